@@ -30,6 +30,14 @@ namespace gs {
  * @brief Breadth-first search. The predecessor or successor will be found and
  * hold in the context. The behavior of the algorithm can be controlled by a
  * source vertex and depth limit.
+ *
+ * The search is direction optimizing. A level is expanded top-down, pushing
+ * from the frontier along the outgoing edges, or bottom-up, where each
+ * unvisited vertex pulls along its incoming edges until a parent in the
+ * frontier is found. The direction is decided by a PushPullSwitcher on the
+ * frontier, the edges out of it, and the edges left to check. A pull needs
+ * the outer vertices in the frontier, which the owners publish along the
+ * outgoing edges, so the first pull after a push takes an extra round.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -54,74 +62,56 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
     ctx.exec_time -= GetCurrentTime();
 #endif
 
+    ctx.unvisited_edges = 0;
+    for (auto v : frag.InnerVertices()) {
+      ctx.unvisited_edges += pullDegree(frag, v);
+    }
     if (native_source) {
       ctx.visited[source] = true;
       ctx.predecessor[source] = frag.Vertex2Gid(source);
-      vertexProcess(source, frag, ctx, messages);
+      ctx.level[source] = 0;
+      ctx.curr_level_inner.push_back(source);
     }
 
-#ifdef PROFILING
-    ctx.exec_time += GetCurrentTime();
-    ctx.post_time -= GetCurrentTime();
-#endif
-
-    messages.ForceContinue();
+    expand(frag, ctx, messages);
 
 #ifdef PROFILING
-    ctx.post_time += GetCurrentTime();
+    ctx.exec_time += GetCurrentTime();
 #endif
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices();
 #ifdef PROFILING
     ctx.pre_time -= GetCurrentTime();
 #endif
 
+    // the inner vertices pushed to, with the predecessors, and the outer
+    // vertices published in the frontier
     vid_t msg;
     vertex_t u;
     while (messages.GetMessage<fragment_t, vid_t>(frag, u, msg)) {
-      // Update predecessor of mirror u in this fragment.
-      ctx.visited[u] = true;
-      ctx.predecessor[u] = msg;
-      vid_t u_vid = frag.Vertex2Gid(u);
-      // Iterate and activate all unvisited neighbors.
-      for (auto w : inner_vertices) {
-        if (ctx.visited[w] == false) {
-          auto oes = frag.GetOutgoingAdjList(w);
-          for (auto& e : oes)
-            if (e.get_neighbor() == u) {
-              ctx.visited[w] = true;
-              ctx.predecessor[w] = u_vid;
-              ctx.next_level_inner.push(w);
-            }
-        }
+      if (frag.IsOuterVertex(u)) {
+        ctx.visited[u] = true;
+        ctx.predecessor[u] = msg;
+        ctx.level[u] = ctx.depth;
+      } else if (ctx.visited[u] == false) {
+        ctx.visited[u] = true;
+        ctx.predecessor[u] = msg;
+        ctx.level[u] = ctx.depth;
+        ctx.curr_level_inner.push_back(u);
       }
     }
-    ctx.curr_level_inner.swap(ctx.next_level_inner);
 
 #ifdef PROFILING
     ctx.pre_time += GetCurrentTime();
     ctx.exec_time -= GetCurrentTime();
 #endif
-    ctx.depth++;
-    if (ctx.depth < ctx.depth_limit) {
-      while (!ctx.curr_level_inner.empty()) {
-        vertex_t v = ctx.curr_level_inner.front();
-        ctx.curr_level_inner.pop();
-        vertexProcess(v, frag, ctx, messages);
-      }
 
-      // Make sure IncEval continues when all activated neighbor is local.
-      if (ctx.next_level_inner.empty()) {
-        writeToCtx(frag, ctx);
-      } else {
-        messages.ForceContinue();
-      }
-    }
+    expand(frag, ctx, messages);
+
 #ifdef PROFILING
-    ctx.post_time += GetCurrentTime();
+    ctx.exec_time += GetCurrentTime();
 #endif
   }
 
@@ -152,17 +142,13 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
         }
       }
     } else if (output_format == "successors") {
+      // by the successors, as the predecessors of the outer vertices are
+      // known to their owners only
       for (auto v : inner_vertices) {
-        if (visited[v]) {
-          vid_t v_vid = frag.Vertex2Gid(v);
-          auto oes = frag.GetOutgoingAdjList(v);
-          for (auto& e : oes) {
-            if (predecessor[e.get_neighbor()] == v_vid) {
-              data.push_back(frag.GetId(v));
-              data.push_back(frag.GetId(e.get_neighbor()));
-              row_num++;
-            }
-          }
+        if (visited[v] && frag.GetId(v) != source_id) {
+          data.push_back(frag.Gid2Oid(predecessor[v]));
+          data.push_back(frag.GetId(v));
+          row_num++;
         }
       }
     }
@@ -170,26 +156,116 @@ class BFSGeneric : public AppBase<FRAG_T, BFSGenericContext<FRAG_T>>,
     ctx.assign(data, shape);
   }
 
-  void vertexProcess(vertex_t v, const fragment_t& frag, context_t& ctx,
-                     message_manager_t& messages) {
-    vid_t v_vid = frag.Vertex2Gid(v);
-    auto oes = frag.GetOutgoingAdjList(v);
-    bool need_sync = false;
-    for (auto& e : oes) {
-      vertex_t u = e.get_neighbor();
-      if (!frag.IsOuterVertex(u)) {
+  static size_t pullDegree(const fragment_t& frag, const vertex_t& v) {
+    return frag.directed() ? frag.GetLocalInDegree(v)
+                           : frag.GetLocalOutDegree(v);
+  }
+
+  // expands the frontier of the current depth, which is complete on the
+  // inner vertices
+  void expand(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    size_t frontier_size = ctx.curr_level_inner.size(), scout_count = 0,
+           unvisited_edges = ctx.unvisited_edges;
+    for (auto v : ctx.curr_level_inner) {
+      scout_count += frag.GetLocalOutDegree(v);
+      // the frontier is visited, and left out of the edges to check
+      unvisited_edges -= pullDegree(frag, v);
+    }
+    size_t global_frontier_size = 0;
+    Sum(frontier_size, global_frontier_size);
+    if (global_frontier_size == 0 || ctx.depth >= ctx.depth_limit) {
+      writeToCtx(frag, ctx);
+      return;
+    }
+
+    size_t global_scout_count = 0, global_unvisited_edges = 0;
+    Sum(scout_count, global_scout_count);
+    Sum(unvisited_edges, global_unvisited_edges);
+
+    ActiveStats stats;
+    stats.active_vertex_num = global_frontier_size;
+    stats.active_edge_num = global_scout_count;
+    stats.total_vertex_num = frag.GetTotalVerticesNum();
+    stats.total_edge_num = global_unvisited_edges;
+    bool pull = ctx.switcher.Next(stats) == EvalDirection::kPull;
+
+    if (pull && !ctx.published) {
+      // publishes the frontier, and pulls in the next round
+      for (auto v : ctx.curr_level_inner) {
+        publish(frag, ctx, v, messages);
+      }
+      ctx.published = true;
+      messages.ForceContinue();
+      return;
+    }
+
+    ctx.next_level_inner.clear();
+    if (pull) {
+      pullLevel(frag, ctx, messages);
+    } else {
+      pushLevel(frag, ctx, messages);
+    }
+    ctx.published = pull;
+    ctx.unvisited_edges = unvisited_edges;
+
+    ctx.depth++;
+    ctx.curr_level_inner.swap(ctx.next_level_inner);
+    messages.ForceContinue();
+  }
+
+  // sends the inner vertex to the fragments holding it as an outer vertex
+  void publish(const fragment_t& frag, const context_t& ctx,
+               const vertex_t& v, message_manager_t& messages) {
+    messages.SendMsgThroughOEdges<fragment_t, vid_t>(frag, v,
+                                                     ctx.predecessor[v]);
+  }
+
+  void pushLevel(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    for (auto v : ctx.curr_level_inner) {
+      vid_t v_vid = frag.Vertex2Gid(v);
+      auto oes = frag.GetOutgoingAdjList(v);
+      for (auto& e : oes) {
+        vertex_t u = e.get_neighbor();
         if (ctx.visited[u] == false) {
-          ctx.predecessor[u] = v_vid;
-          ctx.next_level_inner.push(u);
+          ctx.visited[u] = true;
+          if (frag.IsOuterVertex(u)) {
+            messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, u,
+                                                               v_vid);
+          } else {
+            ctx.predecessor[u] = v_vid;
+            ctx.level[u] = ctx.depth + 1;
+            ctx.next_level_inner.push_back(u);
+          }
+        }
+      }
+    }
+  }
+
+  void pullLevel(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    for (auto v : frag.InnerVertices()) {
+      if (ctx.visited[v]) {
+        continue;
+      }
+      auto es = frag.directed() ? frag.GetIncomingAdjList(v)
+                                : frag.GetOutgoingAdjList(v);
+      for (auto& e : es) {
+        vertex_t u = e.get_neighbor();
+        if (ctx.level[u] == ctx.depth) {
+          ctx.visited[v] = true;
+          ctx.predecessor[v] = frag.Vertex2Gid(u);
+          ctx.level[v] = ctx.depth + 1;
+          ctx.next_level_inner.push_back(v);
+          break;
         }
-      } else {
-        need_sync = true;
       }
-      ctx.visited[u] = true;
     }
-    if (need_sync) {
-      messages.SendMsgThroughOEdges<fragment_t, vid_t>(frag, v,
-                                                       ctx.predecessor[v]);
+
+    // the next frontier is complete, and published for the next pull
+    for (auto v : ctx.next_level_inner) {
+      publish(frag, ctx, v, messages);
     }
   }
 };
@@ -17,12 +17,13 @@ limitations under the License.
 #define ANALYTICAL_ENGINE_APPS_BFS_BFS_GENERIC_CONTEXT_H_
 
 #include <limits>
-#include <queue>
 #include <string>
+#include <vector>
 
 #include "grape/grape.h"
 
 #include "core/context/tensor_context.h"
+#include "core/worker/push_pull_switcher.h"
 
 namespace gs {
 
@@ -53,6 +54,9 @@ class BFSGenericContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
 
     visited.Init(vertices, false);
     predecessor.Init(vertices);
+    level.Init(vertices, -1);
+    switcher.Reset();
+    published = false;
 
 #ifdef PROFILING
     preprocess_time = 0;
@@ -80,11 +84,20 @@ class BFSGenericContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   oid_t source_id;
   typename FRAG_T::template vertex_array_t<vid_t> predecessor;
   typename FRAG_T::template vertex_array_t<bool> visited;
-  std::queue<vertex_t> curr_level_inner, next_level_inner;
+  // the depths of the inner vertices visited, and of the outer vertices
+  // published in a frontier
+  typename FRAG_T::template vertex_array_t<depth_type> level;
+  std::vector<vertex_t> curr_level_inner, next_level_inner;
 
   int depth_limit;
   std::string output_format;
   int depth;
+  // expands the frontier bottom-up in kPull, and whether the outer vertices
+  // in the current frontier have been published
+  PushPullSwitcher switcher;
+  bool published = false;
+  // the incoming edges of the unvisited inner vertices to check in a pull
+  size_t unvisited_edges = 0;
 
 #ifdef PROFILING
   double preprocess_time = 0;
@@ -111,15 +124,9 @@ class BFSGenericContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   void outputSuccessors(const FRAG_T& frag, std::ostream& os) {
     auto inner_vertices = frag.InnerVertices();
     for (auto v : inner_vertices)
-      if (visited[v]) {
-        vid_t v_vid = frag.Vertex2Gid(v);
-        auto oes = frag.GetOutgoingAdjList(v);
-        for (auto& e : oes) {
-          if (predecessor[e.get_neighbor()] == v_vid)
-            os << frag.GetId(v) << ": " << frag.GetId(e.get_neighbor())
-               << std::endl;
-        }
-      }
+      if (visited[v] && frag.GetId(v) != source_id)
+        os << frag.Gid2Oid(predecessor[v]) << ": " << frag.GetId(v)
+           << std::endl;
   }
 };
 }  // namespace gs
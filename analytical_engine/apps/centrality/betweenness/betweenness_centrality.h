@@ -0,0 +1,310 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_H_
+#define ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/centrality/betweenness/betweenness_centrality_context.h"
+#include "core/app/app_base.h"
+#include "core/worker/default_worker.h"
+#include "sssp/multi_source_bfs.h"
+
+namespace gs {
+/**
+ * @brief Compute the betweenness centrality for vertices by Brandes, i.e.,
+ * the sum over the pairs of the other vertices of the fraction of the
+ * shortest paths between them through the vertex, as NetworkX. The searches
+ * of a batch of kLaneNum sources run at once, level by level: the forward
+ * pass counts the shortest paths along the outgoing edges, then the backward
+ * pass accumulates the dependencies along the incoming edges from the
+ * deepest level, and the dependencies of a vertex add to its betweenness.
+ * The counts and the dependencies of the outer vertices are sent to the
+ * owners per level. The sources may be a sample of the vertices, picked by
+ * SampleSources, of which the betweenness is scaled up for an estimate.
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class BetweennessCentrality
+    : public AppBase<FRAG_T, BetweennessCentralityContext<FRAG_T>>,
+      public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(BetweennessCentrality<FRAG_T>,
+                         BetweennessCentralityContext<FRAG_T>, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using stage_t = typename context_t::Stage;
+  // the lane and the path count, or the dependency to add
+  using msg_t = std::pair<int32_t, double>;
+
+  static constexpr int kLaneNum = context_t::kLaneNum;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    SampleSources(*this, frag, ctx.sample_num, ctx.sources, ctx.source_offset,
+                  ctx.total_source_num);
+    ctx.batch = 0;
+    startBatch(frag, ctx, messages);
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    vertex_t u;
+    msg_t msg;
+    if (ctx.stage == stage_t::kForward) {
+      int32_t level = ctx.level + 1;
+      while (messages.GetMessage<fragment_t, msg_t>(frag, u, msg)) {
+        reach(ctx, u, msg.first, level, msg.second);
+      }
+      ctx.level = level;
+      size_t active = 0;
+      if (static_cast<size_t>(level) < ctx.levels.size()) {
+        active = ctx.levels[level].size();
+      }
+      size_t global_active = 0;
+      Sum(active, global_active);
+      if (global_active != 0) {
+        forward(frag, ctx, messages);
+        messages.ForceContinue();
+        return;
+      }
+      // backward from the deepest level of the batch
+      ctx.stage = stage_t::kBackward;
+      ctx.level = level - 1;
+      ctx.levels.resize(ctx.level + 1);
+    } else {
+      while (messages.GetMessage<fragment_t, msg_t>(frag, u, msg)) {
+        size_t slot = context_t::slot(u, msg.first);
+        if (ctx.distance[slot] == ctx.level) {
+          ctx.delta[slot] += ctx.sigma[slot] * msg.second;
+        }
+      }
+    }
+
+    // the sources at level 0 depend on nothing
+    if (ctx.level >= 1) {
+      backward(frag, ctx, messages);
+      --ctx.level;
+    }
+    if (ctx.level >= 1) {
+      messages.ForceContinue();
+      return;
+    }
+
+    resetBatch(ctx);
+    ++ctx.batch;
+    if (ctx.batch * kLaneNum < ctx.total_source_num) {
+      startBatch(frag, ctx, messages);
+      messages.ForceContinue();
+      return;
+    }
+    writeToCtx(frag, ctx);
+  }
+
+ private:
+  // the predecessors on the shortest paths are along the incoming edges
+  template <typename FUNC_T>
+  static void forEachPredecessor(const fragment_t& frag, const vertex_t& v,
+                                 const FUNC_T& func) {
+    if (frag.directed()) {
+      for (auto& e : frag.GetIncomingAdjList(v)) {
+        func(e.get_neighbor());
+      }
+    } else {
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        func(e.get_neighbor());
+      }
+    }
+  }
+
+  static void lanesAt(const context_t& ctx, const vertex_t& v, int32_t level,
+                      std::vector<int>& lanes) {
+    lanes.clear();
+    for (int i = 0; i < kLaneNum; ++i) {
+      if (ctx.distance[context_t::slot(v, i)] == level) {
+        lanes.push_back(i);
+      }
+    }
+  }
+
+  // adds the paths of the lane to an inner vertex at the level
+  static void reach(context_t& ctx, const vertex_t& v, int lane, int32_t level,
+                    double paths) {
+    size_t slot = context_t::slot(v, lane);
+    if (ctx.distance[slot] == -1) {
+      ctx.distance[slot] = level;
+      if (ctx.listed[v] != level) {
+        ctx.listed[v] = level;
+        if (ctx.levels.size() <= static_cast<size_t>(level)) {
+          ctx.levels.resize(level + 1);
+        }
+        ctx.levels[level].push_back(v);
+      }
+    }
+    if (ctx.distance[slot] == level) {
+      ctx.sigma[slot] += paths;
+    }
+  }
+
+  void startBatch(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages) {
+    size_t begin = ctx.batch * kLaneNum;
+    size_t local_begin = std::max(begin, ctx.source_offset);
+    size_t local_end =
+        std::min(begin + kLaneNum, ctx.source_offset + ctx.sources.size());
+
+    ctx.levels.clear();
+    for (size_t i = local_begin; i < local_end; ++i) {
+      reach(ctx, ctx.sources[i - ctx.source_offset],
+            static_cast<int>(i - begin), 0, 1);
+    }
+    ctx.level = 0;
+    ctx.stage = stage_t::kForward;
+    forward(frag, ctx, messages);
+  }
+
+  // pushes the path counts of the vertices at the level to the next one
+  void forward(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    int32_t level = ctx.level;
+    std::vector<int> lanes;
+    // the next level is reached while the vertices at the level are iterated
+    ctx.levels.resize(
+        std::max(ctx.levels.size(), static_cast<size_t>(level) + 2));
+    for (auto v : ctx.levels[level]) {
+      lanesAt(ctx, v, level, lanes);
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        bool inner = frag.IsInnerVertex(u);
+        for (int i : lanes) {
+          double paths = ctx.sigma[context_t::slot(v, i)];
+          if (inner) {
+            reach(ctx, u, i, level + 1, paths);
+          } else {
+            ctx.sigma[context_t::slot(u, i)] += paths;
+          }
+        }
+        if (!inner) {
+          ctx.pending.Insert(u);
+        }
+      }
+    }
+    send(frag, ctx, messages, ctx.sigma);
+  }
+
+  // accumulates the dependencies of the vertices at the level, and pushes
+  // them to the predecessors, if not the sources
+  void backward(const fragment_t& frag, context_t& ctx,
+                message_manager_t& messages) {
+    int32_t level = ctx.level;
+    std::vector<int> lanes;
+    std::vector<double> coefs;
+    for (auto w : ctx.levels[level]) {
+      lanesAt(ctx, w, level, lanes);
+      coefs.clear();
+      for (int i : lanes) {
+        size_t slot = context_t::slot(w, i);
+        ctx.centrality[w] += ctx.delta[slot];
+        coefs.push_back((1 + ctx.delta[slot]) / ctx.sigma[slot]);
+      }
+      if (level == 1) {
+        continue;
+      }
+      forEachPredecessor(frag, w, [&frag, &ctx, &lanes, &coefs,
+                                   level](const vertex_t& v) {
+        bool inner = frag.IsInnerVertex(v);
+        for (size_t j = 0; j < lanes.size(); ++j) {
+          size_t slot = context_t::slot(v, lanes[j]);
+          if (!inner) {
+            ctx.delta[slot] += coefs[j];
+          } else if (ctx.distance[slot] == level - 1) {
+            ctx.delta[slot] += ctx.sigma[slot] * coefs[j];
+          }
+        }
+        if (!inner) {
+          ctx.pending.Insert(v);
+        }
+      });
+    }
+    send(frag, ctx, messages, ctx.delta);
+  }
+
+  // sends the states of the pending outer vertices to the owners, and
+  // clears them
+  void send(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages, std::vector<double>& states) {
+    for (auto v : frag.OuterVertices()) {
+      if (!ctx.pending.Exist(v)) {
+        continue;
+      }
+      for (int i = 0; i < kLaneNum; ++i) {
+        double& state = states[context_t::slot(v, i)];
+        if (state != 0) {
+          messages.SyncStateOnOuterVertex<fragment_t, msg_t>(frag, v,
+                                                             msg_t(i, state));
+          state = 0;
+        }
+      }
+    }
+    ctx.pending.Clear();
+  }
+
+  // clears the states of the inner vertices reached in the batch
+  void resetBatch(context_t& ctx) {
+    for (auto& vertices : ctx.levels) {
+      for (auto v : vertices) {
+        for (int i = 0; i < kLaneNum; ++i) {
+          size_t slot = context_t::slot(v, i);
+          ctx.distance[slot] = -1;
+          ctx.sigma[slot] = 0;
+          ctx.delta[slot] = 0;
+        }
+        ctx.listed[v] = -1;
+      }
+    }
+    ctx.levels.clear();
+  }
+
+  void writeToCtx(const fragment_t& frag, context_t& ctx) {
+    double n = frag.GetTotalVerticesNum();
+    double scale = 1;
+    if (ctx.normalized) {
+      if (n > 2) {
+        scale = 1 / ((n - 1) * (n - 2));
+      }
+    } else if (!frag.directed()) {
+      // each pair is counted from both ends
+      scale = 0.5;
+    }
+    if (ctx.total_source_num != 0 && ctx.total_source_num < n) {
+      scale *= n / ctx.total_source_num;
+    }
+    for (auto v : frag.InnerVertices()) {
+      ctx.centrality[v] *= scale;
+    }
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_H_
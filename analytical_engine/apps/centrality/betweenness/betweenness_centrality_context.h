@@ -0,0 +1,109 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_CONTEXT_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+template <typename FRAG_T>
+class BetweennessCentralityContext
+    : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  // the sources of a batch, each of a lane of the states of the vertices,
+  // which bounds the memory by kLaneNum * 20 bytes per vertex
+  static constexpr int kLaneNum = 32;
+
+  enum class Stage { kForward, kBackward };
+
+  explicit BetweennessCentralityContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        centrality(this->data()) {}
+
+  /**
+   * @param normalized Normalizes the betweenness by the pairs of the other
+   * vertices.
+   * @param sample_num The number of the sources sampled to estimate the
+   * betweenness, or 0 for all the vertices.
+   */
+  void Init(grape::DefaultMessageManager& messages, bool normalized,
+            int64_t sample_num) {
+    auto& frag = this->fragment();
+
+    CHECK_GE(sample_num, 0);
+    this->normalized = normalized;
+    this->sample_num = sample_num;
+    centrality.SetValue(0);
+
+    vid_t lid_num = 0;
+    for (auto v : frag.Vertices()) {
+      lid_num = std::max(lid_num, static_cast<vid_t>(v.GetValue() + 1));
+    }
+    distance.assign(static_cast<size_t>(lid_num) * kLaneNum, -1);
+    sigma.assign(static_cast<size_t>(lid_num) * kLaneNum, 0);
+    delta.assign(static_cast<size_t>(lid_num) * kLaneNum, 0);
+    listed.Init(frag.InnerVertices(), -1);
+    pending.Init(frag.OuterVertices());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto& u : inner_vertices) {
+      os << frag.GetId(u) << "\t" << centrality[u] << std::endl;
+    }
+  }
+
+  // the offset of the lane of a vertex in the states
+  static size_t slot(const vertex_t& v, int lane) {
+    return static_cast<size_t>(v.GetValue()) * kLaneNum + lane;
+  }
+
+  typename FRAG_T::template vertex_array_t<double>& centrality;
+  bool normalized;
+  int64_t sample_num;
+
+  // the states of the lanes of the vertices, by the lids: the distance from
+  // the source, or -1 if not reached, the number of the shortest paths and
+  // the dependency of the source on the vertex. The path counts and the
+  // dependencies of an outer vertex are the ones to send to the owner.
+  std::vector<int32_t> distance;
+  std::vector<double> sigma;
+  std::vector<double> delta;
+  // the inner vertices reached at each level by any lane, and the last level
+  // a vertex is listed at
+  std::vector<std::vector<vertex_t>> levels;
+  typename FRAG_T::template vertex_array_t<int32_t> listed;
+  // the outer vertices with the states to send
+  grape::DenseVertexSet<vid_t> pending;
+
+  std::vector<vertex_t> sources;
+  size_t source_offset = 0;
+  size_t total_source_num = 0;
+  size_t batch = 0;
+  int32_t level = 0;
+  Stage stage = Stage::kForward;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CENTRALITY_BETWEENNESS_BETWEENNESS_CENTRALITY_CONTEXT_H_
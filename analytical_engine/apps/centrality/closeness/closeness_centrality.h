@@ -0,0 +1,113 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_H_
+#define ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_H_
+
+#include "grape/grape.h"
+
+#include "apps/centrality/closeness/closeness_centrality_context.h"
+#include "core/app/app_base.h"
+#include "core/worker/default_worker.h"
+#include "sssp/multi_source_bfs.h"
+
+namespace gs {
+/**
+ * @brief Compute the closeness centrality for vertices, i.e., the reciprocal
+ * of the average distance to a vertex from the vertices reaching it, along
+ * the outgoing edges, as NetworkX. The distances are searched by
+ * MultiSourceBFS, 64 sources per batch, and summed up on the vertices
+ * reached, so the sources may be a sample of the vertices for an estimate.
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class ClosenessCentrality
+    : public AppBase<FRAG_T, ClosenessCentralityContext<FRAG_T>>,
+      public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(ClosenessCentrality<FRAG_T>,
+                         ClosenessCentralityContext<FRAG_T>, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using bfs_t = MultiSourceBFS<FRAG_T>;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    SampleSources(*this, frag, ctx.sample_num, ctx.sources, ctx.source_offset,
+                  ctx.total_source_num);
+    for (auto v : ctx.sources) {
+      ctx.sampled[v] = true;
+    }
+
+    ctx.bfs.Init(frag);
+    ctx.batch = 0;
+    startBatch(frag, ctx, messages);
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    double level = ctx.level;
+    size_t active = ctx.bfs.Advance(
+        frag, messages,
+        [&ctx, level](const vertex_t& v, typename bfs_t::lanes_t lanes) {
+          int count = __builtin_popcountll(lanes);
+          ctx.distance_sum[v] += level * count;
+          ctx.reached[v] += count;
+        });
+    size_t global_active = 0;
+    Sum(active, global_active);
+    if (global_active != 0) {
+      ctx.bfs.Expand(frag, messages);
+      ++ctx.level;
+      messages.ForceContinue();
+      return;
+    }
+
+    ++ctx.batch;
+    if (ctx.batch * bfs_t::kLaneNum < ctx.total_source_num) {
+      startBatch(frag, ctx, messages);
+      messages.ForceContinue();
+      return;
+    }
+
+    for (auto v : frag.InnerVertices()) {
+      double reached = ctx.reached[v];
+      if (ctx.distance_sum[v] <= 0) {
+        continue;
+      }
+      ctx.centrality[v] = reached / ctx.distance_sum[v];
+      if (ctx.wf_improved) {
+        // the sources other than the vertex itself
+        double others = ctx.total_source_num - (ctx.sampled[v] ? 1 : 0);
+        ctx.centrality[v] *= reached / others;
+      }
+    }
+  }
+
+ private:
+  void startBatch(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages) {
+    ctx.bfs.StartBatch(ctx.sources, ctx.source_offset, ctx.batch);
+    ctx.bfs.Expand(frag, messages);
+    ctx.level = 1;
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_H_
@@ -0,0 +1,86 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_CONTEXT_H_
+
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "sssp/multi_source_bfs.h"
+
+namespace gs {
+template <typename FRAG_T>
+class ClosenessCentralityContext
+    : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit ClosenessCentralityContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        centrality(this->data()) {}
+
+  /**
+   * @param wf_improved Scales the closeness by the fraction of the vertices
+   * reaching the vertex, as Wasserman and Faust.
+   * @param sample_num The number of the sources sampled to estimate the
+   * closeness, or 0 for all the vertices.
+   */
+  void Init(grape::DefaultMessageManager& messages, bool wf_improved,
+            int64_t sample_num) {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    CHECK_GE(sample_num, 0);
+    this->wf_improved = wf_improved;
+    this->sample_num = sample_num;
+    centrality.SetValue(0);
+    distance_sum.Init(inner_vertices, 0);
+    reached.Init(inner_vertices, 0);
+    sampled.Init(inner_vertices, false);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto& u : inner_vertices) {
+      os << frag.GetId(u) << "\t" << centrality[u] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<double>& centrality;
+  bool wf_improved;
+  int64_t sample_num;
+
+  // the sum of the distances from the sources reaching a vertex, and the
+  // number of them
+  typename FRAG_T::template vertex_array_t<double> distance_sum;
+  typename FRAG_T::template vertex_array_t<size_t> reached;
+  typename FRAG_T::template vertex_array_t<bool> sampled;
+
+  // the searches by the batches of the sources
+  MultiSourceBFS<FRAG_T> bfs;
+  std::vector<vertex_t> sources;
+  size_t source_offset = 0;
+  size_t total_source_num = 0;
+  size_t batch = 0;
+  int level = 0;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CENTRALITY_CLOSENESS_CLOSENESS_CENTRALITY_CONTEXT_H_
@@ -16,13 +16,14 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_EIGENVECTOR_EIGENVECTOR_CENTRALITY_H_
 #define ANALYTICAL_ENGINE_APPS_CENTRALITY_EIGENVECTOR_EIGENVECTOR_CENTRALITY_H_
 
+#include <cmath>
+#include <numeric>
+#include <vector>
+
 #include "grape/grape.h"
 
 #include "apps/centrality/eigenvector/eigenvector_centrality_context.h"
 
-#include "core/app/app_base.h"
-#include "core/worker/default_worker.h"
-
 namespace gs {
 /**
  * @brief Eigenvector centrality is a measure of the influence of a vertex in a
@@ -34,11 +35,13 @@ namespace gs {
  */
 template <typename FRAG_T>
 class EigenvectorCentrality
-    : public AppBase<FRAG_T, EigenvectorCentralityContext<FRAG_T>>,
+    : public grape::ParallelAppBase<FRAG_T,
+                                    EigenvectorCentralityContext<FRAG_T>>,
+      public grape::ParallelEngine,
       public grape::Communicator {
  public:
-  INSTALL_DEFAULT_WORKER(EigenvectorCentrality<FRAG_T>,
-                         EigenvectorCentralityContext<FRAG_T>, FRAG_T)
+  INSTALL_PARALLEL_WORKER(EigenvectorCentrality<FRAG_T>,
+                          EigenvectorCentralityContext<FRAG_T>, FRAG_T)
   static constexpr grape::MessageStrategy message_strategy =
       grape::MessageStrategy::kAlongEdgeToOuterVertex;
   static constexpr grape::LoadStrategy load_strategy =
@@ -49,11 +52,14 @@ class EigenvectorCentrality
 
   bool NormAndCheckTerm(const fragment_t& frag, context_t& ctx) {
     auto inner_vertices = frag.InnerVertices();
-    double frag_sum = 0.0;
+    auto& x = ctx.x;
+    auto& x_last = ctx.x_last;
+    // the partial sums of the threads
+    std::vector<double> sums(thread_num(), 0), delta_sums(thread_num(), 0);
 
-    for (auto& v : inner_vertices) {
-      frag_sum += ctx.x[v] * ctx.x[v];
-    }
+    ForEach(inner_vertices,
+            [&x, &sums](int tid, vertex_t v) { sums[tid] += x[v] * x[v]; });
+    double frag_sum = std::accumulate(sums.begin(), sums.end(), 0.0);
 
     double total_sum = 0;
     Sum(frag_sum, total_sum);
@@ -61,12 +67,15 @@ class EigenvectorCentrality
     double norm = sqrt(total_sum);
     CHECK_GT(norm, 0);
 
-    double local_delta_sum = 0, total_delta_sum = 0;
-    for (auto& v : inner_vertices) {
-      ctx.x[v] /= norm;
-      local_delta_sum += std::abs(ctx.x[v] - ctx.x_last[v]);
-    }
+    ForEach(inner_vertices,
+            [&x, &x_last, &delta_sums, norm](int tid, vertex_t v) {
+              x[v] /= norm;
+              delta_sums[tid] += std::abs(x[v] - x_last[v]);
+            });
+    double local_delta_sum =
+        std::accumulate(delta_sums.begin(), delta_sums.end(), 0.0);
 
+    double total_delta_sum = 0;
     Sum(local_delta_sum, total_delta_sum);
     VLOG(1) << "[step - " << ctx.curr_round << " ] Diff: " << total_delta_sum;
     if (total_delta_sum < frag.GetTotalVerticesNum() * ctx.tolerance ||
@@ -80,19 +89,20 @@ class EigenvectorCentrality
 
   template <typename FRAG_T_, typename = void>
   struct Pull {
-    void operator()(const fragment_t& frag, context_t& ctx,
-                    message_manager_t& messages) {
+    void operator()(EigenvectorCentrality& app, const fragment_t& frag,
+                    context_t& ctx, message_manager_t& messages) {
       auto inner_vertices = frag.InnerVertices();
       auto& x = ctx.x;
       auto& x_last = ctx.x_last;
 
-      for (auto& v : inner_vertices) {
+      app.ForEach(inner_vertices, [&frag, &x, &x_last](int tid, vertex_t v) {
         auto es = frag.GetIncomingAdjList(v);
-        x[v] = x_last[v];
+        double sum = x_last[v];
         for (auto& e : es) {
-          x[v] += x_last[e.get_neighbor()];
+          sum += x_last[e.get_neighbor()];
         }
-      }
+        x[v] = sum;
+      });
     }
   };
 
@@ -100,38 +110,35 @@ class EigenvectorCentrality
   struct Pull<FRAG_T_,
               typename std::enable_if<!std::is_same<
                   typename FRAG_T_::edata_t, grape::EmptyType>::value>::type> {
-    void operator()(const fragment_t& frag, context_t& ctx,
-                    message_manager_t& messages) {
+    void operator()(EigenvectorCentrality& app, const fragment_t& frag,
+                    context_t& ctx, message_manager_t& messages) {
       auto inner_vertices = frag.InnerVertices();
       auto& x = ctx.x;
       auto& x_last = ctx.x_last;
 
-      for (auto& v : inner_vertices) {
+      app.ForEach(inner_vertices, [&frag, &x, &x_last](int tid, vertex_t v) {
         auto es = frag.GetIncomingAdjList(v);
+        double sum = x_last[v];
         for (auto& e : es) {
-          x[v] += x_last[e.get_neighbor()] * e.get_data();
+          sum += x_last[e.get_neighbor()] * e.get_data();
         }
-      }
+        x[v] = sum;
+      });
     }
   };
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
-    Pull<fragment_t>{}(frag, ctx, messages);
-    auto inner_vertices = frag.InnerVertices();
+    messages.InitChannels(thread_num());
+
+    Pull<fragment_t>{}(*this, frag, ctx, messages);
 
     // call NormAndCheckTerm before send. because we normalize the vector 'x' in
     // the function.
     if (NormAndCheckTerm(frag, ctx))
       return;
 
-    if (frag.fnum() == 1) {
-      messages.ForceContinue();
-    } else {
-      for (auto& v : inner_vertices) {
-        messages.SendMsgThroughEdges(frag, v, ctx.x[v]);
-      }
-    }
+    send(frag, ctx, messages);
     ctx.curr_round++;
   }
 
@@ -139,31 +146,35 @@ class EigenvectorCentrality
                message_manager_t& messages) {
     auto& x = ctx.x;
     auto& x_last = ctx.x_last;
-    auto inner_vertices = frag.InnerVertices();
 
-    {
-      double msg;
-      vertex_t u;
-      while (messages.GetMessage(frag, u, msg)) {
-        x[u] = msg;
-      }
-    }
+    messages.ParallelProcess<fragment_t, double>(
+        thread_num(), frag,
+        [&x](int tid, vertex_t u, double msg) { x[u] = msg; });
 
     x_last.Swap(x);
 
-    Pull<fragment_t>{}(frag, ctx, messages);
+    Pull<fragment_t>{}(*this, frag, ctx, messages);
 
     if (NormAndCheckTerm(frag, ctx))
       return;
 
+    send(frag, ctx, messages);
+    ctx.curr_round++;
+  }
+
+ private:
+  void send(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    auto& x = ctx.x;
     if (frag.fnum() == 1) {
       messages.ForceContinue();
     } else {
-      for (auto& v : inner_vertices) {
-        messages.SendMsgThroughEdges(frag, v, x[v]);
-      }
+      ForEach(frag.InnerVertices(),
+              [&frag, &x, &messages](int tid, vertex_t v) {
+                messages.SendMsgThroughEdges<fragment_t, double>(frag, v, x[v],
+                                                                 tid);
+              });
     }
-    ctx.curr_round++;
   }
 };
 }  // namespace gs
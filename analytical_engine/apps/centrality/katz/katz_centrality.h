@@ -16,13 +16,14 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_CENTRALITY_KATZ_KATZ_CENTRALITY_H_
 #define ANALYTICAL_ENGINE_APPS_CENTRALITY_KATZ_KATZ_CENTRALITY_H_
 
+#include <cmath>
+#include <numeric>
+#include <vector>
+
 #include "grape/grape.h"
 
 #include "apps/centrality/katz/katz_centrality_context.h"
 
-#include "core/app/app_base.h"
-#include "core/worker/default_worker.h"
-
 namespace gs {
 /**
  * @brief The Katz centrality of a vertex is a measure of centrality in a
@@ -31,11 +32,13 @@ namespace gs {
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
-class KatzCentrality : public AppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
-                       public grape::Communicator {
+class KatzCentrality
+    : public grape::ParallelAppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
  public:
-  INSTALL_DEFAULT_WORKER(KatzCentrality<FRAG_T>, KatzCentralityContext<FRAG_T>,
-                         FRAG_T)
+  INSTALL_PARALLEL_WORKER(KatzCentrality<FRAG_T>,
+                          KatzCentralityContext<FRAG_T>, FRAG_T)
   static constexpr grape::MessageStrategy message_strategy =
       grape::MessageStrategy::kAlongEdgeToOuterVertex;
   static constexpr grape::LoadStrategy load_strategy =
@@ -46,12 +49,19 @@ class KatzCentrality : public AppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
 
   bool CheckTerm(const fragment_t& frag, context_t& ctx) {
     auto inner_vertices = frag.InnerVertices();
-    double frag_sum = 0.0, frag_delta_sum = 0.0;
-
-    for (auto& v : inner_vertices) {
-      frag_sum += ctx.x[v] * ctx.x[v];
-      frag_delta_sum += std::fabs(ctx.x[v] - ctx.x_last[v]);
-    }
+    auto& x = ctx.x;
+    auto& x_last = ctx.x_last;
+    // the partial sums of the threads
+    std::vector<double> sums(thread_num(), 0), delta_sums(thread_num(), 0);
+
+    ForEach(inner_vertices,
+            [&x, &x_last, &sums, &delta_sums](int tid, vertex_t v) {
+              sums[tid] += x[v] * x[v];
+              delta_sums[tid] += std::fabs(x[v] - x_last[v]);
+            });
+    double frag_sum = std::accumulate(sums.begin(), sums.end(), 0.0);
+    double frag_delta_sum =
+        std::accumulate(delta_sums.begin(), delta_sums.end(), 0.0);
 
     double total_sum = 0, total_delta_sum = 0;
     Sum(frag_sum, total_sum);
@@ -70,22 +80,23 @@ class KatzCentrality : public AppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
 
   template <typename FRAG_T_, typename = void>
   struct PullAndSend {
-    void operator()(const fragment_t& frag, context_t& ctx,
-                    message_manager_t& messages) {
+    void operator()(KatzCentrality& app, const fragment_t& frag,
+                    context_t& ctx, message_manager_t& messages) {
       auto inner_vertices = frag.InnerVertices();
       auto& x = ctx.x;
       auto& x_last = ctx.x_last;
 
-      for (auto& v : inner_vertices) {
+      app.ForEach(inner_vertices, [&frag, &ctx, &messages, &x, &x_last](
+                                      int tid, vertex_t v) {
         auto es = frag.GetIncomingAdjList(v);
-        x[v] = 0;
+        double sum = 0;
         for (auto& e : es) {
           // do the multiplication y^T = Alpha * x^T A - Beta
-          x[v] += x_last[e.get_neighbor()];
+          sum += x_last[e.get_neighbor()];
         }
-        x[v] = x[v] * ctx.alpha + ctx.beta;
-        messages.SendMsgThroughEdges(frag, v, ctx.x[v]);
-      }
+        x[v] = sum * ctx.alpha + ctx.beta;
+        messages.SendMsgThroughEdges<fragment_t, double>(frag, v, x[v], tid);
+      });
     }
   };
 
@@ -93,28 +104,31 @@ class KatzCentrality : public AppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
   struct PullAndSend<
       FRAG_T_, typename std::enable_if<!std::is_same<
                    typename FRAG_T_::edata_t, grape::EmptyType>::value>::type> {
-    void operator()(const fragment_t& frag, context_t& ctx,
-                    message_manager_t& messages) {
+    void operator()(KatzCentrality& app, const fragment_t& frag,
+                    context_t& ctx, message_manager_t& messages) {
       auto inner_vertices = frag.InnerVertices();
       auto& x = ctx.x;
       auto& x_last = ctx.x_last;
 
-      for (auto& v : inner_vertices) {
+      app.ForEach(inner_vertices, [&frag, &ctx, &messages, &x, &x_last](
+                                      int tid, vertex_t v) {
         auto es = frag.GetIncomingAdjList(v);
-        x[v] = 0;
+        double sum = 0;
         for (auto& e : es) {
           // do the multiplication y^T = Alpha * x^T A - Beta
-          x[v] += x_last[e.get_neighbor()] * e.get_data();
+          sum += x_last[e.get_neighbor()] * e.get_data();
         }
-        x[v] = x[v] * ctx.alpha + ctx.beta;
-        messages.SendMsgThroughEdges(frag, v, ctx.x[v]);
-      }
+        x[v] = sum * ctx.alpha + ctx.beta;
+        messages.SendMsgThroughEdges<fragment_t, double>(frag, v, x[v], tid);
+      });
     }
   };
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
-    PullAndSend<fragment_t>{}(frag, ctx, messages);
+    messages.InitChannels(thread_num());
+
+    PullAndSend<fragment_t>{}(*this, frag, ctx, messages);
 
     if (frag.fnum() == 1) {
       messages.ForceContinue();
@@ -134,25 +148,20 @@ class KatzCentrality : public AppBase<FRAG_T, KatzCentralityContext<FRAG_T>>,
 
       CHECK_GT(total_sum, 0);
       double s = 1.0 / std::sqrt(total_sum);
-      for (auto& u : inner_vertices) {
-        if (ctx.normalized) {
-          x[u] *= s;
-        }
+      if (ctx.normalized) {
+        ForEach(inner_vertices, [&x, s](int tid, vertex_t u) { x[u] *= s; });
       }
 
       return;
     }
-    {
-      double msg;
-      vertex_t u;
-      while (messages.GetMessage(frag, u, msg)) {
-        x[u] = msg;
-      }
-    }
+
+    messages.ParallelProcess<fragment_t, double>(
+        thread_num(), frag,
+        [&x](int tid, vertex_t u, double msg) { x[u] = msg; });
 
     x_last.Swap(x);
 
-    PullAndSend<fragment_t>{}(frag, ctx, messages);
+    PullAndSend<fragment_t>{}(*this, frag, ctx, messages);
 
     if (frag.fnum() == 1) {
       messages.ForceContinue();
@@ -0,0 +1,251 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_H_
+#define ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_H_
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "clustering/approx_clustering_context.h"
+
+namespace gs {
+/**
+ * @brief Estimate the transitivity or the average clustering coefficient of
+ * the graph by sampling the wedges, i.e., the paths of length 2, in the
+ * graph taken as undirected. The transitivity is the fraction of the closed
+ * wedges, sampled uniformly, and the average clustering is the fraction over
+ * a random wedge of each vertex sampled uniformly, where the vertices of
+ * degree less than 2 count 0. Each fragment samples its inner vertices by
+ * its share of the total, and the estimate is within epsilon of the exact
+ * value with probability 1 - delta, by the Hoeffding bound.
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class ApproxClustering
+    : public grape::ParallelAppBase<FRAG_T, ApproxClusteringContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(ApproxClustering<FRAG_T>,
+                          ApproxClusteringContext<FRAG_T>, FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  // the gids of the ends of a wedge, and the weight of it in the estimate
+  using query_t = std::tuple<vid_t, vid_t, double>;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+
+    std::vector<vertex_t> centers;
+    std::vector<double> cumulative_weights;
+    double local_weight = 0;
+    for (auto v : frag.InnerVertices()) {
+      double degree = static_cast<double>(getDegree(frag, v));
+      local_weight += ctx.by_wedges ? degree * (degree - 1) / 2 : 1;
+      centers.push_back(v);
+      cumulative_weights.push_back(local_weight);
+    }
+    double total_weight = 0;
+    Sum(local_weight, total_weight);
+
+    if (local_weight > 0) {
+      // the samples of the fragments are proportional to their weights, and
+      // a sample weighs the share of its fragment per sample
+      auto sample_num = static_cast<size_t>(
+          std::ceil(ctx.sample_num * local_weight / total_weight));
+      ctx.sample_weight = local_weight / total_weight / sample_num;
+      sampleWedges(frag, ctx, messages, centers, cumulative_weights,
+                   sample_num);
+    }
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    messages.ParallelProcess<query_t>(
+        thread_num(), [&frag, &ctx](int tid, const query_t& query) {
+          vertex_t u, w;
+          if (frag.InnerVertexGid2Vertex(std::get<0>(query), u) &&
+              frag.Gid2Vertex(std::get<1>(query), w) &&
+              hasNeighbor(frag, u, w)) {
+            grape::atomic_add(ctx.closed_weight, std::get<2>(query));
+          }
+        });
+
+    double estimate = 0;
+    Sum(ctx.closed_weight, estimate);
+    ctx.estimate = estimate;
+    if (frag.fid() == 0) {
+      std::vector<size_t> shape{1};
+      ctx.set_shape(shape);
+      ctx.assign(estimate);
+    }
+  }
+
+ private:
+  static size_t getDegree(const fragment_t& frag, const vertex_t& v) {
+    size_t degree = frag.GetLocalOutDegree(v);
+    if (frag.directed()) {
+      degree += frag.GetLocalInDegree(v);
+    }
+    return degree;
+  }
+
+  // the out neighbors followed by the in neighbors, if directed
+  template <typename FUNC_T>
+  static void forEachNeighbor(const fragment_t& frag, const vertex_t& v,
+                              const FUNC_T& func) {
+    for (auto& e : frag.GetOutgoingAdjList(v)) {
+      func(e.get_neighbor());
+    }
+    if (frag.directed()) {
+      for (auto& e : frag.GetIncomingAdjList(v)) {
+        func(e.get_neighbor());
+      }
+    }
+  }
+
+  static bool hasNeighbor(const fragment_t& frag, const vertex_t& u,
+                          const vertex_t& w) {
+    for (auto& e : frag.GetOutgoingAdjList(u)) {
+      if (e.get_neighbor() == w) {
+        return true;
+      }
+    }
+    if (frag.directed()) {
+      for (auto& e : frag.GetIncomingAdjList(u)) {
+        if (e.get_neighbor() == w) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void sampleWedges(const fragment_t& frag, context_t& ctx,
+                    message_manager_t& messages,
+                    const std::vector<vertex_t>& centers,
+                    const std::vector<double>& cumulative_weights,
+                    size_t sample_num) {
+    std::mt19937_64 rng(frag.fid());
+    std::uniform_real_distribution<double> by_wedge(
+        0, cumulative_weights.back());
+    std::uniform_int_distribution<size_t> by_vertex(0, centers.size() - 1);
+
+    // the center and the positions of the two neighbors of each wedge
+    std::vector<std::tuple<size_t, size_t, size_t>> wedges;
+    wedges.reserve(sample_num);
+    for (size_t i = 0; i < sample_num; ++i) {
+      size_t center;
+      if (ctx.by_wedges) {
+        center = std::upper_bound(cumulative_weights.begin(),
+                                  cumulative_weights.end(), by_wedge(rng)) -
+                 cumulative_weights.begin();
+        center = std::min(center, centers.size() - 1);
+      } else {
+        center = by_vertex(rng);
+      }
+      size_t degree = getDegree(frag, centers[center]);
+      if (degree < 2) {
+        continue;
+      }
+      size_t first = std::uniform_int_distribution<size_t>(0, degree - 1)(rng);
+      size_t second =
+          std::uniform_int_distribution<size_t>(0, degree - 2)(rng);
+      if (second >= first) {
+        ++second;
+      }
+      wedges.emplace_back(center, std::min(first, second),
+                          std::max(first, second));
+    }
+    std::sort(wedges.begin(), wedges.end());
+
+    // picks the neighbors of a center in one pass over its neighbors
+    std::vector<size_t> positions;
+    std::vector<vertex_t> picked;
+    size_t begin = 0;
+    while (begin < wedges.size()) {
+      size_t center = std::get<0>(wedges[begin]);
+      size_t end = begin;
+      positions.clear();
+      while (end < wedges.size() && std::get<0>(wedges[end]) == center) {
+        positions.push_back(std::get<1>(wedges[end]));
+        positions.push_back(std::get<2>(wedges[end]));
+        ++end;
+      }
+      std::sort(positions.begin(), positions.end());
+      positions.erase(std::unique(positions.begin(), positions.end()),
+                      positions.end());
+      picked.resize(positions.size());
+      size_t position = 0, index = 0;
+      forEachNeighbor(frag, centers[center], [&](const vertex_t& u) {
+        if (index < positions.size() && positions[index] == position) {
+          picked[index++] = u;
+        }
+        ++position;
+      });
+
+      auto pick = [&positions, &picked](size_t pos) {
+        return picked[std::lower_bound(positions.begin(), positions.end(),
+                                       pos) -
+                      positions.begin()];
+      };
+      for (size_t i = begin; i < end; ++i) {
+        vertex_t u = pick(std::get<1>(wedges[i]));
+        vertex_t w = pick(std::get<2>(wedges[i]));
+        checkWedge(frag, ctx, messages, centers[center], u, w);
+      }
+      begin = end;
+    }
+  }
+
+  // the wedge u - v - w is resolved by the fragment of u
+  void checkWedge(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages, const vertex_t& v, vertex_t u,
+                  vertex_t w) {
+    if (u == v || w == v || u == w) {
+      // by the self loops or the parallel edges
+      return;
+    }
+    if (!frag.IsInnerVertex(u)) {
+      std::swap(u, w);
+    }
+    if (frag.IsInnerVertex(u)) {
+      if (hasNeighbor(frag, u, w)) {
+        ctx.closed_weight += ctx.sample_weight;
+      }
+    } else {
+      messages.Channels()[0].SendToFragment(
+          frag.GetFragId(u), query_t(frag.Vertex2Gid(u), frag.Vertex2Gid(w),
+                                     ctx.sample_weight));
+    }
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_H_
@@ -0,0 +1,86 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_CONTEXT_H_
+
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+#include "grape/grape.h"
+
+#include "core/context/tensor_context.h"
+
+namespace gs {
+/**
+ * @brief Context for the approximate transitivity and average clustering.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class ApproxClusteringContext : public TensorContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit ApproxClusteringContext(const FRAG_T& fragment)
+      : TensorContext<FRAG_T, double>(fragment) {}
+
+  /**
+   * @param mode "transitivity" or "avg_clustering"
+   * @param epsilon The additive error of the estimate.
+   * @param delta The probability the error exceeds epsilon.
+   */
+  void Init(grape::ParallelMessageManager& messages, const std::string& mode,
+            double epsilon, double delta) {
+    if (mode == "transitivity") {
+      by_wedges = true;
+    } else if (mode == "avg_clustering") {
+      by_wedges = false;
+    } else {
+      LOG(FATAL) << "Unknown mode of approx_clustering: " << mode
+                 << ", expects transitivity or avg_clustering";
+    }
+    CHECK(epsilon > 0 && epsilon < 1);
+    CHECK(delta > 0 && delta < 1);
+    // by the Hoeffding bound
+    sample_num = static_cast<size_t>(
+        std::ceil(std::log(2.0 / delta) / (2.0 * epsilon * epsilon)));
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    if (frag.fid() == 0) {
+      os << std::setiosflags(std::ios::fixed) << std::setprecision(4)
+         << estimate << std::endl;
+    }
+  }
+
+  // sample the centers by the wedges for the transitivity, or by the vertices
+  // for the average clustering
+  bool by_wedges = true;
+  size_t sample_num = 0;
+  // the weight of a closed wedge sampled by this fragment in the estimate
+  double sample_weight = 0;
+  // the weights of the closed wedges resolved by this fragment
+  double closed_weight = 0;
+  double estimate = 0;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CLUSTERING_APPROX_CLUSTERING_CONTEXT_H_
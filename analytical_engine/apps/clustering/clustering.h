@@ -22,6 +22,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "clustering/clustering_context.h"
+#include "clustering/triangle_kernel.h"
 
 namespace gs {
 /**
@@ -174,27 +175,8 @@ class Clustering
                 }
               });
 
-      typename FRAG_T::template vertex_array_t<uint32_t> v0_nbr_set(vertices,
-                                                                    0);
-      for (auto v : inner_vertices) {
-        auto& v0_nbr_vec = ctx.complete_neighbor[v];
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = u.second;
-        }
-        for (auto u : v0_nbr_vec) {
-          auto& v1_nbr_vec = ctx.complete_neighbor[u.first];
-          for (auto w : v1_nbr_vec) {
-            if (v0_nbr_set[w.first] != 0) {
-              ctx.tricnt[u.first] += v0_nbr_set[w.first] * u.second * w.second;
-              ctx.tricnt[v] += v0_nbr_set[w.first] * u.second * w.second;
-              ctx.tricnt[w.first] += v0_nbr_set[w.first] * u.second * w.second;
-            }
-          }
-        }
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = 0;
-        }
-      }
+      SortNeighbors(*this, frag, ctx.complete_neighbor);
+      CountTriangles(*this, frag, ctx.complete_neighbor, ctx.tricnt);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
@@ -16,12 +16,14 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_CLUSTERING_TRANSITIVITY_H_
 #define ANALYTICAL_ENGINE_APPS_CLUSTERING_TRANSITIVITY_H_
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
 #include "grape/grape.h"
 
 #include "clustering/transitivity_context.h"
+#include "clustering/triangle_kernel.h"
 
 namespace gs {
 /**
@@ -203,66 +205,37 @@ class Transitivity
             }
           });
 
-      typename FRAG_T::template vertex_array_t<uint32_t> v0_nbr_set(vertices,
-                                                                    0);
-      for (auto v : inner_vertices) {
-        auto& v0_nbr_vec = ctx.complete_neighbor[v];
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = u.second;
-        }
-        for (auto u : v0_nbr_vec) {
-          auto& v1_nbr_vec = ctx.complete_neighbor[u.first];
-          for (auto w : v1_nbr_vec) {
-            if (v0_nbr_set[w.first] != 0) {
-              int flag = 0;
-              for (size_t i = 0; i < ctx.complete_outer_neighbor[v].size();
-                   i++) {
-                if (ctx.complete_outer_neighbor[v][i] == u.first ||
-                    ctx.complete_outer_neighbor[v][i] == w.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[v] += w.second;
-              }
-              flag = 0;
-              for (size_t i = 0;
-                   i < ctx.complete_outer_neighbor[u.first].size(); i++) {
-                if (ctx.complete_outer_neighbor[u.first][i] == v ||
-                    ctx.complete_outer_neighbor[u.first][i] == w.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[u.first] += v0_nbr_set[w.first];
-              }
-              flag = 0;
-              for (size_t i = 0;
-                   i < ctx.complete_outer_neighbor[w.first].size(); i++) {
-                if (ctx.complete_outer_neighbor[w.first][i] == v ||
-                    ctx.complete_outer_neighbor[w.first][i] == u.first) {
-                  flag++;
-                }
-                if (flag == 2) {
-                  break;
-                }
-              }
-              if (flag == 2) {
-                ctx.tricnt[w.first] += v0_nbr_set[u.first];
-              }
+      SortNeighbors(*this, frag, ctx.complete_neighbor);
+      SortNeighbors(*this, frag, ctx.complete_outer_neighbor);
+      auto& outer_nbrs = ctx.complete_outer_neighbor;
+      // if both of the vertices are out neighbors of v
+      auto has_out_neighbors = [&outer_nbrs](vertex_t v, vertex_t a,
+                                             vertex_t b) {
+        auto& nbrs = outer_nbrs[v];
+        auto less = [](vertex_t lhs, vertex_t rhs) {
+          return lhs.GetValue() < rhs.GetValue();
+        };
+        return std::binary_search(nbrs.begin(), nbrs.end(), a, less) &&
+               std::binary_search(nbrs.begin(), nbrs.end(), b, less);
+      };
+      ForEachTriangle(
+          *this, frag, ctx.complete_neighbor,
+          [&ctx, &has_out_neighbors](
+              int tid, vertex_t v, const std::pair<vertex_t, uint32_t>& u,
+              const std::pair<vertex_t, uint32_t>& w,
+              const std::pair<vertex_t, uint32_t>& w_of_v) {
+            int w_weight = static_cast<int>(w_of_v.second);
+            if (has_out_neighbors(v, u.first, w.first)) {
+              grape::atomic_add(ctx.tricnt[v], static_cast<int>(w.second));
             }
-          }
-        }
-        for (auto u : v0_nbr_vec) {
-          v0_nbr_set[u.first] = 0;
-        }
-      }
+            if (has_out_neighbors(u.first, v, w.first)) {
+              grape::atomic_add(ctx.tricnt[u.first], w_weight);
+            }
+            if (has_out_neighbors(w.first, v, u.first)) {
+              grape::atomic_add(ctx.tricnt[w.first],
+                                static_cast<int>(u.second));
+            }
+          });
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
@@ -0,0 +1,192 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_KERNEL_H_
+#define ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_KERNEL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/fragment/sorted_adj_list.h"
+#include "core/utils/parallel_utils.h"
+
+namespace gs {
+
+namespace triangle_kernel_impl {
+
+// the neighbors are either the vertices, or the vertices with the weights
+template <typename VID_T>
+inline grape::Vertex<VID_T> vertex_of(const grape::Vertex<VID_T>& v) {
+  return v;
+}
+
+template <typename VID_T, typename W_T>
+inline grape::Vertex<VID_T> vertex_of(
+    const std::pair<grape::Vertex<VID_T>, W_T>& nbr) {
+  return nbr.first;
+}
+
+template <typename VID_T>
+inline int weight_of(const grape::Vertex<VID_T>&) {
+  return 1;
+}
+
+template <typename VID_T, typename W_T>
+inline int weight_of(const std::pair<grape::Vertex<VID_T>, W_T>& nbr) {
+  return static_cast<int>(nbr.second);
+}
+
+template <typename NBR_T>
+inline auto key_of(const NBR_T& nbr) -> decltype(vertex_of(nbr).GetValue()) {
+  return vertex_of(nbr).GetValue();
+}
+
+}  // namespace triangle_kernel_impl
+
+/**
+ * @brief Calls func(x, y) for each y of b which is a neighbor in a as well,
+ * where x is the one in a. Both lists are sorted by the vertices, see
+ * SortNeighbors, and intersected by IntersectSortedRuns.
+ */
+template <typename NBR_T, typename FUNC_T>
+void ForEachCommonNeighbor(const std::vector<NBR_T>& a,
+                           const std::vector<NBR_T>& b, const FUNC_T& func) {
+  IntersectSortedRuns(
+      a.data(), a.data() + a.size(), b.data(), b.data() + b.size(),
+      [](const NBR_T& nbr) { return triangle_kernel_impl::key_of(nbr); },
+      [&func](const NBR_T* x, const NBR_T*, const NBR_T* y,
+              const NBR_T* y_end) {
+        for (; y < y_end; ++y) {
+          func(*x, *y);
+        }
+      });
+}
+
+/**
+ * @brief Sorts the neighbor lists of all the vertices by the vertices, in
+ * parallel by the app.
+ */
+template <typename APP_T, typename FRAG_T, typename NBR_ARRAY_T>
+void SortNeighbors(APP_T& app, const FRAG_T& frag,
+                   NBR_ARRAY_T& complete_neighbor) {
+  using vertex_t = typename FRAG_T::vertex_t;
+  app.ForEach(frag.Vertices(), [&complete_neighbor](int tid, vertex_t v) {
+    auto& nbrs = complete_neighbor[v];
+    using nbr_t = typename std::decay<decltype(nbrs[0])>::type;
+    std::sort(nbrs.begin(), nbrs.end(), [](const nbr_t& lhs, const nbr_t& rhs) {
+      return triangle_kernel_impl::key_of(lhs) <
+             triangle_kernel_impl::key_of(rhs);
+    });
+  });
+}
+
+/**
+ * @brief Calls func(tid, v, begin, end) for the neighbors [begin, end) of each
+ * inner vertex v in parallel by the threads of the app, balanced by the
+ * neighbors rather than the vertices, so the neighbors of a hub may be split
+ * into the parts handled by different threads, see parallel_for_balanced.
+ */
+template <typename APP_T, typename FRAG_T, typename NBR_ARRAY_T,
+          typename FUNC_T>
+void ForEachNeighborPart(APP_T& app, const FRAG_T& frag,
+                         const NBR_ARRAY_T& complete_neighbor,
+                         const FUNC_T& func) {
+  using vertex_t = typename FRAG_T::vertex_t;
+  auto inner_vertices = frag.InnerVertices();
+  auto first = inner_vertices.begin().GetValue();
+  parallel_for_balanced(
+      inner_vertices.size(), app.thread_num(),
+      [&](size_t i) { return complete_neighbor[vertex_t(first + i)].size(); },
+      [&](size_t tid, size_t i, size_t begin, size_t end) {
+        func(static_cast<int>(tid), vertex_t(first + i), begin, end);
+      });
+}
+
+/**
+ * @brief Enumerates the triangles (v, u, w) with v an inner vertex, u a
+ * neighbor of v, and w a neighbor of both, over the degree ordered neighbor
+ * lists sorted by SortNeighbors, i.e., each triangle once. func(tid, v, x, y,
+ * z) is called per triangle, where x is the neighbor u of v, y the neighbor w
+ * of u, and z the neighbor w of v.
+ */
+template <typename APP_T, typename FRAG_T, typename NBR_ARRAY_T,
+          typename FUNC_T>
+void ForEachTriangle(APP_T& app, const FRAG_T& frag,
+                     const NBR_ARRAY_T& complete_neighbor, const FUNC_T& func) {
+  ForEachNeighborPart(
+      app, frag, complete_neighbor,
+      [&complete_neighbor, &func](int tid, const auto& v, size_t begin,
+                                  size_t end) {
+        auto& v_nbrs = complete_neighbor[v];
+        for (size_t k = begin; k < end; ++k) {
+          auto& x = v_nbrs[k];
+          auto& u_nbrs = complete_neighbor[triangle_kernel_impl::vertex_of(x)];
+          ForEachCommonNeighbor(v_nbrs, u_nbrs,
+                                [&](const auto& z, const auto& y) {
+                                  func(tid, v, x, y, z);
+                                });
+        }
+      });
+}
+
+/**
+ * @brief Adds the number of the triangles each vertex belongs to, to tricnt,
+ * where a triangle counts the product of the weights of its three neighbors,
+ * i.e., of w in the neighbors of v, of u in v and of w in u. The count of v
+ * and u are added once per vertex and per neighbor respectively, so a
+ * triangle costs a single atomic add.
+ */
+template <typename APP_T, typename FRAG_T, typename NBR_ARRAY_T,
+          typename CNT_ARRAY_T>
+void CountTriangles(APP_T& app, const FRAG_T& frag,
+                    const NBR_ARRAY_T& complete_neighbor, CNT_ARRAY_T& tricnt) {
+  using triangle_kernel_impl::vertex_of;
+  using triangle_kernel_impl::weight_of;
+  ForEachNeighborPart(
+      app, frag, complete_neighbor,
+      [&complete_neighbor, &tricnt](int tid, const auto& v, size_t begin,
+                                    size_t end) {
+        auto& v_nbrs = complete_neighbor[v];
+        int v_count = 0;
+        for (size_t k = begin; k < end; ++k) {
+          auto& x = v_nbrs[k];
+          auto u = vertex_of(x);
+          int u_count = 0;
+          ForEachCommonNeighbor(
+              v_nbrs, complete_neighbor[u],
+              [&x, &tricnt, &u_count](const auto& z, const auto& y) {
+                int count = weight_of(z) * weight_of(x) * weight_of(y);
+                u_count += count;
+                grape::atomic_add(tricnt[vertex_of(y)], count);
+              });
+          if (u_count != 0) {
+            v_count += u_count;
+            grape::atomic_add(tricnt[u], u_count);
+          }
+        }
+        if (v_count != 0) {
+          grape::atomic_add(tricnt[v], v_count);
+        }
+      });
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CLUSTERING_TRIANGLE_KERNEL_H_
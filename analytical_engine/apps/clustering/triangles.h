@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "grape/grape.h"
 
+#include "clustering/triangle_kernel.h"
 #include "clustering/triangles_context.h"
 
 namespace gs {
@@ -107,35 +108,8 @@ class Triangles
             }
           });
 
-      std::vector<grape::DenseVertexSet<vid_t>> vertexsets(thread_num());
-
-      ForEach(
-          inner_vertices,
-          [&vertexsets, &frag](int tid) {
-            auto& ns = vertexsets[tid];
-            ns.Init(frag.Vertices());
-          },
-          [&vertexsets, &ctx](int tid, vertex_t v) {
-            auto& v0_nbr_set = vertexsets[tid];
-            auto& v0_nbr_vec = ctx.complete_neighbor[v];
-            for (auto u : v0_nbr_vec) {
-              v0_nbr_set.Insert(u);
-            }
-            for (auto u : v0_nbr_vec) {
-              auto& v1_nbr_vec = ctx.complete_neighbor[u];
-              for (auto w : v1_nbr_vec) {
-                if (v0_nbr_set.Exist(w)) {
-                  grape::atomic_add(ctx.tricnt[u], 1);
-                  grape::atomic_add(ctx.tricnt[v], 1);
-                  grape::atomic_add(ctx.tricnt[w], 1);
-                }
-              }
-            }
-            for (auto u : v0_nbr_vec) {
-              v0_nbr_set.Erase(u);
-            }
-          },
-          [](int tid) {});
+      SortNeighbors(*this, frag, ctx.complete_neighbor);
+      CountTriangles(*this, frag, ctx.complete_neighbor, ctx.tricnt);
 
       ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
         if (ctx.tricnt[v] != 0) {
@@ -0,0 +1,210 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cuda/cuda_kernels.h"
+
+#include <cuda_runtime.h>
+
+#include "cuda/cuda_utils.h"
+
+namespace gs {
+namespace cuda {
+
+namespace {
+
+constexpr int kBlockSize = 256;
+
+inline int blockNum(size_t n) {
+  size_t blocks = (n + kBlockSize - 1) / kBlockSize;
+  return static_cast<int>(blocks < 65535 ? (blocks == 0 ? 1 : blocks) : 65535);
+}
+
+// a thread per vertex, by the grid-stride loop
+#define GRID_STRIDE_LOOP(i, n)                                           \
+  for (size_t i = blockIdx.x * blockDim.x + threadIdx.x; i < (n);        \
+       i += static_cast<size_t>(blockDim.x) * gridDim.x)
+
+template <RelaxOp OP>
+__device__ inline unsigned long long relaxed(unsigned long long value,
+                                             const double* weights,
+                                             int64_t e) {
+  if (OP == RelaxOp::kLabel) {
+    return value;
+  } else if (OP == RelaxOp::kHop) {
+    return value + 1;
+  } else {
+    return static_cast<unsigned long long>(__double_as_longlong(
+        __longlong_as_double(static_cast<long long>(value)) + weights[e]));
+  }
+}
+
+template <RelaxOp OP>
+__global__ void relaxKernel(const int64_t* offsets, const uint32_t* nbrs,
+                            const double* weights, const uint8_t* active,
+                            unsigned long long* values, uint8_t* updated,
+                            uint32_t ivnum) {
+  GRID_STRIDE_LOOP(v, ivnum) {
+    if (!active[v]) {
+      continue;
+    }
+    unsigned long long value = values[v];
+    for (int64_t e = offsets[v]; e < offsets[v + 1]; ++e) {
+      uint32_t u = nbrs[e];
+      unsigned long long candidate = relaxed<OP>(value, weights, e);
+      if (candidate < values[u] &&
+          atomicMin(&values[u], candidate) > candidate) {
+        updated[u] = 1;
+      }
+    }
+  }
+}
+
+__global__ void applyMinKernel(const uint32_t* indices,
+                               const unsigned long long* messages, size_t n,
+                               unsigned long long* values, uint8_t* updated) {
+  GRID_STRIDE_LOOP(i, n) {
+    uint32_t v = indices[i];
+    if (atomicMin(&values[v], messages[i]) > messages[i]) {
+      updated[v] = 1;
+    }
+  }
+}
+
+__global__ void countKernel(const uint8_t* flags, uint32_t n,
+                            unsigned long long* counter) {
+  unsigned long long local = 0;
+  GRID_STRIDE_LOOP(i, n) { local += flags[i] != 0; }
+  if (local != 0) {
+    atomicAdd(counter, local);
+  }
+}
+
+__global__ void pageRankPushKernel(const int64_t* offsets, const uint32_t* nbrs,
+                                   const double* contrib, double* next,
+                                   uint32_t ivnum) {
+  GRID_STRIDE_LOOP(v, ivnum) {
+    double c = contrib[v];
+    if (c == 0) {
+      continue;
+    }
+    for (int64_t e = offsets[v]; e < offsets[v + 1]; ++e) {
+      atomicAdd(&next[nbrs[e]], c);
+    }
+  }
+}
+
+__global__ void danglingSumKernel(const int64_t* offsets, const double* rank,
+                                  uint32_t ivnum, double* sum) {
+  double local = 0;
+  GRID_STRIDE_LOOP(v, ivnum) {
+    if (offsets[v] == offsets[v + 1]) {
+      local += rank[v];
+    }
+  }
+  if (local != 0) {
+    atomicAdd(sum, local);
+  }
+}
+
+__global__ void pageRankUpdateKernel(const int64_t* offsets,
+                                     const double* received, double* next,
+                                     double* rank, double* contrib,
+                                     uint32_t ivnum, uint32_t tvnum,
+                                     double base, double delta) {
+  GRID_STRIDE_LOOP(v, tvnum) {
+    if (v < ivnum) {
+      double r = base + delta * (next[v] + received[v]);
+      int64_t degree = offsets[v + 1] - offsets[v];
+      rank[v] = r;
+      contrib[v] = degree == 0 ? 0 : r / degree;
+    }
+    next[v] = 0;
+  }
+}
+
+}  // namespace
+
+void Relax(RelaxOp op, const int64_t* offsets, const uint32_t* nbrs,
+           const double* weights, const uint8_t* active, uint64_t* values,
+           uint8_t* updated, uint32_t ivnum) {
+  auto* target = reinterpret_cast<unsigned long long*>(values);
+  switch (op) {
+  case RelaxOp::kLabel:
+    relaxKernel<RelaxOp::kLabel><<<blockNum(ivnum), kBlockSize>>>(
+        offsets, nbrs, weights, active, target, updated, ivnum);
+    break;
+  case RelaxOp::kHop:
+    relaxKernel<RelaxOp::kHop><<<blockNum(ivnum), kBlockSize>>>(
+        offsets, nbrs, weights, active, target, updated, ivnum);
+    break;
+  case RelaxOp::kDistance:
+    relaxKernel<RelaxOp::kDistance><<<blockNum(ivnum), kBlockSize>>>(
+        offsets, nbrs, weights, active, target, updated, ivnum);
+    break;
+  }
+  CHECK_CUDA(cudaGetLastError());
+}
+
+void ApplyMin(const uint32_t* indices, const uint64_t* messages, size_t n,
+              uint64_t* values, uint8_t* updated) {
+  if (n == 0) {
+    return;
+  }
+  applyMinKernel<<<blockNum(n), kBlockSize>>>(
+      indices, reinterpret_cast<const unsigned long long*>(messages), n,
+      reinterpret_cast<unsigned long long*>(values), updated);
+  CHECK_CUDA(cudaGetLastError());
+}
+
+uint64_t Count(const uint8_t* flags, uint32_t n, uint64_t* counter) {
+  uint64_t count = 0;
+  CHECK_CUDA(cudaMemset(counter, 0, sizeof(uint64_t)));
+  countKernel<<<blockNum(n), kBlockSize>>>(
+      flags, n, reinterpret_cast<unsigned long long*>(counter));  // NOLINT
+  CHECK_CUDA(cudaGetLastError());
+  CHECK_CUDA(
+      cudaMemcpy(&count, counter, sizeof(uint64_t), cudaMemcpyDeviceToHost));
+  return count;
+}
+
+void PageRankPush(const int64_t* offsets, const uint32_t* nbrs,
+                  const double* contrib, double* next, uint32_t ivnum) {
+  pageRankPushKernel<<<blockNum(ivnum), kBlockSize>>>(offsets, nbrs, contrib,
+                                                       next, ivnum);
+  CHECK_CUDA(cudaGetLastError());
+}
+
+double DanglingSum(const int64_t* offsets, const double* rank, uint32_t ivnum,
+                   double* sum) {
+  double result = 0;
+  CHECK_CUDA(cudaMemset(sum, 0, sizeof(double)));
+  danglingSumKernel<<<blockNum(ivnum), kBlockSize>>>(offsets, rank, ivnum,
+                                                      sum);
+  CHECK_CUDA(cudaGetLastError());
+  CHECK_CUDA(cudaMemcpy(&result, sum, sizeof(double), cudaMemcpyDeviceToHost));
+  return result;
+}
+
+void PageRankUpdate(const int64_t* offsets, const double* received,
+                    double* next, double* rank, double* contrib,
+                    uint32_t ivnum, uint32_t tvnum, double base,
+                    double delta) {
+  pageRankUpdateKernel<<<blockNum(tvnum), kBlockSize>>>(
+      offsets, received, next, rank, contrib, ivnum, tvnum, base, delta);
+  CHECK_CUDA(cudaGetLastError());
+}
+
+}  // namespace cuda
+}  // namespace gs
@@ -0,0 +1,85 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_CUDA_KERNELS_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_CUDA_KERNELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * The kernels of the cuda apps, compiled by nvcc from cuda_kernels.cu, and
+ * called by the apps compiled by the host compiler, so the arguments are the
+ * plain pointers to the device memory. The vertices are indexed by their
+ * offsets in Vertices() of the fragment, i.e., the inner vertices first, and
+ * the lists of the neighbors of the inner vertices are in CSR, see
+ * DeviceCSR.
+ */
+namespace gs {
+namespace cuda {
+
+// the ways to relax the value of a neighbor by the value of a vertex, as an
+// unsigned 64-bit integer to take the minimum of
+enum class RelaxOp {
+  // the component ids
+  kLabel,
+  // the hops, i.e., the value plus 1
+  kHop,
+  // the distances, i.e., the bits of the non-negative doubles plus the edge
+  // weights, of which the order agrees with the one of the doubles
+  kDistance,
+};
+
+/**
+ * @brief For the active inner vertices, relaxes the values of the neighbors
+ * by atomic minimum, and flags the updated ones in updated.
+ */
+void Relax(RelaxOp op, const int64_t* offsets, const uint32_t* nbrs,
+           const double* weights, const uint8_t* active, uint64_t* values,
+           uint8_t* updated, uint32_t ivnum);
+
+// relaxes the values of the n vertices in indices by the ones in the messages
+void ApplyMin(const uint32_t* indices, const uint64_t* messages, size_t n,
+              uint64_t* values, uint8_t* updated);
+
+// the number of the non-zero flags, counted in counter
+uint64_t Count(const uint8_t* flags, uint32_t n, uint64_t* counter);
+
+/**
+ * @brief Adds the contribution of each inner vertex to the next ranks of the
+ * neighbors, including the outer vertices, of which the sums are sent to
+ * the owners.
+ */
+void PageRankPush(const int64_t* offsets, const uint32_t* nbrs,
+                  const double* contrib, double* next, uint32_t ivnum);
+
+// the sum of the ranks of the inner vertices without outgoing edges
+double DanglingSum(const int64_t* offsets, const double* rank, uint32_t ivnum,
+                   double* sum);
+
+/**
+ * @brief Updates the ranks of the inner vertices by the sums pushed locally
+ * and the ones received, and the contributions to push in the next round,
+ * then clears the sums of all the vertices.
+ */
+void PageRankUpdate(const int64_t* offsets, const double* received,
+                    double* next, double* rank, double* contrib,
+                    uint32_t ivnum, uint32_t tvnum, double base,
+                    double delta);
+
+}  // namespace cuda
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_CUDA_KERNELS_H_
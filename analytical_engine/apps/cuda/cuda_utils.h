@@ -0,0 +1,129 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_CUDA_UTILS_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_CUDA_UTILS_H_
+
+#include <cuda_runtime_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "glog/logging.h"
+
+#define CHECK_CUDA(call)                                            \
+  do {                                                              \
+    cudaError_t __err = (call);                                     \
+    CHECK_EQ(__err, cudaSuccess) << #call << ": "                   \
+                                 << cudaGetErrorString(__err);      \
+  } while (0)
+
+namespace gs {
+
+/**
+ * @brief Selects the GPU of a worker, i.e., the workers of a host share the
+ * GPUs of it in turn by their fids, which are numbered by the hosts.
+ */
+inline void SelectDevice(int fid) {
+  int device_num = 0;
+  CHECK_CUDA(cudaGetDeviceCount(&device_num));
+  CHECK_GT(device_num, 0) << "No GPU is found for the cuda apps";
+  CHECK_CUDA(cudaSetDevice(fid % device_num));
+}
+
+/**
+ * @brief An array in the device memory, which is freed with the array.
+ */
+template <typename T>
+class DeviceArray {
+ public:
+  DeviceArray() : data_(nullptr), size_(0) {}
+
+  explicit DeviceArray(size_t size) : DeviceArray() { Resize(size); }
+
+  DeviceArray(const DeviceArray&) = delete;
+  DeviceArray& operator=(const DeviceArray&) = delete;
+
+  ~DeviceArray() { Clear(); }
+
+  void Resize(size_t size) {
+    Clear();
+    if (size != 0) {
+      CHECK_CUDA(cudaMalloc(&data_, size * sizeof(T)));
+      size_ = size;
+    }
+  }
+
+  void Clear() {
+    if (data_ != nullptr) {
+      CHECK_CUDA(cudaFree(data_));
+    }
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  void SetZero() {
+    if (size_ != 0) {
+      CHECK_CUDA(cudaMemset(data_, 0, size_ * sizeof(T)));
+    }
+  }
+
+  // copies n elements from the host to [begin, begin + n)
+  void CopyFromHost(const T* src, size_t n, size_t begin = 0) {
+    CHECK_LE(begin + n, size_);
+    if (n != 0) {
+      CHECK_CUDA(cudaMemcpy(data_ + begin, src, n * sizeof(T),
+                            cudaMemcpyHostToDevice));
+    }
+  }
+
+  // copies [begin, begin + n) to n elements of the host
+  void CopyToHost(T* dst, size_t n, size_t begin = 0) const {
+    CHECK_LE(begin + n, size_);
+    if (n != 0) {
+      CHECK_CUDA(cudaMemcpy(dst, data_ + begin, n * sizeof(T),
+                            cudaMemcpyDeviceToHost));
+    }
+  }
+
+  // copies n elements in the device memory to [begin, begin + n)
+  void CopyFromDevice(const T* src, size_t n, size_t begin = 0) {
+    CHECK_LE(begin + n, size_);
+    if (n != 0) {
+      CHECK_CUDA(cudaMemcpy(data_ + begin, src, n * sizeof(T),
+                            cudaMemcpyDeviceToDevice));
+    }
+  }
+
+  void Swap(DeviceArray& rhs) {
+    std::swap(data_, rhs.data_);
+    std::swap(size_, rhs.size_);
+  }
+
+  T* data() { return data_; }
+
+  const T* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+ private:
+  T* data_;
+  size_t size_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_CUDA_UTILS_H_
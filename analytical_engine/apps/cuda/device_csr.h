@@ -0,0 +1,130 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_CSR_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_CSR_H_
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "cuda/cuda_utils.h"
+
+namespace gs {
+
+namespace device_csr_impl {
+
+template <typename EDATA_T, typename NBR_T>
+inline typename std::enable_if<std::is_arithmetic<EDATA_T>::value,
+                               double>::type
+weight_of(const NBR_T& e) {
+  return static_cast<double>(e.get_data());
+}
+
+template <typename EDATA_T, typename NBR_T>
+inline typename std::enable_if<!std::is_arithmetic<EDATA_T>::value,
+                               double>::type
+weight_of(const NBR_T&) {
+  return 1;
+}
+
+}  // namespace device_csr_impl
+
+/**
+ * @brief The outgoing or the incoming lists of the inner vertices of a
+ * fragment in the device memory, in CSR, uploaded once at the creation. The
+ * vertices are indexed by their offsets in Vertices(), see Index, so the
+ * inner vertices are in [0, ivnum) and the outer ones in [ivnum, tvnum).
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class DeviceCSR {
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+  using edata_t = typename FRAG_T::edata_t;
+
+ public:
+  /**
+   * @param incoming The incoming lists, or the outgoing ones.
+   * @param weighted Whether to upload the numeric edge data as the weights,
+   * or 1 for the edges without one.
+   */
+  void Init(const FRAG_T& frag, bool incoming, bool weighted) {
+    auto inner_vertices = frag.InnerVertices();
+    CHECK_LT(frag.Vertices().size(), std::numeric_limits<uint32_t>::max());
+    ivnum_ = static_cast<uint32_t>(inner_vertices.size());
+    tvnum_ = static_cast<uint32_t>(frag.Vertices().size());
+    base_ = frag.Vertices().begin().GetValue();
+
+    std::vector<int64_t> offsets;
+    std::vector<uint32_t> nbrs;
+    std::vector<double> weights;
+    offsets.reserve(ivnum_ + 1);
+    offsets.push_back(0);
+    for (auto v : inner_vertices) {
+      auto es = incoming ? frag.GetIncomingAdjList(v)
+                         : frag.GetOutgoingAdjList(v);
+      for (auto& e : es) {
+        nbrs.push_back(Index(e.get_neighbor()));
+        if (weighted) {
+          weights.push_back(device_csr_impl::weight_of<edata_t>(e));
+        }
+      }
+      offsets.push_back(static_cast<int64_t>(nbrs.size()));
+    }
+
+    offsets_.Resize(offsets.size());
+    offsets_.CopyFromHost(offsets.data(), offsets.size());
+    nbrs_.Resize(nbrs.size());
+    nbrs_.CopyFromHost(nbrs.data(), nbrs.size());
+    weights_.Resize(weights.size());
+    weights_.CopyFromHost(weights.data(), weights.size());
+  }
+
+  inline uint32_t Index(const vertex_t& v) const {
+    return static_cast<uint32_t>(v.GetValue() - base_);
+  }
+
+  inline vertex_t Vertex(uint32_t index) const {
+    return vertex_t(base_ + index);
+  }
+
+  uint32_t ivnum() const { return ivnum_; }
+
+  uint32_t tvnum() const { return tvnum_; }
+
+  const int64_t* offsets() const { return offsets_.data(); }
+
+  const uint32_t* nbrs() const { return nbrs_.data(); }
+
+  // the weights of the edges, or null if not weighted
+  const double* weights() const { return weights_.data(); }
+
+ private:
+  uint32_t ivnum_ = 0;
+  uint32_t tvnum_ = 0;
+  vid_t base_ = 0;
+  DeviceArray<int64_t> offsets_;
+  DeviceArray<uint32_t> nbrs_;
+  DeviceArray<double> weights_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_CSR_H_
@@ -0,0 +1,167 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_MIN_PROPAGATION_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_MIN_PROPAGATION_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "cuda/cuda_kernels.h"
+#include "cuda/cuda_utils.h"
+#include "cuda/device_csr.h"
+
+namespace gs {
+
+/**
+ * @brief The propagation of the minimum values along the edges on the GPU,
+ * shared by WCCCuda, BFSCuda and SSSPCuda. A round applies the messages,
+ * relaxes the edges of the fragment until no inner vertex is updated, then
+ * syncs the updated outer vertices to their owners by the message manager,
+ * so the query converges once no message is sent.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class DeviceMinPropagation {
+  using vertex_t = typename FRAG_T::vertex_t;
+
+ public:
+  /**
+   * @param op How a value is relaxed by an edge.
+   * @param both_directions Relaxes the incoming edges as well, for the
+   * directed fragments.
+   * @param values The initial values of the vertices, by the indices of
+   * DeviceCSR.
+   * @param sources The indices of the inner vertices to relax from first.
+   */
+  void Init(const FRAG_T& frag, cuda::RelaxOp op, bool both_directions,
+            const std::vector<uint64_t>& values,
+            const std::vector<uint32_t>& sources) {
+    SelectDevice(frag.fid());
+    op_ = op;
+    bool weighted = op == cuda::RelaxOp::kDistance;
+    oe_.Init(frag, false, weighted);
+    both_directions_ = both_directions && frag.directed();
+    if (both_directions_) {
+      ie_.Init(frag, true, weighted);
+    }
+    uint32_t tvnum = oe_.tvnum();
+    CHECK_EQ(values.size(), tvnum);
+    values_.Resize(tvnum);
+    values_.CopyFromHost(values.data(), tvnum);
+    updated_.Resize(tvnum);
+    updated_.SetZero();
+    active_.Resize(oe_.ivnum());
+    counter_.Resize(1);
+
+    std::vector<uint8_t> active(oe_.ivnum(), 0);
+    for (auto i : sources) {
+      active[i] = 1;
+    }
+    active_.CopyFromHost(active.data(), active.size());
+  }
+
+  /**
+   * @brief Applies the values received, relaxes the edges until the local
+   * convergence, and sends the values of the updated outer vertices.
+   */
+  template <typename MESSAGE_MANAGER_T>
+  void Round(const FRAG_T& frag, MESSAGE_MANAGER_T& messages,
+             bool from_sources) {
+    uint32_t ivnum = oe_.ivnum(), tvnum = oe_.tvnum();
+
+    if (!from_sources) {
+      receive(frag, messages);
+      active_.CopyFromDevice(updated_.data(), ivnum);
+      CHECK_CUDA(cudaMemset(updated_.data(), 0, ivnum));
+    }
+    while (cuda::Count(active_.data(), ivnum, counter_.data()) != 0) {
+      cuda::Relax(op_, oe_.offsets(), oe_.nbrs(), oe_.weights(),
+                  active_.data(), values_.data(), updated_.data(), ivnum);
+      if (both_directions_) {
+        cuda::Relax(op_, ie_.offsets(), ie_.nbrs(), ie_.weights(),
+                    active_.data(), values_.data(), updated_.data(), ivnum);
+      }
+      active_.CopyFromDevice(updated_.data(), ivnum);
+      CHECK_CUDA(cudaMemset(updated_.data(), 0, ivnum));
+    }
+
+    // the flags of the outer vertices are kept over the local iterations
+    std::vector<uint8_t> updated(tvnum - ivnum);
+    std::vector<uint64_t> values(tvnum - ivnum);
+    updated_.CopyToHost(updated.data(), updated.size(), ivnum);
+    values_.CopyToHost(values.data(), values.size(), ivnum);
+    for (size_t i = 0; i < updated.size(); ++i) {
+      if (updated[i]) {
+        messages.template SyncStateOnOuterVertex<FRAG_T, uint64_t>(
+            frag, oe_.Vertex(ivnum + i), values[i]);
+      }
+    }
+    CHECK_CUDA(cudaMemset(updated_.data() + ivnum, 0, tvnum - ivnum));
+  }
+
+  // copies the values of the inner vertices to func(v, value)
+  template <typename FUNC_T>
+  void Download(const FUNC_T& func) const {
+    std::vector<uint64_t> values(oe_.ivnum());
+    values_.CopyToHost(values.data(), values.size());
+    for (uint32_t i = 0; i < oe_.ivnum(); ++i) {
+      func(oe_.Vertex(i), values[i]);
+    }
+  }
+
+  const DeviceCSR<FRAG_T>& csr() const { return oe_; }
+
+ private:
+  template <typename MESSAGE_MANAGER_T>
+  void receive(const FRAG_T& frag, MESSAGE_MANAGER_T& messages) {
+    std::vector<uint32_t> indices;
+    std::vector<uint64_t> received;
+    vertex_t v;
+    uint64_t msg;
+    while (messages.template GetMessage<FRAG_T, uint64_t>(frag, v, msg)) {
+      indices.push_back(oe_.Index(v));
+      received.push_back(msg);
+    }
+    if (indices.empty()) {
+      return;
+    }
+    if (indices_.size() < indices.size()) {
+      indices_.Resize(indices.size());
+      received_.Resize(indices.size());
+    }
+    indices_.CopyFromHost(indices.data(), indices.size());
+    received_.CopyFromHost(received.data(), received.size());
+    cuda::ApplyMin(indices_.data(), received_.data(), indices.size(),
+                   values_.data(), updated_.data());
+  }
+
+  cuda::RelaxOp op_;
+  bool both_directions_ = false;
+  DeviceCSR<FRAG_T> oe_, ie_;
+  DeviceArray<uint64_t> values_;
+  DeviceArray<uint8_t> updated_;
+  DeviceArray<uint8_t> active_;
+  DeviceArray<uint64_t> counter_;
+  DeviceArray<uint32_t> indices_;
+  DeviceArray<uint64_t> received_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_DEVICE_MIN_PROPAGATION_H_
@@ -0,0 +1,166 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
+
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/app_base.h"
+#include "cuda/cuda_kernels.h"
+#include "cuda/cuda_utils.h"
+#include "cuda/device_csr.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class PageRankCudaContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  explicit PageRankCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, double delta,
+            int max_round) {
+    this->delta = delta;
+    this->max_round = max_round;
+    step = 0;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (auto v : frag.InnerVertices()) {
+      os << frag.GetId(v) << " " << result[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<double>& result;
+  double delta = 0.85;
+  int max_round = 10;
+  int step = 0;
+
+  DeviceCSR<FRAG_T> csr;
+  // the ranks and the contributions of the inner vertices, the sums pushed
+  // to all the vertices, and the ones received for the inner vertices
+  DeviceArray<double> rank, contrib, next, received;
+  DeviceArray<double> scratch;
+};
+
+/**
+ * @brief PageRank on the GPU, where the ranks of the inner vertices are
+ * pushed along the outgoing edges in the device memory, and the sums on the
+ * outer vertices are sent to their owners by the message manager. The
+ * ranks of the vertices without outgoing edges are spread to all the
+ * vertices.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class PageRankCuda : public AppBase<FRAG_T, PageRankCudaContext<FRAG_T>>,
+                     public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(PageRankCuda<FRAG_T>, PageRankCudaContext<FRAG_T>,
+                         FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    SelectDevice(frag.fid());
+    ctx.csr.Init(frag, false, false);
+    uint32_t ivnum = ctx.csr.ivnum(), tvnum = ctx.csr.tvnum();
+    double init = 1.0 / frag.GetTotalVerticesNum();
+
+    std::vector<double> rank(ivnum, init), contrib(ivnum, 0);
+    uint32_t i = 0;
+    for (auto v : frag.InnerVertices()) {
+      int degree = frag.GetLocalOutDegree(v);
+      contrib[i++] = degree == 0 ? 0 : init / degree;
+    }
+    ctx.rank.Resize(ivnum);
+    ctx.rank.CopyFromHost(rank.data(), ivnum);
+    ctx.contrib.Resize(ivnum);
+    ctx.contrib.CopyFromHost(contrib.data(), ivnum);
+    ctx.next.Resize(tvnum);
+    ctx.next.SetZero();
+    ctx.received.Resize(ivnum);
+    ctx.scratch.Resize(1);
+
+    if (ctx.max_round > 0) {
+      push(frag, ctx, messages);
+      messages.ForceContinue();
+    }
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    uint32_t ivnum = ctx.csr.ivnum(), tvnum = ctx.csr.tvnum();
+
+    std::vector<double> received(ivnum, 0);
+    vertex_t v;
+    double msg;
+    while (messages.GetMessage<fragment_t, double>(frag, v, msg)) {
+      received[ctx.csr.Index(v)] += msg;
+    }
+    ctx.received.CopyFromHost(received.data(), ivnum);
+
+    double dangling = cuda::DanglingSum(ctx.csr.offsets(), ctx.rank.data(),
+                                        ivnum, ctx.scratch.data());
+    double total_dangling = 0;
+    Sum(dangling, total_dangling);
+    double n = static_cast<double>(frag.GetTotalVerticesNum());
+    double base = (1 - ctx.delta) / n + ctx.delta * total_dangling / n;
+    cuda::PageRankUpdate(ctx.csr.offsets(), ctx.received.data(),
+                         ctx.next.data(), ctx.rank.data(), ctx.contrib.data(),
+                         ivnum, tvnum, base, ctx.delta);
+
+    if (++ctx.step < ctx.max_round) {
+      push(frag, ctx, messages);
+      messages.ForceContinue();
+    }
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    std::vector<double> rank(ctx.csr.ivnum());
+    ctx.rank.CopyToHost(rank.data(), rank.size());
+    for (uint32_t i = 0; i < rank.size(); ++i) {
+      ctx.result[ctx.csr.Vertex(i)] = rank[i];
+    }
+  }
+
+ private:
+  // pushes the contributions, and sends the sums of the outer vertices
+  void push(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    uint32_t ivnum = ctx.csr.ivnum(), tvnum = ctx.csr.tvnum();
+    cuda::PageRankPush(ctx.csr.offsets(), ctx.csr.nbrs(), ctx.contrib.data(),
+                       ctx.next.data(), ivnum);
+
+    std::vector<double> sums(tvnum - ivnum);
+    ctx.next.CopyToHost(sums.data(), sums.size(), ivnum);
+    for (size_t i = 0; i < sums.size(); ++i) {
+      if (sums[i] != 0) {
+        messages.SyncStateOnOuterVertex<fragment_t, double>(
+            frag, ctx.csr.Vertex(ivnum + i), sums[i]);
+      }
+    }
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_PAGERANK_CUDA_H_
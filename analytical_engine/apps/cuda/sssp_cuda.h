@@ -0,0 +1,113 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/app_base.h"
+#include "cuda/device_min_propagation.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class SSSPCudaContext : public grape::VertexDataContext<FRAG_T, double> {
+  using oid_t = typename FRAG_T::oid_t;
+
+ public:
+  explicit SSSPCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        partial_result(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t src_id) {
+    source_id = src_id;
+    partial_result.SetValue(std::numeric_limits<double>::max());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (auto v : frag.InnerVertices()) {
+      os << frag.GetId(v) << "\t" << partial_result[v] << std::endl;
+    }
+  }
+
+  oid_t source_id;
+  typename FRAG_T::template vertex_array_t<double>& partial_result;
+  DeviceMinPropagation<FRAG_T> propagation;
+};
+
+/**
+ * @brief The single source shortest paths on the GPU, by relaxing the
+ * outgoing edges weighted by the numeric edge data, or 1 without one, until
+ * the local convergence in a round. The distances are kept as the bits of
+ * the doubles for the atomic minimum, so the weights are non-negative, and
+ * the unreachable vertices are of the maximum of double.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class SSSPCuda : public AppBase<FRAG_T, SSSPCudaContext<FRAG_T>> {
+ public:
+  INSTALL_DEFAULT_WORKER(SSSPCuda<FRAG_T>, SSSPCudaContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::vector<uint64_t> values(frag.Vertices().size(),
+                                 toBits(std::numeric_limits<double>::max()));
+    std::vector<uint32_t> sources;
+    vertex_t source;
+    if (frag.GetInnerVertex(ctx.source_id, source)) {
+      auto index = static_cast<uint32_t>(source.GetValue() -
+                                         frag.Vertices().begin().GetValue());
+      values[index] = toBits(0.0);
+      sources.push_back(index);
+    }
+    ctx.propagation.Init(frag, cuda::RelaxOp::kDistance, false, values,
+                         sources);
+    ctx.propagation.Round(frag, messages, true);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    ctx.propagation.Round(frag, messages, false);
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    ctx.propagation.Download([&ctx](const vertex_t& v, uint64_t value) {
+      double distance;
+      memcpy(&distance, &value, sizeof(double));
+      ctx.partial_result[v] = distance;
+    });
+  }
+
+ private:
+  static uint64_t toBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(double));
+    return bits;
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_SSSP_CUDA_H_
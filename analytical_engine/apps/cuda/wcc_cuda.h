@@ -0,0 +1,101 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
+#define ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/app_base.h"
+#include "cuda/device_min_propagation.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class WCCCudaContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  explicit WCCCudaContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages) {}
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (auto v : frag.InnerVertices()) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+  DeviceMinPropagation<FRAG_T> propagation;
+};
+
+/**
+ * @brief The weakly connected components on the GPU, as WCCProjected, where
+ * the smallest gids of the components are propagated along the edges of
+ * both directions in the device memory, and synced on the outer vertices by
+ * the message manager.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class WCCCuda : public AppBase<FRAG_T, WCCCudaContext<FRAG_T>> {
+ public:
+  INSTALL_DEFAULT_WORKER(WCCCuda<FRAG_T>, WCCCudaContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    std::vector<uint64_t> values;
+    std::vector<uint32_t> sources;
+    for (auto v : frag.InnerVertices()) {
+      sources.push_back(values.size());
+      values.push_back(frag.GetInnerVertexGid(v));
+    }
+    for (auto v : frag.OuterVertices()) {
+      values.push_back(frag.GetOuterVertexGid(v));
+    }
+    ctx.propagation.Init(frag, cuda::RelaxOp::kLabel, true, values, sources);
+    ctx.propagation.Round(frag, messages, true);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    ctx.propagation.Round(frag, messages, false);
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    ctx.propagation.Download([&ctx](const vertex_t& v, uint64_t value) {
+      ctx.comp_id[v] = static_cast<vid_t>(value);
+    });
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_CUDA_WCC_CUDA_H_
@@ -0,0 +1,260 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_DFS_BCC_H_
+#define ANALYTICAL_ENGINE_APPS_DFS_BCC_H_
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/config.h"
+#include "dfs/bcc_context.h"
+
+namespace gs {
+/**
+ * @brief The biconnected components of the connected component of a source
+ * vertex, by the low links of Tarjan on the depth-first search of DFS, in
+ * which the edges are undirected. The search is a single token passed
+ * between the fragments, which carries the rank of the last discovered
+ * vertex, and the low link of a vertex is sent back to its parent with the
+ * token when its subtree is finished. A visited outer vertex is found by
+ * its fragment bouncing the token back with its discovery rank.
+ *
+ * A tree edge from p to v starts a component if low[v] >= disc[p], and v is
+ * the head of the component, otherwise the edge is of the component of the
+ * tree edge to p. Each vertex other than the source is labeled by the gid of
+ * the head of the component of the tree edge to it, which is propagated down
+ * the tree after the search, so the component of a head is the vertices of
+ * its label and the parent of the head, which is an articulation point
+ * unless it is the source with a single child.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class BCC : public AppBase<FRAG_T, BCCContext<FRAG_T>>,
+            public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(BCC<FRAG_T>, BCCContext<FRAG_T>, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  // the kinds of the messages of the search
+  enum Kind {
+    // visits the target from the source
+    kVisit = 0,
+    // the target is visited already, and bounces the token back
+    kVisited = 1,
+    // the subtree of the source is finished, back to its parent
+    kReturn = 2,
+    // the search is finished, sent to all the fragments
+    kDone = 3,
+  };
+  // <source gid, target gid, the max rank, a rank, the kind>, where the rank
+  // is the discovery rank of the source for kVisit, the one of the target for
+  // kVisited, and the low link of the source for kReturn
+  using msg_t = std::tuple<vid_t, vid_t, int, int, int>;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    if (ctx.stage == context_t::Stage::kSearch) {
+      msg_t msg;
+      while (messages.GetMessage(msg)) {
+        receive(frag, ctx, messages, msg);
+      }
+      if (ctx.is_in_frag) {
+        search(frag, ctx, messages);
+      }
+      if (ctx.stage == context_t::Stage::kLabel) {
+        label(frag, ctx, messages);
+      }
+    } else {
+      vid_t head;
+      vertex_t u;
+      while (messages.GetMessage<fragment_t, vid_t>(frag, u, head)) {
+        ctx.bcc[u] = head;
+      }
+      label(frag, ctx, messages);
+    }
+  }
+
+ private:
+  void receive(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages, const msg_t& msg) {
+    vid_t src_gid = std::get<0>(msg), dst_gid = std::get<1>(msg);
+    int max_rank = std::get<2>(msg), rank = std::get<3>(msg);
+    int kind = std::get<4>(msg);
+    if (kind == kDone) {
+      ctx.stage = context_t::Stage::kLabel;
+      return;
+    }
+    vertex_t src, dst;
+    frag.Gid2Vertex(src_gid, src);
+    frag.Gid2Vertex(dst_gid, dst);
+    if (kind == kVisit) {
+      ctx.disc[src] = rank;
+      if (ctx.disc[dst] == -1) {
+        ctx.max_rank = max_rank + 1;
+        ctx.disc[dst] = ctx.max_rank;
+        ctx.low[dst] = ctx.max_rank;
+        ctx.parent[dst] = src_gid;
+        ctx.parent_disc[dst] = rank;
+        ctx.current_vertex = dst;
+        ctx.is_in_frag = true;
+      } else {
+        messages.SendToFragment(
+            frag.GetFragId(src),
+            msg_t(dst_gid, src_gid, max_rank, ctx.disc[dst], kVisited));
+      }
+    } else if (kind == kVisited) {
+      ctx.disc[src] = rank;
+      ctx.max_rank = max_rank;
+      ctx.current_vertex = dst;
+      ctx.is_in_frag = true;
+    } else if (kind == kReturn) {
+      ctx.low[dst] = std::min(ctx.low[dst], rank);
+      ctx.max_rank = max_rank;
+      ctx.current_vertex = dst;
+      ctx.is_in_frag = true;
+    }
+  }
+
+  // goes on with the search from the current vertex, till the token leaves
+  // the fragment or the search is finished
+  void search(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    auto v = ctx.current_vertex;
+    while (true) {
+      vertex_t u;
+      if (nextUnvisited(frag, ctx, v, u)) {
+        if (frag.IsInnerVertex(u)) {
+          ctx.parent[u] = frag.Vertex2Gid(v);
+          ctx.parent_disc[u] = ctx.disc[v];
+          ctx.disc[u] = ++ctx.max_rank;
+          ctx.low[u] = ctx.disc[u];
+          v = u;
+        } else {
+          // the rank u gets if it is not visited yet, or the one bounced back
+          ctx.disc[u] = ctx.max_rank + 1;
+          messages.SendToFragment(
+              frag.GetFragId(u),
+              msg_t(frag.Vertex2Gid(v), frag.Vertex2Gid(u), ctx.max_rank,
+                    ctx.disc[v], kVisit));
+          break;
+        }
+      } else if (ctx.parent[v] == context_t::kNone) {
+        for (fid_t fid = 0; fid < frag.fnum(); ++fid) {
+          messages.SendToFragment(fid, msg_t(0, 0, ctx.max_rank, 0, kDone));
+        }
+        break;
+      } else {
+        ctx.is_head[v] = ctx.low[v] >= ctx.parent_disc[v];
+        vertex_t p;
+        frag.Gid2Vertex(ctx.parent[v], p);
+        if (frag.IsInnerVertex(p)) {
+          ctx.low[p] = std::min(ctx.low[p], ctx.low[v]);
+          v = p;
+        } else {
+          messages.SendToFragment(
+              frag.GetFragId(p), msg_t(frag.Vertex2Gid(v), ctx.parent[v],
+                                       ctx.max_rank, ctx.low[v], kReturn));
+          break;
+        }
+      }
+    }
+    ctx.is_in_frag = false;
+  }
+
+  // the first unvisited neighbor of v other than its parent, with the low
+  // link of v updated by the visited ones, which are all scanned once v has
+  // no unvisited neighbor left
+  bool nextUnvisited(const fragment_t& frag, context_t& ctx, const vertex_t& v,
+                     vertex_t& next) {
+    vid_t parent = ctx.parent[v];
+    auto scan = [&](const auto& es) {
+      for (auto& e : es) {
+        auto u = e.get_neighbor();
+        if (frag.Vertex2Gid(u) == parent) {
+          continue;
+        }
+        if (ctx.disc[u] == -1) {
+          next = u;
+          return true;
+        }
+        ctx.low[v] = std::min(ctx.low[v], ctx.disc[u]);
+      }
+      return false;
+    };
+    if (scan(frag.GetOutgoingAdjList(v))) {
+      return true;
+    }
+    return frag.directed() && scan(frag.GetIncomingAdjList(v));
+  }
+
+  // labels the inner vertices reached by the search, of which the labels of
+  // the parents are known, and sends the new labels to the mirrors
+  void label(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    std::vector<vertex_t> chain;
+    for (auto v : inner_vertices) {
+      if (ctx.bcc[v] != context_t::kNone || ctx.disc[v] == -1 ||
+          ctx.parent[v] == context_t::kNone) {
+        continue;
+      }
+      // walks up to a head or a labeled parent, the children of the source
+      // are all heads
+      vid_t head = context_t::kNone;
+      auto w = v;
+      while (true) {
+        chain.push_back(w);
+        if (ctx.is_head[w]) {
+          head = frag.Vertex2Gid(w);
+          break;
+        }
+        vertex_t p;
+        frag.Gid2Vertex(ctx.parent[w], p);
+        if (ctx.bcc[p] != context_t::kNone) {
+          head = ctx.bcc[p];
+          break;
+        } else if (!frag.IsInnerVertex(p)) {
+          break;
+        }
+        w = p;
+      }
+      if (head != context_t::kNone) {
+        for (auto& u : chain) {
+          ctx.bcc[u] = head;
+          messages.SendMsgThroughEdges<fragment_t, vid_t>(frag, u, head);
+        }
+      }
+      chain.clear();
+    }
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_DFS_BCC_H_
@@ -0,0 +1,97 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_DFS_BCC_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_DFS_BCC_CONTEXT_H_
+
+#include <limits>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class BCCContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  // the stages of BCC, the search of the tree, and the labeling after it
+  enum class Stage { kSearch, kLabel };
+
+  static constexpr vid_t kNone = std::numeric_limits<vid_t>::max();
+
+  explicit BCCContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                  true),
+        bcc(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, oid_t source_id) {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    auto vertices = frag.Vertices();
+
+    bcc.Init(vertices, kNone);
+    disc.Init(vertices, -1);
+    low.Init(inner_vertices, -1);
+    parent.Init(inner_vertices, kNone);
+    parent_disc.Init(inner_vertices, -1);
+    is_head.Init(inner_vertices, false);
+    stage = Stage::kSearch;
+    is_in_frag = false;
+    max_rank = 0;
+    vertex_t source;
+    if (frag.GetInnerVertex(source_id, source)) {
+      is_in_frag = true;
+      current_vertex = source;
+      disc[source] = 0;
+      low[source] = 0;
+    }
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << bcc[v] << std::endl;
+    }
+  }
+
+  // the gid of the head of the component of the tree edge from the parent
+  // of a vertex, kNone for the source and the vertices not reached, which is
+  // synced to the mirrors of the inner vertices
+  typename FRAG_T::template vertex_array_t<vid_t>& bcc;
+  // the discovery rank of a vertex, -1 if not visited, which of an outer
+  // vertex is the one known by the fragment
+  typename FRAG_T::template vertex_array_t<int> disc;
+  // the least discovery rank reached from the subtree of a vertex by a back
+  // edge at most
+  typename FRAG_T::template vertex_array_t<int> low;
+  typename FRAG_T::template vertex_array_t<vid_t> parent;
+  typename FRAG_T::template vertex_array_t<int> parent_disc;
+  // whether the tree edge from the parent starts a component, i.e., the
+  // parent is an articulation point or the source
+  typename FRAG_T::template vertex_array_t<bool> is_head;
+  Stage stage;
+  vertex_t current_vertex;
+  bool is_in_frag;
+  int max_rank;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_DFS_BCC_CONTEXT_H_
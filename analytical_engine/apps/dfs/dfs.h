@@ -29,7 +29,10 @@ namespace gs {
 /**
  * @brief Depth-first search. The predecessor or successor will be found and
  * hold in the context. The behavior of the algorithm can be controlled by a
- * source vertex.
+ * source vertex. The search visits the neighbors in the order of the
+ * adjacency lists, or the inner ones first when local_first, which is still a
+ * depth-first order, but crosses the fragments only when no unvisited inner
+ * neighbor is left.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -110,16 +113,9 @@ class DFS : public AppBase<FRAG_T, DFSContext<FRAG_T>>,
     if (is_in_frag) {
       auto current_vertex = ctx.current_vertex;
       while (true) {
-        bool message_send = false;
-        int num_visited = 0;
-        auto es = frag.GetOutgoingAdjList(current_vertex);
-        for (auto& e : es) {
-          auto u = e.neighbor;
-          if (ctx.is_visited[u] == true) {
-            num_visited++;
-          }
-        }
-        if (num_visited == frag.GetLocalOutDegree(current_vertex) &&
+        vertex_t u;
+        bool has_unvisited = nextUnvisited(frag, ctx, current_vertex, u);
+        if (!has_unvisited &&
             frag.Vertex2Gid(current_vertex) != ctx.source_gid) {
           vid_t gid = ctx.parent[current_vertex];
           vertex_t parent_vertex;
@@ -135,8 +131,7 @@ class DFS : public AppBase<FRAG_T, DFSContext<FRAG_T>>,
             messages.SendToFragment(fid, msg);
             break;
           }
-        } else if (num_visited == frag.GetLocalOutDegree(current_vertex) &&
-                   frag.Vertex2Gid(current_vertex) == ctx.source_gid) {
+        } else if (!has_unvisited) {
           std::tuple<std::pair<vid_t, vid_t>, int, bool> msg =
               std::make_tuple(std::make_pair(0, 0), -1, false);
           for (fid_t fid = 0; fid < frag.fnum(); fid++) {
@@ -144,30 +139,20 @@ class DFS : public AppBase<FRAG_T, DFSContext<FRAG_T>>,
           }
           break;
         } else {
-          auto es = frag.GetOutgoingAdjList(current_vertex);
-          for (auto& e : es) {
-            auto u = e.neighbor;
-            if (ctx.is_visited[u] == false) {
-              ctx.is_visited[u] = true;
-              if (frag.IsInnerVertex(u)) {
-                ctx.parent[u] = frag.Vertex2Gid(current_vertex);
-                ctx.rank[u] = ctx.max_rank + 1;
-                ctx.max_rank++;
-                current_vertex = u;
-              } else {
-                vid_t gid = frag.Vertex2Gid(u);
-                std::tuple<std::pair<vid_t, vid_t>, int, bool> msg =
-                    std::make_tuple(
-                        std::make_pair(frag.Vertex2Gid(current_vertex), gid),
-                        ctx.max_rank, true);
-                fid_t fid = frag.GetFragId(u);
-                messages.SendToFragment(fid, msg);
-                message_send = true;
-              }
-              break;
-            }
-          }
-          if (message_send) {
+          ctx.is_visited[u] = true;
+          if (frag.IsInnerVertex(u)) {
+            ctx.parent[u] = frag.Vertex2Gid(current_vertex);
+            ctx.rank[u] = ctx.max_rank + 1;
+            ctx.max_rank++;
+            current_vertex = u;
+          } else {
+            vid_t gid = frag.Vertex2Gid(u);
+            std::tuple<std::pair<vid_t, vid_t>, int, bool> msg =
+                std::make_tuple(
+                    std::make_pair(frag.Vertex2Gid(current_vertex), gid),
+                    ctx.max_rank, true);
+            fid_t fid = frag.GetFragId(u);
+            messages.SendToFragment(fid, msg);
             break;
           }
         }
@@ -222,6 +207,28 @@ class DFS : public AppBase<FRAG_T, DFSContext<FRAG_T>>,
       }
     }
   }
+
+ private:
+  // the next neighbor of v to visit, in the order of the adjacency list, or
+  // the first unvisited inner one if any when local_first
+  bool nextUnvisited(const fragment_t& frag, const context_t& ctx,
+                     const vertex_t& v, vertex_t& next) {
+    bool found = false;
+    for (auto& e : frag.GetOutgoingAdjList(v)) {
+      auto u = e.neighbor;
+      if (ctx.is_visited[u] == false) {
+        if (!ctx.local_first || frag.IsInnerVertex(u)) {
+          next = u;
+          return true;
+        }
+        if (!found) {
+          next = u;
+          found = true;
+        }
+      }
+    }
+    return found;
+  }
 };
 };  // namespace gs
 
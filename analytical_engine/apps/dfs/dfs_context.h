@@ -36,8 +36,12 @@ class DFSContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   explicit DFSContext(const FRAG_T& fragment)
       : TensorContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
 
+  /**
+   * @param local_first Whether to visit the inner neighbors first, so the
+   * search crosses the fragments less often.
+   */
   void Init(grape::DefaultMessageManager& messages, oid_t source_id,
-            std::string dfs_format) {
+            std::string dfs_format, bool local_first = false) {
     auto& frag = this->fragment();
     auto inner_vertices = frag.InnerVertices();
     auto vertices = frag.Vertices();
@@ -47,6 +51,7 @@ class DFSContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
     is_visited.Init(vertices, false);
     this->is_in_frag = false;
     this->output_stage = false;
+    this->local_first = local_first;
     this->total_num = 0;
     vertex_t source;
     bool native_source = frag.GetInnerVertex(source_id, source);
@@ -93,6 +98,7 @@ class DFSContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   std::vector<oid_t> results;
   bool is_in_frag;
   bool output_stage;
+  bool local_first;
   vid_t source_gid;
   int max_rank;
   int total_num;
@@ -0,0 +1,204 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_H_
+#define ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "apps/fused/fused_analytics_context.h"
+#include "core/app/app_base.h"
+#include "core/worker/default_worker.h"
+
+namespace gs {
+/**
+ * @brief Co-schedules the degree centrality, the PageRank and the WCC in a
+ * single run. A round scans the incoming edges of a vertex once for both the
+ * sum of the ranks and the minimum of the component ids of the neighbors,
+ * and a single message carries both the rank and the component id of a
+ * vertex to the fragments that hold it as an outer vertex. The ranks are the
+ * same as the ones of grape::PageRank with the same delta and max_round, and
+ * the components are labelled by the least gid in them, as grape::WCC does.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class FusedAnalytics
+    : public grape::ParallelAppBase<FRAG_T, FusedAnalyticsContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(FusedAnalytics<FRAG_T>, FusedAnalyticsContext<FRAG_T>,
+                          FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  // the rank and the component id of a vertex
+  using msg_t = std::pair<double, vid_t>;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    auto outer_vertices = frag.OuterVertices();
+
+    messages.InitChannels(thread_num());
+
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+    double max_degree = graph_vnum - 1;
+    double p = 1.0 / graph_vnum;
+    auto type = ctx.degree_centrality_type;
+
+    ForEach(outer_vertices, [&frag, &ctx](int tid, vertex_t v) {
+      ctx.comp_id[v] = frag.GetOuterVertexGid(v);
+    });
+    ForEach(inner_vertices, [&frag, &ctx, &messages, max_degree, p, type](
+                                int tid, vertex_t u) {
+      int in_degree = frag.GetLocalInDegree(u);
+      int out_degree = frag.GetLocalOutDegree(u);
+      switch (type) {
+      case DegreeCentralityType::IN:
+        ctx.centrality[u] = in_degree / max_degree;
+        break;
+      case DegreeCentralityType::OUT:
+        ctx.centrality[u] = out_degree / max_degree;
+        break;
+      case DegreeCentralityType::BOTH:
+        ctx.centrality[u] =
+            static_cast<double>(in_degree + out_degree) / max_degree;
+        break;
+      }
+
+      ctx.degree[u] = out_degree;
+      ctx.rank[u] = out_degree > 0 ? p / out_degree : p;
+      ctx.comp_id[u] = frag.GetInnerVertexGid(u);
+      messages.Channels()[tid].SendMsgThroughEdges<fragment_t, msg_t>(
+          frag, u, msg_t(ctx.rank[u], ctx.comp_id[u]));
+    });
+
+    for (auto u : inner_vertices) {
+      if (ctx.degree[u] == 0) {
+        ++ctx.dangling_vnum;
+      }
+    }
+    double dangling_sum = p * static_cast<double>(ctx.dangling_vnum);
+    Sum(dangling_sum, ctx.dangling_sum);
+
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    int thrd_num = thread_num();
+
+    ++ctx.step;
+    // the ranks are updated in the first max_round rounds, and sent in all of
+    // them but the last one, while the component ids are sent only when
+    // changed, until none of them changes any more
+    bool ranking = ctx.step <= ctx.max_round;
+    bool sending_ranks = ctx.step < ctx.max_round;
+
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+    double base = (1.0 - ctx.delta) / graph_vnum +
+                  ctx.delta * ctx.dangling_sum / graph_vnum;
+
+    messages.ParallelProcess<fragment_t, msg_t>(
+        thrd_num, frag, [&ctx](int tid, vertex_t u, const msg_t& msg) {
+          ctx.rank[u] = msg.first;
+          ctx.comp_id[u] = std::min(ctx.comp_id[u], msg.second);
+        });
+
+    bool directed = frag.directed();
+    std::vector<size_t> changed(thrd_num, 0);
+    ForEach(inner_vertices, [&frag, &ctx, &messages, &changed, base, directed,
+                             ranking, sending_ranks](int tid, vertex_t u) {
+      double cur = 0;
+      vid_t cid = ctx.comp_id[u];
+      for (auto& e : frag.GetIncomingAdjList(u)) {
+        auto v = e.get_neighbor();
+        cur += ctx.rank[v];
+        cid = std::min(cid, ctx.comp_id[v]);
+      }
+      // the incoming and the outgoing edges are the same when undirected
+      if (directed) {
+        for (auto& e : frag.GetOutgoingAdjList(u)) {
+          cid = std::min(cid, ctx.comp_id[e.get_neighbor()]);
+        }
+      }
+
+      if (ranking) {
+        ctx.next_rank[u] = ctx.degree[u] == 0
+                               ? base
+                               : (ctx.delta * cur + base) / ctx.degree[u];
+      }
+      ctx.next_comp_id[u] = cid;
+      bool comp_changed = cid != ctx.comp_id[u];
+      if (comp_changed) {
+        ++changed[tid];
+      }
+      if (sending_ranks || comp_changed) {
+        double r = ranking ? ctx.next_rank[u] : ctx.rank[u];
+        messages.Channels()[tid].SendMsgThroughEdges<fragment_t, msg_t>(
+            frag, u, msg_t(r, cid));
+      }
+    });
+
+    ForEach(inner_vertices, [&ctx](int tid, vertex_t u) {
+      ctx.comp_id[u] = ctx.next_comp_id[u];
+    });
+    if (ranking) {
+      ctx.rank.Swap(ctx.next_rank);
+      double new_dangling = base * static_cast<double>(ctx.dangling_vnum);
+      Sum(new_dangling, ctx.dangling_sum);
+    }
+
+    size_t local_changed = 0, total_changed = 0;
+    for (auto n : changed) {
+      local_changed += n;
+    }
+    Sum(local_changed, total_changed);
+    if (sending_ranks || total_changed > 0) {
+      messages.ForceContinue();
+      return;
+    }
+
+    VLOG(1) << "FusedAnalytics terminates after " << ctx.step << " rounds.";
+    auto dc_idx = ctx.add_column("degree_centrality", ContextDataType::kDouble);
+    auto pr_idx = ctx.add_column("pagerank", ContextDataType::kDouble);
+    auto wcc_idx = ctx.add_column("wcc", ContextDataType::kUInt64);
+    auto col_dc = ctx.template get_typed_column<double>(dc_idx);
+    auto col_pr = ctx.template get_typed_column<double>(pr_idx);
+    auto col_wcc = ctx.template get_typed_column<uint64_t>(wcc_idx);
+    ForEach(inner_vertices,
+            [&ctx, &col_dc, &col_pr, &col_wcc](int tid, vertex_t u) {
+              col_dc->at(u) = ctx.centrality[u];
+              col_pr->at(u) = ctx.degree[u] == 0
+                                  ? ctx.rank[u]
+                                  : ctx.rank[u] * ctx.degree[u];
+              col_wcc->at(u) = ctx.comp_id[u];
+            });
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_H_
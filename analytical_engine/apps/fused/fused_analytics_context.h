@@ -0,0 +1,104 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_CONTEXT_H_
+
+#include <iomanip>
+#include <string>
+
+#include "grape/grape.h"
+
+#include "apps/centrality/degree/degree_centrality_context.h"
+#include "core/context/vertex_property_context.h"
+
+namespace gs {
+/**
+ * @brief Context for FusedAnalytics, which holds the states of the degree
+ * centrality, the PageRank and the WCC of the vertices at the same time, and
+ * puts the results into the columns "degree_centrality", "pagerank" and
+ * "wcc".
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class FusedAnalyticsContext : public VertexPropertyContext<FRAG_T> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+
+  explicit FusedAnalyticsContext(const FRAG_T& fragment)
+      : VertexPropertyContext<FRAG_T>(fragment) {}
+
+  void Init(grape::ParallelMessageManager& messages, double delta,
+            int max_round, const std::string& centrality_type) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+    auto inner_vertices = frag.InnerVertices();
+
+    if (centrality_type == "in") {
+      degree_centrality_type = DegreeCentralityType::IN;
+    } else if (centrality_type == "out") {
+      degree_centrality_type = DegreeCentralityType::OUT;
+    } else if (centrality_type == "both") {
+      degree_centrality_type = DegreeCentralityType::BOTH;
+    } else {
+      LOG(FATAL) << "invalid parameter: " << centrality_type;
+    }
+    this->delta = delta;
+    this->max_round = max_round;
+
+    centrality.Init(inner_vertices, 0.0);
+    degree.Init(inner_vertices, 0);
+    rank.Init(vertices, 0.0);
+    next_rank.Init(vertices);
+    comp_id.Init(vertices);
+    next_comp_id.Init(inner_vertices);
+    step = 0;
+    dangling_vnum = 0;
+    dangling_sum = 0.0;
+  }
+
+  // one line for each vertex, with the ranks in the format of PageRank
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto& u : inner_vertices) {
+      double r = degree[u] == 0 ? rank[u] : rank[u] * degree[u];
+      os << frag.GetId(u) << "\t" << centrality[u] << "\t" << std::scientific
+         << std::setprecision(15) << r << std::defaultfloat
+         << std::setprecision(6) << "\t" << comp_id[u] << std::endl;
+    }
+  }
+
+  DegreeCentralityType degree_centrality_type;
+  double delta;
+  int max_round;
+
+  typename FRAG_T::template vertex_array_t<double> centrality;
+  typename FRAG_T::template vertex_array_t<int> degree;
+  // the ranks of the vertices divided by their out degrees, if any
+  typename FRAG_T::template vertex_array_t<double> rank;
+  typename FRAG_T::template vertex_array_t<double> next_rank;
+  typename FRAG_T::template vertex_array_t<vid_t> comp_id;
+  typename FRAG_T::template vertex_array_t<vid_t> next_comp_id;
+
+  int step;
+  vid_t dangling_vnum;
+  double dangling_sum;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_FUSED_FUSED_ANALYTICS_CONTEXT_H_
@@ -17,8 +17,10 @@ limitations under the License.
 #define ANALYTICAL_ENGINE_APPS_HITS_HITS_H_
 
 #include <algorithm>
+#include <array>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
@@ -123,43 +125,41 @@ class HITS : public grape::ParallelAppBase<FRAG_T, HitsContext<FRAG_T>>,
           thrd_num, frag,
           [&hub](int tid, vertex_t v, double hub_val) { hub[v] = hub_val; });
 
-      double local_max_h = -std::numeric_limits<double>::max();
-      double local_max_a = -std::numeric_limits<double>::max();
-
-      for (auto& u : inner_vertices) {
-        local_max_h = std::max(local_max_h, hub[u]);
-        local_max_a = std::max(local_max_a, auth[u]);
-      }
-
-      {
-        double global_max = -std::numeric_limits<double>::max();
-        Max(local_max_h, global_max);
-
-        double s = 1.0 / global_max;
-        for (auto& u : vertices) {
-          hub[u] *= s;
-        }
-      }
-
-      {
-        double global_max = -std::numeric_limits<double>::max();
-        Max(local_max_a, global_max);
+      // the partial maxima of the hubs and the authorities of the threads
+      std::vector<std::array<double, 2>> maxs(
+          thrd_num, {-std::numeric_limits<double>::max(),
+                     -std::numeric_limits<double>::max()});
+      ForEach(inner_vertices, [&hub, &auth, &maxs](int tid, vertex_t u) {
+        maxs[tid][0] = std::max(maxs[tid][0], hub[u]);
+        maxs[tid][1] = std::max(maxs[tid][1], auth[u]);
+      });
+      // both maxima are reduced in a single collective
+      auto global_max = allReduce(maxs, [](double& lhs, double rhs) {
+        lhs = std::max(lhs, rhs);
+      });
 
-        double s = 1.0 / global_max;
-        for (auto& u : vertices) {
-          auth[u] *= s;
-        }
-      }
+      double s_hub = 1.0 / global_max[0];
+      double s_auth = 1.0 / global_max[1];
+      ForEach(vertices, [&hub, &auth, s_hub, s_auth](int tid, vertex_t u) {
+        hub[u] *= s_hub;
+        auth[u] *= s_auth;
+      });
       ctx.stage = AuthIteration;
 
       ++ctx.step;
 
-      double eps = 0.0;
-      for (auto& u : inner_vertices) {
-        eps += fabs(hub[u] - hub_last[u]);
-      }
-      double total_eps = 0.0;
-      Sum(eps, total_eps);
+      // the partial diffs, and the sums of the authorities and the hubs for
+      // the final normalization, which are reduced together as well
+      std::vector<std::array<double, 3>> sums(thrd_num, {0.0, 0.0, 0.0});
+      ForEach(inner_vertices,
+              [&hub, &auth, &hub_last, &sums](int tid, vertex_t u) {
+                sums[tid][0] += fabs(hub[u] - hub_last[u]);
+                sums[tid][1] += auth[u];
+                sums[tid][2] += hub[u];
+              });
+      auto global_sum =
+          allReduce(sums, [](double& lhs, double rhs) { lhs += rhs; });
+      double total_eps = global_sum[0];
       VLOG(1) << "[step - " << ctx.step << " ] Diff: " << total_eps;
       if (total_eps <= tolerance || ctx.step >= ctx.max_round) {
         VLOG(1) << "HITS terminates after " << ctx.step
@@ -167,14 +167,8 @@ class HITS : public grape::ParallelAppBase<FRAG_T, HitsContext<FRAG_T>>,
 
         // normalize result
         if (ctx.normalized) {
-          double local_sum_a = 0;
-          double local_sum_h = 0;
-          for (auto& u : inner_vertices) {
-            local_sum_a += auth[u];
-            local_sum_h += hub[u];
-          }
-          Sum(local_sum_a, ctx.sum_a);
-          Sum(local_sum_h, ctx.sum_h);
+          ctx.sum_a = global_sum[1];
+          ctx.sum_h = global_sum[2];
         }
 
         auto hub_idx = ctx.add_column("hub", ContextDataType::kDouble);
@@ -184,20 +178,47 @@ class HITS : public grape::ParallelAppBase<FRAG_T, HitsContext<FRAG_T>>,
         auto col_hub = ctx.template get_typed_column<double>(hub_idx);
         auto col_auth = ctx.template get_typed_column<double>(auth_idx);
 
-        for (auto& u : inner_vertices) {
-          if (ctx.normalized) {
+        bool normalized = ctx.normalized;
+        ForEach(inner_vertices, [&hub, &auth, &col_hub, &col_auth, normalized,
+                                 s_h, s_a](int tid, vertex_t u) {
+          if (normalized) {
             hub[u] *= s_h;
             auth[u] *= s_a;
           }
           col_hub->at(u) = hub[u];
           col_auth->at(u) = auth[u];
-        }
+        });
         return;
       }
       // this stage does not produce any messages
       messages.ForceContinue();
     }
   }
+
+ private:
+  // merges the partials of the threads, and then the ones of the fragments
+  // by a single collective, slot by slot
+  template <size_t N, typename FUNC_T>
+  std::array<double, N> allReduce(
+      const std::vector<std::array<double, N>>& partials, const FUNC_T& func) {
+    auto merge = [&func](std::array<double, N>& lhs,
+                         const std::array<double, N>& rhs) {
+      for (size_t i = 0; i < N; ++i) {
+        func(lhs[i], rhs[i]);
+      }
+    };
+    std::array<double, N> local = partials[0];
+    for (size_t i = 1; i < partials.size(); ++i) {
+      merge(local, partials[i]);
+    }
+    std::vector<std::array<double, N>> all;
+    AllGather(local, all);
+    std::array<double, N> global = all[0];
+    for (size_t i = 1; i < all.size(); ++i) {
+      merge(global, all[i]);
+    }
+    return global;
+  }
 };
 };  // namespace gs
 
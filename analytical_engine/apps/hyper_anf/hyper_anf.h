@@ -0,0 +1,195 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_H_
+#define ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_H_
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/utils/hyper_log_log.h"
+#include "hyper_anf/hyper_anf_context.h"
+
+namespace gs {
+/**
+ * @brief HyperANF, i.e., the approximate neighborhood function of the graph,
+ * by a HyperLogLog counter per vertex of the vertices reachable in t hops,
+ * which is the union of the counters of the out neighbors in t - 1 hops and
+ * itself. The counters are merged by the max of the registers, only from the
+ * neighbors changed in the last hop, and only the changed registers of an
+ * inner vertex are sent to the fragments having it as an outer vertex, as
+ * pairs of the index and the value of the register packed in a uint32_t.
+ *
+ * The sum of the counters in t hops is the estimated pairs of the vertices
+ * within t hops, from which the effective diameter is interpolated.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class HyperANF
+    : public grape::ParallelAppBase<FRAG_T, HyperANFContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(HyperANF<FRAG_T>, HyperANFContext<FRAG_T>, FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  // the changed registers of a vertex, as (index << 8 | value)
+  using msg_t = std::vector<uint32_t>;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+
+    ForEach(frag.Vertices(), [&frag, &ctx](int tid, vertex_t v) {
+      HLLAdd(ctx.registers[v], ctx.precision, HLLHash(frag.Vertex2Gid(v)));
+    });
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+      ctx.reach[v] = HLLEstimate(ctx.registers[v], ctx.m);
+    });
+    ctx.neighborhood_function.push_back(sumReach(frag, ctx));
+
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    messages.ParallelProcess<fragment_t, msg_t>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, const msg_t& msg) {
+          uint8_t* registers = ctx.registers[u];
+          for (auto reg : msg) {
+            auto value = static_cast<uint8_t>(reg & 0xff);
+            registers[reg >> 8] = std::max(registers[reg >> 8], value);
+          }
+          ctx.changed[u] = true;
+        });
+
+    step(frag, ctx, messages);
+  }
+
+ private:
+  // counts the vertices within one more hop
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    size_t m = ctx.m;
+    // the changes of the last hop are not sent, as no one merges them
+    bool last_hop = ++ctx.hop >= ctx.max_hops;
+
+    ForEach(inner_vertices, [&frag, &ctx, m](int tid, vertex_t v) {
+      uint8_t* next = ctx.next_registers[v];
+      bool merged = false;
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        if (!ctx.changed[u]) {
+          continue;
+        }
+        if (!merged) {
+          std::memcpy(next, ctx.registers[v], m);
+          merged = true;
+        }
+        HLLMerge(next, ctx.registers[u], m);
+      }
+      ctx.updated[v] = merged;
+    });
+
+    // the counters are read by the neighbors above, so they are updated
+    // after all of them are merged
+    ForEach(frag.Vertices(),
+            [&ctx](int tid, vertex_t v) { ctx.changed[v] = false; });
+    std::vector<size_t> changed_num(thread_num(), 0);
+    ForEach(inner_vertices, [&](int tid, vertex_t v) {
+      if (!ctx.updated[v]) {
+        return;
+      }
+      const uint8_t* next = ctx.next_registers[v];
+      uint8_t* curr = ctx.registers[v];
+      msg_t msg;
+      for (size_t i = 0; i < m; ++i) {
+        if (next[i] != curr[i]) {
+          msg.push_back(static_cast<uint32_t>(i << 8 | next[i]));
+        }
+      }
+      if (msg.empty()) {
+        return;
+      }
+      std::memcpy(curr, next, m);
+      ctx.changed[v] = true;
+      ctx.reach[v] = HLLEstimate(curr, m);
+      ++changed_num[tid];
+      if (!last_hop) {
+        messages.Channels()[tid].SendMsgThroughIEdges<fragment_t, msg_t>(
+            frag, v, msg);
+      }
+    });
+
+    size_t local_changed = 0, global_changed = 0;
+    for (auto num : changed_num) {
+      local_changed += num;
+    }
+    Sum(local_changed, global_changed);
+    ctx.neighborhood_function.push_back(sumReach(frag, ctx));
+
+    if (global_changed != 0 && !last_hop) {
+      messages.ForceContinue();
+    } else {
+      finish(frag, ctx);
+    }
+  }
+
+  double sumReach(const fragment_t& frag, context_t& ctx) {
+    double local_sum = 0, global_sum = 0;
+    for (auto v : frag.InnerVertices()) {
+      local_sum += ctx.reach[v];
+    }
+    Sum(local_sum, global_sum);
+    return global_sum;
+  }
+
+  void finish(const fragment_t& frag, context_t& ctx) {
+    auto& nf = ctx.neighborhood_function;
+    double target = 0.9 * nf.back();
+    size_t t = 0;
+    while (t < nf.size() && nf[t] < target) {
+      ++t;
+    }
+    if (t == 0 || t == nf.size()) {
+      ctx.effective_diameter = static_cast<double>(t == 0 ? 0 : t - 1);
+    } else {
+      ctx.effective_diameter =
+          (t - 1) + (target - nf[t - 1]) / (nf[t] - nf[t - 1]);
+    }
+
+    if (frag.fid() == 0) {
+      for (size_t hop = 0; hop < nf.size(); ++hop) {
+        VLOG(1) << "[hyper_anf] N(" << hop << ") = " << nf[hop];
+      }
+      LOG(INFO) << "[hyper_anf] effective diameter: "
+                << ctx.effective_diameter << " within " << nf.size() - 1
+                << " hops";
+    }
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_H_
@@ -0,0 +1,132 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_CONTEXT_H_
+
+#include <cstdint>
+#include <iomanip>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/utils/hyper_log_log.h"
+
+namespace gs {
+/**
+ * @brief The HyperLogLog counters of the vertices in a range, row-major with
+ * the m registers of a vertex adjacent in one array.
+ */
+template <typename VID_T>
+class HLLCounters {
+ public:
+  void Init(const grape::VertexRange<VID_T>& range, size_t m) {
+    begin_ = range.begin().GetValue();
+    m_ = m;
+    data_.assign(static_cast<size_t>(range.size()) * m, 0);
+  }
+
+  inline uint8_t* operator[](const grape::Vertex<VID_T>& v) {
+    return &data_[static_cast<size_t>(v.GetValue() - begin_) * m_];
+  }
+
+  inline const uint8_t* operator[](const grape::Vertex<VID_T>& v) const {
+    return &data_[static_cast<size_t>(v.GetValue() - begin_) * m_];
+  }
+
+ private:
+  VID_T begin_ = 0;
+  size_t m_ = 0;
+  std::vector<uint8_t> data_;
+};
+
+/**
+ * @brief Context for HyperANF, of which the result is the estimated number of
+ * the vertices reachable from each vertex in at most max_hops hops, itself
+ * included.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class HyperANFContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  explicit HyperANFContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        reach(this->data()) {}
+
+  /**
+   * @param max_hops The hops to count the reachable vertices within.
+   * @param precision The counter of a vertex has 2^precision registers, with
+   * the relative standard error about 1.04 / sqrt(2^precision).
+   */
+  void Init(grape::ParallelMessageManager& messages, int max_hops,
+            int precision) {
+    auto& frag = this->fragment();
+
+    CHECK_GT(max_hops, 0);
+    CHECK(precision >= kHLLMinPrecision && precision <= kHLLMaxPrecision)
+        << "The precision of hyper_anf should be in [" << kHLLMinPrecision
+        << ", " << kHLLMaxPrecision << "]";
+    this->max_hops = max_hops;
+    this->precision = precision;
+    m = static_cast<size_t>(1) << precision;
+
+    registers.Init(frag.Vertices(), m);
+    next_registers.Init(frag.InnerVertices(), m);
+    changed.Init(frag.Vertices(), true);
+    updated.Init(frag.InnerVertices(), false);
+    hop = 0;
+    neighborhood_function.clear();
+    effective_diameter = 0;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+         << reach[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<double>& reach;
+  int max_hops = 0;
+  int precision = 0;
+  size_t m = 0;
+
+  // the counters of all the vertices, of which the ones of the outer
+  // vertices are synced from their owners, and the counters of the inner
+  // vertices of the next hop
+  HLLCounters<vid_t> registers;
+  HLLCounters<vid_t> next_registers;
+  // the vertices of which the counters changed in the last hop, and the inner
+  // vertices of which the counters are merged in this hop
+  typename FRAG_T::template vertex_array_t<bool> changed;
+  typename FRAG_T::template vertex_array_t<bool> updated;
+
+  int hop = 0;
+  // the estimated pairs of the vertices within t hops, by t
+  std::vector<double> neighborhood_function;
+  // the hops within which 90% of the reachable pairs are, interpolated
+  double effective_diameter = 0;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_HYPER_ANF_HYPER_ANF_CONTEXT_H_
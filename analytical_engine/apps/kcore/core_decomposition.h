@@ -0,0 +1,197 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
+#define ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief The core decomposition by peeling, shared by KCore and KShell. The
+ * vertices of degree no more than the level are removed level by level, and
+ * a vertex removed at a level is of the core number of the level. Inside a
+ * level, only the neighbors of the removed vertices are checked, as the
+ * degrees decrease, and the first level after a level with nothing removed
+ * is the least degree of the remaining vertices, so the empty levels are
+ * skipped. The decrements on the outer vertices are accumulated, and sent to
+ * the owners once per round.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class CoreDecomposition {
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+ public:
+  /**
+   * @brief Peels the levels up to max_level only, and the vertices remaining
+   * after it, i.e., of the core numbers larger than max_level, are of the
+   * core number -1.
+   */
+  void Init(const FRAG_T& frag, int32_t max_level) {
+    auto inner_vertices = frag.InnerVertices();
+    vid_t lid_num = 0;
+    for (auto v : frag.Vertices()) {
+      lid_num = std::max(lid_num, static_cast<vid_t>(v.GetValue() + 1));
+    }
+
+    degrees_ = std::vector<std::atomic<int32_t>>(lid_num);
+    for (auto v : frag.Vertices()) {
+      degrees_[v.GetValue()].store(
+          frag.IsInnerVertex(v) ? frag.GetLocalOutDegree(v) : 0);
+    }
+    cores_.Init(frag.Vertices(), -1);
+    remaining_.clear();
+    for (auto v : inner_vertices) {
+      remaining_.push_back(v);
+    }
+    frontiers_.assign(1, std::vector<vertex_t>());
+    touched_.clear();
+    level_ = -1;
+    max_level_ = max_level;
+  }
+
+  /**
+   * @brief Runs a round of the peeling, in which the decrements received are
+   * applied, and the vertices of the current level are removed until none is
+   * left locally. Returns true when the peeling is finished.
+   */
+  template <typename APP_T>
+  bool Step(APP_T& app, const FRAG_T& frag,
+            grape::ParallelMessageManager& messages) {
+    int thread_num = app.thread_num();
+    frontiers_.resize(std::max<size_t>(frontiers_.size(), thread_num));
+    touched_.resize(std::max<size_t>(touched_.size(), thread_num));
+
+    int32_t level = level_;
+    messages.ParallelProcess<FRAG_T, int32_t>(
+        thread_num, frag,
+        [this, level](int tid, vertex_t v, int32_t delta) {
+          int32_t degree = degrees_[v.GetValue()].fetch_add(delta);
+          if (degree > level && degree + delta <= level) {
+            frontiers_[tid].push_back(v);
+          }
+        });
+
+    size_t removed_count = 0;
+    std::vector<vertex_t> frontier;
+    gather(frontiers_, frontier);
+    while (!frontier.empty()) {
+      removed_count += frontier.size();
+      app.ForEach(grape::VertexRange<vid_t>(
+                      0, static_cast<vid_t>(frontier.size())),
+                  [this, &frag, &frontier, level](int tid, vertex_t i) {
+                    remove(frag, tid, frontier[i.GetValue()], level);
+                  });
+      gather(frontiers_, frontier);
+    }
+
+    std::vector<vertex_t> touched;
+    gather(touched_, touched);
+    app.ForEach(
+        grape::VertexRange<vid_t>(0, static_cast<vid_t>(touched.size())),
+        [this, &frag, &touched, &messages](int tid, vertex_t i) {
+          auto v = touched[i.GetValue()];
+          int32_t delta = degrees_[v.GetValue()].exchange(0);
+          messages.Channels()[tid].SyncStateOnOuterVertex<FRAG_T, int32_t>(
+              frag, v, delta);
+        });
+
+    size_t global_removed_count = 0;
+    app.Sum(removed_count, global_removed_count);
+    if (global_removed_count != 0) {
+      return false;
+    }
+
+    // the degrees are settled, as nothing is removed in the round
+    remaining_.erase(std::remove_if(remaining_.begin(), remaining_.end(),
+                                    [this](const vertex_t& v) {
+                                      return cores_[v] != -1;
+                                    }),
+                     remaining_.end());
+    int32_t min_degree = std::numeric_limits<int32_t>::max();
+    for (auto v : remaining_) {
+      min_degree = std::min(min_degree, degrees_[v.GetValue()].load());
+    }
+    int32_t global_min_degree = 0;
+    app.Min(min_degree, global_min_degree);
+    if (global_min_degree == std::numeric_limits<int32_t>::max() ||
+        global_min_degree > max_level_) {
+      return true;
+    }
+
+    level_ = global_min_degree;
+    for (auto v : remaining_) {
+      if (degrees_[v.GetValue()].load() == level_) {
+        frontiers_[0].push_back(v);
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief The core number of the inner vertex, or -1 if it is larger than
+   * max_level.
+   */
+  int32_t Coreness(const vertex_t& v) const { return cores_[v]; }
+
+ private:
+  void remove(const FRAG_T& frag, int tid, const vertex_t& u, int32_t level) {
+    cores_[u] = level;
+    for (auto& e : frag.GetOutgoingAdjList(u)) {
+      auto v = e.get_neighbor();
+      int32_t degree = degrees_[v.GetValue()].fetch_sub(1);
+      if (frag.IsInnerVertex(v)) {
+        if (degree == level + 1) {
+          frontiers_[tid].push_back(v);
+        }
+      } else if (degree == 0) {
+        touched_[tid].push_back(v);
+      }
+    }
+  }
+
+  static void gather(std::vector<std::vector<vertex_t>>& lists,
+                     std::vector<vertex_t>& out) {
+    out.clear();
+    for (auto& list : lists) {
+      out.insert(out.end(), list.begin(), list.end());
+      list.clear();
+    }
+  }
+
+  // the degrees of the inner vertices, and the decrements to send of the
+  // outer vertices, by the lids
+  std::vector<std::atomic<int32_t>> degrees_;
+  typename FRAG_T::template vertex_array_t<int32_t> cores_;
+  std::vector<vertex_t> remaining_;
+  std::vector<std::vector<vertex_t>> frontiers_;
+  std::vector<std::vector<vertex_t>> touched_;
+  int32_t level_;
+  int32_t max_level_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_KCORE_CORE_DECOMPOSITION_H_
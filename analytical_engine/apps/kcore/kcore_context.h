@@ -16,55 +16,35 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_KCORE_KCORE_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_KCORE_KCORE_CONTEXT_H_
 
-#include <limits>
-#include <map>
-#include <memory>
-#include <queue>
-#include <unordered_set>
-#include <utility>
-
 #include "grape/grape.h"
 
+#include "kcore/core_decomposition.h"
+
 namespace gs {
 
+/**
+ * @brief Context for KCore, of which the result is a flag of a byte per
+ * vertex, whether the vertex is in the k-core.
+ *
+ * @tparam FRAG_T
+ */
 template <typename FRAG_T>
-class KCoreContext
-    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t> {
+class KCoreContext : public grape::VertexDataContext<FRAG_T, bool> {
  public:
   using oid_t = typename FRAG_T::oid_t;
   using vid_t = typename FRAG_T::vid_t;
 
   explicit KCoreContext(const FRAG_T& fragment)
-      : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
+      : grape::VertexDataContext<FRAG_T, bool>(fragment) {}
 
-  typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
-      degrees;
-  grape::DenseVertexSet<vid_t> to_remove_vertices, remaining_vertices,
-      next_remaining_vertices;
+  CoreDecomposition<FRAG_T> decomposition;
   int k;
-  int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
     auto& frag = this->fragment();
-    auto vertices = frag.Vertices();
-    auto inner_vertices = frag.InnerVertices();
 
-    degrees.Init(vertices);
-    to_remove_vertices.Init(inner_vertices);
-    remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
+    decomposition.Init(frag, k - 1);
     this->k = k;
-    curr_k = 0;
-
-    for (auto& v : vertices) {
-      degrees[v] = std::make_shared<std::atomic_int>(0);
-      if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
-        degrees[v]->store(frag.GetLocalOutDegree(v));
-      } else {
-        degrees[v]->store(0);
-      }
-    }
   }
 
   void Output(std::ostream& os) override {
@@ -72,7 +52,7 @@ class KCoreContext
     auto inner_vertices = frag.InnerVertices();
 
     for (auto& v : inner_vertices) {
-      if (remaining_vertices.Exist(v)) {
+      if (decomposition.Coreness(v) == -1) {
         os << frag.GetId(v) << '\n';
       }
     }
@@ -0,0 +1,258 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_H_
+#define ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_H_
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+#include "khop_sampling/khop_sampling_context.h"
+
+namespace gs {
+
+namespace khop_sampling_impl {
+
+template <typename FRAG_T>
+inline typename std::enable_if<
+    std::is_arithmetic<typename FRAG_T::edata_t>::value>::type
+init_alias_tables(const FRAG_T& frag) {
+  frag.InitOutgoingAliasTables();
+}
+
+template <typename FRAG_T>
+inline typename std::enable_if<
+    !std::is_arithmetic<typename FRAG_T::edata_t>::value>::type
+init_alias_tables(const FRAG_T&) {
+  LOG(FATAL) << "The weighted khop_sampling needs numeric edge data";
+}
+
+}  // namespace khop_sampling_impl
+
+/**
+ * @brief The k-hop neighborhood sampling for the mini-batches of the GNNs,
+ * i.e., fanouts[h] out neighbors are sampled with replacement for each node
+ * of the hop h, uniformly or by the alias tables of the edge weights of
+ * ArrowProjectedFragment, as the nodes of the hop h + 1, from the seeds as
+ * the hop 0, see KHopSamplingContext.
+ *
+ * The fragment owning a seed keeps the subgraph of the seed, and requests
+ * the owners of the nodes of a hop to sample them, in a batch per fragment by
+ * the message manager, while the ones owned by itself are sampled in place.
+ * The owners reply with the sampled neighbors and the data of the vertices
+ * as the features, so a hop takes two rounds, and the features of the last
+ * hop are requested in the end by the fanout 0.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class KHopSampling
+    : public grape::ParallelAppBase<FRAG_T, KHopSamplingContext<FRAG_T>>,
+      public grape::ParallelEngine {
+ public:
+  INSTALL_PARALLEL_WORKER(KHopSampling<FRAG_T>, KHopSamplingContext<FRAG_T>,
+                          FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using request_t = typename context_t::request_t;
+  using reply_t = typename context_t::reply_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kOnlyOut;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    for (int tid = 0; tid < thread_num(); ++tid) {
+      ctx.rngs.emplace_back(ctx.random_seed + frag.fid() * thread_num() + tid);
+    }
+    id_parser_.Init(frag.fnum(), 1);
+    if (ctx.weighted) {
+      khop_sampling_impl::init_alias_tables(frag);
+    }
+
+    for (size_t i = 0; i < ctx.seed_ids.size(); ++i) {
+      vertex_t v;
+      if (frag.GetInnerVertex(ctx.seed_ids[i], v)) {
+        ctx.nodes.push_back(frag.Vertex2Gid(v));
+        ctx.node_seeds.push_back(static_cast<int32_t>(i));
+      }
+    }
+    ctx.hop_offsets = {0, ctx.nodes.size()};
+    ctx.hop = 0;
+
+    request(frag, ctx, messages);
+    serving_ = true;
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    if (serving_) {
+      messages.ParallelProcess<request_t>(
+          thread_num(), [&](int tid, const request_t& msg) {
+            vertex_t v;
+            CHECK(frag.InnerVertexGid2Vertex(std::get<3>(msg), v));
+            reply_t reply;
+            reply.index = std::get<2>(msg);
+            sample(frag, ctx, tid, v, std::get<1>(msg), reply);
+            messages.Channels()[tid].SendToFragment(std::get<0>(msg), reply);
+          });
+      serving_ = false;
+      messages.ForceContinue();
+      return;
+    }
+
+    messages.ParallelProcess<reply_t>(
+        thread_num(), [&ctx](int tid, const reply_t& msg) {
+          ctx.replies[msg.index] = msg;
+        });
+    finishHop(ctx);
+    if (ctx.hop < ctx.fanouts.size()) {
+      ++ctx.hop;
+      request(frag, ctx, messages);
+      serving_ = true;
+      messages.ForceContinue();
+    } else {
+      writeToCtx(frag, ctx);
+    }
+  }
+
+ private:
+  // samples fanout out neighbors of the inner vertex v into reply
+  void sample(const fragment_t& frag, context_t& ctx, int tid,
+              const vertex_t& v, uint32_t fanout, reply_t& reply) {
+    auto& rng = ctx.rngs[tid];
+    reply.feature = frag.GetData(v);
+    reply.nbrs.clear();
+    size_t degree = frag.GetLocalOutDegree(v);
+    if (fanout == 0 || degree == 0) {
+      return;
+    }
+    reply.nbrs.reserve(fanout);
+    if (ctx.weighted) {
+      for (uint32_t i = 0; i < fanout; ++i) {
+        reply.nbrs.push_back(
+            frag.Vertex2Gid(frag.SampleOutgoingNeighbor(v, rng)));
+      }
+      return;
+    }
+    // picks the positions, and the neighbors at them in one pass
+    std::uniform_int_distribution<size_t> pick(0, degree - 1);
+    std::vector<size_t> positions(fanout);
+    for (auto& position : positions) {
+      position = pick(rng);
+    }
+    std::sort(positions.begin(), positions.end());
+    size_t position = 0, index = 0;
+    for (auto& e : frag.GetOutgoingAdjList(v)) {
+      while (index < positions.size() && positions[index] == position) {
+        reply.nbrs.push_back(frag.Vertex2Gid(e.get_neighbor()));
+        ++index;
+      }
+      if (index == positions.size()) {
+        break;
+      }
+      ++position;
+    }
+  }
+
+  // samples the nodes of the current hop owned by this fragment in place,
+  // and requests the owners of the others
+  void request(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    size_t begin = ctx.hop_offsets[ctx.hop];
+    size_t end = ctx.hop_offsets[ctx.hop + 1];
+    uint32_t fanout = ctx.hop < ctx.fanouts.size() ? ctx.fanouts[ctx.hop] : 0;
+    ctx.replies.clear();
+    ctx.replies.resize(end - begin);
+
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(end - begin)),
+            [&](int tid, vertex_t k) {
+              size_t index = k.GetValue();
+              vid_t gid = ctx.nodes[begin + index];
+              grape::fid_t owner = id_parser_.GetFid(gid);
+              if (owner == frag.fid()) {
+                vertex_t v;
+                CHECK(frag.InnerVertexGid2Vertex(gid, v));
+                ctx.replies[index].index = index;
+                sample(frag, ctx, tid, v, fanout, ctx.replies[index]);
+              } else {
+                messages.Channels()[tid].SendToFragment(
+                    owner, request_t(frag.fid(), fanout, index, gid));
+              }
+            });
+  }
+
+  // appends the nodes sampled for the current hop as the next hop, in the
+  // order of the nodes they are sampled for
+  void finishHop(context_t& ctx) {
+    size_t begin = ctx.hop_offsets[ctx.hop];
+    ctx.features.resize(ctx.hop_offsets[ctx.hop + 1]);
+    ctx.indptr.resize(begin);
+    for (size_t k = 0; k < ctx.replies.size(); ++k) {
+      auto& reply = ctx.replies[k];
+      size_t i = begin + k;
+      ctx.features[i] = std::move(reply.feature);
+      ctx.indptr.push_back(ctx.nodes.size());
+      for (auto gid : reply.nbrs) {
+        ctx.nodes.push_back(gid);
+        ctx.node_seeds.push_back(ctx.node_seeds[i]);
+      }
+    }
+    ctx.replies.clear();
+    if (ctx.hop < ctx.fanouts.size()) {
+      ctx.hop_offsets.push_back(ctx.nodes.size());
+    } else {
+      ctx.indptr.push_back(ctx.nodes.size());
+    }
+  }
+
+  void writeToCtx(const fragment_t& frag, context_t& ctx) {
+    std::vector<double> data;
+    size_t edge_num = ctx.nodes.size() - ctx.hop_offsets[1];
+    data.reserve(edge_num * 4);
+    for (size_t hop = 0; hop + 1 < ctx.hop_offsets.size(); ++hop) {
+      for (size_t i = ctx.hop_offsets[hop]; i < ctx.hop_offsets[hop + 1];
+           ++i) {
+        auto src = static_cast<double>(frag.Gid2Oid(ctx.nodes[i]));
+        for (size_t j = ctx.indptr[i]; j < ctx.indptr[i + 1]; ++j) {
+          data.push_back(static_cast<double>(ctx.seed_ids[ctx.node_seeds[i]]));
+          data.push_back(static_cast<double>(hop));
+          data.push_back(src);
+          data.push_back(static_cast<double>(frag.Gid2Oid(ctx.nodes[j])));
+        }
+      }
+    }
+    std::vector<size_t> shape{edge_num, 4};
+    ctx.assign(data, shape);
+  }
+
+  bool serving_ = false;
+  vineyard::IdParser<vid_t> id_parser_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_H_
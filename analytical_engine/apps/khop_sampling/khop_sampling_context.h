@@ -0,0 +1,166 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_CONTEXT_H_
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/context/tensor_context.h"
+
+namespace gs {
+
+/**
+ * @brief The neighbors sampled for a vertex requested by a fragment, i.e.,
+ * the index of the vertex in the nodes of the fragment, the data of the
+ * vertex as its features, and the gids of the sampled neighbors.
+ */
+template <typename VID_T, typename VDATA_T>
+struct KHopSampleReply {
+  uint64_t index = 0;
+  VDATA_T feature{};
+  std::vector<VID_T> nbrs;
+
+  friend grape::InArchive& operator<<(grape::InArchive& in_archive,
+                                      const KHopSampleReply& reply) {
+    in_archive << reply.index;
+    in_archive << reply.feature;
+    in_archive << reply.nbrs;
+    return in_archive;
+  }
+
+  friend grape::OutArchive& operator>>(grape::OutArchive& out_archive,
+                                       KHopSampleReply& reply) {
+    out_archive >> reply.index;
+    out_archive >> reply.feature;
+    out_archive >> reply.nbrs;
+    return out_archive;
+  }
+};
+
+/**
+ * @brief Context for the k-hop neighborhood sampling. The seeds are sampled
+ * by the fragments owning them, each of which keeps the sampled subgraph of
+ * its seeds in CSR, i.e., the nodes by the hops, a node per sampled vertex,
+ * repeated if sampled more than once, with the out neighbors of a node being
+ * the nodes sampled for it in the next hop, and the features of the nodes.
+ *
+ * The result is a row of (seed, hop, src, dst) per sampled edge, in the
+ * order of the edges in the CSR, with the ids of the vertices as doubles.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class KHopSamplingContext : public TensorContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vdata_t = typename FRAG_T::vdata_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  static_assert(std::is_arithmetic<oid_t>::value,
+                "The ids of the vertices are written as doubles");
+
+  // the fragment requesting, the fanout, the index of the node and the gid
+  using request_t = std::tuple<grape::fid_t, uint32_t, uint64_t, vid_t>;
+  using reply_t = KHopSampleReply<vid_t, vdata_t>;
+
+  explicit KHopSamplingContext(const FRAG_T& fragment)
+      : TensorContext<FRAG_T, double>(fragment) {}
+
+  /**
+   * @param seeds The ids of the seeds, separated by the commas.
+   * @param fanouts The neighbors sampled per vertex in each hop, separated by
+   * the commas, e.g., "25,10" for two hops.
+   * @param weighted Whether to sample by the weights of the edges, or else
+   * uniformly, with replacement either way.
+   * @param random_seed The seed of the random numbers.
+   */
+  void Init(grape::ParallelMessageManager& messages, const std::string& seeds,
+            const std::string& fanouts, bool weighted, int64_t random_seed) {
+    std::stringstream ss(seeds);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+      if (token.empty()) {
+        continue;
+      }
+      std::stringstream ts(token);
+      oid_t seed;
+      ts >> seed;
+      CHECK(!ts.fail()) << "Invalid seed of khop_sampling: " << token;
+      seed_ids.push_back(seed);
+    }
+    std::stringstream fs(fanouts);
+    while (std::getline(fs, token, ',')) {
+      if (!token.empty()) {
+        int fanout = std::stoi(token);
+        CHECK_GT(fanout, 0) << "Invalid fanout of khop_sampling: " << token;
+        this->fanouts.push_back(static_cast<uint32_t>(fanout));
+      }
+    }
+    CHECK(!seed_ids.empty());
+    CHECK(!this->fanouts.empty());
+    this->weighted = weighted;
+    this->random_seed = random_seed;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (size_t hop = 0; hop + 1 < hop_offsets.size(); ++hop) {
+      for (size_t i = hop_offsets[hop]; i < hop_offsets[hop + 1]; ++i) {
+        os << seed_ids[node_seeds[i]] << " " << hop << " "
+           << frag.Gid2Oid(nodes[i]);
+        for (size_t j = indptr[i]; j < indptr[i + 1]; ++j) {
+          os << " " << frag.Gid2Oid(nodes[j]);
+        }
+        os << std::endl;
+      }
+    }
+  }
+
+  std::vector<oid_t> seed_ids;
+  std::vector<uint32_t> fanouts;
+  bool weighted = false;
+  int64_t random_seed = 0;
+  std::vector<std::mt19937_64> rngs;
+
+  // the sampled subgraph of the seeds owned by this fragment: the gids of
+  // the nodes, the nodes of the hop h in [hop_offsets[h], hop_offsets[h +
+  // 1]), the nodes sampled for the node i in [indptr[i], indptr[i + 1]), the
+  // index of the seed of a node, and the features of the nodes
+  std::vector<vid_t> nodes;
+  std::vector<size_t> hop_offsets;
+  std::vector<size_t> indptr;
+  std::vector<int32_t> node_seeds;
+  std::vector<vdata_t> features;
+
+  // the hop of the nodes requested in the last round, and the replies to
+  // them, by the indices of the nodes in the hop
+  size_t hop = 0;
+  std::vector<reply_t> replies;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_KHOP_SAMPLING_KHOP_SAMPLING_CONTEXT_H_
@@ -16,15 +16,10 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_KSHELL_KSHELL_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_KSHELL_KSHELL_CONTEXT_H_
 
-#include <limits>
-#include <map>
-#include <memory>
-#include <queue>
-#include <unordered_set>
-#include <utility>
-
 #include "grape/grape.h"
 
+#include "kcore/core_decomposition.h"
+
 namespace gs {
 
 template <typename FRAG_T>
@@ -37,35 +32,14 @@ class KShellContext
   explicit KShellContext(const FRAG_T& fragment)
       : grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
 
-  typename FRAG_T::template vertex_array_t<std::shared_ptr<std::atomic_int>>
-      degrees;
-  grape::DenseVertexSet<vid_t> to_remove_vertices_k, to_remove_vertices_inc,
-      remaining_vertices, next_remaining_vertices;
+  CoreDecomposition<FRAG_T> decomposition;
   int k;
-  int curr_k;
 
   void Init(grape::ParallelMessageManager& messages, int k) {
     auto& frag = this->fragment();
-    auto vertices = frag.Vertices();
-    auto inner_vertices = frag.InnerVertices();
 
-    degrees.Init(vertices);
-    to_remove_vertices_k.Init(inner_vertices);
-    to_remove_vertices_inc.Init(inner_vertices);
-    remaining_vertices.Init(inner_vertices);
-    next_remaining_vertices.Init(inner_vertices);
+    decomposition.Init(frag, k);
     this->k = k;
-    curr_k = 0;
-
-    for (auto& v : vertices) {
-      degrees[v] = std::make_shared<std::atomic_int>(0);
-      if (frag.IsInnerVertex(v)) {
-        remaining_vertices.Insert(v);
-        degrees[v]->store(frag.GetLocalOutDegree(v));
-      } else {
-        degrees[v]->store(0);
-      }
-    }
   }
 
   void Output(std::ostream& os) override {
@@ -73,7 +47,7 @@ class KShellContext
     auto inner_vertices = frag.InnerVertices();
 
     for (auto& v : inner_vertices) {
-      if (to_remove_vertices_k.Exist(v)) {
+      if (decomposition.Coreness(v) == k) {
         os << frag.GetId(v) << '\n';
       }
     }
@@ -0,0 +1,584 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_H_
+#define ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_H_
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "louvain/level_louvain_context.h"
+
+namespace gs {
+
+namespace level_louvain_impl {
+
+template <typename EDATA_T>
+inline double weight_of(const EDATA_T& data) {
+  return static_cast<double>(data);
+}
+
+inline double weight_of(const grape::EmptyType&) { return 1.0; }
+
+}  // namespace level_louvain_impl
+
+/**
+ * @brief The Louvain community detection level by level, on the graph taken
+ * as undirected. Each level runs the sweeps of the local moves on its own
+ * graph, and then coarsens the graph by its communities, i.e., the owner of
+ * a community sums up the edges of its members into the graph of the next
+ * level, so the later levels run on a graph of the communities only rather
+ * than the whole fragment. A sweep takes four rounds: syncing the moved
+ * vertices to the fragments having them as the ghosts, requesting the total
+ * degrees of the communities from the owners, moving the vertices by the
+ * gains in parallel, and applying the changes of the totals by the owners.
+ * The moves of a sweep are to the communities of smaller ids only, or larger
+ * ones only, by turns, so two vertices never swap their communities. A level
+ * ends when two sweeps in a row gain less than the tolerance of modularity,
+ * and the detection ends at a level with no move or at max_levels.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class LevelLouvain
+    : public grape::ParallelAppBase<FRAG_T, LevelLouvainContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(LevelLouvain<FRAG_T>, LevelLouvainContext<FRAG_T>,
+                          FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using stage_t = typename context_t::Stage;
+  // a vertex of the level asked by a fragment
+  using request_t = std::pair<vid_t, grape::fid_t>;
+  // the total degree of a community, or a change of it
+  using total_t = std::pair<vid_t, double>;
+  // the community of a vertex of the level
+  using label_t = std::pair<vid_t, vid_t>;
+  // an edge between two communities, with the weight
+  using edge_t = std::tuple<vid_t, vid_t, double>;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    weights_to_.resize(thread_num());
+
+    for (auto v : frag.InnerVertices()) {
+      ctx.label[v] = frag.GetInnerVertexGid(v);
+    }
+    buildFirstLevel(frag, ctx);
+
+    auto& degrees = ctx.graph.degrees;
+    double two_m = 0;
+    Sum(std::accumulate(degrees.begin(), degrees.end(), 0.0), two_m);
+    ctx.two_m = two_m;
+    if (two_m == 0) {
+      writeResult(frag, ctx);
+      return;
+    }
+    startLevel(frag, ctx, messages);
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    switch (ctx.stage) {
+    case stage_t::kRequestTotal: {
+      messages.ParallelProcess<request_t>(
+          thread_num(),
+          [&frag, &ctx, &messages](int tid, const request_t& msg) {
+            double tot = ctx.tot[indexOf(frag, ctx, msg.first)];
+            messages.Channels()[tid].SendToFragment(msg.second,
+                                                    total_t(msg.first, tot));
+          });
+      ctx.stage = stage_t::kMove;
+      messages.ForceContinue();
+      break;
+    }
+    case stage_t::kMove: {
+      // the placeholders of the requested totals are there, so the map is
+      // not rehashed
+      messages.ParallelProcess<total_t>(
+          thread_num(), [&ctx](int tid, const total_t& msg) {
+            ctx.remote_tot.find(msg.first)->second = msg.second;
+          });
+      sweep(frag, ctx, messages);
+      break;
+    }
+    case stage_t::kApplyDelta: {
+      messages.ParallelProcess<total_t>(
+          thread_num(), [&frag, &ctx](int tid, const total_t& msg) {
+            grape::atomic_add(ctx.tot[indexOf(frag, ctx, msg.first)],
+                              msg.second);
+          });
+      syncCommunities(ctx, messages);
+      ctx.stage = stage_t::kSyncCommunity;
+      messages.ForceContinue();
+      break;
+    }
+    case stage_t::kSyncCommunity: {
+      messages.ParallelProcess<label_t>(
+          thread_num(), [&ctx](int tid, const label_t& msg) {
+            ctx.comm[ctx.graph.ghost_slots.at(msg.first)] = msg.second;
+          });
+      requestTotals(frag, ctx, messages);
+      messages.ForceContinue();
+      break;
+    }
+    case stage_t::kBuild: {
+      std::vector<std::vector<edge_t>> received(thread_num());
+      messages.ParallelProcess<edge_t>(
+          thread_num(), [&received](int tid, const edge_t& msg) {
+            received[tid].push_back(msg);
+          });
+      ctx.coarse_edges.clear();
+      for (auto& edges : received) {
+        ctx.coarse_edges.insert(ctx.coarse_edges.end(), edges.begin(),
+                                edges.end());
+      }
+      requestLabels(frag, ctx, messages);
+      ctx.stage = stage_t::kRelabelReply;
+      messages.ForceContinue();
+      break;
+    }
+    case stage_t::kRelabelReply: {
+      messages.ParallelProcess<request_t>(
+          thread_num(),
+          [&frag, &ctx, &messages](int tid, const request_t& msg) {
+            vid_t c = ctx.comm[indexOf(frag, ctx, msg.first)];
+            messages.Channels()[tid].SendToFragment(msg.second,
+                                                    label_t(msg.first, c));
+          });
+      if (!ctx.last_level) {
+        buildCoarseLevel(frag, ctx);
+      }
+      ctx.stage = stage_t::kRelabel;
+      messages.ForceContinue();
+      break;
+    }
+    case stage_t::kRelabel: {
+      messages.ParallelProcess<label_t>(
+          thread_num(), [&ctx](int tid, const label_t& msg) {
+            ctx.relabels.find(msg.first)->second = msg.second;
+          });
+      ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+        ctx.label[v] = ctx.relabels.find(ctx.label[v])->second;
+      });
+      ctx.relabels.clear();
+      if (ctx.last_level) {
+        writeResult(frag, ctx);
+        break;
+      }
+      ++ctx.level;
+      startLevel(frag, ctx, messages);
+      messages.ForceContinue();
+      break;
+    }
+    }
+  }
+
+ private:
+  static size_t indexOf(const fragment_t& frag, const context_t& ctx,
+                        vid_t gid) {
+    vertex_t v;
+    frag.InnerVertexGid2Vertex(gid, v);
+    return ctx.local_index[v];
+  }
+
+  static double totalOf(const fragment_t& frag, const context_t& ctx,
+                        vid_t c) {
+    if (ctx.id_parser.GetFid(c) == frag.fid()) {
+      return ctx.tot[indexOf(frag, ctx, c)];
+    }
+    return ctx.remote_tot.find(c)->second;
+  }
+
+  // the slot of a neighbor by the gid, adding it as a ghost if it is not
+  // local
+  static size_t addSlot(const fragment_t& frag, context_t& ctx, vid_t gid) {
+    auto& g = ctx.graph;
+    if (ctx.id_parser.GetFid(gid) == frag.fid()) {
+      return indexOf(frag, ctx, gid);
+    }
+    auto iter = g.ghost_slots.find(gid);
+    if (iter != g.ghost_slots.end()) {
+      return iter->second;
+    }
+    size_t slot = g.slot_num();
+    g.ghost_gids.push_back(gid);
+    g.ghost_slots.emplace(gid, slot);
+    return slot;
+  }
+
+  // the graph of the first level is the fragment, with the in edges as well
+  // if directed
+  void buildFirstLevel(const fragment_t& frag, context_t& ctx) {
+    std::vector<vid_t> gids;
+    std::vector<size_t> offsets{0};
+    std::vector<std::pair<vid_t, double>> nbrs;
+    for (auto v : frag.InnerVertices()) {
+      ctx.local_index[v] = gids.size();
+      gids.push_back(frag.GetInnerVertexGid(v));
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        nbrs.emplace_back(frag.Vertex2Gid(e.get_neighbor()),
+                          level_louvain_impl::weight_of(e.get_data()));
+      }
+      if (frag.directed()) {
+        for (auto& e : frag.GetIncomingAdjList(v)) {
+          nbrs.emplace_back(frag.Vertex2Gid(e.get_neighbor()),
+                            level_louvain_impl::weight_of(e.get_data()));
+        }
+      }
+      offsets.push_back(nbrs.size());
+    }
+    buildLevel(frag, ctx, std::move(gids), offsets, nbrs);
+  }
+
+  // the graph of the next level from the edges between the communities
+  // received, where the communities keep their names
+  void buildCoarseLevel(const fragment_t& frag, context_t& ctx) {
+    auto& edges = ctx.coarse_edges;
+    std::sort(edges.begin(), edges.end());
+    for (auto gid : ctx.graph.gids) {
+      vertex_t v;
+      frag.InnerVertexGid2Vertex(gid, v);
+      ctx.local_index[v] = context_t::kNone;
+    }
+
+    std::vector<vid_t> gids;
+    std::vector<size_t> offsets{0};
+    std::vector<std::pair<vid_t, double>> nbrs;
+    for (auto& e : edges) {
+      vid_t c = std::get<0>(e);
+      if (gids.empty() || gids.back() != c) {
+        if (!gids.empty()) {
+          offsets.push_back(nbrs.size());
+        }
+        vertex_t v;
+        frag.InnerVertexGid2Vertex(c, v);
+        ctx.local_index[v] = gids.size();
+        gids.push_back(c);
+      }
+      // the isolated communities are there by the edges of weight 0
+      if (std::get<2>(e) != 0) {
+        nbrs.emplace_back(std::get<1>(e), std::get<2>(e));
+      }
+    }
+    if (!gids.empty()) {
+      offsets.push_back(nbrs.size());
+    }
+    edges.clear();
+    edges.shrink_to_fit();
+    buildLevel(frag, ctx, std::move(gids), offsets, nbrs);
+  }
+
+  // the CSR in slots from the neighbors of the local vertices by the gids,
+  // where the parallel edges are merged
+  void buildLevel(const fragment_t& frag, context_t& ctx,
+                  std::vector<vid_t>&& gids, const std::vector<size_t>& offsets,
+                  std::vector<std::pair<vid_t, double>>& nbrs) {
+    auto& g = ctx.graph;
+    g.clear();
+    g.gids = std::move(gids);
+    size_t n = g.size();
+
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(n)),
+            [&offsets, &nbrs](int tid, vertex_t i) {
+              std::sort(nbrs.begin() + offsets[i.GetValue()],
+                        nbrs.begin() + offsets[i.GetValue() + 1]);
+            });
+
+    g.offsets.push_back(0);
+    g.degrees.assign(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+        g.degrees[i] += nbrs[k].second;
+        if (k > offsets[i] && nbrs[k - 1].first == nbrs[k].first) {
+          g.weights.back() += nbrs[k].second;
+        } else {
+          g.nbrs.push_back(addSlot(frag, ctx, nbrs[k].first));
+          g.weights.push_back(nbrs[k].second);
+        }
+      }
+      g.offsets.push_back(g.nbrs.size());
+    }
+
+    // the edges are symmetric, so the owners of the ghosts of a vertex are
+    // the fragments having it as a ghost
+    std::vector<grape::fid_t> fids;
+    g.mirror_offsets.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+      fids.clear();
+      for (size_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+        if (g.nbrs[k] >= n) {
+          fids.push_back(ctx.id_parser.GetFid(g.ghost_gids[g.nbrs[k] - n]));
+        }
+      }
+      std::sort(fids.begin(), fids.end());
+      fids.erase(std::unique(fids.begin(), fids.end()), fids.end());
+      g.mirrors.insert(g.mirrors.end(), fids.begin(), fids.end());
+      g.mirror_offsets.push_back(g.mirrors.size());
+    }
+  }
+
+  // each vertex of the level starts in a community of its own
+  void startLevel(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages) {
+    auto& g = ctx.graph;
+    size_t n = g.size();
+    ctx.comm.resize(g.slot_num());
+    std::copy(g.gids.begin(), g.gids.end(), ctx.comm.begin());
+    std::copy(g.ghost_gids.begin(), g.ghost_gids.end(),
+              ctx.comm.begin() + n);
+    ctx.tot = g.degrees;
+    ctx.changed.assign(n, 0);
+    ctx.modularity = std::numeric_limits<double>::lowest();
+    ctx.sweep = 0;
+    ctx.stalls = 0;
+    ctx.level_moves = 0;
+    ctx.last_level = ctx.max_levels != 0 && ctx.level + 1 >= ctx.max_levels;
+    requestTotals(frag, ctx, messages);
+  }
+
+  // asks the owners for the totals of the communities of the slots
+  void requestTotals(const fragment_t& frag, context_t& ctx,
+                     message_manager_t& messages) {
+    auto fid = frag.fid();
+    ctx.remote_tot.clear();
+    for (auto c : ctx.comm) {
+      auto owner = ctx.id_parser.GetFid(c);
+      if (owner != fid && ctx.remote_tot.emplace(c, 0).second) {
+        messages.Channels()[0].SendToFragment(owner, request_t(c, fid));
+      }
+    }
+    ctx.stage = stage_t::kRequestTotal;
+  }
+
+  void sweep(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto& g = ctx.graph;
+    size_t n = g.size();
+    grape::VertexRange<vid_t> range(0, static_cast<vid_t>(n));
+    double two_m = ctx.two_m;
+
+    // the modularity sums up the internal weights of the communities, and
+    // the squared totals of the ones owned
+    std::vector<double> partials(thread_num(), 0);
+    ForEach(range, [&g, &ctx, &partials, two_m](int tid, vertex_t v) {
+      size_t i = v.GetValue();
+      double in = 0;
+      for (size_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+        if (ctx.comm[g.nbrs[k]] == ctx.comm[i]) {
+          in += g.weights[k];
+        }
+      }
+      double share = ctx.tot[i] / two_m;
+      partials[tid] += in / two_m - share * share;
+    });
+    double modularity = 0;
+    Sum(std::accumulate(partials.begin(), partials.end(), 0.0), modularity);
+    if (modularity - ctx.modularity < ctx.tolerance) {
+      ++ctx.stalls;
+    } else {
+      ctx.stalls = 0;
+    }
+    ctx.modularity = modularity;
+    if (ctx.stalls >= 2 || ctx.sweep >= ctx.max_sweeps) {
+      endLevel(frag, ctx, messages);
+      return;
+    }
+
+    bool to_smaller = ctx.sweep % 2 == 0;
+    std::vector<vid_t> next(n);
+    std::vector<size_t> moves(thread_num(), 0);
+    ForEach(range, [this, &frag, &g, &ctx, &next, &moves, to_smaller,
+                    two_m](int tid, vertex_t v) {
+      size_t i = v.GetValue();
+      vid_t c = ctx.comm[i];
+      next[i] = c;
+      double degree = g.degrees[i];
+      if (degree == 0) {
+        return;
+      }
+      auto& weights_to = weights_to_[tid];
+      weights_to.clear();
+      for (size_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+        if (g.nbrs[k] != i) {
+          weights_to[ctx.comm[g.nbrs[k]]] += g.weights[k];
+        }
+      }
+
+      // the gain of joining a community d, up to the constant of leaving c
+      double scale = degree / two_m;
+      auto iter = weights_to.find(c);
+      double best = (iter == weights_to.end() ? 0 : iter->second) -
+                    (totalOf(frag, ctx, c) - degree) * scale;
+      vid_t best_c = c;
+      for (auto& pair : weights_to) {
+        vid_t d = pair.first;
+        if (d == c || (to_smaller ? d > c : d < c)) {
+          continue;
+        }
+        double gain = pair.second - totalOf(frag, ctx, d) * scale;
+        if (gain > best || (gain == best && best_c != c && d < best_c)) {
+          best = gain;
+          best_c = d;
+        }
+      }
+      if (best_c != c) {
+        next[i] = best_c;
+        ++moves[tid];
+      }
+    });
+
+    ForEach(range, [&frag, &g, &ctx, &messages, &next](int tid, vertex_t v) {
+      size_t i = v.GetValue();
+      ctx.changed[i] = 0;
+      if (next[i] == ctx.comm[i]) {
+        return;
+      }
+      addTotal(frag, ctx, messages, tid, ctx.comm[i], -g.degrees[i]);
+      addTotal(frag, ctx, messages, tid, next[i], g.degrees[i]);
+      ctx.comm[i] = next[i];
+      ctx.changed[i] = 1;
+    });
+
+    size_t moved = 0;
+    Sum(std::accumulate(moves.begin(), moves.end(), static_cast<size_t>(0)),
+        moved);
+    ctx.level_moves += moved;
+    ++ctx.sweep;
+    ctx.stage = stage_t::kApplyDelta;
+    messages.ForceContinue();
+  }
+
+  static void addTotal(const fragment_t& frag, context_t& ctx,
+                       message_manager_t& messages, int tid, vid_t c,
+                       double delta) {
+    auto owner = ctx.id_parser.GetFid(c);
+    if (owner == frag.fid()) {
+      grape::atomic_add(ctx.tot[indexOf(frag, ctx, c)], delta);
+    } else {
+      messages.Channels()[tid].SendToFragment(owner, total_t(c, delta));
+    }
+  }
+
+  // sends the communities of the moved vertices to the fragments having
+  // them as the ghosts
+  void syncCommunities(context_t& ctx, message_manager_t& messages) {
+    auto& g = ctx.graph;
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(g.size())),
+            [&g, &ctx, &messages](int tid, vertex_t v) {
+              size_t i = v.GetValue();
+              if (!ctx.changed[i]) {
+                return;
+              }
+              for (size_t k = g.mirror_offsets[i];
+                   k < g.mirror_offsets[i + 1]; ++k) {
+                messages.Channels()[tid].SendToFragment(
+                    g.mirrors[k], label_t(g.gids[i], ctx.comm[i]));
+              }
+            });
+  }
+
+  void endLevel(const fragment_t& frag, context_t& ctx,
+                message_manager_t& messages) {
+    if (frag.fid() == 0) {
+      VLOG(1) << "Level " << ctx.level << ": modularity " << ctx.modularity
+              << ", " << ctx.level_moves << " moves";
+    }
+    if (ctx.level_moves == 0) {
+      writeResult(frag, ctx);
+      return;
+    }
+    if (!ctx.last_level) {
+      sendCoarseEdges(ctx, messages);
+    }
+    ctx.stage = stage_t::kBuild;
+    messages.ForceContinue();
+  }
+
+  // each local vertex sends its edges summed up by the communities of the
+  // neighbors to the owner of its community
+  void sendCoarseEdges(context_t& ctx, message_manager_t& messages) {
+    auto& g = ctx.graph;
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(g.size())),
+            [this, &g, &ctx, &messages](int tid, vertex_t v) {
+              size_t i = v.GetValue();
+              vid_t c = ctx.comm[i];
+              auto owner = ctx.id_parser.GetFid(c);
+              auto& weights_to = weights_to_[tid];
+              weights_to.clear();
+              for (size_t k = g.offsets[i]; k < g.offsets[i + 1]; ++k) {
+                weights_to[ctx.comm[g.nbrs[k]]] += g.weights[k];
+              }
+              auto& channel = messages.Channels()[tid];
+              if (weights_to.empty()) {
+                channel.SendToFragment(owner, edge_t(c, c, 0));
+              }
+              for (auto& pair : weights_to) {
+                channel.SendToFragment(owner,
+                                       edge_t(c, pair.first, pair.second));
+              }
+            });
+  }
+
+  // the labels of the inner vertices are the vertices of the level, of which
+  // the communities are asked from the owners
+  void requestLabels(const fragment_t& frag, context_t& ctx,
+                     message_manager_t& messages) {
+    auto fid = frag.fid();
+    ctx.relabels.clear();
+    for (auto v : frag.InnerVertices()) {
+      vid_t x = ctx.label[v];
+      if (ctx.relabels.find(x) != ctx.relabels.end()) {
+        continue;
+      }
+      auto owner = ctx.id_parser.GetFid(x);
+      if (owner == fid) {
+        ctx.relabels.emplace(x, ctx.comm[indexOf(frag, ctx, x)]);
+      } else {
+        ctx.relabels.emplace(x, x);
+        messages.Channels()[0].SendToFragment(owner, request_t(x, fid));
+      }
+    }
+  }
+
+  void writeResult(const fragment_t& frag, context_t& ctx) {
+    ForEach(frag.InnerVertices(), [&frag, &ctx](int tid, vertex_t v) {
+      ctx.community_id[v] = frag.Gid2Oid(ctx.label[v]);
+    });
+  }
+
+  // the weights to the communities of the neighbors, per thread
+  std::vector<std::unordered_map<vid_t, double>> weights_to_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_H_
@@ -0,0 +1,177 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_CONTEXT_H_
+
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+#include "core/context/vertex_data_context.h"
+
+namespace gs {
+
+/**
+ * @brief The graph of a level of LevelLouvain, distributed by the owners of
+ * its vertices. The vertices of a level are the communities of the last
+ * level, named by the gids of the vertices of the fragment, so a vertex is
+ * owned by the fragment that owns the vertex of its gid. The slots number the
+ * local vertices first and the ghosts, i.e., the neighbors owned by the
+ * other fragments, after them.
+ *
+ * @tparam VID_T
+ */
+template <typename VID_T>
+struct LouvainLevelGraph {
+  // the gids of the local vertices
+  std::vector<VID_T> gids;
+  // the neighbors of the local vertices in slots, and the weights, in CSR
+  std::vector<size_t> offsets;
+  std::vector<size_t> nbrs;
+  std::vector<double> weights;
+  // the gids of the ghosts, and the slots of them by the gids
+  std::vector<VID_T> ghost_gids;
+  std::unordered_map<VID_T, size_t> ghost_slots;
+  // the weighted degrees of the local vertices, self loops counted twice
+  std::vector<double> degrees;
+  // the fragments having a local vertex as a ghost, in CSR
+  std::vector<size_t> mirror_offsets;
+  std::vector<grape::fid_t> mirrors;
+
+  size_t size() const { return gids.size(); }
+
+  size_t slot_num() const { return gids.size() + ghost_gids.size(); }
+
+  void clear() {
+    gids.clear();
+    offsets.clear();
+    nbrs.clear();
+    weights.clear();
+    ghost_gids.clear();
+    ghost_slots.clear();
+    degrees.clear();
+    mirror_offsets.clear();
+    mirrors.clear();
+  }
+};
+
+/**
+ * @brief Context of LevelLouvain, of which the result is the oid of the
+ * representative vertex of the community of each vertex.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class LevelLouvainContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::oid_t> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+  // the rounds of a sweep of the local moves, and of the coarsening
+  enum class Stage {
+    kSyncCommunity,
+    kRequestTotal,
+    kMove,
+    kApplyDelta,
+    kBuild,
+    kRelabelReply,
+    kRelabel,
+  };
+
+  explicit LevelLouvainContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, oid_t>(fragment, true),
+        community_id(this->data()) {}
+
+  /**
+   * @param tolerance The least gain of the modularity by a sweep to go on.
+   * @param max_sweeps The most sweeps of the local moves in a level.
+   * @param max_levels The most levels, or 0 for no limit.
+   */
+  void Init(grape::ParallelMessageManager& messages, double tolerance,
+            int max_sweeps, int max_levels) {
+    auto& frag = this->fragment();
+
+    CHECK_GE(tolerance, 0);
+    CHECK_GT(max_sweeps, 0);
+    CHECK_GE(max_levels, 0);
+    this->tolerance = tolerance;
+    this->max_sweeps = max_sweeps;
+    this->max_levels = max_levels;
+
+    id_parser.Init(frag.fnum(), 1);
+    local_index.Init(frag.InnerVertices(), kNone);
+    label.Init(frag.InnerVertices());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (auto v : frag.InnerVertices()) {
+      os << frag.GetId(v) << " " << community_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<oid_t>& community_id;
+
+  double tolerance = 1e-7;
+  int max_sweeps = 20;
+  int max_levels = 0;
+
+  vineyard::IdParser<vid_t> id_parser;
+  LouvainLevelGraph<vid_t> graph;
+  // the index in graph of an inner vertex, if its gid is a local vertex
+  typename FRAG_T::template vertex_array_t<size_t> local_index;
+  // the community of each vertex of the fragment, in the current level
+  typename FRAG_T::template vertex_array_t<vid_t> label;
+
+  // the community of each slot, and the total degrees of the communities
+  // of the local vertices, i.e., owned by the fragment
+  std::vector<vid_t> comm;
+  std::vector<double> tot;
+  // the total degrees of the communities owned by the other fragments
+  std::unordered_map<vid_t, double> remote_tot;
+  // the local vertices moved in the last sweep
+  std::vector<uint8_t> changed;
+  // the edges between the communities received by the owners, to build the
+  // graph of the next level from
+  std::vector<std::tuple<vid_t, vid_t, double>> coarse_edges;
+  // the communities of the labels of the inner vertices, in the coarsening
+  std::unordered_map<vid_t, vid_t> relabels;
+
+  Stage stage = Stage::kRequestTotal;
+  // the total edge weights, doubled
+  double two_m = 0;
+  double modularity = 0;
+  int level = 0;
+  int sweep = 0;
+  int stalls = 0;
+  size_t level_moves = 0;
+  bool last_level = false;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_LOUVAIN_LEVEL_LOUVAIN_CONTEXT_H_
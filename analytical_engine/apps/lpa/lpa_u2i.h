@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_H_
 #define ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_H_
 
+#include <algorithm>
 #include <utility>
 
 #include "apps/lpa/lpa_u2i_context.h"
@@ -23,7 +24,8 @@ limitations under the License.
 namespace gs {
 /**
  * @brief Label propagation algorithm. U stands for the user label. V stands for
- * the item label.
+ * the item label. The labels of a vertex label are a row-major matrix of
+ * prop_num doubles per vertex, updated row by row, and sent as fixed blocks.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -34,6 +36,7 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
   using vertex_t = typename FRAG_T::vertex_t;
   using label_id_t = typename FRAG_T::label_id_t;
   using label_t = typename context_t::label_t;
+  using label_msg_t = typename context_t::label_msg_t;
   using edata_t = typename context_t::edata_t;
   static constexpr uint32_t prop_num = context_t::prop_num;
   static constexpr grape::MessageStrategy message_strategy =
@@ -46,24 +49,17 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
 
     for (auto v_label = 0; v_label != v_label_num; ++v_label) {
       auto inner_vertices = frag.InnerVertices(v_label);
-      auto outer_vertices = frag.OuterVertices(v_label);
       auto& label = ctx.label[v_label];
 
-      for (auto u : inner_vertices) {
-        if (v_label == 0) {
-          label_t vdata;
+      // the labels of the items and the outer vertices are 0 by Init
+      if (v_label == 0) {
+        for (auto u : inner_vertices) {
+          double* row = label[u];
           for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
-            vdata.push_back(frag.template GetData<double>(u, prop_id));
+            row[prop_id] = frag.template GetData<double>(u, prop_id);
           }
-          label[u] = vdata;
-        } else {
-          label[u].resize(prop_num, 0);
         }
       }
-
-      for (auto u : outer_vertices) {
-        label[u].resize(prop_num, 0);
-      }
     }
 
     // init degree for u
@@ -107,13 +103,24 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
     messages.ForceContinue();
   }
 
+  // row += weight * label, over the contiguous rows
+  static inline void accumulate(double* row, const double* label,
+                                double weight) {
+    for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
+      row[prop_id] += label[prop_id] * weight;
+    }
+  }
+
   void SyncLabelOnInnerVertex(const fragment_t& frag, context_t& ctx,
                               message_manager_t& messages, uint32_t v_label) {
     auto inner_vertices = frag.InnerVertices(v_label);
     auto& label = ctx.label[v_label];
 
+    label_msg_t msg;
     for (auto u : inner_vertices) {
-      messages.SendMsgThroughEdges(frag, u, 0, label[u]);
+      const double* row = label[u];
+      std::copy(row, row + prop_num, msg.begin());
+      messages.SendMsgThroughEdges(frag, u, 0, msg);
     }
   }
 
@@ -152,14 +159,14 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
       SyncLabelOnInnerVertex(frag, ctx, messages, 0);
     } else {
       // get outer vertex's label
-      std::pair<vid_t, label_t> msg;
+      std::pair<vid_t, label_msg_t> msg;
 
       while (messages.GetMessage(msg)) {
         vertex_t u(0);
         CHECK(frag.Gid2Vertex(msg.first, u));
         auto v_label = frag.vertex_label(u);
 
-        label[v_label][u] = msg.second;
+        std::copy(msg.second.begin(), msg.second.end(), label[v_label][u]);
       }
 
       auto v_label = step % 2 == 0 ? 1 : 0;
@@ -169,72 +176,54 @@ class LPAU2I : public PropertyAppBase<FRAG_T, LPAU2IContext<FRAG_T>> {
         // pull i label from u label along incoming edges
         for (auto u : inner_vertices) {
           auto ies = frag.GetIncomingAdjList(u, 0);
+          double* row = label[v_label][u];
 
-          label[v_label][u].clear();
+          std::fill(row, row + prop_num, 0);
           for (auto& e : ies) {
             auto v = e.neighbor();
             auto edata = e.template get_data<edata_t>(0);
 
-            for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
-              label[v_label][u][prop_id] +=
-                  label[frag.vertex_label(v)][v][prop_id] * edata;
-            }
+            accumulate(row, label[frag.vertex_label(v)][v], edata);
           }
         }
         SyncLabelOnInnerVertex(frag, ctx, messages, v_label);
 
       } else {
         // i2u stage
-        grape::VertexArray<label_t, vid_t> inner_tmp_label;
-        grape::VertexArray<label_t, vid_t> inner_new_label;
-
-        inner_tmp_label.Init(inner_vertices);
-        inner_new_label.Init(inner_vertices);
+        auto& out_degree = ctx.out_degree[v_label];
+        auto& out_nbr_in_degree_sum = ctx.out_nbr_in_degree_sum[v_label];
+        // the items are not updated in this stage, so a user is updated in
+        // place right after its sum
+        double tmp_label[prop_num];
 
-        // u_label part1
         for (auto u : inner_vertices) {
           auto oes = frag.GetOutgoingAdjList(u, 0);
+          double* row = label[v_label][u];
 
-          inner_tmp_label[u].resize(prop_num, 0);
+          // u_label part1
+          std::fill(tmp_label, tmp_label + prop_num, 0);
           for (auto& e : oes) {
             auto v = e.neighbor();
             auto edata = e.template get_data<edata_t>(0);
 
-            for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
-              inner_tmp_label[u][prop_id] +=
-                  label[frag.vertex_label(v)][v][prop_id] * edata;
-            }
+            accumulate(tmp_label, label[frag.vertex_label(v)][v], edata);
           }
-        }
-
-        // u_label part2
-        auto& out_degree = ctx.out_degree[v_label];
-        auto& out_nbr_in_degree_sum = ctx.out_nbr_in_degree_sum[v_label];
-
-        for (auto u : inner_vertices) {
-          inner_new_label[u].resize(prop_num);
 
+          // u_label part2
+          if (out_nbr_in_degree_sum[u] == out_degree[u]) {
+            continue;
+          }
+          double scale =
+              1.0 / (static_cast<double>(out_nbr_in_degree_sum[u]) -
+                     static_cast<double>(out_degree[u]));
           for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
-            if (label[v_label][u][prop_id] == 0 ||
-                label[v_label][u][prop_id] == 1) {
-              inner_new_label[u][prop_id] = label[v_label][u][prop_id];
-            } else {
-              if (out_nbr_in_degree_sum[u] != out_degree[u]) {
-                inner_new_label[u][prop_id] =
-                    (inner_tmp_label[u][prop_id] -
-                     out_degree[u] * label[v_label][u][prop_id]) /
-                    (out_nbr_in_degree_sum[u] - out_degree[u]);
-              } else {
-                inner_new_label[u][prop_id] = label[v_label][u][prop_id];
-              }
+            if (row[prop_id] != 0 && row[prop_id] != 1) {
+              row[prop_id] =
+                  (tmp_label[prop_id] - out_degree[u] * row[prop_id]) * scale;
             }
           }
         }
 
-        for (auto u : inner_vertices) {
-          label[v_label][u] = inner_new_label[u];
-        }
-
         SyncLabelOnInnerVertex(frag, ctx, messages, v_label);
       }
     }
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_CONTEXT_H_
 #define ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_CONTEXT_H_
 
+#include <array>
 #include <vector>
 
 #include "grape/grape.h"
@@ -24,12 +25,40 @@
 #include "core/context/labeled_vertex_property_context.h"
 
 namespace gs {
+/**
+ * @brief The labels of the vertices in a range, row-major with K doubles per
+ * vertex in one array.
+ */
+template <typename VID_T, uint32_t K>
+class LabelMatrix {
+ public:
+  void Init(const grape::VertexRange<VID_T>& range) {
+    begin_ = range.begin().GetValue();
+    data_.assign(static_cast<size_t>(range.size()) * K, 0);
+  }
+
+  inline double* operator[](const grape::Vertex<VID_T>& v) {
+    return &data_[static_cast<size_t>(v.GetValue() - begin_) * K];
+  }
+
+  inline const double* operator[](const grape::Vertex<VID_T>& v) const {
+    return &data_[static_cast<size_t>(v.GetValue() - begin_) * K];
+  }
+
+ private:
+  VID_T begin_ = 0;
+  std::vector<double> data_;
+};
+
 template <typename FRAG_T>
 class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
  public:
   using vid_t = typename FRAG_T::vid_t;
   using oid_t = typename FRAG_T::oid_t;
-  using label_t = std::vector<double>;
+  static constexpr uint32_t prop_num = 2;
+  using label_t = LabelMatrix<vid_t, prop_num>;
+  // the label of a vertex sent as a fixed block
+  using label_msg_t = std::array<double, prop_num>;
   using edata_t = double;
 
   explicit LPAU2IContext(const FRAG_T& fragment)
@@ -72,8 +101,8 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
 
     for (auto v : iv) {
       os << frag.GetId(v) << "\t";
-      for (auto val : label[0][v]) {
-        os << val << "\t";
+      for (auto prop_id = 0u; prop_id < prop_num; prop_id++) {
+        os << label[0][v][prop_id] << "\t";
       }
       os << std::endl;
     }
@@ -81,12 +110,11 @@ class LPAU2IContext : public LabeledVertexPropertyContext<FRAG_T> {
 
   uint32_t step;
   uint32_t max_round;
-  std::vector<grape::VertexArray<label_t, vid_t>> label;
+  std::vector<label_t> label;
   std::vector<grape::VertexArray<vid_t, vid_t>> in_degree;
   std::vector<grape::VertexArray<vid_t, vid_t>> out_degree;
   std::vector<grape::VertexArray<vid_t, vid_t>> out_nbr_in_degree_sum;
   std::vector<int64_t> label_column_indices;
-  static constexpr uint32_t prop_num = 2;
 };
 }  // namespace gs
 #endif  // ANALYTICAL_ENGINE_APPS_LPA_LPA_U2I_CONTEXT_H_
@@ -0,0 +1,134 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#ifndef ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_H_
+#define ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_H_
+
+#include "grape/grape.h"
+
+#include "pagerank/pagerank_float_context.h"
+
+namespace gs {
+/**
+ * @brief The PageRank of grape::PageRank with the ranks stored and sent in
+ * float, for the graphs of which the ranks in double do not fit the memory.
+ * The sum of the ranks of the neighbors of a vertex is taken in double, and
+ * rounded to float once per vertex per round, so the ranks agree with the
+ * ones of grape::PageRank up to the precision of float.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class PageRankFloat
+    : public grape::ParallelAppBase<FRAG_T, PageRankFloatContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(PageRankFloat<FRAG_T>, PageRankFloatContext<FRAG_T>,
+                          FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+
+    messages.InitChannels(thread_num());
+
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+    double p = 1.0 / graph_vnum;
+
+    ForEach(inner_vertices, [&frag, &ctx, &messages, p](int tid, vertex_t u) {
+      int degree = frag.GetLocalOutDegree(u);
+      ctx.degree[u] = degree;
+      ctx.result[u] = static_cast<float>(degree > 0 ? p / degree : p);
+      messages.Channels()[tid].SendMsgThroughOEdges<fragment_t, float>(
+          frag, u, ctx.result[u]);
+    });
+
+    for (auto u : inner_vertices) {
+      if (ctx.degree[u] == 0) {
+        ++ctx.dangling_vnum;
+      }
+    }
+    double dangling_sum = p * static_cast<double>(ctx.dangling_vnum);
+    Sum(dangling_sum, ctx.dangling_sum);
+
+    if (ctx.max_round <= 0) {
+      finish(frag, ctx);
+      return;
+    }
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+
+    ++ctx.step;
+
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+    double base = (1.0 - ctx.delta) / graph_vnum +
+                  ctx.delta * ctx.dangling_sum / graph_vnum;
+
+    messages.ParallelProcess<fragment_t, float>(
+        thread_num(), frag,
+        [&ctx](int tid, vertex_t u, float msg) { ctx.result[u] = msg; });
+
+    ForEach(inner_vertices, [&frag, &ctx, base](int tid, vertex_t u) {
+      double cur = 0;
+      for (auto& e : frag.GetIncomingAdjList(u)) {
+        cur += ctx.result[e.get_neighbor()];
+      }
+      int degree = ctx.degree[u];
+      ctx.next_result[u] = static_cast<float>(
+          degree == 0 ? base : (ctx.delta * cur + base) / degree);
+    });
+
+    ForEach(inner_vertices, [&ctx](int tid, vertex_t u) {
+      ctx.result[u] = ctx.next_result[u];
+    });
+    double new_dangling = base * static_cast<double>(ctx.dangling_vnum);
+    Sum(new_dangling, ctx.dangling_sum);
+
+    if (ctx.step == ctx.max_round) {
+      finish(frag, ctx);
+      return;
+    }
+    ForEach(inner_vertices, [&frag, &ctx, &messages](int tid, vertex_t u) {
+      messages.Channels()[tid].SendMsgThroughOEdges<fragment_t, float>(
+          frag, u, ctx.result[u]);
+    });
+    messages.ForceContinue();
+  }
+
+ private:
+  // the ranks of the vertices of out edges are multiplied back by the
+  // degrees
+  void finish(const fragment_t& frag, context_t& ctx) {
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t u) {
+      if (ctx.degree[u] != 0) {
+        ctx.result[u] *= ctx.degree[u];
+      }
+    });
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_H_
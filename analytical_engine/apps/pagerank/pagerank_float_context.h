@@ -0,0 +1,83 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#ifndef ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_CONTEXT_H_
+
+#include <iomanip>
+#include <limits>
+
+#include "grape/grape.h"
+
+namespace gs {
+/**
+ * @brief Context for PageRankFloat, of which the ranks are kept in float, so
+ * the ranks of all the vertices and the next ranks of the inner vertices take
+ * half the memory of the ones of grape::PageRank.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class PageRankFloatContext : public grape::VertexDataContext<FRAG_T, float> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+
+  explicit PageRankFloatContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, float>(fragment, true),
+        result(this->data()) {}
+
+  void Init(grape::ParallelMessageManager& messages, double delta,
+            int max_round) {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    this->delta = delta;
+    this->max_round = max_round;
+    degree.Init(inner_vertices, 0);
+    result.Init(frag.Vertices(), 0.0f);
+    next_result.Init(inner_vertices);
+    step = 0;
+    dangling_vnum = 0;
+    dangling_sum = 0.0;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto& u : inner_vertices) {
+      os << frag.GetId(u) << " " << std::scientific
+         << std::setprecision(std::numeric_limits<float>::max_digits10)
+         << result[u] << std::endl;
+    }
+  }
+
+  double delta;
+  int max_round;
+
+  typename FRAG_T::template vertex_array_t<int> degree;
+  // the ranks of the vertices divided by their out degrees, if any, until
+  // the last round
+  typename FRAG_T::template vertex_array_t<float>& result;
+  typename FRAG_T::template vertex_array_t<float> next_result;
+
+  int step;
+  vid_t dangling_vnum;
+  double dangling_sum;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_PAGERANK_PAGERANK_FLOAT_CONTEXT_H_
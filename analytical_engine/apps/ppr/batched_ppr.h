@@ -0,0 +1,257 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_H_
+#define ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_H_
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "ppr/batched_ppr_context.h"
+
+namespace gs {
+/**
+ * @brief The approximate personalized pageranks of many seeds in one job, by
+ * the Monte Carlo random walks. walk_num walks start from each seed, and at
+ * each step a walk stops with the probability alpha, or moves to a random
+ * out neighbor, or back to its seed from a vertex without out neighbors. The
+ * score of a vertex to a seed is the fraction of the walks of the seed
+ * stopped at it. The walks of a seed at a vertex are moved as a single
+ * count, so a step costs by the distinct (vertex, seed) pairs and the walks
+ * moved, and the walks reaching the outer vertices are sent to the owners
+ * once per round.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class BatchedPPR
+    : public grape::ParallelAppBase<FRAG_T, BatchedPPRContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(BatchedPPR<FRAG_T>, BatchedPPRContext<FRAG_T>,
+                          FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using walker_t = typename context_t::walker_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kOnlyOut;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    ctx.next_walkers.resize(thread_num());
+    ctx.ends.resize(thread_num());
+    for (int tid = 0; tid < thread_num(); ++tid) {
+      ctx.rngs.emplace_back(frag.fid() * thread_num() + tid);
+    }
+
+    // the fragments owning the seeds start the walks
+    std::vector<std::pair<int32_t, vid_t>> owned;
+    for (size_t i = 0; i < ctx.seed_ids.size(); ++i) {
+      vertex_t v;
+      if (frag.GetInnerVertex(ctx.seed_ids[i], v)) {
+        owned.emplace_back(i, frag.Vertex2Gid(v));
+        ctx.next_walkers[0].emplace_back(v.GetValue(), i, ctx.walk_num);
+      }
+    }
+    std::vector<std::vector<std::pair<int32_t, vid_t>>> all_owned;
+    AllGather(owned, all_owned);
+    ctx.seed_fids.assign(ctx.seed_ids.size(), frag.fnum());
+    ctx.seed_gids.resize(ctx.seed_ids.size());
+    for (size_t fid = 0; fid < all_owned.size(); ++fid) {
+      for (auto& pair : all_owned[fid]) {
+        ctx.seed_fids[pair.first] = fid;
+        ctx.seed_gids[pair.first] = pair.second;
+      }
+    }
+    for (size_t i = 0; i < ctx.seed_ids.size(); ++i) {
+      CHECK_LT(ctx.seed_fids[i], frag.fnum())
+          << "Seed not found: " << ctx.seed_ids[i];
+    }
+
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    messages.ParallelProcess<walker_t>(
+        thread_num(), [&frag, &ctx](int tid, const walker_t& msg) {
+          vertex_t u;
+          CHECK(frag.InnerVertexGid2Vertex(std::get<0>(msg), u));
+          ctx.next_walkers[tid].emplace_back(u.GetValue(), std::get<1>(msg),
+                                             std::get<2>(msg));
+        });
+
+    step(frag, ctx, messages);
+  }
+
+ private:
+  // sorts the walkers, and merges the counts of the same vertex and seed
+  static void merge(std::vector<std::vector<walker_t>>& lists,
+                    std::vector<walker_t>& out) {
+    out.clear();
+    for (auto& list : lists) {
+      out.insert(out.end(), list.begin(), list.end());
+      list.clear();
+    }
+    std::sort(out.begin(), out.end());
+    size_t size = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+      if (size != 0 && std::get<0>(out[size - 1]) == std::get<0>(out[i]) &&
+          std::get<1>(out[size - 1]) == std::get<1>(out[i])) {
+        std::get<2>(out[size - 1]) += std::get<2>(out[i]);
+      } else {
+        out[size++] = out[i];
+      }
+    }
+    out.resize(size);
+  }
+
+  // the walks move to an inner vertex in this round, or to the owner of an
+  // outer one in the next round
+  void moveTo(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages, int tid, const vertex_t& u,
+              int32_t seed, uint32_t count) {
+    if (frag.IsInnerVertex(u)) {
+      ctx.next_walkers[tid].emplace_back(u.GetValue(), seed, count);
+    } else {
+      messages.Channels()[tid].SendToFragment(
+          frag.GetFragId(u), walker_t(frag.Vertex2Gid(u), seed, count));
+    }
+  }
+
+  void restart(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages, int tid, int32_t seed,
+               uint32_t count) {
+    vertex_t u;
+    if (frag.InnerVertexGid2Vertex(ctx.seed_gids[seed], u)) {
+      ctx.next_walkers[tid].emplace_back(u.GetValue(), seed, count);
+    } else {
+      messages.Channels()[tid].SendToFragment(
+          ctx.seed_fids[seed], walker_t(ctx.seed_gids[seed], seed, count));
+    }
+  }
+
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    std::vector<walker_t> walkers;
+    merge(ctx.next_walkers, walkers);
+
+    std::vector<size_t> moved(thread_num(), 0);
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(walkers.size())),
+            [&](int tid, vertex_t i) {
+              auto& walker = walkers[i.GetValue()];
+              vertex_t v(std::get<0>(walker));
+              int32_t seed = std::get<1>(walker);
+              uint32_t count = std::get<2>(walker);
+              auto& rng = ctx.rngs[tid];
+
+              uint32_t stopped =
+                  std::binomial_distribution<uint32_t>(count, ctx.alpha)(rng);
+              if (stopped != 0) {
+                ctx.ends[tid].emplace_back(v.GetValue(), seed, stopped);
+              }
+              uint32_t moving = count - stopped;
+              if (moving == 0) {
+                return;
+              }
+              moved[tid] += moving;
+
+              size_t degree = frag.GetLocalOutDegree(v);
+              if (degree == 0) {
+                restart(frag, ctx, messages, tid, seed, moving);
+                return;
+              }
+              // picks the neighbors of the walks in one pass over the
+              // neighbors
+              std::uniform_int_distribution<size_t> pick(0, degree - 1);
+              std::vector<size_t> positions(moving);
+              for (auto& position : positions) {
+                position = pick(rng);
+              }
+              std::sort(positions.begin(), positions.end());
+              size_t position = 0, index = 0;
+              for (auto& e : frag.GetOutgoingAdjList(v)) {
+                uint32_t picked = 0;
+                while (index < positions.size() &&
+                       positions[index] == position) {
+                  ++picked;
+                  ++index;
+                }
+                if (picked != 0) {
+                  moveTo(frag, ctx, messages, tid, e.get_neighbor(), seed,
+                         picked);
+                }
+                if (index == positions.size()) {
+                  break;
+                }
+                ++position;
+              }
+            });
+
+    size_t local_moved = std::accumulate(moved.begin(), moved.end(), 0UL);
+    size_t global_moved = 0;
+    Sum(local_moved, global_moved);
+    if (global_moved != 0) {
+      messages.ForceContinue();
+    } else {
+      writeToCtx(frag, ctx);
+    }
+  }
+
+  void writeToCtx(const fragment_t& frag, context_t& ctx) {
+    std::vector<walker_t> ends;
+    merge(ctx.ends, ends);
+
+    ctx.rows.clear();
+    for (auto& end : ends) {
+      double score = static_cast<double>(std::get<2>(end)) / ctx.walk_num;
+      if (score >= ctx.threshold) {
+        vertex_t v(std::get<0>(end));
+        ctx.rows.push_back({std::get<1>(end), frag.GetId(v), score});
+      }
+    }
+    // by the seeds, and the scores in descending order
+    std::sort(ctx.rows.begin(), ctx.rows.end(),
+              [](const typename context_t::row_t& lhs,
+                 const typename context_t::row_t& rhs) {
+                return lhs.seed < rhs.seed ||
+                       (lhs.seed == rhs.seed && lhs.score > rhs.score);
+              });
+
+    std::vector<double> data;
+    data.reserve(ctx.rows.size() * 3);
+    for (auto& row : ctx.rows) {
+      data.push_back(static_cast<double>(ctx.seed_ids[row.seed]));
+      data.push_back(static_cast<double>(row.oid));
+      data.push_back(row.score);
+    }
+    std::vector<size_t> shape{ctx.rows.size(), 3};
+    ctx.assign(data, shape);
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_H_
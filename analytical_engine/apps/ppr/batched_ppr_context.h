@@ -0,0 +1,115 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_CONTEXT_H_
+
+#include <cstdint>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/context/tensor_context.h"
+
+namespace gs {
+/**
+ * @brief Context for the batched personalized pagerank. The result is sparse,
+ * a row of (seed, vertex, score) per vertex of a score no less than the
+ * threshold to a seed, with the ids of the vertices as doubles.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class BatchedPPRContext : public TensorContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  static_assert(std::is_arithmetic<oid_t>::value,
+                "The ids of the vertices are written as doubles");
+
+  explicit BatchedPPRContext(const FRAG_T& fragment)
+      : TensorContext<FRAG_T, double>(fragment) {}
+
+  /**
+   * @param seeds The ids of the seeds, separated by the commas.
+   * @param walk_num The number of the walks from each seed.
+   * @param alpha The probability a walk stops at each step, i.e., teleports
+   * back to the seed.
+   * @param threshold The least score to output.
+   */
+  void Init(grape::ParallelMessageManager& messages, const std::string& seeds,
+            int walk_num, double alpha, double threshold) {
+    std::stringstream ss(seeds);
+    std::string token;
+    while (std::getline(ss, token, ',')) {
+      if (token.empty()) {
+        continue;
+      }
+      std::stringstream ts(token);
+      oid_t seed;
+      ts >> seed;
+      CHECK(!ts.fail()) << "Invalid seed of batched_ppr: " << token;
+      seed_ids.push_back(seed);
+    }
+    CHECK(!seed_ids.empty());
+    CHECK_GT(walk_num, 0);
+    CHECK(alpha > 0 && alpha <= 1);
+    this->walk_num = static_cast<uint32_t>(walk_num);
+    this->alpha = alpha;
+    this->threshold = threshold;
+  }
+
+  void Output(std::ostream& os) override {
+    os << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+    for (auto& row : rows) {
+      os << seed_ids[row.seed] << " " << row.oid << " " << row.score
+         << std::endl;
+    }
+  }
+
+  // the lid or the gid of a vertex, the index of the seed, and the number of
+  // the walks
+  using walker_t = std::tuple<vid_t, int32_t, uint32_t>;
+
+  struct row_t {
+    int32_t seed;
+    oid_t oid;
+    double score;
+  };
+
+  std::vector<oid_t> seed_ids;
+  // the owners and the gids of the seeds, resolved in PEval
+  std::vector<grape::fid_t> seed_fids;
+  std::vector<vid_t> seed_gids;
+  uint32_t walk_num = 0;
+  double alpha = 0;
+  double threshold = 0;
+  // the walks moved to the inner vertices, and the ones stopped, per thread
+  std::vector<std::vector<walker_t>> next_walkers;
+  std::vector<std::vector<walker_t>> ends;
+  std::vector<std::mt19937_64> rngs;
+  std::vector<row_t> rows;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_PPR_BATCHED_PPR_CONTEXT_H_
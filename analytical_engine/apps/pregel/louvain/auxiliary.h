@@ -16,7 +16,9 @@
 #ifndef ANALYTICAL_ENGINE_APPS_PREGEL_LOUVAIN_AUXILIARY_H_
 #define ANALYTICAL_ENGINE_APPS_PREGEL_LOUVAIN_AUXILIARY_H_
 
+#include <algorithm>
 #include <map>
+#include <utility>
 #include <vector>
 
 #include "grape/grape.h"
@@ -40,6 +42,52 @@ constexpr int phase_one_minor_step_0 = 0;
 constexpr int phase_one_minor_step_1 = 1;
 constexpr int phase_one_minor_step_2 = 2;
 
+/**
+ * The aggregated edges of a community vertex, as (dst community, weight)
+ * pairs sorted by the dst community.
+ */
+template <typename VID_T, typename EDATA_T>
+using community_edges_t = std::vector<std::pair<VID_T, EDATA_T>>;
+
+/**
+ * Sorts the (dst community, weight) pairs by the dst community and sums the
+ * weights of the same one in place. The sort is stable, so the weights are
+ * summed in the order they are appended.
+ */
+template <typename VID_T, typename EDATA_T>
+void SortAndReduceEdges(community_edges_t<VID_T, EDATA_T>& edges) {
+  std::stable_sort(edges.begin(), edges.end(),
+                   [](const std::pair<VID_T, EDATA_T>& lhs,
+                      const std::pair<VID_T, EDATA_T>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  size_t size = 0;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    if (size > 0 && edges[size - 1].first == edges[i].first) {
+      edges[size - 1].second += edges[i].second;
+    } else {
+      edges[size++] = edges[i];
+    }
+  }
+  edges.resize(size);
+  edges.shrink_to_fit();
+}
+
+/**
+ * Finds the weight of the edge to dst in the sorted edges.
+ */
+template <typename VID_T, typename EDATA_T>
+const EDATA_T* FindEdge(const community_edges_t<VID_T, EDATA_T>& edges,
+                        const VID_T& dst) {
+  auto iter = std::lower_bound(edges.begin(), edges.end(), dst,
+                               [](const std::pair<VID_T, EDATA_T>& edge,
+                                  const VID_T& id) { return edge.first < id; });
+  if (iter != edges.end() && iter->first == dst) {
+    return &iter->second;
+  }
+  return nullptr;
+}
+
 /**
  * The state of a vertex.
  */
@@ -65,7 +113,7 @@ struct LouvainNodeState {
   bool use_fake_edges = false;
   bool is_alived_community = true;
 
-  std::map<vid_t, edata_t> fake_edges;
+  community_edges_t<vid_t, edata_t> fake_edges;
   std::vector<vid_t> nodes_in_community;
   edata_t total_edge_weight;
 
@@ -102,7 +150,7 @@ struct LouvainMessage {
   // the community compress its member's data and make self a new vertex for
   // next phase.
   edata_t internal_weight = 0;
-  std::map<vid_t, edata_t> edges;
+  community_edges_t<vid_t, edata_t> edges;
   std::vector<vid_t> nodes_in_self_community;
 
   LouvainMessage()
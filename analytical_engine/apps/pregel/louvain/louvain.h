@@ -359,23 +359,22 @@ class PregelLouvain
    */
   void replaceNodeEdgesWithCommunityEdges(
       pregel_vertex_t& vertex, grape::IteratorPair<md_t*>& messages) {
-    std::map<vid_t, edata_t> community_map;
+    community_edges_t<vid_t, edata_t> community_edges;
+    community_edges.reserve(messages.size());
     for (auto& message : messages) {
-      const auto& community_id = message.community_id;
-      community_map[community_id] += message.edge_weight;
+      community_edges.emplace_back(message.community_id, message.edge_weight);
     }
+    SortAndReduceEdges(community_edges);
 
-    vertex.set_fake_edges(std::move(community_map));
+    vertex.set_fake_edges(std::move(community_edges));
   }
 
   void sendCommunitiesInfo(pregel_vertex_t& vertex) {
     state_t& state = vertex.state();
     md_t message;
     message.internal_weight = state.internal_weight;
-    std::map<vid_t, edata_t> edges;
     assert(vertex.use_fake_edges());
-    edges = vertex.fake_edges();
-    message.edges = std::move(edges);
+    message.edges = vertex.fake_edges();
     if (vertex.get_gid() != state.community) {
       message.nodes_in_self_community.swap(vertex.nodes_in_self_community());
     }
@@ -388,7 +387,8 @@ class PregelLouvain
                            grape::IteratorPair<md_t*>& messages) {
     auto community_id = vertex.get_gid();
     edata_t weight = 0;
-    std::map<vid_t, edata_t> edge_map;
+    // the edges of the members, reduced by the dst community
+    community_edges_t<vid_t, edata_t> community_edges;
     auto& nodes_in_self_community = vertex.nodes_in_self_community();
     for (auto& m : messages) {
       weight += m.internal_weight;
@@ -396,7 +396,7 @@ class PregelLouvain
         if (entry.first == community_id) {
           weight += entry.second;
         } else {
-          edge_map[entry.first] += entry.second;
+          community_edges.push_back(entry);
         }
       }
       nodes_in_self_community.insert(nodes_in_self_community.end(),
@@ -404,7 +404,8 @@ class PregelLouvain
                                      m.nodes_in_self_community.end());
     }
     vertex.state().internal_weight = weight;
-    vertex.set_fake_edges(std::move(edge_map));
+    SortAndReduceEdges(community_edges);
+    vertex.set_fake_edges(std::move(community_edges));
     vertex.state().is_from_louvain_vertex_reader = false;
 
     // send self fake message to activate next round.
@@ -25,6 +25,7 @@ limitations under the License.
 #include "grape/utils/iterator_pair.h"
 
 #include "core/app/app_base.h"
+#include "core/app/pregel/aggregators/aggregator_communicator.h"
 #include "core/app/pregel/pregel_compute_context.h"
 
 #include "apps/pregel/louvain/auxiliary.h"
@@ -47,7 +48,7 @@ class LouvainAppBase
                                      FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                      typename VERTEX_PROGRAM_T::md_t>>>,
       public grape::ParallelEngine,
-      public grape::Communicator {
+      public AggregatorCommunicator {
  public:
   using fragment_t = FRAG_T;
   using oid_t = typename FRAG_T::oid_t;
@@ -77,13 +78,15 @@ class LouvainAppBase
     // superstep is 0 in PEval
     uint32_t thrd_num = thread_num();
     messages.InitChannels(thrd_num);
+    ctx.compute_context().set_thread_num(thrd_num);
 
     // register the aggregators
-    ctx.compute_context().register_aggregator(
+    auto& compute_context = ctx.compute_context();
+    change_handle_ = compute_context.template register_aggregator<int64_t>(
         change_aggregator, PregelAggregatorType::kInt64SumAggregator);
-    ctx.compute_context().register_aggregator(
+    edge_weight_handle_ = compute_context.template register_aggregator<double>(
         edge_weight_aggregator, PregelAggregatorType::kDoubleSumAggregator);
-    ctx.compute_context().register_aggregator(
+    quality_handle_ = compute_context.template register_aggregator<double>(
         actual_quality_aggregator, PregelAggregatorType::kDoubleSumAggregator);
     ctx.ClearLocalAggregateValues(thrd_num);
 
@@ -113,27 +116,16 @@ class LouvainAppBase
 
     {
       // sync aggregator
-      ctx.compute_context().aggregate(change_aggregator,
-                                      ctx.GetLocalChangeSum());
-      ctx.compute_context().aggregate(edge_weight_aggregator,
-                                      ctx.GetLocalEdgeWeightSum());
-      ctx.compute_context().aggregate(actual_quality_aggregator,
-                                      ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      compute_context.aggregate(change_handle_, ctx.GetLocalChangeSum());
+      compute_context.aggregate(
+          edge_weight_handle_,
+          static_cast<double>(ctx.GetLocalEdgeWeightSum()));
+      compute_context.aggregate(quality_handle_, ctx.GetLocalQualitySum());
+      compute_context.flush_aggregators();
+      SyncAggregators(compute_context.aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
-    ctx.compute_context().clear_for_next_round();
-
     if (!ctx.compute_context().all_halted()) {
       messages.ForceContinue();
     }
@@ -183,9 +175,7 @@ class LouvainAppBase
                   for (auto const& msg : buffer[index][tid]) {
                     vertex_t v;
                     frag.InnerVertexGid2Vertex(msg.dst_id, v);
-                    ctx.compute_context().messages_in()[v].emplace_back(
-                        std::move(msg));
-                    ctx.compute_context().activate(v);
+                    ctx.compute_context().receive_message(v, md_t(msg), tid);
                   }
                 }
               },
@@ -195,14 +185,14 @@ class LouvainAppBase
           threads[tid].join();
         }
       }
+      ctx.compute_context().build_messages();
     }
 
     if (current_minor_step == phase_one_minor_step_1 && current_iteration > 0 &&
         current_iteration % 2 == 0) {
       // aggreate total change
       int64_t total_change =
-          ctx.compute_context().template get_aggregated_value<int64_t>(
-              change_aggregator);
+          ctx.compute_context().get_aggregated_value(change_handle_);
       ctx.change_history().push_back(total_change);
       // check whether to halt phase-1
       bool to_halt = decide_to_halt(ctx.change_history(), ctx.min_progress(),
@@ -221,8 +211,7 @@ class LouvainAppBase
       // after decide_to_halt and aggregate actual quality in previous super
       // step, here we check terminate computaion or start phase 2.
       double actual_quality =
-          ctx.compute_context().template get_aggregated_value<double>(
-              actual_quality_aggregator);
+          ctx.compute_context().get_aggregated_value(quality_handle_);
       // after one pass if already decided halt, that means the pass yield no
       // changes, so we halt computation.
       if (current_super_step <= 14 || actual_quality <= ctx.prev_quality()) {
@@ -252,7 +241,7 @@ class LouvainAppBase
     if (ctx.compute_context().superstep() == phase_two_start_step) {
       ForEach(inner_vertices, [&ctx](int tid, vertex_t v) {
         if (ctx.GetVertexState(v).is_alived_community) {
-          ctx.compute_context().activate(v);
+          ctx.compute_context().activate(v, tid);
         }
       });
     }
@@ -265,12 +254,8 @@ class LouvainAppBase
         pregel_vertex.set_compute_context(&ctx.compute_context());
         pregel_vertex.set_vertex(v);
         pregel_vertex.set_tid(tid);
-        auto& cur_msgs = (ctx.compute_context().messages_in())[v];
-        this->program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context());
+        this->program_.Compute(ctx.compute_context().get_messages(v),
+                               pregel_vertex, ctx.compute_context());
       } else if (ctx.compute_context().superstep() == compress_community_step) {
         ctx.GetVertexState(v).is_alived_community = false;
       }
@@ -278,27 +263,17 @@ class LouvainAppBase
 
     {
       // sync aggregator
-      ctx.compute_context().aggregate(change_aggregator,
-                                      ctx.GetLocalChangeSum());
-      ctx.compute_context().aggregate(edge_weight_aggregator,
-                                      ctx.GetLocalEdgeWeightSum());
-      ctx.compute_context().aggregate(actual_quality_aggregator,
-                                      ctx.GetLocalQualitySum());
-      for (auto& pair : ctx.compute_context().aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      auto& compute_context = ctx.compute_context();
+      compute_context.aggregate(change_handle_, ctx.GetLocalChangeSum());
+      compute_context.aggregate(
+          edge_weight_handle_,
+          static_cast<double>(ctx.GetLocalEdgeWeightSum()));
+      compute_context.aggregate(quality_handle_, ctx.GetLocalQualitySum());
+      compute_context.flush_aggregators();
+      SyncAggregators(compute_context.aggregators());
       ctx.ClearLocalAggregateValues(thrd_num);
     }
 
-    ctx.compute_context().clear_for_next_round();
-
     if (!ctx.compute_context().all_halted()) {
       messages.ForceContinue();
     }
@@ -334,6 +309,9 @@ class LouvainAppBase
 
  private:
   vertex_program_t program_;
+  AggregatorHandle<int64_t> change_handle_;
+  AggregatorHandle<double> edge_weight_handle_;
+  AggregatorHandle<double> quality_handle_;
 };
 }  // namespace gs
 
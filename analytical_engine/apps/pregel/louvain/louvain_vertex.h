@@ -16,13 +16,13 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_PREGEL_LOUVAIN_LOUVAIN_VERTEX_H_
 #define ANALYTICAL_ENGINE_APPS_PREGEL_LOUVAIN_LOUVAIN_VERTEX_H_
 
-#include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "core/app/pregel/pregel_vertex.h"
 
+#include "apps/pregel/louvain/auxiliary.h"
 #include "apps/pregel/louvain/louvain_context.h"
 
 namespace gs {
@@ -77,7 +77,7 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
     return context_->GetVertexState(this->vertex_).use_fake_edges;
   }
 
-  const std::map<vid_t, edata_t>& fake_edges() const {
+  const community_edges_t<vid_t, edata_t>& fake_edges() const {
     return context_->GetVertexState(this->vertex_).fake_edges;
   }
 
@@ -94,12 +94,14 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
         }
       }
     } else {
-      return this->fake_edges().at(dst_id);
+      auto* weight = FindEdge(this->fake_edges(), dst_id);
+      CHECK(weight != nullptr);
+      return *weight;
     }
     return edata_t();
   }
 
-  void set_fake_edges(std::map<vid_t, edata_t>&& edges) {
+  void set_fake_edges(community_edges_t<vid_t, edata_t>&& edges) {
     state_t& ref_state = this->state();
     ref_state.fake_edges = std::move(edges);
     ref_state.use_fake_edges = true;
@@ -109,9 +111,6 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
     return context_->GetVertexState(this->vertex_).nodes_in_community;
   }
 
-  int tid() { return tid_; }
-  void set_tid(int id) { tid_ = id; }
-
   PregelComputeContext<fragment_t, VD_T, MD_T>* compute_context() {
     return this->compute_context_;
   }
@@ -120,7 +119,6 @@ class LouvainVertex : public PregelVertex<FRAG_T, VD_T, MD_T> {
   context_t* context() { return context_; }
 
  private:
-  int tid_;
   context_t* context_;
 };
 }  // namespace gs
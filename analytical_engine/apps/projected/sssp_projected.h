@@ -19,12 +19,16 @@
 #include <iostream>
 #include <limits>
 #include <queue>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "grape/grape.h"
 
 #include "core/app/app_base.h"
+#include "core/app/incremental_state.h"
+#include "core/utils/vertex_subset.h"
 #include "core/worker/default_worker.h"
 
 namespace gs {
@@ -45,7 +49,7 @@ class SSSPProjectedContext : public grape::VertexDataContext<FRAG_T, double> {
 
     source_id = source_id_;
     partial_result.SetValue(std::numeric_limits<double>::max());
-    modified.Init(vertices, false);
+    modified.Init(vertices);
   }
 
   void Output(std::ostream& os) override {
@@ -58,12 +62,14 @@ class SSSPProjectedContext : public grape::VertexDataContext<FRAG_T, double> {
   }
 
   typename FRAG_T::template vertex_array_t<double>& partial_result;
-  typename FRAG_T::template vertex_array_t<bool> modified;
+  // the settled inner vertices and the updated outer vertices in Dijkstra
+  VertexSubset<vid_t> modified;
   oid_t source_id;
 };
 
 template <typename FRAG_T>
-class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
+class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>>,
+                      public grape::Communicator {
  public:
   // specialize the templated worker.
   INSTALL_DEFAULT_WORKER(SSSPProjected<FRAG_T>, SSSPProjectedContext<FRAG_T>,
@@ -84,10 +90,9 @@ class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
       distu = -heap.top().first;
       heap.pop();
 
-      if (ctx.modified[u]) {
+      if (!ctx.modified.Insert(u)) {
         continue;
       }
-      ctx.modified[u] = true;
 
       auto es = frag.GetOutgoingAdjList(u);
       for (auto& e : es) {
@@ -99,7 +104,7 @@ class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
           if (frag.IsInnerVertex(v)) {
             heap.emplace(-ndistv, v);
           } else {
-            ctx.modified[v] = true;
+            ctx.modified.Insert(v);
           }
         }
       }
@@ -114,6 +119,20 @@ class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
 
     std::priority_queue<std::pair<double, vertex_t>> heap;
 
+    // the distances only decrease as edges are added, so relaxes from the
+    // endpoints of the added edges only, both of them for undirected graphs
+    std::vector<vertex_t> srcs, dsts;
+    if (incremental_.Resume(frag, stateKey(ctx), *this, ctx.partial_result,
+                            srcs, dsts)) {
+      srcs.insert(srcs.end(), dsts.begin(), dsts.end());
+      for (auto v : srcs) {
+        if (frag.IsInnerVertex(v) &&
+            ctx.partial_result[v] < std::numeric_limits<double>::max()) {
+          heap.emplace(-ctx.partial_result[v], v);
+        }
+      }
+    }
+
     if (native_source) {
       ctx.partial_result[source] = 0.0;
       heap.emplace(0, source);
@@ -121,21 +140,18 @@ class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
 
     Dijkstra(frag, ctx, heap);
 
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      if (ctx.modified[v]) {
+    ctx.modified.ForEach([&](const vertex_t& v) {
+      if (frag.IsOuterVertex(v)) {
         messages.SyncStateOnOuterVertex<FRAG_T, double>(frag, v,
                                                         ctx.partial_result[v]);
       }
-    }
+    });
 
-    ctx.modified.SetValue(false);
+    ctx.modified.Clear();
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                grape::DefaultMessageManager& messages) {
-    auto inner_vertices = frag.InnerVertices();
-
     std::priority_queue<std::pair<double, vertex_t>> heap;
 
     {
@@ -144,29 +160,40 @@ class SSSPProjected : public AppBase<FRAG_T, SSSPProjectedContext<FRAG_T>> {
       while (messages.GetMessage<fragment_t, double>(frag, v, val)) {
         if (val < ctx.partial_result[v]) {
           ctx.partial_result[v] = val;
-          ctx.modified[v] = true;
+          ctx.modified.Insert(v);
         }
       }
     }
 
-    for (auto& v : inner_vertices) {
-      if (ctx.modified[v]) {
-        heap.emplace(-ctx.partial_result[v], v);
-        ctx.modified[v] = false;
-      }
-    }
+    // the messages only update the inner vertices
+    ctx.modified.ForEach([&ctx, &heap](const vertex_t& v) {
+      heap.emplace(-ctx.partial_result[v], v);
+    });
+    ctx.modified.Clear();
 
     Dijkstra(frag, ctx, heap);
 
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      if (ctx.modified[v]) {
+    ctx.modified.ForEach([&](const vertex_t& v) {
+      if (frag.IsOuterVertex(v)) {
         messages.SyncStateOnOuterVertex<FRAG_T, double>(frag, v,
                                                         ctx.partial_result[v]);
       }
-    }
-    ctx.modified.SetValue(false);
+    });
+    ctx.modified.Clear();
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    incremental_.Save(frag, stateKey(ctx), ctx.partial_result);
   }
+
+ private:
+  static std::string stateKey(const context_t& ctx) {
+    std::stringstream ss;
+    ss << "sssp_projected:" << ctx.source_id;
+    return ss.str();
+  }
+
+  IncrementalState<fragment_t, double> incremental_;
 };
 
 }  // namespace gs
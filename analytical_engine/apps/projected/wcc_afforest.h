@@ -0,0 +1,258 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_AFFOREST_H_
+#define ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_AFFOREST_H_
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <unordered_map>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class WCCAfforestContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  explicit WCCAfforestContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()) {}
+
+  void Init(grape::ParallelMessageManager& messages) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    parent.Init(vertices);
+    label.Init(vertices, std::numeric_limits<vid_t>::max());
+    changed.Init(vertices);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto iv = frag.InnerVertices();
+
+    for (auto v : iv) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+  // the parents of the local union find over the inner and outer vertices,
+  // by the lids
+  typename FRAG_T::template vertex_array_t<vid_t> parent;
+  // the least gid known of the component of a local root
+  typename FRAG_T::template vertex_array_t<vid_t> label;
+  // the local roots of which the label decreased in the round
+  grape::DenseVertexSet<vid_t> changed;
+};
+
+/**
+ * @brief The weakly connected components by the Afforest algorithm, where each
+ * vertex is labeled by the least gid in its component, as WCCProjected. Each
+ * fragment first links the endpoints of its edges in a local union find, in
+ * which the outer vertices take part, without any communication. The first
+ * few neighbors of each vertex are linked first, and then the remaining edges
+ * of the vertices out of the largest local component found by sampling, as
+ * the ones inside it are linked already from the other ends, except for the
+ * edges to the outer vertices, of which the other ends are not local.
+ *
+ * Then the labels are exchanged between the local components only, i.e., a
+ * component sends its label through its outer vertices to their owners, and
+ * lowers the label of the component of the vertex there. As a cut edge is
+ * kept by the fragments of both ends, the labels flow both ways, and the
+ * rounds are bounded by the hops between the fragments instead of the
+ * diameter of the graph.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class WCCAfforest
+    : public grape::ParallelAppBase<FRAG_T, WCCAfforestContext<FRAG_T>>,
+      public grape::ParallelEngine {
+ public:
+  INSTALL_PARALLEL_WORKER(WCCAfforest<FRAG_T>, WCCAfforestContext<FRAG_T>,
+                          FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  // the neighbors of each vertex linked before the sampling
+  static constexpr int kNeighborRounds = 2;
+  // the vertices sampled for the largest local component
+  static constexpr int kSampleNum = 1024;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto vertices = frag.Vertices();
+    auto inner_vertices = frag.InnerVertices();
+
+    messages.InitChannels(thread_num());
+
+    ForEach(vertices,
+            [&ctx](int tid, vertex_t v) { ctx.parent[v] = v.GetValue(); });
+    for (int round = 0; round < kNeighborRounds; ++round) {
+      ForEach(inner_vertices, [&frag, &ctx, round](int tid, vertex_t v) {
+        int index = 0;
+        forEachNeighbor(frag, v, [&ctx, &v, &index, round](vertex_t u) {
+          if (index++ == round) {
+            link(ctx, v, u);
+          }
+          return index <= round;
+        });
+      });
+      compress(frag, ctx);
+    }
+
+    vid_t giant = sampleLargestComponent(frag, ctx);
+    ForEach(inner_vertices, [&frag, &ctx, giant](int tid, vertex_t v) {
+      bool in_giant = ctx.parent[v] == giant;
+      int index = 0;
+      forEachNeighbor(frag, v, [&frag, &ctx, &v, &index, in_giant](vertex_t u) {
+        if (index++ >= kNeighborRounds &&
+            (!in_giant || frag.IsOuterVertex(u))) {
+          link(ctx, v, u);
+        }
+        return true;
+      });
+    });
+    compress(frag, ctx);
+
+    ForEach(vertices, [&frag, &ctx](int tid, vertex_t v) {
+      grape::atomic_min(ctx.label[vertex_t(ctx.parent[v])],
+                        frag.Vertex2Gid(v));
+    });
+    ForEach(vertices, [&ctx](int tid, vertex_t v) {
+      if (ctx.parent[v] == v.GetValue()) {
+        ctx.changed.Insert(v);
+      }
+    });
+
+    exchange(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    messages.ParallelProcess<fragment_t, vid_t>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, vid_t msg) {
+          vertex_t root(ctx.parent[u]);
+          if (ctx.label[root] > msg &&
+              grape::atomic_min(ctx.label[root], msg)) {
+            ctx.changed.Insert(root);
+          }
+        });
+
+    exchange(frag, ctx, messages);
+  }
+
+ private:
+  // calls func on the outgoing neighbors, followed by the incoming ones if
+  // directed, till it returns false
+  template <typename FUNC_T>
+  static void forEachNeighbor(const fragment_t& frag, const vertex_t& v,
+                              const FUNC_T& func) {
+    for (auto& e : frag.GetOutgoingAdjList(v)) {
+      if (!func(e.get_neighbor())) {
+        return;
+      }
+    }
+    if (frag.directed()) {
+      for (auto& e : frag.GetIncomingAdjList(v)) {
+        if (!func(e.get_neighbor())) {
+          return;
+        }
+      }
+    }
+  }
+
+  // hooks the larger root under the smaller one, retried on the contention
+  static void link(context_t& ctx, const vertex_t& u, const vertex_t& v) {
+    vid_t p1 = ctx.parent[u], p2 = ctx.parent[v];
+    while (p1 != p2) {
+      vid_t high = std::max(p1, p2), low = std::min(p1, p2);
+      vid_t& p_high = ctx.parent[vertex_t(high)];
+      vid_t curr = p_high;
+      if (curr == low ||
+          (curr == high && __sync_bool_compare_and_swap(&p_high, high, low))) {
+        return;
+      }
+      p1 = ctx.parent[vertex_t(curr)];
+      p2 = ctx.parent[vertex_t(low)];
+    }
+  }
+
+  // points each vertex to its root
+  void compress(const fragment_t& frag, context_t& ctx) {
+    ForEach(frag.Vertices(), [&ctx](int tid, vertex_t v) {
+      vid_t root = ctx.parent[v];
+      while (ctx.parent[vertex_t(root)] != root) {
+        root = ctx.parent[vertex_t(root)];
+      }
+      ctx.parent[v] = root;
+    });
+  }
+
+  // the most frequent root of the sampled inner vertices
+  vid_t sampleLargestComponent(const fragment_t& frag, context_t& ctx) {
+    auto inner_vertices = frag.InnerVertices();
+    vid_t giant = std::numeric_limits<vid_t>::max();
+    if (inner_vertices.size() == 0) {
+      return giant;
+    }
+    std::mt19937 rng(frag.fid());
+    std::uniform_int_distribution<vid_t> dist(0, inner_vertices.size() - 1);
+    std::unordered_map<vid_t, int> counts;
+    int max_count = 0;
+    for (int i = 0; i < kSampleNum; ++i) {
+      vertex_t v(inner_vertices.begin().GetValue() + dist(rng));
+      int count = ++counts[ctx.parent[v]];
+      if (count > max_count) {
+        max_count = count;
+        giant = ctx.parent[v];
+      }
+    }
+    return giant;
+  }
+
+  // sends the labels of the changed components through their outer vertices,
+  // and labels the inner vertices
+  void exchange(const fragment_t& frag, context_t& ctx,
+                message_manager_t& messages) {
+    ForEach(frag.OuterVertices(),
+            [&messages, &frag, &ctx](int tid, vertex_t v) {
+              vertex_t root(ctx.parent[v]);
+              if (ctx.changed.Exist(root)) {
+                messages.SyncStateOnOuterVertex<fragment_t, vid_t>(
+                    frag, v, ctx.label[root], tid);
+              }
+            });
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+      ctx.comp_id[v] = ctx.label[vertex_t(ctx.parent[v])];
+    });
+    ctx.changed.ParallelClear(thread_num());
+  }
+};
+
+}  // namespace gs
+#endif  // ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_AFFOREST_H_
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_PROJECTED_H_
 #define ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_PROJECTED_H_
 
+#include <algorithm>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -23,6 +24,9 @@
 #include "grape/grape.h"
 
 #include "core/app/app_base.h"
+#include "core/app/incremental_state.h"
+#include "core/utils/hub_mirrors.h"
+#include "core/utils/vertex_subset.h"
 
 namespace gs {
 
@@ -37,12 +41,19 @@ class WCCProjectedContext
                                                                  true),
         comp_id(this->data()) {}
 
-  void Init(grape::DefaultMessageManager& messages) {
+  /**
+   * @param hub_threshold The least edges of the vertices to send their
+   * components once to each fragment having them as outer vertices, or 0 to
+   * sync the outer neighbors of every vertex, see HubMirrors.
+   */
+  void Init(grape::DefaultMessageManager& messages, int hub_threshold) {
     auto& frag = this->fragment();
     auto vertices = frag.Vertices();
 
-    curr_modified.Init(vertices, false);
-    next_modified.Init(vertices, false);
+    CHECK_GE(hub_threshold, 0);
+    curr_modified.Init(vertices);
+    next_modified.Init(vertices);
+    hubs.Init(frag, hub_threshold);
   }
 
   void Output(std::ostream& os) override {
@@ -55,15 +66,21 @@ class WCCProjectedContext
   }
 
   typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
-  typename FRAG_T::template vertex_array_t<bool> curr_modified;
-  typename FRAG_T::template vertex_array_t<bool> next_modified;
+  // the inner vertices to propagate from, and the vertices updated by them
+  VertexSubset<vid_t> curr_modified;
+  VertexSubset<vid_t> next_modified;
+  HubMirrors<FRAG_T> hubs;
 };
 
 template <typename FRAG_T>
-class WCCProjected : public AppBase<FRAG_T, WCCProjectedContext<FRAG_T>> {
+class WCCProjected : public AppBase<FRAG_T, WCCProjectedContext<FRAG_T>>,
+                     public grape::Communicator {
  public:
   INSTALL_DEFAULT_WORKER(WCCProjected<FRAG_T>, WCCProjectedContext<FRAG_T>,
                          FRAG_T)
+  // the hubs send their components to the fragments of their neighbors
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
   using vertex_t = typename fragment_t::vertex_t;
   using vid_t = typename fragment_t::vid_t;
 
@@ -71,7 +88,6 @@ class WCCProjected : public AppBase<FRAG_T, WCCProjectedContext<FRAG_T>> {
              message_manager_t& messages) {
     auto inner_vertices = frag.InnerVertices();
     auto outer_vertices = frag.OuterVertices();
-    auto vertices = frag.Vertices();
 
     for (auto v : inner_vertices) {
       ctx.comp_id[v] = frag.GetInnerVertexGid(v);
@@ -80,102 +96,106 @@ class WCCProjected : public AppBase<FRAG_T, WCCProjectedContext<FRAG_T>> {
       ctx.comp_id[v] = frag.GetOuterVertexGid(v);
     }
 
-    for (auto v : inner_vertices) {
-      auto cid = ctx.comp_id[v];
-
-      auto es = frag.GetOutgoingAdjList(v);
-      for (auto& e : es) {
-        auto u = e.neighbor();
-        if (ctx.comp_id[u] > cid) {
-          ctx.comp_id[u] = cid;
-          ctx.next_modified[u] = true;
+    // the components only merge as edges are added, so propagates from the
+    // endpoints of the added edges only
+    std::vector<vertex_t> srcs, dsts;
+    if (incremental_.Resume(frag, "wcc_projected", *this, ctx.comp_id, srcs,
+                            dsts)) {
+      for (size_t i = 0; i < srcs.size(); ++i) {
+        if (frag.IsInnerVertex(srcs[i])) {
+          ctx.curr_modified.Insert(srcs[i]);
         }
-      }
-
-      es = frag.GetIncomingAdjList(v);
-      for (auto& e : es) {
-        auto u = e.neighbor();
-        if (ctx.comp_id[u] > cid) {
-          ctx.comp_id[u] = cid;
-          ctx.next_modified[u] = true;
+        if (frag.IsInnerVertex(dsts[i])) {
+          ctx.curr_modified.Insert(dsts[i]);
         }
       }
-    }
-
-    for (auto v : outer_vertices) {
-      if (ctx.next_modified[v]) {
-        messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
-                                                           ctx.comp_id[v]);
-        ctx.next_modified[v] = false;
-      }
-    }
-    for (auto v : inner_vertices) {
-      if (ctx.next_modified[v]) {
-        messages.ForceContinue();
-        break;
+    } else {
+      for (auto v : inner_vertices) {
+        ctx.curr_modified.Insert(v);
       }
     }
-    ctx.next_modified.Swap(ctx.curr_modified);
+
+    propagate(frag, ctx, messages);
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                grape::DefaultMessageManager& messages) {
-    auto inner_vertices = frag.InnerVertices();
-    auto outer_vertices = frag.OuterVertices();
-    auto vertices = frag.Vertices();
-
     {
       vertex_t v(0);
       vid_t val;
       while (messages.GetMessage<fragment_t, vid_t>(frag, v, val)) {
-        if (ctx.comp_id[v] > val) {
+        if (frag.IsOuterVertex(v)) {
+          // from a hub, whose outer neighbors here are relaxed by this
+          // fragment, even if the hub got the component from here
+          ctx.comp_id[v] = std::min(ctx.comp_id[v], val);
+          ctx.hubs.ForEachMirrorNbr(v, [&ctx, val](const vertex_t& u) {
+            if (ctx.comp_id[u] > val) {
+              ctx.comp_id[u] = val;
+              ctx.curr_modified.Insert(u);
+            }
+          });
+        } else if (ctx.comp_id[v] > val) {
           ctx.comp_id[v] = val;
-          ctx.curr_modified[v] = true;
+          ctx.curr_modified.Insert(v);
         }
       }
     }
 
-    for (auto v : inner_vertices) {
-      if (!ctx.curr_modified[v]) {
-        continue;
-      }
-      ctx.curr_modified[v] = false;
-      auto cid = ctx.comp_id[v];
-
-      auto es = frag.GetOutgoingAdjList(v);
-      for (auto& e : es) {
-        auto u = e.neighbor();
-        if (ctx.comp_id[u] > cid) {
-          ctx.comp_id[u] = cid;
-          ctx.next_modified[u] = true;
-        }
-      }
+    propagate(frag, ctx, messages);
+  }
 
-      es = frag.GetIncomingAdjList(v);
-      for (auto& e : es) {
-        auto u = e.neighbor();
-        if (ctx.comp_id[u] > cid) {
-          ctx.comp_id[u] = cid;
-          ctx.next_modified[u] = true;
-        }
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    incremental_.Save(frag, "wcc_projected", ctx.comp_id);
+  }
+
+ private:
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 grape::DefaultMessageManager& messages) {
+    // the hubs leave their outer neighbors to the fragments of them
+    auto relax = [&frag, &ctx](const vertex_t& v, const auto& e) {
+      auto u = e.neighbor();
+      if (ctx.comp_id[u] > ctx.comp_id[v] &&
+          !(frag.IsOuterVertex(u) && ctx.hubs.IsHub(v))) {
+        ctx.comp_id[u] = ctx.comp_id[v];
+        return true;
       }
+      return false;
+    };
+    EdgeMap(
+        ctx.curr_modified, ctx.next_modified,
+        [&frag](const vertex_t& v) { return frag.GetOutgoingAdjList(v); },
+        relax);
+    EdgeMap(
+        ctx.curr_modified, ctx.next_modified,
+        [&frag](const vertex_t& v) { return frag.GetIncomingAdjList(v); },
+        relax);
+    if (ctx.hubs.enabled()) {
+      ctx.curr_modified.ForEach([&](const vertex_t& v) {
+        if (ctx.hubs.IsHub(v)) {
+          messages.SendMsgThroughEdges<fragment_t, vid_t>(frag, v,
+                                                          ctx.comp_id[v]);
+        }
+      });
     }
+    ctx.curr_modified.Clear();
 
-    for (auto v : outer_vertices) {
-      if (ctx.next_modified[v]) {
+    // the updated outer vertices are synced, and the inner ones propagate
+    // in the next round
+    ctx.next_modified.ForEach([&](const vertex_t& v) {
+      if (frag.IsOuterVertex(v)) {
         messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
                                                            ctx.comp_id[v]);
-        ctx.next_modified[v] = false;
+      } else {
+        ctx.curr_modified.Insert(v);
       }
+    });
+    ctx.next_modified.Clear();
+    if (!ctx.curr_modified.empty()) {
+      messages.ForceContinue();
     }
-    for (auto v : inner_vertices) {
-      if (ctx.next_modified[v]) {
-        messages.ForceContinue();
-        break;
-      }
-    }
-    ctx.curr_modified.Swap(ctx.next_modified);
   }
+
+  IncrementalState<fragment_t, vid_t> incremental_;
 };
 
 }  // namespace gs
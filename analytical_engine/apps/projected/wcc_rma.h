@@ -0,0 +1,165 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_RMA_H_
+#define ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_RMA_H_
+
+#include <mpi.h>
+
+#include <limits>
+
+#include "grape/grape.h"
+
+#include "core/app/app_base.h"
+#include "core/parallel/rma_state_sync.h"
+#include "core/utils/vertex_subset.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class WCCRMAContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  explicit WCCRMAContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    curr_modified.Init(vertices);
+    next_modified.Init(vertices);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto iv = frag.InnerVertices();
+
+    for (auto v : iv) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+  // the inner vertices to propagate from, and the vertices updated by them
+  VertexSubset<vid_t> curr_modified;
+  VertexSubset<vid_t> next_modified;
+  // the components of the outer vertices, min-accumulated on their owners
+  RMAStateSync<FRAG_T, vid_t> sync;
+};
+
+/**
+ * @brief The weakly connected components as WCCProjected, i.e., labeled by
+ * the least gid in each component, of which the components of the updated
+ * outer vertices are synced to their owners by the one-sided accumulates of
+ * MPI_MIN into a window of the components of the inner vertices, see
+ * RMAStateSync, instead of the messages.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class WCCRMA : public AppBase<FRAG_T, WCCRMAContext<FRAG_T>>,
+               public grape::Communicator {
+ public:
+  INSTALL_DEFAULT_WORKER(WCCRMA<FRAG_T>, WCCRMAContext<FRAG_T>, FRAG_T)
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  // hides the one of grape::Communicator, which is called by the workers, to
+  // open the window in the same communicator
+  void InitCommunicator(MPI_Comm comm) {
+    grape::Communicator::InitCommunicator(comm);
+    comm_ = comm;
+  }
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    ctx.sync.Init(frag, comm_, MPI_MIN, std::numeric_limits<vid_t>::max());
+
+    for (auto v : frag.InnerVertices()) {
+      ctx.comp_id[v] = frag.GetInnerVertexGid(v);
+      ctx.curr_modified.Insert(v);
+    }
+    for (auto v : frag.OuterVertices()) {
+      ctx.comp_id[v] = frag.GetOuterVertexGid(v);
+    }
+
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    ctx.sync.ForEachReceived(frag, [&ctx](const vertex_t& v, vid_t val) {
+      if (ctx.comp_id[v] > val) {
+        ctx.comp_id[v] = val;
+        ctx.curr_modified.Insert(v);
+      }
+    });
+
+    propagate(frag, ctx, messages);
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    ctx.sync.Finalize();
+  }
+
+ private:
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    auto relax = [&ctx](const vertex_t& v, const auto& e) {
+      auto u = e.neighbor();
+      if (ctx.comp_id[u] > ctx.comp_id[v]) {
+        ctx.comp_id[u] = ctx.comp_id[v];
+        return true;
+      }
+      return false;
+    };
+    EdgeMap(
+        ctx.curr_modified, ctx.next_modified,
+        [&frag](const vertex_t& v) { return frag.GetOutgoingAdjList(v); },
+        relax);
+    EdgeMap(
+        ctx.curr_modified, ctx.next_modified,
+        [&frag](const vertex_t& v) { return frag.GetIncomingAdjList(v); },
+        relax);
+    ctx.curr_modified.Clear();
+
+    // the updated outer vertices are accumulated to their owners, and the
+    // inner ones propagate in the next round
+    ctx.next_modified.ForEach([&](const vertex_t& v) {
+      if (frag.IsOuterVertex(v)) {
+        ctx.sync.Accumulate(frag, v, ctx.comp_id[v]);
+      } else {
+        ctx.curr_modified.Insert(v);
+      }
+    });
+    ctx.next_modified.Clear();
+    if (!ctx.curr_modified.empty()) {
+      messages.ForceContinue();
+    }
+    ctx.sync.FinishRound(messages);
+  }
+
+  MPI_Comm comm_ = MPI_COMM_NULL;
+};
+
+}  // namespace gs
+#endif  // ANALYTICAL_ENGINE_APPS_PROJECTED_WCC_RMA_H_
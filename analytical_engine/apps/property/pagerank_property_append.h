@@ -0,0 +1,191 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_PROPERTY_PAGERANK_PROPERTY_APPEND_H_
+#define ANALYTICAL_ENGINE_APPS_PROPERTY_PAGERANK_PROPERTY_APPEND_H_
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/app/append_property_app_base.h"
+#include "core/context/vertex_data_context.h"
+
+namespace gs {
+/**
+ * @brief A PageRank algorithm for labeled appendable graph, which is warm
+ * started from the ranks of the last query, and iterates until the ranks
+ * change less than tolerance in total, or max_round rounds.
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class PageRankPropertyAppendContext
+    : public LabeledVertexDataContext<FRAG_T, double> {
+  using label_id_t = typename FRAG_T::label_id_t;
+
+ public:
+  explicit PageRankPropertyAppendContext(const FRAG_T& fragment)
+      : LabeledVertexDataContext<FRAG_T, double>(fragment, true),
+        rank(this->data()) {}
+
+  void Init(grape::DefaultMessageManager& messages, double delta_,
+            int max_round_, double tolerance_) {
+    auto& frag = this->fragment();
+    auto v_label_num = frag.vertex_label_num();
+
+    delta = delta_;
+    max_round = max_round_;
+    tolerance = tolerance_;
+    step = 0;
+    next.resize(v_label_num);
+
+    double init_rank = 1.0 / frag.GetTotalNodesNum();
+    for (label_id_t v_label = 0; v_label != v_label_num; ++v_label) {
+      rank[v_label].SetValue(init_rank);
+      next[v_label].Init(frag.Vertices(v_label), 0.0);
+    }
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (label_id_t i = 0; i < frag.vertex_label_num(); ++i) {
+      auto iv = frag.InnerVertices(i);
+      for (auto v : iv) {
+        os << frag.GetId(v) << " " << rank[i][v] << std::endl;
+      }
+    }
+  }
+
+  std::vector<typename FRAG_T::template vertex_array_t<double>>& rank;
+  // the ranks pushed to the vertices in the round
+  std::vector<typename FRAG_T::template vertex_array_t<double>> next;
+  // the ranks of the dangling inner vertices in the round
+  double dangling_sum = 0;
+  double delta;
+  int max_round;
+  double tolerance;
+  int step;
+};
+
+template <typename FRAG_T>
+class PageRankPropertyAppend
+    : public AppendPropertyAppBase<
+          FRAG_T, PageRankPropertyAppendContext<FRAG_T>, double> {
+ public:
+  INSTALL_DEFAULT_PROPERTY_WORKER(PageRankPropertyAppend<FRAG_T>,
+                                  PageRankPropertyAppendContext<FRAG_T>,
+                                  FRAG_T)
+  using vertex_t = typename FRAG_T::vertex_t;
+  using label_id_t = typename FRAG_T::label_id_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    // PageRank is not monotone, but converges faster from the last ranks, the
+    // new vertices get the initial ranks
+    std::vector<vertex_t> srcs, dsts;
+    this->Resume(frag, stateKey(ctx), ctx.rank, srcs, dsts);
+
+    push(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    {
+      vertex_t v(0);
+      double val;
+      while (messages.GetMessage<fragment_t, double>(frag, v, val)) {
+        ctx.next[frag.vertex_label(v)][v] += val;
+      }
+    }
+
+    double dangling_sum, diff = 0;
+    this->Sum(ctx.dangling_sum, dangling_sum);
+
+    label_id_t v_label_num = frag.vertex_label_num();
+    size_t total_num = frag.GetTotalNodesNum();
+    double base = (1.0 - ctx.delta) / total_num +
+                  ctx.delta * dangling_sum / total_num;
+    for (label_id_t i = 0; i < v_label_num; ++i) {
+      for (auto v : frag.InnerVertices(i)) {
+        double rank = base + ctx.delta * ctx.next[i][v];
+        diff += std::fabs(rank - ctx.rank[i][v]);
+        ctx.rank[i][v] = rank;
+        ctx.next[i][v] = 0;
+      }
+    }
+
+    double total_diff;
+    this->Sum(diff, total_diff);
+    if (++ctx.step >= ctx.max_round || total_diff < ctx.tolerance) {
+      return;
+    }
+
+    push(frag, ctx, messages);
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    this->Save(frag, stateKey(ctx), ctx.rank);
+  }
+
+ private:
+  void push(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    label_id_t v_label_num = frag.vertex_label_num();
+    label_id_t e_label_num = frag.edge_label_num();
+
+    ctx.dangling_sum = 0;
+    for (label_id_t i = 0; i < v_label_num; ++i) {
+      for (auto v : frag.InnerVertices(i)) {
+        size_t degree = this->OutDegree(frag, v);
+        if (degree == 0) {
+          ctx.dangling_sum += ctx.rank[i][v];
+          continue;
+        }
+        double contrib = ctx.rank[i][v] / degree;
+        for (label_id_t j = 0; j < e_label_num; ++j) {
+          this->ForEachOutgoingEdge(frag, v, j, [&](const auto& e) {
+            auto u = e.neighbor();
+            ctx.next[frag.vertex_label(u)][u] += contrib;
+          });
+        }
+      }
+    }
+
+    for (label_id_t i = 0; i < v_label_num; ++i) {
+      for (auto v : frag.OuterVertices(i)) {
+        if (ctx.next[i][v] != 0) {
+          messages.SyncStateOnOuterVertex<fragment_t, double>(frag, v,
+                                                              ctx.next[i][v]);
+          ctx.next[i][v] = 0;
+        }
+      }
+    }
+    messages.ForceContinue();
+  }
+
+  static std::string stateKey(const context_t& ctx) {
+    std::stringstream ss;
+    ss << "pagerank_property_append:" << ctx.delta;
+    return ss.str();
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_PROPERTY_PAGERANK_PROPERTY_APPEND_H_
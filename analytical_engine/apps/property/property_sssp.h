@@ -25,6 +25,7 @@ limitations under the License.
 #include "grape/grape.h"
 
 #include "core/app/property_app_base.h"
+#include "core/app/property_schema_binding.h"
 #include "core/context/vertex_property_context.h"
 #include "core/parallel/property_message_manager.h"
 
@@ -89,6 +90,9 @@ class PropertySSSP
   using vertex_t = typename fragment_t::vertex_t;
   using label_id_t = typename fragment_t::label_id_t;
 
+  // the length of an edge is its first property
+  void BindSchema(const fragment_t& frag) { length_.Bind(frag, 0); }
+
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     vertex_t source;
@@ -114,7 +118,7 @@ class PropertySSSP
       auto es = frag.GetOutgoingAdjList(source, j);
       for (auto& e : es) {
         auto u = e.neighbor();
-        auto u_dist = static_cast<double>(e.template get_data<int64_t>(0));
+        auto u_dist = static_cast<double>(length_(j, e));
         label_id_t u_label = frag.vertex_label(u);
         if (ctx.comp_id[u_label][u] > u_dist) {
           ctx.comp_id[u_label][u] = u_dist;
@@ -189,8 +193,7 @@ class PropertySSSP
           auto es = frag.GetOutgoingAdjList(v, j);
           for (auto& e : es) {
             auto u = e.neighbor();
-            auto u_dist =
-                v_dist + static_cast<double>(e.template get_data<int64_t>(0));
+            auto u_dist = v_dist + static_cast<double>(length_(j, e));
             label_id_t u_label = frag.vertex_label(u);
             if (ctx.comp_id[u_label][u] > u_dist) {
               ctx.comp_id[u_label][u] = u_dist;
@@ -236,6 +239,9 @@ class PropertySSSP
       }
     }
   }
+
+ private:
+  EdgePropertyBinding<FRAG_T, int64_t> length_;
 };
 
 }  // namespace gs
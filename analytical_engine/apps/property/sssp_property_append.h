@@ -17,18 +17,20 @@
 #define ANALYTICAL_ENGINE_APPS_PROPERTY_SSSP_PROPERTY_APPEND_H_
 #include <iomanip>
 #include <limits>
-
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "grape/grape.h"
 
-#include "core/app/property_app_base.h"
+#include "core/app/append_property_app_base.h"
 #include "core/context/vertex_data_context.h"
 
 namespace gs {
 
 /**
- * An SSSP implementation for labeled appendable graph
+ * An SSSP implementation for labeled appendable graph, which resumes from the
+ * distances of the last query from the same source.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -83,7 +85,8 @@ class SSSPPropertyAppendContext
 
 template <typename FRAG_T>
 class SSSPPropertyAppend
-    : public PropertyAppBase<FRAG_T, SSSPPropertyAppendContext<FRAG_T>> {
+    : public AppendPropertyAppBase<FRAG_T, SSSPPropertyAppendContext<FRAG_T>,
+                                   double> {
  public:
   INSTALL_DEFAULT_PROPERTY_WORKER(SSSPPropertyAppend<FRAG_T>,
                                   SSSPPropertyAppendContext<FRAG_T>, FRAG_T)
@@ -94,77 +97,31 @@ class SSSPPropertyAppend
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
-    vertex_t source;
-    bool native_source = false;
-
-    label_id_t v_label_num = frag.vertex_label_num();
-    label_id_t e_label_num = frag.edge_label_num();
-
-    for (label_id_t i = 0; i < v_label_num; ++i) {
-      native_source = frag.GetInnerVertex(i, ctx.source_id, source);
-      if (native_source) {
-        break;
-      }
-    }
-
-    if (native_source) {
-      label_id_t label = frag.vertex_label(source);
-      ctx.comp_id[label][source] = 0;
-    } else {
-      return;
-    }
-
-    for (label_id_t j = 0; j < e_label_num; ++j) {
-      auto es = frag.GetOutgoingAdjList(source, j);
-      for (auto& e : es) {
-        auto u = e.neighbor();
-        auto u_dist = static_cast<double>(e.template get_data<int64_t>(0));
-        label_id_t u_label = frag.vertex_label(u);
-
-        if (ctx.comp_id[u_label][u] > u_dist) {
-          ctx.comp_id[u_label][u] = u_dist;
-          ctx.next_modified[u_label][u] = true;
-        }
-      }
-
-      auto extra_es = frag.GetExtraOutgoingAdjList(source, j);
-      for (auto& e : extra_es) {
-        auto u = e.neighbor();
-        auto u_dist = static_cast<double>(e.template get_data<int64_t>(0));
-        label_id_t u_label = frag.vertex_label(u);
-
-        if (ctx.comp_id[u_label][u] > u_dist) {
-          ctx.comp_id[u_label][u] = u_dist;
-          ctx.next_modified[u_label][u] = true;
+    // the distances only decrease as edges are appended, so relaxes from the
+    // endpoints of the appended edges only
+    std::vector<vertex_t> srcs, dsts;
+    if (this->Resume(frag, stateKey(ctx), ctx.comp_id, srcs, dsts)) {
+      srcs.insert(srcs.end(), dsts.begin(), dsts.end());
+      for (auto v : srcs) {
+        label_id_t v_label = frag.vertex_label(v);
+        if (frag.IsInnerVertex(v) && ctx.comp_id[v_label][v] <
+                                         std::numeric_limits<double>::max()) {
+          ctx.curr_modified[v_label][v] = true;
         }
       }
     }
 
+    label_id_t v_label_num = frag.vertex_label_num();
     for (label_id_t i = 0; i < v_label_num; ++i) {
-      auto ov = frag.OuterVertices(i);
-      for (auto v : ov) {
-        if (ctx.next_modified[i][v]) {
-          messages.SyncStateOnOuterVertex<fragment_t, double>(
-              frag, v, ctx.comp_id[i][v]);
-          ctx.next_modified[i][v] = false;
-        }
-      }
-    }
-    for (label_id_t i = 0; i < v_label_num; ++i) {
-      auto iv = frag.InnerVertices(i);
-      bool ok = false;
-      for (auto v : iv) {
-        if (ctx.next_modified[i][v]) {
-          messages.ForceContinue();
-          ok = true;
-          break;
-        }
-      }
-      if (ok) {
+      vertex_t source;
+      if (frag.GetInnerVertex(i, ctx.source_id, source)) {
+        ctx.comp_id[i][source] = 0;
+        ctx.curr_modified[i][source] = true;
         break;
       }
     }
-    ctx.curr_modified.swap(ctx.next_modified);
+
+    relax(frag, ctx, messages);
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
@@ -181,6 +138,16 @@ class SSSPPropertyAppend
       }
     }
 
+    relax(frag, ctx, messages);
+  }
+
+  void EndQuery(const fragment_t& frag, context_t& ctx) {
+    this->Save(frag, stateKey(ctx), ctx.comp_id);
+  }
+
+ private:
+  void relax(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
     label_id_t v_label_num = frag.vertex_label_num();
     label_id_t e_label_num = frag.edge_label_num();
     for (label_id_t i = 0; i < v_label_num; ++i) {
@@ -194,30 +161,16 @@ class SSSPPropertyAppend
         auto v_dist = ctx.comp_id[i][v];
 
         for (label_id_t j = 0; j < e_label_num; ++j) {
-          auto es = frag.GetOutgoingAdjList(v, j);
-          for (auto& e : es) {
-            auto u = e.neighbor();
-            auto u_dist =
-                v_dist + static_cast<double>(e.template get_data<int64_t>(0));
-            label_id_t u_label = frag.vertex_label(u);
-            if (ctx.comp_id[u_label][u] > u_dist) {
-              ctx.comp_id[u_label][u] = u_dist;
-              ctx.next_modified[u_label][u] = true;
-            }
-          }
-
-          auto extra_es = frag.GetExtraOutgoingAdjList(v, j);
-          for (auto& e : extra_es) {
+          this->ForEachOutgoingEdge(frag, v, j, [&](const auto& e) {
             auto u = e.neighbor();
             auto u_dist =
                 v_dist + static_cast<double>(e.template get_data<int64_t>(0));
             label_id_t u_label = frag.vertex_label(u);
-
             if (ctx.comp_id[u_label][u] > u_dist) {
               ctx.comp_id[u_label][u] = u_dist;
               ctx.next_modified[u_label][u] = true;
             }
-          }
+          });
         }
       }
     }
@@ -248,6 +201,12 @@ class SSSPPropertyAppend
     }
     ctx.curr_modified.swap(ctx.next_modified);
   }
+
+  static std::string stateKey(const context_t& ctx) {
+    std::stringstream ss;
+    ss << "sssp_property_append:" << ctx.source_id;
+    return ss.str();
+  }
 };
 
 }  // namespace gs
@@ -31,9 +31,17 @@ class CythonPIEProgram {
   typedef void (*InitFuncT)(wrapper_fragment_t&, wrapper_context_t&);
   typedef void (*PEvalFuncT)(wrapper_fragment_t&, wrapper_context_t&);
   typedef void (*IncEvalFuncT)(wrapper_fragment_t&, wrapper_context_t&);
+  // a nogil kernel run on a range of the inner vertices of a label, by the
+  // thread tid, after PEval or IncEval of the round
+  typedef void (*KernelFuncT)(wrapper_fragment_t&, wrapper_context_t&,
+                              python_grape::VertexRange&, int, int);
 
   CythonPIEProgram()
-      : init_func_(nullptr), peval_func_(nullptr), inceval_func_(nullptr) {}
+      : init_func_(nullptr),
+        peval_func_(nullptr),
+        inceval_func_(nullptr),
+        peval_kernel_(nullptr),
+        inceval_kernel_(nullptr) {}
 
   void SetInitFunction(InitFuncT init_func) { init_func_ = init_func; }
 
@@ -43,6 +51,14 @@ class CythonPIEProgram {
     inceval_func_ = inceval_func;
   }
 
+  void SetPEvalKernel(KernelFuncT kernel) { peval_kernel_ = kernel; }
+
+  void SetIncEvalKernel(KernelFuncT kernel) { inceval_kernel_ = kernel; }
+
+  bool HasPEvalKernel() const { return peval_kernel_ != nullptr; }
+
+  bool HasIncEvalKernel() const { return inceval_kernel_ != nullptr; }
+
   inline void Init(wrapper_fragment_t& frag, wrapper_context_t& context) {
     init_func_(frag, context);
   }
@@ -55,10 +71,25 @@ class CythonPIEProgram {
     inceval_func_(frag, context);
   }
 
+  inline void PEvalKernel(wrapper_fragment_t& frag, wrapper_context_t& context,
+                          python_grape::VertexRange& vertices, int label,
+                          int tid) {
+    peval_kernel_(frag, context, vertices, label, tid);
+  }
+
+  inline void IncEvalKernel(wrapper_fragment_t& frag,
+                            wrapper_context_t& context,
+                            python_grape::VertexRange& vertices, int label,
+                            int tid) {
+    inceval_kernel_(frag, context, vertices, label, tid);
+  }
+
  private:
   InitFuncT init_func_;
   PEvalFuncT peval_func_;
   IncEvalFuncT inceval_func_;
+  KernelFuncT peval_kernel_;
+  KernelFuncT inceval_kernel_;
 };
 }  // namespace gs
 
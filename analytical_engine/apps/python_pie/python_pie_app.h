@@ -16,12 +16,16 @@
 #ifndef ANALYTICAL_ENGINE_APPS_PYTHON_PIE_PYTHON_PIE_APP_H_
 #define ANALYTICAL_ENGINE_APPS_PYTHON_PIE_PYTHON_PIE_APP_H_
 
+#include <algorithm>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "core/app/property_auto_app_base.h"
+#include "core/parallel/thread_pool.h"
 
 #include "apps/python_pie/python_pie_context.h"
 #include "apps/python_pie/wrapper.h"
@@ -43,6 +47,13 @@ class PythonPIEApp
   using app_t = PythonPIEApp<FRAG_T, PIE_PROGRAM_T>;
   using pie_context_t = PIEContext<FRAG_T, wrapper_context_t>;
 
+  using vid_t = typename FRAG_T::vid_t;
+  using label_id_t = typename FRAG_T::label_id_t;
+  using vertex_range_t = typename FRAG_T::vertex_range_t;
+
+  // the inner vertices taken by a thread at a time to run the kernels
+  static constexpr vid_t kKernelChunkSize = 1024;
+
   INSTALL_AUTO_PROPERTY_WORKER(app_t, pie_context_t, FRAG_T)
 
  public:
@@ -51,6 +62,7 @@ class PythonPIEApp
 
   virtual void PEval(const fragment_t& frag, pie_context_t& context) {
     fragment_.set_fragment(&frag);
+    context.compute_context_.set_thread_num(threadNum(context));
     // call python function
     program_.Init(fragment_, context.compute_context_);
 
@@ -58,6 +70,13 @@ class PythonPIEApp
 
     // call python function
     program_.PEval(fragment_, context.compute_context_);
+    if (program_.HasPEvalKernel()) {
+      runKernel(frag, context, [this](wrapper_context_t& ctx,
+                                      vertex_range_t& vertices, int label,
+                                      int tid) {
+        program_.PEvalKernel(fragment_, ctx, vertices, label, tid);
+      });
+    }
   }
 
   virtual void IncEval(const fragment_t& graph, pie_context_t& context) {
@@ -65,10 +84,60 @@ class PythonPIEApp
 
     // call python function
     program_.IncEval(fragment_, context.compute_context_);
+    if (program_.HasIncEvalKernel()) {
+      runKernel(graph, context, [this](wrapper_context_t& ctx,
+                                       vertex_range_t& vertices, int label,
+                                       int tid) {
+        program_.IncEvalKernel(fragment_, ctx, vertices, label, tid);
+      });
+    }
   }
 
  private:
+  // the threads to run the kernels by, of the "thread_num" in the app
+  // params, or all the cores by default
+  int threadNum(pie_context_t& context) {
+    auto thread_num = context.compute_context_.get_config("thread_num");
+    if (!thread_num.empty()) {
+      return std::max(std::stoi(thread_num), 1);
+    }
+    return std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+
+  /**
+   * @brief Runs the kernel on the chunks of the inner vertices of each label,
+   * which are taken by the threads of the pool dynamically, then applies the
+   * values set by the threads to the sync buffers on this thread.
+   */
+  template <typename KERNEL_T>
+  void runKernel(const fragment_t& frag, pie_context_t& context,
+                 const KERNEL_T& kernel) {
+    auto& compute_context = context.compute_context_;
+    int thread_num = compute_context.thread_num();
+    vid_t chunk_size = kKernelChunkSize;
+
+    for (label_id_t label = 0; label < frag.vertex_label_num(); ++label) {
+      auto iv = frag.InnerVertices(label);
+      vid_t end = iv.end().GetValue();
+      std::atomic<vid_t> offset(iv.begin().GetValue());
+
+      thread_pool_.ParallelRun(thread_num, [&](int tid) {
+        while (true) {
+          vid_t begin = offset.fetch_add(chunk_size);
+          if (begin >= end) {
+            break;
+          }
+          vertex_range_t vertices(begin,
+                                  std::min(begin + chunk_size, end));
+          kernel(compute_context, vertices, static_cast<int>(label), tid);
+        }
+      });
+    }
+    compute_context.apply_thread_values();
+  }
+
   PIE_PROGRAM_T program_;
+  ThreadPool thread_pool_;
 
   // python wrapper
   wrapper_fragment_t fragment_;
@@ -140,7 +140,7 @@ class PythonPIEFragment {
     return fragment_->GetLocalInDegree(v, e_label);
   }
   int get_outdegree(const vertex_t& v, label_id_t e_label) {
-    return fragment_->GetLocalInDegree(v, e_label);
+    return fragment_->GetLocalOutDegree(v, e_label);
   }
   std::string get_str(const vertex_t& v, prop_id_t prop_id) const {
     return fragment_->template GetData<std::string>(v, prop_id);
@@ -154,6 +154,102 @@ class PythonPIEFragment {
   bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
     return fragment_->Gid2Vertex(gid, v);
   }
+
+  // bulk accessors, for the apps written as vectorized kernels. The inner
+  // vertices of a label are indexed by vertex_offset(v), and the edges of
+  // a label by their edge ids.
+
+  /**
+   * @brief The values of a property of the inner vertices of the label, of
+   * get_inner_nodes_num(label) elements, which can be viewed as a numpy
+   * array without copying. Returns nullptr if the property is not of the
+   * type, or is not stored in a single chunk.
+   */
+  const double* get_double_column(label_id_t label, prop_id_t prop_id) const {
+    return column_values<double>(fragment_->vertex_data_table(label), prop_id);
+  }
+  const int64_t* get_int_column(label_id_t label, prop_id_t prop_id) const {
+    return column_values<int64_t>(fragment_->vertex_data_table(label),
+                                  prop_id);
+  }
+
+  /**
+   * @brief The values of a property of the edges of the label, indexed by
+   * the edge ids, see get_outgoing_csr.
+   */
+  const double* get_edge_double_column(label_id_t e_label,
+                                       prop_id_t prop_id) const {
+    return column_values<double>(fragment_->edge_data_table(e_label),
+                                 prop_id);
+  }
+  const int64_t* get_edge_int_column(label_id_t e_label,
+                                     prop_id_t prop_id) const {
+    return column_values<int64_t>(fragment_->edge_data_table(e_label),
+                                  prop_id);
+  }
+
+  /**
+   * @brief Fills the local out and in degrees by the edge label of each
+   * inner vertex of the label into degrees, of get_inner_nodes_num(v_label)
+   * elements.
+   */
+  void get_outdegrees(label_id_t v_label, label_id_t e_label,
+                      int32_t* degrees) const {
+    for (auto v : fragment_->InnerVertices(v_label)) {
+      degrees[fragment_->vertex_offset(v)] =
+          fragment_->GetLocalOutDegree(v, e_label);
+    }
+  }
+  void get_indegrees(label_id_t v_label, label_id_t e_label,
+                     int32_t* degrees) const {
+    for (auto v : fragment_->InnerVertices(v_label)) {
+      degrees[fragment_->vertex_offset(v)] =
+          fragment_->GetLocalInDegree(v, e_label);
+    }
+  }
+
+  /**
+   * @brief The number of the outgoing edges of the label from the inner
+   * vertices of v_label, i.e., the size of the arrays of get_outgoing_csr.
+   */
+  size_t get_outgoing_edges_num(label_id_t v_label, label_id_t e_label) const {
+    size_t num = 0;
+    for (auto v : fragment_->InnerVertices(v_label)) {
+      num += fragment_->GetLocalOutDegree(v, e_label);
+    }
+    return num;
+  }
+  size_t get_incoming_edges_num(label_id_t v_label, label_id_t e_label) const {
+    size_t num = 0;
+    for (auto v : fragment_->InnerVertices(v_label)) {
+      num += fragment_->GetLocalInDegree(v, e_label);
+    }
+    return num;
+  }
+
+  /**
+   * @brief Fills the outgoing edges of the label from the inner vertices of
+   * v_label in CSR: offsets of get_inner_nodes_num(v_label) + 1 elements,
+   * and for each edge, the vertex offset of the neighbor in nbrs, the label
+   * of the neighbor in nbr_labels and the edge id in edge_ids. nbr_labels
+   * and edge_ids may be nullptr if they are not needed.
+   */
+  void get_outgoing_csr(label_id_t v_label, label_id_t e_label,
+                        int64_t* offsets, int64_t* nbrs, int32_t* nbr_labels,
+                        int64_t* edge_ids) const {
+    fill_csr(v_label, offsets, nbrs, nbr_labels, edge_ids,
+             [this, e_label](const vertex_t& v) {
+               return fragment_->GetOutgoingAdjList(v, e_label);
+             });
+  }
+  void get_incoming_csr(label_id_t v_label, label_id_t e_label,
+                        int64_t* offsets, int64_t* nbrs, int32_t* nbr_labels,
+                        int64_t* edge_ids) const {
+    fill_csr(v_label, offsets, nbrs, nbr_labels, edge_ids,
+             [this, e_label](const vertex_t& v) {
+               return fragment_->GetIncomingAdjList(v, e_label);
+             });
+  }
   // schema
   prop_id_t vertex_property_num(label_id_t v_label_id) const {
     return fragment_->vertex_property_num(v_label_id);
@@ -249,6 +345,45 @@ class PythonPIEFragment {
   void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
 
  private:
+  template <typename T>
+  static const T* column_values(const std::shared_ptr<arrow::Table>& table,
+                                prop_id_t prop_id) {
+    using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+    if (table == nullptr || prop_id < 0 || prop_id >= table->num_columns()) {
+      return nullptr;
+    }
+    auto column = table->column(prop_id);
+    if (column->num_chunks() != 1) {
+      return nullptr;
+    }
+    auto array = std::dynamic_pointer_cast<array_t>(column->chunk(0));
+    return array == nullptr ? nullptr : array->raw_values();
+  }
+
+  template <typename GET_ADJ_LIST_T>
+  void fill_csr(label_id_t v_label, int64_t* offsets, int64_t* nbrs,
+                int32_t* nbr_labels, int64_t* edge_ids,
+                const GET_ADJ_LIST_T& get_adj_list) const {
+    auto inner_vertices = fragment_->InnerVertices(v_label);
+    // the inner vertices are in the order of their offsets
+    int64_t index = 0;
+    offsets[0] = 0;
+    for (auto v : inner_vertices) {
+      for (auto& e : get_adj_list(v)) {
+        auto u = e.neighbor();
+        nbrs[index] = fragment_->vertex_offset(u);
+        if (nbr_labels != nullptr) {
+          nbr_labels[index] = fragment_->vertex_label(u);
+        }
+        if (edge_ids != nullptr) {
+          edge_ids[index] = e.edge_id();
+        }
+        ++index;
+      }
+      offsets[fragment_->vertex_offset(v) + 1] = index;
+    }
+  }
+
   const fragment_t* fragment_;
 };
 
@@ -310,6 +445,26 @@ class PythonPIEComputeContext {
     return partial_result_[label][v];
   }
 
+  // The kernels run concurrently, so that they set the values by the buffers
+  // of their threads, which are applied by apply_thread_values after all of
+  // the kernels of the round finish.
+  void set_thread_num(int thread_num) { thread_values_.resize(thread_num); }
+
+  int thread_num() { return static_cast<int>(thread_values_.size()); }
+
+  void set_node_value_in_thread(int tid, vertex_t& v, VD_T value) {
+    thread_values_[tid].emplace_back(v, value);
+  }
+
+  void apply_thread_values() {
+    for (auto& values : thread_values_) {
+      for (auto& pair : values) {
+        set_node_value(pair.first, pair.second);
+      }
+      values.clear();
+    }
+  }
+
   void init_value(vertex_range_t vertices, label_id_t label, VD_T value,
                   const std::function<bool(MD_T*, MD_T&&)>& aggregator) {
     partial_result_[label].Init(vertices, value, aggregator);
@@ -354,6 +509,7 @@ class PythonPIEComputeContext {
   // message auto parallel
   std::vector<grape::VertexArray<VD_T, vid_t>>& data_;
   std::vector<grape::SyncBuffer<VD_T, vid_t>> partial_result_;
+  std::vector<std::vector<std::pair<vertex_t, VD_T>>> thread_values_;
 };
 
 template <typename FRAG_T>
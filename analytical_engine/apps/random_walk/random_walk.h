@@ -0,0 +1,379 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_H_
+#define ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_H_
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/utils/alias_table.h"
+#include "random_walk/random_walk_context.h"
+
+namespace gs {
+
+namespace random_walk_impl {
+
+template <typename T>
+inline double weight_of(const T& data) {
+  return static_cast<double>(data);
+}
+
+inline double weight_of(const grape::EmptyType&) { return 1; }
+
+}  // namespace random_walk_impl
+
+/**
+ * @brief The random walks of walk_length from each vertex walk_num times,
+ * along the outgoing edges, uniformly, or by the weights of the edges with
+ * the alias tables, and biased by the return parameter p and the in-out
+ * parameter q of node2vec by the rejection sampling. A walk stays at a vertex
+ * without out neighbors.
+ *
+ * The walkers move inside a fragment till they reach an outer vertex, and are
+ * migrated to the owners in a batch per round. The edge from the previous
+ * vertex to a node2vec candidate is checked locally if either of them is an
+ * inner vertex, or else the candidate is proposed to its owner, which moves
+ * the walker to it when accepted, or returns the walker otherwise. The steps
+ * of a walk are sent to the fragment it starts from once all the walks
+ * finish. The walks are started in batches of kBatchSize per round.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class RandomWalk
+    : public grape::ParallelAppBase<FRAG_T, RandomWalkContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(RandomWalk<FRAG_T>, RandomWalkContext<FRAG_T>,
+                          FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using walker_t = typename context_t::Walker;
+  using record_t = typename context_t::record_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+  static constexpr size_t kBatchSize = 1 << 22;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+    ctx.walkers.resize(thread_num());
+    ctx.records.resize(thread_num());
+    for (int tid = 0; tid < thread_num(); ++tid) {
+      ctx.rngs.emplace_back(frag.fid() * thread_num() + tid);
+    }
+
+    buildNeighbors(frag, ctx);
+    for (auto v : frag.InnerVertices()) {
+      ctx.starts.push_back(v);
+    }
+    ctx.walks.resize(ctx.starts.size() * ctx.walk_num * ctx.walk_length);
+
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    if (ctx.gathering) {
+      messages.ParallelProcess<record_t>(
+          thread_num(), [&ctx](int tid, const record_t& record) {
+            ctx.walks[std::get<0>(record) * ctx.walk_length +
+                      std::get<1>(record)] = std::get<2>(record);
+          });
+      writeToCtx(frag, ctx);
+      return;
+    }
+
+    messages.ParallelProcess<walker_t>(
+        thread_num(), [&ctx](int tid, const walker_t& walker) {
+          ctx.walkers[tid].push_back(walker);
+        });
+
+    step(frag, ctx, messages);
+  }
+
+ private:
+  // copies the neighbors of the inner vertices sorted by the vertices, and
+  // builds the alias tables of the weights
+  void buildNeighbors(const fragment_t& frag, context_t& ctx) {
+    bool in_nbrs = ctx.second_order && frag.directed();
+    size_t out_size = 0, in_size = 0;
+    for (auto v : frag.InnerVertices()) {
+      ctx.nbr_begin[v] = out_size;
+      out_size += frag.GetLocalOutDegree(v);
+      ctx.nbr_end[v] = out_size;
+      if (in_nbrs) {
+        ctx.in_nbr_begin[v] = in_size;
+        in_size += frag.GetLocalInDegree(v);
+        ctx.in_nbr_end[v] = in_size;
+      }
+    }
+    ctx.nbrs.resize(out_size);
+    if (ctx.weighted) {
+      ctx.alias_prob.resize(out_size);
+      ctx.alias_index.resize(out_size);
+    }
+    ctx.in_nbrs.resize(in_size);
+
+    ForEach(frag.InnerVertices(), [&frag, &ctx, in_nbrs](int tid, vertex_t v) {
+      std::vector<std::pair<vertex_t, double>> edges;
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        edges.emplace_back(e.get_neighbor(),
+                           random_walk_impl::weight_of(e.get_data()));
+      }
+      std::sort(edges.begin(), edges.end(),
+                [](const std::pair<vertex_t, double>& lhs,
+                   const std::pair<vertex_t, double>& rhs) {
+                  return lhs.first.GetValue() < rhs.first.GetValue();
+                });
+      size_t begin = ctx.nbr_begin[v];
+      for (size_t i = 0; i < edges.size(); ++i) {
+        ctx.nbrs[begin + i] = edges[i].first;
+      }
+      if (ctx.weighted) {
+        std::vector<double> weights;
+        for (auto& edge : edges) {
+          weights.push_back(edge.second);
+        }
+        BuildAliasTable(weights.data(), weights.size(),
+                        &ctx.alias_prob[begin], &ctx.alias_index[begin]);
+      }
+
+      if (in_nbrs) {
+        size_t in_begin = ctx.in_nbr_begin[v];
+        for (auto& e : frag.GetIncomingAdjList(v)) {
+          ctx.in_nbrs[in_begin++] = e.get_neighbor();
+        }
+        std::sort(ctx.in_nbrs.begin() + ctx.in_nbr_begin[v],
+                  ctx.in_nbrs.begin() + ctx.in_nbr_end[v],
+                  [](const vertex_t& lhs, const vertex_t& rhs) {
+                    return lhs.GetValue() < rhs.GetValue();
+                  });
+      }
+    });
+  }
+
+  static bool hasNeighbor(const std::vector<vertex_t>& nbrs, size_t begin,
+                          size_t end, const vertex_t& u) {
+    return std::binary_search(nbrs.begin() + begin, nbrs.begin() + end, u,
+                              [](const vertex_t& lhs, const vertex_t& rhs) {
+                                return lhs.GetValue() < rhs.GetValue();
+                              });
+  }
+
+  // whether the edge t -> x exists, where x is an inner vertex
+  static bool hasEdgeTo(const fragment_t& frag, const context_t& ctx,
+                        const vertex_t& t, const vertex_t& x) {
+    if (frag.directed()) {
+      return hasNeighbor(ctx.in_nbrs, ctx.in_nbr_begin[x], ctx.in_nbr_end[x],
+                         t);
+    }
+    return hasNeighbor(ctx.nbrs, ctx.nbr_begin[x], ctx.nbr_end[x], t);
+  }
+
+  /**
+   * @brief The distance from the previous vertex of the gid t to the
+   * candidate x, or -1 if unknown in this fragment.
+   */
+  static int distance(const fragment_t& frag, const context_t& ctx, vid_t t,
+                      const vertex_t& x) {
+    if (frag.Vertex2Gid(x) == t) {
+      return 0;
+    }
+    vertex_t tv;
+    if (!frag.Gid2Vertex(t, tv)) {
+      // no edge to an inner vertex from the vertices not in the fragment
+      return frag.IsInnerVertex(x) ? 2 : -1;
+    }
+    if (frag.IsInnerVertex(tv)) {
+      return hasNeighbor(ctx.nbrs, ctx.nbr_begin[tv], ctx.nbr_end[tv], x) ? 1
+                                                                          : 2;
+    }
+    if (frag.IsInnerVertex(x)) {
+      return hasEdgeTo(frag, ctx, tv, x) ? 1 : 2;
+    }
+    return -1;
+  }
+
+  static vertex_t sample(const context_t& ctx, std::mt19937_64& rng,
+                         const vertex_t& u) {
+    size_t begin = ctx.nbr_begin[u], degree = ctx.nbr_end[u] - begin;
+    size_t i =
+        ctx.weighted
+            ? SampleAlias(&ctx.alias_prob[begin], &ctx.alias_index[begin],
+                          degree, rng)
+            : std::uniform_int_distribution<size_t>(0, degree - 1)(rng);
+    return ctx.nbrs[begin + i];
+  }
+
+  void record(const fragment_t& frag, context_t& ctx, int tid,
+              const walker_t& walker, vid_t gid) {
+    if (walker.home == frag.fid()) {
+      ctx.walks[static_cast<size_t>(walker.index) * ctx.walk_length +
+                walker.step] = gid;
+    } else {
+      ctx.records[tid].emplace_back(walker.home,
+                                    record_t(walker.index, walker.step, gid));
+    }
+  }
+
+  /**
+   * @brief Moves the walker from the inner vertex it is at, or the candidate
+   * proposed to this fragment, till it finishes or leaves the fragment.
+   * Returns whether it is sent to another fragment.
+   */
+  bool walk(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages, int tid, walker_t walker) {
+    auto& rng = ctx.rngs[tid];
+    std::uniform_real_distribution<double> coin(0, 1);
+    auto& channel = messages.Channels()[tid];
+    vertex_t u;
+
+    if (walker.cand != context_t::kNone) {
+      CHECK(frag.InnerVertexGid2Vertex(walker.cand, u));
+      if (coin(rng) * ctx.max_bias >=
+          ctx.bias(distance(frag, ctx, walker.prev, u))) {
+        vertex_t cur;
+        CHECK(frag.Gid2Vertex(walker.cur, cur));
+        walker.cand = context_t::kNone;
+        channel.SendToFragment(frag.GetFragId(cur), walker);
+        return true;
+      }
+      ++walker.step;
+      record(frag, ctx, tid, walker, walker.cand);
+      walker.prev = walker.cur;
+      walker.cur = walker.cand;
+      walker.cand = context_t::kNone;
+    } else {
+      CHECK(frag.InnerVertexGid2Vertex(walker.cur, u));
+    }
+
+    while (walker.step + 1 < ctx.walk_length) {
+      if (ctx.nbr_begin[u] == ctx.nbr_end[u]) {
+        while (walker.step + 1 < ctx.walk_length) {
+          ++walker.step;
+          record(frag, ctx, tid, walker, walker.cur);
+        }
+        break;
+      }
+      vertex_t x = sample(ctx, rng, u);
+      if (ctx.second_order && walker.prev != context_t::kNone) {
+        int dist = distance(frag, ctx, walker.prev, x);
+        if (dist < 0) {
+          walker.cand = frag.Vertex2Gid(x);
+          channel.SendToFragment(frag.GetFragId(x), walker);
+          return true;
+        }
+        if (coin(rng) * ctx.max_bias >= ctx.bias(dist)) {
+          continue;
+        }
+      }
+      ++walker.step;
+      vid_t gid = frag.Vertex2Gid(x);
+      record(frag, ctx, tid, walker, gid);
+      walker.prev = walker.cur;
+      walker.cur = gid;
+      if (!frag.IsInnerVertex(x)) {
+        channel.SendToFragment(frag.GetFragId(x), walker);
+        return true;
+      }
+      u = x;
+    }
+    return false;
+  }
+
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    std::vector<walker_t> walkers;
+    for (auto& list : ctx.walkers) {
+      walkers.insert(walkers.end(), list.begin(), list.end());
+      list.clear();
+    }
+    size_t total = ctx.starts.size() * ctx.walk_num;
+    size_t batch_end = std::min(total, ctx.started + kBatchSize);
+    for (size_t i = ctx.started; i < batch_end; ++i) {
+      auto gid = frag.Vertex2Gid(ctx.starts[i / ctx.walk_num]);
+      walkers.push_back({frag.fid(), static_cast<uint32_t>(i), 0,
+                         context_t::kNone, gid, context_t::kNone});
+      ctx.walks[i * ctx.walk_length] = gid;
+    }
+    ctx.started = batch_end;
+
+    std::vector<size_t> sent(thread_num(), 0);
+    ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(walkers.size())),
+            [&](int tid, vertex_t i) {
+              if (walk(frag, ctx, messages, tid, walkers[i.GetValue()])) {
+                ++sent[tid];
+              }
+            });
+
+    size_t remaining =
+        std::accumulate(sent.begin(), sent.end(), 0UL) + total - ctx.started;
+    size_t global_remaining = 0;
+    Sum(remaining, global_remaining);
+    if (global_remaining != 0) {
+      messages.ForceContinue();
+      return;
+    }
+
+    // sends the steps of the walks to the fragments they start from
+    ctx.gathering = true;
+    std::vector<size_t> record_num(thread_num(), 0);
+    auto lists = grape::VertexRange<vid_t>(
+        0, static_cast<vid_t>(ctx.records.size()));
+    ForEach(lists, [&ctx, &messages, &record_num](int tid, vertex_t i) {
+      auto& records = ctx.records[i.GetValue()];
+      for (auto& pair : records) {
+        messages.Channels()[tid].SendToFragment(pair.first, pair.second);
+      }
+      record_num[tid] += records.size();
+      records.clear();
+      records.shrink_to_fit();
+    });
+    size_t local_record_num =
+        std::accumulate(record_num.begin(), record_num.end(), 0UL);
+    size_t global_record_num = 0;
+    Sum(local_record_num, global_record_num);
+    if (global_record_num == 0) {
+      writeToCtx(frag, ctx);
+    }
+  }
+
+  void writeToCtx(const fragment_t& frag, context_t& ctx) {
+    std::vector<size_t> shape{ctx.walks.size() / ctx.walk_length,
+                              ctx.walk_length};
+
+    ctx.set_shape(shape);
+
+    auto* data = ctx.tensor().data();
+
+    for (size_t idx = 0; idx < ctx.walks.size(); ++idx) {
+      data[idx] = frag.Gid2Oid(ctx.walks[idx]);
+    }
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_H_
@@ -0,0 +1,150 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_CONTEXT_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/context/tensor_context.h"
+
+namespace gs {
+/**
+ * @brief Context for the random walks, of which the result is a tensor of
+ * the ids of the vertices, a row of walk_length per walk, and walk_num rows
+ * per vertex in the order of the inner vertices of the fragments.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class RandomWalkContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  static constexpr vid_t kNone = std::numeric_limits<vid_t>::max();
+
+  /**
+   * @brief The state of a walk in flight, i.e., its index in the walks of the
+   * fragment it starts from, the steps taken, the gids of the previous and
+   * the current vertices, and the candidate of the next step proposed to its
+   * owner, by the node2vec walks, or kNone.
+   */
+  struct Walker {
+    grape::fid_t home;
+    uint32_t index;
+    uint32_t step;
+    vid_t prev;
+    vid_t cur;
+    vid_t cand;
+  };
+
+  // the index of a walk in the fragment it starts from, the step and the gid
+  using record_t = std::tuple<uint32_t, uint32_t, vid_t>;
+
+  explicit RandomWalkContext(const FRAG_T& fragment)
+      : TensorContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
+
+  /**
+   * @param walk_length The number of the vertices of a walk.
+   * @param walk_num The number of the walks from each vertex.
+   * @param weighted Whether to move by the weights of the edges.
+   * @param p The return parameter of node2vec.
+   * @param q The in-out parameter of node2vec.
+   */
+  void Init(grape::ParallelMessageManager& messages, int walk_length,
+            int walk_num, bool weighted, double p, double q) {
+    auto& frag = this->fragment();
+
+    CHECK_GT(walk_length, 0);
+    CHECK_GT(walk_num, 0);
+    CHECK(p > 0 && q > 0);
+    this->walk_length = walk_length;
+    this->walk_num = walk_num;
+    this->weighted = weighted;
+    this->p = p;
+    this->q = q;
+    second_order = p != 1 || q != 1;
+    max_bias = std::max(std::max(1 / p, 1.0), 1 / q);
+
+    nbr_begin.Init(frag.InnerVertices(), 0);
+    nbr_end.Init(frag.InnerVertices(), 0);
+    in_nbr_begin.Init(frag.InnerVertices(), 0);
+    in_nbr_end.Init(frag.InnerVertices(), 0);
+  }
+
+  // the bias of node2vec to move to a vertex of the distance to the previous
+  // vertex
+  double bias(int distance) const {
+    return distance == 0 ? 1 / p : (distance == 1 ? 1 : 1 / q);
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+
+    for (size_t i = 0; i < walks.size(); i += walk_length) {
+      std::string buf;
+
+      for (size_t j = i; j < i + walk_length; ++j) {
+        buf += std::to_string(frag.Gid2Oid(walks[j])) + " ";
+      }
+      if (!buf.empty()) {
+        buf[buf.size() - 1] = '\n';
+        os << buf;
+      }
+    }
+  }
+
+  uint32_t walk_length;
+  uint32_t walk_num;
+  bool weighted;
+  double p, q;
+  bool second_order;
+  double max_bias;
+
+  // the out neighbors of the inner vertices sorted by the vertices, with the
+  // alias tables by the weights, and the in neighbors when directed, to check
+  // the edges to the inner vertices for node2vec
+  typename FRAG_T::template vertex_array_t<size_t> nbr_begin, nbr_end;
+  std::vector<vertex_t> nbrs;
+  std::vector<double> alias_prob;
+  std::vector<uint32_t> alias_index;
+  typename FRAG_T::template vertex_array_t<size_t> in_nbr_begin, in_nbr_end;
+  std::vector<vertex_t> in_nbrs;
+
+  // the inner vertices the walks start from, and the walks started so far
+  std::vector<vertex_t> starts;
+  size_t started = 0;
+  bool gathering = false;
+  // the walkers to move, the steps of the walks from the other fragments
+  // per thread, and the gids of the walks from this fragment
+  std::vector<std::vector<Walker>> walkers;
+  std::vector<std::vector<std::pair<grape::fid_t, record_t>>> records;
+  std::vector<std::mt19937_64> rngs;
+  std::vector<vid_t> walks;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_RANDOM_WALK_RANDOM_WALK_CONTEXT_H_
@@ -16,7 +16,8 @@
 #ifndef ANALYTICAL_ENGINE_APPS_SAMPLING_PATH_SAMPLING_PATH_H_
 #define ANALYTICAL_ENGINE_APPS_SAMPLING_PATH_SAMPLING_PATH_H_
 
-#include <queue>
+#include <algorithm>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,10 @@
 namespace gs {
 /**
  * @brief Sampling paths obey source label-edge label-destination label pattern.
+ * The paths are extended depth first in a buffer of the path length, and the
+ * ones found are stored flat, so a fragment holds no more than the limit of
+ * the paths, and stops extending once the limit is reached. A path reaching
+ * an outer vertex is sent to the owner with the vertices so far.
  * @tparam FRAG_T
  */
 template <typename FRAG_T>
@@ -39,101 +44,119 @@ class SamplingPath
   using path_t = typename context_t::path_t;
   using layer_t = int;
 
-  void BFS(const fragment_t& frag, context_t& ctx, message_manager_t& messages,
-           std::queue<std::pair<layer_t, path_t>>& paths) {
-    auto& path_pattern = ctx.path_pattern;
-    auto& path_result = ctx.path_result;
-
-    while (!paths.empty()) {
-      auto& pair = paths.front();
-      auto level = pair.first;
-      auto& path = pair.second;
-
-      if ((size_t)(level + 2) < ctx.path_pattern.size()) {
-        vertex_t u;
-        auto curr_e_label = ctx.path_pattern[level + 1];
-        auto curr_v_label = ctx.path_pattern[level + 2];
-
-        CHECK_GT(path.size(), 0);
-        CHECK(frag.Gid2Vertex(path[path.size() - 1], u));
-        auto oes = frag.GetOutgoingAdjList(u, curr_e_label);
-
-        for (auto& e : oes) {
-          auto v = e.neighbor();
-
-          if (frag.vertex_label(v) == curr_v_label) {
-            std::vector<vid_t> new_path(path);
-            new_path.push_back(frag.Vertex2Gid(v));
-
-            // |pattern| = k, the result should have "k / 2 + 1" vertices
-            // e.g. pattern = "v0-e0-v1-e1-v2", path = "v0 v1 v2"
-            if (new_path.size() == path_pattern.size() / 2 + 1) {
-              path_result.push_back(new_path);
-            } else {
-              auto new_pair = std::make_pair(level + 2, new_path);
-              if (frag.IsInnerVertex(v)) {
-                paths.push(new_pair);
-              } else {
-                messages.SendToFragment(frag.GetFragId(v), new_pair);
-              }
-            }
-          }
-        }
-      }
-      paths.pop();
-    }
-  }
-
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
     auto curr_u_label = ctx.path_pattern[0];
     auto inner_vertices = frag.InnerVertices(curr_u_label);
 
-    std::queue<std::pair<layer_t, path_t>> paths;
+    path_t path(ctx.path_length);
+    size_t sent = 0;
 
     for (auto u : inner_vertices) {
-      std::pair<layer_t, path_t> pair(0, {frag.Vertex2Gid(u)});
-      paths.push(pair);
+      path[0] = frag.Vertex2Gid(u);
+      if (!extend(frag, ctx, messages, path, u, 0, sent)) {
+        break;
+      }
     }
 
-    BFS(frag, ctx, messages, paths);
+    finish(frag, ctx, sent);
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    std::queue<std::pair<layer_t, path_t>> paths;
+    path_t path(ctx.path_length);
+    size_t sent = 0;
+    bool full = ctx.path_num() >= ctx.total_path_limit;
 
     {
       std::pair<layer_t, path_t> msg;
 
       while (messages.GetMessage(msg)) {
-        paths.push(msg);
+        if (full) {
+          continue;
+        }
+        std::copy(msg.second.begin(), msg.second.end(), path.begin());
+        vertex_t u;
+        CHECK(frag.InnerVertexGid2Vertex(msg.second.back(), u));
+        full = !extend(frag, ctx, messages, path, u, msg.first, sent);
       }
     }
 
-    // A rough implementation to limit path count
-    uint32_t total_path_count;
-    Sum((uint32_t) ctx.path_result.size(), total_path_count);
+    finish(frag, ctx, sent);
+  }
 
-    if (total_path_count >= ctx.total_path_limit) {
-      auto& path_result = ctx.path_result;
-      std::vector<size_t> shape{path_result.size(),
-                                ctx.path_pattern.size() / 2 + 1};
+ private:
+  /**
+   * @brief Extends the path ending at the vertex u at the level of the
+   * pattern, where the vertices of the path are in the buffer up to u.
+   * Returns false when the paths found reach the limit.
+   */
+  bool extend(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages, path_t& path, const vertex_t& u,
+              layer_t level, size_t& sent) {
+    size_t pos = level / 2;
+    if (pos + 1 == ctx.path_length) {
+      ctx.path_result.insert(ctx.path_result.end(), path.begin(), path.end());
+      return ctx.path_num() < ctx.total_path_limit;
+    }
+    if (!frag.IsInnerVertex(u)) {
+      messages.SendToFragment(
+          frag.GetFragId(u),
+          std::make_pair(level, path_t(path.begin(), path.begin() + pos + 1)));
+      ++sent;
+      return true;
+    }
 
-      ctx.set_shape(shape);
+    auto curr_e_label = ctx.path_pattern[level + 1];
+    auto curr_v_label = ctx.path_pattern[level + 2];
+    auto oes = frag.GetOutgoingAdjList(u, curr_e_label);
 
-      auto* data = ctx.tensor().data();
-      size_t idx = 0;
+    for (auto& e : oes) {
+      auto v = e.neighbor();
 
-      for (auto& path : path_result) {
-        for (auto gid : path) {
-          data[idx++] = frag.Gid2Oid(gid);
+      if (frag.vertex_label(v) == curr_v_label) {
+        path[pos + 1] = frag.Vertex2Gid(v);
+        if (!extend(frag, ctx, messages, path, v, level + 2, sent)) {
+          return false;
         }
       }
+    }
+    return true;
+  }
+
+  // writes the first total_path_limit paths, by the order of the fragments,
+  // to the tensor when the limit is reached or no path is in flight
+  void finish(const fragment_t& frag, context_t& ctx, size_t sent) {
+    auto path_count = static_cast<uint32_t>(ctx.path_num());
+    uint32_t total_path_count;
+    Sum(path_count, total_path_count);
+    size_t total_sent;
+    Sum(sent, total_sent);
+
+    if (total_path_count < ctx.total_path_limit && total_sent != 0) {
       return;
     }
 
-    BFS(frag, ctx, messages, paths);
+    std::vector<uint32_t> path_counts;
+    AllGather(path_count, path_counts);
+    uint32_t before = std::accumulate(path_counts.begin(),
+                                      path_counts.begin() + frag.fid(), 0U);
+    size_t kept = before >= ctx.total_path_limit
+                      ? 0
+                      : std::min(path_count, ctx.total_path_limit - before);
+    auto& path_result = ctx.path_result;
+    path_result.resize(kept * ctx.path_length);
+    path_result.shrink_to_fit();
+
+    std::vector<size_t> shape{kept, ctx.path_length};
+
+    ctx.set_shape(shape);
+
+    auto* data = ctx.tensor().data();
+
+    for (size_t idx = 0; idx < path_result.size(); ++idx) {
+      data[idx] = frag.Gid2Oid(path_result[idx]);
+    }
   }
 };
 
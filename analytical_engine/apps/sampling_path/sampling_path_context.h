@@ -40,8 +40,13 @@ class SamplingPathContext
       : TensorContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
 
   std::vector<label_t> path_pattern;
-  std::vector<path_t> path_result;
+  // the vertices of a path, i.e., |path_pattern| / 2 + 1
+  size_t path_length;
+  // the gids of the paths found, path_length per path
+  std::vector<vid_t> path_result;
   uint32_t total_path_limit;
+
+  size_t path_num() const { return path_result.size() / path_length; }
   /**
    *
    * @param frag
@@ -61,6 +66,8 @@ class SamplingPathContext
     // make sure the path pattern is valid
     CHECK_GE(path_pattern.size(), 3);
     CHECK_EQ(path_pattern.size() % 2, 1);
+    // e.g. pattern = "v0-e0-v1-e1-v2", path = "v0 v1 v2"
+    path_length = path_pattern.size() / 2 + 1;
 
     for (uint32_t u_label_idx = 0; u_label_idx + 1 < path_pattern.size();
          u_label_idx += 2) {
@@ -75,11 +82,11 @@ class SamplingPathContext
   void Output(std::ostream& os) override {
     auto& frag = this->fragment();
 
-    for (auto& path : path_result) {
+    for (size_t i = 0; i < path_result.size(); i += path_length) {
       std::string buf;
 
-      for (auto gid : path) {
-        buf += std::to_string(frag.Gid2Oid(gid)) + " ";
+      for (size_t j = i; j < i + path_length; ++j) {
+        buf += std::to_string(frag.Gid2Oid(path_result[j])) + " ";
       }
       if (!buf.empty()) {
         buf[buf.size() - 1] = '\n';
@@ -0,0 +1,314 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_SCC_SCC_H_
+#define ANALYTICAL_ENGINE_APPS_SCC_SCC_H_
+
+#include <numeric>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "scc/scc_context.h"
+
+namespace gs {
+/**
+ * @brief The strongly connected components by the coloring, in which each
+ * vertex is labeled by the gid of the root of its component. A phase first
+ * trims the vertices without an unassigned in or out neighbor, each a
+ * component, till nothing is trimmed. Then the least gid reaching each
+ * unassigned vertex is propagated as its color along the outgoing edges, and
+ * a vertex of its own gid as the color is a root. The component of a root
+ * is the vertices of its color reaching it, searched backward along the
+ * incoming edges. The phases repeat till all the vertices are assigned.
+ *
+ * The stages run to a local fixpoint in each round, with the outer vertices
+ * synced to the owners once per round, and the assignments are synced to
+ * the mirrors for the trimming.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class SCC : public grape::ParallelAppBase<FRAG_T, SCCContext<FRAG_T>>,
+            public grape::ParallelEngine,
+            public grape::Communicator {
+ public:
+  INSTALL_PARALLEL_WORKER(SCC<FRAG_T>, SCCContext<FRAG_T>, FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using stage_t = typename context_t::Stage;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    auto stage = ctx.stage;
+    messages.ParallelProcess<fragment_t, vid_t>(
+        thread_num(), frag,
+        [&frag, &ctx, stage](int tid, vertex_t u, vid_t msg) {
+          if (frag.IsOuterVertex(u)) {
+            // the mirror of a vertex assigned
+            ctx.scc[u] = msg;
+          } else if (ctx.scc[u] == context_t::kNone) {
+            if (stage == stage_t::kColor) {
+              if (grape::atomic_min(ctx.color[u], msg)) {
+                ctx.active.Insert(u);
+              }
+            } else if (stage == stage_t::kBackward && ctx.color[u] == msg) {
+              ctx.scc[u] = msg;
+              ctx.active.Insert(u);
+              ctx.assigned.Insert(u);
+            }
+          }
+        });
+
+    step(frag, ctx, messages);
+  }
+
+ private:
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    if (ctx.stage == stage_t::kTrim) {
+      size_t remaining = trim(frag, ctx, messages);
+      size_t global_remaining = 0;
+      Sum(remaining, global_remaining);
+      if (global_remaining == 0) {
+        return;
+      }
+      if (ctx.stage == stage_t::kTrim) {
+        messages.ForceContinue();
+        return;
+      }
+      // starts the coloring in the same round
+      ForEach(frag.InnerVertices(), [&frag, &ctx](int tid, vertex_t v) {
+        if (ctx.scc[v] == context_t::kNone) {
+          ctx.color[v] = frag.Vertex2Gid(v);
+          ctx.active.Insert(v);
+        }
+      });
+      ForEach(frag.OuterVertices(), [&ctx](int tid, vertex_t v) {
+        ctx.color[v] = context_t::kNone;
+      });
+    }
+
+    if (ctx.stage == stage_t::kColor) {
+      size_t sent = color(frag, ctx, messages);
+      size_t global_sent = 0;
+      Sum(sent, global_sent);
+      if (global_sent != 0) {
+        messages.ForceContinue();
+        return;
+      }
+      // the colors are settled, and the roots start the backward search
+      ctx.stage = stage_t::kBackward;
+      ForEach(frag.InnerVertices(), [&frag, &ctx](int tid, vertex_t v) {
+        if (ctx.scc[v] == context_t::kNone &&
+            ctx.color[v] == frag.Vertex2Gid(v)) {
+          ctx.scc[v] = ctx.color[v];
+          ctx.active.Insert(v);
+          ctx.assigned.Insert(v);
+        }
+      });
+      ForEach(frag.OuterVertices(), [&ctx](int tid, vertex_t v) {
+        ctx.color[v] = context_t::kNone;
+      });
+    }
+
+    size_t sent = backward(frag, ctx, messages);
+    size_t global_sent = 0;
+    Sum(sent, global_sent);
+    if (global_sent == 0) {
+      // the phase is finished, and the trimming of the next one starts once
+      // the assignments reach the mirrors
+      ctx.stage = stage_t::kTrim;
+    }
+    messages.ForceContinue();
+  }
+
+  template <typename FUNC_T>
+  void propagate(const fragment_t& frag, context_t& ctx, const FUNC_T& func) {
+    while (!ctx.active.Empty()) {
+      ForEach(ctx.active, func);
+      ctx.active.ParallelClear(thread_num());
+      ctx.active.Swap(ctx.next_active);
+    }
+  }
+
+  static bool isUnassigned(const context_t& ctx, const vertex_t& v,
+                           const vertex_t& u) {
+    return u != v && ctx.scc[u] == context_t::kNone;
+  }
+
+  template <typename ADJ_LIST_T>
+  static bool hasUnassigned(const context_t& ctx, const vertex_t& v,
+                            const ADJ_LIST_T& es) {
+    for (auto& e : es) {
+      if (isUnassigned(ctx, v, e.get_neighbor())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // syncs the vertices assigned in the round to the mirrors
+  size_t syncAssigned(const fragment_t& frag, context_t& ctx,
+                      message_manager_t& messages) {
+    std::vector<size_t> assigned_num(thread_num(), 0);
+    ForEach(ctx.assigned,
+            [&frag, &ctx, &messages, &assigned_num](int tid, vertex_t v) {
+              messages.SendMsgThroughEdges<fragment_t, vid_t>(frag, v,
+                                                              ctx.scc[v], tid);
+              ++assigned_num[tid];
+            });
+    ctx.assigned.ParallelClear(thread_num());
+    return std::accumulate(assigned_num.begin(), assigned_num.end(), 0UL);
+  }
+
+  // trims the vertices without an unassigned in or out neighbor to a local
+  // fixpoint, and returns the number of the unassigned inner vertices, or
+  // moves to the coloring when nothing is trimmed globally
+  size_t trim(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t v) {
+      if (ctx.scc[v] == context_t::kNone) {
+        ctx.active.Insert(v);
+      }
+    });
+    propagate(frag, ctx, [&frag, &ctx](int tid, vertex_t v) {
+      if (ctx.scc[v] != context_t::kNone ||
+          (hasUnassigned(ctx, v, frag.GetOutgoingAdjList(v)) &&
+           hasUnassigned(ctx, v, frag.GetIncomingAdjList(v)))) {
+        return;
+      }
+      ctx.scc[v] = frag.Vertex2Gid(v);
+      ctx.assigned.Insert(v);
+      auto wake = [&frag, &ctx, &v](const vertex_t& u) {
+        if (frag.IsInnerVertex(u) && isUnassigned(ctx, v, u)) {
+          ctx.next_active.Insert(u);
+        }
+      };
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        wake(e.get_neighbor());
+      }
+      for (auto& e : frag.GetIncomingAdjList(v)) {
+        wake(e.get_neighbor());
+      }
+    });
+
+    size_t trimmed = syncAssigned(frag, ctx, messages);
+    size_t global_trimmed = 0;
+    Sum(trimmed, global_trimmed);
+    if (global_trimmed == 0) {
+      ctx.stage = stage_t::kColor;
+    }
+
+    std::vector<size_t> remaining(thread_num(), 0);
+    ForEach(frag.InnerVertices(), [&ctx, &remaining](int tid, vertex_t v) {
+      if (ctx.scc[v] == context_t::kNone) {
+        ++remaining[tid];
+      }
+    });
+    return std::accumulate(remaining.begin(), remaining.end(), 0UL);
+  }
+
+  // propagates the least colors along the outgoing edges to a local fixpoint,
+  // and returns the number of the colors sent
+  size_t color(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    propagate(frag, ctx, [&frag, &ctx](int tid, vertex_t v) {
+      vid_t c = ctx.color[v];
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        if (ctx.scc[u] != context_t::kNone ||
+            !grape::atomic_min(ctx.color[u], c)) {
+          continue;
+        }
+        if (frag.IsInnerVertex(u)) {
+          ctx.next_active.Insert(u);
+        } else {
+          ctx.outer_updated.Insert(u);
+        }
+      }
+    });
+    return syncOuterVertices(frag, ctx, messages);
+  }
+
+  // searches the vertices of the colors of the roots backward to a local
+  // fixpoint, and returns the number of the messages sent
+  size_t backward(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages) {
+    propagate(frag, ctx, [&frag, &ctx](int tid, vertex_t v) {
+      vid_t c = ctx.scc[v];
+      for (auto& e : frag.GetIncomingAdjList(v)) {
+        auto u = e.get_neighbor();
+        if (ctx.scc[u] != context_t::kNone) {
+          continue;
+        }
+        if (frag.IsInnerVertex(u)) {
+          if (ctx.color[u] == c) {
+            ctx.scc[u] = c;
+            ctx.next_active.Insert(u);
+            ctx.assigned.Insert(u);
+          }
+        } else if (raise(ctx.color[u], c)) {
+          // the color of u is no less than the ones of its out neighbors, so
+          // only the largest one may match
+          ctx.outer_updated.Insert(u);
+        }
+      }
+    });
+    return syncOuterVertices(frag, ctx, messages) +
+           syncAssigned(frag, ctx, messages);
+  }
+
+  size_t syncOuterVertices(const fragment_t& frag, context_t& ctx,
+                           message_manager_t& messages) {
+    std::vector<size_t> sent(thread_num(), 0);
+    ForEach(ctx.outer_updated,
+            [&frag, &ctx, &messages, &sent](int tid, vertex_t u) {
+              messages.Channels()[tid].SyncStateOnOuterVertex<fragment_t,
+                                                              vid_t>(
+                  frag, u, ctx.color[u]);
+              ++sent[tid];
+            });
+    ctx.outer_updated.ParallelClear(thread_num());
+    return std::accumulate(sent.begin(), sent.end(), 0UL);
+  }
+
+  // raises the value to c, where kNone is the least
+  static bool raise(vid_t& value, vid_t c) {
+    vid_t curr = value;
+    while (curr == context_t::kNone || curr < c) {
+      if (__sync_bool_compare_and_swap(&value, curr, c)) {
+        return true;
+      }
+      curr = value;
+    }
+    return false;
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SCC_SCC_H_
@@ -0,0 +1,78 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_SCC_SCC_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_SCC_SCC_CONTEXT_H_
+
+#include <limits>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+template <typename FRAG_T>
+class SCCContext
+    : public grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+
+  // the stages of a phase, see SCC
+  enum class Stage { kTrim, kColor, kBackward };
+
+  static constexpr vid_t kNone = std::numeric_limits<vid_t>::max();
+
+  explicit SCCContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                  true),
+        scc(this->data()) {}
+
+  void Init(grape::ParallelMessageManager& messages) {
+    auto& frag = this->fragment();
+
+    scc.Init(frag.Vertices(), kNone);
+    color.Init(frag.Vertices(), kNone);
+    active.Init(frag.InnerVertices());
+    next_active.Init(frag.InnerVertices());
+    assigned.Init(frag.InnerVertices());
+    outer_updated.Init(frag.OuterVertices());
+    stage = Stage::kTrim;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << scc[v] << std::endl;
+    }
+  }
+
+  // the gid of the root of the component of a vertex, or kNone if not
+  // assigned yet, which is synced to the mirrors of the inner vertices
+  typename FRAG_T::template vertex_array_t<vid_t>& scc;
+  // the least gid reaching a vertex through the unassigned vertices, and the
+  // least one to send of an outer vertex
+  typename FRAG_T::template vertex_array_t<vid_t> color;
+  // the inner vertices to visit in the current round and the next one, and
+  // the ones assigned in the round
+  grape::DenseVertexSet<vid_t> active, next_active, assigned;
+  grape::DenseVertexSet<vid_t> outer_updated;
+  Stage stage;
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SCC_SCC_CONTEXT_H_
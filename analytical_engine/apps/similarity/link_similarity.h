@@ -0,0 +1,217 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_H_
+#define ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_H_
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/fragment/sorted_adj_list.h"
+#include "core/utils/min_hash.h"
+#include "similarity/link_similarity_context.h"
+
+namespace gs {
+/**
+ * @brief The link prediction scores of the edges of an undirected graph,
+ * i.e., the common neighbors, the Jaccard similarity and the Adamic-Adar
+ * index of the ends of each edge, computed once per edge by the fragment
+ * owning the end of the higher degree, ties broken by the gids.
+ *
+ * If the other end is of the degree at most max_exact_degree, its sorted
+ * neighbors are sent to the fragment, and the scores are exact by the
+ * intersection with the neighbors of the higher end. Or else both ends are
+ * of the high degrees, of which the MinHash sketches are sent instead, and
+ * the scores are estimated by the agreeing hashes, i.e., the Jaccard J by
+ * their fraction, the common neighbors by J * (d_u + d_v) / (1 + J), and the
+ * Adamic-Adar by the common neighbors times the mean weight of the agreed
+ * ones, as they are sampled uniformly from the common neighbors.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class LinkSimilarity
+    : public grape::ParallelAppBase<FRAG_T, LinkSimilarityContext<FRAG_T>>,
+      public grape::ParallelEngine {
+ public:
+  INSTALL_PARALLEL_WORKER(LinkSimilarity<FRAG_T>,
+                          LinkSimilarityContext<FRAG_T>, FRAG_T);
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+  using nbrs_msg_t = typename context_t::nbrs_msg_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kOnlyOut;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    CHECK(!frag.directed()) << "link_similarity works on undirected graphs";
+    messages.InitChannels(thread_num());
+
+    ctx.stage = 0;
+    ForEach(frag.InnerVertices(),
+            [&messages, &frag, &ctx](int tid, vertex_t v) {
+              auto& nbrs = ctx.nbrs[v];
+              vid_t gid = frag.GetInnerVertexGid(v);
+              for (auto& e : frag.GetOutgoingAdjList(v)) {
+                vid_t nbr_gid = frag.Vertex2Gid(e.get_neighbor());
+                if (nbr_gid != gid) {
+                  nbrs.push_back(nbr_gid);
+                }
+              }
+              std::sort(nbrs.begin(), nbrs.end());
+              nbrs.erase(std::unique(nbrs.begin(), nbrs.end()), nbrs.end());
+              ctx.degree[v] = nbrs.size();
+              messages.SendMsgThroughOEdges<fragment_t, size_t>(
+                  frag, v, ctx.degree[v], tid);
+            });
+    messages.ForceContinue();
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    if (ctx.stage == 0) {
+      ctx.stage = 1;
+      messages.ParallelProcess<fragment_t, size_t>(
+          thread_num(), frag,
+          [&ctx](int tid, vertex_t u, size_t msg) { ctx.degree[u] = msg; });
+      sendNbrs(frag, ctx, messages);
+      messages.ForceContinue();
+    } else if (ctx.stage == 1) {
+      ctx.stage = 2;
+      messages.ParallelProcess<fragment_t, nbrs_msg_t>(
+          thread_num(), frag,
+          [&ctx](int tid, vertex_t u, const nbrs_msg_t& msg) {
+            ctx.nbrs[u] = msg.nbrs;
+            ctx.sketch[u] = msg.sketch;
+            ctx.sketch_weights[u] = msg.sketch_weights;
+          });
+      scoreEdges(frag, ctx);
+    }
+  }
+
+ private:
+  // the weights of the neighbors of the inner vertices, and the neighbors of
+  // them of the low degrees, or the sketches of the others
+  void sendNbrs(const fragment_t& frag, context_t& ctx,
+                message_manager_t& messages) {
+    ForEach(frag.InnerVertices(), [&](int tid, vertex_t v) {
+      auto& nbrs = ctx.nbrs[v];
+      auto& weights = ctx.nbr_weights[v];
+      weights.resize(nbrs.size());
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        auto u = e.get_neighbor();
+        vid_t gid = frag.Vertex2Gid(u);
+        auto iter = std::lower_bound(nbrs.begin(), nbrs.end(), gid);
+        if (iter != nbrs.end() && *iter == gid) {
+          size_t degree = ctx.degree[u];
+          weights[iter - nbrs.begin()] =
+              degree > 1 ? 1.0 / std::log(static_cast<double>(degree)) : 0;
+        }
+      }
+
+      nbrs_msg_t msg;
+      if (ctx.degree[v] <= ctx.max_exact_degree) {
+        msg.nbrs = nbrs;
+      } else {
+        MinHashSketch(nbrs, weights, ctx.num_hashes, ctx.sketch[v],
+                      ctx.sketch_weights[v]);
+        msg.sketch = ctx.sketch[v];
+        msg.sketch_weights = ctx.sketch_weights[v];
+      }
+      messages.SendMsgThroughOEdges<fragment_t, nbrs_msg_t>(frag, v, msg, tid);
+    });
+  }
+
+  void scoreEdges(const fragment_t& frag, context_t& ctx) {
+    std::vector<std::vector<double>> rows(thread_num());
+
+    ForEach(frag.InnerVertices(), [&](int tid, vertex_t u) {
+      size_t u_degree = ctx.degree[u];
+      vid_t u_gid = frag.GetInnerVertexGid(u);
+      std::vector<vertex_t> lighter;
+      for (auto& e : frag.GetOutgoingAdjList(u)) {
+        auto v = e.get_neighbor();
+        size_t v_degree = ctx.degree[v];
+        vid_t v_gid = frag.Vertex2Gid(v);
+        if (v_degree < u_degree || (v_degree == u_degree && v_gid < u_gid)) {
+          lighter.push_back(v);
+        }
+      }
+      std::sort(lighter.begin(), lighter.end());
+      lighter.erase(std::unique(lighter.begin(), lighter.end()),
+                    lighter.end());
+
+      auto& row = rows[tid];
+      for (auto& v : lighter) {
+        size_t v_degree = ctx.degree[v];
+        double common = 0, jaccard = 0, adamic_adar = 0;
+        bool exact = v_degree <= ctx.max_exact_degree;
+        if (exact) {
+          auto& weights = ctx.nbr_weights[u];
+          common = static_cast<double>(intersect(
+              ctx.nbrs[v], ctx.nbrs[u],
+              [&adamic_adar, &weights](size_t j) {
+                adamic_adar += weights[j];
+              }));
+          jaccard = common / (u_degree + v_degree - common);
+        } else {
+          auto& weights = ctx.sketch_weights[u];
+          double weight_sum = 0;
+          auto matches = static_cast<double>(MinHashMatches(
+              ctx.sketch[u], ctx.sketch[v],
+              [&weight_sum, &weights](size_t i) { weight_sum += weights[i]; }));
+          jaccard = matches / ctx.num_hashes;
+          common = jaccard * (u_degree + v_degree) / (1 + jaccard);
+          adamic_adar = matches > 0 ? common * weight_sum / matches : 0;
+        }
+        row.push_back(static_cast<double>(frag.GetId(u)));
+        row.push_back(static_cast<double>(frag.GetId(v)));
+        row.push_back(common);
+        row.push_back(jaccard);
+        row.push_back(adamic_adar);
+        row.push_back(exact ? 1 : 0);
+      }
+    });
+
+    std::vector<double> data;
+    for (auto& row : rows) {
+      data.insert(data.end(), row.begin(), row.end());
+    }
+    std::vector<size_t> shape{data.size() / context_t::kColumnNum,
+                              context_t::kColumnNum};
+    ctx.assign(data, shape);
+  }
+
+  // calls func(j) for b[j] in both of the sorted a and b, see
+  // IntersectSortedRuns
+  template <typename FUNC_T>
+  static size_t intersect(const std::vector<vid_t>& a,
+                          const std::vector<vid_t>& b, const FUNC_T& func) {
+    return IntersectSortedRuns(
+        a.data(), a.data() + a.size(), b.data(), b.data() + b.size(),
+        [](vid_t gid) { return gid; },
+        [&b, &func](const vid_t*, const vid_t*, const vid_t* iter,
+                    const vid_t*) { func(iter - b.data()); });
+  }
+};
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_H_
@@ -0,0 +1,143 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_CONTEXT_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/context/tensor_context.h"
+
+namespace gs {
+
+/**
+ * @brief The neighbors of a vertex sent to the fragments having it as an
+ * outer vertex, i.e., the sorted gids of the neighbors if its degree is at
+ * most max_exact_degree, or else the MinHash sketch of them, with the
+ * Adamic-Adar weights of the least ones, see MinHashSketch.
+ */
+template <typename VID_T>
+struct LinkSimilarityNbrs {
+  std::vector<VID_T> nbrs;
+  std::vector<uint64_t> sketch;
+  std::vector<double> sketch_weights;
+
+  friend grape::InArchive& operator<<(grape::InArchive& in_archive,
+                                      const LinkSimilarityNbrs& msg) {
+    in_archive << msg.nbrs;
+    in_archive << msg.sketch;
+    in_archive << msg.sketch_weights;
+    return in_archive;
+  }
+
+  friend grape::OutArchive& operator>>(grape::OutArchive& out_archive,
+                                       LinkSimilarityNbrs& msg) {
+    out_archive >> msg.nbrs;
+    out_archive >> msg.sketch;
+    out_archive >> msg.sketch_weights;
+    return out_archive;
+  }
+};
+
+/**
+ * @brief Context for the link similarities, of which the result is a row of
+ * (src, dst, common neighbors, Jaccard, Adamic-Adar, exact) per edge, i.e.,
+ * once per undirected edge, with the ids of the vertices as doubles, and
+ * exact being 1 if the scores are exact, or 0 if estimated by the sketches.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class LinkSimilarityContext : public TensorContext<FRAG_T, double> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+  using nbrs_msg_t = LinkSimilarityNbrs<vid_t>;
+
+  static_assert(std::is_arithmetic<oid_t>::value,
+                "The ids of the vertices are written as doubles");
+
+  // the columns of a row of the result
+  static constexpr size_t kColumnNum = 6;
+
+  explicit LinkSimilarityContext(const FRAG_T& fragment)
+      : TensorContext<FRAG_T, double>(fragment) {}
+
+  /**
+   * @param max_exact_degree The scores of an edge are exact by the
+   * intersection of the neighbors if either end is of the degree at most
+   * this, or else estimated by the MinHash sketches of the ends.
+   * @param num_hashes The hashes of a sketch, with the standard error of the
+   * estimated Jaccard about 1 / sqrt(num_hashes).
+   */
+  void Init(grape::ParallelMessageManager& messages, int max_exact_degree,
+            int num_hashes) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+
+    CHECK_GE(max_exact_degree, 0);
+    CHECK_GT(num_hashes, 0);
+    this->max_exact_degree = static_cast<size_t>(max_exact_degree);
+    this->num_hashes = static_cast<size_t>(num_hashes);
+
+    degree.Init(vertices, 0);
+    nbrs.Init(vertices);
+    nbr_weights.Init(frag.InnerVertices());
+    sketch.Init(vertices);
+    sketch_weights.Init(vertices);
+    stage = 0;
+  }
+
+  void Output(std::ostream& os) override {
+    auto& tensor = this->tensor();
+    const double* data = tensor.data();
+
+    for (size_t i = 0; i < tensor.size(); i += kColumnNum) {
+      os << static_cast<oid_t>(data[i]) << " "
+         << static_cast<oid_t>(data[i + 1]);
+      for (size_t j = 2; j < kColumnNum; ++j) {
+        os << " " << data[i + j];
+      }
+      os << std::endl;
+    }
+  }
+
+  size_t max_exact_degree = 0;
+  size_t num_hashes = 0;
+
+  // the distinct neighbors of the vertices but themselves, of which the
+  // outer ones are synced from their owners
+  typename FRAG_T::template vertex_array_t<size_t> degree;
+  // the sorted gids of the neighbors of the inner vertices, and the outer
+  // ones of the low degrees, and the Adamic-Adar weights of the neighbors
+  // of the inner vertices, i.e., 1 / log of their degrees
+  typename FRAG_T::template vertex_array_t<std::vector<vid_t>> nbrs;
+  typename FRAG_T::template vertex_array_t<std::vector<double>> nbr_weights;
+  // the sketches of the vertices of the high degrees
+  typename FRAG_T::template vertex_array_t<std::vector<uint64_t>> sketch;
+  typename FRAG_T::template vertex_array_t<std::vector<double>>
+      sketch_weights;
+
+  int stage = 0;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SIMILARITY_LINK_SIMILARITY_CONTEXT_H_
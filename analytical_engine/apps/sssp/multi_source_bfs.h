@@ -0,0 +1,177 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_APPS_SSSP_MULTI_SOURCE_BFS_H_
+#define ANALYTICAL_ENGINE_APPS_SSSP_MULTI_SOURCE_BFS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @brief The breadth first searches from up to 64 sources at once, along the
+ * outgoing edges, where the bit i of the lanes of a vertex stands for the
+ * i-th source. A level of all the searches takes a round: the lanes reached
+ * in the last round are pushed to the neighbors by Expand, and the lanes
+ * reaching a vertex for the first time are reported by Advance in the next
+ * round, including the ones from the other fragments.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class MultiSourceBFS {
+  using vertex_t = typename FRAG_T::vertex_t;
+
+ public:
+  using lanes_t = uint64_t;
+  static constexpr int kLaneNum = 64;
+
+  void Init(const FRAG_T& frag) {
+    seen_.Init(frag.InnerVertices(), 0);
+    frontier_.Init(frag.InnerVertices(), 0);
+    next_.Init(frag.Vertices(), 0);
+  }
+
+  // clears the searches of the last batch
+  void Reset() {
+    seen_.SetValue(0);
+    frontier_.SetValue(0);
+    next_.SetValue(0);
+  }
+
+  // starts the search of the lane from an inner vertex
+  void AddSource(const vertex_t& v, int lane) {
+    lanes_t bit = static_cast<lanes_t>(1) << lane;
+    seen_[v] |= bit;
+    frontier_[v] |= bit;
+  }
+
+  /**
+   * @brief Clears the last batch, and starts the searches of the batch-th
+   * kLaneNum sources, numbered from offset on the local ones, see
+   * SampleSources.
+   */
+  void StartBatch(const std::vector<vertex_t>& sources, size_t offset,
+                  size_t batch) {
+    size_t begin = batch * kLaneNum;
+    size_t local_begin = std::max(begin, offset);
+    size_t local_end = std::min(begin + kLaneNum, offset + sources.size());
+
+    Reset();
+    for (size_t i = local_begin; i < local_end; ++i) {
+      AddSource(sources[i - offset], static_cast<int>(i - begin));
+    }
+  }
+
+  /**
+   * @brief Pushes the lanes reached in the last level to the neighbors, and
+   * syncs the ones of the outer vertices to their owners.
+   */
+  template <typename MESSAGE_MANAGER_T>
+  void Expand(const FRAG_T& frag, MESSAGE_MANAGER_T& messages) {
+    for (auto v : frag.InnerVertices()) {
+      lanes_t lanes = frontier_[v];
+      if (lanes == 0) {
+        continue;
+      }
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        next_[e.get_neighbor()] |= lanes;
+      }
+    }
+    for (auto v : frag.OuterVertices()) {
+      if (next_[v] != 0) {
+        messages.template SyncStateOnOuterVertex<FRAG_T, lanes_t>(frag, v,
+                                                                  next_[v]);
+        next_[v] = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief Receives the lanes of the other fragments, and calls func(v, lanes)
+   * for each inner vertex with the lanes reaching it for the first time,
+   * which form the frontier of the next level. Returns the number of such
+   * vertices.
+   */
+  template <typename MESSAGE_MANAGER_T, typename FUNC_T>
+  size_t Advance(const FRAG_T& frag, MESSAGE_MANAGER_T& messages,
+                 const FUNC_T& func) {
+    vertex_t u;
+    lanes_t msg;
+    while (messages.template GetMessage<FRAG_T, lanes_t>(frag, u, msg)) {
+      next_[u] |= msg;
+    }
+    size_t active = 0;
+    for (auto v : frag.InnerVertices()) {
+      lanes_t lanes = next_[v] & ~seen_[v];
+      next_[v] = 0;
+      frontier_[v] = lanes;
+      if (lanes != 0) {
+        seen_[v] |= lanes;
+        func(v, lanes);
+        ++active;
+      }
+    }
+    return active;
+  }
+
+ private:
+  typename FRAG_T::template vertex_array_t<lanes_t> seen_;
+  typename FRAG_T::template vertex_array_t<lanes_t> frontier_;
+  typename FRAG_T::template vertex_array_t<lanes_t> next_;
+};
+
+/**
+ * @brief Picks the inner vertices as the sources of the searches, i.e., all
+ * of them if sample_num is 0 or no less than the vertices of the graph, or
+ * else a uniform sample of about sample_num vertices in total, of which each
+ * fragment takes its share by its inner vertices. The sources are numbered
+ * by the fragments, then by the order in sources, so the local ones are from
+ * offset, and total is the number of all the sources.
+ */
+template <typename COMM_T, typename FRAG_T>
+void SampleSources(COMM_T& comm, const FRAG_T& frag, size_t sample_num,
+                   std::vector<typename FRAG_T::vertex_t>& sources,
+                   size_t& offset, size_t& total) {
+  sources.clear();
+  for (auto v : frag.InnerVertices()) {
+    sources.push_back(v);
+  }
+  size_t vertex_num = frag.GetTotalVerticesNum();
+  if (sample_num != 0 && sample_num < vertex_num) {
+    std::mt19937_64 rng(frag.fid());
+    std::shuffle(sources.begin(), sources.end(), rng);
+    auto share = static_cast<size_t>(std::ceil(
+        static_cast<double>(sample_num) * sources.size() / vertex_num));
+    sources.resize(std::min(share, sources.size()));
+    std::sort(sources.begin(), sources.end());
+  }
+
+  std::vector<size_t> nums;
+  comm.AllGather(sources.size(), nums);
+  offset = std::accumulate(nums.begin(), nums.begin() + frag.fid(), 0UL);
+  total = std::accumulate(nums.begin(), nums.end(), 0UL);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SSSP_MULTI_SOURCE_BFS_H_
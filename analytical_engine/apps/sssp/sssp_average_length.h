@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_APPS_SSSP_SSSP_AVERAGE_LENGTH_H_
 #define ANALYTICAL_ENGINE_APPS_SSSP_SSSP_AVERAGE_LENGTH_H_
 
+#include <algorithm>
 #include <map>
 #include <queue>
 #include <tuple>
@@ -26,6 +27,7 @@ limitations under the License.
 
 #include "core/app/app_base.h"
 #include "core/worker/default_worker.h"
+#include "sssp/multi_source_bfs.h"
 #include "sssp/sssp_average_length_context.h"
 
 namespace gs {
@@ -34,7 +36,8 @@ namespace gs {
  * @brief Compute the average shortest path length in a *connected* graph.
  * Average shortest path length is average of all sssp length of (source = v,
  * target = u), where v, u is any vertex in graph. Note that this algorithm is
- * time consuming.
+ * time consuming. The unweighted lengths are computed by MultiSourceBFS, 64
+ * sources per batch.
  * */
 template <typename FRAG_T>
 class SSSPAverageLength
@@ -58,6 +61,10 @@ class SSSPAverageLength
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
+    if (!ctx.weight) {
+      unweightedPEval(frag, ctx, messages);
+      return;
+    }
     auto inner_vertices = frag.InnerVertices();
 #ifdef PROFILING
     ctx.exec_time -= GetCurrentTime();
@@ -98,6 +105,10 @@ class SSSPAverageLength
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
+    if (!ctx.weight) {
+      unweightedIncEval(frag, ctx, messages);
+      return;
+    }
 #ifdef PROFILING
     auto t1 = GetCurrentTime(), t2 = GetCurrentTime();
 #endif
@@ -174,6 +185,61 @@ class SSSPAverageLength
   }
 
  private:
+  using bfs_t = MultiSourceBFS<FRAG_T>;
+
+  void unweightedPEval(const fragment_t& frag, context_t& ctx,
+                       message_manager_t& messages) {
+    SampleSources(*this, frag, 0, ctx.sources, ctx.source_offset,
+                  ctx.total_source_num);
+
+    ctx.bfs.Init(frag);
+    ctx.batch = 0;
+    startBatch(frag, ctx, messages);
+    messages.ForceContinue();
+  }
+
+  void unweightedIncEval(const fragment_t& frag, context_t& ctx,
+                         message_manager_t& messages) {
+    double level = ctx.level;
+    size_t active = ctx.bfs.Advance(
+        frag, messages,
+        [&ctx, level](const vertex_t& v, typename bfs_t::lanes_t lanes) {
+          ctx.inner_sum += level * __builtin_popcountll(lanes);
+        });
+    size_t global_active = 0;
+    Sum(active, global_active);
+    if (global_active != 0) {
+      ctx.bfs.Expand(frag, messages);
+      ++ctx.level;
+      messages.ForceContinue();
+      return;
+    }
+
+    ++ctx.batch;
+    if (ctx.batch * bfs_t::kLaneNum < ctx.total_source_num) {
+      startBatch(frag, ctx, messages);
+      messages.ForceContinue();
+      return;
+    }
+
+    double sum = 0;
+    Sum(ctx.inner_sum, sum);
+    if (frag.fid() == 0) {
+      ctx.all_sums[0] = sum;
+      auto n = frag.GetTotalVerticesNum();
+      std::vector<size_t> shape{1};
+      ctx.set_shape(shape);
+      ctx.assign(sum / static_cast<double>(n * (n - 1)));
+    }
+  }
+
+  void startBatch(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages) {
+    ctx.bfs.StartBatch(ctx.sources, ctx.source_offset, ctx.batch);
+    ctx.bfs.Expand(frag, messages);
+    ctx.level = 1;
+  }
+
   inline void syncSum(const fragment_t& frag, context_t& ctx,
                       message_manager_t& messages) {
     int fid = frag.fid();
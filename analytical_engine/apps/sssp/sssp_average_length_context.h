@@ -20,10 +20,12 @@ limitations under the License.
 #include <map>
 #include <queue>
 #include <utility>
+#include <vector>
 
 #include "grape/grape.h"
 
 #include "core/context/tensor_context.h"
+#include "sssp/multi_source_bfs.h"
 
 namespace gs {
 
@@ -87,6 +89,14 @@ class SSSPAverageLengthContext : public TensorContext<FRAG_T, double> {
   std::priority_queue<std::pair<double, vertex_t>> next_queue;
   grape::DenseVertexSet<vid_t> updated;
 
+  // the searches of the unweighted lengths, by the batches of the sources
+  MultiSourceBFS<FRAG_T> bfs;
+  std::vector<vertex_t> sources;
+  size_t source_offset = 0;
+  size_t total_source_num = 0;
+  size_t batch = 0;
+  int level = 0;
+
 #ifdef PROFILING
   double preprocess_time = 0;
   double exec_time = 0;
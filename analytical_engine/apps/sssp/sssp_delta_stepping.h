@@ -0,0 +1,239 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
+#define ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "sssp/sssp_delta_stepping_context.h"
+
+namespace gs {
+
+/**
+ * @brief The delta-stepping single source shortest path. The vertices are
+ * relaxed by the buckets of the tentative distances of width delta, lower
+ * buckets first. In a bucket, the light edges, no heavier than delta, are
+ * relaxed until no distance in the bucket improves on all the fragments, and
+ * then the heavy edges of the vertices relaxed are relaxed once, as they only
+ * reach the later buckets. The empty buckets are skipped by the least
+ * distance of the vertices left.
+ *
+ * @tparam FRAG_T
+ * @tparam DIST_T The type of the distances, of which a path is summed up in
+ * double and rounded to DIST_T once per edge.
+ */
+template <typename FRAG_T, typename DIST_T = double>
+class SSSPDeltaStepping
+    : public grape::ParallelAppBase<FRAG_T,
+                                    SSSPDeltaSteppingContext<FRAG_T, DIST_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+  using app_t = SSSPDeltaStepping<FRAG_T, DIST_T>;
+  using ctx_t = SSSPDeltaSteppingContext<FRAG_T, DIST_T>;
+
+ public:
+  INSTALL_PARALLEL_WORKER(app_t, ctx_t, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kOnlyOut;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    messages.InitChannels(thread_num());
+
+    if (ctx.delta <= 0) {
+      ctx.delta = defaultDelta(frag);
+    }
+
+    vertex_t source;
+    bool native_source = frag.GetInnerVertex(ctx.source_id, source);
+    if (native_source) {
+      ctx.partial_result[source] = 0;
+      ctx.deferred.Insert(source);
+    }
+
+    step(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    messages.ParallelProcess<fragment_t, DIST_T>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, DIST_T msg) {
+          if (ctx.partial_result[u] > msg) {
+            grape::atomic_min(ctx.partial_result[u], msg);
+            if (msg < ctx.bound) {
+              ctx.curr_bucket.Insert(u);
+            } else {
+              ctx.deferred.Insert(u);
+            }
+          }
+        });
+
+    step(frag, ctx, messages);
+  }
+
+ private:
+  // the largest edge weight over the average degree
+  double defaultDelta(const fragment_t& frag) {
+    double max_weight = 0;
+    size_t edge_num = 0;
+    for (auto v : frag.InnerVertices()) {
+      auto es = frag.GetOutgoingAdjList(v);
+      for (auto& e : es) {
+        max_weight = std::max(max_weight, static_cast<double>(e.get_data()));
+        ++edge_num;
+      }
+    }
+    double global_max_weight = 0;
+    size_t global_edge_num = 0;
+    Max(max_weight, global_max_weight);
+    Sum(edge_num, global_edge_num);
+    if (global_edge_num == 0 || global_max_weight <= 0) {
+      return 1;
+    }
+    return global_max_weight * frag.GetTotalVerticesNum() / global_edge_num;
+  }
+
+  // runs the buckets until the outer vertices are to sync, or all the
+  // buckets are done
+  void step(const fragment_t& frag, context_t& ctx,
+            message_manager_t& messages) {
+    while (true) {
+      relaxBucket(frag, ctx);
+      if (syncOuterVertices(frag, ctx, messages)) {
+        messages.ForceContinue();
+        return;
+      }
+
+      // the bucket is settled
+      ForEach(ctx.settled, [&frag, &ctx](int tid, vertex_t v) {
+        relax(frag, ctx, v, false);
+      });
+      ctx.settled.ParallelClear(thread_num());
+      if (syncOuterVertices(frag, ctx, messages)) {
+        messages.ForceContinue();
+        return;
+      }
+
+      if (!nextBucket(frag, ctx)) {
+        return;
+      }
+    }
+  }
+
+  // relaxes the light or the heavy edges of the inner vertex
+  static void relax(const fragment_t& frag, context_t& ctx, const vertex_t& v,
+                    bool light) {
+    double distv = ctx.partial_result[v];
+    auto es = frag.GetOutgoingAdjList(v);
+    for (auto& e : es) {
+      double weight = static_cast<double>(e.get_data());
+      if ((weight <= ctx.delta) != light) {
+        continue;
+      }
+      vertex_t u = e.get_neighbor();
+      DIST_T ndistu = static_cast<DIST_T>(distv + weight);
+      if (ndistu < ctx.partial_result[u]) {
+        grape::atomic_min(ctx.partial_result[u], ndistu);
+        if (frag.IsOuterVertex(u)) {
+          ctx.outer_updated.Insert(u);
+        } else if (ndistu < ctx.bound) {
+          ctx.next_bucket.Insert(u);
+        } else {
+          ctx.deferred.Insert(u);
+        }
+      }
+    }
+  }
+
+  // relaxes the light edges in the bucket until it is empty locally
+  void relaxBucket(const fragment_t& frag, context_t& ctx) {
+    while (!ctx.curr_bucket.Empty()) {
+      ctx.next_bucket.ParallelClear(thread_num());
+      ForEach(ctx.curr_bucket, [&frag, &ctx](int tid, vertex_t v) {
+        ctx.deferred.Erase(v);
+        ctx.settled.Insert(v);
+        relax(frag, ctx, v, true);
+      });
+      ctx.curr_bucket.ParallelClear(thread_num());
+      ctx.curr_bucket.Swap(ctx.next_bucket);
+    }
+  }
+
+  // returns whether any fragment has synced the outer vertices
+  bool syncOuterVertices(const fragment_t& frag, context_t& ctx,
+                         message_manager_t& messages) {
+    auto& channels = messages.Channels();
+    std::vector<size_t> counts(thread_num(), 0);
+    ForEach(ctx.outer_updated,
+            [&frag, &ctx, &channels, &counts](int tid, vertex_t v) {
+              channels[tid].SyncStateOnOuterVertex<fragment_t, DIST_T>(
+                  frag, v, ctx.partial_result[v]);
+              ++counts[tid];
+            });
+    ctx.outer_updated.ParallelClear(thread_num());
+
+    size_t count = std::accumulate(counts.begin(), counts.end(),
+                                   static_cast<size_t>(0));
+    size_t global_count = 0;
+    Sum(count, global_count);
+    return global_count != 0;
+  }
+
+  // moves to the bucket of the least distance left, and returns false if
+  // there is none
+  bool nextBucket(const fragment_t& frag, context_t& ctx) {
+    std::vector<DIST_T> min_dists(thread_num(),
+                                  std::numeric_limits<DIST_T>::max());
+    ForEach(ctx.deferred, [&ctx, &min_dists](int tid, vertex_t v) {
+      min_dists[tid] = std::min(min_dists[tid], ctx.partial_result[v]);
+    });
+    DIST_T min_dist = *std::min_element(min_dists.begin(), min_dists.end());
+    DIST_T global_min_dist = 0;
+    Min(min_dist, global_min_dist);
+    if (global_min_dist == std::numeric_limits<DIST_T>::max()) {
+      return false;
+    }
+
+    ctx.bound = (std::floor(global_min_dist / ctx.delta) + 1) * ctx.delta;
+    ForEach(ctx.deferred, [&ctx](int tid, vertex_t v) {
+      if (ctx.partial_result[v] < ctx.bound) {
+        ctx.deferred.Erase(v);
+        ctx.curr_bucket.Insert(v);
+      }
+    });
+    return true;
+  }
+};
+
+/**
+ * @brief SSSPDeltaStepping of the distances in float.
+ */
+template <typename FRAG_T>
+using SSSPDeltaSteppingFloat = SSSPDeltaStepping<FRAG_T, float>;
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_H_
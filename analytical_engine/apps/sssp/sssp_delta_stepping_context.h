@@ -0,0 +1,91 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
+#define ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
+
+#include <iomanip>
+#include <limits>
+
+#include "grape/grape.h"
+
+namespace gs {
+
+/**
+ * @tparam FRAG_T
+ * @tparam DIST_T The type the distances are stored and sent in, double, or
+ * float to halve the memory of the distances and the messages, where the
+ * distances are rounded to float.
+ */
+template <typename FRAG_T, typename DIST_T = double>
+class SSSPDeltaSteppingContext
+    : public grape::VertexDataContext<FRAG_T, DIST_T> {
+ public:
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using dist_t = DIST_T;
+
+  explicit SSSPDeltaSteppingContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, DIST_T>(fragment, true),
+        partial_result(this->data()) {}
+
+  /**
+   * @param d The width of the buckets, or no more than 0 to take the largest
+   * edge weight over the average degree.
+   */
+  void Init(grape::ParallelMessageManager& messages, oid_t src_id, double d) {
+    auto& frag = this->fragment();
+
+    source_id = src_id;
+    delta = d;
+    partial_result.Init(frag.Vertices(), std::numeric_limits<DIST_T>::max());
+
+    curr_bucket.Init(frag.InnerVertices());
+    next_bucket.Init(frag.InnerVertices());
+    deferred.Init(frag.InnerVertices());
+    settled.Init(frag.InnerVertices());
+    outer_updated.Init(frag.OuterVertices());
+  }
+
+  void Output(std::ostream& os) override {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      DIST_T d = partial_result[v];
+      if (d == std::numeric_limits<DIST_T>::max()) {
+        os << frag.GetId(v) << " infinity" << std::endl;
+      } else {
+        os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+           << d << std::endl;
+      }
+    }
+  }
+
+  oid_t source_id;
+  double delta;
+  // the distances below the bound are in the current bucket
+  double bound = 0;
+
+  typename FRAG_T::template vertex_array_t<DIST_T>& partial_result;
+  // the inner vertices to relax in the current bucket, the ones improved to
+  // the later buckets, and the ones relaxed in the current bucket, of which
+  // the heavy edges are relaxed once the bucket is settled
+  grape::DenseVertexSet<vid_t> curr_bucket, next_bucket, deferred, settled;
+  grape::DenseVertexSet<vid_t> outer_updated;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_APPS_SSSP_SSSP_DELTA_STEPPING_CONTEXT_H_
@@ -36,6 +36,10 @@ namespace gs {
  * @param weight: whether weight is edge attribute in efile.
  *  If @param weight is false, every edge has 1 weight. Otherwise, take edge
  * attribute as weight.
+ * @param rebuild: whether to send the distances only. The distances are
+ * settled first, and published to the outer vertices once, then the
+ * predecessor of each vertex is rebuilt locally as an in-neighbor u with
+ * dist[u] + w == dist[v], which halves the messages of the relaxations.
  * */
 template <typename FRAG_T>
 class SSSPPath : public AppBase<FRAG_T, SSSPPathContext<FRAG_T>>,
@@ -43,7 +47,7 @@ class SSSPPath : public AppBase<FRAG_T, SSSPPathContext<FRAG_T>>,
  public:
   INSTALL_DEFAULT_WORKER(SSSPPath<FRAG_T>, SSSPPathContext<FRAG_T>, FRAG_T)
   static constexpr grape::MessageStrategy message_strategy =
-      grape::MessageStrategy::kSyncOnOuterVertex;
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
   static constexpr grape::LoadStrategy load_strategy =
       grape::LoadStrategy::kBothOutIn;
   using vertex_t = typename fragment_t::vertex_t;
@@ -62,7 +66,14 @@ class SSSPPath : public AppBase<FRAG_T, SSSPPathContext<FRAG_T>>,
     if (native_source) {
       ctx.path_distance[source] = 0.0;
       ctx.predecessor[source] = source;
-      vertexProcess(source, frag, ctx, messages);
+      if (ctx.rebuild) {
+        relaxDistance(source, frag, ctx);
+      } else {
+        vertexProcess(source, frag, ctx, messages);
+      }
+    }
+    if (ctx.rebuild) {
+      syncOuterVertices(frag, ctx, messages);
     }
 
 #ifdef PROFILING
@@ -82,6 +93,14 @@ class SSSPPath : public AppBase<FRAG_T, SSSPPathContext<FRAG_T>>,
 #ifdef PROFILING
     auto t1 = GetCurrentTime(), t2 = GetCurrentTime();
 #endif
+    if (ctx.rebuild) {
+      rebuildIncEval(frag, ctx, messages);
+#ifdef PROFILING
+      t2 = GetCurrentTime();
+      ctx.exec_time += t2 - t1;
+#endif
+      return;
+    }
     auto inner_vertices = frag.InnerVertices();
 
     vertex_t v, u;
@@ -109,39 +128,152 @@ class SSSPPath : public AppBase<FRAG_T, SSSPPathContext<FRAG_T>>,
       messages.ForceContinue();
     }
 
-    {
-      vertex_t source;
-      bool native_source = frag.GetInnerVertex(ctx.source_id, source);
-      size_t row_num = 0;
+    writeToCtx(frag, ctx);
+#ifdef PROFILING
+    t2 = GetCurrentTime();
+    ctx.exec_time += t2 - t1;
+#endif
+  }
 
+ private:
+  void writeToCtx(const fragment_t& frag, context_t& ctx) {
+    auto inner_vertices = frag.InnerVertices();
+    vertex_t source;
+    bool native_source = frag.GetInnerVertex(ctx.source_id, source);
+    size_t row_num = 0;
+
+    for (auto v : inner_vertices) {
+      if (!(native_source && v == source) &&
+          ctx.path_distance[v] != std::numeric_limits<double>::max()) {
+        row_num++;
+      }
+    }
+    std::vector<size_t> shape{row_num, 2};
+
+    ctx.set_shape(shape);
+    size_t idx = 0;
+
+    auto* data = ctx.tensor().data();
+
+    for (auto v : inner_vertices) {
+      if (!(native_source && v == source) &&
+          ctx.path_distance[v] != std::numeric_limits<double>::max()) {
+        data[idx++] = frag.GetId(ctx.predecessor[v]);
+        data[idx++] = frag.GetId(v);
+      }
+    }
+  }
+
+  void rebuildIncEval(const fragment_t& frag, context_t& ctx,
+                      message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+
+    vertex_t u;
+    double distu;
+    if (ctx.settled) {
+      // the distances of the outer vertices
+      while (messages.GetMessage<fragment_t, double>(frag, u, distu)) {
+        ctx.path_distance[u] = distu;
+      }
+      rebuildPredecessors(frag, ctx);
+      writeToCtx(frag, ctx);
+      return;
+    }
+
+    while (messages.GetMessage<fragment_t, double>(frag, u, distu)) {
+      if (ctx.path_distance[u] > distu) {
+        ctx.path_distance[u] = distu;
+        ctx.curr_updated.Insert(u);
+      }
+    }
+
+    ctx.prev_updated.Swap(ctx.curr_updated);
+    ctx.curr_updated.Clear();
+
+    for (auto v : inner_vertices) {
+      if (ctx.prev_updated.Exist(v)) {
+        relaxDistance(v, frag, ctx);
+      }
+    }
+
+    size_t active = syncOuterVertices(frag, ctx, messages);
+    if (!ctx.curr_updated.Empty()) {
+      ++active;
+    }
+    size_t global_active = 0;
+    Sum(active, global_active);
+    if (global_active == 0) {
+      // publishes the settled distances to the outer vertices
+      ctx.settled = true;
       for (auto v : inner_vertices) {
-        if (!(native_source && v == source) &&
-            ctx.path_distance[v] != std::numeric_limits<double>::max()) {
-          row_num++;
+        if (ctx.path_distance[v] != std::numeric_limits<double>::max()) {
+          messages.SendMsgThroughOEdges<fragment_t, double>(
+              frag, v, ctx.path_distance[v]);
         }
       }
-      std::vector<size_t> shape{row_num, 2};
+    }
+    messages.ForceContinue();
+  }
+
+  template <typename EDGE_T>
+  static double edgeWeight(const context_t& ctx, const EDGE_T& e) {
+    return ctx.weight ? static_cast<double>(e.get_data()) : 1;
+  }
 
-      ctx.set_shape(shape);
-      size_t idx = 0;
+  void relaxDistance(vertex_t v, const fragment_t& frag, context_t& ctx) {
+    auto oes = frag.GetOutgoingAdjList(v);
+    for (auto& e : oes) {
+      auto u = e.get_neighbor();
+      double new_distu = ctx.path_distance[v] + edgeWeight(ctx, e);
+      if (ctx.path_distance[u] > new_distu) {
+        ctx.path_distance[u] = new_distu;
+        if (frag.IsOuterVertex(u)) {
+          ctx.outer_updated.Insert(u);
+        } else {
+          ctx.curr_updated.Insert(u);
+        }
+      }
+    }
+  }
 
-      auto* data = ctx.tensor().data();
+  size_t syncOuterVertices(const fragment_t& frag, context_t& ctx,
+                           message_manager_t& messages) {
+    size_t count = 0;
+    for (auto v : frag.OuterVertices()) {
+      if (ctx.outer_updated.Exist(v)) {
+        messages.SyncStateOnOuterVertex<fragment_t, double>(
+            frag, v, ctx.path_distance[v]);
+        ++count;
+      }
+    }
+    ctx.outer_updated.Clear();
+    return count;
+  }
 
-      for (auto v : inner_vertices) {
-        if (!(native_source && v == source) &&
-            ctx.path_distance[v] != std::numeric_limits<double>::max()) {
-          data[idx++] = frag.GetId(ctx.predecessor[v]);
-          data[idx++] = frag.GetId(v);
+  // the predecessor is an in-neighbor on a shortest path, which exists as
+  // the settled distance of v is the one relaxed from it
+  void rebuildPredecessors(const fragment_t& frag, context_t& ctx) {
+    vertex_t source;
+    bool native_source = frag.GetInnerVertex(ctx.source_id, source);
+    for (auto v : frag.InnerVertices()) {
+      double distv = ctx.path_distance[v];
+      if ((native_source && v == source) ||
+          distv == std::numeric_limits<double>::max()) {
+        continue;
+      }
+      auto es = frag.directed() ? frag.GetIncomingAdjList(v)
+                                : frag.GetOutgoingAdjList(v);
+      for (auto& e : es) {
+        auto u = e.get_neighbor();
+        if (ctx.path_distance[u] != std::numeric_limits<double>::max() &&
+            ctx.path_distance[u] + edgeWeight(ctx, e) == distv) {
+          ctx.predecessor[v] = u;
+          break;
         }
       }
     }
-#ifdef PROFILING
-    t2 = GetCurrentTime();
-    ctx.exec_time += t2 - t1;
-#endif
   }
 
- private:
   void vertexProcess(vertex_t v, const fragment_t& frag, context_t& ctx,
                      message_manager_t& messages) {
     auto oes = frag.GetOutgoingAdjList(v);
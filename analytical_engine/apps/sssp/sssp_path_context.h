@@ -34,17 +34,23 @@ class SSSPPathContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
   explicit SSSPPathContext(const FRAG_T& fragment)
       : TensorContext<FRAG_T, typename FRAG_T::oid_t>(fragment) {}
 
-  void Init(grape::DefaultMessageManager& messages, oid_t source, bool w) {
+  /**
+   * @param r Whether to send the distances only, and rebuild the
+   * predecessors from the distances once they are settled.
+   */
+  void Init(grape::DefaultMessageManager& messages, oid_t source, bool w,
+            bool r = false) {
     auto& frag = this->fragment();
 
     source_id = source;
     weight = w;
+    rebuild = r;
     predecessor.Init(frag.InnerVertices());
-    path_distance.Init(frag.InnerVertices(),
-                       std::numeric_limits<double>::max());
+    path_distance.Init(frag.Vertices(), std::numeric_limits<double>::max());
 
     curr_updated.Init(frag.InnerVertices());
     prev_updated.Init(frag.InnerVertices());
+    outer_updated.Init(frag.OuterVertices());
 
 #ifdef PROFILING
     preprocess_time = 0;
@@ -69,10 +75,14 @@ class SSSPPathContext : public TensorContext<FRAG_T, typename FRAG_T::oid_t> {
 
   oid_t source_id;
   bool weight;
+  bool rebuild;
+  // the distances are settled, and published to the outer vertices
+  bool settled = false;
 
   typename FRAG_T::template vertex_array_t<vertex_t> predecessor;
   typename FRAG_T::template vertex_array_t<double> path_distance;
   grape::DenseVertexSet<vid_t> curr_updated, prev_updated;
+  grape::DenseVertexSet<vid_t> outer_updated;
 
 #ifdef PROFILING
   double preprocess_time = 0;
@@ -17,9 +17,13 @@ limitations under the License.
 #define ANALYTICAL_ENGINE_BENCHMARKS_APPS_BFS_BFS_H_
 
 #include <limits>
+#include <numeric>
+#include <vector>
 
 #include "grape/grape.h"
 
+#include "core/worker/push_pull_switcher.h"
+
 namespace gs {
 
 namespace benchmarks {
@@ -54,24 +58,48 @@ class BFSContext : public grape::VertexDataContext<FRAG_T, int64_t> {
   oid_t source_id;
   typename FRAG_T::template vertex_array_t<depth_type>& partial_result;
   grape::DenseVertexSet<vid_t> curr_inner_updated, next_inner_updated;
+  // the outer vertices in the frontier, published by their owners
+  grape::DenseVertexSet<vid_t> outer_updated;
 
   depth_type current_depth = 0;
+  // expands the frontier bottom-up in kPull, and whether the outer vertices
+  // in the current frontier have been published
+  PushPullSwitcher switcher;
+  bool published = false;
+  // the incoming edges of the unvisited inner vertices to check in a pull
+  size_t unvisited_edges = 0;
 };
 
+/**
+ * @brief The direction optimizing breadth first search. A level is expanded
+ * top-down, pushing from the frontier along the outgoing edges, or bottom-up,
+ * where each unvisited vertex pulls along its incoming edges until a parent in
+ * the frontier is found. The direction is decided by a PushPullSwitcher on
+ * the frontier, the edges out of it, and the edges left to check. A pull needs
+ * the outer vertices in the frontier, which the owners publish along the
+ * outgoing edges, so the first pull after a push takes an extra round.
+ *
+ * @tparam FRAG_T
+ */
 template <typename FRAG_T>
 class BFS : public grape::ParallelAppBase<FRAG_T, BFSContext<FRAG_T>>,
-            public grape::ParallelEngine {
+            public grape::ParallelEngine,
+            public grape::Communicator {
  public:
   INSTALL_PARALLEL_WORKER(BFS<FRAG_T>, BFSContext<FRAG_T>, FRAG_T)
   using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
 
   void PEval(const fragment_t& frag, context_t& ctx,
              message_manager_t& messages) {
-    using depth_type = typename context_t::depth_type;
-
     messages.InitChannels(thread_num(), 2 * 1023 * 64, 2 * 1024 * 64);
 
-    ctx.current_depth = 1;
+    ctx.current_depth = 0;
 
     vertex_t source;
     bool native_source = frag.GetInnerVertex(ctx.source_id, source);
@@ -82,47 +110,134 @@ class BFS : public grape::ParallelAppBase<FRAG_T, BFSContext<FRAG_T>>,
     // init double buffer which contains updated vertices using bitmap
     ctx.curr_inner_updated.Init(inner_vertices, thread_num());
     ctx.next_inner_updated.Init(inner_vertices, thread_num());
+    ctx.outer_updated.Init(outer_vertices, thread_num());
 
-    auto& channel_0 = messages.Channels()[0];
+    std::vector<size_t> edges(thread_num(), 0);
+    ForEach(inner_vertices, [&frag, &edges](int tid, vertex_t v) {
+      edges[tid] += pullDegree(frag, v);
+    });
+    ctx.unvisited_edges = std::accumulate(edges.begin(), edges.end(),
+                                          static_cast<size_t>(0));
 
     if (native_source) {
       ctx.partial_result[source] = 0;
-      auto oes = frag.GetOutgoingAdjList(source);
-      for (auto& e : oes) {
-        auto u = e.get_neighbor();
-        if (ctx.partial_result[u] == std::numeric_limits<depth_type>::max()) {
-          ctx.partial_result[u] = 1;
-          if (frag.IsOuterVertex(u)) {
-            channel_0.SyncStateOnOuterVertex<fragment_t>(frag, u);
-          } else {
-            ctx.curr_inner_updated.Insert(u);
-          }
-        }
-      }
+      ctx.curr_inner_updated.Insert(source);
     }
 
-    messages.ForceContinue();
+    expand(frag, ctx, messages);
   }
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
     using depth_type = typename context_t::depth_type;
 
-    auto& channels = messages.Channels();
-
-    depth_type next_depth = ctx.current_depth + 1;
     int thrd_num = thread_num();
-    ctx.next_inner_updated.ParallelClear(thrd_num);
+    ctx.outer_updated.ParallelClear(thrd_num);
 
-    // process received messages and update depth
+    // process received messages: the inner vertices pushed to, and the outer
+    // vertices published in the frontier
     messages.ParallelProcess<fragment_t, grape::EmptyType>(
-        thrd_num, frag, [&ctx](int tid, vertex_t v, grape::EmptyType) {
-          if (ctx.partial_result[v] == std::numeric_limits<depth_type>::max()) {
+        thrd_num, frag, [&frag, &ctx](int tid, vertex_t v, grape::EmptyType) {
+          if (frag.IsOuterVertex(v)) {
+            ctx.outer_updated.Insert(v);
+          } else if (ctx.partial_result[v] ==
+                     std::numeric_limits<depth_type>::max()) {
             ctx.partial_result[v] = ctx.current_depth;
             ctx.curr_inner_updated.Insert(v);
           }
         });
 
+    expand(frag, ctx, messages);
+  }
+
+ private:
+  static size_t pullDegree(const fragment_t& frag, const vertex_t& v) {
+    return frag.directed() ? frag.GetLocalInDegree(v)
+                           : frag.GetLocalOutDegree(v);
+  }
+
+  // sends the inner vertex to the fragments holding it as an outer vertex,
+  // in the format of the states synced without data
+  template <typename CHANNEL_T>
+  static void publish(const fragment_t& frag, CHANNEL_T& channel,
+                      const vertex_t& v) {
+    vid_t gid = frag.GetInnerVertexGid(v);
+    auto dsts = frag.OEDests(v);
+    for (const grape::fid_t* ptr = dsts.begin; ptr != dsts.end; ++ptr) {
+      channel.template SendToFragment<vid_t>(*ptr, gid);
+    }
+  }
+
+  // expands the frontier of the current depth, which is complete on the
+  // inner vertices
+  void expand(const fragment_t& frag, context_t& ctx,
+              message_manager_t& messages) {
+    int thrd_num = thread_num();
+    std::vector<size_t> frontier(thrd_num, 0), scouts(thrd_num, 0),
+        awakes(thrd_num, 0);
+    ForEach(ctx.curr_inner_updated,
+            [&frag, &frontier, &scouts, &awakes](int tid, vertex_t v) {
+              ++frontier[tid];
+              scouts[tid] += frag.GetLocalOutDegree(v);
+              awakes[tid] += pullDegree(frag, v);
+            });
+    size_t frontier_size = std::accumulate(frontier.begin(), frontier.end(),
+                                           static_cast<size_t>(0));
+    size_t global_frontier_size = 0;
+    Sum(frontier_size, global_frontier_size);
+    if (global_frontier_size == 0) {
+      return;
+    }
+
+    // the frontier is visited, and left out of the edges to check
+    size_t unvisited_edges =
+        ctx.unvisited_edges -
+        std::accumulate(awakes.begin(), awakes.end(), static_cast<size_t>(0));
+    size_t scout_count = std::accumulate(scouts.begin(), scouts.end(),
+                                         static_cast<size_t>(0));
+    size_t global_scout_count = 0, global_unvisited_edges = 0;
+    Sum(scout_count, global_scout_count);
+    Sum(unvisited_edges, global_unvisited_edges);
+
+    ActiveStats stats;
+    stats.active_vertex_num = global_frontier_size;
+    stats.active_edge_num = global_scout_count;
+    stats.total_vertex_num = frag.GetTotalVerticesNum();
+    stats.total_edge_num = global_unvisited_edges;
+    bool pull = ctx.switcher.Next(stats) == EvalDirection::kPull;
+
+    auto& channels = messages.Channels();
+    if (pull && !ctx.published) {
+      // publishes the frontier, and pulls in the next round
+      ForEach(ctx.curr_inner_updated, [&frag, &channels](int tid, vertex_t v) {
+        publish(frag, channels[tid], v);
+      });
+      ctx.published = true;
+      messages.ForceContinue();
+      return;
+    }
+
+    if (pull) {
+      pullLevel(frag, ctx, messages);
+    } else {
+      pushLevel(frag, ctx, messages);
+    }
+    ctx.published = pull;
+    ctx.unvisited_edges = unvisited_edges;
+
+    ctx.current_depth += 1;
+    messages.ForceContinue();
+    ctx.next_inner_updated.Swap(ctx.curr_inner_updated);
+  }
+
+  void pushLevel(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    using depth_type = typename context_t::depth_type;
+
+    auto& channels = messages.Channels();
+    depth_type next_depth = ctx.current_depth + 1;
+    ctx.next_inner_updated.ParallelClear(thread_num());
+
     // sync messages to other workers
     ForEach(ctx.curr_inner_updated, [next_depth, &frag, &ctx, &channels](
                                         int tid, vertex_t v) {
@@ -139,13 +254,38 @@ class BFS : public grape::ParallelAppBase<FRAG_T, BFSContext<FRAG_T>>,
         }
       }
     });
+  }
 
-    ctx.current_depth = next_depth;
-    if (!ctx.next_inner_updated.Empty()) {
-      messages.ForceContinue();
-    }
+  void pullLevel(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    using depth_type = typename context_t::depth_type;
 
-    ctx.next_inner_updated.Swap(ctx.curr_inner_updated);
+    auto& channels = messages.Channels();
+    depth_type next_depth = ctx.current_depth + 1;
+    ctx.next_inner_updated.ParallelClear(thread_num());
+
+    ForEach(frag.InnerVertices(), [next_depth, &frag, &ctx](int tid,
+                                                           vertex_t v) {
+      if (ctx.partial_result[v] != std::numeric_limits<depth_type>::max()) {
+        return;
+      }
+      auto es = frag.directed() ? frag.GetIncomingAdjList(v)
+                                : frag.GetOutgoingAdjList(v);
+      for (auto& e : es) {
+        auto u = e.get_neighbor();
+        if (frag.IsOuterVertex(u) ? ctx.outer_updated.Exist(u)
+                                  : ctx.curr_inner_updated.Exist(u)) {
+          ctx.partial_result[v] = next_depth;
+          ctx.next_inner_updated.Insert(v);
+          break;
+        }
+      }
+    });
+
+    // the next frontier is complete, and published for the next pull
+    ForEach(ctx.next_inner_updated, [&frag, &channels](int tid, vertex_t v) {
+      publish(frag, channels[tid], v);
+    });
   }
 };
 
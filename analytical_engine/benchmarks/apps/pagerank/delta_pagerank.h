@@ -0,0 +1,214 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_BENCHMARKS_APPS_PAGERANK_DELTA_PAGERANK_H_
+#define ANALYTICAL_ENGINE_BENCHMARKS_APPS_PAGERANK_DELTA_PAGERANK_H_
+
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <vector>
+
+#include "grape/grape.h"
+
+#include "core/fragment/vertex_order.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+template <typename FRAG_T>
+class DeltaPageRankContext : public grape::VertexDataContext<FRAG_T, double> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+
+  explicit DeltaPageRankContext(const FRAG_T& fragment)
+      : grape::VertexDataContext<FRAG_T, double>(fragment, true),
+        result(this->data()) {}
+
+  /**
+   * @param delta The damping factor.
+   * @param max_round The maximum number of rounds.
+   * @param epsilon The least change of a rank to propagate.
+   */
+  void Init(grape::ParallelMessageManager& messages, double delta,
+            int max_round, double epsilon) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices();
+    auto inner_vertices = frag.InnerVertices();
+    this->delta = delta;
+    this->max_round = max_round;
+    this->epsilon = epsilon;
+    degree.Init(inner_vertices, 0);
+    result.Init(vertices, 0.0);
+    residual.Init(inner_vertices, 0.0);
+    next_residual.Init(vertices, 0.0);
+    step = 0;
+  }
+
+  void Output(std::ostream& os) {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices();
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << std::scientific << std::setprecision(15)
+         << result[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<int> degree;
+  typename FRAG_T::template vertex_array_t<double>& result;
+  // the changes of the ranks not propagated yet, and the ones received in
+  // the round, of the outer vertices to send as well
+  typename FRAG_T::template vertex_array_t<double> residual;
+  typename FRAG_T::template vertex_array_t<double> next_residual;
+
+  int step = 0;
+  int max_round = 0;
+  double delta = 0;
+  double epsilon = 0;
+
+  // the changes propagated by the dangling vertices in the last round
+  double dangling_sum = 0.0;
+};
+
+/**
+ * @brief The delta PageRank, where a vertex only propagates the change of
+ * its rank, and only when the change exceeds epsilon. The changes below
+ * epsilon are accumulated until they exceed it, so the vertices converged
+ * cost nothing, and the query stops once no vertex changes by more than
+ * epsilon, or after max_round rounds. The changes of the dangling vertices
+ * are shared by all the vertices. The ranks are the same as the ones of
+ * PageRank, up to the changes held back.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class DeltaPageRank
+    : public grape::ParallelAppBase<FRAG_T, DeltaPageRankContext<FRAG_T>>,
+      public grape::ParallelEngine,
+      public grape::Communicator {
+ public:
+  static constexpr grape::MessageStrategy message_strategy =
+      grape::MessageStrategy::kSyncOnOuterVertex;
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kOnlyOut;
+
+  INSTALL_PARALLEL_WORKER(DeltaPageRank<FRAG_T>, DeltaPageRankContext<FRAG_T>,
+                          FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+    messages.InitChannels(thread_num());
+
+    ctx.step = 0;
+    ctx.dangling_sum = 0;
+    double p = (1.0 - ctx.delta) / graph_vnum;
+
+    ForEach(inner_vertices, [&ctx, &frag, p](int tid, vertex_t u) {
+      ctx.degree[u] = frag.GetOutgoingAdjList(u).Size();
+      ctx.residual[u] = p;
+    });
+
+    propagate(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices();
+    size_t graph_vnum = frag.GetTotalVerticesNum();
+
+    messages.ParallelProcess<fragment_t, double>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, const double& msg) {
+          grape::atomic_add(ctx.residual[u], msg);
+        });
+
+    double dangling_share = ctx.delta * ctx.dangling_sum / graph_vnum;
+    if (dangling_share != 0) {
+      ForEach(inner_vertices, [&ctx, dangling_share](int tid, vertex_t u) {
+        ctx.residual[u] += dangling_share;
+      });
+    }
+
+    propagate(frag, ctx, messages);
+  }
+
+ private:
+  // propagates the changes exceeding epsilon
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages) {
+    if (ctx.step >= ctx.max_round) {
+      return;
+    }
+    ++ctx.step;
+
+    std::vector<size_t> actives(thread_num(), 0);
+    std::vector<double> danglings(thread_num(), 0);
+    ForEachInnerVertex(
+        *this, frag, [&ctx, &frag, &actives, &danglings](int tid, vertex_t u) {
+          double change = ctx.residual[u];
+          if (std::fabs(change) <= ctx.epsilon) {
+            return;
+          }
+          ++actives[tid];
+          ctx.residual[u] = 0;
+          ctx.result[u] += change;
+          if (ctx.degree[u] == 0) {
+            danglings[tid] += change;
+            return;
+          }
+          double share = ctx.delta * change / ctx.degree[u];
+          auto es = frag.GetOutgoingAdjList(u);
+          for (auto& e : es) {
+            grape::atomic_add(ctx.next_residual[e.get_neighbor()], share);
+          }
+        });
+
+    auto& channels = messages.Channels();
+    ForEach(frag.InnerVertices(), [&ctx](int tid, vertex_t u) {
+      ctx.residual[u] += ctx.next_residual[u];
+      ctx.next_residual[u] = 0;
+    });
+    ForEach(frag.OuterVertices(), [&ctx, &frag, &channels](int tid,
+                                                          vertex_t u) {
+      if (ctx.next_residual[u] != 0) {
+        channels[tid].SyncStateOnOuterVertex<fragment_t, double>(
+            frag, u, ctx.next_residual[u]);
+        ctx.next_residual[u] = 0;
+      }
+    });
+
+    size_t active = std::accumulate(actives.begin(), actives.end(),
+                                    static_cast<size_t>(0));
+    size_t global_active = 0;
+    Sum(active, global_active);
+    double dangling_sum =
+        std::accumulate(danglings.begin(), danglings.end(), 0.0);
+    Sum(dangling_sum, ctx.dangling_sum);
+
+    if (global_active != 0 && ctx.step < ctx.max_round) {
+      messages.ForceContinue();
+    }
+  }
+};
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_BENCHMARKS_APPS_PAGERANK_DELTA_PAGERANK_H_
@@ -21,6 +21,8 @@ limitations under the License.
 
 #include "grape/grape.h"
 
+#include "core/fragment/vertex_order.h"
+
 namespace gs {
 
 namespace benchmarks {
@@ -129,8 +131,6 @@ class PageRank : public grape::ParallelAppBase<FRAG_T, PageRankContext<FRAG_T>>,
 
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices();
-
     double dangling_sum = ctx.dangling_sum;
 
     size_t graph_vnum = frag.GetTotalVerticesNum();
@@ -151,26 +151,28 @@ class PageRank : public grape::ParallelAppBase<FRAG_T, PageRankContext<FRAG_T>>,
           });
     }
 
-    // compute new ranks and send messages
+    // compute new ranks and send messages, in the order of the inner
+    // vertices of the fragment if any, so the ranks of the neighbors of the
+    // vertices in a row are likely to be in the cache
     if (ctx.step != ctx.max_round) {
-      ForEach(inner_vertices,
-              [&ctx, base, &frag, &messages](int tid, vertex_t u) {
-                if (ctx.degree[u] == 0) {
-                  ctx.next_result[u] = base;
-                } else {
-                  double cur = 0;
-                  auto es = frag.GetIncomingAdjList(u);
-                  for (auto& e : es) {
-                    cur += ctx.result[e.get_neighbor()];
-                  }
-                  cur = (ctx.delta * cur + base) / ctx.degree[u];
-                  ctx.next_result[u] = cur;
-                  messages.SendMsgThroughOEdges<fragment_t, double>(
-                      frag, u, ctx.next_result[u], tid);
-                }
-              });
+      ForEachInnerVertex(
+          *this, frag, [&ctx, base, &frag, &messages](int tid, vertex_t u) {
+            if (ctx.degree[u] == 0) {
+              ctx.next_result[u] = base;
+            } else {
+              double cur = 0;
+              auto es = frag.GetIncomingAdjList(u);
+              for (auto& e : es) {
+                cur += ctx.result[e.get_neighbor()];
+              }
+              cur = (ctx.delta * cur + base) / ctx.degree[u];
+              ctx.next_result[u] = cur;
+              messages.SendMsgThroughOEdges<fragment_t, double>(
+                  frag, u, ctx.next_result[u], tid);
+            }
+          });
     } else {
-      ForEach(inner_vertices, [&ctx, base, &frag](int tid, vertex_t u) {
+      ForEachInnerVertex(*this, frag, [&ctx, base, &frag](int tid, vertex_t u) {
         if (ctx.degree[u] == 0) {
           ctx.next_result[u] = base;
         } else {
@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_BENCHMARKS_APPS_PAGERANK_PROPERTY_PAGERANK_H_
 #define ANALYTICAL_ENGINE_BENCHMARKS_APPS_PAGERANK_PROPERTY_PAGERANK_H_
 
+#include <cmath>
 #include <iomanip>
 #include <limits>
 
@@ -24,6 +25,7 @@
 #include "core/app/parallel_property_app_base.h"
 #include "core/context/vertex_data_context.h"
 #include "core/worker/parallel_property_worker.h"
+#include "core/worker/push_pull_switcher.h"
 
 namespace gs {
 
@@ -41,15 +43,17 @@ class PropertyPageRankContext
         result(this->data()[0]) {}
 
   void Init(ParallelPropertyMessageManager& messages, double delta,
-            int max_round) {
+            int max_round, double tolerance = 0) {
     auto& frag = this->fragment();
     auto vertices = frag.Vertices(0);
     auto inner_vertices = frag.InnerVertices(0);
     this->delta = delta;
     this->max_round = max_round;
+    this->tolerance = tolerance;
     degree.Init(inner_vertices, 0);
     result.Init(vertices, 0.0);
-    next_result.Init(vertices);
+    sum.Init(inner_vertices, 0.0);
+    summed.Init(vertices, 0.0);
     step = 0;
   }
 
@@ -65,25 +69,41 @@ class PropertyPageRankContext
            << result[v] * degree[v] << std::endl;
       }
     }
-    /*
-        for (auto v : inner_vertices) {
-          os << frag.GetId(v) << " " << result[v] << std::endl;
-        }
-    */
   }
 
   typename FRAG_T::template vertex_array_t<int> degree;
   typename FRAG_T::template vertex_array_t<double>& result;
-  typename FRAG_T::template vertex_array_t<double> next_result;
+  // the sum of the results of the in-neighbors of each inner vertex, as of
+  // summed
+  typename FRAG_T::template vertex_array_t<double> sum;
+  // the result of each vertex added to the sums of its out-neighbors
+  typename FRAG_T::template vertex_array_t<double> summed;
+  // the vertices of which the result is updated since it was summed, i.e.,
+  // the inner vertices changed by more than the tolerance in the last round,
+  // and the outer vertices synced by their owners
+  grape::DenseVertexSet<vid_t> changed;
 
   vid_t dangling_vnum = 0;
   int step = 0;
   int max_round = 0;
   double delta = 0;
+  double tolerance = 0;
+  // the out edges of the inner vertices of the fragment
+  size_t edge_num = 0;
 
   double dangling_sum = 0.0;
 };
 
+/**
+ * @brief PageRank on the vertices of label 0 along the edges of label 0. Each
+ * round sums the results of the in-neighbors of the inner vertices, either by
+ * IncEvalPull, gathering along the incoming edges of all the inner vertices,
+ * or by IncEval, where the vertices changed since the last round push the
+ * differences along their outgoing edges, which is cheaper once few of them
+ * change, i.e., with a tolerance to skip the changes below, see
+ * PushPullSwitcher. The changed inner vertices are synced to the fragments
+ * holding them as outer vertices in both.
+ */
 template <typename FRAG_T>
 class PropertyPageRank
     : public ParallelPropertyAppBase<FRAG_T, PropertyPageRankContext<FRAG_T>>,
@@ -105,6 +125,7 @@ class PropertyPageRank
 
     size_t graph_vnum = frag.GetTotalVerticesNum(0);
     messages.InitChannels(thread_num());
+    ctx.changed.Init(frag.Vertices(0), thread_num());
 
     ctx.step = 0;
     double p = 1.0 / graph_vnum;
@@ -113,6 +134,7 @@ class PropertyPageRank
     ForEach(inner_vertices, [&ctx, &frag, p, &messages](int tid, vertex_t u) {
       int EdgeNum = frag.GetOutgoingAdjList(u, 0).Size();
       ctx.degree[u] = EdgeNum;
+      ctx.changed.Insert(u);
       if (EdgeNum > 0) {
         ctx.result[u] = p / EdgeNum;
         messages.SendMsgThroughOEdges<fragment_t, double>(frag, u, 0,
@@ -122,10 +144,12 @@ class PropertyPageRank
       }
     });
 
+    ctx.edge_num = 0;
     for (auto u : inner_vertices) {
       if (ctx.degree[u] == 0) {
         ++ctx.dangling_vnum;
       }
+      ctx.edge_num += ctx.degree[u];
     }
 
     double dangling_sum = p * static_cast<double>(ctx.dangling_vnum);
@@ -135,71 +159,121 @@ class PropertyPageRank
     messages.ForceContinue();
   }
 
+  /**
+   * @brief The inner vertices changed in the last round, which push in the
+   * next one, and their out edges.
+   */
+  ActiveStats CountActive(const fragment_t& frag, const context_t& ctx) const {
+    ActiveStats stats;
+    for (auto u : frag.InnerVertices(0)) {
+      if (ctx.changed.Exist(u)) {
+        ++stats.active_vertex_num;
+        stats.active_edge_num += ctx.degree[u];
+      }
+    }
+    stats.total_vertex_num = frag.InnerVertices(0).size();
+    stats.total_edge_num = ctx.edge_num;
+    return stats;
+  }
+
   void IncEval(const fragment_t& frag, context_t& ctx,
                message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices(0);
+    double base;
+    if (!startRound(frag, ctx, messages, base)) {
+      return;
+    }
+
+    // the changed vertices push the differences to the sums of the inner
+    // vertices, of which the outer ones have the edges to the inner vertices
+    ForEach(ctx.changed, [&ctx, &frag](int tid, vertex_t v) {
+      double diff = ctx.result[v] - ctx.summed[v];
+      ctx.summed[v] = ctx.result[v];
+      auto es = frag.GetOutgoingAdjList(v, 0);
+      for (auto& e : es) {
+        auto u = e.get_neighbor();
+        if (frag.IsInnerVertex(u)) {
+          grape::atomic_add(ctx.sum[u], diff);
+        }
+      }
+    });
+
+    finishRound(frag, ctx, messages, base);
+  }
 
-    double dangling_sum = ctx.dangling_sum;
+  void IncEvalPull(const fragment_t& frag, context_t& ctx,
+                   message_manager_t& messages) {
+    double base;
+    if (!startRound(frag, ctx, messages, base)) {
+      return;
+    }
+
+    ForEach(frag.InnerVertices(0), [&ctx, &frag](int tid, vertex_t u) {
+      double cur = 0;
+      auto es = frag.GetIncomingAdjList(u, 0);
+      for (auto& e : es) {
+        cur += ctx.result[e.get_neighbor()];
+      }
+      ctx.sum[u] = cur;
+    });
+    ForEach(frag.Vertices(0),
+            [&ctx](int tid, vertex_t v) { ctx.summed[v] = ctx.result[v]; });
+
+    finishRound(frag, ctx, messages, base);
+  }
 
+ private:
+  // processes the results synced by the other workers, and returns false
+  // once the rounds are done
+  bool startRound(const fragment_t& frag, context_t& ctx,
+                  message_manager_t& messages, double& base) {
     size_t graph_vnum = frag.GetTotalVerticesNum(0);
 
     ++ctx.step;
     if (ctx.step > ctx.max_round) {
-      return;
+      return false;
     }
 
-    double base =
-        (1.0 - ctx.delta) / graph_vnum + ctx.delta * dangling_sum / graph_vnum;
+    base = (1.0 - ctx.delta) / graph_vnum +
+           ctx.delta * ctx.dangling_sum / graph_vnum;
 
     // process received ranks sent by other workers
-    {
-      messages.ParallelProcess<fragment_t, double>(
-          thread_num(), frag, [&ctx](int tid, vertex_t u, const double& msg) {
-            ctx.result[u] = msg;
-          });
-    }
-
-    // compute new ranks and send messages
-    if (ctx.step != ctx.max_round) {
-      ForEach(inner_vertices,
-              [&ctx, base, &frag, &messages](int tid, vertex_t u) {
-                if (ctx.degree[u] == 0) {
-                  ctx.next_result[u] = base;
-                } else {
-                  double cur = 0;
-                  auto es = frag.GetIncomingAdjList(u, 0);
-                  for (auto& e : es) {
-                    cur += ctx.result[e.get_neighbor()];
-                  }
-                  cur = (ctx.delta * cur + base) / ctx.degree[u];
-                  ctx.next_result[u] = cur;
-                  messages.SendMsgThroughOEdges<fragment_t, double>(
-                      frag, u, 0, ctx.next_result[u], tid);
-                }
-              });
-    } else {
-      ForEach(inner_vertices, [&ctx, base, &frag](int tid, vertex_t u) {
-        if (ctx.degree[u] == 0) {
-          ctx.next_result[u] = base;
-        } else {
-          double cur = 0;
-          auto es = frag.GetIncomingAdjList(u, 0);
-          for (auto& e : es) {
-            cur += ctx.result[e.get_neighbor()];
-          }
-          cur = (ctx.delta * cur + base) / ctx.degree[u];
-          ctx.next_result[u] = cur;
-        }
-      });
-    }
+    messages.ParallelProcess<fragment_t, double>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, const double& msg) {
+          ctx.result[u] = msg;
+          ctx.changed.Insert(u);
+        });
+    return true;
+  }
 
-    ctx.result.Swap(ctx.next_result);
+  // computes the new ranks from the sums, and syncs the changed ones
+  void finishRound(const fragment_t& frag, context_t& ctx,
+                   message_manager_t& messages, double base) {
+    ctx.changed.ParallelClear(thread_num());
+    bool send = ctx.step != ctx.max_round;
+    ForEach(frag.InnerVertices(0),
+            [&ctx, base, send, &frag, &messages](int tid, vertex_t u) {
+              double next = base;
+              if (ctx.degree[u] != 0) {
+                next = (ctx.delta * ctx.sum[u] + base) / ctx.degree[u];
+              }
+              if (std::fabs(next - ctx.result[u]) <= ctx.tolerance) {
+                return;
+              }
+              ctx.result[u] = next;
+              ctx.changed.Insert(u);
+              if (send && ctx.degree[u] != 0) {
+                messages.SendMsgThroughOEdges<fragment_t, double>(
+                    frag, u, 0, next, tid);
+              }
+            });
 
     double new_dangling = base * static_cast<double>(ctx.dangling_vnum);
 
     Sum(new_dangling, ctx.dangling_sum);
 
-    messages.ForceContinue();
+    if (!ctx.changed.Empty()) {
+      messages.ForceContinue();
+    }
   }
 };
 
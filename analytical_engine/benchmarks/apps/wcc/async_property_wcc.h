@@ -0,0 +1,161 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_ASYNC_PROPERTY_WCC_H_
+#define ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_ASYNC_PROPERTY_WCC_H_
+
+#include "grape/grape.h"
+
+#include "core/app/async_property_app_base.h"
+#include "core/context/vertex_data_context.h"
+#include "core/worker/async_property_worker.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+template <typename FRAG_T>
+class AsyncPropertyWCCContext
+    : public LabeledVertexDataContext<FRAG_T, typename FRAG_T::vid_t> {
+ public:
+  using vid_t = typename FRAG_T::vid_t;
+
+  explicit AsyncPropertyWCCContext(const FRAG_T& fragment)
+      : LabeledVertexDataContext<FRAG_T, typename FRAG_T::vid_t>(fragment,
+                                                                 true),
+        comp_id(this->data()[0]) {}
+
+  void Init(AsyncPropertyMessageManager& messages) {
+    auto& frag = this->fragment();
+    auto vertices = frag.Vertices(0);
+    comp_id.Init(vertices);
+    curr_modified.Init(vertices);
+    next_modified.Init(vertices);
+    outer_modified.Init(vertices);
+  }
+
+  void Output(std::ostream& os) {
+    auto& frag = this->fragment();
+    auto inner_vertices = frag.InnerVertices(0);
+    for (auto v : inner_vertices) {
+      os << frag.GetId(v) << " " << comp_id[v] << std::endl;
+    }
+  }
+
+  typename FRAG_T::template vertex_array_t<vid_t>& comp_id;
+
+  grape::DenseVertexSet<vid_t> curr_modified, next_modified;
+  // the outer vertices updated since the labels were last sent
+  grape::DenseVertexSet<vid_t> outer_modified;
+};
+
+/**
+ * @brief The asynchronous version of PropertyWCC. As there is no round to
+ * continue with, each evaluation propagates the labels over the local edges
+ * until nothing changes, and then sends the labels of the updated outer
+ * vertices, which are applied by the owners as soon as they arrive.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class AsyncPropertyWCC
+    : public AsyncPropertyAppBase<FRAG_T, AsyncPropertyWCCContext<FRAG_T>>,
+      public grape::ParallelEngine {
+ public:
+  INSTALL_ASYNC_PROPERTY_WORKER(AsyncPropertyWCC<FRAG_T>,
+                                AsyncPropertyWCCContext<FRAG_T>, FRAG_T)
+  using vertex_t = typename fragment_t::vertex_t;
+  using vid_t = typename fragment_t::vid_t;
+
+  void PropagateLabelPush(const fragment_t& frag, context_t& ctx,
+                          message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices(0);
+    auto outer_vertices = frag.OuterVertices(0);
+    auto update = [&ctx](vertex_t u, vid_t cid) {
+      if (ctx.comp_id[u] > cid) {
+        grape::atomic_min(ctx.comp_id[u], cid);
+        ctx.next_modified.Insert(u);
+      }
+    };
+
+    while (!ctx.curr_modified.PartialEmpty(0, frag.GetInnerVerticesNum(0))) {
+      ctx.next_modified.ParallelClear(thread_num());
+      ForEach(ctx.curr_modified, inner_vertices,
+              [&frag, &ctx, &update](int tid, vertex_t v) {
+                auto cid = ctx.comp_id[v];
+                auto es = frag.GetOutgoingAdjList(v, 0);
+                for (auto& e : es) {
+                  update(e.get_neighbor(), cid);
+                }
+                es = frag.GetIncomingAdjList(v, 0);
+                for (auto& e : es) {
+                  update(e.get_neighbor(), cid);
+                }
+              });
+      ForEach(outer_vertices, [&ctx](int tid, vertex_t v) {
+        if (ctx.next_modified.Exist(v)) {
+          ctx.outer_modified.Insert(v);
+        }
+      });
+      ctx.curr_modified.Swap(ctx.next_modified);
+    }
+
+    ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
+      if (ctx.outer_modified.Exist(v)) {
+        messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
+                                                           ctx.comp_id[v], tid);
+      }
+    });
+    ctx.outer_modified.ParallelClear(thread_num());
+  }
+
+  void PEval(const fragment_t& frag, context_t& ctx,
+             message_manager_t& messages) {
+    auto inner_vertices = frag.InnerVertices(0);
+    auto outer_vertices = frag.OuterVertices(0);
+
+    messages.InitChannels(thread_num());
+
+    ForEach(inner_vertices, [&frag, &ctx](int tid, vertex_t v) {
+      ctx.comp_id[v] = frag.GetInnerVertexGid(v);
+      ctx.curr_modified.Insert(v);
+    });
+    ForEach(outer_vertices, [&frag, &ctx](int tid, vertex_t v) {
+      ctx.comp_id[v] = frag.GetOuterVertexGid(v);
+    });
+
+    PropagateLabelPush(frag, ctx, messages);
+  }
+
+  void IncEval(const fragment_t& frag, context_t& ctx,
+               message_manager_t& messages) {
+    ctx.curr_modified.ParallelClear(thread_num());
+    messages.ParallelProcess<fragment_t, vid_t>(
+        thread_num(), frag, [&ctx](int tid, vertex_t u, vid_t msg) {
+          if (ctx.comp_id[u] > msg) {
+            grape::atomic_min(ctx.comp_id[u], msg);
+            ctx.curr_modified.Insert(u);
+          }
+        });
+
+    PropagateLabelPush(frag, ctx, messages);
+  }
+};
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_BENCHMARKS_APPS_WCC_ASYNC_PROPERTY_WCC_H_
@@ -70,39 +70,15 @@ class PropertyWCC
   using vertex_t = typename fragment_t::vertex_t;
   using vid_t = typename fragment_t::vid_t;
 
+  // propagates the labels of the vertices in curr_modified to their incoming
+  // and outgoing neighbors, where the ones of the outer neighbors are
+  // combined by the min, and sent to their owners
   void PropagateLabelPush(const fragment_t& frag, context_t& ctx,
                           message_manager_t& messages) {
-    auto inner_vertices = frag.InnerVertices(0);
-    auto outer_vertices = frag.OuterVertices(0);
-
-    // propagate label to incoming and outgoing neighbors
-    ForEach(ctx.curr_modified, inner_vertices,
-            [&frag, &ctx](int tid, vertex_t v) {
-              auto cid = ctx.comp_id[v];
-              auto es = frag.GetOutgoingAdjList(v, 0);
-              for (auto& e : es) {
-                auto u = e.get_neighbor();
-                if (ctx.comp_id[u] > cid) {
-                  grape::atomic_min(ctx.comp_id[u], cid);
-                  ctx.next_modified.Insert(u);
-                }
-              }
-              es = frag.GetIncomingAdjList(v, 0);
-              for (auto& e : es) {
-                auto u = e.get_neighbor();
-                if (ctx.comp_id[u] > cid) {
-                  grape::atomic_min(ctx.comp_id[u], cid);
-                  ctx.next_modified.Insert(u);
-                }
-              }
+    ForEach(ctx.curr_modified, frag.InnerVertices(0),
+            [this, &frag, &ctx, &messages](int tid, vertex_t v) {
+              propagate(frag, ctx, messages, tid, v);
             });
-
-    ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
-      if (ctx.next_modified.Exist(v)) {
-        messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
-                                                           ctx.comp_id[v], tid);
-      }
-    });
   }
 
   void PEval(const fragment_t& frag, context_t& ctx,
@@ -119,32 +95,10 @@ class PropertyWCC
       ctx.comp_id[v] = frag.GetOuterVertexGid(v);
     });
 
-    ForEach(inner_vertices, [&frag, &ctx](int tid, vertex_t v) {
-      auto cid = ctx.comp_id[v];
-      auto es = frag.GetOutgoingAdjList(v, 0);
-      for (auto& e : es) {
-        auto u = e.get_neighbor();
-        if (ctx.comp_id[u] > cid) {
-          grape::atomic_min(ctx.comp_id[u], cid);
-          ctx.next_modified.Insert(u);
-        }
-      }
-      es = frag.GetIncomingAdjList(v, 0);
-      for (auto& e : es) {
-        auto u = e.get_neighbor();
-        if (ctx.comp_id[u] > cid) {
-          grape::atomic_min(ctx.comp_id[u], cid);
-          ctx.next_modified.Insert(u);
-        }
-      }
-    });
-
-    ForEach(outer_vertices, [&messages, &frag, &ctx](int tid, vertex_t v) {
-      if (ctx.next_modified.Exist(v)) {
-        messages.SyncStateOnOuterVertex<fragment_t, vid_t>(frag, v,
-                                                           ctx.comp_id[v], tid);
-      }
-    });
+    ForEach(inner_vertices,
+            [this, &frag, &ctx, &messages](int tid, vertex_t v) {
+              propagate(frag, ctx, messages, tid, v);
+            });
 
     if (!ctx.next_modified.PartialEmpty(0, frag.GetInnerVerticesNum(0))) {
       messages.ForceContinue();
@@ -173,6 +127,29 @@ class PropertyWCC
 
     ctx.curr_modified.Swap(ctx.next_modified);
   }
+
+ private:
+  void propagate(const fragment_t& frag, context_t& ctx,
+                 message_manager_t& messages, int tid, vertex_t v) {
+    auto cid = ctx.comp_id[v];
+    auto update = [&](vertex_t u) {
+      if (ctx.comp_id[u] > cid) {
+        grape::atomic_min(ctx.comp_id[u], cid);
+        if (frag.IsOuterVertex(u)) {
+          messages.CombineStateOnOuterVertex<fragment_t, vid_t, MinCombiner>(
+              frag, u, cid, MinCombiner(), tid);
+        } else {
+          ctx.next_modified.Insert(u);
+        }
+      }
+    };
+    for (auto& e : frag.GetOutgoingAdjList(v, 0)) {
+      update(e.get_neighbor());
+    }
+    for (auto& e : frag.GetIncomingAdjList(v, 0)) {
+      update(e.get_neighbor());
+    }
+  }
 };
 
 }  // namespace benchmarks
@@ -20,6 +20,8 @@
 
 #include "grape/grape.h"
 
+#include "core/fragment/vertex_order.h"
+
 namespace gs {
 
 namespace benchmarks {
@@ -112,7 +114,9 @@ class WCC : public grape::ParallelAppBase<FRAG_T, WCCContext<FRAG_T>>,
       ctx.comp_id[v] = frag.GetOuterVertexGid(v);
     });
 
-    ForEach(inner_vertices, [&frag, &ctx](int tid, vertex_t v) {
+    // the neighbors of the vertices in a row are likely to be in the cache
+    // in the order of the inner vertices of the fragment, if any
+    ForEachInnerVertex(*this, frag, [&frag, &ctx](int tid, vertex_t v) {
       auto cid = ctx.comp_id[v];
       auto es = frag.GetOutgoingAdjList(v);
       for (auto& e : es) {
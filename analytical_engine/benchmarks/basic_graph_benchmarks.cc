@@ -27,10 +27,16 @@ limitations under the License.
 #include "grape/util.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "apps/projected/wcc_afforest.h"
+#include "apps/projected/wcc_rma.h"
+#include "apps/scc/scc.h"
 #include "benchmarks/apps/bfs/bfs.h"
+#include "benchmarks/apps/pagerank/delta_pagerank.h"
 #include "benchmarks/apps/pagerank/pagerank.h"
 #include "benchmarks/apps/sssp/sssp.h"
 #include "benchmarks/apps/wcc/wcc.h"
+#include "benchmarks/benchmark_report.h"
+#include "benchmarks/benchmark_worker.h"
 
 using EmptyGraphType =
     grape::ImmutableEdgecutFragment<vineyard::property_graph_types::OID_TYPE,
@@ -45,8 +51,10 @@ using EDGraphType =
                                     grape::LoadStrategy::kBothOutIn>;
 
 template <typename GRAPH_T, typename APP_T, typename... Args>
-void LoadAndRunApp(const grape::CommSpec& comm_spec, const std::string& efile,
-                   const std::string& vfile, bool directed,
+void LoadAndRunApp(const grape::CommSpec& comm_spec,
+                   gs::benchmarks::BenchmarkReport& report,
+                   const std::string& efile, const std::string& vfile,
+                   bool directed,
                    const grape::ParallelEngineSpec& parallel_spec,
                    const std::string& serial_prefix,
                    const std::string& out_prefix, Args... args) {
@@ -55,21 +63,27 @@ void LoadAndRunApp(const grape::CommSpec& comm_spec, const std::string& efile,
   graph_spec.set_deserialize(true, serial_prefix);
   graph_spec.set_rebalance(false, 0);
 
+  double t0 = grape::GetCurrentTime();
   std::shared_ptr<GRAPH_T> fragment;
   fragment = grape::LoadGraph<GRAPH_T,
                               grape::HashPartitioner<typename GRAPH_T::oid_t>>(
       efile, vfile, comm_spec, graph_spec);
+  report.AddPhase("load", grape::GetCurrentTime() - t0);
 
   auto app = std::make_shared<APP_T>();
 
-  auto worker = APP_T::CreateWorker(app, fragment);
+  auto worker =
+      std::make_shared<gs::benchmarks::BenchmarkWorker<APP_T>>(app, fragment,
+                                                               report);
   worker->Init(comm_spec, parallel_spec);
-  double t0 = grape::GetCurrentTime();
+  t0 = grape::GetCurrentTime();
   worker->Query(std::forward<Args>(args)...);
   double t1 = grape::GetCurrentTime();
+  report.AddPhase("query", t1 - t0);
   LOG(INFO) << "[worker-" << comm_spec.worker_id()
             << "]: Query time: " << t1 - t0;
 
+  t0 = grape::GetCurrentTime();
   std::ofstream ostream;
   std::string output_path =
       grape::GetResultFilename(out_prefix, fragment->fid());
@@ -77,6 +91,7 @@ void LoadAndRunApp(const grape::CommSpec& comm_spec, const std::string& efile,
   worker->Output(ostream);
   ostream.close();
   worker->Finalize();
+  report.AddPhase("output", grape::GetCurrentTime() - t0);
 }
 
 int main(int argc, char** argv) {
@@ -100,39 +115,67 @@ int main(int argc, char** argv) {
   comm_spec.Init(MPI_COMM_WORLD);
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(comm_spec, app_name, epath);
 
   if (app_name == "sssp") {
     CHECK_GE(argc, 7);
     std::string root = argv[6];
 
     LoadAndRunApp<EDGraphType, gs::benchmarks::SSSP<EDGraphType>>(
-        comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_sssp",
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_sssp",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "bfs") {
     CHECK_GE(argc, 7);
     std::string root = argv[6];
 
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::BFS<EmptyGraphType>>(
-        comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_bfs",
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_bfs",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::WCC<EmptyGraphType>>(
-        comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_wcc");
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_wcc");
+  } else if (app_name == "wcc_afforest") {
+    LoadAndRunApp<EmptyGraphType, gs::WCCAfforest<EmptyGraphType>>(
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_wcc_afforest");
+  } else if (app_name == "wcc_rma") {
+    LoadAndRunApp<EmptyGraphType, gs::WCCRMA<EmptyGraphType>>(
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_wcc_rma");
+  } else if (app_name == "scc") {
+    LoadAndRunApp<EmptyGraphType, gs::SCC<EmptyGraphType>>(
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_scc");
   } else if (app_name == "pr") {
     CHECK_GE(argc, 8);
     std::string delta = argv[6];
     std::string max_round = argv[7];
 
     LoadAndRunApp<EmptyGraphType, gs::benchmarks::PageRank<EmptyGraphType>>(
-        comm_spec, epath, vpath, directed, parallel_spec, serialization_prefix,
-        "./output_or_pr", boost::lexical_cast<double>(delta),
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_pr",
+        boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
+  } else if (app_name == "delta_pr") {
+    CHECK_GE(argc, 9);
+    std::string delta = argv[6];
+    std::string max_round = argv[7];
+    std::string epsilon = argv[8];
+
+    LoadAndRunApp<EmptyGraphType,
+                  gs::benchmarks::DeltaPageRank<EmptyGraphType>>(
+        comm_spec, report, epath, vpath, directed, parallel_spec,
+        serialization_prefix, "./output_or_delta_pr",
+        boost::lexical_cast<double>(delta),
+        boost::lexical_cast<int>(max_round),
+        boost::lexical_cast<double>(epsilon));
   }
 
   MPI_Barrier(comm_spec.comm());
+  report.Write();
 
   grape::FinalizeMPIComm();
   return 0;
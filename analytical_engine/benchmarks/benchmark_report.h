@@ -0,0 +1,144 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_REPORT_H_
+#define ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_REPORT_H_
+
+#include <mpi.h>
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/worker/comm_spec.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+/**
+ * @brief The timings of a run of a benchmark, of the phases, e.g., load,
+ * prepare, init and output, and of each round of the query, with the bytes of
+ * the messages sent in the round, and the counters, e.g., the bytes loaded.
+ * The times are the maxima of the workers, and the bytes and the counters
+ * are the sums, written by the coordinator as a JSON object to the
+ * path of the environment variable GS_BENCHMARK_REPORT if it is set.
+ */
+class BenchmarkReport {
+ public:
+  BenchmarkReport(const grape::CommSpec& comm_spec, const std::string& app,
+                  const std::string& dataset)
+      : comm_spec_(comm_spec), app_(app), dataset_(dataset) {}
+
+  void AddPhase(const std::string& name, double seconds) {
+    phases_.emplace_back(name, seconds);
+  }
+
+  void AddRound(double seconds, size_t message_bytes) {
+    round_times_.push_back(seconds);
+    round_bytes_.push_back(message_bytes);
+  }
+
+  void AddCounter(const std::string& name, int64_t value) {
+    counters_.emplace_back(name, value);
+  }
+
+  /**
+   * @brief Reduces the timings of the workers, which must have the same phases
+   * and rounds, and writes the report on the coordinator.
+   */
+  void Write() {
+    std::vector<double> times;
+    for (auto const& phase : phases_) {
+      times.push_back(phase.second);
+    }
+    times.insert(times.end(), round_times_.begin(), round_times_.end());
+    std::vector<double> max_times(times.size());
+    MPI_Allreduce(times.data(), max_times.data(), times.size(), MPI_DOUBLE,
+                  MPI_MAX, comm_spec_.comm());
+
+    std::vector<uint64_t> bytes(round_bytes_.begin(), round_bytes_.end());
+    std::vector<uint64_t> total_bytes(bytes.size());
+    MPI_Allreduce(bytes.data(), total_bytes.data(), bytes.size(),
+                  MPI_UINT64_T, MPI_SUM, comm_spec_.comm());
+
+    std::vector<int64_t> counters, total_counters(counters_.size());
+    for (auto const& counter : counters_) {
+      counters.push_back(counter.second);
+    }
+    MPI_Allreduce(counters.data(), total_counters.data(), counters.size(),
+                  MPI_INT64_T, MPI_SUM, comm_spec_.comm());
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    int64_t rss = usage.ru_maxrss, max_rss = 0, total_rss = 0;
+    MPI_Allreduce(&rss, &max_rss, 1, MPI_INT64_T, MPI_MAX, comm_spec_.comm());
+    MPI_Allreduce(&rss, &total_rss, 1, MPI_INT64_T, MPI_SUM,
+                  comm_spec_.comm());
+
+    if (comm_spec_.worker_id() != grape::kCoordinatorRank) {
+      return;
+    }
+    const char* path = std::getenv("GS_BENCHMARK_REPORT");
+    LOG(INFO) << "[" << app_ << "]: " << phases_.size() << " phases, "
+              << round_times_.size() << " rounds, peak rss " << max_rss
+              << " KB";
+    if (path == nullptr) {
+      return;
+    }
+    std::ofstream os(path);
+    os << "{\"app\": \"" << app_ << "\", \"dataset\": \"" << dataset_
+       << "\", \"workers\": " << comm_spec_.worker_num() << ", \"phases\": {";
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << "\"" << phases_[i].first
+         << "\": " << max_times[i];
+    }
+    os << "}, \"rounds\": [";
+    for (size_t i = 0; i < round_times_.size(); ++i) {
+      os << (i == 0 ? "" : ", ")
+         << "{\"time\": " << max_times[phases_.size() + i]
+         << ", \"message_bytes\": " << total_bytes[i] << "}";
+    }
+    os << "], \"counters\": {";
+    for (size_t i = 0; i < counters_.size(); ++i) {
+      os << (i == 0 ? "" : ", ") << "\"" << counters_[i].first
+         << "\": " << total_counters[i];
+    }
+    os << "}, \"peak_rss_kb\": {\"max\": " << max_rss
+       << ", \"total\": " << total_rss << "}}" << std::endl;
+    LOG(INFO) << "Wrote the benchmark report to " << path;
+  }
+
+ private:
+  grape::CommSpec comm_spec_;
+  std::string app_;
+  std::string dataset_;
+  std::vector<std::pair<std::string, double>> phases_;
+  std::vector<double> round_times_;
+  std::vector<size_t> round_bytes_;
+  std::vector<std::pair<std::string, int64_t>> counters_;
+};
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_REPORT_H_
@@ -0,0 +1,123 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_WORKER_H_
+#define ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_WORKER_H_
+
+#include <mpi.h>
+
+#include <memory>
+#include <ostream>
+#include <utility>
+
+#include "grape/communication/communicator.h"
+#include "grape/config.h"
+#include "grape/parallel/parallel_engine.h"
+#include "grape/util.h"
+#include "grape/worker/comm_spec.h"
+
+#include "benchmarks/benchmark_report.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+/**
+ * @brief A worker of the parallel apps like the one of grape, which records
+ * the time of PrepareToRunApp, of the init of the context, of PEval and each
+ * IncEval round, and the bytes of the messages of each round, to the report.
+ *
+ * @tparam APP_T
+ */
+template <typename APP_T>
+class BenchmarkWorker {
+ public:
+  using fragment_t = typename APP_T::fragment_t;
+  using context_t = typename APP_T::context_t;
+  using message_manager_t = typename APP_T::message_manager_t;
+
+  BenchmarkWorker(std::shared_ptr<APP_T> app, std::shared_ptr<fragment_t> graph,
+                  BenchmarkReport& report)
+      : app_(app),
+        graph_(graph),
+        context_(std::make_shared<context_t>(*graph)),
+        report_(report) {}
+
+  void Init(const grape::CommSpec& comm_spec,
+            const grape::ParallelEngineSpec& pe_spec =
+                grape::DefaultParallelEngineSpec()) {
+    double t0 = grape::GetCurrentTime();
+    graph_->PrepareToRunApp(APP_T::message_strategy, APP_T::need_split_edges);
+    report_.AddPhase("prepare", grape::GetCurrentTime() - t0);
+
+    comm_spec_ = comm_spec;
+    messages_.Init(comm_spec_.comm());
+
+    grape::InitParallelEngine(app_, pe_spec);
+    grape::InitCommunicator(app_, comm_spec_.comm());
+  }
+
+  void Finalize() {}
+
+  template <class... Args>
+  void Query(Args&&... args) {
+    MPI_Barrier(comm_spec_.comm());
+
+    double t0 = grape::GetCurrentTime();
+    context_->Init(messages_, std::forward<Args>(args)...);
+    report_.AddPhase("init", grape::GetCurrentTime() - t0);
+
+    messages_.Start();
+
+    t0 = grape::GetCurrentTime();
+    messages_.StartARound();
+    app_->PEval(*graph_, *context_, messages_);
+    messages_.FinishARound();
+    report_.AddRound(grape::GetCurrentTime() - t0, messages_.GetMsgSize());
+
+    while (!messages_.ToTerminate()) {
+      t0 = grape::GetCurrentTime();
+      messages_.StartARound();
+      app_->IncEval(*graph_, *context_, messages_);
+      messages_.FinishARound();
+      report_.AddRound(grape::GetCurrentTime() - t0, messages_.GetMsgSize());
+    }
+    MPI_Barrier(comm_spec_.comm());
+    messages_.Finalize();
+  }
+
+  void Output(std::ostream& os) { context_->Output(os); }
+
+  /**
+   * @brief The message manager, which is configured between Init() and
+   * Query(), e.g., to enable the hierarchical routing.
+   */
+  message_manager_t& GetMessageManager() { return messages_; }
+
+ private:
+  std::shared_ptr<APP_T> app_;
+  std::shared_ptr<fragment_t> graph_;
+  std::shared_ptr<context_t> context_;
+  message_manager_t messages_;
+  BenchmarkReport& report_;
+
+  grape::CommSpec comm_spec_;
+};
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_BENCHMARKS_BENCHMARK_WORKER_H_
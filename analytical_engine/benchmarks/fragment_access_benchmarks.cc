@@ -0,0 +1,383 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "folly/dynamic.h"
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "core/fragment/arrow_projected_fragment.h"
+#include "core/fragment/dynamic_fragment.h"
+#include "core/fragment/dynamic_projected_fragment.h"
+#include "core/loader/arrow_fragment_loader.h"
+#include "core/loader/arrow_to_dynamic_converter.h"
+
+namespace gs {
+
+namespace benchmarks {
+
+using oid_t = vineyard::property_graph_types::OID_TYPE;
+using vid_t = vineyard::property_graph_types::VID_TYPE;
+
+using ArrowFragmentType = vineyard::ArrowFragment<oid_t, vid_t>;
+using ArrowProjectedFragmentType =
+    gs::ArrowProjectedFragment<oid_t, vid_t, int64_t, int64_t>;
+using DynamicProjectedFragmentType =
+    gs::DynamicProjectedFragment<int64_t, int64_t>;
+
+// the sources of the edges are uniform, or skewed to a few hubs
+enum class Distribution { kUniform, kPowerLaw };
+
+inline std::string distribution_name(Distribution dist) {
+  return dist == Distribution::kUniform ? "uniform" : "power_law";
+}
+
+/**
+ * @brief The fragments of a synthetic graph, all from the same ArrowFragment,
+ * with an int64 property "value" of the vertices and "weight" of the edges.
+ */
+struct Graphs {
+  std::shared_ptr<ArrowProjectedFragmentType> arrow_projected;
+  std::shared_ptr<ArrowProjectedFragmentType> arrow_materialized;
+  std::shared_ptr<gs::DynamicFragment> dynamic;
+  std::shared_ptr<DynamicProjectedFragmentType> dynamic_projected;
+};
+
+/**
+ * @brief Counts the cache misses of the calling thread with perf events, if
+ * they are available, e.g., perf_event_paranoid allows it.
+ */
+class CacheMissCounter {
+ public:
+  CacheMissCounter() {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  ~CacheMissCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool valid() const { return fd_ >= 0; }
+
+  void Start() {
+    if (valid()) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  uint64_t Stop() {
+    uint64_t count = 0;
+    if (valid()) {
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+        count = 0;
+      }
+    }
+    return count;
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+struct Config {
+  int64_t vertex_num = 1 << 20;
+  int64_t degree = 16;
+};
+
+Config config;
+vineyard::Client client;
+grape::CommSpec comm_spec;
+
+// the R-MAT graph of the distribution generated by the loader, i.e., the
+// uniform one by the equal quadrants, of 2^scale vertices for the scale of
+// rounding up vertex_num
+std::pair<std::string, std::string> graph_locations(Distribution dist) {
+  int scale = 1;
+  while ((int64_t(1) << scale) < config.vertex_num) {
+    ++scale;
+  }
+  std::string params = "scale=" + std::to_string(scale) + "&seed=0";
+  if (dist == Distribution::kUniform) {
+    params += "&a=0.25&b=0.25&c=0.25";
+  }
+  return std::make_pair(
+      "rmat://edges?" + params + "&edge_factor=" +
+          std::to_string(config.degree) +
+          "#label=e&src_label=v&dst_label=v",
+      "rmat://vertices?" + params + "#label=v");
+}
+
+// loads the fragments of the graph of the distribution once, on the first
+// benchmark using it
+const Graphs& load_graphs(Distribution dist) {
+  static std::map<Distribution, Graphs> cache;
+  auto iter = cache.find(dist);
+  if (iter != cache.end()) {
+    return iter->second;
+  }
+
+  auto locations = graph_locations(dist);
+  std::vector<std::string> efiles{locations.first};
+  std::vector<std::string> vfiles{locations.second};
+
+  auto& graphs = cache[dist];
+  ArrowFragmentLoader<oid_t, vid_t> loader(client, comm_spec, efiles, vfiles,
+                                           true);
+  boost::leaf::try_handle_all(
+      [&]() -> boost::leaf::result<void> {
+        BOOST_LEAF_AUTO(frag_id, loader.LoadFragment());
+        auto frag = std::dynamic_pointer_cast<ArrowFragmentType>(
+            client.GetObject(frag_id));
+        graphs.arrow_projected =
+            ArrowProjectedFragmentType::Project(frag, "0", "0", "0", "0");
+        graphs.arrow_materialized = ArrowProjectedFragmentType::Project(
+            frag, "0", "0", "0", "0", "none", true);
+        ArrowToDynamicConverter<ArrowFragmentType> converter(comm_spec);
+        BOOST_LEAF_ASSIGN(graphs.dynamic, converter.Convert(frag));
+        graphs.dynamic_projected = DynamicProjectedFragmentType::Project(
+            graphs.dynamic, "value", "weight");
+        return {};
+      },
+      [](const vineyard::GSError& e) { LOG(FATAL) << e.error_msg; },
+      [](const boost::leaf::error_info& unmatched) {
+        LOG(FATAL) << "Unmatched error " << unmatched;
+      });
+  return graphs;
+}
+
+inline int64_t value_of(int64_t value, const char*) { return value; }
+
+inline int64_t value_of(const folly::dynamic& value, const char* key) {
+  return value.at(key).asInt();
+}
+
+// the time and the cache misses per item, e.g., per edge or per vertex
+void report(benchmark::State& state, CacheMissCounter& counter,
+            uint64_t misses, size_t items) {
+  state.SetItemsProcessed(state.iterations() * items);
+  state.counters["time_per_item"] =
+      benchmark::Counter(static_cast<double>(items),
+                         benchmark::Counter::kIsIterationInvariantRate |
+                             benchmark::Counter::kInvert);
+  if (counter.valid() && items != 0) {
+    state.counters["cache_misses_per_item"] =
+        benchmark::Counter(static_cast<double>(misses) / items,
+                           benchmark::Counter::kAvgIterations);
+  }
+}
+
+template <typename FRAG_T>
+using getter_t = std::function<std::shared_ptr<FRAG_T>(const Graphs&)>;
+
+template <typename FRAG_T>
+void outgoing_edges(benchmark::State& state, Distribution dist,
+                    const getter_t<FRAG_T>& get, bool read_data) {
+  auto frag = get(load_graphs(dist));
+  auto inner_vertices = frag->InnerVertices();
+  size_t edge_num = 0;
+  for (auto v : inner_vertices) {
+    for (auto& e : frag->GetOutgoingAdjList(v)) {
+      static_cast<void>(e);
+      ++edge_num;
+    }
+  }
+
+  CacheMissCounter counter;
+  counter.Start();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto v : inner_vertices) {
+      for (auto& e : frag->GetOutgoingAdjList(v)) {
+        sum += read_data ? value_of(e.get_data(), "weight")
+                         : static_cast<int64_t>(e.get_neighbor().GetValue());
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  report(state, counter, counter.Stop(), edge_num);
+}
+
+template <typename FRAG_T>
+void gid_to_vertex(benchmark::State& state, Distribution dist,
+                   const getter_t<FRAG_T>& get) {
+  auto frag = get(load_graphs(dist));
+  std::vector<typename FRAG_T::vid_t> gids;
+  for (auto v : frag->InnerVertices()) {
+    gids.push_back(frag->GetInnerVertexGid(v));
+  }
+  std::shuffle(gids.begin(), gids.end(), std::mt19937_64(0));
+
+  CacheMissCounter counter;
+  counter.Start();
+  for (auto _ : state) {
+    typename FRAG_T::vertex_t v;
+    int64_t sum = 0;
+    for (auto gid : gids) {
+      frag->Gid2Vertex(gid, v);
+      sum += v.GetValue();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  report(state, counter, counter.Stop(), gids.size());
+}
+
+template <typename FRAG_T>
+void get_vertex(benchmark::State& state, Distribution dist,
+                const getter_t<FRAG_T>& get) {
+  auto frag = get(load_graphs(dist));
+  std::vector<typename FRAG_T::oid_t> oids;
+  for (auto v : frag->InnerVertices()) {
+    oids.push_back(frag->GetId(v));
+  }
+  std::shuffle(oids.begin(), oids.end(), std::mt19937_64(0));
+
+  CacheMissCounter counter;
+  counter.Start();
+  for (auto _ : state) {
+    typename FRAG_T::vertex_t v;
+    int64_t sum = 0;
+    for (auto& oid : oids) {
+      frag->GetVertex(oid, v);
+      sum += v.GetValue();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  report(state, counter, counter.Stop(), oids.size());
+}
+
+template <typename FRAG_T>
+void get_data(benchmark::State& state, Distribution dist,
+              const getter_t<FRAG_T>& get) {
+  auto frag = get(load_graphs(dist));
+  auto inner_vertices = frag->InnerVertices();
+
+  CacheMissCounter counter;
+  counter.Start();
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto v : inner_vertices) {
+      sum += value_of(frag->GetData(v), "value");
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  report(state, counter, counter.Stop(), inner_vertices.size());
+}
+
+template <typename FRAG_T>
+void register_fragment(const std::string& kind, const getter_t<FRAG_T>& get) {
+  for (auto dist : {Distribution::kUniform, Distribution::kPowerLaw}) {
+    std::string suffix = "/" + distribution_name(dist);
+    benchmark::RegisterBenchmark(
+        (kind + "/outgoing_edges" + suffix).c_str(),
+        [=](benchmark::State& state) {
+          outgoing_edges<FRAG_T>(state, dist, get, false);
+        });
+    benchmark::RegisterBenchmark(
+        (kind + "/edge_data" + suffix).c_str(), [=](benchmark::State& state) {
+          outgoing_edges<FRAG_T>(state, dist, get, true);
+        });
+    benchmark::RegisterBenchmark(
+        (kind + "/gid2vertex" + suffix).c_str(),
+        [=](benchmark::State& state) {
+          gid_to_vertex<FRAG_T>(state, dist, get);
+        });
+    benchmark::RegisterBenchmark(
+        (kind + "/get_vertex" + suffix).c_str(),
+        [=](benchmark::State& state) { get_vertex<FRAG_T>(state, dist, get); });
+    benchmark::RegisterBenchmark(
+        (kind + "/get_data" + suffix).c_str(),
+        [=](benchmark::State& state) { get_data<FRAG_T>(state, dist, get); });
+  }
+}
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (argc < 2) {
+    printf(
+        "usage: ./fragment_access_benchmarks [benchmark flags] <ipc_socket> "
+        "[vertex_num] [degree]\n");
+    return 1;
+  }
+  using namespace gs::benchmarks;  // NOLINT(build/namespaces)
+  std::string ipc_socket = argv[1];
+  if (argc > 2) {
+    config.vertex_num = atol(argv[2]);
+  }
+  if (argc > 3) {
+    config.degree = atol(argv[3]);
+  }
+
+  grape::InitMPIComm();
+  {
+    comm_spec.Init(MPI_COMM_WORLD);
+    // the whole graph is loaded to a single worker, to time the local
+    // accesses only
+    CHECK_EQ(comm_spec.worker_num(), 1);
+    VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+
+    register_fragment<ArrowProjectedFragmentType>(
+        "arrow_projected",
+        [](const Graphs& graphs) { return graphs.arrow_projected; });
+    register_fragment<ArrowProjectedFragmentType>(
+        "arrow_materialized",
+        [](const Graphs& graphs) { return graphs.arrow_materialized; });
+    register_fragment<gs::DynamicFragment>(
+        "dynamic", [](const Graphs& graphs) { return graphs.dynamic; });
+    register_fragment<DynamicProjectedFragmentType>(
+        "dynamic_projected",
+        [](const Graphs& graphs) { return graphs.dynamic_projected; });
+
+    benchmark::RunSpecifiedBenchmarks();
+  }
+  grape::FinalizeMPIComm();
+  return 0;
+}
@@ -0,0 +1,388 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/algorithm/string.hpp"
+#include "glog/logging.h"
+
+#include "grape/grape.h"
+#include "grape/util.h"
+#include "vineyard/client/client.h"
+
+#include "apps/property/wcc_property_append.h"
+#include "benchmarks/apps/wcc/wcc.h"
+#include "benchmarks/benchmark_report.h"
+#include "benchmarks/benchmark_worker.h"
+#include "core/fragment/append_only_arrow_fragment.h"
+#include "core/loader/append_only_arrow_fragment_loader.h"
+#include "core/loader/arrow_fragment_appender.h"
+
+#ifdef NETWORKX
+#include "folly/dynamic.h"
+
+#include "core/fragment/dynamic_fragment.h"
+#include "core/fragment/dynamic_projected_fragment.h"
+#include "proto/types.pb.h"
+#endif
+
+namespace gs {
+
+namespace benchmarks {
+
+using oid_t = vineyard::property_graph_types::OID_TYPE;
+using vid_t = vineyard::property_graph_types::VID_TYPE;
+
+/**
+ * @brief The edges replayed as the mutations, i.e., the lines of
+ * "src,dst,weight" of the edge file after the header, and the vertices, i.e.,
+ * the lines of "id,value" of the vertex file.
+ */
+struct Workload {
+  std::vector<oid_t> vertices;
+  std::vector<int64_t> vertex_values;
+  std::vector<oid_t> srcs;
+  std::vector<oid_t> dsts;
+  std::vector<int64_t> weights;
+  size_t batch_size = 100000;
+};
+
+void read_csv(const std::string& path,
+              const std::function<void(std::vector<std::string>&)>& func) {
+  std::ifstream in(path);
+  CHECK(in) << "Failed to open " << path;
+  std::string line;
+  std::vector<std::string> fields;
+  bool header = true;
+  while (std::getline(in, line)) {
+    if (header) {
+      header = false;
+      continue;
+    }
+    boost::split(fields, line, boost::is_any_of(","));
+    func(fields);
+  }
+}
+
+Workload read_workload(const std::string& efile, const std::string& vfile,
+                       size_t batch_size) {
+  Workload workload;
+  workload.batch_size = batch_size;
+  read_csv(vfile, [&workload](std::vector<std::string>& fields) {
+    workload.vertices.push_back(std::stoll(fields[0]));
+    workload.vertex_values.push_back(
+        fields.size() > 1 ? std::stoll(fields[1]) : 0);
+  });
+  read_csv(efile, [&workload](std::vector<std::string>& fields) {
+    workload.srcs.push_back(std::stoll(fields[0]));
+    workload.dsts.push_back(std::stoll(fields[1]));
+    workload.weights.push_back(fields.size() > 2 ? std::stoll(fields[2]) : 0);
+  });
+  return workload;
+}
+
+// the resident memory of the worker now, rather than the peak one, in KB
+int64_t current_rss_kb() {
+  int64_t pages = 0, resident = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> pages >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * @brief Times a phase of the mutations on all the workers, and logs the
+ * mutations per second by the slowest worker on the coordinator. The
+ * mutations of the phase are counted once, by the coordinator, if every
+ * worker applies the whole batch, or else by each worker of its own shard.
+ */
+class MutationTimer {
+ public:
+  MutationTimer(const grape::CommSpec& comm_spec, BenchmarkReport& report)
+      : comm_spec_(comm_spec), report_(report) {}
+
+  template <typename FUNC_T>
+  void Run(const std::string& name, int64_t mutations, bool sharded,
+           const FUNC_T& func) {
+    MPI_Barrier(comm_spec_.comm());
+    int64_t rss = current_rss_kb();
+    double t0 = grape::GetCurrentTime();
+    func();
+    MPI_Barrier(comm_spec_.comm());
+    double seconds = grape::GetCurrentTime() - t0, max_seconds = 0;
+    int64_t rss_growth = current_rss_kb() - rss;
+    MPI_Allreduce(&seconds, &max_seconds, 1, MPI_DOUBLE, MPI_MAX,
+                  comm_spec_.comm());
+    bool is_coordinator = comm_spec_.worker_id() == grape::kCoordinatorRank;
+    if (!sharded && !is_coordinator) {
+      mutations = 0;
+    }
+    int64_t total_mutations = 0, total_rss_growth = 0;
+    MPI_Allreduce(&mutations, &total_mutations, 1, MPI_INT64_T, MPI_SUM,
+                  comm_spec_.comm());
+    MPI_Allreduce(&rss_growth, &total_rss_growth, 1, MPI_INT64_T, MPI_SUM,
+                  comm_spec_.comm());
+
+    report_.AddPhase(name, seconds);
+    report_.AddCounter(name + "_mutations", mutations);
+    report_.AddCounter(name + "_rss_growth_kb", rss_growth);
+    if (is_coordinator) {
+      LOG(INFO) << "[" << name << "]: " << total_mutations << " mutations in "
+                << max_seconds << "s, "
+                << (max_seconds > 0 ? total_mutations / max_seconds : 0)
+                << " per second, rss growth " << total_rss_growth << " KB"
+                << (total_mutations > 0
+                        ? ", " + std::to_string(total_rss_growth * 1e6 /
+                                                total_mutations) +
+                              " KB per million"
+                        : "");
+    }
+  }
+
+ private:
+  const grape::CommSpec& comm_spec_;
+  BenchmarkReport& report_;
+};
+
+// runs the app on the fragment by the benchmark worker, which adds the
+// rounds to the report, and times the query as the phase of the name
+template <typename APP_T>
+void run_app(const std::string& name,
+             std::shared_ptr<typename APP_T::fragment_t> fragment,
+             const grape::CommSpec& comm_spec, BenchmarkReport& report) {
+  auto app = std::make_shared<APP_T>();
+  BenchmarkWorker<APP_T> worker(app, fragment, report);
+  worker.Init(comm_spec, grape::DefaultParallelEngineSpec());
+  double t0 = grape::GetCurrentTime();
+  worker.Query();
+  report.AddPhase(name, grape::GetCurrentTime() - t0);
+  worker.Finalize();
+}
+
+#ifdef NETWORKX
+using DynamicProjectedFragmentType = DynamicProjectedFragment<int64_t, int64_t>;
+
+/**
+ * @brief Builds a DynamicFragment by ModifyVertices and ModifyEdges in
+ * batches, updates and deletes a batch of the edges, copies it by CopyFrom
+ * and ToDirectedFrom, i.e., CopyGraph and ToDirected of the wrapper, and runs
+ * WCC on its projection after the additions and after the deletions. The
+ * batches are applied on every worker, as the engine broadcasts them, and
+ * the lines are parsed up front, so the parsing is not timed.
+ */
+void run_dynamic(const Workload& workload, bool directed,
+                 const grape::CommSpec& comm_spec, BenchmarkReport& report) {
+  using vertex_map_t = DynamicFragment::vertex_map_t;
+  auto vm_ptr = std::shared_ptr<vertex_map_t>(new vertex_map_t(comm_spec));
+  vm_ptr->Init();
+  auto fragment = std::make_shared<DynamicFragment>(vm_ptr);
+  fragment->Init(comm_spec.fid(), directed);
+  MutationTimer timer(comm_spec, report);
+  size_t batch_size = workload.batch_size;
+
+  timer.Run("dynamic_add_vertices", workload.vertices.size(), false, [&]() {
+    std::vector<folly::dynamic> oids, vdatas;
+    for (size_t begin = 0; begin < workload.vertices.size();
+         begin += batch_size) {
+      size_t end = std::min(begin + batch_size, workload.vertices.size());
+      oids.clear();
+      vdatas.clear();
+      for (size_t i = begin; i < end; ++i) {
+        oids.emplace_back(workload.vertices[i]);
+        vdatas.push_back(
+            folly::dynamic::object("value", workload.vertex_values[i]));
+      }
+      fragment->ModifyVertices(oids, vdatas, rpc::NX_ADD_NODES);
+    }
+  });
+
+  auto modify_edges = [&](size_t begin, size_t end, int64_t weight_delta,
+                          rpc::ModifyType type) {
+    std::vector<folly::dynamic> srcs, dsts, edatas;
+    for (size_t batch = begin; batch < end; batch += batch_size) {
+      size_t batch_end = std::min(batch + batch_size, end);
+      srcs.clear();
+      dsts.clear();
+      edatas.clear();
+      for (size_t i = batch; i < batch_end; ++i) {
+        srcs.emplace_back(workload.srcs[i]);
+        dsts.emplace_back(workload.dsts[i]);
+        edatas.push_back(folly::dynamic::object(
+            "weight", workload.weights[i] + weight_delta));
+      }
+      fragment->ModifyEdges(srcs, dsts, edatas, type);
+    }
+  };
+  size_t edge_num = workload.srcs.size();
+  timer.Run("dynamic_add_edges", edge_num, false,
+            [&]() { modify_edges(0, edge_num, 0, rpc::NX_ADD_EDGES); });
+  run_app<WCC<DynamicProjectedFragmentType>>(
+      "dynamic_wcc_after_add",
+      DynamicProjectedFragmentType::Project(fragment, "value", "weight"),
+      comm_spec, report);
+
+  // the last batch of the edges is updated and then deleted
+  size_t tail = edge_num - std::min(edge_num, batch_size);
+  timer.Run("dynamic_update_edges", edge_num - tail, false,
+            [&]() { modify_edges(tail, edge_num, 1, rpc::NX_UPDATE_EDGES); });
+
+  timer.Run("dynamic_copy_graph", fragment->GetEdgeNum(), true, [&]() {
+    auto copy = std::make_shared<DynamicFragment>(fragment->GetVertexMap());
+    copy->CopyFrom(fragment, "identical");
+  });
+  if (!directed) {
+    timer.Run("dynamic_to_directed", fragment->GetEdgeNum(), true, [&]() {
+      auto copy = std::make_shared<DynamicFragment>(fragment->GetVertexMap());
+      copy->ToDirectedFrom(fragment);
+    });
+  }
+
+  timer.Run("dynamic_delete_edges", edge_num - tail, false,
+            [&]() { modify_edges(tail, edge_num, 0, rpc::NX_DEL_EDGES); });
+  run_app<WCC<DynamicProjectedFragmentType>>(
+      "dynamic_wcc_after_delete",
+      DynamicProjectedFragmentType::Project(fragment, "value", "weight"),
+      comm_spec, report);
+}
+#endif
+
+/**
+ * @brief Loads an AppendOnlyArrowFragment from the files of the prefixes,
+ * see AppendOnlyArrowFragmentLoader, and appends the edges of the workload to
+ * it in batches by ArrowFragmentAppender, each worker its own shard of each
+ * batch, timing an incremental WCC after each batch. The memory of the
+ * sealed chunks is in vineyard, so the growth of the rss of the workers is
+ * of the unsealed edges and the indices only.
+ */
+void run_append(const Workload& workload, bool directed,
+                const std::string& ipc_socket, const std::string& efile_prefix,
+                const std::string& vfile_prefix,
+                const grape::CommSpec& comm_spec, BenchmarkReport& report) {
+  using fragment_t = AppendOnlyArrowFragment<oid_t, vid_t>;
+  vineyard::Client client;
+  VINEYARD_CHECK_OK(client.Connect(ipc_socket));
+
+  double t0 = grape::GetCurrentTime();
+  AppendOnlyArrowFragmentLoader<oid_t, vid_t> loader(
+      client, comm_spec, 1, 1, efile_prefix, vfile_prefix, directed);
+  auto fragment_id = boost::leaf::try_handle_all(
+      [&loader]() { return loader.LoadFragment(); },
+      [](const vineyard::GSError& e) {
+        LOG(FATAL) << "Failed to load fragment: " << e.error_msg;
+        return vineyard::ObjectID(0);
+      },
+      [](const boost::leaf::error_info& unmatched) {
+        LOG(FATAL) << "Unmatched error " << unmatched;
+        return vineyard::ObjectID(0);
+      });
+  auto fragment =
+      std::dynamic_pointer_cast<fragment_t>(client.GetObject(fragment_id));
+  report.AddPhase("append_load", grape::GetCurrentTime() - t0);
+
+  grape::CommSpec appender_comm_spec = comm_spec;
+  ArrowFragmentAppender<oid_t, vid_t> appender(appender_comm_spec, fragment);
+  auto app = std::make_shared<WCCPropertyAppend<fragment_t>>();
+  app->set_incremental(true);
+  auto worker = WCCPropertyAppend<fragment_t>::CreateWorker(app, fragment);
+  worker->Init(comm_spec, grape::DefaultParallelEngineSpec());
+  t0 = grape::GetCurrentTime();
+  worker->Query();
+  report.AddPhase("append_wcc_initial", grape::GetCurrentTime() - t0);
+
+  MutationTimer timer(comm_spec, report);
+  size_t edge_num = workload.srcs.size();
+  int worker_id = comm_spec.worker_id(), worker_num = comm_spec.worker_num();
+  int batch_id = 0;
+  for (size_t begin = 0; begin < edge_num;
+       begin += workload.batch_size, ++batch_id) {
+    size_t end = std::min(begin + workload.batch_size, edge_num);
+    // "src,dst,src_label,dst_label,weight", of which the labels are dropped
+    std::vector<std::vector<std::string>> vertex_messages;
+    std::vector<std::vector<std::string>> edge_messages(1);
+    for (size_t i = begin + worker_id; i < end; i += worker_num) {
+      edge_messages[0].push_back(std::to_string(workload.srcs[i]) + "," +
+                                 std::to_string(workload.dsts[i]) + ",0,0," +
+                                 std::to_string(workload.weights[i]));
+    }
+    std::string name = "append_batch_" + std::to_string(batch_id);
+    timer.Run(name, edge_messages[0].size(), true, [&]() {
+      boost::leaf::try_handle_all(
+          [&]() {
+            return appender.ExtendFragment(vertex_messages, edge_messages,
+                                           false, ',', directed);
+          },
+          [](const vineyard::GSError& e) {
+            LOG(FATAL) << e.error_msg;
+            return int64_t(0);
+          },
+          [](const boost::leaf::error_info& unmatched) {
+            LOG(FATAL) << "Unmatched error " << unmatched;
+            return int64_t(0);
+          });
+    });
+    t0 = grape::GetCurrentTime();
+    worker->Query();
+    report.AddPhase(name + "_wcc", grape::GetCurrentTime() - t0);
+  }
+  worker->Finalize();
+}
+
+}  // namespace benchmarks
+
+}  // namespace gs
+
+int main(int argc, char** argv) {
+  if (argc < 5) {
+    printf(
+        "usage: ./mutation_benchmarks <efile> <vfile> <directed> <batch_size> "
+        "[<ipc_socket> <append_efile_prefix> <append_vfile_prefix>]\n");
+    return 1;
+  }
+  using namespace gs::benchmarks;  // NOLINT(build/namespaces)
+  std::string efile = argv[1];
+  std::string vfile = argv[2];
+  bool directed = atoi(argv[3]) != 0;
+  size_t batch_size = std::max(atol(argv[4]), 1L);
+
+  grape::InitMPIComm();
+  {
+    grape::CommSpec comm_spec;
+    comm_spec.Init(MPI_COMM_WORLD);
+    BenchmarkReport report(comm_spec, "mutations", efile);
+    auto workload = read_workload(efile, vfile, batch_size);
+
+#ifdef NETWORKX
+    run_dynamic(workload, directed, comm_spec, report);
+#endif
+    if (argc >= 8) {
+      run_append(workload, directed, argv[5], argv[6], argv[7], comm_spec,
+                 report);
+    }
+
+    MPI_Barrier(comm_spec.comm());
+    report.Write();
+  }
+  grape::FinalizeMPIComm();
+  return 0;
+}
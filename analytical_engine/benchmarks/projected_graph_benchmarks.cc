@@ -25,10 +25,15 @@
 #include "vineyard/client/client.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "apps/projected/wcc_afforest.h"
+#include "apps/projected/wcc_rma.h"
+#include "apps/scc/scc.h"
 #include "benchmarks/apps/bfs/bfs.h"
 #include "benchmarks/apps/pagerank/pagerank.h"
 #include "benchmarks/apps/sssp/sssp.h"
 #include "benchmarks/apps/wcc/wcc.h"
+#include "benchmarks/benchmark_report.h"
+#include "benchmarks/benchmark_worker.h"
 #include "core/fragment/arrow_projected_fragment.h"
 #include "core/loader/arrow_fragment_loader.h"
 #include "core/utils/transform_utils.h"
@@ -45,18 +50,30 @@ using EDProjectedGraphType =
 
 template <typename GRAPH_T, typename APP_T, typename... Args>
 void RunApp(std::shared_ptr<GRAPH_T> fragment, const grape::CommSpec& comm_spec,
+            gs::benchmarks::BenchmarkReport& report,
             const grape::ParallelEngineSpec& parallel_spec,
             const std::string& out_prefix, Args... args) {
   auto app = std::make_shared<APP_T>();
 
-  auto worker = APP_T::CreateWorker(app, fragment);
+  auto worker =
+      std::make_shared<gs::benchmarks::BenchmarkWorker<APP_T>>(app, fragment,
+                                                               report);
   worker->Init(comm_spec, parallel_spec);
   double t0 = grape::GetCurrentTime();
   worker->Query(std::forward<Args>(args)...);
   double t1 = grape::GetCurrentTime();
+  report.AddPhase("query", t1 - t0);
+  // the order of the inner vertices is given by property_graph_loader, so
+  // the query times of the orders are compared on the same graph
+  std::string vertex_order = "none";
+  if (fragment->meta().HasKey("vertex_order")) {
+    vertex_order = fragment->meta().GetKeyValue("vertex_order");
+  }
   LOG(INFO) << "[worker-" << comm_spec.worker_id()
-            << "]: Query time: " << t1 - t0;
+            << "]: Query time: " << t1 - t0
+            << ", vertex order: " << vertex_order;
 
+  t0 = grape::GetCurrentTime();
   std::ofstream ostream;
   std::string output_path =
       grape::GetResultFilename(out_prefix, fragment->fid());
@@ -64,6 +81,7 @@ void RunApp(std::shared_ptr<GRAPH_T> fragment, const grape::CommSpec& comm_spec,
   worker->Output(ostream);
   ostream.close();
   worker->Finalize();
+  report.AddPhase("output", grape::GetCurrentTime() - t0);
 }
 
 int main(int argc, char** argv) {
@@ -94,6 +112,7 @@ int main(int argc, char** argv) {
   MPI_Barrier(comm_spec.comm());
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(comm_spec, app_name, frag_id_str);
 
   if (app_name == "bfs") {
     CHECK_GE(argc, basic_argc + 1);
@@ -104,7 +123,8 @@ int main(int argc, char** argv) {
 
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::BFS<EmptyProjectedGraphType>>(
-        projected_fragment, comm_spec, parallel_spec, "./output_pb_bfs/",
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_bfs/",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "sssp") {
     CHECK_GE(argc, basic_argc + 1);
@@ -114,7 +134,8 @@ int main(int argc, char** argv) {
             client.GetObject(fragment_id));
 
     RunApp<EDProjectedGraphType, gs::benchmarks::SSSP<EDProjectedGraphType>>(
-        projected_fragment, comm_spec, parallel_spec, "./output_pb_sssp/",
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_sssp/",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     std::shared_ptr<EmptyProjectedGraphType> projected_fragment =
@@ -123,7 +144,32 @@ int main(int argc, char** argv) {
 
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::WCC<EmptyProjectedGraphType>>(
-        projected_fragment, comm_spec, parallel_spec, "./output_pb_wcc/");
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_wcc/");
+  } else if (app_name == "wcc_afforest") {
+    std::shared_ptr<EmptyProjectedGraphType> projected_fragment =
+        std::dynamic_pointer_cast<EmptyProjectedGraphType>(
+            client.GetObject(fragment_id));
+
+    RunApp<EmptyProjectedGraphType, gs::WCCAfforest<EmptyProjectedGraphType>>(
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_wcc_afforest/");
+  } else if (app_name == "wcc_rma") {
+    std::shared_ptr<EmptyProjectedGraphType> projected_fragment =
+        std::dynamic_pointer_cast<EmptyProjectedGraphType>(
+            client.GetObject(fragment_id));
+
+    RunApp<EmptyProjectedGraphType, gs::WCCRMA<EmptyProjectedGraphType>>(
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_wcc_rma/");
+  } else if (app_name == "scc") {
+    std::shared_ptr<EmptyProjectedGraphType> projected_fragment =
+        std::dynamic_pointer_cast<EmptyProjectedGraphType>(
+            client.GetObject(fragment_id));
+
+    RunApp<EmptyProjectedGraphType, gs::SCC<EmptyProjectedGraphType>>(
+        projected_fragment, comm_spec, report, parallel_spec,
+        "./output_pb_scc/");
   } else if (app_name == "pr") {
     CHECK_GE(argc, basic_argc + 2);
     std::string delta = argv[basic_argc];
@@ -134,12 +180,13 @@ int main(int argc, char** argv) {
 
     RunApp<EmptyProjectedGraphType,
            gs::benchmarks::PageRank<EmptyProjectedGraphType>>(
-        projected_fragment, comm_spec, parallel_spec, "./output_pb_pr/",
+        projected_fragment, comm_spec, report, parallel_spec, "./output_pb_pr/",
         boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
   }
 
   MPI_Barrier(comm_spec.comm());
+  report.Write();
 
   grape::FinalizeMPIComm();
   return 0;
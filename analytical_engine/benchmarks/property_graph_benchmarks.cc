@@ -15,11 +15,14 @@
 
 #include <stdio.h>
 
+#include <chrono>
 #include <fstream>
 #include <string>
 
+#include "gflags/gflags.h"
 #include "glog/logging.h"
 
+#include "arrow/util/compression.h"
 #include "grape/grape.h"
 #include "grape/util.h"
 #include "vineyard/client/client.h"
@@ -29,9 +32,27 @@
 #include "benchmarks/apps/pagerank/property_pagerank.h"
 #include "benchmarks/apps/sssp/property_sssp.h"
 #include "benchmarks/apps/wcc/property_wcc.h"
+#include "benchmarks/benchmark_report.h"
+#include "benchmarks/benchmark_worker.h"
 #include "core/loader/arrow_fragment_loader.h"
 #include "core/utils/transform_utils.h"
 
+DEFINE_string(message_compression, "uncompressed",
+              "the arrow codec to compress the messages to other workers, "
+              "e.g., lz4 or zstd");
+DEFINE_int64(compress_threshold, 4096,
+             "the messages smaller than this many bytes are not compressed");
+DEFINE_bool(hierarchical_routing, false,
+            "route the messages to other hosts through a proxy on each host");
+DEFINE_int64(routing_flush_bytes, 2 * 1023 * 1024,
+             "the size at which the aggregated messages to a host are sent");
+DEFINE_int32(routing_hosts, 0,
+             "if positive, group the workers into this many hosts for the "
+             "routing instead of by the memory they share");
+DEFINE_int64(flush_interval_us, 0,
+             "flush the partial message blocks held for longer than this "
+             "many microseconds, 0 disables it");
+
 using GraphType =
     vineyard::ArrowFragment<vineyard::property_graph_types::OID_TYPE,
                             vineyard::property_graph_types::VID_TYPE>;
@@ -39,18 +60,41 @@ using GraphType =
 template <typename APP_T, typename... Args>
 void RunApp(std::shared_ptr<GraphType> fragment,
             const grape::CommSpec& comm_spec,
+            gs::benchmarks::BenchmarkReport& report,
             const grape::ParallelEngineSpec& parallel_spec,
             const std::string& out_prefix, Args... args) {
   auto app = std::make_shared<APP_T>();
 
-  auto worker = APP_T::CreateWorker(app, fragment);
+  auto worker =
+      std::make_shared<gs::benchmarks::BenchmarkWorker<APP_T>>(app, fragment,
+                                                               report);
   worker->Init(comm_spec, parallel_spec);
+  auto& messages = worker->GetMessageManager();
+  auto compression =
+      arrow::util::Codec::GetCompressionType(FLAGS_message_compression);
+  CHECK(compression.ok()) << compression.status().ToString();
+  messages.SetCompression(*compression, FLAGS_compress_threshold);
+  messages.SetFlushInterval(std::chrono::microseconds(FLAGS_flush_interval_us));
+  if (FLAGS_hierarchical_routing) {
+    messages.EnableHierarchicalRouting(FLAGS_routing_flush_bytes,
+                                       FLAGS_routing_hosts);
+  }
   double t0 = grape::GetCurrentTime();
   worker->Query(std::forward<Args>(args)...);
   double t1 = grape::GetCurrentTime();
+  report.AddPhase("query", t1 - t0);
+  // the ratio of the compression is the one of the sums of the workers
+  int64_t raw_bytes = 0, wire_bytes = 0;
+  for (auto& stats : messages.GetRoundStats().rounds()) {
+    raw_bytes += stats.raw_bytes;
+    wire_bytes += stats.wire_bytes;
+  }
+  report.AddCounter("message_raw_bytes", raw_bytes);
+  report.AddCounter("message_wire_bytes", wire_bytes);
   LOG(INFO) << "[worker-" << comm_spec.worker_id()
             << "]: Query time: " << t1 - t0;
 
+  t0 = grape::GetCurrentTime();
   std::ofstream ostream;
   std::string output_path =
       grape::GetResultFilename(out_prefix, fragment->fid());
@@ -58,9 +102,11 @@ void RunApp(std::shared_ptr<GraphType> fragment,
   worker->Output(ostream);
   ostream.close();
   worker->Finalize();
+  report.AddPhase("output", grape::GetCurrentTime() - t0);
 }
 
 int main(int argc, char** argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
   grape::InitMPIComm();
   grape::CommSpec comm_spec;
   comm_spec.Init(MPI_COMM_WORLD);
@@ -69,8 +115,8 @@ int main(int argc, char** argv) {
 
   if (argc < basic_argc) {
     printf(
-        "usage: ./property_graph_benchmarks <ipc_socket> <app> <frag_0> ... "
-        "<frag_n-1> [query_args]\n");
+        "usage: ./property_graph_benchmarks [flags] <ipc_socket> <app> "
+        "<frag_0> ... <frag_n-1> [query_args]\n");
     return 1;
   }
 
@@ -91,33 +137,35 @@ int main(int argc, char** argv) {
       std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
 
   auto parallel_spec = grape::DefaultParallelEngineSpec();
+  gs::benchmarks::BenchmarkReport report(comm_spec, app_name, frag_id_str);
 
   if (app_name == "bfs") {
     CHECK_GE(argc, basic_argc + 1);
     std::string root = argv[basic_argc];
     RunApp<gs::benchmarks::PropertyBFS<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_bfs/",
+        fragment, comm_spec, report, parallel_spec, "./output_pp_bfs/",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "sssp") {
     CHECK_GE(argc, basic_argc + 1);
     std::string root = argv[basic_argc];
     RunApp<gs::benchmarks::PropertySSSP<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_sssp/",
+        fragment, comm_spec, report, parallel_spec, "./output_pp_sssp/",
         boost::lexical_cast<vineyard::property_graph_types::OID_TYPE>(root));
   } else if (app_name == "wcc") {
     RunApp<gs::benchmarks::PropertyWCC<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_wcc/");
+        fragment, comm_spec, report, parallel_spec, "./output_pp_wcc/");
   } else if (app_name == "pr") {
     CHECK_GE(argc, basic_argc + 2);
     std::string delta = argv[basic_argc];
     std::string max_round = argv[basic_argc + 1];
     RunApp<gs::benchmarks::PropertyPageRank<GraphType>>(
-        fragment, comm_spec, parallel_spec, "./output_pp_pr/",
+        fragment, comm_spec, report, parallel_spec, "./output_pp_pr/",
         boost::lexical_cast<double>(delta),
         boost::lexical_cast<int>(max_round));
   }
 
   MPI_Barrier(comm_spec.comm());
+  report.Write();
 
   grape::FinalizeMPIComm();
   return 0;
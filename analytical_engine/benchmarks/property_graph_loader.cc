@@ -25,6 +25,7 @@
 #include "vineyard/client/client.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "benchmarks/benchmark_report.h"
 #include "core/fragment/arrow_projected_fragment.h"
 #include "core/loader/arrow_fragment_loader.h"
 #include "core/utils/transform_utils.h"
@@ -71,7 +72,7 @@ int main(int argc, char** argv) {
   if (argc < 6) {
     printf(
         "usage: ./property_graph_loader <ipc_socket> <e_label_num> <efiles...> "
-        "<v_label_num> <vfiles...> [directed]\n");
+        "<v_label_num> <vfiles...> [directed] [vertex_order]\n");
     return 1;
   }
   int index = 1;
@@ -91,7 +92,12 @@ int main(int argc, char** argv) {
 
   int directed = 1;
   if (argc > index) {
-    directed = atoi(argv[index]);
+    directed = atoi(argv[index++]);
+  }
+  // none, degree, bfs or rcm, the order to traverse the projected fragments
+  std::string vertex_order = "none";
+  if (argc > index) {
+    vertex_order = argv[index++];
   }
 
   grape::InitMPIComm();
@@ -103,8 +109,11 @@ int main(int argc, char** argv) {
 
   LOG(INFO) << "Connected to IPCServer: " << ipc_socket;
 
+  gs::benchmarks::BenchmarkReport report(comm_spec, "loader",
+                                         efiles.empty() ? "" : efiles[0]);
   vineyard::ObjectID fragment_id;
   {
+    double t0 = grape::GetCurrentTime();
     auto loader = std::make_unique<
         gs::ArrowFragmentLoader<vineyard::property_graph_types::OID_TYPE,
                                 vineyard::property_graph_types::VID_TYPE>>(
@@ -119,6 +128,20 @@ int main(int argc, char** argv) {
           LOG(FATAL) << "Unmatched error " << unmatched;
           return 0;
         });
+    report.AddPhase("load", grape::GetCurrentTime() - t0);
+
+    // the phases of the loader, of which the times are the maxima of the
+    // workers in the report, and the ones of each worker are logged
+    auto& profile = loader->GetLoadProfile();
+    for (auto const& phase : profile.phases()) {
+      report.AddPhase(phase.name, phase.wall_time);
+      report.AddCounter(phase.name + "_cpu_ms",
+                        static_cast<int64_t>(phase.cpu_time * 1000));
+      report.AddCounter(phase.name + "_rows", phase.rows);
+      report.AddCounter(phase.name + "_bytes", phase.bytes);
+    }
+    LOG(INFO) << "[worker-" << comm_spec.worker_id()
+              << "]: load profile: " << profile.ToJSON();
   }
 
   if (comm_spec.worker_id() == 0) {
@@ -133,9 +156,13 @@ int main(int argc, char** argv) {
       std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
 
   vineyard::ObjectID empty_frag_id =
-      EmptyProjectedGraphType::Project(fragment, "0", "-1", "0", "-1")->id();
+      EmptyProjectedGraphType::Project(fragment, "0", "-1", "0", "-1",
+                                       vertex_order)
+          ->id();
   vineyard::ObjectID ed_frag_id =
-      EDProjectedGraphType::Project(fragment, "0", "-1", "0", "0")->id();
+      EDProjectedGraphType::Project(fragment, "0", "-1", "0", "0",
+                                    vertex_order)
+          ->id();
 
   if (comm_spec.worker_id() == 0) {
     LOG(INFO) << "[empty graph ids]:";
@@ -151,6 +178,7 @@ int main(int argc, char** argv) {
             << "]: " << vineyard::ObjectIDToString(ed_frag_id);
 
   MPI_Barrier(comm_spec.comm());
+  report.Write();
 
   grape::FinalizeMPIComm();
   return 0;
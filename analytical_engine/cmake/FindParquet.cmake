@@ -0,0 +1,30 @@
+# This file is used to find the Parquet library of Arrow, and the ORC adapter
+# in the Arrow library, in CMake script, which should be included after
+# FindArrow.cmake.
+#
+# The following are set after configuration is done:
+#  PARQUET_FOUND
+#  PARQUET_LIBRARIES
+#  ARROW_ORC_FOUND
+
+include(FindPackageHandleStandardArgs)
+
+find_library(PARQUET_LIBRARY parquet
+             HINTS ${ARROW_LIB_DIR}
+             PATH_SUFFIXES ${ARROW_SEARCH_LIB_PATH_SUFFIXES})
+find_path(PARQUET_INCLUDE_DIR parquet/arrow/reader.h
+          HINTS ${ARROW_INCLUDE_DIR})
+
+find_package_handle_standard_args(PARQUET DEFAULT_MSG PARQUET_INCLUDE_DIR PARQUET_LIBRARY)
+
+if(PARQUET_FOUND)
+    set(PARQUET_LIBRARIES ${PARQUET_LIBRARY})
+    message(STATUS "Found parquet (include: ${PARQUET_INCLUDE_DIR}, library: ${PARQUET_LIBRARIES})")
+    mark_as_advanced(PARQUET_LIBRARY PARQUET_INCLUDE_DIR)
+endif()
+
+if(EXISTS "${ARROW_INCLUDE_DIR}/arrow/adapters/orc/adapter.h")
+    set(ARROW_ORC_FOUND TRUE)
+else()
+    set(ARROW_ORC_FOUND FALSE)
+endif()
@@ -0,0 +1,108 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_APPEND_PROPERTY_APP_BASE_H_
+#define ANALYTICAL_ENGINE_CORE_APP_APPEND_PROPERTY_APP_BASE_H_
+
+#include <string>
+#include <vector>
+
+#include "grape/communication/communicator.h"
+
+#include "core/app/incremental_state.h"
+#include "core/app/property_app_base.h"
+
+namespace gs {
+
+/**
+ * @brief AppendPropertyAppBase is the base of the apps on
+ * AppendOnlyArrowFragment, which follow the edges appended by
+ * ArrowFragmentAppender as well as the loaded ones, and refresh the results
+ * of the last query from the appended edges, rather than recomputing from
+ * scratch.
+ *
+ * The apps save their results in EndQuery, and Resume them in PEval, which
+ * gives the endpoints of the edges appended since then. It is only correct
+ * for the monotone apps, e.g., WCC and SSSP, whose results only decrease as
+ * edges are appended, or the iterative ones to be warm started, e.g.,
+ * PageRank.
+ *
+ * @tparam FRAG_T
+ * @tparam CONTEXT_T
+ * @tparam VALUE_T The type of the results to be resumed.
+ */
+template <typename FRAG_T, typename CONTEXT_T, typename VALUE_T>
+class AppendPropertyAppBase : public PropertyAppBase<FRAG_T, CONTEXT_T>,
+                              public grape::Communicator {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using label_id_t = typename FRAG_T::label_id_t;
+  using vertex_array_t = typename FRAG_T::template vertex_array_t<VALUE_T>;
+
+ public:
+  /**
+   * @brief Recomputes from scratch if not incremental, e.g., to compare with.
+   * It should be the same on all of the workers.
+   */
+  void set_incremental(bool incremental) { incremental_ = incremental; }
+
+ protected:
+  /**
+   * @brief Visits the outgoing edges of e_label of v, both the loaded and the
+   * appended ones.
+   */
+  template <typename FUNC_T>
+  static void ForEachOutgoingEdge(const FRAG_T& frag, const vertex_t& v,
+                                  label_id_t e_label, const FUNC_T& func) {
+    for (auto& e : frag.GetOutgoingAdjList(v, e_label)) {
+      func(e);
+    }
+    for (auto& e : frag.GetExtraOutgoingAdjList(v, e_label)) {
+      func(e);
+    }
+  }
+
+  static size_t OutDegree(const FRAG_T& frag, const vertex_t& v) {
+    size_t degree = 0;
+    for (label_id_t j = 0; j < frag.edge_label_num(); ++j) {
+      degree += frag.GetLocalOutDegree(v, j) +
+                frag.GetExtraOutgoingAdjList(v, j).size();
+    }
+    return degree;
+  }
+
+  /**
+   * @brief Restores the results of the last query of key, and fills the
+   * endpoints of the edges appended since then. Returns false if the query
+   * has to be computed from scratch.
+   */
+  bool Resume(const FRAG_T& frag, const std::string& key,
+              std::vector<vertex_array_t>& values, std::vector<vertex_t>& srcs,
+              std::vector<vertex_t>& dsts) {
+    return incremental_ && state_.Resume(frag, key, *this, values, srcs, dsts);
+  }
+
+  void Save(const FRAG_T& frag, const std::string& key,
+            const std::vector<vertex_array_t>& values) {
+    state_.Save(frag, key, values);
+  }
+
+ private:
+  bool incremental_ = true;
+  LabeledIncrementalState<FRAG_T, VALUE_T> state_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_APPEND_PROPERTY_APP_BASE_H_
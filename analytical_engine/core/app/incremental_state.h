@@ -0,0 +1,273 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_STATE_H_
+#define ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_STATE_H_
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/communication/communicator.h"
+
+namespace gs {
+
+template <typename FRAG_T, typename = void>
+struct has_mutation_log : std::false_type {};
+
+template <typename FRAG_T>
+struct has_mutation_log<
+    FRAG_T, decltype(void(std::declval<const FRAG_T&>().mutation_log()))>
+    : std::true_type {};
+
+/**
+ * @brief IncrementalStates keeps the results of the inner vertices of the last
+ * runs of the incremental apps in the process, by the vertex labels and
+ * indexed by the offsets of the inner vertices, which are kept by the
+ * additions to the fragments. At most kCapacity states are kept, the least
+ * recently saved ones are dropped.
+ *
+ * @tparam VALUE_T
+ */
+template <typename VALUE_T>
+class IncrementalStates {
+ public:
+  struct State {
+    // the version of the mutation log when the results are saved
+    uint64_t version;
+    // by the vertex labels, a single one for the unlabeled fragments
+    std::vector<std::vector<VALUE_T>> values;
+  };
+
+  static constexpr size_t kCapacity = 8;
+
+  static IncrementalStates& Instance() {
+    static IncrementalStates instance;
+    return instance;
+  }
+
+  std::shared_ptr<const State> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    return iter == index_.end() ? nullptr : iter->second->second;
+  }
+
+  void Put(const std::string& key, std::shared_ptr<const State> state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      entries_.erase(iter->second);
+    }
+    entries_.emplace_front(key, std::move(state));
+    index_[key] = entries_.begin();
+    while (entries_.size() > kCapacity) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+ private:
+  using entry_t = std::pair<std::string, std::shared_ptr<const State>>;
+
+  std::mutex mutex_;
+  // the most recently saved first
+  std::list<entry_t> entries_;
+  std::unordered_map<std::string, typename std::list<entry_t>::iterator>
+      index_;
+};
+
+/**
+ * @brief IncrementalState resumes the results of a monotone app, e.g., WCC
+ * and SSSP, on a fragment with a mutation log, from the results of the last
+ * run and the edges added since then. The fragments without mutation logs
+ * are always computed from scratch.
+ *
+ * @tparam FRAG_T
+ * @tparam VALUE_T
+ */
+namespace incremental_state_impl {
+
+// the endpoints of the edges added to the fragment, in [begin, end) of the log
+template <typename FRAG_T>
+void added_endpoints(const FRAG_T& frag, size_t begin, size_t end,
+                     std::vector<typename FRAG_T::vertex_t>& srcs,
+                     std::vector<typename FRAG_T::vertex_t>& dsts) {
+  auto& edges = frag.mutation_log().added_edges();
+  for (size_t i = begin; i < end; ++i) {
+    typename FRAG_T::vertex_t u, v;
+    if (frag.Gid2Vertex(edges[i].first, u) &&
+        frag.Gid2Vertex(edges[i].second, v)) {
+      srcs.push_back(u);
+      dsts.push_back(v);
+    }
+  }
+}
+
+}  // namespace incremental_state_impl
+
+template <typename FRAG_T, typename VALUE_T, typename = void>
+class IncrementalState {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vertex_array_t = typename FRAG_T::template vertex_array_t<VALUE_T>;
+
+ public:
+  bool Resume(const FRAG_T&, const std::string&, grape::Communicator&,
+              vertex_array_t&, std::vector<vertex_t>&,
+              std::vector<vertex_t>&) {
+    return false;
+  }
+
+  void Save(const FRAG_T&, const std::string&, const vertex_array_t&) {}
+};
+
+template <typename FRAG_T, typename VALUE_T>
+class IncrementalState<FRAG_T, VALUE_T,
+                       typename std::enable_if<
+                           has_mutation_log<FRAG_T>::value>::type> {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vertex_array_t = typename FRAG_T::template vertex_array_t<VALUE_T>;
+  using states_t = IncrementalStates<VALUE_T>;
+
+ public:
+  /**
+   * @brief Restores the values of the inner vertices saved by the last run of
+   * the app of key, if all of the workers can, and fills the endpoints of the
+   * edges added since then, as the vertices to resume the computation from.
+   * The values of the new vertices are left as they are initialized.
+   */
+  bool Resume(const FRAG_T& frag, const std::string& key,
+              grape::Communicator& comm, vertex_array_t& values,
+              std::vector<vertex_t>& srcs, std::vector<vertex_t>& dsts) {
+    auto& log = frag.mutation_log();
+    auto state = states_t::Instance().Get(stateKey(frag, key));
+    size_t begin = 0, end = 0;
+    int resumable =
+        state != nullptr && log.AddedSince(state->version, begin, end);
+    int all_resumable;
+    comm.Min(resumable, all_resumable);
+    if (!all_resumable) {
+      return false;
+    }
+
+    auto& saved = state->values[0];
+    for (auto v : frag.InnerVertices()) {
+      auto lid = v.GetValue();
+      if (lid < saved.size()) {
+        values[v] = saved[lid];
+      }
+    }
+    incremental_state_impl::added_endpoints(frag, begin, end, srcs, dsts);
+    return true;
+  }
+
+  void Save(const FRAG_T& frag, const std::string& key,
+            const vertex_array_t& values) {
+    auto state = std::make_shared<typename states_t::State>();
+    state->version = frag.mutation_log().version();
+    size_t size = 0;
+    for (auto v : frag.InnerVertices()) {
+      size = std::max(size, static_cast<size_t>(v.GetValue()) + 1);
+    }
+    state->values.resize(1);
+    state->values[0].resize(size);
+    for (auto v : frag.InnerVertices()) {
+      state->values[0][v.GetValue()] = values[v];
+    }
+    states_t::Instance().Put(stateKey(frag, key), std::move(state));
+  }
+
+ private:
+  static std::string stateKey(const FRAG_T& frag, const std::string& key) {
+    return key + "/" + std::to_string(frag.mutation_log().uid()) + "/" +
+           frag.projection_key();
+  }
+};
+
+/**
+ * @brief LabeledIncrementalState is the IncrementalState of the apps on the
+ * labeled fragments with mutation logs, e.g., AppendOnlyArrowFragment, which
+ * keeps the values of the inner vertices of each vertex label.
+ *
+ * @tparam FRAG_T
+ * @tparam VALUE_T
+ */
+template <typename FRAG_T, typename VALUE_T>
+class LabeledIncrementalState {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using label_id_t = typename FRAG_T::label_id_t;
+  using vertex_array_t = typename FRAG_T::template vertex_array_t<VALUE_T>;
+  using states_t = IncrementalStates<VALUE_T>;
+
+ public:
+  bool Resume(const FRAG_T& frag, const std::string& key,
+              grape::Communicator& comm, std::vector<vertex_array_t>& values,
+              std::vector<vertex_t>& srcs, std::vector<vertex_t>& dsts) {
+    auto& log = frag.mutation_log();
+    auto state = states_t::Instance().Get(stateKey(frag, key));
+    label_id_t v_label_num = frag.vertex_label_num();
+    size_t begin = 0, end = 0;
+    int resumable = state != nullptr &&
+                    state->values.size() == static_cast<size_t>(v_label_num) &&
+                    log.AddedSince(state->version, begin, end);
+    int all_resumable;
+    comm.Min(resumable, all_resumable);
+    if (!all_resumable) {
+      return false;
+    }
+
+    for (label_id_t i = 0; i < v_label_num; ++i) {
+      auto& saved = state->values[i];
+      for (auto v : frag.InnerVertices(i)) {
+        auto offset = static_cast<size_t>(frag.vertex_offset(v));
+        if (offset < saved.size()) {
+          values[i][v] = saved[offset];
+        }
+      }
+    }
+    incremental_state_impl::added_endpoints(frag, begin, end, srcs, dsts);
+    return true;
+  }
+
+  void Save(const FRAG_T& frag, const std::string& key,
+            const std::vector<vertex_array_t>& values) {
+    auto state = std::make_shared<typename states_t::State>();
+    label_id_t v_label_num = frag.vertex_label_num();
+    state->version = frag.mutation_log().version();
+    state->values.resize(v_label_num);
+    for (label_id_t i = 0; i < v_label_num; ++i) {
+      auto& saved = state->values[i];
+      saved.resize(frag.GetInnerVerticesNum(i));
+      for (auto v : frag.InnerVertices(i)) {
+        saved[frag.vertex_offset(v)] = values[i][v];
+      }
+    }
+    states_t::Instance().Put(stateKey(frag, key), std::move(state));
+  }
+
+ private:
+  static std::string stateKey(const FRAG_T& frag, const std::string& key) {
+    return key + "/" + std::to_string(frag.mutation_log().uid());
+  }
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_INCREMENTAL_STATE_H_
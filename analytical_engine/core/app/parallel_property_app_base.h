@@ -34,6 +34,13 @@ class ParallelPropertyWorker;
  * send/receive messages during computation. This strategy improves performance
  * by overlapping the communication time and the evaluation time.
  *
+ * An app may also have an IncEvalPull of the same signature as IncEval, and
+ * an ActiveStats CountActive(graph, context) const, of the vertices and
+ * edges the next round would process. The worker then runs each round by
+ * IncEval, i.e., pushing along the out edges of the active vertices, or by
+ * IncEvalPull, i.e., pulling along the in edges of all the vertices, as
+ * decided by a PushPullSwitcher on the counts summed over the workers.
+ *
  * @tparam FRAG_T
  * @tparam CONTEXT_T
  */
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -43,6 +44,35 @@ enum PregelAggregatorType {
   kEmptyAggregator = 100,
 };
 
+namespace aggregator_impl {
+
+template <typename T, bool = std::is_arithmetic<T>::value>
+struct SlotValue {
+  static constexpr bool reducible = false;
+  static void Put(const T&, AggregatorSlot&) {}
+  static void Get(const AggregatorSlot&, T&) {}
+};
+
+template <typename T>
+struct SlotValue<T, true> {
+  static constexpr bool reducible = true;
+
+  static void Put(const T& value, AggregatorSlot& slot) {
+    slot.is_double = std::is_floating_point<T>::value;
+    if (slot.is_double) {
+      slot.d = static_cast<double>(value);
+    } else {
+      slot.i = static_cast<int64_t>(value);
+    }
+  }
+
+  static void Get(const AggregatorSlot& slot, T& value) {
+    value = slot.is_double ? static_cast<T>(slot.d) : static_cast<T>(slot.i);
+  }
+};
+
+}  // namespace aggregator_impl
+
 /**
  * @brief Aggregator is a base class for pregel program
  * @tparam AGGR_TYPE
@@ -86,9 +116,39 @@ class Aggregator : public IAggregator {
 
   std::shared_ptr<IAggregator> clone() override { return nullptr; }
 
+  void SaveState(grape::InArchive& arc) override {
+    arc << curr_value_ << last_value_;
+  }
+
+  void LoadState(grape::OutArchive& arc) override {
+    arc >> curr_value_ >> last_value_;
+  }
+
   std::string ToString() override { return std::to_string(curr_value_); }
 
+  bool Reducible() const override {
+    return slot_value_t::reducible && ReduceOp() != AggregatorSlot::kNone;
+  }
+
+  void ToSlot(AggregatorSlot& slot) override {
+    slot.op = ReduceOp();
+    slot_value_t::Put(curr_value_, slot);
+  }
+
+  void FromSlot(const AggregatorSlot& slot) override {
+    slot_value_t::Get(slot, curr_value_);
+  }
+
+ protected:
+  /**
+   * @brief The op of Aggregate in MPI_Allreduce, kNone if the aggregator
+   * must be synchronized by gathering.
+   */
+  virtual AggregatorSlot::Op ReduceOp() const { return AggregatorSlot::kNone; }
+
  private:
+  using slot_value_t = aggregator_impl::SlotValue<AGGR_TYPE>;
+
   // The global aggregated value are stored in `last_value_` variable,
   // which can be used in next compute step
   AGGR_TYPE curr_value_;
@@ -137,6 +197,14 @@ class Aggregator<std::string> : public IAggregator {
 
   std::shared_ptr<IAggregator> clone() override { return nullptr; }
 
+  void SaveState(grape::InArchive& arc) override {
+    arc << curr_value_ << last_value_;
+  }
+
+  void LoadState(grape::OutArchive& arc) override {
+    arc >> curr_value_ >> last_value_;
+  }
+
   std::string ToString() override { return curr_value_; }
 
  private:
@@ -0,0 +1,160 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_COMMUNICATOR_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_COMMUNICATOR_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/communication/communicator.h"
+#include "grape/serialization/in_archive.h"
+
+#include "core/app/pregel/i_vertex_program.h"
+
+namespace gs {
+
+namespace aggregator_impl {
+
+template <typename T>
+inline T ReduceValue(int32_t op, T lhs, T rhs) {
+  switch (op) {
+    case AggregatorSlot::kAnd:
+      return lhs && rhs;
+    case AggregatorSlot::kOr:
+      return lhs || rhs;
+    case AggregatorSlot::kMin:
+      return std::min(lhs, rhs);
+    case AggregatorSlot::kMax:
+      return std::max(lhs, rhs);
+    case AggregatorSlot::kSum:
+      return lhs + rhs;
+    case AggregatorSlot::kProduct:
+      return lhs * rhs;
+    default:
+      // kOverwrite keeps the value of the higher rank
+      return rhs;
+  }
+}
+
+// inout[i] = in[i] op inout[i], where in comes from the lower ranks
+inline void ReduceSlots(void* in, void* inout, int* len, MPI_Datatype*) {
+  auto* lhs = static_cast<AggregatorSlot*>(in);
+  auto* rhs = static_cast<AggregatorSlot*>(inout);
+  for (int i = 0; i < *len; ++i) {
+    if (rhs[i].is_double) {
+      rhs[i].d = ReduceValue(rhs[i].op, lhs[i].d, rhs[i].d);
+    } else {
+      rhs[i].i = ReduceValue(rhs[i].op, lhs[i].i, rhs[i].i);
+    }
+  }
+}
+
+}  // namespace aggregator_impl
+
+/**
+ * @brief AggregatorCommunicator is a grape::Communicator that synchronizes
+ * the aggregators of pregel apps once per superstep. The numeric and bool
+ * aggregators are packed into slots and reduced together by a single
+ * MPI_Allreduce, the others, i.e., the text ones, are gathered one by one.
+ *
+ * The op is not commutative, so the slots are reduced in the rank order,
+ * which keeps the overwrite aggregators with the value of the last worker
+ * and the floating point sums the same on all workers.
+ */
+class AggregatorCommunicator : public grape::Communicator {
+ public:
+  AggregatorCommunicator() = default;
+
+  ~AggregatorCommunicator() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized && slot_type_ != MPI_DATATYPE_NULL) {
+      MPI_Type_free(&slot_type_);
+      MPI_Op_free(&slot_op_);
+      MPI_Comm_free(&aggregator_comm_);
+    }
+  }
+
+  // hides the one of grape::Communicator, which is called by the workers
+  void InitCommunicator(MPI_Comm comm) {
+    grape::Communicator::InitCommunicator(comm);
+    if (slot_type_ == MPI_DATATYPE_NULL) {
+      MPI_Comm_dup(comm, &aggregator_comm_);
+      MPI_Type_contiguous(sizeof(AggregatorSlot), MPI_BYTE, &slot_type_);
+      MPI_Type_commit(&slot_type_);
+      MPI_Op_create(&aggregator_impl::ReduceSlots, 0, &slot_op_);
+    }
+  }
+
+  /**
+   * @brief Aggregates the current values of all workers and starts a new
+   * round of each aggregator. The aggregators are visited in the order of
+   * their names, which is the same on all workers.
+   */
+  void SyncAggregators(
+      std::unordered_map<std::string, std::shared_ptr<IAggregator>>&
+          aggregators) {
+    std::vector<std::pair<std::string, IAggregator*>> sorted;
+    for (auto& pair : aggregators) {
+      sorted.emplace_back(pair.first, pair.second.get());
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<IAggregator*> reducible;
+    std::vector<AggregatorSlot> slots;
+    for (auto& pair : sorted) {
+      auto* aggregator = pair.second;
+      if (aggregator->Reducible()) {
+        AggregatorSlot slot;
+        aggregator->ToSlot(slot);
+        reducible.push_back(aggregator);
+        slots.push_back(slot);
+      } else {
+        grape::InArchive iarc;
+        std::vector<grape::InArchive> oarcs;
+        aggregator->Serialize(iarc);
+        aggregator->Reset();
+        AllGather(std::move(iarc), oarcs);
+        aggregator->DeserializeAndAggregate(oarcs);
+      }
+    }
+    if (!slots.empty()) {
+      MPI_Allreduce(MPI_IN_PLACE, slots.data(), static_cast<int>(slots.size()),
+                    slot_type_, slot_op_, aggregator_comm_);
+      for (size_t i = 0; i < reducible.size(); ++i) {
+        reducible[i]->FromSlot(slots[i]);
+      }
+    }
+    for (auto& pair : sorted) {
+      pair.second->StartNewRound();
+    }
+  }
+
+ private:
+  MPI_Comm aggregator_comm_ = MPI_COMM_NULL;
+  MPI_Datatype slot_type_ = MPI_DATATYPE_NULL;
+  MPI_Op slot_op_ = MPI_OP_NULL;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_AGGREGATORS_AGGREGATOR_COMMUNICATOR_H_
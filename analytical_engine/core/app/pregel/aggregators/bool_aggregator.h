@@ -36,6 +36,9 @@ class BoolAndAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(true); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(true); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override { return AggregatorSlot::kAnd; }
 };
 
 /**
@@ -52,6 +55,9 @@ class BoolOrAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(false); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(false); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override { return AggregatorSlot::kOr; }
 };
 /**
  * @brief Pregel aggregator for bool type. The aggregator only keeps the last
@@ -66,6 +72,11 @@ class BoolOverwriteAggregator : public Aggregator<bool> {
   void Init() override { Aggregator<bool>::SetCurrentValue(false); }
 
   void Reset() override { Aggregator<bool>::SetCurrentValue(false); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override {
+    return AggregatorSlot::kOverwrite;
+  }
 };
 
 }  // namespace gs
@@ -45,6 +45,9 @@ class NumericMinAggregator : public Aggregator<AGGR_TYPE> {
     Aggregator<AGGR_TYPE>::SetCurrentValue(
         std::numeric_limits<AGGR_TYPE>::max());
   }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override { return AggregatorSlot::kMin; }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -68,6 +71,9 @@ class NumericMaxAggregator : public Aggregator<AGGR_TYPE> {
     Aggregator<AGGR_TYPE>::SetCurrentValue(
         std::numeric_limits<AGGR_TYPE>::min());
   }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override { return AggregatorSlot::kMax; }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -85,6 +91,9 @@ class NumericSumAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override { return AggregatorSlot::kSum; }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. The aggregator
@@ -102,6 +111,11 @@ class NumericProductAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(1); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(1); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override {
+    return AggregatorSlot::kProduct;
+  }
 };
 /**
  * @brief A pregel aggregator for the numeric data type. This aggregator only
@@ -118,6 +132,11 @@ class NumericOverwriteAggregator : public Aggregator<AGGR_TYPE> {
   void Init() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
 
   void Reset() override { Aggregator<AGGR_TYPE>::SetCurrentValue(0); }
+
+ protected:
+  AggregatorSlot::Op ReduceOp() const override {
+    return AggregatorSlot::kOverwrite;
+  }
 };
 
 }  // namespace gs
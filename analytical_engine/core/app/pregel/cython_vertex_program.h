@@ -43,9 +43,14 @@ class CythonPregelProgram
   typedef void (*ComputeFuncT)(pregel::MessageIterator<MD_TYPE>,
                                pregel::Vertex<VD_TYPE, MD_TYPE>&,
                                pregel::Context<VD_TYPE, MD_TYPE>&);
+  typedef void (*ComputeBatchFuncT)(pregel::VertexBatch<VD_TYPE, MD_TYPE>&,
+                                    pregel::Context<VD_TYPE, MD_TYPE>&);
 
  public:
-  CythonPregelProgram() : init_func_(NULL), compute_func_(NULL) {}
+  using vertex_batch_t = pregel::VertexBatch<VD_TYPE, MD_TYPE>;
+
+  CythonPregelProgram()
+      : init_func_(NULL), compute_func_(NULL), compute_batch_func_(NULL) {}
 
   void SetInitFunction(InitFuncT init_func) { init_func_ = init_func; }
 
@@ -53,6 +58,16 @@ class CythonPregelProgram
     compute_func_ = compute_func;
   }
 
+  /**
+   * @brief Lets the vertices be computed in batches by one call of the cython
+   * function, instead of one call per vertex.
+   */
+  void SetComputeBatchFunction(ComputeBatchFuncT compute_batch_func) {
+    compute_batch_func_ = compute_batch_func;
+  }
+
+  bool HasComputeBatch() const { return compute_batch_func_ != NULL; }
+
   inline void Init(pregel::Vertex<VD_TYPE, MD_TYPE>& v,
                    pregel::Context<VD_TYPE, MD_TYPE>& context) {
     init_func_(v, context);
@@ -64,9 +79,15 @@ class CythonPregelProgram
     compute_func_(messages, vertex, context);
   }
 
+  inline void ComputeBatch(vertex_batch_t& batch,
+                           pregel::Context<VD_TYPE, MD_TYPE>& context) {
+    compute_batch_func_(batch, context);
+  }
+
  private:
   InitFuncT init_func_;
   ComputeFuncT compute_func_;
+  ComputeBatchFuncT compute_batch_func_;
 };
 
 /**
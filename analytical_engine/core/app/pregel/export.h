@@ -48,6 +48,21 @@ using AdjList = gs::PregelPropertyAdjList<
                             vineyard::property_graph_types::VID_TYPE>,
     VD_T, MD_T>;
 
+template <typename VD_T, typename MD_T, typename DATA_T>
+using EdgeColumn = gs::PregelPropertyEdgeColumn<
+    vineyard::ArrowFragment<vineyard::property_graph_types::OID_TYPE,
+                            vineyard::property_graph_types::VID_TYPE>,
+    VD_T, MD_T, DATA_T>;
+
+template <typename VD_T, typename MD_T, typename DATA_T>
+using VertexColumn = gs::PregelPropertyVertexColumn<
+    vineyard::ArrowFragment<vineyard::property_graph_types::OID_TYPE,
+                            vineyard::property_graph_types::VID_TYPE>,
+    VD_T, MD_T, DATA_T>;
+
+template <typename VD_T, typename MD_T>
+using VertexBatch = gs::VertexBatch<Vertex<VD_T, MD_T>, VD_T, MD_T>;
+
 using gs::Aggregator;
 using gs::MessageIterator;
 using gs::PregelAggregatorType;
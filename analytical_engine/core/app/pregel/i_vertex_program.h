@@ -16,8 +16,11 @@
 #ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_I_VERTEX_PROGRAM_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "grape/grape.h"
@@ -30,6 +33,70 @@ namespace gs {
 template <typename MD_T>
 using MessageIterator = grape::IteratorPair<MD_T*>;
 
+/**
+ * @brief A batch of vertices handed to a batched vertex program in one call,
+ * e.g., a cython program, to amortize the cost of crossing into it. The
+ * messages of the vertices are kept in one contiguous buffer, and the values
+ * in a snapshot array, which set_value keeps up to date.
+ * @tparam PREGEL_VERTEX_T
+ * @tparam VD_T
+ * @tparam MD_T
+ */
+template <typename PREGEL_VERTEX_T, typename VD_T, typename MD_T>
+class VertexBatch {
+ public:
+  VertexBatch() : offsets_(1, 0) {}
+
+  size_t size() const { return vertices_.size(); }
+
+  bool empty() const { return vertices_.empty(); }
+
+  PREGEL_VERTEX_T& vertex(size_t i) { return vertices_[i]; }
+
+  const VD_T& value(size_t i) const { return values_[i]; }
+
+  void set_value(size_t i, const VD_T& value) {
+    values_[i] = value;
+    vertices_[i].set_value(value);
+  }
+
+  // the values of all vertices of the batch, e.g., for a numpy view
+  const VD_T* values() const { return values_.data(); }
+
+  MessageIterator<MD_T> messages(size_t i) {
+    return MessageIterator<MD_T>(messages_.data() + offsets_[i],
+                                 messages_.data() + offsets_[i + 1]);
+  }
+
+  // the messages of the i-th vertex are [offsets()[i], offsets()[i + 1]) of
+  // all_messages()
+  const size_t* offsets() const { return offsets_.data(); }
+
+  MD_T* all_messages() { return messages_.data(); }
+
+  void Append(const PREGEL_VERTEX_T& v, MessageIterator<MD_T> messages) {
+    vertices_.push_back(v);
+    values_.push_back(vertices_.back().value());
+    for (auto& msg : messages) {
+      messages_.push_back(std::move(msg));
+    }
+    offsets_.push_back(messages_.size());
+  }
+
+  void Clear() {
+    vertices_.clear();
+    values_.clear();
+    offsets_.resize(1);
+    messages_.clear();
+  }
+
+ private:
+  std::vector<PREGEL_VERTEX_T> vertices_;
+  std::vector<VD_T> values_;
+  std::vector<size_t> offsets_;
+  std::vector<MD_T> messages_;
+};
+
 template <typename FRAG_T, typename VD_T, typename MD_T>
 class PregelPropertyVertex;
 
@@ -66,6 +133,32 @@ class ICombinator {
   virtual MD_T CombineMessages(MessageIterator<MD_T> messages) = 0;
 };
 
+/**
+ * @brief The current value of a numeric or bool aggregator with the way to
+ * aggregate it, the slots of all aggregators are reduced together by one
+ * MPI_Allreduce of AggregatorCommunicator.
+ */
+struct AggregatorSlot {
+  enum Op : int32_t {
+    kNone = 0,
+    kAnd = 1,
+    kOr = 2,
+    kMin = 3,
+    kMax = 4,
+    kSum = 5,
+    kProduct = 6,
+    kOverwrite = 7,
+  };
+
+  int32_t op;
+  // whether the value is stored in d or i, bools are stored in i
+  int32_t is_double;
+  union {
+    int64_t i;
+    double d;
+  };
+};
+
 /**
  * @brief Aggregator interface for pregel program
  */
@@ -87,6 +180,24 @@ class IAggregator {
 
   virtual std::shared_ptr<IAggregator> clone() = 0;
 
+  /**
+   * @brief Whether the aggregator is synchronized by packing its current
+   * value into a slot, instead of gathering the serialized values.
+   */
+  virtual bool Reducible() const { return false; }
+
+  virtual void ToSlot(AggregatorSlot& slot) {}
+
+  virtual void FromSlot(const AggregatorSlot& slot) {}
+
+  /**
+   * @brief Writes the current and the aggregated values for a checkpoint,
+   * LoadState reads them back.
+   */
+  virtual void SaveState(grape::InArchive& arc) {}
+
+  virtual void LoadState(grape::OutArchive& arc) {}
+
   virtual std::string ToString() { return ""; }
 };
 
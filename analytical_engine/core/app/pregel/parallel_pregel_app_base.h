@@ -0,0 +1,272 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PARALLEL_PREGEL_APP_BASE_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PARALLEL_PREGEL_APP_BASE_H_
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+#include "grape/utils/iterator_pair.h"
+
+#include "core/app/app_base.h"
+#include "core/app/pregel/aggregators/aggregator_communicator.h"
+#include "core/app/pregel/pregel_checkpoint.h"
+#include "core/app/pregel/pregel_compute_context.h"
+#include "core/app/pregel/pregel_context.h"
+#include "core/parallel/thread_pool.h"
+
+namespace gs {
+
+namespace parallel_pregel_impl {
+
+template <typename COMBINATOR_T>
+struct CombinatorHolder {
+  static constexpr bool enabled = true;
+
+  CombinatorHolder() = default;
+  explicit CombinatorHolder(const COMBINATOR_T& cb) : combinator(cb) {}
+
+  template <typename COMPUTE_CONTEXT_T, typename VERTEX_T, typename SEND_FUNC_T>
+  void Combine(COMPUTE_CONTEXT_T& compute_context, const VERTEX_T& v, int tid,
+               const SEND_FUNC_T& send) {
+    compute_context.combine_messages(combinator, v, tid, send);
+  }
+
+  COMBINATOR_T combinator;
+};
+
+template <>
+struct CombinatorHolder<void> {
+  static constexpr bool enabled = false;
+
+  template <typename COMPUTE_CONTEXT_T, typename VERTEX_T, typename SEND_FUNC_T>
+  void Combine(COMPUTE_CONTEXT_T&, const VERTEX_T&, int, const SEND_FUNC_T&) {}
+};
+
+}  // namespace parallel_pregel_impl
+
+/**
+ * @brief ParallelPregelAppBase runs a pregel program as PregelAppBase does,
+ * but the Init and Compute of the vertices are run by the threads of the
+ * ParallelEngine. Each thread has its own PregelVertex handle, whose tid
+ * routes the messages to the pending buffers of the thread in the mailboxes
+ * of PregelComputeContext and the channels of the parallel message manager,
+ * and the combining and the placing of messages are parallel as well.
+ *
+ * The vertex program must be safe to call concurrently on different
+ * vertices, aggregate() is serialized by the compute context.
+ *
+ * @tparam FRAG_T
+ * @tparam VERTEX_PROGRAM_T
+ * @tparam COMBINATOR_T void for no combinator, the CombineMessages of it
+ * must be safe to call concurrently.
+ */
+template <typename FRAG_T, typename VERTEX_PROGRAM_T,
+          typename COMBINATOR_T = void>
+class ParallelPregelAppBase
+    : public grape::ParallelAppBase<
+          FRAG_T,
+          PregelContext<FRAG_T, PregelComputeContext<
+                                    FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
+                                    typename VERTEX_PROGRAM_T::md_t>>>,
+      public grape::ParallelEngine,
+      public AggregatorCommunicator {
+  using vd_t = typename VERTEX_PROGRAM_T::vd_t;
+  using md_t = typename VERTEX_PROGRAM_T::md_t;
+  using pregel_compute_context_t = PregelComputeContext<FRAG_T, vd_t, md_t>;
+  using pregel_vertex_t = PregelVertex<FRAG_T, vd_t, md_t>;
+
+  using app_t = ParallelPregelAppBase<FRAG_T, VERTEX_PROGRAM_T, COMBINATOR_T>;
+  using pregel_context_t = PregelContext<FRAG_T, pregel_compute_context_t>;
+  INSTALL_PARALLEL_WORKER(app_t, pregel_context_t, FRAG_T)
+
+ public:
+  explicit ParallelPregelAppBase(
+      const VERTEX_PROGRAM_T& program = VERTEX_PROGRAM_T())
+      : program_(program) {}
+
+  template <typename COMB_T = COMBINATOR_T,
+            typename = typename std::enable_if<
+                !std::is_void<COMB_T>::value>::type>
+  ParallelPregelAppBase(const VERTEX_PROGRAM_T& program,
+                        const COMB_T& combinator)
+      : program_(program), combinator_(combinator) {}
+
+  using vid_t = typename fragment_t::vid_t;
+
+  using vertex_t = typename fragment_t::vertex_t;
+
+  void PEval(const fragment_t& frag, pregel_context_t& ctx,
+             message_manager_t& messages) {
+    // superstep is 0 in PEval
+    int thrd_num = thread_num();
+    messages.InitChannels(thrd_num);
+    auto& compute_context = ctx.compute_context_;
+    if (combinator_holder_t::enabled) {
+      compute_context.enable_combine();
+    }
+    compute_context.set_thread_num(thrd_num);
+
+    auto inner_vertices = frag.InnerVertices();
+    ForEach(inner_vertices, [&frag, &compute_context, this](int tid,
+                                                            vertex_t v) {
+      pregel_vertex_t pregel_vertex;
+      setVertex(pregel_vertex, frag, compute_context, tid, v);
+      this->program_.Init(pregel_vertex, compute_context);
+    });
+
+    checkpoint_.Init(frag, compute_context);
+    if (checkpoint_.Resume(compute_context, *this)) {
+      // continues the superstep of the checkpoint
+      computeActive(frag, compute_context);
+      finishSuperstep(frag, compute_context, messages);
+      return;
+    }
+
+    grape::IteratorPair<md_t*> null_messages(nullptr, nullptr);
+    ForEach(inner_vertices, [&null_messages, &frag, &compute_context, this](
+                                int tid, vertex_t v) {
+      pregel_vertex_t pregel_vertex;
+      setVertex(pregel_vertex, frag, compute_context, tid, v);
+      this->program_.Compute(null_messages, pregel_vertex, compute_context);
+    });
+
+    finishSuperstep(frag, compute_context, messages);
+  }
+
+  void IncEval(const fragment_t& frag, pregel_context_t& ctx,
+               message_manager_t& messages) {
+    int thrd_num = thread_num();
+    auto& compute_context = ctx.compute_context_;
+    compute_context.inc_step();
+
+    {
+      // get messages, and place them with the ones sent by this fragment
+      messages.ParallelProcess<fragment_t, md_t>(
+          thrd_num, frag,
+          [&compute_context](int tid, vertex_t v, const md_t& msg) {
+            compute_context.inbox().Append(tid, v, msg);
+          });
+      auto& inbox = compute_context.inbox();
+      inbox.Build(runner());
+      thread_pool_.ParallelRun(
+          inbox.BucketNum(), [&compute_context, &inbox](int bucket) {
+            for (auto& v : inbox.Receivers(bucket)) {
+              compute_context.activate(v, bucket);
+            }
+          });
+      compute_context.merge_activated();
+    }
+    checkpoint_.Save(compute_context);
+
+    computeActive(frag, compute_context);
+
+    finishSuperstep(frag, compute_context, messages);
+  }
+
+ private:
+  using combinator_holder_t =
+      parallel_pregel_impl::CombinatorHolder<COMBINATOR_T>;
+
+  void computeActive(const fragment_t& frag,
+                     pregel_compute_context_t& compute_context) {
+    int thrd_num = thread_num();
+    auto compute = [&frag, &compute_context, this](int tid, vertex_t v) {
+      if (compute_context.active(v)) {
+        pregel_vertex_t pregel_vertex;
+        setVertex(pregel_vertex, frag, compute_context, tid, v);
+        this->program_.Compute(compute_context.get_messages(v), pregel_vertex,
+                               compute_context);
+      }
+    };
+    if (compute_context.dense_active()) {
+      ForEach(frag.InnerVertices(), compute);
+    } else {
+      // a small frontier, split among the threads
+      auto& active = compute_context.active_vertices();
+      size_t chunk = (active.size() + thrd_num - 1) / thrd_num;
+      thread_pool_.ParallelRun(thrd_num, [&active, &compute, chunk](int tid) {
+        size_t begin = std::min(active.size(), chunk * tid);
+        size_t end = std::min(active.size(), begin + chunk);
+        for (size_t i = begin; i < end; ++i) {
+          compute(tid, active[i]);
+        }
+      });
+    }
+  }
+
+  static void setVertex(pregel_vertex_t& pregel_vertex,
+                        const fragment_t& frag,
+                        pregel_compute_context_t& compute_context, int tid,
+                        vertex_t v) {
+    pregel_vertex.set_fragment(&frag);
+    pregel_vertex.set_compute_context(&compute_context);
+    pregel_vertex.set_vertex(v);
+    pregel_vertex.set_tid(tid);
+  }
+
+  // runs func(bucket) for the buckets of the mailboxes on the thread pool
+  std::function<void(int, const std::function<void(int)>&)> runner() {
+    return [this](int bucket_num, const std::function<void(int)>& func) {
+      thread_pool_.ParallelRun(bucket_num, func);
+    };
+  }
+
+  void finishSuperstep(const fragment_t& frag,
+                       pregel_compute_context_t& compute_context,
+                       message_manager_t& messages) {
+    if (combinator_holder_t::enabled) {
+      auto& outbox = compute_context.outbox();
+      outbox.Build(runner());
+      thread_pool_.ParallelRun(outbox.BucketNum(), [&frag, &compute_context,
+                                                    &messages, &outbox,
+                                                    this](int tid) {
+        auto send = [&frag, &messages, tid](const vertex_t& u,
+                                            const md_t& msg) {
+          messages.Channels()[tid].SyncStateOnOuterVertex<fragment_t, md_t>(
+              frag, u, msg);
+        };
+        for (auto& v : outbox.Receivers(tid)) {
+          combinator_.Combine(compute_context, v, tid, send);
+        }
+      });
+    }
+
+    {
+      // Sync Aggregator
+      compute_context.flush_aggregators();
+      SyncAggregators(compute_context.aggregators());
+    }
+
+    if (!compute_context.all_halted()) {
+      messages.ForceContinue();
+    }
+  }
+
+  VERTEX_PROGRAM_T program_;
+  combinator_holder_t combinator_;
+  ThreadPool thread_pool_;
+  PregelCheckpoint checkpoint_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_PARALLEL_PREGEL_APP_BASE_H_
@@ -24,6 +24,8 @@ limitations under the License.
 #include "grape/utils/iterator_pair.h"
 
 #include "core/app/app_base.h"
+#include "core/app/pregel/aggregators/aggregator_communicator.h"
+#include "core/app/pregel/pregel_checkpoint.h"
 #include "core/app/pregel/pregel_compute_context.h"
 #include "core/app/pregel/pregel_context.h"
 
@@ -31,7 +33,8 @@ namespace gs {
 
 /**
  * @brief PregelAppBase is implemented with PIE programming model. The pregel
- * program is driven by the PIE functions.
+ * program is driven by the PIE functions. The computation is checkpointed
+ * and resumed as configured by the app args, see PregelCheckpoint.
  * @tparam FRAG_T
  * @tparam VERTEX_PROGRAM_T
  * @tparam COMBINATOR_T
@@ -44,7 +47,7 @@ class PregelAppBase
           PregelContext<FRAG_T, PregelComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public AggregatorCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using pregel_compute_context_t = PregelComputeContext<FRAG_T, vd_t, md_t>;
@@ -65,7 +68,7 @@ class PregelAppBase
   void PEval(const fragment_t& frag, pregel_context_t& ctx,
              message_manager_t& messages) {
     // superstep is 0 in PEval
-    ctx.compute_context_.enable_combine();
+    ctx.compute_context_.enable_combine(combinator_);
 
     PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
     pregel_vertex.set_fragment(&frag);
@@ -79,39 +82,28 @@ class PregelAppBase
       program_.Init(pregel_vertex, ctx.compute_context_);
     }
 
-    for (auto v : inner_vertices) {
-      pregel_vertex.set_vertex(v);
-      program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-    }
-
-    ctx.compute_context_.apply_combine(combinator_);
-    ctx.compute_context_.before_comm();
-
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      auto& msgs = (ctx.compute_context_.messages_out())[v];
-      assert(msgs.size() <= 1);
-      if (!msgs.empty()) {
-        messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msgs[0]);
-        msgs.clear();
+    checkpoint_.Init(frag, ctx.compute_context_);
+    if (checkpoint_.Resume(ctx.compute_context_, *this)) {
+      // continues the superstep of the checkpoint
+      computeActive(frag, ctx);
+    } else {
+      for (auto v : inner_vertices) {
+        pregel_vertex.set_vertex(v);
+        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
       }
     }
 
+    ctx.compute_context_.apply_combine(
+        combinator_, [&frag, &messages](const vertex_t& v, const md_t& msg) {
+          messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msg);
+        });
+
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      ctx.compute_context_.flush_aggregators();
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
-    ctx.compute_context_.clear_for_next_round();
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
@@ -126,63 +118,47 @@ class PregelAppBase
       md_t msg;
       while (messages.GetMessage<fragment_t, md_t>(frag, v, msg)) {
         assert(frag.IsInnerVertex(v));
-        ctx.compute_context_.messages_in[v].emplace_back(std::move(msg));
+        ctx.compute_context_.receive_message(v, std::move(msg));
       }
     }
+    ctx.compute_context_.build_messages();
+    checkpoint_.Save(ctx.compute_context_);
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
+    computeActive(frag, ctx);
 
-    auto inner_vertices = frag.InnerVertices();
-    for (auto v : inner_vertices) {
-      if (ctx.compute_context_.active(v)) {
-        pregel_vertex.set_vertex(v);
-        auto& cur_msgs = (ctx.compute_context_.messages_in())[v];
-        program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context_);
-      }
-    }
-
-    ctx.compute_context_.apply_combine(combinator_);
-    ctx.compute_context_.before_comm();
-
-    auto outer_vertices = frag.OuterVertices();
-    for (auto v : outer_vertices) {
-      auto& msgs = (ctx.compute_context_.messages_out())[v];
-      assert(msgs.size() <= 1);
-      if (!msgs.empty()) {
-        messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msgs[0]);
-        msgs.clear();
-      }
-    }
+    ctx.compute_context_.apply_combine(
+        combinator_, [&frag, &messages](const vertex_t& v, const md_t& msg) {
+          messages.SyncStateOnOuterVertex<fragment_t, md_t>(frag, v, msg);
+        });
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      ctx.compute_context_.flush_aggregators();
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
-    ctx.compute_context_.clear_for_next_round();
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
   }
 
  private:
+  void computeActive(const fragment_t& frag, pregel_context_t& ctx) {
+    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
+    pregel_vertex.set_fragment(&frag);
+    pregel_vertex.set_compute_context(&ctx.compute_context_);
+
+    ctx.compute_context_.for_each_active(
+        [&ctx, &pregel_vertex, this](const vertex_t& v) {
+          pregel_vertex.set_vertex(v);
+          program_.Compute(ctx.compute_context_.get_messages(v), pregel_vertex,
+                           ctx.compute_context_);
+        });
+  }
+
   VERTEX_PROGRAM_T program_;
   COMBINATOR_T combinator_;
+  PregelCheckpoint checkpoint_;
 };
 /**
  * @brief This class is a specialized PregelAppBase without a combinator.
@@ -196,7 +172,7 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
           PregelContext<FRAG_T, PregelComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public AggregatorCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using app_t = PregelAppBase<FRAG_T, VERTEX_PROGRAM_T>;
@@ -230,27 +206,23 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
       program_.Init(pregel_vertex, ctx.compute_context_);
     }
 
-    for (auto v : inner_vertices) {
-      pregel_vertex.set_vertex(v);
-      program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
+    checkpoint_.Init(frag, ctx.compute_context_);
+    if (checkpoint_.Resume(ctx.compute_context_, *this)) {
+      // continues the superstep of the checkpoint
+      computeActive(frag, ctx);
+    } else {
+      for (auto v : inner_vertices) {
+        pregel_vertex.set_vertex(v);
+        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
+      }
     }
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      ctx.compute_context_.flush_aggregators();
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
-    ctx.compute_context_.clear_for_next_round();
-
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
@@ -265,50 +237,41 @@ class PregelAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
       md_t msg;
       while (messages.GetMessage<fragment_t, md_t>(frag, v, msg)) {
         assert(frag.IsInnerVertex(v));
-        ctx.compute_context_.messages_in()[v].emplace_back(std::move(msg));
+        ctx.compute_context_.receive_message(v, std::move(msg));
       }
     }
+    ctx.compute_context_.build_messages();
+    checkpoint_.Save(ctx.compute_context_);
 
-    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
-    pregel_vertex.set_fragment(&frag);
-    pregel_vertex.set_compute_context(&ctx.compute_context_);
-
-    auto inner_vertices = frag.InnerVertices();
-    for (auto v : inner_vertices) {
-      if (ctx.compute_context_.active(v)) {
-        pregel_vertex.set_vertex(v);
-        auto& cur_msgs = (ctx.compute_context_.messages_in())[v];
-        program_.Compute(
-            grape::IteratorPair<md_t*>(
-                &cur_msgs[0],
-                &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-            pregel_vertex, ctx.compute_context_);
-      }
-    }
+    computeActive(frag, ctx);
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      ctx.compute_context_.flush_aggregators();
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
-    ctx.compute_context_.clear_for_next_round();
-
     if (!ctx.compute_context_.all_halted()) {
       messages.ForceContinue();
     }
   }
 
  private:
+  void computeActive(const fragment_t& frag, pregel_context_t& ctx) {
+    PregelVertex<fragment_t, vd_t, md_t> pregel_vertex;
+    pregel_vertex.set_fragment(&frag);
+    pregel_vertex.set_compute_context(&ctx.compute_context_);
+
+    ctx.compute_context_.for_each_active(
+        [&ctx, &pregel_vertex, this](const vertex_t& v) {
+          pregel_vertex.set_vertex(v);
+          program_.Compute(ctx.compute_context_.get_messages(v), pregel_vertex,
+                           ctx.compute_context_);
+        });
+  }
+
   VERTEX_PROGRAM_T program_;
+  PregelCheckpoint checkpoint_;
 };
 
 }  // namespace gs
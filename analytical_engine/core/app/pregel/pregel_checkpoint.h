@@ -0,0 +1,153 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_CHECKPOINT_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_CHECKPOINT_H_
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "grape/communication/communicator.h"
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+
+namespace gs {
+
+/**
+ * @brief PregelCheckpoint stores the state of the pregel computation of a
+ * fragment into a local file periodically, and loads it back to resume a
+ * computation that was interrupted.
+ *
+ * A checkpoint is taken at the start of a superstep, after the messages of
+ * it are received and built, so the messages in flight between the workers
+ * are all in the inbox of the compute context. It is configured by the app
+ * args:
+ *   - checkpoint_dir: the directory of the files, one per fragment, nothing
+ *     is stored if it is empty;
+ *   - checkpoint_interval: the number of supersteps between checkpoints,
+ *     10 by default;
+ *   - resume: "true" to resume from the files in checkpoint_dir.
+ *
+ * The files are replaced by renaming, and the computation is only resumed
+ * when the checkpoints of all fragments are of the same superstep, otherwise
+ * it starts from the beginning.
+ */
+class PregelCheckpoint {
+ public:
+  static constexpr int kDefaultInterval = 10;
+
+  template <typename FRAG_T, typename COMPUTE_CONTEXT_T>
+  void Init(const FRAG_T& frag, COMPUTE_CONTEXT_T& compute_context) {
+    dir_ = compute_context.get_config("checkpoint_dir");
+    std::string interval = compute_context.get_config("checkpoint_interval");
+    interval_ = interval.empty() ? kDefaultInterval : std::stoi(interval);
+    std::string resume = compute_context.get_config("resume");
+    resume_ = (resume == "true" || resume == "True" || resume == "1");
+    if (!dir_.empty()) {
+      path_ = dir_ + "/pregel_" + std::to_string(frag.fid()) + "_of_" +
+              std::to_string(frag.fnum()) + ".ckpt";
+    }
+  }
+
+  bool enabled() const { return !dir_.empty(); }
+
+  /**
+   * @brief Stores the state of the superstep if it is a multiple of the
+   * interval. A failed store is logged and the computation goes on.
+   */
+  template <typename COMPUTE_CONTEXT_T>
+  void Save(COMPUTE_CONTEXT_T& compute_context) {
+    int step = compute_context.superstep();
+    if (!enabled() || interval_ <= 0 || step <= 0 || step % interval_ != 0) {
+      return;
+    }
+    grape::InArchive arc;
+    arc << step;
+    compute_context.save_checkpoint(arc);
+
+    std::string tmp_path = path_ + ".tmp";
+    {
+      std::ofstream fout(tmp_path, std::ios::binary | std::ios::trunc);
+      fout.write(arc.GetBuffer(), static_cast<std::streamsize>(arc.GetSize()));
+      if (!fout.good()) {
+        LOG(ERROR) << "Failed to write the checkpoint " << tmp_path;
+        return;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path_.c_str()) != 0) {
+      LOG(ERROR) << "Failed to rename the checkpoint to " << path_;
+      return;
+    }
+    VLOG(1) << "Stored the checkpoint of superstep " << step << " to "
+            << path_;
+  }
+
+  /**
+   * @brief Loads the state of the checkpoints if resume is set, returns
+   * whether the computation is resumed. It must be called by all workers,
+   * after the aggregators are registered.
+   */
+  template <typename COMPUTE_CONTEXT_T>
+  bool Resume(COMPUTE_CONTEXT_T& compute_context, grape::Communicator& comm) {
+    if (!enabled() || !resume_) {
+      return false;
+    }
+    grape::InArchive iarc;
+    int step = -1;
+    {
+      std::ifstream fin(path_, std::ios::binary | std::ios::ate);
+      if (fin.good()) {
+        size_t size = static_cast<size_t>(fin.tellg());
+        std::vector<char> buffer(size);
+        fin.seekg(0);
+        fin.read(buffer.data(), static_cast<std::streamsize>(size));
+        if (fin.good() && size >= sizeof(int)) {
+          iarc.AddBytes(buffer.data(), size);
+        }
+      }
+    }
+    grape::OutArchive oarc(std::move(iarc));
+    if (!oarc.Empty()) {
+      oarc >> step;
+    }
+
+    int min_step, max_step;
+    comm.Min(step, min_step);
+    comm.Max(step, max_step);
+    if (min_step < 0 || min_step != max_step) {
+      LOG(WARNING) << "No consistent checkpoint in " << dir_
+                   << ", the computation starts from the beginning";
+      return false;
+    }
+    compute_context.set_superstep(step);
+    compute_context.load_checkpoint(oarc);
+    VLOG(1) << "Resumed from the checkpoint of superstep " << step;
+    return true;
+  }
+
+ private:
+  std::string dir_;
+  std::string path_;
+  int interval_ = kDefaultInterval;
+  bool resume_ = false;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_CHECKPOINT_H_
@@ -18,7 +18,10 @@ limitations under the License.
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -29,10 +32,39 @@ limitations under the License.
 
 #include "core/app/pregel/aggregators/aggregator.h"
 #include "core/app/pregel/aggregators/aggregator_factory.h"
+#include "core/app/pregel/pregel_mailbox.h"
 #include "core/app/pregel/pregel_vertex.h"
 #include "core/config.h"
+#include "core/utils/vertex_bit_array.h"
 
 namespace gs {
+
+template <typename FRAG_T, typename VD_T, typename MD_T>
+class PregelComputeContext;
+
+/**
+ * @brief A typed handle of a registered aggregator, which is aggregated
+ * without looking up the name.
+ * @tparam AGGR_TYPE
+ */
+template <typename AGGR_TYPE>
+class AggregatorHandle {
+ public:
+  AggregatorHandle() = default;
+
+  bool valid() const { return index_ >= 0; }
+
+  int index() const { return index_; }
+
+ private:
+  explicit AggregatorHandle(int index) : index_(index) {}
+
+  template <typename FRAG_T, typename VD_T, typename MD_T>
+  friend class PregelComputeContext;
+
+  int index_ = -1;
+};
+
 /**
  * @brief PregelComputeContext holds the properties of the graph and
  * messages during the computation.
@@ -59,19 +91,46 @@ class PregelComputeContext {
     auto vertices = frag.Vertices();
     auto inner_vertices = frag.InnerVertices();
 
-    messages_out_.Init(vertices, {});
+    outbox_.Init(vertices);
     total_vertex_num_ = vertices.size();
 
-    messages_in_.Init(inner_vertices, {});
+    inbox_.Init(inner_vertices);
     halted_.Init(inner_vertices, false);
+    in_active_.Init(inner_vertices, true);
+    active_.clear();
+    active_.reserve(inner_vertices.size());
+    for (auto v : inner_vertices) {
+      active_.push_back(v);
+    }
+    activated_.clear();
+    activated_.resize(1);
+    dense_active_ = true;
     vid_parser_.Init(frag.fnum(), 1);
     inner_vertex_num_ = inner_vertices.size();
 
     step_ = 0;
     voted_to_halt_num_ = 0;
     enable_combine_ = false;
+    eager_combine_ = nullptr;
+    thread_num_ = 1;
+  }
+
+  /**
+   * @brief Lets the vertices be computed by thread_num threads, the messages
+   * to the vertices of this fragment are appended to the pending buffers of
+   * the sending thread, and the others are sent through the channel of the
+   * thread, so the parallel message manager must be set.
+   */
+  void set_thread_num(int thread_num) {
+    thread_num_ = thread_num;
+    inbox_.SetThreadNum(thread_num);
+    outbox_.SetThreadNum(thread_num);
+    activated_.resize(thread_num);
+    resizePartialAggregates();
   }
 
+  int thread_num() const { return thread_num_; }
+
   void inc_step() { step_++; }
 
   int superstep() const { return step_; }
@@ -90,32 +149,38 @@ class PregelComputeContext {
     return vertex_data_[v.vertex()];
   }
 
-  void send_message(const vertex_t& v, const MD_T& value) {
-    if (enable_combine_) {
-      messages_out_[v].emplace_back(value);
+  void send_message(const vertex_t& v, const MD_T& value, int tid = 0) {
+    if (eager_combine_ != nullptr) {
+      combineOnArrival(v, MD_T(value));
+    } else if (enable_combine_) {
+      outbox_.Append(tid, v, value);
+    } else if (fragment_->IsOuterVertex(v)) {
+      sendToOuterVertex(v, value, tid);
     } else {
-      if (fragment_->IsOuterVertex(v)) {
-        message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
-                                                                   v, value);
-      } else {
-        messages_out_[v].emplace_back(value);
-      }
+      inbox_.Append(tid, v, value);
     }
   }
 
-  void send_message(const vertex_t& v, MD_T&& value) {
-    if (enable_combine_) {
-      messages_out_[v].emplace_back(std::move(value));
+  void send_message(const vertex_t& v, MD_T&& value, int tid = 0) {
+    if (eager_combine_ != nullptr) {
+      combineOnArrival(v, std::move(value));
+    } else if (enable_combine_) {
+      outbox_.Append(tid, v, std::move(value));
+    } else if (fragment_->IsOuterVertex(v)) {
+      sendToOuterVertex(v, value, tid);
     } else {
-      if (fragment_->IsOuterVertex(v)) {
-        message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
-                                                                   v, value);
-      } else {
-        messages_out_[v].emplace_back(std::move(value));
-      }
+      inbox_.Append(tid, v, std::move(value));
     }
   }
 
+  /**
+   * @brief Receives a message from other fragments to the inner vertex v, it
+   * is processed in the next build_messages.
+   */
+  void receive_message(const vertex_t& v, MD_T&& value, int tid = 0) {
+    inbox_.Append(tid, v, std::move(value));
+  }
+
   void send_p2p_message(const vid_t& v_gid, const MD_T& value, int tid = 0) {
     auto fid = vid_parser_.GetFid(v_gid);
     parallel_message_manager_->Channels()[tid].SendToFragment(fid, value);
@@ -126,80 +191,251 @@ class PregelComputeContext {
     parallel_message_manager_->Channels()[tid].SendToFragment(fid, value);
   }
 
-  template <typename COMBINATOR_T>
-  void apply_combine(COMBINATOR_T& cb) {
-    auto vertices = fragment_->Vertices();
-    for (auto v : vertices) {
-      auto& msgs = messages_out_[v];
-      if (!msgs.empty()) {
-        MD_T ret = cb.CombineMessages(grape::IteratorPair<MD_T*>(
-            &msgs[0], &msgs[0] + static_cast<ptrdiff_t>(msgs.size())));
-        msgs.clear();
-        msgs.emplace_back(std::move(ret));
+  /**
+   * @brief Places the sent and received messages of the inner vertices,
+   * which are read by get_messages, and activates the vertices receiving
+   * messages. It is called before Compute of each superstep but the first.
+   */
+  void build_messages() {
+    inbox_.Build();
+    for (int bucket = 0; bucket < inbox_.BucketNum(); ++bucket) {
+      for (auto& v : inbox_.Receivers(bucket)) {
+        activate(v);
       }
     }
+    merge_activated();
   }
 
-  void before_comm() {
-    auto inner_vertices = fragment_->InnerVertices();
-    for (auto v : inner_vertices) {
-      messages_in_[v].clear();
-      messages_in_[v].swap(messages_out_[v]);
-      if (!messages_in_[v].empty()) {
-        activate(v);
+  grape::IteratorPair<MD_T*> get_messages(const vertex_t& v) {
+    return inbox_.Get(v);
+  }
+
+  /**
+   * @brief Combines the messages sent to each vertex into one, the combined
+   * messages to outer vertices are passed to send(v, msg), and those to
+   * inner vertices are kept for the next superstep.
+   */
+  template <typename COMBINATOR_T, typename SEND_FUNC_T>
+  void apply_combine(COMBINATOR_T& cb, const SEND_FUNC_T& send) {
+    if (eager_combine_ != nullptr) {
+      for (auto& v : combined_vertices_) {
+        if (fragment_->IsOuterVertex(v)) {
+          send(v, combined_[v]);
+        } else {
+          inbox_.Append(0, v, std::move(combined_[v]));
+        }
+        has_combined_[v] = false;
+      }
+      combined_vertices_.clear();
+      return;
+    }
+    outbox_.Build();
+    for (int bucket = 0; bucket < outbox_.BucketNum(); ++bucket) {
+      for (auto& v : outbox_.Receivers(bucket)) {
+        combine_messages(cb, v, 0, send);
       }
     }
   }
 
+  template <typename COMBINATOR_T, typename SEND_FUNC_T>
+  void combine_messages(COMBINATOR_T& cb, const vertex_t& v, int tid,
+                        const SEND_FUNC_T& send) {
+    if (outbox_.Empty(v)) {
+      return;
+    }
+    MD_T ret = cb.CombineMessages(outbox_.Get(v));
+    if (fragment_->IsOuterVertex(v)) {
+      send(v, ret);
+    } else {
+      inbox_.Append(tid, v, std::move(ret));
+    }
+  }
+
   bool active(const vertex_t& v) { return !halted_[v]; }
 
-  void activate(const vertex_t& v) {
-    if (halted_[v] == true) {
-      halted_[v] = false;
+  /**
+   * @brief Activates the inner vertex v, it may be called concurrently on
+   * different vertices, with the tid of the calling thread.
+   */
+  void activate(const vertex_t& v, int tid = 0) {
+    if (halted_[v]) {
+      halted_.Set(v, false);
+      if (!in_active_[v]) {
+        in_active_.Set(v, true);
+        activated_[tid].push_back(v);
+      }
+    }
+  }
+
+  /**
+   * @brief Appends the vertices activated by the messages to the active list,
+   * so a sparse superstep computes them as well. It must be called after the
+   * messages are built and before Compute.
+   */
+  void merge_activated() {
+    if (dense_active_) {
+      // the inner vertices are scanned, updateActive will rebuild the list
+      return;
+    }
+    for (auto& vertices : activated_) {
+      active_.insert(active_.end(), vertices.begin(), vertices.end());
+      vertices.clear();
     }
   }
 
   void vote_to_halt(const pregel_vertex_t& vertex) {
-    if (halted_[vertex.vertex()] == false) {
-      halted_[vertex.vertex()] = true;
+    if (!halted_[vertex.vertex()]) {
+      halted_.Set(vertex.vertex(), true);
     }
   }
 
+  /**
+   * @brief Drops the vertices voted to halt from the active set and adds the
+   * activated ones, then tells whether all vertices are halted. It must be
+   * called once at the end of each superstep, the vertices with pending
+   * messages are activated in the next superstep.
+   */
   bool all_halted() {
-    auto inner_vertices = fragment_->InnerVertices();
-    for (auto& v : inner_vertices) {
-      if (!halted_[v]) {
-        return false;
+    updateActive();
+    return active_.empty() && !inbox_.HasPending();
+  }
+
+  /**
+   * @brief Calls func(v) for each active inner vertex. The vertices are
+   * scanned in order when the active set is dense, and read from the active
+   * list otherwise, so a superstep with a small frontier doesn't visit all
+   * vertices.
+   */
+  template <typename FUNC_T>
+  void for_each_active(const FUNC_T& func) {
+    if (dense_active_) {
+      for (auto v : fragment_->InnerVertices()) {
+        if (!halted_[v]) {
+          func(v);
+        }
+      }
+    } else {
+      for (auto& v : active_) {
+        if (!halted_[v]) {
+          func(v);
+        }
       }
     }
-    return true;
   }
 
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>>& messages_in() {
-    return messages_in_;
+  bool dense_active() const { return dense_active_; }
+
+  /**
+   * @brief A superset of the active inner vertices, the ones voted to halt
+   * after the last all_halted are kept until the next one.
+   */
+  const std::vector<vertex_t>& active_vertices() const { return active_; }
+
+  /**
+   * @brief Writes the data and the halted flags of the inner vertices, the
+   * built messages and the aggregators to arc. It is called at the start of
+   * a superstep, after the messages are built.
+   */
+  void save_checkpoint(grape::InArchive& arc) {
+    for (auto v : fragment_->InnerVertices()) {
+      arc << vertex_data_[v] << halted_[v];
+    }
+    size_t receiver_num = 0;
+    for (int bucket = 0; bucket < inbox_.BucketNum(); ++bucket) {
+      receiver_num += inbox_.Receivers(bucket).size();
+    }
+    arc << receiver_num;
+    for (int bucket = 0; bucket < inbox_.BucketNum(); ++bucket) {
+      for (auto& v : inbox_.Receivers(bucket)) {
+        arc << v.GetValue() << inbox_.Size(v);
+        for (auto& msg : inbox_.Get(v)) {
+          arc << msg;
+        }
+      }
+    }
+    std::vector<std::string> names;
+    for (auto& pair : aggregators_) {
+      names.push_back(pair.first);
+    }
+    std::sort(names.begin(), names.end());
+    arc << names.size();
+    for (auto& name : names) {
+      arc << name;
+      aggregators_.at(name)->SaveState(arc);
+    }
   }
 
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>>& messages_out() {
-    return messages_out_;
+  /**
+   * @brief Reads the state written by save_checkpoint, the aggregators must
+   * have been registered. The messages sent before are dropped, and the
+   * active set is rebuilt from the halted flags.
+   */
+  void load_checkpoint(grape::OutArchive& arc) {
+    for (auto v : fragment_->InnerVertices()) {
+      bool halted;
+      arc >> vertex_data_[v] >> halted;
+      halted_.Set(v, halted);
+    }
+    inbox_.SetThreadNum(thread_num_);
+    outbox_.SetThreadNum(thread_num_);
+    size_t receiver_num;
+    arc >> receiver_num;
+    for (size_t i = 0; i < receiver_num; ++i) {
+      vid_t lid;
+      size_t msg_num;
+      arc >> lid >> msg_num;
+      vertex_t v(lid);
+      for (size_t j = 0; j < msg_num; ++j) {
+        MD_T msg;
+        arc >> msg;
+        inbox_.Append(0, v, std::move(msg));
+      }
+    }
+    inbox_.Build();
+    size_t aggregator_num;
+    arc >> aggregator_num;
+    for (size_t i = 0; i < aggregator_num; ++i) {
+      std::string name;
+      arc >> name;
+      CHECK(aggregators_.find(name) != aggregators_.end())
+          << "Aggregator " << name << " of the checkpoint is not registered";
+      aggregators_.at(name)->LoadState(arc);
+    }
+    for (auto& vertices : activated_) {
+      vertices.clear();
+    }
+    dense_active_ = true;
+    updateActive();
   }
 
+  PregelMailbox<FRAG_T, MD_T>& inbox() { return inbox_; }
+
+  PregelMailbox<FRAG_T, MD_T>& outbox() { return outbox_; }
+
   typename FRAG_T::template vertex_array_t<VD_T>& vertex_data() {
     return vertex_data_;
   }
-  void clear_for_next_round() {
-    if (!enable_combine_) {
-      auto inner_vertices = fragment_->InnerVertices();
-      for (auto v : inner_vertices) {
-        messages_in_[v].clear();
-        messages_in_[v].swap(messages_out_[v]);
-        if (!messages_in_[v].empty()) {
-          activate(v);
-        }
-      }
-    }
-  }
 
   void enable_combine() { enable_combine_ = true; }
+
+  /**
+   * @brief Enables combining each message into the single pending message of
+   * the receiving vertex as it is sent, so neither the messages nor a scan
+   * of all vertices are needed to combine them. cb combines the pending one
+   * and the new one, it must be associative, and outlive the computation.
+   * It is not thread safe, i.e., must not be used with set_thread_num.
+   */
+  template <typename COMBINATOR_T>
+  void enable_combine(COMBINATOR_T& cb) {
+    enable_combine_ = true;
+    combined_.Init(fragment_->Vertices());
+    has_combined_.Init(fragment_->Vertices(), false);
+    combined_vertices_.clear();
+    eager_combine_ = [&cb](MD_T& slot, MD_T&& msg) {
+      MD_T pair[2] = {std::move(slot), std::move(msg)};
+      slot = cb.CombineMessages(grape::IteratorPair<MD_T*>(pair, pair + 2));
+    };
+  }
   void set_fragment(const fragment_t* fragment) { fragment_ = fragment; }
   void set_message_manager(grape::DefaultMessageManager* message_manager) {
     message_manager_ = message_manager;
@@ -235,12 +471,83 @@ class PregelComputeContext {
     if (aggregators_.find(name) == aggregators_.end()) {
       aggregators_.emplace(name, AggregatorFactory::CreateAggregator(type));
       aggregators_.at(name)->Init();
+      aggregator_indices_.emplace(name, indexed_aggregators_.size());
+      indexed_aggregators_.push_back(aggregators_.at(name).get());
+      aggregator_types_.push_back(type);
+      resizePartialAggregates();
+    }
+  }
+
+  /**
+   * @brief Registers the aggregator and returns the handle of it, e.g.,
+   * register_aggregator<double>(name, kDoubleSumAggregator).
+   */
+  template <typename AGGR_TYPE>
+  AggregatorHandle<AGGR_TYPE> register_aggregator(const std::string& name,
+                                                  PregelAggregatorType type) {
+    register_aggregator(name, type);
+    return get_aggregator_handle<AGGR_TYPE>(name);
+  }
+
+  template <typename AGGR_TYPE>
+  AggregatorHandle<AGGR_TYPE> get_aggregator_handle(const std::string& name) {
+    auto iter = aggregator_indices_.find(name);
+    CHECK(iter != aggregator_indices_.end())
+        << "Aggregator " << name << " is not registered";
+    CHECK(dynamic_cast<Aggregator<AGGR_TYPE>*>(
+              indexed_aggregators_[iter->second]) != nullptr)
+        << "Aggregator " << name << " has a different value type";
+    return AggregatorHandle<AGGR_TYPE>(static_cast<int>(iter->second));
+  }
+
+  /**
+   * @brief Aggregates the value into the partial aggregate of the calling
+   * thread, which is lock free. The partial aggregates are merged by
+   * flush_aggregators before the aggregators are synchronized.
+   */
+  template <typename AGGR_TYPE>
+  void aggregate(const AggregatorHandle<AGGR_TYPE>& handle, AGGR_TYPE value,
+                 int tid = 0) {
+    auto& partial = partial_aggregates_[tid][handle.index_];
+    static_cast<Aggregator<AGGR_TYPE>*>(partial.aggregator.get())
+        ->Aggregate(value);
+    partial.touched = true;
+  }
+
+  template <typename AGGR_TYPE>
+  AGGR_TYPE get_aggregated_value(const AggregatorHandle<AGGR_TYPE>& handle) {
+    return static_cast<Aggregator<AGGR_TYPE>*>(
+               indexed_aggregators_[handle.index_])
+        ->GetAggregatedValue();
+  }
+
+  /**
+   * @brief Merges the partial aggregates of the threads into the
+   * aggregators, it must be called before the aggregators are synchronized.
+   */
+  void flush_aggregators() {
+    for (auto& partials : partial_aggregates_) {
+      for (size_t i = 0; i < partials.size(); ++i) {
+        auto& partial = partials[i];
+        if (partial.touched) {
+          grape::InArchive iarc;
+          partial.aggregator->Serialize(iarc);
+          grape::OutArchive oarc(std::move(iarc));
+          indexed_aggregators_[i]->DeserializeAndAggregate(oarc);
+          partial.aggregator->Reset();
+          partial.touched = false;
+        }
+      }
     }
   }
 
   template <typename AGGR_TYPE>
   void aggregate(const std::string& name, AGGR_TYPE value) {
     if (aggregators_.find(name) != aggregators_.end()) {
+      std::unique_lock<std::mutex> lock(aggregate_mutex_, std::defer_lock);
+      if (thread_num_ > 1) {
+        lock.lock();
+      }
       std::dynamic_pointer_cast<Aggregator<AGGR_TYPE>>(aggregators_.at(name))
           ->Aggregate(value);
     }
@@ -254,26 +561,128 @@ class PregelComputeContext {
   }
 
  private:
+  struct PartialAggregate {
+    std::shared_ptr<IAggregator> aggregator;
+    bool touched = false;
+  };
+
+  void resizePartialAggregates() {
+    partial_aggregates_.resize(thread_num_);
+    for (auto& partials : partial_aggregates_) {
+      while (partials.size() < aggregator_types_.size()) {
+        PartialAggregate partial;
+        auto type = aggregator_types_[partials.size()];
+        partial.aggregator = AggregatorFactory::CreateAggregator(type);
+        partial.aggregator->Init();
+        partials.push_back(std::move(partial));
+      }
+    }
+  }
+
+  void updateActive() {
+    if (dense_active_) {
+      // the vertices have been scanned in the superstep
+      active_.clear();
+      for (auto v : fragment_->InnerVertices()) {
+        in_active_.Set(v, !halted_[v]);
+        if (!halted_[v]) {
+          active_.push_back(v);
+        }
+      }
+      for (auto& vertices : activated_) {
+        vertices.clear();
+      }
+    } else {
+      size_t kept = 0;
+      for (auto& v : active_) {
+        if (halted_[v]) {
+          in_active_.Set(v, false);
+        } else {
+          active_[kept++] = v;
+        }
+      }
+      active_.resize(kept);
+      for (auto& vertices : activated_) {
+        for (auto& v : vertices) {
+          if (halted_[v]) {
+            in_active_.Set(v, false);
+          } else {
+            active_.push_back(v);
+          }
+        }
+        vertices.clear();
+      }
+    }
+    dense_active_ = active_.size() * kDenseActiveRatio >= inner_vertex_num_;
+  }
+
+  void combineOnArrival(const vertex_t& v, MD_T&& value) {
+    if (has_combined_[v]) {
+      eager_combine_(combined_[v], std::move(value));
+    } else {
+      has_combined_[v] = true;
+      combined_[v] = std::move(value);
+      combined_vertices_.push_back(v);
+    }
+  }
+
+  void sendToOuterVertex(const vertex_t& v, const MD_T& value, int tid) {
+    if (parallel_message_manager_ != nullptr) {
+      parallel_message_manager_->Channels()[tid]
+          .SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_, v, value);
+    } else {
+      message_manager_->SyncStateOnOuterVertex<fragment_t, MD_T>(*fragment_,
+                                                                 v, value);
+    }
+  }
+
   const fragment_t* fragment_;
-  grape::DefaultMessageManager* message_manager_;
-  grape::ParallelMessageManager* parallel_message_manager_;
+  grape::DefaultMessageManager* message_manager_ = nullptr;
+  grape::ParallelMessageManager* parallel_message_manager_ = nullptr;
 
   typename FRAG_T::template vertex_array_t<VD_T>& vertex_data_;
 
-  size_t voted_to_halt_num_;
-  typename FRAG_T::template vertex_array_t<bool> halted_;
+  // the active set is scanned densely when it holds at least
+  // 1 / kDenseActiveRatio of the inner vertices
+  static constexpr size_t kDenseActiveRatio = 16;
 
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>> messages_out_;
-  typename FRAG_T::template vertex_array_t<std::vector<MD_T>> messages_in_;
+  size_t voted_to_halt_num_;
+  VertexBitArray<typename FRAG_T::vid_t> halted_;
+  // the active inner vertices, with the ones voted to halt in the superstep,
+  // the activated ones of each thread are appended in all_halted
+  std::vector<vertex_t> active_;
+  VertexBitArray<typename FRAG_T::vid_t> in_active_;
+  std::vector<std::vector<vertex_t>> activated_;
+  bool dense_active_;
+
+  // the messages to all vertices before they are combined, and the messages
+  // to inner vertices
+  PregelMailbox<FRAG_T, MD_T> outbox_;
+  PregelMailbox<FRAG_T, MD_T> inbox_;
 
   size_t inner_vertex_num_;
   size_t total_vertex_num_;
 
   bool enable_combine_;
+  // the pending combined message of each vertex, and the vertices having
+  // one, when messages are combined on arrival
+  std::function<void(MD_T&, MD_T&&)> eager_combine_;
+  typename FRAG_T::template vertex_array_t<MD_T> combined_;
+  typename FRAG_T::template vertex_array_t<bool> has_combined_;
+  std::vector<vertex_t> combined_vertices_;
+
+  int thread_num_ = 1;
+  std::mutex aggregate_mutex_;
 
   int step_;
   std::unordered_map<std::string, std::string> config_;
   std::unordered_map<std::string, std::shared_ptr<IAggregator>> aggregators_;
+  // the registered aggregators by their handles, and the partial aggregates
+  // of each thread, [tid][index]
+  std::unordered_map<std::string, size_t> aggregator_indices_;
+  std::vector<IAggregator*> indexed_aggregators_;
+  std::vector<PregelAggregatorType> aggregator_types_;
+  std::vector<std::vector<PartialAggregate>> partial_aggregates_;
   vineyard::IdParser<vid_t> vid_parser_;
 };
 
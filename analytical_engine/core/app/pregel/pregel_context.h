@@ -54,17 +54,19 @@ class PregelContext
     compute_context_.init(frag);
     compute_context_.set_fragment(&frag);
     compute_context_.set_message_manager(&messages);
+    setConfig(args);
+  }
 
-    if (!args.empty()) {
-      // The app params are passed via serialized json string.
-      boost::property_tree::ptree pt;
-      std::stringstream ss;
-      ss << args;
-      boost::property_tree::read_json(ss, pt);
-      for (const auto& x : pt) {
-        compute_context_.set_config(x.first, x.second.get_value<std::string>());
-      }
-    }
+  /**
+   * @brief Init for ParallelPregelAppBase.
+   */
+  void Init(grape::ParallelMessageManager& messages, const std::string& args) {
+    auto& frag = this->fragment();
+
+    compute_context_.init(frag);
+    compute_context_.set_fragment(&frag);
+    compute_context_.set_parallel_message_manager(&messages);
+    setConfig(args);
   }
 
   void Output(std::ostream& os) override {
@@ -78,6 +80,20 @@ class PregelContext
   }
 
   COMPUTE_CONTEXT_T compute_context_;
+
+ private:
+  void setConfig(const std::string& args) {
+    if (!args.empty()) {
+      // The app params are passed via serialized json string.
+      boost::property_tree::ptree pt;
+      std::stringstream ss;
+      ss << args;
+      boost::property_tree::read_json(ss, pt);
+      for (const auto& x : pt) {
+        compute_context_.set_config(x.first, x.second.get_value<std::string>());
+      }
+    }
+  }
 };
 
 /**
@@ -0,0 +1,220 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MAILBOX_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MAILBOX_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "grape/utils/iterator_pair.h"
+
+namespace gs {
+
+namespace pregel_mailbox_impl {
+
+// the built messages, which are read by the pointers to them
+template <typename MD_T>
+class MessageBuffer : public std::vector<MD_T> {};
+
+// std::vector<bool> is packed without data(), so the bools are kept in a
+// plain array, of which the memory is reused by the later rounds
+template <>
+class MessageBuffer<bool> {
+ public:
+  bool* data() { return data_.get(); }
+
+  size_t size() const { return size_; }
+
+  void clear() { size_ = 0; }
+
+  void resize(size_t size) {
+    if (size > capacity_) {
+      data_.reset(new bool[size]);
+      capacity_ = size;
+    }
+    size_ = size;
+  }
+
+  bool& operator[](size_t index) { return data_[index]; }
+
+ private:
+  std::unique_ptr<bool[]> data_;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
+
+}  // namespace pregel_mailbox_impl
+
+/**
+ * @brief PregelMailbox keeps the messages of the vertices of a fragment in
+ * CSR form: the messages of all vertices are stored contiguously, grouped by
+ * the receiving vertex, and located by the offset and the count of it.
+ *
+ * The messages are appended to the pending buffers of the sending threads,
+ * one per bucket of receiving vertices, and placed by Build with a counting
+ * pass and a placing pass. The built messages are left readable while new
+ * ones are appended, so the messages of the next superstep can be sent
+ * while the current ones are processed. Build only visits the receivers of
+ * the messages, so its cost doesn't depend on the number of vertices.
+ *
+ * @tparam FRAG_T
+ * @tparam MD_T
+ */
+template <typename FRAG_T, typename MD_T>
+class PregelMailbox {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using pending_t = std::vector<std::pair<vertex_t, MD_T>>;
+
+ public:
+  template <typename RANGE_T>
+  void Init(const RANGE_T& vertices, int thread_num = 1) {
+    offsets_.Init(vertices, 0);
+    counts_.Init(vertices, 0);
+    messages_.clear();
+    receivers_.clear();
+    SetThreadNum(thread_num);
+  }
+
+  /**
+   * @brief Sets the number of threads appending messages, and the number of
+   * buckets, the pending messages are dropped.
+   */
+  void SetThreadNum(int thread_num) {
+    for (auto& receivers : receivers_) {
+      for (auto& v : receivers) {
+        counts_[v] = 0;
+      }
+    }
+    thread_num_ = thread_num;
+    pending_.clear();
+    pending_.resize(thread_num, std::vector<pending_t>(thread_num));
+    receivers_.clear();
+    receivers_.resize(thread_num);
+    bucket_offsets_.resize(thread_num + 1);
+  }
+
+  int BucketNum() const { return thread_num_; }
+
+  int Bucket(const vertex_t& v) const { return v.GetValue() % thread_num_; }
+
+  void Append(int tid, const vertex_t& v, const MD_T& msg) {
+    pending_[tid][Bucket(v)].emplace_back(v, msg);
+  }
+
+  void Append(int tid, const vertex_t& v, MD_T&& msg) {
+    pending_[tid][Bucket(v)].emplace_back(v, std::move(msg));
+  }
+
+  bool HasPending() const {
+    for (auto& buckets : pending_) {
+      for (auto& bucket : buckets) {
+        if (!bucket.empty()) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Replaces the built messages with the pending ones. run(n, func)
+   * runs func(bucket) for each bucket in [0, n), concurrently or not, the
+   * buckets are disjoint.
+   */
+  template <typename RUN_FUNC_T>
+  void Build(const RUN_FUNC_T& run) {
+    run(thread_num_, [this](int bucket) {
+      auto& receivers = receivers_[bucket];
+      for (auto& v : receivers) {
+        counts_[v] = 0;
+      }
+      receivers.clear();
+      size_t total = 0;
+      for (auto& buckets : pending_) {
+        for (auto& pair : buckets[bucket]) {
+          if (counts_[pair.first]++ == 0) {
+            receivers.push_back(pair.first);
+          }
+        }
+        total += buckets[bucket].size();
+      }
+      bucket_offsets_[bucket + 1] = total;
+    });
+    bucket_offsets_[0] = 0;
+    for (int bucket = 0; bucket < thread_num_; ++bucket) {
+      bucket_offsets_[bucket + 1] += bucket_offsets_[bucket];
+    }
+    messages_.clear();
+    messages_.resize(bucket_offsets_[thread_num_]);
+    run(thread_num_, [this](int bucket) {
+      size_t offset = bucket_offsets_[bucket];
+      for (auto& v : receivers_[bucket]) {
+        offsets_[v] = offset;
+        offset += counts_[v];
+        counts_[v] = 0;
+      }
+      for (auto& buckets : pending_) {
+        for (auto& pair : buckets[bucket]) {
+          auto& v = pair.first;
+          messages_[offsets_[v] + counts_[v]++] = std::move(pair.second);
+        }
+        buckets[bucket].clear();
+      }
+    });
+  }
+
+  void Build() {
+    Build([](int bucket_num, const std::function<void(int)>& func) {
+      for (int bucket = 0; bucket < bucket_num; ++bucket) {
+        func(bucket);
+      }
+    });
+  }
+
+  /**
+   * @brief The vertices with built messages in the bucket.
+   */
+  const std::vector<vertex_t>& Receivers(int bucket) const {
+    return receivers_[bucket];
+  }
+
+  grape::IteratorPair<MD_T*> Get(const vertex_t& v) {
+    MD_T* begin = messages_.data() + offsets_[v];
+    return grape::IteratorPair<MD_T*>(begin, begin + counts_[v]);
+  }
+
+  size_t Size(const vertex_t& v) const { return counts_[v]; }
+
+  bool Empty(const vertex_t& v) const { return counts_[v] == 0; }
+
+ private:
+  int thread_num_ = 1;
+  typename FRAG_T::template vertex_array_t<size_t> offsets_;
+  typename FRAG_T::template vertex_array_t<size_t> counts_;
+  pregel_mailbox_impl::MessageBuffer<MD_T> messages_;
+  // [src thread][bucket]
+  std::vector<std::vector<pending_t>> pending_;
+  // [bucket]
+  std::vector<std::vector<vertex_t>> receivers_;
+  std::vector<size_t> bucket_offsets_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_MAILBOX_H_
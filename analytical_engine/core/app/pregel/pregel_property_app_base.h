@@ -17,17 +17,93 @@ limitations under the License.
 #define ANALYTICAL_ENGINE_CORE_APP_PREGEL_PREGEL_PROPERTY_APP_BASE_H_
 
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "grape/grape.h"
 #include "grape/utils/iterator_pair.h"
 
+#include "core/app/pregel/aggregators/aggregator_communicator.h"
 #include "core/app/pregel/pregel_context.h"
 #include "core/app/pregel/pregel_property_vertex.h"
 #include "core/app/property_app_base.h"
 
 namespace gs {
+
+namespace pregel_property_impl {
+
+static constexpr size_t kVertexBatchSize = 1024;
+
+template <typename PROGRAM_T, typename = void>
+struct HasComputeBatch : std::false_type {};
+
+template <typename PROGRAM_T>
+struct HasComputeBatch<PROGRAM_T, decltype(void(&PROGRAM_T::HasComputeBatch))>
+    : std::true_type {};
+
+template <typename PROGRAM_T, typename PREGEL_VERTEX_T,
+          typename COMPUTE_CONTEXT_T, typename RANGE_T, typename FILTER_T,
+          typename MSG_FUNC_T>
+void ComputeVertices(PROGRAM_T& program, PREGEL_VERTEX_T& pregel_vertex,
+                     COMPUTE_CONTEXT_T& compute_context,
+                     const RANGE_T& vertices, const FILTER_T& filter,
+                     const MSG_FUNC_T& get_messages, std::false_type) {
+  for (auto v : vertices) {
+    if (filter(v)) {
+      pregel_vertex.set_vertex(v);
+      program.Compute(get_messages(v), pregel_vertex, compute_context);
+    }
+  }
+}
+
+template <typename PROGRAM_T, typename PREGEL_VERTEX_T,
+          typename COMPUTE_CONTEXT_T, typename RANGE_T, typename FILTER_T,
+          typename MSG_FUNC_T>
+void ComputeVertices(PROGRAM_T& program, PREGEL_VERTEX_T& pregel_vertex,
+                     COMPUTE_CONTEXT_T& compute_context,
+                     const RANGE_T& vertices, const FILTER_T& filter,
+                     const MSG_FUNC_T& get_messages, std::true_type) {
+  if (!program.HasComputeBatch()) {
+    ComputeVertices(program, pregel_vertex, compute_context, vertices, filter,
+                    get_messages, std::false_type());
+    return;
+  }
+  typename PROGRAM_T::vertex_batch_t batch;
+  for (auto v : vertices) {
+    if (filter(v)) {
+      pregel_vertex.set_vertex(v);
+      batch.Append(pregel_vertex, get_messages(v));
+      if (batch.size() == kVertexBatchSize) {
+        program.ComputeBatch(batch, compute_context);
+        batch.Clear();
+      }
+    }
+  }
+  if (!batch.empty()) {
+    program.ComputeBatch(batch, compute_context);
+  }
+}
+
+/**
+ * @brief Computes the vertices passing filter(v) with the messages of
+ * get_messages(v). A program with a batched Compute, i.e., ComputeBatch, is
+ * handed the vertices by batches of kVertexBatchSize, so the cost of calling
+ * into it is paid once per batch rather than once per vertex.
+ */
+template <typename PROGRAM_T, typename PREGEL_VERTEX_T,
+          typename COMPUTE_CONTEXT_T, typename RANGE_T, typename FILTER_T,
+          typename MSG_FUNC_T>
+void ComputeVertices(PROGRAM_T& program, PREGEL_VERTEX_T& pregel_vertex,
+                     COMPUTE_CONTEXT_T& compute_context,
+                     const RANGE_T& vertices, const FILTER_T& filter,
+                     const MSG_FUNC_T& get_messages) {
+  ComputeVertices(program, pregel_vertex, compute_context, vertices, filter,
+                  get_messages, HasComputeBatch<PROGRAM_T>());
+}
+
+}  // namespace pregel_property_impl
+
 /**
  * @brief PregelPropertyAppBase is implemented with PIE programming model. The
  * pregel program is driven by the PIE functions. Compared with PregelAppBase,
@@ -44,7 +120,7 @@ class PregelPropertyAppBase
           PregelContext<FRAG_T, PregelPropertyComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public AggregatorCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using pregel_compute_context_t =
@@ -86,11 +162,11 @@ class PregelPropertyAppBase
         program_.Init(pregel_vertex, ctx.compute_context_);
       }
 
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-      }
+      pregel_vertex.set_label_id(i);
+      pregel_property_impl::ComputeVertices(
+          program_, pregel_vertex, ctx.compute_context_, inner_vertices,
+          [](vertex_t) { return true; },
+          [&null_messages](vertex_t) { return null_messages; });
     }
 
     ctx.compute_context_.apply_combine(combinator_);
@@ -110,16 +186,7 @@ class PregelPropertyAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -153,18 +220,16 @@ class PregelPropertyAppBase
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
       auto inner_vertices = frag.InnerVertices(i);
-      for (auto v : inner_vertices) {
-        if (ctx.compute_context_.active(v)) {
-          pregel_vertex.set_vertex(v);
-          pregel_vertex.set_label_id(i);
-          auto& cur_msgs = (ctx.compute_context_.messages_in(i))[v];
-          program_.Compute(
-              grape::IteratorPair<md_t*>(
-                  &cur_msgs[0],
-                  &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-              pregel_vertex, ctx.compute_context_);
-        }
-      }
+      auto& messages_in = ctx.compute_context_.messages_in(i);
+      pregel_vertex.set_label_id(i);
+      pregel_property_impl::ComputeVertices(
+          program_, pregel_vertex, ctx.compute_context_, inner_vertices,
+          [&ctx](vertex_t v) { return ctx.compute_context_.active(v); },
+          [&messages_in](vertex_t v) {
+            auto& cur_msgs = messages_in[v];
+            return grape::IteratorPair<md_t*>(
+                cur_msgs.data(), cur_msgs.data() + cur_msgs.size());
+          });
     }
 
     ctx.compute_context_.apply_combine(combinator_);
@@ -184,16 +249,7 @@ class PregelPropertyAppBase
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -220,7 +276,7 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
           PregelContext<FRAG_T, PregelPropertyComputeContext<
                                     FRAG_T, typename VERTEX_PROGRAM_T::vd_t,
                                     typename VERTEX_PROGRAM_T::md_t>>>,
-      public grape::Communicator {
+      public AggregatorCommunicator {
   using vd_t = typename VERTEX_PROGRAM_T::vd_t;
   using md_t = typename VERTEX_PROGRAM_T::md_t;
   using app_t = PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T>;
@@ -260,25 +316,16 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
         program_.Init(pregel_vertex, ctx.compute_context_);
       }
 
-      for (auto v : inner_vertices) {
-        pregel_vertex.set_vertex(v);
-        pregel_vertex.set_label_id(i);
-        program_.Compute(null_messages, pregel_vertex, ctx.compute_context_);
-      }
+      pregel_vertex.set_label_id(i);
+      pregel_property_impl::ComputeVertices(
+          program_, pregel_vertex, ctx.compute_context_, inner_vertices,
+          [](vertex_t) { return true; },
+          [&null_messages](vertex_t) { return null_messages; });
     }
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
@@ -312,32 +359,21 @@ class PregelPropertyAppBase<FRAG_T, VERTEX_PROGRAM_T, void>
 
     for (label_id_t i = 0; i < v_label_num; ++i) {
       auto inner_vertices = frag.InnerVertices(i);
-      for (auto v : inner_vertices) {
-        if (ctx.compute_context_.active(v)) {
-          pregel_vertex.set_vertex(v);
-          pregel_vertex.set_label_id(i);
-          auto& cur_msgs = (ctx.compute_context_.messages_in(i))[v];
-          program_.Compute(
-              grape::IteratorPair<md_t*>(
-                  &cur_msgs[0],
-                  &cur_msgs[0] + static_cast<ptrdiff_t>(cur_msgs.size())),
-              pregel_vertex, ctx.compute_context_);
-        }
-      }
+      auto& messages_in = ctx.compute_context_.messages_in(i);
+      pregel_vertex.set_label_id(i);
+      pregel_property_impl::ComputeVertices(
+          program_, pregel_vertex, ctx.compute_context_, inner_vertices,
+          [&ctx](vertex_t v) { return ctx.compute_context_.active(v); },
+          [&messages_in](vertex_t v) {
+            auto& cur_msgs = messages_in[v];
+            return grape::IteratorPair<md_t*>(
+                cur_msgs.data(), cur_msgs.data() + cur_msgs.size());
+          });
     }
 
     {
       // Sync Aggregator
-      for (auto& pair : ctx.compute_context_.aggregators()) {
-        grape::InArchive iarc;
-        std::vector<grape::InArchive> oarcs;
-        std::string name = pair.first;
-        pair.second->Serialize(iarc);
-        pair.second->Reset();
-        AllGather(std::move(iarc), oarcs);
-        pair.second->DeserializeAndAggregate(oarcs);
-        pair.second->StartNewRound();
-      }
+      SyncAggregators(ctx.compute_context_.aggregators());
     }
 
     ctx.compute_context_.clear_for_next_round();
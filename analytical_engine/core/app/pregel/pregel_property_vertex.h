@@ -18,16 +18,23 @@
 
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "glog/logging.h"
 #include "grape/grape.h"
 #include "grape/utils/iterator_pair.h"
+#include "vineyard/basic/ds/arrow_utils.h"
 
 #include "core/app/pregel/aggregators/aggregator.h"
 #include "core/app/pregel/aggregators/aggregator_factory.h"
 #include "core/context/i_context.h"
+#include "core/loader/property_encoder.h"
+#include "core/utils/vertex_bit_array.h"
 
 namespace gs {
 
@@ -238,6 +245,8 @@ class PregelPropertyNeighbor {
     return nbr_.template get_data<int64_t>(prop_id);
   }
 
+  const nbr_t& raw_nbr() const { return nbr_; }
+
   bool operator==(const PregelPropertyNeighbor& rhs) {
     return (fragment_ == rhs.fragment_) && (nbr_ == rhs.nbr_);
   }
@@ -329,6 +338,108 @@ class PregelPropertyAdjList {
   adj_list_t adj_list_;
 };
 
+namespace pregel_property_vertex_impl {
+
+// the prop_id-th column of table must be of type T, otherwise the typed
+// column would reinterpret the values of another type.
+template <typename T>
+void check_column_type(const std::shared_ptr<arrow::Table>& table,
+                       int prop_id, const std::string& kind,
+                       int64_t label_id) {
+  CHECK(prop_id >= 0 && prop_id < table->num_columns())
+      << kind << " label " << label_id << " has no property " << prop_id;
+  CHECK(!IsEncodedField(table->field(prop_id)))
+      << "The property " << prop_id << " of " << kind << " label "
+      << label_id << " is encoded by compress_properties";
+  auto type = table->column(prop_id)->type();
+  CHECK(type->Equals(vineyard::ConvertToArrowType<T>::TypeValue()))
+      << "The property " << prop_id << " of " << kind << " label "
+      << label_id << " is " << type->ToString() << ", expects "
+      << vineyard::ConvertToArrowType<T>::TypeValue()->ToString();
+}
+
+}  // namespace pregel_property_vertex_impl
+
+/**
+ * @brief PregelPropertyEdgeColumn is the typed column of a numeric property
+ * of an edge label. It is indexed by the neighbors of the adjacent lists of
+ * the label, reading the raw values directly instead of dispatching on the
+ * property id for each edge as get_double or get_int does.
+ * @tparam FRAG_T
+ * @tparam VD_T
+ * @tparam MD_T
+ * @tparam DATA_T
+ */
+template <typename FRAG_T, typename VD_T, typename MD_T, typename DATA_T>
+class PregelPropertyEdgeColumn {
+  static_assert(std::is_arithmetic<DATA_T>::value,
+                "Only numeric properties have typed columns");
+  using label_id_t = typename FRAG_T::label_id_t;
+  using prop_id_t = typename FRAG_T::prop_id_t;
+  using column_t = decltype(std::declval<const FRAG_T&>()
+                                .template edge_data_column<DATA_T>(
+                                    label_id_t(), prop_id_t()));
+
+ public:
+  PregelPropertyEdgeColumn(const FRAG_T& fragment, label_id_t e_label,
+                           prop_id_t prop_id)
+      : column_(fragment.template edge_data_column<DATA_T>(e_label, prop_id)) {
+  }
+
+  static void CheckType(const FRAG_T& fragment, label_id_t e_label,
+                        prop_id_t prop_id) {
+    pregel_property_vertex_impl::check_column_type<DATA_T>(
+        fragment.edge_data_table(e_label), prop_id, "edge", e_label);
+  }
+
+  DATA_T operator[](
+      const PregelPropertyNeighbor<FRAG_T, VD_T, MD_T>& nbr) const {
+    return column_[nbr.raw_nbr()];
+  }
+
+ private:
+  column_t column_;
+};
+
+/**
+ * @brief PregelPropertyVertexColumn is the typed column of a numeric property
+ * of a vertex label, indexed by the vertices of the label.
+ * @tparam FRAG_T
+ * @tparam VD_T
+ * @tparam MD_T
+ * @tparam DATA_T
+ */
+template <typename FRAG_T, typename VD_T, typename MD_T, typename DATA_T>
+class PregelPropertyVertexColumn {
+  static_assert(std::is_arithmetic<DATA_T>::value,
+                "Only numeric properties have typed columns");
+  using label_id_t = typename FRAG_T::label_id_t;
+  using prop_id_t = typename FRAG_T::prop_id_t;
+  using column_t = decltype(std::declval<const FRAG_T&>()
+                                .template vertex_data_column<DATA_T>(
+                                    label_id_t(), prop_id_t()));
+
+ public:
+  PregelPropertyVertexColumn(const FRAG_T& fragment, label_id_t v_label,
+                             prop_id_t prop_id)
+      : column_(
+            fragment.template vertex_data_column<DATA_T>(v_label, prop_id)) {}
+
+  static void CheckType(const FRAG_T& fragment, label_id_t v_label,
+                        prop_id_t prop_id) {
+    pregel_property_vertex_impl::check_column_type<DATA_T>(
+        fragment.vertex_data_table(v_label), prop_id, "vertex", v_label);
+  }
+
+  DATA_T operator[](
+      const PregelPropertyVertex<FRAG_T, VD_T, MD_T>& vertex) const {
+    return column_[vertex.vertex()];
+  }
+
+ private:
+  column_t column_;
+};
+
 /**
  * @brief PregelPropertyComputeContext holds the properties of the graph and
  * messages during the computation.
@@ -570,15 +681,15 @@ class PregelPropertyComputeContext {
 
   void activate(const vertex_t& v) {
     int label = fragment_->vertex_label(v);
-    if (halted_[label][v] == true) {
-      halted_[label][v] = false;
+    if (halted_[label][v]) {
+      halted_[label].Set(v, false);
       --voted_to_halt_num_;
     }
   }
 
   void vote_to_halt(const pregel_vertex_t& vertex) {
-    if (halted_[vertex.label_id()][vertex.vertex()] == false) {
-      halted_[vertex.label_id()][vertex.vertex()] = true;
+    if (!halted_[vertex.label_id()][vertex.vertex()]) {
+      halted_[vertex.label_id()].Set(vertex.vertex(), true);
       ++voted_to_halt_num_;
     }
   }
@@ -669,6 +780,42 @@ class PregelPropertyComputeContext {
         ->GetAggregatedValue();
   }
 
+  /**
+   * @brief The typed column of the edge property, which is created on the
+   * first request and kept during the computation, so that it can be asked
+   * for in each Compute with little cost. A property must be requested with
+   * its type in the schema, and the same type each time.
+   */
+  template <typename DATA_T>
+  const PregelPropertyEdgeColumn<FRAG_T, VD_T, MD_T, DATA_T>& edge_column(
+      label_id_t e_label_id, prop_id_t prop_id) {
+    using column_t = PregelPropertyEdgeColumn<FRAG_T, VD_T, MD_T, DATA_T>;
+    return getColumn<column_t>(edge_columns_, e_label_id, prop_id);
+  }
+
+  template <typename DATA_T>
+  const PregelPropertyEdgeColumn<FRAG_T, VD_T, MD_T, DATA_T>& edge_column(
+      const std::string& e_label, const std::string& name) {
+    label_id_t e_label_id = schema_->GetEdgeLabelId(e_label);
+    return edge_column<DATA_T>(e_label_id,
+                               schema_->GetEdgePropertyId(e_label_id, name));
+  }
+
+  template <typename DATA_T>
+  const PregelPropertyVertexColumn<FRAG_T, VD_T, MD_T, DATA_T>& vertex_column(
+      label_id_t v_label_id, prop_id_t prop_id) {
+    using column_t = PregelPropertyVertexColumn<FRAG_T, VD_T, MD_T, DATA_T>;
+    return getColumn<column_t>(vertex_columns_, v_label_id, prop_id);
+  }
+
+  template <typename DATA_T>
+  const PregelPropertyVertexColumn<FRAG_T, VD_T, MD_T, DATA_T>& vertex_column(
+      const std::string& v_label, const std::string& name) {
+    label_id_t v_label_id = schema_->GetVertexLabelId(v_label);
+    return vertex_column<DATA_T>(
+        v_label_id, schema_->GetVertexPropertyId(v_label_id, name));
+  }
+
   size_t get_total_vertices_num() { return fragment_->GetTotalNodesNum(); }
 
   vineyard::ObjectID vertex_map_id() { return fragment_->vertex_map_id(); }
@@ -676,6 +823,35 @@ class PregelPropertyComputeContext {
   const vineyard::PropertyGraphSchema* schema() const { return schema_; }
 
  private:
+  struct CachedColumn {
+    std::type_index type = std::type_index(typeid(void));
+    std::shared_ptr<void> column;
+  };
+  // [label][prop]
+  using column_cache_t = std::vector<std::vector<CachedColumn>>;
+
+  template <typename COLUMN_T>
+  const COLUMN_T& getColumn(column_cache_t& cache, label_id_t label_id,
+                            prop_id_t prop_id) {
+    if (cache.size() <= static_cast<size_t>(label_id)) {
+      cache.resize(label_id + 1);
+    }
+    auto& columns = cache[label_id];
+    if (columns.size() <= static_cast<size_t>(prop_id)) {
+      columns.resize(prop_id + 1);
+    }
+    auto& cached = columns[prop_id];
+    if (cached.column == nullptr) {
+      COLUMN_T::CheckType(*fragment_, label_id, prop_id);
+      cached.type = std::type_index(typeid(COLUMN_T));
+      cached.column = std::make_shared<COLUMN_T>(*fragment_, label_id, prop_id);
+    }
+    CHECK(cached.type == std::type_index(typeid(COLUMN_T)))
+        << "Property " << prop_id << " of label " << label_id
+        << " is requested with different types";
+    return *std::static_pointer_cast<COLUMN_T>(cached.column);
+  }
+
   const fragment_t* fragment_;
   grape::DefaultMessageManager* message_manager_;
 
@@ -685,7 +861,7 @@ class PregelPropertyComputeContext {
   std::vector<typename FRAG_T::template vertex_array_t<VD_T>>& vertex_data_;
 
   size_t voted_to_halt_num_;
-  std::vector<typename FRAG_T::template vertex_array_t<bool>> halted_;
+  std::vector<VertexBitArray<typename FRAG_T::vid_t>> halted_;
 
   std::vector<typename FRAG_T::template vertex_array_t<std::vector<MD_T>>>
       messages_out_;
@@ -701,6 +877,9 @@ class PregelPropertyComputeContext {
   int step_;
   std::unordered_map<std::string, std::string> config_;
   std::unordered_map<std::string, std::shared_ptr<IAggregator>> aggregators_;
+
+  column_cache_t edge_columns_;
+  column_cache_t vertex_columns_;
 };
 
 }  // namespace gs
@@ -0,0 +1,170 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_APP_PROPERTY_SCHEMA_BINDING_H_
+#define ANALYTICAL_ENGINE_CORE_APP_PROPERTY_SCHEMA_BINDING_H_
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "arrow/api.h"
+#include "glog/logging.h"
+#include "vineyard/basic/ds/arrow_utils.h"
+
+#include "core/loader/property_encoder.h"
+
+namespace gs {
+
+namespace schema_binding_impl {
+
+// the values of the prop_id-th column of table, or nullptr if the table is
+// empty, which has no chunks. The column must be of type T.
+template <typename T>
+const T* column_values(const std::shared_ptr<arrow::Table>& table,
+                       int prop_id, const std::string& kind,
+                       int64_t label_id) {
+  CHECK(prop_id >= 0 && prop_id < table->num_columns())
+      << kind << " label " << label_id << " has no property " << prop_id;
+  CHECK(!IsEncodedField(table->field(prop_id)))
+      << "The property " << prop_id << " of " << kind << " label "
+      << label_id << " is encoded by compress_properties";
+  auto column = table->column(prop_id);
+  CHECK(column->type()->Equals(vineyard::ConvertToArrowType<T>::TypeValue()))
+      << "The property " << prop_id << " of " << kind << " label "
+      << label_id << " is " << column->type()->ToString() << ", expects "
+      << vineyard::ConvertToArrowType<T>::TypeValue()->ToString();
+  if (table->num_rows() == 0) {
+    return nullptr;
+  }
+  CHECK_EQ(column->num_chunks(), 1);
+  return std::dynamic_pointer_cast<
+             typename vineyard::ConvertToArrowType<T>::ArrayType>(
+             column->chunk(0))
+      ->raw_values();
+}
+
+}  // namespace schema_binding_impl
+
+/**
+ * @brief The raw column of a vertex property of type T for each vertex label,
+ * which is resolved once by Bind, so reading the property of an inner vertex
+ * is an offset into the column. Properties of outer vertices are not
+ * available.
+ *
+ * @tparam FRAG_T Labeled fragment class, e.g., vineyard::ArrowFragment
+ * @tparam T The type of the property, a primitive arrow type
+ */
+template <typename FRAG_T, typename T>
+class VertexPropertyBinding {
+  static_assert(std::is_arithmetic<T>::value,
+                "Only the primitive properties can be bound");
+  using vertex_t = typename FRAG_T::vertex_t;
+  using label_id_t = typename FRAG_T::label_id_t;
+  using prop_id_t = typename FRAG_T::prop_id_t;
+
+ public:
+  // binds the prop_id-th property of each vertex label
+  void Bind(const FRAG_T& frag, prop_id_t prop_id) {
+    label_id_t v_label_num = frag.vertex_label_num();
+    columns_.assign(v_label_num, nullptr);
+    for (label_id_t v_label = 0; v_label < v_label_num; ++v_label) {
+      columns_[v_label] = schema_binding_impl::column_values<T>(
+          frag.vertex_data_table(v_label), prop_id, "Vertex", v_label);
+    }
+  }
+
+  // binds the properties named name of the vertex labels
+  void Bind(const FRAG_T& frag, const std::string& name) {
+    label_id_t v_label_num = frag.vertex_label_num();
+    columns_.assign(v_label_num, nullptr);
+    for (label_id_t v_label = 0; v_label < v_label_num; ++v_label) {
+      auto prop_id = frag.schema().GetVertexPropertyId(v_label, name);
+      CHECK_GE(prop_id, 0) << "Vertex label " << static_cast<int>(v_label)
+                           << " has no property " << name;
+      columns_[v_label] = schema_binding_impl::column_values<T>(
+          frag.vertex_data_table(v_label), prop_id, "Vertex", v_label);
+    }
+  }
+
+  inline T operator()(const FRAG_T& frag, label_id_t v_label,
+                      const vertex_t& v) const {
+    return columns_[v_label][frag.vertex_offset(v)];
+  }
+
+  inline const T* column(label_id_t v_label) const {
+    return columns_[v_label];
+  }
+
+ private:
+  std::vector<const T*> columns_;
+};
+
+/**
+ * @brief The raw column of an edge property of type T for each edge label,
+ * which is resolved once by Bind, so reading the property of an edge is an
+ * offset into the column by the edge id.
+ *
+ * @tparam FRAG_T Labeled fragment class, e.g., vineyard::ArrowFragment
+ * @tparam T The type of the property, a primitive arrow type
+ */
+template <typename FRAG_T, typename T>
+class EdgePropertyBinding {
+  static_assert(std::is_arithmetic<T>::value,
+                "Only the primitive properties can be bound");
+  using label_id_t = typename FRAG_T::label_id_t;
+  using prop_id_t = typename FRAG_T::prop_id_t;
+
+ public:
+  // binds the prop_id-th property of each edge label
+  void Bind(const FRAG_T& frag, prop_id_t prop_id) {
+    label_id_t e_label_num = frag.edge_label_num();
+    columns_.assign(e_label_num, nullptr);
+    for (label_id_t e_label = 0; e_label < e_label_num; ++e_label) {
+      columns_[e_label] = schema_binding_impl::column_values<T>(
+          frag.edge_data_table(e_label), prop_id, "Edge", e_label);
+    }
+  }
+
+  // binds the properties named name of the edge labels
+  void Bind(const FRAG_T& frag, const std::string& name) {
+    label_id_t e_label_num = frag.edge_label_num();
+    columns_.assign(e_label_num, nullptr);
+    for (label_id_t e_label = 0; e_label < e_label_num; ++e_label) {
+      auto prop_id = frag.schema().GetEdgePropertyId(e_label, name);
+      CHECK_GE(prop_id, 0) << "Edge label " << static_cast<int>(e_label)
+                           << " has no property " << name;
+      columns_[e_label] = schema_binding_impl::column_values<T>(
+          frag.edge_data_table(e_label), prop_id, "Edge", e_label);
+    }
+  }
+
+  template <typename NBR_T>
+  inline T operator()(label_id_t e_label, const NBR_T& e) const {
+    return columns_[e_label][e.edge_id()];
+  }
+
+  inline const T* column(label_id_t e_label) const {
+    return columns_[e_label];
+  }
+
+ private:
+  std::vector<const T*> columns_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_APP_PROPERTY_SCHEMA_BINDING_H_
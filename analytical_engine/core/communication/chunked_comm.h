@@ -0,0 +1,257 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_COMMUNICATION_CHUNKED_COMM_H_
+#define ANALYTICAL_ENGINE_CORE_COMMUNICATION_CHUNKED_COMM_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "grape/serialization/out_archive.h"
+
+namespace gs {
+
+/**
+ * @brief Buffers larger than the int count of a single MPI message are split
+ * into pieces of kChunkBytes.
+ */
+static constexpr size_t kChunkBytes = static_cast<size_t>(1) << 30;
+
+/**
+ * @brief Sends the buffer as one or more messages with the same tag without
+ * waiting for them, the requests are appended to reqs and the buffer must be
+ * kept until they complete. A piece of exactly kChunkBytes means more pieces
+ * follow, so a buffer whose size is a multiple of kChunkBytes ends with an
+ * empty piece. Buffers smaller than kChunkBytes are sent as a single message
+ * as before.
+ */
+inline void IsendChunked(const void* ptr, size_t size, int dst_worker_id,
+                         int tag, MPI_Comm comm,
+                         std::vector<MPI_Request>& reqs) {
+  const char* begin = static_cast<const char*>(ptr);
+  size_t offset = 0;
+  while (true) {
+    size_t piece = std::min(kChunkBytes, size - offset);
+    MPI_Request req;
+    MPI_Isend(begin + offset, static_cast<int>(piece), MPI_CHAR,
+              dst_worker_id, tag, comm, &req);
+    reqs.push_back(req);
+    offset += piece;
+    if (piece < kChunkBytes) {
+      break;
+    }
+  }
+}
+
+/**
+ * @brief Receives a buffer sent by IsendChunked, whose first piece has been
+ * probed as status. grow(size) must enlarge the destination by size bytes
+ * and return the address of the enlarged part. The rest pieces are received
+ * from the same source and tag, which MPI delivers in order.
+ */
+template <typename GROW_FUNC_T>
+inline void RecvChunked(const MPI_Status& status, MPI_Comm comm,
+                        const GROW_FUNC_T& grow) {
+  int src_worker_id = status.MPI_SOURCE;
+  int tag = status.MPI_TAG;
+  int count;
+  MPI_Get_count(&status, MPI_CHAR, &count);
+  while (true) {
+    char* buffer = grow(static_cast<size_t>(count));
+    MPI_Recv(buffer, count, MPI_CHAR, src_worker_id, tag, comm,
+             MPI_STATUS_IGNORE);
+    if (static_cast<size_t>(count) < kChunkBytes) {
+      break;
+    }
+    MPI_Status next_status;
+    MPI_Probe(src_worker_id, tag, comm, &next_status);
+    MPI_Get_count(&next_status, MPI_CHAR, &count);
+  }
+}
+
+/**
+ * @brief Receives a buffer sent by IsendChunked into a vector.
+ */
+inline void RecvChunked(const MPI_Status& status, MPI_Comm comm,
+                        std::vector<char>& buffer) {
+  buffer.clear();
+  RecvChunked(status, comm, [&buffer](size_t size) {
+    size_t old_size = buffer.size();
+    buffer.resize(old_size + size);
+    return buffer.data() + old_size;
+  });
+}
+
+/**
+ * @brief Broadcasts the buffer of the root to the other workers of comm, by
+ * its size followed by the pieces of kChunkBytes, so buffers beyond the int
+ * count of MPI_Bcast can be broadcast, see BcastRecvChunked.
+ */
+inline void BcastSendChunked(const void* ptr, size_t size, int root,
+                             MPI_Comm comm) {
+  uint64_t total = size;
+  MPI_Bcast(&total, 1, MPI_UINT64_T, root, comm);
+  char* begin = const_cast<char*>(static_cast<const char*>(ptr));
+  for (size_t offset = 0; offset < size; offset += kChunkBytes) {
+    size_t piece = std::min(kChunkBytes, size - offset);
+    MPI_Bcast(begin + offset, static_cast<int>(piece), MPI_CHAR, root, comm);
+  }
+}
+
+/**
+ * @brief Receives a buffer broadcast by BcastSendChunked into a vector.
+ */
+inline void BcastRecvChunked(std::vector<char>& buffer, int root,
+                             MPI_Comm comm) {
+  uint64_t total;
+  MPI_Bcast(&total, 1, MPI_UINT64_T, root, comm);
+  buffer.resize(total);
+  for (size_t offset = 0; offset < total; offset += kChunkBytes) {
+    size_t piece = std::min(kChunkBytes, static_cast<size_t>(total) - offset);
+    MPI_Bcast(buffer.data() + offset, static_cast<int>(piece), MPI_CHAR, root,
+              comm);
+  }
+}
+
+namespace chunked_comm_impl {
+
+using send_segment_t = std::pair<const char*, size_t>;
+
+// the pieces of a round of AlltoallvChunked, of which the displacements fit
+// the int ones of MPI_Alltoallv
+struct AlltoallvRound {
+  std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+  std::vector<char> send_buffer, recv_buffer;
+  MPI_Request req = MPI_REQUEST_NULL;
+
+  void Init(int worker_num) {
+    send_counts.resize(worker_num);
+    recv_counts.resize(worker_num);
+    send_displs.resize(worker_num + 1);
+    recv_displs.resize(worker_num + 1);
+  }
+
+  void Pack(const std::vector<send_segment_t>& send,
+            const std::vector<uint64_t>& recv_sizes, size_t offset,
+            size_t piece) {
+    size_t worker_num = send_counts.size();
+    send_displs[0] = recv_displs[0] = 0;
+    for (size_t i = 0; i < worker_num; ++i) {
+      size_t send_size = send[i].second;
+      send_counts[i] = static_cast<int>(
+          offset < send_size ? std::min(piece, send_size - offset) : 0);
+      recv_counts[i] = static_cast<int>(
+          offset < recv_sizes[i] ? std::min(piece, recv_sizes[i] - offset) : 0);
+      send_displs[i + 1] = send_displs[i] + send_counts[i];
+      recv_displs[i + 1] = recv_displs[i] + recv_counts[i];
+    }
+    send_buffer.resize(send_displs[worker_num]);
+    recv_buffer.resize(recv_displs[worker_num]);
+    for (size_t i = 0; i < worker_num; ++i) {
+      if (send_counts[i] != 0) {
+        memcpy(send_buffer.data() + send_displs[i], send[i].first + offset,
+               send_counts[i]);
+      }
+    }
+  }
+
+  void Start(MPI_Comm comm) {
+    MPI_Ialltoallv(send_buffer.data(), send_counts.data(), send_displs.data(),
+                   MPI_CHAR, recv_buffer.data(), recv_counts.data(),
+                   recv_displs.data(), MPI_CHAR, comm, &req);
+  }
+
+  void Unpack(std::vector<grape::OutArchive>& recv, size_t offset) {
+    MPI_Wait(&req, MPI_STATUS_IGNORE);
+    for (size_t i = 0; i < recv_counts.size(); ++i) {
+      if (recv_counts[i] != 0) {
+        memcpy(recv[i].GetBuffer() + offset,
+               recv_buffer.data() + recv_displs[i], recv_counts[i]);
+      }
+    }
+  }
+};
+
+}  // namespace chunked_comm_impl
+
+/**
+ * @brief Sends the buffer send[i] to worker i and receives recv[i] from
+ * worker i of comm, by MPI_Ialltoallv in rounds. In each round every pair of
+ * workers exchanges up to a piece of their buffers, so the total of a worker
+ * may exceed the int displacements of a single MPI_Alltoallv. The next round
+ * is packed while the last one is in flight. The send buffers may alias each
+ * other, e.g., to send the same buffer to every worker.
+ */
+inline void AlltoallvChunked(
+    const std::vector<chunked_comm_impl::send_segment_t>& send,
+    std::vector<grape::OutArchive>& recv, MPI_Comm comm) {
+  int worker_num;
+  MPI_Comm_size(comm, &worker_num);
+  std::vector<uint64_t> send_sizes(worker_num), recv_sizes(worker_num);
+  for (int i = 0; i < worker_num; ++i) {
+    send_sizes[i] = send[i].second;
+  }
+  MPI_Alltoall(send_sizes.data(), 1, MPI_UINT64_T, recv_sizes.data(), 1,
+               MPI_UINT64_T, comm);
+
+  uint64_t max_size = 0;
+  for (int i = 0; i < worker_num; ++i) {
+    max_size = std::max(max_size, std::max(send_sizes[i], recv_sizes[i]));
+  }
+  MPI_Allreduce(MPI_IN_PLACE, &max_size, 1, MPI_UINT64_T, MPI_MAX, comm);
+  size_t piece = std::max<size_t>(
+      1, std::min(kChunkBytes,
+                  static_cast<size_t>(std::numeric_limits<int>::max()) /
+                      worker_num));
+  size_t round_num = (max_size + piece - 1) / piece;
+
+  recv.clear();
+  recv.resize(worker_num);
+  for (int i = 0; i < worker_num; ++i) {
+    if (recv_sizes[i] != 0) {
+      recv[i].Allocate(recv_sizes[i]);
+    }
+  }
+
+  chunked_comm_impl::AlltoallvRound rounds[2];
+  rounds[0].Init(worker_num);
+  rounds[1].Init(worker_num);
+  if (round_num != 0) {
+    rounds[0].Pack(send, recv_sizes, 0, piece);
+    rounds[0].Start(comm);
+  }
+  for (size_t round = 0; round < round_num; ++round) {
+    auto& curr = rounds[round % 2];
+    auto& next = rounds[(round + 1) % 2];
+    if (round + 1 < round_num) {
+      next.Pack(send, recv_sizes, (round + 1) * piece, piece);
+    }
+    curr.Unpack(recv, round * piece);
+    if (round + 1 < round_num) {
+      next.Start(comm);
+    }
+  }
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_COMMUNICATION_CHUNKED_COMM_H_
@@ -15,11 +15,122 @@
 #ifndef ANALYTICAL_ENGINE_CORE_COMMUNICATION_SHUFFLE_H_
 #define ANALYTICAL_ENGINE_CORE_COMMUNICATION_SHUFFLE_H_
 
+#include <algorithm>
+#include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "grape/communication/shuffle.h"
 #include "vineyard/graph/utils/string_collection.h"
 
+#include "core/communication/chunked_comm.h"
+
+namespace gs {
+
+namespace shuffle_impl {
+
+// payloads up to this size are sent in the same message as the header, the
+// larger ones are sent in pieces of kChunkBytes after it
+static constexpr size_t kInlineBytes = 64 * 1024;
+
+using send_segment_t = std::pair<const void*, size_t>;
+using recv_segment_t = std::pair<void*, size_t>;
+
+inline void send_chunked(const void* ptr, size_t size, int dst_worker_id,
+                         int tag, MPI_Comm comm) {
+  const char* begin = static_cast<const char*>(ptr);
+  for (size_t offset = 0; offset < size; offset += kChunkBytes) {
+    int count = static_cast<int>(std::min(kChunkBytes, size - offset));
+    MPI_Send(begin + offset, count, MPI_CHAR, dst_worker_id, tag, comm);
+  }
+}
+
+inline void recv_chunked(void* ptr, size_t size, int src_worker_id, int tag,
+                         MPI_Comm comm) {
+  char* begin = static_cast<char*>(ptr);
+  for (size_t offset = 0; offset < size; offset += kChunkBytes) {
+    int count = static_cast<int>(std::min(kChunkBytes, size - offset));
+    MPI_Recv(begin + offset, count, MPI_CHAR, src_worker_id, tag, comm,
+             MPI_STATUS_IGNORE);
+  }
+}
+
+/**
+ * @brief Sends a POD header followed by the segments. When the segments are
+ * small they are packed with the header into a single message, otherwise
+ * each segment is sent in chunks of at most kChunkBytes after the header.
+ */
+template <typename HEADER_T>
+inline void SendFramed(const HEADER_T& header,
+                       const std::vector<send_segment_t>& segments,
+                       int dst_worker_id, int tag, MPI_Comm comm) {
+  size_t total = 0;
+  for (auto& seg : segments) {
+    total += seg.second;
+  }
+  if (total <= kInlineBytes) {
+    std::vector<char> message(sizeof(HEADER_T) + total);
+    memcpy(message.data(), &header, sizeof(HEADER_T));
+    size_t offset = sizeof(HEADER_T);
+    for (auto& seg : segments) {
+      if (seg.second) {
+        memcpy(message.data() + offset, seg.first, seg.second);
+        offset += seg.second;
+      }
+    }
+    MPI_Send(message.data(), static_cast<int>(message.size()), MPI_CHAR,
+             dst_worker_id, tag, comm);
+  } else {
+    MPI_Send(&header, static_cast<int>(sizeof(HEADER_T)), MPI_CHAR,
+             dst_worker_id, tag, comm);
+    for (auto& seg : segments) {
+      send_chunked(seg.first, seg.second, dst_worker_id, tag, comm);
+    }
+  }
+}
+
+/**
+ * @brief Receives a message sent by SendFramed. prepare(header) is called
+ * once the header arrives, and returns the destinations of the segments,
+ * which must have the same sizes as the sent ones.
+ */
+template <typename HEADER_T, typename PREPARE_FUNC_T>
+inline void RecvFramed(const PREPARE_FUNC_T& prepare, int src_worker_id,
+                       int tag, MPI_Comm comm) {
+  MPI_Message msg;
+  MPI_Status status;
+  MPI_Mprobe(src_worker_id, tag, comm, &msg, &status);
+  int count = 0;
+  MPI_Get_count(&status, MPI_CHAR, &count);
+
+  HEADER_T header;
+  if (static_cast<size_t>(count) == sizeof(HEADER_T)) {
+    MPI_Mrecv(&header, count, MPI_CHAR, &msg, MPI_STATUS_IGNORE);
+    std::vector<recv_segment_t> segments = prepare(header);
+    for (auto& seg : segments) {
+      recv_chunked(seg.first, seg.second, src_worker_id, tag, comm);
+    }
+  } else {
+    std::vector<char> message(count);
+    MPI_Mrecv(message.data(), count, MPI_CHAR, &msg, MPI_STATUS_IGNORE);
+    memcpy(&header, message.data(), sizeof(HEADER_T));
+    std::vector<recv_segment_t> segments = prepare(header);
+    size_t offset = sizeof(HEADER_T);
+    for (auto& seg : segments) {
+      if (seg.second) {
+        memcpy(seg.first, message.data() + offset, seg.second);
+        offset += seg.second;
+      }
+    }
+    CHECK_EQ(offset, message.size());
+  }
+}
+
+}  // namespace shuffle_impl
+
+}  // namespace gs
+
 namespace grape {
 /**
  * @brief ShuffleUnit wraps a vector, for data shuffling between workers.
@@ -42,24 +153,23 @@ class ShuffleUnit<std::string> {
 
   void SendTo(int dst_worker_id, int tag, MPI_Comm comm) {
     rsv_header header(buffer_.size_in_bytes(), buffer_.size());
-    MPI_Send(&header, static_cast<int>(sizeof(rsv_header)), MPI_CHAR,
-             dst_worker_id, tag, comm);
-    if (header.size) {
-      MPI_Send(buffer_.data(), static_cast<int>(header.size), MPI_CHAR,
-               dst_worker_id, tag, comm);
-    }
+    gs::shuffle_impl::SendFramed(header, {{buffer_.data(), header.size}},
+                                 dst_worker_id, tag, comm);
   }
 
   void RecvFrom(int src_worker_id, int tag, MPI_Comm comm) {
     size_t old_size = buffer_.size_in_bytes();
-    rsv_header header;
-    MPI_Recv(&header, static_cast<int>(sizeof(rsv_header)), MPI_CHAR,
-             src_worker_id, tag, comm, MPI_STATUS_IGNORE);
-    if (header.size) {
-      buffer_.resize(header.size + old_size, header.count + buffer_.size());
-      MPI_Recv(buffer_.data() + old_size, static_cast<int>(header.size),
-               MPI_CHAR, src_worker_id, tag, comm, MPI_STATUS_IGNORE);
-    }
+    gs::shuffle_impl::RecvFramed<rsv_header>(
+        [&, this](const rsv_header& header) {
+          std::vector<gs::shuffle_impl::recv_segment_t> segments;
+          if (header.size) {
+            buffer_.resize(header.size + old_size,
+                           header.count + buffer_.size());
+            segments.emplace_back(buffer_.data() + old_size, header.size);
+          }
+          return segments;
+        },
+        src_worker_id, tag, comm);
   }
 
  private:
@@ -39,6 +39,8 @@ class IColumn {
   virtual ContextDataType type() const { return ContextDataType::kUndefined; }
   virtual std::shared_ptr<arrow::Array> ToArrowArray() const = 0;
 
+  virtual size_t MemoryUsage() const { return 0; }
+
  private:
   std::string name_;
 };
@@ -83,6 +85,10 @@ class Column : public IColumn {
     return ret;
   }
 
+  size_t MemoryUsage() const override {
+    return data_.GetVertexRange().size() * sizeof(DATA_T);
+  }
+
   DATA_T& at(vertex_t v) { return data_[v]; }
 
   const DATA_T& at(vertex_t v) const { return data_[v]; }
@@ -66,10 +66,12 @@ class IVertexDataContextWrapper : public IContextWrapper {
       const grape::CommSpec& comm_spec, const Selector& selector,
       const std::pair<std::string, std::string>& range) = 0;
 
+  // the vertices kept by a top k limit are in descending order of the data
   virtual bl::result<std::unique_ptr<grape::InArchive>> ToDataframe(
       const grape::CommSpec& comm_spec,
       const std::vector<std::pair<std::string, Selector>>& selectors,
-      const std::pair<std::string, std::string>& range) = 0;
+      const std::pair<std::string, std::string>& range,
+      const VertexLimit& limit = VertexLimit()) = 0;
 
   virtual bl::result<vineyard::ObjectID> ToVineyardTensor(
       const grape::CommSpec& comm_spec, vineyard::Client& client,
@@ -103,10 +105,12 @@ class ILabeledVertexDataContextWrapper : public IContextWrapper {
       const grape::CommSpec& comm_spec, const LabeledSelector& selector,
       const std::pair<std::string, std::string>& range) = 0;
 
+  // the vertices kept by a top k limit are in descending order of the data
   virtual bl::result<std::unique_ptr<grape::InArchive>> ToDataframe(
       const grape::CommSpec& comm_spec,
       const std::vector<std::pair<std::string, LabeledSelector>>& selectors,
-      const std::pair<std::string, std::string>& range) = 0;
+      const std::pair<std::string, std::string>& range,
+      const VertexLimit& limit = VertexLimit()) = 0;
 
   virtual bl::result<vineyard::ObjectID> ToVineyardTensor(
       const grape::CommSpec& comm_spec, vineyard::Client& client,
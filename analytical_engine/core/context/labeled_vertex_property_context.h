@@ -184,6 +184,16 @@ class LabeledVertexPropertyContextWrapper
     return frag_wrapper_;
   }
 
+  size_t MemoryUsage() const override {
+    size_t bytes = 0;
+    for (auto& columns : ctx_->vertex_properties()) {
+      for (auto& column : columns) {
+        bytes += column->MemoryUsage();
+      }
+    }
+    return bytes;
+  }
+
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const LabeledSelector& selector,
       const std::pair<std::string, std::string>& range) override {
@@ -288,6 +298,7 @@ class LabeledVertexPropertyContextWrapper
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
+    std::vector<std::pair<size_t, size_t>> columns;
     for (auto& pair : selectors) {
       auto& col_name = pair.first;
       auto& selector = pair.second;
@@ -344,8 +355,9 @@ class LabeledVertexPropertyContextWrapper
                 selector.str());
       }
 
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
     return arc;
   }
 
@@ -512,7 +524,8 @@ class LabeledVertexPropertyContextWrapper
       }
       case SelectorType::kVertexData: {
         auto prop_id = selector.property_id();
-        arr = trans_utils.VertexPropertyToArrowArray(label_id, prop_id);
+        BOOST_LEAF_ASSIGN(
+            arr, trans_utils.VertexPropertyToArrowArray(label_id, prop_id));
         break;
       }
       case SelectorType::kResult: {
@@ -350,5 +350,46 @@ class LabeledSelector : public Selector {
   label_id_t label_id_;
   prop_id_t property_id_;
 };
+
+/**
+ * @brief VertexLimit restricts the vertices retrieved from a context, to the k
+ * ones with the largest results of each worker, or to a sample of k vertices
+ * stratified by the fragments, so the size of the retrieved data is O(k *
+ * fnum) rather than the number of vertices.
+ */
+struct VertexLimit {
+  enum class Type { kNone, kTopK, kSample };
+
+  Type type = Type::kNone;
+  size_t k = 0;
+  uint64_t seed = 0;
+
+  /**
+   * @brief parse the limit from a json string.
+   *
+   * @param s_limit JSON {"top_k": k} or {"sample": k, "seed": seed}
+   */
+  static bl::result<VertexLimit> Parse(const std::string& s_limit) {
+    std::stringstream ss(s_limit);
+    boost::property_tree::ptree pt;
+    VertexLimit limit;
+
+    try {
+      boost::property_tree::read_json(ss, pt);
+      if (pt.count("top_k")) {
+        limit.type = Type::kTopK;
+        limit.k = pt.get<size_t>("top_k");
+      } else if (pt.count("sample")) {
+        limit.type = Type::kSample;
+        limit.k = pt.get<size_t>("sample");
+        limit.seed = pt.get<uint64_t>("seed", 0);
+      }
+    } catch (boost::property_tree::ptree_error& e) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Failed to parse json: " + s_limit);
+    }
+    return limit;
+  }
+};
 }  // namespace gs
 #endif  // ANALYTICAL_ENGINE_CORE_CONTEXT_SELECTOR_H_
@@ -17,6 +17,7 @@
 #define ANALYTICAL_ENGINE_CORE_CONTEXT_TENSOR_CONTEXT_H_
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -77,20 +78,13 @@ inline InArchive& operator<<(
 }  // namespace grape
 
 namespace gs {
-template <typename T>
-static bl::result<size_t> get_n_dim(const grape::CommSpec& comm_spec,
-                                    const trivial_tensor_t<T>& tensor) {
-  auto shape = tensor.shape();
-  auto n_dim = shape.size();
-  std::vector<size_t> n_dims;
-
-  vineyard::GlobalAllGatherv<size_t>(n_dim, n_dims, comm_spec);
-
+inline bl::result<size_t> get_n_dim(
+    const std::vector<std::vector<size_t>>& shapes) {
   // find out first n-dim of non empty shape
-  n_dim = 0;
-  for (auto e : n_dims) {
-    if (e != 0) {
-      n_dim = e;
+  size_t n_dim = 0;
+  for (auto& sp : shapes) {
+    if (!sp.empty()) {
+      n_dim = sp.size();
       break;
     }
   }
@@ -99,8 +93,8 @@ static bl::result<size_t> get_n_dim(const grape::CommSpec& comm_spec,
                     "Every tensor is 0-dim.");
   }
 
-  for (auto e : n_dims) {
-    if (e != 0 && e != n_dim) {
+  for (auto& sp : shapes) {
+    if (!sp.empty() && sp.size() != n_dim) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
                       "Dim count is not consistent.");
     }
@@ -108,16 +102,9 @@ static bl::result<size_t> get_n_dim(const grape::CommSpec& comm_spec,
   return n_dim;
 }
 
-template <typename T>
-static bl::result<std::vector<size_t>> get_non_empty_shape(
-    const grape::CommSpec& comm_spec, const trivial_tensor_t<T>& tensor,
-    uint32_t axis) {
-  BOOST_LEAF_AUTO(n_dim, get_n_dim<T>(comm_spec, tensor));
-  auto shape = tensor.shape();
-  std::vector<std::vector<std::size_t>> shapes;
-  vineyard::GlobalAllGatherv<std::vector<std::size_t>>(shape, shapes,
-                                                       comm_spec);
-
+inline bl::result<std::vector<size_t>> get_non_empty_shape(
+    const std::vector<std::vector<size_t>>& shapes, uint32_t axis) {
+  BOOST_LEAF_AUTO(n_dim, get_n_dim(shapes));
   std::vector<size_t> first_shape;
   // find out first non-empty shape
   for (auto& sp : shapes) {
@@ -127,11 +114,6 @@ static bl::result<std::vector<size_t>> get_non_empty_shape(
     }
   }
 
-  if (first_shape.empty()) {
-    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                    "Every tensor is 0-dim.");
-  }
-
   // for every dim except the dim to concat
   for (uint32_t i = 0; i < n_dim; i++) {
     if (i != axis) {
@@ -146,23 +128,19 @@ static bl::result<std::vector<size_t>> get_non_empty_shape(
   return first_shape;
 }
 
-template <typename T>
-static bl::result<size_t> get_n_column(const grape::CommSpec& comm_spec,
-                                       const trivial_tensor_t<T>& tensor) {
-  auto shape = tensor.shape();
-  if (!shape.empty() && shape.size() != 2) {
-    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                    "This is not a 2-dim tensor.");
+inline bl::result<size_t> get_n_column(
+    const std::vector<std::vector<size_t>>& shapes) {
+  for (auto& sp : shapes) {
+    if (!sp.empty() && sp.size() != 2) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "This is not a 2-dim tensor.");
+    }
   }
 
-  auto n_col = shape.empty() ? 0 : shape[1];
-  std::vector<size_t> n_cols;
-
-  vineyard::GlobalAllGatherv<size_t>(n_col, n_cols, comm_spec);
-
-  for (auto e : n_cols) {
-    if (e != 0) {
-      n_col = e;
+  size_t n_col = 0;
+  for (auto& sp : shapes) {
+    if (!sp.empty() && sp[1] != 0) {
+      n_col = sp[1];
       break;
     }
   }
@@ -172,18 +150,46 @@ static bl::result<size_t> get_n_column(const grape::CommSpec& comm_spec,
                     "Every tensor is empty.");
   }
 
-  for (auto e : n_cols) {
-    if (e != 0 && e != n_col) {
+  for (auto& sp : shapes) {
+    if (!sp.empty() && sp[1] != 0 && sp[1] != n_col) {
       std::stringstream ss;
       ss << "Number of column is not same. ";
       ss << "The column number of first non-empty is " << n_col;
-      ss << ". But this one is " << e;
+      ss << ". But this one is " << sp[1];
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError, ss.str());
     }
   }
   return n_col;
 }
 
+template <typename T>
+static std::vector<std::vector<size_t>> gather_shapes(
+    const grape::CommSpec& comm_spec, const trivial_tensor_t<T>& tensor) {
+  std::vector<std::vector<size_t>> shapes;
+  vineyard::GlobalAllGatherv<std::vector<size_t>>(tensor.shape(), shapes,
+                                                  comm_spec);
+  return shapes;
+}
+
+template <typename T>
+static bl::result<size_t> get_n_dim(const grape::CommSpec& comm_spec,
+                                    const trivial_tensor_t<T>& tensor) {
+  return get_n_dim(gather_shapes(comm_spec, tensor));
+}
+
+template <typename T>
+static bl::result<std::vector<size_t>> get_non_empty_shape(
+    const grape::CommSpec& comm_spec, const trivial_tensor_t<T>& tensor,
+    uint32_t axis) {
+  return get_non_empty_shape(gather_shapes(comm_spec, tensor), axis);
+}
+
+template <typename T>
+static bl::result<size_t> get_n_column(const grape::CommSpec& comm_spec,
+                                       const trivial_tensor_t<T>& tensor) {
+  return get_n_column(gather_shapes(comm_spec, tensor));
+}
+
 /**
  * @brief TensorContext is designed for holding a bunch of computation results.
  * The TensorContext should be used if the number of elements are
@@ -335,6 +341,7 @@ class TensorContextWrapper : public ITensorContextWrapper {
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
+    std::vector<std::pair<size_t, size_t>> columns;
     for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
       if (comm_spec.worker_id() == grape::kCoordinatorRank) {
         *arc << "Col " + std::to_string(col_idx);  // Column name
@@ -348,8 +355,9 @@ class TensorContextWrapper : public ITensorContextWrapper {
         auto idx = row_idx * n_col + col_idx;
         *arc << tensor.data()[idx];
       }
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
     return arc;
   }
 
@@ -472,9 +480,130 @@ class TensorContextWrapper : public ITensorContextWrapper {
 };
 
 #ifdef NETWORKX
+/**
+ * @brief DynamicTensorMeta holds the shapes and the element types of the
+ * folly::dynamic tensors of all workers, which are exchanged by a single
+ * collective. The type of a tensor is the one shared by all of its elements,
+ * where a mixture of int64 and double is taken as double.
+ */
+struct DynamicTensorMeta {
+  static constexpr size_t kMixedType = std::numeric_limits<size_t>::max();
+
+  std::vector<std::vector<size_t>> shapes;
+  std::vector<size_t> types;
+
+  static DynamicTensorMeta Gather(
+      const grape::CommSpec& comm_spec,
+      const trivial_tensor_t<folly::dynamic>& tensor) {
+    // the type of the tensor, followed by the shape
+    std::vector<size_t> local{localType(tensor)};
+    auto shape = tensor.shape();
+    local.insert(local.end(), shape.begin(), shape.end());
+    std::vector<std::vector<size_t>> gathered;
+    vineyard::GlobalAllGatherv<std::vector<size_t>>(local, gathered,
+                                                    comm_spec);
+
+    DynamicTensorMeta meta;
+    for (auto& e : gathered) {
+      meta.types.push_back(e[0]);
+      meta.shapes.emplace_back(e.begin() + 1, e.end());
+    }
+    return meta;
+  }
+
+  bl::result<folly::dynamic::Type> type() const {
+    size_t type = folly::dynamic::NULLT;
+    for (auto e : types) {
+      if (e == folly::dynamic::NULLT) {
+        continue;
+      }
+      type = type == folly::dynamic::NULLT ? e : mergeType(type, e);
+      if (type == kMixedType) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
+                        "The types of folly:dynamic is not same.");
+      }
+    }
+    if (type == folly::dynamic::NULLT) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "All folly::dynamic are empty");
+    }
+    return static_cast<folly::dynamic::Type>(type);
+  }
+
+  // the sum of the dim of the tensors, i.e., the dim after combined
+  size_t total_dim(uint32_t axis) const {
+    size_t total = 0;
+    for (auto& sp : shapes) {
+      total += sp.size() > axis ? sp[axis] : 0;
+    }
+    return total;
+  }
+
+ private:
+  static size_t mergeType(size_t lhs, size_t rhs) {
+    if (lhs == rhs) {
+      return lhs;
+    }
+    auto numeric = [](size_t t) {
+      return t == folly::dynamic::INT64 || t == folly::dynamic::DOUBLE;
+    };
+    return numeric(lhs) && numeric(rhs) ? folly::dynamic::DOUBLE : kMixedType;
+  }
+
+  static size_t localType(const trivial_tensor_t<folly::dynamic>& tensor) {
+    size_t type = folly::dynamic::NULLT;
+    for (size_t i = 0; i < tensor.size(); ++i) {
+      size_t elem_type = tensor.data()[i].type();
+      type = i == 0 ? elem_type : mergeType(type, elem_type);
+      if (type == kMixedType) {
+        break;
+      }
+    }
+    return type;
+  }
+};
+
+template <typename T>
+inline T dynamic_value_as(const folly::dynamic& value);
+
+template <>
+inline int64_t dynamic_value_as<int64_t>(const folly::dynamic& value) {
+  return value.getInt();
+}
+
+template <>
+inline double dynamic_value_as<double>(const folly::dynamic& value) {
+  return value.isDouble() ? value.getDouble()
+                          : static_cast<double>(value.getInt());
+}
+
+template <>
+inline std::string dynamic_value_as<std::string>(const folly::dynamic& value) {
+  return value.getString();
+}
+
+/**
+ * @brief Serializes n elements of the tensor as T, the i-th of which is at
+ * begin + i * stride, into a block of the archive filled in parallel.
+ */
+template <typename T>
+void serialize_dynamic_tensor(grape::InArchive& arc,
+                              const trivial_tensor_t<folly::dynamic>& tensor,
+                              size_t begin, size_t stride, size_t n) {
+  size_t old_size = arc.GetSize();
+  arc.Resize(old_size + n * sizeof(T));
+  char* dst = arc.GetBuffer() + old_size;
+  const folly::dynamic* src = tensor.data() + begin;
+  parallel_fill(n, [dst, src, stride](size_t i) {
+    T value = dynamic_value_as<T>(src[i * stride]);
+    memcpy(dst + i * sizeof(T), &value, sizeof(T));
+  });
+}
+
 /**
  * @brief This is the specialized TensorContextWrapper for folly::dynamic type
- * of oid
+ * of oid. The elements are converted to the type shared by them all, instead
+ * of being serialized one by one.
  * @tparam FRAG_T
  * @tparam DATA_T
  */
@@ -505,11 +634,11 @@ class TensorContextWrapper<
 
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, uint32_t axis) override {
-    auto shape = ctx_->shape();
     auto& tensor = ctx_->tensor();
     auto arc = std::make_unique<grape::InArchive>();
+    auto meta = DynamicTensorMeta::Gather(comm_spec, tensor);
 
-    BOOST_LEAF_AUTO(n_dim, get_n_dim<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_dim, get_n_dim(meta.shapes));
 
     if (axis >= n_dim) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
@@ -517,8 +646,8 @@ class TensorContextWrapper<
                           ", n-dim: " + std::to_string(n_dim));
     }
 
-    BOOST_LEAF_AUTO(first_shape, get_non_empty_shape(comm_spec, tensor, axis));
-    BOOST_LEAF_AUTO(data_type, get_dynamic_type(comm_spec, tensor));
+    BOOST_LEAF_AUTO(first_shape, get_non_empty_shape(meta.shapes, axis));
+    BOOST_LEAF_AUTO(data_type, meta.type());
 
     if (data_type != folly::dynamic::INT64 &&
         data_type != folly::dynamic::DOUBLE) {
@@ -527,13 +656,9 @@ class TensorContextWrapper<
           "Only support folly::dynamic::INT64 or folly::dynamic::DOUBLE");
     }
 
-    int64_t local_num = shape[axis], total_num;
-
     if (comm_spec.fid() == 0) {
-      MPI_Reduce(&local_num, &total_num, 1, MPI_INT64_T, MPI_SUM,
-                 comm_spec.worker_id(), comm_spec.comm());
-      *arc << static_cast<int64_t>(n_dim);  // shape size
-      first_shape[axis] = total_num;        // shape after combined
+      *arc << static_cast<int64_t>(n_dim);       // shape size
+      first_shape[axis] = meta.total_dim(axis);  // shape after combined
       for (auto dim_size : first_shape) {
         *arc << static_cast<int64_t>(dim_size);
       }
@@ -543,13 +668,14 @@ class TensorContextWrapper<
         total_size *= e;
       }
       *arc << static_cast<int64_t>(total_size);
-    } else {
-      MPI_Reduce(&local_num, NULL, 1, MPI_INT64_T, MPI_SUM,
-                 comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
     auto old_size = arc->GetSize();
-    *arc << tensor;
+    if (data_type == folly::dynamic::INT64) {
+      serialize_dynamic_tensor<int64_t>(*arc, tensor, 0, 1, tensor.size());
+    } else {
+      serialize_dynamic_tensor<double>(*arc, tensor, 0, 1, tensor.size());
+    }
     gather_archives(*arc, comm_spec, old_size);
     return arc;
   }
@@ -559,8 +685,9 @@ class TensorContextWrapper<
     auto shape = ctx_->shape();
     auto& tensor = ctx_->tensor();
     auto arc = std::make_unique<grape::InArchive>();
+    auto meta = DynamicTensorMeta::Gather(comm_spec, tensor);
 
-    BOOST_LEAF_AUTO(n_dim, get_n_dim<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_dim, get_n_dim(meta.shapes));
 
     if (n_dim != 2) {
       RETURN_GS_ERROR(
@@ -568,58 +695,27 @@ class TensorContextWrapper<
           "This is not a 2-dims tensor, n-dim: " + std::to_string(n_dim));
     }
 
-    BOOST_LEAF_AUTO(n_col, get_n_column<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_col, get_n_column(meta.shapes));
+    BOOST_LEAF_AUTO(data_type, meta.type());
 
-    int64_t n_row = shape.empty() ? 0 : shape[0];
-    int64_t total_n_row;
+    if (data_type != folly::dynamic::INT64 &&
+        data_type != folly::dynamic::DOUBLE) {
+      RETURN_GS_ERROR(
+          vineyard::ErrorCode::kInvalidOperationError,
+          "Only support folly::dynamic::INT64 or folly::dynamic::DOUBLE");
+    }
+
+    size_t n_row = shape.empty() ? 0 : shape[0];
 
     if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-      MPI_Reduce(&n_row, &total_n_row, 1, MPI_INT64_T, MPI_SUM,
-                 comm_spec.worker_id(), comm_spec.comm());
       *arc << static_cast<int64_t>(n_col);
-      *arc << static_cast<int64_t>(total_n_row);
-    } else {
-      MPI_Reduce(&n_row, NULL, 1, MPI_INT64_T, MPI_SUM,
-                 comm_spec.FragToWorker(0), comm_spec.comm());
+      *arc << static_cast<int64_t>(meta.total_dim(0));
     }
 
-    BOOST_LEAF_AUTO(data_type, get_dynamic_type(comm_spec, tensor));
-
     if (data_type == folly::dynamic::INT64) {
-      for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
-        if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-          *arc << "Col " + std::to_string(col_idx);  // Column name
-          *arc << static_cast<int>(vineyard::TypeToInt<int64_t>::value);
-        }
-
-        auto old_size = arc->GetSize();
-
-        for (size_t row_idx = 0; row_idx < n_row; row_idx++) {
-          auto idx = row_idx * n_col + col_idx;
-          *arc << tensor.data()[idx].asInt();
-        }
-        gather_archives(*arc, comm_spec, old_size);
-      }
-    } else if (data_type == folly::dynamic::DOUBLE) {
-      for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
-        if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-          *arc << "Col " + std::to_string(col_idx);
-          *arc << static_cast<int>(vineyard::TypeToInt<double>::value);
-        }
-
-        auto old_size = arc->GetSize();
-
-        for (size_t row_idx = 0; row_idx < n_row; row_idx++) {
-          auto idx = row_idx * n_col + col_idx;
-
-          *arc << tensor.data()[idx].asDouble();
-        }
-        gather_archives(*arc, comm_spec, old_size);
-      }
+      serializeColumns<int64_t>(comm_spec, tensor, n_row, n_col, *arc);
     } else {
-      RETURN_GS_ERROR(
-          vineyard::ErrorCode::kInvalidOperationError,
-          "Only support folly::dynamic::INT64 or folly::dynamic::DOUBLE");
+      serializeColumns<double>(comm_spec, tensor, n_row, n_col, *arc);
     }
     return arc;
   }
@@ -630,8 +726,9 @@ class TensorContextWrapper<
     auto& frag = ctx_->fragment();
     auto& tensor = ctx_->tensor();
     auto local_shape = ctx_->shape();
+    auto meta = DynamicTensorMeta::Gather(comm_spec, tensor);
 
-    BOOST_LEAF_AUTO(n_dim, get_n_dim<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_dim, get_n_dim(meta.shapes));
 
     if (axis >= n_dim) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
@@ -639,15 +736,10 @@ class TensorContextWrapper<
                           ", n-dim: " + std::to_string(n_dim));
     }
 
-    size_t local_num = local_shape.empty() ? 0 : local_shape[axis], total_num;
+    BOOST_LEAF_AUTO(first_shape, get_non_empty_shape(meta.shapes, axis));
+    BOOST_LEAF_AUTO(data_type, meta.type());
 
-    MPI_Allreduce(&local_num, &total_num, 1, MPI_SIZE_T, MPI_SUM,
-                  comm_spec.comm());
-
-    BOOST_LEAF_AUTO(first_shape, get_non_empty_shape(comm_spec, tensor, axis));
-    BOOST_LEAF_AUTO(data_type, get_dynamic_type(comm_spec, tensor));
-
-    first_shape[axis] = total_num;  // the shape after combined
+    first_shape[axis] = meta.total_dim(axis);  // the shape after combined
 
     if (local_shape.empty()) {
       local_shape.resize(n_dim, 0);
@@ -668,33 +760,21 @@ class TensorContextWrapper<
     vineyard::ObjectID tensor_chunk_id;
 
     if (data_type == folly::dynamic::INT64) {
-      vineyard::TensorBuilder<int64_t> tensor_builder(client, vy_tensor_shape,
-                                                      partition_index);
-
-      for (size_t offset = 0; offset < tensor.size(); offset++) {
-        tensor_builder.data()[offset] = tensor.data()[offset].asInt();
-      }
-
-      auto vy_tensor = std::dynamic_pointer_cast<vineyard::Tensor<int64_t>>(
-          tensor_builder.Seal(client));
-      VY_OK_OR_RAISE(vy_tensor->Persist(client));
-      tensor_chunk_id = vy_tensor->id();
+      BOOST_LEAF_ASSIGN(tensor_chunk_id,
+                        buildTensor<int64_t>(client, tensor, vy_tensor_shape,
+                                             partition_index));
+    } else if (data_type == folly::dynamic::DOUBLE) {
+      BOOST_LEAF_ASSIGN(tensor_chunk_id,
+                        buildTensor<double>(client, tensor, vy_tensor_shape,
+                                            partition_index));
     } else if (data_type == folly::dynamic::STRING) {
-      vineyard::TensorBuilder<std::string> tensor_builder(
-          client, vy_tensor_shape, partition_index);
-
-      for (size_t offset = 0; offset < tensor.size(); offset++) {
-        tensor_builder.data()[offset] = tensor.data()[offset].asString();
-      }
-
-      auto vy_tensor = std::dynamic_pointer_cast<vineyard::Tensor<std::string>>(
-          tensor_builder.Seal(client));
-      VY_OK_OR_RAISE(vy_tensor->Persist(client));
-      tensor_chunk_id = vy_tensor->id();
+      BOOST_LEAF_ASSIGN(tensor_chunk_id,
+                        buildTensor<std::string>(
+                            client, tensor, vy_tensor_shape, partition_index));
     } else {
-      RETURN_GS_ERROR(
-          vineyard::ErrorCode::kInvalidOperationError,
-          "Only support folly::dynamic::INT64 or folly::dynamic::DOUBLE");
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "Only support folly::dynamic::INT64, "
+                      "folly::dynamic::DOUBLE or folly::dynamic::STRING");
     }
 
     std::vector<int64_t> global_shape;
@@ -718,8 +798,9 @@ class TensorContextWrapper<
     auto shape = ctx_->shape();
     auto& tensor = ctx_->tensor();
     auto& frag = ctx_->fragment();
+    auto meta = DynamicTensorMeta::Gather(comm_spec, tensor);
 
-    BOOST_LEAF_AUTO(n_dim, get_n_dim<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_dim, get_n_dim(meta.shapes));
 
     if (n_dim != 2) {
       RETURN_GS_ERROR(
@@ -727,7 +808,8 @@ class TensorContextWrapper<
           "This is not a 2-dims tensor, n-dim: " + std::to_string(n_dim));
     }
 
-    BOOST_LEAF_AUTO(n_col, get_n_column<data_t>(comm_spec, tensor));
+    BOOST_LEAF_AUTO(n_col, get_n_column(meta.shapes));
+    BOOST_LEAF_AUTO(data_type, meta.type());
 
     size_t n_row = shape.empty() ? 0 : shape[0];
 
@@ -736,32 +818,10 @@ class TensorContextWrapper<
     df_builder.set_partition_index(frag.fid(), 0);
     df_builder.set_row_batch_index(frag.fid());
 
-    BOOST_LEAF_AUTO(data_type, get_dynamic_type(comm_spec, tensor));
-
     if (data_type == folly::dynamic::INT64) {
-      for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
-        std::vector<int64_t> shape{static_cast<int64_t>(n_row)};
-        auto tensor_builder =
-            std::make_shared<vineyard::TensorBuilder<int64_t>>(client, shape);
-
-        for (auto row_idx = 0; row_idx < n_row; row_idx++) {
-          auto idx = row_idx * n_col + col_idx;
-          tensor_builder->data()[row_idx] = tensor.data()[idx].asInt();
-        }
-        df_builder.AddColumn("Col " + std::to_string(col_idx), tensor_builder);
-      }
+      addColumns<int64_t>(client, tensor, n_row, n_col, df_builder);
     } else if (data_type == folly::dynamic::DOUBLE) {
-      for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
-        std::vector<int64_t> shape{static_cast<int64_t>(n_row)};
-        auto tensor_builder =
-            std::make_shared<vineyard::TensorBuilder<double>>(client, shape);
-
-        for (auto row_idx = 0; row_idx < n_row; row_idx++) {
-          auto idx = row_idx * n_col + col_idx;
-          tensor_builder->data()[row_idx] = tensor.data()[idx].asInt();
-        }
-        df_builder.AddColumn("Col " + std::to_string(col_idx), tensor_builder);
-      }
+      addColumns<double>(client, tensor, n_row, n_col, df_builder);
     } else {
       RETURN_GS_ERROR(
           vineyard::ErrorCode::kInvalidOperationError,
@@ -780,33 +840,58 @@ class TensorContextWrapper<
   }
 
  private:
-  bl::result<folly::dynamic::Type> get_dynamic_type(
-      const grape::CommSpec& comm_spec,
-      const trivial_tensor_t<folly::dynamic>& tensor) {
-    int type =
-        tensor.size() == 0 ? folly::dynamic::NULLT : tensor.data()[0].type();
-    std::vector<int> types;
-    vineyard::GlobalAllGatherv<int>(type, types, comm_spec);
-
-    type = folly::dynamic::NULLT;
-    for (auto e : types) {
-      if (e != folly::dynamic::NULLT) {
-        type = e;
-        break;
+  template <typename T>
+  void serializeColumns(const grape::CommSpec& comm_spec,
+                        const trivial_tensor_t<folly::dynamic>& tensor,
+                        size_t n_row, size_t n_col, grape::InArchive& arc) {
+    std::vector<std::pair<size_t, size_t>> columns;
+    for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
+      if (comm_spec.worker_id() == grape::kCoordinatorRank) {
+        arc << "Col " + std::to_string(col_idx);  // Column name
+        arc << static_cast<int>(vineyard::TypeToInt<T>::value);
       }
+
+      // Python side requires columnar data structure
+      auto old_size = arc.GetSize();
+      serialize_dynamic_tensor<T>(arc, tensor, col_idx, n_col, n_row);
+      columns.emplace_back(old_size, arc.GetSize());
     }
-    if (type == folly::dynamic::NULLT) {
-      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                      "All folly::dynamic are empty");
-    }
+    gather_columns(arc, comm_spec, columns);
+  }
 
-    for (auto e : types) {
-      if (e != folly::dynamic::NULLT && e != type) {
-        RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
-                        "The types of folly:dynamic is not same.");
-      }
+  template <typename T>
+  bl::result<vineyard::ObjectID> buildTensor(
+      vineyard::Client& client, const trivial_tensor_t<folly::dynamic>& tensor,
+      const std::vector<int64_t>& shape,
+      const std::vector<int64_t>& partition_index) {
+    vineyard::TensorBuilder<T> tensor_builder(client, shape, partition_index);
+    auto* dst = tensor_builder.data();
+    const folly::dynamic* src = tensor.data();
+    parallel_fill(tensor.size(), [dst, src](size_t offset) {
+      dst[offset] = dynamic_value_as<T>(src[offset]);
+    });
+
+    auto vy_tensor = std::dynamic_pointer_cast<vineyard::Tensor<T>>(
+        tensor_builder.Seal(client));
+    VY_OK_OR_RAISE(vy_tensor->Persist(client));
+    return vy_tensor->id();
+  }
+
+  template <typename T>
+  void addColumns(vineyard::Client& client,
+                  const trivial_tensor_t<folly::dynamic>& tensor, size_t n_row,
+                  size_t n_col, vineyard::DataFrameBuilder& df_builder) {
+    const folly::dynamic* src = tensor.data();
+    for (size_t col_idx = 0; col_idx < n_col; col_idx++) {
+      std::vector<int64_t> shape{static_cast<int64_t>(n_row)};
+      auto tensor_builder =
+          std::make_shared<vineyard::TensorBuilder<T>>(client, shape);
+      auto* dst = tensor_builder->data();
+      parallel_fill(n_row, [dst, src, n_col, col_idx](size_t row_idx) {
+        dst[row_idx] = dynamic_value_as<T>(src[row_idx * n_col + col_idx]);
+      });
+      df_builder.AddColumn("Col " + std::to_string(col_idx), tensor_builder);
     }
-    return static_cast<folly::dynamic::Type>(type);
   }
 
   std::shared_ptr<IFragmentWrapper> frag_wrapper_;
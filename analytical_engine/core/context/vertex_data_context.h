@@ -17,9 +17,11 @@
 #define ANALYTICAL_ENGINE_CORE_CONTEXT_VERTEX_DATA_CONTEXT_H_
 
 #include <algorithm>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -69,6 +71,84 @@ context_data_to_arrow_array(
                   "Can not transform dynamic type");
 }
 
+/**
+ * @brief An arrow buffer over the memory of a context, which keeps the owner
+ * of the memory alive as long as the arrays on the buffer.
+ */
+class ContextDataBuffer : public arrow::Buffer {
+ public:
+  ContextDataBuffer(const void* data, int64_t size,
+                    std::shared_ptr<const void> owner)
+      : arrow::Buffer(reinterpret_cast<const uint8_t*>(data), size),
+        owner_(std::move(owner)) {}
+
+ private:
+  std::shared_ptr<const void> owner_;
+};
+
+/**
+ * @brief Whether the data of a context can be wrapped as an arrow array with
+ * no copy, i.e., the data type is a primitive arrow type, and the vertex
+ * array is contiguous over a vertex range.
+ */
+template <typename FRAG_T, typename DATA_T>
+struct is_zero_copy_context_data {
+  using vid_t = typename FRAG_T::vid_t;
+  static constexpr bool value =
+      (std::is_same<DATA_T, int32_t>::value ||
+       std::is_same<DATA_T, int64_t>::value ||
+       std::is_same<DATA_T, uint32_t>::value ||
+       std::is_same<DATA_T, uint64_t>::value ||
+       std::is_same<DATA_T, float>::value ||
+       std::is_same<DATA_T, double>::value) &&
+      std::is_same<typename FRAG_T::vertex_range_t,
+                   grape::VertexRange<vid_t>>::value &&
+      std::is_same<typename FRAG_T::template vertex_array_t<DATA_T>,
+                   grape::VertexArray<DATA_T, vid_t>>::value;
+};
+
+/**
+ * @brief Wraps the data of the vertices as an arrow array on the memory of
+ * the context, which is kept alive by owner, if the data is a contiguous and
+ * aligned array of a primitive type. Or else the data is copied.
+ */
+template <typename FRAG_T, typename DATA_T>
+typename std::enable_if<is_zero_copy_context_data<FRAG_T, DATA_T>::value,
+                        bl::result<std::shared_ptr<arrow::Array>>>::type
+context_data_to_arrow_array(
+    const typename FRAG_T::vertex_range_t& vertices,
+    const typename FRAG_T::template vertex_array_t<DATA_T>& data,
+    const std::shared_ptr<const void>& owner) {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using array_t = typename vineyard::ConvertToArrowType<DATA_T>::ArrayType;
+  auto& range = data.GetVertexRange();
+  size_t size = vertices.size();
+
+  if (size == 0 ||
+      vertices.begin().GetValue() < range.begin().GetValue() ||
+      vertices.end().GetValue() > range.end().GetValue()) {
+    return context_data_to_arrow_array<FRAG_T, DATA_T>(vertices, data);
+  }
+  const DATA_T* values = &data[vertex_t(vertices.begin().GetValue())];
+  if (reinterpret_cast<uintptr_t>(values) % alignof(DATA_T) != 0) {
+    return context_data_to_arrow_array<FRAG_T, DATA_T>(vertices, data);
+  }
+  auto buffer = std::make_shared<ContextDataBuffer>(
+      values, static_cast<int64_t>(size * sizeof(DATA_T)), owner);
+  return std::dynamic_pointer_cast<arrow::Array>(
+      std::make_shared<array_t>(static_cast<int64_t>(size), buffer));
+}
+
+template <typename FRAG_T, typename DATA_T>
+typename std::enable_if<!is_zero_copy_context_data<FRAG_T, DATA_T>::value,
+                        bl::result<std::shared_ptr<arrow::Array>>>::type
+context_data_to_arrow_array(
+    const typename FRAG_T::vertex_range_t& vertices,
+    const typename FRAG_T::template vertex_array_t<DATA_T>& data,
+    const std::shared_ptr<const void>& owner) {
+  return context_data_to_arrow_array<FRAG_T, DATA_T>(vertices, data);
+}
+
 template <typename FRAG_T, typename COMPUTE_CONTEXT_T>
 class PregelContext;
 /**
@@ -152,6 +232,10 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
     return frag_wrapper_;
   }
 
+  size_t MemoryUsage() const override {
+    return ctx_->data().GetVertexRange().size() * sizeof(data_t);
+  }
+
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const Selector& selector,
       const std::pair<std::string, std::string>& range) override {
@@ -221,11 +305,13 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
   bl::result<std::unique_ptr<grape::InArchive>> ToDataframe(
       const grape::CommSpec& comm_spec,
       const std::vector<std::pair<std::string, Selector>>& selectors,
-      const std::pair<std::string, std::string>& range) override {
+      const std::pair<std::string, std::string>& range,
+      const VertexLimit& limit) override {
     auto& frag = ctx_->fragment();
     auto& data = ctx_->data();
     TransformUtils<FRAG_T> trans_utils(comm_spec, frag);
     auto vertices = trans_utils.SelectVertices(range);
+    limit_vertices(comm_spec, limit, data, vertices);
     auto local_num = static_cast<int64_t>(vertices.size());
     auto arc = std::make_unique<grape::InArchive>();
 
@@ -240,6 +326,7 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
+    std::vector<std::pair<size_t, size_t>> columns;
     for (auto& pair : selectors) {
       auto col_name = pair.first;
       auto selector = pair.second;
@@ -285,8 +372,9 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
                 selector.str());
       }
 
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
     return std::move(arc);
   }
 
@@ -318,13 +406,9 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
       break;
     }
     case SelectorType::kResult: {
-      auto f = [&data, &vertices](size_t i) {
-        auto v = vertices[i];
-        return data[v];
-      };
-      BOOST_LEAF_ASSIGN(
-          tensor_chunk_id,
-          build_vy_tensor(client, vertices.size(), f, comm_spec.fid()));
+      BOOST_LEAF_ASSIGN(tensor_chunk_id,
+                        vertex_array_to_vy_tensor<data_t>(
+                            client, data, vertices, comm_spec.fid()));
       break;
     }
     default:
@@ -380,10 +464,9 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
         break;
       }
       case SelectorType::kResult: {
-        auto f = [&data, &vertices](size_t i) { return data[vertices[i]]; };
         BOOST_LEAF_AUTO(tensor_builder,
-                        build_vy_tensor_builder(client, vertices.size(), f,
-                                                comm_spec.fid()));
+                        vertex_array_to_vy_tensor_builder<data_t>(
+                            client, data, vertices, comm_spec.fid()));
         df_builder.AddColumn(col_name, tensor_builder);
         break;
       }
@@ -434,8 +517,9 @@ class VertexDataContextWrapper : public IVertexDataContextWrapper {
         break;
       }
       case SelectorType::kResult: {
+        // the array shares the memory of the context if possible
         auto tmp = context_data_to_arrow_array<fragment_t, data_t>(
-            frag.InnerVertices(), data);
+            frag.InnerVertices(), data, ctx_);
         BOOST_LEAF_ASSIGN(arr, tmp);
         break;
       }
@@ -491,6 +575,14 @@ class LabeledVertexDataContextWrapper
     return frag_wrapper_;
   }
 
+  size_t MemoryUsage() const override {
+    size_t bytes = 0;
+    for (auto& data : ctx_->data()) {
+      bytes += data.GetVertexRange().size() * sizeof(data_t);
+    }
+    return bytes;
+  }
+
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const LabeledSelector& selector,
       const std::pair<std::string, std::string>& range) override {
@@ -558,13 +650,15 @@ class LabeledVertexDataContextWrapper
   bl::result<std::unique_ptr<grape::InArchive>> ToDataframe(
       const grape::CommSpec& comm_spec,
       const std::vector<std::pair<std::string, LabeledSelector>>& selectors,
-      const std::pair<std::string, std::string>& range) override {
+      const std::pair<std::string, std::string>& range,
+      const VertexLimit& limit) override {
     auto& frag = ctx_->fragment();
 
     BOOST_LEAF_AUTO(label_id, LabeledSelector::GetVertexLabelId(selectors));
 
     TransformUtils<FRAG_T> trans_utils(comm_spec, frag);
     auto vertices = trans_utils.SelectVertices(label_id, range);
+    limit_vertices(comm_spec, limit, ctx_->data()[label_id], vertices);
     auto local_num = static_cast<int64_t>(vertices.size());
     auto arc = std::make_unique<grape::InArchive>();
 
@@ -579,6 +673,7 @@ class LabeledVertexDataContextWrapper
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
+    std::vector<std::pair<size_t, size_t>> columns;
     for (auto& pair : selectors) {
       auto& col_name = pair.first;
       auto& selector = pair.second;
@@ -625,8 +720,9 @@ class LabeledVertexDataContextWrapper
             "and result. selector: " +
                 selector.str());
       }
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
 
     return std::move(arc);
   }
@@ -662,11 +758,9 @@ class LabeledVertexDataContextWrapper
       break;
     }
     case SelectorType::kResult: {
-      auto f = [&data, &vertices](size_t i) { return data[vertices[i]]; };
-
-      BOOST_LEAF_ASSIGN(
-          tensor_chunk_id,
-          build_vy_tensor(client, vertices.size(), f, comm_spec.fid()));
+      BOOST_LEAF_ASSIGN(tensor_chunk_id,
+                        vertex_array_to_vy_tensor<data_t>(
+                            client, data, vertices, comm_spec.fid()));
       break;
     }
     default:
@@ -727,10 +821,9 @@ class LabeledVertexDataContextWrapper
         break;
       }
       case SelectorType::kResult: {
-        auto f = [&data, &vertices](size_t i) { return data[vertices[i]]; };
         BOOST_LEAF_AUTO(tensor_builder,
-                        build_vy_tensor_builder(client, vertices.size(), f,
-                                                comm_spec.fid()));
+                        vertex_array_to_vy_tensor_builder<data_t>(
+                            client, data, vertices, comm_spec.fid()));
         df_builder.AddColumn(col_name, tensor_builder);
         break;
       }
@@ -782,7 +875,8 @@ class LabeledVertexDataContextWrapper
       case SelectorType::kVertexData: {
         auto prop_id = selector.property_id();
 
-        arr = trans_utils.VertexPropertyToArrowArray(label_id, prop_id);
+        BOOST_LEAF_ASSIGN(
+            arr, trans_utils.VertexPropertyToArrowArray(label_id, prop_id));
         break;
       }
       case SelectorType::kResult: {
@@ -792,8 +886,9 @@ class LabeledVertexDataContextWrapper
           RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
                           "Should not specify property name.");
         }
+        // the array shares the memory of the context if possible
         auto tmp = context_data_to_arrow_array<fragment_t, data_t>(
-            frag.InnerVertices(label_id), data);
+            frag.InnerVertices(label_id), data, ctx_);
         BOOST_LEAF_ASSIGN(arr, tmp);
         break;
       }
@@ -151,6 +151,14 @@ class VertexPropertyContextWrapper : public IVertexPropertyContextWrapper {
     return frag_wrapper_;
   }
 
+  size_t MemoryUsage() const override {
+    size_t bytes = 0;
+    for (auto& column : ctx_->vertex_properties()) {
+      bytes += column->MemoryUsage();
+    }
+    return bytes;
+  }
+
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const Selector& selector,
       const std::pair<std::string, std::string>& range) override {
@@ -242,6 +250,7 @@ class VertexPropertyContextWrapper : public IVertexPropertyContextWrapper {
       MPI_Reduce(&local_num, NULL, 1, MPI_INT64_T, MPI_SUM,
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
+    std::vector<std::pair<size_t, size_t>> columns;
     for (auto& pair : selectors) {
       auto& col_name = pair.first;
       auto& selector = pair.second;
@@ -295,8 +304,9 @@ class VertexPropertyContextWrapper : public IVertexPropertyContextWrapper {
             "and result. selector: " +
                 selector.str());
       }
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
     return arc;
   }
 
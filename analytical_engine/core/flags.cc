@@ -23,7 +23,29 @@ DEFINE_int32(port, 60001, "the port to listen by gRPC server");
 
 // for vineyard
 DEFINE_string(vineyard_socket, "", "Unix domain socket path for vineyardd");
+DEFINE_string(vineyard_socket_pool, "",
+              "the comma separated sockets of the pre-launched vineyardd "
+              "instances, of which a free one is attached to instead of "
+              "launching vineyardd, if vineyard_socket is not given");
 DEFINE_string(etcd_endpoint, "http://127.0.0.1:2379",
               "Etcd endpoint that will be used to launch vineyardd");
 
 DEFINE_string(dag_file, "", "Engine reads serialized dag proto from dag_file.");
+DEFINE_int32(dispatcher_lanes, 1,
+             "the number of lanes to run the commands on different graphs, "
+             "contexts and apps concurrently");
+DEFINE_int64(projection_cache_bytes, static_cast<int64_t>(1) << 30,
+             "the capacity in bytes of the cached projections of the property "
+             "graphs, 0 to disable the cache");
+DEFINE_int64(query_cache_bytes, 0,
+             "the capacity in bytes of the contexts of the queries on the "
+             "immutable graphs cached to answer the repeated queries, 0 to "
+             "disable the cache");
+DEFINE_string(numa_policy, "none",
+              "the placement of the memory and the threads of the workers on "
+              "the NUMA machines: none, interleave on all the nodes, or local "
+              "to a node for each worker");
+DEFINE_int64(memory_budget_bytes, 0,
+             "the bytes of the objects held by a worker, beyond which the "
+             "unused projected graphs and contexts are evicted, 0 for no "
+             "budget");
@@ -22,9 +22,15 @@ DECLARE_string(host);
 DECLARE_int32(port);
 
 DECLARE_string(dag_file);
+DECLARE_int32(dispatcher_lanes);
+DECLARE_int64(projection_cache_bytes);
+DECLARE_int64(query_cache_bytes);
+DECLARE_int64(memory_budget_bytes);
+DECLARE_string(numa_policy);
 
 // vineyard
 DECLARE_string(vineyard_socket);
+DECLARE_string(vineyard_socket_pool);
 DECLARE_string(etcd_endpoint);
 
 #endif  // ANALYTICAL_ENGINE_CORE_FLAGS_H_
@@ -17,6 +17,7 @@
 #define ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_FRAGMENT_H_
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -31,6 +32,8 @@
 #include "vineyard/graph/vertex_map/arrow_vertex_map.h"
 
 #include "core/fragment/append_only_arrow_table.h"
+#include "core/fragment/mutation_log.h"
+#include "core/utils/parallel_utils.h"
 #include "core/vertex_map/extra_vertex_map.h"
 
 namespace gs {
@@ -40,53 +43,73 @@ class AppendOnlyArrowFragmentBuilder;
 namespace append_only_fragment_impl {
 /**
  * @brief ExtraNbr is an internal representation for a later appended neighbor.
+ * The neighbors sealed by the compaction are visited before the ones appended
+ * since then.
  * @see gs::AppendOnlyArrowFragment
  */
 template <typename VID_T, typename EID_T>
 struct ExtraNbr {
  private:
   using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
+  using map_iterator_t = typename std::map<VID_T, nbr_unit_t>::const_iterator;
 
  public:
-  ExtraNbr() : nbr_(NULL), edata_table_(nullptr) {}
-
-  ExtraNbr(typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                        VID_T, EID_T>>::const_iterator nbr,
+  ExtraNbr()
+      : sealed_(nullptr),
+        sealed_end_(nullptr),
+        nbr_(),
+        edata_table_(nullptr) {}
+
+  ExtraNbr(const nbr_unit_t* sealed, const nbr_unit_t* sealed_end,
+           map_iterator_t nbr,
            std::shared_ptr<AppendOnlyArrowTable> edata_table,
            const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
-      : nbr_(nbr),
+      : sealed_(sealed),
+        sealed_end_(sealed_end),
+        nbr_(nbr),
         edata_table_(std::move(edata_table)),
         vid_parser_(vid_parser),
         ivnums_(ivnums) {}
 
   ExtraNbr(const ExtraNbr& rhs)
-      : nbr_(rhs.nbr_),
+      : sealed_(rhs.sealed_),
+        sealed_end_(rhs.sealed_end_),
+        nbr_(rhs.nbr_),
         edata_table_(rhs.edata_table_),
         vid_parser_(rhs.vid_parser_),
         ivnums_(rhs.ivnums_) {}
 
   ExtraNbr(ExtraNbr&& rhs)
-      : nbr_(std::move(rhs.nbr_)),
+      : sealed_(rhs.sealed_),
+        sealed_end_(rhs.sealed_end_),
+        nbr_(std::move(rhs.nbr_)),
         edata_table_(std::move(rhs.edata_table_)),
         vid_parser_(rhs.vid_parser_),
         ivnums_(rhs.ivnums_) {}
 
   ExtraNbr& operator=(const ExtraNbr& rhs) {
+    sealed_ = rhs.sealed_;
+    sealed_end_ = rhs.sealed_end_;
     nbr_ = rhs.nbr_;
     edata_table_ = rhs.edata_table_;
     vid_parser_ = rhs.vid_parser_;
     ivnums_ = rhs.ivnums_;
+    return *this;
   }
 
   ExtraNbr& operator=(ExtraNbr&& rhs) {
+    sealed_ = rhs.sealed_;
+    sealed_end_ = rhs.sealed_end_;
     nbr_ = std::move(rhs.nbr_);
     edata_table_ = std::move(rhs.edata_table_);
     vid_parser_ = rhs.vid_parser_;
     ivnums_ = rhs.ivnums_;
+    return *this;
   }
 
   grape::Vertex<VID_T> neighbor() const {
-    auto lid = nbr_->first;
+    auto lid = unit().vid;
     auto offset_mask = vid_parser_->offset_mask();
     auto offset = vid_parser_->GetOffset(lid);
     auto v_label = vid_parser_->GetLabelId(lid);
@@ -98,15 +121,19 @@ struct ExtraNbr {
     return grape::Vertex<VID_T>(vid);
   }
 
-  EID_T edge_id() const { return nbr_->second.eid; }
+  EID_T edge_id() const { return unit().eid; }
 
   template <typename T>
   T get_data(prop_id_t prop_id) const {
-    return edata_table_->GetValue<T>(prop_id, nbr_->second.eid);
+    return edata_table_->GetValue<T>(prop_id, unit().eid);
   }
 
   inline const ExtraNbr& operator++() const {
-    ++nbr_;
+    if (sealed_ != sealed_end_) {
+      ++sealed_;
+    } else {
+      ++nbr_;
+    }
     return *this;
   }
 
@@ -116,27 +143,21 @@ struct ExtraNbr {
     return ret;
   }
 
-  inline const ExtraNbr& operator--() const {
-    --nbr_;
-    return *this;
+  inline bool operator==(const ExtraNbr& rhs) const {
+    return sealed_ == rhs.sealed_ && nbr_ == rhs.nbr_;
   }
-
-  inline ExtraNbr operator--(int) const {
-    ExtraNbr ret(*this);
-    --ret;
-    return ret;
-  }
-
-  inline bool operator==(const ExtraNbr& rhs) const { return nbr_ == rhs.nbr_; }
-  inline bool operator!=(const ExtraNbr& rhs) const { return nbr_ != rhs.nbr_; }
-
-  inline bool operator<(const ExtraNbr& rhs) const { return nbr_ < rhs.nbr_; }
+  inline bool operator!=(const ExtraNbr& rhs) const { return !(*this == rhs); }
 
   inline const ExtraNbr& operator*() const { return *this; }
 
  private:
-  mutable typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                       VID_T, EID_T>>::const_iterator nbr_;
+  inline const nbr_unit_t& unit() const {
+    return sealed_ != sealed_end_ ? *sealed_ : nbr_->second;
+  }
+
+  mutable const nbr_unit_t* sealed_;
+  const nbr_unit_t* sealed_end_;
+  mutable map_iterator_t nbr_;
   std::shared_ptr<AppendOnlyArrowTable> edata_table_;
   const vineyard::IdParser<VID_T>* vid_parser_;
   const VID_T* ivnums_;
@@ -144,53 +165,73 @@ struct ExtraNbr {
 
 /**
  * @brief ExtraAdjList is an internal representation for the later appended
- * neighbors.
+ * neighbors, i.e., the sealed ones in [sealed_begin, sealed_end), and the
+ * ones appended since the last compaction in [begin, end).
  * @see gs::AppendOnlyArrowFragment
  */
 template <typename VID_T, typename EID_T>
 class ExtraAdjList {
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
+  using map_iterator_t = typename std::map<VID_T, nbr_unit_t>::const_iterator;
+
  public:
   ExtraAdjList() = default;
 
-  ExtraAdjList(
-      typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                   VID_T, EID_T>>::const_iterator begin,
-      typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                                   VID_T, EID_T>>::const_iterator end,
-      std::shared_ptr<AppendOnlyArrowTable> edata_table,
-      const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
-      : begin_(begin),
+  ExtraAdjList(const nbr_unit_t* sealed_begin, const nbr_unit_t* sealed_end,
+               map_iterator_t begin, map_iterator_t end, size_t size,
+               std::shared_ptr<AppendOnlyArrowTable> edata_table,
+               const vineyard::IdParser<VID_T>* vid_parser, const VID_T* ivnums)
+      : sealed_begin_(sealed_begin),
+        sealed_end_(sealed_end),
+        begin_(begin),
         end_(end),
+        size_(size),
         edata_table_(std::move(edata_table)),
         vid_parser_(vid_parser),
         ivnums_(ivnums) {}
 
   inline ExtraNbr<VID_T, EID_T> begin() const {
-    return ExtraNbr<VID_T, EID_T>(begin_, edata_table_, vid_parser_, ivnums_);
+    return ExtraNbr<VID_T, EID_T>(sealed_begin_, sealed_end_, begin_,
+                                  edata_table_, vid_parser_, ivnums_);
   }
 
   inline ExtraNbr<VID_T, EID_T> end() const {
-    return ExtraNbr<VID_T, EID_T>(end_, edata_table_, vid_parser_, ivnums_);
+    return ExtraNbr<VID_T, EID_T>(sealed_end_, sealed_end_, end_, edata_table_,
+                                  vid_parser_, ivnums_);
   }
 
-  inline size_t Size() const { return end_ - begin_; }
+  inline size_t Size() const { return size_; }
 
-  inline bool Empty() const { return end_ == begin_; }
+  inline bool Empty() const { return size_ == 0; }
 
-  inline bool NotEmpty() const { return end_ != begin_; }
+  inline bool NotEmpty() const { return size_ != 0; }
 
-  size_t size() const { return end_ - begin_; }
+  size_t size() const { return size_; }
 
  private:
-  typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                               VID_T, EID_T>>::const_iterator begin_;
-  typename std::map<VID_T, vineyard::property_graph_utils::NbrUnit<
-                               VID_T, EID_T>>::const_iterator end_;
+  const nbr_unit_t* sealed_begin_ = nullptr;
+  const nbr_unit_t* sealed_end_ = nullptr;
+  map_iterator_t begin_;
+  map_iterator_t end_;
+  size_t size_ = 0;
   std::shared_ptr<AppendOnlyArrowTable> edata_table_;
   const vineyard::IdParser<VID_T>* vid_parser_;
   const VID_T* ivnums_;
 };
 
+/**
+ * @brief The numbers of the inner and outer vertices, and of the appended
+ * edges, of each label after an append batch. The vertices and the appended
+ * edges are numbered in the order they are added, so the ones of the batch
+ * and before are the first ones of these numbers.
+ * @see gs::AppendOnlyArrowFragmentView
+ */
+template <typename VID_T, typename EID_T>
+struct AppendVersion {
+  std::vector<VID_T> ivnums, ovnums;
+  std::vector<EID_T> extra_oe_nums;
+};
+
 template <typename T>
 typename std::enable_if<!std::is_same<T, std::string>::value, T>::type
 get_from_arrow_array(const std::shared_ptr<arrow::Array>& arr, int64_t i) {
@@ -286,6 +327,8 @@ class AppendOnlyArrowFragment
   using vertex_map_t = vineyard::ArrowVertexMap<internal_oid_t, vid_t>;
   using extra_vertex_map_t = ExtraVertexMap<oid_t, vid_t>;
   using vertex_t = grape::Vertex<vid_t>;
+  using append_version_t =
+      append_only_fragment_impl::AppendVersion<vid_t, eid_t>;
 
   using vid_array_t = typename vineyard::ConvertToArrowType<vid_t>::ArrayType;
   using eid_array_t = typename vineyard::ConvertToArrowType<eid_t>::ArrayType;
@@ -357,6 +400,8 @@ class AppendOnlyArrowFragment
 
   fid_t fnum() const { return fnum_; }
 
+  bool directed() const { return directed_; }
+
   label_id_t vertex_label_num() const { return vertex_label_num_; }
 
   label_id_t vertex_label(const vertex_t& v) const {
@@ -607,15 +652,30 @@ class AppendOnlyArrowFragment
     label_id_t v_label = vid_parser_.GetLabelId(vid);
     int64_t v_offset = vid_parser_.GetOffset(vid);
     auto& oe_index = extra_oe_indices_[v_label][e_label];
+    auto& sealed_offsets = sealed_oe_offsets_[v_label][e_label];
+    const nbr_unit_t *sealed_begin = nullptr, *sealed_end = nullptr;
     int64_t loc = -1;
 
+    if (v_offset + 1 < (int64_t) sealed_offsets.size()) {
+      auto sealed = sealed_oe_lists_[v_label][e_label].data();
+      sealed_begin = sealed + sealed_offsets[v_offset];
+      sealed_end = sealed + sealed_offsets[v_offset + 1];
+    }
     if (v_offset < (int64_t) oe_index.size() &&
         (loc = oe_index[v_offset]) >= 0) {
-      auto& edge_space = extra_edge_space_array_[e_label];
-      auto& edge_table = extra_edge_tables_[e_label];
+      auto& edges = extra_edge_space_array_[e_label][loc];
 
-      return extra_adj_list_t(edge_space[loc].begin(), edge_space[loc].end(),
-                              edge_table, &vid_parser_, curr_ivnums_.data());
+      return extra_adj_list_t(sealed_begin, sealed_end, edges.begin(),
+                              edges.end(),
+                              sealed_end - sealed_begin + edges.size(),
+                              extra_edge_tables_[e_label], &vid_parser_,
+                              curr_ivnums_.data());
+    }
+    if (sealed_begin != sealed_end) {
+      return extra_adj_list_t(sealed_begin, sealed_end, empty_nbrs_.end(),
+                              empty_nbrs_.end(), sealed_end - sealed_begin,
+                              extra_edge_tables_[e_label], &vid_parser_,
+                              curr_ivnums_.data());
     }
     return extra_adj_list_t();
   }
@@ -659,6 +719,85 @@ class AppendOnlyArrowFragment
     return extra_edge_tables_[i];
   }
 
+  // the log of the edges appended by ArrowFragmentAppender
+  const MutationLog<vid_t>& mutation_log() const { return mutation_log_; }
+
+  // the number of the edges appended since the last compaction
+  size_t unsealed_edge_num() const { return unsealed_edge_num_; }
+
+  // the versions recorded by the append batches, of which the 0th is the
+  // loaded fragment and the last one is the current fragment
+  size_t append_version_num() const { return append_versions_.size(); }
+
+  const append_version_t& append_version(size_t version) const {
+    CHECK_LT(version, append_versions_.size());
+    return append_versions_[version];
+  }
+
+  /**
+   * @brief Seals the appended edges into CSRs, one per vertex label and edge
+   * label, which are faster to read than the maps of the appended edges. The
+   * edges sealed by the last compaction are merged into the new CSRs, which
+   * are built aside and swapped in at last, and the maps are cleared.
+   *
+   * N.B.: the adjacent lists of the appended edges got before are invalidated.
+   */
+  void Compact() {
+    std::vector<std::vector<std::vector<int64_t>>> sealed_oe_offsets(
+        vertex_label_num_);
+    std::vector<std::vector<std::vector<nbr_unit_t>>> sealed_oe_lists(
+        vertex_label_num_);
+
+    for (label_id_t v_label = 0; v_label < vertex_label_num_; ++v_label) {
+      sealed_oe_offsets[v_label].resize(edge_label_num_);
+      sealed_oe_lists[v_label].resize(edge_label_num_);
+      int64_t ivnum = curr_ivnums_[v_label];
+
+      for (label_id_t e_label = 0; e_label < edge_label_num_; ++e_label) {
+        auto& old_offsets = sealed_oe_offsets_[v_label][e_label];
+        auto& old_list = sealed_oe_lists_[v_label][e_label];
+        auto& oe_index = extra_oe_indices_[v_label][e_label];
+        auto& edge_space = extra_edge_space_array_[e_label];
+        auto& offsets = sealed_oe_offsets[v_label][e_label];
+        auto& list = sealed_oe_lists[v_label][e_label];
+
+        offsets.resize(ivnum + 1, 0);
+        list.reserve(old_list.size() + extra_oe_nums_[e_label]);
+        for (int64_t offset = 0; offset < ivnum; ++offset) {
+          auto begin = list.size();
+          if (offset + 1 < (int64_t) old_offsets.size()) {
+            list.insert(list.end(), old_list.begin() + old_offsets[offset],
+                        old_list.begin() + old_offsets[offset + 1]);
+          }
+          if (offset < (int64_t) oe_index.size() && oe_index[offset] >= 0) {
+            for (auto& pair : edge_space[oe_index[offset]]) {
+              list.push_back(pair.second);
+            }
+          }
+          // sorted by the neighbors, as the CSRs of the loaded edges
+          std::sort(list.begin() + begin, list.end(),
+                    [](const nbr_unit_t& l, const nbr_unit_t& r) {
+                      return l.vid < r.vid;
+                    });
+          offsets[offset + 1] = list.size();
+        }
+        list.shrink_to_fit();
+      }
+    }
+
+    sealed_oe_offsets_.swap(sealed_oe_offsets);
+    sealed_oe_lists_.swap(sealed_oe_lists);
+    for (label_id_t v_label = 0; v_label < vertex_label_num_; ++v_label) {
+      for (auto& oe_index : extra_oe_indices_[v_label]) {
+        std::fill(oe_index.begin(), oe_index.end(), -1);
+      }
+    }
+    for (auto& edge_space : extra_edge_space_array_) {
+      edge_space.Clear();
+    }
+    unsealed_edge_num_ = 0;
+  }
+
  private:
   void initPointers() {
     oe_ptr_lists_.resize(vertex_label_num_);
@@ -722,6 +861,8 @@ class AppendOnlyArrowFragment
     extra_oe_indices_.resize(vertex_label_num_);
     extra_edge_space_array_.resize(edge_label_num_);
     extra_oe_nums_.resize(edge_label_num_, 0);
+    sealed_oe_offsets_.resize(vertex_label_num_);
+    sealed_oe_lists_.resize(vertex_label_num_);
 
     for (label_id_t v_label = 0; v_label < vertex_label_num_; v_label++) {
       extra_vertex_tables_[v_label] = std::make_shared<AppendOnlyArrowTable>();
@@ -729,11 +870,19 @@ class AppendOnlyArrowFragment
       curr_ovnums_[v_label] = ovnums_[v_label];
       curr_tvnums_[v_label] = tvnums_[v_label];
       extra_oe_indices_[v_label].resize(edge_label_num_);
+      sealed_oe_offsets_[v_label].resize(edge_label_num_);
+      sealed_oe_lists_[v_label].resize(edge_label_num_);
     }
 
     for (label_id_t e_label = 0; e_label < edge_label_num_; e_label++) {
       extra_edge_tables_[e_label] = std::make_shared<AppendOnlyArrowTable>();
     }
+    recordAppendVersion();
+  }
+
+  void recordAppendVersion() {
+    append_versions_.push_back(
+        append_version_t{curr_ivnums_, curr_ovnums_, extra_oe_nums_});
   }
 
   bool addOutgoingEdge(vid_t src_lid, vid_t dst_lid, label_id_t e_label,
@@ -743,17 +892,30 @@ class AppendOnlyArrowFragment
 
     CHECK_LT(src_offset, curr_ivnums_[src_label]);
 
+    auto target = nbr_unit_t(dst_lid, 0);
+    auto compare = [](const nbr_unit_t& l, const nbr_unit_t& r) {
+      return l.vid < r.vid;
+    };
+
     // first, check dst exists in the csr or not
     if (src_offset < (int64_t) ivnums_[src_label]) {
       auto offset_array = oe_offsets_ptr_lists_[src_label][e_label];
       auto oe = oe_ptr_lists_[src_label][e_label];
-      auto target = nbr_unit_t(dst_lid, 0);
 
       if (std::binary_search(&oe[offset_array[src_offset]],
                              &oe[offset_array[src_offset + 1]], target,
-                             [](const nbr_unit_t& l, const nbr_unit_t& r) {
-                               return l.vid < r.vid;
-                             })) {
+                             compare)) {
+        return false;
+      }
+    }
+
+    // and the sealed appended edges
+    auto& sealed_offsets = sealed_oe_offsets_[src_label][e_label];
+    if (src_offset + 1 < (int64_t) sealed_offsets.size()) {
+      auto& sealed = sealed_oe_lists_[src_label][e_label];
+      if (std::binary_search(sealed.begin() + sealed_offsets[src_offset],
+                             sealed.begin() + sealed_offsets[src_offset + 1],
+                             target, compare)) {
         return false;
       }
     }
@@ -772,6 +934,9 @@ class AppendOnlyArrowFragment
       extra_oe_index[src_offset] =
           extra_edge_space.emplace(pos, dst_lid, eid, created);
     }
+    if (created) {
+      ++unsealed_edge_num_;
+    }
     return created;
   }
 
@@ -856,6 +1021,14 @@ class AppendOnlyArrowFragment
   std::vector<NbrMapSpace<eid_t>> extra_edge_space_array_;
 
   std::vector<eid_t> extra_oe_nums_;
+  // the appended edges sealed by Compact: v_label->e_label->CSR
+  std::vector<std::vector<std::vector<int64_t>>> sealed_oe_offsets_;
+  std::vector<std::vector<std::vector<nbr_unit_t>>> sealed_oe_lists_;
+  size_t unsealed_edge_num_ = 0;
+  // the end of the adjacent lists without unsealed edges
+  std::map<vid_t, nbr_unit_t> empty_nbrs_;
+  MutationLog<vid_t> mutation_log_;
+  std::vector<append_version_t> append_versions_;
 
   template <typename _OID_T, typename _VID_T>
   friend class AppendOnlyArrowFragmentBuilder;
@@ -1224,82 +1397,92 @@ class BasicAppendOnlyArrowFragmentBuilder
           tvnums_builder.Seal(client)));
     }
 
+    // the arrays are independent, so they are sealed concurrently, which
+    // overlaps the copies to the blobs with the requests to vineyard
+    std::vector<std::function<void()>> seals;
     for (label_id_t i = 0; i < vertex_label_num_; ++i) {
-      vineyard::TableBuilder vt(client, vertex_tables_[i]);
-      this->set_vertex_table(
-          i, std::dynamic_pointer_cast<vineyard::Table>(vt.Seal(client)));
-
-      vineyard::NumericArrayBuilder<vid_t> ovgid_list_builder(client,
-                                                              ovgid_lists_[i]);
-      this->set_ovgid_list(
-          i, std::dynamic_pointer_cast<vineyard::NumericArray<vid_t>>(
-                 ovgid_list_builder.Seal(client)));
-
-      vineyard::HashmapBuilder<vid_t, vid_t> ovg2l_builder(
-          client, std::move(ovg2l_maps_[i]));
-      this->set_ovg2l_map(
-          i, std::dynamic_pointer_cast<vineyard::Hashmap<vid_t, vid_t>>(
-                 ovg2l_builder.Seal(client)));
+      seals.emplace_back([this, &client, i]() {
+        vineyard::TableBuilder vt(client, vertex_tables_[i]);
+        this->set_vertex_table(
+            i, std::dynamic_pointer_cast<vineyard::Table>(vt.Seal(client)));
+      });
+      seals.emplace_back([this, &client, i]() {
+        vineyard::NumericArrayBuilder<vid_t> ovgid_list_builder(
+            client, ovgid_lists_[i]);
+        this->set_ovgid_list(
+            i, std::dynamic_pointer_cast<vineyard::NumericArray<vid_t>>(
+                   ovgid_list_builder.Seal(client)));
+      });
+      seals.emplace_back([this, &client, i]() {
+        vineyard::HashmapBuilder<vid_t, vid_t> ovg2l_builder(
+            client, std::move(ovg2l_maps_[i]));
+        this->set_ovg2l_map(
+            i, std::dynamic_pointer_cast<vineyard::Hashmap<vid_t, vid_t>>(
+                   ovg2l_builder.Seal(client)));
+      });
     }
 
     for (label_id_t i = 0; i < edge_label_num_; ++i) {
 #ifdef ENDPOINT_LISTS
-      {
+      seals.emplace_back([this, &client, i]() {
         vineyard::NumericArrayBuilder<vid_t> esa(client, edge_src_[i]);
         this->set_edge_src(
             i, std::dynamic_pointer_cast<vineyard::NumericArray<vid_t>>(
                    esa.Seal(client)));
-      }
-      {
+      });
+      seals.emplace_back([this, &client, i]() {
         vineyard::NumericArrayBuilder<vid_t> eda(client, edge_dst_[i]);
         this->set_edge_dst(
             i, std::dynamic_pointer_cast<vineyard::NumericArray<vid_t>>(
                    eda.Seal(client)));
-      }
+      });
 #endif
-      {
+      seals.emplace_back([this, &client, i]() {
         vineyard::TableBuilder et(client, edge_tables_[i]);
         this->set_edge_table(
             i, std::dynamic_pointer_cast<vineyard::Table>(et.Seal(client)));
-      }
+      });
     }
 
     for (label_id_t i = 0; i < vertex_label_num_; ++i) {
       for (label_id_t j = 0; j < edge_label_num_; ++j) {
         if (directed_) {
-          vineyard::FixedSizeBinaryArrayBuilder ie_builder(client,
-                                                           ie_lists_[i][j]);
-          this->set_in_edge_list(
-              i, j,
-              std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
-                  ie_builder.Seal(client)));
+          seals.emplace_back([this, &client, i, j]() {
+            vineyard::FixedSizeBinaryArrayBuilder ie_builder(client,
+                                                             ie_lists_[i][j]);
+            this->set_in_edge_list(
+                i, j,
+                std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+                    ie_builder.Seal(client)));
+          });
+          seals.emplace_back([this, &client, i, j]() {
+            vineyard::NumericArrayBuilder<int64_t> ieo(
+                client, ie_offsets_lists_[i][j]);
+            this->set_in_edge_offsets(
+                i, j,
+                std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+                    ieo.Seal(client)));
+          });
         }
-        {
+        seals.emplace_back([this, &client, i, j]() {
           vineyard::FixedSizeBinaryArrayBuilder oe_builder(client,
                                                            oe_lists_[i][j]);
           this->set_out_edge_list(
               i, j,
               std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
                   oe_builder.Seal(client)));
-        }
-        if (directed_) {
-          vineyard::NumericArrayBuilder<int64_t> ieo(client,
-                                                     ie_offsets_lists_[i][j]);
-          this->set_in_edge_offsets(
-              i, j,
-              std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
-                  ieo.Seal(client)));
-        }
-        {
+        });
+        seals.emplace_back([this, &client, i, j]() {
           vineyard::NumericArrayBuilder<int64_t> oeo(client,
                                                      oe_offsets_lists_[i][j]);
           this->set_out_edge_offsets(
               i, j,
               std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
                   oeo.Seal(client)));
-        }
+        });
       }
     }
+    parallel_invoke(seals);
 
     this->set_vertex_map(vm_ptr_);
     return vineyard::Status::OK();
@@ -0,0 +1,134 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_FRAGMENT_VIEW_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_FRAGMENT_VIEW_H_
+
+#include "grape/grape.h"
+
+#include "core/fragment/append_only_arrow_fragment.h"
+
+namespace gs {
+
+/**
+ * @brief A view of AppendOnlyArrowFragment as of an append batch, i.e., the
+ * vertices and the edges added by the batch and before, which reads the
+ * fragment in place without copying. The vertices of the view are the first
+ * ones of the fragment of each label, and the appended edges of the view are
+ * the ones of the smaller eids, see AppendOnlyArrowFragment::append_version.
+ *
+ * The vertices are numbered as the ones of the current fragment, so the
+ * vertex arrays of the fragment serve the view, while the outer vertices are
+ * renumbered when later batches add inner vertices.
+ *
+ * @tparam OID_T
+ * @tparam VID_T
+ */
+template <typename OID_T, typename VID_T>
+class AppendOnlyArrowFragmentView {
+ public:
+  using fragment_t = AppendOnlyArrowFragment<OID_T, VID_T>;
+  using oid_t = typename fragment_t::oid_t;
+  using vid_t = typename fragment_t::vid_t;
+  using eid_t = typename fragment_t::eid_t;
+  using label_id_t = typename fragment_t::label_id_t;
+  using vertex_t = typename fragment_t::vertex_t;
+  using vertex_range_t = typename fragment_t::vertex_range_t;
+  using adj_list_t = typename fragment_t::adj_list_t;
+
+  AppendOnlyArrowFragmentView(const fragment_t& fragment, size_t version)
+      : fragment_(fragment),
+        version_(version),
+        bounds_(fragment.append_version(version)) {}
+
+  const fragment_t& fragment() const { return fragment_; }
+
+  size_t version() const { return version_; }
+
+  vertex_range_t InnerVertices(label_id_t label_id) const {
+    vid_t begin = fragment_.InnerVertices(label_id).begin().GetValue();
+    return vertex_range_t(begin, begin + bounds_.ivnums[label_id]);
+  }
+
+  vertex_range_t OuterVertices(label_id_t label_id) const {
+    vid_t begin = fragment_.OuterVertices(label_id).begin().GetValue();
+    return vertex_range_t(begin, begin + bounds_.ovnums[label_id]);
+  }
+
+  vid_t GetInnerVerticesNum(label_id_t label_id) const {
+    return bounds_.ivnums[label_id];
+  }
+
+  vid_t GetOuterVerticesNum(label_id_t label_id) const {
+    return bounds_.ovnums[label_id];
+  }
+
+  // whether the vertex of the fragment is in the view
+  bool HasVertex(const vertex_t& v) const {
+    auto label_id = fragment_.vertex_label(v);
+    return InnerVertices(label_id).Contain(v) ||
+           OuterVertices(label_id).Contain(v);
+  }
+
+  // the appended edges of the edge label visible in the view are the ones of
+  // the eids below the bound
+  eid_t GetExtraEdgeNum(label_id_t e_label) const {
+    return bounds_.extra_oe_nums[e_label];
+  }
+
+  // the loaded edges, which are in every version
+  adj_list_t GetOutgoingAdjList(const vertex_t& v, label_id_t e_label) const {
+    return fragment_.GetOutgoingAdjList(v, e_label);
+  }
+
+  /**
+   * @brief Visits the outgoing edges of e_label of an inner vertex in the
+   * view, i.e., the loaded ones, and the appended ones of the eids below the
+   * bound of the view.
+   */
+  template <typename FUNC_T>
+  void ForEachOutgoingEdge(const vertex_t& v, label_id_t e_label,
+                           const FUNC_T& func) const {
+    eid_t bound = bounds_.extra_oe_nums[e_label];
+
+    for (auto& e : fragment_.GetOutgoingAdjList(v, e_label)) {
+      func(e);
+    }
+    for (auto& e : fragment_.GetExtraOutgoingAdjList(v, e_label)) {
+      if (e.edge_id() < bound) {
+        func(e);
+      }
+    }
+  }
+
+  size_t GetLocalOutDegree(const vertex_t& v, label_id_t e_label) const {
+    eid_t bound = bounds_.extra_oe_nums[e_label];
+    size_t degree = fragment_.GetLocalOutDegree(v, e_label);
+
+    for (auto& e : fragment_.GetExtraOutgoingAdjList(v, e_label)) {
+      degree += e.edge_id() < bound;
+    }
+    return degree;
+  }
+
+ private:
+  const fragment_t& fragment_;
+  size_t version_;
+  typename fragment_t::append_version_t bounds_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_FRAGMENT_VIEW_H_
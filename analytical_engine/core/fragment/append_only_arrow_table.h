@@ -16,8 +16,10 @@
 #ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_TABLE_H_
 #define ANALYTICAL_ENGINE_CORE_FRAGMENT_APPEND_ONLY_ARROW_TABLE_H_
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "vineyard/basic/ds/arrow_utils.h"
@@ -96,13 +98,69 @@ struct ValueGetter<std::string> {
         .to_string();
   }
 };
+
+template <typename T>
+struct ChunkValueGetter {
+  static T get(const std::shared_ptr<arrow::Array>& array, int64_t idx) {
+    using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+    return static_cast<const array_t*>(array.get())->Value(idx);
+  }
+};
+
+template <>
+struct ChunkValueGetter<std::string> {
+  static std::string get(const std::shared_ptr<arrow::Array>& array,
+                         int64_t idx) {
+    if (array->type()->id() == arrow::Type::STRING) {
+      return static_cast<const arrow::StringArray*>(array.get())
+          ->GetString(idx);
+    }
+    return static_cast<const arrow::LargeStringArray*>(array.get())
+        ->GetString(idx);
+  }
+};
 }  // namespace append_only_arrow_table_impl
 
 /**
- * @brief An arrow table composed by multiple arrow array builder
+ * @brief A snapshot of an AppendOnlyArrowTable, which holds the rows sealed
+ * up to a version in immutable chunks. The snapshot can be read while rows are
+ * appended to the table and later versions are sealed.
+ */
+class AppendOnlyArrowTableSnapshot {
+ public:
+  uint64_t version() const { return version_; }
+
+  int64_t size() const { return offsets_.back(); }
+
+  template <typename T>
+  T GetValue(int column_id, int64_t row_id) const {
+    auto chunk_id =
+        std::upper_bound(offsets_.begin(), offsets_.end(), row_id) -
+        offsets_.begin() - 1;
+    return append_only_arrow_table_impl::ChunkValueGetter<T>::get(
+        chunks_[chunk_id][column_id], row_id - offsets_[chunk_id]);
+  }
+
+ private:
+  uint64_t version_ = 0;
+  // the arrays of the columns of each chunk
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> chunks_;
+  // the rows of the i-th chunk are [offsets_[i], offsets_[i + 1])
+  std::vector<int64_t> offsets_{0};
+
+  friend class AppendOnlyArrowTable;
+};
+
+/**
+ * @brief An arrow table composed by multiple arrow array builder. The rows
+ * appended are kept in the builders until they are sealed into an immutable
+ * chunk by Seal, which publishes a new snapshot.
  */
 class AppendOnlyArrowTable {
  public:
+  AppendOnlyArrowTable()
+      : snapshot_(std::make_shared<const AppendOnlyArrowTableSnapshot>()) {}
+
   bl::result<void> AppendValue(int col, uint64_t val) {
     auto builder =
         std::dynamic_pointer_cast<arrow::UInt64Builder>(builders_[col]);
@@ -226,16 +284,104 @@ class AppendOnlyArrowTable {
     return {};
   }
 
+  /**
+   * @brief Appends the rows of the table column by column, which reserves
+   * each builder once for the rows rather than appending cell by cell.
+   */
+  bl::result<void> AppendRows(const std::shared_ptr<arrow::Table>& table,
+                              const std::vector<int64_t>& rows) {
+    BOOST_LEAF_CHECK(createBuildersIfNeeded(table));
+
+    for (int64_t i = 0; i < table->num_columns(); i++) {
+      auto column = table->column(i);
+      auto type = column->type();
+
+      CHECK_EQ(column->num_chunks(), 1);
+
+      auto chunk = column->chunk(0);
+      auto& builder = builders_[i];
+
+      if (type == arrow::uint64()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::UInt64Array, arrow::UInt64Builder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::int64()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::Int64Array, arrow::Int64Builder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::uint32()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::UInt32Array, arrow::UInt32Builder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::int32()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::Int32Array, arrow::Int32Builder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::float64()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::DoubleArray, arrow::DoubleBuilder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::float32()) {
+        BOOST_LEAF_CHECK((appendRows<arrow::FloatArray, arrow::FloatBuilder>(
+            chunk, builder, rows)));
+      } else if (type == arrow::utf8()) {
+        BOOST_LEAF_CHECK(
+            (appendStringRows<arrow::StringArray, arrow::StringBuilder>(
+                chunk, builder, rows)));
+      } else if (type == arrow::large_utf8()) {
+        BOOST_LEAF_CHECK((appendStringRows<arrow::LargeStringArray,
+                                             arrow::LargeStringBuilder>(
+            chunk, builder, rows)));
+      } else {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kArrowError,
+                        "Unsupported type: " + type->ToString());
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @brief Seals the rows appended since the last seal into a chunk, and
+   * publishes the snapshot of all of the sealed rows as a new version. It is
+   * called by the appending thread.
+   */
+  bl::result<void> Seal() {
+    if (builders_.empty() || builders_[0]->length() == 0) {
+      return {};
+    }
+    auto snapshot = std::make_shared<AppendOnlyArrowTableSnapshot>(*snapshot_);
+    std::vector<std::shared_ptr<arrow::Array>> chunk(builders_.size());
+
+    for (size_t i = 0; i < builders_.size(); i++) {
+      ARROW_OK_OR_RAISE(builders_[i]->Finish(&chunk[i]));
+    }
+    snapshot->version_++;
+    snapshot->offsets_.push_back(snapshot->size() + chunk[0]->length());
+    snapshot->chunks_.push_back(std::move(chunk));
+    std::shared_ptr<const AppendOnlyArrowTableSnapshot> published =
+        std::move(snapshot);
+    std::atomic_store(&snapshot_, published);
+    return {};
+  }
+
+  /**
+   * @brief Pins the latest sealed version, which can be read concurrently with
+   * the appends.
+   */
+  std::shared_ptr<const AppendOnlyArrowTableSnapshot> Snapshot() const {
+    return std::atomic_load(&snapshot_);
+  }
+
+  // reads the sealed and the unsealed rows, not concurrently with the appends
   template <typename T>
-  T GetValue(int column_id, int row_id) {
+  T GetValue(int column_id, int64_t row_id) {
+    auto sealed_num = snapshot_->size();
+    if (row_id < sealed_num) {
+      return snapshot_->GetValue<T>(column_id, row_id);
+    }
     return append_only_arrow_table_impl::ValueGetter<T>::get(
-        builders_[column_id], row_id);
+        builders_[column_id], row_id - sealed_num);
   }
 
   int64_t size() {
     if (schema_->num_fields() == 0)
       return 0;
-    return builders_[0]->length();
+    return snapshot_->size() + builders_[0]->length();
   }
 
   std::shared_ptr<arrow::Schema> schema() { return schema_; }
@@ -243,6 +389,42 @@ class AppendOnlyArrowTable {
  private:
   std::shared_ptr<arrow::Schema> schema_;
   std::vector<std::shared_ptr<arrow::ArrayBuilder>> builders_;
+  std::shared_ptr<const AppendOnlyArrowTableSnapshot> snapshot_;
+
+  template <typename ARRAY_T, typename BUILDER_T>
+  static bl::result<void> appendRows(
+      const std::shared_ptr<arrow::Array>& chunk,
+      const std::shared_ptr<arrow::ArrayBuilder>& builder,
+      const std::vector<int64_t>& rows) {
+    auto array = std::dynamic_pointer_cast<ARRAY_T>(chunk);
+    auto typed_builder = std::dynamic_pointer_cast<BUILDER_T>(builder);
+
+    ARROW_OK_OR_RAISE(typed_builder->Reserve(rows.size()));
+    for (auto row : rows) {
+      typed_builder->UnsafeAppend(array->Value(row));
+    }
+    return {};
+  }
+
+  template <typename ARRAY_T, typename BUILDER_T>
+  static bl::result<void> appendStringRows(
+      const std::shared_ptr<arrow::Array>& chunk,
+      const std::shared_ptr<arrow::ArrayBuilder>& builder,
+      const std::vector<int64_t>& rows) {
+    auto array = std::dynamic_pointer_cast<ARRAY_T>(chunk);
+    auto typed_builder = std::dynamic_pointer_cast<BUILDER_T>(builder);
+    int64_t data_size = 0;
+
+    for (auto row : rows) {
+      data_size += array->value_length(row);
+    }
+    ARROW_OK_OR_RAISE(typed_builder->Reserve(rows.size()));
+    ARROW_OK_OR_RAISE(typed_builder->ReserveData(data_size));
+    for (auto row : rows) {
+      typed_builder->UnsafeAppend(array->GetView(row));
+    }
+    return {};
+  }
 
   bl::result<void> createBuildersIfNeeded(
       const std::shared_ptr<arrow::Table>& table) {
@@ -0,0 +1,668 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "grape/grape.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+
+#include "core/error.h"
+#include "core/fragment/arrow_projected_fragment.h"
+#include "core/utils/parallel_utils.h"
+
+namespace gs {
+
+/**
+ * @brief ArrowFlattenedFragment is a simple graph over several vertex labels
+ * and edge labels of an ArrowFragment, where the inner vertices of the labels
+ * are numbered contiguously from 0 in the order of the labels, followed by
+ * the outer vertices in the order of the gids, i.e., grouped by the
+ * fragments. The edges of the labels between the chosen vertex labels are
+ * merged into a single csr owned by the fragment, with the edge data copied
+ * along, so the apps of the simple graphs run over the heterogeneous subgraph
+ * as over an ArrowProjectedFragment. The gids are those of the ArrowFragment.
+ *
+ * @tparam OID_T
+ * @tparam VID_T
+ * @tparam VDATA_T The type of the vertex properties, the same for the labels
+ * @tparam EDATA_T The type of the edge properties, the same for the labels
+ */
+template <typename OID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class ArrowFlattenedFragment {
+ public:
+  using oid_t = OID_T;
+  using vid_t = VID_T;
+  using eid_t = vineyard::property_graph_types::EID_TYPE;
+  using vdata_t = VDATA_T;
+  using edata_t = EDATA_T;
+  using vertex_range_t = grape::VertexRange<vid_t>;
+  using vertex_t = grape::Vertex<vid_t>;
+  using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<vid_t, eid_t>;
+  using nbr_t = arrow_projected_fragment_impl::Nbr<vid_t, eid_t, EDATA_T>;
+  using adj_list_t =
+      arrow_projected_fragment_impl::AdjList<vid_t, eid_t, EDATA_T>;
+  using const_adj_list_t = adj_list_t;
+  using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
+  using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
+  using property_graph_t = vineyard::ArrowFragment<oid_t, vid_t>;
+  using edata_value_t =
+      typename arrow_projected_fragment_impl::TypedArray<EDATA_T>::value_type;
+
+  template <typename DATA_T>
+  using vertex_array_t = grape::VertexArray<DATA_T, vid_t>;
+
+  static constexpr grape::LoadStrategy load_strategy =
+      grape::LoadStrategy::kBothOutIn;
+
+  /**
+   * @brief Flattens the vertex labels v_labels and the edge labels e_labels of
+   * fragment, where v_props and e_props are the property of each label to be
+   * the vertex data and the edge data, or -1 for the labels without data.
+   */
+  static bl::result<std::shared_ptr<ArrowFlattenedFragment>> Project(
+      std::shared_ptr<property_graph_t> fragment,
+      const std::vector<label_id_t>& v_labels,
+      const std::vector<prop_id_t>& v_props,
+      const std::vector<label_id_t>& e_labels,
+      const std::vector<prop_id_t>& e_props) {
+    if (v_labels.empty() || v_labels.size() != v_props.size() ||
+        e_labels.size() != e_props.size()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Expects a property for each of the labels to flatten");
+    }
+    for (size_t i = 0; i < v_labels.size(); ++i) {
+      BOOST_LEAF_CHECK(checkDataType<vdata_t>(
+          fragment->vertex_data_table(v_labels[i]), v_props[i], "Vertex"));
+    }
+    for (size_t i = 0; i < e_labels.size(); ++i) {
+      BOOST_LEAF_CHECK(checkDataType<edata_t>(
+          fragment->edge_data_table(e_labels[i]), e_props[i], "Edge"));
+    }
+
+    auto frag = std::make_shared<ArrowFlattenedFragment>();
+    frag->init(fragment, v_labels, v_props, e_labels, e_props);
+    return frag;
+  }
+
+  void PrepareToRunApp(grape::MessageStrategy strategy, bool need_split_edges) {
+    if (strategy == grape::MessageStrategy::kAlongEdgeToOuterVertex) {
+      initDestFidList(true, true, iodst_, iodoffset_);
+    } else if (strategy ==
+               grape::MessageStrategy::kAlongIncomingEdgeToOuterVertex) {
+      initDestFidList(true, false, idst_, idoffset_);
+    } else if (strategy ==
+               grape::MessageStrategy::kAlongOutgoingEdgeToOuterVertex) {
+      initDestFidList(false, true, odst_, odoffset_);
+    }
+
+    if (need_split_edges) {
+      initEdgeSpliters(oe_, oe_offsets_, oe_spliters_);
+      if (directed_) {
+        initEdgeSpliters(ie_, ie_offsets_, ie_spliters_);
+      }
+    }
+
+    initMirrorInfo();
+  }
+
+  inline fid_t fid() const { return fid_; }
+
+  inline fid_t fnum() const { return fnum_; }
+
+  inline bool directed() const { return directed_; }
+
+  inline vertex_range_t Vertices() const { return vertex_range_t(0, tvnum_); }
+
+  inline vertex_range_t InnerVertices() const {
+    return vertex_range_t(0, ivnum_);
+  }
+
+  inline vertex_range_t OuterVertices() const {
+    return vertex_range_t(ivnum_, tvnum_);
+  }
+
+  inline vertex_range_t OuterVertices(fid_t fid) const {
+    return vertex_range_t(outer_vertex_offsets_[fid],
+                          outer_vertex_offsets_[fid + 1]);
+  }
+
+  inline const std::vector<vertex_t>& MirrorVertices(fid_t fid) const {
+    return mirrors_of_frag_[fid];
+  }
+
+  inline vid_t GetInnerVerticesNum() const { return ivnum_; }
+
+  inline vid_t GetOuterVerticesNum() const { return tvnum_ - ivnum_; }
+
+  inline vid_t GetVerticesNum() const { return tvnum_; }
+
+  inline size_t GetEdgeNum() const { return oe_.size(); }
+
+  inline size_t GetTotalVerticesNum() const { return total_vnum_; }
+
+  // the bytes of the merged csr and the vertex indices owned by the fragment
+  size_t MemoryUsage() const {
+    return (ie_.size() + oe_.size()) * sizeof(nbr_unit_t) +
+           (ie_edata_.size() + oe_edata_.size()) * sizeof(edata_value_t) +
+           (ie_offsets_.size() + oe_offsets_.size()) * sizeof(int64_t) +
+           (arrow_vids_.size() + ovgids_.size()) * sizeof(vid_t);
+  }
+
+  inline bool IsInnerVertex(const vertex_t& v) const {
+    return v.GetValue() < ivnum_;
+  }
+
+  inline bool IsOuterVertex(const vertex_t& v) const {
+    return v.GetValue() >= ivnum_ && v.GetValue() < tvnum_;
+  }
+
+  // the vertex of the first vertex label with the oid, if the oids of the
+  // labels overlap
+  inline bool GetVertex(const oid_t& oid, vertex_t& v) const {
+    vertex_t arrow_v;
+    for (auto label : v_labels_) {
+      if (fragment_->GetVertex(label, oid, arrow_v)) {
+        return toFlattened(arrow_v, v);
+      }
+    }
+    return false;
+  }
+
+  inline bool GetInnerVertex(const oid_t& oid, vertex_t& v) const {
+    vertex_t arrow_v;
+    for (auto label : v_labels_) {
+      if (fragment_->GetInnerVertex(label, oid, arrow_v)) {
+        return toFlattened(arrow_v, v);
+      }
+    }
+    return false;
+  }
+
+  inline bool GetOuterVertex(const oid_t& oid, vertex_t& v) const {
+    return GetVertex(oid, v) && IsOuterVertex(v);
+  }
+
+  inline oid_t GetId(const vertex_t& v) const {
+    return fragment_->GetId(vertex_t(arrow_vids_[v.GetValue()]));
+  }
+
+  inline oid_t GetInnerVertexId(const vertex_t& v) const { return GetId(v); }
+
+  inline oid_t GetOuterVertexId(const vertex_t& v) const { return GetId(v); }
+
+  inline oid_t Gid2Oid(const vid_t& gid) const {
+    return fragment_->Gid2Oid(gid);
+  }
+
+  inline bool Oid2Gid(const oid_t& oid, vid_t& gid) const {
+    vertex_t v;
+    if (GetVertex(oid, v)) {
+      gid = Vertex2Gid(v);
+      return true;
+    }
+    return false;
+  }
+
+  inline fid_t GetFragId(const vertex_t& v) const {
+    return IsInnerVertex(v) ? fid_ : vid_parser_.GetFid(GetOuterVertexGid(v));
+  }
+
+  inline typename arrow_projected_fragment_impl::TypedArray<VDATA_T>::value_type
+  GetData(const vertex_t& v) const {
+    vid_t arrow_vid = arrow_vids_[v.GetValue()];
+    return vdata_accessors_[vid_parser_.GetLabelId(arrow_vid)]
+                           [vid_parser_.GetOffset(arrow_vid)];
+  }
+
+  inline bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
+    return (vid_parser_.GetFid(gid) == fid_) ? InnerVertexGid2Vertex(gid, v)
+                                             : OuterVertexGid2Vertex(gid, v);
+  }
+
+  inline vid_t Vertex2Gid(const vertex_t& v) const {
+    return IsInnerVertex(v) ? GetInnerVertexGid(v) : GetOuterVertexGid(v);
+  }
+
+  inline bool InnerVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    vertex_t arrow_v;
+    return fragment_->InnerVertexGid2Vertex(gid, arrow_v) &&
+           toFlattened(arrow_v, v);
+  }
+
+  inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    vertex_t arrow_v;
+    return fragment_->OuterVertexGid2Vertex(gid, arrow_v) &&
+           toFlattened(arrow_v, v);
+  }
+
+  inline vid_t GetInnerVertexGid(const vertex_t& v) const {
+    return fragment_->GetInnerVertexGid(vertex_t(arrow_vids_[v.GetValue()]));
+  }
+
+  inline vid_t GetOuterVertexGid(const vertex_t& v) const {
+    return ovgids_[v.GetValue() - ivnum_];
+  }
+
+  inline adj_list_t GetIncomingAdjList(const vertex_t& v) const {
+    return directed_ ? makeAdjList(ie_, ie_edata_, ie_offsets_[v.GetValue()],
+                                   ie_offsets_[v.GetValue() + 1])
+                     : GetOutgoingAdjList(v);
+  }
+
+  inline adj_list_t GetOutgoingAdjList(const vertex_t& v) const {
+    return makeAdjList(oe_, oe_edata_, oe_offsets_[v.GetValue()],
+                       oe_offsets_[v.GetValue() + 1]);
+  }
+
+  inline adj_list_t GetIncomingInnerVertexAdjList(const vertex_t& v) const {
+    return directed_ ? makeAdjList(ie_, ie_edata_, ie_offsets_[v.GetValue()],
+                                   splitOf(ie_offsets_, ie_spliters_, 0, v))
+                     : GetOutgoingInnerVertexAdjList(v);
+  }
+
+  inline adj_list_t GetOutgoingInnerVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(oe_, oe_edata_, oe_offsets_[v.GetValue()],
+                       splitOf(oe_offsets_, oe_spliters_, 0, v));
+  }
+
+  inline adj_list_t GetIncomingOuterVertexAdjList(const vertex_t& v) const {
+    return directed_ ? makeAdjList(ie_, ie_edata_,
+                                   splitOf(ie_offsets_, ie_spliters_, 0, v),
+                                   ie_offsets_[v.GetValue() + 1])
+                     : GetOutgoingOuterVertexAdjList(v);
+  }
+
+  inline adj_list_t GetOutgoingOuterVertexAdjList(const vertex_t& v) const {
+    return makeAdjList(oe_, oe_edata_, splitOf(oe_offsets_, oe_spliters_, 0, v),
+                       oe_offsets_[v.GetValue() + 1]);
+  }
+
+  inline adj_list_t GetIncomingAdjList(const vertex_t& v, fid_t src_fid) const {
+    if (!directed_) {
+      return GetOutgoingAdjList(v, src_fid);
+    }
+    return IsInnerVertex(v)
+               ? makeAdjList(ie_, ie_edata_, splitOf(ie_offsets_, ie_spliters_,
+                                                     src_fid, v),
+                             splitOf(ie_offsets_, ie_spliters_, src_fid + 1, v))
+               : (src_fid == fid_ ? GetIncomingAdjList(v) : adj_list_t());
+  }
+
+  inline adj_list_t GetOutgoingAdjList(const vertex_t& v, fid_t dst_fid) const {
+    return IsInnerVertex(v)
+               ? makeAdjList(oe_, oe_edata_, splitOf(oe_offsets_, oe_spliters_,
+                                                     dst_fid, v),
+                             splitOf(oe_offsets_, oe_spliters_, dst_fid + 1, v))
+               : (dst_fid == fid_ ? GetOutgoingAdjList(v) : adj_list_t());
+  }
+
+  inline int GetLocalOutDegree(const vertex_t& v) const {
+    return GetOutgoingAdjList(v).Size();
+  }
+
+  inline int GetLocalInDegree(const vertex_t& v) const {
+    return GetIncomingAdjList(v).Size();
+  }
+
+  inline grape::DestList IEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(idoffset_[v.GetValue()],
+                           idoffset_[v.GetValue() + 1]);
+  }
+
+  inline grape::DestList OEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(odoffset_[v.GetValue()],
+                           odoffset_[v.GetValue() + 1]);
+  }
+
+  inline grape::DestList IOEDests(const vertex_t& v) const {
+    assert(IsInnerVertex(v));
+    return grape::DestList(iodoffset_[v.GetValue()],
+                           iodoffset_[v.GetValue() + 1]);
+  }
+
+ private:
+  template <typename T>
+  static bl::result<void> checkDataType(std::shared_ptr<arrow::Table> table,
+                                        prop_id_t prop,
+                                        const std::string& kind) {
+    bool consistent =
+        prop == -1 ? std::is_same<T, grape::EmptyType>::value
+                   : table->field(prop)->type()->Equals(
+                         vineyard::ConvertToArrowType<T>::TypeValue());
+    if (!consistent) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      kind + " data type of flattened fragment is not "
+                             "consistent with property.");
+    }
+    return {};
+  }
+
+  static std::shared_ptr<arrow::Array> columnOf(
+      std::shared_ptr<arrow::Table> table, prop_id_t prop) {
+    if (prop == -1 || table->num_rows() == 0) {
+      return nullptr;
+    }
+    return table->column(prop)->chunk(0);
+  }
+
+  void init(std::shared_ptr<property_graph_t> fragment,
+            const std::vector<label_id_t>& v_labels,
+            const std::vector<prop_id_t>& v_props,
+            const std::vector<label_id_t>& e_labels,
+            const std::vector<prop_id_t>& e_props) {
+    fragment_ = fragment;
+    fid_ = fragment->fid();
+    fnum_ = fragment->fnum();
+    directed_ = fragment->directed();
+    v_labels_ = v_labels;
+    label_id_t vertex_label_num = fragment->vertex_label_num();
+    vid_parser_.Init(fnum_, vertex_label_num);
+
+    // the inner vertices in the order of the labels
+    inner_bases_.assign(vertex_label_num, invalidVid());
+    ivnums_.assign(vertex_label_num, 0);
+    vdata_accessors_.resize(vertex_label_num);
+    total_vnum_ = 0;
+    ivnum_ = 0;
+    for (size_t i = 0; i < v_labels.size(); ++i) {
+      label_id_t label = v_labels[i];
+      auto inner_vertices = fragment->InnerVertices(label);
+      inner_bases_[label] = ivnum_;
+      ivnums_[label] = static_cast<vid_t>(inner_vertices.size());
+      ivnum_ += ivnums_[label];
+      for (auto v : inner_vertices) {
+        arrow_vids_.push_back(v.GetValue());
+      }
+      vdata_accessors_[label].Init(
+          columnOf(fragment->vertex_data_table(label), v_props[i]));
+      total_vnum_ += fragment->GetTotalVerticesNum(label);
+    }
+
+    // the outer vertices in the order of the gids, i.e., by the fragments
+    std::vector<std::pair<vid_t, vid_t>> outer_vertices;
+    outer_flattened_.resize(vertex_label_num);
+    for (auto label : v_labels) {
+      for (auto v : fragment->OuterVertices(label)) {
+        outer_vertices.emplace_back(fragment->GetOuterVertexGid(v),
+                                    v.GetValue());
+      }
+      outer_flattened_[label].resize(fragment->OuterVertices(label).size());
+    }
+    std::sort(outer_vertices.begin(), outer_vertices.end());
+    tvnum_ = ivnum_ + static_cast<vid_t>(outer_vertices.size());
+    outer_vertex_offsets_.assign(fnum_ + 1, 0);
+    ovgids_.reserve(outer_vertices.size());
+    for (auto& pair : outer_vertices) {
+      vid_t flattened = static_cast<vid_t>(arrow_vids_.size());
+      vid_t arrow_vid = pair.second;
+      label_id_t label = vid_parser_.GetLabelId(arrow_vid);
+      outer_flattened_[label][vid_parser_.GetOffset(arrow_vid) -
+                              ivnums_[label]] = flattened;
+      arrow_vids_.push_back(arrow_vid);
+      ovgids_.push_back(pair.first);
+      ++outer_vertex_offsets_[vid_parser_.GetFid(pair.first) + 1];
+    }
+    outer_vertex_offsets_[0] = ivnum_;
+    for (fid_t i = 0; i < fnum_; ++i) {
+      outer_vertex_offsets_[i + 1] += outer_vertex_offsets_[i];
+    }
+
+    std::vector<arrow_projected_fragment_impl::TypedArray<EDATA_T>>
+        edata_accessors(e_labels.size());
+    for (size_t i = 0; i < e_labels.size(); ++i) {
+      edata_accessors[i].Init(
+          columnOf(fragment->edge_data_table(e_labels[i]), e_props[i]));
+    }
+    buildCsr(e_labels, edata_accessors, true, oe_, oe_edata_, oe_offsets_);
+    if (directed_) {
+      buildCsr(e_labels, edata_accessors, false, ie_, ie_edata_, ie_offsets_);
+    }
+  }
+
+  inline bool toFlattened(const vertex_t& arrow_v, vertex_t& v) const {
+    vid_t arrow_vid = arrow_v.GetValue();
+    label_id_t label = vid_parser_.GetLabelId(arrow_vid);
+    if (static_cast<size_t>(label) >= inner_bases_.size() ||
+        inner_bases_[label] == invalidVid()) {
+      return false;
+    }
+    vid_t offset = static_cast<vid_t>(vid_parser_.GetOffset(arrow_vid));
+    if (offset < ivnums_[label]) {
+      v.SetValue(inner_bases_[label] + offset);
+    } else {
+      v.SetValue(outer_flattened_[label][offset - ivnums_[label]]);
+    }
+    return true;
+  }
+
+  // the inner neighbors come first, followed by the outer ones by fragments,
+  // which is the layout the edge spliters rely on
+  inline fid_t rankOf(vid_t v) const {
+    return v < ivnum_ ? 0 : vid_parser_.GetFid(ovgids_[v - ivnum_]) + 1;
+  }
+
+  // calls func(v, data) for each edge of the edge labels from u to the
+  // flattened vertex v, or to u from v if not outgoing
+  template <typename FUNC_T>
+  void forEachEdge(
+      vid_t u, const std::vector<label_id_t>& e_labels,
+      const std::vector<arrow_projected_fragment_impl::TypedArray<EDATA_T>>&
+          edata_accessors,
+      bool outgoing, const FUNC_T& func) const {
+    vertex_t arrow_u(arrow_vids_[u]);
+    for (size_t i = 0; i < e_labels.size(); ++i) {
+      auto es = outgoing ? fragment_->GetOutgoingAdjList(arrow_u, e_labels[i])
+                         : fragment_->GetIncomingAdjList(arrow_u, e_labels[i]);
+      for (auto& e : es) {
+        vertex_t v;
+        if (toFlattened(e.neighbor(), v)) {
+          func(v.GetValue(), edata_accessors[i][e.edge_id()]);
+        }
+      }
+    }
+  }
+
+  void buildCsr(
+      const std::vector<label_id_t>& e_labels,
+      const std::vector<arrow_projected_fragment_impl::TypedArray<EDATA_T>>&
+          edata_accessors,
+      bool outgoing, std::vector<nbr_unit_t>& nbrs,
+      std::vector<edata_value_t>& edata, std::vector<int64_t>& offsets) {
+    offsets.assign(static_cast<size_t>(tvnum_) + 1, 0);
+    parallel_for(0, static_cast<size_t>(ivnum_), [&](size_t u) {
+      int64_t degree = 0;
+      forEachEdge(static_cast<vid_t>(u), e_labels, edata_accessors, outgoing,
+                  [&degree](vid_t, const edata_value_t&) { ++degree; });
+      offsets[u + 1] = degree;
+    });
+    for (size_t u = 0; u < static_cast<size_t>(tvnum_); ++u) {
+      offsets[u + 1] += offsets[u];
+    }
+
+    nbrs.resize(offsets[tvnum_]);
+    edata.resize(std::is_same<EDATA_T, grape::EmptyType>::value
+                     ? 0
+                     : static_cast<size_t>(offsets[tvnum_]));
+    parallel_for(0, static_cast<size_t>(ivnum_), [&](size_t u) {
+      std::vector<std::pair<vid_t, edata_value_t>> list;
+      forEachEdge(static_cast<vid_t>(u), e_labels, edata_accessors, outgoing,
+                  [&list](vid_t v, const edata_value_t& data) {
+                    list.emplace_back(v, data);
+                  });
+      std::stable_sort(list.begin(), list.end(),
+                       [this](const std::pair<vid_t, edata_value_t>& lhs,
+                              const std::pair<vid_t, edata_value_t>& rhs) {
+                         return rankOf(lhs.first) < rankOf(rhs.first);
+                       });
+      int64_t pos = offsets[u];
+      for (auto& pair : list) {
+        nbrs[pos].vid = pair.first;
+        nbrs[pos].eid = static_cast<eid_t>(pos);
+        if (!edata.empty()) {
+          edata[pos] = pair.second;
+        }
+        ++pos;
+      }
+    });
+  }
+
+  inline adj_list_t makeAdjList(const std::vector<nbr_unit_t>& nbrs,
+                                const std::vector<edata_value_t>& edata,
+                                int64_t begin, int64_t end) const {
+    return adj_list_t(nbrs.data() + begin, nbrs.data() + end,
+                      arrow_projected_fragment_impl::TypedArray<EDATA_T>(),
+                      edata.empty() ? NULL : edata.data(), nbrs.data());
+  }
+
+  inline int64_t splitOf(const std::vector<int64_t>& offsets,
+                         const std::vector<std::vector<int64_t>>& spliters,
+                         fid_t index, const vertex_t& v) const {
+    return IsInnerVertex(v) ? spliters[index][v.GetValue()]
+                            : offsets[v.GetValue() + 1];
+  }
+
+  void initEdgeSpliters(const std::vector<nbr_unit_t>& nbrs,
+                        const std::vector<int64_t>& offsets,
+                        std::vector<std::vector<int64_t>>& spliters) {
+    if (!spliters.empty()) {
+      return;
+    }
+    spliters.resize(fnum_ + 1);
+    for (auto& vec : spliters) {
+      vec.resize(ivnum_);
+    }
+    parallel_for(0, static_cast<size_t>(ivnum_), [&](size_t u) {
+      int64_t pos = offsets[u];
+      int64_t end = offsets[u + 1];
+      while (pos != end && rankOf(nbrs[pos].vid) == 0) {
+        ++pos;
+      }
+      spliters[0][u] = pos;
+      for (fid_t i = 0; i < fnum_; ++i) {
+        while (pos != end && rankOf(nbrs[pos].vid) == i + 1) {
+          ++pos;
+        }
+        spliters[i + 1][u] = pos;
+      }
+    });
+  }
+
+  void initDestFidList(bool in_edge, bool out_edge,
+                       std::vector<fid_t>& fid_list,
+                       std::vector<fid_t*>& fid_list_offset) {
+    if (!fid_list_offset.empty()) {
+      return;
+    }
+    std::vector<int> id_num(ivnum_, 0);
+    std::vector<std::vector<fid_t>> dsts(ivnum_);
+    parallel_for(0, static_cast<size_t>(ivnum_), [&](size_t u) {
+      vertex_t v(static_cast<vid_t>(u));
+      auto& dst = dsts[u];
+      if (in_edge) {
+        for (auto& e : GetIncomingAdjList(v)) {
+          dst.push_back(GetFragId(e.neighbor()));
+        }
+      }
+      if (out_edge) {
+        for (auto& e : GetOutgoingAdjList(v)) {
+          dst.push_back(GetFragId(e.neighbor()));
+        }
+      }
+      std::sort(dst.begin(), dst.end());
+      dst.erase(std::unique(dst.begin(), dst.end()), dst.end());
+      dst.erase(std::remove(dst.begin(), dst.end(), fid_), dst.end());
+      id_num[u] = static_cast<int>(dst.size());
+    });
+
+    fid_list.clear();
+    for (auto& dst : dsts) {
+      fid_list.insert(fid_list.end(), dst.begin(), dst.end());
+    }
+    fid_list.shrink_to_fit();
+    fid_list_offset.resize(ivnum_ + 1, NULL);
+    fid_list_offset[0] = fid_list.data();
+    for (vid_t i = 0; i < ivnum_; ++i) {
+      fid_list_offset[i + 1] = fid_list_offset[i] + id_num[i];
+    }
+  }
+
+  void initMirrorInfo() {
+    if (!mirrors_of_frag_.empty()) {
+      return;
+    }
+    mirrors_of_frag_.resize(fnum_);
+    std::vector<bool> bm(fnum_, false);
+    for (vid_t u = 0; u < ivnum_; ++u) {
+      vertex_t v(u);
+      for (auto& e : GetOutgoingAdjList(v)) {
+        bm[GetFragId(e.get_neighbor())] = true;
+      }
+      for (auto& e : GetIncomingAdjList(v)) {
+        bm[GetFragId(e.get_neighbor())] = true;
+      }
+      for (fid_t i = 0; i != fnum_; ++i) {
+        if ((i != fid_) && bm[i]) {
+          mirrors_of_frag_[i].push_back(v);
+        }
+        bm[i] = false;
+      }
+    }
+  }
+
+  static vid_t invalidVid() { return std::numeric_limits<vid_t>::max(); }
+
+  std::shared_ptr<property_graph_t> fragment_;
+  fid_t fid_, fnum_;
+  bool directed_;
+  vineyard::IdParser<vid_t> vid_parser_;
+
+  std::vector<label_id_t> v_labels_;
+  vid_t ivnum_, tvnum_;
+  size_t total_vnum_;
+  // the arrow vids of the flattened vertices
+  std::vector<vid_t> arrow_vids_;
+  // by the vertex labels, invalidVid() for the labels not flattened
+  std::vector<vid_t> inner_bases_;
+  std::vector<vid_t> ivnums_;
+  std::vector<std::vector<vid_t>> outer_flattened_;
+  std::vector<arrow_projected_fragment_impl::TypedArray<VDATA_T>>
+      vdata_accessors_;
+  // the gids of the outer vertices
+  std::vector<vid_t> ovgids_;
+  std::vector<vid_t> outer_vertex_offsets_;
+
+  std::vector<nbr_unit_t> ie_, oe_;
+  std::vector<edata_value_t> ie_edata_, oe_edata_;
+  std::vector<int64_t> ie_offsets_, oe_offsets_;
+  std::vector<std::vector<int64_t>> ie_spliters_, oe_spliters_;
+
+  std::vector<fid_t> idst_, odst_, iodst_;
+  std::vector<fid_t*> idoffset_, odoffset_, iodoffset_;
+  std::vector<std::vector<vertex_t>> mirrors_of_frag_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_FLATTENED_FRAGMENT_H_
@@ -16,9 +16,12 @@
 #ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_PROJECTED_FRAGMENT_H_
 #define ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_PROJECTED_FRAGMENT_H_
 
+#include <algorithm>
+#include <functional>
 #include <memory>
-#include <set>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -31,7 +34,16 @@
 
 #include "core/context/context_protocols.h"
 #include "core/fragment/arrow_projected_fragment_base.h"
+#include "core/fragment/compressed_adj_list.h"
+#include "core/fragment/edge_filter.h"
+#include "core/fragment/edge_window.h"
+#include "core/fragment/sorted_adj_list.h"
+#include "core/fragment/vertex_order.h"
+#include "core/utils/alias_table.h"
+#include "core/utils/mmap_utils.h"
+#include "core/utils/parallel_utils.h"
 #include "core/vertex_map/arrow_projected_vertex_map.h"
+#include "core/vertex_map/projected_oid_index.h"
 
 namespace gs {
 
@@ -110,8 +122,22 @@ struct TypedArray<std::string> {
   arrow::LargeStringArray* array_;
 };
 
+// the edge data that can be materialized along with the neighbors
+template <typename T>
+struct is_inline_edata
+    : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                       !std::is_same<T, bool>::value> {};
+
+template <typename T>
+using inline_edata_t =
+    typename std::conditional<is_inline_edata<T>::value, T,
+                              typename TypedArray<T>::value_type>::type;
+
 /**
- * @brief This is the internal representation of a neighbor vertex
+ * @brief This is the internal representation of a neighbor vertex. The edge
+ * data is read from inline_edata by the position of the neighbor in the list
+ * starting at nbr_base if it is materialized, or from the edge table by the
+ * edge id otherwise.
  *
  * @tparam VID_T VID type
  * @tparam EID_T Edge id type
@@ -124,10 +150,19 @@ class Nbr {
   using nbr_unit_t = vineyard::property_graph_utils::NbrUnit<VID_T, EID_T>;
 
  public:
-  Nbr(const nbr_unit_t* nbr, TypedArray<EDATA_T> edata_array)
-      : nbr_(nbr), edata_array_(edata_array) {}
-
-  Nbr(const Nbr& rhs) : nbr_(rhs.nbr_), edata_array_(rhs.edata_array_) {}
+  Nbr(const nbr_unit_t* nbr, TypedArray<EDATA_T> edata_array,
+      const inline_edata_t<EDATA_T>* inline_edata = NULL,
+      const nbr_unit_t* nbr_base = NULL)
+      : nbr_(nbr),
+        edata_array_(edata_array),
+        inline_edata_(inline_edata),
+        nbr_base_(nbr_base) {}
+
+  Nbr(const Nbr& rhs)
+      : nbr_(rhs.nbr_),
+        edata_array_(rhs.edata_array_),
+        inline_edata_(rhs.inline_edata_),
+        nbr_base_(rhs.nbr_base_) {}
 
   grape::Vertex<vid_t> neighbor() const {
     return grape::Vertex<vid_t>(nbr_->vid);
@@ -140,12 +175,13 @@ class Nbr {
   eid_t edge_id() const { return nbr_->eid; }
 
   typename TypedArray<EDATA_T>::value_type data() const {
+    if (inline_edata_ != NULL) {
+      return inline_edata_[nbr_ - nbr_base_];
+    }
     return edata_array_[nbr_->eid];
   }
 
-  typename TypedArray<EDATA_T>::value_type get_data() const {
-    return edata_array_[nbr_->eid];
-  }
+  typename TypedArray<EDATA_T>::value_type get_data() const { return data(); }
 
   inline const Nbr& operator++() const {
     ++nbr_;
@@ -182,6 +218,8 @@ class Nbr {
  private:
   const mutable nbr_unit_t* nbr_;
   TypedArray<EDATA_T> edata_array_;
+  const inline_edata_t<EDATA_T>* inline_edata_;
+  const nbr_unit_t* nbr_base_;
 };
 
 /**
@@ -266,15 +304,23 @@ class AdjList {
   AdjList() : begin_(NULL), end_(NULL) {}
 
   AdjList(const nbr_unit_t* begin, const nbr_unit_t* end,
-          TypedArray<EDATA_T> edata_array)
-      : begin_(begin), end_(end), edata_array_(edata_array) {}
+          TypedArray<EDATA_T> edata_array,
+          const inline_edata_t<EDATA_T>* inline_edata = NULL,
+          const nbr_unit_t* nbr_base = NULL)
+      : begin_(begin),
+        end_(end),
+        edata_array_(edata_array),
+        inline_edata_(inline_edata),
+        nbr_base_(nbr_base) {}
 
   Nbr<VID_T, EID_T, EDATA_T> begin() const {
-    return Nbr<VID_T, EID_T, EDATA_T>(begin_, edata_array_);
+    return Nbr<VID_T, EID_T, EDATA_T>(begin_, edata_array_, inline_edata_,
+                                      nbr_base_);
   }
 
   Nbr<VID_T, EID_T, EDATA_T> end() const {
-    return Nbr<VID_T, EID_T, EDATA_T>(end_, edata_array_);
+    return Nbr<VID_T, EID_T, EDATA_T>(end_, edata_array_, inline_edata_,
+                                      nbr_base_);
   }
 
   size_t Size() const { return end_ - begin_; }
@@ -287,6 +333,8 @@ class AdjList {
   const nbr_unit_t* begin_;
   const nbr_unit_t* end_;
   TypedArray<EDATA_T> edata_array_;
+  const inline_edata_t<EDATA_T>* inline_edata_;
+  const nbr_unit_t* nbr_base_;
 };
 
 template <typename VID_T, typename EID_T>
@@ -299,7 +347,8 @@ class AdjList<VID_T, EID_T, grape::EmptyType> {
   AdjList() : begin_(NULL), end_(NULL) {}
 
   AdjList(const nbr_unit_t* begin, const nbr_unit_t* end,
-          TypedArray<grape::EmptyType>)
+          TypedArray<grape::EmptyType>, const grape::EmptyType* = NULL,
+          const nbr_unit_t* = NULL)
       : begin_(begin), end_(end) {}
 
   Nbr<VID_T, EID_T, grape::EmptyType> begin() const {
@@ -321,6 +370,25 @@ class AdjList<VID_T, EID_T, grape::EmptyType> {
   const nbr_unit_t* end_;
 };
 
+// the names of the arrays sealed once for a fragment and shared by its
+// projections, see getOrSealOffsets and getOrSealTimeSortedEdges
+inline std::string shared_offsets_name(vineyard::ObjectID frag_id, int v_label,
+                                       int e_label,
+                                       const std::string& direction) {
+  return "__gs_projected_offsets_" + vineyard::ObjectIDToString(frag_id) +
+         "_" + std::to_string(v_label) + "_" + std::to_string(e_label) + "_" +
+         direction;
+}
+
+inline std::string shared_time_sorted_name(vineyard::ObjectID frag_id,
+                                           int v_label, int e_label,
+                                           int time_prop,
+                                           const std::string& direction) {
+  return "__gs_projected_time_sorted_" + vineyard::ObjectIDToString(frag_id) +
+         "_" + std::to_string(v_label) + "_" + std::to_string(e_label) + "_" +
+         std::to_string(time_prop) + "_" + direction;
+}
+
 }  // namespace arrow_projected_fragment_impl
 
 /**
@@ -350,6 +418,7 @@ class ArrowProjectedFragment
       arrow_projected_fragment_impl::AdjList<vid_t, eid_t, EDATA_T>;
   using const_adj_list_t =
       arrow_projected_fragment_impl::AdjList<vid_t, eid_t, EDATA_T>;
+  using compressed_adj_list_t = CompressedAdjList<vid_t>;
   using vertex_map_t = ArrowProjectedVertexMap<internal_oid_t, vid_t>;
   using label_id_t = vineyard::property_graph_types::LABEL_ID_TYPE;
   using prop_id_t = vineyard::property_graph_types::PROP_ID_TYPE;
@@ -377,7 +446,12 @@ class ArrowProjectedFragment
   static std::shared_ptr<ArrowProjectedFragment<oid_t, vid_t, vdata_t, edata_t>>
   Project(std::shared_ptr<vineyard::ArrowFragment<oid_t, vid_t>> fragment,
           const std::string& v_label_str, const std::string& v_prop_str,
-          const std::string& e_label_str, const std::string& e_prop_str) {
+          const std::string& e_label_str, const std::string& e_prop_str,
+          const std::string& vertex_order_str = "none",
+          bool materialize_edge_data = false, bool compress_adjacency = false,
+          const std::string& edge_filter_str = "",
+          bool sort_adjacency = false,
+          const std::string& edge_window_str = "") {
     label_id_t v_label = boost::lexical_cast<label_id_t>(v_label_str);
     label_id_t e_label = boost::lexical_cast<label_id_t>(e_label_str);
     prop_id_t v_prop = boost::lexical_cast<label_id_t>(v_prop_str);
@@ -417,6 +491,80 @@ class ArrowProjectedFragment
       }
     }
 
+    auto vertex_order = ParseVertexOrder(vertex_order_str);
+    if (!vertex_order) {
+      LOG(ERROR) << "Unknown vertex order of projected fragment: "
+                 << vertex_order_str;
+      return nullptr;
+    }
+
+    std::vector<uint8_t> edge_mask;
+    if (!edge_filter_str.empty()) {
+      auto edge_filter = ParseEdgeFilter(edge_filter_str);
+      if (!edge_filter) {
+        LOG(ERROR) << "Invalid edge filter of projected fragment: "
+                   << edge_filter_str;
+        return nullptr;
+      }
+      auto& edge_table = fragment->edge_tables_[e_label];
+      prop_id_t filter_prop = edge_filter.value().prop_id;
+      if (filter_prop < 0 || filter_prop >= edge_table->num_columns()) {
+        LOG(ERROR) << "Edge filter of projected fragment on an unknown "
+                      "property: "
+                   << filter_prop;
+        return nullptr;
+      }
+      if (edge_table->num_rows() != 0) {
+        auto column = edge_table->column(filter_prop)->chunk(0);
+        auto mask = EvaluateEdgeFilter(edge_filter.value(), column);
+        if (!mask) {
+          LOG(ERROR) << "Edge filter of projected fragment on the property "
+                     << filter_prop << " of type "
+                     << column->type()->ToString()
+                     << " is not supported";
+          return nullptr;
+        }
+        edge_mask = std::move(mask.value());
+      }
+    }
+
+    EdgeWindow edge_window;
+    EdgeTimes edge_times;
+    if (!edge_window_str.empty()) {
+      auto parsed = ParseEdgeWindow(edge_window_str);
+      if (!parsed) {
+        LOG(ERROR) << "Invalid edge window of projected fragment: "
+                   << edge_window_str;
+        return nullptr;
+      }
+      edge_window = parsed.value();
+      // the lists of the window are the ranges of the lists sorted by the
+      // times, which are shared by the windows
+      if (!edge_filter_str.empty() || sort_adjacency || compress_adjacency) {
+        LOG(ERROR) << "Edge window of projected fragment is not supported "
+                      "with the edge filter, the sorted or the compressed "
+                      "adjacency lists";
+        return nullptr;
+      }
+      auto& edge_table = fragment->edge_tables_[e_label];
+      if (edge_window.prop_id < 0 ||
+          edge_window.prop_id >= edge_table->num_columns()) {
+        LOG(ERROR) << "Edge window of projected fragment on an unknown "
+                      "property: "
+                   << edge_window.prop_id;
+        return nullptr;
+      }
+      if (edge_table->num_rows() != 0) {
+        auto column = edge_table->column(edge_window.prop_id)->chunk(0);
+        if (!edge_times.Init(column)) {
+          LOG(ERROR) << "Edge window of projected fragment on the property "
+                     << edge_window.prop_id << " of type "
+                     << column->type()->ToString() << " is not supported";
+          return nullptr;
+        }
+      }
+    }
+
     meta.SetTypeName(
         type_name<ArrowProjectedFragment<oid_t, vid_t, vdata_t, edata_t>>());
 
@@ -429,52 +577,81 @@ class ArrowProjectedFragment
     meta.AddMember("arrow_projected_vertex_map", vm->meta());
 
     std::shared_ptr<vineyard::NumericArray<int64_t>> ie_offsets_begin,
-        ie_offsets_end;
-
+        ie_offsets_end, oe_offsets_begin, oe_offsets_end;
     size_t nbytes = 0;
+    // the offsets of the two directions are selected and sealed concurrently
+    std::vector<std::function<void()>> seals;
+    if (fragment->directed()) {
+      seals.emplace_back([&]() {
+        getOrSealOffsets(client, fragment, v_label, e_label, "ie",
+                         ie_offsets_begin, ie_offsets_end);
+      });
+    }
+    seals.emplace_back([&]() {
+      getOrSealOffsets(client, fragment, v_label, e_label, "oe",
+                       oe_offsets_begin, oe_offsets_end);
+    });
+    parallel_invoke(seals);
     if (fragment->directed()) {
-      std::shared_ptr<arrow::Int64Array> ie_offsets_begin_arrow,
-          ie_offsets_end_arrow;
-      selectEdgeByNeighborLabel(fragment, v_label,
-                                fragment->ie_lists_[v_label][e_label],
-                                fragment->ie_offsets_lists_[v_label][e_label],
-                                ie_offsets_begin_arrow, ie_offsets_end_arrow);
-      vineyard::NumericArrayBuilder<int64_t> ie_offsets_begin_builder(
-          client, ie_offsets_begin_arrow);
-      ie_offsets_begin =
-          std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
-              ie_offsets_begin_builder.Seal(client));
-      vineyard::NumericArrayBuilder<int64_t> ie_offsets_end_builder(
-          client, ie_offsets_end_arrow);
-      ie_offsets_end =
-          std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
-              ie_offsets_end_builder.Seal(client));
-
       nbytes += ie_offsets_begin->nbytes();
       nbytes += ie_offsets_end->nbytes();
     }
+    nbytes += oe_offsets_begin->nbytes();
+    nbytes += oe_offsets_end->nbytes();
 
-    std::shared_ptr<vineyard::NumericArray<int64_t>> oe_offsets_begin,
-        oe_offsets_end;
-    {
-      std::shared_ptr<arrow::Int64Array> oe_offsets_begin_arrow,
-          oe_offsets_end_arrow;
-      selectEdgeByNeighborLabel(fragment, v_label,
-                                fragment->oe_lists_[v_label][e_label],
-                                fragment->oe_offsets_lists_[v_label][e_label],
-                                oe_offsets_begin_arrow, oe_offsets_end_arrow);
-      vineyard::NumericArrayBuilder<int64_t> oe_offsets_begin_builder(
-          client, oe_offsets_begin_arrow);
-      oe_offsets_begin =
-          std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
-              oe_offsets_begin_builder.Seal(client));
-      vineyard::NumericArrayBuilder<int64_t> oe_offsets_end_builder(
-          client, oe_offsets_end_arrow);
-      oe_offsets_end =
-          std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
-              oe_offsets_end_builder.Seal(client));
-      nbytes += oe_offsets_begin->nbytes();
-      nbytes += oe_offsets_end->nbytes();
+    std::shared_ptr<arrow::FixedSizeBinaryArray> ie_list, oe_list;
+    if (fragment->directed()) {
+      ie_list = fragment->ie_lists_[v_label][e_label];
+    }
+    oe_list = fragment->oe_lists_[v_label][e_label];
+    if (!edge_filter_str.empty()) {
+      // the edges are kept in new lists with the offsets in them, so the
+      // offsets shared with other projections are left intact
+      meta.AddKeyValue("edge_filter", edge_filter_str);
+      if (fragment->directed()) {
+        auto ie_filtered = filterEdges(client, ie_list, edge_mask,
+                                       ie_offsets_begin, ie_offsets_end);
+        meta.AddMember("ie_filtered", ie_filtered->meta());
+        nbytes += ie_filtered->nbytes();
+        ie_list = ie_filtered->GetArray();
+      }
+      auto oe_filtered = filterEdges(client, oe_list, edge_mask,
+                                     oe_offsets_begin, oe_offsets_end);
+      meta.AddMember("oe_filtered", oe_filtered->meta());
+      nbytes += oe_filtered->nbytes();
+      oe_list = oe_filtered->GetArray();
+    }
+    if (sort_adjacency) {
+      // sorted in new lists as well, for the order of the shared lists
+      if (fragment->directed()) {
+        auto ie_sorted = sortEdges(client, ie_list, ie_offsets_begin,
+                                   ie_offsets_end);
+        meta.AddMember("ie_sorted", ie_sorted->meta());
+        nbytes += ie_sorted->nbytes();
+        ie_list = ie_sorted->GetArray();
+      }
+      auto oe_sorted =
+          sortEdges(client, oe_list, oe_offsets_begin, oe_offsets_end);
+      meta.AddMember("oe_sorted", oe_sorted->meta());
+      nbytes += oe_sorted->nbytes();
+      oe_list = oe_sorted->GetArray();
+    }
+    if (!edge_window_str.empty()) {
+      meta.AddKeyValue("edge_window", edge_window_str);
+      if (fragment->directed()) {
+        auto ie_time_sorted = getOrSealTimeSortedEdges(
+            client, fragment, v_label, e_label, edge_window.prop_id, "ie",
+            ie_list, ie_offsets_begin, ie_offsets_end, edge_times);
+        meta.AddMember("ie_time_sorted", ie_time_sorted->meta());
+        nbytes += ie_time_sorted->nbytes();
+        ie_list = ie_time_sorted->GetArray();
+      }
+      auto oe_time_sorted = getOrSealTimeSortedEdges(
+          client, fragment, v_label, e_label, edge_window.prop_id, "oe",
+          oe_list, oe_offsets_begin, oe_offsets_end, edge_times);
+      meta.AddMember("oe_time_sorted", oe_time_sorted->meta());
+      nbytes += oe_time_sorted->nbytes();
+      oe_list = oe_time_sorted->GetArray();
     }
 
     if (fragment->directed()) {
@@ -484,6 +661,78 @@ class ArrowProjectedFragment
     meta.AddMember("oe_offsets_begin", oe_offsets_begin->meta());
     meta.AddMember("oe_offsets_end", oe_offsets_end->meta());
 
+    if (materialize_edge_data && e_prop != -1 &&
+        fragment->edge_tables_[e_label]->num_rows() != 0) {
+      auto edata_column =
+          fragment->edge_tables_[e_label]->column(e_prop)->chunk(0);
+      auto oe_edata = materializeEdgeData(client, oe_list, edata_column);
+      if (oe_edata == nullptr) {
+        LOG(WARNING) << "The edge data of type "
+                     << vineyard::type_name<edata_t>()
+                     << " is not materialized";
+      } else {
+        meta.AddMember("oe_edata", oe_edata->meta());
+        nbytes += oe_edata->nbytes();
+        if (fragment->directed()) {
+          auto ie_edata = materializeEdgeData(client, ie_list, edata_column);
+          meta.AddMember("ie_edata", ie_edata->meta());
+          nbytes += ie_edata->nbytes();
+        }
+      }
+    }
+
+    if (compress_adjacency && !std::is_same<edata_t, grape::EmptyType>::value) {
+      LOG(WARNING) << "The adjacency lists with the edge data of type "
+                   << vineyard::type_name<edata_t>() << " are not compressed";
+    } else if (compress_adjacency) {
+      auto oe_compressed =
+          compressAdjList(client, oe_list, oe_offsets_begin->GetArray(),
+                          oe_offsets_end->GetArray());
+      meta.AddMember("oe_compressed", oe_compressed.first->meta());
+      meta.AddMember("oe_compressed_offsets", oe_compressed.second->meta());
+      nbytes += oe_compressed.first->nbytes();
+      nbytes += oe_compressed.second->nbytes();
+      if (fragment->directed()) {
+        auto ie_compressed =
+            compressAdjList(client, ie_list, ie_offsets_begin->GetArray(),
+                            ie_offsets_end->GetArray());
+        meta.AddMember("ie_compressed", ie_compressed.first->meta());
+        meta.AddMember("ie_compressed_offsets", ie_compressed.second->meta());
+        nbytes += ie_compressed.first->nbytes();
+        nbytes += ie_compressed.second->nbytes();
+      }
+    }
+
+    meta.AddKeyValue("vertex_order", vertex_order_str);
+    if (vertex_order.value() != VertexOrder::kNone) {
+      std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>> nbr_lists = {
+          oe_list};
+      std::vector<std::shared_ptr<arrow::Int64Array>> begins = {
+          oe_offsets_begin->GetArray()};
+      std::vector<std::shared_ptr<arrow::Int64Array>> ends = {
+          oe_offsets_end->GetArray()};
+      if (fragment->directed()) {
+        nbr_lists.push_back(ie_list);
+        begins.push_back(ie_offsets_begin->GetArray());
+        ends.push_back(ie_offsets_end->GetArray());
+      }
+      auto order = computeInnerVertexOrder(fragment, v_label,
+                                           vertex_order.value(), nbr_lists,
+                                           begins, ends);
+
+      typename vineyard::ConvertToArrowType<vid_t>::BuilderType order_builder;
+      std::shared_ptr<vid_array_t> order_array;
+      CHECK(order_builder.AppendValues(order).ok());
+      CHECK(order_builder.Finish(&order_array).ok());
+      vineyard::NumericArrayBuilder<vid_t> inner_vertex_order_builder(
+          client, order_array);
+      auto inner_vertex_order =
+          std::dynamic_pointer_cast<vineyard::NumericArray<vid_t>>(
+              inner_vertex_order_builder.Seal(client));
+      meta.AddMember("inner_vertex_order", inner_vertex_order->meta());
+      nbytes += inner_vertex_order->nbytes();
+    }
+
     meta.SetNBytes(nbytes);
 
     vineyard::ObjectID id;
@@ -539,6 +788,18 @@ class ArrowProjectedFragment
     ovnum_ = static_cast<vid_t>(outer_vertices_.size());
     tvnum_ = static_cast<vid_t>(vertices_.size());
 
+    inner_vertex_order_.clear();
+    if (meta.HasKey("inner_vertex_order")) {
+      vineyard::NumericArray<vid_t> inner_vertex_order;
+      inner_vertex_order.Construct(meta.GetMemberMeta("inner_vertex_order"));
+      auto order = inner_vertex_order.GetArray();
+      vid_t begin = inner_vertices_.begin().GetValue();
+      inner_vertex_order_.reserve(order->length());
+      for (int64_t i = 0; i < order->length(); ++i) {
+        inner_vertex_order_.emplace_back(begin + order->Value(i));
+      }
+    }
+
     vertex_label_num_ = fragment_->vertex_label_num_;
     edge_label_num_ = fragment_->edge_label_num_;
 
@@ -568,6 +829,48 @@ class ArrowProjectedFragment
       ie_ = fragment_->ie_lists_[vertex_label_][edge_label_];
     }
     oe_ = fragment_->oe_lists_[vertex_label_][edge_label_];
+    if (meta.HasKey("oe_filtered")) {
+      if (directed_) {
+        vineyard::FixedSizeBinaryArray ie_filtered;
+        ie_filtered.Construct(meta.GetMemberMeta("ie_filtered"));
+        ie_ = ie_filtered.GetArray();
+      }
+      vineyard::FixedSizeBinaryArray oe_filtered;
+      oe_filtered.Construct(meta.GetMemberMeta("oe_filtered"));
+      oe_ = oe_filtered.GetArray();
+    }
+    sorted_adjacency_ = meta.HasKey("oe_sorted");
+    if (sorted_adjacency_) {
+      if (directed_) {
+        vineyard::FixedSizeBinaryArray ie_sorted;
+        ie_sorted.Construct(meta.GetMemberMeta("ie_sorted"));
+        ie_ = ie_sorted.GetArray();
+      }
+      vineyard::FixedSizeBinaryArray oe_sorted;
+      oe_sorted.Construct(meta.GetMemberMeta("oe_sorted"));
+      oe_ = oe_sorted.GetArray();
+    }
+    if (meta.HasKey("oe_time_sorted")) {
+      if (directed_) {
+        vineyard::FixedSizeBinaryArray ie_time_sorted;
+        ie_time_sorted.Construct(meta.GetMemberMeta("ie_time_sorted"));
+        ie_ = ie_time_sorted.GetArray();
+      }
+      vineyard::FixedSizeBinaryArray oe_time_sorted;
+      oe_time_sorted.Construct(meta.GetMemberMeta("oe_time_sorted"));
+      oe_ = oe_time_sorted.GetArray();
+    }
+
+    constructInlineEdata(meta);
+    constructCompressedAdjList(meta, "oe_compressed", oe_compressed_,
+                               oe_compressed_offsets_);
+    if (directed_) {
+      constructCompressedAdjList(meta, "ie_compressed", ie_compressed_,
+                                 ie_compressed_offsets_);
+    } else {
+      ie_compressed_ = oe_compressed_;
+      ie_compressed_offsets_ = oe_compressed_offsets_;
+    }
 
     vm_ptr_ = std::make_shared<vertex_map_t>();
     vm_ptr_->Construct(meta.GetMemberMeta("arrow_projected_vertex_map"));
@@ -575,6 +878,7 @@ class ArrowProjectedFragment
     vid_parser_.Init(fnum_, vertex_label_num_);
 
     initPointers();
+    initEdgeWindow(meta);
   }
 
   void PrepareToRunApp(grape::MessageStrategy strategy, bool need_split_edges) {
@@ -589,11 +893,15 @@ class ArrowProjectedFragment
     }
 
     if (need_split_edges) {
+      CHECK(!has_edge_window_) << "The edges in the window are sorted by the "
+                                  "times, and not split by the fragments";
       ie_spliters_ptr_.clear();
       oe_spliters_ptr_.clear();
       if (directed_) {
-        initEdgeSpliters(ie_, ie_offsets_begin_, ie_offsets_end_, ie_spliters_);
-        initEdgeSpliters(oe_, oe_offsets_begin_, oe_offsets_end_, oe_spliters_);
+        initEdgeSpliters(ie_ptr_, ie_offsets_begin_ptr_, ie_offsets_end_ptr_,
+                         ie_spliters_);
+        initEdgeSpliters(oe_ptr_, oe_offsets_begin_ptr_, oe_offsets_end_ptr_,
+                         oe_spliters_);
         for (auto& vec : ie_spliters_) {
           ie_spliters_ptr_.push_back(vec.data());
         }
@@ -601,7 +909,8 @@ class ArrowProjectedFragment
           oe_spliters_ptr_.push_back(vec.data());
         }
       } else {
-        initEdgeSpliters(oe_, oe_offsets_begin_, oe_offsets_end_, oe_spliters_);
+        initEdgeSpliters(oe_ptr_, oe_offsets_begin_ptr_, oe_offsets_end_ptr_,
+                         oe_spliters_);
         for (auto& vec : oe_spliters_) {
           ie_spliters_ptr_.push_back(vec.data());
           oe_spliters_ptr_.push_back(vec.data());
@@ -617,12 +926,134 @@ class ArrowProjectedFragment
 
   inline fid_t fnum() const { return fnum_; }
 
+  inline bool directed() const { return directed_; }
+
   inline vertex_range_t Vertices() const { return vertices_; }
 
   inline vertex_range_t InnerVertices() const { return inner_vertices_; }
 
+  // the inner vertices in the order given at the projection, which is empty
+  // if the vertices are in the order of the lids
+  inline const std::vector<vertex_t>& InnerVertexOrder() const {
+    return inner_vertex_order_;
+  }
+
   inline vertex_range_t OuterVertices() const { return outer_vertices_; }
 
+  /**
+   * @brief Moves the offsets and the lists of the edges, with the inline edge
+   * data if any, to a file mapped from dir, e.g., on the local SSD, for the
+   * fragments exceeding the memory, as the pages of the file are loaded on
+   * demand. The lists are laid out in the order of the inner vertices given
+   * at the projection, e.g., by the degrees, followed by the outer vertices,
+   * so the apps visiting the vertices by ForEachInnerVertex read the file in
+   * sequence, and the lists of no less than a page start at the pages. The
+   * spliters of the edges are built from the mapped lists.
+   */
+  bl::result<void> MapToDisk(const std::string& dir) {
+    using inline_edata_t =
+        arrow_projected_fragment_impl::inline_edata_t<EDATA_T>;
+    if (mapped_file_ != nullptr) {
+      return {};
+    }
+    size_t offset_num = static_cast<size_t>(oe_offsets_begin_->length());
+    std::vector<int64_t> order;
+    order.reserve(offset_num);
+    for (auto v : inner_vertex_order_) {
+      order.push_back(vid_parser_.GetOffset(v.GetValue()));
+    }
+    for (size_t i = order.size(); i < offset_num; ++i) {
+      order.push_back(i);
+    }
+
+    // the positions of the lists are laid out first, to size the file
+    size_t direction_num = directed_ ? 2 : 1;
+    const int64_t* begins[2] = {oe_offsets_begin_ptr_, ie_offsets_begin_ptr_};
+    const int64_t* ends[2] = {oe_offsets_end_ptr_, ie_offsets_end_ptr_};
+    const nbr_unit_t* nbrs[2] = {oe_ptr_, ie_ptr_};
+    const inline_edata_t* edata[2] = {oe_edata_ptr_, ie_edata_ptr_};
+    std::vector<int64_t> new_begins[2];
+    int64_t lengths[2] = {0, 0};
+    size_t offsets_bytes =
+        MappedFile::AlignToPage(offset_num * sizeof(int64_t));
+    size_t bytes = 0;
+    for (size_t d = 0; d < direction_num; ++d) {
+      new_begins[d].resize(offset_num);
+      lengths[d] =
+          layoutAdjLists(begins[d], ends[d], order, new_begins[d].data());
+      bytes += 2 * offsets_bytes;
+      bytes += MappedFile::AlignToPage(lengths[d] * sizeof(nbr_unit_t));
+      if (edata[d] != NULL) {
+        bytes += MappedFile::AlignToPage(lengths[d] * sizeof(inline_edata_t));
+      }
+    }
+    BOOST_LEAF_AUTO(file, MappedFile::Create(dir, bytes));
+
+    int64_t* mapped_begins[2];
+    int64_t* mapped_ends[2];
+    nbr_unit_t* mapped_nbrs[2];
+    inline_edata_t* mapped_edata[2] = {NULL, NULL};
+    char* region = file->data();
+    for (size_t d = 0; d < direction_num; ++d) {
+      mapped_begins[d] = reinterpret_cast<int64_t*>(region);
+      region += offsets_bytes;
+      mapped_ends[d] = reinterpret_cast<int64_t*>(region);
+      region += offsets_bytes;
+      mapped_nbrs[d] = reinterpret_cast<nbr_unit_t*>(region);
+      region += MappedFile::AlignToPage(lengths[d] * sizeof(nbr_unit_t));
+      if (edata[d] != NULL) {
+        mapped_edata[d] = reinterpret_cast<inline_edata_t*>(region);
+        region += MappedFile::AlignToPage(lengths[d] * sizeof(inline_edata_t));
+      }
+      std::copy(new_begins[d].begin(), new_begins[d].end(), mapped_begins[d]);
+      copyAdjLists(begins[d], ends[d], nbrs[d], edata[d], offset_num,
+                   mapped_begins[d], mapped_ends[d], mapped_nbrs[d],
+                   mapped_edata[d]);
+    }
+    BOOST_LEAF_CHECK(file->Seal());
+
+    oe_offsets_begin_ptr_ = mapped_begins[0];
+    oe_offsets_end_ptr_ = mapped_ends[0];
+    oe_ptr_ = mapped_nbrs[0];
+    oe_edata_ptr_ = mapped_edata[0];
+    oe_length_ = lengths[0];
+    if (directed_) {
+      ie_offsets_begin_ptr_ = mapped_begins[1];
+      ie_offsets_end_ptr_ = mapped_ends[1];
+      ie_ptr_ = mapped_nbrs[1];
+      ie_edata_ptr_ = mapped_edata[1];
+    } else {
+      ie_offsets_begin_ptr_ = oe_offsets_begin_ptr_;
+      ie_offsets_end_ptr_ = oe_offsets_end_ptr_;
+      ie_ptr_ = oe_ptr_;
+      ie_edata_ptr_ = oe_edata_ptr_;
+    }
+    // the spliters and the alias tables are of the positions in the lists
+    ie_spliters_.clear();
+    oe_spliters_.clear();
+    ie_spliters_ptr_.clear();
+    oe_spliters_ptr_.clear();
+    oe_alias_prob_.clear();
+    oe_alias_index_.clear();
+    mapped_file_ = file;
+    VLOG(1) << "Mapped " << bytes << " bytes of the adjacency lists to "
+            << dir;
+    return {};
+  }
+
+  inline bool IsMappedToDisk() const { return mapped_file_ != nullptr; }
+
+  /**
+   * @brief Whether the adjacency lists are of the edges in the window of the
+   * times given at the projection only, in the order of the times, as the
+   * ranges of the lists sorted by the times shared by the windows of the
+   * property, so a projection of another window costs the binary searches of
+   * the lists only. The edges are not split by the fragments.
+   */
+  inline bool HasEdgeWindow() const { return has_edge_window_; }
+
+  inline const EdgeWindow& GetEdgeWindow() const { return edge_window_; }
+
   inline vertex_range_t OuterVertices(fid_t fid) const {
     return vertex_range_t(outer_vertex_offsets_[fid],
                           outer_vertex_offsets_[fid + 1]);
@@ -632,14 +1063,12 @@ class ArrowProjectedFragment
     return mirrors_of_frag_[fid];
   }
 
+  /**
+   * @brief Looks up the oid among the inner vertices and then the outer
+   * vertices of the fragment only, see GetInnerVertex and GetOuterVertex.
+   */
   inline bool GetVertex(const oid_t& oid, vertex_t& v) const {
-    vid_t gid;
-    if (vm_ptr_->GetGid(internal_oid_t(oid), gid)) {
-      return (vid_parser_.GetFid(gid) == fid()) ? InnerVertexGid2Vertex(gid, v)
-                                                : OuterVertexGid2Vertex(gid, v);
-    } else {
-      return false;
-    }
+    return GetInnerVertex(oid, v) || GetOuterVertex(oid, v);
   }
 
   inline oid_t GetId(const vertex_t& v) const {
@@ -688,24 +1117,29 @@ class ArrowProjectedFragment
         vid_parser_.GetOffset(v.GetValue()) >= static_cast<int64_t>(ivnum_));
   }
 
+  /**
+   * @brief Looks up the oid in the hash map of the fragment itself, rather
+   * than in the index of the label over all the fragments.
+   */
   inline bool GetInnerVertex(const oid_t& oid, vertex_t& v) const {
     vid_t gid;
-    if (vm_ptr_->GetGid(internal_oid_t(oid), gid)) {
-      if (vid_parser_.GetFid(gid) == fid_) {
-        v.SetValue(vid_parser_.GetLid(gid));
-        return true;
-      }
+    if (vm_ptr_->GetGid(fid_, internal_oid_t(oid), gid)) {
+      v.SetValue(vid_parser_.GetLid(gid));
+      return true;
     }
     return false;
   }
 
+  /**
+   * @brief Looks up the oid in the index of the outer vertices of the
+   * fragment, which is built at the first call, and of the size of the outer
+   * vertices rather than of the label.
+   */
   inline bool GetOuterVertex(const oid_t& oid, vertex_t& v) const {
+    std::call_once(outer_index_flag_, [this]() { buildOuterIndex(); });
     vid_t gid;
-    if (vm_ptr_->GetGid(internal_oid_t(oid), gid)) {
-      return OuterVertexGid2Vertex(gid, v);
-    } else {
-      return false;
-    }
+    return outer_index_.Find(internal_oid_t(oid), gid) &&
+           OuterVertexGid2Vertex(gid, v);
   }
 
   inline oid_t GetInnerVertexId(const vertex_t& v) const {
@@ -730,7 +1164,17 @@ class ArrowProjectedFragment
     return oid_t(internal_oid);
   }
 
+  /**
+   * @brief The gid of the oid, of which only the ones of neither the inner
+   * nor the outer vertices are looked up in the vertex map over all the
+   * fragments.
+   */
   inline bool Oid2Gid(const oid_t& oid, vid_t& gid) const {
+    vertex_t v;
+    if (GetVertex(oid, v)) {
+      gid = Vertex2Gid(v);
+      return true;
+    }
     return vm_ptr_->GetGid(internal_oid_t(oid), gid);
   }
 
@@ -740,6 +1184,16 @@ class ArrowProjectedFragment
   }
 
   inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    if (ovgid_sorted_) {
+      size_t index;
+      if (InterpolationSearch(ovgid_list_ptr_, static_cast<size_t>(ovnum_),
+                              gid, index)) {
+        v.SetValue(outer_vertices_.begin().GetValue() +
+                   static_cast<vid_t>(index));
+        return true;
+      }
+      return false;
+    }
     auto iter = ovg2l_map_->find(gid);
     if (iter != ovg2l_map_->end()) {
       v.SetValue(iter->second);
@@ -762,14 +1216,14 @@ class ArrowProjectedFragment
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return adj_list_t(&ie_ptr_[ie_offsets_begin_ptr_[offset]],
                       &ie_ptr_[ie_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                      edge_data_array_accessor_, ie_edata_ptr_, ie_ptr_);
   }
 
   inline adj_list_t GetOutgoingAdjList(const vertex_t& v) const {
     int64_t offset = vid_parser_.GetOffset(v.GetValue());
     return adj_list_t(&oe_ptr_[oe_offsets_begin_ptr_[offset]],
                       &oe_ptr_[oe_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                      edge_data_array_accessor_, oe_edata_ptr_, oe_ptr_);
   }
 
   inline adj_list_t GetIncomingInnerVertexAdjList(const vertex_t& v) const {
@@ -778,7 +1232,7 @@ class ArrowProjectedFragment
                       &ie_ptr_[offset < static_cast<int64_t>(ivnum_)
                                    ? ie_spliters_ptr_[0][offset]
                                    : ie_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                      edge_data_array_accessor_, ie_edata_ptr_, ie_ptr_);
   }
 
   inline adj_list_t GetOutgoingInnerVertexAdjList(const vertex_t& v) const {
@@ -787,7 +1241,7 @@ class ArrowProjectedFragment
                       &oe_ptr_[offset < static_cast<int64_t>(ivnum_)
                                    ? oe_spliters_ptr_[0][offset]
                                    : oe_offsets_end_ptr_[offset]],
-                      edge_data_array_accessor_);
+                      edge_data_array_accessor_, oe_edata_ptr_, oe_ptr_);
   }
 
   inline adj_list_t GetIncomingOuterVertexAdjList(const vertex_t& v) const {
@@ -795,7 +1249,7 @@ class ArrowProjectedFragment
     return offset < static_cast<int64_t>(ivnum_)
                ? adj_list_t(&ie_ptr_[ie_spliters_ptr_[0][offset]],
                             &ie_ptr_[ie_offsets_end_ptr_[offset]],
-                            edge_data_array_accessor_)
+                            edge_data_array_accessor_, ie_edata_ptr_, ie_ptr_)
                : adj_list_t();
   }
 
@@ -804,7 +1258,7 @@ class ArrowProjectedFragment
     return offset < static_cast<int64_t>(ivnum_)
                ? adj_list_t(&oe_ptr_[oe_spliters_ptr_[0][offset]],
                             &oe_ptr_[oe_offsets_end_ptr_[offset]],
-                            edge_data_array_accessor_)
+                            edge_data_array_accessor_, oe_edata_ptr_, oe_ptr_)
                : adj_list_t();
   }
 
@@ -813,7 +1267,7 @@ class ArrowProjectedFragment
     return offset < static_cast<int64_t>(ivnum_)
                ? adj_list_t(&ie_ptr_[ie_spliters_ptr_[src_fid][offset]],
                             &ie_ptr_[ie_spliters_ptr_[src_fid + 1][offset]],
-                            edge_data_array_accessor_)
+                            edge_data_array_accessor_, ie_edata_ptr_, ie_ptr_)
                : (src_fid == fid_ ? GetIncomingAdjList(v) : adj_list_t());
   }
 
@@ -822,10 +1276,120 @@ class ArrowProjectedFragment
     return offset < static_cast<int64_t>(ivnum_)
                ? adj_list_t(&oe_ptr_[oe_spliters_ptr_[dst_fid][offset]],
                             &oe_ptr_[oe_spliters_ptr_[dst_fid + 1][offset]],
-                            edge_data_array_accessor_)
+                            edge_data_array_accessor_, oe_edata_ptr_, oe_ptr_)
                : (dst_fid == fid_ ? GetOutgoingAdjList(v) : adj_list_t());
   }
 
+  /**
+   * @brief Builds the alias tables of the outgoing edges of the inner
+   * vertices by the edge data as the weights, once, so SampleOutgoingNeighbor
+   * draws a neighbor by the weights in O(1). A table is a probability and an
+   * alias per edge, aligned with the outgoing edges.
+   */
+  void InitOutgoingAliasTables() const {
+    static_assert(std::is_arithmetic<EDATA_T>::value,
+                  "The alias tables are built by the numeric edge data");
+    if (HasOutgoingAliasTables()) {
+      return;
+    }
+    oe_alias_prob_.resize(oe_length_);
+    oe_alias_index_.resize(oe_length_);
+    parallel_for(0, ivnum_, [this](size_t i) {
+      vertex_t v(inner_vertices_.begin().GetValue() + i);
+      std::vector<double> weights;
+      for (auto& e : GetOutgoingAdjList(v)) {
+        weights.push_back(static_cast<double>(e.get_data()));
+      }
+      int64_t begin =
+          oe_offsets_begin_ptr_[vid_parser_.GetOffset(v.GetValue())];
+      BuildAliasTable(weights.data(), weights.size(), &oe_alias_prob_[begin],
+                      &oe_alias_index_[begin]);
+    });
+  }
+
+  inline bool HasOutgoingAliasTables() const {
+    return oe_alias_prob_.size() == static_cast<size_t>(oe_length_);
+  }
+
+  /**
+   * @brief Draws an outgoing neighbor of the inner vertex by the weights,
+   * after InitOutgoingAliasTables, where the vertex has out neighbors.
+   */
+  template <typename RNG_T>
+  inline vertex_t SampleOutgoingNeighbor(const vertex_t& v, RNG_T& rng) const {
+    int64_t offset = vid_parser_.GetOffset(v.GetValue());
+    int64_t begin = oe_offsets_begin_ptr_[offset];
+    size_t i = SampleAlias(&oe_alias_prob_[begin], &oe_alias_index_[begin],
+                           oe_offsets_end_ptr_[offset] - begin, rng);
+    return vertex_t(oe_ptr_[begin + i].vid);
+  }
+
+  /**
+   * @brief Whether the adjacency lists are compressed at the projection, in
+   * which case the unweighted traversals may read the neighbors by
+   * GetOutgoingCompressedAdjList and GetIncomingCompressedAdjList, in the
+   * order of the vids.
+   */
+  inline bool HasCompressedAdjList() const { return oe_compressed_ != nullptr; }
+
+  inline compressed_adj_list_t GetOutgoingCompressedAdjList(
+      const vertex_t& v) const {
+    int64_t offset = vid_parser_.GetOffset(v.GetValue());
+    return compressed_adj_list_t(
+        oe_compressed_->raw_values() + oe_compressed_offsets_->Value(offset),
+        oe_offsets_end_ptr_[offset] - oe_offsets_begin_ptr_[offset]);
+  }
+
+  inline compressed_adj_list_t GetIncomingCompressedAdjList(
+      const vertex_t& v) const {
+    int64_t offset = vid_parser_.GetOffset(v.GetValue());
+    return compressed_adj_list_t(
+        ie_compressed_->raw_values() + ie_compressed_offsets_->Value(offset),
+        ie_offsets_end_ptr_[offset] - ie_offsets_begin_ptr_[offset]);
+  }
+
+  /**
+   * @brief Whether the adjacency lists are sorted by the neighbors at the
+   * projection, in which case HasEdge and the intersections search them
+   * rather than scan or sort them.
+   */
+  inline bool HasSortedAdjList() const { return sorted_adjacency_; }
+
+  /**
+   * @brief Whether there is an edge from u to v, by the outgoing edges of u
+   * if it is an inner vertex, or else the incoming ones of v if it is.
+   */
+  inline bool HasEdge(const vertex_t& u, const vertex_t& v) const {
+    if (IsInnerVertex(u)) {
+      return hasNbr(oe_ptr_, oe_offsets_begin_ptr_, oe_offsets_end_ptr_, u, v);
+    } else if (IsInnerVertex(v)) {
+      return hasNbr(ie_ptr_, ie_offsets_begin_ptr_, ie_offsets_end_ptr_, v, u);
+    }
+    return false;
+  }
+
+  /**
+   * @brief Calls func(w) for each common outgoing neighbor w of the inner
+   * vertices u and v, once even for the parallel edges, and returns the
+   * number of them, e.g., the triangles on the edge (u, v) of undirected
+   * graphs. The lists are copied and sorted without HasSortedAdjList.
+   */
+  template <typename FUNC_T>
+  inline size_t IntersectOutgoingNeighbors(const vertex_t& u,
+                                           const vertex_t& v,
+                                           const FUNC_T& func) const {
+    return intersectNbrs(oe_ptr_, oe_offsets_begin_ptr_, oe_offsets_end_ptr_,
+                         u, v, func);
+  }
+
+  template <typename FUNC_T>
+  inline size_t IntersectIncomingNeighbors(const vertex_t& u,
+                                           const vertex_t& v,
+                                           const FUNC_T& func) const {
+    return intersectNbrs(ie_ptr_, ie_offsets_begin_ptr_, ie_offsets_end_ptr_,
+                         u, v, func);
+  }
+
   inline int GetLocalOutDegree(const vertex_t& v) const {
     return GetOutgoingAdjList(v).Size();
   }
@@ -853,6 +1417,56 @@ class ArrowProjectedFragment
   }
 
  private:
+  void buildOuterIndex() const {
+    std::vector<std::pair<internal_oid_t, vid_t>> entries;
+    entries.reserve(ovnum_);
+    internal_oid_t internal_oid;
+    for (vid_t i = 0; i < ovnum_; ++i) {
+      vid_t gid = ovgid_list_ptr_[i];
+      CHECK(vm_ptr_->GetOid(gid, internal_oid));
+      entries.emplace_back(internal_oid, gid);
+    }
+    outer_index_.Init(std::move(entries));
+  }
+
+  inline bool hasNbr(const nbr_unit_t* nbrs, const int64_t* begins,
+                     const int64_t* ends, const vertex_t& u,
+                     const vertex_t& v) const {
+    int64_t offset = vid_parser_.GetOffset(u.GetValue());
+    const nbr_unit_t* begin = nbrs + begins[offset];
+    const nbr_unit_t* end = nbrs + ends[offset];
+    if (sorted_adjacency_) {
+      return SortedNbrUnitsContain(begin, end, v.GetValue());
+    }
+    return std::any_of(begin, end, [&v](const nbr_unit_t& nbr) {
+      return nbr.vid == v.GetValue();
+    });
+  }
+
+  template <typename FUNC_T>
+  inline size_t intersectNbrs(const nbr_unit_t* nbrs, const int64_t* begins,
+                              const int64_t* ends, const vertex_t& u,
+                              const vertex_t& v, const FUNC_T& func) const {
+    int64_t u_offset = vid_parser_.GetOffset(u.GetValue());
+    int64_t v_offset = vid_parser_.GetOffset(v.GetValue());
+    const nbr_unit_t* u_begin = nbrs + begins[u_offset];
+    const nbr_unit_t* u_end = nbrs + ends[u_offset];
+    const nbr_unit_t* v_begin = nbrs + begins[v_offset];
+    const nbr_unit_t* v_end = nbrs + ends[v_offset];
+    auto visit = [&func](const nbr_unit_t& a, const nbr_unit_t&) {
+      func(vertex_t(a.vid));
+    };
+    if (sorted_adjacency_) {
+      return IntersectSortedNbrUnits(u_begin, u_end, v_begin, v_end, visit);
+    }
+    std::vector<nbr_unit_t> u_nbrs(u_begin, u_end), v_nbrs(v_begin, v_end);
+    SortNbrUnits(u_nbrs.data(), u_nbrs.data() + u_nbrs.size());
+    SortNbrUnits(v_nbrs.data(), v_nbrs.data() + v_nbrs.size());
+    return IntersectSortedNbrUnits(u_nbrs.data(), u_nbrs.data() + u_nbrs.size(),
+                                   v_nbrs.data(), v_nbrs.data() + v_nbrs.size(),
+                                   visit);
+  }
+
   inline static std::pair<int64_t, int64_t> getRangeOfLabel(
       std::shared_ptr<property_graph_t> fragment, label_id_t v_label,
       std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list, int64_t begin,
@@ -895,6 +1509,412 @@ class ArrowProjectedFragment
     return {};
   }
 
+  /**
+   * @brief The begin and end offsets of the edges to the neighbors of v_label
+   * in the adjacency lists of the direction, "ie" or "oe", which only depend
+   * on the labels, so they are sealed once and shared by the projections of
+   * the fragment with other properties, via the names in vineyard, which are
+   * dropped with the fragment, see DeleteSharedProjectionArrays.
+   */
+  static void getOrSealOffsets(
+      vineyard::Client& client, std::shared_ptr<property_graph_t> fragment,
+      label_id_t v_label, label_id_t e_label, const std::string& direction,
+      std::shared_ptr<vineyard::NumericArray<int64_t>>& begins,
+      std::shared_ptr<vineyard::NumericArray<int64_t>>& ends) {
+    std::string name = arrow_projected_fragment_impl::shared_offsets_name(
+        fragment->id(), v_label, e_label, direction);
+    vineyard::ObjectID begins_id, ends_id;
+    if (client.GetName(name + "_begin", begins_id, false).ok() &&
+        client.GetName(name + "_end", ends_id, false).ok()) {
+      std::shared_ptr<vineyard::Object> begins_object, ends_object;
+      if (client.GetObject(begins_id, begins_object).ok() &&
+          client.GetObject(ends_id, ends_object).ok()) {
+        begins = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+            begins_object);
+        ends = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+            ends_object);
+        if (begins != nullptr && ends != nullptr) {
+          VLOG(1) << "Reusing the offsets " << name;
+          return;
+        }
+      }
+    }
+
+    bool is_ie = direction == "ie";
+    std::shared_ptr<arrow::Int64Array> begins_arrow, ends_arrow;
+    selectEdgeByNeighborLabel(
+        fragment, v_label,
+        is_ie ? fragment->ie_lists_[v_label][e_label]
+              : fragment->oe_lists_[v_label][e_label],
+        is_ie ? fragment->ie_offsets_lists_[v_label][e_label]
+              : fragment->oe_offsets_lists_[v_label][e_label],
+        begins_arrow, ends_arrow);
+    std::vector<std::function<void()>> seals;
+    seals.emplace_back([&]() {
+      vineyard::NumericArrayBuilder<int64_t> begins_builder(client,
+                                                            begins_arrow);
+      begins = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+          begins_builder.Seal(client));
+    });
+    seals.emplace_back([&]() {
+      vineyard::NumericArrayBuilder<int64_t> ends_builder(client, ends_arrow);
+      ends = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+          ends_builder.Seal(client));
+    });
+    parallel_invoke(seals);
+
+    // only the persistent objects can be named
+    if (client.Persist(begins->id()).ok() && client.Persist(ends->id()).ok()) {
+      VINEYARD_SUPPRESS(client.PutName(begins->id(), name + "_begin"));
+      VINEYARD_SUPPRESS(client.PutName(ends->id(), name + "_end"));
+    }
+  }
+
+  /**
+   * @brief Copies the edges of nbr_list in [begins[i], ends[i]) passing the
+   * filter, i.e., the mask by the edge ids, to a new list, and replaces the
+   * offsets with the ones in the new list. The edge ids are kept, so the
+   * edge data are still read from the property tables.
+   */
+  static std::shared_ptr<vineyard::FixedSizeBinaryArray> filterEdges(
+      vineyard::Client& client,
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      const std::vector<uint8_t>& mask,
+      std::shared_ptr<vineyard::NumericArray<int64_t>>& begins,
+      std::shared_ptr<vineyard::NumericArray<int64_t>>& ends) {
+    auto begins_array = begins->GetArray();
+    auto ends_array = ends->GetArray();
+    size_t vnum = static_cast<size_t>(begins_array->length());
+    const nbr_unit_t* nbrs =
+        reinterpret_cast<const nbr_unit_t*>(nbr_list->GetValue(0));
+
+    std::vector<int64_t> offsets(vnum + 1, 0);
+    parallel_for(0, vnum, [&](size_t i) {
+      int64_t count = 0;
+      for (int64_t j = begins_array->Value(i); j < ends_array->Value(i); ++j) {
+        count += mask[nbrs[j].eid];
+      }
+      offsets[i + 1] = count;
+    });
+    for (size_t i = 0; i < vnum; ++i) {
+      offsets[i + 1] += offsets[i];
+    }
+    std::vector<nbr_unit_t> filtered(offsets[vnum]);
+    parallel_for(0, vnum, [&](size_t i) {
+      int64_t k = offsets[i];
+      for (int64_t j = begins_array->Value(i); j < ends_array->Value(i); ++j) {
+        if (mask[nbrs[j].eid]) {
+          filtered[k++] = nbrs[j];
+        }
+      }
+    });
+    VLOG(1) << "Filtered " << offsets[vnum] << " edges out of "
+            << nbr_list->length();
+
+    arrow::FixedSizeBinaryBuilder list_builder(
+        arrow::fixed_size_binary(sizeof(nbr_unit_t)));
+    std::shared_ptr<arrow::FixedSizeBinaryArray> list_array;
+    CHECK(list_builder
+              .AppendValues(reinterpret_cast<const uint8_t*>(filtered.data()),
+                            static_cast<int64_t>(filtered.size()))
+              .ok());
+    CHECK(list_builder.Finish(&list_array).ok());
+    arrow::Int64Builder begins_builder, ends_builder;
+    std::shared_ptr<arrow::Int64Array> filtered_begins, filtered_ends;
+    CHECK(begins_builder.AppendValues(offsets.data(), vnum).ok());
+    CHECK(begins_builder.Finish(&filtered_begins).ok());
+    CHECK(ends_builder.AppendValues(offsets.data() + 1, vnum).ok());
+    CHECK(ends_builder.Finish(&filtered_ends).ok());
+
+    vineyard::NumericArrayBuilder<int64_t> sealed_begins(client,
+                                                         filtered_begins);
+    begins = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+        sealed_begins.Seal(client));
+    vineyard::NumericArrayBuilder<int64_t> sealed_ends(client, filtered_ends);
+    ends = std::dynamic_pointer_cast<vineyard::NumericArray<int64_t>>(
+        sealed_ends.Seal(client));
+    vineyard::FixedSizeBinaryArrayBuilder sealed_list(client, list_array);
+    return std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+        sealed_list.Seal(client));
+  }
+
+  /**
+   * @brief Copies nbr_list to a new list in which the edges in [begins[i],
+   * ends[i]) are sorted by SortNbrUnits, in parallel by the vertices. The
+   * offsets are unchanged.
+   */
+  static std::shared_ptr<vineyard::FixedSizeBinaryArray> sortEdges(
+      vineyard::Client& client,
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> begins,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> ends) {
+    auto begins_array = begins->GetArray();
+    auto ends_array = ends->GetArray();
+    size_t vnum = static_cast<size_t>(begins_array->length());
+    std::vector<nbr_unit_t> sorted(nbr_list->length());
+    if (!sorted.empty()) {
+      std::copy_n(reinterpret_cast<const nbr_unit_t*>(nbr_list->GetValue(0)),
+                  sorted.size(), sorted.data());
+    }
+    parallel_for(
+        0, vnum,
+        [&](size_t i) {
+          SortNbrUnits(sorted.data() + begins_array->Value(i),
+                       sorted.data() + ends_array->Value(i));
+        },
+        kParallelGrainSize / 16);
+
+    arrow::FixedSizeBinaryBuilder list_builder(
+        arrow::fixed_size_binary(sizeof(nbr_unit_t)));
+    std::shared_ptr<arrow::FixedSizeBinaryArray> list_array;
+    CHECK(list_builder
+              .AppendValues(reinterpret_cast<const uint8_t*>(sorted.data()),
+                            static_cast<int64_t>(sorted.size()))
+              .ok());
+    CHECK(list_builder.Finish(&list_array).ok());
+    vineyard::FixedSizeBinaryArrayBuilder sealed_list(client, list_array);
+    return std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+        sealed_list.Seal(client));
+  }
+
+  /**
+   * @brief A copy of nbr_list in which the edges in [begins[i], ends[i]) are
+   * sorted by the times, the ties by the neighbors, which only depends on the
+   * labels and the property, so it is sealed once and shared by the
+   * projections of the windows of the property, via the name in vineyard,
+   * which is dropped with the fragment, see DeleteSharedProjectionArrays.
+   */
+  static std::shared_ptr<vineyard::FixedSizeBinaryArray>
+  getOrSealTimeSortedEdges(
+      vineyard::Client& client, std::shared_ptr<property_graph_t> fragment,
+      label_id_t v_label, label_id_t e_label, prop_id_t time_prop,
+      const std::string& direction,
+      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> begins,
+      std::shared_ptr<vineyard::NumericArray<int64_t>> ends,
+      const EdgeTimes& times) {
+    std::string name = arrow_projected_fragment_impl::shared_time_sorted_name(
+        fragment->id(), v_label, e_label, time_prop, direction);
+    vineyard::ObjectID sorted_id;
+    if (client.GetName(name, sorted_id, false).ok()) {
+      std::shared_ptr<vineyard::Object> sorted_object;
+      if (client.GetObject(sorted_id, sorted_object).ok()) {
+        auto sorted =
+            std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+                sorted_object);
+        if (sorted != nullptr) {
+          VLOG(1) << "Reusing the edges sorted by the times " << name;
+          return sorted;
+        }
+      }
+    }
+
+    auto begins_array = begins->GetArray();
+    auto ends_array = ends->GetArray();
+    size_t vnum = static_cast<size_t>(begins_array->length());
+    std::vector<nbr_unit_t> sorted(nbr_list->length());
+    if (!sorted.empty()) {
+      std::copy_n(reinterpret_cast<const nbr_unit_t*>(nbr_list->GetValue(0)),
+                  sorted.size(), sorted.data());
+    }
+    parallel_for(
+        0, vnum,
+        [&](size_t i) {
+          std::sort(sorted.data() + begins_array->Value(i),
+                    sorted.data() + ends_array->Value(i),
+                    [&times](const nbr_unit_t& lhs, const nbr_unit_t& rhs) {
+                      int64_t lhs_time = times[lhs.eid];
+                      int64_t rhs_time = times[rhs.eid];
+                      return lhs_time < rhs_time ||
+                             (lhs_time == rhs_time && lhs.vid < rhs.vid);
+                    });
+        },
+        kParallelGrainSize / 16);
+
+    arrow::FixedSizeBinaryBuilder list_builder(
+        arrow::fixed_size_binary(sizeof(nbr_unit_t)));
+    std::shared_ptr<arrow::FixedSizeBinaryArray> list_array;
+    CHECK(list_builder
+              .AppendValues(reinterpret_cast<const uint8_t*>(sorted.data()),
+                            static_cast<int64_t>(sorted.size()))
+              .ok());
+    CHECK(list_builder.Finish(&list_array).ok());
+    vineyard::FixedSizeBinaryArrayBuilder sealed_list(client, list_array);
+    auto sealed = std::dynamic_pointer_cast<vineyard::FixedSizeBinaryArray>(
+        sealed_list.Seal(client));
+
+    // only the persistent objects can be named
+    if (client.Persist(sealed->id()).ok()) {
+      VINEYARD_SUPPRESS(client.PutName(sealed->id(), name));
+    }
+    return sealed;
+  }
+
+  /**
+   * @brief Copies the edge data of the edges of nbr_list in the order of the
+   * list, so the weighted traversals read the data along with the neighbors,
+   * rather than from the edge table by the edge ids. Returns nullptr if the
+   * type of the edge data is not numeric.
+   */
+  template <typename T = edata_t>
+  static typename std::enable_if<
+      arrow_projected_fragment_impl::is_inline_edata<T>::value,
+      std::shared_ptr<vineyard::Object>>::type
+  materializeEdgeData(vineyard::Client& client,
+                      std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+                      std::shared_ptr<arrow::Array> edata_column) {
+    using array_t = typename vineyard::ConvertToArrowType<T>::ArrayType;
+    const T* values =
+        std::dynamic_pointer_cast<array_t>(edata_column)->raw_values();
+    typename vineyard::ConvertToArrowType<T>::BuilderType builder;
+    CHECK(builder.Resize(nbr_list->length()).ok());
+    for (int64_t i = 0; i < nbr_list->length(); ++i) {
+      const nbr_unit_t* ptr =
+          reinterpret_cast<const nbr_unit_t*>(nbr_list->GetValue(i));
+      builder.UnsafeAppend(values[ptr->eid]);
+    }
+    std::shared_ptr<array_t> array;
+    CHECK(builder.Finish(&array).ok());
+    vineyard::NumericArrayBuilder<T> edata_builder(client, array);
+    return edata_builder.Seal(client);
+  }
+
+  template <typename T = edata_t>
+  static typename std::enable_if<
+      !arrow_projected_fragment_impl::is_inline_edata<T>::value,
+      std::shared_ptr<vineyard::Object>>::type
+  materializeEdgeData(vineyard::Client&,
+                      std::shared_ptr<arrow::FixedSizeBinaryArray>,
+                      std::shared_ptr<arrow::Array>) {
+    return nullptr;
+  }
+
+  /**
+   * @brief Encodes the neighbors of each vertex in [begins[i], ends[i]) of
+   * nbr_list by EncodeCompressedNeighbors, without the edge ids. Returns the
+   * bytes and the offsets of the vertices in the bytes.
+   */
+  static std::pair<std::shared_ptr<vineyard::Object>,
+                   std::shared_ptr<vineyard::Object>>
+  compressAdjList(vineyard::Client& client,
+                  std::shared_ptr<arrow::FixedSizeBinaryArray> nbr_list,
+                  std::shared_ptr<arrow::Int64Array> begins,
+                  std::shared_ptr<arrow::Int64Array> ends) {
+    std::vector<uint8_t> bytes;
+    std::vector<int64_t> offsets;
+    std::vector<vid_t> nbrs;
+    offsets.reserve(begins->length() + 1);
+    for (int64_t i = 0; i < begins->length(); ++i) {
+      offsets.push_back(static_cast<int64_t>(bytes.size()));
+      nbrs.clear();
+      for (int64_t j = begins->Value(i); j < ends->Value(i); ++j) {
+        nbrs.push_back(
+            reinterpret_cast<const nbr_unit_t*>(nbr_list->GetValue(j))->vid);
+      }
+      EncodeCompressedNeighbors(nbrs, bytes);
+    }
+    offsets.push_back(static_cast<int64_t>(bytes.size()));
+    VLOG(1) << "Compressed " << nbr_list->length() * sizeof(nbr_unit_t)
+            << " bytes of the adjacency lists to " << bytes.size();
+
+    arrow::UInt8Builder bytes_builder;
+    std::shared_ptr<arrow::UInt8Array> bytes_array;
+    CHECK(bytes_builder.AppendValues(bytes).ok());
+    CHECK(bytes_builder.Finish(&bytes_array).ok());
+    arrow::Int64Builder offsets_builder;
+    std::shared_ptr<arrow::Int64Array> offsets_array;
+    CHECK(offsets_builder.AppendValues(offsets).ok());
+    CHECK(offsets_builder.Finish(&offsets_array).ok());
+
+    vineyard::NumericArrayBuilder<uint8_t> compressed_builder(client,
+                                                              bytes_array);
+    vineyard::NumericArrayBuilder<int64_t> compressed_offsets_builder(
+        client, offsets_array);
+    return std::make_pair(compressed_builder.Seal(client),
+                          compressed_offsets_builder.Seal(client));
+  }
+
+  static void constructCompressedAdjList(
+      const vineyard::ObjectMeta& meta, const std::string& name,
+      std::shared_ptr<arrow::UInt8Array>& compressed,
+      std::shared_ptr<arrow::Int64Array>& compressed_offsets) {
+    compressed = nullptr;
+    compressed_offsets = nullptr;
+    if (meta.HasKey(name)) {
+      vineyard::NumericArray<uint8_t> bytes;
+      bytes.Construct(meta.GetMemberMeta(name));
+      compressed = bytes.GetArray();
+      vineyard::NumericArray<int64_t> offsets;
+      offsets.Construct(meta.GetMemberMeta(name + "_offsets"));
+      compressed_offsets = offsets.GetArray();
+    }
+  }
+
+  template <typename T = edata_t>
+  typename std::enable_if<
+      arrow_projected_fragment_impl::is_inline_edata<T>::value>::type
+  constructInlineEdata(const vineyard::ObjectMeta& meta) {
+    ie_edata_ptr_ = oe_edata_ptr_ = NULL;
+    if (meta.HasKey("oe_edata")) {
+      vineyard::NumericArray<T> oe_edata;
+      oe_edata.Construct(meta.GetMemberMeta("oe_edata"));
+      auto array = oe_edata.GetArray();
+      oe_edata_ptr_ = array->raw_values();
+      oe_edata_ = array;
+    }
+    if (directed_ && meta.HasKey("ie_edata")) {
+      vineyard::NumericArray<T> ie_edata;
+      ie_edata.Construct(meta.GetMemberMeta("ie_edata"));
+      auto array = ie_edata.GetArray();
+      ie_edata_ptr_ = array->raw_values();
+      ie_edata_ = array;
+    }
+  }
+
+  template <typename T = edata_t>
+  typename std::enable_if<
+      !arrow_projected_fragment_impl::is_inline_edata<T>::value>::type
+  constructInlineEdata(const vineyard::ObjectMeta&) {
+    ie_edata_ptr_ = oe_edata_ptr_ = NULL;
+  }
+
+  // orders the inner vertices by their inner neighbors along the edges of
+  // nbr_lists, returns the offsets of the vertices in the order
+  static std::vector<vid_t> computeInnerVertexOrder(
+      std::shared_ptr<property_graph_t> fragment, label_id_t v_label,
+      VertexOrder order,
+      const std::vector<std::shared_ptr<arrow::FixedSizeBinaryArray>>&
+          nbr_lists,
+      const std::vector<std::shared_ptr<arrow::Int64Array>>& begins,
+      const std::vector<std::shared_ptr<arrow::Int64Array>>& ends) {
+    vid_t ivnum = fragment->ivnums_[v_label];
+    std::vector<size_t> offsets;
+    std::vector<vid_t> nbrs;
+    offsets.reserve(ivnum + 1);
+    for (vid_t i = 0; i != ivnum; ++i) {
+      offsets.push_back(nbrs.size());
+      for (size_t j = 0; j < nbr_lists.size(); ++j) {
+        for (int64_t k = begins[j]->Value(i); k != ends[j]->Value(i); ++k) {
+          const nbr_unit_t* ptr =
+              reinterpret_cast<const nbr_unit_t*>(nbr_lists[j]->GetValue(k));
+          vid_t offset = fragment->vid_parser_.GetOffset(ptr->vid);
+          if (offset < ivnum) {
+            nbrs.push_back(offset);
+          }
+        }
+      }
+    }
+    offsets.push_back(nbrs.size());
+    return ComputeVertexOrder(order, offsets, nbrs);
+  }
+
+  // the inner vertices are handled by the chunks in parallel, whose results
+  // are merged in the order of the chunks
+  size_t innerVertexChunkNum() const {
+    return (static_cast<size_t>(ivnum_) + kParallelGrainSize - 1) /
+           kParallelGrainSize;
+  }
+
   void initDestFidList(bool in_edge, bool out_edge,
                        std::vector<fid_t>& fid_list,
                        std::vector<fid_t*>& fid_list_offset) {
@@ -904,47 +1924,62 @@ class ArrowProjectedFragment
 
     fid_list_offset.resize(ivnum_ + 1, NULL);
 
-    std::set<fid_t> dstset;
     std::vector<int> id_num(ivnum_, 0);
-
-    vertex_t v = inner_vertices_.begin();
-    for (vid_t i = 0; i < ivnum_; ++i) {
-      dstset.clear();
-      if (in_edge) {
-        auto es = GetIncomingAdjList(v);
-        for (auto& e : es) {
-          fid_t f = GetFragId(e.neighbor());
-          if (f != fid_) {
-            dstset.insert(f);
-          }
-        }
-      }
-      if (out_edge) {
-        auto es = GetOutgoingAdjList(v);
-        for (auto& e : es) {
-          fid_t f = GetFragId(e.neighbor());
-          if (f != fid_) {
-            dstset.insert(f);
+    size_t chunk_num = innerVertexChunkNum();
+    std::vector<std::vector<fid_t>> chunk_fid_lists(chunk_num);
+    parallel_for(
+        0, chunk_num,
+        [&](size_t chunk) {
+          std::vector<bool> dstset(fnum_, false);
+          auto& chunk_fid_list = chunk_fid_lists[chunk];
+          vid_t begin = static_cast<vid_t>(chunk * kParallelGrainSize);
+          vid_t end = std::min(ivnum_, static_cast<vid_t>(
+                                           begin + kParallelGrainSize));
+          vertex_t v(inner_vertices_.begin().GetValue() + begin);
+          for (vid_t i = begin; i < end; ++i, ++v) {
+            if (in_edge) {
+              auto es = GetIncomingAdjList(v);
+              for (auto& e : es) {
+                dstset[GetFragId(e.neighbor())] = true;
+              }
+            }
+            if (out_edge) {
+              auto es = GetOutgoingAdjList(v);
+              for (auto& e : es) {
+                dstset[GetFragId(e.neighbor())] = true;
+              }
+            }
+            dstset[fid_] = false;
+            for (fid_t fid = 0; fid < fnum_; ++fid) {
+              if (dstset[fid]) {
+                chunk_fid_list.push_back(fid);
+                ++id_num[i];
+                dstset[fid] = false;
+              }
+            }
           }
-        }
-      }
-      id_num[i] = dstset.size();
-      for (auto fid : dstset) {
-        fid_list.push_back(fid);
-      }
-      ++v;
-    }
+        },
+        1);
 
-    fid_list.shrink_to_fit();
+    size_t total = 0;
+    for (auto& chunk_fid_list : chunk_fid_lists) {
+      total += chunk_fid_list.size();
+    }
+    fid_list.clear();
+    fid_list.reserve(total);
+    for (auto& chunk_fid_list : chunk_fid_lists) {
+      fid_list.insert(fid_list.end(), chunk_fid_list.begin(),
+                      chunk_fid_list.end());
+    }
     fid_list_offset[0] = fid_list.data();
     for (vid_t i = 0; i < ivnum_; ++i) {
       fid_list_offset[i + 1] = fid_list_offset[i] + id_num[i];
     }
   }
 
-  void initEdgeSpliters(std::shared_ptr<arrow::FixedSizeBinaryArray> edge_list,
-                        std::shared_ptr<arrow::Int64Array> offsets_begin,
-                        std::shared_ptr<arrow::Int64Array> offsets_end,
+  void initEdgeSpliters(const nbr_unit_t* edge_list,
+                        const int64_t* offsets_begin,
+                        const int64_t* offsets_end,
                         std::vector<std::vector<int64_t>>& spliters) {
     if (!spliters.empty()) {
       return;
@@ -953,28 +1988,33 @@ class ArrowProjectedFragment
     for (auto& vec : spliters) {
       vec.resize(ivnum_);
     }
-    std::vector<int> frag_count;
-    for (vid_t i = 0; i < ivnum_; ++i) {
-      frag_count.clear();
-      frag_count.resize(fnum_, 0);
-      int64_t begin = offsets_begin->Value(i);
-      int64_t end = offsets_end->Value(i);
-      for (int64_t j = begin; j != end; ++j) {
-        const nbr_unit_t* nbr_ptr =
-            reinterpret_cast<const nbr_unit_t*>(edge_list->GetValue(j));
-        vertex_t u(nbr_ptr->vid);
-        fid_t u_fid = GetFragId(u);
-        ++frag_count[u_fid];
-      }
-      begin += frag_count[fid_];
-      frag_count[fid_] = 0;
-      spliters[0][i] = begin;
-      for (fid_t j = 0; j < fnum_; ++j) {
-        begin += frag_count[j];
-        spliters[j + 1][i] = begin;
-      }
-      CHECK_EQ(begin, end);
-    }
+    parallel_for(
+        0, innerVertexChunkNum(),
+        [&](size_t chunk) {
+          std::vector<int> frag_count(fnum_, 0);
+          vid_t chunk_begin = static_cast<vid_t>(chunk * kParallelGrainSize);
+          vid_t chunk_end = std::min(
+              ivnum_, static_cast<vid_t>(chunk_begin + kParallelGrainSize));
+          for (vid_t i = chunk_begin; i < chunk_end; ++i) {
+            std::fill(frag_count.begin(), frag_count.end(), 0);
+            int64_t begin = offsets_begin[i];
+            int64_t end = offsets_end[i];
+            for (int64_t j = begin; j != end; ++j) {
+              vertex_t u(edge_list[j].vid);
+              fid_t u_fid = GetFragId(u);
+              ++frag_count[u_fid];
+            }
+            begin += frag_count[fid_];
+            frag_count[fid_] = 0;
+            spliters[0][i] = begin;
+            for (fid_t j = 0; j < fnum_; ++j) {
+              begin += frag_count[j];
+              spliters[j + 1][i] = begin;
+            }
+            CHECK_EQ(begin, end);
+          }
+        },
+        1);
   }
 
   void initOuterVertexRanges() {
@@ -1001,24 +2041,44 @@ class ArrowProjectedFragment
 
     mirrors_of_frag_.resize(fnum_);
 
-    std::vector<bool> bm(fnum_, false);
-    for (auto v : inner_vertices_) {
-      auto es = GetOutgoingAdjList(v);
-      for (auto& e : es) {
-        fid_t fid = GetFragId(e.get_neighbor());
-        bm[fid] = true;
-      }
-      es = GetIncomingAdjList(v);
-      for (auto& e : es) {
-        fid_t fid = GetFragId(e.get_neighbor());
-        bm[fid] = true;
-      }
+    size_t chunk_num = innerVertexChunkNum();
+    std::vector<std::vector<std::vector<vertex_t>>> chunk_mirrors(chunk_num);
+    parallel_for(
+        0, chunk_num,
+        [&](size_t chunk) {
+          std::vector<bool> bm(fnum_, false);
+          auto& mirrors = chunk_mirrors[chunk];
+          mirrors.resize(fnum_);
+          vid_t begin = static_cast<vid_t>(chunk * kParallelGrainSize);
+          vid_t end = std::min(ivnum_, static_cast<vid_t>(
+                                           begin + kParallelGrainSize));
+          vertex_t v(inner_vertices_.begin().GetValue() + begin);
+          for (vid_t i = begin; i < end; ++i, ++v) {
+            auto es = GetOutgoingAdjList(v);
+            for (auto& e : es) {
+              fid_t fid = GetFragId(e.get_neighbor());
+              bm[fid] = true;
+            }
+            es = GetIncomingAdjList(v);
+            for (auto& e : es) {
+              fid_t fid = GetFragId(e.get_neighbor());
+              bm[fid] = true;
+            }
+
+            for (fid_t j = 0; j != fnum_; ++j) {
+              if ((j != fid_) && bm[j]) {
+                mirrors[j].push_back(v);
+                bm[j] = false;
+              }
+            }
+          }
+        },
+        1);
 
-      for (fid_t i = 0; i != fnum_; ++i) {
-        if ((i != fid_) && bm[i]) {
-          mirrors_of_frag_[i].push_back(v);
-          bm[i] = false;
-        }
+    for (fid_t i = 0; i != fnum_; ++i) {
+      for (auto& mirrors : chunk_mirrors) {
+        mirrors_of_frag_[i].insert(mirrors_of_frag_[i].end(),
+                                   mirrors[i].begin(), mirrors[i].end());
       }
     }
   }
@@ -1036,17 +2096,118 @@ class ArrowProjectedFragment
 
     vertex_data_array_accessor_.Init(vertex_data_array_);
     ovgid_list_ptr_ = ovgid_list_->raw_values();
+    ovgid_sorted_ = std::is_sorted(ovgid_list_ptr_, ovgid_list_ptr_ + ovnum_);
     edge_data_array_accessor_.Init(edge_data_array_);
 
     if (directed_) {
       ie_ptr_ = reinterpret_cast<const nbr_unit_t*>(ie_->GetValue(0));
     } else {
       ie_ptr_ = reinterpret_cast<const nbr_unit_t*>(oe_->GetValue(0));
+      ie_edata_ptr_ = oe_edata_ptr_;
     }
     oe_ptr_ = reinterpret_cast<const nbr_unit_t*>(oe_->GetValue(0));
+    oe_length_ = oe_->length();
+  }
+
+  // restricts the offsets of the lists, sorted by the times, to the edges in
+  // the window, by the binary searches in the lists of the vertices
+  void initEdgeWindow(const vineyard::ObjectMeta& meta) {
+    has_edge_window_ = meta.HasKey("edge_window");
+    ie_window_begins_.clear();
+    ie_window_ends_.clear();
+    oe_window_begins_.clear();
+    oe_window_ends_.clear();
+    if (!has_edge_window_) {
+      return;
+    }
+    auto window = ParseEdgeWindow(meta.GetKeyValue("edge_window"));
+    CHECK(window) << "Invalid edge window: "
+                  << meta.GetKeyValue("edge_window");
+    edge_window_ = window.value();
+    auto& edge_table = fragment_->edge_tables_[edge_label_];
+    EdgeTimes times;
+    if (edge_table->num_rows() != 0) {
+      CHECK(times.Init(edge_table->column(edge_window_.prop_id)->chunk(0)));
+    }
+
+    auto restrict_lists = [this, &times](const nbr_unit_t* nbrs,
+                                         const int64_t* begins,
+                                         const int64_t* ends,
+                                         std::vector<int64_t>& window_begins,
+                                         std::vector<int64_t>& window_ends) {
+      size_t vnum = static_cast<size_t>(oe_offsets_begin_->length());
+      window_begins.resize(vnum);
+      window_ends.resize(vnum);
+      auto before = [&times](const nbr_unit_t& nbr, int64_t time) {
+        return times[nbr.eid] < time;
+      };
+      parallel_for(0, vnum, [&](size_t i) {
+        const nbr_unit_t* first = std::lower_bound(
+            nbrs + begins[i], nbrs + ends[i], edge_window_.begin, before);
+        const nbr_unit_t* last =
+            std::lower_bound(first, nbrs + ends[i], edge_window_.end, before);
+        window_begins[i] = first - nbrs;
+        window_ends[i] = last - nbrs;
+      });
+    };
+    restrict_lists(oe_ptr_, oe_offsets_begin_ptr_, oe_offsets_end_ptr_,
+                   oe_window_begins_, oe_window_ends_);
+    oe_offsets_begin_ptr_ = oe_window_begins_.data();
+    oe_offsets_end_ptr_ = oe_window_ends_.data();
+    if (directed_) {
+      restrict_lists(ie_ptr_, ie_offsets_begin_ptr_, ie_offsets_end_ptr_,
+                     ie_window_begins_, ie_window_ends_);
+      ie_offsets_begin_ptr_ = ie_window_begins_.data();
+      ie_offsets_end_ptr_ = ie_window_ends_.data();
+    } else {
+      ie_offsets_begin_ptr_ = oe_offsets_begin_ptr_;
+      ie_offsets_end_ptr_ = oe_offsets_end_ptr_;
+    }
+  }
+
+  // the positions of the lists laid out in the order, where the lists of no
+  // less than a page start at the pages, if a page is of whole units, and
+  // returns the length of the lists with the paddings
+  static int64_t layoutAdjLists(const int64_t* begins, const int64_t* ends,
+                                const std::vector<int64_t>& order,
+                                int64_t* new_begins) {
+    size_t page_size = MappedFile::PageSize();
+    int64_t page_units = page_size % sizeof(nbr_unit_t) == 0
+                             ? page_size / sizeof(nbr_unit_t)
+                             : 0;
+    int64_t pos = 0;
+    for (auto i : order) {
+      int64_t length = ends[i] - begins[i];
+      if (page_units != 0 && length >= page_units) {
+        pos = (pos + page_units - 1) / page_units * page_units;
+      }
+      new_begins[i] = pos;
+      pos += length;
+    }
+    return pos;
+  }
+
+  // copies the lists, and the inline edge data if any, to the positions in
+  // new_begins
+  static void copyAdjLists(
+      const int64_t* begins, const int64_t* ends, const nbr_unit_t* nbrs,
+      const arrow_projected_fragment_impl::inline_edata_t<EDATA_T>* edata,
+      size_t offset_num, const int64_t* new_begins, int64_t* new_ends,
+      nbr_unit_t* new_nbrs,
+      arrow_projected_fragment_impl::inline_edata_t<EDATA_T>* new_edata) {
+    parallel_for(0, offset_num, [&](size_t i) {
+      int64_t length = ends[i] - begins[i];
+      new_ends[i] = new_begins[i] + length;
+      std::copy(nbrs + begins[i], nbrs + ends[i], new_nbrs + new_begins[i]);
+      if (edata != NULL) {
+        std::copy(edata + begins[i], edata + ends[i],
+                  new_edata + new_begins[i]);
+      }
+    });
   }
 
   vertex_range_t inner_vertices_;
+  std::vector<vertex_t> inner_vertex_order_;
   vertex_range_t outer_vertices_;
   vertex_range_t vertices_;
 
@@ -1073,6 +2234,9 @@ class ArrowProjectedFragment
 
   std::shared_ptr<vid_array_t> ovgid_list_;
   const vid_t* ovgid_list_ptr_;
+  // the outer gids sorted, as they are grouped by the fids, are searched in
+  // place rather than by probing ovg2l_map_
+  bool ovgid_sorted_;
   std::shared_ptr<vineyard::Hashmap<vid_t, vid_t>> ovg2l_map_;
 
   std::shared_ptr<arrow::Array> edge_data_array_;
@@ -1081,8 +2245,36 @@ class ArrowProjectedFragment
   std::shared_ptr<arrow::FixedSizeBinaryArray> ie_, oe_;
   const nbr_unit_t* ie_ptr_;
   const nbr_unit_t* oe_ptr_;
+  // the length of the outgoing lists, including the paddings if mapped
+  int64_t oe_length_;
+  // the file holding the offsets, the lists and the inline edge data, by
+  // MapToDisk
+  std::shared_ptr<MappedFile> mapped_file_;
+  // the edge data materialized in the order of ie_ and oe_, if any
+  std::shared_ptr<arrow::Array> ie_edata_, oe_edata_;
+  const arrow_projected_fragment_impl::inline_edata_t<EDATA_T>* ie_edata_ptr_;
+  const arrow_projected_fragment_impl::inline_edata_t<EDATA_T>* oe_edata_ptr_;
+  // the lists of ie_ and oe_ are sorted by SortNbrUnits
+  bool sorted_adjacency_ = false;
+  // the lists of ie_ and oe_ are sorted by the times, and the offsets of the
+  // edges in the window of them, if the projection is of an edge window
+  bool has_edge_window_ = false;
+  EdgeWindow edge_window_;
+  std::vector<int64_t> ie_window_begins_, ie_window_ends_;
+  std::vector<int64_t> oe_window_begins_, oe_window_ends_;
+  // the neighbors encoded by EncodeCompressedNeighbors, if any
+  std::shared_ptr<arrow::UInt8Array> ie_compressed_, oe_compressed_;
+  std::shared_ptr<arrow::Int64Array> ie_compressed_offsets_,
+      oe_compressed_offsets_;
+  // the alias tables of the outgoing edges, built by InitOutgoingAliasTables
+  mutable std::vector<double> oe_alias_prob_;
+  mutable std::vector<uint32_t> oe_alias_index_;
 
   std::shared_ptr<vertex_map_t> vm_ptr_;
+  // the oids of the outer vertices to their gids, so the lookups by the oids
+  // on a worker take the memory of its own vertices only
+  mutable std::once_flag outer_index_flag_;
+  mutable ProjectedOidIndex<internal_oid_t, vid_t> outer_index_;
 
   vineyard::IdParser<vid_t> vid_parser_;
 
@@ -1098,6 +2290,41 @@ class ArrowProjectedFragment
   std::vector<std::vector<vertex_t>> mirrors_of_frag_;
 };
 
+/**
+ * @brief Drops the names of the arrays shared by the projections of the
+ * fragment, and deletes them, once the fragment is unloaded. The arrays still
+ * held by a projection are kept by vineyard until it is deleted as well.
+ */
+template <typename OID_T, typename VID_T>
+void DeleteSharedProjectionArrays(
+    vineyard::Client& client,
+    const vineyard::ArrowFragment<OID_T, VID_T>& fragment) {
+  std::vector<std::string> names;
+  for (int v_label = 0; v_label < fragment.vertex_label_num(); ++v_label) {
+    for (int e_label = 0; e_label < fragment.edge_label_num(); ++e_label) {
+      for (const std::string direction : {"ie", "oe"}) {
+        auto name = arrow_projected_fragment_impl::shared_offsets_name(
+            fragment.id(), v_label, e_label, direction);
+        names.push_back(name + "_begin");
+        names.push_back(name + "_end");
+        for (int prop = 0; prop < fragment.edge_property_num(e_label);
+             ++prop) {
+          names.push_back(
+              arrow_projected_fragment_impl::shared_time_sorted_name(
+                  fragment.id(), v_label, e_label, prop, direction));
+        }
+      }
+    }
+  }
+  for (auto& name : names) {
+    vineyard::ObjectID id;
+    if (client.GetName(name, id, false).ok()) {
+      VINEYARD_SUPPRESS(client.DropName(name));
+      VINEYARD_SUPPRESS(client.DelData(id, false, true));
+    }
+  }
+}
+
 }  // namespace gs
 
 #endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_ARROW_PROJECTED_FRAGMENT_H_
@@ -0,0 +1,160 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_COMPRESSED_ADJ_LIST_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_COMPRESSED_ADJ_LIST_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "grape/types.h"
+#include "grape/utils/vertex_array.h"
+
+namespace gs {
+
+namespace compressed_adj_list_impl {
+
+inline void encode_varint(uint64_t value, std::vector<uint8_t>& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+inline uint64_t decode_varint(const uint8_t*& ptr) {
+  uint64_t value = 0;
+  int shift = 0;
+  while (*ptr & 0x80) {
+    value |= static_cast<uint64_t>(*ptr++ & 0x7f) << shift;
+    shift += 7;
+  }
+  value |= static_cast<uint64_t>(*ptr++) << shift;
+  return value;
+}
+
+}  // namespace compressed_adj_list_impl
+
+/**
+ * @brief Appends the neighbors to out, sorted, as the first neighbor followed
+ * by the gaps between the adjacent ones, each of which is a LEB128 varint.
+ * The neighbors are reordered in place.
+ */
+template <typename VID_T>
+void EncodeCompressedNeighbors(std::vector<VID_T>& nbrs,
+                               std::vector<uint8_t>& out) {
+  std::sort(nbrs.begin(), nbrs.end());
+  VID_T prev = 0;
+  for (auto v : nbrs) {
+    compressed_adj_list_impl::encode_varint(static_cast<uint64_t>(v - prev),
+                                            out);
+    prev = v;
+  }
+}
+
+/**
+ * @brief The neighbor decoded from a compressed adjacency list, which has no
+ * edge id nor edge data, i.e., the iterator of the unweighted traversals.
+ */
+template <typename VID_T>
+class CompressedNbr {
+  using vid_t = VID_T;
+
+ public:
+  CompressedNbr(const uint8_t* ptr, size_t remaining)
+      : ptr_(ptr), remaining_(remaining), vid_(0) {
+    decode();
+  }
+
+  CompressedNbr(const CompressedNbr& rhs)
+      : ptr_(rhs.ptr_), remaining_(rhs.remaining_), vid_(rhs.vid_) {}
+
+  grape::Vertex<vid_t> neighbor() const { return grape::Vertex<vid_t>(vid_); }
+
+  grape::Vertex<vid_t> get_neighbor() const {
+    return grape::Vertex<vid_t>(vid_);
+  }
+
+  grape::EmptyType data() const { return grape::EmptyType(); }
+
+  grape::EmptyType get_data() const { return grape::EmptyType(); }
+
+  inline const CompressedNbr& operator++() const {
+    --remaining_;
+    decode();
+    return *this;
+  }
+
+  inline CompressedNbr operator++(int) const {
+    CompressedNbr ret(*this);
+    ++(*this);
+    return ret;
+  }
+
+  inline bool operator==(const CompressedNbr& rhs) const {
+    return remaining_ == rhs.remaining_;
+  }
+  inline bool operator!=(const CompressedNbr& rhs) const {
+    return remaining_ != rhs.remaining_;
+  }
+
+  inline const CompressedNbr& operator*() const { return *this; }
+
+  inline const CompressedNbr* operator->() const { return this; }
+
+ private:
+  inline void decode() const {
+    if (remaining_ != 0) {
+      vid_ += static_cast<vid_t>(compressed_adj_list_impl::decode_varint(ptr_));
+    }
+  }
+
+  const mutable uint8_t* ptr_;
+  mutable size_t remaining_;
+  mutable vid_t vid_;
+};
+
+/**
+ * @brief The neighbors of a vertex encoded by EncodeCompressedNeighbors,
+ * which are visited forward only, in the order of the vids.
+ */
+template <typename VID_T>
+class CompressedAdjList {
+ public:
+  CompressedAdjList() : ptr_(NULL), size_(0) {}
+
+  CompressedAdjList(const uint8_t* ptr, size_t size) : ptr_(ptr), size_(size) {}
+
+  CompressedNbr<VID_T> begin() const {
+    return CompressedNbr<VID_T>(ptr_, size_);
+  }
+
+  CompressedNbr<VID_T> end() const { return CompressedNbr<VID_T>(ptr_, 0); }
+
+  size_t Size() const { return size_; }
+
+  inline bool Empty() const { return size_ == 0; }
+
+  inline bool NotEmpty() const { return size_ != 0; }
+
+ private:
+  const uint8_t* ptr_;
+  size_t size_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_COMPRESSED_ADJ_LIST_H_
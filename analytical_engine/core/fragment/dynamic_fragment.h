@@ -19,14 +19,23 @@
 #ifdef NETWORKX
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <iosfwd>
+#include <iterator>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <tuple>
+#include <type_traits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -49,8 +58,12 @@
 #include "vineyard/graph/utils/partitioner.h"
 
 #include "core/error.h"
+#include "core/fragment/mutation_log.h"
 #include "core/io/dynamic_line_parser.h"
+#include "core/utils/memory_strategy.h"
 #include "core/utils/mpi_utils.h"
+#include "core/utils/parallel_utils.h"
+#include "core/vertex_map/dynamic_vertex_map.h"
 #include "core/vertex_map/global_vertex_map.h"
 #include "proto/types.pb.h"
 
@@ -217,7 +230,315 @@ class Nbr {
 };
 
 /**
- * This is an internal representation of neighbor vertices using std::map.
+ * @brief Writes a folly::dynamic in a tagged binary form, which is much cheaper
+ * to parse than json and keeps the distinction of int64 and double.
+ */
+inline void SerializeDynamic(grape::InArchive& arc, const folly::dynamic& d) {
+  arc << static_cast<int8_t>(d.type());
+  switch (d.type()) {
+  case folly::dynamic::Type::NULLT:
+    break;
+  case folly::dynamic::Type::BOOL:
+    arc << d.getBool();
+    break;
+  case folly::dynamic::Type::INT64:
+    arc << d.getInt();
+    break;
+  case folly::dynamic::Type::DOUBLE:
+    arc << d.getDouble();
+    break;
+  case folly::dynamic::Type::STRING:
+    arc << d.getString();
+    break;
+  case folly::dynamic::Type::ARRAY:
+    arc << static_cast<size_t>(d.size());
+    for (auto& elem : d) {
+      SerializeDynamic(arc, elem);
+    }
+    break;
+  case folly::dynamic::Type::OBJECT:
+    arc << static_cast<size_t>(d.size());
+    for (auto& kv : d.items()) {
+      SerializeDynamic(arc, kv.first);
+      SerializeDynamic(arc, kv.second);
+    }
+    break;
+  default:
+    LOG(FATAL) << "Unsupported dynamic type: " << d.typeName();
+  }
+}
+
+inline void DeserializeDynamic(grape::OutArchive& arc, folly::dynamic& d) {
+  int8_t type;
+  arc >> type;
+  switch (static_cast<folly::dynamic::Type>(type)) {
+  case folly::dynamic::Type::NULLT:
+    d = nullptr;
+    break;
+  case folly::dynamic::Type::BOOL: {
+    bool value;
+    arc >> value;
+    d = value;
+    break;
+  }
+  case folly::dynamic::Type::INT64: {
+    int64_t value;
+    arc >> value;
+    d = value;
+    break;
+  }
+  case folly::dynamic::Type::DOUBLE: {
+    double value;
+    arc >> value;
+    d = value;
+    break;
+  }
+  case folly::dynamic::Type::STRING: {
+    std::string value;
+    arc >> value;
+    d = std::move(value);
+    break;
+  }
+  case folly::dynamic::Type::ARRAY: {
+    size_t size;
+    arc >> size;
+    d = folly::dynamic::array;
+    d.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      DeserializeDynamic(arc, d[i]);
+    }
+    break;
+  }
+  case folly::dynamic::Type::OBJECT: {
+    size_t size;
+    arc >> size;
+    d = folly::dynamic::object;
+    for (size_t i = 0; i < size; ++i) {
+      folly::dynamic key, value;
+      DeserializeDynamic(arc, key);
+      DeserializeDynamic(arc, value);
+      d.insert(std::move(key), std::move(value));
+    }
+    break;
+  }
+  default:
+    LOG(FATAL) << "Unsupported dynamic type: " << static_cast<int>(type);
+  }
+}
+
+/**
+ * @brief Writes the elements of an array of trivial type as raw bytes.
+ */
+template <typename T, typename ALLOC_T>
+inline void SerializeArray(grape::InArchive& arc,
+                           const grape::Array<T, ALLOC_T>& array) {
+  arc << static_cast<size_t>(array.size());
+  if (array.size() > 0) {
+    arc.AddBytes(array.data(), array.size() * sizeof(T));
+  }
+}
+
+template <typename T, typename ALLOC_T>
+inline void DeserializeArray(grape::OutArchive& arc,
+                             grape::Array<T, ALLOC_T>& array) {
+  size_t size;
+  arc >> size;
+  array.clear();
+  array.resize(size);
+  if (size > 0) {
+    memcpy(array.data(), arc.GetBytes(size * sizeof(T)), size * sizeof(T));
+  }
+}
+
+/**
+ * @brief Neighbors of a vertex, stored in a contiguous array sorted by the
+ * internal lid of the neighbor, which is the key of a Nbr and not stored
+ * apart.
+ *
+ * Newly inserted neighbors are appended to an unsorted tail (the delta) and
+ * merged into the sorted part by Compact(). Iteration follows the lid order
+ * only when the delta is empty, which NbrMapSpace guarantees at the end of
+ * every mutation batch.
+ *
+ * @tparam EDATA_T Data type of edge
+ */
+template <typename EDATA_T>
+class NbrMap {
+  using VID_T = vineyard::property_graph_types::VID_TYPE;
+  using NbrT = Nbr<EDATA_T>;
+
+ public:
+  using value_type = NbrT;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  static inline VID_T key_of(const value_type& nbr) {
+    return nbr.neighbor().GetValue();
+  }
+
+  NbrMap() : sorted_num_(0) {}
+
+  inline size_t size() const { return nbrs_.size(); }
+
+  inline bool empty() const { return nbrs_.empty(); }
+
+  inline bool compacted() const { return sorted_num_ == nbrs_.size(); }
+
+  inline iterator begin() { return nbrs_.data(); }
+
+  inline iterator end() { return nbrs_.data() + nbrs_.size(); }
+
+  // the bytes of the neighbor array, including the reserved ones
+  inline size_t capacity_bytes() const {
+    return nbrs_.capacity() * sizeof(value_type);
+  }
+
+  inline const_iterator begin() const { return nbrs_.data(); }
+
+  inline const_iterator end() const { return nbrs_.data() + nbrs_.size(); }
+
+  inline const_iterator cbegin() const { return begin(); }
+
+  inline const_iterator cend() const { return end(); }
+
+  // binary search in the sorted part only
+  inline iterator find_sorted(VID_T vid) {
+    auto sorted_end = begin() + sorted_num_;
+    auto iter = std::lower_bound(begin(), sorted_end, vid, key_less);
+    return (iter != sorted_end && key_of(*iter) == vid) ? iter : end();
+  }
+
+  inline iterator find(VID_T vid) {
+    auto iter = find_sorted(vid);
+    if (iter == end()) {
+      iter = std::find_if(
+          begin() + sorted_num_, end(),
+          [vid](const value_type& v) { return key_of(v) == vid; });
+    }
+    return iter;
+  }
+
+  inline const_iterator find(VID_T vid) const {
+    return const_cast<NbrMap*>(this)->find(vid);
+  }
+
+  // append a neighbor which must not exist
+  inline void emplace_back(const NbrT& nbr) {
+    bool keep_sorted =
+        compacted() && (empty() || key_of(nbrs_.back()) < key_of(nbr));
+    nbrs_.emplace_back(nbr);
+    if (keep_sorted) {
+      ++sorted_num_;
+    }
+  }
+
+  inline size_t erase(VID_T vid) {
+    auto iter = find(vid);
+    if (iter == end()) {
+      return 0;
+    }
+    size_t idx = iter - begin();
+    nbrs_.erase(nbrs_.begin() + idx);
+    if (idx < sorted_num_) {
+      --sorted_num_;
+    }
+    return 1;
+  }
+
+  // merge the delta into the sorted part
+  void Compact() {
+    if (compacted()) {
+      return;
+    }
+    auto sorted_end = nbrs_.begin() + sorted_num_;
+    std::sort(sorted_end, nbrs_.end(), value_less);
+    std::inplace_merge(nbrs_.begin(), sorted_end, nbrs_.end(), value_less);
+    sorted_num_ = nbrs_.size();
+  }
+
+  void clear() {
+    std::vector<value_type>().swap(nbrs_);
+    sorted_num_ = 0;
+  }
+
+  // the neighbor ids are written as a raw array, followed by the edge data.
+  void Serialize(grape::InArchive& arc) const {
+    assert(compacted());
+    std::vector<VID_T> vids(nbrs_.size());
+    for (size_t i = 0; i < nbrs_.size(); ++i) {
+      vids[i] = key_of(nbrs_[i]);
+    }
+    arc << vids.size();
+    if (!vids.empty()) {
+      arc.AddBytes(vids.data(), vids.size() * sizeof(VID_T));
+    }
+    for (auto& nbr : nbrs_) {
+      SerializeDynamic(arc, nbr.data());
+    }
+  }
+
+  void Deserialize(grape::OutArchive& arc) {
+    size_t size;
+    arc >> size;
+    std::vector<VID_T> vids(size);
+    if (size > 0) {
+      memcpy(vids.data(), arc.GetBytes(size * sizeof(VID_T)),
+             size * sizeof(VID_T));
+    }
+    nbrs_.clear();
+    nbrs_.reserve(size);
+    EDATA_T data;
+    for (auto vid : vids) {
+      DeserializeDynamic(arc, data);
+      nbrs_.emplace_back(vid, data);
+    }
+    sorted_num_ = nbrs_.size();
+  }
+
+ private:
+  static bool key_less(const value_type& lhs, VID_T vid) {
+    return key_of(lhs) < vid;
+  }
+
+  static bool value_less(const value_type& lhs, const value_type& rhs) {
+    return key_of(lhs) < key_of(rhs);
+  }
+
+  std::vector<value_type> nbrs_;
+  size_t sorted_num_;
+};
+
+/**
+ * @brief A sub-range of a NbrMap, e.g. the inner or outer neighbors of a
+ * vertex.
+ *
+ * @tparam ITER_T Iterator type of NbrMap
+ */
+template <typename ITER_T>
+class NbrRange {
+ public:
+  NbrRange(ITER_T begin, ITER_T end) : begin_(begin), end_(end) {}
+
+  inline ITER_T begin() const { return begin_; }
+
+  inline ITER_T end() const { return end_; }
+
+  inline ITER_T cbegin() const { return begin_; }
+
+  inline ITER_T cend() const { return end_; }
+
+  inline size_t size() const { return end_ - begin_; }
+
+  inline bool empty() const { return begin_ == end_; }
+
+ private:
+  ITER_T begin_;
+  ITER_T end_;
+};
+
+/**
+ * This is an internal representation of neighbor vertices, which iterates
+ * over the contiguous neighbor array of a NbrMap.
  *
  * @tparam EDATA_T Data type of edge
  */
@@ -225,25 +546,23 @@ template <typename EDATA_T>
 class AdjList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
   using NbrT = Nbr<EDATA_T>;
+  using nbr_iterator_t = typename NbrMap<EDATA_T>::iterator;
 
  public:
   AdjList() = default;
-  AdjList(VID_T id_mask, VID_T ivnum,
-          typename std::map<VID_T, NbrT>::iterator map_iter_begin,
-          typename std::map<VID_T, NbrT>::iterator map_iter_end)
+  AdjList(VID_T id_mask, VID_T ivnum, nbr_iterator_t iter_begin,
+          nbr_iterator_t iter_end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        iter_begin_(iter_begin),
+        iter_end_(iter_end) {}
   ~AdjList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return iter_begin_ == iter_end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return iter_end_ - iter_begin_; }
 
   class iterator {
     using pointer_type = NbrT*;
@@ -251,9 +570,8 @@ class AdjList {
 
    public:
     iterator() = default;
-    iterator(VID_T id_mask, VID_T ivnum,
-             typename std::map<VID_T, NbrT>::iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    iterator(VID_T id_mask, VID_T ivnum, nbr_iterator_t current) noexcept
+        : id_mask_(id_mask), ivnum_(ivnum), current_(current) {}
 
     reference_type operator*() noexcept {
       set_nbr();
@@ -266,41 +584,38 @@ class AdjList {
     }
 
     iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     iterator operator++(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_++);
+      return iterator(id_mask_, ivnum_, current_++);
     }
 
     iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     iterator operator--(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_--);
+      return iterator(id_mask_, ivnum_, current_--);
     }
 
     iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return iterator(id_mask_, ivnum_, curr);
+      return iterator(id_mask_, ivnum_, current_ + offset);
     }
 
     bool operator==(const iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
     void set_nbr() {
-      internal_nbr = map_current_->second;
+      internal_nbr = *current_;
       auto v = internal_nbr.neighbor();
       // convert internal lid to external lid
       if (v.GetValue() >= ivnum_) {
@@ -312,7 +627,7 @@ class AdjList {
     VID_T id_mask_{};
     VID_T ivnum_{};
     NbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    nbr_iterator_t current_{};
   };
 
   class const_iterator {
@@ -321,10 +636,8 @@ class AdjList {
 
    public:
     const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum,
-        typename std::map<VID_T, NbrT>::iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    const_iterator(VID_T id_mask, VID_T ivnum, nbr_iterator_t current) noexcept
+        : id_mask_(id_mask), ivnum_(ivnum), current_(current) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -337,67 +650,74 @@ class AdjList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, current_ + offset);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
-    VID_T id_mask_;
-    VID_T ivnum_;
+    void set_nbr() {
+      internal_nbr = *current_;
+      auto v = internal_nbr.neighbor();
+      // convert internal lid to external lid
+      if (v.GetValue() >= ivnum_) {
+        v.SetValue(ivnum_ + id_mask_ - v.GetValue());
+      }
+      internal_nbr.set_neighbor(v);
+    }
+
+    VID_T id_mask_{};
+    VID_T ivnum_{};
     NbrT internal_nbr;
-    typename std::map<VID_T, const NbrT>::iterator map_current_;
+    nbr_iterator_t current_{};
   };
 
-  iterator begin() { return iterator(id_mask_, ivnum_, map_iter_begin_); }
+  iterator begin() { return iterator(id_mask_, ivnum_, iter_begin_); }
 
-  iterator end() { return iterator(id_mask_, ivnum_, map_iter_end_); }
+  iterator end() { return iterator(id_mask_, ivnum_, iter_end_); }
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, iter_begin_);
   }
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, iter_end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return iter_begin_ == iter_end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
-  typename std::map<VID_T, NbrT>::iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_end_;
+  nbr_iterator_t iter_begin_{};
+  nbr_iterator_t iter_end_{};
 };
 
 /**
- * @brief This is an internal representation of neighbor vertices using
- * std::map.
+ * @brief This is an internal representation of neighbor vertices, which
+ * iterates over the contiguous neighbor array of a NbrMap.
  *
  * @tparam EDATA_T Data type of edge
  */
@@ -405,25 +725,23 @@ template <typename EDATA_T>
 class ConstAdjList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
   using NbrT = Nbr<EDATA_T>;
+  using nbr_iterator_t = typename NbrMap<EDATA_T>::const_iterator;
 
  public:
   ConstAdjList() = default;
-  ConstAdjList(VID_T id_mask, VID_T ivnum,
-               typename std::map<VID_T, NbrT>::const_iterator map_iter_begin,
-               typename std::map<VID_T, NbrT>::const_iterator map_iter_end)
+  ConstAdjList(VID_T id_mask, VID_T ivnum, nbr_iterator_t iter_begin,
+               nbr_iterator_t iter_end)
       : id_mask_(id_mask),
         ivnum_(ivnum),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        iter_begin_(iter_begin),
+        iter_end_(iter_end) {}
   ~ConstAdjList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return iter_begin_ == iter_end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return iter_end_ - iter_begin_; }
 
   class const_iterator {
     using pointer_type = const NbrT*;
@@ -431,10 +749,8 @@ class ConstAdjList {
 
    public:
     const_iterator() = default;
-    const_iterator(
-        VID_T id_mask, VID_T ivnum,
-        typename std::map<VID_T, NbrT>::const_iterator map_current) noexcept
-        : id_mask_(id_mask), ivnum_(ivnum), map_current_(map_current) {}
+    const_iterator(VID_T id_mask, VID_T ivnum, nbr_iterator_t current) noexcept
+        : id_mask_(id_mask), ivnum_(ivnum), current_(current) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -447,41 +763,38 @@ class ConstAdjList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, current_ + offset);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
     void set_nbr() {
-      internal_nbr = map_current_->second;
+      internal_nbr = *current_;
       auto v = internal_nbr.neighbor();
       // convert internal lid to external lid
       if (v.GetValue() >= ivnum_) {
@@ -493,27 +806,46 @@ class ConstAdjList {
     VID_T id_mask_{};
     VID_T ivnum_{};
     NbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::const_iterator map_current_;
+    nbr_iterator_t current_{};
   };
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, iter_begin_);
   }
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, iter_end_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return iter_begin_ == iter_end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_end_;
+  nbr_iterator_t iter_begin_{};
+  nbr_iterator_t iter_end_{};
 };
 
 /**
- * @brief A container to store edges.
+ * @brief A container to store edges. Each slot is a NbrMap, whose neighbors
+ * are kept in a sorted contiguous array. Edges inserted during a mutation
+ * batch are buffered in per-slot deltas, which are indexed by a batch-wide
+ * hash map and merged by Compact().
+ *
+ * The slots are held by shared pointers and copies of the space share them,
+ * a slot is duplicated only when it is modified while being shared, so that
+ * copying a fragment costs memory proportional to the modified slots. The
+ * non-const accessors must not be used to modify a slot, use the mutation
+ * methods instead.
+ *
+ * Whether a slot may be written in place is tracked by an ownership flag per
+ * slot rather than the use count of the pointer, which is read without any
+ * ordering against the other spaces, or the other half of a double_copy(),
+ * writing the same slot from other threads. A space owns the slots it
+ * creates, and copy() and double_copy() take the ownership of the shared
+ * slots from both sides, so each side duplicates them on the first write.
+ * The flag of a slot is only touched by the single thread mutating the slot,
+ * see BatchEmplace, and the copies must not run concurrently with the
+ * mutations of the source.
  *
  * @tparam EDATA_T The type of data attached with the edge
  */
@@ -521,153 +853,693 @@ template <typename EDATA_T>
 class NbrMapSpace {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
   using NbrT = Nbr<EDATA_T>;
+  using nbr_map_t = NbrMap<EDATA_T>;
+  using inner_range_t = NbrRange<typename nbr_map_t::iterator>;
+  using const_inner_range_t = NbrRange<typename nbr_map_t::const_iterator>;
+
+  struct pending_key_hash {
+    size_t operator()(const std::pair<size_t, VID_T>& key) const {
+      return (key.first * 0x9E3779B97F4A7C15ULL) ^ key.second;
+    }
+  };
+  using pending_map_t =
+      ska::flat_hash_map<std::pair<size_t, VID_T>, size_t, pending_key_hash>;
 
  public:
-  NbrMapSpace() : index_(0) {}
+  // a neighbor to be inserted to, updated in or removed from slot loc
+  struct BatchNbr {
+    size_t loc;
+    VID_T vid;
+    const EDATA_T* data;
+  };
 
-  size_t size() { return buffer_.size(); }
+  NbrMapSpace()
+      : split_ivnum_(std::numeric_limits<VID_T>::max()), index_(0) {}
 
-  // Create a new linked list
+  size_t size() const { return buffer_.size(); }
+
+  // Create a new neighbor list
   inline size_t emplace(VID_T vid, const EDATA_T& edata) {
     buffer_.resize(index_ + 1);
-    buffer_[index_] = new std::map<VID_T, NbrT>();
-    buffer_[index_]->operator[](vid) = NbrT(vid, edata);
+    owned_.resize(index_ + 1);
+    buffer_[index_] = std::make_shared<nbr_map_t>();
+    owned_[index_] = 1;
+    buffer_[index_]->emplace_back(NbrT(vid, edata));
+    return index_++;
+  }
+
+  // Create a new empty neighbor list
+  inline size_t allocate() {
+    buffer_.resize(index_ + 1);
+    owned_.resize(index_ + 1);
+    buffer_[index_] = std::make_shared<nbr_map_t>();
+    owned_[index_] = 1;
     return index_++;
   }
 
-  // Insert the value to an existing linked list, or update the existing value
+  // Insert the value to an existing neighbor list, or update the existing
+  // value
   inline size_t emplace(size_t loc, VID_T vid, const EDATA_T& edata,
                         bool& created) {
-    if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid).update_data(edata);
-      created = false;
-      return loc;
-    } else {
-      buffer_[loc]->operator[](vid) = NbrT(vid, edata);
-      created = true;
-      return loc;
+    created = emplaceImpl(loc, vid, edata, pending_, dirty_);
+    return loc;
+  }
+
+  /**
+   * @brief Inserts a batch of neighbors to existing slots by multiple threads,
+   * each slot is owned by a single thread. created[i] is set to 1 if nbrs[i]
+   * is newly inserted, otherwise the data is merged into the existing one.
+   */
+  void BatchEmplace(const std::vector<BatchNbr>& nbrs,
+                    std::vector<uint8_t>& created) {
+    Compact();
+    created.resize(nbrs.size());
+    size_t thread_num = parallel_thread_num(nbrs.size(), kParallelGrainSize);
+    std::vector<pending_map_t> pendings(thread_num);
+    std::vector<std::vector<size_t>> dirties(thread_num);
+    parallel_for_by_key(
+        nbrs.size(), thread_num, [&](size_t i) { return nbrs[i].loc; },
+        [&](size_t tid, size_t i) {
+          auto& nbr = nbrs[i];
+          created[i] = emplaceImpl(nbr.loc, nbr.vid, *nbr.data, pendings[tid],
+                                   dirties[tid]);
+        });
+    for (auto& dirty : dirties) {
+      dirty_.insert(dirty_.end(), dirty.begin(), dirty.end());
     }
+    Compact();
+  }
+
+  // Updates the data of a batch of neighbors by multiple threads.
+  void BatchSetData(const std::vector<BatchNbr>& nbrs) {
+    size_t thread_num = parallel_thread_num(nbrs.size(), kParallelGrainSize);
+    parallel_for_by_key(
+        nbrs.size(), thread_num, [&](size_t i) { return nbrs[i].loc; },
+        [&](size_t, size_t i) {
+          set_data(nbrs[i].loc, nbrs[i].vid, *nbrs[i].data);
+        });
+  }
+
+  // Removes a batch of neighbors by multiple threads, removed[i] is set to 1
+  // if nbrs[i] existed.
+  void BatchRemove(const std::vector<BatchNbr>& nbrs,
+                   std::vector<uint8_t>& removed) {
+    Compact();
+    removed.resize(nbrs.size());
+    size_t thread_num = parallel_thread_num(nbrs.size(), kParallelGrainSize);
+    parallel_for_by_key(
+        nbrs.size(), thread_num, [&](size_t i) { return nbrs[i].loc; },
+        [&](size_t, size_t i) {
+          removed[i] = remove_edge(nbrs[i].loc, nbrs[i].vid);
+        });
   }
 
   inline void update(size_t loc, VID_T vid, const EDATA_T& edata) {
     if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid).update_data(edata);
+      mutableSlot(loc).find(vid)->update_data(edata);
     }
   }
 
   inline void set_data(size_t loc, VID_T vid, const EDATA_T& edata) {
     if (buffer_[loc]->find(vid) != buffer_[loc]->end()) {
-      buffer_[loc]->operator[](vid) = NbrT(vid, edata);
+      mutableSlot(loc).find(vid)->set_data(edata);
     }
   }
 
   inline void remove_edges(size_t loc) {
-    delete buffer_[loc];
-    buffer_[loc] = nullptr;
+    buffer_[loc] = std::make_shared<nbr_map_t>();
+    owned_[loc] = 1;
+    markSplitStale(loc);
   }
 
   inline size_t remove_edge(size_t loc, VID_T vid) {
-    return buffer_[loc]->erase(vid);
+    assert(dirty_.empty());
+    if (buffer_[loc]->find(vid) == buffer_[loc]->end()) {
+      return 0;
+    }
+    return mutableSlot(loc).erase(vid);
   }
 
-  inline std::map<VID_T, NbrT>& operator[](size_t loc) { return *buffer_[loc]; }
+  inline nbr_map_t& operator[](size_t loc) { return *buffer_[loc]; }
 
-  inline const std::map<VID_T, NbrT>& operator[](size_t loc) const {
+  inline const nbr_map_t& operator[](size_t loc) const {
     return *buffer_[loc];
   }
 
-  inline std::map<VID_T, NbrT>& InnerNbr(size_t loc) {
-    return split_buffer_[loc][0];
+  inline inner_range_t InnerNbr(size_t loc) {
+    auto& nbrs = *buffer_[loc];
+    return inner_range_t(nbrs.begin(), nbrs.begin() + split_offsets_[loc]);
+  }
+
+  inline const_inner_range_t InnerNbr(size_t loc) const {
+    auto& nbrs = *buffer_[loc];
+    return const_inner_range_t(nbrs.begin(),
+                               nbrs.begin() + split_offsets_[loc]);
   }
 
-  inline const std::map<VID_T, NbrT>& InnerNbr(size_t loc) const {
-    return split_buffer_[loc][0];
+  inline inner_range_t OuterNbr(size_t loc) {
+    auto& nbrs = *buffer_[loc];
+    return inner_range_t(nbrs.begin() + split_offsets_[loc], nbrs.end());
   }
 
-  inline std::map<VID_T, NbrT>& OuterNbr(size_t loc) {
-    return split_buffer_[loc][1];
+  inline const_inner_range_t OuterNbr(size_t loc) const {
+    auto& nbrs = *buffer_[loc];
+    return const_inner_range_t(nbrs.begin() + split_offsets_[loc],
+                               nbrs.end());
   }
 
-  inline const std::map<VID_T, NbrT>& OuterNbr(size_t loc) const {
-    return split_buffer_[loc][1];
+  // merge all pending deltas, must be called before iterating the edges.
+  void Compact() {
+    parallel_for(0, dirty_.size(),
+                 [this](size_t i) { buffer_[dirty_[i]]->Compact(); }, 64);
+    dirty_.clear();
+    pending_.clear();
   }
 
+  // shares the slots of other, which are duplicated on the first write by
+  // either side.
   void copy(const NbrMapSpace<EDATA_T>& other) {
+    assert(other.dirty_.empty());
     index_ = other.index_;
-    buffer_.resize(other.buffer_.size());
-    for (size_t i = 0; i < other.buffer_.size(); ++i) {
-      if (other.buffer_[i] != nullptr) {
-        buffer_[i] = new std::map<VID_T, NbrT>();
-        for (auto& item : *(other.buffer_[i])) {
-          buffer_[i]->operator[](item.first) = item.second;
-        }
-      } else {
-        buffer_[i] = nullptr;
-      }
-    }
+    buffer_ = other.buffer_;
+    other.owned_.assign(other.buffer_.size(), 0);
+    owned_.assign(buffer_.size(), 0);
+    split_offsets_ = other.split_offsets_;
+    split_stale_ = other.split_stale_;
+    split_ivnum_ = other.split_ivnum_;
   }
 
   // copy the edge space double size, use for undirected graph to directed
-  // graph.
+  // graph. Both halves share the slots of other.
   void double_copy(const NbrMapSpace<EDATA_T>& other) {
+    assert(other.dirty_.empty());
     index_ = other.index_ * 2;
     size_t old_index = other.index_;
     buffer_.resize(other.buffer_.size() * 2);
     for (size_t i = 0; i < other.buffer_.size(); ++i) {
-      if (other.buffer_[i] != nullptr) {
-        buffer_[i] = new std::map<VID_T, NbrT>();
-        buffer_[i + old_index] = new std::map<VID_T, NbrT>();
-        for (auto& item : *(other.buffer_[i])) {
-          buffer_[i]->operator[](item.first) = item.second;
-          buffer_[i + old_index]->operator[](item.first) = item.second;
-        }
-      } else {
-        buffer_[i] = nullptr;
-        buffer_[i + old_index] = nullptr;
-      }
+      buffer_[i] = other.buffer_[i];
+      buffer_[i + old_index] = other.buffer_[i];
     }
+    other.owned_.assign(other.buffer_.size(), 0);
+    owned_.assign(buffer_.size(), 0);
+    split_offsets_.clear();
+    split_stale_.clear();
+    split_ivnum_ = std::numeric_limits<VID_T>::max();
   }
 
   void Clear() {
-    for (size_t i = 0; i < buffer_.size(); ++i) {
-      delete buffer_[i];
-      buffer_[i] = nullptr;
-    }
     buffer_.clear();
+    owned_.clear();
+    split_offsets_.clear();
+    split_stale_.clear();
+    split_ivnum_ = std::numeric_limits<VID_T>::max();
+    pending_.clear();
+    dirty_.clear();
     index_ = 0;
   }
 
+  // backs the large neighbor arrays by the huge pages
+  void AdviseHugePages() {
+    parallel_for(0, buffer_.size(), [this](size_t loc) {
+      auto& nbrs = *buffer_[loc];
+      if (nbrs.capacity_bytes() >= kHugePageSize) {
+        gs::AdviseHugePages(nbrs.begin(), nbrs.capacity_bytes());
+      }
+    });
+    gs::AdviseHugePages(buffer_.data(),
+                        buffer_.size() * sizeof(buffer_[0]));
+    gs::AdviseHugePages(split_offsets_.data(),
+                        split_offsets_.size() * sizeof(size_t));
+  }
+
+  // split offsets are not written, they are rebuilt by BuildSplitEdges().
+  void Serialize(grape::InArchive& arc) {
+    Compact();
+    arc << index_ << buffer_.size();
+    for (auto& nbrs : buffer_) {
+      nbrs->Serialize(arc);
+    }
+  }
+
+  void Deserialize(grape::OutArchive& arc) {
+    Clear();
+    size_t size;
+    arc >> index_ >> size;
+    buffer_.resize(size);
+    owned_.assign(size, 1);
+    for (auto& nbrs : buffer_) {
+      nbrs = std::make_shared<nbr_map_t>();
+      nbrs->Deserialize(arc);
+    }
+  }
+
+  // Inner vertices have lids in [0, ivnum) and outer vertices have lids in
+  // (ivnum, id_mask], so the inner neighbors are always a prefix of the
+  // sorted neighbor list, only the split point is recorded. The split points
+  // are kept across calls and only the slots modified since the last call
+  // are recomputed.
   void BuildSplitEdges(VID_T ivnum) {
-    // free existed buffer
-    for (size_t loc = 0; loc < split_buffer_.size(); loc++) {
-      delete[] split_buffer_[loc];
+    Compact();
+    if (ivnum != split_ivnum_) {
+      split_offsets_.clear();
+      split_stale_.clear();
+      split_ivnum_ = ivnum;
+    }
+    split_offsets_.resize(buffer_.size(), 0);
+    split_stale_.resize(buffer_.size(), 1);
+    parallel_for(0, buffer_.size(), [this, ivnum](size_t loc) {
+      if (!split_stale_[loc]) {
+        return;
+      }
+      auto& nbrs = *buffer_[loc];
+      auto iter = std::lower_bound(
+          nbrs.begin(), nbrs.end(), ivnum,
+          [](const NbrT& nbr, VID_T lid) {
+            return nbr_map_t::key_of(nbr) < lid;
+          });
+      split_offsets_[loc] = iter - nbrs.begin();
+      split_stale_[loc] = 0;
+    });
+  }
+
+ private:
+  // duplicates the slot if it is not owned by the space, i.e., it may be
+  // shared with other spaces or slots.
+  inline nbr_map_t& mutableSlot(size_t loc) {
+    markSplitStale(loc);
+    auto& nbrs = buffer_[loc];
+    if (!owned_[loc]) {
+      nbrs = std::make_shared<nbr_map_t>(*nbrs);
+      owned_[loc] = 1;
     }
+    return *nbrs;
+  }
 
-    // copy all existed edges and distinguish inner/outer neighbors
-    split_buffer_.resize(buffer_.size());
-    for (size_t loc = 0; loc < buffer_.size(); loc++) {
-      auto& maps = *buffer_[loc];
+  // slots created after the last BuildSplitEdges() are beyond split_stale_
+  // and are always recomputed.
+  inline void markSplitStale(size_t loc) {
+    if (loc < split_stale_.size()) {
+      split_stale_[loc] = 1;
+    }
+  }
 
-      split_buffer_[loc] = new std::map<VID_T, NbrT>[2];
-      for (const auto& iter : maps) {
-        auto lid = iter.first;
-        auto& nbr = iter.second;
-        auto idx = lid < ivnum ? 0 : 1;
+  std::vector<std::shared_ptr<nbr_map_t>> buffer_;
+  // owned_[i] is set if buffer_[i] is written in place, see mutableSlot(),
+  // which is cleared on the source by copy() as well
+  mutable std::vector<uint8_t> owned_;
+  // split_offsets_[i] is the number of inner neighbors in buffer_[i]
+  std::vector<size_t> split_offsets_;
+  // split_stale_[i] is set if buffer_[i] is modified after its split point
+  // is computed
+  std::vector<uint8_t> split_stale_;
+  VID_T split_ivnum_;
+  // returns true if the neighbor is newly inserted
+  inline bool emplaceImpl(size_t loc, VID_T vid, const EDATA_T& edata,
+                          pending_map_t& pending, std::vector<size_t>& dirty) {
+    auto& nbrs = mutableSlot(loc);
+    auto iter = nbrs.find_sorted(vid);
+
+    if (iter == nbrs.end() && !nbrs.compacted()) {
+      auto pending_iter = pending.find(std::make_pair(loc, vid));
+      if (pending_iter != pending.end()) {
+        iter = nbrs.begin() + pending_iter->second;
+      }
+    }
+    if (iter != nbrs.end()) {
+      iter->update_data(edata);
+      return false;
+    }
 
-        split_buffer_[loc][idx][lid] = nbr;
+    bool was_compacted = nbrs.compacted();
+    nbrs.emplace_back(NbrT(vid, edata));
+    if (!nbrs.compacted()) {
+      if (was_compacted) {
+        dirty.push_back(loc);
       }
+      pending.emplace(std::make_pair(loc, vid), nbrs.size() - 1);
     }
+    return true;
   }
 
- private:
-  std::vector<std::map<VID_T, NbrT>*> buffer_;
-  // split_buffer_[i][0] represents inner neighbors, split_buffer_[i][1]
-  // represents outer neighbors
-  std::vector<std::map<VID_T, NbrT>*> split_buffer_;
+  // <loc, vid> -> position of the not-yet-merged neighbor in buffer_[loc]
+  pending_map_t pending_;
+  // slots with a non-empty delta
+  std::vector<size_t> dirty_;
   size_t index_;
 };
+
+/**
+ * @brief Records the types of values observed for each property key, so that
+ * keys whose type is stable across the fragment can be materialized as typed
+ * columns.
+ */
+class PropertyTypeTracker {
+ public:
+  void Observe(const folly::dynamic& data) {
+    if (!data.isObject()) {
+      return;
+    }
+    for (auto& kv : data.items()) {
+      masks_[kv.first.asString()] |= typeBit(kv.second.type());
+    }
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+  IsCompatible(const std::string& key) const {
+    auto mask = getMask(key);
+    return mask != 0 && (mask & ~(typeBit(folly::dynamic::Type::INT64) |
+                                  typeBit(folly::dynamic::Type::DOUBLE))) == 0;
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value, bool>::type
+  IsCompatible(const std::string& key) const {
+    return getMask(key) == typeBit(folly::dynamic::Type::INT64);
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_same<T, std::string>::value, bool>::type
+  IsCompatible(const std::string& key) const {
+    return getMask(key) == typeBit(folly::dynamic::Type::STRING);
+  }
+
+  void Clear() { masks_.clear(); }
+
+  void Serialize(grape::InArchive& arc) const {
+    arc << masks_.size();
+    for (auto& pair : masks_) {
+      arc << pair.first << pair.second;
+    }
+  }
+
+  void Deserialize(grape::OutArchive& arc) {
+    size_t size;
+    arc >> size;
+    masks_.clear();
+    for (size_t i = 0; i < size; ++i) {
+      std::string key;
+      uint32_t mask;
+      arc >> key >> mask;
+      masks_.emplace(std::move(key), mask);
+    }
+  }
+
+ private:
+  static uint32_t typeBit(folly::dynamic::Type type) {
+    return 1u << static_cast<uint32_t>(type);
+  }
+
+  uint32_t getMask(const std::string& key) const {
+    auto iter = masks_.find(key);
+    return iter == masks_.end() ? 0 : iter->second;
+  }
+
+  std::map<std::string, uint32_t> masks_;
+};
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+unpack_value(const folly::dynamic& data, T& value) {
+  value = static_cast<T>(data.asDouble());
+  return true;
+}
+
+// an integer out of the range of T is left to the dynamic path rather than
+// narrowed
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, bool>::type
+unpack_value(const folly::dynamic& data, T& value) {
+  int64_t v = data.asInt();
+  if (v < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+      v > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+    return false;
+  }
+  value = static_cast<T>(v);
+  return true;
+}
+
+// returns false if the property is missing, or its value doesn't fit in T
+template <typename T>
+inline bool unpack_property(const folly::dynamic& data, const std::string& key,
+                            T& value) {
+  if (data.isObject()) {
+    auto iter = data.find(key);
+    if (iter != data.items().end()) {
+      return unpack_value<T>(iter->second, value);
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief A typed copy of one vertex property, indexed by the lid of inner
+ * vertices.
+ *
+ * @tparam T The type of the property
+ */
+template <typename T>
+class VertexColumn {
+ public:
+  /**
+   * @return false if some vertex does not contain the property, or its value
+   * doesn't fit in T.
+   */
+  template <typename VDATA_T>
+  bool Build(const grape::Array<VDATA_T, grape::Allocator<VDATA_T>>& vdata,
+             const std::string& key) {
+    values_.resize(vdata.size());
+    for (size_t i = 0; i < vdata.size(); ++i) {
+      if (!unpack_property<T>(vdata[i], key, values_[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  inline const T& operator[](size_t lid) const { return values_[lid]; }
+
+  inline void Set(size_t lid, const T& value) { values_[lid] = value; }
+
+  inline const T* data() const { return values_.data(); }
+
+ private:
+  std::vector<T> values_;
+};
+
+/**
+ * @brief A string vertex property encoded by a dictionary, i.e., each vertex
+ * keeps the code of its value, so the repeated values, e.g., the labels or
+ * the categories, are stored once and compared by the codes.
+ *
+ * Set may be called by several threads at once on different vertices, e.g.,
+ * by DynamicProjectedFragment::SetData in a ForEach, and operator[] alongside.
+ * The new values are appended to the dictionary under a lock, into the chunks
+ * of the doubling sizes, so the strings already there are never moved and are
+ * read without the lock.
+ */
+template <>
+class VertexColumn<std::string> {
+  // chunk k holds the codes [2^k - 1, 2^(k + 1) - 1)
+  static constexpr int kChunkNum = 32;
+
+ public:
+  /**
+   * @return false if some vertex does not contain the property as a string.
+   */
+  template <typename VDATA_T>
+  bool Build(const grape::Array<VDATA_T, grape::Allocator<VDATA_T>>& vdata,
+             const std::string& key) {
+    codes_.resize(vdata.size());
+    for (auto& chunk : chunks_) {
+      chunk.reset();
+    }
+    size_ = 0;
+    index_.clear();
+    for (size_t i = 0; i < vdata.size(); ++i) {
+      if (!vdata[i].isObject()) {
+        return false;
+      }
+      auto iter = vdata[i].find(key);
+      if (iter == vdata[i].items().end() || !iter->second.isString()) {
+        return false;
+      }
+      codes_[i] = encode(iter->second.getString());
+    }
+    return true;
+  }
+
+  inline const std::string& operator[](size_t lid) const {
+    return entry(codes_[lid]);
+  }
+
+  inline void Set(size_t lid, const std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    codes_[lid] = encode(value);
+  }
+
+  // the codes of the vertices, equal values have the same code
+  inline const uint32_t* codes() const { return codes_.data(); }
+
+  // the number of the distinct values, i.e., the codes are below it
+  inline size_t dictionary_size() const { return size_; }
+
+ private:
+  static inline int chunkOf(uint32_t code) {
+    return 63 - __builtin_clzll(static_cast<uint64_t>(code) + 1);
+  }
+
+  inline const std::string& entry(uint32_t code) const {
+    int k = chunkOf(code);
+    return chunks_[k][code + 1 - (uint64_t(1) << k)];
+  }
+
+  uint32_t encode(const std::string& value) {
+    auto iter = index_.find(value);
+    if (iter != index_.end()) {
+      return iter->second;
+    }
+    uint32_t code = static_cast<uint32_t>(size_);
+    int k = chunkOf(code);
+    if (chunks_[k] == nullptr) {
+      chunks_[k].reset(new std::string[uint64_t(1) << k]);
+    }
+    chunks_[k][code + 1 - (uint64_t(1) << k)] = value;
+    ++size_;
+    index_.emplace(value, code);
+    return code;
+  }
+
+  std::vector<uint32_t> codes_;
+  std::array<std::unique_ptr<std::string[]>, kChunkNum> chunks_;
+  size_t size_ = 0;
+  ska::flat_hash_map<std::string, uint32_t> index_;
+  std::mutex mutex_;
+};
+
+/**
+ * @brief A typed copy of one edge property, laid out in the same order as the
+ * neighbors of NbrMapSpace, i.e., data(loc)[i] is the property of the i-th
+ * neighbor in slot loc.
+ *
+ * @tparam T The type of the property
+ */
+template <typename T>
+class EdgeColumn {
+ public:
+  /**
+   * @return false if some edge does not contain the property, or its value
+   * doesn't fit in T.
+   */
+  template <typename EDATA_T>
+  bool Build(const NbrMapSpace<EDATA_T>& space, const std::string& key) {
+    offsets_.resize(space.size() + 1);
+    offsets_[0] = 0;
+    for (size_t loc = 0; loc < space.size(); ++loc) {
+      offsets_[loc + 1] = offsets_[loc] + space[loc].size();
+    }
+    values_.resize(offsets_[space.size()]);
+    for (size_t loc = 0; loc < space.size(); ++loc) {
+      T* ptr = values_.data() + offsets_[loc];
+      for (auto& e : space[loc]) {
+        if (!unpack_property<T>(e.data(), key, *ptr++)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  inline const T* data(size_t loc) const {
+    return values_.data() + offsets_[loc];
+  }
+
+ private:
+  std::vector<T> values_;
+  std::vector<size_t> offsets_;
+};
+
+/**
+ * @brief Typed columns of a fragment, keyed by the property name.
+ *
+ * @tparam COLUMN_T VertexColumn or EdgeColumn
+ */
+template <template <typename> class COLUMN_T>
+class ColumnSet {
+ public:
+  std::map<std::string, COLUMN_T<int>>& columns(int*) { return int_columns_; }
+
+  std::map<std::string, COLUMN_T<int64_t>>& columns(int64_t*) {
+    return int64_columns_;
+  }
+
+  std::map<std::string, COLUMN_T<double>>& columns(double*) {
+    return double_columns_;
+  }
+
+  std::map<std::string, COLUMN_T<std::string>>& columns(std::string*) {
+    return string_columns_;
+  }
+
+  void Clear() {
+    int_columns_.clear();
+    int64_columns_.clear();
+    double_columns_.clear();
+    string_columns_.clear();
+  }
+
+ private:
+  std::map<std::string, COLUMN_T<int>> int_columns_;
+  std::map<std::string, COLUMN_T<int64_t>> int64_columns_;
+  std::map<std::string, COLUMN_T<double>> double_columns_;
+  std::map<std::string, COLUMN_T<std::string>> string_columns_;
+};
+
+/**
+ * @brief Appends the vertices [begin, begin + n) alive by the flags to out.
+ * Takes all of them at once when alive_num equals n, or otherwise tests the
+ * flags a word of 8 at a time, so the runs of the removed vertices are
+ * skipped by words. alive_num is a lower bound of the alive ones, as the
+ * vertices revived by the edges added are not counted.
+ */
+template <typename VID_T>
+void CollectAliveVertices(const bool* alive, VID_T begin, VID_T n,
+                          VID_T alive_num,
+                          std::vector<grape::Vertex<VID_T>>& out) {
+  out.reserve(out.size() + alive_num);
+  if (alive_num == n) {
+    for (VID_T i = 0; i < n; ++i) {
+      out.emplace_back(begin + i);
+    }
+    return;
+  }
+  const VID_T word_size = sizeof(uint64_t);
+  VID_T i = 0;
+  for (; i + word_size <= n; i += word_size) {
+    uint64_t word;
+    memcpy(&word, alive + i, word_size);
+    if (word == 0) {
+      continue;
+    }
+    for (VID_T j = i; j < i + word_size; ++j) {
+      if (alive[j]) {
+        out.emplace_back(begin + j);
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    if (alive[i]) {
+      out.emplace_back(begin + i);
+    }
+  }
+}
 }  // namespace dynamic_fragment_impl
 
+static constexpr const char* kDynamicFragmentSnapshotFormat =
+    "%s/dynamic_frag_%d.dat";
+static constexpr uint64_t kDynamicFragmentSnapshotMagic = 0x4753445946524147;
+static constexpr uint32_t kDynamicFragmentSnapshotVersion = 1;
+
 /**
  * @brief A mutable non-labeled fragment. The data attached with vertex or edge
  * are represented by folly::dynamic.
@@ -684,7 +1556,7 @@ class DynamicFragment {
   using internal_vertex_t = grape::internal::Vertex<vid_t, vdata_t>;
   using const_adj_list_t = dynamic_fragment_impl::ConstAdjList<edata_t>;
   using adj_list_t = dynamic_fragment_impl::AdjList<edata_t>;
-  using vertex_map_t = grape::GlobalVertexMap<oid_t, vid_t>;
+  using vertex_map_t = DynamicVertexMap<vid_t>;
   using partitioner_t = vineyard::HashPartitioner<oid_t>;
   using vertex_range_t = grape::VertexVector<vid_t>;
   template <typename DATA_T>
@@ -763,6 +1635,10 @@ class DynamicFragment {
 
     initOuterVerticesOfFragment();
 
+    vprop_types_.Clear();
+    eprop_types_.Clear();
+    observePropertyTypes(vertices, edges);
+
     vdata_.clear();
     vdata_.resize(ivnum_);
     if (sizeof(internal_vertex_t) > sizeof(vid_t)) {
@@ -786,20 +1662,64 @@ class DynamicFragment {
     Init(fid, empty_vertices, empty_edges, directed);
   }
 
+  /**
+   * @brief Sets the strategy to allocate the memory of the fragment, see
+   * MemoryStrategy, which is kept by the copies of the fragment.
+   */
+  void SetMemoryStrategy(const MemoryStrategy& strategy) {
+    memory_strategy_ = strategy;
+  }
+
+  const MemoryStrategy& memory_strategy() const { return memory_strategy_; }
+
   void CopyFrom(std::shared_ptr<DynamicFragment> other,
                 const std::string& copy_type = "identical") {
+    SetMemoryStrategy(other->memory_strategy_);
     directed_ = other->directed_;
     load_strategy_ = other->load_strategy_;
 
     copyVertices(other);
     copyEdges(other, copy_type);
+    vprop_types_ = other->vprop_types_;
+    eprop_types_ = other->eprop_types_;
 
     mirrors_of_frag_.resize(fnum_);
     InvalidCache();
   }
 
+  /**
+   * @brief A read-only copy of the fragment at the current epoch, on which
+   * the reads go on while ModifyEdges or ModifyVertices mutates the fragment.
+   * The copy shares the neighbors and the vertex map with the fragment, which
+   * are copied on write by the mutations, and only the vertices are copied.
+   *
+   * The copy is made by the first call of an epoch, and each mutation starts
+   * the next epoch when it is done, so the calls of an epoch share a copy,
+   * and a call during a mutation gets the copy of the last epoch, or waits
+   * for the mutation if there is none. The caches of the copy are built
+   * lazily, hence the readers of a copy are not concurrent with each other.
+   */
+  std::shared_ptr<DynamicFragment> Snapshot() {
+    std::unique_lock<std::mutex> lock(epoch_mutex_);
+    epoch_cv_.wait(lock,
+                   [this]() { return snapshot_ != nullptr || !mutating_; });
+    if (snapshot_ == nullptr) {
+      auto snapshot = std::make_shared<DynamicFragment>(vm_ptr_);
+      // not owned, the fragment outlives the copy
+      snapshot->CopyFrom(
+          std::shared_ptr<DynamicFragment>(std::shared_ptr<DynamicFragment>(),
+                                           this));
+      snapshot_ = snapshot;
+    }
+    return snapshot_;
+  }
+
+  // the number of the mutations done on the fragment
+  size_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
   // generate directed graph from orignal undirected graph.
   void ToDirectedFrom(std::shared_ptr<DynamicFragment> origin) {
+    SetMemoryStrategy(origin->memory_strategy_);
     // original graph must be undirected.
     assert(!origin->directed());
 
@@ -807,12 +1727,15 @@ class DynamicFragment {
     load_strategy_ = grape::LoadStrategy::kBothOutIn;
     copyVertices(origin);
     toDirectedEdges(origin);
+    vprop_types_ = origin->vprop_types_;
+    eprop_types_ = origin->eprop_types_;
     mirrors_of_frag_.resize(fnum_);
     InvalidCache();
   }
 
   // generate undirected graph from original directed graph.
   void ToUnDirectedFrom(std::shared_ptr<DynamicFragment> origin) {
+    SetMemoryStrategy(origin->memory_strategy_);
     // original graph must be directed.
     assert(origin->directed());
 
@@ -820,6 +1743,8 @@ class DynamicFragment {
     load_strategy_ = grape::LoadStrategy::kOnlyOut;
     copyVertices(origin);
     toUnDirectedEdges(origin);
+    vprop_types_ = origin->vprop_types_;
+    eprop_types_ = origin->eprop_types_;
     mirrors_of_frag_.resize(fnum_);
     InvalidCache();
   }
@@ -831,6 +1756,7 @@ class DynamicFragment {
       std::shared_ptr<DynamicFragment> origin,
       const std::unordered_set<oid_t>& induced_vertices,
       const std::vector<std::pair<oid_t, oid_t>>& induced_edges) {
+    SetMemoryStrategy(origin->memory_strategy_);
     // copy base elements
     directed_ = origin->directed();
     directed() ? load_strategy_ = grape::LoadStrategy::kBothOutIn
@@ -883,6 +1809,8 @@ class DynamicFragment {
 
     AddEdges(edges, load_strategy_);
     initOuterVerticesOfFragment();
+    vprop_types_ = origin->vprop_types_;
+    eprop_types_ = origin->eprop_types_;
   }
 
   void ClearGraph(std::shared_ptr<vertex_map_t> vm_ptr) {
@@ -905,6 +1833,7 @@ class DynamicFragment {
     inner_oe_pos_.resize(ivnum_, -1);
     inner_edge_space_.Clear();
     selfloops_vertices_.clear();
+    eprop_types_.Clear();
 
     ovnum_ = 0;
     tvnum_ = ivnum_;
@@ -917,11 +1846,215 @@ class DynamicFragment {
     InvalidCache();
   }
 
+  /**
+   * @brief Writes a snapshot of the fragment to prefix/dynamic_frag_<fid>.dat.
+   * The snapshot is self-contained, i.e., it contains a copy of the global
+   * vertex map, so that each worker can restore from its own file. Arrays of
+   * trivial types are written as raw bytes and restored by a single copy.
+   */
   template <typename IOADAPTOR_T>
-  void Serialize(const std::string& prefix) {}
+  void Serialize(const std::string& prefix) {
+    char fbuf[1024];
+    snprintf(fbuf, sizeof(fbuf), kDynamicFragmentSnapshotFormat,
+             prefix.c_str(), fid_);
+
+    auto io_adaptor =
+        std::unique_ptr<IOADAPTOR_T>(new IOADAPTOR_T(std::string(fbuf)));
+    io_adaptor->Open("wb");
+
+    grape::InArchive ia;
+    ia << kDynamicFragmentSnapshotMagic << kDynamicFragmentSnapshotVersion;
+    ia << fid_ << fnum_ << directed_ << static_cast<int>(load_strategy_);
+    ia << ivnum_ << ovnum_ << alive_ivnum_ << alive_ovnum_ << ienum_ << oenum_
+       << selfloops_num_;
+    CHECK(io_adaptor->WriteArchive(ia));
+    ia.Clear();
+
+    // vertex map
+    oid_t oid;
+    for (fid_t fid = 0; fid < fnum_; ++fid) {
+      vid_t fvnum = vm_ptr_->GetInnerVertexSize(fid);
+      ia << fvnum;
+      for (vid_t lid = 0; lid < fvnum; ++lid) {
+        CHECK(vm_ptr_->GetOid(fid, lid, oid));
+        dynamic_fragment_impl::SerializeDynamic(ia, oid);
+      }
+      CHECK(io_adaptor->WriteArchive(ia));
+      ia.Clear();
+    }
+
+    // vertices
+    dynamic_fragment_impl::SerializeArray(ia, ovgid_);
+    dynamic_fragment_impl::SerializeArray(ia, inner_vertex_alive_);
+    dynamic_fragment_impl::SerializeArray(ia, outer_vertex_alive_);
+    ia << static_cast<size_t>(vdata_.size());
+    for (auto& data : vdata_) {
+      dynamic_fragment_impl::SerializeDynamic(ia, data);
+    }
+    vprop_types_.Serialize(ia);
+    CHECK(io_adaptor->WriteArchive(ia));
+    ia.Clear();
+
+    // edges
+    dynamic_fragment_impl::SerializeArray(ia, inner_ie_pos_);
+    dynamic_fragment_impl::SerializeArray(ia, inner_oe_pos_);
+    inner_edge_space_.Serialize(ia);
+    ia << std::vector<vid_t>(selfloops_vertices_.begin(),
+                             selfloops_vertices_.end());
+    eprop_types_.Serialize(ia);
+    CHECK(io_adaptor->WriteArchive(ia));
+    ia.Clear();
+
+    CHECK(io_adaptor->Close());
+  }
 
+  /**
+   * @brief Checks prefix/dynamic_frag_<fid>.dat is a snapshot of the current
+   * version written by fnum fragments, as Deserialize() aborts otherwise,
+   * e.g., on a snapshot written by a cluster of another size, where the
+   * vertices are partitioned differently.
+   */
   template <typename IOADAPTOR_T>
-  void Deserialize(const std::string& prefix, const fid_t fid) {}
+  static bl::result<void> CheckSnapshot(const std::string& prefix,
+                                        const fid_t fid, const fid_t fnum) {
+    char fbuf[1024];
+    snprintf(fbuf, sizeof(fbuf), kDynamicFragmentSnapshotFormat,
+             prefix.c_str(), fid);
+
+    auto io_adaptor =
+        std::unique_ptr<IOADAPTOR_T>(new IOADAPTOR_T(std::string(fbuf)));
+    if (!io_adaptor->IsExist()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                      std::string("Snapshot not found: ") + fbuf);
+    }
+    io_adaptor->Open();
+    grape::OutArchive oa;
+    bool read = io_adaptor->ReadArchive(oa);
+    io_adaptor->Close();
+    if (!read) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                      std::string("Failed to read the snapshot: ") + fbuf);
+    }
+
+    uint64_t magic;
+    uint32_t version;
+    fid_t snapshot_fid, snapshot_fnum;
+    oa >> magic >> version;
+    if (magic != kDynamicFragmentSnapshotMagic) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      std::string("Not a snapshot of DynamicFragment: ") +
+                          fbuf);
+    }
+    if (version != kDynamicFragmentSnapshotVersion) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Unsupported snapshot version: " +
+                          std::to_string(version));
+    }
+    oa >> snapshot_fid >> snapshot_fnum;
+    if (snapshot_fid != fid || snapshot_fnum != fnum) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "The snapshot is written by fragment " +
+                          std::to_string(snapshot_fid) + " of " +
+                          std::to_string(snapshot_fnum) +
+                          ", but is restored to fragment " +
+                          std::to_string(fid) + " of " +
+                          std::to_string(fnum));
+    }
+    return {};
+  }
+
+  /**
+   * @brief Restores the fragment from a snapshot written by Serialize(). The
+   * vertex map of the fragment must be initialized and empty, it is filled
+   * with the vertex map in the snapshot.
+   */
+  template <typename IOADAPTOR_T>
+  void Deserialize(const std::string& prefix, const fid_t fid) {
+    char fbuf[1024];
+    snprintf(fbuf, sizeof(fbuf), kDynamicFragmentSnapshotFormat,
+             prefix.c_str(), fid);
+
+    auto io_adaptor =
+        std::unique_ptr<IOADAPTOR_T>(new IOADAPTOR_T(std::string(fbuf)));
+    io_adaptor->Open();
+
+    grape::OutArchive oa;
+    CHECK(io_adaptor->ReadArchive(oa));
+    uint64_t magic;
+    uint32_t version;
+    int load_strategy;
+    oa >> magic >> version;
+    CHECK_EQ(magic, kDynamicFragmentSnapshotMagic)
+        << "Not a snapshot of DynamicFragment: " << fbuf;
+    CHECK_EQ(version, kDynamicFragmentSnapshotVersion)
+        << "Unsupported snapshot version: " << version;
+    oa >> fid_ >> fnum_ >> directed_ >> load_strategy;
+    oa >> ivnum_ >> ovnum_ >> alive_ivnum_ >> alive_ovnum_ >> ienum_ >>
+        oenum_ >> selfloops_num_;
+    oa.Clear();
+    CHECK_EQ(fid_, fid);
+    CHECK_EQ(fnum_, vm_ptr_->GetFragmentNum())
+        << "The snapshot is written by " << fnum_ << " fragments";
+    load_strategy_ = static_cast<grape::LoadStrategy>(load_strategy);
+    calcFidBitWidth(fnum_, id_mask_, fid_offset_);
+    tvnum_ = ivnum_ + ovnum_;
+
+    // vertex map
+    oid_t oid;
+    vid_t gid;
+    for (fid_t i = 0; i < fnum_; ++i) {
+      CHECK(io_adaptor->ReadArchive(oa));
+      vid_t fvnum;
+      oa >> fvnum;
+      for (vid_t lid = 0; lid < fvnum; ++lid) {
+        dynamic_fragment_impl::DeserializeDynamic(oa, oid);
+        CHECK(vm_ptr_->AddVertex(i, oid, gid));
+      }
+      oa.Clear();
+    }
+    CHECK_EQ(ivnum_, vm_ptr_->GetInnerVertexSize(fid_));
+
+    // vertices
+    CHECK(io_adaptor->ReadArchive(oa));
+    dynamic_fragment_impl::DeserializeArray(oa, ovgid_);
+    dynamic_fragment_impl::DeserializeArray(oa, inner_vertex_alive_);
+    dynamic_fragment_impl::DeserializeArray(oa, outer_vertex_alive_);
+    size_t vdata_size;
+    oa >> vdata_size;
+    vdata_.clear();
+    vdata_.resize(vdata_size);
+    for (auto& data : vdata_) {
+      dynamic_fragment_impl::DeserializeDynamic(oa, data);
+    }
+    vprop_types_.Deserialize(oa);
+    oa.Clear();
+
+    ovg2i_.clear();
+    ovg2i_.reserve(ovnum_);
+    for (vid_t i = 0; i < ovnum_; ++i) {
+      ovg2i_.emplace(ovgid_[i], i);
+    }
+
+    // edges
+    CHECK(io_adaptor->ReadArchive(oa));
+    dynamic_fragment_impl::DeserializeArray(oa, inner_ie_pos_);
+    dynamic_fragment_impl::DeserializeArray(oa, inner_oe_pos_);
+    inner_edge_space_.Deserialize(oa);
+    std::vector<vid_t> selfloops_vertices;
+    oa >> selfloops_vertices;
+    selfloops_vertices_.clear();
+    selfloops_vertices_.insert(selfloops_vertices.begin(),
+                               selfloops_vertices.end());
+    eprop_types_.Deserialize(oa);
+    oa.Clear();
+
+    CHECK(io_adaptor->Close());
+
+    initOuterVerticesOfFragment();
+    mirrors_of_frag_.clear();
+    mirrors_of_frag_.resize(fnum_);
+    InvalidCache();
+  }
 
   virtual void PrepareToRunApp(grape::MessageStrategy strategy,
                                bool need_split_edges) {
@@ -932,19 +2065,25 @@ class DynamicFragment {
       initMessageDestination(strategy);
     }
 
-    // a naive implementation by copy edges
+    inner_edge_space_.Compact();
     if (need_split_edges) {
       inner_edge_space_.BuildSplitEdges(ivnum_);
     }
+    if (memory_strategy_.huge_pages) {
+      adviseHugePages();
+    }
   }
 
-  inline virtual fid_t fid() const { return fid_; }
+  // The accessors below, independent of the views, read the states of core_
+  // rather than being virtual, so they are inlined into the inner loops of
+  // the apps, over both the fragments and the views.
+  inline fid_t fid() const { return core_->fid_; }
 
-  inline virtual fid_t fnum() const { return fnum_; }
+  inline fid_t fnum() const { return core_->fnum_; }
 
-  inline virtual vid_t id_mask() const { return id_mask_; }
+  inline vid_t id_mask() const { return core_->id_mask_; }
 
-  inline virtual int fid_offset() const { return fid_offset_; }
+  inline int fid_offset() const { return core_->fid_offset_; }
 
   inline virtual bool directed() const { return directed_; }
 
@@ -965,18 +2104,16 @@ class DynamicFragment {
   }
 
   inline virtual vertex_range_t InnerVertices() const {
-    auto inner_vertices = grape::VertexRange<vid_t>(0, ivnum_);
     auto& mutable_vertices =
         const_cast<DynamicFragment*>(this)->alive_inner_vertices_;
 
     if (!mutable_vertices.first) {
       mutable_vertices.second.clear();
       mutable_vertices.first = true;
-
-      for (auto v : inner_vertices) {
-        if (IsAliveInnerVertex(v)) {
-          mutable_vertices.second.push_back(v);
-        }
+      if (ivnum_ != 0) {
+        dynamic_fragment_impl::CollectAliveVertices(
+            &inner_vertex_alive_[0], static_cast<vid_t>(0), ivnum_,
+            alive_ivnum_, mutable_vertices.second);
       }
     }
 
@@ -984,18 +2121,16 @@ class DynamicFragment {
   }
 
   inline virtual vertex_range_t OuterVertices() const {
-    auto outer_vertices = grape::VertexRange<vid_t>(ivnum_, tvnum_);
     auto& mutable_vertices =
         const_cast<DynamicFragment*>(this)->alive_outer_vertices_;
 
     if (!mutable_vertices.first) {
       mutable_vertices.second.clear();
       mutable_vertices.first = true;
-
-      for (auto v : outer_vertices) {
-        if (IsAliveOuterVertex(v)) {
-          mutable_vertices.second.push_back(v);
-        }
+      if (ovnum_ != 0) {
+        dynamic_fragment_impl::CollectAliveVertices(
+            &outer_vertex_alive_[0], ivnum_, ovnum_, alive_ovnum_,
+            mutable_vertices.second);
       }
     }
 
@@ -1003,19 +2138,25 @@ class DynamicFragment {
   }
 
   inline virtual vertex_range_t Vertices() const {
-    auto vertices = grape::VertexRange<vid_t>(0, tvnum_);
     auto& mutable_vertices =
         const_cast<DynamicFragment*>(this)->alive_vertices_;
 
     if (!mutable_vertices.first) {
+      // the inner vertices precede the outer ones by the lids
+      InnerVertices();
+      OuterVertices();
+      auto& inner_vertices = alive_inner_vertices_.second;
+      auto& outer_vertices = alive_outer_vertices_.second;
       mutable_vertices.second.clear();
       mutable_vertices.first = true;
-
-      for (auto v : vertices) {
-        if (IsAliveVertex(v)) {
-          mutable_vertices.second.push_back(v);
-        }
-      }
+      mutable_vertices.second.reserve(inner_vertices.size() +
+                                      outer_vertices.size());
+      mutable_vertices.second.insert(mutable_vertices.second.end(),
+                                     inner_vertices.begin(),
+                                     inner_vertices.end());
+      mutable_vertices.second.insert(mutable_vertices.second.end(),
+                                     outer_vertices.begin(),
+                                     outer_vertices.end());
     }
 
     return vertex_range_t(mutable_vertices.second);
@@ -1035,20 +2176,25 @@ class DynamicFragment {
     return IsInnerVertex(v) ? GetInnerVertexId(v) : GetOuterVertexId(v);
   }
 
-  inline virtual fid_t GetFragId(const vertex_t& u) const {
-    return IsInnerVertex(u)
-               ? fid_
-               : (fid_t)(ovgid_[u.GetValue() - ivnum_] >> fid_offset_);
+  inline fid_t GetFragId(const vertex_t& u) const {
+    auto core = core_;
+    if (IsInnerVertex(u)) {
+      return core->fid_;
+    }
+    return (fid_t)(core->ovgid_[u.GetValue() - core->ivnum_] >>
+                   core->fid_offset_);
   }
 
-  inline virtual const vdata_t& GetData(const vertex_t& v) const {
+  inline const vdata_t& GetData(const vertex_t& v) const {
     assert(IsInnerVertex(v));
-    return vdata_[v.GetValue()];
+    return core_->vdata_[v.GetValue()];
   }
 
   inline virtual void SetData(const vertex_t& v, const vdata_t& val) {
     assert(IsInnerVertex(v));
     vdata_[v.GetValue()] = val;
+    vprop_types_.Observe(val);
+    vertex_columns_.Clear();
   }
 
   inline virtual bool HasChild(const vertex_t& v) const {
@@ -1075,12 +2221,13 @@ class DynamicFragment {
     return pos == -1 ? 0 : inner_edge_space_[pos].size();
   }
 
-  inline virtual bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
-    return ((gid >> fid_offset_) == fid_) ? InnerVertexGid2Vertex(gid, v)
-                                          : OuterVertexGid2Vertex(gid, v);
+  inline bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
+    return ((gid >> core_->fid_offset_) == core_->fid_)
+               ? InnerVertexGid2Vertex(gid, v)
+               : OuterVertexGid2Vertex(gid, v);
   }
 
-  inline virtual vid_t Vertex2Gid(const vertex_t& v) const {
+  inline vid_t Vertex2Gid(const vertex_t& v) const {
     return IsInnerVertex(v) ? GetInnerVertexGid(v) : GetOuterVertexGid(v);
   }
 
@@ -1088,12 +2235,12 @@ class DynamicFragment {
 
   inline virtual vid_t GetOuterVerticesNum() const { return alive_ovnum_; }
 
-  inline virtual bool IsInnerVertex(const vertex_t& v) const {
-    return (v.GetValue() < ivnum_);
+  inline bool IsInnerVertex(const vertex_t& v) const {
+    return (v.GetValue() < core_->ivnum_);
   }
 
-  inline virtual bool IsOuterVertex(const vertex_t& v) const {
-    return v.GetValue() < tvnum_ && v.GetValue() >= ivnum_;
+  inline bool IsOuterVertex(const vertex_t& v) const {
+    return v.GetValue() < core_->tvnum_ && v.GetValue() >= core_->ivnum_;
   }
 
   inline virtual bool GetInnerVertex(const oid_t& oid, vertex_t& v) const {
@@ -1160,35 +2307,34 @@ class DynamicFragment {
     }
   }
 
-  inline virtual bool InnerVertexGid2Vertex(const vid_t& gid,
-                                            vertex_t& v) const {
-    vid_t lid = gid & id_mask_;
-    if (lid < ivnum_ && isAlive(lid)) {
-      assert(isAlive(lid));
-      v.SetValue(gid & id_mask_);
+  inline bool InnerVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    auto core = core_;
+    vid_t lid = gid & core->id_mask_;
+    if (lid < core->ivnum_ && core->isAlive(lid)) {
+      v.SetValue(lid);
       return true;
     }
     return false;
   }
 
-  inline virtual bool OuterVertexGid2Vertex(const vid_t& gid,
-                                            vertex_t& v) const {
-    auto iter = ovg2i_.find(gid);
-    if (iter != ovg2i_.end()) {
-      assert(isAlive(ivnum_ + iter->second));
-      v.SetValue(ivnum_ + iter->second);
+  inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
+    auto core = core_;
+    auto iter = core->ovg2i_.find(gid);
+    if (iter != core->ovg2i_.end()) {
+      assert(core->isAlive(core->ivnum_ + iter->second));
+      v.SetValue(core->ivnum_ + iter->second);
       return true;
     } else {
       return false;
     }
   }
 
-  inline virtual vid_t GetOuterVertexGid(const vertex_t& v) const {
-    return ovgid_[v.GetValue() - ivnum_];
+  inline vid_t GetOuterVertexGid(const vertex_t& v) const {
+    return core_->ovgid_[v.GetValue() - core_->ivnum_];
   }
 
-  inline virtual vid_t GetInnerVertexGid(const vertex_t& v) const {
-    return (v.GetValue() | ((vid_t) fid_ << fid_offset_));
+  inline vid_t GetInnerVertexGid(const vertex_t& v) const {
+    return (v.GetValue() | ((vid_t) core_->fid_ << core_->fid_offset_));
   }
 
   /**
@@ -1412,35 +2558,12 @@ class DynamicFragment {
 
   inline virtual bool HasNode(const oid_t& node) const {
     vid_t gid;
-    return vm_ptr_->GetGid(fid_, node, gid) && isAlive(gid & id_mask_);
-  }
-
-  inline virtual bool HasEdge(const oid_t& u, const oid_t& v) {
-    vid_t uid, vid;
-    if (Oid2Gid(u, uid) && Oid2Gid(v, vid)) {
-      vid_t ulid, vlid;
-      if ((uid >> fid_offset_) == fid_ && Gid2Lid(uid, ulid) &&
-          Gid2Lid(vid, vlid) && isAlive(ulid)) {
-        auto pos = inner_oe_pos_[ulid];
-        if (pos != -1) {
-          auto& oe = inner_edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
-            return true;
-          }
-        }
-      } else if ((vid >> fid_offset_) == fid_ && Gid2Lid(uid, ulid) &&
-                 Gid2Lid(vid, vlid) && isAlive(vlid)) {
-        int32_t pos;
-        directed() ? pos = inner_ie_pos_[vlid] : pos = inner_oe_pos_[vlid];
-        if (pos != -1) {
-          auto& es = inner_edge_space_[pos];
-          if (es.find(ulid) != es.end()) {
-            return true;
-          }
-        }
-      }
-    }
-    return false;
+    return vm_ptr_->GetGid(fid_, node, gid) && isAlive(gid & id_mask_);
+  }
+
+  inline virtual bool HasEdge(const oid_t& u, const oid_t& v) {
+    vid_t uid, vid;
+    return Oid2Gid(u, uid) && Oid2Gid(v, vid) && hasEdge(uid, vid);
   }
 
   inline virtual bool GetVertexData(const oid_t& oid, std::string& ret) const {
@@ -1462,8 +2585,9 @@ class DynamicFragment {
         auto pos = inner_oe_pos_[ulid];
         if (pos != -1) {
           auto& oe = inner_edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
-            ret = folly::toJson(oe[vlid].data());
+          auto iter = oe.find(vlid);
+          if (iter != oe.end()) {
+            ret = folly::toJson(iter->data());
             return true;
           }
         }
@@ -1481,8 +2605,9 @@ class DynamicFragment {
         auto pos = inner_oe_pos_[ulid];
         if (pos != -1) {
           auto& oe = inner_edge_space_[pos];
-          if (oe.find(vlid) != oe.end()) {
-            data = oe[vlid].data();
+          auto iter = oe.find(vlid);
+          if (iter != oe.end()) {
+            data = iter->data();
             return true;
           }
         }
@@ -1492,8 +2617,9 @@ class DynamicFragment {
         directed() ? pos = inner_ie_pos_[vlid] : pos = inner_oe_pos_[vlid];
         if (pos != -1) {
           auto& es = inner_edge_space_[pos];
-          if (es.find(ulid) != es.end()) {
-            data = es[ulid].data();
+          auto iter = es.find(ulid);
+          if (iter != es.end()) {
+            data = iter->data();
             return true;
           }
         }
@@ -1504,56 +2630,79 @@ class DynamicFragment {
 
   void ModifyEdges(const std::vector<std::string>& edges_to_modify,
                    const rpc::ModifyType modify_type) {
+    std::vector<oid_t> srcs, dsts;
+    std::vector<edata_t> edatas;
+    ParseEdgeLines(edges_to_modify, srcs, dsts, edatas);
+    ModifyEdges(srcs, dsts, edatas, modify_type);
+  }
+
+  /**
+   * @brief Modifies a batch of parsed edges, the i-th edge is
+   * srcs[i] -> dsts[i] with edatas[i]. The edges are partitioned and mapped to
+   * gids by multiple threads.
+   */
+  void ModifyEdges(const std::vector<oid_t>& srcs,
+                   const std::vector<oid_t>& dsts,
+                   const std::vector<edata_t>& edatas,
+                   const rpc::ModifyType modify_type) {
+    EpochGuard guard(this);
     std::vector<internal_vertex_t> vertices;
     std::vector<edge_t> edges;
+    size_t edge_num = srcs.size();
 
-    edges.reserve(edges_to_modify.size());
-    InvalidCache();
+    edges.reserve(edge_num);
+    clearCaches();
+
+    std::vector<fid_t> src_fids(edge_num), dst_fids(edge_num);
+    std::vector<vid_t> src_gids(edge_num), dst_gids(edge_num);
     {
-      edata_t e_data = folly::dynamic::object;
-      vdata_t fake_data = folly::dynamic::object;
-      oid_t src, dst;
-      vid_t src_gid, dst_gid;
-      fid_t src_fid, dst_fid;
       partitioner_t partitioner;
       partitioner.Init(fnum_);
-      auto line_parser_ptr = std::make_unique<DynamicLineParser>();
-      for (auto& line : edges_to_modify) {
-        if (line.empty() || line[0] == '#') {
-          continue;
-        }
-        try {
-          line_parser_ptr->LineParserForEFile(line, src, dst, e_data);
-        } catch (std::exception& e) {
-          LOG(ERROR) << e.what() << " line: " << line;
-          continue;
+      parallel_for(0, edge_num, [&](size_t i) {
+        src_fids[i] = partitioner.GetPartitionId(srcs[i]);
+        dst_fids[i] = partitioner.GetPartitionId(dsts[i]);
+      });
+      const fid_t* fids[] = {src_fids.data(), dst_fids.data()};
+      const oid_t* oids[] = {srcs.data(), dsts.data()};
+      vid_t* gids[] = {src_gids.data(), dst_gids.data()};
+      mapVertices(edge_num, 2, fids, oids, gids,
+                  modify_type == rpc::NX_ADD_EDGES);
+    }
+
+    vdata_t fake_data = folly::dynamic::object;
+    for (size_t i = 0; i < edge_num; ++i) {
+      vid_t src_gid = src_gids[i], dst_gid = dst_gids[i];
+      fid_t src_fid = src_fids[i], dst_fid = dst_fids[i];
+      if (src_gid == invalid_vid || dst_gid == invalid_vid) {
+        continue;
+      }
+      if (modify_type == rpc::NX_ADD_EDGES) {
+        if (src_fid == fid_) {
+          vertices.emplace_back(src_gid, fake_data);
         }
-        src_fid = partitioner.GetPartitionId(src);
-        dst_fid = partitioner.GetPartitionId(dst);
-        if (modify_type == rpc::NX_ADD_EDGES) {
-          vm_ptr_->AddVertex(src_fid, src, src_gid);
-          vm_ptr_->AddVertex(dst_fid, dst, dst_gid);
-          if (src_fid == fid_) {
-            vertices.emplace_back(src_gid, fake_data);
-          }
-          if (dst_fid == fid_) {
-            vertices.emplace_back(dst_gid, fake_data);
-          }
-        } else {
-          if (!vm_ptr_->GetGid(src_fid, src, src_gid) ||
-              !vm_ptr_->GetGid(dst_fid, dst, dst_gid)) {
-            continue;
-          }
+        if (dst_fid == fid_) {
+          vertices.emplace_back(dst_gid, fake_data);
         }
-        if (src_fid == fid_ || dst_fid == fid_) {
-          edges.emplace_back(src_gid, dst_gid, e_data);
-          if (!directed_ && src_gid != dst_gid) {
-            edges.emplace_back(dst_gid, src_gid, e_data);
-          }
+      }
+      if (src_fid == fid_ || dst_fid == fid_) {
+        edges.emplace_back(src_gid, dst_gid, edatas[i]);
+        if (!directed_ && src_gid != dst_gid) {
+          edges.emplace_back(dst_gid, src_gid, edatas[i]);
         }
       }
     }
 
+    // new edges are logged, the ones modifying the existing edges are not
+    // monotone, e.g., to the distances
+    if (modify_type == rpc::NX_ADD_EDGES &&
+        std::none_of(edges.begin(), edges.end(), [this](const edge_t& e) {
+          return hasEdge(e.src(), e.dst());
+        })) {
+      mutation_log_.AddEdges(edges);
+    } else {
+      mutation_log_.Reset();
+    }
+
     switch (modify_type) {
     case rpc::NX_ADD_EDGES:
       Insert(vertices, edges);
@@ -1571,42 +2720,57 @@ class DynamicFragment {
 
   void ModifyVertices(const std::vector<std::string>& vertices_to_modify,
                       const rpc::ModifyType& modify_type) {
+    std::vector<oid_t> oids;
+    std::vector<vdata_t> vdatas;
+    ParseVertexLines(vertices_to_modify, oids, vdatas);
+    ModifyVertices(oids, vdatas, modify_type);
+  }
+
+  /**
+   * @brief Modifies a batch of parsed vertices, the i-th vertex is oids[i]
+   * with vdatas[i]. The vertices are partitioned and mapped to gids by
+   * multiple threads.
+   */
+  void ModifyVertices(const std::vector<oid_t>& oids,
+                      const std::vector<vdata_t>& vdatas,
+                      const rpc::ModifyType& modify_type) {
+    EpochGuard guard(this);
     std::vector<internal_vertex_t> vertices;
     std::vector<edge_t> empty_edges;
+    size_t vertex_num = oids.size();
 
-    vertices.reserve(vertices_to_modify.size());
-    InvalidCache();
+    vertices.reserve(vertex_num);
+    clearCaches();
+    if (modify_type == rpc::NX_ADD_NODES) {
+      mutation_log_.AddEdges(empty_edges);
+    } else {
+      mutation_log_.Reset();
+    }
+
+    std::vector<fid_t> fids(vertex_num);
+    std::vector<vid_t> gids(vertex_num);
     {
       partitioner_t partitioner;
       partitioner.Init(fnum_);
-      oid_t oid;
-      vid_t gid;
-      vdata_t v_data = folly::dynamic::object;
-      fid_t v_fid;
-      auto line_parser_ptr = std::make_unique<DynamicLineParser>();
-      for (auto& line : vertices_to_modify) {
-        if (line.empty() || line[0] == '#') {
-          continue;
-        }
-        try {
-          line_parser_ptr->LineParserForVFile(line, oid, v_data);
-        } catch (std::exception& e) {
-          LOG(ERROR) << e.what();
-          continue;
-        }
-        v_fid = partitioner.GetPartitionId(oid);
-        if (modify_type == rpc::NX_ADD_NODES) {
-          vm_ptr_->AddVertex(v_fid, oid, gid);
-        } else {
-          // UPDATE or DELETE, if not exist the node, continue.
-          if (!vm_ptr_->GetGid(v_fid, oid, gid)) {
-            continue;
-          }
-        }
-        if (v_fid == fid_ || (modify_type == rpc::NX_DEL_NODES &&
+      parallel_for(0, vertex_num, [&](size_t i) {
+        fids[i] = partitioner.GetPartitionId(oids[i]);
+      });
+      // UPDATE or DELETE, if not exist the node, the gid is invalid.
+      const fid_t* fids_column = fids.data();
+      const oid_t* oids_column = oids.data();
+      vid_t* gids_column = gids.data();
+      mapVertices(vertex_num, 1, &fids_column, &oids_column, &gids_column,
+                  modify_type == rpc::NX_ADD_NODES);
+    }
+
+    for (size_t i = 0; i < vertex_num; ++i) {
+      vid_t gid = gids[i];
+      if (gid == invalid_vid) {
+        continue;
+      }
+      if (fids[i] == fid_ || (modify_type == rpc::NX_DEL_NODES &&
                               ovg2i_.find(gid) != ovg2i_.end())) {
-          vertices.emplace_back(gid, v_data);
-        }
+        vertices.emplace_back(gid, vdatas[i]);
       }
     }
     if (vertices.empty())
@@ -1627,6 +2791,71 @@ class DynamicFragment {
     }
   }
 
+  /**
+   * @brief Returns the typed column of a vertex property, which is
+   * materialized on the first call and dropped once the fragment is mutated.
+   *
+   * @return nullptr if the values of the property are not all of type T, or
+   * some vertex does not contain the property, or some value doesn't fit in
+   * T. A string property is encoded by a dictionary.
+   */
+  template <typename T>
+  dynamic_fragment_impl::VertexColumn<T>* GetVertexColumn(
+      const std::string& key) {
+    if (core_ != this) {
+      return core_->GetVertexColumn<T>(key);
+    }
+    if (!vprop_types_.IsCompatible<T>(key)) {
+      return nullptr;
+    }
+    auto& columns = vertex_columns_.columns(static_cast<T*>(nullptr));
+    auto iter = columns.find(key);
+    if (iter == columns.end()) {
+      // the string columns hold a lock, which is not movable
+      iter = columns
+                 .emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple())
+                 .first;
+      if (!iter->second.Build(vdata_, key)) {
+        columns.erase(iter);
+        return nullptr;
+      }
+    }
+    return &iter->second;
+  }
+
+  /**
+   * @brief Returns the typed column of an edge property, whose layout follows
+   * inner_ie_pos_/inner_oe_pos_ and the order of the adjacent lists. The
+   * column is materialized on the first call and dropped once the fragment is
+   * mutated.
+   *
+   * @return nullptr if the values of the property are not all of type T, or
+   * some edge does not contain the property, or some value doesn't fit in T.
+   */
+  template <typename T>
+  dynamic_fragment_impl::EdgeColumn<T>* GetEdgeColumn(const std::string& key) {
+    if (core_ != this) {
+      // the views share the edge space, and so the columns, of the fragment
+      return core_->GetEdgeColumn<T>(key);
+    }
+    if (!eprop_types_.IsCompatible<T>(key)) {
+      return nullptr;
+    }
+    auto& columns = edge_columns_.columns(static_cast<T*>(nullptr));
+    auto iter = columns.find(key);
+    if (iter == columns.end()) {
+      inner_edge_space_.Compact();
+      iter =
+          columns.emplace(key, dynamic_fragment_impl::EdgeColumn<T>()).first;
+      if (!iter->second.Build(inner_edge_space_, key)) {
+        columns.erase(iter);
+        return nullptr;
+      }
+    }
+    return &iter->second;
+  }
+
   /**
    * Collect property keys and types for existed vertices
    *
@@ -1677,8 +2906,7 @@ class DynamicFragment {
                             size_t edge_pos) -> bl::result<void> {
       auto& adj_list = inner_edge_space_[edge_pos];
 
-      for (auto& e : adj_list) {
-        auto& nbr = e.second;
+      for (auto& nbr : adj_list) {
         auto data = nbr.data();
 
         CHECK(data.isObject());
@@ -1778,18 +3006,24 @@ class DynamicFragment {
 
   std::shared_ptr<vertex_map_t> GetVertexMap() { return vm_ptr_; }
 
-  inline virtual bool IsAliveVertex(const vertex_t& v) const {
+  // the log of the edges added since the last rebuilding of the fragment
+  const MutationLog<vid_t>& mutation_log() const { return mutation_log_; }
+
+  // the key of the projection, by which the results of the apps are resumed
+  std::string projection_key() const { return ""; }
+
+  inline bool IsAliveVertex(const vertex_t& v) const {
     return IsInnerVertex(v) ? IsAliveInnerVertex(v) : IsAliveOuterVertex(v);
   }
 
-  inline virtual bool IsAliveInnerVertex(const vertex_t& v) const {
+  inline bool IsAliveInnerVertex(const vertex_t& v) const {
     assert(IsInnerVertex(v));
-    return inner_vertex_alive_[v.GetValue()];
+    return core_->inner_vertex_alive_[v.GetValue()];
   }
 
-  inline virtual bool IsAliveOuterVertex(const vertex_t& v) const {
+  inline bool IsAliveOuterVertex(const vertex_t& v) const {
     assert(IsOuterVertex(v));
-    return outer_vertex_alive_[v.GetValue() - ivnum_];
+    return core_->outer_vertex_alive_[v.GetValue() - core_->ivnum_];
   }
 
  private:
@@ -1820,14 +3054,113 @@ class DynamicFragment {
     return false;
   }
 
-  void InvalidCache() {
+  inline bool hasEdge(vid_t uid, vid_t vid) {
+    vid_t ulid, vlid;
+    if ((uid >> fid_offset_) == fid_ && Gid2Lid(uid, ulid) &&
+        Gid2Lid(vid, vlid) && isAlive(ulid)) {
+      auto pos = inner_oe_pos_[ulid];
+      if (pos != -1) {
+        auto& oe = inner_edge_space_[pos];
+        if (oe.find(vlid) != oe.end()) {
+          return true;
+        }
+      }
+    } else if ((vid >> fid_offset_) == fid_ && Gid2Lid(uid, ulid) &&
+               Gid2Lid(vid, vlid) && isAlive(vlid)) {
+      int32_t pos;
+      directed() ? pos = inner_ie_pos_[vlid] : pos = inner_oe_pos_[vlid];
+      if (pos != -1) {
+        auto& es = inner_edge_space_[pos];
+        if (es.find(ulid) != es.end()) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void clearCaches() {
     alive_inner_vertices_.first = false;
     alive_outer_vertices_.first = false;
     alive_vertices_.first = false;
+    vertex_columns_.Clear();
+    edge_columns_.Clear();
+  }
+
+  // the fragment is rebuilt, which can not be resumed from by the apps
+  void InvalidCache() {
+    clearCaches();
+    mutation_log_.Reset();
+  }
+
+  // the arrays may be reallocated by the mutations, so they are advised
+  // before running the apps
+  void adviseHugePages() {
+    AdviseHugePages(vdata_.data(), vdata_.size() * sizeof(vdata_t));
+    AdviseHugePages(ovgid_.data(), ovgid_.size() * sizeof(vid_t));
+    AdviseHugePages(inner_ie_pos_.data(),
+                    inner_ie_pos_.size() * sizeof(int32_t));
+    AdviseHugePages(inner_oe_pos_.data(),
+                    inner_oe_pos_.size() * sizeof(int32_t));
+    inner_edge_space_.AdviseHugePages();
+  }
+
+  // The vertex map is shared by the fragments derived from each other, e.g.,
+  // by CopyGraph, as no vertex is removed from it. A fragment copies the map
+  // before adding vertices to it if it is still shared, where the copy takes
+  // the hash tables as they are, instead of inserting the oids again.
+  void detachVertexMap() {
+    if (vm_ptr_.use_count() > 1) {
+      vm_ptr_ = std::make_shared<vertex_map_t>(*vm_ptr_);
+    }
+  }
+
+  /**
+   * Maps the oids of column_num id columns to gids, e.g., the src and dst
+   * columns of edges. Missing vertices are added to the vertex map if
+   * add_vertex is true, otherwise their gids are set to invalid_vid. The
+   * vertex map can be mutated concurrently on distinct fragments, so the oids
+   * are bucketed by their fids once, each fid is owned by a single thread, and
+   * each thread visits the oids in the row-major order to keep the gids
+   * identical across workers.
+   */
+  void mapVertices(size_t row_num, size_t column_num, const fid_t* const* fids,
+                   const oid_t* const* oids, vid_t* const* gids,
+                   bool add_vertex) {
+    if (add_vertex) {
+      detachVertexMap();
+    }
+    size_t n = row_num * column_num;
+    size_t thread_num =
+        std::min<size_t>(fnum_, parallel_thread_num(n, kParallelGrainSize));
+    parallel_for_by_key(
+        n, thread_num,
+        [&](size_t j) { return fids[j % column_num][j / column_num]; },
+        [&](size_t, size_t j) {
+          size_t i = j / column_num, k = j % column_num;
+          vid_t gid;
+          if (add_vertex) {
+            vm_ptr_->AddVertex(fids[k][i], oids[k][i], gid);
+          } else if (!vm_ptr_->GetGid(fids[k][i], oids[k][i], gid)) {
+            gid = invalid_vid;
+          }
+          gids[k][i] = gid;
+        });
+  }
+
+  void observePropertyTypes(const std::vector<internal_vertex_t>& vertices,
+                            const std::vector<edge_t>& edges) {
+    for (auto& v : vertices) {
+      vprop_types_.Observe(v.vdata());
+    }
+    for (auto& e : edges) {
+      eprop_types_.Observe(e.edata());
+    }
   }
 
   void Insert(std::vector<internal_vertex_t>& vertices,
               std::vector<edge_t>& edges) {
+    observePropertyTypes(vertices, edges);
     std::vector<vid_t> outer_vertices =
         getOuterVerticesAndInvalidEdges(edges, load_strategy_);
     std::vector<vid_t> new_outer_vertices;
@@ -1878,65 +3211,33 @@ class DynamicFragment {
 
   void Update(std::vector<internal_vertex_t>& vertices,
               std::vector<edge_t>& edges) {
+    observePropertyTypes(vertices, edges);
     for (auto& v : vertices) {
       // the vertex exist
       vdata_[(v.vid() & id_mask_)] = v.vdata();
     }
 
-    switch (load_strategy_) {
-    case grape::LoadStrategy::kOnlyOut: {
-      for (auto& e : edges) {
-        vid_t dst;
-        if (!is_iv_gid(e.src()))
-          continue;
-        if (is_iv_gid(e.dst())) {
-          dst = iv_gid_to_lid(e.dst());
-        } else {
-          dst = ov_gid_to_lid(e.dst());
-        }
-        e.SetEndpoint(iv_gid_to_lid(e.src()), dst);
-        int pos = inner_oe_pos_[e.src()];
-        inner_edge_space_.set_data(pos, e.dst(), e.edata());
+    assert(load_strategy_ == grape::LoadStrategy::kOnlyOut ||
+           load_strategy_ == grape::LoadStrategy::kBothOutIn);
+    bool update_in = load_strategy_ == grape::LoadStrategy::kBothOutIn;
+    std::vector<batch_nbr_t> nbrs;
+    nbrs.reserve(edges.size());
+    for (auto& e : edges) {
+      bool src_inner = is_iv_gid(e.src()), dst_inner = is_iv_gid(e.dst());
+      if (!src_inner && !(update_in && dst_inner)) {
+        continue;
       }
-      break;
-    }
-    case grape::LoadStrategy::kBothOutIn: {
-      for (auto& e : edges) {
-        if (is_iv_gid(e.src()) && is_iv_gid(e.dst())) {
-          e.SetEndpoint(iv_gid_to_lid(e.src()), iv_gid_to_lid(e.dst()));
-          int pos = inner_oe_pos_[e.src()];
-          inner_edge_space_.set_data(pos, e.dst(), e.edata());
-          pos = inner_ie_pos_[e.dst()];
-          inner_edge_space_.set_data(pos, e.src(), e.edata());
-        } else if (is_iv_gid(e.src())) {
-          vid_t dst;
-          if (is_iv_gid(e.dst())) {
-            dst = iv_gid_to_lid(e.dst());
-          } else {
-            dst = ov_gid_to_lid(e.dst());
-          }
-          e.SetEndpoint(iv_gid_to_lid(e.src()), dst);
-          int pos = inner_oe_pos_[e.src()];
-          inner_edge_space_.set_data(pos, e.dst(), e.edata());
-        } else if (is_iv_gid(e.dst())) {
-          vid_t src;
-          if (is_iv_gid(e.src())) {
-            src = iv_gid_to_lid(e.src());
-          } else {
-            src = ov_gid_to_lid(e.src());
-          }
-          e.SetEndpoint(src, iv_gid_to_lid(e.dst()));
-          int pos = inner_ie_pos_[e.dst()];
-          inner_edge_space_.set_data(pos, e.src(), e.edata());
-        } else {
-          CHECK(false);
-        }
+      e.SetEndpoint(gid_to_lid(e.src()), gid_to_lid(e.dst()));
+      if (src_inner && inner_oe_pos_[e.src()] != -1) {
+        nbrs.push_back({static_cast<size_t>(inner_oe_pos_[e.src()]), e.dst(),
+                        &e.edata()});
+      }
+      if (update_in && dst_inner && inner_ie_pos_[e.dst()] != -1) {
+        nbrs.push_back({static_cast<size_t>(inner_ie_pos_[e.dst()]), e.src(),
+                        &e.edata()});
       }
-      break;
-    }
-    default:
-      assert(false);
     }
+    inner_edge_space_.BatchSetData(nbrs);
   }
 
   void Delete(
@@ -1987,10 +3288,10 @@ class DynamicFragment {
   void initOuterVerticesOfFragment() {
     outer_vertices_of_frag_.clear();
     outer_vertices_of_frag_.resize(fnum());
-    for (auto e : ovg2i_) {
-      auto gid = e.first;
-      auto idx = e.second;
-      auto fid = gid >> fid_offset_;
+    // ovgid_ is a dense array indexed by idx of outer vertex, which is much
+    // cheaper to traverse than ovg2i_.
+    for (vid_t idx = 0; idx < ovnum_; ++idx) {
+      auto fid = ovgid_[idx] >> fid_offset_;
 
       CHECK_NE(fid, fid_);
       // mapped gid -> ivnum_ + idx of outer vertex;
@@ -2047,97 +3348,97 @@ class DynamicFragment {
     return outer_vertices;
   }
 
+  /**
+   * Converts the endpoints of edges to lids and inserts them into the edge
+   * space. The conversion and the insertion are done by multiple threads, the
+   * latter dispatches the neighbors to threads by their slots.
+   */
   void AddEdges(std::vector<edge_t>& edges, grape::LoadStrategy strategy) {
-    switch (strategy) {
-    case grape::LoadStrategy::kOnlyIn: {
-      for (auto& e : edges) {
-        if (e.src() != invalid_vid && is_iv_gid(e.dst())) {
-          vid_t src;
-          if (is_iv_gid(e.src())) {
-            src = iv_gid_to_lid(e.src());
-          } else {
-            src = ov_gid_to_lid(e.src());
-          }
-          e.SetEndpoint(src, iv_gid_to_lid(e.dst()));
+    bool add_in = strategy == grape::LoadStrategy::kOnlyIn ||
+                  strategy == grape::LoadStrategy::kBothOutIn;
+    bool add_out = strategy == grape::LoadStrategy::kOnlyOut ||
+                   strategy == grape::LoadStrategy::kBothOutIn;
+    std::vector<uint8_t> kinds(edges.size(), 0);
+
+    parallel_for(0, edges.size(), [&](size_t i) {
+      auto& e = edges[i];
+      if (e.src() == invalid_vid) {
+        return;
+      }
+      bool src_inner = is_iv_gid(e.src()), dst_inner = is_iv_gid(e.dst());
+      uint8_t kind = 0;
+      if (add_out && src_inner) {
+        kind |= kOutEdge;
+      }
+      if (add_in && dst_inner) {
+        kind |= kInEdge;
+      }
+      if (kind != 0) {
+        e.SetEndpoint(
+            src_inner ? iv_gid_to_lid(e.src()) : ov_gid_to_lid(e.src()),
+            dst_inner ? iv_gid_to_lid(e.dst()) : ov_gid_to_lid(e.dst()));
+      }
+      kinds[i] = kind;
+    });
 
-          if (addIncomingEdge(e.src(), e.dst(), e.edata())) {
-            if (e.src() == e.dst()) {
-              addSelfLoop(e.src());
-            }
-            ++ienum_;
-          }
+    std::vector<batch_nbr_t> nbrs;
+    nbrs.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (kinds[i] == 0) {
+        continue;
+      }
+      auto& e = edges[i];
+      markAlive(e.src());
+      markAlive(e.dst());
+      if (kinds[i] & kOutEdge) {
+        if (inner_oe_pos_[e.src()] == -1) {
+          inner_oe_pos_[e.src()] = inner_edge_space_.allocate();
         }
+        nbrs.push_back({static_cast<size_t>(inner_oe_pos_[e.src()]), e.dst(),
+                        &e.edata()});
       }
-      break;
-    }
-    case grape::LoadStrategy::kOnlyOut: {
-      for (auto& e : edges) {
-        if (e.src() != invalid_vid && is_iv_gid(e.src())) {
-          vid_t dst;
-          if (is_iv_gid(e.dst())) {
-            dst = iv_gid_to_lid(e.dst());
-          } else {
-            dst = ov_gid_to_lid(e.dst());
-          }
-          e.SetEndpoint(iv_gid_to_lid(e.src()), dst);
-
-          if (addOutgoingEdge(e.src(), e.dst(), e.edata())) {
-            if (e.src() == e.dst()) {
-              addSelfLoop(e.src());
-            }
-            ++oenum_;
-          }
+      if (kinds[i] & kInEdge) {
+        if (inner_ie_pos_[e.dst()] == -1) {
+          inner_ie_pos_[e.dst()] = inner_edge_space_.allocate();
         }
+        nbrs.push_back({static_cast<size_t>(inner_ie_pos_[e.dst()]), e.src(),
+                        &e.edata()});
       }
-      break;
     }
-    case grape::LoadStrategy::kBothOutIn: {
-      for (auto& e : edges) {
-        if (e.src() != invalid_vid) {
-          if (is_iv_gid(e.src()) && is_iv_gid(e.dst())) {
-            e.SetEndpoint(iv_gid_to_lid(e.src()), iv_gid_to_lid(e.dst()));
-            if (addOutgoingEdge(e.src(), e.dst(), e.edata())) {
-              if (e.src() == e.dst()) {
-                addSelfLoop(e.src());
-              }
-              ++oenum_;
-            }
-
-            if (addIncomingEdge(e.src(), e.dst(), e.edata())) {
-              ++ienum_;
-            }
-          } else if (is_iv_gid(e.src())) {
-            vid_t dst;
-            if (is_iv_gid(e.dst())) {
-              dst = iv_gid_to_lid(e.dst());
-            } else {
-              dst = ov_gid_to_lid(e.dst());
-            }
-            e.SetEndpoint(iv_gid_to_lid(e.src()), dst);
 
-            if (addOutgoingEdge(e.src(), e.dst(), e.edata())) {
-              ++oenum_;
-            }
-          } else if (is_iv_gid(e.dst())) {
-            vid_t src;
-            if (is_iv_gid(e.src())) {
-              src = iv_gid_to_lid(e.src());
-            } else {
-              src = ov_gid_to_lid(e.src());
-            }
-            e.SetEndpoint(src, iv_gid_to_lid(e.dst()));
+    std::vector<uint8_t> created;
+    inner_edge_space_.BatchEmplace(nbrs, created);
 
-            if (addIncomingEdge(e.src(), e.dst(), e.edata())) {
-              ++ienum_;
-            }
-          } else {
-            CHECK(false);
+    // self loops are counted by the outgoing edge if there is one
+    size_t cursor = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      auto& e = edges[i];
+      if (kinds[i] & kOutEdge) {
+        if (created[cursor++]) {
+          ++oenum_;
+          if (e.src() == e.dst()) {
+            addSelfLoop(e.src());
+          }
+        }
+      }
+      if (kinds[i] & kInEdge) {
+        if (created[cursor++]) {
+          ++ienum_;
+          if (!add_out && e.src() == e.dst()) {
+            addSelfLoop(e.dst());
           }
         }
       }
-      break;
     }
-    default:
+    inner_edge_space_.Compact();
+  }
+
+  inline void markAlive(vid_t lid) {
+    if (lid < ivnum_) {
+      inner_vertex_alive_[lid] = true;
+    } else if (id_mask_ - lid < ovnum_) {
+      outer_vertex_alive_[id_mask_ - lid] = true;
+    } else {
       assert(false);
     }
   }
@@ -2157,7 +3458,7 @@ class DynamicFragment {
 
         if (inner_vertex_alive_[i] && pos != -1) {
           for (auto& e : inner_edge_space_[pos]) {
-            vid_t src = e.first;
+            vid_t src = e.neighbor().GetValue();
             if (src >= ivnum_) {
               fid_t f = ovgid_[id_mask_ - src] >> fid_offset_;
               dstset.insert(f);
@@ -2171,7 +3472,7 @@ class DynamicFragment {
 
         if (inner_vertex_alive_[i] && pos != -1) {
           for (auto& e : inner_edge_space_[pos]) {
-            vid_t dst = e.first;
+            vid_t dst = e.neighbor().GetValue();
             if (dst >= ivnum_) {
               fid_t f = ovgid_[id_mask_ - dst] >> fid_offset_;
               dstset.insert(f);
@@ -2304,117 +3605,98 @@ class DynamicFragment {
       }
     }
 
-    auto inner_vertices = grape::VertexRange<vid_t>(0, ivnum_);
-    for (auto v : inner_vertices) {
-      if (IsAliveInnerVertex(v)) {
-        auto lid = v.GetValue();
-        if (load_strategy_ == grape::LoadStrategy::kOnlyIn ||
-            load_strategy_ == grape::LoadStrategy::kBothOutIn) {
-          auto ie_pos = inner_ie_pos_[lid];
-
-          if (ie_pos != -1) {
-            for (auto to_remove_lid : to_remove_lid_set) {
-              ienum_ -= inner_edge_space_.remove_edge(ie_pos, to_remove_lid);
-            }
+    if (to_remove_lid_set.empty()) {
+      return;
+    }
+    // each vertex only mutates its own slots, so they are processed in
+    // parallel.
+    std::atomic<size_t> ie_removed(0), oe_removed(0);
+    parallel_for(0, ivnum_, [&](size_t lid) {
+      if (!inner_vertex_alive_[lid]) {
+        return;
+      }
+      if (load_strategy_ == grape::LoadStrategy::kOnlyIn ||
+          load_strategy_ == grape::LoadStrategy::kBothOutIn) {
+        auto ie_pos = inner_ie_pos_[lid];
+
+        if (ie_pos != -1) {
+          size_t removed = 0;
+          for (auto to_remove_lid : to_remove_lid_set) {
+            removed += inner_edge_space_.remove_edge(ie_pos, to_remove_lid);
           }
+          ie_removed += removed;
         }
+      }
 
-        if (load_strategy_ == grape::LoadStrategy::kOnlyOut ||
-            load_strategy_ == grape::LoadStrategy::kBothOutIn) {
-          auto oe_pos = inner_oe_pos_[lid];
+      if (load_strategy_ == grape::LoadStrategy::kOnlyOut ||
+          load_strategy_ == grape::LoadStrategy::kBothOutIn) {
+        auto oe_pos = inner_oe_pos_[lid];
 
-          if (oe_pos != -1) {
-            for (auto to_remove_lid : to_remove_lid_set) {
-              oenum_ -= inner_edge_space_.remove_edge(oe_pos, to_remove_lid);
-            }
+        if (oe_pos != -1) {
+          size_t removed = 0;
+          for (auto to_remove_lid : to_remove_lid_set) {
+            removed += inner_edge_space_.remove_edge(oe_pos, to_remove_lid);
           }
+          oe_removed += removed;
         }
       }
-    }
+    });
+    ienum_ -= ie_removed;
+    oenum_ -= oe_removed;
   }
 
   void deleteEdges(const std::vector<grape::Edge<vid_t, edata_t>>& edges) {
-    switch (load_strategy_) {
-    case grape::LoadStrategy::kOnlyIn: {
-      for (auto& e : edges) {
-        if (is_iv_gid(e.dst())) {
-          auto dst_lid = iv_gid_to_lid(e.dst());
-          auto src_lid = gid_to_lid(e.src());
-          auto ie_pos = inner_ie_pos_[dst_lid];
-
-          if (ie_pos != -1) {
-            auto remove_num = inner_edge_space_.remove_edge(ie_pos, src_lid);
-            ienum_ -= remove_num;
-            if (src_lid == dst_lid && remove_num > 0) {
-              deleteSelfLoop(dst_lid);
-            }
-          }
-        }
+    bool del_in = load_strategy_ == grape::LoadStrategy::kOnlyIn ||
+                  load_strategy_ == grape::LoadStrategy::kBothOutIn;
+    bool del_out = load_strategy_ == grape::LoadStrategy::kOnlyOut ||
+                   load_strategy_ == grape::LoadStrategy::kBothOutIn;
+    std::vector<uint8_t> kinds(edges.size(), 0);
+    std::vector<batch_nbr_t> nbrs;
+    nbrs.reserve(edges.size());
+
+    for (size_t i = 0; i < edges.size(); ++i) {
+      auto& e = edges[i];
+      bool src_inner = is_iv_gid(e.src()), dst_inner = is_iv_gid(e.dst());
+      if (!(del_out && src_inner) && !(del_in && dst_inner)) {
+        continue;
+      }
+      auto src_lid = gid_to_lid(e.src());
+      auto dst_lid = gid_to_lid(e.dst());
+      if (del_out && src_inner && inner_oe_pos_[src_lid] != -1) {
+        nbrs.push_back(
+            {static_cast<size_t>(inner_oe_pos_[src_lid]), dst_lid, nullptr});
+        kinds[i] |= kOutEdge;
+      }
+      if (del_in && dst_inner && inner_ie_pos_[dst_lid] != -1) {
+        nbrs.push_back(
+            {static_cast<size_t>(inner_ie_pos_[dst_lid]), src_lid, nullptr});
+        kinds[i] |= kInEdge;
       }
-      break;
     }
-    case grape::LoadStrategy::kOnlyOut: {
-      for (auto& e : edges) {
-        if (is_iv_gid(e.src())) {
-          auto src_lid = iv_gid_to_lid(e.src());
-          auto dst_lid = gid_to_lid(e.dst());
-          auto oe_pos = inner_oe_pos_[src_lid];
 
-          if (oe_pos != -1) {
-            auto remove_num = inner_edge_space_.remove_edge(oe_pos, dst_lid);
-            oenum_ -= remove_num;
-            if (src_lid == dst_lid && remove_num > 0) {
-              deleteSelfLoop(src_lid);
-            }
+    std::vector<uint8_t> removed;
+    inner_edge_space_.BatchRemove(nbrs, removed);
+
+    // self loops are counted by the outgoing edge if there is one
+    size_t cursor = 0;
+    for (size_t i = 0; i < edges.size(); ++i) {
+      bool selfloop = edges[i].src() == edges[i].dst();
+      if (kinds[i] & kOutEdge) {
+        if (removed[cursor++]) {
+          --oenum_;
+          if (selfloop) {
+            deleteSelfLoop(iv_gid_to_lid(edges[i].src()));
           }
         }
       }
-      break;
-    }
-    case grape::LoadStrategy::kBothOutIn: {
-      for (auto& e : edges) {
-        if (is_iv_gid(e.src()) && is_iv_gid(e.dst())) {
-          auto src_lid = iv_gid_to_lid(e.src());
-          auto dst_lid = iv_gid_to_lid(e.dst());
-          auto ie_pos = inner_ie_pos_[dst_lid];
-          auto oe_pos = inner_oe_pos_[src_lid];
-
-          if (oe_pos != -1) {
-            auto remove_num = inner_edge_space_.remove_edge(oe_pos, dst_lid);
-            oenum_ -= remove_num;
-            if (src_lid == dst_lid && remove_num > 0) {
-              deleteSelfLoop(src_lid);
-            }
-          }
-
-          if (ie_pos != -1) {
-            ienum_ -= inner_edge_space_.remove_edge(ie_pos, src_lid);
-          }
-
-        } else if (is_iv_gid(e.src())) {
-          auto src_lid = iv_gid_to_lid(e.src());
-          auto dst_lid = gid_to_lid(e.dst());
-          auto oe_pos = inner_oe_pos_[src_lid];
-
-          if (oe_pos != -1) {
-            oenum_ -= inner_edge_space_.remove_edge(oe_pos, dst_lid);
-          }
-        } else if (is_iv_gid(e.dst())) {
-          auto src_lid = gid_to_lid(e.src());
-          auto dst_lid = iv_gid_to_lid(e.dst());
-          auto ie_pos = inner_ie_pos_[dst_lid];
-
-          if (ie_pos != -1) {
-            ienum_ -= inner_edge_space_.remove_edge(ie_pos, src_lid);
+      if (kinds[i] & kInEdge) {
+        if (removed[cursor++]) {
+          --ienum_;
+          if (!del_out && selfloop) {
+            deleteSelfLoop(iv_gid_to_lid(edges[i].dst()));
           }
-        } else {
-          CHECK(false);
         }
       }
-      break;
-    }
-    default:
-      CHECK(false);
     }
   }
 
@@ -2528,47 +3810,116 @@ class DynamicFragment {
         continue;
       }
       for (auto& e : origin->inner_edge_space_[ie_pos]) {
-        if (addOutgoingEdge(lid, e.first, e.second.data())) {
+        if (addOutgoingEdge(lid, e.neighbor().GetValue(), e.data())) {
           ++oenum_;
         }
       }
     }
+    inner_edge_space_.Compact();
   }
 
   // induce subgraph from induced_nodes
   void induceFromVertices(std::shared_ptr<DynamicFragment>& origin,
                           const std::unordered_set<oid_t>& induced_vertices,
                           std::vector<edge_t>& edges) {
-    vertex_t vertex;
-    vid_t gid, dst_gid;
-    for (auto& oid : induced_vertices) {
-      if (origin->GetVertex(oid, vertex) && origin->IsInnerVertex(vertex)) {
-        // store the vertex data
-        CHECK(vm_ptr_->GetGid(fid_, oid, gid));
-        auto lid = iv_gid_to_lid(gid);
-        vdata_[lid] = origin->GetData(vertex);
-        inner_vertex_alive_[lid] = true;
-
-        for (auto& e : origin->GetOutgoingAdjList(vertex)) {
-          auto dst_oid = origin->GetId(e.get_neighbor());
-          if (induced_vertices.find(dst_oid) != induced_vertices.end()) {
-            CHECK(Oid2Gid(dst_oid, dst_gid));
-            edges.emplace_back(gid, dst_gid, e.get_data());
-          }
-        }
-        if (directed()) {
-          // filter the cross-fragment incoming edges
-          for (auto& e : origin->GetIncomingAdjList(vertex)) {
-            if (origin->IsOuterVertex(e.get_neighbor())) {
-              auto dst_oid = origin->GetId(e.get_neighbor());
-              if (induced_vertices.find(dst_oid) != induced_vertices.end()) {
-                CHECK(Oid2Gid(dst_oid, dst_gid));
-                edges.emplace_back(dst_gid, gid, e.get_data());
+    const DynamicFragment& src = *origin;
+    // resolve each induced vertex once, to the vertex in origin and the gid
+    // in the subgraph, so the neighbors are checked by the vertices of origin
+    // without hashing the oids per edge.
+    std::vector<oid_t> oids(induced_vertices.begin(), induced_vertices.end());
+    std::vector<vertex_t> vertices(oids.size());
+    std::vector<vid_t> gids(oids.size());
+    std::vector<uint8_t> resolved(oids.size(), 0);
+    parallel_for(0, oids.size(), [&](size_t i) {
+      resolved[i] =
+          src.GetVertex(oids[i], vertices[i]) && Oid2Gid(oids[i], gids[i]);
+    });
+
+    // index the gids by the lids of origin, densely if the subgraph holds a
+    // fair share of the vertices of origin, or else in a hash map to avoid
+    // the arrays as large as origin.
+    constexpr vid_t invalid_gid = std::numeric_limits<vid_t>::max();
+    bool dense = oids.size() * kSparseInduceRatio >= src.tvnum_;
+    std::vector<vid_t> dense_index;
+    ska::flat_hash_map<vid_t, vid_t> sparse_index;
+    std::vector<size_t> inner;
+    if (dense) {
+      dense_index.resize(src.tvnum_, invalid_gid);
+    } else {
+      sparse_index.reserve(oids.size());
+    }
+    for (size_t i = 0; i < oids.size(); ++i) {
+      if (!resolved[i]) {
+        continue;
+      }
+      if (dense) {
+        dense_index[vertices[i].GetValue()] = gids[i];
+      } else {
+        sparse_index.emplace(vertices[i].GetValue(), gids[i]);
+      }
+      if (src.IsInnerVertex(vertices[i])) {
+        inner.push_back(i);
+      }
+    }
+    auto lookup = [&](const vertex_t& v, vid_t& gid) {
+      if (dense) {
+        gid = dense_index[v.GetValue()];
+        return gid != invalid_gid;
+      }
+      auto iter = sparse_index.find(v.GetValue());
+      if (iter == sparse_index.end()) {
+        return false;
+      }
+      gid = iter->second;
+      return true;
+    };
+
+    // copy the vertex data and the edges by chunks of the inner vertices,
+    // each of which collects its edges apart, then concatenate them by the
+    // order of the chunks.
+    size_t thread_num = parallel_thread_num(inner.size(), kInduceGrainSize);
+    size_t chunk = (inner.size() + thread_num - 1) / thread_num;
+    std::vector<std::vector<edge_t>> thread_edges(thread_num);
+    parallel_for(
+        0, thread_num,
+        [&](size_t tid) {
+          auto& local_edges = thread_edges[tid];
+          size_t begin = std::min(inner.size(), tid * chunk);
+          size_t end = std::min(inner.size(), begin + chunk);
+          vid_t dst_gid;
+          for (size_t k = begin; k < end; ++k) {
+            auto& vertex = vertices[inner[k]];
+            auto gid = gids[inner[k]];
+            auto lid = iv_gid_to_lid(gid);
+            vdata_[lid] = src.GetData(vertex);
+            inner_vertex_alive_[lid] = true;
+
+            for (auto& e : src.GetOutgoingAdjList(vertex)) {
+              if (lookup(e.get_neighbor(), dst_gid)) {
+                local_edges.emplace_back(gid, dst_gid, e.get_data());
+              }
+            }
+            if (directed()) {
+              // filter the cross-fragment incoming edges
+              for (auto& e : src.GetIncomingAdjList(vertex)) {
+                if (src.IsOuterVertex(e.get_neighbor()) &&
+                    lookup(e.get_neighbor(), dst_gid)) {
+                  local_edges.emplace_back(dst_gid, gid, e.get_data());
+                }
               }
             }
           }
-        }
-      }
+        },
+        1);
+    size_t edge_num = edges.size();
+    for (auto& local_edges : thread_edges) {
+      edge_num += local_edges.size();
+    }
+    edges.reserve(edge_num);
+    for (auto& local_edges : thread_edges) {
+      std::move(local_edges.begin(), local_edges.end(),
+                std::back_inserter(edges));
+      std::vector<edge_t>().swap(local_edges);
     }
     // since we filtering alive vertex in vertex map construct, alive_ivnum
     // equal to ivnum
@@ -2580,49 +3931,68 @@ class DynamicFragment {
       std::shared_ptr<DynamicFragment>& origin,
       const std::vector<std::pair<oid_t, oid_t>>& induced_edges,
       std::vector<edge_t>& edges) {
-    vertex_t vertex;
-    vid_t gid, dst_gid;
-    edata_t edata;
-    for (auto& e : induced_edges) {
-      const auto& src_oid = e.first;
-      const auto& dst_oid = e.second;
-      if (origin->HasEdge(src_oid, dst_oid)) {
-        if (vm_ptr_->GetGid(fid_, src_oid, gid)) {
-          // src is inner vertex
-          auto lid = iv_gid_to_lid(gid);
-          CHECK(origin->GetVertex(src_oid, vertex));
-          vdata_[lid] = origin->GetData(vertex);
-          inner_vertex_alive_[lid] = true;
-          CHECK(vm_ptr_->GetGid(dst_oid, dst_gid));
-          CHECK(origin->GetEdgeData(src_oid, dst_oid, edata));
-          edges.emplace_back(gid, dst_gid, edata);
-          if ((dst_gid >> fid_offset_) == fid_ && gid != dst_gid) {
-            // dst is inner vertex too
-            CHECK(origin->GetVertex(dst_oid, vertex));
-            vdata_[(dst_gid & id_mask_)] = origin->GetData(vertex);
-            inner_vertex_alive_[(dst_gid & id_mask_)] = true;
-            if (!directed_) {
-              edges.emplace_back(dst_gid, gid, edata);
-            }
+    // resolve the edges in parallel, then mark the vertices and collect the
+    // edges by the order of induced_edges.
+    enum class Incidence : uint8_t { kNone, kSrcInner, kDstInner };
+    size_t edge_num = induced_edges.size();
+    std::vector<Incidence> incidences(edge_num, Incidence::kNone);
+    std::vector<vid_t> src_gids(edge_num), dst_gids(edge_num);
+    std::vector<edata_t> edatas(edge_num);
+    parallel_for(0, edge_num, [&](size_t i) {
+      const auto& src_oid = induced_edges[i].first;
+      const auto& dst_oid = induced_edges[i].second;
+      // GetEdgeData finds the edge as HasEdge does
+      if (!origin->GetEdgeData(src_oid, dst_oid, edatas[i])) {
+        return;
+      }
+      if (vm_ptr_->GetGid(fid_, src_oid, src_gids[i])) {
+        // src is inner vertex
+        CHECK(vm_ptr_->GetGid(dst_oid, dst_gids[i]));
+        incidences[i] = Incidence::kSrcInner;
+      } else if (vm_ptr_->GetGid(fid_, dst_oid, dst_gids[i])) {
+        // dst is inner vertex but src is outer vertex
+        CHECK(vm_ptr_->GetGid(src_oid, src_gids[i]));
+        incidences[i] = Incidence::kDstInner;
+      }
+    });
+
+    // the oids of the alive inner vertices, to copy the vertex data from
+    std::vector<const oid_t*> alive_oids(ivnum_, nullptr);
+    for (size_t i = 0; i < edge_num; ++i) {
+      auto gid = src_gids[i];
+      auto dst_gid = dst_gids[i];
+      auto& edata = edatas[i];
+      if (incidences[i] == Incidence::kSrcInner) {
+        alive_oids[iv_gid_to_lid(gid)] = &induced_edges[i].first;
+        edges.emplace_back(gid, dst_gid, edata);
+        if ((dst_gid >> fid_offset_) == fid_ && gid != dst_gid) {
+          // dst is inner vertex too
+          alive_oids[iv_gid_to_lid(dst_gid)] = &induced_edges[i].second;
+          if (!directed_) {
+            edges.emplace_back(dst_gid, gid, edata);
           }
-        } else if (vm_ptr_->GetGid(fid_, dst_oid, dst_gid)) {
-          // dst is inner vertex but src is outer vertex
-          CHECK(origin->GetVertex(dst_oid, vertex));
-          vdata_[(dst_gid & id_mask_)] = origin->GetData(vertex);
-          inner_vertex_alive_[(dst_gid & id_mask_)] = true;
-          CHECK(vm_ptr_->GetGid(src_oid, gid));
-          origin->GetEdgeData(src_oid, dst_oid, edata);
-          directed() ? edges.emplace_back(gid, dst_gid, edata)
-                     : edges.emplace_back(dst_gid, gid, edata);
         }
+      } else if (incidences[i] == Incidence::kDstInner) {
+        alive_oids[iv_gid_to_lid(dst_gid)] = &induced_edges[i].second;
+        directed() ? edges.emplace_back(gid, dst_gid, edata)
+                   : edges.emplace_back(dst_gid, gid, edata);
       }
     }
-    // init alive_ivnum with inner_vertex_alive_ array
-    for (size_t i = 0; i < ivnum_; ++i) {
-      if (inner_vertex_alive_[i]) {
-        ++alive_ivnum_;
+
+    const DynamicFragment& src = *origin;
+    std::atomic<size_t> alive_num(0);
+    parallel_for(0, ivnum_, [&](size_t lid) {
+      if (alive_oids[lid] == nullptr) {
+        return;
       }
-    }
+      vertex_t vertex;
+      CHECK(src.GetVertex(*alive_oids[lid], vertex));
+      vdata_[lid] = src.GetData(vertex);
+      inner_vertex_alive_[lid] = true;
+      ++alive_num;
+    });
+    // init alive_ivnum with inner_vertex_alive_ array
+    alive_ivnum_ += alive_num;
   }
 
   inline const char* getTypeName(folly::dynamic::Type type) const {
@@ -2646,6 +4016,16 @@ class DynamicFragment {
     }
   }
 
+  using batch_nbr_t = dynamic_fragment_impl::NbrMapSpace<edata_t>::BatchNbr;
+  // kinds of the adjacent lists an edge belongs to
+  static constexpr uint8_t kOutEdge = 1;
+  static constexpr uint8_t kInEdge = 2;
+  // the induced subgraphs smaller than 1 / kSparseInduceRatio of origin are
+  // indexed by hash maps, see induceFromVertices
+  static constexpr size_t kSparseInduceRatio = 8;
+  // the minimal number of induced vertices copied by a thread
+  static constexpr size_t kInduceGrainSize = 256;
+
   std::shared_ptr<vertex_map_t> vm_ptr_;
   vid_t ivnum_{}, ovnum_{}, tvnum_{}, id_mask_{};
   vid_t alive_ivnum_{}, alive_ovnum_{};
@@ -2655,6 +4035,9 @@ class DynamicFragment {
   bool directed_{};
   grape::LoadStrategy load_strategy_{};
 
+  // the fragment holding the vertices, i.e., this, or the one under a view
+  DynamicFragment* core_ = this;
+
   // vertices cache
   std::pair<bool, std::vector<vertex_t>> alive_inner_vertices_;
   std::pair<bool, std::vector<vertex_t>> alive_outer_vertices_;
@@ -2685,12 +4068,52 @@ class DynamicFragment {
   Array<int32_t, grape::Allocator<int32_t>> inner_ie_pos_;
   Array<int32_t, grape::Allocator<int32_t>> inner_oe_pos_;
   dynamic_fragment_impl::NbrMapSpace<edata_t> inner_edge_space_;
+  MemoryStrategy memory_strategy_;
 
   const vid_t invalid_vid = std::numeric_limits<vid_t>::max();
 
   size_t selfloops_num_{};
   std::set<vid_t> selfloops_vertices_;
 
+  // types of the properties seen on vertices and edges, and the typed columns
+  // materialized from the type-stable ones.
+  dynamic_fragment_impl::PropertyTypeTracker vprop_types_, eprop_types_;
+  dynamic_fragment_impl::ColumnSet<dynamic_fragment_impl::VertexColumn>
+      vertex_columns_;
+  dynamic_fragment_impl::ColumnSet<dynamic_fragment_impl::EdgeColumn>
+      edge_columns_;
+  MutationLog<vid_t> mutation_log_;
+
+  // the state of the epochs, see Snapshot
+  std::mutex epoch_mutex_;
+  std::condition_variable epoch_cv_;
+  bool mutating_ = false;
+  std::atomic<size_t> epoch_{0};
+  std::shared_ptr<DynamicFragment> snapshot_;
+
+  // marks a mutation of the fragment in its scope, at the end of which the
+  // snapshot of the last epoch is dropped and the next epoch starts
+  class EpochGuard {
+   public:
+    explicit EpochGuard(DynamicFragment* fragment) : fragment_(fragment) {
+      std::lock_guard<std::mutex> lock(fragment_->epoch_mutex_);
+      fragment_->mutating_ = true;
+    }
+
+    ~EpochGuard() {
+      {
+        std::lock_guard<std::mutex> lock(fragment_->epoch_mutex_);
+        fragment_->mutating_ = false;
+        fragment_->snapshot_.reset();
+        fragment_->epoch_.fetch_add(1, std::memory_order_release);
+      }
+      fragment_->epoch_cv_.notify_all();
+    }
+
+   private:
+    DynamicFragment* fragment_;
+  };
+
   inline bool is_iv_gid(vid_t id) const { return (id >> fid_offset_) == fid_; }
 
   inline vid_t gid_to_lid(vid_t gid) const {
@@ -18,16 +18,19 @@
 
 #ifdef NETWORKX
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "boost/lexical_cast.hpp"
 #include "folly/dynamic.h"
 #include "folly/json.h"
 
 #include "grape/communication/communicator.h"
+#include "grape/serialization/in_archive.h"
 #include "grape/worker/comm_spec.h"
 
 #include "core/server/rpc_utils.h"
@@ -55,6 +58,16 @@ class DynamicGraphReporter : public grape::Communicator {
   bl::result<std::string> Report(std::shared_ptr<fragment_t>& fragment,
                                  const rpc::GSParams& params) {
     BOOST_LEAF_AUTO(report_type, params.Get<rpc::ReportType>(rpc::REPORT_TYPE));
+    if (params.HasKey(rpc::BATCH_SIZE)) {
+      BOOST_LEAF_AUTO(batch_size, params.Get<int64_t>(rpc::BATCH_SIZE));
+      if (batch_size > 0) {
+        batch_num_ = static_cast<int>(batch_size);
+      }
+    }
+    bool binary = false;
+    if (params.HasKey(rpc::BATCH_BINARY)) {
+      BOOST_LEAF_ASSIGN(binary, params.Get<bool>(rpc::BATCH_BINARY));
+    }
     switch (report_type) {
     case rpc::NODE_NUM: {
       return std::to_string(reportNodeNum(fragment));
@@ -65,6 +78,9 @@ class DynamicGraphReporter : public grape::Communicator {
     case rpc::SELFLOOPS_NUM: {
       return std::to_string(reportSelfloopsNum(fragment));
     }
+    case rpc::DEGREE_HISTOGRAM: {
+      return reportDegreeHistogram(fragment);
+    }
     case rpc::HAS_NODE: {
       BOOST_LEAF_AUTO(node_in_json, params.Get<std::string>(rpc::NODE));
       oid_t node_id = folly::parseJson(node_in_json, json_opts_)[0];
@@ -104,7 +120,9 @@ class DynamicGraphReporter : public grape::Communicator {
       BOOST_LEAF_AUTO(fid, params.Get<int64_t>(rpc::FID));
       BOOST_LEAF_AUTO(lid, params.Get<int64_t>(rpc::LID));
       BOOST_LEAF_AUTO(edge_key, params.Get<std::string>(rpc::EDGE_KEY));
-
+      if (binary) {
+        return packDegree(fragment, fid, lid, report_type, edge_key);
+      }
       return batchGetDegree(fragment, fid, lid, report_type, edge_key);
     }
     case rpc::NEIGHBORS_BY_NODE:
@@ -119,18 +137,179 @@ class DynamicGraphReporter : public grape::Communicator {
     case rpc::PREDS_BY_LOC: {
       BOOST_LEAF_AUTO(fid, params.Get<int64_t>(rpc::FID));
       BOOST_LEAF_AUTO(lid, params.Get<int64_t>(rpc::LID));
+      if (binary) {
+        return packNeighbors(fragment, fid, lid, report_type);
+      }
       return batchGetNeighbors(fragment, fid, lid, report_type);
     }
     case rpc::NODES_BY_LOC: {
       BOOST_LEAF_AUTO(fid, params.Get<int64_t>(rpc::FID));
       BOOST_LEAF_AUTO(lid, params.Get<int64_t>(rpc::LID));
+      if (binary) {
+        return packNodes(fragment, fid, lid);
+      }
       return batchGetNodes(fragment, fid, lid);
     }
+    case rpc::HAS_NODES: {
+      BOOST_LEAF_AUTO(nodes_in_json, params.Get<std::string>(rpc::NODE));
+      folly::dynamic nodes = folly::parseJson(nodes_in_json, json_opts_);
+      auto found = gatherOwned<char>(nodes.size(), [&](size_t i, char& ret) {
+        ret = fragment->HasNode(nodes[i]);
+        return ret != 0;
+      });
+      return std::string(found.begin(), found.end());
+    }
+    case rpc::HAS_EDGES: {
+      BOOST_LEAF_AUTO(edges_in_json, params.Get<std::string>(rpc::EDGE));
+      folly::dynamic edges = folly::parseJson(edges_in_json, json_opts_);
+      auto found = gatherOwned<char>(edges.size(), [&](size_t i, char& ret) {
+        ret = fragment->HasEdge(edges[i][0], edges[i][1]);
+        return ret != 0;
+      });
+      return std::string(found.begin(), found.end());
+    }
+    case rpc::NODES_DATA: {
+      BOOST_LEAF_AUTO(nodes_in_json, params.Get<std::string>(rpc::NODE));
+      folly::dynamic nodes = folly::parseJson(nodes_in_json, json_opts_);
+      auto data = gatherOwned<std::string>(
+          nodes.size(), [&](size_t i, std::string& ret) {
+            return fragment->GetVertexData(nodes[i], ret);
+          });
+      std::string ret = "[";
+      for (size_t i = 0; i < data.size(); ++i) {
+        ret += (i == 0 ? "" : ",");
+        ret += (data[i].empty() ? "null" : data[i]);
+      }
+      ret += "]";
+      return ret;
+    }
+    case rpc::DEG_BY_NODES:
+    case rpc::IN_DEG_BY_NODES:
+    case rpc::OUT_DEG_BY_NODES: {
+      BOOST_LEAF_AUTO(nodes_in_json, params.Get<std::string>(rpc::NODE));
+      BOOST_LEAF_AUTO(edge_key, params.Get<std::string>(rpc::EDGE_KEY));
+      folly::dynamic nodes = folly::parseJson(nodes_in_json, json_opts_);
+      rpc::ReportType type = rpc::OUT_DEG_BY_NODE;
+      if (report_type == rpc::DEG_BY_NODES) {
+        type = rpc::DEG_BY_NODE;
+      } else if (report_type == rpc::IN_DEG_BY_NODES) {
+        type = rpc::IN_DEG_BY_NODE;
+      }
+      auto degrees =
+          gatherOwned<double>(nodes.size(), [&](size_t i, double& ret) {
+            vertex_t v;
+            if (fragment->GetInnerVertex(nodes[i], v) &&
+                fragment->IsAliveInnerVertex(v)) {
+              ret = getGraphDegree(fragment, v, type, edge_key);
+              return true;
+            }
+            return false;
+          });
+      return std::string(reinterpret_cast<const char*>(degrees.data()),
+                         degrees.size() * sizeof(double));
+    }
     default:
       CHECK(false);
     }
   }
 
+  /**
+   * @brief Finds the only fragment needed to answer the report, i.e., the
+   * owner of the node, or of the source of the edge, or the fragment of the
+   * batch. It is looked up in the global vertex map of the fragment, and a
+   * missing node is answered by the fragment itself. The batched reports are
+   * routed if all of the keys have the same owner. Returns false if all
+   * fragments take part in the report.
+   */
+  static bool Owner(const std::shared_ptr<fragment_t>& fragment,
+                    const rpc::GSParams& params, grape::fid_t& owner) {
+    if (!params.HasKey(rpc::REPORT_TYPE)) {
+      return false;
+    }
+    folly::json::serialization_opts json_opts;
+    json_opts.allow_non_string_keys = true;
+    json_opts.allow_nan_inf = true;
+
+    auto owner_of = [&fragment](const oid_t& node) {
+      vid_t gid;
+      if (fragment->Oid2Gid(node, gid)) {
+        return static_cast<grape::fid_t>(gid >> fragment->fid_offset());
+      }
+      return fragment->fid();
+    };
+    folly::dynamic keys;
+    auto parse_keys = [&params, &json_opts, &keys](rpc::ParamKey key) {
+      if (!params.HasKey(key)) {
+        return false;
+      }
+      keys = folly::parseJson(params.Get<std::string>(key).value(), json_opts);
+      return !keys.empty();
+    };
+
+    auto report_type = params.Get<rpc::ReportType>(rpc::REPORT_TYPE).value();
+    switch (report_type) {
+    case rpc::HAS_NODE:
+    case rpc::NODE_DATA:
+    case rpc::DEG_BY_NODE:
+    case rpc::IN_DEG_BY_NODE:
+    case rpc::OUT_DEG_BY_NODE:
+    case rpc::NEIGHBORS_BY_NODE:
+    case rpc::SUCCS_BY_NODE:
+    case rpc::PREDS_BY_NODE: {
+      if (!parse_keys(rpc::NODE)) {
+        return false;
+      }
+      owner = owner_of(keys[0]);
+      return true;
+    }
+    case rpc::HAS_EDGE:
+    case rpc::EDGE_DATA: {
+      if (!parse_keys(rpc::EDGE)) {
+        return false;
+      }
+      owner = owner_of(keys[0]);
+      return true;
+    }
+    case rpc::HAS_NODES:
+    case rpc::NODES_DATA:
+    case rpc::DEG_BY_NODES:
+    case rpc::IN_DEG_BY_NODES:
+    case rpc::OUT_DEG_BY_NODES:
+    case rpc::HAS_EDGES: {
+      bool edges = (report_type == rpc::HAS_EDGES);
+      if (!parse_keys(edges ? rpc::EDGE : rpc::NODE)) {
+        return false;
+      }
+      owner = owner_of(edges ? keys[0][0] : keys[0]);
+      for (auto& key : keys) {
+        if (owner_of(edges ? key[0] : key) != owner) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case rpc::DEG_BY_LOC:
+    case rpc::IN_DEG_BY_LOC:
+    case rpc::OUT_DEG_BY_LOC:
+    case rpc::NEIGHBORS_BY_LOC:
+    case rpc::SUCCS_BY_LOC:
+    case rpc::PREDS_BY_LOC:
+    case rpc::NODES_BY_LOC: {
+      if (!params.HasKey(rpc::FID)) {
+        return false;
+      }
+      int64_t fid = params.Get<int64_t>(rpc::FID).value();
+      if (fid < 0 || fid >= static_cast<int64_t>(fragment->fnum())) {
+        return false;
+      }
+      owner = static_cast<grape::fid_t>(fid);
+      return true;
+    }
+    default:
+      return false;
+    }
+  }
+
  private:
   inline size_t reportNodeNum(std::shared_ptr<fragment_t>& fragment) {
     size_t frag_vnum = 0, total_vnum = 0;
@@ -153,6 +332,41 @@ class DynamicGraphReporter : public grape::Communicator {
     return total_selfloops_num;
   }
 
+  // the numbers of the nodes of each degree, indexed by the degree, in a json
+  // array, as networkx.degree_histogram. The degrees are the ones reported to
+  // the graphs, i.e., the out degrees of the undirected ones
+  std::string reportDegreeHistogram(std::shared_ptr<fragment_t>& fragment) {
+    auto type = fragment->directed() ? rpc::DEG_BY_NODE : rpc::OUT_DEG_BY_NODE;
+    std::vector<size_t> histogram;
+    for (auto v : fragment->InnerVertices()) {
+      if (!fragment->IsAliveInnerVertex(v)) {
+        continue;
+      }
+      auto degree =
+          static_cast<size_t>(getGraphDegree(fragment, v, type, ""));
+      if (degree >= histogram.size()) {
+        histogram.resize(degree + 1, 0);
+      }
+      ++histogram[degree];
+    }
+    std::vector<std::vector<size_t>> histograms;
+    AllGather(histogram, histograms);
+    histogram.clear();
+    for (auto& part : histograms) {
+      if (part.size() > histogram.size()) {
+        histogram.resize(part.size(), 0);
+      }
+      for (size_t degree = 0; degree < part.size(); ++degree) {
+        histogram[degree] += part[degree];
+      }
+    }
+    folly::dynamic ret = folly::dynamic::array;
+    for (auto num : histogram) {
+      ret.push_back(num);
+    }
+    return folly::json::serialize(ret, json_opts_);
+  }
+
   bool hasNode(std::shared_ptr<fragment_t>& fragment, const oid_t& node) {
     bool ret = false;
     bool to_send = fragment->HasNode(node);
@@ -340,6 +554,143 @@ class DynamicGraphReporter : public grape::Communicator {
     return ret;
   }
 
+  /**
+   * @brief Scans the alive inner vertices of a batch from start_lid, and
+   * returns the location of the next batch, as the json batches do.
+   */
+  std::pair<vid_t, vid_t> scanBatch(std::shared_ptr<fragment_t>& fragment,
+                                    vid_t fid, vid_t start_lid,
+                                    std::vector<vertex_t>& batch) {
+    vertex_t v(start_lid);
+    while (fragment->IsInnerVertex(v) &&
+           static_cast<int>(batch.size()) < batch_num_) {
+      if (fragment->IsAliveInnerVertex(v)) {
+        batch.push_back(v);
+      }
+      ++v;
+    }
+    if (fragment->IsInnerVertex(v)) {
+      return std::make_pair(fid, v.GetValue());
+    }
+    return std::make_pair(fid + 1, static_cast<vid_t>(0));
+  }
+
+  /**
+   * The binary batches start with the status as uint8, the next location as
+   * two int64 and the size of the batch as int64, followed by the ids of the
+   * nodes. The ids are a uint8 kind, 0 for an array of int64 and 1 for a
+   * json array of other ids, which is a uint64 length and the bytes, as the
+   * strings, e.g., the json arrays of the data, are packed.
+   */
+  void packHeader(grape::InArchive& arc, const std::pair<vid_t, vid_t>& next,
+                  size_t size) {
+    arc << static_cast<uint8_t>(size > 0);
+    arc << static_cast<int64_t>(next.first);
+    arc << static_cast<int64_t>(next.second);
+    arc << static_cast<int64_t>(size);
+  }
+
+  void packIds(grape::InArchive& arc, const std::vector<oid_t>& ids) {
+    bool all_int = std::all_of(ids.begin(), ids.end(),
+                               [](const oid_t& id) { return id.isInt(); });
+    arc << static_cast<uint8_t>(all_int ? 0 : 1);
+    if (all_int) {
+      for (auto& id : ids) {
+        arc << static_cast<int64_t>(id.getInt());
+      }
+    } else {
+      folly::dynamic array = folly::dynamic::array;
+      for (auto& id : ids) {
+        array.push_back(id);
+      }
+      arc << folly::json::serialize(array, json_opts_);
+    }
+  }
+
+  static std::string toString(const grape::InArchive& arc) {
+    return std::string(arc.GetBuffer(), arc.GetSize());
+  }
+
+  // the binary batchGetNodes: header, ids, json array of data
+  std::string packNodes(std::shared_ptr<fragment_t>& fragment, vid_t fid,
+                        vid_t start_lid) {
+    if (fragment->fid() != fid) {
+      return std::string();
+    }
+    std::vector<vertex_t> batch;
+    auto next = scanBatch(fragment, fid, start_lid, batch);
+    std::vector<oid_t> ids;
+    folly::dynamic data = folly::dynamic::array;
+    for (auto& v : batch) {
+      ids.push_back(fragment->GetId(v));
+      data.push_back(fragment->GetData(v));
+    }
+    grape::InArchive arc;
+    packHeader(arc, next, batch.size());
+    packIds(arc, ids);
+    arc << folly::json::serialize(data, json_opts_);
+    return toString(arc);
+  }
+
+  // the binary batchGetDegree: header, ids, double array of degrees
+  std::string packDegree(std::shared_ptr<fragment_t>& fragment, vid_t fid,
+                         vid_t start_lid, const rpc::ReportType& type,
+                         const std::string& weight) {
+    if (fragment->fid() != fid) {
+      return std::string();
+    }
+    std::vector<vertex_t> batch;
+    auto next = scanBatch(fragment, fid, start_lid, batch);
+    std::vector<oid_t> ids;
+    std::vector<double> degrees;
+    for (auto& v : batch) {
+      ids.push_back(fragment->GetId(v));
+      degrees.push_back(getGraphDegree(fragment, v, type, weight));
+    }
+    grape::InArchive arc;
+    packHeader(arc, next, batch.size());
+    packIds(arc, ids);
+    arc.AddBytes(degrees.data(), degrees.size() * sizeof(double));
+    return toString(arc);
+  }
+
+  // the binary batchGetNeighbors: header, ids, int64 array of size + 1
+  // offsets, ids of the neighbors, json array of the edge data
+  std::string packNeighbors(std::shared_ptr<fragment_t>& fragment, vid_t fid,
+                            vid_t start_lid, const rpc::ReportType& type) {
+    if (fragment->fid() != fid) {
+      return std::string();
+    }
+    std::vector<vertex_t> batch;
+    auto next = scanBatch(fragment, fid, start_lid, batch);
+    std::vector<oid_t> ids, nbr_ids;
+    std::vector<int64_t> offsets(1, 0);
+    folly::dynamic data = folly::dynamic::array;
+    for (auto& v : batch) {
+      ids.push_back(fragment->GetId(v));
+      if (type == rpc::NEIGHBORS_BY_LOC || type == rpc::SUCCS_BY_LOC) {
+        for (auto& e : fragment->GetOutgoingAdjList(v)) {
+          nbr_ids.push_back(fragment->GetId(e.neighbor()));
+          data.push_back(e.data());
+        }
+      }
+      if (type == rpc::NEIGHBORS_BY_LOC || type == rpc::PREDS_BY_LOC) {
+        for (auto& e : fragment->GetIncomingAdjList(v)) {
+          nbr_ids.push_back(fragment->GetId(e.neighbor()));
+          data.push_back(e.data());
+        }
+      }
+      offsets.push_back(static_cast<int64_t>(nbr_ids.size()));
+    }
+    grape::InArchive arc;
+    packHeader(arc, next, batch.size());
+    packIds(arc, ids);
+    arc.AddBytes(offsets.data(), offsets.size() * sizeof(int64_t));
+    packIds(arc, nbr_ids);
+    arc << folly::json::serialize(data, json_opts_);
+    return toString(arc);
+  }
+
   double getGraphDegree(std::shared_ptr<fragment_t>& fragment, vertex_t& v,
                         const rpc::ReportType& type,
                         const std::string& weight) {
@@ -369,8 +720,35 @@ class DynamicGraphReporter : public grape::Communicator {
     return degree;
   }
 
+  /**
+   * @brief Evaluates func(i, value) for each key in [0, size), which returns
+   * false if the key is not owned by the fragment, and gathers the values of
+   * the owners. The values of the keys without owner are left as T().
+   */
+  template <typename T, typename FUNC_T>
+  std::vector<T> gatherOwned(size_t size, const FUNC_T& func) {
+    std::vector<std::pair<size_t, T>> owned;
+    T value;
+    for (size_t i = 0; i < size; ++i) {
+      if (func(i, value)) {
+        owned.emplace_back(i, value);
+      }
+    }
+    std::vector<std::vector<std::pair<size_t, T>>> all_owned;
+    AllGather(owned, all_owned);
+
+    std::vector<T> ret(size);
+    for (auto& pairs : all_owned) {
+      for (auto& pair : pairs) {
+        ret[pair.first] = std::move(pair.second);
+      }
+    }
+    return ret;
+  }
+
   grape::CommSpec comm_spec_;
-  static const int batch_num_ = 100;
+  static const int kDefaultBatchNum = 100;
+  int batch_num_ = kDefaultBatchNum;
   folly::json::serialization_opts json_opts_;
 };
 }  // namespace gs
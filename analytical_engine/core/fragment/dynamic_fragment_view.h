@@ -49,8 +49,11 @@ FragmentViewType parse_fragment_view_type(const std::string& view_type) {
  *             undirected.
  * - undirected: view of original graph with edge undirected, original graph is
  *               directed.
+ * The accessors independent of the directions, e.g., IsInnerVertex and
+ * GetData, are the non-virtual ones of DynamicFragment over the states of the
+ * viewed fragment, and only the ones on the edges are dispatched to the view.
  */
-class DynamicFragmentView : public DynamicFragment {
+class DynamicFragmentView final : public DynamicFragment {
  public:
   using fragment_t = DynamicFragment;
 
@@ -58,18 +61,12 @@ class DynamicFragmentView : public DynamicFragment {
 
   explicit DynamicFragmentView(fragment_t* frag,
                                const FragmentViewType& view_type)
-      : fragment_(frag), view_type_(view_type) {}
+      : fragment_(frag), view_type_(view_type) {
+    core_ = frag->core_;
+  }
 
   virtual ~DynamicFragmentView() = default;
 
-  inline fid_t fid() const { return fragment_->fid(); }
-
-  inline fid_t fnum() const { return fragment_->fnum(); }
-
-  inline vid_t id_mask() const { return fragment_->id_mask(); }
-
-  inline int fid_offset() const { return fragment_->fid_offset(); }
-
   inline size_t selfloops_num() const { return fragment_->selfloops_num(); }
 
   inline bool directed() const {
@@ -115,14 +112,6 @@ class DynamicFragmentView : public DynamicFragment {
 
   inline oid_t GetId(const vertex_t& v) const { return fragment_->GetId(v); }
 
-  inline fid_t GetFragId(const vertex_t& u) const {
-    return fragment_->GetFragId(u);
-  }
-
-  inline const vdata_t& GetData(const vertex_t& v) const {
-    return fragment_->GetData(v);
-  }
-
   inline void SetData(const vertex_t& v, const vdata_t& val) {
     return fragment_->SetData(v, val);
   }
@@ -150,14 +139,6 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->GetLocalInDegree(v);
   }
 
-  inline bool Gid2Vertex(const vid_t& gid, vertex_t& v) const {
-    return fragment_->Gid2Vertex(gid, v);
-  }
-
-  inline vid_t Vertex2Gid(const vertex_t& v) const {
-    return fragment_->Vertex2Gid(v);
-  }
-
   inline vid_t GetInnerVerticesNum() const {
     return fragment_->GetInnerVerticesNum();
   }
@@ -166,14 +147,6 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->GetOuterVerticesNum();
   }
 
-  inline bool IsInnerVertex(const vertex_t& v) const {
-    return fragment_->IsInnerVertex(v);
-  }
-
-  inline bool IsOuterVertex(const vertex_t& v) const {
-    return fragment_->IsOuterVertex(v);
-  }
-
   inline bool GetInnerVertex(const oid_t& oid, vertex_t& v) const {
     return fragment_->GetInnerVertex(oid, v);
   }
@@ -198,22 +171,6 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->Oid2Gid(oid, gid);
   }
 
-  inline bool InnerVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
-    return fragment_->InnerVertexGid2Vertex(gid, v);
-  }
-
-  inline bool OuterVertexGid2Vertex(const vid_t& gid, vertex_t& v) const {
-    return fragment_->OuterVertexGid2Vertex(gid, v);
-  }
-
-  inline vid_t GetOuterVertexGid(const vertex_t& v) const {
-    return fragment_->GetOuterVertexGid(v);
-  }
-
-  inline vid_t GetInnerVertexGid(const vertex_t& v) const {
-    return fragment_->GetInnerVertexGid(v);
-  }
-
   inline grape::DestList IEDests(const vertex_t& v) const {
     return fragment_->IEDests(v);
   }
@@ -276,18 +233,6 @@ class DynamicFragmentView : public DynamicFragment {
     return fragment_->GetOidType(comm_spec);
   }
 
-  inline bool IsAliveVertex(const vertex_t& v) const {
-    return fragment_->IsAliveVertex(v);
-  }
-
-  inline bool IsAliveInnerVertex(const vertex_t& v) const {
-    return fragment_->IsAliveInnerVertex(v);
-  }
-
-  inline bool IsAliveOuterVertex(const vertex_t& v) const {
-    return fragment_->IsAliveOuterVertex(v);
-  }
-
  private:
   inline vid_t ivnum() { return fragment_->ivnum(); }
 
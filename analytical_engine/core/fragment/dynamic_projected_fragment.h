@@ -139,23 +139,70 @@ unpack_nbr(dynamic_fragment_impl::Nbr<T>& nbr, const folly::dynamic& d,
   nbr.set_data(grape::EmptyType());
 }
 
-#define SET_PROJECTED_NBR                               \
-  void set_nbr() {                                      \
-    auto original_nbr = map_current_->second;           \
-    auto& data = original_nbr.data();                   \
-                                                        \
-    unpack_nbr<EDATA_T>(internal_nbr, data, prop_key_); \
-    internal_nbr.set_neighbor(original_nbr.neighbor()); \
-    auto v = internal_nbr.neighbor();                   \
-    if (v.GetValue() >= ivnum_) {                       \
-      v.SetValue(ivnum_ + id_mask_ - v.GetValue());     \
-    }                                                   \
-    internal_nbr.set_neighbor(v);                       \
+/**
+ * @brief Whether the property type can be materialized as a typed column of
+ * DynamicFragment.
+ */
+template <typename T>
+struct is_columnar
+    : std::integral_constant<bool, std::is_same<T, int>::value ||
+                                       std::is_same<T, int64_t>::value ||
+                                       std::is_same<T, double>::value> {};
+
+// the string vertex properties are also columnar, encoded by a dictionary
+template <typename T>
+struct is_vertex_columnar
+    : std::integral_constant<bool, is_columnar<T>::value ||
+                                       std::is_same<T, std::string>::value> {};
+
+template <typename T>
+typename std::enable_if<is_vertex_columnar<T>::value,
+                        dynamic_fragment_impl::VertexColumn<T>*>::type
+get_vertex_column(DynamicFragment* frag, const std::string& key) {
+  return frag->GetVertexColumn<T>(key);
+}
+
+template <typename T>
+typename std::enable_if<!is_vertex_columnar<T>::value,
+                        dynamic_fragment_impl::VertexColumn<T>*>::type
+get_vertex_column(DynamicFragment* frag, const std::string& key) {
+  return nullptr;
+}
+
+template <typename T>
+typename std::enable_if<is_columnar<T>::value,
+                        dynamic_fragment_impl::EdgeColumn<T>*>::type
+get_edge_column(DynamicFragment* frag, const std::string& key) {
+  return frag->GetEdgeColumn<T>(key);
+}
+
+template <typename T>
+typename std::enable_if<!is_columnar<T>::value,
+                        dynamic_fragment_impl::EdgeColumn<T>*>::type
+get_edge_column(DynamicFragment* frag, const std::string& key) {
+  return nullptr;
+}
+
+// reads the edge data from the typed column if any, rather than unpacking
+// the dynamic data of each edge
+#define SET_PROJECTED_NBR                                                  \
+  void set_nbr() {                                                         \
+    auto& original_nbr = *current_;                                        \
+    if (edata_ != nullptr) {                                               \
+      internal_nbr.set_data(edata_[current_ - base_]);                     \
+    } else {                                                               \
+      unpack_nbr<EDATA_T>(internal_nbr, original_nbr.data(), prop_key_);   \
+    }                                                                      \
+    auto v = original_nbr.neighbor();                                      \
+    if (v.GetValue() >= ivnum_) {                                          \
+      v.SetValue(ivnum_ + id_mask_ - v.GetValue());                        \
+    }                                                                      \
+    internal_nbr.set_neighbor(v);                                          \
   }
 
 /**
- * @brief This is an internal representation of neighbor vertices using
- * std::map.
+ * @brief This is an internal representation of neighbor vertices, which
+ * iterates over the contiguous neighbor array of a NbrMap.
  *
  * @tparam EDATA_T Data type of edge
  */
@@ -164,27 +211,28 @@ class ProjectedAdjLinkedList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
   using NbrT = dynamic_fragment_impl::Nbr<folly::dynamic>;
   using ProjectedNbrT = dynamic_fragment_impl::Nbr<EDATA_T>;
+  using nbr_iterator_t =
+      typename dynamic_fragment_impl::NbrMap<folly::dynamic>::iterator;
 
  public:
   ProjectedAdjLinkedList() = default;
   ProjectedAdjLinkedList(
       VID_T id_mask, VID_T ivnum, std::string prop_key,
-      typename std::map<VID_T, NbrT>::iterator map_iter_begin,
-      typename std::map<VID_T, NbrT>::iterator map_iter_end)
+      nbr_iterator_t iter_begin, nbr_iterator_t iter_end,
+      const EDATA_T* edata = nullptr)
       : id_mask_(id_mask),
         ivnum_(ivnum),
         prop_key_(std::move(prop_key)),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        iter_begin_(iter_begin),
+        iter_end_(iter_end),
+        edata_(edata) {}
   ~ProjectedAdjLinkedList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return iter_begin_ == iter_end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return iter_end_ - iter_begin_; }
 
   class iterator {
     using pointer_type = ProjectedNbrT*;
@@ -195,11 +243,14 @@ class ProjectedAdjLinkedList {
    public:
     iterator() = default;
     iterator(VID_T id_mask, VID_T ivnum, std::string prop_key,
-             typename std::map<VID_T, NbrT>::iterator map_current) noexcept
+             nbr_iterator_t current, nbr_iterator_t base = {},
+             const EDATA_T* edata = nullptr) noexcept
         : id_mask_(id_mask),
           ivnum_(ivnum),
           prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
+          current_(current),
+          base_(base),
+          edata_(edata) {}
 
     reference_type operator*() noexcept {
       set_nbr();
@@ -212,36 +263,34 @@ class ProjectedAdjLinkedList {
     }
 
     iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     iterator operator++(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_++);
+      return iterator(id_mask_, ivnum_, current_++);
     }
 
     iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     iterator operator--(int) noexcept {
-      return iterator(id_mask_, ivnum_, map_current_--);
+      return iterator(id_mask_, ivnum_, current_--);
     }
 
     iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return iterator(id_mask_, ivnum_, curr);
+      return iterator(id_mask_, ivnum_, prop_key_, current_ + offset, base_,
+                      edata_);
     }
 
     bool operator==(const iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
@@ -249,7 +298,9 @@ class ProjectedAdjLinkedList {
     VID_T ivnum_;
     std::string prop_key_;
     ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    nbr_iterator_t current_{};
+    nbr_iterator_t base_{};
+    const EDATA_T* edata_ = nullptr;
   };
 
   class const_iterator {
@@ -262,11 +313,14 @@ class ProjectedAdjLinkedList {
     const_iterator() = default;
     const_iterator(
         VID_T id_mask, VID_T ivnum, std::string prop_key,
-        typename std::map<VID_T, NbrT>::iterator map_current) noexcept
+        nbr_iterator_t current, nbr_iterator_t base = {},
+        const EDATA_T* edata = nullptr) noexcept
         : id_mask_(id_mask),
           ivnum_(ivnum),
           prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
+          current_(current),
+          base_(base),
+          edata_(edata) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -279,35 +333,33 @@ class ProjectedAdjLinkedList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, prop_key_, current_ + offset,
+                            base_, edata_);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
@@ -315,32 +367,39 @@ class ProjectedAdjLinkedList {
     VID_T ivnum_;
     std::string prop_key_;
     ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::iterator map_current_;
+    nbr_iterator_t current_{};
+    nbr_iterator_t base_{};
+    const EDATA_T* edata_ = nullptr;
   };
 
   iterator begin() {
-    return iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    return iterator(id_mask_, ivnum_, prop_key_, iter_begin_, iter_begin_,
+                    edata_);
   }
 
   iterator end() {
-    return iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    return iterator(id_mask_, ivnum_, prop_key_, iter_end_, iter_begin_,
+                    edata_);
   }
 
   const_iterator cbegin() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, prop_key_, iter_begin_,
+                          iter_begin_, edata_);
   }
   const_iterator cend() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, prop_key_, iter_end_, iter_begin_,
+                          edata_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return iter_begin_ == iter_end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
   std::string prop_key_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::iterator map_iter_end_;
+  nbr_iterator_t iter_begin_{};
+  nbr_iterator_t iter_end_{};
+  const EDATA_T* edata_ = nullptr;
 };
 
 /**
@@ -352,27 +411,28 @@ class ConstProjectedAdjLinkedList {
   using VID_T = vineyard::property_graph_types::VID_TYPE;
   using NbrT = dynamic_fragment_impl::Nbr<folly::dynamic>;
   using ProjectedNbrT = dynamic_fragment_impl::Nbr<EDATA_T>;
+  using const_nbr_iterator_t =
+      typename dynamic_fragment_impl::NbrMap<folly::dynamic>::const_iterator;
 
  public:
   ConstProjectedAdjLinkedList() = default;
   ConstProjectedAdjLinkedList(
       VID_T id_mask, VID_T ivnum, std::string prop_key,
-      typename std::map<VID_T, NbrT>::const_iterator map_iter_begin,
-      typename std::map<VID_T, NbrT>::const_iterator map_iter_end)
+      const_nbr_iterator_t iter_begin, const_nbr_iterator_t iter_end,
+      const EDATA_T* edata = nullptr)
       : id_mask_(id_mask),
         ivnum_(ivnum),
         prop_key_(std::move(prop_key)),
-        map_iter_begin_(map_iter_begin),
-        map_iter_end_(map_iter_end) {}
+        iter_begin_(iter_begin),
+        iter_end_(iter_end),
+        edata_(edata) {}
   ~ConstProjectedAdjLinkedList() = default;
 
-  inline bool Empty() const { return map_iter_begin_ == map_iter_end_; }
+  inline bool Empty() const { return iter_begin_ == iter_end_; }
 
   inline bool NotEmpty() const { return !Empty(); }
 
-  inline size_t Size() const {
-    return std::distance(map_iter_begin_, map_iter_end_);
-  }
+  inline size_t Size() const { return iter_end_ - iter_begin_; }
 
   class const_iterator {
     using pointer_type = const ProjectedNbrT*;
@@ -384,11 +444,14 @@ class ConstProjectedAdjLinkedList {
     const_iterator() = default;
     const_iterator(
         VID_T id_mask, VID_T ivnum, std::string prop_key,
-        typename std::map<VID_T, NbrT>::const_iterator map_current) noexcept
+        const_nbr_iterator_t current, const_nbr_iterator_t base = {},
+        const EDATA_T* edata = nullptr) noexcept
         : id_mask_(id_mask),
           ivnum_(ivnum),
           prop_key_(std::move(prop_key)),
-          map_current_(map_current) {}
+          current_(current),
+          base_(base),
+          edata_(edata) {}
 
     reference_type operator*() const noexcept {
       const_cast<const_iterator*>(this)->set_nbr();
@@ -401,36 +464,34 @@ class ConstProjectedAdjLinkedList {
     }
 
     const_iterator& operator++() noexcept {
-      ++map_current_;
+      ++current_;
       return *this;
     }
 
     const_iterator operator++(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_++);
+      return const_iterator(id_mask_, ivnum_, current_++);
     }
 
     const_iterator& operator--() noexcept {
-      --map_current_;
+      --current_;
       return *this;
     }
 
     const_iterator operator--(int) noexcept {
-      return const_iterator(id_mask_, ivnum_, map_current_--);
+      return const_iterator(id_mask_, ivnum_, current_--);
     }
 
     const_iterator operator+(size_t offset) noexcept {
-      auto curr = map_current_;
-      for (int i = 0; i < offset; i++)
-        curr++;
-      return const_iterator(id_mask_, ivnum_, curr);
+      return const_iterator(id_mask_, ivnum_, prop_key_, current_ + offset,
+                            base_, edata_);
     }
 
     bool operator==(const const_iterator& rhs) noexcept {
-      return map_current_ == rhs.map_current_;
+      return current_ == rhs.current_;
     }
 
     bool operator!=(const const_iterator& rhs) noexcept {
-      return map_current_ != rhs.map_current_;
+      return current_ != rhs.current_;
     }
 
    private:
@@ -438,24 +499,29 @@ class ConstProjectedAdjLinkedList {
     VID_T ivnum_{};
     std::string prop_key_;
     ProjectedNbrT internal_nbr;
-    typename std::map<VID_T, NbrT>::const_iterator map_current_;
+    const_nbr_iterator_t current_{};
+    const_nbr_iterator_t base_{};
+    const EDATA_T* edata_ = nullptr;
   };
 
   const_iterator begin() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_begin_);
+    return const_iterator(id_mask_, ivnum_, prop_key_, iter_begin_,
+                          iter_begin_, edata_);
   }
   const_iterator end() const {
-    return const_iterator(id_mask_, ivnum_, prop_key_, map_iter_end_);
+    return const_iterator(id_mask_, ivnum_, prop_key_, iter_end_, iter_begin_,
+                          edata_);
   }
 
-  bool empty() const { return map_iter_begin_ == map_iter_end_; }
+  bool empty() const { return iter_begin_ == iter_end_; }
 
  private:
   VID_T id_mask_{};
   VID_T ivnum_{};
   std::string prop_key_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_begin_;
-  typename std::map<VID_T, NbrT>::const_iterator map_iter_end_;
+  const_nbr_iterator_t iter_begin_{};
+  const_nbr_iterator_t iter_end_{};
+  const EDATA_T* edata_ = nullptr;
 };
 
 }  // namespace dynamic_projected_fragment_impl
@@ -507,10 +573,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto& nbrs = fragment_->inner_edge_space()[ie_pos];
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space()[ie_pos].begin(),
-        fragment_->inner_edge_space()[ie_pos].end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(ie_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetIncomingAdjList(
@@ -519,10 +585,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto& nbrs = fragment_->inner_edge_space()[ie_pos];
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space()[ie_pos].cbegin(),
-        fragment_->inner_edge_space()[ie_pos].cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(ie_pos, nbrs.cbegin()));
   }
 
   inline projected_adj_linked_list_t GetIncomingInnerVertexAdjList(
@@ -531,10 +597,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().InnerNbr(ie_pos);
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().InnerNbr(ie_pos).begin(),
-        fragment_->inner_edge_space().InnerNbr(ie_pos).end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(ie_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetIncomingInnerVertexAdjList(
@@ -543,10 +609,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().InnerNbr(ie_pos);
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().InnerNbr(ie_pos).cbegin(),
-        fragment_->inner_edge_space().InnerNbr(ie_pos).cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(ie_pos, nbrs.cbegin()));
   }
 
   inline projected_adj_linked_list_t GetIncomingOuterVertexAdjList(
@@ -555,10 +621,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().OuterNbr(ie_pos);
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().OuterNbr(ie_pos).begin(),
-        fragment_->inner_edge_space().OuterNbr(ie_pos).end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(ie_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetIncomingOuterVertexAdjList(
@@ -567,10 +633,10 @@ class DynamicProjectedFragment {
     if (ie_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().OuterNbr(ie_pos);
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().OuterNbr(ie_pos).cbegin(),
-        fragment_->inner_edge_space().OuterNbr(ie_pos).cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(ie_pos, nbrs.cbegin()));
   }
 
   inline projected_adj_linked_list_t GetOutgoingAdjList(const vertex_t& v) {
@@ -578,10 +644,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto& nbrs = fragment_->inner_edge_space()[oe_pos];
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space()[oe_pos].begin(),
-        fragment_->inner_edge_space()[oe_pos].end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(oe_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetOutgoingAdjList(
@@ -590,10 +656,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto& nbrs = fragment_->inner_edge_space()[oe_pos];
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space()[oe_pos].cbegin(),
-        fragment_->inner_edge_space()[oe_pos].cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(oe_pos, nbrs.cbegin()));
   }
 
   inline projected_adj_linked_list_t GetOutgoingInnerVertexAdjList(
@@ -602,10 +668,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().InnerNbr(oe_pos);
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().InnerNbr(oe_pos).begin(),
-        fragment_->inner_edge_space().InnerNbr(oe_pos).end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(oe_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetOutgoingInnerVertexAdjList(
@@ -614,10 +680,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().InnerNbr(oe_pos);
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().InnerNbr(oe_pos).cbegin(),
-        fragment_->inner_edge_space().InnerNbr(oe_pos).cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(oe_pos, nbrs.cbegin()));
   }
 
   inline projected_adj_linked_list_t GetOutgoingOuterVertexAdjList(
@@ -626,10 +692,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().OuterNbr(oe_pos);
     return projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().OuterNbr(oe_pos).begin(),
-        fragment_->inner_edge_space().OuterNbr(oe_pos).end());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.begin(),
+        nbrs.end(), edataOf(oe_pos, nbrs.begin()));
   }
 
   inline const_projected_adj_linked_list_t GetOutgoingOuterVertexAdjList(
@@ -638,10 +704,10 @@ class DynamicProjectedFragment {
     if (oe_pos == -1) {
       return const_projected_adj_linked_list_t();
     }
+    auto nbrs = fragment_->inner_edge_space().OuterNbr(oe_pos);
     return const_projected_adj_linked_list_t(
-        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_,
-        fragment_->inner_edge_space().OuterNbr(oe_pos).cbegin(),
-        fragment_->inner_edge_space().OuterNbr(oe_pos).cend());
+        fragment_->id_mask(), fragment_->ivnum(), e_prop_key_, nbrs.cbegin(),
+        nbrs.cend(), edataOf(oe_pos, nbrs.cbegin()));
   }
 
   inline fid_t fid() const { return fragment_->fid_; }
@@ -686,6 +752,9 @@ class DynamicProjectedFragment {
 
   inline vdata_t GetData(const vertex_t& v) const {
     assert(fragment_->IsInnerVertex(v));
+    if (v_column_ != nullptr) {
+      return (*v_column_)[v.GetValue()];
+    }
     auto data = fragment_->vdata()[v.GetValue()];
     return dynamic_projected_fragment_impl::unpack_dynamic<vdata_t>(
         data, v_prop_key_);
@@ -695,6 +764,9 @@ class DynamicProjectedFragment {
     assert(fragment_->IsInnerVertex(v));
     dynamic_projected_fragment_impl::pack_dynamic(
         fragment_->vdata()[v.GetValue()][v_prop_key_], val);
+    if (v_column_ != nullptr) {
+      v_column_->Set(v.GetValue(), val);
+    }
   }
 
   inline bool HasChild(const vertex_t& v) const {
@@ -805,8 +877,44 @@ class DynamicProjectedFragment {
     return fragment_->MirrorVertices(fid);
   }
 
+  /**
+   * @brief Returns the projected data of the outgoing edges of v, where the
+   * i-th element belongs to the i-th neighbor of GetOutgoingAdjList(v).
+   *
+   * @return nullptr if the edge property can not be materialized as a typed
+   * column, in which case the adjacent list should be used instead.
+   */
+  inline const edata_t* GetOutgoingEdgeDataArray(const vertex_t& v) const {
+    auto oe_pos = fragment_->inner_oe_pos()[v.GetValue()];
+    if (e_column_ == nullptr || oe_pos == -1) {
+      return nullptr;
+    }
+    return e_column_->data(oe_pos);
+  }
+
+  /**
+   * @brief Returns the projected data of the incoming edges of v, aligned with
+   * GetIncomingAdjList(v).
+   *
+   * @return nullptr if the edge property can not be materialized as a typed
+   * column, in which case the adjacent list should be used instead.
+   */
+  inline const edata_t* GetIncomingEdgeDataArray(const vertex_t& v) const {
+    auto ie_pos = fragment_->inner_ie_pos()[v.GetValue()];
+    if (e_column_ == nullptr || ie_pos == -1) {
+      return nullptr;
+    }
+    return e_column_->data(ie_pos);
+  }
+
   void PrepareToRunApp(grape::MessageStrategy strategy, bool need_split_edges) {
     fragment_->PrepareToRunApp(strategy, need_split_edges);
+    // the columns are dropped by the fragment on mutation, so they are
+    // fetched again for every app.
+    v_column_ = dynamic_projected_fragment_impl::get_vertex_column<vdata_t>(
+        fragment_, v_prop_key_);
+    e_column_ = dynamic_projected_fragment_impl::get_edge_column<edata_t>(
+        fragment_, e_prop_key_);
   }
 
   bl::result<folly::dynamic::Type> GetOidType(
@@ -814,10 +922,28 @@ class DynamicProjectedFragment {
     return fragment_->GetOidType(comm_spec);
   }
 
+  const MutationLog<vid_t>& mutation_log() const {
+    return fragment_->mutation_log();
+  }
+
+  std::string projection_key() const { return v_prop_key_ + ":" + e_prop_key_; }
+
  private:
+  // the typed data of the edges from begin in the slot pos of the edge space
+  template <typename ITER_T>
+  inline const edata_t* edataOf(int32_t pos, ITER_T begin) const {
+    if (e_column_ == nullptr) {
+      return nullptr;
+    }
+    auto& nbrs = fragment_->inner_edge_space()[pos];
+    return e_column_->data(pos) + (begin - nbrs.cbegin());
+  }
+
   fragment_t* fragment_;
   std::string v_prop_key_;
   std::string e_prop_key_;
+  dynamic_fragment_impl::VertexColumn<vdata_t>* v_column_ = nullptr;
+  dynamic_fragment_impl::EdgeColumn<edata_t>* e_column_ = nullptr;
 
   static_assert(std::is_same<int, VDATA_T>::value ||
                     std::is_same<int64_t, VDATA_T>::value ||
@@ -0,0 +1,175 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_FILTER_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_FILTER_H_
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arrow/array.h"
+
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+enum class CompareOp {
+  kLt,
+  kLe,
+  kGt,
+  kGe,
+  kEq,
+  kNe,
+};
+
+/**
+ * @brief A predicate on a numeric property of the edges, i.e., prop op value,
+ * by which a projection keeps the edges passing it only.
+ */
+struct EdgeFilter {
+  vineyard::property_graph_types::PROP_ID_TYPE prop_id;
+  CompareOp op;
+  double value;
+};
+
+/**
+ * @brief Parses the edge filter in the form of "<prop_id> <op> <value>",
+ * where op is one of <, <=, >, >=, == and !=, e.g., "0 > 2.5".
+ */
+inline bl::result<EdgeFilter> ParseEdgeFilter(const std::string& str) {
+  std::istringstream iss(str);
+  EdgeFilter filter;
+  std::string op;
+  if (!(iss >> filter.prop_id >> op >> filter.value)) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Invalid edge filter: " + str +
+                        ", expects <prop_id> <op> <value>");
+  }
+  if (op == "<") {
+    filter.op = CompareOp::kLt;
+  } else if (op == "<=") {
+    filter.op = CompareOp::kLe;
+  } else if (op == ">") {
+    filter.op = CompareOp::kGt;
+  } else if (op == ">=") {
+    filter.op = CompareOp::kGe;
+  } else if (op == "==") {
+    filter.op = CompareOp::kEq;
+  } else if (op == "!=") {
+    filter.op = CompareOp::kNe;
+  } else {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Unknown operator of edge filter: " + op +
+                        ", expects <, <=, >, >=, == or !=");
+  }
+  return filter;
+}
+
+namespace edge_filter_impl {
+
+// the branch free loops, which compilers vectorize
+template <typename T, typename CMP_T>
+void evaluate(const T* values, int64_t length, const CMP_T& cmp,
+              std::vector<uint8_t>& mask) {
+  uint8_t* out = mask.data();
+  for (int64_t i = 0; i < length; ++i) {
+    out[i] = static_cast<uint8_t>(cmp(static_cast<double>(values[i])));
+  }
+}
+
+template <typename T>
+void evaluate(const T* values, int64_t length, CompareOp op, double value,
+              std::vector<uint8_t>& mask) {
+  switch (op) {
+  case CompareOp::kLt:
+    evaluate(values, length, [value](double x) { return x < value; }, mask);
+    break;
+  case CompareOp::kLe:
+    evaluate(values, length, [value](double x) { return x <= value; }, mask);
+    break;
+  case CompareOp::kGt:
+    evaluate(values, length, [value](double x) { return x > value; }, mask);
+    break;
+  case CompareOp::kGe:
+    evaluate(values, length, [value](double x) { return x >= value; }, mask);
+    break;
+  case CompareOp::kEq:
+    evaluate(values, length, [value](double x) { return x == value; }, mask);
+    break;
+  case CompareOp::kNe:
+    evaluate(values, length, [value](double x) { return x != value; }, mask);
+    break;
+  }
+}
+
+// reads the buffer of the values, which is shared by the dates and the
+// timestamps with the integers of the same width
+template <typename T>
+void evaluate(const arrow::Array& column, CompareOp op, double value,
+              std::vector<uint8_t>& mask) {
+  evaluate(column.data()->GetValues<T>(1), column.length(), op, value, mask);
+}
+
+}  // namespace edge_filter_impl
+
+/**
+ * @brief Evaluates the filter over the column of the edge property, into a
+ * byte per edge, by the edge ids. The dates and the timestamps are compared
+ * by their integral values. The null values pass the filter as the values
+ * under them.
+ */
+inline bl::result<std::vector<uint8_t>> EvaluateEdgeFilter(
+    const EdgeFilter& filter, const std::shared_ptr<arrow::Array>& column) {
+  std::vector<uint8_t> mask(column->length());
+  auto op = filter.op;
+  auto value = filter.value;
+  switch (column->type_id()) {
+  case arrow::Type::INT32:
+  case arrow::Type::DATE32:
+    edge_filter_impl::evaluate<int32_t>(*column, op, value, mask);
+    break;
+  case arrow::Type::INT64:
+  case arrow::Type::DATE64:
+  case arrow::Type::TIMESTAMP:
+    edge_filter_impl::evaluate<int64_t>(*column, op, value, mask);
+    break;
+  case arrow::Type::UINT32:
+    edge_filter_impl::evaluate<uint32_t>(*column, op, value, mask);
+    break;
+  case arrow::Type::UINT64:
+    edge_filter_impl::evaluate<uint64_t>(*column, op, value, mask);
+    break;
+  case arrow::Type::FLOAT:
+    edge_filter_impl::evaluate<float>(*column, op, value, mask);
+    break;
+  case arrow::Type::DOUBLE:
+    edge_filter_impl::evaluate<double>(*column, op, value, mask);
+    break;
+  default:
+    RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                    "Cannot filter the edges by the property of type " +
+                        column->type()->ToString());
+  }
+  return mask;
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_FILTER_H_
@@ -0,0 +1,106 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_WINDOW_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_WINDOW_H_
+
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "arrow/array.h"
+
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+/**
+ * @brief A window [begin, end) of the times of the edges, i.e., the values of
+ * an integral, date or timestamp property, to which a projection restricts
+ * the adjacency lists.
+ */
+struct EdgeWindow {
+  vineyard::property_graph_types::PROP_ID_TYPE prop_id;
+  int64_t begin;
+  int64_t end;
+};
+
+/**
+ * @brief Parses the edge window in the form of "<prop_id> <begin> <end>",
+ * e.g., "1 1609459200 1610064000".
+ */
+inline bl::result<EdgeWindow> ParseEdgeWindow(const std::string& str) {
+  std::istringstream iss(str);
+  EdgeWindow window;
+  if (!(iss >> window.prop_id >> window.begin >> window.end)) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Invalid edge window: " + str +
+                        ", expects <prop_id> <begin> <end>");
+  }
+  if (window.begin > window.end) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "The begin of edge window is after the end: " + str);
+  }
+  return window;
+}
+
+/**
+ * @brief The times of the edges by the edge ids, read from the buffer of the
+ * column, which is shared by the dates and the timestamps with the integers
+ * of the same width. The null values are the values under them.
+ */
+class EdgeTimes {
+ public:
+  bl::result<void> Init(const std::shared_ptr<arrow::Array>& column) {
+    column_ = column;
+    values32_ = nullptr;
+    values64_ = nullptr;
+    if (column == nullptr) {
+      return {};
+    }
+    switch (column->type_id()) {
+    case arrow::Type::INT32:
+    case arrow::Type::DATE32:
+      values32_ = column->data()->GetValues<int32_t>(1);
+      break;
+    case arrow::Type::INT64:
+    case arrow::Type::DATE64:
+    case arrow::Type::TIMESTAMP:
+      values64_ = column->data()->GetValues<int64_t>(1);
+      break;
+    default:
+      RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                      "Cannot window the edges by the property of type " +
+                          column->type()->ToString());
+    }
+    return {};
+  }
+
+  inline int64_t operator[](int64_t eid) const {
+    return values64_ != nullptr ? values64_[eid] : values32_[eid];
+  }
+
+ private:
+  std::shared_ptr<arrow::Array> column_;
+  const int32_t* values32_ = nullptr;
+  const int64_t* values64_ = nullptr;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_EDGE_WINDOW_H_
@@ -0,0 +1,119 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_MUTATION_LOG_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_MUTATION_LOG_H_
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+/**
+ * @brief MutationLog records the edges added to a fragment by the gids of the
+ * endpoints, so the results of a monotone app computed at a version can be
+ * resumed from the edges added since then. The other mutations, i.e., the
+ * deletions, the updates and the rebuilding of the fragment, reset the log,
+ * after which only the later versions can be resumed. The log is reset as
+ * well once it holds more than kCapacity edges.
+ *
+ * @tparam VID_T
+ */
+template <typename VID_T>
+class MutationLog {
+ public:
+  static constexpr size_t kCapacity = 1 << 22;
+
+  MutationLog() : uid_(nextUid()) { offsets_.push_back(0); }
+
+  // the unique id of the log in the process, as the address of a fragment may
+  // be reused by another one
+  uint64_t uid() const { return uid_; }
+
+  uint64_t version() const { return version_; }
+
+  template <typename EDGE_T>
+  void AddEdges(const std::vector<EDGE_T>& edges) {
+    ++version_;
+    if (added_.size() + edges.size() > kCapacity) {
+      reset();
+      return;
+    }
+    for (auto& e : edges) {
+      added_.emplace_back(e.src(), e.dst());
+    }
+    offsets_.push_back(added_.size());
+  }
+
+  // adds the edges given by the gids of the endpoints
+  void AddEdgeGids(const std::vector<std::pair<VID_T, VID_T>>& edges) {
+    ++version_;
+    if (added_.size() + edges.size() > kCapacity) {
+      reset();
+      return;
+    }
+    added_.insert(added_.end(), edges.begin(), edges.end());
+    offsets_.push_back(added_.size());
+  }
+
+  void Reset() {
+    ++version_;
+    reset();
+  }
+
+  /**
+   * @brief Finds the edges added after version, which are
+   * added_edges()[begin, end). Returns false if they are not recorded.
+   */
+  bool AddedSince(uint64_t version, size_t& begin, size_t& end) const {
+    if (version < base_version_ || version > version_) {
+      return false;
+    }
+    begin = offsets_[version - base_version_];
+    end = added_.size();
+    return true;
+  }
+
+  const std::vector<std::pair<VID_T, VID_T>>& added_edges() const {
+    return added_;
+  }
+
+ private:
+  static uint64_t nextUid() {
+    static std::atomic<uint64_t> uid(0);
+    return uid++;
+  }
+
+  void reset() {
+    base_version_ = version_;
+    added_.clear();
+    added_.shrink_to_fit();
+    offsets_.assign(1, 0);
+  }
+
+  uint64_t uid_;
+  uint64_t version_ = 0;
+  // the versions before it are not recorded
+  uint64_t base_version_ = 0;
+  std::vector<std::pair<VID_T, VID_T>> added_;
+  // offsets_[i] is the number of the edges added up to base_version_ + i
+  std::vector<size_t> offsets_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_MUTATION_LOG_H_
@@ -0,0 +1,154 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_SORTED_ADJ_LIST_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_SORTED_ADJ_LIST_H_
+
+#include <algorithm>
+#include <cstddef>
+
+namespace gs {
+
+// the ratio of the lengths of the lists from which the longer one is
+// galloped through instead of merged
+static constexpr size_t kGallopRatio = 32;
+
+/**
+ * @brief Sorts the nbr units of a vertex by the vids, and the edge ids of the
+ * same vid, so the parallel edges are adjacent.
+ */
+template <typename NBR_UNIT_T>
+inline void SortNbrUnits(NBR_UNIT_T* begin, NBR_UNIT_T* end) {
+  std::sort(begin, end, [](const NBR_UNIT_T& lhs, const NBR_UNIT_T& rhs) {
+    return lhs.vid < rhs.vid || (lhs.vid == rhs.vid && lhs.eid < rhs.eid);
+  });
+}
+
+/**
+ * @brief Returns the first of the elements in [begin, end), sorted by the
+ * keys, of which key_of is not less than key, by probing at the doubling
+ * distances from begin and a binary search in the last gap. It takes
+ * O(log d) to skip d elements, so a long list is advanced through cheaply by
+ * the keys of a short one.
+ */
+template <typename T, typename KEY_T, typename KEY_OF_T>
+inline const T* GallopLowerBound(const T* begin, const T* end, KEY_T key,
+                                 const KEY_OF_T& key_of) {
+  const T* low = begin;
+  const T* high = begin;
+  size_t step = 1;
+  while (high < end && key_of(*high) < key) {
+    low = high + 1;
+    high = static_cast<size_t>(end - high) > step ? high + step : end;
+    step <<= 1;
+  }
+  return std::lower_bound(
+      low, high, key,
+      [&key_of](const T& elem, KEY_T value) { return key_of(elem) < value; });
+}
+
+/**
+ * @brief Calls func(a, a_end, b, b_end) for each key in both of the lists
+ * sorted by the keys, where [a, a_end) and [b, b_end) are the runs of the
+ * elements of the key in the lists respectively, and returns the number of
+ * such keys. The lists are merged when of the similar lengths, or else the
+ * longer one is galloped through by the shorter one, see GallopLowerBound.
+ * The triangle kernel and the link similarities intersect by it as well.
+ */
+template <typename T, typename KEY_OF_T, typename FUNC_T>
+inline size_t IntersectSortedRuns(const T* a_begin, const T* a_end,
+                                  const T* b_begin, const T* b_end,
+                                  const KEY_OF_T& key_of, const FUNC_T& func) {
+  auto run_end = [&key_of](const T* begin, const T* end) {
+    auto key = key_of(*begin);
+    while (++begin < end && key_of(*begin) == key) {
+    }
+    return begin;
+  };
+  size_t a_len = a_end - a_begin, b_len = b_end - b_begin;
+  size_t count = 0;
+  if (a_len * kGallopRatio < b_len || b_len * kGallopRatio < a_len) {
+    bool swapped = a_len > b_len;
+    const T* s = swapped ? b_begin : a_begin;
+    const T* s_end = swapped ? b_end : a_end;
+    const T* l = swapped ? a_begin : b_begin;
+    const T* l_end = swapped ? a_end : b_end;
+    while (s < s_end && l < l_end) {
+      l = GallopLowerBound(l, l_end, key_of(*s), key_of);
+      if (l == l_end) {
+        break;
+      }
+      const T* s_next = run_end(s, s_end);
+      if (key_of(*l) == key_of(*s)) {
+        const T* l_next = run_end(l, l_end);
+        swapped ? func(l, l_next, s, s_next) : func(s, s_next, l, l_next);
+        ++count;
+        l = l_next;
+      }
+      s = s_next;
+    }
+    return count;
+  }
+  while (a_begin < a_end && b_begin < b_end) {
+    if (key_of(*a_begin) < key_of(*b_begin)) {
+      ++a_begin;
+    } else if (key_of(*b_begin) < key_of(*a_begin)) {
+      ++b_begin;
+    } else {
+      const T* a_next = run_end(a_begin, a_end);
+      const T* b_next = run_end(b_begin, b_end);
+      func(a_begin, a_next, b_begin, b_next);
+      ++count;
+      a_begin = a_next;
+      b_begin = b_next;
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Whether a nbr unit in [begin, end), sorted by the vids, is of vid.
+ */
+template <typename NBR_UNIT_T, typename VID_T>
+inline bool SortedNbrUnitsContain(const NBR_UNIT_T* begin,
+                                  const NBR_UNIT_T* end, VID_T vid) {
+  auto iter = std::lower_bound(
+      begin, end, vid,
+      [](const NBR_UNIT_T& nbr, VID_T value) { return nbr.vid < value; });
+  return iter != end && iter->vid == vid;
+}
+
+/**
+ * @brief Calls func(a, b) for each vid in both of the lists of the nbr units
+ * sorted by the vids, once per vid, where a and b are the first units of the
+ * vid in the lists respectively, and returns the number of such vids, see
+ * IntersectSortedRuns.
+ */
+template <typename NBR_UNIT_T, typename FUNC_T>
+inline size_t IntersectSortedNbrUnits(const NBR_UNIT_T* a_begin,
+                                      const NBR_UNIT_T* a_end,
+                                      const NBR_UNIT_T* b_begin,
+                                      const NBR_UNIT_T* b_end,
+                                      const FUNC_T& func) {
+  return IntersectSortedRuns(
+      a_begin, a_end, b_begin, b_end,
+      [](const NBR_UNIT_T& nbr) { return nbr.vid; },
+      [&func](const NBR_UNIT_T* a, const NBR_UNIT_T*, const NBR_UNIT_T* b,
+              const NBR_UNIT_T*) { func(*a, *b); });
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_SORTED_ADJ_LIST_H_
@@ -0,0 +1,183 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_FRAGMENT_VERTEX_ORDER_H_
+#define ANALYTICAL_ENGINE_CORE_FRAGMENT_VERTEX_ORDER_H_
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grape/graph/vertex.h"
+#include "grape/parallel/parallel_engine.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+/**
+ * @brief The orders to traverse the inner vertices of a fragment in, so the
+ * vertices visited one after another share their neighbors. kDegree sorts
+ * the vertices by the degrees, from the largest one, kBfs is the order of the
+ * breadth first searches from the vertices in the order of the lids, and
+ * kRcm is the reverse Cuthill-McKee order, i.e., the breadth first searches
+ * from the vertices of the least degrees, with the neighbors visited by the
+ * degrees, reversed.
+ */
+enum class VertexOrder {
+  kNone,
+  kDegree,
+  kBfs,
+  kRcm,
+};
+
+inline bl::result<VertexOrder> ParseVertexOrder(const std::string& name) {
+  if (name.empty() || name == "none") {
+    return VertexOrder::kNone;
+  } else if (name == "degree") {
+    return VertexOrder::kDegree;
+  } else if (name == "bfs") {
+    return VertexOrder::kBfs;
+  } else if (name == "rcm") {
+    return VertexOrder::kRcm;
+  }
+  RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                  "Unknown vertex order: " + name +
+                      ", expects none, degree, bfs or rcm");
+}
+
+namespace vertex_order_impl {
+
+// the breadth first search from root, appends the visited vertices to order
+template <typename VID_T>
+void bfs(VID_T root, const std::vector<size_t>& offsets,
+         const std::vector<VID_T>& nbrs, bool by_degree,
+         std::vector<bool>& visited, std::vector<VID_T>& order) {
+  size_t head = order.size();
+  visited[root] = true;
+  order.push_back(root);
+  while (head < order.size()) {
+    VID_T v = order[head++];
+    size_t begin = order.size();
+    for (size_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+      VID_T u = nbrs[i];
+      if (!visited[u]) {
+        visited[u] = true;
+        order.push_back(u);
+      }
+    }
+    if (by_degree) {
+      std::stable_sort(order.begin() + begin, order.end(),
+                       [&offsets](VID_T lhs, VID_T rhs) {
+                         return offsets[lhs + 1] - offsets[lhs] <
+                                offsets[rhs + 1] - offsets[rhs];
+                       });
+    }
+  }
+}
+
+}  // namespace vertex_order_impl
+
+/**
+ * @brief Computes the order of the vertices [0, n) of a graph in the csr
+ * format, i.e., the neighbors of v are nbrs[offsets[v], offsets[v + 1]),
+ * which are usually the inner neighbors of the inner vertices by the offsets.
+ * Returns the vertices in the order.
+ */
+template <typename VID_T>
+std::vector<VID_T> ComputeVertexOrder(VertexOrder order,
+                                      const std::vector<size_t>& offsets,
+                                      const std::vector<VID_T>& nbrs) {
+  VID_T n = static_cast<VID_T>(offsets.size() - 1);
+  std::vector<VID_T> result;
+  result.reserve(n);
+  auto degree = [&offsets](VID_T v) { return offsets[v + 1] - offsets[v]; };
+
+  if (order == VertexOrder::kDegree || order == VertexOrder::kRcm) {
+    for (VID_T v = 0; v < n; ++v) {
+      result.push_back(v);
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [&degree](VID_T lhs, VID_T rhs) {
+                       return degree(lhs) > degree(rhs);
+                     });
+    if (order == VertexOrder::kDegree) {
+      return result;
+    }
+  }
+
+  std::vector<VID_T> roots;
+  if (order == VertexOrder::kRcm) {
+    // the roots of the least degrees first
+    roots.assign(result.rbegin(), result.rend());
+    result.clear();
+  } else {
+    for (VID_T v = 0; v < n; ++v) {
+      roots.push_back(v);
+    }
+  }
+  std::vector<bool> visited(n, false);
+  for (auto root : roots) {
+    if (!visited[root]) {
+      vertex_order_impl::bfs(root, offsets, nbrs, order == VertexOrder::kRcm,
+                             visited, result);
+    }
+  }
+  if (order == VertexOrder::kRcm) {
+    std::reverse(result.begin(), result.end());
+  }
+  return result;
+}
+
+template <typename FRAG_T, typename = void>
+struct has_inner_vertex_order : std::false_type {};
+
+template <typename FRAG_T>
+struct has_inner_vertex_order<
+    FRAG_T, decltype(void(std::declval<const FRAG_T&>().InnerVertexOrder()))>
+    : std::true_type {};
+
+/**
+ * @brief Applies func to the inner vertices of the fragment by the engine, in
+ * the order given at the projection if any, or in the order of the lids.
+ */
+template <typename FRAG_T, typename FUNC_T>
+typename std::enable_if<has_inner_vertex_order<FRAG_T>::value>::type
+ForEachInnerVertex(grape::ParallelEngine& engine, const FRAG_T& frag,
+                   const FUNC_T& func) {
+  using vid_t = typename FRAG_T::vid_t;
+  auto& order = frag.InnerVertexOrder();
+  if (order.empty()) {
+    engine.ForEach(frag.InnerVertices(), func);
+    return;
+  }
+  engine.ForEach(grape::VertexRange<vid_t>(0, static_cast<vid_t>(order.size())),
+                 [&order, &func](int tid, grape::Vertex<vid_t> i) {
+                   func(tid, order[i.GetValue()]);
+                 });
+}
+
+template <typename FRAG_T, typename FUNC_T>
+typename std::enable_if<!has_inner_vertex_order<FRAG_T>::value>::type
+ForEachInnerVertex(grape::ParallelEngine& engine, const FRAG_T& frag,
+                   const FUNC_T& func) {
+  engine.ForEach(frag.InnerVertices(), func);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_FRAGMENT_VERTEX_ORDER_H_
@@ -13,9 +13,16 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <csignal>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <utility>
+#include <vector>
+
+#include "boost/property_tree/json_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
 
 #include "core/config.h"
 #include "core/flags.h"
@@ -56,17 +63,35 @@ class GrapeEngine {
     dag_file_ = std::move(dag_file);
   }
 
+  /**
+   * @brief Starts the components. The RPC server starts first, whose
+   * requests are queued until the dispatcher starts, and the vineyard client
+   * connects in the background, so the RPC server, vineyardd and the
+   * connection start concurrently.
+   */
   void Start() {
-    vineyard_server_->Start();
-    grape_instance_->Init(vineyard_server_->vineyard_socket());
+    auto start = std::chrono::steady_clock::now();
     dispatcher_->Subscribe(grape_instance_);
-
     if (rpc_server_ != nullptr) {
       service_thread_ = std::thread([this]() { rpc_server_->StartServer(); });
     }
+
+    vineyard_server_->Start();
+    AddStartupPhase("vineyard", secondsSince(start));
+
+    start = std::chrono::steady_clock::now();
+    grape_instance_->Init(vineyard_server_->vineyard_socket());
+    AddStartupPhase("instance_init", secondsSince(start));
+
+    reportStartup();
     dispatcher_->Start();
   }
 
+  // the phases before Start, e.g., initializing MPI
+  void AddStartupPhase(const std::string& name, double seconds) {
+    startup_phases_.emplace_back(name, seconds);
+  }
+
   void Stop() {
     if (rpc_server_) {
       LOG(INFO) << "grape-engine (master) RPC server is stopping...";
@@ -108,11 +133,39 @@ class GrapeEngine {
   }
 
  private:
+  static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  }
+
+  // logs the time of each phase of the startup, the most of the workers
+  void reportStartup() {
+    std::vector<double> seconds, max_seconds(startup_phases_.size());
+    for (auto& phase : startup_phases_) {
+      seconds.push_back(phase.second);
+    }
+    MPI_Reduce(seconds.data(), max_seconds.data(),
+               static_cast<int>(seconds.size()), MPI_DOUBLE, MPI_MAX,
+               grape::kCoordinatorRank, comm_spec_.comm());
+    if (comm_spec_.worker_id() != grape::kCoordinatorRank) {
+      return;
+    }
+    boost::property_tree::ptree pt;
+    for (size_t i = 0; i < startup_phases_.size(); ++i) {
+      pt.put(startup_phases_[i].first, max_seconds[i]);
+    }
+    std::stringstream ss;
+    boost::property_tree::json_parser::write_json(ss, pt, false);
+    LOG(INFO) << "Startup phases of grape-engine in seconds: " << ss.str();
+  }
+
   GrapeEngine() {
     comm_spec_.Init(MPI_COMM_WORLD);
     vineyard_server_ = std::make_shared<VineyardServer>(comm_spec_);
     grape_instance_ = std::make_shared<GrapeInstance>(comm_spec_);
-    dispatcher_ = std::make_shared<Dispatcher>(comm_spec_);
+    dispatcher_ =
+        std::make_shared<Dispatcher>(comm_spec_, FLAGS_dispatcher_lanes);
   }
 
   grape::CommSpec comm_spec_;
@@ -122,6 +175,7 @@ class GrapeEngine {
   std::shared_ptr<rpc::AnalyticalServer> rpc_server_;
   std::string dag_file_;
   std::thread service_thread_;
+  std::vector<std::pair<std::string, double>> startup_phases_;
 };
 }  // namespace gs
 static std::shared_ptr<gs::GrapeEngine> grape_engine_ptr;
@@ -163,18 +217,27 @@ int main(int argc, char* argv[]) {
   google::InstallFailureSignalHandler();
 
   // InitMPI
+  auto mpi_start = std::chrono::steady_clock::now();
   grape::InitMPIComm();
+  std::chrono::duration<double> mpi_init =
+      std::chrono::steady_clock::now() - mpi_start;
 
   auto host = FLAGS_host;
   auto port = FLAGS_port;
   auto dag_file = FLAGS_dag_file;
 
+  auto engine_start = std::chrono::steady_clock::now();
   if (dag_file.empty()) {
     grape_engine_ptr = std::make_shared<gs::GrapeEngine>(host, port);
   } else {
     grape_engine_ptr = std::make_shared<gs::GrapeEngine>(dag_file);
   }
 
+  std::chrono::duration<double> engine_init =
+      std::chrono::steady_clock::now() - engine_start;
+  grape_engine_ptr->AddStartupPhase("mpi_init", mpi_init.count());
+  grape_engine_ptr->AddStartupPhase("engine_init", engine_init.count());
+
   InstallSignalHandlers(&master_signal_handler);
   grape_engine_ptr->Start();
 
@@ -13,24 +13,36 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "grape/io/local_io_adaptor.h"
+
 #include "core/context/tensor_context.h"
 #include "core/context/vertex_data_context.h"
 #include "core/context/vertex_property_context.h"
+#include "core/flags.h"
 #include "core/fragment/dynamic_fragment.h"
 #include "core/fragment/dynamic_fragment_reporter.h"
 #include "core/grape_instance.h"
+#include "core/io/arrow_file_writer.h"
+#include "core/io/dynamic_batch_parser.h"
 #include "core/io/property_parser.h"
 #include "core/launcher.h"
+#include "core/loader/arrow_fragment_snapshot.h"
 #include "core/object/app_entry.h"
 #include "core/object/graph_utils.h"
 #include "core/object/i_fragment_wrapper.h"
 #include "core/object/projector.h"
 #include "core/server/rpc_utils.h"
+#include "core/utils/memory_strategy.h"
+#include "core/utils/parallel_utils.h"
+#include "core/utils/transform_utils.h"
 #include "proto/types.pb.h"
 
 namespace gs {
@@ -38,9 +50,31 @@ namespace gs {
 GrapeInstance::GrapeInstance(const grape::CommSpec& comm_spec)
     : comm_spec_(comm_spec) {}
 
+GrapeInstance::~GrapeInstance() {
+  if (connect_thread_.joinable()) {
+    connect_thread_.join();
+  }
+}
+
 void GrapeInstance::Init(const std::string& vineyard_socket) {
-  EnsureClient(client_, vineyard_socket);
-  if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+  if (!ParseNumaPolicy(FLAGS_numa_policy, numa_policy_)) {
+    LOG(FATAL) << "Unknown NUMA policy: " << FLAGS_numa_policy
+               << ", expects none, interleave or local";
+  }
+  // before the threads of the dispatcher start, which inherit the policy
+  ApplyNumaMemoryPolicy(comm_spec_, numa_policy_);
+
+  // connects to vineyardd in the background, which may be still starting,
+  // and the commands using the client wait for it
+  vineyard_socket_ = vineyard_socket;
+  connect_thread_ = std::thread([this]() { client(); });
+  object_manager_.projection_cache().SetCapacity(
+      static_cast<size_t>(FLAGS_projection_cache_bytes));
+  object_manager_.query_cache().SetCapacity(
+      static_cast<size_t>(FLAGS_query_cache_bytes));
+  object_manager_.SetMemoryBudget(
+      static_cast<size_t>(FLAGS_memory_budget_bytes));
+  if (comm_spec().worker_id() == grape::kCoordinatorRank) {
     VLOG(1) << "Workers of grape-engine initialized.";
   }
 }
@@ -61,11 +95,21 @@ bl::result<rpc::GraphDef> GrapeInstance::loadGraph(
     VLOG(1) << "Loading graph, graph name: " << graph_name
             << ", graph type: DynamicFragment, directed: " << directed;
 
-    auto vm_ptr = std::shared_ptr<vertex_map_t>(new vertex_map_t(comm_spec_));
+    auto vm_ptr = std::shared_ptr<vertex_map_t>(new vertex_map_t(comm_spec()));
     vm_ptr->Init();
 
     auto fragment = std::make_shared<fragment_t>(vm_ptr);
-    fragment->Init(comm_spec_.fid(), directed);
+    fragment->Init(comm_spec().fid(), directed);
+    if (params.HasKey(rpc::MEMORY_STRATEGY)) {
+      BOOST_LEAF_AUTO(strategy_str,
+                      params.Get<std::string>(rpc::MEMORY_STRATEGY));
+      MemoryStrategy strategy;
+      if (!MemoryStrategy::Parse(strategy_str, strategy)) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                        "Invalid memory strategy: " + strategy_str);
+      }
+      fragment->SetMemoryStrategy(strategy);
+    }
 
     rpc::GraphDef graph_def;
 
@@ -104,7 +148,7 @@ bl::result<rpc::GraphDef> GrapeInstance::loadGraph(
 
     BOOST_LEAF_AUTO(graph_utils,
                     object_manager_.GetObject<PropertyGraphUtils>(type_sig));
-    BOOST_LEAF_AUTO(wrapper, graph_utils->LoadGraph(comm_spec_, *client_,
+    BOOST_LEAF_AUTO(wrapper, graph_utils->LoadGraph(comm_spec(), *client(),
                                                     graph_name, params));
     BOOST_LEAF_CHECK(object_manager_.PutObject(wrapper));
 
@@ -118,25 +162,81 @@ bl::result<rpc::GraphDef> GrapeInstance::loadGraph(
 
 bl::result<void> GrapeInstance::unloadGraph(const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+  vineyard::ObjectID frag_group_id = vineyard::InvalidObjectID();
   if (params.HasKey(rpc::VINEYARD_ID)) {
-    BOOST_LEAF_AUTO(frag_group_id, params.Get<int64_t>(rpc::VINEYARD_ID));
+    BOOST_LEAF_ASSIGN(frag_group_id, params.Get<int64_t>(rpc::VINEYARD_ID));
+  }
+  bool existed = object_manager_.HasObject(graph_name);
+  BOOST_LEAF_CHECK(removeObject(graph_name, frag_group_id));
+  if (!existed) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Object " + graph_name + " does not exist");
+  }
+  return {};
+}
+
+bl::result<void> GrapeInstance::removeObject(const std::string& id,
+                                             vineyard::ObjectID frag_group_id) {
+  // the cached projection is no longer handed out, and the vineyard objects
+  // shared with the aliases of a projection are kept until the last of them
+  // is unloaded, which must be agreed by all workers
+  object_manager_.projection_cache().EraseProjection(id);
+  int owned = !object_manager_.FragmentShared(id);
+  int all_owned = 0;
+  MPI_Allreduce(&owned, &all_owned, 1, MPI_INT, MPI_MIN, comm_spec().comm());
+  if (!all_owned) {
+    frag_group_id = vineyard::InvalidObjectID();
+  }
+  // the fragment built by the engine on this worker, e.g., a projection,
+  // which is not a member of any fragment group
+  vineyard::ObjectID local_id = vineyard::InvalidObjectID();
+  // the property graph, of which the arrays shared by the projections are
+  // deleted with it
+  std::shared_ptr<ILabeledFragmentWrapper> labeled;
+  if (all_owned && object_manager_.HasObject(id)) {
+    BOOST_LEAF_AUTO(object, object_manager_.GetObject(id));
+    auto wrapper = std::dynamic_pointer_cast<IFragmentWrapper>(object);
+    if (wrapper != nullptr) {
+      local_id = wrapper->local_vineyard_id();
+    }
+    labeled = std::dynamic_pointer_cast<ILabeledFragmentWrapper>(object);
+  }
+  object_manager_.projection_cache().EraseSource(id);
+  object_manager_.query_cache().EraseGraph(id);
+  if (object_manager_.HasObject(id)) {
+    BOOST_LEAF_CHECK(object_manager_.RemoveObject(id));
+  }
+
+  if (frag_group_id != vineyard::InvalidObjectID()) {
     bool exists = false;
-    client_->Exists(frag_group_id, exists);
+    client()->Exists(frag_group_id, exists);
+    std::shared_ptr<vineyard::ArrowFragmentGroup> fg;
     if (exists) {
-      auto fg = std::dynamic_pointer_cast<vineyard::ArrowFragmentGroup>(
-          client_->GetObject(frag_group_id));
-      auto fid = comm_spec_.WorkerToFrag(comm_spec_.worker_id());
+      fg = std::dynamic_pointer_cast<vineyard::ArrowFragmentGroup>(
+          client()->GetObject(frag_group_id));
+    }
+    if (fg != nullptr) {
+      if (labeled != nullptr) {
+        labeled->DeleteProjectionObjects(*client());
+        labeled.reset();
+      }
+      auto fid = comm_spec().WorkerToFrag(comm_spec().worker_id());
       auto frag_id = fg->Fragments().at(fid);
-      VY_OK_OR_RAISE(client_->DelData(frag_id, false, true));
+      VY_OK_OR_RAISE(client()->DelData(frag_id, false, true));
     }
-    MPI_Barrier(comm_spec_.comm());
-    if (exists) {
-      if (comm_spec_.worker_id() == 0) {
-        VINEYARD_SUPPRESS(client_->DelData(frag_group_id, false, true));
+    MPI_Barrier(comm_spec().comm());
+    if (fg != nullptr) {
+      if (comm_spec().worker_id() == 0) {
+        VINEYARD_SUPPRESS(client()->DelData(frag_group_id, false, true));
       }
     }
   }
-  return object_manager_.RemoveObject(graph_name);
+  // the members shared with the fragment projected from, e.g., its tables,
+  // are referenced by it as well, and are kept by the non-forced deletion
+  if (local_id != vineyard::InvalidObjectID()) {
+    VY_OK_OR_RAISE(client()->DelData(local_id, false, true));
+  }
+  return {};
 }
 
 bl::result<std::string> GrapeInstance::loadApp(const rpc::GSParams& params) {
@@ -156,6 +256,12 @@ bl::result<void> GrapeInstance::unloadApp(const rpc::GSParams& params) {
   return object_manager_.RemoveObject(app_name);
 }
 
+bl::result<void> GrapeInstance::unloadContext(const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(context_key, params.Get<std::string>(rpc::CTX_NAME));
+  // the context is removed from the query cache with the last of its handles
+  return object_manager_.RemoveObject(context_key);
+}
+
 bl::result<rpc::GraphDef> GrapeInstance::projectGraph(
     const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
@@ -172,9 +278,9 @@ bl::result<rpc::GraphDef> GrapeInstance::projectGraph(
   std::string dst_graph_name = "graph_" + generateId();
 
   BOOST_LEAF_AUTO(new_frag_wrapper,
-                  frag_wrapper->Project(comm_spec_, dst_graph_name,
+                  frag_wrapper->Project(comm_spec(), dst_graph_name,
                                         project_infos[0], project_infos[1]));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(new_frag_wrapper));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(new_frag_wrapper, graph_name));
   return new_frag_wrapper->graph_def();
 }
 
@@ -189,10 +295,75 @@ bl::result<rpc::GraphDef> GrapeInstance::projectToSimple(
 
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+
+  // the property fragments are immutable, so are the projections of them
+  std::string cache_key;
+  auto& cache = object_manager_.projection_cache();
+  BOOST_LEAF_AUTO(dst_graph_type, params.Get<rpc::GraphType>(rpc::GRAPH_TYPE));
+  if (wrapper->graph_def().graph_type() == rpc::ARROW_PROPERTY &&
+      dst_graph_type == rpc::ARROW_PROJECTED) {
+    cache_key = graph_name + ":" +
+                std::to_string(wrapper->graph_def().vineyard_id()) + ":" +
+                type_sig;
+    for (auto key : {rpc::V_LABEL_ID, rpc::E_LABEL_ID, rpc::V_PROP_ID,
+                     rpc::E_PROP_ID}) {
+      BOOST_LEAF_AUTO(id, params.Get<int64_t>(key));
+      cache_key += ":" + std::to_string(id);
+    }
+    if (params.HasKey(rpc::VERTEX_ORDER)) {
+      BOOST_LEAF_AUTO(vertex_order,
+                      params.Get<std::string>(rpc::VERTEX_ORDER));
+      cache_key += ":" + vertex_order;
+    }
+    if (params.HasKey(rpc::MATERIALIZE_EDGE_DATA)) {
+      BOOST_LEAF_AUTO(materialize_edge_data,
+                      params.Get<bool>(rpc::MATERIALIZE_EDGE_DATA));
+      cache_key += materialize_edge_data ? ":inline" : "";
+    }
+    if (params.HasKey(rpc::COMPRESS_ADJACENCY)) {
+      BOOST_LEAF_AUTO(compress_adjacency,
+                      params.Get<bool>(rpc::COMPRESS_ADJACENCY));
+      cache_key += compress_adjacency ? ":compressed" : "";
+    }
+    if (params.HasKey(rpc::SORT_ADJACENCY)) {
+      BOOST_LEAF_AUTO(sort_adjacency, params.Get<bool>(rpc::SORT_ADJACENCY));
+      cache_key += sort_adjacency ? ":sorted" : "";
+    }
+    if (params.HasKey(rpc::EDGE_FILTER)) {
+      BOOST_LEAF_AUTO(edge_filter, params.Get<std::string>(rpc::EDGE_FILTER));
+      cache_key += ":" + edge_filter;
+    }
+    if (params.HasKey(rpc::EDGE_WINDOW)) {
+      BOOST_LEAF_AUTO(edge_window, params.Get<std::string>(rpc::EDGE_WINDOW));
+      cache_key += ":window:" + edge_window;
+    }
+    if (params.HasKey(rpc::OUT_OF_CORE_DIR)) {
+      BOOST_LEAF_AUTO(out_of_core_dir,
+                      params.Get<std::string>(rpc::OUT_OF_CORE_DIR));
+      cache_key += ":ooc:" + out_of_core_dir;
+    }
+    auto cached = cache.Get(cache_key);
+    // the projections may be evicted from the caches of some of the workers
+    // only, and the projection must run on all of them if so
+    int hit = cached != nullptr;
+    int all_hit = 0;
+    MPI_Allreduce(&hit, &all_hit, 1, MPI_INT, MPI_MIN, comm_spec().comm());
+    if (all_hit) {
+      VLOG(1) << "Reusing the projection " << cached->id() << " as "
+              << projected_id;
+      auto alias = std::make_shared<AliasFragmentWrapper>(projected_id, cached);
+      BOOST_LEAF_CHECK(object_manager_.PutObject(alias, graph_name));
+      return alias->graph_def();
+    }
+  }
+
   BOOST_LEAF_AUTO(projector, object_manager_.GetObject<Projector>(type_sig));
   BOOST_LEAF_AUTO(projected_wrapper,
                   projector->Project(wrapper, projected_id, params));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(projected_wrapper));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(projected_wrapper, graph_name));
+  if (!cache_key.empty()) {
+    cache.Put(cache_key, graph_name, projected_wrapper);
+  }
 
   return projected_wrapper->graph_def();
 }
@@ -205,17 +376,52 @@ bl::result<std::string> GrapeInstance::query(const rpc::GSParams& params,
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
 
+  // the arrow fragments are immutable, so the contexts of the same query on
+  // them are the same
+  std::string cache_key;
+  auto& cache = object_manager_.query_cache();
+  auto graph_type = wrapper->graph_def().graph_type();
+  if (cache.enabled() && (graph_type == rpc::ARROW_PROPERTY ||
+                          graph_type == rpc::ARROW_PROJECTED ||
+                          graph_type == rpc::ARROW_FLATTENED)) {
+    cache_key = app->lib_path() + ":" + graph_name + ":" +
+                std::to_string(wrapper->graph_def().vineyard_id()) + ":" +
+                query_args.SerializeAsString();
+    auto cached = cache.Get(cache_key);
+    int hit = cached != nullptr;
+    // the contexts may be evicted from the caches of some of the workers
+    // only, and the query must run on all of them if so
+    int all_hit = 0;
+    MPI_Allreduce(&hit, &all_hit, 1, MPI_INT, MPI_MIN, comm_spec().comm());
+    if (all_hit) {
+      // each handle has its own key, so the context is kept until all of
+      // them are released
+      std::string context_key = "ctx_" + generateId();
+      VLOG(1) << "Reusing the context " << cached->id() << " of " << app_name
+              << " on " << graph_name << " as " << context_key;
+      BOOST_LEAF_CHECK(
+          object_manager_.PutAlias(context_key, cached, graph_name));
+      return toJson({{"context_type", cached->context_type()},
+                     {"context_key", context_key},
+                     {"cache_hit", "true"}});
+    }
+    cache.Erase(cache_key);
+  }
+
   auto fragment = wrapper->fragment();
-  auto spec = grape::DefaultParallelEngineSpec();
+  auto spec = NumaParallelEngineSpec(comm_spec(), numa_policy_);
   std::string context_key = "ctx_" + generateId();
 
-  BOOST_LEAF_AUTO(worker, app->CreateWorker(fragment, comm_spec_, spec));
+  BOOST_LEAF_AUTO(worker, app->CreateWorker(fragment, comm_spec(), spec));
   BOOST_LEAF_AUTO(ctx_wrapper,
                   app->Query(worker.get(), query_args, context_key, wrapper));
   std::string context_type;
   if (ctx_wrapper != nullptr) {
     context_type = ctx_wrapper->context_type();
-    BOOST_LEAF_CHECK(object_manager_.PutObject(ctx_wrapper));
+    BOOST_LEAF_CHECK(object_manager_.PutObject(ctx_wrapper, graph_name));
+    if (!cache_key.empty()) {
+      cache.Put(cache_key, graph_name, ctx_wrapper);
+    }
   }
 
   return toJson({{"context_type", context_type}, {"context_key", context_key}});
@@ -236,14 +442,59 @@ bl::result<std::string> GrapeInstance::reportGraph(
   }
   auto fragment =
       std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
-  DynamicGraphReporter reporter(comm_spec_);
-  return reporter.Report(fragment, params);
+  // reads the copy of the current epoch, which is not changed by the
+  // mutations of the graph
+  auto snapshot = fragment->Snapshot();
+  DynamicGraphReporter reporter(comm_spec());
+  return reporter.Report(snapshot, params);
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
                   "GS is compiled without folly");
 #endif  // NETWORKX
 }
 
+int GrapeInstance::OwnerOf(const CommandDetail& cmd) {
+#ifdef NETWORKX
+  if (cmd.type != rpc::REPORT_GRAPH) {
+    return -1;
+  }
+  // the errors are left to the workers, which report them as usual
+  rpc::GSParams params(cmd.params);
+  if (!params.HasKey(rpc::GRAPH_NAME)) {
+    return -1;
+  }
+  auto graph_name = params.Get<std::string>(rpc::GRAPH_NAME).value();
+  if (!object_manager_.HasObject(graph_name)) {
+    return -1;
+  }
+  auto wrapper = std::dynamic_pointer_cast<IFragmentWrapper>(
+      object_manager_.GetObject(graph_name).value());
+  if (wrapper == nullptr ||
+      wrapper->graph_def().graph_type() != rpc::DYNAMIC_PROPERTY) {
+    return -1;
+  }
+  auto fragment =
+      std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
+  grape::fid_t owner;
+  try {
+    if (DynamicGraphReporter::Owner(fragment, params, owner)) {
+      return comm_spec_.FragToWorker(owner);
+    }
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to find the owner of the report: " << e.what();
+  }
+#endif  // NETWORKX
+  return -1;
+}
+
+std::string GrapeInstance::RootOf(const std::string& id) {
+  return object_manager_.RootOf(id);
+}
+
+std::vector<std::string> GrapeInstance::DerivedOf(const std::string& id) {
+  return object_manager_.DerivedOf(id);
+}
+
 bl::result<void> GrapeInstance::modifyVertices(
     const rpc::GSParams& params, const std::vector<std::string>& vertices) {
 #ifdef NETWORKX
@@ -251,6 +502,7 @@ bl::result<void> GrapeInstance::modifyVertices(
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
   auto graph_type = wrapper->graph_def().graph_type();
 
   if (graph_type != rpc::DYNAMIC_PROPERTY) {
@@ -276,6 +528,7 @@ bl::result<void> GrapeInstance::modifyEdges(
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
   auto graph_type = wrapper->graph_def().graph_type();
 
   if (graph_type != rpc::DYNAMIC_PROPERTY) {
@@ -294,6 +547,68 @@ bl::result<void> GrapeInstance::modifyEdges(
   return {};
 }
 
+bl::result<void> GrapeInstance::modifyVerticesByBatch(
+    const rpc::GSParams& params, const std::string& batch) {
+#ifdef NETWORKX
+  BOOST_LEAF_AUTO(modify_type, params.Get<rpc::ModifyType>(rpc::MODIFY_TYPE));
+  BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+  BOOST_LEAF_AUTO(wrapper,
+                  object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
+  auto graph_type = wrapper->graph_def().graph_type();
+
+  if (graph_type != rpc::DYNAMIC_PROPERTY) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Error graph type: " + std::to_string(graph_type) +
+                        ", graph id: " + graph_name);
+  }
+
+  std::vector<DynamicFragment::oid_t> oids;
+  std::vector<DynamicFragment::vdata_t> vdatas;
+  DynamicBatchParser parser;
+  BOOST_LEAF_CHECK(parser.ParseVertices(batch, oids, vdatas));
+
+  auto fragment =
+      std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
+  fragment->ModifyVertices(oids, vdatas, modify_type);
+#else
+  RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
+                  "GS is compiled without folly");
+#endif  // NETWORKX
+  return {};
+}
+
+bl::result<void> GrapeInstance::modifyEdgesByBatch(const rpc::GSParams& params,
+                                                   const std::string& batch) {
+#ifdef NETWORKX
+  BOOST_LEAF_AUTO(modify_type, params.Get<rpc::ModifyType>(rpc::MODIFY_TYPE));
+  BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+  BOOST_LEAF_AUTO(wrapper,
+                  object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
+  auto graph_type = wrapper->graph_def().graph_type();
+
+  if (graph_type != rpc::DYNAMIC_PROPERTY) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Error graph type: " + std::to_string(graph_type) +
+                        ", graph id: " + graph_name);
+  }
+
+  std::vector<DynamicFragment::oid_t> srcs, dsts;
+  std::vector<DynamicFragment::edata_t> edatas;
+  DynamicBatchParser parser;
+  BOOST_LEAF_CHECK(parser.ParseEdges(batch, srcs, dsts, edatas));
+
+  auto fragment =
+      std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
+  fragment->ModifyEdges(srcs, dsts, edatas, modify_type);
+#else
+  RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
+                  "GS is compiled without folly");
+#endif  // NETWORKX
+  return {};
+}
+
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
     const rpc::GSParams& params) {
   std::pair<std::string, std::string> range;
@@ -319,32 +634,32 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToNumpy(
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
     BOOST_LEAF_AUTO(axis, params.Get<int64_t>(rpc::AXIS));
 
-    return wrapper->ToNdArray(comm_spec_, axis);
+    return wrapper->ToNdArray(comm_spec(), axis);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec(), selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec(), selector, range);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec(), selector, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
-    return wrapper->ToNdArray(comm_spec_, selector, range);
+    return wrapper->ToNdArray(comm_spec(), selector, range);
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
                   "Unsupported context type: " + std::string(ctx_type));
@@ -364,42 +679,56 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToDataframe(
     BOOST_LEAF_ASSIGN(s_selectors, params.Get<std::string>(rpc::SELECTOR));
   }
 
+  VertexLimit limit;
+  if (params.HasKey(rpc::VERTEX_LIMIT)) {
+    BOOST_LEAF_AUTO(limit_in_json, params.Get<std::string>(rpc::VERTEX_LIMIT));
+    BOOST_LEAF_ASSIGN(limit, VertexLimit::Parse(limit_in_json));
+  }
+
   BOOST_LEAF_AUTO(ctx_name, params.Get<std::string>(rpc::CTX_NAME));
   BOOST_LEAF_AUTO(base_ctx_wrapper,
                   object_manager_.GetObject<IContextWrapper>(ctx_name));
 
   auto ctx_type = base_ctx_wrapper->context_type();
 
+  if (limit.type != VertexLimit::Type::kNone &&
+      ctx_type != CONTEXT_TYPE_VERTEX_DATA &&
+      ctx_type != CONTEXT_TYPE_LABELED_VERTEX_DATA) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Top k and sampling are not supported by the context "
+                    "type: " + ctx_type);
+  }
+
   if (ctx_type == CONTEXT_TYPE_TENSOR) {
     auto wrapper =
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
 
-    return wrapper->ToDataframe(comm_spec_);
+    return wrapper->ToDataframe(comm_spec());
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec(), selectors, range, limit);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec(), selectors, range, limit);
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec(), selectors, range);
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
             base_ctx_wrapper);
 
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
-    return wrapper->ToDataframe(comm_spec_, selectors, range);
+    return wrapper->ToDataframe(comm_spec(), selectors, range);
   }
   RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
                   "Unsupported context type: " + std::string(ctx_type));
@@ -425,7 +754,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardTensor(
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
     BOOST_LEAF_AUTO(axis, params.Get<int64_t>(rpc::AXIS));
     BOOST_LEAF_ASSIGN(id,
-                      wrapper->ToVineyardTensor(comm_spec_, *client_, axis));
+                      wrapper->ToVineyardTensor(comm_spec(), *client(), axis));
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
@@ -433,7 +762,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardTensor(
     BOOST_LEAF_AUTO(s_selector, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
     BOOST_LEAF_ASSIGN(
-        id, wrapper->ToVineyardTensor(comm_spec_, *client_, selector, range));
+        id, wrapper->ToVineyardTensor(comm_spec(), *client(), selector, range));
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto wrapper = std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
         base_ctx_wrapper);
@@ -441,7 +770,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardTensor(
     BOOST_LEAF_AUTO(s_selector, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
     BOOST_LEAF_ASSIGN(
-        id, wrapper->ToVineyardTensor(comm_spec_, *client_, selector, range));
+        id, wrapper->ToVineyardTensor(comm_spec(), *client(), selector, range));
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
         base_ctx_wrapper);
@@ -449,7 +778,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardTensor(
     BOOST_LEAF_AUTO(s_selector, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selector, Selector::parse(s_selector));
     BOOST_LEAF_ASSIGN(
-        id, wrapper->ToVineyardTensor(comm_spec_, *client_, selector, range));
+        id, wrapper->ToVineyardTensor(comm_spec(), *client(), selector, range));
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
@@ -458,14 +787,14 @@ bl::result<std::string> GrapeInstance::contextToVineyardTensor(
     BOOST_LEAF_AUTO(s_selector, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
     BOOST_LEAF_ASSIGN(
-        id, wrapper->ToVineyardTensor(comm_spec_, *client_, selector, range));
+        id, wrapper->ToVineyardTensor(comm_spec(), *client(), selector, range));
   } else {
     CHECK(false);
   }
 
   auto s_id = vineyard::ObjectIDToString(id);
 
-  client_->PutName(id, s_id);
+  client()->PutName(id, s_id);
 
   return toJson({{"object_id", s_id}});
 }
@@ -489,7 +818,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardDataFrame(
     auto wrapper =
         std::dynamic_pointer_cast<ITensorContextWrapper>(base_ctx_wrapper);
 
-    BOOST_LEAF_ASSIGN(id, wrapper->ToVineyardDataframe(comm_spec_, *client_));
+    BOOST_LEAF_ASSIGN(id, wrapper->ToVineyardDataframe(comm_spec(), *client()));
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
     auto vd_ctx_wrapper =
         std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
@@ -497,7 +826,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardDataFrame(
     BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
     BOOST_LEAF_ASSIGN(id, vd_ctx_wrapper->ToVineyardDataframe(
-                              comm_spec_, *client_, selectors, range));
+                              comm_spec(), *client(), selectors, range));
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
     auto vd_ctx_wrapper =
         std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
@@ -506,7 +835,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardDataFrame(
     BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
     BOOST_LEAF_ASSIGN(id, vd_ctx_wrapper->ToVineyardDataframe(
-                              comm_spec_, *client_, selectors, range));
+                              comm_spec(), *client(), selectors, range));
   } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
     auto vd_ctx_wrapper =
         std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
@@ -515,7 +844,7 @@ bl::result<std::string> GrapeInstance::contextToVineyardDataFrame(
     BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
     BOOST_LEAF_ASSIGN(id, vd_ctx_wrapper->ToVineyardDataframe(
-                              comm_spec_, *client_, selectors, range));
+                              comm_spec(), *client(), selectors, range));
   } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
     auto vd_ctx_wrapper =
         std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
@@ -524,18 +853,141 @@ bl::result<std::string> GrapeInstance::contextToVineyardDataFrame(
     BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
     BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
     BOOST_LEAF_ASSIGN(id, vd_ctx_wrapper->ToVineyardDataframe(
-                              comm_spec_, *client_, selectors, range));
+                              comm_spec(), *client(), selectors, range));
   } else {
     CHECK(false);
   }
 
   auto s_id = vineyard::ObjectIDToString(id);
 
-  client_->PutName(id, s_id);
+  client()->PutName(id, s_id);
 
   return toJson({{"object_id", s_id}});
 }
 
+bl::result<std::string> GrapeInstance::contextToFiles(
+    const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(ctx_name, params.Get<std::string>(rpc::CTX_NAME));
+  BOOST_LEAF_AUTO(prefix, params.Get<std::string>(rpc::OUTPUT_PREFIX));
+  BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
+  BOOST_LEAF_AUTO(base_ctx_wrapper,
+                  object_manager_.GetObject<IContextWrapper>(ctx_name));
+  auto ctx_type = base_ctx_wrapper->context_type();
+  std::string suffix = "_frag_" + std::to_string(comm_spec().fid()) + ".arrow";
+  // one line per file, the lines of all workers are concatenated
+  std::string paths;
+
+  if (ctx_type == CONTEXT_TYPE_VERTEX_DATA ||
+      ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
+    BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
+    std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>> columns;
+    if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
+      auto wrapper = std::dynamic_pointer_cast<IVertexDataContextWrapper>(
+          base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    } else {
+      auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
+          base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    }
+    std::string path = prefix + suffix;
+    BOOST_LEAF_CHECK(WriteArrowFile(path, columns));
+    paths += path + "\n";
+  } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA ||
+             ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
+    BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
+    std::map<vineyard::property_graph_types::LABEL_ID_TYPE,
+             std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>>>
+        label_columns;
+    if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
+      auto wrapper =
+          std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
+              base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(label_columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    } else {
+      auto wrapper =
+          std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
+              base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(label_columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    }
+    for (auto& pair : label_columns) {
+      std::string path =
+          prefix + "_label_" + std::to_string(pair.first) + suffix;
+      BOOST_LEAF_CHECK(WriteArrowFile(path, pair.second));
+      paths += path + "\n";
+    }
+  } else {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
+                    "Unsupported context type for output to files: " +
+                        std::string(ctx_type));
+  }
+  VLOG(1) << "Wrote context " << ctx_name << " to " << paths;
+  return paths;
+}
+
+bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::contextToArrow(
+    const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(ctx_name, params.Get<std::string>(rpc::CTX_NAME));
+  BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
+  BOOST_LEAF_AUTO(base_ctx_wrapper,
+                  object_manager_.GetObject<IContextWrapper>(ctx_name));
+  auto ctx_type = base_ctx_wrapper->context_type();
+  std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>> columns;
+
+  if (ctx_type == CONTEXT_TYPE_VERTEX_DATA) {
+    BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
+    auto wrapper =
+        std::dynamic_pointer_cast<IVertexDataContextWrapper>(base_ctx_wrapper);
+    BOOST_LEAF_ASSIGN(columns, wrapper->ToArrowArrays(comm_spec(), selectors));
+  } else if (ctx_type == CONTEXT_TYPE_VERTEX_PROPERTY) {
+    BOOST_LEAF_AUTO(selectors, Selector::ParseSelectors(s_selectors));
+    auto wrapper = std::dynamic_pointer_cast<IVertexPropertyContextWrapper>(
+        base_ctx_wrapper);
+    BOOST_LEAF_ASSIGN(columns, wrapper->ToArrowArrays(comm_spec(), selectors));
+  } else if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA ||
+             ctx_type == CONTEXT_TYPE_LABELED_VERTEX_PROPERTY) {
+    BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
+    BOOST_LEAF_AUTO(label_id, LabeledSelector::GetVertexLabelId(selectors));
+    std::map<vineyard::property_graph_types::LABEL_ID_TYPE,
+             std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>>>
+        label_columns;
+    if (ctx_type == CONTEXT_TYPE_LABELED_VERTEX_DATA) {
+      auto wrapper =
+          std::dynamic_pointer_cast<ILabeledVertexDataContextWrapper>(
+              base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(label_columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    } else {
+      auto wrapper =
+          std::dynamic_pointer_cast<ILabeledVertexPropertyContextWrapper>(
+              base_ctx_wrapper);
+      BOOST_LEAF_ASSIGN(label_columns,
+                        wrapper->ToArrowArrays(comm_spec(), selectors));
+    }
+    columns = std::move(label_columns[label_id]);
+  } else {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
+                    "Unsupported context type for output to arrow: " +
+                        std::string(ctx_type));
+  }
+
+  BOOST_LEAF_AUTO(buffer, WriteArrowStream(columns));
+  // the number of streams, followed by the sized stream of each worker
+  auto arc = std::make_shared<grape::InArchive>();
+  if (comm_spec().fid() == 0) {
+    *arc << static_cast<int64_t>(comm_spec().fnum());
+  }
+  auto old_size = arc->GetSize();
+  *arc << static_cast<int64_t>(buffer->size());
+  arc->AddBytes(buffer->data(), static_cast<size_t>(buffer->size()));
+  gather_archives(*arc, comm_spec(), old_size);
+  return arc;
+}
+
 bl::result<rpc::GraphDef> GrapeInstance::addColumn(
     const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
@@ -554,12 +1006,36 @@ bl::result<rpc::GraphDef> GrapeInstance::addColumn(
   std::string dst_graph_name = "graph_" + generateId();
 
   BOOST_LEAF_AUTO(new_frag_wrapper,
-                  frag_wrapper->AddColumn(comm_spec_, dst_graph_name,
+                  frag_wrapper->AddColumn(comm_spec(), dst_graph_name,
                                           ctx_wrapper, s_selectors));
   BOOST_LEAF_CHECK(object_manager_.PutObject(new_frag_wrapper));
   return new_frag_wrapper->graph_def();
 }
 
+bl::result<rpc::GraphDef> GrapeInstance::rebalanceGraph(
+    const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+  std::string strategy = "degree_aware";
+  if (params.HasKey(rpc::PARTITION_STRATEGY)) {
+    BOOST_LEAF_ASSIGN(strategy,
+                      params.Get<std::string>(rpc::PARTITION_STRATEGY));
+  }
+  BOOST_LEAF_AUTO(
+      frag_wrapper,
+      object_manager_.GetObject<ILabeledFragmentWrapper>(graph_name));
+
+  if (frag_wrapper->graph_def().graph_type() != rpc::ARROW_PROPERTY) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Rebalance is only available for ArrowFragment");
+  }
+  std::string dst_graph_name = "graph_" + generateId();
+
+  BOOST_LEAF_AUTO(new_frag_wrapper, frag_wrapper->Rebalance(
+                                        comm_spec(), dst_graph_name, strategy));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(new_frag_wrapper));
+  return new_frag_wrapper->graph_def();
+}
+
 bl::result<rpc::GraphDef> GrapeInstance::convertGraph(
     const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(src_graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
@@ -583,14 +1059,14 @@ bl::result<rpc::GraphDef> GrapeInstance::convertGraph(
   if (src_graph_type == rpc::ARROW_PROPERTY &&
       dst_graph_type == rpc::DYNAMIC_PROPERTY) {
     BOOST_LEAF_AUTO(dst_graph_wrapper,
-                    g_utils->ToDynamicFragment(comm_spec_, src_frag_wrapper,
+                    g_utils->ToDynamicFragment(comm_spec(), src_frag_wrapper,
                                                dst_graph_name));
     BOOST_LEAF_CHECK(object_manager_.PutObject(dst_graph_wrapper));
     return dst_graph_wrapper->graph_def();
   } else if (src_graph_type == rpc::DYNAMIC_PROPERTY &&
              dst_graph_type == rpc::ARROW_PROPERTY) {
     BOOST_LEAF_AUTO(dst_graph_wrapper,
-                    g_utils->ToArrowFragment(*client_, comm_spec_,
+                    g_utils->ToArrowFragment(*client(), comm_spec(),
                                              src_frag_wrapper, dst_graph_name));
     BOOST_LEAF_CHECK(object_manager_.PutObject(dst_graph_wrapper));
     return dst_graph_wrapper->graph_def();
@@ -611,8 +1087,8 @@ bl::result<rpc::GraphDef> GrapeInstance::copyGraph(
   std::string dst_graph_name = "graph_" + generateId();
 
   BOOST_LEAF_AUTO(dst_wrapper, src_wrapper->CopyGraph(
-                                   comm_spec_, dst_graph_name, copy_type));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper));
+                                   comm_spec(), dst_graph_name, copy_type));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper, src_graph_name));
   return dst_wrapper->graph_def();
 }
 
@@ -627,8 +1103,8 @@ bl::result<rpc::GraphDef> GrapeInstance::toDirected(
   std::string dst_graph_name = "graph_" + generateId();
 
   BOOST_LEAF_AUTO(dst_wrapper,
-                  src_wrapper->ToDirected(comm_spec_, dst_graph_name));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper));
+                  src_wrapper->ToDirected(comm_spec(), dst_graph_name));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper, src_graph_name));
   return dst_wrapper->graph_def();
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
@@ -646,8 +1122,8 @@ bl::result<rpc::GraphDef> GrapeInstance::toUnDirected(
   std::string dst_graph_name = "graph_" + generateId();
 
   BOOST_LEAF_AUTO(dst_wrapper,
-                  src_wrapper->ToUnDirected(comm_spec_, dst_graph_name));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper));
+                  src_wrapper->ToUnDirected(comm_spec(), dst_graph_name));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper, src_graph_name));
   return dst_wrapper->graph_def();
 #else
   RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
@@ -675,15 +1151,24 @@ bl::result<rpc::GraphDef> GrapeInstance::induceSubGraph(
       std::static_pointer_cast<DynamicFragment>(src_wrapper->fragment());
 
   auto sub_vm_ptr =
-      std::make_shared<typename DynamicFragment::vertex_map_t>(comm_spec_);
+      std::make_shared<typename DynamicFragment::vertex_map_t>(comm_spec());
   sub_vm_ptr->Init();
   typename DynamicFragment::partitioner_t partitioner;
   partitioner.Init(fragment->fnum());
+  // filter the induced vertices of this fragment in parallel, and add them
+  // to the vertex map by the order of the candidates
+  std::vector<typename DynamicFragment::oid_t> candidates(
+      induced_vertices.begin(), induced_vertices.end());
+  std::vector<uint8_t> owned(candidates.size(), 0);
+  auto fid = fragment->fid();
+  parallel_for(0, candidates.size(), [&](size_t i) {
+    owned[i] = partitioner.GetPartitionId(candidates[i]) == fid &&
+               fragment->HasNode(candidates[i]);
+  });
   typename DynamicFragment::vid_t gid;
-  for (auto& v : induced_vertices) {
-    auto fid = partitioner.GetPartitionId(v);
-    if (fid == fragment->fid() && fragment->HasNode(v)) {
-      sub_vm_ptr->AddVertex(fid, v, gid);
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (owned[i]) {
+      sub_vm_ptr->AddVertex(fid, candidates[i], gid);
     }
   }
   sub_vm_ptr->Construct();
@@ -706,6 +1191,7 @@ bl::result<void> GrapeInstance::clearGraph(const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
   auto graph_type = wrapper->graph_def().graph_type();
 
   if (graph_type != rpc::DYNAMIC_PROPERTY) {
@@ -715,7 +1201,7 @@ bl::result<void> GrapeInstance::clearGraph(const rpc::GSParams& params) {
   }
 
   auto vm_ptr = std::shared_ptr<DynamicFragment::vertex_map_t>(
-      new DynamicFragment::vertex_map_t(comm_spec_));
+      new DynamicFragment::vertex_map_t(comm_spec()));
   vm_ptr->Init();
   auto fragment =
       std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
@@ -732,6 +1218,7 @@ bl::result<void> GrapeInstance::clearEdges(const rpc::GSParams& params) {
   BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  object_manager_.query_cache().EraseGraph(graph_name);
   auto graph_type = wrapper->graph_def().graph_type();
 
   if (graph_type != rpc::DYNAMIC_PROPERTY) {
@@ -750,6 +1237,103 @@ bl::result<void> GrapeInstance::clearEdges(const rpc::GSParams& params) {
   return {};
 }
 
+bl::result<void> GrapeInstance::serializeGraph(const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+  BOOST_LEAF_AUTO(path, params.Get<std::string>(rpc::SNAPSHOT_PATH));
+  BOOST_LEAF_AUTO(wrapper,
+                  object_manager_.GetObject<IFragmentWrapper>(graph_name));
+  auto graph_type = wrapper->graph_def().graph_type();
+
+  if (graph_type == rpc::ARROW_PROPERTY) {
+    VLOG(1) << "Serializing arrow graph " << graph_name << " to " << path;
+
+    auto fg = std::dynamic_pointer_cast<vineyard::ArrowFragmentGroup>(
+        client()->GetObject(wrapper->graph_def().vineyard_id()));
+    auto fid = comm_spec().fid();
+    auto frag_id = fg->Fragments().at(fid);
+    BOOST_LEAF_CHECK(WriteObjectSnapshot(
+        *client(), frag_id, ArrowFragmentSnapshotLocation(path, fid)));
+    return {};
+  }
+#ifdef NETWORKX
+  if (graph_type != rpc::DYNAMIC_PROPERTY) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Error graph type: " + std::to_string(graph_type) +
+                        ", graph id: " + graph_name);
+  }
+
+  VLOG(1) << "Serializing graph " << graph_name << " to " << path;
+
+  auto fragment =
+      std::static_pointer_cast<DynamicFragment>(wrapper->fragment());
+  fragment->Serialize<grape::LocalIOAdaptor>(path);
+#else
+  RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
+                  "GS is compiled without folly");
+#endif  // NETWORKX
+  return {};
+}
+
+bl::result<rpc::GraphDef> GrapeInstance::deserializeGraph(
+    const rpc::GSParams& params) {
+#ifdef NETWORKX
+  std::string graph_name = "graph_" + generateId();
+  BOOST_LEAF_AUTO(path, params.Get<std::string>(rpc::SNAPSHOT_PATH));
+
+  VLOG(1) << "Deserializing graph from " << path
+          << ", graph name: " << graph_name;
+
+  // the workers agree on whether the snapshot can be restored, so that none
+  // of them registers a graph the others fail to restore
+  auto snapshot = DynamicFragment::CheckSnapshot<grape::LocalIOAdaptor>(
+      path, comm_spec().fid(), comm_spec().fnum());
+  int valid = snapshot ? 1 : 0, all_valid = 0;
+  MPI_Allreduce(&valid, &all_valid, 1, MPI_INT, MPI_MIN, comm_spec().comm());
+  if (!snapshot) {
+    return snapshot.error();
+  }
+  if (!all_valid) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "Failed to restore the snapshot " + path +
+                        " on the other workers");
+  }
+
+  auto vm_ptr = std::shared_ptr<DynamicFragment::vertex_map_t>(
+      new DynamicFragment::vertex_map_t(comm_spec()));
+  vm_ptr->Init();
+  auto fragment = std::make_shared<DynamicFragment>(vm_ptr);
+  fragment->Deserialize<grape::LocalIOAdaptor>(path, comm_spec().fid());
+
+  rpc::GraphDef graph_def;
+
+  graph_def.set_key(graph_name);
+  graph_def.set_directed(fragment->directed());
+  graph_def.set_graph_type(rpc::DYNAMIC_PROPERTY);
+  // dynamic graph doesn't have a vineyard id
+  graph_def.set_vineyard_id(-1);
+  auto* schema_def = graph_def.mutable_schema_def();
+
+  schema_def->set_oid_type(
+      vineyard::TypeName<typename DynamicFragment::oid_t>::Get());
+  schema_def->set_vid_type(
+      vineyard::TypeName<typename DynamicFragment::vid_t>::Get());
+  schema_def->set_vdata_type(
+      vineyard::TypeName<typename DynamicFragment::vdata_t>::Get());
+  schema_def->set_edata_type(
+      vineyard::TypeName<typename DynamicFragment::edata_t>::Get());
+  schema_def->set_property_schema_json("{}");
+
+  auto wrapper = std::make_shared<FragmentWrapper<DynamicFragment>>(
+      graph_name, graph_def, fragment);
+
+  BOOST_LEAF_CHECK(object_manager_.PutObject(wrapper));
+  return graph_def;
+#else
+  RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
+                  "GS is compiled without folly");
+#endif  // NETWORKX
+}
+
 bl::result<rpc::GraphDef> GrapeInstance::createGraphView(
     const rpc::GSParams& params) {
 #ifdef NETWORKX
@@ -763,8 +1347,8 @@ bl::result<rpc::GraphDef> GrapeInstance::createGraphView(
   BOOST_LEAF_AUTO(wrapper,
                   object_manager_.GetObject<IFragmentWrapper>(graph_name));
   BOOST_LEAF_AUTO(view_wrapper,
-                  wrapper->CreateGraphView(comm_spec_, view_id, view_type));
-  BOOST_LEAF_CHECK(object_manager_.PutObject(view_wrapper));
+                  wrapper->CreateGraphView(comm_spec(), view_id, view_type));
+  BOOST_LEAF_CHECK(object_manager_.PutObject(view_wrapper, graph_name));
 
   return view_wrapper->graph_def();
 #else
@@ -791,7 +1375,7 @@ bl::result<rpc::GraphDef> GrapeInstance::addLabelsToGraph(
                   object_manager_.GetObject<PropertyGraphUtils>(type_sig));
   std::string dst_graph_name = "graph_" + generateId();
   BOOST_LEAF_AUTO(dst_wrapper, graph_utils->AddLabelsToGraph(
-                                   src_frag_id, comm_spec_, *client_,
+                                   src_frag_id, comm_spec(), *client(),
                                    dst_graph_name, params));
   BOOST_LEAF_CHECK(object_manager_.PutObject(dst_wrapper));
 
@@ -813,7 +1397,7 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToNumpy(
   }
   BOOST_LEAF_AUTO(selector, LabeledSelector::parse(s_selector));
 
-  return wrapper->ToNdArray(comm_spec_, selector, range);
+  return wrapper->ToNdArray(comm_spec(), selector, range);
 }
 
 bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
@@ -833,7 +1417,33 @@ bl::result<std::shared_ptr<grape::InArchive>> GrapeInstance::graphToDataframe(
   BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
   BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
 
-  return wrapper->ToDataframe(comm_spec_, selectors, range);
+  return wrapper->ToDataframe(comm_spec(), selectors, range);
+}
+
+bl::result<std::string> GrapeInstance::graphToVineyardDataframe(
+    const rpc::GSParams& params) {
+  BOOST_LEAF_AUTO(graph_name, params.Get<std::string>(rpc::GRAPH_NAME));
+
+  BOOST_LEAF_AUTO(
+      wrapper, object_manager_.GetObject<ILabeledFragmentWrapper>(graph_name));
+
+  std::pair<std::string, std::string> range;
+
+  if (params.HasKey(rpc::VERTEX_RANGE)) {
+    BOOST_LEAF_AUTO(range_in_json, params.Get<std::string>(rpc::VERTEX_RANGE));
+    range = parseRange(range_in_json);
+  }
+
+  BOOST_LEAF_AUTO(s_selectors, params.Get<std::string>(rpc::SELECTOR));
+  BOOST_LEAF_AUTO(selectors, LabeledSelector::ParseSelectors(s_selectors));
+  BOOST_LEAF_AUTO(id, wrapper->ToVineyardDataframe(comm_spec(), *client(),
+                                                   selectors, range));
+
+  auto s_id = vineyard::ObjectIDToString(id);
+
+  client()->PutName(id, s_id);
+
+  return toJson({{"object_id", s_id}});
 }
 
 bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
@@ -865,6 +1475,86 @@ bl::result<void> GrapeInstance::registerGraphType(const rpc::GSParams& params) {
   }
 }
 
+std::string GrapeInstance::reportMemory() {
+  size_t total;
+  auto usage = object_manager_.MemoryUsage(total);
+  boost::property_tree::ptree pt, objects;
+
+  for (auto& object : usage) {
+    boost::property_tree::ptree child;
+    child.put("id", object.id);
+    child.put("type", ObjectTypeToString(object.type));
+    child.put("bytes", object.bytes);
+    objects.push_back(std::make_pair("", child));
+  }
+  pt.put("worker_id", comm_spec_.worker_id());
+  pt.put("total_bytes", total);
+  pt.put("budget_bytes", object_manager_.memory_budget());
+  pt.add_child("objects", objects);
+
+  std::stringstream ss;
+  boost::property_tree::json_parser::write_json(ss, pt, false);
+  return ss.str();
+}
+
+bl::result<std::vector<std::string>> GrapeInstance::evictObjects() {
+  std::vector<std::string> evicted;
+  uint64_t budget = object_manager_.memory_budget();
+  // the commands run by a single worker leave the eviction to the others
+  if (budget == 0 || comm_spec().worker_num() != comm_spec_.worker_num()) {
+    return evicted;
+  }
+  bool caches_cleared = false;
+  while (true) {
+    // the budget is exceeded once it is exceeded on any of the workers
+    uint64_t bytes = object_manager_.TotalBytes(), max_bytes = 0;
+    MPI_Allreduce(&bytes, &max_bytes, 1, MPI_UINT64_T, MPI_MAX,
+                  comm_spec().comm());
+    if (max_bytes <= budget) {
+      break;
+    }
+    if (!caches_cleared) {
+      object_manager_.projection_cache().Clear();
+      object_manager_.query_cache().Clear();
+      caches_cleared = true;
+      continue;
+    }
+    std::string victim;
+    if (comm_spec().worker_id() == grape::kCoordinatorRank) {
+      victim = object_manager_.EvictionVictim();
+      grape::BcastSend(victim, comm_spec().comm());
+    } else {
+      grape::BcastRecv(victim, comm_spec().comm(), grape::kCoordinatorRank);
+    }
+    if (victim.empty()) {
+      LOG_IF(WARNING, comm_spec().worker_id() == grape::kCoordinatorRank)
+          << "The objects hold " << max_bytes << " bytes, exceed the budget "
+          << budget << ", but none of them can be evicted.";
+      break;
+    }
+    LOG_IF(INFO, comm_spec().worker_id() == grape::kCoordinatorRank)
+        << victim << " is evicted, the objects hold " << max_bytes
+        << " bytes, exceed the budget " << budget;
+    // the victims are the projections and the contexts, and the vineyard
+    // objects of the projections are deleted as those unloaded by the client
+    BOOST_LEAF_CHECK(removeObject(victim, vineyard::InvalidObjectID()));
+    evicted.push_back(victim);
+  }
+  return evicted;
+}
+
+std::shared_ptr<vineyard::Client>& GrapeInstance::client() {
+  std::call_once(client_once_, [this]() {
+    auto start = std::chrono::steady_clock::now();
+    EnsureClient(client_, vineyard_socket_);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    VLOG(1) << "Connected to vineyardd on " << vineyard_socket_ << " in "
+            << elapsed.count() << " seconds";
+  });
+  return client_;
+}
+
 bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     const CommandDetail& cmd) {
   auto r = std::make_shared<DispatchResult>(comm_spec_.worker_id());
@@ -894,6 +1584,10 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     BOOST_LEAF_CHECK(unloadGraph(params));
     break;
   }
+  case rpc::UNLOAD_CONTEXT: {
+    BOOST_LEAF_CHECK(unloadContext(params));
+    break;
+  }
   case rpc::REPORT_GRAPH: {
     BOOST_LEAF_AUTO(report_in_json, reportGraph(params));
     r->set_data(report_in_json,
@@ -912,6 +1606,11 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
   }
   case rpc::MODIFY_VERTICES: {
 #ifdef NETWORKX
+    if (params.HasKey(rpc::ARROW_BATCH)) {
+      BOOST_LEAF_CHECK(modifyVerticesByBatch(
+          params, cmd.params.at(rpc::ARROW_BATCH).s()));
+      break;
+    }
     std::vector<std::string> vertices_to_modify;
     int size = cmd.params.at(rpc::NODES).list().s_size();
     vertices_to_modify.reserve(size);
@@ -927,6 +1626,11 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
   }
   case rpc::MODIFY_EDGES: {
 #ifdef NETWORKX
+    if (params.HasKey(rpc::ARROW_BATCH)) {
+      BOOST_LEAF_CHECK(modifyEdgesByBatch(
+          params, cmd.params.at(rpc::ARROW_BATCH).s()));
+      break;
+    }
     std::vector<std::string> edges_to_modify;
     int size = cmd.params.at(rpc::EDGES).list().s_size();
     edges_to_modify.reserve(size);
@@ -1030,6 +1734,20 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
 #else
     RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                     "GS is built with networkx off");
+#endif
+    break;
+  }
+  case rpc::SERIALIZE_GRAPH: {
+    BOOST_LEAF_CHECK(serializeGraph(params));
+    break;
+  }
+  case rpc::DESERIALIZE_GRAPH: {
+#ifdef NETWORKX
+    BOOST_LEAF_AUTO(graph_def, deserializeGraph(params));
+    r->set_graph_def(graph_def);
+#else
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "GS is built with networkx off");
 #endif
     break;
   }
@@ -1068,11 +1786,21 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     r->set_data(vy_obj_id_in_json);
     break;
   }
+  case rpc::CONTEXT_TO_FILES: {
+    BOOST_LEAF_AUTO(paths, contextToFiles(params));
+    r->set_data(paths, DispatchResult::AggregatePolicy::kConcat);
+    break;
+  }
   case rpc::ADD_COLUMN: {
     BOOST_LEAF_AUTO(graph_def, addColumn(params));
     r->set_graph_def(graph_def);
     break;
   }
+  case rpc::REBALANCE_GRAPH: {
+    BOOST_LEAF_AUTO(graph_def, rebalanceGraph(params));
+    r->set_graph_def(graph_def);
+    break;
+  }
   case rpc::GRAPH_TO_NUMPY: {
     BOOST_LEAF_AUTO(arc, graphToNumpy(params));
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
@@ -1083,10 +1811,25 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
     break;
   }
+  case rpc::GRAPH_TO_VINEYARD_DATAFRAME: {
+    BOOST_LEAF_AUTO(vy_obj_id_in_json, graphToVineyardDataframe(params));
+    r->set_data(vy_obj_id_in_json);
+    break;
+  }
   case rpc::REGISTER_GRAPH_TYPE: {
     BOOST_LEAF_CHECK(registerGraphType(params));
     break;
   }
+  case rpc::CONTEXT_TO_ARROW: {
+    BOOST_LEAF_AUTO(arc, contextToArrow(params));
+    r->set_data(*arc, DispatchResult::AggregatePolicy::kPickFirst);
+    break;
+  }
+  case rpc::REPORT_MEMORY: {
+    // one line per worker, the lines of all workers are concatenated
+    r->set_data(reportMemory(), DispatchResult::AggregatePolicy::kConcat);
+    break;
+  }
   case rpc::GET_ENGINE_CONFIG: {
     EngineConfig conf;
 #ifdef NETWORKX
@@ -1094,8 +1837,8 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
 #else
     conf.networkx = "OFF";
 #endif
-    conf.vineyard_socket = client_->IPCSocket();
-    conf.vineyard_rpc_endpoint = client_->RPCEndpoint();
+    conf.vineyard_socket = client()->IPCSocket();
+    conf.vineyard_rpc_endpoint = client()->RPCEndpoint();
     r->set_data(conf.ToJsonString(),
                 DispatchResult::AggregatePolicy::kPickFirst);
     break;
@@ -1104,6 +1847,8 @@ bl::result<std::shared_ptr<DispatchResult>> GrapeInstance::OnReceive(
     RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
                     "Unknown command type: " + std::to_string(cmd.type));
   }
+  BOOST_LEAF_AUTO(evicted, evictObjects());
+  r->set_evicted(evicted);
   return r;
 }
 
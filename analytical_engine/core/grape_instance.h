@@ -20,7 +20,9 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -39,6 +41,7 @@
 #include "core/server/dispatcher.h"
 #include "core/server/graphscope_service.h"
 #include "core/server/rpc_utils.h"
+#include "core/utils/numa_utils.h"
 #include "proto/query_args.pb.h"
 #include "proto/types.pb.h"
 
@@ -74,20 +77,36 @@ class GrapeInstance : public Subscriber {
  public:
   explicit GrapeInstance(const grape::CommSpec& comm_spec);
 
+  ~GrapeInstance();
+
   void Init(const std::string& vineyard_socket);
 
   bl::result<std::shared_ptr<DispatchResult>> OnReceive(
       const CommandDetail& cmd) override;
 
+  int OwnerOf(const CommandDetail& cmd) override;
+
+  std::string RootOf(const std::string& id) override;
+
+  std::vector<std::string> DerivedOf(const std::string& id) override;
+
  private:
   bl::result<rpc::GraphDef> loadGraph(const rpc::GSParams& params);
 
   bl::result<void> unloadGraph(const rpc::GSParams& params);
 
+  // removes the object on all workers, and deletes the vineyard objects of the
+  // graph it holds, i.e., the fragment group, or the fragment built by the
+  // engine, e.g., a projection, unless they are shared with other objects
+  bl::result<void> removeObject(const std::string& id,
+                                vineyard::ObjectID frag_group_id);
+
   bl::result<std::string> loadApp(const rpc::GSParams& params);
 
   bl::result<void> unloadApp(const rpc::GSParams& params);
 
+  bl::result<void> unloadContext(const rpc::GSParams& params);
+
   bl::result<std::string> query(const rpc::GSParams& params,
                                 const rpc::QueryArgs& query_args);
 
@@ -103,6 +122,12 @@ class GrapeInstance : public Subscriber {
   bl::result<void> modifyEdges(const rpc::GSParams& params,
                                const std::vector<std::string>& edges);
 
+  bl::result<void> modifyVerticesByBatch(const rpc::GSParams& params,
+                                         const std::string& batch);
+
+  bl::result<void> modifyEdgesByBatch(const rpc::GSParams& params,
+                                      const std::string& batch);
+
   bl::result<void> clearEdges(const rpc::GSParams& params);
 
   bl::result<void> clearGraph(const rpc::GSParams& params);
@@ -118,8 +143,17 @@ class GrapeInstance : public Subscriber {
   bl::result<std::string> contextToVineyardDataFrame(
       const rpc::GSParams& params);
 
+  // writes the partition of each worker to Arrow IPC files without gathering
+  // them, returns the paths of the files, one per line
+  bl::result<std::string> contextToFiles(const rpc::GSParams& params);
+
+  bl::result<std::shared_ptr<grape::InArchive>> contextToArrow(
+      const rpc::GSParams& params);
+
   bl::result<rpc::GraphDef> addColumn(const rpc::GSParams& params);
 
+  bl::result<rpc::GraphDef> rebalanceGraph(const rpc::GSParams& params);
+
   bl::result<rpc::GraphDef> convertGraph(const rpc::GSParams& params);
 
   bl::result<rpc::GraphDef> copyGraph(const rpc::GSParams& params);
@@ -130,6 +164,10 @@ class GrapeInstance : public Subscriber {
 
   bl::result<rpc::GraphDef> createGraphView(const rpc::GSParams& params);
 
+  bl::result<void> serializeGraph(const rpc::GSParams& params);
+
+  bl::result<rpc::GraphDef> deserializeGraph(const rpc::GSParams& params);
+
 #ifdef NETWORKX
   bl::result<rpc::GraphDef> induceSubGraph(
       const rpc::GSParams& params,
@@ -148,8 +186,19 @@ class GrapeInstance : public Subscriber {
   bl::result<std::shared_ptr<grape::InArchive>> graphToDataframe(
       const rpc::GSParams& params);
 
+  bl::result<std::string> graphToVineyardDataframe(
+      const rpc::GSParams& params);
+
   bl::result<void> registerGraphType(const rpc::GSParams& params);
 
+  // the bytes held by the objects of the worker, as a line of json
+  std::string reportMemory();
+
+  // evicts the derived objects over the memory budget, returns the evicted
+  // ones, which are chosen by the coordinator and unloaded by all workers, as
+  // the bytes held by the objects differ among them
+  bl::result<std::vector<std::string>> evictObjects();
+
   static std::string toJson(const std::map<std::string, std::string>& map) {
     boost::property_tree::ptree pt;
 
@@ -191,18 +240,32 @@ class GrapeInstance : public Subscriber {
   std::string generateId() {
     std::string id;
 
-    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+    if (comm_spec().worker_id() == grape::kCoordinatorRank) {
       id = vineyard::random_string(8);
-      grape::BcastSend(id, MPI_COMM_WORLD);
+      grape::BcastSend(id, comm_spec().comm());
     } else {
-      grape::BcastRecv(id, MPI_COMM_WORLD, grape::kCoordinatorRank);
+      grape::BcastRecv(id, comm_spec().comm(), grape::kCoordinatorRank);
     }
     return id;
   }
 
+  // the commands running concurrently on different lanes of the dispatcher
+  // must communicate over the communicators of their lanes
+  const grape::CommSpec& comm_spec() const {
+    auto* lane_comm_spec = Dispatcher::LaneCommSpec();
+    return lane_comm_spec != nullptr ? *lane_comm_spec : comm_spec_;
+  }
+
+  // the client connected on the first use, see Init
+  std::shared_ptr<vineyard::Client>& client();
+
   grape::CommSpec comm_spec_;
   ObjectManager object_manager_;
+  NumaPolicy numa_policy_ = NumaPolicy::kNone;
+  std::string vineyard_socket_;
+  std::once_flag client_once_;
   std::shared_ptr<vineyard::Client> client_;
+  std::thread connect_thread_;
 };
 }  // namespace gs
 #endif  // ANALYTICAL_ENGINE_CORE_GRAPE_INSTANCE_H_
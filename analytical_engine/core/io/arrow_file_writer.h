@@ -0,0 +1,91 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_IO_ARROW_FILE_WRITER_H_
+#define ANALYTICAL_ENGINE_CORE_IO_ARROW_FILE_WRITER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/file.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/writer.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+inline std::shared_ptr<arrow::Table> MakeArrowTable(
+    const std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>>&
+        columns) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::Array>> arrays;
+  for (auto& pair : columns) {
+    fields.push_back(arrow::field(pair.first, pair.second->type()));
+    arrays.push_back(pair.second);
+  }
+  return arrow::Table::Make(arrow::schema(fields), arrays);
+}
+
+/**
+ * @brief Writes the named columns of a partition to path as an Arrow IPC file,
+ * which can be read by pyarrow.ipc.open_file. All columns must be of the same
+ * length.
+ */
+inline bl::result<void> WriteArrowFile(
+    const std::string& path,
+    const std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>>&
+        columns) {
+  auto table = MakeArrowTable(columns);
+  auto schema = table->schema();
+
+  std::shared_ptr<arrow::io::FileOutputStream> stream;
+  ARROW_OK_ASSIGN_OR_RAISE(stream, arrow::io::FileOutputStream::Open(path));
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  ARROW_OK_ASSIGN_OR_RAISE(writer,
+                           arrow::ipc::NewFileWriter(stream.get(), schema));
+  ARROW_OK_OR_RAISE(writer->WriteTable(*table));
+  ARROW_OK_OR_RAISE(writer->Close());
+  ARROW_OK_OR_RAISE(stream->Close());
+  return {};
+}
+
+/**
+ * @brief Serializes the named columns of a partition as an Arrow IPC stream,
+ * which can be read by pyarrow.ipc.open_stream without decoding the elements.
+ */
+inline bl::result<std::shared_ptr<arrow::Buffer>> WriteArrowStream(
+    const std::vector<std::pair<std::string, std::shared_ptr<arrow::Array>>>&
+        columns) {
+  auto table = MakeArrowTable(columns);
+
+  std::shared_ptr<arrow::io::BufferOutputStream> stream;
+  ARROW_OK_ASSIGN_OR_RAISE(stream, arrow::io::BufferOutputStream::Create());
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer;
+  ARROW_OK_ASSIGN_OR_RAISE(
+      writer, arrow::ipc::NewStreamWriter(stream.get(), table->schema()));
+  ARROW_OK_OR_RAISE(writer->WriteTable(*table));
+  ARROW_OK_OR_RAISE(writer->Close());
+  std::shared_ptr<arrow::Buffer> buffer;
+  ARROW_OK_ASSIGN_OR_RAISE(buffer, stream->Finish());
+  return buffer;
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_IO_ARROW_FILE_WRITER_H_
@@ -0,0 +1,381 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_IO_COLUMNAR_TABLE_READER_H_
+#define ANALYTICAL_ENGINE_CORE_IO_COLUMNAR_TABLE_READER_H_
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/filesystem/api.h"
+#include "arrow/io/api.h"
+#include "boost/algorithm/string.hpp"
+#ifdef WITH_PARQUET
+#include "parquet/arrow/reader.h"
+#endif
+#ifdef WITH_ARROW_ORC
+#include "arrow/adapters/orc/adapter.h"
+#endif
+
+#include "vineyard/basic/ds/arrow_utils.h"
+#include "vineyard/common/util/status.h"
+
+namespace gs {
+
+namespace columnar_table_reader_impl {
+
+// splits the location into the uri and the options after '#', which are
+// separated by '&'
+inline void parse_location(const std::string& location, std::string& uri,
+                           std::map<std::string, std::string>& options) {
+  auto pos = location.find('#');
+  uri = location.substr(0, pos);
+  if (pos == std::string::npos) {
+    return;
+  }
+  std::vector<std::string> items;
+  std::string options_str = location.substr(pos + 1);
+  boost::split(items, options_str, boost::is_any_of("&"));
+  for (auto& item : items) {
+    auto eq = item.find('=');
+    if (eq != std::string::npos) {
+      options[item.substr(0, eq)] = item.substr(eq + 1);
+    }
+  }
+}
+
+// the format given by the "format" option, or by the extension of the file
+inline std::string format_of(
+    const std::string& uri, const std::map<std::string, std::string>& options) {
+  auto iter = options.find("format");
+  if (iter != options.end()) {
+    return boost::algorithm::to_lower_copy(iter->second);
+  }
+  auto lower_uri = boost::algorithm::to_lower_copy(uri);
+  if (boost::algorithm::ends_with(lower_uri, ".parquet") ||
+      boost::algorithm::ends_with(lower_uri, ".parq")) {
+    return "parquet";
+  }
+  if (boost::algorithm::ends_with(lower_uri, ".orc")) {
+    return "orc";
+  }
+  return "";
+}
+
+/**
+ * @brief Selects the columns listed by the "schema" option, as the CSV
+ * adaptors do, where a column is given by its name or its index. The selected
+ * columns come first in the order of the list, followed by the others in the
+ * file if "include_all_columns" is set. All of the columns are selected if the
+ * list is absent.
+ */
+inline vineyard::Status select_columns(
+    const std::shared_ptr<arrow::Schema>& schema,
+    const std::map<std::string, std::string>& options,
+    std::vector<int>& indices) {
+  auto iter = options.find("schema");
+  std::vector<bool> selected(schema->num_fields(), false);
+  if (iter != options.end() && !iter->second.empty()) {
+    std::vector<std::string> names;
+    boost::split(names, iter->second, boost::is_any_of(","));
+    for (auto& name : names) {
+      int index = schema->GetFieldIndex(name);
+      if (index == -1 && !name.empty() &&
+          std::all_of(name.begin(), name.end(), ::isdigit)) {
+        index = std::stoi(name);
+      }
+      if (index < 0 || index >= schema->num_fields()) {
+        return vineyard::Status::Invalid("Column not found: " + name);
+      }
+      if (!selected[index]) {
+        selected[index] = true;
+        indices.push_back(index);
+      }
+    }
+    auto all_iter = options.find("include_all_columns");
+    if (all_iter == options.end() ||
+        boost::algorithm::to_lower_copy(all_iter->second) != "true") {
+      return vineyard::Status::OK();
+    }
+  }
+  for (int i = 0; i < schema->num_fields(); ++i) {
+    if (!selected[i]) {
+      indices.push_back(i);
+    }
+  }
+  return vineyard::Status::OK();
+}
+
+// reorders the columns of the table read in the order of the file to the
+// order of the indices
+inline std::shared_ptr<arrow::Table> reorder_columns(
+    const std::shared_ptr<arrow::Table>& table,
+    const std::vector<int>& indices) {
+  std::vector<int> sorted(indices);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+  for (auto index : indices) {
+    auto pos = std::lower_bound(sorted.begin(), sorted.end(), index) -
+               sorted.begin();
+    fields.push_back(table->schema()->field(pos));
+    columns.push_back(table->column(pos));
+  }
+  return arrow::Table::Make(arrow::schema(fields), columns);
+}
+
+// reads the units, i.e., the row groups or the stripes, [begin, end) by the
+// threads of concurrency, each of which reads a sub range by read_units
+template <typename FUNC_T>
+vineyard::Status read_units_concurrently(
+    int begin, int end, int concurrency, const FUNC_T& read_units,
+    std::vector<std::shared_ptr<arrow::Table>>& tables) {
+  concurrency = std::max(1, std::min(concurrency, end - begin));
+  std::vector<vineyard::Status> statuses(concurrency);
+  std::vector<std::thread> threads;
+  tables.resize(concurrency);
+  for (int i = 0; i < concurrency; ++i) {
+    threads.emplace_back([&, i]() {
+      int sub_begin = begin + (end - begin) * i / concurrency;
+      int sub_end = begin + (end - begin) * (i + 1) / concurrency;
+      statuses[i] = read_units(sub_begin, sub_end, tables[i]);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& status : statuses) {
+    RETURN_ON_ERROR(status);
+  }
+  return vineyard::Status::OK();
+}
+
+inline vineyard::Status concatenate_tables(
+    const std::vector<std::shared_ptr<arrow::Table>>& tables,
+    std::shared_ptr<arrow::Table>& table) {
+  if (tables.size() == 1) {
+    table = tables[0];
+    return vineyard::Status::OK();
+  }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  RETURN_ON_ARROW_ERROR(arrow::ConcatenateTables(tables, &table));
+#else
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(table, arrow::ConcatenateTables(tables));
+#endif
+  return vineyard::Status::OK();
+}
+
+inline vineyard::Status open_input_file(
+    const std::string& uri,
+    std::shared_ptr<arrow::io::RandomAccessFile>& file) {
+  std::string path;
+  std::shared_ptr<arrow::fs::FileSystem> fs;
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      fs, arrow::fs::FileSystemFromUriOrPath(uri, &path));
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(file, fs->OpenInputFile(path));
+  return vineyard::Status::OK();
+}
+
+#ifdef WITH_PARQUET
+inline vineyard::Status open_parquet_file(
+    const std::string& uri,
+    std::unique_ptr<parquet::arrow::FileReader>& reader) {
+  std::shared_ptr<arrow::io::RandomAccessFile> file;
+  RETURN_ON_ERROR(open_input_file(uri, file));
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 19000000
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      reader, parquet::arrow::OpenFile(file, arrow::default_memory_pool()));
+#else
+  RETURN_ON_ARROW_ERROR(
+      parquet::arrow::OpenFile(file, arrow::default_memory_pool(), &reader));
+#endif
+  return vineyard::Status::OK();
+}
+
+inline vineyard::Status read_parquet(
+    const std::string& uri, const std::map<std::string, std::string>& options,
+    int index, int total_parts, int concurrency,
+    std::shared_ptr<arrow::Table>& table) {
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  RETURN_ON_ERROR(open_parquet_file(uri, reader));
+  std::shared_ptr<arrow::Schema> schema;
+  RETURN_ON_ARROW_ERROR(reader->GetSchema(&schema));
+  std::vector<int> indices;
+  RETURN_ON_ERROR(select_columns(schema, options, indices));
+  std::vector<int> sorted(indices);
+  std::sort(sorted.begin(), sorted.end());
+
+  int row_group_num = reader->num_row_groups();
+  int begin = row_group_num * index / total_parts;
+  int end = row_group_num * (index + 1) / total_parts;
+  if (begin == end) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    for (auto i : sorted) {
+      fields.push_back(schema->field(i));
+    }
+    RETURN_ON_ERROR(
+        vineyard::EmptyTableBuilder::Build(arrow::schema(fields), table));
+    table = reorder_columns(table, indices);
+    return vineyard::Status::OK();
+  }
+
+  auto read_row_groups = [&](int sub_begin, int sub_end,
+                             std::shared_ptr<arrow::Table>& sub_table) {
+    std::unique_ptr<parquet::arrow::FileReader> sub_reader;
+    RETURN_ON_ERROR(open_parquet_file(uri, sub_reader));
+    std::vector<int> row_groups;
+    for (int i = sub_begin; i < sub_end; ++i) {
+      row_groups.push_back(i);
+    }
+    RETURN_ON_ARROW_ERROR(
+        sub_reader->ReadRowGroups(row_groups, sorted, &sub_table));
+    return vineyard::Status::OK();
+  };
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  RETURN_ON_ERROR(read_units_concurrently(begin, end, concurrency,
+                                          read_row_groups, tables));
+  RETURN_ON_ERROR(concatenate_tables(tables, table));
+  table = reorder_columns(table, indices);
+  return vineyard::Status::OK();
+}
+#endif
+
+#ifdef WITH_ARROW_ORC
+inline vineyard::Status open_orc_file(
+    const std::string& uri,
+    std::unique_ptr<arrow::adapters::orc::ORCFileReader>& reader) {
+  std::shared_ptr<arrow::io::RandomAccessFile> file;
+  RETURN_ON_ERROR(open_input_file(uri, file));
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 6000000
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+      reader, arrow::adapters::orc::ORCFileReader::Open(
+                  file, arrow::default_memory_pool()));
+#else
+  RETURN_ON_ARROW_ERROR(arrow::adapters::orc::ORCFileReader::Open(
+      file, arrow::default_memory_pool(), &reader));
+#endif
+  return vineyard::Status::OK();
+}
+
+inline vineyard::Status read_orc(
+    const std::string& uri, const std::map<std::string, std::string>& options,
+    int index, int total_parts, int concurrency,
+    std::shared_ptr<arrow::Table>& table) {
+  std::unique_ptr<arrow::adapters::orc::ORCFileReader> reader;
+  RETURN_ON_ERROR(open_orc_file(uri, reader));
+  std::shared_ptr<arrow::Schema> schema;
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 6000000
+  RETURN_ON_ARROW_ERROR_AND_ASSIGN(schema, reader->ReadSchema());
+#else
+  RETURN_ON_ARROW_ERROR(reader->ReadSchema(&schema));
+#endif
+  std::vector<int> indices;
+  RETURN_ON_ERROR(select_columns(schema, options, indices));
+  std::vector<int> sorted(indices);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (auto i : sorted) {
+    fields.push_back(schema->field(i));
+  }
+  auto selected_schema = arrow::schema(fields);
+
+  int stripe_num = static_cast<int>(reader->NumberOfStripes());
+  int begin = stripe_num * index / total_parts;
+  int end = stripe_num * (index + 1) / total_parts;
+
+  auto read_stripes = [&](int sub_begin, int sub_end,
+                          std::shared_ptr<arrow::Table>& sub_table) {
+    std::unique_ptr<arrow::adapters::orc::ORCFileReader> sub_reader;
+    RETURN_ON_ERROR(open_orc_file(uri, sub_reader));
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (int i = sub_begin; i < sub_end; ++i) {
+      std::shared_ptr<arrow::RecordBatch> batch;
+#if defined(ARROW_VERSION) && ARROW_VERSION >= 6000000
+      RETURN_ON_ARROW_ERROR_AND_ASSIGN(batch,
+                                       sub_reader->ReadStripe(i, sorted));
+#else
+      RETURN_ON_ARROW_ERROR(sub_reader->ReadStripe(i, sorted, &batch));
+#endif
+      batches.push_back(batch);
+    }
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        sub_table, arrow::Table::FromRecordBatches(selected_schema, batches));
+    return vineyard::Status::OK();
+  };
+  std::vector<std::shared_ptr<arrow::Table>> tables;
+  RETURN_ON_ERROR(
+      read_units_concurrently(begin, end, concurrency, read_stripes, tables));
+  RETURN_ON_ERROR(concatenate_tables(tables, table));
+  table = reorder_columns(table, indices);
+  return vineyard::Status::OK();
+}
+#endif
+
+}  // namespace columnar_table_reader_impl
+
+/**
+ * @brief Whether the location is a Parquet or an ORC file, by the "format"
+ * option or the extension, which is read by ReadColumnarTable rather than the
+ * io adaptors.
+ */
+inline bool IsColumnarLocation(const std::string& location) {
+  std::string uri;
+  std::map<std::string, std::string> options;
+  columnar_table_reader_impl::parse_location(location, uri, options);
+  auto format = columnar_table_reader_impl::format_of(uri, options);
+  return format == "parquet" || format == "orc";
+}
+
+/**
+ * @brief Reads the part index of total_parts of a Parquet or an ORC file, as
+ * the row groups or the stripes assigned to it, which are read by concurrency
+ * threads. Only the columns listed by the "schema" option are decoded.
+ */
+inline vineyard::Status ReadColumnarTable(
+    const std::string& location, int index, int total_parts, int concurrency,
+    std::shared_ptr<arrow::Table>& table) {
+  std::string uri;
+  std::map<std::string, std::string> options;
+  columnar_table_reader_impl::parse_location(location, uri, options);
+  auto format = columnar_table_reader_impl::format_of(uri, options);
+  if (format == "parquet") {
+#ifdef WITH_PARQUET
+    return columnar_table_reader_impl::read_parquet(
+        uri, options, index, total_parts, concurrency, table);
+#else
+    return vineyard::Status::NotImplemented(
+        "Arrow is built without Parquet: " + location);
+#endif
+  } else if (format == "orc") {
+#ifdef WITH_ARROW_ORC
+    return columnar_table_reader_impl::read_orc(
+        uri, options, index, total_parts, concurrency, table);
+#else
+    return vineyard::Status::NotImplemented("Arrow is built without ORC: " +
+                                            location);
+#endif
+  }
+  return vineyard::Status::Invalid("Not a columnar file: " + location);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_IO_COLUMNAR_TABLE_READER_H_
@@ -0,0 +1,254 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_IO_DYNAMIC_BATCH_PARSER_H_
+#define ANALYTICAL_ENGINE_CORE_IO_DYNAMIC_BATCH_PARSER_H_
+
+#ifdef NETWORKX
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/io/memory.h"
+#include "arrow/ipc/reader.h"
+#include "folly/dynamic.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+namespace dynamic_batch_parser_impl {
+
+template <typename ARRAY_T>
+inline folly::dynamic array_value(const ARRAY_T& array, int64_t i) {
+  return folly::dynamic(array.Value(i));
+}
+
+inline folly::dynamic array_value(const arrow::StringArray& array,
+                                  int64_t i) {
+  return folly::dynamic(array.GetString(i));
+}
+
+inline folly::dynamic array_value(const arrow::LargeStringArray& array,
+                                  int64_t i) {
+  return folly::dynamic(array.GetString(i));
+}
+
+template <typename ARRAY_T, typename SETTER_T>
+inline void fill_column(const arrow::Array& array, int64_t begin, int64_t end,
+                        const SETTER_T& setter) {
+  auto& typed_array = dynamic_cast<const ARRAY_T&>(array);
+  for (int64_t i = begin; i < end; ++i) {
+    if (!typed_array.IsNull(i)) {
+      setter(i, array_value(typed_array, i));
+    }
+  }
+}
+
+inline bool is_supported(const std::shared_ptr<arrow::DataType>& type) {
+  switch (type->id()) {
+  case arrow::Type::BOOL:
+  case arrow::Type::INT32:
+  case arrow::Type::INT64:
+  case arrow::Type::UINT32:
+  case arrow::Type::UINT64:
+  case arrow::Type::FLOAT:
+  case arrow::Type::DOUBLE:
+  case arrow::Type::STRING:
+  case arrow::Type::LARGE_STRING:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Calls setter(row, value) for each non-null value in [begin, end) of
+ * the array, whose type must be checked by is_supported() in advance.
+ */
+template <typename SETTER_T>
+inline void fill(const arrow::Array& array, int64_t begin, int64_t end,
+                 const SETTER_T& setter) {
+  switch (array.type_id()) {
+  case arrow::Type::BOOL:
+    fill_column<arrow::BooleanArray>(array, begin, end, setter);
+    break;
+  case arrow::Type::INT32:
+    fill_column<arrow::Int32Array>(array, begin, end, setter);
+    break;
+  case arrow::Type::INT64:
+    fill_column<arrow::Int64Array>(array, begin, end, setter);
+    break;
+  case arrow::Type::UINT32:
+    fill_column<arrow::UInt32Array>(array, begin, end, setter);
+    break;
+  case arrow::Type::UINT64:
+    fill_column<arrow::UInt64Array>(array, begin, end, setter);
+    break;
+  case arrow::Type::FLOAT:
+    fill_column<arrow::FloatArray>(array, begin, end, setter);
+    break;
+  case arrow::Type::DOUBLE:
+    fill_column<arrow::DoubleArray>(array, begin, end, setter);
+    break;
+  case arrow::Type::STRING:
+    fill_column<arrow::StringArray>(array, begin, end, setter);
+    break;
+  case arrow::Type::LARGE_STRING:
+    fill_column<arrow::LargeStringArray>(array, begin, end, setter);
+    break;
+  default:
+    LOG(FATAL) << "Unexpected type: " << array.type()->ToString();
+  }
+}
+
+}  // namespace dynamic_batch_parser_impl
+
+/**
+ * @brief A parser for the columnar form of MODIFY_EDGES/MODIFY_VERTICES. The
+ * batch is an arrow IPC stream, whose leading columns are the ids (src and
+ * dst for edges, id for vertices) and the rest columns are the properties,
+ * named by the field names. Null properties are omitted. The rows are
+ * converted to folly::dynamic by multiple threads.
+ */
+class DynamicBatchParser {
+ public:
+  using oid_t = folly::dynamic;
+  using vdata_t = folly::dynamic;
+  using edata_t = folly::dynamic;
+
+  explicit DynamicBatchParser(
+      int thread_num = std::thread::hardware_concurrency())
+      : thread_num_(std::max(thread_num, 1)) {}
+
+  bl::result<void> ParseEdges(const std::string& batch,
+                              std::vector<oid_t>& srcs,
+                              std::vector<oid_t>& dsts,
+                              std::vector<edata_t>& edatas) {
+    BOOST_LEAF_AUTO(table, readTable(batch, 2));
+    auto num_rows = table->num_rows();
+    srcs.clear();
+    dsts.clear();
+    edatas.clear();
+    srcs.resize(num_rows);
+    dsts.resize(num_rows);
+    edatas.resize(num_rows, folly::dynamic::object);
+    auto id_column = [&](int col_id) -> oid_t* {
+      return col_id == 0 ? srcs.data() : dsts.data();
+    };
+    parse(table, 2, id_column, edatas.data());
+    return {};
+  }
+
+  bl::result<void> ParseVertices(const std::string& batch,
+                                 std::vector<oid_t>& oids,
+                                 std::vector<vdata_t>& vdatas) {
+    BOOST_LEAF_AUTO(table, readTable(batch, 1));
+    auto num_rows = table->num_rows();
+    oids.clear();
+    vdatas.clear();
+    oids.resize(num_rows);
+    vdatas.resize(num_rows, folly::dynamic::object);
+    parse(table, 1, [&](int) -> oid_t* { return oids.data(); },
+          vdatas.data());
+    return {};
+  }
+
+ private:
+  bl::result<std::shared_ptr<arrow::Table>> readTable(const std::string& batch,
+                                                      int id_num) {
+    auto buffer = std::make_shared<arrow::Buffer>(
+        reinterpret_cast<const uint8_t*>(batch.data()), batch.size());
+    auto buffer_reader = std::make_shared<arrow::io::BufferReader>(buffer);
+    std::shared_ptr<arrow::ipc::RecordBatchReader> reader;
+    ARROW_OK_ASSIGN_OR_RAISE(
+        reader, arrow::ipc::RecordBatchStreamReader::Open(buffer_reader));
+    std::shared_ptr<arrow::Table> table;
+    ARROW_OK_OR_RAISE(reader->ReadAll(&table));
+    ARROW_OK_ASSIGN_OR_RAISE(
+        table, table->CombineChunks(arrow::default_memory_pool()));
+
+    if (table->num_columns() < id_num) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Expect at least " + std::to_string(id_num) +
+                          " id columns, got " +
+                          std::to_string(table->num_columns()));
+    }
+    for (int col_id = 0; col_id < table->num_columns(); ++col_id) {
+      auto column = table->column(col_id);
+      if (!dynamic_batch_parser_impl::is_supported(column->type())) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                        "Unexpected type: " + column->type()->ToString() +
+                            " of column " + table->field(col_id)->name());
+      }
+      if (col_id < id_num && column->null_count() != 0) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                        "Null id in column " + table->field(col_id)->name());
+      }
+    }
+    return table;
+  }
+
+  template <typename ID_COLUMN_FUNC_T>
+  void parse(const std::shared_ptr<arrow::Table>& table, int id_num,
+             const ID_COLUMN_FUNC_T& id_column, folly::dynamic* datas) {
+    int64_t num_rows = table->num_rows();
+    if (num_rows == 0) {
+      return;
+    }
+    int thread_num =
+        static_cast<int>(std::min<int64_t>(thread_num_, num_rows));
+    int64_t chunk = (num_rows + thread_num - 1) / thread_num;
+    std::vector<std::thread> threads(thread_num);
+
+    for (int tid = 0; tid < thread_num; ++tid) {
+      threads[tid] = std::thread([&, tid]() {
+        int64_t begin = std::min(num_rows, tid * chunk);
+        int64_t end = std::min(num_rows, begin + chunk);
+        for (int col_id = 0; col_id < table->num_columns(); ++col_id) {
+          auto& array = *table->column(col_id)->chunk(0);
+          if (col_id < id_num) {
+            oid_t* ids = id_column(col_id);
+            dynamic_batch_parser_impl::fill(
+                array, begin, end, [ids](int64_t i, folly::dynamic&& v) {
+                  ids[i] = std::move(v);
+                });
+          } else {
+            const std::string& key = table->field(col_id)->name();
+            dynamic_batch_parser_impl::fill(
+                array, begin, end,
+                [datas, &key](int64_t i, folly::dynamic&& v) {
+                  datas[i][key] = std::move(v);
+                });
+          }
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+  }
+
+  int thread_num_;
+};
+
+}  // namespace gs
+
+#endif  // NETWORKX
+#endif  // ANALYTICAL_ENGINE_CORE_IO_DYNAMIC_BATCH_PARSER_H_
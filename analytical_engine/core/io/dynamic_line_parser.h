@@ -19,12 +19,15 @@
 #ifdef NETWORKX
 
 #include <cctype>
+#include <cstdint>
 
 #include <regex>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "glog/logging.h"
+
 #include "folly/dynamic.h"
 #include "folly/json.h"
 
@@ -32,7 +35,12 @@
 #include "grape/io/line_parser_base.h"
 #include "grape/types.h"
 
+#include "core/utils/parallel_utils.h"
+
 namespace gs {
+// the lines parsed by a thread at least
+static constexpr size_t kParseGrainSize = 1024;
+
 /**
  * @brief A parser can parse a line that represents an edge. A line may contain
  * the source, destination, and data of the edge.
@@ -47,27 +55,116 @@ class DynamicLineParser
   using edata_t = folly::dynamic;
   DynamicLineParser() = default;
 
+  // the parts of the parsed line are moved out rather than copied
   void LineParserForEFile(const std::string& line, oid_t& u, oid_t& v,
                           edata_t& e_data) override {
     auto edge = folly::parseJson(line);
-    u = edge[0];
-    v = edge[1];
-    if (edge.size() == 3) {
-      e_data = edge[2];
-    } else if (edge.size() > 3) {
+    if (edge.size() > 3) {
       throw std::runtime_error("not a valid edge: " + line);
     }
+    u = std::move(edge[0]);
+    v = std::move(edge[1]);
+    if (edge.size() == 3) {
+      e_data = std::move(edge[2]);
+    }
   }
 
   void LineParserForVFile(const std::string& line, oid_t& u,
                           oid_t& u_data) override {
     auto node = folly::parseJson(line);
-    u = node[0];
+    u = std::move(node[0]);
     if (node.size() > 1) {
-      u_data = node[1];
+      u_data = std::move(node[1]);
     }
   }
 };
+
+namespace dynamic_line_parser_impl {
+
+inline bool skip_line(const std::string& line) {
+  return line.empty() || line[0] == '#';
+}
+
+// keeps the rows of which the flags are set, in order
+template <typename T>
+void compact(std::vector<T>& rows, const std::vector<uint8_t>& flags) {
+  size_t kept = 0;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (flags[i]) {
+      if (kept != i) {
+        rows[kept] = std::move(rows[i]);
+      }
+      ++kept;
+    }
+  }
+  rows.resize(kept);
+}
+
+}  // namespace dynamic_line_parser_impl
+
+/**
+ * @brief Parses the json lines of the edges by multiple threads, in the order
+ * of the lines. The empty lines, the comments and the invalid lines are
+ * skipped, and an edge without data has an empty object as its data.
+ */
+inline void ParseEdgeLines(const std::vector<std::string>& lines,
+                           std::vector<folly::dynamic>& srcs,
+                           std::vector<folly::dynamic>& dsts,
+                           std::vector<folly::dynamic>& edatas) {
+  size_t n = lines.size();
+  srcs.resize(n);
+  dsts.resize(n);
+  edatas.assign(n, folly::dynamic::object);
+  std::vector<uint8_t> parsed(n, 0);
+  parallel_for(
+      0, n,
+      [&](size_t i) {
+        if (dynamic_line_parser_impl::skip_line(lines[i])) {
+          return;
+        }
+        DynamicLineParser parser;
+        try {
+          parser.LineParserForEFile(lines[i], srcs[i], dsts[i], edatas[i]);
+          parsed[i] = 1;
+        } catch (std::exception& e) {
+          LOG(ERROR) << e.what() << " line: " << lines[i];
+        }
+      },
+      kParseGrainSize);
+  dynamic_line_parser_impl::compact(srcs, parsed);
+  dynamic_line_parser_impl::compact(dsts, parsed);
+  dynamic_line_parser_impl::compact(edatas, parsed);
+}
+
+/**
+ * @brief Parses the json lines of the vertices by multiple threads, as
+ * ParseEdgeLines.
+ */
+inline void ParseVertexLines(const std::vector<std::string>& lines,
+                             std::vector<folly::dynamic>& oids,
+                             std::vector<folly::dynamic>& vdatas) {
+  size_t n = lines.size();
+  oids.resize(n);
+  vdatas.assign(n, folly::dynamic::object);
+  std::vector<uint8_t> parsed(n, 0);
+  parallel_for(
+      0, n,
+      [&](size_t i) {
+        if (dynamic_line_parser_impl::skip_line(lines[i])) {
+          return;
+        }
+        DynamicLineParser parser;
+        try {
+          parser.LineParserForVFile(lines[i], oids[i], vdatas[i]);
+          parsed[i] = 1;
+        } catch (std::exception& e) {
+          LOG(ERROR) << e.what() << " line: " << lines[i];
+        }
+      },
+      kParseGrainSize);
+  dynamic_line_parser_impl::compact(oids, parsed);
+  dynamic_line_parser_impl::compact(vdatas, parsed);
+}
 }  // namespace gs
 
 #endif  // NETWORKX
@@ -0,0 +1,331 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_IO_GRAPH_GENERATOR_H_
+#define ANALYTICAL_ENGINE_CORE_IO_GRAPH_GENERATOR_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "arrow/api.h"
+#include "boost/algorithm/string.hpp"
+
+#include "vineyard/basic/ds/arrow_utils.h"
+#include "vineyard/common/util/status.h"
+
+namespace gs {
+
+namespace graph_generator_impl {
+
+static constexpr const char* kScheme = "rmat://";
+// the edges generated by a random engine, so the graph does not depend on
+// the number of the parts
+static constexpr int64_t kChunkEdges = 1 << 16;
+
+struct RMATSpec {
+  // the vertices are [0, 2^scale)
+  int scale = 16;
+  int64_t edge_factor = 16;
+  // the probabilities of the quadrants, d is 1 - a - b - c
+  double a = 0.57;
+  double b = 0.19;
+  double c = 0.19;
+  uint64_t seed = 1;
+  // scatters the hubs over the ids by a bijection of the ids
+  bool scramble = true;
+  bool properties = true;
+};
+
+inline uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// a bijection of [0, 2^scale), i.e., an odd multiplier and a xor shift, both
+// modulo 2^scale
+inline int64_t scramble(uint64_t id, int scale, uint64_t seed) {
+  uint64_t mask = scale >= 64 ? ~0ULL : (1ULL << scale) - 1;
+  id = (id * (mix(seed) | 1)) & mask;
+  id ^= id >> (scale / 2 + 1);
+  id = (id * (mix(seed + 1) | 1)) & mask;
+  return static_cast<int64_t>(id);
+}
+
+// splits "rmat://<kind>?<params>#<meta>" into the kind, the params and the
+// meta, e.g., the labels, of which the items are separated by '&', and the
+// meta by '#' as well, as the loaders append "#header_row=true"
+inline void parse_location(
+    const std::string& location, std::string& kind,
+    std::map<std::string, std::string>& params,
+    std::unordered_map<std::string, std::string>& meta) {
+  auto parse_items = [](const std::string& str, const char* separators,
+                        auto& items) {
+    std::vector<std::string> tokens;
+    boost::split(tokens, str, boost::is_any_of(separators));
+    for (auto& token : tokens) {
+      auto eq = token.find('=');
+      if (eq != std::string::npos) {
+        items[token.substr(0, eq)] = token.substr(eq + 1);
+      }
+    }
+  };
+  auto hash = location.find('#');
+  std::string uri = location.substr(0, hash);
+  if (hash != std::string::npos) {
+    parse_items(location.substr(hash + 1), "&#", meta);
+  }
+  uri = uri.substr(std::string(kScheme).size());
+  auto question = uri.find('?');
+  kind = uri.substr(0, question);
+  if (question != std::string::npos) {
+    parse_items(uri.substr(question + 1), "&", params);
+  }
+}
+
+inline vineyard::Status parse_spec(
+    const std::map<std::string, std::string>& params, RMATSpec& spec) {
+  try {
+    for (auto& param : params) {
+      if (param.first == "scale") {
+        spec.scale = std::stoi(param.second);
+      } else if (param.first == "edge_factor") {
+        spec.edge_factor = std::stoll(param.second);
+      } else if (param.first == "a") {
+        spec.a = std::stod(param.second);
+      } else if (param.first == "b") {
+        spec.b = std::stod(param.second);
+      } else if (param.first == "c") {
+        spec.c = std::stod(param.second);
+      } else if (param.first == "seed") {
+        spec.seed = std::stoull(param.second);
+      } else if (param.first == "scramble") {
+        spec.scramble = param.second != "0" && param.second != "false";
+      } else if (param.first == "properties") {
+        spec.properties = param.second != "0" && param.second != "false";
+      } else {
+        return vineyard::Status::Invalid("Unknown parameter of rmat: " +
+                                         param.first);
+      }
+    }
+  } catch (std::exception& e) {
+    return vineyard::Status::Invalid("Invalid parameter of rmat: " +
+                                     std::string(e.what()));
+  }
+  if (spec.scale <= 0 || spec.scale > 40 || spec.edge_factor < 0 ||
+      spec.a < 0 || spec.b < 0 || spec.c < 0 || spec.a + spec.b + spec.c > 1) {
+    return vineyard::Status::Invalid("Invalid spec of rmat");
+  }
+  return vineyard::Status::OK();
+}
+
+// runs func(begin, end) on [begin, end) split by the threads
+template <typename FUNC_T>
+void parallel_for(int64_t begin, int64_t end, const FUNC_T& func) {
+  int concurrency = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(std::thread::hardware_concurrency(), end - begin)));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < concurrency; ++i) {
+    threads.emplace_back([&, i]() {
+      func(begin + (end - begin) * i / concurrency,
+           begin + (end - begin) * (i + 1) / concurrency);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+template <typename T>
+vineyard::Status to_array(const std::vector<T>& values,
+                          std::shared_ptr<arrow::Array>& array) {
+  typename vineyard::ConvertToArrowType<T>::BuilderType builder;
+  RETURN_ON_ARROW_ERROR(builder.AppendValues(values));
+  RETURN_ON_ARROW_ERROR(builder.Finish(&array));
+  return vineyard::Status::OK();
+}
+
+// the vertices of the part, with the properties "value" in [0, 1000) and
+// "score" in [0, 1), by the hashes of the ids
+inline vineyard::Status generate_vertices(
+    const RMATSpec& spec, int index, int total_parts,
+    std::shared_ptr<arrow::Table>& table) {
+  int64_t vertex_num = int64_t(1) << spec.scale;
+  int64_t begin = vertex_num * index / total_parts;
+  int64_t end = vertex_num * (index + 1) / total_parts;
+  std::vector<int64_t> ids(end - begin), values;
+  std::vector<double> scores;
+  if (spec.properties) {
+    values.resize(ids.size());
+    scores.resize(ids.size());
+  }
+  parallel_for(begin, end, [&](int64_t sub_begin, int64_t sub_end) {
+    for (int64_t id = sub_begin; id < sub_end; ++id) {
+      ids[id - begin] = id;
+      if (spec.properties) {
+        uint64_t h = mix(spec.seed ^ mix(static_cast<uint64_t>(id)));
+        values[id - begin] = static_cast<int64_t>(h % 1000);
+        scores[id - begin] = static_cast<double>(h >> 11) * 0x1.0p-53;
+      }
+    }
+  });
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field("id", arrow::int64())};
+  std::vector<std::shared_ptr<arrow::Array>> columns(1);
+  RETURN_ON_ERROR(to_array(ids, columns[0]));
+  if (spec.properties) {
+    fields.push_back(arrow::field("value", arrow::int64()));
+    fields.push_back(arrow::field("score", arrow::float64()));
+    columns.resize(3);
+    RETURN_ON_ERROR(to_array(values, columns[1]));
+    RETURN_ON_ERROR(to_array(scores, columns[2]));
+  }
+  table = arrow::Table::Make(arrow::schema(fields), columns);
+  return vineyard::Status::OK();
+}
+
+// the edges of the chunks of the part, each of which descends the quadrants
+// of the adjacency matrix by the probabilities scale times, with the
+// properties "weight" in [1, 100] and "timestamp" in [0, 2^31)
+inline vineyard::Status generate_edges(const RMATSpec& spec, int index,
+                                       int total_parts,
+                                       std::shared_ptr<arrow::Table>& table) {
+  int64_t edge_num = spec.edge_factor << spec.scale;
+  int64_t chunk_num = (edge_num + kChunkEdges - 1) / kChunkEdges;
+  int64_t chunk_begin = chunk_num * index / total_parts;
+  int64_t chunk_end = chunk_num * (index + 1) / total_parts;
+  int64_t begin = std::min(chunk_begin * kChunkEdges, edge_num);
+  int64_t end = std::min(chunk_end * kChunkEdges, edge_num);
+  std::vector<int64_t> srcs(end - begin), dsts(end - begin), weights,
+      timestamps;
+  if (spec.properties) {
+    weights.resize(srcs.size());
+    timestamps.resize(srcs.size());
+  }
+  double ab = spec.a + spec.b;
+  double a_in_ab = ab > 0 ? spec.a / ab : 0;
+  double c_in_cd = 1 - ab > 0 ? spec.c / (1 - ab) : 0;
+
+  parallel_for(chunk_begin, chunk_end, [&](int64_t sub_begin,
+                                           int64_t sub_end) {
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int64_t chunk = sub_begin; chunk < sub_end; ++chunk) {
+      std::mt19937_64 rng(mix(spec.seed) ^ mix(static_cast<uint64_t>(chunk)));
+      int64_t edge_end = std::min((chunk + 1) * kChunkEdges, edge_num);
+      for (int64_t e = chunk * kChunkEdges; e < edge_end; ++e) {
+        uint64_t src = 0, dst = 0;
+        for (int bit = 0; bit < spec.scale; ++bit) {
+          bool down = unit(rng) >= ab;
+          bool right = unit(rng) >= (down ? c_in_cd : a_in_ab);
+          src = src << 1 | static_cast<uint64_t>(down);
+          dst = dst << 1 | static_cast<uint64_t>(right);
+        }
+        int64_t offset = e - begin;
+        srcs[offset] = spec.scramble ? scramble(src, spec.scale, spec.seed)
+                                     : static_cast<int64_t>(src);
+        dsts[offset] = spec.scramble ? scramble(dst, spec.scale, spec.seed)
+                                     : static_cast<int64_t>(dst);
+        if (spec.properties) {
+          uint64_t h = rng();
+          weights[offset] = static_cast<int64_t>(h % 100) + 1;
+          timestamps[offset] = static_cast<int64_t>((h >> 32) & 0x7fffffff);
+        }
+      }
+    }
+  });
+
+  std::vector<std::shared_ptr<arrow::Field>> fields{
+      arrow::field("src", arrow::int64()), arrow::field("dst", arrow::int64())};
+  std::vector<std::shared_ptr<arrow::Array>> columns(2);
+  RETURN_ON_ERROR(to_array(srcs, columns[0]));
+  RETURN_ON_ERROR(to_array(dsts, columns[1]));
+  if (spec.properties) {
+    fields.push_back(arrow::field("weight", arrow::int64()));
+    fields.push_back(arrow::field("timestamp", arrow::int64()));
+    columns.resize(4);
+    RETURN_ON_ERROR(to_array(weights, columns[2]));
+    RETURN_ON_ERROR(to_array(timestamps, columns[3]));
+  }
+  table = arrow::Table::Make(arrow::schema(fields), columns);
+  return vineyard::Status::OK();
+}
+
+}  // namespace graph_generator_impl
+
+/**
+ * @brief Whether the location is a generated graph, i.e.,
+ * "rmat://vertices?<params>#label=v" or
+ * "rmat://edges?<params>#label=e&src_label=v&dst_label=v", which is built in
+ * memory by GenerateTable rather than read by the io adaptors.
+ */
+inline bool IsGeneratedLocation(const std::string& location) {
+  return boost::algorithm::starts_with(location,
+                                       graph_generator_impl::kScheme);
+}
+
+/**
+ * @brief The meta of the generated location, i.e., the items after '#', e.g.,
+ * the label, like the ones of the io adaptors.
+ */
+inline std::unordered_map<std::string, std::string> GeneratedLocationMeta(
+    const std::string& location) {
+  std::string kind;
+  std::map<std::string, std::string> params;
+  std::unordered_map<std::string, std::string> meta;
+  graph_generator_impl::parse_location(location, kind, params, meta);
+  return meta;
+}
+
+/**
+ * @brief Generates the part index of total_parts of the vertices or the
+ * edges of an R-MAT graph, i.e., the stochastic Kronecker graph of the 2 x 2
+ * initiator (a, b; c, d), as the Graph500 generator. The params are scale,
+ * edge_factor, a, b, c, seed, scramble and properties, see RMATSpec, which
+ * must be the same for the vertices and the edges of a graph. The edges of
+ * every part are generated by all the cores, and the graph is the same for
+ * any number of the parts. The ids are int64, and the duplicated edges and
+ * the self loops are kept.
+ */
+inline vineyard::Status GenerateTable(const std::string& location, int index,
+                                      int total_parts,
+                                      std::shared_ptr<arrow::Table>& table) {
+  std::string kind;
+  std::map<std::string, std::string> params;
+  std::unordered_map<std::string, std::string> meta;
+  graph_generator_impl::parse_location(location, kind, params, meta);
+  graph_generator_impl::RMATSpec spec;
+  RETURN_ON_ERROR(graph_generator_impl::parse_spec(params, spec));
+  if (kind == "vertices") {
+    return graph_generator_impl::generate_vertices(spec, index, total_parts,
+                                                   table);
+  } else if (kind == "edges") {
+    return graph_generator_impl::generate_edges(spec, index, total_parts,
+                                                table);
+  }
+  return vineyard::Status::Invalid("Unknown kind of rmat: " + location);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_IO_GRAPH_GENERATOR_H_
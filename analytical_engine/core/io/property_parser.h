@@ -16,6 +16,7 @@
 #ifndef ANALYTICAL_ENGINE_CORE_IO_PROPERTY_PARSER_H_
 #define ANALYTICAL_ENGINE_CORE_IO_PROPERTY_PARSER_H_
 
+#include <algorithm>
 #include <atomic>
 #include <iostream>
 #include <map>
@@ -123,11 +124,20 @@ struct Graph {
   std::vector<std::shared_ptr<Edge>> edges;
   bool directed;
   bool generate_eid;
+  // the number of the threads reading the slice of a file on each worker
+  int read_concurrency = 1;
+  // the strategy to place the vertices, the default one of the loader if empty
+  std::string partition_strategy;
+  // whether the property columns are encoded before sealed
+  bool compress_properties = false;
 
   std::string SerializeToString() const {
     std::stringstream ss;
     ss << "directed: " << directed << "\n";
     ss << "generate_eid: " << generate_eid << "\n";
+    ss << "read_concurrency: " << read_concurrency << "\n";
+    ss << "partition_strategy: " << partition_strategy << "\n";
+    ss << "compress_properties: " << compress_properties << "\n";
     for (auto& v : vertices) {
       ss << v->SerializeToString();
     }
@@ -222,6 +232,19 @@ inline bl::result<std::shared_ptr<detail::Graph>> ParseCreatePropertyGraph(
 
   graph->directed = directed;
   graph->generate_eid = generate_eid;
+  if (params.HasKey(rpc::READ_CONCURRENCY)) {
+    BOOST_LEAF_AUTO(read_concurrency,
+                    params.Get<int64_t>(rpc::READ_CONCURRENCY));
+    graph->read_concurrency = std::max(static_cast<int>(read_concurrency), 1);
+  }
+  if (params.HasKey(rpc::PARTITION_STRATEGY)) {
+    BOOST_LEAF_ASSIGN(graph->partition_strategy,
+                      params.Get<std::string>(rpc::PARTITION_STRATEGY));
+  }
+  if (params.HasKey(rpc::COMPRESS_PROPERTIES)) {
+    BOOST_LEAF_ASSIGN(graph->compress_properties,
+                      params.Get<bool>(rpc::COMPRESS_PROPERTIES));
+  }
 
   for (const auto& item : items) {
     if (item.name() == "vertex") {
@@ -13,8 +13,15 @@
  * limitations under the License.
  */
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <chrono>
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "grape/worker/comm_spec.h"
@@ -38,6 +45,12 @@ void VineyardServer::Start() {
     return;
   }
 
+  if (claimPooled()) {
+    LOG(INFO) << "Attached to the pooled vineyardd on " << vineyard_socket_;
+    grape::BcastSend(vineyard_socket_, comm_spec_.local_comm());
+    return;
+  }
+
   // Use a unique timestamp as the etcd prefix to avoid contention between
   // unrelated vineyardd processes.
   auto ts = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -66,6 +79,10 @@ void VineyardServer::Start() {
                     " --size " + "2048000000" + " --etcd_endpoint " +
                     FLAGS_etcd_endpoint + " --etcd_prefix vineyard.gsa." +
                     std::to_string(ts);
+  // the other workers of the machine go on while vineyardd is starting, and
+  // wait for it when connecting
+  grape::BcastSend(vineyard_socket_, comm_spec_.local_comm());
+
   auto env = boost::this_process::environment();
   // Set verbosity level to 2 can get rid of most of vineyard server's
   // debugging output
@@ -83,8 +100,6 @@ void VineyardServer::Start() {
     LOG(INFO) << "vineyardd launched: pid = " << proc_->id()
               << ", listening on " << vineyard_socket_;
   }
-
-  grape::BcastSend(vineyard_socket_, comm_spec_.local_comm());
 }
 
 void VineyardServer::Stop() {
@@ -92,6 +107,45 @@ void VineyardServer::Stop() {
     kill(proc_->id(), SIGTERM);
     proc_->wait();
   }
+  if (!lock_file_.empty()) {
+    unlink(lock_file_.c_str());
+    lock_file_.clear();
+  }
+}
+
+bool VineyardServer::claimPooled() {
+  std::stringstream ss(FLAGS_vineyard_socket_pool);
+  std::string socket;
+  while (std::getline(ss, socket, ',')) {
+    struct stat st;
+    if (socket.empty() || stat(socket.c_str(), &st) != 0 ||
+        !S_ISSOCK(st.st_mode)) {
+      continue;
+    }
+    std::string lock_file = socket + ".gs_lock";
+    int fd = open(lock_file.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+    if (fd < 0 && errno == EEXIST) {
+      // takes over the lock left by an engine which has exited
+      pid_t pid = 0;
+      std::ifstream(lock_file) >> pid;
+      if (pid > 0 && kill(pid, 0) != 0 && errno == ESRCH) {
+        unlink(lock_file.c_str());
+        fd = open(lock_file.c_str(), O_CREAT | O_EXCL | O_WRONLY, 0644);
+      }
+    }
+    if (fd < 0) {
+      continue;
+    }
+    std::string pid = std::to_string(getpid());
+    if (write(fd, pid.data(), pid.size()) < 0) {
+      LOG(WARNING) << "Failed to write the lock file " << lock_file;
+    }
+    close(fd);
+    vineyard_socket_ = socket;
+    lock_file_ = lock_file;
+    return true;
+  }
+  return false;
 }
 
 void EnsureClient(std::shared_ptr<vineyard::Client>& client,
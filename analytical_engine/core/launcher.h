@@ -31,7 +31,10 @@
 namespace gs {
 
 /**
- * @brief VineyardServer is a launcher for vineyardd
+ * @brief VineyardServer is a launcher for vineyardd. Unless a vineyard socket
+ * is given, a free instance of the pool of the pre-launched vineyardd is
+ * claimed by a lock file aside its socket, or else a vineyardd is launched,
+ * once on each machine.
  */
 class VineyardServer {
  public:
@@ -47,8 +50,12 @@ class VineyardServer {
   void Stop();
 
  private:
+  // claims a free socket of the pool, returns false if none
+  bool claimPooled();
+
   grape::CommSpec comm_spec_;
   std::string vineyard_socket_;
+  std::string lock_file_;
   std::unique_ptr<boost::process::child> proc_;
 };
 
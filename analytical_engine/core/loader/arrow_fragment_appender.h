@@ -19,6 +19,8 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "arrow/csv/api.h"
@@ -27,6 +29,7 @@
 #include "arrow/util/key_value_metadata.h"
 #include "boost/algorithm/string/split.hpp"
 #include "boost/algorithm/string/trim.hpp"
+#include "grape/communication/communicator.h"
 
 #include "vineyard/basic/ds/arrow_utils.h"
 #include "vineyard/graph/loader/basic_arrow_fragment_loader.h"
@@ -37,77 +40,64 @@
 namespace gs {
 
 /**
- * @brief BroadcastOIDs is a utility to broadcast oids
+ * @brief Gets the oids in the id column of a vertex table.
  * @tparam OID_T
  */
 template <typename OID_T>
 typename std::enable_if<!std::is_same<OID_T, std::string>::value,
-                        std::vector<std::vector<OID_T>>>::type
-bcast_oids(std::vector<std::shared_ptr<arrow::Table>>& v_tables,
-           vineyard::property_graph_types::LABEL_ID_TYPE vertex_label_num,
-           grape::CommSpec& comm_spec) {
-  using oid_t = OID_T;
-  using oid_array_t = typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
-
-  std::vector<std::vector<oid_t>> oids_list;
-
-  for (auto v_label_id = 0; v_label_id < vertex_label_num; v_label_id++) {
-    if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-      auto& v_table = v_tables[v_label_id];
+                        std::vector<OID_T>>::type
+get_oids(const std::shared_ptr<arrow::Table>& v_table) {
+  using oid_array_t = typename vineyard::ConvertToArrowType<OID_T>::ArrayType;
 
-      CHECK_EQ(v_table->field(0)->type(), arrow::int64());
-      CHECK_EQ(v_table->column(0)->num_chunks(), 1);
-      auto array =
-          std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
+  CHECK_EQ(v_table->field(0)->type(), arrow::int64());
+  CHECK_EQ(v_table->column(0)->num_chunks(), 1);
+  auto array =
+      std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
 
-      std::vector<oid_t> oids(array->raw_values(),
-                              array->raw_values() + array->length());
-
-      grape::BcastSend(oids, comm_spec.comm());
-      oids_list.push_back(oids);
-    } else {
-      std::vector<oid_t> oids;
-      grape::BcastRecv(oids, comm_spec.comm(), grape::kCoordinatorRank);
-      oids_list.push_back(oids);
-    }
-  }
-  return oids_list;
+  return std::vector<OID_T>(array->raw_values(),
+                            array->raw_values() + array->length());
 }
 
 /**
- * @brief This is a specialized BroadcastOIDs for string type
+ * @brief This is a specialized get_oids for string type
  */
 template <typename OID_T>
 typename std::enable_if<std::is_same<OID_T, std::string>::value,
-                        std::vector<std::vector<OID_T>>>::type
-bcast_oids(std::vector<std::shared_ptr<arrow::Table>>& v_tables,
-           vineyard::property_graph_types::LABEL_ID_TYPE vertex_label_num,
-           grape::CommSpec& comm_spec) {
-  using oid_t = std::string;
-  using oid_array_t = typename vineyard::ConvertToArrowType<oid_t>::ArrayType;
+                        std::vector<OID_T>>::type
+get_oids(const std::shared_ptr<arrow::Table>& v_table) {
+  using oid_array_t = typename vineyard::ConvertToArrowType<OID_T>::ArrayType;
+
+  CHECK_EQ(v_table->field(0)->type(), arrow::large_utf8());
+  CHECK_EQ(v_table->column(0)->num_chunks(), 1);
+  auto array =
+      std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
+  std::vector<OID_T> oids(array->length());
+
+  for (int64_t i = 0; i < array->length(); i++) {
+    oids[i] = array->GetString(i);
+  }
+  return oids;
+}
 
-  std::vector<std::vector<oid_t>> oids_list;
+/**
+ * @brief Gathers the oids of the vertex tables of all of the workers, in the
+ * order of the workers, so every worker adds the new vertices in the same
+ * order.
+ * @tparam OID_T
+ */
+template <typename OID_T>
+std::vector<std::vector<OID_T>> gather_oids(
+    std::vector<std::shared_ptr<arrow::Table>>& v_tables,
+    vineyard::property_graph_types::LABEL_ID_TYPE vertex_label_num,
+    grape::Communicator& communicator) {
+  std::vector<std::vector<OID_T>> oids_list(vertex_label_num);
 
   for (auto v_label_id = 0; v_label_id < vertex_label_num; v_label_id++) {
-    if (comm_spec.worker_id() == grape::kCoordinatorRank) {
-      auto& v_table = v_tables[v_label_id];
-
-      CHECK_EQ(v_table->field(0)->type(), arrow::large_utf8());
-      CHECK_EQ(v_table->column(0)->num_chunks(), 1);
-      auto array =
-          std::dynamic_pointer_cast<oid_array_t>(v_table->column(0)->chunk(0));
-      std::vector<oid_t> oids(array->length());
-
-      for (int64_t i = 0; i < array->length(); i++) {
-        oids[i] = array->GetString(i);
-      }
-
-      grape::BcastSend(oids, comm_spec.comm());
-      oids_list.push_back(oids);
-    } else {
-      std::vector<oid_t> oids;
-      grape::BcastRecv(oids, comm_spec.comm(), grape::kCoordinatorRank);
-      oids_list.push_back(oids);
+    std::vector<std::vector<OID_T>> all_oids;
+    communicator.AllGather(get_oids<OID_T>(v_tables[v_label_id]), all_oids);
+    for (auto& oids : all_oids) {
+      oids_list[v_label_id].insert(oids_list[v_label_id].end(), oids.begin(),
+                                   oids.end());
     }
   }
   return oids_list;
@@ -132,6 +122,8 @@ class ArrowFragmentAppender {
   const int dst_column = 1;
 
  public:
+  static constexpr size_t kDefaultCompactionThreshold = 1 << 20;
+
   explicit ArrowFragmentAppender(
       grape::CommSpec& comm_spec,
       std::shared_ptr<AppendOnlyArrowFragment<OID_T, VID_T>> fragment)
@@ -142,13 +134,26 @@ class ArrowFragmentAppender {
         vertex_label_num_(fragment->vertex_label_num_),
         edge_label_num_(fragment->edge_label_num_) {
     partitioner_.Init(comm_spec_.fnum());
+    communicator_.InitCommunicator(comm_spec_.comm());
+  }
+
+  /**
+   * @brief The fragment is compacted once the edges appended since its last
+   * compaction exceed the threshold, 0 disables the compaction.
+   */
+  void set_compaction_threshold(size_t threshold) {
+    compaction_threshold_ = threshold;
   }
 
   /**
-   * Only should be invoked on Coordinator process
+   * Extends the fragment by the lines of the vertices and the edges of each
+   * label. Each worker parses its own shard of the batch, which is empty,
+   * i.e., without any label, if the worker consumes nothing, e.g., when the
+   * whole batch is consumed on the coordinator.
    *
-   * @param vertex_messages
-   * @param edge_messages
+   * @param vertex_messages "id,properties..." lines of each vertex label
+   * @param edge_messages "src,dst,src_label,dst_label,properties..." lines of
+   * each edge label
    * @param directed
    */
   bl::result<int64_t> ExtendFragment(
@@ -156,46 +161,88 @@ class ArrowFragmentAppender {
       std::vector<std::vector<std::string>>& edge_messages, bool header_row,
       char delimiter, bool directed) {
     std::vector<std::shared_ptr<arrow::Table>> v_tables(vertex_label_num_);
+    std::vector<std::shared_ptr<arrow::Table>> e_tables(edge_label_num_);
 
-    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-      CHECK_EQ(vertex_messages.size(), fragment_->vertex_label_num());
-      CHECK_EQ(edge_messages.size(), fragment_->edge_label_num());
-    } else {
-      CHECK_EQ(vertex_messages.size(), 0);
-      CHECK_EQ(edge_messages.size(), 0);
+    CHECK(vertex_messages.empty() ||
+          vertex_messages.size() == fragment_->vertex_label_num());
+    CHECK(edge_messages.empty() ||
+          edge_messages.size() == fragment_->edge_label_num());
+
+    for (size_t v_label = 0; v_label < vertex_messages.size(); v_label++) {
+      auto& msgs = vertex_messages[v_label];
+
+      if (!msgs.empty() && !(header_row && msgs.size() == 1)) {
+        BOOST_LEAF_AUTO(tmp_v_table, ReadTable(msgs, header_row, delimiter));
+
+        if (header_row) {
+          auto existed_schema = fragment_->vertex_data_table(v_label)->schema();
+          std::shared_ptr<arrow::Schema> schema_without_id;
+
+          // make sure later append schema is the same with the existed one
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+          ARROW_OK_OR_RAISE(tmp_v_table->schema()->RemoveField(
+              id_column, &schema_without_id));
+#else
+          ARROW_OK_ASSIGN_OR_RAISE(
+              schema_without_id, tmp_v_table->schema()->RemoveField(id_column));
+#endif
+          CHECK(schema_without_id->Equals(existed_schema, false));
+        }
+        v_tables[v_label] = tmp_v_table;
+      }
     }
 
-    // parse vertex message and convert it into arrow::table
-    for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
-      auto existed_schema = fragment_->vertex_data_table(v_label)->schema();
+    for (size_t e_label = 0; e_label < edge_messages.size(); e_label++) {
+      auto& msgs = edge_messages[e_label];
 
-      if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-        auto& msgs = vertex_messages[v_label];
+      if (!msgs.empty() && !(header_row && msgs.size() == 1)) {
+        BOOST_LEAF_AUTO(tmp_table, ReadTable(msgs, header_row, delimiter));
+        // N.B.: remove src_label and dst_label columns
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+        ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(3, &tmp_table));
+        ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(2, &e_tables[e_label]));
+#else
+        ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(3));
+        ARROW_OK_ASSIGN_OR_RAISE(e_tables[e_label], tmp_table->RemoveColumn(2));
+#endif
+      }
+    }
 
-        if (msgs.empty() || (header_row && msgs.size() == 1)) {
-          VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
-                                                            v_tables[v_label]));
-        } else {
-          BOOST_LEAF_AUTO(tmp_v_table, ReadTable(msgs, header_row, delimiter));
+    return ExtendFragment(v_tables, e_tables, directed);
+  }
 
-          if (header_row) {
-            std::shared_ptr<arrow::Schema> schema_without_id;
+  /**
+   * Extends the fragment by the tables of the vertices and the edges of each
+   * label, e.g., built from the record batches of the shard of the batch
+   * consumed by each worker. The vertex tables are the id column followed by
+   * the properties, and the edge tables are the src and dst columns of oids
+   * followed by the properties. The absent tables, i.e., nullptr, are empty.
+   *
+   * @param vertex_tables the tables of each vertex label
+   * @param edge_tables the tables of each edge label
+   * @param directed
+   */
+  bl::result<int64_t> ExtendFragment(
+      std::vector<std::shared_ptr<arrow::Table>>& vertex_tables,
+      std::vector<std::shared_ptr<arrow::Table>>& edge_tables, bool directed) {
+    std::vector<std::shared_ptr<arrow::Table>> v_tables(vertex_label_num_);
+
+    CHECK_EQ(vertex_tables.size(), fragment_->vertex_label_num());
+    CHECK_EQ(edge_tables.size(), fragment_->edge_label_num());
 
-            // make sure later append schema is the same with the existed one
+    for (auto v_label = 0; v_label < vertex_label_num_; v_label++) {
+      if (vertex_tables[v_label] != nullptr) {
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-            ARROW_OK_OR_RAISE(tmp_v_table->schema()->RemoveField(
-                id_column, &schema_without_id));
+        ARROW_OK_OR_RAISE(vertex_tables[v_label]->CombineChunks(
+            arrow::default_memory_pool(), &v_tables[v_label]));
 #else
-            ARROW_OK_ASSIGN_OR_RAISE(
-                schema_without_id,
-                tmp_v_table->schema()->RemoveField(id_column));
+        ARROW_OK_ASSIGN_OR_RAISE(v_tables[v_label],
+                                 vertex_tables[v_label]->CombineChunks(
+                                     arrow::default_memory_pool()));
 #endif
-            CHECK(schema_without_id->Equals(existed_schema, false));
-          }
-          v_tables[v_label] = tmp_v_table;
-        }
       } else {
-        // build an empty table on other workers
+        // build an empty table on the workers without vertices
+        auto existed_schema = fragment_->vertex_data_table(v_label)->schema();
         std::shared_ptr<arrow::Schema> schema_with_id;
         auto id_field = std::make_shared<arrow::Field>(
             "id", vineyard::ConvertToArrowType<oid_t>::TypeValue());
@@ -222,51 +269,44 @@ class ArrowFragmentAppender {
         "dst", vineyard::ConvertToArrowType<vid_t>::TypeValue());
 
     for (auto e_label = 0; e_label < edge_label_num_; e_label++) {
-      auto existed_schema = fragment_->edge_data_table(e_label)->schema();
-
-      if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-        auto& msgs = edge_messages[e_label];
-
-        if (msgs.empty() || (header_row && msgs.size() == 1)) {
-          VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
-                                                            e_tables[e_label]));
-        } else {
-          auto meta = std::make_shared<arrow::KeyValueMetadata>();
-          BOOST_LEAF_AUTO(tmp_table, ReadTable(msgs, header_row, delimiter));
-          BOOST_LEAF_AUTO(src_gid_array,
-                          parseOidChunkedArray(tmp_table->column(src_column)));
-          BOOST_LEAF_AUTO(dst_gid_array,
-                          parseOidChunkedArray(tmp_table->column(dst_column)));
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-          ARROW_OK_OR_RAISE(tmp_table->SetColumn(src_column, src_gid_field,
-                                                 src_gid_array, &tmp_table));
-          ARROW_OK_OR_RAISE(tmp_table->SetColumn(dst_column, dst_gid_field,
-                                                 dst_gid_array, &tmp_table));
-#else
-          ARROW_OK_ASSIGN_OR_RAISE(
-              tmp_table,
-              tmp_table->SetColumn(src_column, src_gid_field, src_gid_array));
-          ARROW_OK_ASSIGN_OR_RAISE(
-              tmp_table,
-              tmp_table->SetColumn(dst_column, dst_gid_field, dst_gid_array));
-#endif
+      auto tmp_table = edge_tables[e_label];
 
+      if (tmp_table != nullptr && tmp_table->num_rows() != 0) {
+        BOOST_LEAF_AUTO(src_gid_array,
+                        parseOidChunkedArray(tmp_table->column(src_column)));
+        BOOST_LEAF_AUTO(dst_gid_array,
+                        parseOidChunkedArray(tmp_table->column(dst_column)));
 #if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-          ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(3, &tmp_table));
-          ARROW_OK_OR_RAISE(tmp_table->RemoveColumn(2, &e_tables[e_label]));
+        ARROW_OK_OR_RAISE(tmp_table->SetColumn(src_column, src_gid_field,
+                                               src_gid_array, &tmp_table));
+        ARROW_OK_OR_RAISE(tmp_table->SetColumn(dst_column, dst_gid_field,
+                                               dst_gid_array,
+                                               &e_tables[e_label]));
 #else
-          ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(3));
-          ARROW_OK_ASSIGN_OR_RAISE(e_tables[e_label],
-                                   tmp_table->RemoveColumn(2));
+        ARROW_OK_ASSIGN_OR_RAISE(
+            tmp_table,
+            tmp_table->SetColumn(src_column, src_gid_field, src_gid_array));
+        ARROW_OK_ASSIGN_OR_RAISE(
+            e_tables[e_label],
+            tmp_table->SetColumn(dst_column, dst_gid_field, dst_gid_array));
 #endif
-        }
       } else {
+        auto existed_schema = fragment_->edge_data_table(e_label)->schema();
         VY_OK_OR_RAISE(vineyard::EmptyTableBuilder::Build(existed_schema,
                                                           e_tables[e_label]));
       }
     }
 
-    return updateEdges(e_tables, directed);
+    BOOST_LEAF_AUTO(edge_num, updateEdges(e_tables, directed));
+    // the batch is the version boundary of the snapshots of the extra tables
+    for (auto& table : fragment_->extra_vertex_tables_) {
+      BOOST_LEAF_CHECK(table->Seal());
+    }
+    for (auto& table : fragment_->extra_edge_tables_) {
+      BOOST_LEAF_CHECK(table->Seal());
+    }
+    fragment_->recordAppendVersion();
+    return edge_num;
   }
 
  private:
@@ -338,12 +378,13 @@ class ArrowFragmentAppender {
       size_t size = oid_array->length();
       ARROW_OK_OR_RAISE(builder.Resize(size));
 
-      for (size_t i = 0; i != size; ++i) {
+      // the vertex maps are only read here
+      parallelFor(size, [&](size_t i) {
         internal_oid_t oid = oid_array->GetView(i);
         fid_t fid = partitioner_.GetPartitionId(oid_t(oid));
         CHECK(vm_ptr_->GetGid(fid, 0, oid, builder[i]) ||
               extra_vm_ptr_->GetGid(fid, oid_t(oid), builder[i]));
-      }
+      });
       ARROW_OK_OR_RAISE(builder.Advance(size));
       ARROW_OK_OR_RAISE(builder.Finish(&chunks_out[chunk_i]));
     }
@@ -354,7 +395,8 @@ class ArrowFragmentAppender {
   bl::result<void> updateVertices(
       std::vector<std::shared_ptr<arrow::Table>>& v_tables) {
     // every worker got a copy of oids
-    auto oids_list = bcast_oids<oid_t>(v_tables, vertex_label_num_, comm_spec_);
+    auto oids_list =
+        gather_oids<oid_t>(v_tables, vertex_label_num_, communicator_);
     std::vector<ska::flat_hash_set<oid_t>> appended_oid_list;
     auto vid_parser = fragment_->vid_parser_;
 
@@ -418,14 +460,16 @@ class ArrowFragmentAppender {
                                tmp_table->RemoveColumn(id_column));
 #endif
 
+      std::vector<int64_t> appended_rows;
       for (int64_t row = 0; row < oid_array->length(); row++) {
         auto oid = oid_array->GetView(row);
 
         if (appended_oids.find(oid_t(oid)) != appended_oids.end()) {
-          fragment_->extra_vertex_tables_[v_label_id]->AppendValue(
-              local_v_table, row);
+          appended_rows.push_back(row);
         }
       }
+      BOOST_LEAF_CHECK(fragment_->extra_vertex_tables_[v_label_id]->AppendRows(
+          local_v_table, appended_rows));
     }
     return {};
   }
@@ -517,6 +561,7 @@ class ArrowFragmentAppender {
 
     // now, insert edges into fragment
     uint64_t total_added_enum = 0;
+    std::vector<std::pair<vid_t, vid_t>> added_edges;
     for (label_id_t e_label = 0; e_label < edge_label_num_; e_label++) {
       auto& e_table = edge_tables[e_label];  // arrow table with src, dst column
       auto& internal_e_table = fragment_->extra_edge_tables_[e_label];
@@ -538,6 +583,7 @@ class ArrowFragmentAppender {
       ARROW_OK_ASSIGN_OR_RAISE(tmp_table, tmp_table->RemoveColumn(src_column));
 #endif
 
+      std::vector<int64_t> appended_rows;
       for (int64_t row = 0; row < e_table->num_rows(); row++) {
         auto src_gid = src_gids->Value(row), dst_gid = dst_gids->Value(row);
         auto src_v_label = vid_parser.GetLabelId(src_gid),
@@ -574,23 +620,63 @@ class ArrowFragmentAppender {
               fragment_->addOutgoingEdge(dst_lid, src_lid, e_label, eid);
         }
         if (added_enum > 0) {
-          internal_e_table->AppendValue(tmp_table, row);
+          appended_rows.push_back(row);
           eid++;
-          CHECK_EQ(eid, internal_e_table->size());
           total_added_enum += added_enum;
+          added_edges.emplace_back(src_gid, dst_gid);
         }
       }
+      BOOST_LEAF_CHECK(internal_e_table->AppendRows(tmp_table, appended_rows));
+      CHECK_EQ(fragment_->extra_oe_nums_[e_label], internal_e_table->size());
+    }
+    fragment_->mutation_log_.AddEdgeGids(added_edges);
+    if (compaction_threshold_ != 0 &&
+        fragment_->unsealed_edge_num() > compaction_threshold_) {
+      fragment_->Compact();
     }
     return total_added_enum;
   }
 
+  // runs func(i) for i in [0, size) in threads of the worker
+  template <typename FUNC_T>
+  void parallelFor(size_t size, const FUNC_T& func) {
+    constexpr size_t kMinChunkSize = 16384;
+    size_t thread_num = std::max<size_t>(
+        1, (std::thread::hardware_concurrency() + comm_spec_.local_num() - 1) /
+               comm_spec_.local_num());
+    thread_num =
+        std::min(thread_num, (size + kMinChunkSize - 1) / kMinChunkSize);
+    if (thread_num <= 1) {
+      for (size_t i = 0; i < size; ++i) {
+        func(i);
+      }
+      return;
+    }
+    size_t chunk = (size + thread_num - 1) / thread_num;
+    std::vector<std::thread> threads(thread_num);
+    for (size_t tid = 0; tid < thread_num; ++tid) {
+      threads[tid] = std::thread([&, tid] {
+        size_t begin = std::min(size, chunk * tid);
+        size_t end = std::min(size, begin + chunk);
+        for (size_t i = begin; i < end; ++i) {
+          func(i);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
   grape::CommSpec comm_spec_;
+  grape::Communicator communicator_;
   std::shared_ptr<AppendOnlyArrowFragment<OID_T, VID_T>> fragment_;
   std::shared_ptr<vineyard::ArrowVertexMap<internal_oid_t, VID_T>> vm_ptr_;
   std::shared_ptr<ExtraVertexMap<OID_T, VID_T>> extra_vm_ptr_;
   label_id_t vertex_label_num_;
   label_id_t edge_label_num_;
   partitioner_t partitioner_;
+  size_t compaction_threshold_ = kDefaultCompactionThreshold;
 };
 
 }  // namespace gs
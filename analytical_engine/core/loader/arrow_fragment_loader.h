@@ -17,15 +17,19 @@
 #define ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_LOADER_H_
 
 #include <algorithm>
+#include <functional>
+#include <future>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "grape/worker/comm_spec.h"
+#include "vineyard/basic/ds/dataframe.h"
 #include "vineyard/basic/stream/byte_stream.h"
 #include "vineyard/basic/stream/dataframe_stream.h"
 #include "vineyard/basic/stream/parallel_stream.h"
@@ -35,7 +39,12 @@
 #include "vineyard/io/io/io_factory.h"
 
 #include "core/error.h"
+#include "core/io/columnar_table_reader.h"
+#include "core/io/graph_generator.h"
 #include "core/io/property_parser.h"
+#include "core/loader/balanced_partitioner.h"
+#include "core/loader/load_profile.h"
+#include "core/loader/property_encoder.h"
 
 #define HASH_PARTITION
 
@@ -60,12 +69,25 @@ class ArrowFragmentLoader {
   static constexpr const char* DST_LABEL_TAG = "dst_label";
 
   const int id_column = 0;
+  const int src_column = 0;
+  const int dst_column = 1;
 
-#ifdef HASH_PARTITION
-  using partitioner_t = vineyard::HashPartitioner<oid_t>;
-#else
-  using partitioner_t = SegmentedPartitioner<oid_t>;
-#endif
+  using partitioner_t = BalancedPartitioner<oid_t>;
+  using edge_tables_t = std::vector<std::vector<std::shared_ptr<arrow::Table>>>;
+
+  using io_adaptor_t =
+      std::unique_ptr<vineyard::IIOAdaptor,
+                      std::function<void(vineyard::IIOAdaptor*)>>;
+
+  // a table read ahead from its io adaptor, which is kept for the metadata
+  struct PrefetchedTable {
+    bool fetched = false;
+    vineyard::Status status;
+    std::shared_ptr<arrow::Table> table;
+    io_adaptor_t io_adaptor{nullptr, [](vineyard::IIOAdaptor*) {}};
+  };
+  // by the edge labels, then the sub labels
+  using prefetched_tables_t = std::vector<std::vector<PrefetchedTable>>;
 
  public:
   ArrowFragmentLoader(vineyard::Client& client,
@@ -79,7 +101,8 @@ class ArrowFragmentLoader {
         vfiles_(vfiles),
         graph_info_(nullptr),
         directed_(directed),
-        generate_eid_(false) {}
+        generate_eid_(false),
+        read_concurrency_(1) {}
 
   ArrowFragmentLoader(vineyard::Client& client,
                       const grape::CommSpec& comm_spec,
@@ -90,10 +113,45 @@ class ArrowFragmentLoader {
         vfiles_(),
         graph_info_(graph_info),
         directed_(graph_info->directed),
-        generate_eid_(graph_info->generate_eid) {}
+        generate_eid_(graph_info->generate_eid),
+        read_concurrency_(graph_info->read_concurrency),
+        partition_strategy_(graph_info->partition_strategy),
+        compress_properties_(graph_info->compress_properties) {}
 
   ~ArrowFragmentLoader() = default;
 
+  /**
+   * @brief Sets the number of the sub slices of the slice of each worker in a
+   * file, which are read and parsed concurrently and merged into one table.
+   */
+  void set_read_concurrency(int read_concurrency) {
+    read_concurrency_ = std::max(read_concurrency, 1);
+  }
+
+  /**
+   * @brief Sets the strategy to place the vertices, i.e., hash, segment,
+   * edge_balanced or degree_aware, see PartitionStrategy. The default one is
+   * hash if built with HASH_PARTITION, otherwise segment.
+   */
+  void set_partition_strategy(const std::string& strategy) {
+    partition_strategy_ = strategy;
+  }
+
+  /**
+   * @brief Sets whether the vertex property columns are encoded before
+   * sealed, i.e., the strings of few distinct values by dictionaries and the
+   * integers by the offsets from their minimums, see PropertyEncoder. The
+   * encoded columns are decoded by the global store, ArrowToDynamicConverter
+   * and the vertex data selectors of the contexts, and rejected by the
+   * projections and the typed columns of the property apps, rather than read
+   * as the codes. The edge property columns are kept as they are, since the
+   * apps read them by get_data<T> of the adjacency lists, which can neither
+   * decode nor reject them.
+   */
+  void set_compress_properties(bool compress_properties) {
+    compress_properties_ = compress_properties;
+  }
+
   boost::leaf::result<std::vector<std::shared_ptr<arrow::Table>>>
   LoadVertexTables() {
     std::vector<std::shared_ptr<arrow::Table>> v_tables;
@@ -114,16 +172,36 @@ class ArrowFragmentLoader {
                       vineyard::sync_gs_error(comm_spec_, load_v_procedure));
       v_tables = tmp_v;
     }
+    if (compress_properties_) {
+      // the ids of the vertices are kept
+      edge_tables_t groups;
+      for (auto& table : v_tables) {
+        groups.push_back({table});
+      }
+      BOOST_LEAF_CHECK(encodeProperties(groups, id_column + 1));
+      for (size_t i = 0; i < v_tables.size(); ++i) {
+        v_tables[i] = groups[i][0];
+      }
+    }
     return v_tables;
   }
 
   boost::leaf::result<std::vector<std::vector<std::shared_ptr<arrow::Table>>>>
   LoadEdgeTables() {
+    if (e_tables_loaded_) {
+      // loaded to weight the vertices by initPartitioner
+      e_tables_loaded_ = false;
+      return std::move(loaded_e_tables_);
+    }
     std::vector<std::vector<std::shared_ptr<arrow::Table>>> e_tables;
+    prefetched_tables_t prefetched;
+    if (edge_prefetch_.valid()) {
+      prefetched = edge_prefetch_.get();
+    }
     if (!efiles_.empty()) {
       auto load_e_procedure = [&]() {
         return loadEdgeTables(efiles_, comm_spec_.worker_id(),
-                              comm_spec_.worker_num());
+                              comm_spec_.worker_num(), prefetched);
       };
       BOOST_LEAF_AUTO(tmp_e,
                       vineyard::sync_gs_error(comm_spec_, load_e_procedure));
@@ -131,7 +209,7 @@ class ArrowFragmentLoader {
     } else {
       auto load_e_procedure = [&]() {
         return loadEdgeTables(graph_info_->edges, comm_spec_.worker_id(),
-                              comm_spec_.worker_num());
+                              comm_spec_.worker_num(), prefetched);
       };
       BOOST_LEAF_AUTO(tmp_e,
                       vineyard::sync_gs_error(comm_spec_, load_e_procedure));
@@ -140,6 +218,58 @@ class ArrowFragmentLoader {
     return e_tables;
   }
 
+  /**
+   * @brief Starts reading the edge tables from the io adaptors in a background
+   * thread, which are taken by the next LoadEdgeTables, so the reading
+   * overlaps with the shuffling of the vertices and the building of the
+   * vertex map. The tables from numpy, pandas and vineyard are read by
+   * LoadEdgeTables, as well as the synchronization of the errors and the
+   * schemas among the workers.
+   */
+  void PrefetchEdgeTables() {
+    if (e_tables_loaded_) {
+      return;
+    }
+    std::vector<std::vector<std::string>> locations;
+    if (!efiles_.empty()) {
+      for (auto& file : efiles_) {
+        std::vector<std::string> sub_label_files;
+        boost::split(sub_label_files, file, boost::is_any_of(";"));
+        locations.emplace_back();
+        for (auto& sub_label_file : sub_label_files) {
+          // the generated tables are built by all the cores when loading
+          locations.back().push_back(IsGeneratedLocation(sub_label_file)
+                                         ? ""
+                                         : sub_label_file + "#header_row=true");
+        }
+      }
+    } else if (graph_info_ != nullptr) {
+      for (auto& edge : graph_info_->edges) {
+        locations.emplace_back();
+        for (auto& sub_label : edge->sub_labels) {
+          bool by_adaptor = sub_label.protocol != "numpy" &&
+                            sub_label.protocol != "pandas" &&
+                            sub_label.protocol != "vineyard";
+          locations.back().push_back(by_adaptor ? sub_label.values : "");
+        }
+      }
+    }
+    int index = comm_spec_.worker_id(), total_parts = comm_spec_.worker_num();
+    edge_prefetch_ = std::async(std::launch::async, [this, locations, index,
+                                                     total_parts]() {
+      prefetched_tables_t tables(locations.size());
+      for (size_t i = 0; i < locations.size(); ++i) {
+        tables[i].resize(locations[i].size());
+        for (size_t j = 0; j < locations[i].size(); ++j) {
+          if (!locations[i][j].empty()) {
+            prefetchTable(locations[i][j], index, total_parts, tables[i][j]);
+          }
+        }
+      }
+      return tables;
+    });
+  }
+
   boost::leaf::result<vineyard::ObjectID> AddLabelsToGraph(
       vineyard::ObjectID frag_id) {
     if (!graph_info_->vertices.empty() && !graph_info_->edges.empty()) {
@@ -155,8 +285,8 @@ class ArrowFragmentLoader {
   boost::leaf::result<vineyard::ObjectID> addVerticesAndEdges(
       vineyard::ObjectID frag_id) {
     BOOST_LEAF_AUTO(partitioner, initPartitioner());
+    PrefetchEdgeTables();
     BOOST_LEAF_AUTO(partial_v_tables, LoadVertexTables());
-    BOOST_LEAF_AUTO(partial_e_tables, LoadEdgeTables());
 
     auto basic_fragment_loader = std::make_shared<
         vineyard::BasicEVFragmentLoader<OID_T, VID_T, partitioner_t>>(
@@ -196,6 +326,7 @@ class ArrowFragmentLoader {
     }
     basic_fragment_loader->set_vertex_label_to_index(
         std::move(vertex_label_to_index));
+    BOOST_LEAF_AUTO(partial_e_tables, LoadEdgeTables());
     for (auto& table_vec : partial_e_tables) {
       for (auto table : table_vec) {
         auto meta = table->schema()->metadata();
@@ -337,9 +468,15 @@ class ArrowFragmentLoader {
   }
 
   boost::leaf::result<vineyard::ObjectID> LoadFragment() {
+    profile_.Clear();
+    auto mark = profile_.Start();
     BOOST_LEAF_AUTO(partitioner, initPartitioner());
+    profile_.Finish("partition", mark);
+    PrefetchEdgeTables();
+    mark = profile_.Start();
     BOOST_LEAF_AUTO(partial_v_tables, LoadVertexTables());
-    BOOST_LEAF_AUTO(partial_e_tables, LoadEdgeTables());
+    profile_.Finish("read_vertices", mark, tablesRows(partial_v_tables),
+                    tablesBytes(partial_v_tables));
 
     if (!partial_v_tables.empty()) {
       std::shared_ptr<
@@ -366,10 +503,18 @@ class ArrowFragmentLoader {
             basic_fragment_loader->AddVertexTable(label_name, table));
       }
 
+      int64_t v_rows = tablesRows(partial_v_tables);
+      int64_t v_bytes = tablesBytes(partial_v_tables);
       partial_v_tables.clear();
 
+      mark = profile_.Start();
       BOOST_LEAF_CHECK(basic_fragment_loader->ConstructVertices());
+      profile_.Finish("construct_vertices", mark, v_rows, v_bytes);
 
+      mark = profile_.Start();
+      BOOST_LEAF_AUTO(partial_e_tables, LoadEdgeTables());
+      profile_.Finish("read_edges", mark, tablesRows(partial_e_tables),
+                      tablesBytes(partial_e_tables));
       for (auto& table_vec : partial_e_tables) {
         for (auto table : table_vec) {
           auto meta = table->schema()->metadata();
@@ -408,11 +553,18 @@ class ArrowFragmentLoader {
         }
       }
 
+      int64_t e_rows = tablesRows(partial_e_tables);
+      int64_t e_bytes = tablesBytes(partial_e_tables);
       partial_e_tables.clear();
 
+      mark = profile_.Start();
       BOOST_LEAF_CHECK(basic_fragment_loader->ConstructEdges());
+      profile_.Finish("construct_edges", mark, e_rows, e_bytes);
 
-      return basic_fragment_loader->ConstructFragment();
+      mark = profile_.Start();
+      BOOST_LEAF_AUTO(frag_id, basic_fragment_loader->ConstructFragment());
+      profile_.Finish("construct_fragment", mark);
+      return frag_id;
     } else {
       std::shared_ptr<
           vineyard::BasicEFragmentLoader<OID_T, VID_T, partitioner_t>>
@@ -420,6 +572,11 @@ class ArrowFragmentLoader {
               vineyard::BasicEFragmentLoader<OID_T, VID_T, partitioner_t>>(
               client_, comm_spec_, partitioner, directed_, true, generate_eid_);
 
+      mark = profile_.Start();
+      BOOST_LEAF_AUTO(partial_e_tables, LoadEdgeTables());
+      profile_.Finish("read_edges", mark, tablesRows(partial_e_tables),
+                      tablesBytes(partial_e_tables));
+
       for (auto& table_vec : partial_e_tables) {
         for (auto table : table_vec) {
           auto meta = table->schema()->metadata();
@@ -458,11 +615,18 @@ class ArrowFragmentLoader {
         }
       }
 
+      int64_t e_rows = tablesRows(partial_e_tables);
+      int64_t e_bytes = tablesBytes(partial_e_tables);
       partial_e_tables.clear();
 
+      mark = profile_.Start();
       BOOST_LEAF_CHECK(basic_fragment_loader->ConstructEdges());
+      profile_.Finish("construct_edges", mark, e_rows, e_bytes);
 
-      return basic_fragment_loader->ConstructFragment();
+      mark = profile_.Start();
+      BOOST_LEAF_AUTO(frag_id, basic_fragment_loader->ConstructFragment());
+      profile_.Finish("construct_fragment", mark);
+      return frag_id;
     }
   }
 
@@ -473,23 +637,37 @@ class ArrowFragmentLoader {
     return vineyard::ConstructFragmentGroup(client_, new_frag_id, comm_spec_);
   }
 
+  /**
+   * @brief The phases of the last LoadFragment on this worker: the
+   * partitioner, reading and parsing the vertex and edge tables, shuffling
+   * them and building the vertex map in construct_vertices and
+   * construct_edges, and building the CSR and sealing the fragment in
+   * construct_fragment. The vertex and edge tables are counted by the rows
+   * and bytes read, which are the ones to shuffle. The edge tables may be
+   * read ahead during the vertices, so read_edges is the part left.
+   */
+  const LoadProfile& GetLoadProfile() const { return profile_; }
+
   boost::leaf::result<vineyard::ObjectID> LoadFragmentAsFragmentGroup() {
     BOOST_LEAF_AUTO(frag_id, LoadFragment());
+    reportPartition(frag_id);
     VY_OK_OR_RAISE(client_.Persist(frag_id));
     return vineyard::ConstructFragmentGroup(client_, frag_id, comm_spec_);
   }
 
   boost::leaf::result<partitioner_t> initPartitioner() {
     partitioner_t partitioner;
-#ifdef HASH_PARTITION
-    partitioner.Init(comm_spec_.fnum());
-#else
+    BOOST_LEAF_AUTO(strategy, partitionStrategy());
+    if (strategy == PartitionStrategy::kHash) {
+      partitioner.Init(comm_spec_.fnum());
+      return partitioner;
+    }
     if (vfiles_.empty() &&
         (graph_info_ != nullptr && graph_info_->vertices.empty())) {
       RETURN_GS_ERROR(
           vineyard::ErrorCode::kInvalidOperationError,
-          "Segmented partitioner is not supported when the v-file is "
-          "not provided");
+          "Segmented and balanced partitioners are not supported when the "
+          "v-file is not provided");
     }
     std::vector<std::shared_ptr<arrow::Table>> vtables;
     if (graph_info_) {
@@ -515,12 +693,102 @@ class ArrowFragmentLoader {
       }
     }
 
-    partitioner.Init(comm_spec_.fnum(), oid_list);
-#endif
+    if (strategy == PartitionStrategy::kSegment) {
+      partitioner.Init(comm_spec_.fnum(), oid_list);
+    } else {
+      BOOST_LEAF_AUTO(weights, vertexWeights(oid_list));
+      partitioner.Init(comm_spec_.fnum(), oid_list, weights, strategy);
+    }
     return partitioner;
   }
 
  private:
+  boost::leaf::result<PartitionStrategy> partitionStrategy() {
+    if (partition_strategy_.empty()) {
+#ifdef HASH_PARTITION
+      return PartitionStrategy::kHash;
+#else
+      return PartitionStrategy::kSegment;
+#endif
+    }
+    return ParsePartitionStrategy(partition_strategy_);
+  }
+
+  /**
+   * @brief The weights of the vertices in oid_list, i.e., the degrees plus
+   * one, counted from the edge slices of all of the workers. The edge tables
+   * are kept for the next LoadEdgeTables.
+   */
+  boost::leaf::result<std::vector<int64_t>> vertexWeights(
+      const std::vector<oid_t>& oid_list) {
+    std::unordered_map<oid_t, size_t> indices;
+    indices.reserve(oid_list.size());
+    for (size_t i = 0; i < oid_list.size(); ++i) {
+      indices.emplace(oid_list[i], i);
+    }
+
+    BOOST_LEAF_AUTO(e_tables, LoadEdgeTables());
+    std::vector<int64_t> weights(oid_list.size(), 0);
+    for (auto& sub_label_tables : e_tables) {
+      for (auto& table : sub_label_tables) {
+        for (int col : {src_column, dst_column}) {
+          auto chunks = table->column(col);
+          for (int chunk_i = 0; chunk_i < chunks->num_chunks(); ++chunk_i) {
+            auto array =
+                std::dynamic_pointer_cast<oid_array_t>(chunks->chunk(chunk_i));
+            if (array == nullptr) {
+              continue;
+            }
+            for (int64_t i = 0; i < array->length(); ++i) {
+              auto iter = indices.find(oid_t(array->GetView(i)));
+              if (iter != indices.end()) {
+                ++weights[iter->second];
+              }
+            }
+          }
+        }
+      }
+    }
+    AllReduceSum(weights, comm_spec_.comm());
+    for (auto& weight : weights) {
+      ++weight;
+    }
+
+    loaded_e_tables_ = std::move(e_tables);
+    e_tables_loaded_ = true;
+    return weights;
+  }
+
+  // logs the numbers of the inner vertices and the edges of each fragment
+  void reportPartition(vineyard::ObjectID frag_id) {
+    using fragment_t = vineyard::ArrowFragment<oid_t, vid_t>;
+    auto frag =
+        std::dynamic_pointer_cast<fragment_t>(client_.GetObject(frag_id));
+    fid_t fnum = comm_spec_.fnum();
+    std::vector<int64_t> counts(2 * fnum, 0);
+    if (frag != nullptr) {
+      for (label_id_t i = 0; i < frag->vertex_label_num(); ++i) {
+        counts[2 * comm_spec_.fid()] += frag->GetInnerVerticesNum(i);
+      }
+      counts[2 * comm_spec_.fid() + 1] = frag->GetEdgeNum();
+    }
+    AllReduceSum(counts, comm_spec_.comm());
+    if (comm_spec_.worker_id() != grape::kCoordinatorRank) {
+      return;
+    }
+    int64_t max_edges = 0, total_edges = 0;
+    for (fid_t fid = 0; fid < fnum; ++fid) {
+      LOG(INFO) << "Fragment " << fid << ": " << counts[2 * fid]
+                << " inner vertices, " << counts[2 * fid + 1] << " edges";
+      max_edges = std::max(max_edges, counts[2 * fid + 1]);
+      total_edges += counts[2 * fid + 1];
+    }
+    if (total_edges > 0) {
+      LOG(INFO) << "Edge imbalance (max / mean): "
+                << static_cast<double>(max_edges) * fnum / total_edges;
+    }
+  }
+
   boost::leaf::result<std::shared_ptr<arrow::Table>> readTableFromNumpy(
       std::vector<std::string>& data, size_t row_num, size_t col_num, int index,
       int total_parts,
@@ -564,9 +832,65 @@ class ArrowFragmentLoader {
     return table;
   }
 
+  /**
+   * @brief Reads the table of the vineyard object. The chunks of a
+   * GlobalDataFrame on this instance are split among the local workers, and
+   * wrapped as the record batches of the table without copying. Other
+   * objects, e.g., the streams, are read by ReadTableFromVineyard. Returns
+   * nullptr if there are no chunks for this worker, whose schema is synced
+   * from the others.
+   */
+  boost::leaf::result<std::shared_ptr<arrow::Table>> readTableFromVineyard(
+      vineyard::ObjectID object_id) {
+    std::shared_ptr<arrow::Table> table;
+    vineyard::ObjectMeta meta;
+    VY_OK_OR_RAISE(client_.GetMetaData(object_id, meta, true));
+    if (meta.GetTypeName() !=
+        vineyard::type_name<vineyard::GlobalDataFrame>()) {
+      VY_OK_OR_RAISE(vineyard::ReadTableFromVineyard(
+          client_, object_id, table, comm_spec_.local_id(),
+          comm_spec_.local_num()));
+      return table;
+    }
+
+    auto dataframe = std::dynamic_pointer_cast<vineyard::GlobalDataFrame>(
+        client_.GetObject(object_id));
+    auto chunks = dataframe->LocalPartitions(client_);
+    std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+    for (size_t i = comm_spec_.local_id(); i < chunks.size();
+         i += comm_spec_.local_num()) {
+      auto chunk = std::dynamic_pointer_cast<vineyard::DataFrame>(chunks[i]);
+      if (chunk != nullptr && chunk->shape().first > 0) {
+        batches.push_back(chunk->AsBatch(false));
+      }
+    }
+    VLOG(2) << "[worker-" << comm_spec_.worker_id() << "] wraps "
+            << batches.size() << " of " << chunks.size()
+            << " local chunks of dataframe "
+            << vineyard::ObjectIDToString(object_id);
+    if (batches.empty()) {
+      return table;
+    }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    ARROW_OK_OR_RAISE(arrow::Table::FromRecordBatches(batches, &table));
+#else
+    ARROW_OK_ASSIGN_OR_RAISE(table, arrow::Table::FromRecordBatches(batches));
+#endif
+    return table;
+  }
+
   boost::leaf::result<std::shared_ptr<arrow::Table>> readTableFromLocation(
       const std::string& location, int index, int total_parts) {
     std::shared_ptr<arrow::Table> table;
+    if (IsColumnarLocation(location)) {
+      VY_OK_OR_RAISE(ReadColumnarTable(location, index, total_parts,
+                                       read_concurrency_, table));
+      return table;
+    }
+    if (IsGeneratedLocation(location)) {
+      VY_OK_OR_RAISE(GenerateTable(location, index, total_parts, table));
+      return table;
+    }
     auto io_adaptor = vineyard::IOFactory::CreateIOAdaptor(location);
     if (io_adaptor == nullptr) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
@@ -574,11 +898,87 @@ class ArrowFragmentLoader {
     }
     ARROW_OK_OR_RAISE(io_adaptor->SetPartialRead(index, total_parts));
     ARROW_OK_OR_RAISE(io_adaptor->Open());
-    ARROW_OK_OR_RAISE(io_adaptor->ReadTable(&table));
+    ARROW_OK_OR_RAISE(
+        readTable(io_adaptor.get(), location, index, total_parts, table));
     ARROW_OK_OR_RAISE(io_adaptor->Close());
     return table;
   }
 
+  /**
+   * @brief Reads the slice index of total_parts of the location from the
+   * opened io adaptor. With a read concurrency of c, the slice is read as the
+   * sub slices [index * c, index * c + c) of total_parts * c by c threads,
+   * each with its own io adaptor, and falls back to the io adaptor if the
+   * schemas of the sub slices are inferred differently. The Parquet and the
+   * ORC files are read by ReadColumnarTable, where the io adaptor is only
+   * kept for the metadata.
+   */
+  vineyard::Status readTable(vineyard::IIOAdaptor* io_adaptor,
+                             const std::string& location, int index,
+                             int total_parts,
+                             std::shared_ptr<arrow::Table>& table) {
+    int concurrency = read_concurrency_;
+    if (IsColumnarLocation(location)) {
+      return ReadColumnarTable(location, index, total_parts, concurrency,
+                               table);
+    }
+    if (concurrency <= 1) {
+      return io_adaptor->ReadTable(&table);
+    }
+    std::vector<std::shared_ptr<arrow::Table>> tables(concurrency);
+    std::vector<vineyard::Status> statuses(concurrency);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < concurrency; ++i) {
+      threads.emplace_back([&, i]() {
+        auto sub_adaptor = vineyard::IOFactory::CreateIOAdaptor(location);
+        if (sub_adaptor == nullptr) {
+          statuses[i] = vineyard::Status::IOError(
+              "Cannot find a supported adaptor for " + location);
+          return;
+        }
+        statuses[i] = sub_adaptor->SetPartialRead(index * concurrency + i,
+                                                  total_parts * concurrency);
+        if (statuses[i].ok()) {
+          statuses[i] = sub_adaptor->Open();
+        }
+        if (statuses[i].ok()) {
+          statuses[i] = sub_adaptor->ReadTable(&tables[i]);
+        }
+        if (statuses[i].ok()) {
+          statuses[i] = sub_adaptor->Close();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto& status : statuses) {
+      RETURN_ON_ERROR(status);
+    }
+
+    std::vector<std::shared_ptr<arrow::Table>> non_empty_tables;
+    for (auto& sub_table : tables) {
+      if (sub_table != nullptr && sub_table->num_rows() > 0) {
+        if (!non_empty_tables.empty() &&
+            !sub_table->schema()->Equals(non_empty_tables[0]->schema())) {
+          return io_adaptor->ReadTable(&table);
+        }
+        non_empty_tables.push_back(sub_table);
+      }
+    }
+    if (non_empty_tables.size() <= 1) {
+      table = non_empty_tables.empty() ? tables[0] : non_empty_tables[0];
+      return vineyard::Status::OK();
+    }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    RETURN_ON_ARROW_ERROR(arrow::ConcatenateTables(non_empty_tables, &table));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        table, arrow::ConcatenateTables(non_empty_tables));
+#endif
+    return vineyard::Status::OK();
+  }
+
   boost::leaf::result<std::vector<std::shared_ptr<arrow::Table>>>
   loadVertexTables(const std::vector<std::string>& files, int index,
                    int total_parts) {
@@ -586,18 +986,26 @@ class ArrowFragmentLoader {
     std::vector<std::shared_ptr<arrow::Table>> tables(label_num);
 
     for (label_id_t label_id = 0; label_id < label_num; ++label_id) {
+      auto location = files[label_id] + "#header_row=true";
+      bool generated = IsGeneratedLocation(location);
       std::unique_ptr<vineyard::IIOAdaptor,
                       std::function<void(vineyard::IIOAdaptor*)>>
-          io_adaptor(vineyard::IOFactory::CreateIOAdaptor(files[label_id] +
-                                                          "#header_row=true")
-                         .release(),
+          io_adaptor(generated
+                         ? nullptr
+                         : vineyard::IOFactory::CreateIOAdaptor(location)
+                               .release(),
                      io_deleter_);
       auto read_procedure =
           [&]() -> boost::leaf::result<std::shared_ptr<arrow::Table>> {
+        std::shared_ptr<arrow::Table> table;
+        if (generated) {
+          VY_OK_OR_RAISE(GenerateTable(location, index, total_parts, table));
+          return table;
+        }
         VY_OK_OR_RAISE(io_adaptor->SetPartialRead(index, total_parts));
         VY_OK_OR_RAISE(io_adaptor->Open());
-        std::shared_ptr<arrow::Table> table;
-        VY_OK_OR_RAISE(io_adaptor->ReadTable(&table));
+        VY_OK_OR_RAISE(
+            readTable(io_adaptor.get(), location, index, total_parts, table));
         return table;
       };
 
@@ -614,7 +1022,8 @@ class ArrowFragmentLoader {
 
       auto meta = std::make_shared<arrow::KeyValueMetadata>();
 
-      auto adaptor_meta = io_adaptor->GetMeta();
+      auto adaptor_meta = generated ? GeneratedLocationMeta(location)
+                                    : io_adaptor->GetMeta();
       // Check if label name is in meta
       if (adaptor_meta.find(LABEL_TAG) == adaptor_meta.end()) {
         RETURN_GS_ERROR(
@@ -691,9 +1100,7 @@ class ArrowFragmentLoader {
         } else if (vertices[i]->protocol == "vineyard") {
           VLOG(2) << "read vertex table from vineyard: " << vertices[i]->values;
           BOOST_LEAF_AUTO(sourceId, resolveVYObject(vertices[i]->values));
-          VY_OK_OR_RAISE(vineyard::ReadTableFromVineyard(
-              client_, sourceId, table, comm_spec_.local_id(),
-              comm_spec_.local_num()));
+          BOOST_LEAF_ASSIGN(table, readTableFromVineyard(sourceId));
           if (table != nullptr) {
             VLOG(2) << "schema of vertex table: "
                     << table->schema()->ToString();
@@ -729,7 +1136,7 @@ class ArrowFragmentLoader {
 
   boost::leaf::result<std::vector<std::vector<std::shared_ptr<arrow::Table>>>>
   loadEdgeTables(const std::vector<std::string>& files, int index,
-                 int total_parts) {
+                 int total_parts, prefetched_tables_t& prefetched) {
     auto label_num = static_cast<label_id_t>(files.size());
     std::vector<std::vector<std::shared_ptr<arrow::Table>>> tables(label_num);
 
@@ -739,18 +1146,32 @@ class ArrowFragmentLoader {
         boost::split(sub_label_files, files[label_id], boost::is_any_of(";"));
 
         for (size_t j = 0; j < sub_label_files.size(); ++j) {
-          std::unique_ptr<vineyard::IIOAdaptor,
-                          std::function<void(vineyard::IIOAdaptor*)>>
-              io_adaptor(vineyard::IOFactory::CreateIOAdaptor(
-                             sub_label_files[j] + "#header_row=true")
-                             .release(),
-                         io_deleter_);
+          auto location = sub_label_files[j] + "#header_row=true";
+          bool generated = IsGeneratedLocation(location);
+          auto prefetched_table = findPrefetched(prefetched, label_id, j);
+          io_adaptor_t io_adaptor(nullptr, io_deleter_);
+          if (prefetched_table != nullptr) {
+            io_adaptor = std::move(prefetched_table->io_adaptor);
+          } else if (!generated) {
+            io_adaptor.reset(
+                vineyard::IOFactory::CreateIOAdaptor(location).release());
+          }
           auto read_procedure =
               [&]() -> boost::leaf::result<std::shared_ptr<arrow::Table>> {
+            if (prefetched_table != nullptr) {
+              VY_OK_OR_RAISE(prefetched_table->status);
+              return prefetched_table->table;
+            }
+            std::shared_ptr<arrow::Table> table;
+            if (generated) {
+              VY_OK_OR_RAISE(
+                  GenerateTable(location, index, total_parts, table));
+              return table;
+            }
             VY_OK_OR_RAISE(io_adaptor->SetPartialRead(index, total_parts));
             VY_OK_OR_RAISE(io_adaptor->Open());
-            std::shared_ptr<arrow::Table> table;
-            VY_OK_OR_RAISE(io_adaptor->ReadTable(&table));
+            VY_OK_OR_RAISE(readTable(io_adaptor.get(), location, index,
+                                     total_parts, table));
             return table;
           };
           BOOST_LEAF_AUTO(table,
@@ -767,7 +1188,8 @@ class ArrowFragmentLoader {
           std::shared_ptr<arrow::KeyValueMetadata> meta(
               new arrow::KeyValueMetadata());
 
-          auto adaptor_meta = io_adaptor->GetMeta();
+          auto adaptor_meta = generated ? GeneratedLocationMeta(location)
+                                        : io_adaptor->GetMeta();
           auto it = adaptor_meta.find(LABEL_TAG);
           if (it == adaptor_meta.end()) {
             RETURN_GS_ERROR(
@@ -814,7 +1236,7 @@ class ArrowFragmentLoader {
 
   boost::leaf::result<std::vector<std::vector<std::shared_ptr<arrow::Table>>>>
   loadEdgeTables(const std::vector<std::shared_ptr<detail::Edge>>& edges,
-                 int index, int total_parts) {
+                 int index, int total_parts, prefetched_tables_t& prefetched) {
     // a special code path when multiple labeled edge batches are mixed.
     if (edges.size() == 1 && edges[0]->sub_labels.size() == 1 &&
         edges[0]->sub_labels[0].protocol == "vineyard") {
@@ -879,11 +1301,15 @@ class ArrowFragmentLoader {
             new arrow::KeyValueMetadata());
         meta->Append(LABEL_TAG, edges[i]->label);
 
+        auto prefetched_table = findPrefetched(prefetched, i, j);
         auto load_procedure =
             [&]() -> boost::leaf::result<std::shared_ptr<arrow::Table>> {
           std::shared_ptr<arrow::Table> table;
-          if (sub_labels[j].protocol == "numpy" ||
-              sub_labels[j].protocol == "pandas") {
+          if (prefetched_table != nullptr) {
+            VY_OK_OR_RAISE(prefetched_table->status);
+            table = prefetched_table->table;
+          } else if (sub_labels[j].protocol == "numpy" ||
+                     sub_labels[j].protocol == "pandas") {
             BOOST_LEAF_ASSIGN(
                 table,
                 readTableFromNumpy(sub_labels[j].data, sub_labels[j].row_num,
@@ -893,9 +1319,7 @@ class ArrowFragmentLoader {
             LOG(INFO) << "read edge table from vineyard: "
                       << sub_labels[j].values;
             BOOST_LEAF_AUTO(sourceId, resolveVYObject(sub_labels[j].values));
-            VY_OK_OR_RAISE(vineyard::ReadTableFromVineyard(
-                client_, sourceId, table, comm_spec_.local_id(),
-                comm_spec_.local_num()));
+            BOOST_LEAF_ASSIGN(table, readTableFromVineyard(sourceId));
             if (table == nullptr) {
               VLOG(2) << "edge table is null";
             } else {
@@ -929,6 +1353,97 @@ class ArrowFragmentLoader {
     return tables;
   }
 
+  // encodes the tables of each label together, by all the workers, see
+  // PropertyEncoder
+  boost::leaf::result<void> encodeProperties(edge_tables_t& groups,
+                                             int key_columns) {
+    auto mark = profile_.Start();
+    PropertyEncoder encoder(comm_spec_);
+    int encoded = 0;
+    for (auto& tables : groups) {
+      int group_encoded = 0;
+      VY_OK_OR_RAISE(encoder.Encode(tables, key_columns, group_encoded));
+      encoded += group_encoded;
+    }
+    profile_.Finish("encode_properties", mark, tablesRows(groups),
+                    tablesBytes(groups));
+    VLOG(1) << "[worker-" << comm_spec_.worker_id() << "] encoded " << encoded
+            << " property columns";
+    return {};
+  }
+
+  // reads the table by the io adaptor in the prefetching thread, where the
+  // errors are kept in the status rather than raised
+  void prefetchTable(const std::string& location, int index, int total_parts,
+                     PrefetchedTable& prefetched) {
+    prefetched.fetched = true;
+    try {
+      prefetched.io_adaptor = io_adaptor_t(
+          vineyard::IOFactory::CreateIOAdaptor(location).release(),
+          io_deleter_);
+      if (prefetched.io_adaptor == nullptr) {
+        prefetched.status = vineyard::Status::IOError(
+            "Cannot find a supported adaptor for " + location);
+        return;
+      }
+      prefetched.status =
+          prefetched.io_adaptor->SetPartialRead(index, total_parts);
+      if (prefetched.status.ok()) {
+        prefetched.status = prefetched.io_adaptor->Open();
+      }
+      if (prefetched.status.ok()) {
+        prefetched.status =
+            readTable(prefetched.io_adaptor.get(), location, index,
+                      total_parts, prefetched.table);
+      }
+    } catch (std::exception& e) {
+      prefetched.status = vineyard::Status::IOError(std::string(e.what()));
+    }
+  }
+
+  static PrefetchedTable* findPrefetched(prefetched_tables_t& prefetched,
+                                         size_t i, size_t j) {
+    if (i < prefetched.size() && j < prefetched[i].size() &&
+        prefetched[i][j].fetched) {
+      return &prefetched[i][j];
+    }
+    return nullptr;
+  }
+
+  static int64_t tablesRows(
+      const std::vector<std::shared_ptr<arrow::Table>>& tables) {
+    int64_t rows = 0;
+    for (auto const& table : tables) {
+      rows += table->num_rows();
+    }
+    return rows;
+  }
+
+  static int64_t tablesRows(const edge_tables_t& tables) {
+    int64_t rows = 0;
+    for (auto const& sub_tables : tables) {
+      rows += tablesRows(sub_tables);
+    }
+    return rows;
+  }
+
+  static int64_t tablesBytes(
+      const std::vector<std::shared_ptr<arrow::Table>>& tables) {
+    int64_t bytes = 0;
+    for (auto const& table : tables) {
+      bytes += LoadProfile::TableBytes(table);
+    }
+    return bytes;
+  }
+
+  static int64_t tablesBytes(const edge_tables_t& tables) {
+    int64_t bytes = 0;
+    for (auto const& sub_tables : tables) {
+      bytes += tablesBytes(sub_tables);
+    }
+    return bytes;
+  }
+
   boost::leaf::result<vineyard::ObjectID> resolveVYObject(
       std::string const& source) {
     vineyard::ObjectID sourceId = vineyard::InvalidObjectID();
@@ -953,12 +1468,23 @@ class ArrowFragmentLoader {
 
   bool directed_;
   bool generate_eid_;
+  int read_concurrency_;
+  std::string partition_strategy_;
+  bool compress_properties_ = false;
+
+  // the edge tables loaded by initPartitioner
+  bool e_tables_loaded_ = false;
+  edge_tables_t loaded_e_tables_;
 
   std::function<void(vineyard::IIOAdaptor*)> io_deleter_ =
       [](vineyard::IIOAdaptor* adaptor) {
         VINEYARD_CHECK_OK(adaptor->Close());
         delete adaptor;
       };
+  // the edge tables being read by PrefetchEdgeTables
+  std::future<prefetched_tables_t> edge_prefetch_;
+
+  LoadProfile profile_;
 };
 
 }  // namespace gs
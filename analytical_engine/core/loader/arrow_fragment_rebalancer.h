@@ -0,0 +1,358 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_REBALANCER_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_REBALANCER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/array/concatenate.h"
+#include "grape/communication/communicator.h"
+#include "grape/worker/comm_spec.h"
+#include "vineyard/client/client.h"
+#include "vineyard/graph/fragment/arrow_fragment.h"
+#include "vineyard/graph/loader/arrow_fragment_loader.h"
+
+#include "core/error.h"
+#include "core/loader/balanced_partitioner.h"
+
+namespace gs {
+
+namespace arrow_fragment_rebalancer_impl {
+
+inline bl::result<std::shared_ptr<arrow::Array>> combine_chunks(
+    const std::shared_ptr<arrow::ChunkedArray>& column) {
+  if (column->num_chunks() == 0) {
+    return std::shared_ptr<arrow::Array>();
+  } else if (column->num_chunks() == 1) {
+    return column->chunk(0);
+  }
+  std::shared_ptr<arrow::Array> array;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  ARROW_OK_OR_RAISE(arrow::Concatenate(column->chunks(),
+                                       arrow::default_memory_pool(), &array));
+#else
+  ARROW_OK_ASSIGN_OR_RAISE(array, arrow::Concatenate(column->chunks()));
+#endif
+  return array;
+}
+
+// the rows of array in the order of rows, the array is null if rows is empty
+template <typename ARROW_T>
+bl::result<std::shared_ptr<arrow::Array>> take_typed(
+    const std::shared_ptr<arrow::Array>& array,
+    const std::vector<int64_t>& rows) {
+  using array_t = typename arrow::TypeTraits<ARROW_T>::ArrayType;
+  using builder_t = typename arrow::TypeTraits<ARROW_T>::BuilderType;
+  auto typed_array = std::static_pointer_cast<array_t>(array);
+  builder_t builder;
+  ARROW_OK_OR_RAISE(builder.Reserve(rows.size()));
+  for (auto row : rows) {
+    if (typed_array->IsNull(row)) {
+      ARROW_OK_OR_RAISE(builder.AppendNull());
+    } else {
+      ARROW_OK_OR_RAISE(builder.Append(typed_array->GetView(row)));
+    }
+  }
+  std::shared_ptr<arrow::Array> result;
+  ARROW_OK_OR_RAISE(builder.Finish(&result));
+  return result;
+}
+
+inline bl::result<std::shared_ptr<arrow::Array>> take_rows(
+    const std::shared_ptr<arrow::DataType>& type,
+    const std::shared_ptr<arrow::Array>& array,
+    const std::vector<int64_t>& rows) {
+  switch (type->id()) {
+  case arrow::Type::BOOL:
+    return take_typed<arrow::BooleanType>(array, rows);
+  case arrow::Type::INT32:
+    return take_typed<arrow::Int32Type>(array, rows);
+  case arrow::Type::INT64:
+    return take_typed<arrow::Int64Type>(array, rows);
+  case arrow::Type::UINT32:
+    return take_typed<arrow::UInt32Type>(array, rows);
+  case arrow::Type::UINT64:
+    return take_typed<arrow::UInt64Type>(array, rows);
+  case arrow::Type::FLOAT:
+    return take_typed<arrow::FloatType>(array, rows);
+  case arrow::Type::DOUBLE:
+    return take_typed<arrow::DoubleType>(array, rows);
+  case arrow::Type::STRING:
+    return take_typed<arrow::StringType>(array, rows);
+  case arrow::Type::LARGE_STRING:
+    return take_typed<arrow::LargeStringType>(array, rows);
+  default:
+    RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
+                    "Unsupported property type to rebalance: " +
+                        type->ToString());
+  }
+}
+
+}  // namespace arrow_fragment_rebalancer_impl
+
+/**
+ * @brief ArrowFragmentRebalancer rebuilds the fragments of a loaded
+ * ArrowFragment with the vertices placed by a weighted PartitionStrategy,
+ * i.e., the degrees plus one, e.g., after the appends skewed the partition.
+ * The vertices and the edges are extracted from the fragments along with the
+ * properties, and shuffled by BasicEVFragmentLoader to a new fragment with a
+ * new vertex map, so the source files are not read again. The labels keep
+ * their ids, and the columns, including the eid column if any, are kept as
+ * they are.
+ *
+ * @tparam OID_T
+ * @tparam VID_T
+ */
+template <typename OID_T, typename VID_T>
+class ArrowFragmentRebalancer {
+  using fragment_t = vineyard::ArrowFragment<OID_T, VID_T>;
+  using oid_t = OID_T;
+  using vid_t = VID_T;
+  using label_id_t = typename fragment_t::label_id_t;
+  using vertex_t = typename fragment_t::vertex_t;
+  using oid_builder_t =
+      typename vineyard::ConvertToArrowType<oid_t>::BuilderType;
+  using partitioner_t = BalancedPartitioner<oid_t>;
+  using loader_t =
+      vineyard::BasicEVFragmentLoader<oid_t, vid_t, partitioner_t>;
+
+  // the edges of a relation, by the rows in the edge table
+  struct RelationEdges {
+    std::vector<oid_t> srcs;
+    std::vector<oid_t> dsts;
+    std::vector<int64_t> rows;
+  };
+
+ public:
+  ArrowFragmentRebalancer(vineyard::Client& client,
+                          const grape::CommSpec& comm_spec,
+                          std::shared_ptr<fragment_t> fragment)
+      : client_(client), comm_spec_(comm_spec), fragment_(fragment) {}
+
+  /**
+   * @brief Returns the id of the local fragment rebuilt by strategy, which
+   * is kEdgeBalanced or kDegreeAware.
+   */
+  bl::result<vineyard::ObjectID> Rebalance(PartitionStrategy strategy) {
+    if (!IsWeightedPartitionStrategy(strategy)) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Rebalancing expects the edge_balanced or "
+                      "degree_aware strategy");
+    }
+    partitioner_t partitioner;
+    BOOST_LEAF_CHECK(initPartitioner(strategy, partitioner));
+
+    auto loader = std::make_shared<loader_t>(
+        client_, comm_spec_, partitioner, fragment_->directed(), false, false);
+    auto& schema = fragment_->schema();
+    for (label_id_t i = 0; i < fragment_->vertex_label_num(); ++i) {
+      BOOST_LEAF_AUTO(table, vertexTable(i));
+      BOOST_LEAF_CHECK(
+          loader->AddVertexTable(schema.GetVertexLabelName(i), table));
+    }
+    BOOST_LEAF_CHECK(loader->ConstructVertices());
+    for (label_id_t i = 0; i < fragment_->edge_label_num(); ++i) {
+      BOOST_LEAF_CHECK(addEdgeTables(*loader, i));
+    }
+    BOOST_LEAF_CHECK(loader->ConstructEdges());
+    return loader->ConstructFragment();
+  }
+
+ private:
+  // places every inner vertex of all of the fragments by its degree plus one
+  bl::result<void> initPartitioner(PartitionStrategy strategy,
+                                   partitioner_t& partitioner) {
+    std::vector<oid_t> oids;
+    std::vector<int64_t> weights;
+    for (label_id_t i = 0; i < fragment_->vertex_label_num(); ++i) {
+      for (auto v : fragment_->InnerVertices(i)) {
+        int64_t weight = 1;
+        for (label_id_t j = 0; j < fragment_->edge_label_num(); ++j) {
+          weight += fragment_->GetLocalOutDegree(v, j);
+          if (fragment_->directed()) {
+            weight += fragment_->GetLocalInDegree(v, j);
+          }
+        }
+        oids.emplace_back(fragment_->GetId(v));
+        weights.push_back(weight);
+      }
+    }
+
+    grape::Communicator communicator;
+    communicator.InitCommunicator(comm_spec_.comm());
+    std::vector<std::vector<oid_t>> all_oids;
+    std::vector<std::vector<int64_t>> all_weights;
+    communicator.AllGather(oids, all_oids);
+    communicator.AllGather(weights, all_weights);
+    oids.clear();
+    weights.clear();
+    for (fid_t fid = 0; fid < comm_spec_.fnum(); ++fid) {
+      oids.insert(oids.end(), all_oids[fid].begin(), all_oids[fid].end());
+      weights.insert(weights.end(), all_weights[fid].begin(),
+                     all_weights[fid].end());
+    }
+    partitioner.Init(comm_spec_.fnum(), oids, weights, strategy);
+    return {};
+  }
+
+  // the id column followed by the properties of the inner vertices
+  bl::result<std::shared_ptr<arrow::Table>> vertexTable(label_id_t label) {
+    oid_builder_t builder;
+    for (auto v : fragment_->InnerVertices(label)) {
+      ARROW_OK_OR_RAISE(builder.Append(fragment_->GetId(v)));
+    }
+    std::shared_ptr<arrow::Array> oid_array;
+    ARROW_OK_OR_RAISE(builder.Finish(&oid_array));
+    auto id_field = std::make_shared<arrow::Field>(
+        "id", vineyard::ConvertToArrowType<oid_t>::TypeValue());
+    auto oid_column = std::make_shared<arrow::ChunkedArray>(oid_array);
+
+    auto table = fragment_->vertex_data_table(label);
+    std::shared_ptr<arrow::Table> result;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    ARROW_OK_OR_RAISE(table->AddColumn(0, id_field, oid_column, &result));
+#else
+    ARROW_OK_ASSIGN_OR_RAISE(result, table->AddColumn(0, id_field, oid_column));
+#endif
+    return result;
+  }
+
+  /**
+   * @brief Adds the edges of e_label to the loader, a table for each of the
+   * relations even if it is empty, so all of the workers add the same ones.
+   * Each edge is taken once by all of the workers: the ones of a directed
+   * fragment are the outgoing edges of the inner vertices, and an edge of an
+   * undirected fragment is taken by the fragment of the smaller fid.
+   */
+  bl::result<void> addEdgeTables(loader_t& loader, label_id_t e_label) {
+    auto& schema = fragment_->schema();
+    bool directed = fragment_->directed();
+    fid_t fid = fragment_->fid();
+
+    std::vector<std::pair<std::string, std::string>> relations;
+    for (auto& entry : schema.edge_entries()) {
+      if (entry.id == e_label) {
+        relations = entry.relations;
+      }
+    }
+    std::map<std::pair<label_id_t, label_id_t>, size_t> relation_index;
+    for (size_t i = 0; i < relations.size(); ++i) {
+      relation_index.emplace(
+          std::make_pair(schema.GetVertexLabelId(relations[i].first),
+                         schema.GetVertexLabelId(relations[i].second)),
+          i);
+    }
+
+    std::vector<RelationEdges> edges(relations.size());
+    auto e_table = fragment_->edge_data_table(e_label);
+    // the edges of an undirected fragment between the inner vertices appear
+    // in both adjacent lists, with the same eid
+    std::vector<bool> taken(directed ? 0 : e_table->num_rows(), false);
+    for (label_id_t v_label = 0; v_label < fragment_->vertex_label_num();
+         ++v_label) {
+      for (auto v : fragment_->InnerVertices(v_label)) {
+        auto oe = fragment_->GetOutgoingAdjList(v, e_label);
+        for (auto& e : oe) {
+          auto u = e.get_neighbor();
+          auto eid = e.edge_id();
+          if (!directed) {
+            if (fragment_->IsInnerVertex(u)) {
+              if (taken[eid]) {
+                continue;
+              }
+              taken[eid] = true;
+            } else if (fragment_->GetFragId(u) < fid) {
+              continue;
+            }
+          }
+          label_id_t u_label = fragment_->vertex_label(u);
+          bool reversed = false;
+          auto iter = relation_index.find(std::make_pair(v_label, u_label));
+          if (iter == relation_index.end() && !directed) {
+            iter = relation_index.find(std::make_pair(u_label, v_label));
+            reversed = true;
+          }
+          if (iter == relation_index.end()) {
+            RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                            "The relation of edge label " +
+                                schema.GetEdgeLabelName(e_label) +
+                                " is not in the schema");
+          }
+          auto& relation_edges = edges[iter->second];
+          relation_edges.srcs.emplace_back(
+              fragment_->GetId(reversed ? u : v));
+          relation_edges.dsts.emplace_back(
+              fragment_->GetId(reversed ? v : u));
+          relation_edges.rows.push_back(static_cast<int64_t>(eid));
+        }
+      }
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> e_columns;
+    for (int i = 0; i < e_table->num_columns(); ++i) {
+      BOOST_LEAF_AUTO(column,
+                      arrow_fragment_rebalancer_impl::combine_chunks(
+                          e_table->column(i)));
+      e_columns.push_back(column);
+    }
+    auto oid_type = vineyard::ConvertToArrowType<oid_t>::TypeValue();
+    std::vector<std::shared_ptr<arrow::Field>> fields = {
+        std::make_shared<arrow::Field>("src", oid_type),
+        std::make_shared<arrow::Field>("dst", oid_type)};
+    for (auto& field : e_table->schema()->fields()) {
+      fields.push_back(field);
+    }
+    auto table_schema = std::make_shared<arrow::Schema>(fields);
+
+    for (size_t i = 0; i < relations.size(); ++i) {
+      auto& relation_edges = edges[i];
+      std::vector<std::shared_ptr<arrow::Array>> arrays(2);
+      for (int j = 0; j < 2; ++j) {
+        auto& oids = j == 0 ? relation_edges.srcs : relation_edges.dsts;
+        oid_builder_t builder;
+        for (auto& oid : oids) {
+          ARROW_OK_OR_RAISE(builder.Append(oid));
+        }
+        ARROW_OK_OR_RAISE(builder.Finish(&arrays[j]));
+      }
+      for (int j = 0; j < e_table->num_columns(); ++j) {
+        BOOST_LEAF_AUTO(array, arrow_fragment_rebalancer_impl::take_rows(
+                                   e_table->field(j)->type(), e_columns[j],
+                                   relation_edges.rows));
+        arrays.push_back(array);
+      }
+      relation_edges = RelationEdges();
+      BOOST_LEAF_CHECK(loader.AddEdgeTable(
+          relations[i].first, relations[i].second,
+          schema.GetEdgeLabelName(e_label),
+          arrow::Table::Make(table_schema, arrays)));
+    }
+    return {};
+  }
+
+  vineyard::Client& client_;
+  grape::CommSpec comm_spec_;
+  std::shared_ptr<fragment_t> fragment_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_REBALANCER_H_
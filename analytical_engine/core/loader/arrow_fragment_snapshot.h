@@ -0,0 +1,319 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_SNAPSHOT_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_SNAPSHOT_H_
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+#include "arrow/filesystem/api.h"
+#include "arrow/io/api.h"
+#include "grape/config.h"
+#include "vineyard/client/client.h"
+#include "vineyard/client/ds/blob.h"
+#include "vineyard/graph/utils/grape_utils.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+namespace arrow_fragment_snapshot_impl {
+
+static constexpr const char kMagic[8] = {'G', 'S', 'A', 'R',
+                                         'F', 'R', 'G', '1'};
+
+inline bool is_member(const vineyard::json& value) {
+  return value.is_object() && value.find("typename") != value.end() &&
+         value.find("id") != value.end();
+}
+
+inline bool is_blob(const vineyard::json& tree) {
+  return tree["typename"].get<std::string>() == "vineyard::Blob";
+}
+
+// collects the blobs of the object tree, each of which is written once
+inline bl::result<void> collect_blobs(
+    const vineyard::ObjectMeta& meta, const vineyard::json& tree,
+    std::map<vineyard::ObjectID, std::shared_ptr<arrow::Buffer>>& blobs) {
+  auto id = vineyard::ObjectIDFromString(tree["id"].get<std::string>());
+  if (is_blob(tree)) {
+    if (id != vineyard::EmptyBlobID() && blobs.find(id) == blobs.end()) {
+      std::shared_ptr<arrow::Buffer> buffer;
+      VY_OK_OR_RAISE(meta.GetBuffer(id, buffer));
+      blobs[id] = buffer;
+    }
+    return {};
+  }
+  for (auto& item : tree.items()) {
+    if (is_member(item.value())) {
+      BOOST_LEAF_CHECK(collect_blobs(meta, item.value(), blobs));
+    }
+  }
+  return {};
+}
+
+/**
+ * @brief Creates the objects of the tree bottom-up as new objects, with the
+ * blobs read from the snapshot, where the objects shared by several members
+ * are created once.
+ */
+inline bl::result<vineyard::ObjectID> rebuild(
+    vineyard::Client& client, const vineyard::json& tree,
+    const vineyard::json& blob_index, int64_t data_offset,
+    const std::shared_ptr<arrow::io::RandomAccessFile>& file,
+    std::map<vineyard::ObjectID, vineyard::ObjectID>& rebuilt) {
+  auto id = vineyard::ObjectIDFromString(tree["id"].get<std::string>());
+  auto iter = rebuilt.find(id);
+  if (iter != rebuilt.end()) {
+    return iter->second;
+  }
+
+  vineyard::ObjectID new_id = vineyard::InvalidObjectID();
+  if (is_blob(tree)) {
+    if (id == vineyard::EmptyBlobID()) {
+      return id;
+    }
+    auto& entry = blob_index[vineyard::ObjectIDToString(id)];
+    auto offset = entry[0].get<int64_t>();
+    auto size = entry[1].get<int64_t>();
+    std::unique_ptr<vineyard::BlobWriter> writer;
+    VY_OK_OR_RAISE(client.CreateBlob(size, writer));
+    int64_t read_size;
+    ARROW_OK_ASSIGN_OR_RAISE(
+        read_size, file->ReadAt(data_offset + offset, size, writer->data()));
+    if (read_size != size) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                      "Truncated snapshot at blob " +
+                          vineyard::ObjectIDToString(id));
+    }
+    new_id = writer->Seal(client)->id();
+  } else {
+    vineyard::ObjectMeta meta;
+    meta.SetTypeName(tree["typename"].get<std::string>());
+    if (tree.find("nbytes") != tree.end()) {
+      meta.SetNBytes(tree["nbytes"].get<size_t>());
+    }
+    for (auto& item : tree.items()) {
+      auto& key = item.key();
+      if (is_member(item.value())) {
+        BOOST_LEAF_AUTO(member_id, rebuild(client, item.value(), blob_index,
+                                           data_offset, file, rebuilt));
+        meta.AddMember(key, member_id);
+      } else if (key != "id" && key != "typename" && key != "nbytes" &&
+                 key != "instance_id" && key != "signature" &&
+                 key != "transient") {
+        meta.MutMetaData()[key] = item.value();
+      }
+    }
+    VY_OK_OR_RAISE(client.CreateMetaData(meta, new_id));
+  }
+  rebuilt[id] = new_id;
+  return new_id;
+}
+
+inline bl::result<std::shared_ptr<arrow::fs::FileSystem>> filesystem_of(
+    const std::string& location, std::string& path) {
+  std::shared_ptr<arrow::fs::FileSystem> fs;
+  ARROW_OK_ASSIGN_OR_RAISE(fs,
+                           arrow::fs::FileSystemFromUriOrPath(location, &path));
+  return fs;
+}
+
+}  // namespace arrow_fragment_snapshot_impl
+
+/**
+ * @brief The location of the snapshot of the fragment fid, in the directory
+ * prefix, which is a local path or a uri of an object storage.
+ */
+inline std::string ArrowFragmentSnapshotLocation(const std::string& prefix,
+                                                 grape::fid_t fid) {
+  return prefix + "/arrow_frag_" + std::to_string(fid) + ".dat";
+}
+
+/**
+ * @brief Writes the object tree of a local vineyard object, e.g., a sealed
+ * ArrowFragment along with its vertex map, to a file at location, which is
+ * composed of the size of the header, the header, i.e., the metadata of the
+ * tree and the offsets of the blobs, and the blobs.
+ */
+inline bl::result<void> WriteObjectSnapshot(vineyard::Client& client,
+                                            vineyard::ObjectID object_id,
+                                            const std::string& location) {
+  namespace impl = arrow_fragment_snapshot_impl;
+  vineyard::ObjectMeta meta;
+  VY_OK_OR_RAISE(client.GetMetaData(object_id, meta, false));
+  auto& tree = meta.MetaData();
+
+  std::map<vineyard::ObjectID, std::shared_ptr<arrow::Buffer>> blobs;
+  BOOST_LEAF_CHECK(impl::collect_blobs(meta, tree, blobs));
+  vineyard::json header, blob_index;
+  int64_t offset = 0;
+  for (auto& pair : blobs) {
+    blob_index[vineyard::ObjectIDToString(pair.first)] = {
+        offset, pair.second->size()};
+    offset += pair.second->size();
+  }
+  header["meta"] = tree;
+  header["blobs"] = blob_index;
+  auto header_str = header.dump();
+  uint64_t header_size = header_str.size();
+
+  std::string path;
+  BOOST_LEAF_AUTO(fs, impl::filesystem_of(location, path));
+  auto pos = path.rfind('/');
+  if (pos != std::string::npos && pos != 0) {
+    // an object storage may refuse to create the directories, the output
+    // stream fails as well if they are missing
+    auto status = fs->CreateDir(path.substr(0, pos), true);
+    VLOG_IF(1, !status.ok()) << "Failed to create the directory of " << path
+                             << ": " << status.ToString();
+  }
+  std::shared_ptr<arrow::io::OutputStream> stream;
+  ARROW_OK_ASSIGN_OR_RAISE(stream, fs->OpenOutputStream(path));
+  ARROW_OK_OR_RAISE(stream->Write(impl::kMagic, sizeof(impl::kMagic)));
+  ARROW_OK_OR_RAISE(stream->Write(&header_size, sizeof(header_size)));
+  ARROW_OK_OR_RAISE(stream->Write(header_str.data(), header_str.size()));
+  for (auto& pair : blobs) {
+    ARROW_OK_OR_RAISE(stream->Write(pair.second->data(), pair.second->size()));
+  }
+  ARROW_OK_OR_RAISE(stream->Close());
+  return {};
+}
+
+namespace arrow_fragment_snapshot_impl {
+
+// reads the header of the snapshot, and the offset of the blobs after it
+inline bl::result<vineyard::json> read_header(
+    const std::shared_ptr<arrow::io::RandomAccessFile>& file,
+    const std::string& location, int64_t& data_offset) {
+  char magic[sizeof(kMagic)];
+  uint64_t header_size = 0;
+  int64_t read_size;
+  ARROW_OK_ASSIGN_OR_RAISE(read_size, file->ReadAt(0, sizeof(magic), magic));
+  if (read_size != sizeof(magic) ||
+      memcmp(magic, kMagic, sizeof(magic)) != 0) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                    "Not a snapshot of ArrowFragment: " + location);
+  }
+  ARROW_OK_ASSIGN_OR_RAISE(
+      read_size,
+      file->ReadAt(sizeof(magic), sizeof(header_size), &header_size));
+  std::string header_str(header_size, '\0');
+  ARROW_OK_ASSIGN_OR_RAISE(
+      read_size, file->ReadAt(sizeof(magic) + sizeof(header_size),
+                              header_size, &header_str[0]));
+  if (read_size != static_cast<int64_t>(header_size)) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                    "Truncated snapshot: " + location);
+  }
+  data_offset = sizeof(magic) + sizeof(header_size) + header_size;
+  return vineyard::json::parse(header_str);
+}
+
+inline bl::result<std::shared_ptr<arrow::io::RandomAccessFile>> open_file(
+    const std::string& location) {
+  std::string path;
+  BOOST_LEAF_AUTO(fs, filesystem_of(location, path));
+  std::shared_ptr<arrow::io::RandomAccessFile> file;
+  ARROW_OK_ASSIGN_OR_RAISE(file, fs->OpenInputFile(path));
+  return file;
+}
+
+// the value of a key of the metadata, which is a string or a number
+inline std::string key_value(const vineyard::json& meta,
+                             const std::string& key) {
+  auto iter = meta.find(key);
+  if (iter == meta.end()) {
+    return "";
+  }
+  return iter->is_string() ? iter->get<std::string>() : iter->dump();
+}
+
+}  // namespace arrow_fragment_snapshot_impl
+
+/**
+ * @brief Reads the metadata of the root object of the snapshot at location,
+ * without restoring anything.
+ */
+inline bl::result<vineyard::json> ReadObjectSnapshotMeta(
+    const std::string& location) {
+  namespace impl = arrow_fragment_snapshot_impl;
+  BOOST_LEAF_AUTO(file, impl::open_file(location));
+  int64_t data_offset = 0;
+  BOOST_LEAF_AUTO(header, impl::read_header(file, location, data_offset));
+  return header["meta"];
+}
+
+/**
+ * @brief Checks the metadata of the snapshot of an ArrowFragment against the
+ * fragment type FRAG_T it is to be restored as, and the number of the
+ * fragments of the session, so that a snapshot of the other oid or vid types
+ * is rejected rather than reinterpreted.
+ */
+template <typename FRAG_T>
+bl::result<void> CheckArrowFragmentSnapshot(const vineyard::json& meta,
+                                            grape::fid_t fnum,
+                                            const std::string& location) {
+  namespace impl = arrow_fragment_snapshot_impl;
+  auto type_name = meta["typename"].get<std::string>();
+  auto expected_type_name = vineyard::type_name<FRAG_T>();
+  if (type_name != expected_type_name) {
+    auto oid_type =
+        vineyard::normalize_datatype(impl::key_value(meta, "oid_type"));
+    auto vid_type =
+        vineyard::normalize_datatype(impl::key_value(meta, "vid_type"));
+    RETURN_GS_ERROR(
+        vineyard::ErrorCode::kInvalidValueError,
+        "The snapshot " + location + " is a " + type_name + " of oid type " +
+            oid_type + " and vid type " + vid_type +
+            ", which cannot be restored as " + expected_type_name +
+            ", load it with the oid_type and vid_type of the saved graph");
+  }
+  auto frag_num = impl::key_value(meta, "fnum_");
+  if (frag_num != std::to_string(fnum)) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                    "The snapshot " + location + " is of " + frag_num +
+                        " fragments, but the session has " +
+                        std::to_string(fnum) + " workers");
+  }
+  return {};
+}
+
+/**
+ * @brief Restores the object tree written by WriteObjectSnapshot as new local
+ * objects, where the blobs are read into the shared memory directly from the
+ * file, without shuffling or indexing anything. Returns the new id of the
+ * root object.
+ */
+inline bl::result<vineyard::ObjectID> ReadObjectSnapshot(
+    vineyard::Client& client, const std::string& location) {
+  namespace impl = arrow_fragment_snapshot_impl;
+  BOOST_LEAF_AUTO(file, impl::open_file(location));
+  int64_t data_offset = 0;
+  BOOST_LEAF_AUTO(header, impl::read_header(file, location, data_offset));
+
+  std::map<vineyard::ObjectID, vineyard::ObjectID> rebuilt;
+  return impl::rebuild(client, header["meta"], header["blobs"], data_offset,
+                       file, rebuilt);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_ARROW_FRAGMENT_SNAPSHOT_H_
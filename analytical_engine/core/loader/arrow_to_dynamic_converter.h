@@ -18,13 +18,21 @@
 
 #ifdef NETWORKX
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "core/fragment/dynamic_fragment.h"
+#include "core/loader/property_encoder.h"
+
 namespace gs {
 /**
  * @brief A utility class to pack basic C++ data type to folly::dynamic
@@ -73,57 +81,85 @@ class ArrowToDynamicConverter {
   }
 
  private:
-  bl::result<void> extractProperty(const std::shared_ptr<arrow::Table>& table,
-                                   int64_t row_id, int col_id,
-                                   folly::dynamic& data) {
-    auto column = table->column(col_id);
-    auto type = column->type();
-    auto prop_key = table->field(col_id)->name();
-
-    CHECK_LE(column->num_chunks(), 1);
-    if (data.find(prop_key) != data.items().end()) {
-      RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
-                      "Duplicated key " + prop_key);
-    }
-    if (type == arrow::int32()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::Int32Array>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::int64()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::Int64Array>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::uint32()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::UInt32Array>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::uint64()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::UInt64Array>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::float32()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::FloatArray>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::float64()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::DoubleArray>(column->chunk(0));
-      data[prop_key] = array->Value(row_id);
-    } else if (type == arrow::utf8()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::StringArray>(column->chunk(0));
-      data[prop_key] = array->GetString(row_id);
-    } else if (type == arrow::large_utf8()) {
-      auto array =
-          std::dynamic_pointer_cast<arrow::LargeStringArray>(column->chunk(0));
-      data[prop_key] = array->GetString(row_id);
-    } else {
-      RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
-                      "Unexpected type: " + type->ToString());
+  bl::result<void> checkColumns(const std::shared_ptr<arrow::Table>& table,
+                                std::vector<std::string>& keys,
+                                std::vector<const arrow::Array*>& arrays) {
+    std::unordered_set<std::string> existed_keys;
+    for (auto col_id = 0; col_id < table->num_columns(); col_id++) {
+      auto column = table->column(col_id);
+      auto type = column->type();
+      auto prop_key = table->field(col_id)->name();
+
+      CHECK_LE(column->num_chunks(), 1);
+      // the codes of the encoded columns are decoded by the conversion, see
+      // PropertyEncoder
+      if (IsEncodedField(table->field(col_id)) && column->num_chunks() != 0) {
+        std::shared_ptr<arrow::Array> decoded;
+        VY_OK_OR_RAISE(
+            DecodeColumn(table->field(col_id), column->chunk(0), decoded));
+        decoded_columns_.push_back(decoded);
+        column = std::make_shared<arrow::ChunkedArray>(decoded);
+        type = decoded->type();
+      }
+      if (!existed_keys.insert(prop_key).second) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
+                        "Duplicated key " + prop_key);
+      }
+      if (type != arrow::int32() && type != arrow::int64() &&
+          type != arrow::uint32() && type != arrow::uint64() &&
+          type != arrow::float32() && type != arrow::float64() &&
+          type != arrow::utf8() && type != arrow::large_utf8()) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                        "Unexpected type: " + type->ToString());
+      }
+      keys.push_back(prop_key);
+      arrays.push_back(column->num_chunks() == 0 ? nullptr
+                                                 : column->chunk(0).get());
     }
     return {};
   }
 
+  // the types of the arrays are checked by checkColumns
+  static folly::dynamic extractValue(const arrow::Array* array,
+                                     int64_t row_id) {
+    switch (array->type_id()) {
+    case arrow::Type::INT32:
+      return static_cast<const arrow::Int32Array*>(array)->Value(row_id);
+    case arrow::Type::INT64:
+      return static_cast<const arrow::Int64Array*>(array)->Value(row_id);
+    case arrow::Type::UINT32:
+      return static_cast<const arrow::UInt32Array*>(array)->Value(row_id);
+    case arrow::Type::UINT64:
+      return static_cast<const arrow::UInt64Array*>(array)->Value(row_id);
+    case arrow::Type::FLOAT:
+      return static_cast<const arrow::FloatArray*>(array)->Value(row_id);
+    case arrow::Type::DOUBLE:
+      return static_cast<const arrow::DoubleArray*>(array)->Value(row_id);
+    case arrow::Type::STRING:
+      return static_cast<const arrow::StringArray*>(array)->GetString(row_id);
+    case arrow::Type::LARGE_STRING:
+      return static_cast<const arrow::LargeStringArray*>(array)->GetString(
+          row_id);
+    default:
+      return nullptr;
+    }
+  }
+
+  static folly::dynamic extractProperties(
+      const std::vector<std::string>& keys,
+      const std::vector<const arrow::Array*>& arrays, int64_t row_id) {
+    folly::dynamic data = folly::dynamic::object();
+    for (size_t i = 0; i < keys.size(); i++) {
+      data[keys[i]] = extractValue(arrays[i], row_id);
+    }
+    return data;
+  }
+
+  /**
+   * @brief Converts the vertex map by a thread per fragment, as the vertices
+   * of a fragment are added in the same order, i.e., by labels and offsets,
+   * and a fragment is only touched by its own thread.
+   */
   bl::result<std::shared_ptr<vertex_map_t>> convertVertexMap(
       const std::shared_ptr<typename src_fragment_t::vertex_map_t>&
           src_vm_ptr) {
@@ -137,8 +173,11 @@ class ArrowToDynamicConverter {
 
     id_parser.Init(fnum, src_vm_ptr->label_num());
 
-    for (label_id_t v_label = 0; v_label < src_vm_ptr->label_num(); v_label++) {
-      for (fid_t fid = 0; fid < fnum; fid++) {
+    std::mutex error_mutex;
+    std::string error;
+    auto convert = [&](fid_t fid) {
+      for (label_id_t v_label = 0; v_label < src_vm_ptr->label_num();
+           v_label++) {
         for (vid_t offset = 0;
              offset < src_vm_ptr->GetInnerVertexSize(fid, v_label); offset++) {
           auto gid = id_parser.GenerateId(fid, v_label, offset);
@@ -149,106 +188,161 @@ class ArrowToDynamicConverter {
                   fid, DynamicWrapper<oid_t>::to_dynamic(oid), gid)) {
             std::stringstream ss;
             ss << "Duplicated oid " << oid;
-            RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError, ss.str());
+            std::lock_guard<std::mutex> lock(error_mutex);
+            error = ss.str();
+            return;
           }
         }
       }
+    };
+
+    int thread_num = std::max(
+        1, std::min(static_cast<int>(fnum),
+                    static_cast<int>((std::thread::hardware_concurrency() +
+                                      comm_spec_.local_num() - 1) /
+                                     comm_spec_.local_num())));
+    std::atomic<fid_t> current_fid(0);
+    std::vector<std::thread> threads(thread_num);
+    for (int i = 0; i < thread_num; ++i) {
+      threads[i] = std::thread([&]() {
+        while (true) {
+          fid_t got = current_fid.fetch_add(1, std::memory_order_relaxed);
+          if (got >= fnum) {
+            break;
+          }
+          convert(got);
+        }
+      });
+    }
+    for (auto& thrd : threads) {
+      thrd.join();
+    }
+    if (!error.empty()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError, error);
     }
     dst_vm_ptr->Construct();
 
     return dst_vm_ptr;
   }
 
+  /**
+   * @brief Converts the vertices and the outgoing edges of the inner vertices
+   * by multiple threads, where the edges of a vertex are written to the range
+   * given by the prefix sum of the degrees, so the edges are laid out as the
+   * serial traversal does without any reallocation.
+   */
   bl::result<std::shared_ptr<dst_fragment_t>> convertFragment(
       const std::shared_ptr<src_fragment_t>& src_frag,
       const std::shared_ptr<vertex_map_t>& dst_vm) {
+    using src_vertex_t = typename src_fragment_t::vertex_t;
     auto fid = src_frag->fid();
-    std::vector<grape::internal::Vertex<vid_t, vdata_t>> processed_vertices;
+    label_id_t v_label_num = src_frag->vertex_label_num();
+    label_id_t e_label_num = src_frag->edge_label_num();
+
+    size_t ivnum = 0;
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      ivnum += src_frag->InnerVertices(v_label).size();
+    }
+    std::vector<grape::internal::Vertex<vid_t, vdata_t>> processed_vertices(
+        ivnum);
 
-    for (label_id_t v_label = 0; v_label < src_frag->vertex_label_num();
-         v_label++) {
-      auto v_data = src_frag->vertex_data_table(v_label);
+    size_t vertex_base = 0;
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      std::vector<std::string> keys;
+      std::vector<const arrow::Array*> arrays;
+      BOOST_LEAF_CHECK(
+          checkColumns(src_frag->vertex_data_table(v_label), keys, arrays));
 
       // traverse vertices and extract data from ArrowFragment
-      for (const auto& u : src_frag->InnerVertices(v_label)) {
-        auto oid = src_frag->GetId(u);
-        vid_t gid;
-
-        CHECK(dst_vm->GetGid(fid, oid, gid));
-        folly::dynamic data = folly::dynamic::object();
-        for (auto col_id = 0; col_id < v_data->num_columns(); col_id++) {
-          auto column = v_data->column(col_id);
-          auto prop_key = v_data->field(col_id)->name();
-          auto type = column->type();
-
-          if (data.find(prop_key) != data.items().end()) {
-            RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
-                            "Duplicated key " + prop_key);
-          }
-          if (type == arrow::int32()) {
-            data[prop_key] = src_frag->template GetData<int32_t>(u, col_id);
-          } else if (type == arrow::int64()) {
-            data[prop_key] = src_frag->template GetData<int64_t>(u, col_id);
-          } else if (type == arrow::uint32()) {
-            data[prop_key] = src_frag->template GetData<uint32_t>(u, col_id);
-          } else if (type == arrow::uint64()) {
-            data[prop_key] = src_frag->template GetData<uint64_t>(u, col_id);
-          } else if (type == arrow::float32()) {
-            data[prop_key] = src_frag->template GetData<float>(u, col_id);
-          } else if (type == arrow::float64()) {
-            data[prop_key] = src_frag->template GetData<double>(u, col_id);
-          } else if (type == arrow::utf8()) {
-            data[prop_key] = src_frag->template GetData<std::string>(u, col_id);
-          } else if (type == arrow::large_utf8()) {
-            data[prop_key] = src_frag->template GetData<std::string>(u, col_id);
-          } else {
-            RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
-                            "Unexpected type: " + type->ToString());
-          }
-        }
-        processed_vertices.emplace_back(gid, data);
-      }
+      auto inner_vertices = src_frag->InnerVertices(v_label);
+      dynamic_fragment_impl::parallel_for(
+          0, inner_vertices.size(), [&](size_t i) {
+            src_vertex_t u(inner_vertices.begin_value() + i);
+            vid_t gid;
+
+            CHECK(dst_vm->GetGid(fid, src_frag->GetId(u), gid));
+            auto data =
+                extractProperties(keys, arrays, src_frag->vertex_offset(u));
+            processed_vertices[vertex_base + i] =
+                grape::internal::Vertex<vid_t, vdata_t>(gid, std::move(data));
+          });
+      vertex_base += inner_vertices.size();
     }
 
-    std::vector<grape::Edge<vid_t, edata_t>> processed_edges;
-    // traverse edges and extract data
-    for (label_id_t v_label = 0; v_label < src_frag->vertex_label_num();
-         v_label++) {
-      for (const auto& u : src_frag->InnerVertices(v_label)) {
-        auto u_oid = src_frag->GetId(u);
-        vid_t u_gid;
-        CHECK(dst_vm->GetGid(fid, u_oid, u_gid));
-        std::unordered_set<vid_t> existed_dsts;
-
-        for (label_id_t e_label = 0; e_label < src_frag->edge_label_num();
-             e_label++) {
-          auto oe = src_frag->GetOutgoingAdjList(u, e_label);
-          auto e_data = src_frag->edge_data_table(e_label);
-
-          for (auto& e : oe) {
-            auto v = e.neighbor();
-            auto e_id = e.edge_id();
-            auto v_oid = src_frag->GetId(v);
-            vid_t v_gid;
-            CHECK(dst_vm->GetGid(v_oid, v_gid));
-
-            // detect parallel edge of different label on the property graph
-            if (existed_dsts.find(v_gid) != existed_dsts.end()) {
-              std::stringstream ss;
-              ss << "Duplicated edge: " << u_oid << " -> " << v_oid;
-              RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError,
-                              ss.str());
+    std::vector<std::vector<std::string>> e_keys(e_label_num);
+    std::vector<std::vector<const arrow::Array*>> e_arrays(e_label_num);
+    for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+      BOOST_LEAF_CHECK(checkColumns(src_frag->edge_data_table(e_label),
+                                    e_keys[e_label], e_arrays[e_label]));
+    }
+
+    // the offsets of the edges of the inner vertices, by the order of the
+    // processed vertices
+    std::vector<size_t> edge_offsets(ivnum + 1, 0);
+    vertex_base = 0;
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      auto inner_vertices = src_frag->InnerVertices(v_label);
+      dynamic_fragment_impl::parallel_for(
+          0, inner_vertices.size(), [&](size_t i) {
+            src_vertex_t u(inner_vertices.begin_value() + i);
+            size_t degree = 0;
+            for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+              degree += src_frag->GetLocalOutDegree(u, e_label);
             }
-            existed_dsts.insert(v_gid);
+            edge_offsets[vertex_base + i + 1] = degree;
+          });
+      vertex_base += inner_vertices.size();
+    }
+    for (size_t i = 0; i < ivnum; i++) {
+      edge_offsets[i + 1] += edge_offsets[i];
+    }
+    std::vector<grape::Edge<vid_t, edata_t>> processed_edges(
+        edge_offsets[ivnum]);
+
+    std::mutex error_mutex;
+    std::string error;
+    // traverse edges and extract data
+    vertex_base = 0;
+    for (label_id_t v_label = 0; v_label < v_label_num; v_label++) {
+      auto inner_vertices = src_frag->InnerVertices(v_label);
+      dynamic_fragment_impl::parallel_for(
+          0, inner_vertices.size(), [&](size_t i) {
+            src_vertex_t u(inner_vertices.begin_value() + i);
+            vid_t u_gid = processed_vertices[vertex_base + i].vid;
+            size_t cursor = edge_offsets[vertex_base + i];
+            std::unordered_set<vid_t> existed_dsts;
+
+            for (label_id_t e_label = 0; e_label < e_label_num; e_label++) {
+              auto oe = src_frag->GetOutgoingAdjList(u, e_label);
+
+              for (auto& e : oe) {
+                auto v = e.neighbor();
+                auto v_oid = src_frag->GetId(v);
+                vid_t v_gid;
+                CHECK(dst_vm->GetGid(v_oid, v_gid));
 
-            folly::dynamic data = folly::dynamic::object();
-            for (auto col_id = 0; col_id < e_data->num_columns(); col_id++) {
-              BOOST_LEAF_CHECK(extractProperty(e_data, e_id, col_id, data));
+                // detect parallel edge of different label on the property
+                // graph
+                if (!existed_dsts.insert(v_gid).second) {
+                  std::stringstream ss;
+                  ss << "Duplicated edge: " << src_frag->GetId(u) << " -> "
+                     << v_oid;
+                  std::lock_guard<std::mutex> lock(error_mutex);
+                  error = ss.str();
+                  return;
+                }
+                processed_edges[cursor++] = grape::Edge<vid_t, edata_t>(
+                    u_gid, v_gid,
+                    extractProperties(e_keys[e_label], e_arrays[e_label],
+                                      e.edge_id()));
+              }
             }
-            processed_edges.emplace_back(u_gid, v_gid, data);
-          }
-        }
-      }
+          });
+      vertex_base += inner_vertices.size();
+    }
+    decoded_columns_.clear();
+    if (!error.empty()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIllegalStateError, error);
     }
 
     auto dynamic_frag = std::make_shared<dst_fragment_t>(dst_vm);
@@ -258,6 +352,8 @@ class ArrowToDynamicConverter {
   }
 
   grape::CommSpec comm_spec_;
+  // the decoded columns read by the conversion
+  std::vector<std::shared_ptr<arrow::Array>> decoded_columns_;
 };
 
 }  // namespace gs
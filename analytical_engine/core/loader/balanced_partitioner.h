@@ -0,0 +1,223 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_BALANCED_PARTITIONER_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_BALANCED_PARTITIONER_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "grape/config.h"
+#include "vineyard/basic/ds/arrow_utils.h"
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+#include "core/error.h"
+
+namespace gs {
+
+/**
+ * @brief The strategies to place the vertices to the fragments at loading.
+ *
+ * kHash and kSegment are the same as vineyard::HashPartitioner and
+ * SegmentedPartitioner. kEdgeBalanced cuts the vertices in the order of the
+ * vertex files into contiguous ranges of about the same total weight, i.e.,
+ * the degree plus one, and kDegreeAware places the vertices from the heaviest
+ * one to the fragment with the least weight so far, so the hubs are spread
+ * over the fragments first.
+ */
+enum class PartitionStrategy {
+  kHash,
+  kSegment,
+  kEdgeBalanced,
+  kDegreeAware,
+};
+
+inline bl::result<PartitionStrategy> ParsePartitionStrategy(
+    const std::string& name) {
+  if (name == "hash") {
+    return PartitionStrategy::kHash;
+  } else if (name == "segment") {
+    return PartitionStrategy::kSegment;
+  } else if (name == "edge_balanced") {
+    return PartitionStrategy::kEdgeBalanced;
+  } else if (name == "degree_aware") {
+    return PartitionStrategy::kDegreeAware;
+  }
+  RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                  "Unknown partition strategy: " + name +
+                      ", expects hash, segment, edge_balanced or "
+                      "degree_aware");
+}
+
+inline bool IsWeightedPartitionStrategy(PartitionStrategy strategy) {
+  return strategy == PartitionStrategy::kEdgeBalanced ||
+         strategy == PartitionStrategy::kDegreeAware;
+}
+
+/**
+ * @brief BalancedPartitioner places the vertices by one of the
+ * PartitionStrategy, which is chosen at runtime. The vertices out of the
+ * list given to Init, e.g., the ones only appearing in the edge files, are
+ * placed by hash. The placement is shared by the copies of the partitioner.
+ *
+ * @tparam OID_T
+ */
+template <typename OID_T>
+class BalancedPartitioner {
+ public:
+  using oid_t = OID_T;
+  using internal_oid_t = typename vineyard::InternalType<oid_t>::type;
+
+  BalancedPartitioner() : fnum_(1), strategy_(PartitionStrategy::kHash) {}
+
+  void Init(fid_t fnum) {
+    fnum_ = fnum;
+    strategy_ = PartitionStrategy::kHash;
+    o2f_.reset();
+  }
+
+  void Init(fid_t fnum, const std::vector<oid_t>& oid_list) {
+    fnum_ = fnum;
+    strategy_ = PartitionStrategy::kSegment;
+    auto o2f = std::make_shared<std::unordered_map<oid_t, fid_t>>();
+    o2f->reserve(oid_list.size());
+    size_t frag_vnum =
+        std::max<size_t>(1, (oid_list.size() + fnum - 1) / fnum);
+    for (size_t i = 0; i < oid_list.size(); ++i) {
+      o2f->emplace(oid_list[i], static_cast<fid_t>(i / frag_vnum));
+    }
+    o2f_ = std::move(o2f);
+  }
+
+  /**
+   * @brief Places the vertices in oid_list by the weights, which are usually
+   * the degrees plus one.
+   */
+  void Init(fid_t fnum, const std::vector<oid_t>& oid_list,
+            const std::vector<int64_t>& weights, PartitionStrategy strategy) {
+    CHECK_EQ(oid_list.size(), weights.size());
+    if (strategy == PartitionStrategy::kHash) {
+      Init(fnum);
+      return;
+    } else if (strategy == PartitionStrategy::kSegment) {
+      Init(fnum, oid_list);
+      return;
+    }
+    fnum_ = fnum;
+    strategy_ = strategy;
+    std::vector<fid_t> placement =
+        strategy == PartitionStrategy::kEdgeBalanced
+            ? balancedRanges(fnum, weights)
+            : heaviestFirst(fnum, weights);
+    auto o2f = std::make_shared<std::unordered_map<oid_t, fid_t>>();
+    o2f->reserve(oid_list.size());
+    for (size_t i = 0; i < oid_list.size(); ++i) {
+      o2f->emplace(oid_list[i], placement[i]);
+    }
+    o2f_ = std::move(o2f);
+  }
+
+  PartitionStrategy strategy() const { return strategy_; }
+
+  fid_t GetPartitionId(const internal_oid_t& oid) const {
+    if (o2f_ != nullptr) {
+      auto iter = o2f_->find(oid_t(oid));
+      if (iter != o2f_->end()) {
+        return iter->second;
+      }
+    }
+    return static_cast<fid_t>(
+        static_cast<uint64_t>(std::hash<oid_t>()(oid_t(oid))) % fnum_);
+  }
+
+ private:
+  // contiguous ranges, the i-th of which ends once the prefix weight reaches
+  // (i + 1) / fnum of the total
+  static std::vector<fid_t> balancedRanges(
+      fid_t fnum, const std::vector<int64_t>& weights) {
+    int64_t total = 0;
+    for (auto weight : weights) {
+      total += weight;
+    }
+    std::vector<fid_t> placement(weights.size());
+    int64_t prefix = 0;
+    fid_t fid = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      placement[i] = fid;
+      prefix += weights[i];
+      while (fid + 1 < fnum &&
+             prefix * static_cast<int64_t>(fnum) >=
+                 total * static_cast<int64_t>(fid + 1)) {
+        ++fid;
+      }
+    }
+    return placement;
+  }
+
+  // the longest processing time first, with the ties broken by the order
+  static std::vector<fid_t> heaviestFirst(
+      fid_t fnum, const std::vector<int64_t>& weights) {
+    std::vector<size_t> order(weights.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      return weights[lhs] > weights[rhs];
+    });
+    using load_t = std::pair<int64_t, fid_t>;
+    std::priority_queue<load_t, std::vector<load_t>, std::greater<load_t>>
+        loads;
+    for (fid_t fid = 0; fid < fnum; ++fid) {
+      loads.emplace(0, fid);
+    }
+    std::vector<fid_t> placement(weights.size());
+    for (auto i : order) {
+      auto load = loads.top();
+      loads.pop();
+      placement[i] = load.second;
+      loads.emplace(load.first + weights[i], load.second);
+    }
+    return placement;
+  }
+
+  fid_t fnum_;
+  PartitionStrategy strategy_;
+  std::shared_ptr<const std::unordered_map<oid_t, fid_t>> o2f_;
+};
+
+/**
+ * @brief Sums the vectors of the workers in place.
+ */
+inline void AllReduceSum(std::vector<int64_t>& values, MPI_Comm comm) {
+  // the count of MPI_Allreduce is an int
+  const size_t batch = 1 << 28;
+  for (size_t begin = 0; begin < values.size(); begin += batch) {
+    int count = static_cast<int>(std::min(batch, values.size() - begin));
+    MPI_Allreduce(MPI_IN_PLACE, values.data() + begin, count, MPI_INT64_T,
+                  MPI_SUM, comm);
+  }
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_BALANCED_PARTITIONER_H_
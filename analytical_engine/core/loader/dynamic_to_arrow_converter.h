@@ -18,12 +18,17 @@
 
 #ifdef NETWORKX
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "arrow/api.h"
+#include "arrow/array/concatenate.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
 #include "core/error.h"
@@ -32,293 +37,195 @@
 
 namespace gs {
 
-/**
- * @brief A util to extract data on the vertices to arrow array from
- * DynamicFragment
- * @tparam T data type
- */
-template <typename T>
-struct VertexArrayBuilder {};
+namespace dynamic_to_arrow_converter_impl {
 
-/**
- * @brief This is a specialized VertexArrayBuilder for arrow::Int64Builder
- */
-template <>
-struct VertexArrayBuilder<arrow::Int64Builder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    arrow::Int64Builder builder;
-    std::shared_ptr<arrow::Array> array;
+// the property columns, sorted by the keys
+using columns_t = std::map<std::string, folly::dynamic::Type>;
 
-    for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
-
-      if (data.count(prop_key) == 0) {
-        ARROW_OK_OR_RAISE(builder.AppendNull());
-      } else {
-        ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asInt()));
-      }
-    }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
-  }
-};
+// the number of the vertices sampled to infer the columns
+static constexpr size_t kSampleSize = 1024;
 
 /**
- * @brief This is a specialized VertexArrayBuilder for arrow::DoubleBuilder
+ * @brief Merges the properties of a row to the columns, returns false if the
+ * type of a key differs from the one seen before.
  */
-template <>
-struct VertexArrayBuilder<arrow::DoubleBuilder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    arrow::DoubleBuilder builder;
-    std::shared_ptr<arrow::Array> array;
-
-    for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
-
-      if (data.count(prop_key) == 0) {
-        ARROW_OK_OR_RAISE(builder.AppendNull());
-      } else {
-        ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asDouble()));
-      }
+inline bool sample_row(const folly::dynamic& data, columns_t& columns) {
+  if (!data.isObject()) {
+    return false;
+  }
+  for (auto& kv : data.items()) {
+    auto iter = columns.emplace(kv.first.asString(), kv.second.type()).first;
+    if (iter->second != kv.second.type()) {
+      return false;
     }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
   }
-};
-
-/**
- * @brief This is a specialized VertexArrayBuilder for arrow::LargeStringBuilder
- */
-template <>
-struct VertexArrayBuilder<arrow::LargeStringBuilder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    arrow::LargeStringBuilder builder;
-    std::shared_ptr<arrow::Array> array;
-
-    for (const auto& u : src_frag->InnerVertices()) {
-      auto& data = src_frag->GetData(u);
-
-      if (data.count(prop_key) == 0) {
-        ARROW_OK_OR_RAISE(builder.AppendNull());
-      } else {
-        ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asString()));
-      }
+  return true;
+}
+
+inline bool is_supported(folly::dynamic::Type type) {
+  return type == folly::dynamic::Type::INT64 ||
+         type == folly::dynamic::Type::DOUBLE ||
+         type == folly::dynamic::Type::STRING;
+}
+
+inline bool is_supported(const columns_t& columns) {
+  for (auto& pair : columns) {
+    if (!is_supported(pair.second)) {
+      return false;
     }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
   }
-};
-
-/**
- * @brief A util to extract data on the edges to arrow array from
- * DynamicFragment
- * @tparam T data type
- */
-template <typename T>
-struct EdgeArrayBuilder {};
-
-/**
- * @brief This is a specialized EdgeArrayBuilder for arrow::Int64Builder
- */
-template <>
-struct EdgeArrayBuilder<arrow::Int64Builder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    auto inner_vertices = src_frag->InnerVertices();
-    arrow::Int64Builder builder;
-    std::shared_ptr<arrow::Array> array;
-
-    for (const auto& u : inner_vertices) {
-      for (auto& e : src_frag->GetOutgoingAdjList(u)) {
-        if (!src_frag->directed() && (u.GetValue() > e.neighbor().GetValue())) {
-          continue;  // if src_frag is undirected, just append one edge.
-        }
-
-        auto& data = e.data();
-        if (data.count(prop_key) == 0) {
-          ARROW_OK_OR_RAISE(builder.AppendNull());
-        } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asInt()));
-        }
-      }
+  return true;
+}
+
+inline bl::result<void> check_columns(const columns_t& columns) {
+  for (auto& pair : columns) {
+    if (!is_supported(pair.second)) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
+                      "Unsupported dynamic type: " +
+                          std::to_string(pair.second));
     }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
   }
-};
+  return {};
+}
+
+inline std::shared_ptr<arrow::DataType> arrow_type_of(
+    folly::dynamic::Type type) {
+  switch (type) {
+  case folly::dynamic::Type::INT64:
+    return arrow::int64();
+  case folly::dynamic::Type::DOUBLE:
+    return arrow::float64();
+  default:
+    return arrow::large_utf8();
+  }
+}
 
 /**
- * @brief This is a specialized EdgeArrayBuilder for arrow::DoubleBuilder
+ * @brief RowBuilder appends the properties of the rows of a thread to the
+ * builders of the columns, where the missing properties are nulls.
  */
-template <>
-struct EdgeArrayBuilder<arrow::DoubleBuilder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    auto inner_vertices = src_frag->InnerVertices();
-    arrow::DoubleBuilder builder;
-    std::shared_ptr<arrow::Array> array;
-    for (const auto& u : inner_vertices) {
-      for (auto& e : src_frag->GetOutgoingAdjList(u)) {
-        if (!src_frag->directed() && (u.GetValue() > e.neighbor().GetValue())) {
-          continue;  // if src_frag is undirected, just append one edge.
-        }
-
-        auto& data = e.data();
-        if (data.count(prop_key) == 0) {
-          ARROW_OK_OR_RAISE(builder.AppendNull());
-        } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asDouble()));
-        }
+class RowBuilder {
+ public:
+  explicit RowBuilder(const columns_t& columns) {
+    for (auto& pair : columns) {
+      keys_.push_back(pair.first);
+      types_.push_back(pair.second);
+      switch (pair.second) {
+      case folly::dynamic::Type::INT64:
+        builders_.emplace_back(new arrow::Int64Builder());
+        break;
+      case folly::dynamic::Type::DOUBLE:
+        builders_.emplace_back(new arrow::DoubleBuilder());
+        break;
+      default:
+        builders_.emplace_back(new arrow::LargeStringBuilder());
+        break;
       }
     }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
   }
-};
 
-/**
- * @brief This is a specialized EdgeArrayBuilder for arrow::LargeStringBuilder
- */
-template <>
-struct EdgeArrayBuilder<arrow::LargeStringBuilder> {
-  static bl::result<std::shared_ptr<arrow::Array>> build(
-      const std::shared_ptr<DynamicFragment>& src_frag, std::string& prop_key) {
-    auto inner_vertices = src_frag->InnerVertices();
-    arrow::LargeStringBuilder builder;
-    std::shared_ptr<arrow::Array> array;
-
-    for (const auto& u : inner_vertices) {
-      for (auto& e : src_frag->GetOutgoingAdjList(u)) {
-        if (!src_frag->directed() && (u.GetValue() > e.neighbor().GetValue())) {
-          continue;  // if src_frag is undirected, just append one edge.
-        }
-
-        auto& data = e.data();
-        if (data.count(prop_key) == 0) {
-          ARROW_OK_OR_RAISE(builder.AppendNull());
-        } else {
-          ARROW_OK_OR_RAISE(builder.Append(data[prop_key].asString()));
-        }
-      }
+  void Reserve(int64_t size) {
+    for (auto& builder : builders_) {
+      check(builder->Reserve(size));
     }
-
-    ARROW_OK_OR_RAISE(builder.Finish(&array));
-    return array;
   }
-};
-
-/**
- * @brief A util to build src and dst oid array from DynamicFragment
- * @tparam DST_FRAG_T The type of destination fragment
- * @tparam OID_T OID type
- */
-template <typename DST_FRAG_T, typename OID_T>
-struct COOBuilder {};
-
-/**
- * @brief This is a specialized EdgeArrayBuilder for int64_t
- * @tparam DST_FRAG_T
- */
-template <typename DST_FRAG_T>
-struct COOBuilder<DST_FRAG_T, int64_t> {
-  using oid_t = int64_t;
-  using src_fragment_t = DynamicFragment;
-  using dst_fragment_t = DST_FRAG_T;
-
-  auto Build(
-      const std::shared_ptr<src_fragment_t>& src_frag,
-      const std::shared_ptr<typename dst_fragment_t::vertex_map_t>& dst_vm)
-      -> bl::result<std::pair<std::shared_ptr<arrow::Array>,
-                              std::shared_ptr<arrow::Array>>> {
-    auto fid = src_frag->fid();
-
-    auto inner_vertices = src_frag->InnerVertices();
-    arrow::UInt64Builder src_builder, dst_builder;
-    std::shared_ptr<arrow::Array> src_array, dst_array;
-
-    for (const auto& u : inner_vertices) {
-      auto u_oid = src_frag->GetId(u);
-      vineyard::property_graph_types::VID_TYPE u_gid;
 
-      CHECK(dst_vm->GetGid(fid, 0, u_oid.asInt(), u_gid));
-
-      for (auto& e : src_frag->GetOutgoingAdjList(u)) {
-        auto& v = e.neighbor();
-        if (!src_frag->directed() && u.GetValue() > v.GetValue()) {
-          continue;
-        }
-        auto v_oid = src_frag->GetId(v);
-        vineyard::property_graph_types::VID_TYPE v_gid;
-
-        CHECK(dst_vm->GetGid(0, v_oid.asInt(), v_gid));
-        ARROW_OK_OR_RAISE(src_builder.Append(u_gid));
-        ARROW_OK_OR_RAISE(dst_builder.Append(v_gid));
+  /**
+   * @brief Appends a row, returns false if the row has a key out of the
+   * columns, or a value of another type, then the builder is left partially
+   * appended.
+   */
+  bool Append(const folly::dynamic& data) {
+    if (!data.isObject()) {
+      return false;
+    }
+    size_t found = 0;
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      auto iter = data.find(keys_[i]);
+      if (iter == data.items().end()) {
+        check(builders_[i]->AppendNull());
+        continue;
+      }
+      auto& value = iter->second;
+      if (value.type() != types_[i]) {
+        return false;
+      }
+      ++found;
+      switch (types_[i]) {
+      case folly::dynamic::Type::INT64:
+        check(static_cast<arrow::Int64Builder*>(builders_[i].get())
+                  ->Append(value.getInt()));
+        break;
+      case folly::dynamic::Type::DOUBLE:
+        check(static_cast<arrow::DoubleBuilder*>(builders_[i].get())
+                  ->Append(value.getDouble()));
+        break;
+      default:
+        check(static_cast<arrow::LargeStringBuilder*>(builders_[i].get())
+                  ->Append(value.getString()));
+        break;
       }
     }
-
-    ARROW_OK_OR_RAISE(src_builder.Finish(&src_array));
-    ARROW_OK_OR_RAISE(dst_builder.Finish(&dst_array));
-
-    return std::make_pair(src_array, dst_array);
+    return found == data.size();
   }
-};
 
-/**
- * @brief This is a specialized EdgeArrayBuilder for std::string
- * @tparam DST_FRAG_T
- */
-template <typename DST_FRAG_T>
-struct COOBuilder<DST_FRAG_T, std::string> {
-  using oid_t = int64_t;
-  using src_fragment_t = DynamicFragment;
-  using dst_fragment_t = DST_FRAG_T;
-
-  auto Build(
-      const std::shared_ptr<src_fragment_t>& src_frag,
-      const std::shared_ptr<typename dst_fragment_t::vertex_map_t>& dst_vm)
-      -> bl::result<std::pair<std::shared_ptr<arrow::Array>,
-                              std::shared_ptr<arrow::Array>>> {
-    auto fid = src_frag->fid();
-
-    auto inner_vertices = src_frag->InnerVertices();
-    arrow::UInt64Builder src_builder, dst_builder;
-    std::shared_ptr<arrow::Array> src_array, dst_array;
+  // appends the chunks of the columns to chunks[i]
+  bl::result<void> Finish(
+      std::vector<std::vector<std::shared_ptr<arrow::Array>>>& chunks) {
+    ARROW_OK_OR_RAISE(status_);
+    chunks.resize(builders_.size());
+    for (size_t i = 0; i < builders_.size(); ++i) {
+      std::shared_ptr<arrow::Array> array;
+      ARROW_OK_OR_RAISE(builders_[i]->Finish(&array));
+      chunks[i].push_back(array);
+    }
+    return {};
+  }
 
-    for (const auto& u : inner_vertices) {
-      auto u_oid = src_frag->GetId(u);
-      vineyard::property_graph_types::VID_TYPE u_gid;
+ private:
+  // keeps the first failure, which is raised by Finish
+  void check(const arrow::Status& status) {
+    if (status_.ok() && !status.ok()) {
+      status_ = status;
+    }
+  }
 
-      CHECK(dst_vm->GetGid(fid, 0, u_oid.asString(), u_gid));
+  std::vector<std::string> keys_;
+  std::vector<folly::dynamic::Type> types_;
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders_;
+  arrow::Status status_;
+};
 
-      for (auto& e : src_frag->GetOutgoingAdjList(u)) {
-        auto& v = e.neighbor();
-        if (!src_frag->directed() && u.GetValue() > v.GetValue()) {
-          continue;
-        }
-        auto v_oid = src_frag->GetId(v);
-        vineyard::property_graph_types::VID_TYPE v_gid;
+inline bl::result<std::shared_ptr<arrow::Array>> concatenate(
+    const std::vector<std::shared_ptr<arrow::Array>>& chunks) {
+  if (chunks.size() == 1) {
+    return chunks[0];
+  }
+  std::shared_ptr<arrow::Array> array;
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+  ARROW_OK_OR_RAISE(
+      arrow::Concatenate(chunks, arrow::default_memory_pool(), &array));
+#else
+  ARROW_OK_ASSIGN_OR_RAISE(array, arrow::Concatenate(chunks));
+#endif
+  return array;
+}
 
-        CHECK(dst_vm->GetGid(0, v_oid.asString(), v_gid));
-        ARROW_OK_OR_RAISE(src_builder.Append(u_gid));
-        ARROW_OK_OR_RAISE(dst_builder.Append(v_gid));
-      }
-    }
+template <typename OID_T>
+struct DynamicOid {};
 
-    ARROW_OK_OR_RAISE(src_builder.Finish(&src_array));
-    ARROW_OK_OR_RAISE(dst_builder.Finish(&dst_array));
+template <>
+struct DynamicOid<int64_t> {
+  static int64_t get(const folly::dynamic& oid) { return oid.asInt(); }
+};
 
-    return std::make_pair(src_array, dst_array);
-  }
+template <>
+struct DynamicOid<std::string> {
+  static std::string get(const folly::dynamic& oid) { return oid.asString(); }
 };
 
+}  // namespace dynamic_to_arrow_converter_impl
+
 /**
  * @brief VertexMapConverter is intended to build ArrowVertexMap from
  * DynamicFragment
@@ -449,47 +356,148 @@ class DynamicToArrowConverter {
   }
 
  private:
-  bl::result<std::shared_ptr<arrow::Table>> BuildVTable(
-      const std::shared_ptr<src_fragment_t>& src_frag) {
-    std::vector<std::shared_ptr<arrow::Field>> schema_vector;
-    std::vector<std::shared_ptr<arrow::Array>> arrays;
-    BOOST_LEAF_AUTO(prop_keys, src_frag->CollectPropertyKeysOnVertices());
-
-    // build schema and array
-    for (const auto& e : prop_keys) {
-      auto key = e.first;
-      auto type = e.second;
+  using vertex_t = typename src_fragment_t::vertex_t;
+  using columns_t = dynamic_to_arrow_converter_impl::columns_t;
+  using row_builder_t = dynamic_to_arrow_converter_impl::RowBuilder;
+
+  // the alive inner vertices, split to contiguous ranges of the threads
+  struct VertexRanges {
+    std::vector<vertex_t> vertices;
+    size_t thread_num;
+    size_t chunk;
+
+    explicit VertexRanges(const std::shared_ptr<src_fragment_t>& src_frag) {
+      auto inner_vertices = src_frag->InnerVertices();
+      vertices.assign(inner_vertices.begin(), inner_vertices.end());
+      thread_num = dynamic_fragment_impl::parallel_thread_num(
+          vertices.size(), dynamic_fragment_impl::kParallelGrainSize);
+      chunk = (vertices.size() + thread_num - 1) / thread_num;
+    }
 
-      switch (type) {
-      case folly::dynamic::Type::INT64: {
-        auto r = VertexArrayBuilder<arrow::Int64Builder>::build(src_frag, key);
+    size_t begin(size_t tid) const {
+      return std::min(vertices.size(), tid * chunk);
+    }
 
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::int64()));
-        arrays.push_back(array);
-        break;
+    size_t end(size_t tid) const {
+      return std::min(vertices.size(), (tid + 1) * chunk);
+    }
+  };
+
+  template <typename FUNC_T>
+  static void forEachOutgoingEdge(
+      const std::shared_ptr<src_fragment_t>& src_frag, const vertex_t& u,
+      const FUNC_T& func) {
+    for (auto& e : src_frag->GetOutgoingAdjList(u)) {
+      if (!src_frag->directed() && u.GetValue() > e.neighbor().GetValue()) {
+        continue;  // if src_frag is undirected, just append one edge.
       }
-      case folly::dynamic::Type::DOUBLE: {
-        auto r = VertexArrayBuilder<arrow::DoubleBuilder>::build(src_frag, key);
+      func(e);
+    }
+  }
 
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::float64()));
-        arrays.push_back(array);
-        break;
+  /**
+   * @brief Infers the columns from the data of a sample of the vertices, or
+   * of their outgoing edges. The columns of all of the data are collected if
+   * the sample has conflicting types.
+   */
+  bl::result<columns_t> sampleColumns(
+      const std::shared_ptr<src_fragment_t>& src_frag,
+      const VertexRanges& ranges, bool on_edges) {
+    namespace impl = dynamic_to_arrow_converter_impl;
+    auto& vertices = ranges.vertices;
+    size_t stride = std::max<size_t>(1, vertices.size() / impl::kSampleSize);
+    columns_t columns;
+    bool sampled = true;
+    for (size_t i = 0; i < vertices.size() && sampled; i += stride) {
+      if (on_edges) {
+        forEachOutgoingEdge(src_frag, vertices[i], [&](auto& e) {
+          sampled = sampled && impl::sample_row(e.data(), columns);
+        });
+      } else {
+        sampled = impl::sample_row(src_frag->GetData(vertices[i]), columns);
       }
-      case folly::dynamic::Type::STRING: {
-        auto r =
-            VertexArrayBuilder<arrow::LargeStringBuilder>::build(src_frag, key);
+    }
+    if (sampled && impl::is_supported(columns)) {
+      return columns;
+    }
+    return collectColumns(src_frag, on_edges);
+  }
 
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::large_utf8()));
-        arrays.push_back(array);
-        break;
-      }
-      default:
-        RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
-                        "Unsupported dynamic type: " + std::to_string(type));
-      }
+  bl::result<columns_t> collectColumns(
+      const std::shared_ptr<src_fragment_t>& src_frag, bool on_edges) {
+    if (on_edges) {
+      BOOST_LEAF_AUTO(columns, src_frag->CollectPropertyKeysOnEdges());
+      BOOST_LEAF_CHECK(dynamic_to_arrow_converter_impl::check_columns(columns));
+      return columns;
+    }
+    BOOST_LEAF_AUTO(columns, src_frag->CollectPropertyKeysOnVertices());
+    BOOST_LEAF_CHECK(dynamic_to_arrow_converter_impl::check_columns(columns));
+    return columns;
+  }
+
+  bl::result<std::vector<std::shared_ptr<arrow::Array>>> concatenateColumns(
+      std::vector<row_builder_t>& rows, size_t column_num) {
+    std::vector<std::vector<std::shared_ptr<arrow::Array>>> chunks(column_num);
+    for (auto& row : rows) {
+      BOOST_LEAF_CHECK(row.Finish(chunks));
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays;
+    for (auto& column_chunks : chunks) {
+      BOOST_LEAF_AUTO(
+          array, dynamic_to_arrow_converter_impl::concatenate(column_chunks));
+      arrays.push_back(array);
+    }
+    return arrays;
+  }
+
+  // returns false if a vertex doesn't match the columns
+  bool buildVertexRows(const std::shared_ptr<src_fragment_t>& src_frag,
+                       const VertexRanges& ranges, const columns_t& columns,
+                       std::vector<row_builder_t>& rows) {
+    rows.clear();
+    for (size_t tid = 0; tid < ranges.thread_num; ++tid) {
+      rows.emplace_back(columns);
+    }
+    std::atomic<bool> matched(true);
+    dynamic_fragment_impl::parallel_for(
+        0, ranges.thread_num,
+        [&](size_t tid) {
+          auto& row = rows[tid];
+          row.Reserve(ranges.end(tid) - ranges.begin(tid));
+          for (size_t i = ranges.begin(tid); i < ranges.end(tid); ++i) {
+            if (!matched.load(std::memory_order_relaxed) ||
+                !row.Append(src_frag->GetData(ranges.vertices[i]))) {
+              matched = false;
+              return;
+            }
+          }
+        },
+        1);
+    return matched;
+  }
+
+  /**
+   * @brief Builds the vertex table in a single pass by multiple threads, each
+   * of which builds the chunks of a range of the vertices, with the columns
+   * inferred from a sample. The columns of all of the vertices are collected
+   * only if a vertex doesn't match the sample.
+   */
+  bl::result<std::shared_ptr<arrow::Table>> BuildVTable(
+      const std::shared_ptr<src_fragment_t>& src_frag) {
+    VertexRanges ranges(src_frag);
+    BOOST_LEAF_AUTO(columns, sampleColumns(src_frag, ranges, false));
+    std::vector<row_builder_t> rows;
+    if (!buildVertexRows(src_frag, ranges, columns, rows)) {
+      BOOST_LEAF_ASSIGN(columns, collectColumns(src_frag, false));
+      CHECK(buildVertexRows(src_frag, ranges, columns, rows));
+    }
+    BOOST_LEAF_AUTO(arrays, concatenateColumns(rows, columns.size()));
+
+    std::vector<std::shared_ptr<arrow::Field>> schema_vector;
+    for (auto& pair : columns) {
+      schema_vector.push_back(arrow::field(
+          pair.first,
+          dynamic_to_arrow_converter_impl::arrow_type_of(pair.second)));
     }
 
     auto schema = std::make_shared<arrow::Schema>(schema_vector);
@@ -503,57 +511,103 @@ class DynamicToArrowConverter {
     return v_table->ReplaceSchemaMetadata(meta);
   }
 
+  // returns false if an edge doesn't match the columns
+  bool buildEdgeRows(
+      const std::shared_ptr<src_fragment_t>& src_frag,
+      const std::shared_ptr<typename dst_fragment_t::vertex_map_t>& dst_vm,
+      const VertexRanges& ranges, const columns_t& columns,
+      std::vector<row_builder_t>& rows, std::vector<std::vector<vid_t>>& srcs,
+      std::vector<std::vector<vid_t>>& dsts) {
+    using dynamic_oid_t = dynamic_to_arrow_converter_impl::DynamicOid<oid_t>;
+    auto fid = src_frag->fid();
+    rows.clear();
+    for (size_t tid = 0; tid < ranges.thread_num; ++tid) {
+      rows.emplace_back(columns);
+    }
+    srcs.assign(ranges.thread_num, std::vector<vid_t>());
+    dsts.assign(ranges.thread_num, std::vector<vid_t>());
+    std::atomic<bool> matched(true);
+    dynamic_fragment_impl::parallel_for(
+        0, ranges.thread_num,
+        [&](size_t tid) {
+          auto& row = rows[tid];
+          for (size_t i = ranges.begin(tid); i < ranges.end(tid); ++i) {
+            if (!matched.load(std::memory_order_relaxed)) {
+              return;
+            }
+            auto& u = ranges.vertices[i];
+            vineyard::property_graph_types::VID_TYPE u_gid;
+            CHECK(dst_vm->GetGid(fid, 0,
+                                 dynamic_oid_t::get(src_frag->GetId(u)),
+                                 u_gid));
+            forEachOutgoingEdge(src_frag, u, [&](auto& e) {
+              if (!matched.load(std::memory_order_relaxed) ||
+                  !row.Append(e.data())) {
+                matched = false;
+                return;
+              }
+              vineyard::property_graph_types::VID_TYPE v_gid;
+              CHECK(dst_vm->GetGid(
+                  0, dynamic_oid_t::get(src_frag->GetId(e.neighbor())),
+                  v_gid));
+              srcs[tid].push_back(u_gid);
+              dsts[tid].push_back(v_gid);
+            });
+          }
+        },
+        1);
+    return matched;
+  }
+
+  // concatenates the gids of the threads to a single array
+  bl::result<std::shared_ptr<arrow::Array>> buildGidArray(
+      const std::vector<std::vector<vid_t>>& gids) {
+    size_t size = 0;
+    for (auto& chunk : gids) {
+      size += chunk.size();
+    }
+    arrow::UInt64Builder builder;
+    std::shared_ptr<arrow::Array> array;
+    ARROW_OK_OR_RAISE(builder.Reserve(size));
+    for (auto& chunk : gids) {
+      ARROW_OK_OR_RAISE(builder.AppendValues(chunk));
+    }
+    ARROW_OK_OR_RAISE(builder.Finish(&array));
+    return array;
+  }
+
+  /**
+   * @brief Builds the edge table, along with the gids of the endpoints, in a
+   * single pass as BuildVTable does.
+   */
   bl::result<std::shared_ptr<arrow::Table>> BuildETable(
       const std::shared_ptr<src_fragment_t>& src_frag,
       const std::shared_ptr<typename dst_fragment_t::vertex_map_t>& dst_vm) {
+    VertexRanges ranges(src_frag);
+    BOOST_LEAF_AUTO(columns, sampleColumns(src_frag, ranges, true));
+    std::vector<row_builder_t> rows;
+    std::vector<std::vector<vid_t>> srcs, dsts;
+    if (!buildEdgeRows(src_frag, dst_vm, ranges, columns, rows, srcs, dsts)) {
+      BOOST_LEAF_ASSIGN(columns, collectColumns(src_frag, true));
+      CHECK(buildEdgeRows(src_frag, dst_vm, ranges, columns, rows, srcs, dsts));
+    }
+    BOOST_LEAF_AUTO(src_array, buildGidArray(srcs));
+    BOOST_LEAF_AUTO(dst_array, buildGidArray(dsts));
+    CHECK_EQ(src_array->length(), dst_array->length());
+    BOOST_LEAF_AUTO(prop_arrays, concatenateColumns(rows, columns.size()));
+
     std::vector<std::shared_ptr<arrow::Field>> schema_vector = {
         std::make_shared<arrow::Field>("src", arrow::uint64()),
         std::make_shared<arrow::Field>("dst", arrow::uint64())};
-    auto inner_vertices = src_frag->InnerVertices();
-    COOBuilder<dst_fragment_t, oid_t> builder;
-    BOOST_LEAF_AUTO(src_dst_array, builder.Build(src_frag, dst_vm));
-    std::shared_ptr<arrow::Array> src_array = src_dst_array.first,
-                                  dst_array = src_dst_array.second;
-    CHECK_EQ(src_array->length(), dst_array->length());
     std::vector<std::shared_ptr<arrow::Array>> arrays{src_array, dst_array};
-
-    BOOST_LEAF_AUTO(prop_keys, src_frag->CollectPropertyKeysOnEdges());
-    // build schema and array
-    for (const auto& e : prop_keys) {
-      auto key = e.first;
-      auto type = e.second;
-
-      switch (type) {
-      case folly::dynamic::Type::INT64: {
-        auto r = EdgeArrayBuilder<arrow::Int64Builder>::build(src_frag, key);
-
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::int64()));
-        CHECK_EQ(array->length(), src_array->length());
-        arrays.push_back(array);
-        break;
-      }
-      case folly::dynamic::Type::DOUBLE: {
-        auto r = EdgeArrayBuilder<arrow::DoubleBuilder>::build(src_frag, key);
-
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::float64()));
-        arrays.push_back(array);
-        break;
-      }
-      case folly::dynamic::Type::STRING: {
-        auto r =
-            EdgeArrayBuilder<arrow::LargeStringBuilder>::build(src_frag, key);
-
-        BOOST_LEAF_AUTO(array, r);
-        schema_vector.push_back(arrow::field(key, arrow::large_utf8()));
-        arrays.push_back(array);
-        break;
-      }
-      default:
-        RETURN_GS_ERROR(vineyard::ErrorCode::kDataTypeError,
-                        "Unsupported dynamic type: " + std::to_string(type));
-      }
+    for (auto& pair : columns) {
+      schema_vector.push_back(arrow::field(
+          pair.first,
+          dynamic_to_arrow_converter_impl::arrow_type_of(pair.second)));
+    }
+    for (auto& array : prop_arrays) {
+      CHECK_EQ(array->length(), src_array->length());
+      arrays.push_back(array);
     }
 
     auto schema = std::make_shared<arrow::Schema>(schema_vector);
@@ -0,0 +1,137 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_LOAD_PROFILE_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_LOAD_PROFILE_H_
+
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+
+namespace gs {
+
+/**
+ * @brief The timings of the phases of loading a fragment on a worker. Besides
+ * the wall time, the cpu time of the process in a phase is recorded, of
+ * which the ratio to the wall time is the number of busy threads, and the
+ * rows and bytes of the tables the phase reads or consumes, e.g., the bytes
+ * of the local tables to shuffle.
+ */
+class LoadProfile {
+  using clock_t = std::chrono::steady_clock;
+
+ public:
+  struct Phase {
+    std::string name;
+    double wall_time = 0;
+    double cpu_time = 0;
+    int64_t rows = 0;
+    int64_t bytes = 0;
+
+    // the average number of busy threads in the phase
+    double utilization() const {
+      return wall_time > 0 ? cpu_time / wall_time : 0;
+    }
+  };
+
+  struct Mark {
+    clock_t::time_point wall;
+    double cpu;
+  };
+
+  Mark Start() const { return Mark{clock_t::now(), cpuTime()}; }
+
+  void Finish(const std::string& name, const Mark& start, int64_t rows = 0,
+              int64_t bytes = 0) {
+    Phase phase;
+    phase.name = name;
+    phase.wall_time =
+        std::chrono::duration<double>(clock_t::now() - start.wall).count();
+    phase.cpu_time = cpuTime() - start.cpu;
+    phase.rows = rows;
+    phase.bytes = bytes;
+    phases_.push_back(phase);
+  }
+
+  void Clear() { phases_.clear(); }
+
+  const std::vector<Phase>& phases() const { return phases_; }
+
+  std::string ToJSON() const {
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < phases_.size(); ++i) {
+      auto& phase = phases_[i];
+      os << (i == 0 ? "" : ", ") << "{\"name\": \"" << phase.name
+         << "\", \"wall_time\": " << phase.wall_time
+         << ", \"cpu_time\": " << phase.cpu_time
+         << ", \"utilization\": " << phase.utilization()
+         << ", \"rows\": " << phase.rows << ", \"bytes\": " << phase.bytes
+         << "}";
+    }
+    os << "]";
+    return os.str();
+  }
+
+  // the size of the buffers of the table, of which the slices are counted
+  // by the whole buffers
+  static int64_t TableBytes(const std::shared_ptr<arrow::Table>& table) {
+    int64_t bytes = 0;
+    if (table == nullptr) {
+      return bytes;
+    }
+    for (auto const& column : table->columns()) {
+      for (auto const& chunk : column->chunks()) {
+        bytes += arrayBytes(chunk->data());
+      }
+    }
+    return bytes;
+  }
+
+ private:
+  static int64_t arrayBytes(const std::shared_ptr<arrow::ArrayData>& data) {
+    int64_t bytes = 0;
+    for (auto const& buffer : data->buffers) {
+      if (buffer != nullptr) {
+        bytes += buffer->size();
+      }
+    }
+    for (auto const& child : data->child_data) {
+      bytes += arrayBytes(child);
+    }
+    return bytes;
+  }
+
+  static double cpuTime() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+  }
+
+  std::vector<Phase> phases_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_LOAD_PROFILE_H_
@@ -0,0 +1,593 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_LOADER_PROPERTY_ENCODER_H_
+#define ANALYTICAL_ENGINE_CORE_LOADER_PROPERTY_ENCODER_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "arrow/api.h"
+
+#include "grape/communication/communicator.h"
+#include "grape/worker/comm_spec.h"
+#include "vineyard/basic/ds/arrow_utils.h"
+#include "vineyard/common/util/status.h"
+
+namespace gs {
+
+/**
+ * The keys of the metadata of an encoded field, i.e., the encoding, the type
+ * of the values, and the base of the integers or the dictionary of the
+ * strings. The global store decodes the fields by the same keys.
+ */
+static constexpr const char* kPropertyEncodingKey = "gs.encoding";
+static constexpr const char* kPropertyEncodingTypeKey = "gs.encoding.type";
+static constexpr const char* kPropertyEncodingBaseKey = "gs.encoding.base";
+static constexpr const char* kPropertyEncodingDictionaryKey =
+    "gs.encoding.dictionary";
+static constexpr const char* kDictionaryEncoding = "dictionary";
+static constexpr const char* kFrameOfReferenceEncoding = "frame_of_reference";
+
+struct PropertyEncodingOptions {
+  // the string columns of at most this many distinct values, of at most
+  // max_dictionary_bytes, are dictionary encoded
+  size_t max_dictionary_size = 4096;
+  size_t max_dictionary_bytes = 1 << 20;
+};
+
+namespace property_encoder_impl {
+
+// the dictionary as the values each prefixed by its length and ':'
+inline std::string pack_dictionary(const std::vector<std::string>& values) {
+  std::string packed;
+  for (auto& value : values) {
+    packed += std::to_string(value.size());
+    packed += ':';
+    packed += value;
+  }
+  return packed;
+}
+
+inline bool unpack_dictionary(const std::string& packed,
+                              std::vector<std::string>& values) {
+  size_t pos = 0;
+  while (pos < packed.size()) {
+    size_t colon = packed.find(':', pos);
+    if (colon == std::string::npos) {
+      return false;
+    }
+    size_t length = std::stoull(packed.substr(pos, colon - pos));
+    if (colon + 1 + length > packed.size()) {
+      return false;
+    }
+    values.emplace_back(packed.substr(colon + 1, length));
+    pos = colon + 1 + length;
+  }
+  return true;
+}
+
+inline std::string metadata_value(const std::shared_ptr<arrow::Field>& field,
+                                  const std::string& key) {
+  auto metadata = field->metadata();
+  if (metadata == nullptr) {
+    return "";
+  }
+  int index = metadata->FindKey(key);
+  return index == -1 ? "" : metadata->value(index);
+}
+
+inline std::shared_ptr<arrow::DataType> type_of(const std::string& name) {
+  if (name == "string") {
+    return arrow::utf8();
+  } else if (name == "large_string") {
+    return arrow::large_utf8();
+  } else if (name == "int32") {
+    return arrow::int32();
+  } else if (name == "int64") {
+    return arrow::int64();
+  }
+  return nullptr;
+}
+
+// the narrowest of int8, int16 and int32 of the codes in [0, max_code],
+// which are stored from the lowest value of the type, or null if none is
+inline std::shared_ptr<arrow::DataType> code_type(uint64_t max_code) {
+  if (max_code <= std::numeric_limits<uint8_t>::max()) {
+    return arrow::int8();
+  } else if (max_code <= std::numeric_limits<uint16_t>::max()) {
+    return arrow::int16();
+  } else if (max_code <= std::numeric_limits<uint32_t>::max()) {
+    return arrow::int32();
+  }
+  return nullptr;
+}
+
+inline int64_t byte_width(const std::shared_ptr<arrow::DataType>& type) {
+  return std::static_pointer_cast<arrow::FixedWidthType>(type)->bit_width() /
+         8;
+}
+
+inline int64_t code_lowest(const std::shared_ptr<arrow::DataType>& type) {
+  if (type->Equals(arrow::int8())) {
+    return std::numeric_limits<int8_t>::lowest();
+  } else if (type->Equals(arrow::int16())) {
+    return std::numeric_limits<int16_t>::lowest();
+  }
+  return std::numeric_limits<int32_t>::lowest();
+}
+
+// calls func(i, code) for the codes of the array
+template <typename FUNC_T>
+void for_each_code(const std::shared_ptr<arrow::Array>& array,
+                   const FUNC_T& func) {
+  auto visit = [&](auto typed_array) {
+    for (int64_t i = 0; i < typed_array->length(); ++i) {
+      func(i, static_cast<int64_t>(typed_array->Value(i)));
+    }
+  };
+  switch (array->type_id()) {
+  case arrow::Type::INT8:
+    visit(std::static_pointer_cast<arrow::Int8Array>(array));
+    break;
+  case arrow::Type::INT16:
+    visit(std::static_pointer_cast<arrow::Int16Array>(array));
+    break;
+  case arrow::Type::INT32:
+    visit(std::static_pointer_cast<arrow::Int32Array>(array));
+    break;
+  default:
+    break;
+  }
+}
+
+// builds the array of the codes of type from func(i) for i in [0, length)
+template <typename FUNC_T>
+vineyard::Status build_codes(const std::shared_ptr<arrow::DataType>& type,
+                             int64_t length, const FUNC_T& func,
+                             std::shared_ptr<arrow::Array>& array) {
+  auto build = [&](auto& builder) -> vineyard::Status {
+    using value_t = typename std::decay_t<decltype(builder)>::value_type;
+    RETURN_ON_ARROW_ERROR(builder.Reserve(length));
+    for (int64_t i = 0; i < length; ++i) {
+      builder.UnsafeAppend(static_cast<value_t>(func(i)));
+    }
+    RETURN_ON_ARROW_ERROR(builder.Finish(&array));
+    return vineyard::Status::OK();
+  };
+  if (type->Equals(arrow::int8())) {
+    arrow::Int8Builder builder;
+    return build(builder);
+  } else if (type->Equals(arrow::int16())) {
+    arrow::Int16Builder builder;
+    return build(builder);
+  }
+  arrow::Int32Builder builder;
+  return build(builder);
+}
+
+// calls func(view) for the values of the string array, of either type
+template <typename FUNC_T>
+void for_each_string(const std::shared_ptr<arrow::Array>& array,
+                     const FUNC_T& func) {
+  if (array->type()->Equals(arrow::utf8())) {
+    auto typed_array = std::static_pointer_cast<arrow::StringArray>(array);
+    for (int64_t i = 0; i < typed_array->length(); ++i) {
+      func(typed_array->GetView(i));
+    }
+  } else {
+    auto typed_array = std::static_pointer_cast<arrow::LargeStringArray>(array);
+    for (int64_t i = 0; i < typed_array->length(); ++i) {
+      func(typed_array->GetView(i));
+    }
+  }
+}
+
+}  // namespace property_encoder_impl
+
+/**
+ * @brief Whether the field is encoded by PropertyEncoder.
+ */
+inline bool IsEncodedField(const std::shared_ptr<arrow::Field>& field) {
+  return !property_encoder_impl::metadata_value(field, kPropertyEncodingKey)
+              .empty();
+}
+
+/**
+ * @brief The type of the values of the field, i.e., the one before encoding
+ * if encoded.
+ */
+inline std::shared_ptr<arrow::DataType> DecodedFieldType(
+    const std::shared_ptr<arrow::Field>& field) {
+  if (!IsEncodedField(field)) {
+    return field->type();
+  }
+  auto type = property_encoder_impl::type_of(
+      property_encoder_impl::metadata_value(field, kPropertyEncodingTypeKey));
+  return type == nullptr ? field->type() : type;
+}
+
+/**
+ * @brief Decodes the array of the codes of the encoded field to the values,
+ * or returns the array itself if the field is not encoded.
+ */
+inline vineyard::Status DecodeColumn(const std::shared_ptr<arrow::Field>& field,
+                                     const std::shared_ptr<arrow::Array>& codes,
+                                     std::shared_ptr<arrow::Array>& values) {
+  using property_encoder_impl::metadata_value;
+  std::string encoding = metadata_value(field, kPropertyEncodingKey);
+  if (encoding.empty()) {
+    values = codes;
+    return vineyard::Status::OK();
+  }
+  auto type = DecodedFieldType(field);
+  if (encoding == kFrameOfReferenceEncoding) {
+    auto base = static_cast<uint64_t>(
+        std::stoll(metadata_value(field, kPropertyEncodingBaseKey)));
+    auto decode = [&](auto& builder) -> vineyard::Status {
+      using value_t = typename std::decay_t<decltype(builder)>::value_type;
+      RETURN_ON_ARROW_ERROR(builder.Reserve(codes->length()));
+      property_encoder_impl::for_each_code(codes, [&](int64_t, int64_t code) {
+        builder.UnsafeAppend(static_cast<value_t>(
+            static_cast<int64_t>(static_cast<uint64_t>(code) + base)));
+      });
+      RETURN_ON_ARROW_ERROR(builder.Finish(&values));
+      return vineyard::Status::OK();
+    };
+    if (type->Equals(arrow::int32())) {
+      arrow::Int32Builder builder;
+      return decode(builder);
+    }
+    arrow::Int64Builder builder;
+    return decode(builder);
+  } else if (encoding == kDictionaryEncoding) {
+    std::vector<std::string> dictionary;
+    if (!property_encoder_impl::unpack_dictionary(
+            metadata_value(field, kPropertyEncodingDictionaryKey),
+            dictionary)) {
+      return vineyard::Status::Invalid("Invalid dictionary of the field " +
+                                       field->name());
+    }
+    auto decode = [&](auto& builder) -> vineyard::Status {
+      RETURN_ON_ARROW_ERROR(builder.Reserve(codes->length()));
+      vineyard::Status status;
+      int64_t lowest = property_encoder_impl::code_lowest(codes->type());
+      property_encoder_impl::for_each_code(codes, [&](int64_t, int64_t code) {
+        auto index = static_cast<size_t>(code - lowest);
+        if (!status.ok()) {
+          return;
+        } else if (index >= dictionary.size()) {
+          status = vineyard::Status::Invalid("Invalid code of the field " +
+                                             field->name());
+        } else {
+          status = vineyard::Status::ArrowError(
+              builder.Append(dictionary[index]));
+        }
+      });
+      RETURN_ON_ERROR(status);
+      RETURN_ON_ARROW_ERROR(builder.Finish(&values));
+      return vineyard::Status::OK();
+    };
+    if (type->Equals(arrow::utf8())) {
+      arrow::StringBuilder builder;
+      return decode(builder);
+    }
+    arrow::LargeStringBuilder builder;
+    return decode(builder);
+  }
+  return vineyard::Status::Invalid("Unknown encoding of the field " +
+                                   field->name() + ": " + encoding);
+}
+
+/**
+ * @brief The table of the decoded columns of the encoded fields, without the
+ * metadata of the encodings, or the table itself if none is encoded.
+ */
+inline vineyard::Status DecodeTable(const std::shared_ptr<arrow::Table>& table,
+                                    std::shared_ptr<arrow::Table>& decoded) {
+  decoded = table;
+  for (int i = 0; i < table->num_columns(); ++i) {
+    auto field = table->field(i);
+    if (!IsEncodedField(field)) {
+      continue;
+    }
+    arrow::ArrayVector chunks;
+    for (auto& chunk : table->column(i)->chunks()) {
+      std::shared_ptr<arrow::Array> values;
+      RETURN_ON_ERROR(DecodeColumn(field, chunk, values));
+      chunks.push_back(values);
+    }
+    auto column =
+        std::make_shared<arrow::ChunkedArray>(chunks, DecodedFieldType(field));
+    auto decoded_field = arrow::field(field->name(), DecodedFieldType(field));
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    RETURN_ON_ARROW_ERROR(decoded->SetColumn(i, decoded_field, column,
+                                             &decoded));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(
+        decoded, decoded->SetColumn(i, decoded_field, column));
+#endif
+  }
+  return vineyard::Status::OK();
+}
+
+/**
+ * @brief Fails if the property prop_id of the table is encoded, for the
+ * readers of the raw columns, e.g., the projected fragments, which would
+ * otherwise see the codes as the values. A prop_id of -1 is no property.
+ */
+inline vineyard::Status CheckUnencodedProperty(
+    const std::shared_ptr<arrow::Table>& table, int prop_id,
+    const std::string& kind) {
+  if (prop_id == -1 || !IsEncodedField(table->field(prop_id))) {
+    return vineyard::Status::OK();
+  }
+  return vineyard::Status::Invalid(
+      kind + " property " + table->field(prop_id)->name() +
+      " is encoded by compress_properties and can't be projected, load the "
+      "graph without compress_properties");
+}
+
+/**
+ * @brief Encodes the property columns of the tables before they are sealed
+ * into a fragment, i.e., the strings of at most
+ * PropertyEncodingOptions::max_dictionary_size distinct values to the codes
+ * of a sorted dictionary, and the int32 and int64 values to the offsets from
+ * their minimum, in the narrowest of int8, int16 and int32. The encoding and
+ * the dictionary or the base are kept in the metadata of the field, see
+ * DecodeColumn. Bit packing below a byte is not applied, as the columns
+ * remain arrow arrays.
+ *
+ * The columns are encoded by all the workers together, as the tables of a
+ * label are shuffled among them and sealed of the same schema, i.e., the
+ * dictionaries are the union of the local ones, and the bases the global
+ * minimums. The columns with nulls, and the ones not smaller encoded, are
+ * kept as they are.
+ */
+class PropertyEncoder {
+ public:
+  explicit PropertyEncoder(const grape::CommSpec& comm_spec,
+                           const PropertyEncodingOptions& options = {})
+      : options_(options) {
+    communicator_.InitCommunicator(comm_spec.comm());
+  }
+
+  /**
+   * @brief Encodes the columns after the first key_columns of the tables,
+   * e.g., the id of the vertices or the src and dst of the edges, which are of
+   * the same schema, e.g., the sub labels of an edge label, and the same on
+   * all the workers. Returns the number of the encoded columns.
+   */
+  vineyard::Status Encode(std::vector<std::shared_ptr<arrow::Table>>& tables,
+                          int key_columns, int& encoded) {
+    encoded = 0;
+    if (tables.empty()) {
+      return vineyard::Status::OK();
+    }
+    auto schema = tables[0]->schema();
+    for (int i = key_columns; i < schema->num_fields(); ++i) {
+      auto type = schema->field(i)->type();
+      bool same_type = true;
+      for (auto& table : tables) {
+        same_type &= table->num_columns() > i &&
+                     table->field(i)->type()->Equals(type) &&
+                     !IsEncodedField(table->field(i));
+      }
+      // the types are synced among the workers, so the columns are skipped
+      // by all of them
+      if (!same_type) {
+        continue;
+      }
+      bool done = false;
+      if (type->Equals(arrow::utf8()) || type->Equals(arrow::large_utf8())) {
+        RETURN_ON_ERROR(encodeStrings(tables, i, done));
+      } else if (type->Equals(arrow::int32()) ||
+                 type->Equals(arrow::int64())) {
+        RETURN_ON_ERROR(encodeIntegers(tables, i, done));
+      }
+      encoded += done;
+    }
+    return vineyard::Status::OK();
+  }
+
+ private:
+  vineyard::Status encodeStrings(
+      std::vector<std::shared_ptr<arrow::Table>>& tables, int col_id,
+      bool& done) {
+    // the local distinct values, or none if too many
+    std::set<std::string> local_values;
+    int local_ok = 1;
+    int64_t local_bytes = 0, local_rows = 0;
+    for (auto& table : tables) {
+      for (auto& chunk : table->column(col_id)->chunks()) {
+        local_ok &= chunk->null_count() == 0;
+        local_rows += chunk->length();
+        property_encoder_impl::for_each_string(chunk, [&](auto view) {
+          local_bytes += view.size() + sizeof(int64_t);
+          if (local_ok &&
+              local_values.emplace(view.data(), view.size()).second &&
+              local_values.size() > options_.max_dictionary_size) {
+            local_ok = 0;
+          }
+        });
+      }
+    }
+    int ok = 0;
+    communicator_.Min(local_ok, ok);
+    if (!ok) {
+      return vineyard::Status::OK();
+    }
+    std::vector<std::vector<std::string>> all_values;
+    communicator_.AllGather(
+        std::vector<std::string>(local_values.begin(), local_values.end()),
+        all_values);
+    std::set<std::string> values;
+    for (auto& sub_values : all_values) {
+      values.insert(sub_values.begin(), sub_values.end());
+    }
+    std::vector<std::string> dictionary(values.begin(), values.end());
+    std::string packed = property_encoder_impl::pack_dictionary(dictionary);
+    int64_t bytes = 0, rows = 0;
+    communicator_.Sum(local_bytes, bytes);
+    communicator_.Sum(local_rows, rows);
+    if (dictionary.empty()) {
+      return vineyard::Status::OK();
+    }
+    auto type = property_encoder_impl::code_type(dictionary.size() - 1);
+    if (dictionary.size() > options_.max_dictionary_size ||
+        packed.size() > options_.max_dictionary_bytes || type == nullptr ||
+        rows * property_encoder_impl::byte_width(type) +
+                static_cast<int64_t>(packed.size()) >=
+            bytes) {
+      return vineyard::Status::OK();
+    }
+
+    auto metadata = arrow::key_value_metadata(
+        {kPropertyEncodingKey, kPropertyEncodingTypeKey,
+         kPropertyEncodingDictionaryKey},
+        {kDictionaryEncoding, tables[0]->field(col_id)->type()->ToString(),
+         packed});
+    int64_t lowest = property_encoder_impl::code_lowest(type);
+    for (auto& table : tables) {
+      arrow::ArrayVector chunks;
+      for (auto& chunk : table->column(col_id)->chunks()) {
+        std::vector<int64_t> codes;
+        codes.reserve(chunk->length());
+        property_encoder_impl::for_each_string(chunk, [&](auto view) {
+          auto iter = std::lower_bound(
+              dictionary.begin(), dictionary.end(), view,
+              [](const std::string& value, const decltype(view)& key) {
+                return value.compare(0, value.size(), key.data(),
+                                     key.size()) < 0;
+              });
+          codes.push_back(lowest + (iter - dictionary.begin()));
+        });
+        std::shared_ptr<arrow::Array> array;
+        RETURN_ON_ERROR(property_encoder_impl::build_codes(
+            type, codes.size(), [&codes](int64_t i) { return codes[i]; },
+            array));
+        chunks.push_back(array);
+      }
+      RETURN_ON_ERROR(replaceColumn(table, col_id, type, metadata, chunks));
+    }
+    done = true;
+    return vineyard::Status::OK();
+  }
+
+  vineyard::Status encodeIntegers(
+      std::vector<std::shared_ptr<arrow::Table>>& tables, int col_id,
+      bool& done) {
+    int local_ok = 1;
+    int64_t local_min = std::numeric_limits<int64_t>::max();
+    int64_t local_max = std::numeric_limits<int64_t>::lowest();
+    int64_t local_rows = 0;
+    auto visit = [&](const std::shared_ptr<arrow::Array>& chunk,
+                     const auto& func) {
+      if (chunk->type()->Equals(arrow::int32())) {
+        auto typed_array = std::static_pointer_cast<arrow::Int32Array>(chunk);
+        for (int64_t i = 0; i < typed_array->length(); ++i) {
+          func(i, static_cast<int64_t>(typed_array->Value(i)));
+        }
+      } else {
+        auto typed_array = std::static_pointer_cast<arrow::Int64Array>(chunk);
+        for (int64_t i = 0; i < typed_array->length(); ++i) {
+          func(i, typed_array->Value(i));
+        }
+      }
+    };
+    for (auto& table : tables) {
+      for (auto& chunk : table->column(col_id)->chunks()) {
+        local_ok &= chunk->null_count() == 0;
+        local_rows += chunk->length();
+        visit(chunk, [&](int64_t, int64_t value) {
+          local_min = std::min(local_min, value);
+          local_max = std::max(local_max, value);
+        });
+      }
+    }
+    int ok = 0;
+    int64_t min_value = 0, max_value = 0, rows = 0;
+    communicator_.Min(local_ok, ok);
+    communicator_.Min(local_min, min_value);
+    communicator_.Max(local_max, max_value);
+    communicator_.Sum(local_rows, rows);
+    if (!ok || rows == 0) {
+      return vineyard::Status::OK();
+    }
+    auto value_type = tables[0]->field(col_id)->type();
+    auto type = property_encoder_impl::code_type(
+        static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value));
+    if (type == nullptr || property_encoder_impl::byte_width(type) >=
+                               property_encoder_impl::byte_width(value_type)) {
+      return vineyard::Status::OK();
+    }
+
+    // the values are the codes plus the base, modulo 2^64
+    uint64_t base =
+        static_cast<uint64_t>(min_value) -
+        static_cast<uint64_t>(property_encoder_impl::code_lowest(type));
+    auto metadata = arrow::key_value_metadata(
+        {kPropertyEncodingKey, kPropertyEncodingTypeKey,
+         kPropertyEncodingBaseKey},
+        {kFrameOfReferenceEncoding, value_type->ToString(),
+         std::to_string(static_cast<int64_t>(base))});
+    for (auto& table : tables) {
+      arrow::ArrayVector chunks;
+      for (auto& chunk : table->column(col_id)->chunks()) {
+        std::vector<int64_t> codes(chunk->length());
+        visit(chunk, [&](int64_t i, int64_t value) {
+          codes[i] = static_cast<int64_t>(static_cast<uint64_t>(value) - base);
+        });
+        std::shared_ptr<arrow::Array> array;
+        RETURN_ON_ERROR(property_encoder_impl::build_codes(
+            type, codes.size(), [&codes](int64_t i) { return codes[i]; },
+            array));
+        chunks.push_back(array);
+      }
+      RETURN_ON_ERROR(replaceColumn(table, col_id, type, metadata, chunks));
+    }
+    done = true;
+    return vineyard::Status::OK();
+  }
+
+  static vineyard::Status replaceColumn(
+      std::shared_ptr<arrow::Table>& table, int col_id,
+      const std::shared_ptr<arrow::DataType>& type,
+      const std::shared_ptr<const arrow::KeyValueMetadata>& metadata,
+      const arrow::ArrayVector& chunks) {
+    auto name = table->field(col_id)->name();
+    auto field = arrow::field(name, type)->WithMetadata(metadata);
+    auto column = std::make_shared<arrow::ChunkedArray>(chunks, type);
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    RETURN_ON_ARROW_ERROR(table->SetColumn(col_id, field, column, &table));
+#else
+    RETURN_ON_ARROW_ERROR_AND_ASSIGN(table,
+                                     table->SetColumn(col_id, field, column));
+#endif
+    return vineyard::Status::OK();
+  }
+
+  PropertyEncodingOptions options_;
+  grape::Communicator communicator_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_LOADER_PROPERTY_ENCODER_H_
@@ -95,6 +95,8 @@ class AppEntry : public GSObject {
     return ctx_wrapper;
   }
 
+  const std::string& lib_path() const { return lib_path_; }
+
  private:
   std::string lib_path_;
   void* dl_handle_;
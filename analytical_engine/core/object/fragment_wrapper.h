@@ -26,12 +26,15 @@
 #include "vineyard/graph/utils/grape_utils.h"
 
 #include "core/context/labeled_vertex_property_context.h"
+#include "core/context/tensor_dataframe_builder.h"
 #include "core/context/vertex_data_context.h"
 #include "core/context/vertex_property_context.h"
 #include "core/error.h"
+#include "core/fragment/arrow_flattened_fragment.h"
 #include "core/fragment/dynamic_fragment_view.h"
 #include "core/fragment/dynamic_projected_fragment.h"
 #include "core/loader/arrow_fragment_loader.h"
+#include "core/loader/arrow_fragment_rebalancer.h"
 #include "core/object/gs_object.h"
 #include "core/object/i_fragment_wrapper.h"
 #include "core/utils/transform_utils.h"
@@ -90,6 +93,8 @@ class FragmentWrapper<vineyard::ArrowFragment<OID_T, VID_T>>
 
   const rpc::GraphDef& graph_def() const override { return graph_def_; }
 
+  size_t MemoryUsage() const override { return fragment_->meta().GetNBytes(); }
+
   bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
       const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
       const std::string& copy_type) override {
@@ -277,6 +282,37 @@ class FragmentWrapper<vineyard::ArrowFragment<OID_T, VID_T>>
     return std::dynamic_pointer_cast<ILabeledFragmentWrapper>(wrapper);
   }
 
+  void DeleteProjectionObjects(vineyard::Client& client) override {
+    DeleteSharedProjectionArrays(client, *fragment_);
+  }
+
+  bl::result<std::shared_ptr<ILabeledFragmentWrapper>> Rebalance(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& strategy) override {
+    auto& meta = fragment_->meta();
+    auto* client = dynamic_cast<vineyard::Client*>(meta.GetClient());
+    BOOST_LEAF_AUTO(partition_strategy, ParsePartitionStrategy(strategy));
+    ArrowFragmentRebalancer<OID_T, VID_T> rebalancer(*client, comm_spec,
+                                                     fragment_);
+    BOOST_LEAF_AUTO(new_frag_id, rebalancer.Rebalance(partition_strategy));
+    VINEYARD_CHECK_OK(client->Persist(new_frag_id));
+    BOOST_LEAF_AUTO(frag_group_id, vineyard::ConstructFragmentGroup(
+                                       *client, new_frag_id, comm_spec));
+    auto new_frag = client->GetObject<fragment_t>(new_frag_id);
+
+    rpc::GraphDef new_graph_def;
+
+    new_graph_def.set_key(dst_graph_name);
+    new_graph_def.set_vineyard_id(frag_group_id);
+    new_graph_def.set_generate_eid(graph_def_.generate_eid());
+
+    set_graph_def(new_frag, new_graph_def);
+
+    auto wrapper = std::make_shared<FragmentWrapper<fragment_t>>(
+        dst_graph_name, new_graph_def, new_frag);
+    return std::dynamic_pointer_cast<ILabeledFragmentWrapper>(wrapper);
+  }
+
   bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const LabeledSelector& selector,
       const std::pair<std::string, std::string>& range) override {
@@ -361,6 +397,7 @@ class FragmentWrapper<vineyard::ArrowFragment<OID_T, VID_T>>
                  comm_spec.FragToWorker(0), comm_spec.comm());
     }
 
+    std::vector<std::pair<size_t, size_t>> columns;
     for (auto& pair : selectors) {
       auto& col_name = pair.first;
       auto& selector = pair.second;
@@ -398,11 +435,69 @@ class FragmentWrapper<vineyard::ArrowFragment<OID_T, VID_T>>
                 selector.str());
       }
 
-      gather_archives(*arc, comm_spec, old_size);
+      columns.emplace_back(old_size, arc->GetSize());
     }
+    gather_columns(*arc, comm_spec, columns);
     return std::move(arc);
   }
 
+  bl::result<vineyard::ObjectID> ToVineyardDataframe(
+      const grape::CommSpec& comm_spec, vineyard::Client& client,
+      const std::vector<std::pair<std::string, LabeledSelector>>& selectors,
+      const std::pair<std::string, std::string>& range) override {
+    TransformUtils<fragment_t> trans_utils(comm_spec, *fragment_);
+
+    BOOST_LEAF_AUTO(label_id, LabeledSelector::GetVertexLabelId(selectors));
+    auto vertices = trans_utils.SelectVertices(label_id, range);
+
+    vineyard::DataFrameBuilder df_builder(client);
+
+    df_builder.set_partition_index(comm_spec.fid(), 0);
+    df_builder.set_row_batch_index(comm_spec.fid());
+
+    // the chunks of the columns are filled in parallel, and stay in the
+    // vineyardd of the worker without gathering
+    for (auto& pair : selectors) {
+      auto& col_name = pair.first;
+      auto& selector = pair.second;
+
+      switch (selector.type()) {
+      case SelectorType::kVertexId: {
+        BOOST_LEAF_AUTO(tensor_builder, trans_utils.VertexIdToVYTensorBuilder(
+                                            client, vertices));
+        df_builder.AddColumn(col_name, tensor_builder);
+        break;
+      }
+      case SelectorType::kVertexData: {
+        BOOST_LEAF_AUTO(tensor_builder,
+                        trans_utils.VertexPropertyToVYTensorBuilder(
+                            client, label_id, selector.property_id(),
+                            vertices));
+        df_builder.AddColumn(col_name, tensor_builder);
+        break;
+      }
+      default:
+        RETURN_GS_ERROR(
+            vineyard::ErrorCode::kUnsupportedOperationError,
+            "Unsupported operation, available selector type: vid,vdata. "
+            "selector: " +
+                selector.str());
+      }
+    }
+
+    auto df = df_builder.Seal(client);
+    VY_OK_OR_RAISE(df->Persist(client));
+    auto df_chunk_id = df->id();
+
+    MPIGlobalDataFrameBuilder builder(client, comm_spec);
+    builder.set_partition_shape(comm_spec.fnum(), selectors.size());
+    builder.AddChunk(df_chunk_id);
+
+    auto vy_obj = builder.Seal(client);
+
+    return vy_obj->id();
+  }
+
   bl::result<std::shared_ptr<IFragmentWrapper>> ToDirected(
       const grape::CommSpec& comm_spec,
       const std::string& dst_graph_name) override {
@@ -452,8 +547,27 @@ class FragmentWrapper<ArrowProjectedFragment<OID_T, VID_T, VDATA_T, EDATA_T>>
     return std::static_pointer_cast<void>(fragment_);
   }
 
+  vineyard::ObjectID local_vineyard_id() const override {
+    return fragment_->id();
+  }
+
   const rpc::GraphDef& graph_def() const override { return graph_def_; }
 
+  // the blobs of the projection, without those of the fragment it is
+  // projected from
+  size_t MemoryUsage() const override {
+    auto& meta = fragment_->meta();
+    auto parent_meta = meta.GetMemberMeta("arrow_fragment");
+    auto& parent_buffers = parent_meta.GetBufferSet();
+    size_t nbytes = 0;
+    for (auto& pair : meta.GetBufferSet()->AllBuffers()) {
+      if (pair.second != nullptr && !parent_buffers->Contains(pair.first)) {
+        nbytes += pair.second->size();
+      }
+    }
+    return nbytes;
+  }
+
   bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
       const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
       const std::string& copy_type) override {
@@ -487,6 +601,66 @@ class FragmentWrapper<ArrowProjectedFragment<OID_T, VID_T, VDATA_T, EDATA_T>>
   std::shared_ptr<fragment_t> fragment_;
 };
 
+/**
+ * @brief A specialized FragmentWrapper for ArrowFlattenedFragment.
+ * @tparam OID_T OID type
+ * @tparam VID_T VID type
+ */
+template <typename OID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class FragmentWrapper<ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>>
+    : public IFragmentWrapper {
+  using fragment_t = ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>;
+
+ public:
+  FragmentWrapper(const std::string& id, rpc::GraphDef graph_def,
+                  std::shared_ptr<fragment_t> fragment)
+      : IFragmentWrapper(id),
+        graph_def_(std::move(graph_def)),
+        fragment_(std::move(fragment)) {
+    CHECK_EQ(graph_def_.graph_type(), rpc::ARROW_FLATTENED);
+  }
+
+  std::shared_ptr<void> fragment() const override {
+    return std::static_pointer_cast<void>(fragment_);
+  }
+
+  const rpc::GraphDef& graph_def() const override { return graph_def_; }
+
+  size_t MemoryUsage() const override { return fragment_->MemoryUsage(); }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& copy_type) override {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Can not copy ArrowFlattenedFragment");
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Can not to directed ArrowFlattenedFragment");
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToUnDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Can not to undirected ArrowFlattenedFragment");
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CreateGraphView(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& copy_type) override {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "Can not view ArrowFlattenedFragment");
+  }
+
+ private:
+  rpc::GraphDef graph_def_;
+  std::shared_ptr<fragment_t> fragment_;
+};
+
 #ifdef NETWORKX
 /**
  * @brief A specialized FragmentWrapper for DynamicFragment.
@@ -516,31 +690,9 @@ class FragmentWrapper<DynamicFragment> : public IFragmentWrapper {
   bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
       const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
       const std::string& copy_type) override {
-    // copy vertex map
-    auto ori_vm_ptr = fragment_->GetVertexMap();
-    auto new_vm_ptr =
-        std::make_shared<typename fragment_t::vertex_map_t>(comm_spec);
-    new_vm_ptr->Init();
-    std::vector<std::thread> copy_vm_threads(comm_spec.fnum());
-    for (size_t fid = 0; fid < comm_spec.fnum(); ++fid) {
-      copy_vm_threads[fid] = std::thread(
-          [&](size_t fid) {
-            typename fragment_t::oid_t oid;
-            typename fragment_t::vid_t gid{};
-            typename fragment_t::vid_t fvnum =
-                ori_vm_ptr->GetInnerVertexSize(fid);
-            for (typename fragment_t::vid_t lid = 0; lid < fvnum; lid++) {
-              ori_vm_ptr->GetOid(fid, lid, oid);
-              CHECK(new_vm_ptr->AddVertex(fid, oid, gid));
-            }
-          },
-          fid);
-    }
-    for (auto& thrd : copy_vm_threads) {
-      thrd.join();
-    }
-    // copy fragment
-    auto dst_frag = std::make_shared<fragment_t>(new_vm_ptr);
+    // share the vertex map, which is copied by the first fragment mutating
+    // it, see DynamicFragment::detachVertexMap
+    auto dst_frag = std::make_shared<fragment_t>(fragment_->GetVertexMap());
 
     dst_frag->CopyFrom(fragment_, copy_type);
 
@@ -554,31 +706,9 @@ class FragmentWrapper<DynamicFragment> : public IFragmentWrapper {
   bl::result<std::shared_ptr<IFragmentWrapper>> ToDirected(
       const grape::CommSpec& comm_spec,
       const std::string& dst_graph_name) override {
-    // copy vertex map
-    auto ori_vm_ptr = fragment_->GetVertexMap();
-    auto new_vm_ptr =
-        std::make_shared<typename fragment_t::vertex_map_t>(comm_spec);
-    new_vm_ptr->Init();
-    std::vector<std::thread> copy_vm_threads(comm_spec.fnum());
-    for (size_t fid = 0; fid < comm_spec.fnum(); ++fid) {
-      copy_vm_threads[fid] = std::thread(
-          [&](size_t fid) {
-            typename fragment_t::oid_t oid;
-            typename fragment_t::vid_t gid{};
-            typename fragment_t::vid_t fvnum =
-                ori_vm_ptr->GetInnerVertexSize(fid);
-            for (typename fragment_t::vid_t lid = 0; lid < fvnum; lid++) {
-              ori_vm_ptr->GetOid(fid, lid, oid);
-              CHECK(new_vm_ptr->AddVertex(fid, oid, gid));
-            }
-          },
-          fid);
-    }
-    for (auto& thrd : copy_vm_threads) {
-      thrd.join();
-    }
-    // copy fragment
-    auto dst_frag = std::make_shared<fragment_t>(new_vm_ptr);
+    // share the vertex map, which is copied by the first fragment mutating
+    // it, see DynamicFragment::detachVertexMap
+    auto dst_frag = std::make_shared<fragment_t>(fragment_->GetVertexMap());
 
     dst_frag->ToDirectedFrom(fragment_);
 
@@ -592,31 +722,9 @@ class FragmentWrapper<DynamicFragment> : public IFragmentWrapper {
   bl::result<std::shared_ptr<IFragmentWrapper>> ToUnDirected(
       const grape::CommSpec& comm_spec,
       const std::string& dst_graph_name) override {
-    // copy vertex map
-    auto ori_vm_ptr = fragment_->GetVertexMap();
-    auto new_vm_ptr =
-        std::make_shared<typename fragment_t::vertex_map_t>(comm_spec);
-    new_vm_ptr->Init();
-    std::vector<std::thread> copy_vm_threads(comm_spec.fnum());
-    for (size_t fid = 0; fid < comm_spec.fnum(); ++fid) {
-      copy_vm_threads[fid] = std::thread(
-          [&](size_t fid) {
-            typename fragment_t::oid_t oid;
-            typename fragment_t::vid_t gid{};
-            typename fragment_t::vid_t fvnum =
-                ori_vm_ptr->GetInnerVertexSize(fid);
-            for (typename fragment_t::vid_t lid = 0; lid < fvnum; lid++) {
-              ori_vm_ptr->GetOid(fid, lid, oid);
-              CHECK(new_vm_ptr->AddVertex(fid, oid, gid));
-            }
-          },
-          fid);
-    }
-    for (auto& thrd : copy_vm_threads) {
-      thrd.join();
-    }
-    // copy fragment
-    auto dst_frag = std::make_shared<fragment_t>(new_vm_ptr);
+    // share the vertex map, which is copied by the first fragment mutating
+    // it, see DynamicFragment::detachVertexMap
+    auto dst_frag = std::make_shared<fragment_t>(fragment_->GetVertexMap());
 
     dst_frag->ToUnDirectedFrom(fragment_);
 
@@ -70,6 +70,12 @@ class GSObject {
 
   ObjectType type() const { return type_; }
 
+  /**
+   * @brief The bytes held by the object apart from its source, 0 if it is
+   * unknown.
+   */
+  virtual size_t MemoryUsage() const { return 0; }
+
   virtual std::string ToString() const {
     std::stringstream ss;
     ss << "Object " << id_ << "[" << ObjectTypeToString(type_) << "]";
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "vineyard/client/client.h"
 #include "vineyard/graph/utils/grape_utils.h"
 
 #include "core/context/i_context.h"
@@ -44,6 +45,16 @@ class IFragmentWrapper : public GSObject {
 
   virtual std::shared_ptr<void> fragment() const = 0;
 
+  /**
+   * @brief The vineyard object built by the engine for the fragment of this
+   * worker, e.g., a projection, which is deleted with the last wrapper of the
+   * fragment, or InvalidObjectID if the fragment is not one, or is a member of
+   * a fragment group instead.
+   */
+  virtual vineyard::ObjectID local_vineyard_id() const {
+    return vineyard::InvalidObjectID();
+  }
+
   virtual bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
       const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
       const std::string& copy_type) = 0;
@@ -81,6 +92,16 @@ class ILabeledFragmentWrapper : public IFragmentWrapper {
       std::shared_ptr<IContextWrapper>& ctx_wrapper,
       const std::string& s_selectors) = 0;
 
+  /**
+   * @brief Deletes the vineyard objects shared by the projections of the
+   * fragment of this worker, before the fragment itself is deleted.
+   */
+  virtual void DeleteProjectionObjects(vineyard::Client& client) = 0;
+
+  virtual bl::result<std::shared_ptr<ILabeledFragmentWrapper>> Rebalance(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& strategy) = 0;
+
   virtual bl::result<std::unique_ptr<grape::InArchive>> ToNdArray(
       const grape::CommSpec& comm_spec, const LabeledSelector& selector,
       const std::pair<std::string, std::string>& range) = 0;
@@ -89,6 +110,13 @@ class ILabeledFragmentWrapper : public IFragmentWrapper {
       const grape::CommSpec& comm_spec,
       const std::vector<std::pair<std::string, LabeledSelector>>& selectors,
       const std::pair<std::string, std::string>& range) = 0;
+
+  // each worker writes its column chunks to the chunk of the global dataframe
+  // of its fragment, which can be fetched from the workers in parallel
+  virtual bl::result<vineyard::ObjectID> ToVineyardDataframe(
+      const grape::CommSpec& comm_spec, vineyard::Client& client,
+      const std::vector<std::pair<std::string, LabeledSelector>>& selectors,
+      const std::pair<std::string, std::string>& range) = 0;
 };
 }  // namespace gs
 
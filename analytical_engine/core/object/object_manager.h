@@ -18,20 +18,86 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "core/error.h"
 #include "core/object/gs_object.h"
+#include "core/object/projection_cache.h"
+#include "core/object/query_cache.h"
 
 namespace gs {
+
+/**
+ * @brief The bytes held by an object managed by ObjectManager.
+ */
+struct ObjectMemory {
+  std::string id;
+  ObjectType type;
+  size_t bytes;
+};
+
 /**
  * @brief ObjectManager manages GSObject like fragment wrapper, loaded app and
- * more.
+ * more. It may be accessed by the commands running on different lanes of the
+ * dispatcher concurrently.
+ *
+ * With a memory budget, the least recently used derived objects, i.e., the
+ * projected fragments and the contexts, which are not in use are the victims
+ * to evict once the objects and the cached projections exceed the budget, see
+ * EvictionVictim. The bytes differ among the workers, so the eviction is left
+ * to the caller, which must agree on the victims with the other workers and
+ * unload them on all of them. The evicted objects must be created again.
+ *
+ * The objects derived from a graph, e.g., the projections, the views, the
+ * copies and the contexts, are recorded with their sources, as they may share
+ * the states of the sources, see RootOf and DerivedOf.
  */
 class ObjectManager {
  public:
+  /**
+   * @brief Sets the budget in bytes, 0 for no budget.
+   */
+  void SetMemoryBudget(size_t budget) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    budget_ = budget;
+  }
+
+  size_t memory_budget() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budget_;
+  }
+
+  /**
+   * @brief The bytes held by each object, and by all of the objects and the
+   * cached projections, where a fragment shared by several objects is counted
+   * once.
+   */
+  std::vector<ObjectMemory> MemoryUsage(size_t& total) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ObjectMemory> usage;
+    for (auto& pair : objects) {
+      usage.push_back(ObjectMemory{pair.first, pair.second->type(),
+                                   pair.second->MemoryUsage()});
+    }
+    total = totalBytes();
+    return usage;
+  }
+
   bl::result<void> PutObject(std::shared_ptr<GSObject> obj) {
+    return PutObject(std::move(obj), "");
+  }
+
+  /**
+   * @brief Puts an object derived from the object of source, an empty source
+   * for the object which is not derived from others.
+   */
+  bl::result<void> PutObject(std::shared_ptr<GSObject> obj,
+                             const std::string& source) {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto& id = obj->id();
 
     if (objects.find(id) != objects.end()) {
@@ -42,33 +108,105 @@ class ObjectManager {
          << " already exists.";
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError, ss.str());
     }
+    accessed_[id] = ++clock_;
+    if (!source.empty()) {
+      sources_[id] = source;
+    }
+    last_put_ = id;
+    objects[id] = std::move(obj);
+    return {};
+  }
+
+  /**
+   * @brief Puts the object under another id as well, e.g., a cached context
+   * handed out again, derived from the object of source. The object is kept
+   * until all of its ids are removed.
+   */
+  bl::result<void> PutAlias(const std::string& id,
+                            std::shared_ptr<GSObject> obj,
+                            const std::string& source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (objects.find(id) != objects.end()) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                      "Object " + id + " already exists.");
+    }
+    accessed_[id] = ++clock_;
+    if (!source.empty()) {
+      sources_[id] = source;
+    }
+    last_put_ = id;
     objects[id] = std::move(obj);
     return {};
   }
 
   bl::result<void> RemoveObject(const std::string& id) {
-    if (objects.find(id) == objects.end()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = objects.find(id);
+    if (iter == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
     }
-    objects.erase(id);
+    auto obj = std::move(iter->second);
+    objects.erase(iter);
+    accessed_.erase(id);
+    eraseSource(id);
+    // the cached context is released with the last of its ids
+    if (obj->type() == ObjectType::kContextWrapper && holders(*obj) == 0) {
+      query_cache_.EraseContext(static_cast<IContextWrapper*>(obj.get()));
+    }
     return {};
   }
 
+  /**
+   * @brief The root of the sources of the object, i.e., the graph the object
+   * is derived from transitively, or the object itself if it is not derived.
+   * The root is kept after the sources are removed.
+   */
+  std::string RootOf(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string root = id;
+    for (auto iter = sources_.find(root); iter != sources_.end();
+         iter = sources_.find(root)) {
+      root = iter->second;
+    }
+    return root;
+  }
+
+  /**
+   * @brief The objects derived from the object transitively.
+   */
+  std::vector<std::string> DerivedOf(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> derived{id};
+    for (size_t i = 0; i < derived.size(); ++i) {
+      for (auto& pair : sources_) {
+        if (pair.second == derived[i]) {
+          derived.push_back(pair.first);
+        }
+      }
+    }
+    derived.erase(derived.begin());
+    return derived;
+  }
+
   bl::result<std::shared_ptr<GSObject>> GetObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (objects.find(id) == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
     }
+    accessed_[id] = ++clock_;
     return objects[id];
   }
 
   template <typename T>
   bl::result<std::shared_ptr<T>> GetObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (objects.find(id) == objects.end()) {
       RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
                       "Object " + id + " does not exist");
     }
+    accessed_[id] = ++clock_;
     auto obj = std::dynamic_pointer_cast<T>(objects[id]);
 
     if (obj == nullptr) {
@@ -79,11 +217,144 @@ class ObjectManager {
   }
 
   bool HasObject(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
     return objects.find(id) != objects.end();
   }
 
+  /**
+   * @brief Whether the fragment of the object is also held by the other
+   * objects or the cached projections, e.g., by the aliases of a projection,
+   * so the vineyard objects of it must be kept once the object is unloaded.
+   */
+  bool FragmentShared(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = objects.find(id);
+    if (iter == objects.end()) {
+      return false;
+    }
+    auto* wrapper = dynamic_cast<const IFragmentWrapper*>(iter->second.get());
+    if (wrapper == nullptr) {
+      return false;
+    }
+    auto* fragment = wrapper->fragment().get();
+    for (auto& pair : objects) {
+      auto* other = dynamic_cast<const IFragmentWrapper*>(pair.second.get());
+      if (pair.first != id && other != nullptr &&
+          other->fragment().get() == fragment) {
+        return true;
+      }
+    }
+    for (auto& other : projection_cache_.Wrappers()) {
+      if (other->id() != id && other->fragment().get() == fragment) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief The bytes held by all of the objects and the cached projections,
+   * where a fragment shared by several objects is counted once.
+   */
+  size_t TotalBytes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return totalBytes();
+  }
+
+  /**
+   * @brief The least recently used derived object which is not in use, i.e.,
+   * held by its ids only, except the one put last, or an empty string if
+   * there is none of them.
+   */
+  std::string EvictionVictim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto victim = objects.end();
+    for (auto iter = objects.begin(); iter != objects.end(); ++iter) {
+      if (iter->first != last_put_ &&
+          iter->second.use_count() == holders(*iter->second) &&
+          derived(*iter->second) &&
+          (victim == objects.end() ||
+           accessed_[iter->first] < accessed_[victim->first])) {
+        victim = iter;
+      }
+    }
+    return victim == objects.end() ? "" : victim->first;
+  }
+
+  ProjectionCache& projection_cache() { return projection_cache_; }
+
+  QueryCache& query_cache() { return query_cache_; }
+
  private:
+  static size_t bytesOnce(const GSObject& obj, std::set<const void*>& seen) {
+    auto* wrapper = dynamic_cast<const IFragmentWrapper*>(&obj);
+    if (wrapper != nullptr && !seen.insert(wrapper->fragment().get()).second) {
+      return 0;
+    }
+    return obj.MemoryUsage();
+  }
+
+  // the number of ids of the object
+  int64_t holders(const GSObject& obj) {
+    int64_t n = 0;
+    for (auto& pair : objects) {
+      n += pair.second.get() == &obj;
+    }
+    return n;
+  }
+
+  size_t totalBytes() {
+    std::set<const void*> seen;
+    size_t total = 0;
+    for (auto& pair : objects) {
+      total += bytesOnce(*pair.second, seen);
+    }
+    for (auto& wrapper : projection_cache_.Wrappers()) {
+      total += bytesOnce(*wrapper, seen);
+    }
+    return total;
+  }
+
+  static bool derived(const GSObject& obj) {
+    if (obj.type() == ObjectType::kContextWrapper) {
+      return true;
+    }
+    auto* wrapper = dynamic_cast<const IFragmentWrapper*>(&obj);
+    if (wrapper == nullptr) {
+      return false;
+    }
+    auto graph_type = wrapper->graph_def().graph_type();
+    return graph_type == rpc::ARROW_PROJECTED ||
+           graph_type == rpc::DYNAMIC_PROJECTED;
+  }
+
+  // the objects derived from id are attached to the source of id, or keep
+  // id as their source if id is a root
+  void eraseSource(const std::string& id) {
+    auto iter = sources_.find(id);
+    if (iter == sources_.end()) {
+      return;
+    }
+    for (auto& pair : sources_) {
+      if (pair.second == id) {
+        pair.second = iter->second;
+      }
+    }
+    sources_.erase(iter);
+  }
+
   std::map<std::string, std::shared_ptr<GSObject>> objects;
+  std::mutex mutex_;
+  ProjectionCache projection_cache_;
+  QueryCache query_cache_;
+  size_t budget_ = 0;
+  // the logical time of the last access of the objects
+  std::map<std::string, uint64_t> accessed_;
+  uint64_t clock_ = 0;
+  // the object put last, which is kept from the eviction
+  std::string last_put_;
+  // the source of each derived object
+  std::map<std::string, std::string> sources_;
 };
 }  // namespace gs
 #endif  // ANALYTICAL_ENGINE_CORE_OBJECT_OBJECT_MANAGER_H_
@@ -0,0 +1,210 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_OBJECT_PROJECTION_CACHE_H_
+#define ANALYTICAL_ENGINE_CORE_OBJECT_PROJECTION_CACHE_H_
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/object/i_fragment_wrapper.h"
+
+namespace gs {
+
+/**
+ * @brief AliasFragmentWrapper exposes the fragment of another wrapper under
+ * a new graph name, so a cached projection can be handed out again, and
+ * unloaded by its own name. The alias doesn't own the fragment, which is kept
+ * as long as the target or any of its aliases is loaded.
+ */
+class AliasFragmentWrapper : public IFragmentWrapper {
+ public:
+  AliasFragmentWrapper(const std::string& id,
+                       std::shared_ptr<IFragmentWrapper> target)
+      : IFragmentWrapper(id),
+        graph_def_(target->graph_def()),
+        target_(std::move(target)) {
+    graph_def_.set_key(id);
+  }
+
+  std::shared_ptr<void> fragment() const override {
+    return target_->fragment();
+  }
+
+  vineyard::ObjectID local_vineyard_id() const override {
+    return target_->local_vineyard_id();
+  }
+
+  const rpc::GraphDef& graph_def() const override { return graph_def_; }
+
+  size_t MemoryUsage() const override { return target_->MemoryUsage(); }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CopyGraph(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& copy_type) override {
+    return target_->CopyGraph(comm_spec, dst_graph_name, copy_type);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    return target_->ToDirected(comm_spec, dst_graph_name);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> ToUnDirected(
+      const grape::CommSpec& comm_spec,
+      const std::string& dst_graph_name) override {
+    return target_->ToUnDirected(comm_spec, dst_graph_name);
+  }
+
+  bl::result<std::shared_ptr<IFragmentWrapper>> CreateGraphView(
+      const grape::CommSpec& comm_spec, const std::string& dst_graph_name,
+      const std::string& view_type) override {
+    return target_->CreateGraphView(comm_spec, dst_graph_name, view_type);
+  }
+
+ private:
+  rpc::GraphDef graph_def_;
+  std::shared_ptr<IFragmentWrapper> target_;
+};
+
+/**
+ * @brief ProjectionCache keeps the recent projections of the graphs, keyed by
+ * the source fragment and the projection spec, so repeated projections are
+ * reused. The least recently used ones are evicted once the bytes of the
+ * projections exceed the capacity, and the projections of a graph are
+ * dropped when it or the projection is unloaded. A capacity of 0 disables
+ * the cache.
+ *
+ * The cache and the aliases of a projection share the wrapper, and thus the
+ * vineyard objects, of the projection, which are deleted by the unload of the
+ * last of the projection and its aliases, see ObjectManager::FragmentShared.
+ */
+class ProjectionCache {
+ public:
+  void SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict();
+  }
+
+  std::shared_ptr<IFragmentWrapper> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return iter->second->wrapper;
+  }
+
+  void Put(const std::string& key, const std::string& source,
+           std::shared_ptr<IFragmentWrapper> wrapper) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.find(key) != index_.end()) {
+      return;
+    }
+    size_t bytes = wrapper->MemoryUsage();
+    entries_.push_front(Entry{key, source, std::move(wrapper), bytes});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+    evict();
+  }
+
+  /**
+   * @brief Drops the projections of the source graph.
+   */
+  void EraseSource(const std::string& source) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      if (iter->source == source) {
+        iter = erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  /**
+   * @brief Drops the cached projection of the id, once it is unloaded.
+   */
+  void EraseProjection(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      if (iter->wrapper->id() == id) {
+        iter = erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+  }
+
+  std::vector<std::shared_ptr<IFragmentWrapper>> Wrappers() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<IFragmentWrapper>> wrappers;
+    for (auto& entry : entries_) {
+      wrappers.push_back(entry.wrapper);
+    }
+    return wrappers;
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string source;
+    std::shared_ptr<IFragmentWrapper> wrapper;
+    size_t bytes;
+  };
+
+  std::list<Entry>::iterator erase(std::list<Entry>::iterator iter) {
+    bytes_ -= iter->bytes;
+    index_.erase(iter->key);
+    return entries_.erase(iter);
+  }
+
+  // keeps the most recent one even if it alone exceeds the capacity
+  void evict() {
+    while (!entries_.empty() && (capacity_ == 0 || bytes_ > capacity_)) {
+      if (capacity_ != 0 && entries_.size() == 1) {
+        break;
+      }
+      erase(std::prev(entries_.end()));
+    }
+  }
+
+  std::mutex mutex_;
+  size_t capacity_ = 0;
+  size_t bytes_ = 0;
+  // the most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_OBJECT_PROJECTION_CACHE_H_
@@ -0,0 +1,155 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_OBJECT_QUERY_CACHE_H_
+#define ANALYTICAL_ENGINE_CORE_OBJECT_QUERY_CACHE_H_
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/context/i_context.h"
+
+namespace gs {
+
+/**
+ * @brief QueryCache keeps the contexts of the recent queries on the immutable
+ * graphs, keyed by the app, the graph and the query args, so a repeated query
+ * returns the existing context under a new key instead of running the app
+ * again. The least recently used ones are evicted once the bytes of the
+ * contexts exceed the capacity, the contexts of a graph are dropped when it is
+ * modified or unloaded, and a context is dropped once none of its keys is
+ * held by ObjectManager. A capacity of 0 disables the cache.
+ */
+class QueryCache {
+ public:
+  void SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    evict();
+  }
+
+  bool enabled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_ != 0;
+  }
+
+  std::shared_ptr<IContextWrapper> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+      return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    return iter->second->context;
+  }
+
+  void Put(const std::string& key, const std::string& graph,
+           std::shared_ptr<IContextWrapper> context) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.find(key) != index_.end()) {
+      return;
+    }
+    size_t bytes = context->MemoryUsage();
+    entries_.push_front(Entry{key, graph, std::move(context), bytes});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+    evict();
+  }
+
+  void Erase(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(key);
+    if (iter != index_.end()) {
+      erase(iter->second);
+    }
+  }
+
+  /**
+   * @brief Drops the contexts of the queries on the graph.
+   */
+  void EraseGraph(const std::string& graph) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      if (iter->graph == graph) {
+        iter = erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  /**
+   * @brief Drops the entry of the context, once the context is no longer held
+   * by any handle of the client.
+   */
+  void EraseContext(const IContextWrapper* context) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      if (iter->context.get() == context) {
+        iter = erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::string graph;
+    std::shared_ptr<IContextWrapper> context;
+    size_t bytes;
+  };
+
+  std::list<Entry>::iterator erase(std::list<Entry>::iterator iter) {
+    bytes_ -= iter->bytes;
+    index_.erase(iter->key);
+    return entries_.erase(iter);
+  }
+
+  // keeps the most recent one even if it alone exceeds the capacity
+  void evict() {
+    while (!entries_.empty() && (capacity_ == 0 || bytes_ > capacity_)) {
+      if (capacity_ != 0 && entries_.size() == 1) {
+        break;
+      }
+      erase(std::prev(entries_.end()));
+    }
+  }
+
+  std::mutex mutex_;
+  size_t capacity_ = 0;
+  size_t bytes_ = 0;
+  // the most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_OBJECT_QUERY_CACHE_H_
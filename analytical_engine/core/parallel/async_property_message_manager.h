@@ -0,0 +1,394 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_ASYNC_PROPERTY_MESSAGE_MANAGER_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_ASYNC_PROPERTY_MESSAGE_MANAGER_H_
+
+#include <mpi.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
+#include "grape/utils/concurrent_queue.h"
+#include "grape/worker/comm_spec.h"
+
+#include "core/communication/chunked_comm.h"
+#include "core/parallel/thread_local_property_message_buffer.h"
+#include "core/parallel/thread_pool.h"
+
+namespace gs {
+
+/**
+ * @brief A message manager without rounds. Messages are sent as soon as the
+ * thread local buffers are flushed, and the received ones are available to
+ * the app immediately, there is no global barrier between two evaluations.
+ *
+ * Termination is detected by counting the buffers sent and processed on all
+ * workers with non-blocking all-reductions, the computation terminates when
+ * two consecutive reductions observe the same totals and every sent buffer
+ * has been processed, i.e., all workers have been idle in between and no
+ * message is in flight.
+ */
+class AsyncPropertyMessageManager {
+  static constexpr size_t default_msg_send_block_size = 2 * 1023 * 1024;
+  static constexpr size_t default_msg_send_block_capacity = 2 * 1023 * 1024;
+  static constexpr int data_tag = 1;
+  static constexpr int stop_tag = 2;
+
+ public:
+  AsyncPropertyMessageManager() : comm_(MPI_COMM_NULL) {}
+  ~AsyncPropertyMessageManager() {
+    if (comm_ != MPI_COMM_NULL) {
+      MPI_Comm_free(&comm_);
+    }
+  }
+
+  void Init(MPI_Comm comm) {
+    MPI_Comm_dup(comm, &comm_);
+    comm_spec_.Init(comm_);
+    fid_ = comm_spec_.fid();
+    fnum_ = comm_spec_.fnum();
+
+    sent_num_ = 0;
+    processed_num_ = 0;
+    wave_in_flight_ = false;
+    last_totals_[0] = last_totals_[1] = 0;
+    has_last_totals_ = false;
+  }
+
+  void Start() {
+    sending_queue_.SetProducerNum(1);
+    send_thread_ = std::thread([this]() { sendAll(); });
+    recv_thread_ = std::thread([this]() { probeAllIncomingMessages(); });
+  }
+
+  void Finalize() {
+    if (wave_in_flight_) {
+      MPI_Wait(&wave_req_, MPI_STATUS_IGNORE);
+      wave_in_flight_ = false;
+    }
+    sending_queue_.DecProducerNum();
+    send_thread_.join();
+    MPI_Barrier(comm_);
+    MPI_Send(NULL, 0, MPI_CHAR, comm_spec_.worker_id(), stop_tag, comm_);
+    recv_thread_.join();
+
+    MPI_Comm_free(&comm_);
+    comm_ = MPI_COMM_NULL;
+  }
+
+  /**
+   * @brief Init a set of channels, each channel is a thread local message
+   * buffer.
+   *
+   * @param channel_num Number of channels.
+   * @param block_size Size of each channel.
+   * @param block_cap Capacity of each channel.
+   */
+  void InitChannels(int channel_num = 1,
+                    size_t block_size = default_msg_send_block_size,
+                    size_t block_cap = default_msg_send_block_capacity) {
+    channels_.resize(channel_num);
+    for (auto& channel : channels_) {
+      channel.Init(fnum_, this, block_size, block_cap);
+    }
+  }
+
+  std::vector<ThreadLocalPropertyMessageBuffer<AsyncPropertyMessageManager>>&
+  Channels() {
+    return channels_;
+  }
+
+  /**
+   * @brief Send a buffer to a fragment, it is called by the channels.
+   *
+   * @param fid Destination fragment id.
+   * @param arc Message buffer.
+   */
+  inline void SendRawMsgByFid(grape::fid_t fid, grape::InArchive&& arc) {
+    if (arc.GetSize() == 0) {
+      return;
+    }
+    ++sent_num_;
+    if (fid == fid_) {
+      putIncoming(grape::OutArchive(std::move(arc)));
+    } else {
+      std::pair<grape::fid_t, grape::InArchive> item;
+      item.first = fid;
+      item.second = std::move(arc);
+      sending_queue_.Put(std::move(item));
+    }
+  }
+
+  template <typename GRAPH_T, typename MESSAGE_T>
+  inline void SyncStateOnOuterVertex(const GRAPH_T& frag,
+                                     const typename GRAPH_T::vertex_t& v,
+                                     const MESSAGE_T& msg, int channel_id = 0) {
+    channels_[channel_id].SyncStateOnOuterVertex<GRAPH_T, MESSAGE_T>(frag, v,
+                                                                     msg);
+  }
+
+  template <typename GRAPH_T, typename MESSAGE_T, typename COMBINER_T>
+  inline void CombineStateOnOuterVertex(const GRAPH_T& frag,
+                                        const typename GRAPH_T::vertex_t& v,
+                                        const MESSAGE_T& msg,
+                                        const COMBINER_T& combiner,
+                                        int channel_id = 0) {
+    channels_[channel_id]
+        .CombineStateOnOuterVertex<GRAPH_T, MESSAGE_T, COMBINER_T>(
+            frag, v, msg, combiner);
+  }
+
+  template <typename GRAPH_T, typename MESSAGE_T>
+  inline void SendMsgThroughIEdges(const GRAPH_T& frag,
+                                   const typename GRAPH_T::vertex_t& v,
+                                   typename GRAPH_T::label_id_t label,
+                                   const MESSAGE_T& msg, int channel_id = 0) {
+    channels_[channel_id].SendMsgThroughIEdges<GRAPH_T, MESSAGE_T>(frag, v,
+                                                                   label, msg);
+  }
+
+  template <typename GRAPH_T, typename MESSAGE_T>
+  inline void SendMsgThroughOEdges(const GRAPH_T& frag,
+                                   const typename GRAPH_T::vertex_t& v,
+                                   typename GRAPH_T::label_id_t label,
+                                   const MESSAGE_T& msg, int channel_id = 0) {
+    channels_[channel_id].SendMsgThroughOEdges<GRAPH_T, MESSAGE_T>(frag, v,
+                                                                   label, msg);
+  }
+
+  template <typename GRAPH_T, typename MESSAGE_T>
+  inline void SendMsgThroughEdges(const GRAPH_T& frag,
+                                  const typename GRAPH_T::vertex_t& v,
+                                  typename GRAPH_T::label_id_t label,
+                                  const MESSAGE_T& msg, int channel_id = 0) {
+    channels_[channel_id].SendMsgThroughEdges<GRAPH_T, MESSAGE_T>(frag, v,
+                                                                  label, msg);
+  }
+
+  /**
+   * @brief Flushes all channels, must not be called concurrently with the
+   * sending methods.
+   */
+  void FlushChannels() {
+    for (auto& channel : channels_) {
+      channel.FlushMessages();
+      channel.Reset();
+    }
+  }
+
+  /**
+   * @brief Whether there are received messages not processed yet.
+   */
+  bool HasIncoming() {
+    std::lock_guard<std::mutex> lock(incoming_mutex_);
+    return !incoming_.empty();
+  }
+
+  /**
+   * @brief Waits until some message is received, or the timeout expires.
+   */
+  template <typename REP_T, typename PERIOD_T>
+  bool WaitIncoming(const std::chrono::duration<REP_T, PERIOD_T>& timeout) {
+    std::unique_lock<std::mutex> lock(incoming_mutex_);
+    return incoming_cv_.wait_for(lock, timeout,
+                                 [this]() { return !incoming_.empty(); });
+  }
+
+  /**
+   * @brief Parallel process the messages received so far, including those
+   * arrive during processing, and returns when none is left.
+   *
+   * @tparam GRAPH_T Graph type.
+   * @tparam MESSAGE_T Message type.
+   * @tparam FUNC_T Function type.
+   * @param thread_num Number of threads.
+   * @param frag
+   * @param func
+   */
+  template <typename GRAPH_T, typename MESSAGE_T, typename FUNC_T>
+  inline void ParallelProcess(int thread_num, const GRAPH_T& frag,
+                              const FUNC_T& func) {
+    thread_pool_.ParallelRun(thread_num, [&](int tid) {
+      typename GRAPH_T::vid_t id;
+      typename GRAPH_T::vertex_t vertex(0);
+      MESSAGE_T msg;
+      grape::OutArchive arc;
+      while (takeIncoming(arc)) {
+        while (!arc.Empty()) {
+          arc >> id >> msg;
+          frag.Gid2Vertex(id, vertex);
+          func(tid, vertex, msg);
+        }
+        ++processed_num_;
+      }
+    });
+  }
+
+  /**
+   * @brief Drives the termination detection without blocking, it should be
+   * called repeatedly when the worker is idle, i.e., the channels are flushed
+   * and no message is left. Every worker gets the same answer at the same
+   * reduction.
+   */
+  bool ToTerminate() {
+    if (!wave_in_flight_) {
+      local_counts_[0] = sent_num_;
+      local_counts_[1] = processed_num_;
+      MPI_Iallreduce(local_counts_, totals_, 2, MPI_UNSIGNED_LONG_LONG,
+                     MPI_SUM, comm_, &wave_req_);
+      wave_in_flight_ = true;
+    }
+    int done = 0;
+    MPI_Test(&wave_req_, &done, MPI_STATUS_IGNORE);
+    if (!done) {
+      return false;
+    }
+    wave_in_flight_ = false;
+    bool terminated = has_last_totals_ && totals_[0] == totals_[1] &&
+                      totals_[0] == last_totals_[0] &&
+                      totals_[1] == last_totals_[1];
+    last_totals_[0] = totals_[0];
+    last_totals_[1] = totals_[1];
+    has_last_totals_ = true;
+    return terminated;
+  }
+
+ private:
+  void putIncoming(grape::OutArchive&& arc) {
+    {
+      std::lock_guard<std::mutex> lock(incoming_mutex_);
+      incoming_.emplace_back(std::move(arc));
+    }
+    incoming_cv_.notify_one();
+  }
+
+  bool takeIncoming(grape::OutArchive& arc) {
+    std::lock_guard<std::mutex> lock(incoming_mutex_);
+    if (incoming_.empty()) {
+      return false;
+    }
+    arc = std::move(incoming_.front());
+    incoming_.pop_front();
+    return true;
+  }
+
+  void sendAll() {
+    std::vector<std::vector<MPI_Request>> reqs;
+    std::vector<grape::InArchive> buffers;
+    std::pair<grape::fid_t, grape::InArchive> item;
+    while (sending_queue_.Get(item)) {
+      std::vector<MPI_Request> buffer_reqs;
+      IsendChunked(item.second.GetBuffer(), item.second.GetSize(),
+                   comm_spec_.FragToWorker(item.first), data_tag, comm_,
+                   buffer_reqs);
+      reqs.push_back(buffer_reqs);
+      buffers.emplace_back(std::move(item.second));
+
+      // release the buffers whose pieces are all sent
+      size_t kept = 0;
+      for (size_t i = 0; i < reqs.size(); ++i) {
+        int done = 0;
+        MPI_Testall(reqs[i].size(), reqs[i].data(), &done,
+                    MPI_STATUSES_IGNORE);
+        if (!done) {
+          reqs[kept] = std::move(reqs[i]);
+          buffers[kept] = std::move(buffers[i]);
+          ++kept;
+        }
+      }
+      reqs.resize(kept);
+      buffers.resize(kept);
+    }
+    for (auto& buffer_reqs : reqs) {
+      MPI_Waitall(buffer_reqs.size(), buffer_reqs.data(), MPI_STATUSES_IGNORE);
+    }
+  }
+
+  void probeAllIncomingMessages() {
+    MPI_Status status;
+    while (true) {
+      MPI_Probe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &status);
+      if (status.MPI_TAG == stop_tag) {
+        MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, stop_tag, comm_,
+                 MPI_STATUS_IGNORE);
+        return;
+      }
+      putIncoming(recvArchive(status));
+    }
+  }
+
+  // receives a buffer sent by IsendChunked, whose first piece is probed
+  grape::OutArchive recvArchive(const MPI_Status& status) {
+    int count;
+    MPI_Get_count(&status, MPI_CHAR, &count);
+    if (static_cast<size_t>(count) < kChunkBytes) {
+      grape::OutArchive arc(count);
+      MPI_Recv(arc.GetBuffer(), count, MPI_CHAR, status.MPI_SOURCE,
+               status.MPI_TAG, comm_, MPI_STATUS_IGNORE);
+      return arc;
+    }
+    std::vector<char> buffer;
+    RecvChunked(status, comm_, buffer);
+    grape::OutArchive arc(buffer.size());
+    memcpy(arc.GetBuffer(), buffer.data(), buffer.size());
+    return arc;
+  }
+
+  grape::fid_t fid_;
+  grape::fid_t fnum_;
+  grape::CommSpec comm_spec_;
+
+  MPI_Comm comm_;
+
+  std::vector<ThreadLocalPropertyMessageBuffer<AsyncPropertyMessageManager>>
+      channels_;
+
+  grape::BlockingQueue<std::pair<grape::fid_t, grape::InArchive>>
+      sending_queue_;
+  std::thread send_thread_;
+  std::thread recv_thread_;
+
+  std::mutex incoming_mutex_;
+  std::condition_variable incoming_cv_;
+  std::deque<grape::OutArchive> incoming_;
+
+  ThreadPool thread_pool_;
+
+  // numbers of non-empty buffers sent and processed by this worker
+  std::atomic<uint64_t> sent_num_;
+  std::atomic<uint64_t> processed_num_;
+
+  MPI_Request wave_req_;
+  bool wave_in_flight_;
+  unsigned long long local_counts_[2];  // NOLINT(runtime/int)
+  unsigned long long totals_[2];        // NOLINT(runtime/int)
+  unsigned long long last_totals_[2];   // NOLINT(runtime/int)
+  bool has_last_totals_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_ASYNC_PROPERTY_MESSAGE_MANAGER_H_
@@ -18,14 +18,23 @@
 
 #include <mpi.h>
 
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "arrow/util/compression.h"
+
 #include "grape/communication/sync_comm.h"
 #include "grape/parallel/message_manager_base.h"
 #include "grape/serialization/in_archive.h"
@@ -33,9 +42,25 @@
 #include "grape/utils/concurrent_queue.h"
 #include "grape/worker/comm_spec.h"
 
+#include "core/communication/chunked_comm.h"
+#include "core/parallel/round_stats.h"
 #include "core/parallel/thread_local_property_message_buffer.h"
+#include "core/parallel/thread_pool.h"
 
 namespace gs {
+
+/**
+ * @brief Whether a message of MESSAGE_T is archived as exactly its raw bytes,
+ * so that ParallelProcess may decode the received records as a packed array.
+ * An empty type, e.g., grape::EmptyType, puts no bytes on the wire, and a POD
+ * type archived by an operator<< of its own must specialize this to
+ * std::false_type.
+ */
+template <typename MESSAGE_T>
+struct is_packed_message
+    : std::integral_constant<bool, std::is_pod<MESSAGE_T>::value &&
+                                       !std::is_empty<MESSAGE_T>::value> {};
+
 /**
  * @brief A kind of parallel message manager.
  *
@@ -53,6 +78,10 @@ namespace gs {
 class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   static constexpr size_t default_msg_send_block_size = 2 * 1023 * 1024;
   static constexpr size_t default_msg_send_block_capacity = 2 * 1023 * 1024;
+  static constexpr size_t default_compress_threshold = 4096;
+  // framing of a message when compression is enabled: a flag telling whether
+  // the payload is compressed, and the size of the raw payload.
+  static constexpr size_t compress_header_size = 1 + sizeof(uint64_t);
 
  public:
   ParallelPropertyMessageManager() : comm_(NULL_COMM) {}
@@ -74,18 +103,28 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     force_terminate_ = false;
     terminate_info_.Init(fnum_);
 
-    recv_queues_[0].SetProducerNum(fnum_);
-    recv_queues_[1].SetProducerNum(fnum_);
+    initTopology();
+    hierarchical_ = false;
+    producer_num_ = fnum_;
+    recv_queues_[0].SetProducerNum(producer_num_);
+    recv_queues_[1].SetProducerNum(producer_num_);
 
     round_ = 0;
 
     sent_size_ = 0;
+
+    stats_.Init(fnum_);
+    fid_sent_bytes_.resize(fnum_);
+    fid_sent_buffers_.resize(fnum_);
   }
 
   /**
    * @brief Inherit
    */
-  void Start() override { startRecvThread(); }
+  void Start() override {
+    stats_.Clear();
+    startRecvThread();
+  }
 
   /**
    * @brief Inherit
@@ -93,6 +132,12 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   void StartARound() override {
     if (round_ != 0) {
       waitSend();
+      stats_.AddSent(fid_sent_bytes_, fid_sent_buffers_);
+      stats_.AddCompressed(raw_bytes_, wire_bytes_);
+      if (codec_ != nullptr && raw_bytes_ != 0) {
+        VLOG(1) << "[frag " << fid_ << "] round " << round_
+                << " message compression ratio: " << GetCompressionRatio();
+      }
       auto& rq = recv_queues_[round_ % 2];
       if (!to_self_.empty()) {
         for (auto& iarc : to_self_) {
@@ -105,15 +150,18 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     }
     sent_size_ = 0;
     startSendThread();
+    stats_.StartCompute();
   }
 
   /**
    * @brief Inherit
    */
   void FinishARound() override {
+    stats_.FinishCompute();
     sent_size_ = finishMsgFilling();
     resetRecvQueue();
     round_++;
+    stats_.FinishRound();
   }
 
   /**
@@ -141,6 +189,8 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   void Finalize() override {
     waitSend();
+    stats_.AddSent(fid_sent_bytes_, fid_sent_buffers_);
+    stats_.AddCompressed(raw_bytes_, wire_bytes_);
     MPI_Barrier(comm_);
     stopRecvThread();
 
@@ -173,6 +223,48 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   size_t GetMsgSize() const override { return sent_size_; }
 
+  /**
+   * @brief The stats of the rounds of the last query. The messages sent to
+   * each fragment in a round are counted before compression, and added once
+   * the sending of the round finishes, i.e., when the next round starts.
+   */
+  const RoundStatsRecorder& GetRoundStats() const { return stats_; }
+
+  /**
+   * @brief Adds to the active vertices of the current round in the stats,
+   * it's thread-safe.
+   */
+  void AddActiveVertices(size_t num) { stats_.AddActiveVertices(num); }
+
+  /**
+   * @brief Enables compressing the messages sent to other workers with a
+   * codec of arrow, e.g., LZ4_FRAME or ZSTD. Buffers smaller than threshold
+   * bytes are sent as-is. It must be called with the same arguments on all
+   * workers before the first round, since the framing of messages changes.
+   * UNCOMPRESSED disables compression.
+   */
+  void SetCompression(arrow::Compression::type type,
+                      size_t threshold = default_compress_threshold) {
+    codec_.reset();
+    if (type != arrow::Compression::UNCOMPRESSED) {
+      auto result = arrow::util::Codec::Create(type);
+      CHECK(result.ok()) << "Failed to create codec: "
+                         << result.status().ToString();
+      codec_ = std::move(result).ValueOrDie();
+    }
+    compress_threshold_ = threshold;
+  }
+
+  /**
+   * @brief The ratio of the compressed size to the raw size of the messages
+   * sent to other workers in the last finished round, 1.0 if nothing is
+   * compressed. The sizes of each round are in the round stats as well.
+   */
+  double GetCompressionRatio() const {
+    return raw_bytes_ == 0 ? 1.0
+                           : static_cast<double>(wire_bytes_) / raw_bytes_;
+  }
+
   /**
    * @brief Init a set of channels, each channel is a thread local message
    * buffer.
@@ -184,12 +276,106 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   void InitChannels(int channel_num = 1,
                     size_t block_size = default_msg_send_block_size,
                     size_t block_cap = default_msg_send_block_capacity) {
+    if (block_size_ != 0) {
+      block_size = block_size_;
+    }
     channels_.resize(channel_num);
     for (auto& channel : channels_) {
       channel.Init(fnum_, this, block_size, block_cap);
+      channel.SetFlushInterval(flush_interval_);
     }
   }
 
+  /**
+   * @brief Lets every channel flush its partial blocks after they have been
+   * held for interval, the received messages are queued by the receiving
+   * thread as they arrive, so the latency is hidden behind the computation
+   * of the round. The interval is kept for the channels created by later
+   * InitChannels(), so it can be set before the app runs.
+   *
+   * @param interval Zero disables the timed flushes.
+   */
+  void SetFlushInterval(std::chrono::microseconds interval) {
+    flush_interval_ = interval;
+    for (auto& channel : channels_) {
+      channel.SetFlushInterval(interval);
+    }
+  }
+
+  /**
+   * @brief Overrides the block size of the channels created by later
+   * InitChannels(), i.e., the bytes from which a channel sends its messages
+   * to a fragment before the end of the round, e.g., to exercise the partial
+   * flushes on a small graph. It is set before the app runs, and zero
+   * restores the block size given by the app.
+   */
+  void SetBlockSize(size_t block_size) { block_size_ = block_size; }
+
+  /**
+   * @brief Routes the messages to other hosts through a proxy on each of
+   * them: the messages from a worker to all workers on a remote host are
+   * aggregated into large buffers, sent to the worker on that host with the
+   * same local index, and forwarded by it to the destinations over shared
+   * memory. Each worker talks to the workers on its host and one worker per
+   * remote host instead of all the workers, which reduces the number of
+   * small packets crossing the network when a host runs many workers.
+   *
+   * It must be called with the same arguments on all workers after Init()
+   * and before the first round.
+   *
+   * @param flush_bytes The aggregated buffer to a host is sent once it
+   * reaches this size.
+   * @param host_num If positive, the workers are grouped into host_num hosts
+   * of consecutive worker ids instead of by the memory they share, e.g., to
+   * exercise the routing on a single machine.
+   */
+  void EnableHierarchicalRouting(
+      size_t flush_bytes = default_msg_send_block_size, int host_num = 0) {
+    if (host_num > 0) {
+      int worker_num = comm_spec_.worker_num();
+      std::vector<int> groups(worker_num);
+      for (int worker = 0; worker < worker_num; ++worker) {
+        groups[worker] = static_cast<int>(static_cast<int64_t>(worker) *
+                                          std::min(host_num, worker_num) /
+                                          worker_num);
+      }
+      groupWorkers(groups);
+    }
+    hierarchical_ = host_num_ > 1;
+    relay_flush_bytes_ = flush_bytes;
+    if (!hierarchical_) {
+      return;
+    }
+    // the remote workers sending to this worker as their proxy
+    relay_sender_num_ = 0;
+    for (int host = 0; host < host_num_; ++host) {
+      if (host == host_id_) {
+        continue;
+      }
+      for (size_t i = 0; i < host_workers_[host].size(); ++i) {
+        if (static_cast<int>(i % host_workers_[host_id_].size()) ==
+            local_index_) {
+          ++relay_sender_num_;
+        }
+      }
+    }
+    // the workers on this host, including this one, finishing the direct
+    // messages, and those relaying messages from other hosts, i.e., the
+    // ones whose local index exists on some remote host
+    size_t max_remote_size = 0;
+    for (int host = 0; host < host_num_; ++host) {
+      if (host != host_id_) {
+        max_remote_size =
+            std::max(max_remote_size, host_workers_[host].size());
+      }
+    }
+    relay_finished_[0] = relay_finished_[1] = 0;
+    producer_num_ = host_workers_[host_id_].size() +
+                    std::min(host_workers_[host_id_].size(), max_remote_size);
+    recv_queues_[0].SetProducerNum(producer_num_);
+    recv_queues_[1].SetProducerNum(producer_num_);
+  }
+
   std::vector<ThreadLocalPropertyMessageBuffer<ParallelPropertyMessageManager>>&
   Channels() {
     return channels_;
@@ -233,6 +419,30 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     channels_[channel_id].SyncStateOnOuterVertex<GRAPH_T>(frag, v);
   }
 
+  /**
+   * @brief CombineStateOnOuterVertex on a channel, messages to the same
+   * outer vertex are merged by the combiner before being sent.
+   *
+   * @tparam GRAPH_T Graph type.
+   * @tparam MESSAGE_T Message type.
+   * @tparam COMBINER_T Combiner type, see MinCombiner.
+   * @param frag Source fragment.
+   * @param v Source vertex.
+   * @param msg
+   * @param combiner
+   * @param channel_id
+   */
+  template <typename GRAPH_T, typename MESSAGE_T, typename COMBINER_T>
+  inline void CombineStateOnOuterVertex(const GRAPH_T& frag,
+                                        const typename GRAPH_T::vertex_t& v,
+                                        const MESSAGE_T& msg,
+                                        const COMBINER_T& combiner,
+                                        int channel_id = 0) {
+    channels_[channel_id]
+        .CombineStateOnOuterVertex<GRAPH_T, MESSAGE_T, COMBINER_T>(
+            frag, v, msg, combiner);
+  }
+
   /**
    * @brief SendMsgThroughIEdges on a channel.
    *
@@ -304,30 +514,13 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   template <typename GRAPH_T, typename MESSAGE_T, typename FUNC_T>
   inline void ParallelProcess(int thread_num, const GRAPH_T& frag,
                               const FUNC_T& func) {
-    std::vector<std::thread> threads(thread_num);
-
-    for (int i = 0; i < thread_num; ++i) {
-      threads[i] = std::thread(
-          [&](int tid) {
-            typename GRAPH_T::vid_t id;
-            typename GRAPH_T::vertex_t vertex(0);
-            MESSAGE_T msg;
-            auto& que = recv_queues_[round_ % 2];
-            grape::OutArchive arc;
-            while (que.Get(arc)) {
-              while (!arc.Empty()) {
-                arc >> id >> msg;
-                frag.Gid2Vertex(id, vertex);
-                func(tid, vertex, msg);
-              }
-            }
-          },
-          i);
-    }
-
-    for (auto& thrd : threads) {
-      thrd.join();
-    }
+    thread_pool_.ParallelRun(thread_num, [&](int tid) {
+      auto& que = recv_queues_[round_ % 2];
+      grape::OutArchive arc;
+      while (que.Get(arc)) {
+        processArchive<GRAPH_T, MESSAGE_T>(tid, frag, arc, func);
+      }
+    });
   }
 
   /**
@@ -343,30 +536,85 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
    */
   template <typename MESSAGE_T, typename FUNC_T>
   inline void ParallelProcess(int thread_num, const FUNC_T& func) {
-    std::vector<std::thread> threads(thread_num);
-
-    for (int i = 0; i < thread_num; ++i) {
-      threads[i] = std::thread(
-          [&](int tid) {
-            MESSAGE_T msg;
-            auto& que = recv_queues_[round_ % 2];
-            grape::OutArchive arc;
-            while (que.Get(arc)) {
-              while (!arc.Empty()) {
-                arc >> msg;
-                func(tid, msg);
-              }
-            }
-          },
-          i);
+    thread_pool_.ParallelRun(thread_num, [&](int tid) {
+      MESSAGE_T msg;
+      auto& que = recv_queues_[round_ % 2];
+      grape::OutArchive arc;
+      while (que.Get(arc)) {
+        while (!arc.Empty()) {
+          arc >> msg;
+          func(tid, msg);
+        }
+      }
+    });
+  }
+
+  /**
+   * @brief Runs func(tid) for each tid in [0, thread_num) on the threads of
+   * the message manager, which are kept across rounds.
+   *
+   * @param thread_num Number of threads.
+   * @param func
+   */
+  template <typename FUNC_T>
+  inline void ParallelRun(int thread_num, const FUNC_T& func) {
+    thread_pool_.ParallelRun(thread_num, func);
+  }
+
+ private:
+  // a packed message is archived as the raw bytes of the gid followed by the
+  // raw bytes of the message, so the archive is decoded as a packed array of
+  // records.
+  template <typename GRAPH_T, typename MESSAGE_T, typename FUNC_T>
+  inline typename std::enable_if<is_packed_message<MESSAGE_T>::value>::type
+  processArchive(int tid, const GRAPH_T& frag, grape::OutArchive& arc,
+                 const FUNC_T& func) {
+    using vid_t = typename GRAPH_T::vid_t;
+    constexpr size_t stride = sizeof(vid_t) + sizeof(MESSAGE_T);
+    size_t count = arc.GetSize() / stride;
+    CHECK_EQ(count * stride, arc.GetSize());
+    if (count == 0) {
+      return;
     }
+    const char* ptr =
+        reinterpret_cast<const char*>(arc.GetBytes(count * stride));
+    vid_t id;
+    typename GRAPH_T::vertex_t vertex(0);
+    MESSAGE_T msg;
+    for (size_t i = 0; i < count; ++i, ptr += stride) {
+      memcpy(&id, ptr, sizeof(vid_t));
+      memcpy(&msg, ptr + sizeof(vid_t), sizeof(MESSAGE_T));
+      frag.Gid2Vertex(id, vertex);
+      func(tid, vertex, msg);
+    }
+  }
 
-    for (auto& thrd : threads) {
-      thrd.join();
+  template <typename GRAPH_T, typename MESSAGE_T, typename FUNC_T>
+  inline typename std::enable_if<!is_packed_message<MESSAGE_T>::value>::type
+  processArchive(int tid, const GRAPH_T& frag, grape::OutArchive& arc,
+                 const FUNC_T& func) {
+    typename GRAPH_T::vid_t id;
+    typename GRAPH_T::vertex_t vertex(0);
+    MESSAGE_T msg;
+    while (!arc.Empty()) {
+      arc >> id >> msg;
+      frag.Gid2Vertex(id, vertex);
+      func(tid, vertex, msg);
     }
   }
 
- private:
+  // the tags of a round: the direct messages, the aggregated messages
+  // relayed by a proxy on the destination host, and the records forwarded
+  // by the proxy. 0 is the stop message. The forwarded records are sent by
+  // the receiving thread of the proxy while its sending thread may send
+  // direct messages to the same worker, so they have a tag of their own to
+  // keep the pieces of the chunked messages of the two threads apart.
+  static int directTag(int msg_round) { return 1 + 3 * (msg_round % 2); }
+  static int relayTag(int msg_round) { return 2 + 3 * (msg_round % 2); }
+  static int forwardTag(int msg_round) { return 3 + 3 * (msg_round % 2); }
+  static int tagQueue(int tag) { return (tag - 1) / 3; }
+  static bool isRelayTag(int tag) { return (tag - 1) % 3 == 1; }
+
   void startSendThread() {
     force_continue_ = false;
     int round = round_;
@@ -376,33 +624,80 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
     send_thread_ = std::thread(
         [this](int msg_round) {
           std::vector<MPI_Request> reqs;
+          std::vector<std::vector<char>> framed;
+          raw_bytes_ = 0;
+          wire_bytes_ = 0;
+          std::fill(fid_sent_bytes_.begin(), fid_sent_bytes_.end(), 0);
+          std::fill(fid_sent_buffers_.begin(), fid_sent_buffers_.end(), 0);
+          int tag = directTag(msg_round);
+          std::vector<std::vector<char>> relay_out(host_num_);
           std::pair<grape::fid_t, grape::InArchive> item;
           while (sending_queue_.Get(item)) {
             if (item.second.GetSize() == 0) {
               continue;
             }
+            fid_sent_bytes_[item.first] += item.second.GetSize();
+            ++fid_sent_buffers_[item.first];
+            int dst_worker = comm_spec_.FragToWorker(item.first);
             if (item.first == fid_) {
               to_self_.emplace_back(std::move(item.second));
+              continue;
+            }
+            int dst_host = worker_host_[dst_worker];
+            if (hierarchical_ && dst_host != host_id_) {
+              auto& out = relay_out[dst_host];
+              if (codec_ != nullptr) {
+                auto buffer = frame(item.second);
+                appendRecord(out, item.first, buffer.data(), buffer.size());
+              } else {
+                appendRecord(out, item.first, item.second.GetBuffer(),
+                             item.second.GetSize());
+              }
+              if (out.size() >= relay_flush_bytes_) {
+                framed.emplace_back(std::move(out));
+                out.clear();
+                IsendChunked(framed.back().data(), framed.back().size(),
+                             proxyOf(dst_host), relayTag(msg_round), comm_,
+                             reqs);
+              }
+            } else if (codec_ != nullptr) {
+              framed.emplace_back(frame(item.second));
+              IsendChunked(framed.back().data(), framed.back().size(),
+                           dst_worker, tag, comm_, reqs);
             } else {
+              IsendChunked(item.second.GetBuffer(), item.second.GetSize(),
+                           dst_worker, tag, comm_, reqs);
+              to_others_.emplace_back(std::move(item.second));
+            }
+          }
+          if (hierarchical_) {
+            for (int host = 0; host < host_num_; ++host) {
+              if (host == host_id_) {
+                continue;
+              }
+              if (!relay_out[host].empty()) {
+                framed.emplace_back(std::move(relay_out[host]));
+                IsendChunked(framed.back().data(), framed.back().size(),
+                             proxyOf(host), relayTag(msg_round), comm_, reqs);
+              }
               MPI_Request req;
-              MPI_Isend(item.second.GetBuffer(), item.second.GetSize(),
-                        MPI_CHAR, comm_spec_.FragToWorker(item.first),
-                        msg_round, comm_, &req);
+              MPI_Isend(NULL, 0, MPI_CHAR, proxyOf(host), relayTag(msg_round),
+                        comm_, &req);
               reqs.push_back(req);
-              to_others_.emplace_back(std::move(item.second));
             }
           }
-          for (grape::fid_t i = 0; i < fnum_; ++i) {
-            if (i == fid_) {
+          for (int worker = 0; worker < comm_spec_.worker_num(); ++worker) {
+            if (worker == comm_spec_.worker_id() ||
+                (hierarchical_ && worker_host_[worker] != host_id_)) {
               continue;
             }
             MPI_Request req;
-            MPI_Isend(NULL, 0, MPI_CHAR, comm_spec_.FragToWorker(i), msg_round,
-                      comm_, &req);
+            MPI_Isend(NULL, 0, MPI_CHAR, worker, tag, comm_, &req);
             reqs.push_back(req);
           }
-          MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+          MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
           to_others_.clear();
+          framed.clear();
         },
         round + 1);
   }
@@ -417,19 +712,185 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
         return;
       }
       int tag = status.MPI_TAG;
+      int queue = tagQueue(tag);
       int count;
       MPI_Get_count(&status, MPI_CHAR, &count);
-      if (count == 0) {
+      if (isRelayTag(tag)) {
+        if (count == 0) {
+          MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, tag, comm_,
+                   MPI_STATUS_IGNORE);
+          if (++relay_finished_[queue] == relay_sender_num_) {
+            finishRelay(queue, forwardTag(queue));
+          }
+        } else {
+          relay_buffers_[queue].emplace_back();
+          RecvChunked(status, comm_, relay_buffers_[queue].back());
+          forwardRecords(queue, forwardTag(queue));
+        }
+      } else if (count == 0) {
         MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, tag, comm_,
                  MPI_STATUS_IGNORE);
-        recv_queues_[tag % 2].DecProducerNum();
+        recv_queues_[queue].DecProducerNum();
+      } else if (codec_ != nullptr) {
+        std::vector<char> buffer;
+        RecvChunked(status, comm_, buffer);
+        recv_queues_[queue].Put(unframe(buffer.data(), buffer.size()));
+      } else {
+        recv_queues_[queue].Put(recvArchive(status));
+      }
+    }
+  }
+
+  // a relayed record is the destination fid, the size and the message as
+  // it would be sent directly.
+  static void appendRecord(std::vector<char>& out, grape::fid_t fid,
+                           const char* data, uint64_t size) {
+    size_t offset = out.size();
+    out.resize(offset + sizeof(grape::fid_t) + sizeof(uint64_t) + size);
+    char* ptr = out.data() + offset;
+    memcpy(ptr, &fid, sizeof(grape::fid_t));
+    memcpy(ptr + sizeof(grape::fid_t), &size, sizeof(uint64_t));
+    memcpy(ptr + sizeof(grape::fid_t) + sizeof(uint64_t), data, size);
+  }
+
+  // delivers the records of the last received relay buffer to this worker
+  // or to the workers on the same host, with the forward tag.
+  void forwardRecords(int queue, int tag) {
+    auto& buffer = relay_buffers_[queue].back();
+    size_t offset = 0;
+    while (offset < buffer.size()) {
+      grape::fid_t fid;
+      uint64_t size;
+      memcpy(&fid, buffer.data() + offset, sizeof(grape::fid_t));
+      offset += sizeof(grape::fid_t);
+      memcpy(&size, buffer.data() + offset, sizeof(uint64_t));
+      offset += sizeof(uint64_t);
+      const char* data = buffer.data() + offset;
+      offset += size;
+      if (fid != fid_) {
+        IsendChunked(data, size, comm_spec_.FragToWorker(fid), tag, comm_,
+                     relay_reqs_[queue]);
+      } else if (codec_ != nullptr) {
+        recv_queues_[queue].Put(unframe(data, size));
       } else {
-        grape::OutArchive arc(count);
-        MPI_Recv(arc.GetBuffer(), count, MPI_CHAR, status.MPI_SOURCE, tag,
-                 comm_, MPI_STATUS_IGNORE);
-        recv_queues_[tag % 2].Put(std::move(arc));
+        grape::OutArchive arc(size);
+        memcpy(arc.GetBuffer(), data, size);
+        recv_queues_[queue].Put(std::move(arc));
+      }
+    }
+    CHECK_EQ(offset, buffer.size());
+  }
+
+  // all senders on other hosts have finished the round, the relaying is
+  // closed as a producer of this worker and the workers on the same host.
+  void finishRelay(int queue, int tag) {
+    auto& reqs = relay_reqs_[queue];
+    MPI_Waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
+    reqs.clear();
+    relay_buffers_[queue].clear();
+    relay_finished_[queue] = 0;
+    for (int worker : host_workers_[host_id_]) {
+      if (worker != comm_spec_.worker_id()) {
+        MPI_Send(NULL, 0, MPI_CHAR, worker, tag, comm_);
+      }
+    }
+    recv_queues_[queue].DecProducerNum();
+  }
+
+  // the worker on the host relaying the messages from this worker
+  int proxyOf(int host) const {
+    auto& workers = host_workers_[host];
+    return workers[local_index_ % workers.size()];
+  }
+
+  // groups the workers by the hosts sharing memory with them
+  void initTopology() {
+    MPI_Comm shared_comm;
+    MPI_Comm_split_type(comm_, MPI_COMM_TYPE_SHARED, comm_spec_.worker_id(),
+                        MPI_INFO_NULL, &shared_comm);
+    int leader = comm_spec_.worker_id();
+    MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, shared_comm);
+    MPI_Comm_free(&shared_comm);
+
+    std::vector<int> leaders(comm_spec_.worker_num());
+    MPI_Allgather(&leader, 1, MPI_INT, leaders.data(), 1, MPI_INT, comm_);
+    groupWorkers(leaders);
+  }
+
+  // the workers in the same group are on the same host, of which the ids
+  // are ordered by the groups
+  void groupWorkers(const std::vector<int>& groups) {
+    int worker_num = comm_spec_.worker_num();
+    std::map<int, int> group_to_host;
+    for (int group : groups) {
+      group_to_host.emplace(group, 0);
+    }
+    host_num_ = 0;
+    for (auto& pair : group_to_host) {
+      pair.second = host_num_++;
+    }
+    worker_host_.resize(worker_num);
+    host_workers_.clear();
+    host_workers_.resize(host_num_);
+    for (int worker = 0; worker < worker_num; ++worker) {
+      worker_host_[worker] = group_to_host[groups[worker]];
+      host_workers_[worker_host_[worker]].push_back(worker);
+    }
+    host_id_ = worker_host_[comm_spec_.worker_id()];
+    auto& local = host_workers_[host_id_];
+    local_index_ = static_cast<int>(
+        std::find(local.begin(), local.end(), comm_spec_.worker_id()) -
+        local.begin());
+  }
+
+  // compresses the buffer if it is large enough and the compressed one is
+  // smaller, and prepends the header.
+  std::vector<char> frame(grape::InArchive& arc) {
+    uint64_t raw_size = arc.GetSize();
+    auto input = reinterpret_cast<const uint8_t*>(arc.GetBuffer());
+    std::vector<char> buffer;
+    bool compressed = false;
+    if (raw_size >= compress_threshold_) {
+      int64_t max_len = codec_->MaxCompressedLen(raw_size, input);
+      buffer.resize(compress_header_size + max_len);
+      auto result = codec_->Compress(
+          raw_size, input, max_len,
+          reinterpret_cast<uint8_t*>(buffer.data() + compress_header_size));
+      if (result.ok() && static_cast<uint64_t>(*result) < raw_size) {
+        buffer.resize(compress_header_size + *result);
+        compressed = true;
       }
     }
+    if (!compressed) {
+      buffer.resize(compress_header_size + raw_size);
+      memcpy(buffer.data() + compress_header_size, arc.GetBuffer(), raw_size);
+    }
+    buffer[0] = compressed ? 1 : 0;
+    memcpy(buffer.data() + 1, &raw_size, sizeof(uint64_t));
+    raw_bytes_ += raw_size;
+    wire_bytes_ += buffer.size() - compress_header_size;
+    return buffer;
+  }
+
+  grape::OutArchive unframe(const char* buffer, size_t size) {
+    CHECK_GE(size, compress_header_size);
+    uint64_t raw_size;
+    memcpy(&raw_size, buffer + 1, sizeof(uint64_t));
+    auto payload =
+        reinterpret_cast<const uint8_t*>(buffer + compress_header_size);
+    int64_t payload_size = size - compress_header_size;
+    grape::OutArchive arc(raw_size);
+    if (buffer[0] != 0) {
+      auto result = codec_->Decompress(
+          payload_size, payload, raw_size,
+          reinterpret_cast<uint8_t*>(arc.GetBuffer()));
+      CHECK(result.ok() && static_cast<uint64_t>(*result) == raw_size)
+          << "Failed to decompress message: " << result.status().ToString();
+    } else {
+      CHECK_EQ(static_cast<uint64_t>(payload_size), raw_size);
+      memcpy(arc.GetBuffer(), payload, raw_size);
+    }
+    return arc;
   }
 
   void startRecvThread() {
@@ -443,12 +904,15 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
 
   inline size_t finishMsgFilling() {
     size_t ret = 0;
+    std::vector<size_t> channel_bytes;
     for (auto& channel : channels_) {
       channel.FlushMessages();
       ret += channel.SentMsgSize();
+      channel_bytes.push_back(channel.SentMsgSize());
       channel.Reset();
     }
     sending_queue_.DecProducerNum();
+    stats_.SetChannelBytes(std::move(channel_bytes));
     return ret;
   }
 
@@ -458,7 +922,7 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
       grape::OutArchive arc;
       while (curr_recv_queue.Get(arc)) {}
     }
-    curr_recv_queue.SetProducerNum(fnum_);
+    curr_recv_queue.SetProducerNum(producer_num_);
   }
 
   void waitSend() { send_thread_.join(); }
@@ -483,6 +947,40 @@ class ParallelPropertyMessageManager : public grape::MessageManagerBase {
   std::array<grape::BlockingQueue<grape::OutArchive>, 2> recv_queues_;
   std::thread recv_thread_;
 
+  // threads of ParallelProcess, kept across rounds
+  ThreadPool thread_pool_;
+
+  // hosts of the workers, and the state of the hierarchical routing
+  int host_num_ = 1;
+  int host_id_ = 0;
+  int local_index_ = 0;
+  std::vector<int> worker_host_;
+  std::vector<std::vector<int>> host_workers_;
+  bool hierarchical_ = false;
+  size_t relay_flush_bytes_ = default_msg_send_block_size;
+  size_t producer_num_ = 0;
+  int relay_sender_num_ = 0;
+  std::array<int, 2> relay_finished_;
+  std::array<std::vector<std::vector<char>>, 2> relay_buffers_;
+  std::array<std::vector<MPI_Request>, 2> relay_reqs_;
+
+  std::unique_ptr<arrow::util::Codec> codec_;
+  size_t compress_threshold_ = default_compress_threshold;
+  std::chrono::microseconds flush_interval_ =
+      std::chrono::microseconds::zero();
+  // overrides the block size of InitChannels() if not zero
+  size_t block_size_ = 0;
+  // bytes of the messages to other workers in the last round, before and
+  // after compression
+  size_t raw_bytes_ = 0;
+  size_t wire_bytes_ = 0;
+
+  RoundStatsRecorder stats_;
+  // messages to each fragment in the last round, counted by the sending
+  // thread
+  std::vector<size_t> fid_sent_bytes_;
+  std::vector<size_t> fid_sent_buffers_;
+
   bool force_continue_;
   size_t sent_size_;
 
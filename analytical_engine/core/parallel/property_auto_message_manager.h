@@ -21,6 +21,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <thread>
 #include <typeinfo>
 #include <utility>
 #include <vector>
@@ -36,6 +37,8 @@
 #include "grape/worker/comm_spec.h"
 
 #include "core/config.h"
+#include "core/parallel/round_stats.h"
+#include "core/parallel/thread_pool.h"
 
 namespace gs {
 
@@ -45,6 +48,12 @@ namespace gs {
  * After registering the vertex array and message strategy as a sync buffer,
  * message generation and ingestion can be applied by message manager
  * automatically.
+ *
+ * Both are done by multiple threads: the updated outer vertices are scanned
+ * in chunks into per-thread arrays of gids and values, which are sent as a
+ * whole to each fragment, and the received updates are bucketed by the
+ * destination vertex so that each thread aggregates a disjoint set of
+ * vertices.
  */
 template <typename FRAG_T>
 class PropertyAutoMessageManager : public grape::DefaultMessageManager {
@@ -65,18 +74,47 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   };
 
  public:
-  PropertyAutoMessageManager() {}
+  PropertyAutoMessageManager()
+      : thread_num_(std::max(1u, std::thread::hardware_concurrency())) {}
   ~PropertyAutoMessageManager() override {}
 
-  using Base::Init;
+  /**
+   * @brief Inherit
+   */
+  void Init(MPI_Comm comm) override {
+    Base::Init(comm);
+    stats_.Init(Base::fnum());
+    grape::CommSpec comm_spec;
+    comm_spec.Init(comm);
+    thread_num_ = std::max(
+        1, static_cast<int>((std::thread::hardware_concurrency() +
+                             comm_spec.local_num() - 1) /
+                            comm_spec.local_num()));
+  }
 
-  using Base::Start;
+  /**
+   * @brief Sets the number of threads generating and aggregating the
+   * messages.
+   */
+  void SetThreadNum(int thread_num) { thread_num_ = std::max(1, thread_num); }
 
   /**
    * @brief Inherit
    */
+  void Start() override {
+    stats_.Clear();
+    Base::Start();
+  }
+
+  /**
+   * @brief Inherit
+   *
+   * The aggregation of the received messages is counted in the compute time
+   * of the round, and the generation of the messages in the finish time.
+   */
   void StartARound() override {
     Base::StartARound();
+    stats_.StartCompute();
     aggregateAutoMessages();
   }
 
@@ -84,8 +122,13 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
    * @brief Inherit
    */
   void FinishARound() override {
+    stats_.FinishCompute();
     generateAutoMessages();
+    for (fid_t fid = 0; fid < Base::fnum(); ++fid) {
+      stats_.AddSent(fid, to_send_[fid].GetSize());
+    }
     Base::FinishARound();
+    stats_.FinishRound();
   }
 
   using Base::ToTerminate;
@@ -96,6 +139,16 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
 
   using Base::ForceContinue;
 
+  /**
+   * @brief The stats of the rounds of the last query.
+   */
+  const RoundStatsRecorder& GetRoundStats() const { return stats_; }
+
+  /**
+   * @brief Adds to the active vertices of the current round in the stats.
+   */
+  void AddActiveVertices(size_t num) { stats_.AddActiveVertices(num); }
+
   /**
    * @brief Register a buffer to be sync automatically between rounds.
    *
@@ -303,36 +356,69 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   }
   */
 
+  // runs func(tid, begin, end) on thread_num_ contiguous chunks of [0, size)
+  template <typename FUNC_T>
+  inline void parallelChunks(size_t size, const FUNC_T& func) {
+    int thread_num = thread_num_;
+    size_t chunk = (size + thread_num - 1) / thread_num;
+    thread_pool_.ParallelRun(thread_num, [&](int tid) {
+      size_t begin = std::min(size, tid * chunk);
+      size_t end = std::min(size, begin + chunk);
+      func(tid, begin, end);
+    });
+  }
+
+  // the updates of an event to a fragment are sent as the event id followed
+  // by an array of gids and an array of values.
   template <typename T>
   inline void syncOnOuterVertexSend(const FRAG_T& frag, label_id_t label,
                                     grape::ISyncBuffer* buffer, int event_id) {
     auto* bptr = dynamic_cast<grape::SyncBuffer<T, vid_t>*>(buffer);
     auto inner_vertices = frag.InnerVertices(label);
     auto outer_vertices = frag.OuterVertices(label);
-    std::vector<size_t> message_num(Base::fnum(), 0);
-
-    for (auto v : inner_vertices) {
-      bptr->Reset(v);
-    }
-
-    for (auto v : outer_vertices) {
-      if (bptr->IsUpdated(v)) {
-        fid_t fid = frag.GetFragId(v);
-        ++message_num[fid];
+    fid_t fnum = Base::fnum();
+    int thread_num = thread_num_;
+    // [tid][fid]
+    std::vector<std::vector<std::vector<vid_t>>> gids(
+        thread_num, std::vector<std::vector<vid_t>>(fnum));
+    std::vector<std::vector<std::vector<T>>> values(
+        thread_num, std::vector<std::vector<T>>(fnum));
+
+    parallelChunks(inner_vertices.size(),
+                   [&](int, size_t begin, size_t end) {
+                     auto iter = inner_vertices.begin() + begin;
+                     for (size_t i = begin; i < end; ++i, ++iter) {
+                       bptr->Reset(*iter);
+                     }
+                   });
+
+    parallelChunks(
+        outer_vertices.size(), [&](int tid, size_t begin, size_t end) {
+          auto iter = outer_vertices.begin() + begin;
+          for (size_t i = begin; i < end; ++i, ++iter) {
+            auto v = *iter;
+            if (bptr->IsUpdated(v)) {
+              fid_t fid = frag.GetFragId(v);
+              gids[tid][fid].push_back(frag.GetOuterVertexGid(v));
+              values[tid][fid].push_back(bptr->GetValue(v));
+              bptr->Reset(v);
+            }
+          }
+        });
+
+    for (fid_t i = 0; i < fnum; i++) {
+      std::vector<vid_t> fid_gids;
+      std::vector<T> fid_values;
+      for (int tid = 0; tid < thread_num; ++tid) {
+        fid_gids.insert(fid_gids.end(), gids[tid][i].begin(),
+                        gids[tid][i].end());
+        fid_values.insert(fid_values.end(), values[tid][i].begin(),
+                          values[tid][i].end());
       }
-    }
-
-    for (fid_t i = 0; i < Base::fnum(); i++) {
-      if (message_num[i] > 0) {
+      if (!fid_gids.empty()) {
         Base::SendToFragment<int>(i, event_id);
-        Base::SendToFragment<size_t>(i, message_num[i]);
-      }
-    }
-
-    for (auto v : outer_vertices) {
-      if (bptr->IsUpdated(v)) {
-        Base::SyncStateOnOuterVertex(frag, v, bptr->GetValue(v));
-        bptr->Reset(v);
+        Base::SendToFragment<std::vector<vid_t>>(i, fid_gids);
+        Base::SendToFragment<std::vector<T>>(i, fid_values);
       }
     }
   }
@@ -341,17 +427,40 @@ class PropertyAutoMessageManager : public grape::DefaultMessageManager {
   inline void syncOnVertexRecv(const FRAG_T& frag, grape::ISyncBuffer* buffer) {
     auto* bptr = dynamic_cast<grape::SyncBuffer<T, vid_t>*>(buffer);
 
-    size_t message_num = 0;
-    T rhs;
-    grape::Vertex<vid_t> v(0);
-    Base::GetMessage<size_t>(message_num);
-    while (message_num--) {
-      GetMessage(frag, v, rhs);
-      bptr->Aggregate(v, std::move(rhs));
-    }
+    std::vector<vid_t> gids;
+    std::vector<T> values;
+    Base::GetMessage<std::vector<vid_t>>(gids);
+    Base::GetMessage<std::vector<T>>(values);
+    CHECK_EQ(gids.size(), values.size());
+
+    // bucket the updates by the destination vertex, then each thread
+    // aggregates one bucket, so that no vertex is aggregated concurrently.
+    int thread_num = thread_num_;
+    std::vector<std::vector<std::vector<std::pair<vid_t, size_t>>>> buckets(
+        thread_num,
+        std::vector<std::vector<std::pair<vid_t, size_t>>>(thread_num));
+    parallelChunks(gids.size(), [&](int tid, size_t begin, size_t end) {
+      grape::Vertex<vid_t> v(0);
+      for (size_t i = begin; i < end; ++i) {
+        CHECK(frag.Gid2Vertex(gids[i], v));
+        buckets[tid][v.GetValue() % thread_num].emplace_back(v.GetValue(), i);
+      }
+    });
+    thread_pool_.ParallelRun(thread_num, [&](int tid) {
+      grape::Vertex<vid_t> v(0);
+      for (int src = 0; src < thread_num; ++src) {
+        for (auto& pair : buckets[src][tid]) {
+          v.SetValue(pair.first);
+          bptr->Aggregate(v, std::move(values[pair.second]));
+        }
+      }
+    });
   }
 
   std::vector<ap_event> auto_parallel_events_;
+  int thread_num_;
+  ThreadPool thread_pool_;
+  RoundStatsRecorder stats_;
 };
 
 }  // namespace gs
@@ -19,6 +19,8 @@
 #include "grape/graph/adj_list.h"
 #include "grape/parallel/default_message_manager.h"
 
+#include "core/parallel/round_stats.h"
+
 namespace gs {
 
 /**
@@ -27,7 +29,55 @@ namespace gs {
  * The send and recv methods are not thread-safe.
  */
 class PropertyMessageManager : public grape::DefaultMessageManager {
+  using Base = grape::DefaultMessageManager;
+
  public:
+  /**
+   * @brief Inherit
+   */
+  void Init(MPI_Comm comm) override {
+    Base::Init(comm);
+    stats_.Init(fnum());
+  }
+
+  /**
+   * @brief Inherit
+   */
+  void Start() override {
+    stats_.Clear();
+    Base::Start();
+  }
+
+  /**
+   * @brief Inherit
+   */
+  void StartARound() override {
+    Base::StartARound();
+    stats_.StartCompute();
+  }
+
+  /**
+   * @brief Inherit
+   */
+  void FinishARound() override {
+    stats_.FinishCompute();
+    for (grape::fid_t fid = 0; fid < fnum(); ++fid) {
+      stats_.AddSent(fid, to_send_[fid].GetSize());
+    }
+    Base::FinishARound();
+    stats_.FinishRound();
+  }
+
+  /**
+   * @brief The stats of the rounds of the last query.
+   */
+  const RoundStatsRecorder& GetRoundStats() const { return stats_; }
+
+  /**
+   * @brief Adds to the active vertices of the current round in the stats.
+   */
+  void AddActiveVertices(size_t num) { stats_.AddActiveVertices(num); }
+
   /**
    * @brief Communication via a crossing edge a<-c. It sends message
    * from a to c.
@@ -99,6 +149,9 @@ class PropertyMessageManager : public grape::DefaultMessageManager {
       to_send_[fid] << gid << msg;
     }
   }
+
+ private:
+  RoundStatsRecorder stats_;
 };
 
 }  // namespace gs
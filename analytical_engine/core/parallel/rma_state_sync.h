@@ -0,0 +1,183 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_RMA_STATE_SYNC_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_RMA_STATE_SYNC_H_
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "vineyard/graph/fragment/property_graph_types.h"
+
+namespace gs {
+
+namespace rma_state_sync_impl {
+
+template <typename T>
+struct MPIType {};
+
+#define RMA_STATE_SYNC_MPI_TYPE(type, mpi_type)    \
+  template <>                                      \
+  struct MPIType<type> {                           \
+    static MPI_Datatype get() { return mpi_type; } \
+  };
+
+RMA_STATE_SYNC_MPI_TYPE(int32_t, MPI_INT32_T)
+RMA_STATE_SYNC_MPI_TYPE(uint32_t, MPI_UINT32_T)
+RMA_STATE_SYNC_MPI_TYPE(int64_t, MPI_INT64_T)
+RMA_STATE_SYNC_MPI_TYPE(uint64_t, MPI_UINT64_T)
+RMA_STATE_SYNC_MPI_TYPE(float, MPI_FLOAT)
+RMA_STATE_SYNC_MPI_TYPE(double, MPI_DOUBLE)
+
+#undef RMA_STATE_SYNC_MPI_TYPE
+
+}  // namespace rma_state_sync_impl
+
+/**
+ * @brief RMAStateSync syncs the states of the outer vertices to their owners
+ * by the one-sided accumulates of MPI-3, for the apps combining them by a
+ * predefined op, e.g., MPI_MIN for the components in WCC, as the
+ * SyncStateOnOuterVertex of the message managers does by the messages.
+ *
+ * Each worker exposes a window of the slots of its inner vertices, and a
+ * sender accumulates the state of an outer vertex into the slot of it on the
+ * owner directly, so the owners neither receive nor decode the messages, and
+ * the states to a vertex from all the senders are combined there. The slots
+ * are doubled and by turns by the parity of the rounds, so the ones of the
+ * last round are read while the others are accumulated into, and a round is
+ * fenced by a flush and an allreduce of whether any state was sent, without
+ * the per round exchange of the lengths of the messages.
+ *
+ * The window is opened by Init and freed by Finalize, both collective, in the
+ * communicator of the app. The states must be of a type of MPIType, and the
+ * identity of the op is taken as no state in the slots.
+ *
+ * @tparam FRAG_T
+ * @tparam STATE_T
+ */
+template <typename FRAG_T, typename STATE_T>
+class RMAStateSync {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  RMAStateSync() = default;
+
+  ~RMAStateSync() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+      Finalize();
+    }
+  }
+
+  void Init(const FRAG_T& frag, MPI_Comm comm, MPI_Op op,
+            const STATE_T& identity) {
+    Finalize();
+    comm_ = comm;
+    op_ = op;
+    identity_ = identity;
+    parity_ = 0;
+    id_parser_.Init(frag.fnum(), 1);
+
+    size_t slot_num = 2 * frag.GetInnerVerticesNum();
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "accumulate_ops", "same_op");
+    MPI_Win_allocate(slot_num * sizeof(STATE_T), sizeof(STATE_T), info, comm_,
+                     &slots_, &win_);
+    MPI_Info_free(&info);
+    for (size_t i = 0; i < slot_num; ++i) {
+      slots_[i] = identity_;
+    }
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+    MPI_Win_sync(win_);
+    MPI_Barrier(comm_);
+  }
+
+  /**
+   * @brief Accumulates the state of an outer vertex into the slot of it on
+   * its owner, for the current round. The slots are by the lids of the inner
+   * vertices, which are from 0 on the owners.
+   */
+  void Accumulate(const FRAG_T& frag, const vertex_t& v,
+                  const STATE_T& state) {
+    int owner = static_cast<int>(frag.GetFragId(v));
+    auto lid = id_parser_.GetOffset(frag.Vertex2Gid(v));
+    MPI_Aint disp = static_cast<MPI_Aint>(2 * lid + parity_);
+    auto type = rma_state_sync_impl::MPIType<STATE_T>::get();
+    MPI_Accumulate(&state, 1, type, owner, disp, 1, type, op_, win_);
+    sent_ = true;
+  }
+
+  /**
+   * @brief Fences the round, collectively, and returns whether any worker
+   * accumulated in it, in which case the messages are forced to continue, for
+   * the states to be received in the next round.
+   */
+  template <typename MESSAGE_MANAGER_T>
+  bool FinishRound(MESSAGE_MANAGER_T& messages) {
+    MPI_Win_flush_all(win_);
+    int local = sent_ ? 1 : 0, global = 0;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_LOR, comm_);
+    MPI_Win_sync(win_);
+    sent_ = false;
+    parity_ ^= 1;
+    if (global != 0) {
+      messages.ForceContinue();
+    }
+    return global != 0;
+  }
+
+  /**
+   * @brief Calls func(v, state) for each inner vertex with the state
+   * accumulated into it in the last round, and clears the slots of them.
+   */
+  template <typename FUNC_T>
+  void ForEachReceived(const FRAG_T& frag, const FUNC_T& func) {
+    size_t slot_num = 2 * frag.GetInnerVerticesNum();
+    for (size_t i = parity_ ^ 1; i < slot_num; i += 2) {
+      if (slots_[i] != identity_) {
+        func(vertex_t(static_cast<vid_t>(i / 2)), slots_[i]);
+        slots_[i] = identity_;
+      }
+    }
+    MPI_Win_sync(win_);
+  }
+
+  void Finalize() {
+    if (win_ != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(win_);
+      MPI_Win_free(&win_);
+      slots_ = nullptr;
+    }
+  }
+
+ private:
+  MPI_Comm comm_ = MPI_COMM_NULL;
+  MPI_Op op_ = MPI_NO_OP;
+  MPI_Win win_ = MPI_WIN_NULL;
+  STATE_T* slots_ = nullptr;
+  STATE_T identity_{};
+  int parity_ = 0;
+  bool sent_ = false;
+  vineyard::IdParser<vid_t> id_parser_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_RMA_STATE_SYNC_H_
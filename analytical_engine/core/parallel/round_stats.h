@@ -0,0 +1,183 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_ROUND_STATS_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_ROUND_STATS_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gs {
+
+/**
+ * @brief The stats of a round of a worker, collected by the message managers.
+ */
+struct RoundStats {
+  int round = 0;
+  // seconds between StartARound and FinishARound, i.e., in PEval or IncEval
+  double compute_time = 0;
+  // seconds in FinishARound, flushing the messages and waiting for the
+  // other workers
+  double finish_time = 0;
+  // bytes and buffers of the messages sent to each fragment
+  std::vector<size_t> sent_bytes;
+  std::vector<size_t> sent_buffers;
+  // bytes of the messages sent by each channel, i.e., each thread, if the
+  // message manager has channels
+  std::vector<size_t> channel_bytes;
+  // vertices reported active by the app in the round, see
+  // RoundStatsRecorder::AddActiveVertices
+  size_t active_vertex_num = 0;
+  // bytes of the messages to other workers before and after compression, if
+  // the message manager compresses them
+  size_t raw_bytes = 0;
+  size_t wire_bytes = 0;
+
+  size_t total_sent_bytes() const {
+    return std::accumulate(sent_bytes.begin(), sent_bytes.end(), size_t(0));
+  }
+
+  void ToJSON(std::ostream& os) const {
+    auto array = [&os](const char* name, const std::vector<size_t>& values) {
+      os << ", \"" << name << "\": [";
+      for (size_t i = 0; i < values.size(); ++i) {
+        os << (i == 0 ? "" : ", ") << values[i];
+      }
+      os << "]";
+    };
+    os << "{\"round\": " << round << ", \"compute_time\": " << compute_time
+       << ", \"finish_time\": " << finish_time;
+    array("sent_bytes", sent_bytes);
+    array("sent_buffers", sent_buffers);
+    array("channel_bytes", channel_bytes);
+    os << ", \"active_vertex_num\": " << active_vertex_num
+       << ", \"raw_bytes\": " << raw_bytes << ", \"wire_bytes\": " << wire_bytes
+       << "}";
+  }
+};
+
+/**
+ * @brief Records a RoundStats for each round of a query, driven by the
+ * message manager: StartCompute at the end of StartARound, FinishCompute at
+ * the beginning of FinishARound and FinishRound at the end of it. The sent
+ * messages of a round may be added until the next round starts.
+ *
+ * AddActiveVertices is thread-safe, the others must be called by the thread
+ * driving the rounds.
+ */
+class RoundStatsRecorder {
+  using clock_t = std::chrono::steady_clock;
+
+ public:
+  void Init(size_t fnum) {
+    fnum_ = fnum;
+    rounds_.clear();
+  }
+
+  void Clear() { rounds_.clear(); }
+
+  void StartCompute() {
+    rounds_.emplace_back();
+    auto& stats = rounds_.back();
+    stats.round = static_cast<int>(rounds_.size()) - 1;
+    stats.sent_bytes.resize(fnum_, 0);
+    stats.sent_buffers.resize(fnum_, 0);
+    active_vertex_num_ = 0;
+    start_ = clock_t::now();
+  }
+
+  void FinishCompute() {
+    auto now = clock_t::now();
+    if (rounds_.empty()) {
+      return;
+    }
+    auto& stats = rounds_.back();
+    stats.compute_time = seconds(start_, now);
+    stats.active_vertex_num = active_vertex_num_.load();
+    start_ = now;
+  }
+
+  void FinishRound() {
+    if (!rounds_.empty()) {
+      rounds_.back().finish_time = seconds(start_, clock_t::now());
+    }
+  }
+
+  // adds the messages sent to fid in the last round
+  void AddSent(size_t fid, size_t bytes, size_t buffers = 1) {
+    if (!rounds_.empty() && fid < fnum_ && bytes != 0) {
+      rounds_.back().sent_bytes[fid] += bytes;
+      rounds_.back().sent_buffers[fid] += buffers;
+    }
+  }
+
+  void AddSent(const std::vector<size_t>& bytes,
+               const std::vector<size_t>& buffers) {
+    for (size_t fid = 0; fid < std::min(bytes.size(), fnum_); ++fid) {
+      AddSent(fid, bytes[fid], buffers[fid]);
+    }
+  }
+
+  // adds the compressed messages of the last round
+  void AddCompressed(size_t raw_bytes, size_t wire_bytes) {
+    if (!rounds_.empty()) {
+      rounds_.back().raw_bytes += raw_bytes;
+      rounds_.back().wire_bytes += wire_bytes;
+    }
+  }
+
+  void SetChannelBytes(std::vector<size_t>&& bytes) {
+    if (!rounds_.empty()) {
+      rounds_.back().channel_bytes = std::move(bytes);
+    }
+  }
+
+  void AddActiveVertices(size_t num) { active_vertex_num_ += num; }
+
+  const std::vector<RoundStats>& rounds() const { return rounds_; }
+
+  std::string ToJSON() const {
+    std::ostringstream os;
+    os << "[";
+    for (size_t i = 0; i < rounds_.size(); ++i) {
+      os << (i == 0 ? "" : ", ");
+      rounds_[i].ToJSON(os);
+    }
+    os << "]";
+    return os.str();
+  }
+
+ private:
+  static double seconds(clock_t::time_point begin, clock_t::time_point end) {
+    return std::chrono::duration<double>(end - begin).count();
+  }
+
+  size_t fnum_ = 0;
+  std::vector<RoundStats> rounds_;
+  std::atomic<size_t> active_vertex_num_{0};
+  clock_t::time_point start_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_ROUND_STATS_H_
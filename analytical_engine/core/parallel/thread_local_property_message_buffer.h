@@ -16,15 +16,99 @@
 #ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_LOCAL_PROPERTY_MESSAGE_BUFFER_H_
 #define ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_LOCAL_PROPERTY_MESSAGE_BUFFER_H_
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <typeindex>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "flat_hash_map/flat_hash_map.hpp"
+
 #include "grape/graph/adj_list.h"
 #include "grape/serialization/in_archive.h"
 
 namespace gs {
 
+/**
+ * @brief Combiners for CombineStateOnOuterVertex, a combiner merges msg into
+ * the pending message acc of the same destination.
+ */
+struct MinCombiner {
+  template <typename MESSAGE_T>
+  void operator()(MESSAGE_T& acc, const MESSAGE_T& msg) const {
+    acc = std::min(acc, msg);
+  }
+};
+
+struct MaxCombiner {
+  template <typename MESSAGE_T>
+  void operator()(MESSAGE_T& acc, const MESSAGE_T& msg) const {
+    acc = std::max(acc, msg);
+  }
+};
+
+struct SumCombiner {
+  template <typename MESSAGE_T>
+  void operator()(MESSAGE_T& acc, const MESSAGE_T& msg) const {
+    acc += msg;
+  }
+};
+
+namespace message_buffer_impl {
+
+class CombineBufferBase {
+ public:
+  virtual ~CombineBufferBase() = default;
+  // appends the combined messages to the archive of each fragment
+  virtual void Flush(std::vector<grape::InArchive>& to_send) = 0;
+};
+
+template <typename VID_T, typename MESSAGE_T, typename COMBINER_T>
+class CombineBuffer : public CombineBufferBase {
+ public:
+  // the pending messages to a fragment are bounded by block_size, taking
+  // sizeof(VID_T) + sizeof(MESSAGE_T) bytes each
+  CombineBuffer(grape::fid_t fnum, size_t block_size)
+      : pending_(fnum),
+        max_pending_num_(std::max(
+            block_size / (sizeof(VID_T) + sizeof(MESSAGE_T)), size_t(1))) {}
+
+  // returns true once the pending messages to fid reach the bound, which are
+  // to be flushed then
+  inline bool Add(grape::fid_t fid, VID_T gid, const MESSAGE_T& msg,
+                  const COMBINER_T& combiner) {
+    auto& pending = pending_[fid];
+    auto iter = pending.find(gid);
+    if (iter == pending.end()) {
+      pending.emplace(gid, msg);
+    } else {
+      combiner(iter->second, msg);
+    }
+    return pending.size() >= max_pending_num_;
+  }
+
+  inline void Flush(grape::fid_t fid, grape::InArchive& arc) {
+    for (auto& pair : pending_[fid]) {
+      arc << pair.first << pair.second;
+    }
+    pending_[fid].clear();
+  }
+
+  void Flush(std::vector<grape::InArchive>& to_send) override {
+    for (size_t fid = 0; fid < pending_.size(); ++fid) {
+      Flush(fid, to_send[fid]);
+    }
+  }
+
+ private:
+  std::vector<ska::flat_hash_map<VID_T, MESSAGE_T>> pending_;
+  size_t max_pending_num_;
+};
+
+}  // namespace message_buffer_impl
+
 /**
  * @brief ThreadLocalPropertyMessageBuffer provides buffers for label fragment
  * for a thread. Every thead should use individual
@@ -48,6 +132,7 @@ class ThreadLocalPropertyMessageBuffer {
 
     to_send_.clear();
     to_send_.resize(fnum_);
+    combine_buffers_.clear();
 
     block_size_ = block_size;
     block_cap_ = block_cap;
@@ -57,6 +142,19 @@ class ThreadLocalPropertyMessageBuffer {
     }
 
     sent_size_ = 0;
+    flush_interval_ = std::chrono::microseconds::zero();
+    pending_msg_num_ = 0;
+  }
+
+  /**
+   * @brief Enables flushing the partial blocks if they have been held for
+   * longer than interval, so that the receivers get messages earlier in a
+   * round. The elapsed time is checked every kFlushCheckPeriod messages.
+   * A zero interval disables it.
+   */
+  void SetFlushInterval(std::chrono::microseconds interval) {
+    flush_interval_ = interval;
+    last_flush_ = std::chrono::steady_clock::now();
   }
 
   /**
@@ -82,6 +180,42 @@ class ThreadLocalPropertyMessageBuffer {
     if (to_send_[fid].GetSize() > block_size_) {
       flushLocalBuffer(fid);
     }
+    checkFlush();
+  }
+
+  /**
+   * @brief Like SyncStateOnOuterVertex, but messages to the same outer vertex
+   * are merged by the combiner locally, and sent at FlushMessages(), or once
+   * the pending ones to a fragment take a block, so the messages to the
+   * vertices flushed may be sent more than once in a round.
+   *
+   * @tparam GRAPH_T Graph type.
+   * @tparam MESSAGE_T Message type.
+   * @tparam COMBINER_T Combiner type, see MinCombiner.
+   * @param frag Source fragment.
+   * @param v: a
+   * @param msg
+   * @param combiner
+   */
+  template <typename GRAPH_T, typename MESSAGE_T, typename COMBINER_T>
+  inline void CombineStateOnOuterVertex(const GRAPH_T& frag,
+                                        const typename GRAPH_T::vertex_t& v,
+                                        const MESSAGE_T& msg,
+                                        const COMBINER_T& combiner) {
+    using buffer_t =
+        message_buffer_impl::CombineBuffer<typename GRAPH_T::vid_t, MESSAGE_T,
+                                           COMBINER_T>;
+    auto& base = combine_buffers_[std::type_index(typeid(buffer_t))];
+    if (!base) {
+      base.reset(new buffer_t(fnum_, block_size_));
+    }
+    auto* buffer = static_cast<buffer_t*>(base.get());
+    grape::fid_t fid = frag.GetFragId(v);
+    if (buffer->Add(fid, frag.GetOuterVertexGid(v), msg, combiner)) {
+      buffer->Flush(fid, to_send_[fid]);
+      flushLocalBuffer(fid);
+    }
+    checkFlush();
   }
 
   template <typename GRAPH_T>
@@ -92,6 +226,7 @@ class ThreadLocalPropertyMessageBuffer {
     if (to_send_[fid].GetSize() > block_size_) {
       flushLocalBuffer(fid);
     }
+    checkFlush();
   }
 
   /**
@@ -119,6 +254,7 @@ class ThreadLocalPropertyMessageBuffer {
         flushLocalBuffer(fid);
       }
     }
+    checkFlush();
   }
 
   /**
@@ -146,6 +282,7 @@ class ThreadLocalPropertyMessageBuffer {
         flushLocalBuffer(fid);
       }
     }
+    checkFlush();
   }
 
   /**
@@ -173,6 +310,7 @@ class ThreadLocalPropertyMessageBuffer {
         flushLocalBuffer(fid);
       }
     }
+    checkFlush();
   }
 
   /**
@@ -191,9 +329,11 @@ class ThreadLocalPropertyMessageBuffer {
    * @brief Flush messages to message manager.
    */
   inline void FlushMessages() {
+    for (auto& pair : combine_buffers_) {
+      pair.second->Flush(to_send_);
+    }
     for (grape::fid_t fid = 0; fid < fnum_; ++fid) {
       if (to_send_[fid].GetSize() > 0) {
-        sent_size_ += to_send_[fid].GetSize();
         flushLocalBuffer(fid);
       }
     }
@@ -204,12 +344,39 @@ class ThreadLocalPropertyMessageBuffer {
   inline void Reset() { sent_size_ = 0; }
 
  private:
+  static constexpr size_t kFlushCheckPeriod = 1024;
+
+  // sent_size_ counts the blocks flushed before FlushMessages() too, so that
+  // a round whose messages are all flushed early isn't taken as silent.
   inline void flushLocalBuffer(grape::fid_t fid) {
+    sent_size_ += to_send_[fid].GetSize();
     mm_->SendRawMsgByFid(fid, std::move(to_send_[fid]));
     to_send_[fid].Reserve(block_cap_);
   }
 
+  inline void checkFlush() {
+    if (flush_interval_ == std::chrono::microseconds::zero() ||
+        ++pending_msg_num_ < kFlushCheckPeriod) {
+      return;
+    }
+    pending_msg_num_ = 0;
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_flush_ < flush_interval_) {
+      return;
+    }
+    last_flush_ = now;
+    for (grape::fid_t fid = 0; fid < fnum_; ++fid) {
+      if (to_send_[fid].GetSize() > 0) {
+        flushLocalBuffer(fid);
+      }
+    }
+  }
+
   std::vector<grape::InArchive> to_send_;
+  // pending messages of CombineStateOnOuterVertex, by the buffer type
+  std::unordered_map<std::type_index,
+                     std::unique_ptr<message_buffer_impl::CombineBufferBase>>
+      combine_buffers_;
   MM_T* mm_;
   grape::fid_t fnum_;
 
@@ -217,6 +384,10 @@ class ThreadLocalPropertyMessageBuffer {
   size_t block_cap_;
 
   size_t sent_size_;
+
+  std::chrono::microseconds flush_interval_;
+  std::chrono::steady_clock::time_point last_flush_;
+  size_t pending_msg_num_;
 };
 
 }  // namespace gs
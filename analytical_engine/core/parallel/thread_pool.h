@@ -0,0 +1,124 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_POOL_H_
+#define ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gs {
+
+/**
+ * @brief A fork-join pool of long-lived threads. ParallelRun(n, func) runs
+ * func(tid) for each tid in [0, n) and returns after all of them finish,
+ * tid 0 runs on the calling thread. Threads are created on demand and kept
+ * until the pool is destroyed, so that running a batch of tasks every round
+ * doesn't pay for creating and joining threads.
+ *
+ * ParallelRun must not be called concurrently or recursively on the same
+ * pool.
+ */
+class ThreadPool {
+ public:
+  ThreadPool() = default;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& thrd : threads_) {
+      thrd.join();
+    }
+  }
+
+  template <typename FUNC_T>
+  void ParallelRun(int thread_num, const FUNC_T& func) {
+    if (thread_num <= 1) {
+      func(0);
+      return;
+    }
+    while (static_cast<int>(threads_.size()) < thread_num - 1) {
+      int index = static_cast<int>(threads_.size());
+      threads_.emplace_back([this, index]() { workerLoop(index); });
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      task_ = [&func](int tid) { func(tid); };
+      active_num_ = thread_num - 1;
+      pending_num_ = thread_num - 1;
+      ++generation_;
+    }
+    start_cv_.notify_all();
+
+    func(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    finish_cv_.wait(lock, [this]() { return pending_num_ == 0; });
+    task_ = nullptr;
+  }
+
+  int Size() const { return static_cast<int>(threads_.size()) + 1; }
+
+ private:
+  void workerLoop(int index) {
+    uint64_t seen_generation = 0;
+    while (true) {
+      std::function<void(int)> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_cv_.wait(lock, [&]() {
+          return stopped_ ||
+                 (generation_ != seen_generation && index < active_num_);
+        });
+        if (stopped_) {
+          return;
+        }
+        seen_generation = generation_;
+        task = task_;
+      }
+      task(index + 1);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --pending_num_;
+      }
+      finish_cv_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable finish_cv_;
+  std::function<void(int)> task_;
+  uint64_t generation_ = 0;
+  int active_num_ = 0;
+  int pending_num_ = 0;
+  bool stopped_ = false;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_PARALLEL_THREAD_POOL_H_
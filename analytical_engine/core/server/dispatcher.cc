@@ -15,16 +15,54 @@
 
 #include "core/server/dispatcher.h"
 
+#include <algorithm>
+
+#include "core/communication/chunked_comm.h"
+
 namespace gs {
 
-Dispatcher::Dispatcher(const grape::CommSpec& comm_spec)
+static constexpr int kDispatchResultTag = 0x5d;
+static constexpr int kPointCmdTag = 0x5e;
+static constexpr int kPointResultTag = 0x5f;
+
+// the lane running on the thread
+static thread_local const grape::CommSpec* tls_lane_comm_spec = nullptr;
+
+Dispatcher::Dispatcher(const grape::CommSpec& comm_spec, int lane_num)
     : running_(false), comm_spec_(comm_spec) {
+  CHECK_GE(lane_num, 1);
   // a naive implementation using MPI
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
-  // we use blocking queue as synchronizer
-  if (publisher) {
-    cmd_queue_.SetLimit(1);
-    result_queue_.SetLimit(1);
+  for (int i = 0; i < lane_num; ++i) {
+    auto lane = std::make_unique<Lane>();
+    if (i == 0) {
+      lane->comm_spec = comm_spec_;
+    } else {
+      // the other lanes have their own communicators
+      MPI_Comm comm;
+      MPI_Comm_dup(comm_spec_.comm(), &comm);
+      lane_comms_.push_back(comm);
+      lane->comm_spec.Init(comm);
+    }
+    // we use blocking queue as synchronizer
+    if (publisher) {
+      lane->cmd_queue.SetLimit(1);
+      lane->result_queue.SetLimit(1);
+    }
+    lanes_.push_back(std::move(lane));
+  }
+  MPI_Comm_dup(comm_spec_.comm(), &point_comm_);
+  local_comm_spec_.Init(MPI_COMM_SELF);
+}
+
+Dispatcher::~Dispatcher() {
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (!finalized) {
+    for (auto& comm : lane_comms_) {
+      MPI_Comm_free(&comm);
+    }
+    MPI_Comm_free(&point_comm_);
   }
 }
 
@@ -35,20 +73,143 @@ void Dispatcher::Start() {
   running_ = true;
   auto publisher = comm_spec_.worker_id() == grape::kCoordinatorRank;
 
-  if (publisher) {
-    auto publisher_th = std::thread([this]() { publisherLoop(); });
-    publisher_th.join();
-  } else {
-    auto subscriber_th = std::thread([this]() { subscriberLoop(); });
-    subscriber_th.join();
+  std::vector<std::thread> threads;
+  for (auto& lane : lanes_) {
+    Lane* lane_ptr = lane.get();
+    if (publisher) {
+      threads.emplace_back([this, lane_ptr]() { publisherLoop(*lane_ptr); });
+    } else {
+      threads.emplace_back([this, lane_ptr]() { subscriberLoop(*lane_ptr); });
+    }
+  }
+  if (!publisher) {
+    threads.emplace_back([this]() { pointLoop(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
   }
 }
 
 void Dispatcher::Stop() { running_ = false; }
 
 std::vector<DispatchResult> Dispatcher::Dispatch(CommandDetail& cmd) {
-  cmd_queue_.Push(cmd);
-  return result_queue_.Pop();
+  std::vector<DispatchResult> results;
+  results.reserve(comm_spec_.worker_num());
+  Dispatch(cmd, [&results](DispatchResult&& result) {
+    results.push_back(std::move(result));
+  });
+  return results;
+}
+
+void Dispatcher::Dispatch(
+    CommandDetail& cmd,
+    const std::function<void(DispatchResult&&)>& on_result) {
+  auto lanes = lanesOf(cmd);
+  auto& lane = *lanes_[lanes[0]];
+  // the results of concurrent commands on a lane must not interleave, and
+  // the lanes are locked in order to avoid deadlocks
+  std::sort(lanes.begin(), lanes.end());
+  std::vector<std::unique_lock<std::mutex>> locks;
+  for (auto index : lanes) {
+    locks.emplace_back(lanes_[index]->dispatch_mutex);
+  }
+
+  std::string data;
+  if (report_cache_.Get(cmd, data)) {
+    DispatchResult result(comm_spec_.worker_id());
+    result.set_data(data, DispatchResult::AggregatePolicy::kPickFirstNonEmpty);
+    on_result(std::move(result));
+    return;
+  }
+  report_cache_.Invalidate(cmd, [this](const std::string& graph_name) {
+    auto root = subscriber_->RootOf(graph_name);
+    auto related = subscriber_->DerivedOf(root);
+    related.push_back(root);
+    return related;
+  });
+
+  int owner = subscriber_->OwnerOf(cmd);
+  if (owner >= 0) {
+    on_result(dispatchTo(owner, cmd));
+    return;
+  }
+
+  bool cacheable = report_cache_.Cacheable(cmd);
+  bool success = true;
+  lane.cmd_queue.Push(cmd);
+  for (int i = 0; i < comm_spec_.worker_num(); ++i) {
+    auto result = lane.result_queue.Pop();
+    if (cacheable) {
+      success &= (result.error_code() == rpc::Code::OK);
+      if (data.empty()) {
+        data = result.data();
+      }
+    }
+    on_result(std::move(result));
+  }
+  if (cacheable && success && !data.empty()) {
+    report_cache_.Put(cmd, data);
+  }
+}
+
+DispatchResult Dispatcher::dispatchTo(int worker_id, const CommandDetail& cmd) {
+  if (worker_id == comm_spec_.worker_id()) {
+    // runs on the calling thread, without the other workers
+    auto* lane_comm_spec = tls_lane_comm_spec;
+    tls_lane_comm_spec = &local_comm_spec_;
+    auto r = processCmd(cmd);
+    tls_lane_comm_spec = lane_comm_spec;
+    return std::move(*r);
+  }
+
+  std::lock_guard<std::mutex> lock(point_mutex_);
+  grape::InArchive iarc;
+  iarc << cmd;
+  std::vector<MPI_Request> reqs;
+  IsendChunked(iarc.GetBuffer(), iarc.GetSize(), worker_id, kPointCmdTag,
+               point_comm_, reqs);
+  MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(), MPI_STATUSES_IGNORE);
+
+  MPI_Status status;
+  std::vector<char> buffer;
+  MPI_Probe(worker_id, kPointResultTag, point_comm_, &status);
+  RecvChunked(status, point_comm_, buffer);
+  grape::OutArchive oarc;
+  oarc.SetSlice(buffer.data(), buffer.size());
+  DispatchResult result;
+  oarc >> result;
+  return result;
+}
+
+const grape::CommSpec* Dispatcher::LaneCommSpec() {
+  return tls_lane_comm_spec;
+}
+
+std::vector<size_t> Dispatcher::lanesOf(const CommandDetail& cmd) const {
+  if (lanes_.size() == 1) {
+    return {0};
+  }
+  std::vector<size_t> lanes;
+  auto add_lane = [&](int key) {
+    auto iter = cmd.params.find(key);
+    if (iter == cmd.params.end() || iter->second.s().empty()) {
+      return;
+    }
+    auto root = subscriber_->RootOf(iter->second.s());
+    auto index = std::hash<std::string>()(root) % lanes_.size();
+    if (std::find(lanes.begin(), lanes.end(), index) == lanes.end()) {
+      lanes.push_back(index);
+    }
+  };
+  add_lane(rpc::GRAPH_NAME);
+  add_lane(rpc::CTX_NAME);
+  if (lanes.empty()) {
+    add_lane(rpc::APP_NAME);
+  }
+  if (lanes.empty()) {
+    lanes.push_back(0);
+  }
+  return lanes;
 }
 
 void Dispatcher::Subscribe(std::shared_ptr<Subscriber> subscriber) {
@@ -95,32 +256,88 @@ std::shared_ptr<DispatchResult> Dispatcher::processCmd(
   return r;
 }
 
-void Dispatcher::publisherLoop() {
+void Dispatcher::publisherLoop(Lane& lane) {
   CHECK_EQ(comm_spec_.worker_id(), grape::kCoordinatorRank);
+  tls_lane_comm_spec = &lane.comm_spec;
+  MPI_Comm comm = lane.comm_spec.comm();
   while (running_) {
-    auto cmd = cmd_queue_.Pop();
-    // process local event
-    grape::BcastSend(cmd, MPI_COMM_WORLD);
+    auto cmd = lane.cmd_queue.Pop();
+    // the command is serialized once, and the archive is released before it
+    // is processed, as the payload of a command may be large
+    {
+      grape::InArchive arc;
+      arc << cmd;
+      BcastSendChunked(arc.GetBuffer(), arc.GetSize(),
+                       grape::kCoordinatorRank, comm);
+    }
 
     auto r = processCmd(cmd);
-    std::vector<DispatchResult> results(comm_spec_.worker_num());
-
-    results[0] = std::move(*r);
-    vineyard::_GatherR(results, comm_spec_.comm());
+    lane.result_queue.Push(std::move(*r));
+    r.reset();
 
-    result_queue_.Push(std::move(results));
+    // receive the results one by one, the queue holds one of them at most
+    std::vector<char> buffer;
+    for (int src = 1; src < comm_spec_.worker_num(); ++src) {
+      MPI_Status status;
+      MPI_Probe(src, kDispatchResultTag, comm, &status);
+      RecvChunked(status, comm, buffer);
+      grape::OutArchive arc;
+      arc.SetSlice(buffer.data(), buffer.size());
+      DispatchResult result;
+      arc >> result;
+      lane.result_queue.Push(std::move(result));
+    }
   }
 }
 
-void Dispatcher::subscriberLoop() {
+void Dispatcher::subscriberLoop(Lane& lane) {
   CHECK_NE(comm_spec_.worker_id(), grape::kCoordinatorRank);
+  tls_lane_comm_spec = &lane.comm_spec;
+  MPI_Comm comm = lane.comm_spec.comm();
   while (running_) {
     CommandDetail cmd;
+    {
+      std::vector<char> buffer;
+      BcastRecvChunked(buffer, grape::kCoordinatorRank, comm);
+      grape::OutArchive arc;
+      arc.SetSlice(buffer.data(), buffer.size());
+      arc >> cmd;
+    }
+    auto r = processCmd(cmd);
+
+    grape::InArchive arc;
+    arc << *r;
+    r.reset();
+    std::vector<MPI_Request> reqs;
+    IsendChunked(arc.GetBuffer(), arc.GetSize(), grape::kCoordinatorRank,
+                 kDispatchResultTag, comm, reqs);
+    MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(),
+                MPI_STATUSES_IGNORE);
+  }
+}
 
-    grape::BcastRecv(cmd, MPI_COMM_WORLD, grape::kCoordinatorRank);
+void Dispatcher::pointLoop() {
+  CHECK_NE(comm_spec_.worker_id(), grape::kCoordinatorRank);
+  tls_lane_comm_spec = &local_comm_spec_;
+  std::vector<char> buffer;
+  while (running_) {
+    MPI_Status status;
+    MPI_Probe(grape::kCoordinatorRank, kPointCmdTag, point_comm_, &status);
+    RecvChunked(status, point_comm_, buffer);
+    grape::OutArchive oarc;
+    oarc.SetSlice(buffer.data(), buffer.size());
+    CommandDetail cmd;
+    oarc >> cmd;
     auto r = processCmd(cmd);
 
-    vineyard::_GatherL(*r, grape::kCoordinatorRank, comm_spec_.comm());
+    grape::InArchive iarc;
+    iarc << *r;
+    r.reset();
+    std::vector<MPI_Request> reqs;
+    IsendChunked(iarc.GetBuffer(), iarc.GetSize(), grape::kCoordinatorRank,
+                 kPointResultTag, point_comm_, reqs);
+    MPI_Waitall(static_cast<int>(reqs.size()), reqs.data(),
+                MPI_STATUSES_IGNORE);
   }
 }
 
@@ -131,6 +348,7 @@ grape::InArchive& operator<<(grape::InArchive& archive,
   archive << result.message_;
   archive << result.data_;
   archive << result.aggregate_policy_;
+  archive << result.evicted_;
   archive << result.graph_def_.SerializeAsString();
   return archive;
 }
@@ -142,6 +360,7 @@ grape::OutArchive& operator>>(grape::OutArchive& archive,
   archive >> result.message_;
   archive >> result.data_;
   archive >> result.aggregate_policy_;
+  archive >> result.evicted_;
   std::string buf;
   archive >> buf;
   CHECK(result.graph_def_.ParseFromString(buf));
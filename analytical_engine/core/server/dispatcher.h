@@ -15,8 +15,10 @@
 #ifndef ANALYTICAL_ENGINE_CORE_SERVER_DISPATCHER_H_
 #define ANALYTICAL_ENGINE_CORE_SERVER_DISPATCHER_H_
 
+#include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <utility>
@@ -31,6 +33,7 @@
 #include "core/config.h"
 #include "core/error.h"
 #include "core/server/command_detail.h"
+#include "core/server/report_cache.h"
 #include "core/utils/mpi_utils.h"
 #include "proto/graph_def.pb.h"
 
@@ -103,12 +106,25 @@ class DispatchResult {
 
   AggregatePolicy aggregate_policy() const { return aggregate_policy_; }
 
+  /**
+   * Set the objects evicted by the command to keep the memory budget, which
+   * are agreed by all workers, so those of the coordinator are kept only.
+   */
+  void set_evicted(const std::vector<std::string>& evicted) {
+    if (worker_id_ == grape::kCoordinatorRank) {
+      evicted_ = evicted;
+    }
+  }
+
+  const std::vector<std::string>& evicted() const { return evicted_; }
+
  private:
   int worker_id_{};
   rpc::Code error_code_{};
   std::string message_;
   std::string data_;
   AggregatePolicy aggregate_policy_{};
+  std::vector<std::string> evicted_;
 
   rpc::GraphDef graph_def_;
 
@@ -129,14 +145,56 @@ class Subscriber {
 
   virtual bl::result<std::shared_ptr<DispatchResult>> OnReceive(
       const CommandDetail& cmd) = 0;
+
+  /**
+   * @brief Returns the only worker needed to run the command, which is then
+   * sent to it alone, or -1 if the command must be run by all workers. It is
+   * called by the coordinator before the command is dispatched.
+   */
+  virtual int OwnerOf(const CommandDetail& cmd) { return -1; }
+
+  /**
+   * @brief Returns the object which the object of id is derived from
+   * transitively, or id itself if it is not derived. It is called by the
+   * coordinator to find the lane of a command.
+   */
+  virtual std::string RootOf(const std::string& id) { return id; }
+
+  /**
+   * @brief Returns the objects derived from the object of id transitively.
+   */
+  virtual std::vector<std::string> DerivedOf(const std::string& id) {
+    return {};
+  }
 };
 
 /**
  * @brief The dispatcher broadcast commands to every worker using MPI.
+ *
+ * The commands are dispatched by one or more lanes, each of which has its
+ * own communicator, queues and threads on every worker. A command is put on
+ * the lane of the root of the object it works on, i.e., the graph which the
+ * graph or the context of the command is derived from, see
+ * Subscriber::RootOf, or the app if there is neither of them. So the commands
+ * on a graph and on the objects derived from it, which may share the states
+ * of the graph, are run in order, and those on unrelated objects may run
+ * concurrently. A command on the objects of several roots, e.g., adding the
+ * columns of a context to another graph, holds the lanes of the other roots
+ * until it is finished. The commands without any object, e.g., loading a
+ * graph or an app, are put on the first lane. The communicator of the running
+ * lane is returned by LaneCommSpec, and must be used by the subscriber for
+ * the collective operations of the command.
+ *
+ * A command owned by a single worker, see Subscriber::OwnerOf, is sent to the
+ * worker alone by point-to-point messages, and run with a CommSpec of the
+ * worker itself. The reported statistics of the graphs are answered by the
+ * ReportCache of the coordinator once they are known.
  */
 class Dispatcher {
  public:
-  explicit Dispatcher(const grape::CommSpec& comm_spec);
+  explicit Dispatcher(const grape::CommSpec& comm_spec, int lane_num = 1);
+
+  ~Dispatcher();
 
   void Start();
 
@@ -144,23 +202,61 @@ class Dispatcher {
 
   std::vector<DispatchResult> Dispatch(CommandDetail& cmd);
 
+  /**
+   * @brief Dispatches the command, and passes the result of each worker to
+   * on_result once it is received, in the order of the workers, so the
+   * results don't have to be held at the same time.
+   */
+  void Dispatch(CommandDetail& cmd,
+                const std::function<void(DispatchResult&&)>& on_result);
+
   void Subscribe(std::shared_ptr<Subscriber> subscriber);
 
   void SetCommand(const CommandDetail& cmd);
 
+  int worker_num() const { return comm_spec_.worker_num(); }
+
+  /**
+   * @brief The CommSpec of the lane running on the calling thread, nullptr
+   * if the thread is not of a lane.
+   */
+  static const grape::CommSpec* LaneCommSpec();
+
  private:
+  struct Lane {
+    grape::CommSpec comm_spec;
+    vineyard::BlockingQueue<CommandDetail> cmd_queue;
+    // the results of a command are pushed one worker after another
+    vineyard::BlockingQueue<DispatchResult> result_queue;
+    std::mutex dispatch_mutex;
+  };
+
+  // the lanes of the objects of the command, the first of which runs it
+  std::vector<size_t> lanesOf(const CommandDetail& cmd) const;
+
+  DispatchResult dispatchTo(int worker_id, const CommandDetail& cmd);
+
   std::shared_ptr<DispatchResult> processCmd(const CommandDetail& cmd);
 
-  void publisherLoop();
+  void publisherLoop(Lane& lane);
+
+  void subscriberLoop(Lane& lane);
 
-  void subscriberLoop();
+  void pointLoop();
 
  private:
   bool running_;
   grape::CommSpec comm_spec_;
   std::shared_ptr<Subscriber> subscriber_;
-  vineyard::BlockingQueue<CommandDetail> cmd_queue_;
-  vineyard::BlockingQueue<std::vector<DispatchResult>> result_queue_;
+  std::vector<std::unique_ptr<Lane>> lanes_;
+  std::vector<MPI_Comm> lane_comms_;
+
+  // for the commands sent to a single worker
+  MPI_Comm point_comm_;
+  grape::CommSpec local_comm_spec_;
+  std::mutex point_mutex_;
+
+  ReportCache report_cache_;
 };
 
 }  // namespace gs
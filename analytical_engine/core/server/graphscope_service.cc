@@ -15,11 +15,34 @@
 
 #include "core/server/graphscope_service.h"
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <vector>
+
 #include "core/server/rpc_utils.h"
 
 namespace gs {
 namespace rpc {
 
+// the result of a worker is streamed in pieces no larger than it
+static constexpr size_t kResultChunkSize = static_cast<size_t>(64) << 20;
+
+// the time a submitted step is kept for its poll once it is done
+static const std::chrono::seconds kJobTTL(600);
+
+static void mergeGraphDef(const GraphDef& graph_def,
+                          RunStepResponse* response) {
+  if (!graph_def.key().empty()) {
+    if (response->graph_def().key().empty()) {
+      response->mutable_graph_def()->CopyFrom(graph_def);
+    } else if (graph_def.SerializeAsString() !=
+               response->graph_def().SerializeAsString()) {
+      LOG(FATAL) << "BUG: Multiple workers return different graph def.";
+    }
+  }
+}
+
 ::grpc::Status GraphScopeService::HeartBeat(::grpc::ServerContext* context,
                                             const HeartBeatRequest* request,
                                             HeartBeatResponse* response) {
@@ -32,13 +55,145 @@ namespace rpc {
 ::grpc::Status GraphScopeService::RunStep(::grpc::ServerContext* context,
                                           const RunStepRequest* request,
                                           RunStepResponse* response) {
-  CHECK(request->has_dag_def());
-  const DagDef& dag_def = request->dag_def();
+  runStep(*request, response);
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status GraphScopeService::SubmitStep(::grpc::ServerContext* context,
+                                             const RunStepRequest* request,
+                                             SubmitStepResponse* response) {
+  auto job = std::make_shared<StepJob>();
+  job->start = std::chrono::steady_clock::now();
+  // the thread is started before the job is visible to the others, which
+  // may join it once it is done
+  job->thread = std::thread([this, job, request = *request]() {
+    RunStepResponse step_response;
+    runStep(request, &step_response);
+    std::lock_guard<std::mutex> lock(job->mutex);
+    job->response.Swap(&step_response);
+    job->finish = std::chrono::steady_clock::now();
+    job->done = true;
+    job->cond.notify_all();
+  });
+  std::string job_id;
+  std::vector<std::shared_ptr<StepJob>> expired;
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    job_id = "job_" + std::to_string(next_job_id_++);
+    jobs_[job_id] = job;
+    takeExpiredJobs(expired);
+  }
+  for (auto& expired_job : expired) {
+    expired_job->thread.join();
+  }
+
+  response->mutable_status()->set_code(rpc::Code::OK);
+  response->set_job_id(job_id);
+  return ::grpc::Status::OK;
+}
+
+::grpc::Status GraphScopeService::PollStep(::grpc::ServerContext* context,
+                                           const PollStepRequest* request,
+                                           PollStepResponse* response) {
+  std::shared_ptr<StepJob> job;
+  std::vector<std::shared_ptr<StepJob>> expired;
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    takeExpiredJobs(expired);
+    auto iter = jobs_.find(request->job_id());
+    if (iter != jobs_.end()) {
+      job = iter->second;
+    }
+  }
+  for (auto& expired_job : expired) {
+    expired_job->thread.join();
+  }
+  auto* res_status = response->mutable_status();
+  if (job == nullptr) {
+    res_status->set_code(rpc::Code::NOT_FOUND_ERROR);
+    res_status->set_error_msg("Unknown job: " + request->job_id());
+    return ::grpc::Status::OK;
+  }
+
+  bool done;
+  {
+    std::unique_lock<std::mutex> lock(job->mutex);
+    if (request->timeout_ms() > 0) {
+      job->cond.wait_for(lock, std::chrono::milliseconds(request->timeout_ms()),
+                         [&job]() { return job->done; });
+    }
+    done = job->done;
+    response->set_done(done);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - job->start;
+    response->set_elapsed_seconds(elapsed.count());
+    if (done) {
+      response->mutable_response()->Swap(&job->response);
+    }
+  }
+  response->set_worker_num(dispatcher_->worker_num());
+  res_status->set_code(rpc::Code::OK);
+
+  // the response of a job is taken once, by the poll seeing it done, and
+  // the job may have been taken by a concurrent poll or as expired already
+  if (done) {
+    bool taken = false;
+    {
+      std::lock_guard<std::mutex> lock(jobs_mutex_);
+      auto iter = jobs_.find(request->job_id());
+      if (iter != jobs_.end() && iter->second == job) {
+        jobs_.erase(iter);
+        taken = true;
+      }
+    }
+    if (taken) {
+      job->thread.join();
+    }
+  }
+  return ::grpc::Status::OK;
+}
+
+GraphScopeService::~GraphScopeService() {
+  std::map<std::string, std::shared_ptr<StepJob>> jobs;
+  {
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    jobs.swap(jobs_);
+  }
+  for (auto& pair : jobs) {
+    pair.second->thread.join();
+  }
+}
+
+void GraphScopeService::takeExpiredJobs(
+    std::vector<std::shared_ptr<StepJob>>& expired) {
+  auto now = std::chrono::steady_clock::now();
+  for (auto iter = jobs_.begin(); iter != jobs_.end();) {
+    auto& job = iter->second;
+    bool expire;
+    {
+      std::lock_guard<std::mutex> lock(job->mutex);
+      expire = job->done && now - job->finish > kJobTTL;
+    }
+    if (expire) {
+      LOG(WARNING) << "Dropping " << iter->first << ", which is not polled "
+                   << "within " << kJobTTL.count() << " seconds once done";
+      expired.push_back(std::move(job));
+      iter = jobs_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+}
+
+void GraphScopeService::runStep(const RunStepRequest& request,
+                                RunStepResponse* response) {
+  CHECK(request.has_dag_def());
+  const DagDef& dag_def = request.dag_def();
   CHECK_EQ(dag_def.op().size(), 1);
   const auto& op = dag_def.op(0);
 
   CommandDetail cmd = OpToCmd(op);
-  auto result = dispatcher_->Dispatch(cmd);
+  std::vector<DispatchResult> result = dispatcher_->Dispatch(cmd);
   auto policy = result[0].aggregate_policy();
   bool success = true;
   std::string error_msgs;
@@ -49,15 +204,9 @@ namespace rpc {
 
     if (ok) {
       CHECK_EQ(e.aggregate_policy(), policy);
-      auto& graph_def = e.graph_def();
-
-      if (!graph_def.key().empty()) {
-        if (response->graph_def().key().empty()) {
-          response->mutable_graph_def()->CopyFrom(graph_def);
-        } else if (graph_def.SerializeAsString() !=
-                   response->graph_def().SerializeAsString()) {
-          LOG(FATAL) << "BUG: Multiple workers return different graph def.";
-        }
+      mergeGraphDef(e.graph_def(), response);
+      for (auto& object_id : e.evicted()) {
+        response->add_evicted_objects(object_id);
       }
     } else {
       error_msgs += e.message() + "\n";
@@ -120,6 +269,100 @@ namespace rpc {
     break;
   }
   }
+}
+
+::grpc::Status GraphScopeService::RunStepStreaming(
+    ::grpc::ServerContext* context, const RunStepRequest* request,
+    ::grpc::ServerWriter<RunStepResponse>* writer) {
+  CHECK(request->has_dag_def());
+  const DagDef& dag_def = request->dag_def();
+  CHECK_EQ(dag_def.op().size(), 1);
+  const auto& op = dag_def.op(0);
+
+  CommandDetail cmd = OpToCmd(op);
+  // the status, the graph def and the results to be checked for consistency
+  // are sent by the last response, the others are streamed as they arrive
+  RunStepResponse response;
+  auto* res_status = response.mutable_status();
+  bool success = true;
+  bool has_policy = false;
+  bool picked = false;
+  auto policy = DispatchResult::AggregatePolicy::kRequireConsistent;
+  std::string error_msgs;
+  int index = 0;
+
+  auto write_data = [writer](const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+      size_t size = std::min(kResultChunkSize, data.size() - offset);
+      RunStepResponse chunk;
+      chunk.mutable_result()->assign(data, offset, size);
+      writer->Write(chunk);
+      offset += size;
+    }
+  };
+
+  dispatcher_->Dispatch(cmd, [&](DispatchResult&& e) {
+    bool first = (index++ == 0);
+    if (e.error_code() != rpc::Code::OK) {
+      error_msgs += e.message() + "\n";
+      success = false;
+      return;
+    }
+    if (!has_policy) {
+      policy = e.aggregate_policy();
+      has_policy = true;
+    }
+    CHECK_EQ(e.aggregate_policy(), policy);
+    mergeGraphDef(e.graph_def(), &response);
+    for (auto& object_id : e.evicted()) {
+      response.add_evicted_objects(object_id);
+    }
+
+    auto& data = e.data();
+    switch (policy) {
+    case DispatchResult::AggregatePolicy::kPickFirst: {
+      if (first) {
+        write_data(data);
+      }
+      break;
+    }
+    case DispatchResult::AggregatePolicy::kPickFirstNonEmpty: {
+      if (!picked && !data.empty()) {
+        write_data(data);
+        picked = true;
+      }
+      break;
+    }
+    case DispatchResult::AggregatePolicy::kRequireConsistent: {
+      if (response.result().empty()) {
+        response.mutable_result()->assign(data.begin(), data.end());
+      } else if (response.result() != data) {
+        std::stringstream ss;
+
+        ss << "Error: Multiple workers return different data."
+           << " Current worker id: " << e.worker_id() << " " << data
+           << " vs the previous: " << response.result();
+        error_msgs += ss.str() + "\n";
+        success = false;
+        LOG(ERROR) << ss.str();
+      }
+      break;
+    }
+    case DispatchResult::AggregatePolicy::kConcat: {
+      write_data(data);
+      break;
+    }
+    }
+  });
+
+  if (!success) {
+    res_status->set_code(rpc::Code::ANALYTICAL_ENGINE_INTERNAL_ERROR);
+    res_status->set_error_msg(error_msgs);
+    OpDef* opdef = res_status->mutable_op();
+    opdef->CopyFrom(op);
+  }
+  writer->Write(response);
 
   return ::grpc::Status::OK;
 }
@@ -16,10 +16,15 @@
 #ifndef ANALYTICAL_ENGINE_CORE_SERVER_GRAPHSCOPE_SERVICE_H_
 #define ANALYTICAL_ENGINE_CORE_SERVER_GRAPHSCOPE_SERVICE_H_
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "core/server/dispatcher.h"
 #include "proto/engine_service.grpc.pb.h"
@@ -42,16 +47,68 @@ class GraphScopeService final : public EngineService::Service {
   explicit GraphScopeService(std::shared_ptr<Dispatcher> dispatcher)
       : dispatcher_(std::move(dispatcher)) {}
 
+  // joins the steps submitted and not dropped yet
+  ~GraphScopeService() override;
+
   ::grpc::Status RunStep(::grpc::ServerContext* context,
                          const RunStepRequest* request,
                          RunStepResponse* response) override;
 
+  /**
+   * @brief The streaming variant of RunStep. The results of the workers are
+   * written in chunks as they are received, the last response carries the
+   * status and the graph def, and the client concatenates the results.
+   */
+  ::grpc::Status RunStepStreaming(
+      ::grpc::ServerContext* context, const RunStepRequest* request,
+      ::grpc::ServerWriter<RunStepResponse>* writer) override;
+
+  /**
+   * @brief Starts the step in the background and returns its job id at once,
+   * so the client can go on with its own work, or submit more steps, which
+   * run concurrently if they are on different lanes of the dispatcher.
+   */
+  ::grpc::Status SubmitStep(::grpc::ServerContext* context,
+                            const RunStepRequest* request,
+                            SubmitStepResponse* response) override;
+
+  /**
+   * @brief Reports whether a submitted step is done and the time elapsed,
+   * waiting up to the timeout for it to be done. The response of RunStep is
+   * returned once the step is done, after which the job is dropped. A job
+   * done and not polled for ten minutes is dropped as well.
+   */
+  ::grpc::Status PollStep(::grpc::ServerContext* context,
+                          const PollStepRequest* request,
+                          PollStepResponse* response) override;
+
   ::grpc::Status HeartBeat(::grpc::ServerContext* context,
                            const HeartBeatRequest* request,
                            HeartBeatResponse* response) override;
 
  private:
+  // a step submitted by SubmitStep, run by its own thread
+  struct StepJob {
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point finish;
+    bool done = false;
+    RunStepResponse response;
+  };
+
+  void runStep(const RunStepRequest& request, RunStepResponse* response);
+
+  // takes the jobs done and not polled for too long out of jobs_,
+  // whose threads are joined by the caller after releasing jobs_mutex_
+  void takeExpiredJobs(std::vector<std::shared_ptr<StepJob>>& expired);
+
   std::shared_ptr<Dispatcher> dispatcher_;
+
+  std::mutex jobs_mutex_;
+  std::map<std::string, std::shared_ptr<StepJob>> jobs_;
+  size_t next_job_id_ = 0;
 };
 }  // namespace rpc
 }  // namespace gs
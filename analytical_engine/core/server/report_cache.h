@@ -0,0 +1,125 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_SERVER_REPORT_CACHE_H_
+#define ANALYTICAL_ENGINE_CORE_SERVER_REPORT_CACHE_H_
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "core/server/command_detail.h"
+
+namespace gs {
+
+/**
+ * @brief ReportCache keeps the statistics of the graphs reported by the
+ * workers on the coordinator, i.e., the number of nodes, edges and selfloops,
+ * and the degree histogram, so they are answered without a round trip to the
+ * workers. The statistics of a graph, and of the graphs derived from the same
+ * root, are dropped once any other command on it is dispatched, which may
+ * modify it.
+ */
+class ReportCache {
+ public:
+  bool Get(const CommandDetail& cmd, std::string& data) {
+    std::string graph_name;
+    int report_type;
+    if (!key(cmd, graph_name, report_type)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = stats_.find(graph_name);
+    if (iter == stats_.end()) {
+      return false;
+    }
+    auto stat_iter = iter->second.find(report_type);
+    if (stat_iter == iter->second.end()) {
+      return false;
+    }
+    data = stat_iter->second;
+    return true;
+  }
+
+  void Put(const CommandDetail& cmd, const std::string& data) {
+    std::string graph_name;
+    int report_type;
+    if (key(cmd, graph_name, report_type)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_[graph_name][report_type] = data;
+    }
+  }
+
+  bool Cacheable(const CommandDetail& cmd) const {
+    std::string graph_name;
+    int report_type;
+    return key(cmd, graph_name, report_type);
+  }
+
+  /**
+   * @brief Drops the statistics of the graph of the command, unless it is a
+   * report, and of the graphs related to it, i.e., those sharing the states
+   * with it, as returned by related_of.
+   */
+  void Invalidate(
+      const CommandDetail& cmd,
+      const std::function<std::vector<std::string>(const std::string&)>&
+          related_of) {
+    if (cmd.type == rpc::REPORT_GRAPH) {
+      return;
+    }
+    auto iter = cmd.params.find(rpc::GRAPH_NAME);
+    if (iter == cmd.params.end()) {
+      return;
+    }
+    auto related = related_of(iter->second.s());
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.erase(iter->second.s());
+    for (auto& graph_name : related) {
+      stats_.erase(graph_name);
+    }
+  }
+
+ private:
+  static bool key(const CommandDetail& cmd, std::string& graph_name,
+                  int& report_type) {
+    if (cmd.type != rpc::REPORT_GRAPH) {
+      return false;
+    }
+    auto name_iter = cmd.params.find(rpc::GRAPH_NAME);
+    auto type_iter = cmd.params.find(rpc::REPORT_TYPE);
+    if (name_iter == cmd.params.end() || type_iter == cmd.params.end()) {
+      return false;
+    }
+    report_type = type_iter->second.report_type();
+    if (report_type != rpc::NODE_NUM && report_type != rpc::EDGE_NUM &&
+        report_type != rpc::SELFLOOPS_NUM &&
+        report_type != rpc::DEGREE_HISTOGRAM) {
+      return false;
+    }
+    graph_name = name_iter->second.s();
+    return true;
+  }
+
+  std::mutex mutex_;
+  // graph name -> report type -> reported data
+  std::map<std::string, std::map<int, std::string>> stats_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_SERVER_REPORT_CACHE_H_
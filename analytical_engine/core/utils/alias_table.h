@@ -0,0 +1,75 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_ALIAS_TABLE_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_ALIAS_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace gs {
+
+/**
+ * @brief Builds the alias table of Vose over the n weights, i.e., a
+ * probability and an alias per item, for the draws in O(1) by SampleAlias.
+ * The items are equally likely if the weights sum to no more than 0.
+ */
+template <typename WEIGHT_T>
+inline void BuildAliasTable(const WEIGHT_T* weights, size_t n, double* prob,
+                            uint32_t* alias) {
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += static_cast<double>(weights[i]);
+  }
+  std::vector<uint32_t> small, large;
+  for (size_t i = 0; i < n; ++i) {
+    prob[i] = sum > 0 ? static_cast<double>(weights[i]) * n / sum : 1;
+    alias[i] = i;
+    (prob[i] < 1 ? small : large).push_back(i);
+  }
+  while (!small.empty() && !large.empty()) {
+    uint32_t s = small.back(), l = large.back();
+    small.pop_back();
+    alias[s] = l;
+    prob[l] -= 1 - prob[s];
+    if (prob[l] < 1) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  // the rest are of the probability 1 up to the rounding errors
+  for (auto i : large) {
+    prob[i] = 1;
+  }
+  for (auto i : small) {
+    prob[i] = 1;
+  }
+}
+
+// draws an item of the n ones by the alias table
+template <typename RNG_T>
+inline size_t SampleAlias(const double* prob, const uint32_t* alias, size_t n,
+                          RNG_T& rng) {
+  size_t i = std::uniform_int_distribution<size_t>(0, n - 1)(rng);
+  return std::uniform_real_distribution<double>(0, 1)(rng) < prob[i]
+             ? i
+             : alias[i];
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_ALIAS_TABLE_H_
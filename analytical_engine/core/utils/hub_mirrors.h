@@ -0,0 +1,135 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_HUB_MIRRORS_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_HUB_MIRRORS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "core/utils/vertex_bit_array.h"
+
+namespace gs {
+
+/**
+ * @brief The hubs of a fragment, i.e., the inner vertices of no less than
+ * threshold local edges, and the inner neighbors of the outer vertices. A
+ * hub sends its update once to each fragment having it as an outer vertex,
+ * e.g., by SendMsgThroughEdges, rather than to each of its outer neighbors,
+ * and the receiving fragment fans the update out to the inner neighbors of
+ * the hub locally. On the power-law graphs, where the hubs have most of the
+ * cut edges, it cuts the messages to about one per hub and fragment.
+ *
+ * The updates of the hubs arrive on the outer vertices, so they are told
+ * from the ones synced to the owners, which arrive on the inner vertices.
+ *
+ * @tparam FRAG_T
+ */
+template <typename FRAG_T>
+class HubMirrors {
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vid_t = typename FRAG_T::vid_t;
+
+ public:
+  /**
+   * @param threshold The least local edges, of both directions, of a hub, or
+   * 0 for no hubs.
+   */
+  void Init(const FRAG_T& frag, size_t threshold) {
+    auto inner_vertices = frag.InnerVertices();
+    auto outer_vertices = frag.OuterVertices();
+
+    threshold_ = threshold;
+    hubs_.Init(inner_vertices, false);
+    offsets_.clear();
+    nbrs_.clear();
+    if (threshold_ == 0) {
+      return;
+    }
+
+    for (auto v : inner_vertices) {
+      size_t degree = frag.GetLocalOutDegree(v);
+      if (frag.directed()) {
+        degree += frag.GetLocalInDegree(v);
+      }
+      hubs_.Set(v, degree >= threshold_);
+    }
+
+    // the inner neighbors of each outer vertex, in CSR
+    outer_begin_ = outer_vertices.begin().GetValue();
+    offsets_.assign(outer_vertices.size() + 1, 0);
+    forEachOuterNbr(frag, [this](const vertex_t& u, const vertex_t&) {
+      ++offsets_[u.GetValue() - outer_begin_ + 1];
+    });
+    for (size_t i = 1; i < offsets_.size(); ++i) {
+      offsets_[i] += offsets_[i - 1];
+    }
+    nbrs_.resize(offsets_.back());
+    std::vector<size_t> cursors(offsets_.begin(), offsets_.end() - 1);
+    forEachOuterNbr(frag, [this, &cursors](const vertex_t& u,
+                                           const vertex_t& v) {
+      nbrs_[cursors[u.GetValue() - outer_begin_]++] = v;
+    });
+  }
+
+  bool enabled() const { return threshold_ != 0; }
+
+  // whether the inner vertex is a hub
+  inline bool IsHub(const vertex_t& v) const {
+    return threshold_ != 0 && hubs_[v];
+  }
+
+  /**
+   * @brief Calls func(v) for each inner neighbor v of an outer vertex, to
+   * which the update of the outer vertex by its owner is fanned out.
+   */
+  template <typename FUNC_T>
+  void ForEachMirrorNbr(const vertex_t& u, const FUNC_T& func) const {
+    size_t i = u.GetValue() - outer_begin_;
+    for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+      func(nbrs_[k]);
+    }
+  }
+
+ private:
+  // calls func(u, v) for the edges between an outer u and an inner v
+  template <typename FUNC_T>
+  static void forEachOuterNbr(const FRAG_T& frag, const FUNC_T& func) {
+    for (auto v : frag.InnerVertices()) {
+      for (auto& e : frag.GetOutgoingAdjList(v)) {
+        if (frag.IsOuterVertex(e.neighbor())) {
+          func(e.neighbor(), v);
+        }
+      }
+      if (frag.directed()) {
+        for (auto& e : frag.GetIncomingAdjList(v)) {
+          if (frag.IsOuterVertex(e.neighbor())) {
+            func(e.neighbor(), v);
+          }
+        }
+      }
+    }
+  }
+
+  size_t threshold_ = 0;
+  VertexBitArray<vid_t> hubs_;
+  vid_t outer_begin_ = 0;
+  std::vector<size_t> offsets_;
+  std::vector<vertex_t> nbrs_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_HUB_MIRRORS_H_
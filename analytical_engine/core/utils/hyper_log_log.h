@@ -0,0 +1,93 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_HYPER_LOG_LOG_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_HYPER_LOG_LOG_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace gs {
+
+// the least and the most bits of the indices of the registers
+static constexpr int kHLLMinPrecision = 4;
+static constexpr int kHLLMaxPrecision = 16;
+
+// the splitmix64 finalizer, to hash the ids to the uniform 64 bits
+inline uint64_t HLLHash(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Adds the hash to the 2^precision registers of a HyperLogLog counter,
+ * i.e., the first precision bits pick the register, which keeps the most
+ * leading zeros plus one of the rest bits.
+ */
+inline void HLLAdd(uint8_t* registers, int precision, uint64_t hash) {
+  uint64_t index = hash >> (64 - precision);
+  uint64_t rest = hash << precision;
+  int max_rank = 64 - precision + 1;
+  auto rank = static_cast<uint8_t>(
+      rest == 0 ? max_rank : std::min(__builtin_clzll(rest) + 1, max_rank));
+  registers[index] = std::max(registers[index], rank);
+}
+
+/**
+ * @brief Merges the registers of src into dst by the max, i.e., the union of
+ * the counters. The loop is kept simple for the compilers to vectorize.
+ */
+inline void HLLMerge(uint8_t* __restrict__ dst,
+                     const uint8_t* __restrict__ src, size_t m) {
+  for (size_t i = 0; i < m; ++i) {
+    dst[i] = dst[i] > src[i] ? dst[i] : src[i];
+  }
+}
+
+/**
+ * @brief The estimate of the distinct items of the m registers, with the
+ * linear counting for the small ones.
+ */
+inline double HLLEstimate(const uint8_t* registers, size_t m) {
+  double alpha;
+  if (m == 16) {
+    alpha = 0.673;
+  } else if (m == 32) {
+    alpha = 0.697;
+  } else if (m == 64) {
+    alpha = 0.709;
+  } else {
+    alpha = 0.7213 / (1 + 1.079 / m);
+  }
+  double sum = 0;
+  size_t zeros = 0;
+  for (size_t i = 0; i < m; ++i) {
+    sum += std::ldexp(1.0, -registers[i]);
+    zeros += registers[i] == 0;
+  }
+  double estimate = alpha * m * m / sum;
+  if (estimate <= 2.5 * m && zeros != 0) {
+    estimate = m * std::log(static_cast<double>(m) / zeros);
+  }
+  return estimate;
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_HYPER_LOG_LOG_H_
@@ -0,0 +1,85 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_MEMORY_STRATEGY_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_MEMORY_STRATEGY_H_
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+namespace gs {
+
+/**
+ * @brief The strategy to allocate the memory of a graph, given at the creation
+ * of the graph as a comma separated list of the options, e.g.,
+ * "huge_pages":
+ *
+ * - huge_pages: the large arrays are backed by the 2MB transparent huge
+ *   pages, to reduce the TLB misses of the random accesses.
+ */
+struct MemoryStrategy {
+  bool huge_pages = false;
+
+  static bool Parse(const std::string& options, MemoryStrategy& strategy) {
+    strategy = MemoryStrategy();
+    std::stringstream ss(options);
+    std::string option;
+    while (std::getline(ss, option, ',')) {
+      if (option.empty() || option == "default") {
+        continue;
+      } else if (option == "huge_pages") {
+        strategy.huge_pages = true;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::string ToString() const {
+    return huge_pages ? "huge_pages" : "default";
+  }
+};
+
+static constexpr size_t kHugePageSize = static_cast<size_t>(2) << 20;
+
+/**
+ * @brief Advises the kernel to back the 2MB aligned pages in the memory of
+ * [ptr, ptr + bytes) by the transparent huge pages, which are merged by
+ * khugepaged if they are already allocated. It is a no-op for the memory
+ * smaller than a huge page.
+ */
+inline void AdviseHugePages(const void* ptr, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  if (ptr == nullptr || bytes < kHugePageSize) {
+    return;
+  }
+  auto begin = reinterpret_cast<uintptr_t>(ptr);
+  auto end = begin + bytes;
+  begin = (begin + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  end &= ~(kHugePageSize - 1);
+  if (begin < end) {
+    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+  }
+#endif
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_MEMORY_STRATEGY_H_
@@ -0,0 +1,75 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_MIN_HASH_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_MIN_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "core/utils/hyper_log_log.h"
+
+namespace gs {
+
+/**
+ * @brief The MinHash sketch of a set of ids, i.e., the least of each of the k
+ * hashes over the set, by the double hashing of HLLHash, with the weight of
+ * the id of the least one. The sketches of two sets agree at a hash with the
+ * probability of their Jaccard similarity, and the ids agreed on are sampled
+ * uniformly from the intersection.
+ */
+template <typename ID_T, typename WEIGHT_T>
+inline void MinHashSketch(const std::vector<ID_T>& ids,
+                          const std::vector<WEIGHT_T>& weights, size_t k,
+                          std::vector<uint64_t>& sketch,
+                          std::vector<WEIGHT_T>& sketch_weights) {
+  sketch.assign(k, std::numeric_limits<uint64_t>::max());
+  sketch_weights.assign(k, 0);
+  for (size_t j = 0; j < ids.size(); ++j) {
+    uint64_t h1 = HLLHash(static_cast<uint64_t>(ids[j]));
+    uint64_t h2 = HLLHash(h1) | 1;
+    uint64_t h = h1;
+    for (size_t i = 0; i < k; ++i, h += h2) {
+      if (h < sketch[i]) {
+        sketch[i] = h;
+        sketch_weights[i] = weights[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Calls func(i) for each of the hashes at which the sketches agree,
+ * and returns the number of them.
+ */
+template <typename FUNC_T>
+inline size_t MinHashMatches(const std::vector<uint64_t>& a,
+                             const std::vector<uint64_t>& b,
+                             const FUNC_T& func) {
+  size_t matches = 0;
+  for (size_t i = 0; i < a.size() && i < b.size(); ++i) {
+    if (a[i] == b[i]) {
+      func(i);
+      ++matches;
+    }
+  }
+  return matches;
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_MIN_HASH_H_
@@ -0,0 +1,135 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_MMAP_UTILS_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_MMAP_UTILS_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/error.h"
+
+namespace gs {
+
+/**
+ * @brief A file in a local directory, e.g., on the SSD, mapped into the
+ * memory, of which the pages are loaded on demand and dropped by the kernel
+ * under the memory pressure, rather than pinned in the memory. The file is
+ * unlinked at the creation, so it is removed once it is unmapped, including
+ * at the crashes.
+ *
+ * The file is written through data() after Create, then Seal makes it read
+ * only, writes the pages back and drops them from the memory.
+ */
+class MappedFile {
+ public:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  static size_t PageSize() {
+    static const size_t page_size = sysconf(_SC_PAGESIZE);
+    return page_size;
+  }
+
+  static size_t AlignToPage(size_t bytes) {
+    size_t page_size = PageSize();
+    return (bytes + page_size - 1) / page_size * page_size;
+  }
+
+  static bl::result<std::shared_ptr<MappedFile>> Create(
+      const std::string& dir, size_t size) {
+    std::string path = dir + "/gs_mapped_XXXXXX";
+    std::vector<char> path_buf(path.begin(), path.end());
+    path_buf.push_back('\0');
+    int fd = mkstemp(path_buf.data());
+    if (fd < 0) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                      "Failed to create a file in " + dir + ": " +
+                          strerror(errno));
+    }
+    unlink(path_buf.data());
+    std::shared_ptr<MappedFile> file(new MappedFile(fd, AlignToPage(size)));
+    if (file->size_ != 0) {
+      if (ftruncate(fd, file->size_) != 0) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                        "Failed to allocate " + std::to_string(file->size_) +
+                            " bytes in " + dir + ": " + strerror(errno));
+      }
+      void* data = mmap(nullptr, file->size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED, fd, 0);
+      if (data == MAP_FAILED) {
+        RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                        std::string("Failed to map the file: ") +
+                            strerror(errno));
+      }
+      file->data_ = static_cast<char*>(data);
+    }
+    return file;
+  }
+
+  /**
+   * @brief Makes the mapping read only, with the sequential read ahead, as the
+   * file is laid out in the order it is scanned, and drops the written pages
+   * from the memory once they are on the disk.
+   */
+  bl::result<void> Seal() {
+    if (data_ == nullptr) {
+      return {};
+    }
+    if (msync(data_, size_, MS_SYNC) != 0 ||
+        mprotect(data_, size_, PROT_READ) != 0) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kIOError,
+                      std::string("Failed to seal the mapped file: ") +
+                          strerror(errno));
+    }
+    madvise(data_, size_, MADV_SEQUENTIAL);
+    madvise(data_, size_, MADV_DONTNEED);
+    return {};
+  }
+
+  char* data() { return data_; }
+
+  const char* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(int fd, size_t size) : fd_(fd), size_(size), data_(nullptr) {}
+
+  int fd_;
+  size_t size_;
+  char* data_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_MMAP_UTILS_H_
@@ -0,0 +1,220 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_NUMA_UTILS_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_NUMA_UTILS_H_
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/parallel/parallel_engine_spec.h"
+#include "grape/worker/comm_spec.h"
+
+namespace gs {
+
+/**
+ * @brief The placement of the memory and the threads of the workers on a
+ * NUMA machine:
+ *
+ * - kNone: the threads are scheduled by the OS, and the pages are placed on
+ *   the node of the thread touching them first.
+ * - kInterleave: the pages are interleaved on all the nodes, and the
+ *   threads are pinned to the cores of the nodes in turn.
+ * - kLocal: each worker of the machine takes a node in turn, i.e., the
+ *   fragment of the worker, a partition of the vertices, is placed on the
+ *   node of its threads, which are pinned to the cores of the node.
+ */
+enum class NumaPolicy {
+  kNone,
+  kInterleave,
+  kLocal,
+};
+
+inline bool ParseNumaPolicy(const std::string& name, NumaPolicy& policy) {
+  if (name.empty() || name == "none") {
+    policy = NumaPolicy::kNone;
+  } else if (name == "interleave") {
+    policy = NumaPolicy::kInterleave;
+  } else if (name == "local") {
+    policy = NumaPolicy::kLocal;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief The cores of each NUMA node, by sysfs. A machine without the NUMA
+ * nodes is taken as a single node of all the cores.
+ */
+inline std::vector<std::vector<uint32_t>> NumaNodeCpus() {
+  std::vector<std::vector<uint32_t>> nodes;
+  for (int node = 0;; ++node) {
+    std::ifstream fin("/sys/devices/system/node/node" + std::to_string(node) +
+                      "/cpulist");
+    if (!fin) {
+      break;
+    }
+    // in the format of "0-15,32-47"
+    std::vector<uint32_t> cpus;
+    std::string range;
+    while (std::getline(fin, range, ',')) {
+      uint32_t begin = 0, end = 0;
+      char dash = 0;
+      std::stringstream ss(range);
+      if (!(ss >> begin)) {
+        continue;
+      }
+      end = begin;
+      if (ss >> dash >> end && dash != '-') {
+        end = begin;
+      }
+      for (uint32_t cpu = begin; cpu <= end; ++cpu) {
+        cpus.push_back(cpu);
+      }
+    }
+    if (!cpus.empty()) {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+  if (nodes.empty()) {
+    uint32_t cpu_num = std::max(1u, std::thread::hardware_concurrency());
+    nodes.emplace_back();
+    for (uint32_t cpu = 0; cpu < cpu_num; ++cpu) {
+      nodes.back().push_back(cpu);
+    }
+  }
+  return nodes;
+}
+
+namespace numa_impl {
+
+// the modes of set_mempolicy(2), without depending on libnuma
+constexpr int kMpolPreferred = 1;
+constexpr int kMpolInterleave = 3;
+
+inline bool set_mempolicy(int mode, const std::vector<int>& nodes) {
+#ifdef SYS_set_mempolicy
+  constexpr size_t kBits = sizeof(unsigned long) * 8;  // NOLINT(runtime/int)
+  int max_node = *std::max_element(nodes.begin(), nodes.end());
+  std::vector<unsigned long> mask(max_node / kBits + 1, 0);  // NOLINT
+  for (int node : nodes) {
+    mask[node / kBits] |= 1UL << (node % kBits);
+  }
+  return syscall(SYS_set_mempolicy, mode, mask.data(),
+                 mask.size() * kBits + 1) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace numa_impl
+
+/**
+ * @brief Places the memory allocated later by the calling thread, and the
+ * threads created by it, by the policy. It should be called by the main
+ * thread of the worker before loading the graphs and starting the threads.
+ */
+inline void ApplyNumaMemoryPolicy(const grape::CommSpec& comm_spec,
+                                  NumaPolicy policy) {
+  auto nodes = NumaNodeCpus();
+  if (policy == NumaPolicy::kNone || nodes.size() <= 1) {
+    return;
+  }
+  std::vector<int> node_ids;
+  int mode;
+  if (policy == NumaPolicy::kInterleave) {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      node_ids.push_back(static_cast<int>(node));
+    }
+    mode = numa_impl::kMpolInterleave;
+  } else {
+    node_ids.push_back(comm_spec.local_id() % static_cast<int>(nodes.size()));
+    mode = numa_impl::kMpolPreferred;
+  }
+  if (!numa_impl::set_mempolicy(mode, node_ids)) {
+    LOG(WARNING) << "Failed to set the NUMA memory policy of worker "
+                 << comm_spec.worker_id();
+  }
+}
+
+/**
+ * @brief The spec of the parallel engine of the workers by the policy, where
+ * the threads are pinned to the cores of the node of the worker for kLocal,
+ * or to the cores of all the nodes in turn for kInterleave, and the workers
+ * of a machine share the cores.
+ */
+inline grape::ParallelEngineSpec NumaParallelEngineSpec(
+    const grape::CommSpec& comm_spec, NumaPolicy policy) {
+  auto spec = grape::DefaultParallelEngineSpec();
+  if (policy == NumaPolicy::kNone) {
+    return spec;
+  }
+  auto nodes = NumaNodeCpus();
+  int local_num = comm_spec.local_num();
+  int local_id = comm_spec.local_id();
+  int node_num = static_cast<int>(nodes.size());
+
+  std::vector<uint32_t> cpus;
+  if (policy == NumaPolicy::kLocal) {
+    // the workers on the same node split its cores
+    auto& node_cpus = nodes[local_id % node_num];
+    int sharing = (local_num - local_id % node_num + node_num - 1) / node_num;
+    int rank = local_id / node_num;
+    size_t chunk = std::max<size_t>(1, node_cpus.size() / sharing);
+    size_t begin = std::min(node_cpus.size(), rank * chunk);
+    size_t end = std::min(node_cpus.size(), begin + chunk);
+    cpus.assign(node_cpus.begin() + begin, node_cpus.begin() + end);
+  } else {
+    // the cores of the nodes in turn, split by the workers
+    std::vector<uint32_t> all;
+    for (size_t i = 0;; ++i) {
+      bool found = false;
+      for (auto& node_cpus : nodes) {
+        if (i < node_cpus.size()) {
+          all.push_back(node_cpus[i]);
+          found = true;
+        }
+      }
+      if (!found) {
+        break;
+      }
+    }
+    for (size_t i = local_id; i < all.size(); i += local_num) {
+      cpus.push_back(all[i]);
+    }
+  }
+  if (cpus.empty()) {
+    return spec;
+  }
+  spec.thread_num = static_cast<uint32_t>(cpus.size());
+  spec.affinity = true;
+  spec.cpu_list = std::move(cpus);
+  return spec;
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_NUMA_UTILS_H_
@@ -0,0 +1,118 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_OID_INDEX_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_OID_INDEX_H_
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "vineyard/client/ds/i_object.h"
+
+namespace gs {
+
+/**
+ * @brief OidIndex keeps the inner vertices of a label of a vineyard fragment
+ * sorted by their oids, so the vertices of a range of oids are found by binary
+ * search instead of materializing the oid of every vertex. The recent indices
+ * are cached by the object id of the fragment and the range of the inner
+ * vertices, which changes once vertices are appended.
+ *
+ * @tparam FRAG_T A fragment which is a vineyard object
+ */
+template <typename FRAG_T>
+class OidIndex {
+  using oid_t = typename FRAG_T::oid_t;
+  using vid_t = typename FRAG_T::vid_t;
+  using vertex_t = typename FRAG_T::vertex_t;
+  using vertex_range_t = typename FRAG_T::vertex_range_t;
+  using key_t = std::tuple<vineyard::ObjectID, vid_t, vid_t>;
+
+  static constexpr size_t kCapacity = 8;
+
+ public:
+  OidIndex(const FRAG_T& frag, const vertex_range_t& iv) {
+    std::vector<std::pair<oid_t, vertex_t>> pairs;
+    pairs.reserve(iv.size());
+    for (auto v : iv) {
+      pairs.emplace_back(frag.GetId(v), v);
+    }
+    std::sort(pairs.begin(), pairs.end(),
+              [](const std::pair<oid_t, vertex_t>& lhs,
+                 const std::pair<oid_t, vertex_t>& rhs) {
+                return lhs.first < rhs.first;
+              });
+    oids_.reserve(pairs.size());
+    vertices_.reserve(pairs.size());
+    for (auto& pair : pairs) {
+      oids_.push_back(std::move(pair.first));
+      vertices_.push_back(pair.second);
+    }
+  }
+
+  static std::shared_ptr<const OidIndex> Get(const FRAG_T& frag,
+                                             const vertex_range_t& iv) {
+    static std::mutex mutex;
+    static std::list<std::pair<key_t, std::shared_ptr<const OidIndex>>> cache;
+
+    key_t key(frag.id(), iv.begin().GetValue(), iv.end().GetValue());
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto iter = cache.begin(); iter != cache.end(); ++iter) {
+      if (iter->first == key) {
+        cache.splice(cache.begin(), cache, iter);
+        return cache.front().second;
+      }
+    }
+    auto index = std::make_shared<const OidIndex>(frag, iv);
+    cache.emplace_front(key, index);
+    if (cache.size() > kCapacity) {
+      cache.pop_back();
+    }
+    return index;
+  }
+
+  /**
+   * @brief The vertices whose oids are in [begin, end) in ascending order,
+   * where a null bound is unbounded.
+   */
+  std::vector<vertex_t> Select(const oid_t* begin, const oid_t* end) const {
+    auto first = begin == nullptr
+                     ? oids_.begin()
+                     : std::lower_bound(oids_.begin(), oids_.end(), *begin);
+    auto last = end == nullptr
+                    ? oids_.end()
+                    : std::lower_bound(oids_.begin(), oids_.end(), *end);
+    std::vector<vertex_t> vertices;
+    if (first < last) {
+      vertices.assign(vertices_.begin() + (first - oids_.begin()),
+                      vertices_.begin() + (last - oids_.begin()));
+      std::sort(vertices.begin(), vertices.end());
+    }
+    return vertices;
+  }
+
+ private:
+  std::vector<oid_t> oids_;
+  std::vector<vertex_t> vertices_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_OID_INDEX_H_
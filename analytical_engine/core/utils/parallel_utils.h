@@ -0,0 +1,282 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_PARALLEL_UTILS_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_PARALLEL_UTILS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gs {
+
+// the minimal number of items handled by a thread in parallel loops.
+static constexpr size_t kParallelGrainSize = 4096;
+
+inline size_t parallel_thread_num(size_t n, size_t grain) {
+  size_t thread_num =
+      std::max<size_t>(1, std::thread::hardware_concurrency());
+  return std::max<size_t>(1, std::min(thread_num, n / grain));
+}
+
+/**
+ * @brief Calls func(i) for each i in [begin, end) by multiple threads, each of
+ * which handles a contiguous range. Small loops are run in the calling thread.
+ */
+template <typename FUNC_T>
+inline void parallel_for(size_t begin, size_t end, const FUNC_T& func,
+                         size_t grain = kParallelGrainSize) {
+  if (begin >= end) {
+    return;
+  }
+  size_t thread_num = parallel_thread_num(end - begin, grain);
+  if (thread_num == 1) {
+    for (size_t i = begin; i < end; ++i) {
+      func(i);
+    }
+    return;
+  }
+  size_t chunk = (end - begin + thread_num - 1) / thread_num;
+  std::vector<std::thread> threads(thread_num);
+  for (size_t tid = 0; tid < thread_num; ++tid) {
+    threads[tid] = std::thread([&, tid]() {
+      size_t chunk_begin = std::min(end, begin + tid * chunk);
+      size_t chunk_end = std::min(end, chunk_begin + chunk);
+      for (size_t i = chunk_begin; i < chunk_end; ++i) {
+        func(i);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+/**
+ * @brief Runs the independent tasks by multiple threads, e.g., the seals of
+ * the arrays of a fragment, in which the data are copied to the blobs while
+ * the other seals wait for the replies of vineyard.
+ */
+inline void parallel_invoke(const std::vector<std::function<void()>>& tasks) {
+  parallel_for(0, tasks.size(), [&tasks](size_t i) { tasks[i](); }, 1);
+}
+
+/**
+ * @brief Calls func(tid, i) for each i in [0, n) by thread_num threads, where
+ * the indices with the same key_of(i) are handled by the same thread, in the
+ * ascending order. So func can mutate the state owned by the key without
+ * locks, and tid can be used to index thread local states.
+ */
+template <typename KEY_FUNC_T, typename FUNC_T>
+inline void parallel_for_by_key(size_t n, size_t thread_num,
+                                const KEY_FUNC_T& key_of, const FUNC_T& func) {
+  if (thread_num <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      func(0, i);
+    }
+    return;
+  }
+
+  // bucket the indices by the owner thread, keeping the order
+  std::vector<uint32_t> owners(n);
+  std::vector<size_t> offsets(thread_num + 1, 0);
+  for (size_t i = 0; i < n; ++i) {
+    owners[i] = static_cast<uint32_t>(key_of(i) % thread_num);
+    ++offsets[owners[i] + 1];
+  }
+  for (size_t tid = 0; tid < thread_num; ++tid) {
+    offsets[tid + 1] += offsets[tid];
+  }
+  std::vector<size_t> order(n);
+  {
+    std::vector<size_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+      order[cursors[owners[i]]++] = i;
+    }
+  }
+
+  std::vector<std::thread> threads(thread_num);
+  for (size_t tid = 0; tid < thread_num; ++tid) {
+    threads[tid] = std::thread([&, tid]() {
+      for (size_t j = offsets[tid]; j < offsets[tid + 1]; ++j) {
+        func(tid, order[j]);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+// the tasks split for each thread by parallel_for_balanced, so that the
+// threads running out of work can steal from the others.
+static constexpr size_t kBalancedTasksPerThread = 16;
+
+namespace parallel_utils_impl {
+
+// the items [item_begin, item_end) in whole, or the units [unit_begin,
+// unit_end) of the single item item_begin
+struct BalancedTask {
+  size_t item_begin, item_end;
+  size_t unit_begin, unit_end;
+};
+
+// the tasks [lo, hi) left to a thread, of which the owner takes the first
+// and the thieves take the latter half
+struct BalancedRange {
+  std::mutex lock;
+  size_t lo = 0, hi = 0;
+};
+
+static constexpr size_t kWholeItem = std::numeric_limits<size_t>::max();
+
+}  // namespace parallel_utils_impl
+
+/**
+ * @brief Calls func(tid, i, begin, end) by thread_num threads for the units
+ * [begin, end) of each item i in [0, n), which has weight_of(i) units, e.g.,
+ * the neighbors of a vertex. The items are split into the tasks of about the
+ * same weight, where the heavy items are split into parts, so func may be
+ * called more than once for an item, with the disjoint parts, by different
+ * threads. Each thread takes a contiguous range of the tasks at first, and
+ * steals the latter half of the range left to another thread once its own
+ * one runs out, so the threads finish at about the same time on the skewed
+ * weights, e.g., the degrees of power-law graphs.
+ */
+template <typename WEIGHT_FUNC_T, typename FUNC_T>
+inline void parallel_for_balanced(size_t n, size_t thread_num,
+                                  const WEIGHT_FUNC_T& weight_of,
+                                  const FUNC_T& func) {
+  using parallel_utils_impl::BalancedRange;
+  using parallel_utils_impl::BalancedTask;
+  using parallel_utils_impl::kWholeItem;
+
+  if (n == 0) {
+    return;
+  }
+  std::vector<size_t> weights(n);
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    weights[i] = weight_of(i);
+    total += weights[i] + 1;
+  }
+  if (thread_num <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      func(0, i, 0, weights[i]);
+    }
+    return;
+  }
+
+  // each item costs a unit more than its weight, so the light items are
+  // grouped as well
+  size_t grain =
+      std::max<size_t>(1, total / (thread_num * kBalancedTasksPerThread));
+  std::vector<BalancedTask> tasks;
+  size_t run_begin = 0, run_weight = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (weights[i] > grain) {
+      if (run_begin < i) {
+        tasks.push_back({run_begin, i, 0, kWholeItem});
+      }
+      for (size_t unit = 0; unit < weights[i]; unit += grain) {
+        tasks.push_back(
+            {i, i + 1, unit, std::min(weights[i], unit + grain)});
+      }
+      run_begin = i + 1;
+      run_weight = 0;
+      continue;
+    }
+    if (run_begin < i && run_weight + weights[i] + 1 > grain) {
+      tasks.push_back({run_begin, i, 0, kWholeItem});
+      run_begin = i;
+      run_weight = 0;
+    }
+    run_weight += weights[i] + 1;
+  }
+  if (run_begin < n) {
+    tasks.push_back({run_begin, n, 0, kWholeItem});
+  }
+
+  thread_num = std::min(thread_num, tasks.size());
+  std::vector<BalancedRange> ranges(thread_num);
+  size_t chunk = (tasks.size() + thread_num - 1) / thread_num;
+  for (size_t tid = 0; tid < thread_num; ++tid) {
+    ranges[tid].lo = std::min(tasks.size(), tid * chunk);
+    ranges[tid].hi = std::min(tasks.size(), ranges[tid].lo + chunk);
+  }
+
+  auto run_task = [&](size_t tid, const BalancedTask& task) {
+    if (task.unit_end == kWholeItem) {
+      for (size_t i = task.item_begin; i < task.item_end; ++i) {
+        func(tid, i, 0, weights[i]);
+      }
+    } else {
+      func(tid, task.item_begin, task.unit_begin, task.unit_end);
+    }
+  };
+  auto steal = [&](size_t tid) {
+    for (size_t k = 1; k < thread_num; ++k) {
+      auto& victim = ranges[(tid + k) % thread_num];
+      size_t lo, hi;
+      {
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.lo >= victim.hi) {
+          continue;
+        }
+        hi = victim.hi;
+        lo = victim.lo + (victim.hi - victim.lo) / 2;
+        victim.hi = lo;
+      }
+      std::lock_guard<std::mutex> guard(ranges[tid].lock);
+      ranges[tid].lo = lo;
+      ranges[tid].hi = hi;
+      return true;
+    }
+    return false;
+  };
+
+  std::vector<std::thread> threads(thread_num);
+  for (size_t tid = 0; tid < thread_num; ++tid) {
+    threads[tid] = std::thread([&, tid]() {
+      auto& own = ranges[tid];
+      while (true) {
+        size_t task = tasks.size();
+        {
+          std::lock_guard<std::mutex> guard(own.lock);
+          if (own.lo < own.hi) {
+            task = own.lo++;
+          }
+        }
+        if (task < tasks.size()) {
+          run_task(tid, tasks[task]);
+        } else if (!steal(tid)) {
+          break;
+        }
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_PARALLEL_UTILS_H_
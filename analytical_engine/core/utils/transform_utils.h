@@ -16,8 +16,13 @@ limitations under the License.
 #ifndef ANALYTICAL_ENGINE_CORE_UTILS_TRANSFORM_UTILS_H_
 #define ANALYTICAL_ENGINE_CORE_UTILS_TRANSFORM_UTILS_H_
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
+#include <random>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -31,6 +36,11 @@ limitations under the License.
 #include "vineyard/basic/ds/tensor.h"
 
 #include "core/context/column.h"
+#include "core/context/selector.h"
+#include "core/loader/property_encoder.h"
+#include "core/parallel/thread_pool.h"
+#include "core/utils/mpi_utils.h"
+#include "core/utils/oid_index.h"
 
 #ifdef NETWORKX
 namespace grape {
@@ -151,6 +161,41 @@ typename std::enable_if<is_dynamic<OID_T>::value, OID_T>::type string_to_oid(
 }
 #endif
 
+template <typename FRAG_T>
+typename std::enable_if<std::is_base_of<vineyard::Object, FRAG_T>::value,
+                        std::vector<typename FRAG_T::vertex_t>>::type
+select_vertices_in_range(const FRAG_T& frag,
+                         const typename FRAG_T::vertex_range_t& iv,
+                         const typename FRAG_T::oid_t* begin_id,
+                         const typename FRAG_T::oid_t* end_id) {
+  return OidIndex<FRAG_T>::Get(frag, iv)->Select(begin_id, end_id);
+}
+
+template <typename FRAG_T>
+typename std::enable_if<!std::is_base_of<vineyard::Object, FRAG_T>::value,
+                        std::vector<typename FRAG_T::vertex_t>>::type
+select_vertices_in_range(const FRAG_T& frag,
+                         const typename FRAG_T::vertex_range_t& iv,
+                         const typename FRAG_T::oid_t* begin_id,
+                         const typename FRAG_T::oid_t* end_id) {
+  using oid_t = typename FRAG_T::oid_t;
+  std::vector<typename FRAG_T::vertex_t> vertices;
+
+  for (auto v : iv) {
+    oid_t id = frag.GetId(v);
+    if ((begin_id == nullptr || id >= *begin_id) &&
+        (end_id == nullptr || id < *end_id)) {
+      vertices.emplace_back(v);
+    }
+  }
+  return vertices;
+}
+
+/**
+ * @brief Selects the inner vertices whose oids are in [range.first,
+ * range.second), an empty bound is unbounded. The vertices of vineyard
+ * fragments are found by the OidIndex of the fragment.
+ */
 template <typename FRAG_T>
 std::vector<typename FRAG_T::vertex_t> select_vertices_impl(
     const FRAG_T& frag, const typename FRAG_T::vertex_range_t& iv,
@@ -158,39 +203,26 @@ std::vector<typename FRAG_T::vertex_t> select_vertices_impl(
   using vertex_t = typename FRAG_T::vertex_t;
   using oid_t = typename FRAG_T::oid_t;
 
-  std::vector<vertex_t> vertices;
   auto& begin = range.first;
   auto& end = range.second;
 
   if (begin.empty() && end.empty()) {
+    std::vector<vertex_t> vertices;
+    vertices.reserve(iv.size());
     for (auto v : iv) {
       vertices.emplace_back(v);
     }
-  } else if (begin.empty() && !end.empty()) {
-    oid_t end_id = string_to_oid<oid_t>(end);
-    for (auto v : iv) {
-      if (frag.GetId(v) < end_id) {
-        vertices.emplace_back(v);
-      }
-    }
-  } else if (!begin.empty() && end.empty()) {
-    oid_t begin_id = string_to_oid<oid_t>(begin);
-    for (auto v : iv) {
-      if (frag.GetId(v) >= begin_id) {
-        vertices.emplace_back(v);
-      }
-    }
-  } else if (!begin.empty() && !end.empty()) {
-    oid_t begin_id = string_to_oid<oid_t>(begin);
-    oid_t end_id = string_to_oid<oid_t>(end);
-    for (auto v : iv) {
-      oid_t id = frag.GetId(v);
-      if (id >= begin_id && id < end_id) {
-        vertices.emplace_back(v);
-      }
-    }
+    return vertices;
   }
-  return vertices;
+  oid_t begin_id{}, end_id{};
+  if (!begin.empty()) {
+    begin_id = string_to_oid<oid_t>(begin);
+  }
+  if (!end.empty()) {
+    end_id = string_to_oid<oid_t>(end);
+  }
+  return select_vertices_in_range(frag, iv, begin.empty() ? nullptr : &begin_id,
+                                  end.empty() ? nullptr : &end_id);
 }
 
 inline void gather_archives(grape::InArchive& arc,
@@ -225,6 +257,80 @@ inline void gather_archives(grape::InArchive& arc,
   }
 }
 
+/**
+ * @brief Gathers the columns serialized in arc to worker 0 at once, instead of
+ * a gather_archives for each column. columns are the [begin, end) of the data
+ * of the columns in arc, which are consecutive on the other workers, and on
+ * worker 0 may be preceded by the headers of the columns. The gathered arc on
+ * worker 0 is laid out as gather_archives for each column does, i.e., the data
+ * of a column on worker 0 is followed by the ones of the other workers in the
+ * order of fid.
+ */
+inline void gather_columns(
+    grape::InArchive& arc, const grape::CommSpec& comm_spec,
+    const std::vector<std::pair<size_t, size_t>>& columns) {
+  if (columns.empty()) {
+    return;
+  }
+  size_t col_num = columns.size();
+  std::vector<int64_t> local_length(col_num);
+  for (size_t i = 0; i < col_num; ++i) {
+    local_length[i] =
+        static_cast<int64_t>(columns[i].second - columns[i].first);
+  }
+
+  if (comm_spec.fid() == 0) {
+    std::vector<int64_t> gathered_length(comm_spec.fnum() * col_num, 0);
+    MPI_Gather(local_length.data(), static_cast<int>(col_num), MPI_INT64_T,
+               gathered_length.data(), static_cast<int>(col_num), MPI_INT64_T,
+               comm_spec.worker_id(), comm_spec.comm());
+
+    std::vector<std::vector<char>> payloads(comm_spec.fnum());
+    size_t total_length = arc.GetSize();
+    for (grape::fid_t i = 1; i < comm_spec.fnum(); ++i) {
+      size_t length = 0;
+      for (size_t j = 0; j < col_num; ++j) {
+        length += static_cast<size_t>(gathered_length[i * col_num + j]);
+      }
+      payloads[i].resize(length);
+      grape::recv_buffer<char>(payloads[i].data(), length,
+                               comm_spec.FragToWorker(i), comm_spec.comm(), 0);
+      total_length += length;
+    }
+
+    std::vector<char> local(arc.GetBuffer(), arc.GetBuffer() + arc.GetSize());
+    arc.Resize(total_length);
+    char* ptr = arc.GetBuffer();
+    std::vector<size_t> offsets(comm_spec.fnum(), 0);
+    size_t local_offset = 0;
+    for (size_t j = 0; j < col_num; ++j) {
+      // the header and the data of the column on worker 0
+      size_t length = columns[j].second - local_offset;
+      memcpy(ptr, local.data() + local_offset, length);
+      ptr += length;
+      local_offset = columns[j].second;
+      for (grape::fid_t i = 1; i < comm_spec.fnum(); ++i) {
+        auto remote_length =
+            static_cast<size_t>(gathered_length[i * col_num + j]);
+        memcpy(ptr, payloads[i].data() + offsets[i], remote_length);
+        ptr += remote_length;
+        offsets[i] += remote_length;
+      }
+    }
+    memcpy(ptr, local.data() + local_offset, local.size() - local_offset);
+  } else {
+    MPI_Gather(local_length.data(), static_cast<int>(col_num), MPI_INT64_T,
+               NULL, static_cast<int>(col_num), MPI_INT64_T,
+               comm_spec.FragToWorker(0), comm_spec.comm());
+
+    size_t from = columns.front().first;
+    grape::send_buffer<char>(arc.GetBuffer() + static_cast<ptrdiff_t>(from),
+                             columns.back().second - from,
+                             comm_spec.FragToWorker(0), comm_spec.comm(), 0);
+    arc.Resize(from);
+  }
+}
+
 template <typename FRAG_T>
 typename std::enable_if<
     !std::is_same<typename FRAG_T::vdata_t, grape::EmptyType>::value,
@@ -252,6 +358,131 @@ vertex_data_to_arrow_array_impl(const FRAG_T& frag) {
                   "Can not transform empty type to arrow array");
 }
 
+// the pool of the calling thread, as the commands on different lanes of the
+// dispatcher may transform the contexts concurrently
+inline ThreadPool& transform_thread_pool() {
+  static thread_local ThreadPool pool;
+  return pool;
+}
+
+/**
+ * @brief Runs func(i) for each i in [0, size) on the threads of
+ * transform_thread_pool, a small size is run on the calling thread.
+ */
+template <typename FUNC_T>
+void parallel_fill(size_t size, const FUNC_T& func) {
+  constexpr size_t kMinChunkSize = 16384;
+  size_t thread_num =
+      std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                       (size + kMinChunkSize - 1) / kMinChunkSize);
+  if (thread_num <= 1) {
+    for (size_t i = 0; i < size; ++i) {
+      func(i);
+    }
+    return;
+  }
+  size_t chunk = (size + thread_num - 1) / thread_num;
+  transform_thread_pool().ParallelRun(
+      static_cast<int>(thread_num), [size, chunk, &func](int tid) {
+        size_t begin = std::min(size, chunk * tid);
+        size_t end = std::min(size, begin + chunk);
+        for (size_t i = begin; i < end; ++i) {
+          func(i);
+        }
+      });
+}
+
+/**
+ * @brief Restricts the selected vertices by the limit. For top k, each worker
+ * keeps its k vertices with the largest data, by partial sorts of the chunks
+ * of the vertices in parallel and then of the candidates of the chunks, in
+ * descending order of the data. For a sample, each worker keeps a uniform
+ * sample whose size is in proportion to its number of vertices, in ascending
+ * order.
+ */
+template <typename VERTEX_ARRAY_T, typename VERTEX_T>
+void limit_vertices(const grape::CommSpec& comm_spec, const VertexLimit& limit,
+                    const VERTEX_ARRAY_T& data,
+                    std::vector<VERTEX_T>& vertices) {
+  if (limit.type == VertexLimit::Type::kTopK) {
+    auto greater = [&data](const VERTEX_T& lhs, const VERTEX_T& rhs) {
+      return data[rhs] < data[lhs];
+    };
+    size_t k = std::min(limit.k, vertices.size());
+    size_t thread_num =
+        std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                         vertices.size() / std::max<size_t>(k, 16384));
+    if (thread_num > 1) {
+      size_t chunk = (vertices.size() + thread_num - 1) / thread_num;
+      std::vector<std::vector<VERTEX_T>> candidates(thread_num);
+      transform_thread_pool().ParallelRun(
+          static_cast<int>(thread_num),
+          [&candidates, &greater, &vertices, chunk, k](int tid) {
+            auto begin = vertices.begin() +
+                         std::min(vertices.size(), chunk * tid);
+            auto end = vertices.begin() +
+                       std::min(vertices.size(), chunk * (tid + 1));
+            auto num = std::min<size_t>(k, end - begin);
+            std::partial_sort(begin, begin + num, end, greater);
+            candidates[tid].assign(begin, begin + num);
+          });
+      vertices.clear();
+      for (auto& candidate : candidates) {
+        vertices.insert(vertices.end(), candidate.begin(), candidate.end());
+      }
+    }
+    std::partial_sort(vertices.begin(), vertices.begin() + k, vertices.end(),
+                      greater);
+    vertices.resize(k);
+  } else if (limit.type == VertexLimit::Type::kSample) {
+    size_t local_num = vertices.size(), total_num;
+    MPI_Allreduce(&local_num, &total_num, 1, MPI_SIZE_T, MPI_SUM,
+                  comm_spec.comm());
+    size_t k =
+        total_num == 0
+            ? 0
+            : std::min(local_num, (limit.k * local_num + total_num - 1) /
+                                      total_num);
+    std::mt19937_64 gen(limit.seed + comm_spec.fid());
+    for (size_t i = 0; i < k; ++i) {
+      std::uniform_int_distribution<size_t> dist(i, local_num - 1);
+      std::swap(vertices[i], vertices[dist(gen)]);
+    }
+    vertices.resize(k);
+    std::sort(vertices.begin(), vertices.end());
+  }
+}
+
+template <typename VERTEX_T>
+bool consecutive_vertices(const std::vector<VERTEX_T>& vertices) {
+  for (size_t i = 1; i < vertices.size(); ++i) {
+    if (vertices[i].GetValue() != vertices[i - 1].GetValue() + 1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Fills dst with the values of data on the vertices. The values of
+ * consecutive vertices of a POD array are copied as one block.
+ */
+template <typename DATA_T, typename VERTEX_ARRAY_T, typename VERTEX_T>
+void fill_from_vertex_array(DATA_T* dst, const VERTEX_ARRAY_T& data,
+                            const std::vector<VERTEX_T>& vertices) {
+  if (vertices.empty()) {
+    return;
+  }
+  if (std::is_pod<DATA_T>::value && consecutive_vertices(vertices)) {
+    memcpy(static_cast<void*>(dst), &data[vertices.front()],
+           sizeof(DATA_T) * vertices.size());
+    return;
+  }
+  parallel_fill(vertices.size(), [dst, &data, &vertices](size_t i) {
+    dst[i] = data[vertices[i]];
+  });
+}
+
 template <typename FUNC_T>
 typename std::enable_if<
     !std::is_same<typename std::result_of<FUNC_T(size_t)>::type,
@@ -269,9 +500,8 @@ build_vy_tensor_builder(vineyard::Client& client, size_t size, FUNC_T&& func,
   std::vector<int64_t> part{part_idx};
   tensor_builder = std::make_shared<tensor_builder_t>(client, shape, part);
 
-  for (size_t i = 0; i < size; i++) {
-    tensor_builder->data()[i] = func(i);
-  }
+  auto* data = tensor_builder->data();
+  parallel_fill(size, [data, &func](size_t i) { data[i] = func(i); });
 
   return std::dynamic_pointer_cast<vineyard::ITensorBuilder>(tensor_builder);
 }
@@ -337,6 +567,70 @@ build_vy_tensor(vineyard::Client& client, size_t size, FUNC_T&& func,
                   "Can not transform dynamic type");
 }
 
+template <typename DATA_T>
+struct is_tensor_pod
+    : std::integral_constant<
+          bool, std::is_pod<DATA_T>::value &&
+                    !std::is_same<DATA_T, grape::EmptyType>::value> {};
+
+/**
+ * @brief Builds a tensor of data on the vertices, see fill_from_vertex_array.
+ */
+template <typename DATA_T, typename VERTEX_ARRAY_T, typename VERTEX_T>
+typename std::enable_if<
+    is_tensor_pod<DATA_T>::value,
+    bl::result<std::shared_ptr<vineyard::ITensorBuilder>>>::type
+vertex_array_to_vy_tensor_builder(vineyard::Client& client,
+                                  const VERTEX_ARRAY_T& data,
+                                  const std::vector<VERTEX_T>& vertices,
+                                  int64_t part_idx) {
+  std::vector<int64_t> shape{static_cast<int64_t>(vertices.size())};
+  std::vector<int64_t> part{part_idx};
+  auto tensor_builder =
+      std::make_shared<vineyard::TensorBuilder<DATA_T>>(client, shape, part);
+
+  fill_from_vertex_array(tensor_builder->data(), data, vertices);
+  return std::dynamic_pointer_cast<vineyard::ITensorBuilder>(tensor_builder);
+}
+
+template <typename DATA_T, typename VERTEX_ARRAY_T, typename VERTEX_T>
+typename std::enable_if<
+    !is_tensor_pod<DATA_T>::value,
+    bl::result<std::shared_ptr<vineyard::ITensorBuilder>>>::type
+vertex_array_to_vy_tensor_builder(vineyard::Client& client,
+                                  const VERTEX_ARRAY_T& data,
+                                  const std::vector<VERTEX_T>& vertices,
+                                  int64_t part_idx) {
+  auto f = [&data, &vertices](size_t i) -> DATA_T { return data[vertices[i]]; };
+  return build_vy_tensor_builder(client, vertices.size(), f, part_idx);
+}
+
+template <typename DATA_T, typename VERTEX_ARRAY_T, typename VERTEX_T>
+typename std::enable_if<is_tensor_pod<DATA_T>::value,
+                        bl::result<vineyard::ObjectID>>::type
+vertex_array_to_vy_tensor(vineyard::Client& client, const VERTEX_ARRAY_T& data,
+                          const std::vector<VERTEX_T>& vertices,
+                          int64_t part_idx) {
+  BOOST_LEAF_AUTO(base_builder, vertex_array_to_vy_tensor_builder<DATA_T>(
+                                    client, data, vertices, part_idx));
+  auto builder =
+      std::dynamic_pointer_cast<vineyard::TensorBuilder<DATA_T>>(base_builder);
+  auto tensor = builder->Seal(client);
+
+  VY_OK_OR_RAISE(tensor->Persist(client));
+  return tensor->id();
+}
+
+template <typename DATA_T, typename VERTEX_ARRAY_T, typename VERTEX_T>
+typename std::enable_if<!is_tensor_pod<DATA_T>::value,
+                        bl::result<vineyard::ObjectID>>::type
+vertex_array_to_vy_tensor(vineyard::Client& client, const VERTEX_ARRAY_T& data,
+                          const std::vector<VERTEX_T>& vertices,
+                          int64_t part_idx) {
+  auto f = [&data, &vertices](size_t i) -> DATA_T { return data[vertices[i]]; };
+  return build_vy_tensor(client, vertices.size(), f, part_idx);
+}
+
 template <typename FRAG_T, typename DATA_T>
 std::shared_ptr<vineyard::TensorBuilder<DATA_T>>
 column_to_vy_tensor_builder_impl(
@@ -347,9 +641,7 @@ column_to_vy_tensor_builder_impl(
   auto tensor_builder =
       std::make_unique<vineyard::TensorBuilder<DATA_T>>(client, shape);
 
-  for (size_t i = 0; i < vertices.size(); i++) {
-    tensor_builder->data()[i] = col->at(vertices[i]);
-  }
+  fill_from_vertex_array(tensor_builder->data(), col->data(), vertices);
   return tensor_builder;
 }
 
@@ -558,10 +850,11 @@ class TransformUtils<FRAG_T,
     std::vector<int64_t> part_idx{comm_spec_.fid()};
     auto tensor_builder = std::make_shared<vineyard::TensorBuilder<oid_t>>(
         client, shape, part_idx);
+    auto* data = tensor_builder->data();
 
-    for (size_t i = 0; i < vertices.size(); i++) {
-      tensor_builder->data()[i] = frag_.GetId(vertices[i]);
-    }
+    parallel_fill(vertices.size(), [this, data, &vertices](size_t i) {
+      data[i] = frag_.GetId(vertices[i]);
+    });
     return std::dynamic_pointer_cast<vineyard::ITensorBuilder>(tensor_builder);
   }
 
@@ -580,22 +873,23 @@ class TransformUtils<FRAG_T,
                                            label_id_t label_id,
                                            prop_id_t prop_id,
                                            grape::InArchive& arc) {
-    auto type = frag_.vertex_property_type(label_id, prop_id);
+    auto type = vertexPropertyType(label_id, prop_id);
+    BOOST_LEAF_AUTO(decoded, decodedVertexProperty(label_id, prop_id));
 
     if (type->Equals(arrow::int32())) {
-      serializeVertexPropertyImpl<int32_t>(arc, range, prop_id);
+      serializeVertexPropertyImpl<int32_t>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::int64())) {
-      serializeVertexPropertyImpl<int64_t>(arc, range, prop_id);
+      serializeVertexPropertyImpl<int64_t>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::uint32())) {
-      serializeVertexPropertyImpl<uint32_t>(arc, range, prop_id);
+      serializeVertexPropertyImpl<uint32_t>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::uint64())) {
-      serializeVertexPropertyImpl<int64_t>(arc, range, prop_id);
+      serializeVertexPropertyImpl<int64_t>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::float32())) {
-      serializeVertexPropertyImpl<float>(arc, range, prop_id);
+      serializeVertexPropertyImpl<float>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::float64())) {
-      serializeVertexPropertyImpl<double>(arc, range, prop_id);
+      serializeVertexPropertyImpl<double>(arc, range, prop_id, decoded);
     } else if (type->Equals(arrow::large_utf8())) {
-      serializeVertexPropertyImpl<std::string>(arc, range, prop_id);
+      serializeVertexPropertyImpl<std::string>(arc, range, prop_id, decoded);
     } else {
       RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
                       "property type not support - " + type->ToString());
@@ -604,8 +898,12 @@ class TransformUtils<FRAG_T,
     return {};
   }
 
-  std::shared_ptr<arrow::Array> VertexPropertyToArrowArray(label_id_t label_id,
-                                                           prop_id_t prop_id) {
+  bl::result<std::shared_ptr<arrow::Array>> VertexPropertyToArrowArray(
+      label_id_t label_id, prop_id_t prop_id) {
+    BOOST_LEAF_AUTO(decoded, decodedVertexProperty(label_id, prop_id));
+    if (decoded != nullptr) {
+      return decoded;
+    }
     auto table = frag_.vertex_data_table(label_id);
     return table->column(prop_id)->chunk(0);
   }
@@ -614,29 +912,30 @@ class TransformUtils<FRAG_T,
   VertexPropertyToVYTensorBuilder(vineyard::Client& client, label_id_t label_id,
                                   prop_id_t prop_id,
                                   const std::vector<vertex_t>& vertices) {
-    auto type = frag_.vertex_property_type(label_id, prop_id);
+    auto type = vertexPropertyType(label_id, prop_id);
+    BOOST_LEAF_AUTO(decoded, decodedVertexProperty(label_id, prop_id));
 
     if (type->Equals(arrow::int32())) {
-      return vertex_property_to_vy_tensor_builder_impl<int32_t>(client, prop_id,
-                                                                vertices);
+      return vertex_property_to_vy_tensor_builder_impl<int32_t>(
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::int64())) {
-      return vertex_property_to_vy_tensor_builder_impl<int64_t>(client, prop_id,
-                                                                vertices);
+      return vertex_property_to_vy_tensor_builder_impl<int64_t>(
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::uint32())) {
       return vertex_property_to_vy_tensor_builder_impl<uint32_t>(
-          client, prop_id, vertices);
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::uint64())) {
       return vertex_property_to_vy_tensor_builder_impl<uint64_t>(
-          client, prop_id, vertices);
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::float32())) {
-      return vertex_property_to_vy_tensor_builder_impl<float>(client, prop_id,
-                                                              vertices);
+      return vertex_property_to_vy_tensor_builder_impl<float>(
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::float64())) {
-      return vertex_property_to_vy_tensor_builder_impl<double>(client, prop_id,
-                                                               vertices);
+      return vertex_property_to_vy_tensor_builder_impl<double>(
+          client, prop_id, vertices, decoded);
     } else if (type->Equals(arrow::large_utf8())) {
       return vertex_property_to_vy_tensor_builder_impl<std::string>(
-          client, prop_id, vertices);
+          client, prop_id, vertices, decoded);
     } else {
       RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
                       "property type not support - " + type->ToString());
@@ -647,30 +946,31 @@ class TransformUtils<FRAG_T,
       vineyard::Client& client, typename FRAG_T::label_id_t label_id,
       typename FRAG_T::prop_id_t prop_id,
       const std::vector<typename FRAG_T::vertex_t>& vertices) {
-    auto type = frag_.vertex_property_type(label_id, prop_id);
+    auto type = vertexPropertyType(label_id, prop_id);
+    BOOST_LEAF_AUTO(decoded, decodedVertexProperty(label_id, prop_id));
 
     if (type->Equals(arrow::int32())) {
       return vertex_property_to_vy_tensor_impl<int32_t>(client, prop_id,
-                                                        vertices);
+                                                        vertices, decoded);
     } else if (type->Equals(arrow::int64())) {
       return vertex_property_to_vy_tensor_impl<int64_t>(client, prop_id,
-                                                        vertices);
+                                                        vertices, decoded);
     } else if (type->Equals(arrow::uint32())) {
       return vertex_property_to_vy_tensor_impl<uint32_t>(client, prop_id,
-                                                         vertices);
+                                                         vertices, decoded);
     } else if (type->Equals(arrow::uint64())) {
       return vertex_property_to_vy_tensor_impl<uint64_t>(client, prop_id,
-                                                         vertices);
+                                                         vertices, decoded);
     } else if (type->Equals(arrow::float32())) {
       return vertex_property_to_vy_tensor_impl<float>(client, prop_id,
-                                                      vertices);
+                                                      vertices, decoded);
     } else if (type->Equals(arrow::float64())) {
       return vertex_property_to_vy_tensor_impl<double>(client, prop_id,
-                                                       vertices);
+                                                       vertices, decoded);
     } else if (type->Equals(arrow::utf8()) ||
                type->Equals(arrow::large_utf8())) {
       return vertex_property_to_vy_tensor_impl<std::string>(client, prop_id,
-                                                            vertices);
+                                                            vertices, decoded);
     } else {
       RETURN_GS_ERROR(vineyard::ErrorCode::kUnsupportedOperationError,
                       "property type not support - " + type->ToString());
@@ -678,13 +978,65 @@ class TransformUtils<FRAG_T,
   }
 
  private:
+  // the type of the values of the property, i.e., the one before encoding if
+  // the property is encoded by compress_properties
+  std::shared_ptr<arrow::DataType> vertexPropertyType(label_id_t label_id,
+                                                      prop_id_t prop_id) {
+    return DecodedFieldType(frag_.vertex_data_table(label_id)->field(prop_id));
+  }
+
+  // the decoded values of the property if it is encoded, indexed by the
+  // vertex offsets, or nullptr to read the fragment as it is, e.g., the
+  // empty tables, which have no chunks
+  bl::result<std::shared_ptr<arrow::Array>> decodedVertexProperty(
+      label_id_t label_id, prop_id_t prop_id) {
+    auto table = frag_.vertex_data_table(label_id);
+    std::shared_ptr<arrow::Array> values;
+    if (IsEncodedField(table->field(prop_id)) &&
+        table->column(prop_id)->num_chunks() > 0) {
+      VY_OK_OR_RAISE(DecodeColumn(table->field(prop_id),
+                                  table->column(prop_id)->chunk(0), values));
+    }
+    return values;
+  }
+
+  template <typename DATA_T>
+  static typename std::enable_if<!std::is_same<DATA_T, std::string>::value,
+                                 DATA_T>::type
+  decodedValue(const std::shared_ptr<arrow::Array>& values, int64_t offset) {
+    using array_t = typename vineyard::ConvertToArrowType<DATA_T>::ArrayType;
+    return static_cast<const array_t*>(values.get())->Value(offset);
+  }
+
+  template <typename DATA_T>
+  static typename std::enable_if<std::is_same<DATA_T, std::string>::value,
+                                 DATA_T>::type
+  decodedValue(const std::shared_ptr<arrow::Array>& values, int64_t offset) {
+    if (values->type()->Equals(arrow::utf8())) {
+      return static_cast<const arrow::StringArray*>(values.get())
+          ->GetString(offset);
+    }
+    return static_cast<const arrow::LargeStringArray*>(values.get())
+        ->GetString(offset);
+  }
+
+  template <typename DATA_T>
+  DATA_T vertexPropertyValue(const vertex_t& v, prop_id_t prop_id,
+                             const std::shared_ptr<arrow::Array>& decoded) {
+    if (decoded != nullptr) {
+      return decodedValue<DATA_T>(decoded, frag_.vertex_offset(v));
+    }
+    return frag_.template GetData<DATA_T>(v, prop_id);
+  }
+
   template <typename DATA_T>
   void serializeVertexPropertyImpl(
       grape::InArchive& arc,
       const std::vector<typename FRAG_T::vertex_t>& range,
-      typename FRAG_T::prop_id_t prop_id) {
+      typename FRAG_T::prop_id_t prop_id,
+      const std::shared_ptr<arrow::Array>& decoded) {
     for (auto v : range) {
-      arc << frag_.template GetData<DATA_T>(v, prop_id);
+      arc << vertexPropertyValue<DATA_T>(v, prop_id, decoded);
     }
   }
 
@@ -692,26 +1044,31 @@ class TransformUtils<FRAG_T,
   std::shared_ptr<vineyard::ITensorBuilder>
   vertex_property_to_vy_tensor_builder_impl(
       vineyard::Client& client, typename FRAG_T::prop_id_t prop_id,
-      const std::vector<vertex_t>& vertices) {
+      const std::vector<vertex_t>& vertices,
+      const std::shared_ptr<arrow::Array>& decoded) {
     std::vector<int64_t> shape{static_cast<int64_t>(vertices.size())};
     auto tensor_builder =
         std::make_shared<vineyard::TensorBuilder<DATA_T>>(client, shape);
 
-    for (size_t i = 0; i < vertices.size(); i++) {
-      tensor_builder->data()[i] =
-          frag_.template GetData<DATA_T>(vertices[i], prop_id);
-    }
+    auto* data = tensor_builder->data();
+
+    parallel_fill(vertices.size(),
+                  [this, data, prop_id, &vertices, &decoded](size_t i) {
+                    data[i] = vertexPropertyValue<DATA_T>(vertices[i], prop_id,
+                                                          decoded);
+                  });
     return tensor_builder;
   }
 
   template <typename DATA_T>
   bl::result<vineyard::ObjectID> vertex_property_to_vy_tensor_impl(
       vineyard::Client& client, typename FRAG_T::prop_id_t prop_id,
-      const std::vector<typename FRAG_T::vertex_t>& vertices) {
+      const std::vector<typename FRAG_T::vertex_t>& vertices,
+      const std::shared_ptr<arrow::Array>& decoded) {
     auto tensor_builder =
         std::dynamic_pointer_cast<vineyard::TensorBuilder<DATA_T>>(
-            vertex_property_to_vy_tensor_builder_impl<DATA_T>(client, prop_id,
-                                                              vertices));
+            vertex_property_to_vy_tensor_builder_impl<DATA_T>(
+                client, prop_id, vertices, decoded));
     auto tensor = tensor_builder->Seal(client);
     VY_OK_OR_RAISE(tensor->Persist(client));
     return tensor->id();
@@ -775,10 +1132,11 @@ class TransformUtils<
     std::vector<int64_t> part_idx{comm_spec_.fid()};
     auto tensor_builder = std::make_shared<vineyard::TensorBuilder<oid_t>>(
         client, shape, part_idx);
+    auto* data = tensor_builder->data();
 
-    for (size_t i = 0; i < vertices.size(); i++) {
-      tensor_builder->data()[i] = frag_.GetId(vertices[i]);
-    }
+    parallel_fill(vertices.size(), [this, data, &vertices](size_t i) {
+      data[i] = frag_.GetId(vertices[i]);
+    });
     return std::dynamic_pointer_cast<vineyard::ITensorBuilder>(tensor_builder);
   }
 
@@ -0,0 +1,101 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_BIT_ARRAY_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_BIT_ARRAY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grape/utils/vertex_array.h"
+
+namespace gs {
+
+/**
+ * @brief A flag per vertex of a contiguous range, e.g., InnerVertices(),
+ * packed in bits rather than the bytes of a vertex_array_t<bool>, so the
+ * flags of the contexts, e.g., the halted ones of Pregel, take 1 / 8 of the
+ * memory. Set may be called concurrently on different vertices, as the bits
+ * sharing a word are updated atomically.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+class VertexBitArray {
+ public:
+  using vertex_t = grape::Vertex<VID_T>;
+
+  template <typename RANGE_T>
+  void Init(const RANGE_T& range, bool value = false) {
+    begin_ = range.begin().GetValue();
+    size_ = range.size();
+    words_.resize((size_ + 63) / 64);
+    SetValue(value);
+  }
+
+  inline bool operator[](const vertex_t& v) const {
+    size_t i = v.GetValue() - begin_;
+    return (__atomic_load_n(&words_[i >> 6], __ATOMIC_RELAXED) >> (i & 63)) &
+           1;
+  }
+
+  inline void Set(const vertex_t& v, bool value) {
+    size_t i = v.GetValue() - begin_;
+    uint64_t bit = static_cast<uint64_t>(1) << (i & 63);
+    if (value) {
+      __atomic_fetch_or(&words_[i >> 6], bit, __ATOMIC_RELAXED);
+    } else {
+      __atomic_fetch_and(&words_[i >> 6], ~bit, __ATOMIC_RELAXED);
+    }
+  }
+
+  void SetValue(bool value) {
+    uint64_t word = value ? ~static_cast<uint64_t>(0) : 0;
+    std::fill(words_.begin(), words_.end(), word);
+    // the bits beyond the range are kept clear for Count
+    if (value && (size_ & 63) != 0) {
+      words_.back() = (static_cast<uint64_t>(1) << (size_ & 63)) - 1;
+    }
+  }
+
+  // the number of the vertices flagged
+  size_t Count() const {
+    size_t count = 0;
+    for (auto word : words_) {
+      count += __builtin_popcountll(word);
+    }
+    return count;
+  }
+
+  inline size_t size() const { return size_; }
+
+  void Swap(VertexBitArray& rhs) {
+    std::swap(begin_, rhs.begin_);
+    std::swap(size_, rhs.size_);
+    words_.swap(rhs.words_);
+  }
+
+ private:
+  VID_T begin_ = 0;
+  size_t size_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_BIT_ARRAY_H_
@@ -0,0 +1,251 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_SUBSET_H_
+#define ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_SUBSET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "grape/utils/vertex_array.h"
+
+#include "core/utils/parallel_utils.h"
+
+namespace gs {
+
+/**
+ * @brief A subset of the vertices of a fragment, e.g., the frontier of a
+ * round, in the manner of Ligra. The members are kept in a bitmap over the
+ * lids, and also in a list while they are sparse, i.e., fewer than
+ * 1 / kSparseRatio of the vertices, so visiting or clearing a sparse subset
+ * costs its size rather than the vertices of the fragment. A subset turns
+ * dense once it grows beyond that, until it is cleared.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+class VertexSubset {
+ public:
+  using vertex_t = grape::Vertex<VID_T>;
+  static constexpr size_t kSparseRatio = 20;
+
+  /**
+   * @brief Makes an empty subset of the vertices, which can be any range of
+   * vertices, not necessarily contiguous, e.g., the Vertices() of a fragment.
+   */
+  template <typename RANGE_T>
+  void Init(const RANGE_T& vertices) {
+    VID_T begin = std::numeric_limits<VID_T>::max(), end = 0;
+    for (auto v : vertices) {
+      begin = std::min(begin, v.GetValue());
+      end = std::max(end, static_cast<VID_T>(v.GetValue() + 1));
+    }
+    if (begin >= end) {
+      begin = end = 0;
+    }
+    begin_ = begin;
+    capacity_ = end - begin;
+    words_.assign((capacity_ + 63) / 64, 0);
+    members_.clear();
+    size_ = 0;
+    sparse_ = true;
+  }
+
+  inline bool Contains(const vertex_t& v) const {
+    size_t i = v.GetValue() - begin_;
+    return (words_[i >> 6] >> (i & 63)) & 1;
+  }
+
+  // returns true if v is not in the subset before
+  inline bool Insert(const vertex_t& v) {
+    size_t i = v.GetValue() - begin_;
+    uint64_t bit = static_cast<uint64_t>(1) << (i & 63);
+    if (words_[i >> 6] & bit) {
+      return false;
+    }
+    words_[i >> 6] |= bit;
+    ++size_;
+    if (sparse_) {
+      if (size_ * kSparseRatio < capacity_) {
+        members_.push_back(v.GetValue());
+      } else {
+        sparse_ = false;
+        std::vector<VID_T>().swap(members_);
+      }
+    }
+    return true;
+  }
+
+  void Clear() {
+    if (sparse_) {
+      for (auto lid : members_) {
+        size_t i = lid - begin_;
+        words_[i >> 6] = 0;
+      }
+      members_.clear();
+    } else {
+      std::fill(words_.begin(), words_.end(), 0);
+    }
+    size_ = 0;
+    sparse_ = true;
+  }
+
+  inline size_t size() const { return size_; }
+
+  inline bool empty() const { return size_ == 0; }
+
+  inline bool IsSparse() const { return sparse_; }
+
+  /**
+   * @brief Calls func(v) for each member, in the order of insertion if the
+   * subset is sparse, or else in the order of the lids.
+   */
+  template <typename FUNC_T>
+  void ForEach(const FUNC_T& func) const {
+    if (sparse_) {
+      for (auto lid : members_) {
+        func(vertex_t(lid));
+      }
+      return;
+    }
+    for (size_t w = 0; w < words_.size(); ++w) {
+      forEachInWord(w, func);
+    }
+  }
+
+  /**
+   * @brief Calls func(tid, v) for each member by thread_num threads, each of
+   * which handles a contiguous part of the members.
+   */
+  template <typename FUNC_T>
+  void ParallelForEach(size_t thread_num, const FUNC_T& func) const {
+    size_t n = sparse_ ? members_.size() : words_.size();
+    thread_num = std::max<size_t>(1, std::min(thread_num, n));
+    size_t chunk = (n + thread_num - 1) / thread_num;
+    parallel_for(
+        0, thread_num,
+        [&](size_t tid) {
+          size_t begin = std::min(n, tid * chunk);
+          size_t end = std::min(n, begin + chunk);
+          for (size_t i = begin; i < end; ++i) {
+            if (sparse_) {
+              func(tid, vertex_t(members_[i]));
+            } else {
+              forEachInWord(i, [&](const vertex_t& v) { func(tid, v); });
+            }
+          }
+        },
+        1);
+  }
+
+  void Swap(VertexSubset& rhs) {
+    std::swap(begin_, rhs.begin_);
+    std::swap(capacity_, rhs.capacity_);
+    words_.swap(rhs.words_);
+    members_.swap(rhs.members_);
+    std::swap(size_, rhs.size_);
+    std::swap(sparse_, rhs.sparse_);
+  }
+
+  // sets the bit of v atomically, returns true if it is not set before. The
+  // members set so are counted and listed by MergeInserted, see EdgeMap.
+  inline bool InsertAtomic(const vertex_t& v) {
+    size_t i = v.GetValue() - begin_;
+    uint64_t bit = static_cast<uint64_t>(1) << (i & 63);
+    if (__atomic_load_n(&words_[i >> 6], __ATOMIC_RELAXED) & bit) {
+      return false;
+    }
+    return !(__atomic_fetch_or(&words_[i >> 6], bit, __ATOMIC_RELAXED) & bit);
+  }
+
+  // counts the members set by InsertAtomic, which are listed by the threads
+  void MergeInserted(const std::vector<std::vector<VID_T>>& inserted) {
+    size_t num = 0;
+    for (auto& lids : inserted) {
+      num += lids.size();
+    }
+    size_ += num;
+    if (sparse_ && size_ * kSparseRatio < capacity_) {
+      for (auto& lids : inserted) {
+        members_.insert(members_.end(), lids.begin(), lids.end());
+      }
+    } else if (sparse_) {
+      sparse_ = false;
+      std::vector<VID_T>().swap(members_);
+    }
+  }
+
+ private:
+  template <typename FUNC_T>
+  inline void forEachInWord(size_t w, const FUNC_T& func) const {
+    uint64_t word = words_[w];
+    while (word != 0) {
+      int bit = __builtin_ctzll(word);
+      word &= word - 1;
+      func(vertex_t(static_cast<VID_T>(begin_ + (w << 6) + bit)));
+    }
+  }
+
+  VID_T begin_ = 0;
+  size_t capacity_ = 0;
+  std::vector<uint64_t> words_;
+  std::vector<VID_T> members_;
+  size_t size_ = 0;
+  bool sparse_ = true;
+};
+
+/**
+ * @brief Visits the edges of the frontier, i.e., adj_of(v) for each member v,
+ * and adds the neighbor of an edge e to next if update(v, e) returns true, as
+ * the EdgeMap of Ligra in the push direction. With thread_num > 1, the
+ * members are visited by the threads in parallel, so update must be safe to
+ * run concurrently.
+ */
+template <typename VID_T, typename ADJ_FUNC_T, typename UPDATE_FUNC_T>
+void EdgeMap(const VertexSubset<VID_T>& frontier, VertexSubset<VID_T>& next,
+             const ADJ_FUNC_T& adj_of, const UPDATE_FUNC_T& update,
+             size_t thread_num = 1) {
+  using vertex_t = typename VertexSubset<VID_T>::vertex_t;
+  if (thread_num <= 1) {
+    frontier.ForEach([&](const vertex_t& v) {
+      for (auto& e : adj_of(v)) {
+        if (update(v, e)) {
+          next.Insert(e.neighbor());
+        }
+      }
+    });
+    return;
+  }
+  std::vector<std::vector<VID_T>> inserted(thread_num);
+  frontier.ParallelForEach(thread_num, [&](size_t tid, const vertex_t& v) {
+    for (auto& e : adj_of(v)) {
+      if (update(v, e)) {
+        auto u = e.neighbor();
+        if (next.InsertAtomic(u)) {
+          inserted[tid].push_back(u.GetValue());
+        }
+      }
+    }
+  });
+  next.MergeInserted(inserted);
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_UTILS_VERTEX_SUBSET_H_
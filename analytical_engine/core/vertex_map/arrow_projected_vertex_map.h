@@ -17,12 +17,15 @@
 #define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_ARROW_PROJECTED_VERTEX_MAP_H_
 
 #include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 #include "vineyard/graph/fragment/property_graph_types.h"
 #include "vineyard/graph/vertex_map/arrow_vertex_map.h"
 
 #include "core/config.h"
+#include "core/vertex_map/projected_oid_index.h"
 
 namespace gs {
 /**
@@ -110,13 +113,16 @@ class ArrowProjectedVertexMap
     return false;
   }
 
+  /**
+   * @brief Looks up the oid in all the fragments by the index of the label,
+   * which is built at the first call, rather than by a probe per fragment.
+   */
   bool GetGid(oid_t oid, vid_t& gid) const {
-    for (fid_t i = 0; i < fnum_; ++i) {
-      if (GetGid(i, oid, gid)) {
-        return true;
-      }
+    if (fnum_ == 1) {
+      return GetGid(0, oid, gid);
     }
-    return false;
+    std::call_once(index_flag_, [this]() { buildIndex(); });
+    return index_.Find(oid, gid);
   }
 
   size_t GetTotalVerticesNum() const {
@@ -128,6 +134,19 @@ class ArrowProjectedVertexMap
   }
 
  private:
+  void buildIndex() const {
+    std::vector<std::pair<oid_t, vid_t>> entries;
+    entries.reserve(GetTotalVerticesNum());
+    for (fid_t i = 0; i < fnum_; ++i) {
+      auto& oid_array = oid_arrays_[i];
+      for (int64_t offset = 0; offset < oid_array->length(); ++offset) {
+        entries.emplace_back(oid_array->GetView(offset),
+                             id_parser_.GenerateId(i, label_id_, offset));
+      }
+    }
+    index_.Init(std::move(entries));
+  }
+
   fid_t fnum_;
   label_id_t label_num_;
   label_id_t label_id_;
@@ -136,6 +155,9 @@ class ArrowProjectedVertexMap
   std::vector<std::shared_ptr<oid_array_t>> oid_arrays_;
   std::vector<vineyard::Hashmap<oid_t, vid_t>> o2g_;
 
+  mutable std::once_flag index_flag_;
+  mutable ProjectedOidIndex<oid_t, vid_t> index_;
+
   std::shared_ptr<vineyard::ArrowVertexMap<oid_t, vid_t>> vertex_map_;
 };
 
@@ -220,13 +242,16 @@ class ArrowProjectedVertexMap<arrow::util::string_view, VID_T>
     return false;
   }
 
+  /**
+   * @brief Looks up the oid in all the fragments by the index of the label,
+   * which is built at the first call, rather than by a probe per fragment.
+   */
   bool GetGid(oid_t oid, vid_t& gid) const {
-    for (fid_t i = 0; i < fnum_; ++i) {
-      if (GetGid(i, oid, gid)) {
-        return true;
-      }
+    if (fnum_ == 1) {
+      return GetGid(0, oid, gid);
     }
-    return false;
+    std::call_once(index_flag_, [this]() { buildIndex(); });
+    return index_.Find(oid, gid);
   }
 
   size_t GetTotalVerticesNum() const {
@@ -238,6 +263,19 @@ class ArrowProjectedVertexMap<arrow::util::string_view, VID_T>
   }
 
  private:
+  void buildIndex() const {
+    std::vector<std::pair<oid_t, vid_t>> entries;
+    entries.reserve(GetTotalVerticesNum());
+    for (fid_t i = 0; i < fnum_; ++i) {
+      auto& oid_array = oid_arrays_[i];
+      for (int64_t offset = 0; offset < oid_array->length(); ++offset) {
+        entries.emplace_back(oid_array->GetView(offset),
+                             id_parser_.GenerateId(i, label_id_, offset));
+      }
+    }
+    index_.Init(std::move(entries));
+  }
+
   fid_t fnum_;
   label_id_t label_num_;
   label_id_t label_id_;
@@ -246,6 +284,9 @@ class ArrowProjectedVertexMap<arrow::util::string_view, VID_T>
   std::vector<std::shared_ptr<oid_array_t>> oid_arrays_;
   std::vector<ska::flat_hash_map<oid_t, vid_t>*> o2g_ptrs_;
 
+  mutable std::once_flag index_flag_;
+  mutable ProjectedOidIndex<oid_t, vid_t> index_;
+
   std::shared_ptr<vineyard::ArrowVertexMap<oid_t, vid_t>> vertex_map_;
 };
 
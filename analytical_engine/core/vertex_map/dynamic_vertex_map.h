@@ -0,0 +1,165 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_DYNAMIC_VERTEX_MAP_H_
+#define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_DYNAMIC_VERTEX_MAP_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flat_hash_map/flat_hash_map.hpp"
+#include "folly/dynamic.h"
+
+#include "glog/logging.h"
+#include "grape/worker/comm_spec.h"
+
+#include "core/utils/parallel_utils.h"
+#include "core/vertex_map/global_vertex_map.h"
+
+namespace gs {
+
+/**
+ * @brief The vertex map of DynamicFragment, a GlobalVertexMap of
+ * folly::dynamic oids with an index of the int64 oids beside it, so the
+ * lookups of the int oids hash and compare raw int64 instead of dynamic.
+ *
+ * The index of a fragment holds the int oids of it only. A miss of an int
+ * oid in the index is final unless a non-integer oid has been added, e.g., a
+ * double equal to an int, and then the lookup falls back to the dynamic map.
+ * The index is updated by AddVertex, and rebuilt from the dynamic map by
+ * Construct and Deserialize. An index which falls behind the dynamic map,
+ * e.g., the map is modified through the base class, is bypassed.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+class DynamicVertexMap : public grape::GlobalVertexMap<folly::dynamic, VID_T> {
+  using Base = grape::GlobalVertexMap<folly::dynamic, VID_T>;
+  using oid_t = folly::dynamic;
+
+ public:
+  explicit DynamicVertexMap(const grape::CommSpec& comm_spec)
+      : Base(comm_spec) {}
+
+  void Init() {
+    Base::Init();
+    resetIndex();
+  }
+
+  void Clear() {
+    Base::Clear();
+    resetIndex();
+  }
+
+  void AddVertex(grape::fid_t fid, const oid_t& oid) {
+    VID_T gid;
+    AddVertex(fid, oid, gid);
+  }
+
+  bool AddVertex(grape::fid_t fid, const oid_t& oid, VID_T& gid) {
+    bool indexed = indexed(fid);
+    if (!Base::AddVertex(fid, oid, gid)) {
+      return false;
+    }
+    if (indexed) {
+      index(fid, oid, Base::GetLidFromGid(gid));
+    }
+    return true;
+  }
+
+  bool GetGid(grape::fid_t fid, const oid_t& oid, VID_T& gid) {
+    if (oid.isInt() && indexed(fid)) {
+      auto& index = int_o2l_[fid];
+      auto iter = index.find(oid.getInt());
+      if (iter != index.end()) {
+        gid = Base::Lid2Gid(fid, iter->second);
+        return true;
+      }
+      if (non_int_num_[fid] == 0) {
+        return false;
+      }
+    }
+    return Base::GetGid(fid, oid, gid);
+  }
+
+  bool GetGid(const oid_t& oid, VID_T& gid) {
+    for (grape::fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
+      if (GetGid(fid, oid, gid)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Construct() {
+    Base::Construct();
+    buildIndex();
+  }
+
+  template <typename IOADAPTOR_T>
+  void Deserialize(const std::string& prefix) {
+    Base::template Deserialize<IOADAPTOR_T>(prefix);
+    buildIndex();
+  }
+
+ private:
+  void resetIndex() {
+    int_o2l_.clear();
+    int_o2l_.resize(Base::GetFragmentNum());
+    non_int_num_.assign(Base::GetFragmentNum(), 0);
+  }
+
+  // whether the index of fid covers all of the oids of it
+  bool indexed(grape::fid_t fid) {
+    return fid < int_o2l_.size() &&
+           int_o2l_[fid].size() + non_int_num_[fid] ==
+               Base::GetInnerVertexSize(fid);
+  }
+
+  void index(grape::fid_t fid, const oid_t& oid, VID_T lid) {
+    if (oid.isInt()) {
+      int_o2l_[fid].emplace(oid.getInt(), lid);
+    } else {
+      ++non_int_num_[fid];
+    }
+  }
+
+  // the fragments are indexed in parallel
+  void buildIndex() {
+    resetIndex();
+    parallel_for(
+        0, Base::GetFragmentNum(),
+        [this](size_t i) {
+          auto fid = static_cast<grape::fid_t>(i);
+          VID_T vnum = Base::GetInnerVertexSize(fid);
+          int_o2l_[fid].reserve(vnum);
+          oid_t oid;
+          for (VID_T lid = 0; lid < vnum; ++lid) {
+            CHECK(Base::GetOid(fid, lid, oid));
+            index(fid, oid, lid);
+          }
+        },
+        1);
+  }
+
+  std::vector<ska::flat_hash_map<int64_t, VID_T>> int_o2l_;
+  // the number of non-integer oids of each fragment
+  std::vector<size_t> non_int_num_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_VERTEX_MAP_DYNAMIC_VERTEX_MAP_H_
@@ -16,18 +16,239 @@
 #ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_GLOBAL_VERTEX_MAP_H_
 #define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_GLOBAL_VERTEX_MAP_H_
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "grape/serialization/in_archive.h"
+#include "grape/serialization/out_archive.h"
 #include "grape/vertex_map/global_vertex_map.h"
 #include "vineyard/graph/utils/string_collection.h"
 
+#include "core/communication/chunked_comm.h"
+
 namespace grape {
 
+namespace global_vertex_map_impl {
+
+/**
+ * @brief MurmurHash64A of the string. Unlike std::hash, it doesn't depend on
+ * the standard library, so the hashes stored in a persisted index stay valid
+ * when it is loaded by another binary of the same byte order.
+ */
+inline uint64_t murmur_hash64(const char* key, size_t len,
+                              uint64_t seed = 0x9747b28cULL) {
+  const uint64_t m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
+  uint64_t h = seed ^ (len * m);
+  const char* end = key + (len / 8) * 8;
+  for (const char* p = key; p != end; p += 8) {
+    uint64_t k;
+    memcpy(&k, p, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  size_t rest = len & 7;
+  for (size_t i = rest; i > 0; --i) {
+    h ^= static_cast<uint64_t>(static_cast<uint8_t>(end[i - 1]))
+         << (8 * (i - 1));
+  }
+  if (rest != 0) {
+    h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+struct RefStringHash {
+  size_t operator()(const RefString& s) const {
+    return static_cast<size_t>(murmur_hash64(s.str, s.len));
+  }
+};
+
+/**
+ * @brief An open-addressing hash index from the strings of a StringCollection
+ * to their lids. Only the hash and the lid of each string are stored, the
+ * keys are compared against the collection itself.
+ *
+ * @tparam VID_T VID type
+ */
+template <typename VID_T>
+class StringIdIndex {
+  static constexpr VID_T kEmpty = std::numeric_limits<VID_T>::max();
+
+  struct Entry {
+    size_t hash;
+    VID_T lid;
+  };
+
+ public:
+  StringIdIndex() : size_(0), shift_(64) {}
+
+  size_t size() const { return size_; }
+
+  void clear() {
+    entries_.clear();
+    size_ = 0;
+    shift_ = 64;
+  }
+
+  void reserve(size_t n) {
+    size_t capacity = 16;
+    while (capacity * 7 < n * 10) {
+      capacity <<= 1;
+    }
+    if (capacity > entries_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  bool Find(StringCollection& sc, const RefString& oid, size_t hash,
+            VID_T& lid) const {
+    if (entries_.empty()) {
+      return false;
+    }
+    size_t mask = entries_.size() - 1;
+    RefString rs;
+    for (size_t i = bucket(hash); entries_[i].lid != kEmpty;
+         i = (i + 1) & mask) {
+      if (entries_[i].hash == hash) {
+        sc.Get(entries_[i].lid, rs);
+        if (rs == oid) {
+          lid = entries_[i].lid;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // the string of lid must not be in the index yet
+  void Insert(size_t hash, VID_T lid) {
+    if ((size_ + 1) * 10 > entries_.size() * 7) {
+      rehash(entries_.empty() ? 16 : entries_.size() * 2);
+    }
+    place(hash, lid);
+    ++size_;
+  }
+
+  /**
+   * @brief Writes the table as-is: the size, the capacity, and then the
+   * hashes and the lids of the entries as two arrays, so the table can be
+   * loaded without rehashing any string. The fields are written one by one
+   * rather than the entries, which have the padding after a 32-bit lid.
+   */
+  template <typename IOADAPTOR_T>
+  bool Write(IOADAPTOR_T& io_adaptor) const {
+    uint64_t header[2] = {size_, entries_.size()};
+    if (!io_adaptor->Write(header, sizeof(header))) {
+      return false;
+    }
+    if (entries_.empty()) {
+      return true;
+    }
+    std::vector<uint64_t> hashes(entries_.size());
+    std::vector<VID_T> lids(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      hashes[i] = entries_[i].hash;
+      lids[i] = entries_[i].lid;
+    }
+    return io_adaptor->Write(hashes.data(), hashes.size() * sizeof(uint64_t)) &&
+           io_adaptor->Write(lids.data(), lids.size() * sizeof(VID_T));
+  }
+
+  template <typename IOADAPTOR_T>
+  bool Read(IOADAPTOR_T& io_adaptor) {
+    clear();
+    uint64_t header[2];
+    if (!io_adaptor->Read(header, sizeof(header))) {
+      return false;
+    }
+    if (header[1] == 0) {
+      return true;
+    }
+    // the capacity is a power of two above the size, see reserve
+    if ((header[1] & (header[1] - 1)) != 0 || header[0] >= header[1]) {
+      return false;
+    }
+    std::vector<uint64_t> hashes(header[1]);
+    std::vector<VID_T> lids(header[1]);
+    if (!io_adaptor->Read(hashes.data(), hashes.size() * sizeof(uint64_t)) ||
+        !io_adaptor->Read(lids.data(), lids.size() * sizeof(VID_T))) {
+      return false;
+    }
+    rehash(header[1]);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      entries_[i].hash = static_cast<size_t>(hashes[i]);
+      entries_[i].lid = lids[i];
+    }
+    size_ = header[0];
+    return true;
+  }
+
+ private:
+  // fibonacci hashing, so that weak hashes are spread over the table.
+  inline size_t bucket(size_t hash) const {
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  inline void place(size_t hash, VID_T lid) {
+    size_t mask = entries_.size() - 1;
+    size_t i = bucket(hash);
+    while (entries_[i].lid != kEmpty) {
+      i = (i + 1) & mask;
+    }
+    entries_[i].hash = hash;
+    entries_[i].lid = lid;
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<Entry> old_entries(capacity, Entry{0, kEmpty});
+    old_entries.swap(entries_);
+    shift_ = 64;
+    for (size_t c = capacity; c > 1; c >>= 1) {
+      --shift_;
+    }
+    for (auto& entry : old_entries) {
+      if (entry.lid != kEmpty) {
+        place(entry.hash, entry.lid);
+      }
+    }
+  }
+
+  std::vector<Entry> entries_;
+  size_t size_;
+  int shift_;
+};
+
+template <typename VID_T>
+constexpr VID_T StringIdIndex<VID_T>::kEmpty;
+
+}  // namespace global_vertex_map_impl
+
 /**
  * @brief A specialized GlobalVertexMap for string oid.
  *
+ * The oid -> lid index of each fragment is a StringIdIndex over its string
+ * collection, and the oid is hashed once for the probes of all fragments.
+ * Construct exchanges the string collections along a ring by default, or by
+ * a single chunked alltoallv, see SetExchangeMode.
+ *
  * * @tparam VID_T VID type
  */
 template <typename VID_T>
@@ -36,7 +257,16 @@ class GlobalVertexMap<std::string, VID_T>
   using Base = VertexMapBase<std::string, VID_T>;
 
  public:
-  explicit GlobalVertexMap(const CommSpec& comm_spec) : Base(comm_spec) {}
+  /**
+   * @brief How Construct exchanges the string collections of the fragments.
+   * kRing passes them to the neighbors of a ring, one worker per step.
+   * kAlltoallv sends the packed collections to all workers by
+   * AlltoallvChunked, which takes fewer latency-bound steps on many workers.
+   */
+  enum class ExchangeMode { kRing, kAlltoallv };
+
+  explicit GlobalVertexMap(const CommSpec& comm_spec)
+      : Base(comm_spec), exchange_mode_(ExchangeMode::kRing) {}
   ~GlobalVertexMap() = default;
   void Init() {
     Base::Init();
@@ -58,29 +288,27 @@ class GlobalVertexMap<std::string, VID_T>
 
   void Clear() {}
 
+  void SetExchangeMode(ExchangeMode mode) { exchange_mode_ = mode; }
+
   void AddVertex(fid_t fid, const std::string& oid) {
-    RefString ref_oid(oid);
-    auto& rm = o2l_[fid];
-    if (rm.find(ref_oid) == rm.end()) {
-      RefString key = string_collections_[fid].PutString(ref_oid);
-      rm.emplace(key, static_cast<VID_T>(rm.size()));
-    }
+    VID_T gid;
+    AddVertex(fid, oid, gid);
   }
 
   bool AddVertex(fid_t fid, const std::string& oid, VID_T& gid) {
     RefString ref_oid(oid);
+    size_t hash = hash_(ref_oid);
     auto& rm = o2l_[fid];
-    auto iter = rm.find(ref_oid);
-    if (iter == rm.end()) {
-      RefString key = string_collections_[fid].PutString(ref_oid);
-      gid = static_cast<VID_T>(rm.size());
-      rm.emplace(key, gid);
-      gid = Base::Lid2Gid(fid, gid);
-      return true;
-    } else {
-      gid = Base::Lid2Gid(fid, iter->second);
+    VID_T lid;
+    if (rm.Find(string_collections_[fid], ref_oid, hash, lid)) {
+      gid = Base::Lid2Gid(fid, lid);
       return false;
     }
+    string_collections_[fid].PutString(ref_oid);
+    lid = static_cast<VID_T>(rm.size());
+    rm.Insert(hash, lid);
+    gid = Base::Lid2Gid(fid, lid);
+    return true;
   }
 
   bool GetOid(const VID_T& gid, std::string& oid) {
@@ -100,89 +328,101 @@ class GlobalVertexMap<std::string, VID_T>
 
   bool GetGid(fid_t fid, const std::string& oid, VID_T& gid) {
     RefString ref_oid(oid);
-    auto& rm = o2l_[fid];
-    auto iter = rm.find(ref_oid);
-    if (iter == rm.end()) {
-      return false;
-    } else {
-      gid = Base::Lid2Gid(fid, iter->second);
-      return true;
-    }
+    return getGid(fid, ref_oid, hash_(ref_oid), gid);
   }
 
   bool GetGid(const std::string& oid, VID_T& gid) {
+    RefString ref_oid(oid);
+    size_t hash = hash_(ref_oid);
     for (fid_t i = 0; i < Base::GetFragmentNum(); ++i) {
-      if (GetGid(i, oid, gid)) {
+      if (getGid(i, ref_oid, hash, gid)) {
         return true;
       }
     }
     return false;
   }
 
+  /**
+   * @brief Exchanges the string collections along a ring. The index of each
+   * received fragment is built by a pool of threads as soon as it arrives,
+   * overlapping with receiving the next ones.
+   */
   void Construct() {
+    if (exchange_mode_ == ExchangeMode::kAlltoallv) {
+      constructByAlltoallv();
+      return;
+    }
     const CommSpec& comm_spec = Base::GetCommSpec();
     int worker_id = comm_spec.worker_id();
     int worker_num = comm_spec.worker_num();
-    {
-      std::thread recv_thread([&]() {
-        int src_worker_id = (worker_id + 1) % worker_num;
-        while (src_worker_id != worker_id) {
-          for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
-            if (comm_spec.FragToWorker(fid) != src_worker_id) {
-              continue;
-            }
-            string_collections_[fid].RecvFrom(src_worker_id, comm_spec.comm());
-          }
-          src_worker_id = (src_worker_id + 1) % worker_num;
-        }
-      });
-      std::thread send_thread([&]() {
-        int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
-        while (dst_worker_id != worker_id) {
-          for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
-            if (comm_spec.FragToWorker(fid) != worker_id) {
-              continue;
+
+    std::mutex ready_mutex;
+    std::condition_variable ready_cv;
+    std::vector<fid_t> ready_fids;
+    bool recv_finished = false;
+
+    int thread_num = std::max(
+        1, static_cast<int>((std::thread::hardware_concurrency() +
+                             comm_spec.local_num() - 1) /
+                            comm_spec.local_num()));
+    std::vector<std::thread> index_threads(thread_num);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      index_threads[tid] = std::thread([&] {
+        while (true) {
+          fid_t got;
+          {
+            std::unique_lock<std::mutex> lock(ready_mutex);
+            ready_cv.wait(lock,
+                          [&] { return !ready_fids.empty() || recv_finished; });
+            if (ready_fids.empty()) {
+              break;
             }
-            string_collections_[fid].SendTo(dst_worker_id, comm_spec.comm());
+            got = ready_fids.back();
+            ready_fids.pop_back();
           }
-          dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
+          buildIndex(got);
         }
       });
-      send_thread.join();
-      recv_thread.join();
     }
-    {
-      int thread_num =
-          (std::thread::hardware_concurrency() + comm_spec.local_num() - 1) /
-          comm_spec.local_num();
-      std::atomic<fid_t> current_fid(0);
-      fid_t fnum = comm_spec.fnum();
-      std::vector<std::thread> work_threads(thread_num);
-      for (int tid = 0; tid < thread_num; ++tid) {
-        work_threads[tid] = std::thread([&] {
-          fid_t got;
-          RefString rs;
-          while (true) {
-            got = current_fid.fetch_add(1, std::memory_order_relaxed);
-            if (got >= fnum) {
-              break;
-            }
-            if (comm_spec.FragToWorker(got) == worker_id) {
-              continue;
-            }
-            auto& rm = o2l_[got];
-            VID_T vnum = static_cast<VID_T>(string_collections_[got].Count());
-            rm.reserve(vnum);
-            for (VID_T lid = 0; lid < vnum; ++lid) {
-              string_collections_[got].Get(lid, rs);
-              rm.emplace(rs, lid);
-            }
+
+    std::thread recv_thread([&]() {
+      int src_worker_id = (worker_id + 1) % worker_num;
+      while (src_worker_id != worker_id) {
+        for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
+          if (comm_spec.FragToWorker(fid) != src_worker_id) {
+            continue;
           }
-        });
+          string_collections_[fid].RecvFrom(src_worker_id, comm_spec.comm());
+          {
+            std::lock_guard<std::mutex> lock(ready_mutex);
+            ready_fids.push_back(fid);
+          }
+          ready_cv.notify_one();
+        }
+        src_worker_id = (src_worker_id + 1) % worker_num;
       }
-      for (auto& thrd : work_threads) {
-        thrd.join();
+      {
+        std::lock_guard<std::mutex> lock(ready_mutex);
+        recv_finished = true;
       }
+      ready_cv.notify_all();
+    });
+    std::thread send_thread([&]() {
+      int dst_worker_id = (worker_id + worker_num - 1) % worker_num;
+      while (dst_worker_id != worker_id) {
+        for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
+          if (comm_spec.FragToWorker(fid) != worker_id) {
+            continue;
+          }
+          string_collections_[fid].SendTo(dst_worker_id, comm_spec.comm());
+        }
+        dst_worker_id = (dst_worker_id + worker_num - 1) % worker_num;
+      }
+    });
+    send_thread.join();
+    recv_thread.join();
+    for (auto& thrd : index_threads) {
+      thrd.join();
     }
   }
 
@@ -204,6 +444,14 @@ class GlobalVertexMap<std::string, VID_T>
       sc.Write(io_adaptor);
     }
 
+    // the indices are appended, so that files without them can still be
+    // loaded by rebuilding.
+    ia << kIndexMagic << kIndexVersion;
+    CHECK(io_adaptor->WriteArchive(ia));
+    for (auto& rm : o2l_) {
+      CHECK(rm.Write(io_adaptor));
+    }
+
     CHECK(io_adaptor->Close());
   }
 
@@ -229,7 +477,28 @@ class GlobalVertexMap<std::string, VID_T>
 
     o2l_.clear();
     o2l_.resize(Base::GetFragmentNum());
-    {
+    oa.Clear();
+    uint64_t magic = 0, version = 0;
+    if (io_adaptor->ReadArchive(oa) && !oa.Empty()) {
+      oa >> magic;
+      if (!oa.Empty()) {
+        oa >> version;
+      }
+    }
+    bool index_loaded = magic == kIndexMagic && version == kIndexVersion;
+    if (magic == kIndexMagic && version != kIndexVersion) {
+      LOG(WARNING) << "The persisted vertex map index is of version "
+                   << version << ", expects " << kIndexVersion
+                   << ", it is rebuilt";
+    }
+    for (auto& rm : o2l_) {
+      if (!index_loaded) {
+        break;
+      }
+      index_loaded = rm.Read(io_adaptor);
+    }
+
+    if (!index_loaded) {
       int thread_num = (std::thread::hardware_concurrency() +
                         Base::GetCommSpec().local_num() - 1) /
                        Base::GetCommSpec().local_num();
@@ -239,19 +508,12 @@ class GlobalVertexMap<std::string, VID_T>
       for (int i = 0; i < thread_num; ++i) {
         construct_threads[i] = std::thread([&]() {
           fid_t got;
-          RefString rs;
           while (true) {
             got = current_fid.fetch_add(1, std::memory_order_relaxed);
             if (got >= fnum) {
               break;
             }
-            auto& rm = o2l_[got];
-            size_t vnum = string_collections_[got].Count();
-            rm.reserve(vnum);
-            for (size_t lid = 0; lid < vnum; ++lid) {
-              string_collections_[got].Get(lid, rs);
-              rm.emplace(rs, static_cast<VID_T>(lid));
-            }
+            buildIndex(got);
           }
         });
       }
@@ -270,10 +532,108 @@ class GlobalVertexMap<std::string, VID_T>
   }
 
  private:
+  static constexpr uint64_t kIndexMagic = 0x5354524944584d50ULL;
+  // bumped whenever the layout of the index or the hash function changes
+  static constexpr uint64_t kIndexVersion = 2;
+
+  // Packs the strings of the local fragments once, sends the packed buffer
+  // to every other worker by AlltoallvChunked, and then unpacks and indexes
+  // the fragments of each worker in a thread.
+  void constructByAlltoallv() {
+    const CommSpec& comm_spec = Base::GetCommSpec();
+    int worker_id = comm_spec.worker_id();
+    int worker_num = comm_spec.worker_num();
+
+    InArchive packed;
+    std::string oid;
+    for (fid_t fid = 0; fid < Base::GetFragmentNum(); ++fid) {
+      if (comm_spec.FragToWorker(fid) != worker_id) {
+        continue;
+      }
+      auto& sc = string_collections_[fid];
+      size_t vnum = sc.Count();
+      packed << fid << vnum;
+      for (size_t lid = 0; lid < vnum; ++lid) {
+        sc.Get(lid, oid);
+        packed << oid;
+      }
+    }
+
+    std::vector<std::pair<const char*, size_t>> send(
+        worker_num, std::make_pair(packed.GetBuffer(), packed.GetSize()));
+    send[worker_id].second = 0;
+    std::vector<OutArchive> recv;
+    gs::AlltoallvChunked(send, recv, comm_spec.comm());
+    packed.Clear();
+
+    int thread_num = std::max(
+        1, static_cast<int>((std::thread::hardware_concurrency() +
+                             comm_spec.local_num() - 1) /
+                            comm_spec.local_num()));
+    std::vector<std::thread> unpack_threads(thread_num);
+    std::atomic<int> current_worker(0);
+    for (int tid = 0; tid < thread_num; ++tid) {
+      unpack_threads[tid] = std::thread([&] {
+        std::string str;
+        while (true) {
+          int got = current_worker.fetch_add(1, std::memory_order_relaxed);
+          if (got >= worker_num) {
+            break;
+          }
+          auto& arc = recv[got];
+          while (!arc.Empty()) {
+            fid_t fid;
+            size_t vnum;
+            arc >> fid >> vnum;
+            auto& sc = string_collections_[fid];
+            for (size_t lid = 0; lid < vnum; ++lid) {
+              arc >> str;
+              sc.PutString(RefString(str));
+            }
+            buildIndex(fid);
+          }
+          arc.Clear();
+        }
+      });
+    }
+    for (auto& thrd : unpack_threads) {
+      thrd.join();
+    }
+  }
+
+  void buildIndex(fid_t fid) {
+    auto& rm = o2l_[fid];
+    auto& sc = string_collections_[fid];
+    size_t vnum = sc.Count();
+    RefString rs;
+    rm.clear();
+    rm.reserve(vnum);
+    for (size_t lid = 0; lid < vnum; ++lid) {
+      sc.Get(lid, rs);
+      rm.Insert(hash_(rs), static_cast<VID_T>(lid));
+    }
+  }
+
+  bool getGid(fid_t fid, const RefString& oid, size_t hash, VID_T& gid) {
+    VID_T lid;
+    if (o2l_[fid].Find(string_collections_[fid], oid, hash, lid)) {
+      gid = Base::Lid2Gid(fid, lid);
+      return true;
+    }
+    return false;
+  }
+
   std::vector<StringCollection> string_collections_;
-  std::vector<HashMap<RefString, VID_T>> o2l_;
+  std::vector<global_vertex_map_impl::StringIdIndex<VID_T>> o2l_;
+  global_vertex_map_impl::RefStringHash hash_;
+  ExchangeMode exchange_mode_;
 };
 
+template <typename VID_T>
+constexpr uint64_t GlobalVertexMap<std::string, VID_T>::kIndexMagic;
+template <typename VID_T>
+constexpr uint64_t GlobalVertexMap<std::string, VID_T>::kIndexVersion;
+
 }  // namespace grape
 
 #endif  // ANALYTICAL_ENGINE_CORE_VERTEX_MAP_GLOBAL_VERTEX_MAP_H_
@@ -0,0 +1,129 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PROJECTED_OID_INDEX_H_
+#define ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PROJECTED_OID_INDEX_H_
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flat_hash_map/flat_hash_map.hpp"
+
+namespace gs {
+
+/**
+ * @brief Finds key in the sorted keys[0, n), by a few steps of the
+ * interpolation search, which take about log log n probes on the uniformly
+ * distributed keys, e.g., the integral oids, followed by the binary search,
+ * so the skewed keys cost no more than log n probes.
+ */
+template <typename KEY_T>
+inline bool InterpolationSearch(const KEY_T* keys, size_t n, const KEY_T& key,
+                                size_t& index) {
+  static_assert(std::is_arithmetic<KEY_T>::value,
+                "Interpolates the arithmetic keys only");
+  const int max_interpolations = 8;
+  int interpolations = 0;
+  size_t lo = 0, hi = n;
+  while (lo < hi) {
+    size_t mid;
+    if (interpolations < max_interpolations && keys[lo] < keys[hi - 1]) {
+      if (key < keys[lo] || keys[hi - 1] < key) {
+        return false;
+      }
+      double low = static_cast<double>(keys[lo]);
+      double ratio = (static_cast<double>(key) - low) /
+                     (static_cast<double>(keys[hi - 1]) - low);
+      mid = lo + std::min(hi - 1 - lo,
+                          static_cast<size_t>(ratio * (hi - 1 - lo)));
+      ++interpolations;
+    } else {
+      mid = lo + (hi - lo) / 2;
+    }
+    if (keys[mid] < key) {
+      lo = mid + 1;
+    } else if (key < keys[mid]) {
+      hi = mid;
+    } else {
+      index = mid;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief The oid to gid index of a single vertex label over all the
+ * fragments, which answers a lookup by one probe rather than one per
+ * fragment. The arithmetic oids are kept in sorted arrays and looked up by
+ * InterpolationSearch, and the others in a flat hash map.
+ */
+template <typename OID_T, typename VID_T, typename = void>
+class ProjectedOidIndex {
+ public:
+  void Init(std::vector<std::pair<OID_T, VID_T>>&& entries) {
+    o2g_.reserve(entries.size());
+    for (auto& pair : entries) {
+      o2g_.emplace(pair.first, pair.second);
+    }
+  }
+
+  bool Find(const OID_T& oid, VID_T& gid) const {
+    auto iter = o2g_.find(oid);
+    if (iter != o2g_.end()) {
+      gid = iter->second;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  ska::flat_hash_map<OID_T, VID_T> o2g_;
+};
+
+template <typename OID_T, typename VID_T>
+class ProjectedOidIndex<
+    OID_T, VID_T,
+    typename std::enable_if<std::is_arithmetic<OID_T>::value>::type> {
+ public:
+  void Init(std::vector<std::pair<OID_T, VID_T>>&& entries) {
+    std::sort(entries.begin(), entries.end());
+    oids_.resize(entries.size());
+    gids_.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+      oids_[i] = entries[i].first;
+      gids_[i] = entries[i].second;
+    }
+  }
+
+  bool Find(const OID_T& oid, VID_T& gid) const {
+    size_t index;
+    if (InterpolationSearch(oids_.data(), oids_.size(), oid, index)) {
+      gid = gids_[index];
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  std::vector<OID_T> oids_;
+  std::vector<VID_T> gids_;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_VERTEX_MAP_PROJECTED_OID_INDEX_H_
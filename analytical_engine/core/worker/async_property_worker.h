@@ -0,0 +1,148 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_WORKER_ASYNC_PROPERTY_WORKER_H_
+#define ANALYTICAL_ENGINE_CORE_WORKER_ASYNC_PROPERTY_WORKER_H_
+
+#include <mpi.h>
+
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "grape/communication/communicator.h"
+#include "grape/config.h"
+#include "grape/parallel/parallel_engine.h"
+#include "grape/worker/comm_spec.h"
+
+#include "core/parallel/async_property_message_manager.h"
+#include "core/worker/worker_utils.h"
+
+namespace gs {
+
+template <typename FRAG_T, typename CONTEXT_T>
+class AsyncPropertyAppBase;
+
+/**
+ * @brief An asynchronous worker for labeled fragment. There are no rounds,
+ * IncEval is invoked as soon as messages arrive, and the query ends when the
+ * message manager detects that all workers are idle with no message in
+ * flight.
+ * @tparam APP_T
+ */
+template <typename APP_T>
+class AsyncPropertyWorker {
+  static_assert(
+      std::is_base_of<AsyncPropertyAppBase<typename APP_T::fragment_t,
+                                           typename APP_T::context_t>,
+                      APP_T>::value,
+      "AsyncPropertyWorker should work with AsyncPropertyApp");
+  static_assert(
+      vineyard::is_property_fragment<typename APP_T::fragment_t>::value,
+      "AsyncPropertyWorker is only available for "
+      "property graph");
+
+  // how long an idle worker waits for messages before polling termination
+  static constexpr std::chrono::microseconds idle_wait{100};
+
+ public:
+  using fragment_t = typename APP_T::fragment_t;
+  using context_t = typename APP_T::context_t;
+  using message_manager_t = AsyncPropertyMessageManager;
+
+  AsyncPropertyWorker(std::shared_ptr<APP_T> app,
+                      std::shared_ptr<fragment_t> graph)
+      : app_(app),
+        graph_(graph),
+        context_(std::make_shared<context_t>(*graph)) {}
+
+  virtual ~AsyncPropertyWorker() = default;
+
+  void Init(const grape::CommSpec& comm_spec,
+            const grape::ParallelEngineSpec& pe_spec =
+                grape::DefaultParallelEngineSpec()) {
+    // prepare for the query
+    graph_->PrepareToRunApp(APP_T::message_strategy, APP_T::need_split_edges);
+
+    comm_spec_ = comm_spec;
+
+    messages_.Init(comm_spec_.comm());
+
+    grape::InitParallelEngine(app_, pe_spec);
+    grape::InitCommunicator(app_, comm_spec_.comm());
+  }
+
+  void Finalize() {}
+
+  template <class... Args>
+  void Query(Args&&... args) {
+    MPI_Barrier(comm_spec_.comm());
+
+    context_->Init(messages_, std::forward<Args>(args)...);
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      VLOG(1) << "[Coordinator]: Finished Init";
+    }
+
+    bind_schema(*app_, *graph_);
+
+    messages_.Start();
+
+    app_->PEval(*graph_, *context_, messages_);
+    messages_.FlushChannels();
+
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      VLOG(1) << "[Coordinator]: Finished PEval";
+    }
+
+    size_t step = 0;
+    while (true) {
+      if (messages_.HasIncoming()) {
+        app_->IncEval(*graph_, *context_, messages_);
+        messages_.FlushChannels();
+        ++step;
+      } else if (messages_.ToTerminate()) {
+        break;
+      } else {
+        messages_.WaitIncoming(idle_wait);
+      }
+    }
+
+    if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      VLOG(1) << "[Coordinator]: Finished after " << step << " IncEval";
+    }
+    messages_.Finalize();
+  }
+
+  std::shared_ptr<context_t> GetContext() { return context_; }
+
+  void Output(std::ostream& os) { context_->Output(os); }
+
+ private:
+  std::shared_ptr<APP_T> app_;
+  std::shared_ptr<fragment_t> graph_;
+  std::shared_ptr<context_t> context_;
+  message_manager_t messages_;
+
+  grape::CommSpec comm_spec_;
+};
+
+template <typename APP_T>
+constexpr std::chrono::microseconds AsyncPropertyWorker<APP_T>::idle_wait;
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_WORKER_ASYNC_PROPERTY_WORKER_H_
@@ -29,6 +29,7 @@
 #include "grape/parallel/parallel_engine.h"
 
 #include "core/parallel/property_message_manager.h"
+#include "core/worker/worker_utils.h"
 
 namespace gs {
 
@@ -92,6 +93,8 @@ class DefaultPropertyWorker {
 
     messages_.Start();
 
+    bind_schema(*app_, graph);
+
     messages_.StartARound();
 
     app_->PEval(graph, *context_, messages_);
@@ -118,13 +121,24 @@ class DefaultPropertyWorker {
       ++step;
     }
 
+    end_query(*app_, graph, *context_);
+
     MPI_Barrier(comm_spec_.comm());
 
     messages_.Finalize();
+
+    log_round_stats(comm_spec_, messages_.GetRoundStats());
   }
 
   std::shared_ptr<context_t> GetContext() { return context_; }
 
+  /**
+   * @brief The stats of the rounds of the last query, see RoundStats.
+   */
+  const RoundStatsRecorder& GetRoundStats() const {
+    return messages_.GetRoundStats();
+  }
+
   void Output(std::ostream& os) { context_->Output(os); }
 
  private:
@@ -28,6 +28,8 @@
 #include "grape/parallel/default_message_manager.h"
 #include "grape/parallel/parallel_engine.h"
 
+#include "core/worker/worker_utils.h"
+
 namespace gs {
 
 template <typename FRAG_T, typename CONTEXT_T>
@@ -115,6 +117,8 @@ class DefaultWorker {
       ++step;
     }
 
+    end_query(*app_, graph, *context_);
+
     MPI_Barrier(comm_spec_.comm());
 
     messages_.Finalize();
@@ -29,6 +29,8 @@
 #include "grape/worker/comm_spec.h"
 
 #include "core/parallel/parallel_property_message_manager.h"
+#include "core/worker/push_pull_switcher.h"
+#include "core/worker/worker_utils.h"
 
 namespace gs {
 
@@ -73,6 +75,7 @@ class ParallelPropertyWorker {
     comm_spec_ = comm_spec;
 
     messages_.Init(comm_spec_.comm());
+    switcher_.Init(comm_spec_.comm());
 
     grape::InitParallelEngine(app_, pe_spec);
     grape::InitCommunicator(app_, comm_spec_.comm());
@@ -89,6 +92,8 @@ class ParallelPropertyWorker {
       VLOG(1) << "[Coordinator]: Finished Init";
     }
 
+    bind_schema(*app_, *graph_);
+
     int round = 0;
 
     messages_.Start();
@@ -104,26 +109,56 @@ class ParallelPropertyWorker {
     }
 
     int step = 1;
+    switcher_.Reset();
 
     while (!messages_.ToTerminate()) {
       round++;
+      auto direction = decide_direction(*app_, *graph_, *context_, switcher_);
       messages_.StartARound();
 
-      app_->IncEval(*graph_, *context_, messages_);
+      inc_eval(*app_, *graph_, *context_, messages_, direction);
 
       messages_.FinishARound();
 
       if (comm_spec_.worker_id() == grape::kCoordinatorRank) {
-        VLOG(1) << "[Coordinator]: Finished IncEval - " << step;
+        VLOG(1) << "[Coordinator]: Finished IncEval - " << step << " by "
+                << (direction == EvalDirection::kPull ? "pull" : "push");
       }
       ++step;
     }
     MPI_Barrier(comm_spec_.comm());
     messages_.Finalize();
+    if (switcher_.switch_num() != 0 &&
+        comm_spec_.worker_id() == grape::kCoordinatorRank) {
+      VLOG(1) << "[Coordinator]: Switched between push and pull "
+              << switcher_.switch_num() << " times";
+    }
+
+    log_round_stats(comm_spec_, messages_.GetRoundStats());
   }
 
   std::shared_ptr<context_t> GetContext() { return context_; }
 
+  /**
+   * @brief The message manager, which is configured between Init() and
+   * Query(), e.g., to enable the hierarchical routing.
+   */
+  message_manager_t& GetMessageManager() { return messages_; }
+
+  /**
+   * @brief The switcher of the push and the pull rounds of the apps having
+   * both, which is configured between Init() and Query(), e.g., to fix the
+   * direction by the thresholds.
+   */
+  PushPullSwitcher& GetSwitcher() { return switcher_; }
+
+  /**
+   * @brief The stats of the rounds of the last query, see RoundStats.
+   */
+  const RoundStatsRecorder& GetRoundStats() const {
+    return messages_.GetRoundStats();
+  }
+
   void Output(std::ostream& os) { context_->Output(os); }
 
  private:
@@ -131,6 +166,7 @@ class ParallelPropertyWorker {
   std::shared_ptr<fragment_t> graph_;
   std::shared_ptr<context_t> context_;
   message_manager_t messages_;
+  PushPullSwitcher switcher_;
 
   grape::CommSpec comm_spec_;
 };
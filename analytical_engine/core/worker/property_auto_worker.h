@@ -29,6 +29,7 @@
 #include "grape/worker/comm_spec.h"
 
 #include "core/parallel/property_auto_message_manager.h"
+#include "core/worker/worker_utils.h"
 
 namespace gs {
 
@@ -120,10 +121,19 @@ class PropertyAutoWorker {
     MPI_Barrier(comm_spec_.comm());
 
     messages_.Finalize();
+
+    log_round_stats(comm_spec_, messages_.GetRoundStats());
   }
 
   std::shared_ptr<context_t> GetContext() { return context_; }
 
+  /**
+   * @brief The stats of the rounds of the last query, see RoundStats.
+   */
+  const RoundStatsRecorder& GetRoundStats() const {
+    return messages_.GetRoundStats();
+  }
+
   void Output(std::ostream& os) { context_->Output(os); }
 
  private:
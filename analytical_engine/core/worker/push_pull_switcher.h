@@ -0,0 +1,160 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_WORKER_PUSH_PULL_SWITCHER_H_
+#define ANALYTICAL_ENGINE_CORE_WORKER_PUSH_PULL_SWITCHER_H_
+
+#include <mpi.h>
+
+#include <cstdint>
+
+#include "glog/logging.h"
+
+#include "grape/communication/sync_comm.h"
+#include "grape/config.h"
+
+namespace gs {
+
+/**
+ * @brief The vertices and the edges to be processed by the next IncEval of
+ * an app, and all the ones it could process, which are counted by the
+ * CountActive of the app on the inner vertices of the fragment, and summed
+ * over the workers by PushPullSwitcher.
+ */
+struct ActiveStats {
+  uint64_t active_vertex_num = 0;
+  // the out edges of the active vertices
+  uint64_t active_edge_num = 0;
+  uint64_t total_vertex_num = 0;
+  uint64_t total_edge_num = 0;
+};
+
+enum class EvalDirection {
+  // the active vertices push the updates along their out edges
+  kPush,
+  // all the vertices pull the updates along their in edges
+  kPull,
+};
+
+/**
+ * @brief Decides the direction of each IncEval of the apps having both the
+ * push and the pull variants, by the heuristic of the direction-optimizing
+ * BFS: push until the out edges of the active vertices exceed 1 / alpha of
+ * all the edges, then pull until the active vertices are under 1 / beta of
+ * all the vertices. The two thresholds keep it from switching back and forth
+ * around a single one.
+ *
+ * It has a communicator of its own, as the message manager may use the one
+ * of the workers in the background. The apps summing the stats themselves,
+ * e.g., the BFS ones with their own frontier, call Next instead, without
+ * Init.
+ */
+class PushPullSwitcher {
+ public:
+  static constexpr double kDefaultAlpha = 15;
+  static constexpr double kDefaultBeta = 18;
+
+  explicit PushPullSwitcher(double alpha = kDefaultAlpha,
+                            double beta = kDefaultBeta)
+      : alpha_(alpha), beta_(beta) {}
+
+  ~PushPullSwitcher() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized && ValidComm(comm_)) {
+      MPI_Comm_free(&comm_);
+    }
+  }
+
+  PushPullSwitcher(const PushPullSwitcher&) = delete;
+  PushPullSwitcher& operator=(const PushPullSwitcher&) = delete;
+
+  void Init(MPI_Comm comm) {
+    if (!ValidComm(comm_)) {
+      MPI_Comm_dup(comm, &comm_);
+    }
+    Reset();
+  }
+
+  // e.g., an alpha of 0 never pulls, and the max of both never pushes after
+  // the first round with any active edge
+  void SetThresholds(double alpha, double beta) {
+    alpha_ = alpha;
+    beta_ = beta;
+  }
+
+  // starts a new query by pushing
+  void Reset() {
+    direction_ = EvalDirection::kPush;
+    switch_num_ = 0;
+  }
+
+  /**
+   * @brief Sums the stats of the workers, and returns the direction of the
+   * next round, which is the same on all the workers.
+   */
+  EvalDirection Decide(const ActiveStats& local) {
+    uint64_t local_values[4] = {local.active_vertex_num, local.active_edge_num,
+                                local.total_vertex_num, local.total_edge_num};
+    uint64_t values[4];
+    MPI_Allreduce(local_values, values, 4, MPI_UINT64_T, MPI_SUM, comm_);
+    ActiveStats global;
+    global.active_vertex_num = values[0];
+    global.active_edge_num = values[1];
+    global.total_vertex_num = values[2];
+    global.total_edge_num = values[3];
+    return Next(global);
+  }
+
+  /**
+   * @brief Returns the direction of the next round by the stats summed over
+   * the workers already, which must be the same on all of them.
+   */
+  EvalDirection Next(const ActiveStats& global) {
+    global_ = global;
+    EvalDirection next = direction_;
+    if (direction_ == EvalDirection::kPush) {
+      if (global_.active_edge_num * alpha_ > global_.total_edge_num) {
+        next = EvalDirection::kPull;
+      }
+    } else if (global_.active_vertex_num * beta_ < global_.total_vertex_num) {
+      next = EvalDirection::kPush;
+    }
+    if (next != direction_) {
+      direction_ = next;
+      ++switch_num_;
+    }
+    return direction_;
+  }
+
+  EvalDirection direction() const { return direction_; }
+
+  // the stats of the last Decide or Next
+  const ActiveStats& global_stats() const { return global_; }
+
+  int switch_num() const { return switch_num_; }
+
+ private:
+  double alpha_;
+  double beta_;
+  MPI_Comm comm_ = NULL_COMM;
+  EvalDirection direction_ = EvalDirection::kPush;
+  ActiveStats global_;
+  int switch_num_ = 0;
+};
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_WORKER_PUSH_PULL_SWITCHER_H_
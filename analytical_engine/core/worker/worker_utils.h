@@ -0,0 +1,184 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANALYTICAL_ENGINE_CORE_WORKER_WORKER_UTILS_H_
+#define ANALYTICAL_ENGINE_CORE_WORKER_WORKER_UTILS_H_
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/worker/comm_spec.h"
+
+#include "core/parallel/round_stats.h"
+#include "core/worker/push_pull_switcher.h"
+
+namespace gs {
+
+namespace worker_impl {
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+auto end_query(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx, int)
+    -> decltype(app.EndQuery(frag, ctx), void()) {
+  app.EndQuery(frag, ctx);
+}
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+void end_query(APP_T&, const FRAG_T&, CONTEXT_T&, long) {}
+
+template <typename APP_T, typename FRAG_T>
+auto bind_schema(APP_T& app, const FRAG_T& frag, int)
+    -> decltype(app.BindSchema(frag), void()) {
+  app.BindSchema(frag);
+}
+
+template <typename APP_T, typename FRAG_T>
+void bind_schema(APP_T&, const FRAG_T&, long) {}
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+auto decide_direction(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx,
+                      PushPullSwitcher& switcher, int)
+    -> decltype(app.CountActive(frag, ctx), EvalDirection()) {
+  return switcher.Decide(app.CountActive(frag, ctx));
+}
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+EvalDirection decide_direction(APP_T&, const FRAG_T&, CONTEXT_T&,
+                               PushPullSwitcher&, long) {
+  return EvalDirection::kPush;
+}
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T,
+          typename MESSAGE_MANAGER_T>
+auto inc_eval(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx,
+              MESSAGE_MANAGER_T& messages, EvalDirection direction, int)
+    -> decltype(app.IncEvalPull(frag, ctx, messages), void()) {
+  if (direction == EvalDirection::kPull) {
+    app.IncEvalPull(frag, ctx, messages);
+  } else {
+    app.IncEval(frag, ctx, messages);
+  }
+}
+
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T,
+          typename MESSAGE_MANAGER_T>
+void inc_eval(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx,
+              MESSAGE_MANAGER_T& messages, EvalDirection, long) {
+  app.IncEval(frag, ctx, messages);
+}
+
+}  // namespace worker_impl
+
+/**
+ * @brief Calls the EndQuery of the app once the query converges, if there is
+ * one, e.g., to keep the results for the next query.
+ */
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+void end_query(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx) {
+  worker_impl::end_query(app, frag, ctx, 0);
+}
+
+/**
+ * @brief Calls the BindSchema of the app before PEval, if there is one, to
+ * resolve the columns of the properties read by the app, see
+ * property_schema_binding.h.
+ */
+template <typename APP_T, typename FRAG_T>
+void bind_schema(APP_T& app, const FRAG_T& frag) {
+  worker_impl::bind_schema(app, frag, 0);
+}
+
+/**
+ * @brief The direction of the next IncEval of the app, which is decided by
+ * the switcher on the ActiveStats returned by the CountActive of the app if
+ * there is one, or else always kPush. All workers must call it before each
+ * IncEval, as the stats are summed over them.
+ */
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T>
+EvalDirection decide_direction(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx,
+                               PushPullSwitcher& switcher) {
+  return worker_impl::decide_direction(app, frag, ctx, switcher, 0);
+}
+
+/**
+ * @brief Calls the IncEvalPull of the app for kPull if there is one, or else
+ * the IncEval. An app having both pushes in IncEval, i.e., the updated
+ * vertices send the messages along their out edges, and pulls in
+ * IncEvalPull, i.e., each vertex gathers along its in edges, with the
+ * messages of both consumed the same way in the next round.
+ */
+template <typename APP_T, typename FRAG_T, typename CONTEXT_T,
+          typename MESSAGE_MANAGER_T>
+void inc_eval(APP_T& app, const FRAG_T& frag, CONTEXT_T& ctx,
+              MESSAGE_MANAGER_T& messages, EvalDirection direction) {
+  worker_impl::inc_eval(app, frag, ctx, messages, direction, 0);
+}
+
+/**
+ * @brief Logs the slowest worker of each round of the query on the
+ * coordinator at VLOG(1), to tell the stragglers, and the stats of the
+ * rounds of each worker as JSON at VLOG(2). All workers must call it, since
+ * the times are gathered to the coordinator.
+ */
+inline void log_round_stats(const grape::CommSpec& comm_spec,
+                            const RoundStatsRecorder& stats) {
+  if (!VLOG_IS_ON(1)) {
+    return;
+  }
+  VLOG(2) << "[worker " << comm_spec.worker_id()
+          << "]: round stats: " << stats.ToJSON();
+
+  auto& rounds = stats.rounds();
+  int worker_num = comm_spec.worker_num();
+  bool is_coordinator = comm_spec.worker_id() == grape::kCoordinatorRank;
+  std::vector<double> times(2 * rounds.size());
+  for (size_t i = 0; i < rounds.size(); ++i) {
+    times[2 * i] = rounds[i].compute_time;
+    times[2 * i + 1] = rounds[i].finish_time;
+  }
+  std::vector<double> all_times(is_coordinator ? times.size() * worker_num
+                                               : 0);
+  MPI_Gather(times.data(), times.size(), MPI_DOUBLE, all_times.data(),
+             times.size(), MPI_DOUBLE, grape::kCoordinatorRank,
+             comm_spec.comm());
+  if (!is_coordinator) {
+    return;
+  }
+  for (size_t i = 0; i < rounds.size(); ++i) {
+    int slowest = 0;
+    double max_compute = 0, max_finish = 0, sum_compute = 0;
+    for (int worker = 0; worker < worker_num; ++worker) {
+      double compute = all_times[worker * times.size() + 2 * i];
+      double finish = all_times[worker * times.size() + 2 * i + 1];
+      if (compute > max_compute) {
+        max_compute = compute;
+        slowest = worker;
+      }
+      max_finish = std::max(max_finish, finish);
+      sum_compute += compute;
+    }
+    VLOG(1) << "[Coordinator]: round " << i << " compute max " << max_compute
+            << "s on worker " << slowest << ", avg "
+            << sum_compute / worker_num << "s, finish max " << max_finish
+            << "s";
+  }
+}
+
+}  // namespace gs
+
+#endif  // ANALYTICAL_ENGINE_CORE_WORKER_WORKER_UTILS_H_
@@ -88,6 +88,13 @@ void _Compute(MessageIterator<_MD_TYPE> messages, Vertex<_VD_TYPE, _MD_TYPE>& v,
   Compute(messages, v, context);
 }
 
+#ifdef _ENABLE_COMPUTE_BATCH
+void _ComputeBatch(VertexBatch<_VD_TYPE, _MD_TYPE>& batch,
+                   Context<_VD_TYPE, _MD_TYPE>& context) {
+  ComputeBatch(batch, context);
+}
+#endif
+
 #ifdef _ENABLE_COMBINE
 double _Combine(MessageIterator<_MD_TYPE> messages) {
   return Combine(messages);
@@ -120,6 +127,9 @@ std::shared_ptr<_APP_TYPE> CreateApp() {
   gs::CythonPregelProgram<_VD_TYPE, _MD_TYPE> program;
   program.SetInitFunction(_Init);
   program.SetComputeFunction(_Compute);
+#ifdef _ENABLE_COMPUTE_BATCH
+  program.SetComputeBatchFunction(_ComputeBatch);
+#endif
 #ifdef _ENABLE_COMBINE
   gs::CythonCombinator<_MD_TYPE> combinator;
   combinator.SetCombineFunction(_Combine);
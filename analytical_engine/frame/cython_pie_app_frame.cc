@@ -87,6 +87,20 @@ void _IncEval(Fragment& frag, Context<_VD_TYPE, _MD_TYPE>& context) {
   IncEval(frag, context);
 }
 
+#ifdef _ENABLE_PEVAL_KERNEL
+void _PEvalKernel(Fragment& frag, Context<_VD_TYPE, _MD_TYPE>& context,
+                  VertexRange& vertices, int label, int tid) {
+  PEvalKernel(frag, context, vertices, label, tid);
+}
+#endif
+
+#ifdef _ENABLE_INCEVAL_KERNEL
+void _IncEvalKernel(Fragment& frag, Context<_VD_TYPE, _MD_TYPE>& context,
+                    VertexRange& vertices, int label, int tid) {
+  IncEvalKernel(frag, context, vertices, label, tid);
+}
+#endif
+
 void AppInit() {
 #define INIT_PREFIX PyInit_
 #define PPCAT_NX(A, B) A##B
@@ -114,6 +128,12 @@ std::shared_ptr<_APP_TYPE> CreateApp() {
   program.SetInitFunction(_Init);
   program.SetPEvalFunction(_PEval);
   program.SetIncEvalFunction(_IncEval);
+#ifdef _ENABLE_PEVAL_KERNEL
+  program.SetPEvalKernel(_PEvalKernel);
+#endif
+#ifdef _ENABLE_INCEVAL_KERNEL
+  program.SetIncEvalKernel(_IncEvalKernel);
+#endif
   return std::make_shared<_APP_TYPE>(program);
 }
 
@@ -15,13 +15,16 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "vineyard/common/util/typename.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 
+#include "core/fragment/arrow_flattened_fragment.h"
 #include "core/fragment/arrow_projected_fragment.h"
 #include "core/fragment/dynamic_fragment.h"
 #include "core/fragment/dynamic_projected_fragment.h"
+#include "core/loader/property_encoder.h"
 #include "core/object/fragment_wrapper.h"
 #include "core/server/rpc_utils.h"
 #include "proto/attr_value.pb.h"
@@ -32,12 +35,12 @@
 
 /**
  * project_frame.cc serves as a frame to be compiled with
- * ArrowProjectedFragment/DynamicProjectedFragment. The frame will be compiled
- * when the client issues a PROJECT_TO_SIMPLE request. Then, a library will be
- * produced based on the frame. The reason we need the frame is the template
- * parameters are unknown before the project request has arrived at the
- * analytical engine. A dynamic library is necessary to prevent hardcode data
- * type in the engine.
+ * ArrowProjectedFragment/ArrowFlattenedFragment/DynamicProjectedFragment. The
+ * frame will be compiled when the client issues a PROJECT_TO_SIMPLE request.
+ * Then, a library will be produced based on the frame. The reason we need the
+ * frame is the template parameters are unknown before the project request has
+ * arrived at the analytical engine. A dynamic library is necessary to prevent
+ * hardcode data type in the engine.
  */
 namespace gs {
 
@@ -68,10 +71,58 @@ class ProjectSimpleFrame<
     auto e_label = std::to_string(e_label_id);
     auto v_prop = std::to_string(v_prop_id);
     auto e_prop = std::to_string(e_prop_id);
+    std::string vertex_order = "none";
+    if (params.HasKey(rpc::VERTEX_ORDER)) {
+      BOOST_LEAF_ASSIGN(vertex_order,
+                        params.Get<std::string>(rpc::VERTEX_ORDER));
+    }
+    BOOST_LEAF_CHECK(ParseVertexOrder(vertex_order));
+    bool materialize_edge_data = false;
+    if (params.HasKey(rpc::MATERIALIZE_EDGE_DATA)) {
+      BOOST_LEAF_ASSIGN(materialize_edge_data,
+                        params.Get<bool>(rpc::MATERIALIZE_EDGE_DATA));
+    }
+    bool compress_adjacency = false;
+    if (params.HasKey(rpc::COMPRESS_ADJACENCY)) {
+      BOOST_LEAF_ASSIGN(compress_adjacency,
+                        params.Get<bool>(rpc::COMPRESS_ADJACENCY));
+    }
+    bool sort_adjacency = false;
+    if (params.HasKey(rpc::SORT_ADJACENCY)) {
+      BOOST_LEAF_ASSIGN(sort_adjacency, params.Get<bool>(rpc::SORT_ADJACENCY));
+    }
+    std::string edge_filter;
+    if (params.HasKey(rpc::EDGE_FILTER)) {
+      BOOST_LEAF_ASSIGN(edge_filter, params.Get<std::string>(rpc::EDGE_FILTER));
+      BOOST_LEAF_CHECK(ParseEdgeFilter(edge_filter));
+    }
+    std::string edge_window;
+    if (params.HasKey(rpc::EDGE_WINDOW)) {
+      BOOST_LEAF_ASSIGN(edge_window, params.Get<std::string>(rpc::EDGE_WINDOW));
+      BOOST_LEAF_CHECK(ParseEdgeWindow(edge_window));
+    }
+    std::string out_of_core_dir;
+    if (params.HasKey(rpc::OUT_OF_CORE_DIR)) {
+      BOOST_LEAF_ASSIGN(out_of_core_dir,
+                        params.Get<std::string>(rpc::OUT_OF_CORE_DIR));
+    }
     auto input_frag =
         std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
+    VY_OK_OR_RAISE(CheckUnencodedProperty(
+        input_frag->vertex_data_table(v_label_id), v_prop_id, "Vertex"));
+    VY_OK_OR_RAISE(CheckUnencodedProperty(
+        input_frag->edge_data_table(e_label_id), e_prop_id, "Edge"));
     auto projected_frag = projected_fragment_t::Project(
-        input_frag, v_label, v_prop, e_label, e_prop);
+        input_frag, v_label, v_prop, e_label, e_prop, vertex_order,
+        materialize_edge_data, compress_adjacency, edge_filter, sort_adjacency,
+        edge_window);
+    if (projected_frag == nullptr) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "Failed to project the fragment, see the logs");
+    }
+    if (!out_of_core_dir.empty()) {
+      BOOST_LEAF_CHECK(projected_frag->MapToDisk(out_of_core_dir));
+    }
 
     rpc::GraphDef graph_def;
     graph_def.set_key(projected_graph_name);
@@ -122,6 +173,76 @@ class ProjectSimpleFrame<
   }
 };
 
+template <typename OID_T, typename VID_T, typename VDATA_T, typename EDATA_T>
+class ProjectSimpleFrame<
+    gs::ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>> {
+  using fragment_t = vineyard::ArrowFragment<OID_T, VID_T>;
+  using projected_fragment_t =
+      gs::ArrowFlattenedFragment<OID_T, VID_T, VDATA_T, EDATA_T>;
+
+ public:
+  static bl::result<std::shared_ptr<IFragmentWrapper>> Project(
+      std::shared_ptr<IFragmentWrapper>& input_wrapper,
+      const std::string& projected_graph_name, const rpc::GSParams& params) {
+    if (input_wrapper->graph_def().graph_type() != rpc::ARROW_PROPERTY) {
+      RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                      "graph_type should be ARROW_PROPERTY");
+    }
+
+    using label_id_t = typename projected_fragment_t::label_id_t;
+    using prop_id_t = typename projected_fragment_t::prop_id_t;
+    BOOST_LEAF_AUTO(v_labels, getIds<label_id_t>(params, rpc::V_LABEL_IDS));
+    BOOST_LEAF_AUTO(e_labels, getIds<label_id_t>(params, rpc::E_LABEL_IDS));
+    BOOST_LEAF_AUTO(v_props, getIds<prop_id_t>(params, rpc::V_PROP_IDS));
+    BOOST_LEAF_AUTO(e_props, getIds<prop_id_t>(params, rpc::E_PROP_IDS));
+    auto input_frag =
+        std::static_pointer_cast<fragment_t>(input_wrapper->fragment());
+    for (size_t i = 0; i < v_labels.size() && i < v_props.size(); ++i) {
+      VY_OK_OR_RAISE(CheckUnencodedProperty(
+          input_frag->vertex_data_table(v_labels[i]), v_props[i], "Vertex"));
+    }
+    for (size_t i = 0; i < e_labels.size() && i < e_props.size(); ++i) {
+      VY_OK_OR_RAISE(CheckUnencodedProperty(
+          input_frag->edge_data_table(e_labels[i]), e_props[i], "Edge"));
+    }
+    BOOST_LEAF_AUTO(projected_frag,
+                    projected_fragment_t::Project(input_frag, v_labels, v_props,
+                                                  e_labels, e_props));
+
+    rpc::GraphDef graph_def;
+    graph_def.set_key(projected_graph_name);
+    graph_def.set_graph_type(rpc::ARROW_FLATTENED);
+    graph_def.set_directed(input_frag->directed());
+
+    auto* schema = graph_def.mutable_schema_def();
+    schema->set_oid_type(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::oid_t>::Get()));
+    schema->set_vid_type(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::vid_t>::Get()));
+    schema->set_vdata_type(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::vdata_t>::Get()));
+    schema->set_edata_type(vineyard::normalize_datatype(
+        vineyard::TypeName<typename projected_fragment_t::edata_t>::Get()));
+    schema->set_property_schema_json("{}");
+
+    auto wrapper = std::make_shared<FragmentWrapper<projected_fragment_t>>(
+        projected_graph_name, graph_def, projected_frag);
+    return std::dynamic_pointer_cast<IFragmentWrapper>(wrapper);
+  }
+
+ private:
+  template <typename T>
+  static bl::result<std::vector<T>> getIds(const rpc::GSParams& params,
+                                           rpc::ParamKey key) {
+    BOOST_LEAF_AUTO(list, params.Get<rpc::AttrValue_ListValue>(key));
+    std::vector<T> ids;
+    for (auto id : list.i()) {
+      ids.push_back(static_cast<T>(id));
+    }
+    return ids;
+  }
+};
+
 #ifdef NETWORKX
 template <typename VDATA_T, typename EDATA_T>
 class ProjectSimpleFrame<gs::DynamicProjectedFragment<VDATA_T, EDATA_T>> {
@@ -15,6 +15,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <type_traits>
 
 #include "vineyard/client/client.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
@@ -24,6 +26,7 @@
 #include "core/fragment/dynamic_fragment.h"
 #include "core/io/property_parser.h"
 #include "core/loader/arrow_fragment_loader.h"
+#include "core/loader/arrow_fragment_snapshot.h"
 #include "core/loader/arrow_to_dynamic_converter.h"
 #include "core/loader/dynamic_to_arrow_converter.h"
 #include "core/object/fragment_wrapper.h"
@@ -36,6 +39,118 @@
 #error Missing _GRAPH_TYPE
 #endif
 
+#ifdef NETWORKX
+namespace {
+/**
+ * DynamicFragment numbers its vertices by 64-bit vids, which the converters
+ * lay out by the id parser of the same type, so only the ArrowFragments of
+ * the same vid type are converted to or from it.
+ */
+using vid_matches_dynamic_t =
+    std::is_same<typename _GRAPH_TYPE::vid_t, gs::DynamicFragment::vid_t>;
+
+gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> toArrowFragment(
+    vineyard::Client& client, const grape::CommSpec& comm_spec,
+    std::shared_ptr<gs::IFragmentWrapper>& wrapper_in,
+    const std::string& dst_graph_name, std::true_type) {
+  using oid_t = typename _GRAPH_TYPE::oid_t;
+
+  auto dynamic_frag = std::static_pointer_cast<gs::DynamicFragment>(
+      wrapper_in->fragment());
+
+  BOOST_LEAF_AUTO(oid_type, dynamic_frag->GetOidType(comm_spec));
+
+  if (oid_type == folly::dynamic::Type::INT64 &&
+      !std::is_same<oid_t, int32_t>::value &&
+      !std::is_same<oid_t, int64_t>::value) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "The oid type of DynamicFragment is int64, but the "
+                    "oid type of destination fragment is: " +
+                        std::string(vineyard::TypeName<oid_t>::Get()));
+  }
+
+  if (oid_type == folly::dynamic::Type::STRING &&
+      !std::is_same<oid_t, std::string>::value) {
+    RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                    "The oid type of DynamicFragment is string, but the "
+                    "oid type of destination fragment is: " +
+                        std::string(vineyard::TypeName<oid_t>::Get()));
+  }
+
+  gs::DynamicToArrowConverter<oid_t> converter(comm_spec, client);
+  BOOST_LEAF_AUTO(arrow_frag, converter.Convert(dynamic_frag));
+  VINEYARD_CHECK_OK(client.Persist(arrow_frag->id()));
+  BOOST_LEAF_AUTO(frag_group_id,
+                  vineyard::ConstructFragmentGroup(
+                      client, arrow_frag->id(), comm_spec));
+  gs::rpc::GraphDef graph_def;
+
+  graph_def.set_key(dst_graph_name);
+  graph_def.set_vineyard_id(frag_group_id);
+  gs::set_graph_def(arrow_frag, graph_def);
+
+  auto wrapper = std::make_shared<gs::FragmentWrapper<_GRAPH_TYPE>>(
+      dst_graph_name, graph_def, arrow_frag);
+  return std::dynamic_pointer_cast<gs::IFragmentWrapper>(wrapper);
+}
+
+gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> toArrowFragment(
+    vineyard::Client& client, const grape::CommSpec& comm_spec,
+    std::shared_ptr<gs::IFragmentWrapper>& wrapper_in,
+    const std::string& dst_graph_name, std::false_type) {
+  RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                  "DynamicFragment can not be converted to an ArrowFragment "
+                  "of vid type " +
+                      std::string(vineyard::TypeName<
+                                  typename _GRAPH_TYPE::vid_t>::Get()));
+}
+
+gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> toDynamicFragment(
+    const grape::CommSpec& comm_spec,
+    std::shared_ptr<gs::IFragmentWrapper>& wrapper_in,
+    const std::string& dst_graph_name, std::true_type) {
+  auto arrow_frag =
+      std::static_pointer_cast<_GRAPH_TYPE>(wrapper_in->fragment());
+  gs::ArrowToDynamicConverter<_GRAPH_TYPE> converter(comm_spec);
+
+  BOOST_LEAF_AUTO(dynamic_frag, converter.Convert(arrow_frag));
+
+  gs::rpc::GraphDef graph_def;
+
+  graph_def.set_key(dst_graph_name);
+  graph_def.set_directed(dynamic_frag->directed());
+  graph_def.set_graph_type(gs::rpc::DYNAMIC_PROPERTY);
+
+  auto* schema_def = graph_def.mutable_schema_def();
+
+  schema_def->set_oid_type(
+      vineyard::TypeName<typename gs::DynamicFragment::oid_t>::Get());
+  schema_def->set_vid_type(
+      vineyard::TypeName<typename gs::DynamicFragment::vid_t>::Get());
+  schema_def->set_vdata_type(
+      vineyard::TypeName<typename gs::DynamicFragment::vdata_t>::Get());
+  schema_def->set_edata_type(
+      vineyard::TypeName<typename gs::DynamicFragment::edata_t>::Get());
+  schema_def->set_property_schema_json("{}");
+
+  auto wrapper = std::make_shared<gs::FragmentWrapper<gs::DynamicFragment>>(
+      dst_graph_name, graph_def, dynamic_frag);
+  return std::dynamic_pointer_cast<gs::IFragmentWrapper>(wrapper);
+}
+
+gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> toDynamicFragment(
+    const grape::CommSpec& comm_spec,
+    std::shared_ptr<gs::IFragmentWrapper>& wrapper_in,
+    const std::string& dst_graph_name, std::false_type) {
+  RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
+                  "An ArrowFragment of vid type " +
+                      std::string(vineyard::TypeName<
+                                  typename _GRAPH_TYPE::vid_t>::Get()) +
+                      " can not be converted to DynamicFragment");
+}
+}  // namespace
+#endif
+
 /**
  * property_graph_frame.cc serves as a frame to be compiled with ArrowFragment.
  * LoadGraph, ToArrowFragment, and ToDynamicFragment functions are provided to
@@ -54,6 +169,37 @@ void LoadGraph(
 
   fragment_wrapper = gs::bl::try_handle_some(
       [&]() -> gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> {
+        if (params.HasKey(gs::rpc::SNAPSHOT_PATH)) {
+          BOOST_LEAF_AUTO(path,
+                          params.Get<std::string>(gs::rpc::SNAPSHOT_PATH));
+          auto fid = comm_spec.WorkerToFrag(comm_spec.worker_id());
+          auto location = gs::ArrowFragmentSnapshotLocation(path, fid);
+          BOOST_LEAF_AUTO(meta, gs::ReadObjectSnapshotMeta(location));
+          BOOST_LEAF_CHECK(gs::CheckArrowFragmentSnapshot<_GRAPH_TYPE>(
+              meta, comm_spec.fnum(), location));
+          BOOST_LEAF_AUTO(frag_id, gs::ReadObjectSnapshot(client, location));
+          VY_OK_OR_RAISE(client.Persist(frag_id));
+          auto frag =
+              std::dynamic_pointer_cast<_GRAPH_TYPE>(client.GetObject(frag_id));
+          if (frag == nullptr) {
+            RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
+                            "The snapshot " + location +
+                                " is not restored as " +
+                                vineyard::type_name<_GRAPH_TYPE>());
+          }
+
+          BOOST_LEAF_AUTO(frag_group_id, vineyard::ConstructFragmentGroup(
+                                             client, frag_id, comm_spec));
+          gs::rpc::GraphDef graph_def;
+
+          graph_def.set_key(graph_name);
+          graph_def.set_vineyard_id(frag_group_id);
+          gs::set_graph_def(frag, graph_def);
+
+          auto wrapper = std::make_shared<gs::FragmentWrapper<_GRAPH_TYPE>>(
+              graph_name, graph_def, frag);
+          return std::dynamic_pointer_cast<gs::IFragmentWrapper>(wrapper);
+        }
         BOOST_LEAF_AUTO(from_vineyard_id,
                         params.Get<bool>(gs::rpc::IS_FROM_VINEYARD_ID));
 
@@ -128,14 +274,6 @@ void ToArrowFragment(
     std::shared_ptr<gs::IFragmentWrapper>& wrapper_in,
     const std::string& dst_graph_name,
     gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>>& wrapper_out) {
-#ifdef NETWORKX
-  using oid_t = typename _GRAPH_TYPE::oid_t;
-  using vid_t = typename _GRAPH_TYPE::vid_t;
-  static_assert(std::is_same<vid_t, gs::DynamicFragment::vid_t>::value,
-                "The type of ArrowFragment::vid_t does not match with the "
-                "DynamicFragment::vid_t");
-#endif
-
   wrapper_out = gs::bl::try_handle_some(
       [&]() -> gs::bl::result<std::shared_ptr<gs::IFragmentWrapper>> {
 #ifdef NETWORKX
@@ -143,43 +281,8 @@ void ToArrowFragment(
           RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
                           "Source fragment it not DynamicFragment.");
         }
-        auto dynamic_frag = std::static_pointer_cast<gs::DynamicFragment>(
-            wrapper_in->fragment());
-
-        BOOST_LEAF_AUTO(oid_type, dynamic_frag->GetOidType(comm_spec));
-
-        if (oid_type == folly::dynamic::Type::INT64 &&
-            !std::is_same<oid_t, int32_t>::value &&
-            !std::is_same<oid_t, int64_t>::value) {
-          RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                          "The oid type of DynamicFragment is int64, but the "
-                          "oid type of destination fragment is: " +
-                              std::string(vineyard::TypeName<oid_t>::Get()));
-        }
-
-        if (oid_type == folly::dynamic::Type::STRING &&
-            !std::is_same<oid_t, std::string>::value) {
-          RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidOperationError,
-                          "The oid type of DynamicFragment is string, but the "
-                          "oid type of destination fragment is: " +
-                              std::string(vineyard::TypeName<oid_t>::Get()));
-        }
-
-        gs::DynamicToArrowConverter<oid_t> converter(comm_spec, client);
-        BOOST_LEAF_AUTO(arrow_frag, converter.Convert(dynamic_frag));
-        VINEYARD_CHECK_OK(client.Persist(arrow_frag->id()));
-        BOOST_LEAF_AUTO(frag_group_id,
-                        vineyard::ConstructFragmentGroup(
-                            client, arrow_frag->id(), comm_spec));
-        gs::rpc::GraphDef graph_def;
-
-        graph_def.set_key(dst_graph_name);
-        graph_def.set_vineyard_id(frag_group_id);
-        gs::set_graph_def(arrow_frag, graph_def);
-
-        auto wrapper = std::make_shared<gs::FragmentWrapper<_GRAPH_TYPE>>(
-            dst_graph_name, graph_def, arrow_frag);
-        return std::dynamic_pointer_cast<gs::IFragmentWrapper>(wrapper);
+        return toArrowFragment(client, comm_spec, wrapper_in, dst_graph_name,
+                               vid_matches_dynamic_t{});
 #else
         RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
                         "GS is compiled without folly");
@@ -199,34 +302,8 @@ void ToDynamicFragment(
           RETURN_GS_ERROR(vineyard::ErrorCode::kInvalidValueError,
                           "Source fragment it not ArrowFragment.");
         }
-        auto arrow_frag =
-            std::static_pointer_cast<_GRAPH_TYPE>(wrapper_in->fragment());
-        gs::ArrowToDynamicConverter<_GRAPH_TYPE> converter(comm_spec);
-
-        BOOST_LEAF_AUTO(dynamic_frag, converter.Convert(arrow_frag));
-
-        gs::rpc::GraphDef graph_def;
-
-        graph_def.set_key(dst_graph_name);
-        graph_def.set_directed(dynamic_frag->directed());
-        graph_def.set_graph_type(gs::rpc::DYNAMIC_PROPERTY);
-
-        auto* schema_def = graph_def.mutable_schema_def();
-
-        schema_def->set_oid_type(
-            vineyard::TypeName<typename gs::DynamicFragment::oid_t>::Get());
-        schema_def->set_vid_type(
-            vineyard::TypeName<typename gs::DynamicFragment::vid_t>::Get());
-        schema_def->set_vdata_type(
-            vineyard::TypeName<typename gs::DynamicFragment::vdata_t>::Get());
-        schema_def->set_edata_type(
-            vineyard::TypeName<typename gs::DynamicFragment::edata_t>::Get());
-        schema_def->set_property_schema_json("{}");
-
-        auto wrapper =
-            std::make_shared<gs::FragmentWrapper<gs::DynamicFragment>>(
-                dst_graph_name, graph_def, dynamic_frag);
-        return std::dynamic_pointer_cast<gs::IFragmentWrapper>(wrapper);
+        return toDynamicFragment(comm_spec, wrapper_in, dst_graph_name,
+                                 vid_matches_dynamic_t{});
 #else
         RETURN_GS_ERROR(vineyard::ErrorCode::kUnimplementedMethod,
                         "GS is compiled without folly");
@@ -147,6 +147,378 @@ function run() {
 }
 
 
+########################################################
+# Verify the columns of fused_analytics against the results of
+# degree_centrality, pagerank and wcc run one by one.
+# Arguments:
+#   - num_of_process.
+#   - rest args of run_app.
+########################################################
+function run_fused() {
+  num_of_process=$1
+  shift
+
+  for app in degree_centrality pagerank wcc; do
+    run "${num_of_process}" ./run_app --application "${app}" "$@"
+    cat ./test_output/* | sort -k1n | awk '{print $1, $2}' >./test_output_"${app}".res
+    rm -rf ./test_output/*
+  done
+
+  run "${num_of_process}" ./run_app --application fused_analytics "$@"
+  cat ./test_output/* | sort -k1n >./test_output_fused.res
+  column=2
+  for app in degree_centrality pagerank wcc; do
+    if ! awk -v c="${column}" '{print $1, $c}' ./test_output_fused.res |
+      cmp - ./test_output_"${app}".res >/dev/null 2>&1; then
+      err "Failed to match the ${app} of fused_analytics"
+      exit 1
+    fi
+    column=$((column + 1))
+  done
+  rm -rf ./test_output/* ./test_output_*.res
+  info "Passed the match of fused_analytics with the apps run one by one"
+}
+
+########################################################
+# Verify the components of an app against the ones of wcc, up to the labels
+# of the components, i.e., each component is labeled by its least id.
+# Arguments:
+#   - num_of_process.
+#   - app.
+#   - rest args of run_app.
+########################################################
+function run_components() {
+  num_of_process=$1
+  shift
+  app=$1
+  shift
+
+  for name in wcc "${app}"; do
+    run "${num_of_process}" ./run_app --application "${name}" "$@"
+    cat ./test_output/* |
+      awk '{ comp[$1] = $2; if (!($2 in least) || $1 < least[$2]) least[$2] = $1 }
+        END { for (v in comp) print v, least[comp[v]] }' |
+      sort -k1n >./test_output_"${name}".res
+    rm -rf ./test_output/*
+  done
+
+  if ! cmp ./test_output_wcc.res ./test_output_"${app}".res >/dev/null 2>&1; then
+    err "Failed to match the components of ${app} with wcc"
+    exit 1
+  fi
+  rm -rf ./test_output_*.res
+  info "Passed the match of the components of ${app} with wcc"
+}
+
+########################################################
+# Verify the distances of sssp_delta_stepping against the ones of sssp, for
+# the automatic bucket width and the given ones. The distances are matched up
+# to a relative error, as the shortest paths of equal length may be summed up
+# in different orders.
+# Arguments:
+#   - num_of_process.
+#   - rest args of run_app, including the --sssp_source.
+########################################################
+function run_delta_stepping() {
+  num_of_process=$1
+  shift
+
+  run "${num_of_process}" ./run_app --application sssp "$@"
+  cat ./test_output/* | sort -k1n >./test_output_sssp.res
+  rm -rf ./test_output/*
+
+  for delta in 0 1 10 1000; do
+    run "${num_of_process}" ./run_app --application sssp_delta_stepping \
+      --sssp_delta="${delta}" "$@"
+    cat ./test_output/* | sort -k1n >./test_output_delta.res
+    rm -rf ./test_output/*
+    if ! paste -d ' ' ./test_output_sssp.res ./test_output_delta.res |
+      awk '{ if ($1 != $3) exit 1
+             if ($2 == "infinity" || $4 == "infinity") { if ($2 != $4) exit 1; next }
+             d = $2 - $4; if (d < 0) d = -d
+             if (d > 1e-9 * ($2 < 1 ? 1 : $2)) exit 1 }
+        END { if (NR == 0) exit 1 }' ||
+      [[ $(wc -l <./test_output_sssp.res) -ne $(wc -l <./test_output_delta.res) ]]; then
+      err "Failed to match the distances of sssp_delta_stepping (delta=${delta}) with sssp"
+      exit 1
+    fi
+  done
+  rm -rf ./test_output_sssp.res ./test_output_delta.res
+  info "Passed the match of the distances of sssp_delta_stepping with sssp"
+}
+
+########################################################
+# Write the results of networkx on a graph to a file, of which each line is
+# "id value", sorted by the ids.
+# Arguments:
+#   - vfile.
+#   - efile.
+#   - directed, true or false.
+#   - the python expression of the dict from the vertices to the values, on
+#     the networkx graph G, e.g., "nx.pagerank(G)".
+#   - output file.
+#   - optional, the result file of an app, of which the values are in the
+#     dict R by the ids, as strings.
+########################################################
+function nx_result() {
+  python3 - "$@" <<'EOF'
+import sys
+
+import networkx as nx
+
+vfile, efile, directed, expr, out = sys.argv[1:6]
+G = nx.DiGraph() if directed == "true" else nx.Graph()
+R = {}
+if len(sys.argv) > 6:
+    with open(sys.argv[6]) as f:
+        for line in f:
+            items = line.split()
+            if items:
+                R[int(items[0])] = items[1]
+with open(vfile) as f:
+    for line in f:
+        items = line.split()
+        if items and not items[0].startswith("#"):
+            G.add_node(int(items[0]))
+with open(efile) as f:
+    for line in f:
+        items = line.split()
+        if items and not items[0].startswith("#"):
+            weight = float(items[2]) if len(items) > 2 else 1.0
+            G.add_edge(int(items[0]), int(items[1]), weight=weight)
+result = eval(expr, {"nx": nx, "G": G, "R": R})
+with open(out, "w") as f:
+    for v in sorted(result):
+        f.write("%d %s\n" % (v, result[v]))
+EOF
+}
+
+########################################################
+# Verify the strongly connected components of scc against the ones of
+# networkx on the directed graph, up to the labels of the components, i.e.,
+# each component is labeled by its least id.
+# Arguments:
+#   - num_of_process.
+#   - vfile.
+#   - efile.
+########################################################
+function run_scc() {
+  num_of_process=$1
+  vfile=$2
+  efile=$3
+
+  run "${num_of_process}" ./run_app --application scc --vfile "${vfile}" \
+    --efile "${efile}" --out_prefix ./test_output --directed
+  cat ./test_output/* |
+    awk '{ comp[$1] = $2; if (!($2 in least) || $1 < least[$2]) least[$2] = $1 }
+      END { for (v in comp) print v, least[comp[v]] }' |
+    sort -k1n >./test_output_scc.res
+  rm -rf ./test_output/*
+  nx_result "${vfile}" "${efile}" true \
+    "{v: min(c) for c in nx.strongly_connected_components(G) for v in c}" \
+    ./test_output_nx.res
+
+  if ! cmp ./test_output_nx.res ./test_output_scc.res >/dev/null 2>&1; then
+    err "Failed to match the components of scc with networkx"
+    exit 1
+  fi
+  rm -rf ./test_output_scc.res ./test_output_nx.res
+  info "Passed the match of the components of scc with networkx"
+}
+
+########################################################
+# Verify the biconnected components of bcc against the ones of networkx in
+# the connected component of the source. Each component of networkx must be
+# the vertices of a label of bcc and the parent of the head of the label,
+# i.e., all but one of its vertices, and the labels are matched one to one.
+# Arguments:
+#   - num_of_process.
+#   - vfile.
+#   - efile.
+#   - source.
+########################################################
+function run_bcc() {
+  num_of_process=$1
+  vfile=$2
+  efile=$3
+  source=$4
+
+  run "${num_of_process}" ./run_app --application bcc --vfile "${vfile}" \
+    --efile "${efile}" --out_prefix ./test_output --bcc_source "${source}"
+  cat ./test_output/* >./test_output_bcc.res
+  rm -rf ./test_output/*
+  if ! python3 - "${efile}" "${source}" ./test_output_bcc.res <<'EOF'; then
+import sys
+
+import networkx as nx
+
+efile, source, result = sys.argv[1], int(sys.argv[2]), sys.argv[3]
+G = nx.Graph()
+with open(efile) as f:
+    for line in f:
+        items = line.split()
+        if items and not items[0].startswith("#"):
+            G.add_edge(int(items[0]), int(items[1]))
+G.remove_edges_from(list(nx.selfloop_edges(G)))
+reached = nx.node_connected_component(G, source)
+comps = [c for c in nx.biconnected_components(G) if c <= reached]
+groups = {}
+with open(result) as f:
+    for line in f:
+        v, label = line.split()
+        if int(v) in reached and int(v) != source:
+            groups.setdefault(label, set()).add(int(v))
+cands = [[h for h, g in groups.items() if g < c and len(g) == len(c) - 1]
+         for c in comps]
+match = {}
+
+
+def augment(i, seen):
+    for h in cands[i]:
+        if h not in seen:
+            seen.add(h)
+            if h not in match or augment(match[h], seen):
+                match[h] = i
+                return True
+    return False
+
+
+ok = all(augment(i, set()) for i in range(len(comps)))
+sys.exit(0 if ok and len(match) == len(groups) else 1)
+EOF
+    err "Failed to match the components of bcc with networkx"
+    exit 1
+  fi
+  rm -rf ./test_output_bcc.res
+  info "Passed the match of the components of bcc with networkx"
+}
+
+########################################################
+# Verify two result files of "id value" lines sorted by the ids match, where
+# the values are equal up to a relative error, or both "infinity".
+# Arguments:
+#   - result file.
+#   - result file.
+#   - relative error.
+########################################################
+function approx_match() {
+  [[ $(wc -l <"$1") -eq $(wc -l <"$2") ]] &&
+    paste -d ' ' "$1" "$2" |
+    awk -v eps="$3" '{ if ($1 != $3) exit 1
+        if ($2 == "infinity" || $4 == "infinity") { if ($2 != $4) exit 1; next }
+        d = $2 - $4; if (d < 0) d = -d; m = $2 < 0 ? -$2 : $2
+        if (d > eps * m + 1e-12) exit 1 }
+      END { if (NR == 0) exit 1 }'
+}
+
+########################################################
+# Verify the apps of the results kept in float against the ones in double,
+# i.e., pagerank_float against pagerank, and sssp_delta_stepping_float against
+# sssp, up to the precision of float.
+# Arguments:
+#   - num_of_process.
+#   - rest args of run_app, including the --sssp_source.
+########################################################
+function run_float() {
+  num_of_process=$1
+  shift
+
+  for app in pagerank pagerank_float sssp sssp_delta_stepping_float; do
+    run "${num_of_process}" ./run_app --application "${app}" "$@"
+    cat ./test_output/* | sort -k1n | awk '{print $1, $2}' >./test_output_"${app}".res
+    rm -rf ./test_output/*
+  done
+
+  for pair in pagerank:pagerank_float sssp:sssp_delta_stepping_float; do
+    if ! approx_match ./test_output_"${pair%%:*}".res \
+      ./test_output_"${pair##*:}".res 1e-5; then
+      err "Failed to match the results of ${pair##*:} with ${pair%%:*}"
+      exit 1
+    fi
+  done
+  rm -rf ./test_output_*.res
+  info "Passed the match of the apps in float with the ones in double"
+}
+
+########################################################
+# Verify the betweenness and closeness centrality of all the sources, i.e.,
+# the k is 0, against networkx. As networkx takes hours on the whole graph,
+# the apps run on the subgraph induced by the vertices of ids less than
+# max_id. The apps output 6 significant digits.
+# Arguments:
+#   - num_of_process.
+#   - vfile.
+#   - efile.
+#   - max_id.
+#   - directed, true or false.
+########################################################
+function run_centrality() {
+  num_of_process=$1
+  vfile=$2
+  efile=$3
+  max_id=$4
+  directed=$5
+
+  awk -v m="${max_id}" '$1 < m' "${vfile}" >./test_centrality.v
+  awk -v m="${max_id}" '$1 < m && $2 < m' "${efile}" >./test_centrality.e
+  flags=""
+  if [[ "${directed}" == "true" ]]; then
+    flags="--directed"
+  fi
+
+  for app in betweenness_centrality closeness_centrality; do
+    run "${num_of_process}" ./run_app --application "${app}" \
+      --vfile ./test_centrality.v --efile ./test_centrality.e \
+      --out_prefix ./test_output --"${app}"_k=0 ${flags}
+    cat ./test_output/* | sort -k1n >./test_output_"${app}".res
+    rm -rf ./test_output/*
+    nx_result ./test_centrality.v ./test_centrality.e "${directed}" \
+      "nx.${app}(G)" ./test_output_nx.res
+    if ! approx_match ./test_output_nx.res ./test_output_"${app}".res 1e-5; then
+      err "Failed to match the ${app} (directed=${directed}) with networkx"
+      exit 1
+    fi
+  done
+  rm -rf ./test_centrality.v ./test_centrality.e ./test_output_*.res
+  info "Passed the match of betweenness and closeness centrality with networkx"
+}
+
+########################################################
+# Verify the modularity of the communities of level_louvain against a bound,
+# i.e., the given ratio of the modularity of the louvain of networkx, as the
+# communities of both are not unique.
+# Arguments:
+#   - num_of_process.
+#   - vfile.
+#   - efile.
+#   - ratio.
+########################################################
+function run_louvain() {
+  num_of_process=$1
+  vfile=$2
+  efile=$3
+  ratio=$4
+
+  run "${num_of_process}" ./run_app --application level_louvain \
+    --vfile "${vfile}" --efile "${efile}" --out_prefix ./test_output
+  cat ./test_output/* | sort -k1n >./test_output_louvain.res
+  rm -rf ./test_output/*
+  # line 0 is the modularity of level_louvain, and line 1 is the bound
+  nx_result "${vfile}" "${efile}" false \
+    "{0: nx.community.modularity(G, nx.utils.groups(R).values()),
+      1: nx.community.modularity(G, nx.community.louvain_communities(G, seed=7))
+      * ${ratio}}" \
+    ./test_output_nx.res ./test_output_louvain.res
+
+  if ! awk '{ q[$1] = $2 } END { exit !(NR == 2 && q[0] >= q[1]) }' \
+    ./test_output_nx.res; then
+    err "Failed to reach the bound of modularity with level_louvain: $(cat ./test_output_nx.res | xargs)"
+    exit 1
+  fi
+  rm -rf ./test_output_louvain.res ./test_output_nx.res
+  info "Passed the bound of modularity with level_louvain"
+}
+
 ########################################################
 # Run apps over property graphs on vineyard.
 # Arguments:
@@ -361,6 +733,13 @@ pushd "${ENGINE_HOME}"/build
 
 get_test_data
 
+# the unit tests, of which test_dynamic_fragment is built with NETWORKX only
+./test_pregel_mailbox
+if [[ -x ./test_dynamic_fragment ]]; then
+  ./test_dynamic_fragment
+fi
+info "Passed the unit tests."
+
 for app in "${apps[@]}"; do
   run ${np} ./run_app --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --application "${app}" --out_prefix ./test_output --sssp_source=6 --sssp_target=10 --bfs_source=6
   exact_verify "${test_dir}"/p2p-31-"${app}"
@@ -371,9 +750,62 @@ for app in "${apps_with_directed[@]}"; do
   exact_verify "${test_dir}"/p2p-31-"${app}"
 done
 
+run_fused ${np} --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output
+run_fused ${np} --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output --directed
+run_components ${np} wcc_afforest --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output
+run_components ${np} wcc_rma --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output
+run_delta_stepping ${np} --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output --sssp_source=6
+run_float ${np} --vfile "${test_dir}"/p2p-31.v --efile "${test_dir}"/p2p-31.e --out_prefix ./test_output --sssp_source=6
+run_scc ${np} "${test_dir}"/p2p-31.v "${test_dir}"/p2p-31.e
+run_bcc ${np} "${test_dir}"/p2p-31.v "${test_dir}"/p2p-31.e 6
+run_centrality ${np} "${test_dir}"/p2p-31.v "${test_dir}"/p2p-31.e 3000 false
+run_centrality ${np} "${test_dir}"/p2p-31.v "${test_dir}"/p2p-31.e 3000 true
+run_louvain ${np} "${test_dir}"/p2p-31.v "${test_dir}"/p2p-31.e 0.95
+
 start_vineyard
 
 run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 
+run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 1 routing
+for app in wcc sssp; do
+  cat ./outputs_routing_direct_"${app}"/* | sort -k1n >./test_output_direct.res
+  cat ./outputs_routing_relay_"${app}"/* | sort -k1n >./test_output_relay.res
+  if ! cmp ./test_output_direct.res ./test_output_relay.res >/dev/null 2>&1; then
+    err "Failed to match the ${app} with the hierarchical routing"
+    exit 1
+  fi
+  rm -rf ./outputs_routing_*_"${app}" ./test_output_direct.res ./test_output_relay.res
+  info "Passed the match of the ${app} with the hierarchical routing"
+done
+run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 1 combine
+cat ./outputs_combine_round_wcc/* | sort -k1n >./test_output_round.res
+cat ./outputs_combine_block_wcc/* | sort -k1n >./test_output_block.res
+if ! cmp ./test_output_round.res ./test_output_block.res >/dev/null 2>&1; then
+  err "Failed to match the wcc with the combined messages flushed by blocks"
+  exit 1
+fi
+rm -rf ./outputs_combine_*_wcc ./test_output_round.res ./test_output_block.res
+info "Passed the match of the wcc with the combined messages flushed by blocks"
+run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 1 push_pull
+cat ./outputs_push_pull_push_pagerank/* | sort -k1n >./test_output_push.res
+for mode in pull switch; do
+  cat ./outputs_push_pull_"${mode}"_pagerank/* | sort -k1n >./test_output_"${mode}".res
+  if ! approx_match ./test_output_push.res ./test_output_"${mode}".res 1e-9; then
+    err "Failed to match the pagerank by ${mode} with the one by push"
+    exit 1
+  fi
+  info "Passed the match of the pagerank by ${mode} with the one by push"
+done
+rm -rf ./outputs_push_pull_*_pagerank ./test_output_{push,pull,switch}.res
+run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 1 parallel_process
+run_vy ${np} ./run_vy_app "${socket_file}" 2 "${test_dir}"/new_property/v2_e2/twitter_e 2 "${test_dir}"/new_property/v2_e2/twitter_v 0 1 async
+cat ./outputs_async_sync_wcc/* | sort -k1n >./test_output_sync.res
+cat ./outputs_async_async_wcc/* | sort -k1n >./test_output_async.res
+if ! cmp ./test_output_sync.res ./test_output_async.res >/dev/null 2>&1; then
+  err "Failed to match the wcc with the asynchronous message manager"
+  exit 1
+fi
+rm -rf ./outputs_async_*_wcc ./test_output_sync.res ./test_output_async.res
+info "Passed the match of the wcc with the asynchronous message manager"
 run_vy_2 ${np} ./run_vy_app "${socket_file}" 4 "${test_dir}"/projected_property/twitter_property_e "${test_dir}"/projected_property/twitter_property_v 1
 run_lpa ${np} ./run_vy_app "${socket_file}" 1 "${test_dir}"/property/lpa_dataset/lpa_3000_e 2 "${test_dir}"/property/lpa_dataset/lpa_3000_v 0 1 lpa 
 run_sampling_path 2 ./run_vy_app "${socket_file}" "${test_dir}"/property/sampling_path 0 1 sampling_path 0-0-1-4-2 
@@ -386,5 +818,8 @@ exact_verify "${test_dir}"/twitter-sssp-4
 run ${np} ./run_pregel_app tc "${test_dir}"/p2p-31.e "${test_dir}"/p2p-31.v ./test_output 
 exact_verify "${test_dir}/p2p-31"-triangles
 
+run ${np} ./run_pregel_app tc_parallel "${test_dir}"/p2p-31.e "${test_dir}"/p2p-31.v ./test_output
+exact_verify "${test_dir}/p2p-31"-triangles
+
 info "Passed all tests for GraphScope analytical engine."
 
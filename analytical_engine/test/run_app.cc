@@ -42,6 +42,24 @@ DEFINE_int32(hits_max_round, 100, "Maximum number of iterations.");
 DEFINE_bool(hits_normalized, true,
             "Normalize results by the sum of all of the values.");
 
+DEFINE_string(approx_clustering_mode, "transitivity",
+              "The coefficient to estimate[transitivity/avg_clustering].");
+DEFINE_double(approx_clustering_epsilon, 0.01,
+              "The additive error of the estimate.");
+DEFINE_double(approx_clustering_delta, 0.05,
+              "The probability the error exceeds epsilon.");
+
+DEFINE_int32(hyper_anf_max_hops, 10,
+             "The hops to count the reachable vertices within.");
+DEFINE_int32(hyper_anf_precision, 8,
+             "The counter of a vertex has 2^precision registers.");
+
+DEFINE_int32(link_similarity_max_exact_degree, 1024,
+             "The scores of an edge are exact if either end is of the degree "
+             "at most this, or else estimated by the MinHash sketches.");
+DEFINE_int32(link_similarity_num_hashes, 128,
+             "The hashes of the MinHash sketch of a vertex.");
+
 DEFINE_int32(kcore_k, 3, "The order of the core");
 
 DEFINE_int32(kshell_k, 3, "The order of the shell");
@@ -54,11 +72,43 @@ DEFINE_int32(katz_centrality_max_round, 100, "Maximum number of iterations.");
 DEFINE_bool(katz_centrality_normalized, true,
             "Normalize results by the sum of all of the values.");
 
+DEFINE_bool(betweenness_centrality_normalized, true,
+            "Normalize results by the pairs of the other vertices.");
+DEFINE_int64(betweenness_centrality_k, 0,
+             "Number of the sampled sources, 0 for all the vertices.");
+
+DEFINE_bool(closeness_centrality_wf_improved, true,
+            "Scale results by the fraction of the vertices reaching a vertex.");
+DEFINE_int64(closeness_centrality_k, 0,
+             "Number of the sampled sources, 0 for all the vertices.");
+
+DEFINE_double(level_louvain_tolerance, 1e-7,
+              "Least gain of modularity by a sweep to go on.");
+DEFINE_int32(level_louvain_max_sweeps, 20,
+             "Maximum number of the sweeps in a level.");
+DEFINE_int32(level_louvain_max_levels, 0,
+             "Maximum number of the levels, 0 for no limit.");
+
 DEFINE_int64(sssp_source, 0, "Source vertex of sssp.");
 DEFINE_int64(sssp_target, 1, "Target vertex of sssp.");
 DEFINE_bool(
     sssp_weight, true,
     "If true, use edge attribute as weight. Otherwise, all use weight 1.");
+DEFINE_double(sssp_delta, 0,
+              "Bucket width of the delta-stepping sssp, no more than 0 to "
+              "choose by the weights and the degrees.");
+
+DEFINE_string(ppr_seeds, "0", "Seeds of the batched ppr, separated by commas.");
+DEFINE_int32(ppr_walk_num, 1000, "Number of the random walks per seed.");
+DEFINE_double(ppr_alpha, 0.15, "Probability a walk stops at each step.");
+DEFINE_double(ppr_threshold, 0, "The least score to output.");
+
+DEFINE_int32(random_walk_length, 10, "Number of the vertices of a walk.");
+DEFINE_int32(random_walk_num, 1, "Number of the walks from each vertex.");
+DEFINE_bool(random_walk_weighted, false,
+            "If true, move by the edge attribute as weight.");
+DEFINE_double(random_walk_p, 1.0, "Return parameter of node2vec.");
+DEFINE_double(random_walk_q, 1.0, "In-out parameter of node2vec.");
 
 DEFINE_int32(bfs_depth_limit, 10, "Specify the maximum search depth.");
 DEFINE_string(bfs_output_format, "edges",
@@ -78,6 +128,10 @@ DEFINE_int32(app_concurrency, -1, "concurrency of application");
 
 DEFINE_int64(dfs_source, 0, "source vertex of dfs.");
 DEFINE_string(dfs_format, "edges", "output format of dfs.");
+DEFINE_bool(dfs_local_first, false,
+            "visit the inner neighbors first in dfs.");
+DEFINE_int64(bcc_source, 0,
+             "the source vertex of the component of bcc to search.");
 
 int main(int argc, char* argv[]) {
   FLAGS_stderrthreshold = 0;
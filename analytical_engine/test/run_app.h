@@ -50,18 +50,33 @@ limitations under the License.
 #include "wcc/wcc_auto.h"
 
 #include "apps/bfs/bfs_generic.h"
+#include "apps/centrality/betweenness/betweenness_centrality.h"
+#include "apps/centrality/closeness/closeness_centrality.h"
 #include "apps/centrality/degree/degree_centrality.h"
 #include "apps/centrality/eigenvector/eigenvector_centrality.h"
 #include "apps/centrality/katz/katz_centrality.h"
+#include "apps/clustering/approx_clustering.h"
 #include "apps/clustering/avg_clustering.h"
 #include "apps/clustering/clustering.h"
 #include "apps/clustering/transitivity.h"
 #include "apps/clustering/triangles.h"
+#include "apps/dfs/bcc.h"
 #include "apps/dfs/dfs.h"
+#include "apps/fused/fused_analytics.h"
 #include "apps/hits/hits.h"
+#include "apps/hyper_anf/hyper_anf.h"
 #include "apps/kcore/kcore.h"
 #include "apps/kshell/kshell.h"
+#include "apps/louvain/level_louvain.h"
+#include "apps/pagerank/pagerank_float.h"
+#include "apps/ppr/batched_ppr.h"
+#include "apps/projected/wcc_afforest.h"
+#include "apps/projected/wcc_rma.h"
+#include "apps/random_walk/random_walk.h"
+#include "apps/scc/scc.h"
+#include "apps/similarity/link_similarity.h"
 #include "apps/sssp/sssp_average_length.h"
+#include "apps/sssp/sssp_delta_stepping.h"
 #include "apps/sssp/sssp_has_path.h"
 #include "apps/sssp/sssp_path.h"
 #include "core/flags.h"
@@ -85,6 +100,16 @@ DECLARE_double(hits_tolerance);
 DECLARE_int32(hits_max_round);
 DECLARE_bool(hits_normalized);
 
+DECLARE_string(approx_clustering_mode);
+DECLARE_double(approx_clustering_epsilon);
+DECLARE_double(approx_clustering_delta);
+
+DECLARE_int32(hyper_anf_max_hops);
+DECLARE_int32(hyper_anf_precision);
+
+DECLARE_int32(link_similarity_max_exact_degree);
+DECLARE_int32(link_similarity_num_hashes);
+
 DECLARE_int32(kcore_k);
 
 DECLARE_int32(kshell_k);
@@ -95,9 +120,31 @@ DECLARE_double(katz_centrality_tolerance);
 DECLARE_int32(katz_centrality_max_round);
 DECLARE_bool(katz_centrality_normalized);
 
+DECLARE_bool(betweenness_centrality_normalized);
+DECLARE_int64(betweenness_centrality_k);
+
+DECLARE_bool(closeness_centrality_wf_improved);
+DECLARE_int64(closeness_centrality_k);
+
+DECLARE_double(level_louvain_tolerance);
+DECLARE_int32(level_louvain_max_sweeps);
+DECLARE_int32(level_louvain_max_levels);
+
 DECLARE_int64(sssp_source);
 DECLARE_int64(sssp_target);
 DECLARE_bool(sssp_weight);
+DECLARE_double(sssp_delta);
+
+DECLARE_string(ppr_seeds);
+DECLARE_int32(ppr_walk_num);
+DECLARE_double(ppr_alpha);
+DECLARE_double(ppr_threshold);
+
+DECLARE_int32(random_walk_length);
+DECLARE_int32(random_walk_num);
+DECLARE_bool(random_walk_weighted);
+DECLARE_double(random_walk_p);
+DECLARE_double(random_walk_q);
 
 DECLARE_int64(bfs_source);
 DECLARE_int32(bfs_depth_limit);
@@ -115,6 +162,8 @@ DECLARE_int32(app_concurrency);
 
 DECLARE_int64(dfs_source);
 DECLARE_string(dfs_format);
+DECLARE_bool(dfs_local_first);
+DECLARE_int64(bcc_source);
 
 namespace gs {
 
@@ -237,6 +286,37 @@ void Run() {
     CreateAndQuery<GraphType, AppType, OID_T>(
         comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
         FLAGS_sssp_source, FLAGS_sssp_weight);
+  } else if (name == "sssp_delta_stepping") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, double>;
+    using AppType = SSSPDeltaStepping<GraphType>;
+    CreateAndQuery<GraphType, AppType, OID_T>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_sssp_source, FLAGS_sssp_delta);
+  } else if (name == "sssp_delta_stepping_float") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, double>;
+    using AppType = SSSPDeltaSteppingFloat<GraphType>;
+    CreateAndQuery<GraphType, AppType, OID_T>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_sssp_source, FLAGS_sssp_delta);
+  } else if (name == "batched_ppr") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T>;
+    using AppType = BatchedPPR<GraphType>;
+    CreateAndQuery<GraphType, AppType>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_ppr_seeds, FLAGS_ppr_walk_num, FLAGS_ppr_alpha,
+        FLAGS_ppr_threshold);
+  } else if (name == "random_walk") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, double,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = RandomWalk<GraphType>;
+    CreateAndQuery<GraphType, AppType>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_random_walk_length, FLAGS_random_walk_num,
+        FLAGS_random_walk_weighted, FLAGS_random_walk_p, FLAGS_random_walk_q);
   } else if (name == "cdlp_auto") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -273,6 +353,27 @@ void Run() {
     using AppType = grape::WCC<GraphType>;
     CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
                                        FLAGS_datasource, fnum, spec);
+  } else if (name == "wcc_afforest") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = WCCAfforest<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec);
+  } else if (name == "wcc_rma") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = WCCRMA<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec);
+  } else if (name == "scc") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = SCC<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec);
   } else if (name == "lcc_auto") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -319,6 +420,14 @@ void Run() {
     CreateAndQuery<GraphType, AppType, double, int>(
         comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec, 0.85,
         10);
+  } else if (name == "pagerank_float") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = PageRankFloat<GraphType>;
+    CreateAndQuery<GraphType, AppType, double, int>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec, 0.85,
+        10);
   } else if (name == "kcore") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -353,6 +462,33 @@ void Run() {
         FLAGS_katz_centrality_alpha, FLAGS_katz_centrality_beta,
         FLAGS_katz_centrality_tolerance, FLAGS_katz_centrality_max_round,
         FLAGS_katz_centrality_normalized);
+  } else if (name == "betweenness_centrality") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = BetweennessCentrality<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec,
+                                       FLAGS_betweenness_centrality_normalized,
+                                       FLAGS_betweenness_centrality_k);
+  } else if (name == "closeness_centrality") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = ClosenessCentrality<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec,
+                                       FLAGS_closeness_centrality_wf_improved,
+                                       FLAGS_closeness_centrality_k);
+  } else if (name == "level_louvain") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = LevelLouvain<GraphType>;
+    CreateAndQuery<GraphType, AppType>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_level_louvain_tolerance, FLAGS_level_louvain_max_sweeps,
+        FLAGS_level_louvain_max_levels);
   } else if (name == "eigenvector") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -378,6 +514,14 @@ void Run() {
     CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
                                        FLAGS_datasource, fnum, spec,
                                        FLAGS_degree_centrality_type);
+  } else if (name == "fused_analytics") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = FusedAnalytics<GraphType>;
+    CreateAndQuery<GraphType, AppType, double, int>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec, 0.85,
+        10, FLAGS_degree_centrality_type);
   } else if (name == "triangles") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -406,6 +550,33 @@ void Run() {
     using AppType = Transitivity<GraphType>;
     CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
                                        FLAGS_datasource, fnum, spec);
+  } else if (name == "approx_clustering") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = ApproxClustering<GraphType>;
+    CreateAndQuery<GraphType, AppType>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_approx_clustering_mode, FLAGS_approx_clustering_epsilon,
+        FLAGS_approx_clustering_delta);
+  } else if (name == "hyper_anf") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = HyperANF<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec,
+                                       FLAGS_hyper_anf_max_hops,
+                                       FLAGS_hyper_anf_precision);
+  } else if (name == "link_similarity") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kOnlyOut>;
+    using AppType = LinkSimilarity<GraphType>;
+    CreateAndQuery<GraphType, AppType>(
+        comm_spec, efile, vfile, out_prefix, FLAGS_datasource, fnum, spec,
+        FLAGS_link_similarity_max_exact_degree,
+        FLAGS_link_similarity_num_hashes);
   } else if (name == "dfs") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
@@ -413,7 +584,16 @@ void Run() {
     using AppType = DFS<GraphType>;
     CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
                                        FLAGS_datasource, fnum, spec,
-                                       FLAGS_dfs_source, FLAGS_dfs_format);
+                                       FLAGS_dfs_source, FLAGS_dfs_format,
+                                       FLAGS_dfs_local_first);
+  } else if (name == "bcc") {
+    using GraphType =
+        grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
+                                        grape::LoadStrategy::kBothOutIn>;
+    using AppType = BCC<GraphType>;
+    CreateAndQuery<GraphType, AppType>(comm_spec, efile, vfile, out_prefix,
+                                       FLAGS_datasource, fnum, spec,
+                                       FLAGS_bcc_source);
   } else if (name == "bfs_original") {
     using GraphType =
         grape::ImmutableEdgecutFragment<OID_T, VID_T, VDATA_T, EDATA_T,
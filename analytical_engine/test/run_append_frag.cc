@@ -19,6 +19,7 @@ limitations under the License.
 #include <fstream>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "gflags/gflags.h"
 
@@ -26,7 +27,9 @@ limitations under the License.
 #include "grape/util.h"
 #include "vineyard/client/client.h"
 
+#include "apps/property/pagerank_property_append.h"
 #include "apps/property/sssp_property_append.h"
+#include "apps/property/wcc_property_append.h"
 #include "core/flags.h"
 #include "core/loader/append_only_arrow_fragment_loader.h"
 #include "core/loader/arrow_fragment_appender.h"
@@ -34,7 +37,14 @@ limitations under the License.
 DEFINE_string(efile, "", "edge file");
 DEFINE_string(vfile, "", "vertex file");
 DEFINE_bool(directed, false, "input graph is directed or not.");
+DEFINE_string(application, "sssp", "application name: sssp, wcc, pagerank.");
 DEFINE_int64(sssp_source, 0, "Source vertex of sssp.");
+DEFINE_double(pr_d, 0.85, "damping factor of pagerank");
+DEFINE_int32(pr_mr, 10, "max rounds of pagerank");
+DEFINE_double(pr_tolerance, 1e-6, "tolerance of the rank changes of pagerank");
+DEFINE_bool(compare_full, false,
+            "recompute from scratch after each append as well, to compare "
+            "with the incremental results");
 DEFINE_string(vineyard_socket, "", "Unix domain socket path for vineyardd");
 // for append frag
 DEFINE_int32(elabel_num, 1, "");
@@ -49,18 +59,22 @@ DEFINE_string(group_id, "grape_consumer", "kafka consumer group id.");
 DEFINE_int32(partition_num, 1, "kafka topic partition number.");
 DEFINE_int32(batch_size, 10000, "kafka consume messages batch size.");
 DEFINE_int64(time_interval, 10, "kafka consume time interval/s");
-
-template <typename FRAG_T>
-void RunSSSP(std::shared_ptr<FRAG_T> fragment, const grape::CommSpec& comm_spec,
-             const std::string& out_prefix, typename FRAG_T::oid_t src_oid) {
-  using AppType = gs::SSSPPropertyAppend<FRAG_T>;
-  auto app = std::make_shared<AppType>();
-  auto worker = AppType::CreateWorker(app, fragment);
+DEFINE_uint64(compaction_threshold, 1 << 20,
+              "compacts the appended edges once there are more unsealed ones "
+              "than it, 0 disables the compaction.");
+
+template <typename APP_T, typename... Args>
+void RunApp(std::shared_ptr<typename APP_T::fragment_t> fragment,
+            const grape::CommSpec& comm_spec, const std::string& out_prefix,
+            bool incremental, Args&&... args) {
+  auto app = std::make_shared<APP_T>();
+  app->set_incremental(incremental);
+  auto worker = APP_T::CreateWorker(app, fragment);
   auto spec = grape::DefaultParallelEngineSpec();
   spec.thread_num = 1;
   worker->Init(comm_spec, spec);
 
-  worker->Query(src_oid);
+  worker->Query(std::forward<Args>(args)...);
 
   std::ofstream ostream;
   std::string output_path =
@@ -73,6 +87,24 @@ void RunSSSP(std::shared_ptr<FRAG_T> fragment, const grape::CommSpec& comm_spec,
   worker->Finalize();
 }
 
+template <typename FRAG_T>
+void Run(std::shared_ptr<FRAG_T> fragment, const grape::CommSpec& comm_spec,
+         const std::string& out_prefix, bool incremental) {
+  if (FLAGS_application == "sssp") {
+    RunApp<gs::SSSPPropertyAppend<FRAG_T>>(fragment, comm_spec, out_prefix,
+                                           incremental, FLAGS_sssp_source);
+  } else if (FLAGS_application == "wcc") {
+    RunApp<gs::WCCPropertyAppend<FRAG_T>>(fragment, comm_spec, out_prefix,
+                                          incremental);
+  } else if (FLAGS_application == "pagerank") {
+    RunApp<gs::PageRankPropertyAppend<FRAG_T>>(
+        fragment, comm_spec, out_prefix, incremental, FLAGS_pr_d, FLAGS_pr_mr,
+        FLAGS_pr_tolerance);
+  } else {
+    LOG(FATAL) << "Unsupported application: " << FLAGS_application;
+  }
+}
+
 void read_lines(std::string path,
                 std::function<void(std::vector<std::string>&)> cb) {
   std::vector<std::string> buffer;
@@ -182,18 +214,27 @@ int main(int argc, char** argv) {
         std::dynamic_pointer_cast<GraphType>(client.GetObject(fragment_id));
 
     gs::ArrowFragmentAppender<OID_T, VID_T> appender(comm_spec, fragment);
+    appender.set_compaction_threshold(FLAGS_compaction_threshold);
+
+    std::string out_prefix = "/tmp/" + FLAGS_application + "_out";
+    std::string full_out_prefix = "/tmp/" + FLAGS_application + "_full_out";
+    mkdir(out_prefix.c_str(), 0777);
+    if (FLAGS_compare_full) {
+      mkdir(full_out_prefix.c_str(), 0777);
+    }
 
-    mkdir("/tmp/sssp_out", 0777);
+    bool is_coordinator = (comm_spec.worker_id() == grape::kCoordinatorRank);
 
     MPI_Barrier(comm_spec.comm());
     {
       auto begin = grape::GetCurrentTime();
-      RunSSSP<GraphType>(fragment, comm_spec, "/tmp/sssp_out",
-                         FLAGS_sssp_source);
-      LOG(INFO) << "SSSP(original) time: " << grape::GetCurrentTime() - begin;
+      Run<GraphType>(fragment, comm_spec, out_prefix, true);
+      if (is_coordinator) {
+        LOG(INFO) << FLAGS_application
+                  << "(original) time: " << grape::GetCurrentTime() - begin;
+      }
     }
 
-    bool is_coordinator = (comm_spec.worker_id() == grape::kCoordinatorRank);
     std::unique_ptr<KafkaConsumer> consumer;
 
     if (is_coordinator) {
@@ -260,10 +301,17 @@ int main(int argc, char** argv) {
       }
       {
         auto begin = grape::GetCurrentTime();
-        RunSSSP<GraphType>(fragment, comm_spec, "/tmp/sssp_out",
-                           FLAGS_sssp_source);
+        Run<GraphType>(fragment, comm_spec, out_prefix, true);
+        if (is_coordinator) {
+          LOG(INFO) << FLAGS_application << "(appended, incremental) time: "
+                    << grape::GetCurrentTime() - begin;
+        }
+      }
+      if (FLAGS_compare_full) {
+        auto begin = grape::GetCurrentTime();
+        Run<GraphType>(fragment, comm_spec, full_out_prefix, false);
         if (is_coordinator) {
-          LOG(INFO) << "SSSP(appended) time: "
+          LOG(INFO) << FLAGS_application << "(appended, full) time: "
                     << grape::GetCurrentTime() - begin;
         }
       }
@@ -31,6 +31,7 @@
 #include "apps/pregel/pagerank_pregel.h"
 #include "apps/pregel/sssp_pregel.h"
 #include "apps/pregel/tc_pregel.h"
+#include "core/app/pregel/parallel_pregel_app_base.h"
 #include "core/app/pregel/pregel_app_base.h"
 #include "core/loader/arrow_fragment_loader.h"
 
@@ -86,14 +87,18 @@ void Run(vineyard::Client& client, const grape::CommSpec& comm_spec,
       fragment, comm_spec, "{}", "./pregel_aggregator_test");
 }
 
+using TCGraphType =
+    grape::ImmutableEdgecutFragment<int64_t, uint32_t, grape::EmptyType,
+                                    grape::EmptyType,
+                                    grape::LoadStrategy::kBothOutIn>;
+
+// the pregel triangle counting, by the serial PregelAppBase, or by the
+// multi-threaded ParallelPregelAppBase, which must give the same result
+template <typename AppType>
 void RunTC(grape::CommSpec const& comm_spec, std::string& efile,
            std::string& vfile, const std::string& query,
            std::string& output_prefix) {
-  using GraphType =
-      grape::ImmutableEdgecutFragment<int64_t, uint32_t, grape::EmptyType,
-                                      grape::EmptyType,
-                                      grape::LoadStrategy::kBothOutIn>;
-  using AppType = gs::PregelAppBase<GraphType, gs::PregelTC<GraphType>>;
+  using GraphType = TCGraphType;
   auto load_spec = grape::DefaultLoadGraphSpec();
 
   load_spec.set_directed(false);
@@ -108,7 +113,9 @@ void RunTC(grape::CommSpec const& comm_spec, std::string& efile,
 
 int main(int argc, char** argv) {
   if (argc != 5 && argc < 7) {
-    printf("usage: ./run_pregel_app tc <efile> <vfile> <output_prefix>\n");
+    printf(
+        "usage: ./run_pregel_app tc|tc_parallel <efile> <vfile> "
+        "<output_prefix>\n");
     printf(
         "usage: ./run_pregel_app <ipc_socket> <e_label_num> <efiles...> "
         "<v_label_num> <vfiles...> [directed]\n");
@@ -123,7 +130,12 @@ int main(int argc, char** argv) {
     std::string app_name = std::string(argv[1]);
     if (app_name == "tc") {
       std::string efile = argv[2], vfile = argv[3], output_prefix = argv[4];
-      RunTC(comm_spec, efile, vfile, "", output_prefix);
+      RunTC<gs::PregelAppBase<TCGraphType, gs::PregelTC<TCGraphType>>>(
+          comm_spec, efile, vfile, "", output_prefix);
+    } else if (app_name == "tc_parallel") {
+      std::string efile = argv[2], vfile = argv[3], output_prefix = argv[4];
+      RunTC<gs::ParallelPregelAppBase<TCGraphType, gs::PregelTC<TCGraphType>>>(
+          comm_spec, efile, vfile, "", output_prefix);
     } else {
       int index = 1;
       std::string ipc_socket = std::string(argv[index++]);
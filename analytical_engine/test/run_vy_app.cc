@@ -13,9 +13,14 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <string>
+#include <thread>
 
 #include "glog/logging.h"
 
@@ -37,8 +42,13 @@
 #include "sssp/sssp.h"
 #include "wcc/wcc.h"
 
+#include "benchmarks/apps/pagerank/property_pagerank.h"
+#include "benchmarks/apps/sssp/property_sssp.h"
+#include "benchmarks/apps/wcc/async_property_wcc.h"
+#include "benchmarks/apps/wcc/property_wcc.h"
 #include "core/fragment/arrow_projected_fragment.h"
 #include "core/loader/arrow_fragment_loader.h"
+#include "core/parallel/parallel_property_message_manager.h"
 
 void output_property(std::ofstream& fout, std::shared_ptr<arrow::Table> table,
                      int64_t row_id, int col_id) {
@@ -305,6 +315,218 @@ void RunAutoSSSP(std::shared_ptr<FragmentType> fragment,
   worker->Finalize();
 }
 
+// runs a parallel property app with the messages sent directly, and then
+// routed through the proxies of two hosts the workers are grouped into, of
+// which the results are written to ./outputs_routing_{direct,relay}_<name>/
+// to be compared.
+template <typename APP_T, typename... Args>
+void RunRouting(std::shared_ptr<FragmentType> fragment,
+                const grape::CommSpec& comm_spec, const std::string& name,
+                Args... args) {
+  for (bool hierarchical : {false, true}) {
+    auto app = std::make_shared<APP_T>();
+    auto worker = APP_T::CreateWorker(app, fragment);
+    auto spec = grape::DefaultParallelEngineSpec();
+    worker->Init(comm_spec, spec);
+    if (hierarchical) {
+      // small relay buffers, so each round sends several of them to a host
+      worker->GetMessageManager().EnableHierarchicalRouting(4096, 2);
+    }
+
+    worker->Query(args...);
+
+    std::ofstream ostream;
+    std::string out_prefix = std::string("./outputs_routing_") +
+                             (hierarchical ? "relay_" : "direct_") + name +
+                             "/";
+    std::string output_path =
+        grape::GetResultFilename(out_prefix, fragment->fid());
+
+    ostream.open(output_path);
+    worker->Output(ostream);
+    ostream.close();
+
+    worker->Finalize();
+  }
+}
+
+// runs the property wcc, which combines the labels to the outer vertices,
+// with the default blocks and with the blocks of a few messages, where the
+// combined ones are flushed many times a round, of which the results are
+// written to ./outputs_combine_{round,block}_wcc/ to be compared.
+void RunCombine(std::shared_ptr<FragmentType> fragment,
+                const grape::CommSpec& comm_spec) {
+  using APP_T = gs::benchmarks::PropertyWCC<FragmentType>;
+  for (bool small_block : {false, true}) {
+    auto app = std::make_shared<APP_T>();
+    auto worker = APP_T::CreateWorker(app, fragment);
+    auto spec = grape::DefaultParallelEngineSpec();
+    worker->Init(comm_spec, spec);
+    if (small_block) {
+      worker->GetMessageManager().SetBlockSize(64);
+    }
+
+    worker->Query();
+
+    std::ofstream ostream;
+    std::string out_prefix = std::string("./outputs_combine_") +
+                             (small_block ? "block" : "round") + "_wcc/";
+    std::string output_path =
+        grape::GetResultFilename(out_prefix, fragment->fid());
+
+    ostream.open(output_path);
+    worker->Output(ostream);
+    ostream.close();
+
+    worker->Finalize();
+  }
+}
+
+// runs the property pagerank by pushing only, by pulling only, and by
+// switching between them, of which the results are written to
+// ./outputs_push_pull_{push,pull,switch}_pagerank/ to be compared.
+void RunPushPull(std::shared_ptr<FragmentType> fragment,
+                 const grape::CommSpec& comm_spec) {
+  using APP_T = gs::benchmarks::PropertyPageRank<FragmentType>;
+  constexpr double kMax = std::numeric_limits<double>::max();
+  for (std::string mode : {"push", "pull", "switch"}) {
+    auto app = std::make_shared<APP_T>();
+    auto worker = APP_T::CreateWorker(app, fragment);
+    auto spec = grape::DefaultParallelEngineSpec();
+    worker->Init(comm_spec, spec);
+    if (mode == "push") {
+      worker->GetSwitcher().SetThresholds(0, 0);
+    } else if (mode == "pull") {
+      worker->GetSwitcher().SetThresholds(kMax, kMax);
+    }
+
+    worker->Query(0.85, 10);
+    if (mode == "switch") {
+      // all the vertices are active in the first rounds
+      CHECK_GT(worker->GetSwitcher().switch_num(), 0);
+    }
+
+    std::ofstream ostream;
+    std::string out_prefix = "./outputs_push_pull_" + mode + "_pagerank/";
+    std::string output_path =
+        grape::GetResultFilename(out_prefix, fragment->fid());
+
+    ostream.open(output_path);
+    worker->Output(ostream);
+    ostream.close();
+
+    worker->Finalize();
+  }
+}
+
+template <typename APP_T, typename... Args>
+void RunPropertyApp(std::shared_ptr<FragmentType> fragment,
+                    const grape::CommSpec& comm_spec,
+                    const std::string& out_prefix, Args... args) {
+  auto app = std::make_shared<APP_T>();
+  auto worker = APP_T::CreateWorker(app, fragment);
+  auto spec = grape::DefaultParallelEngineSpec();
+  worker->Init(comm_spec, spec);
+
+  worker->Query(args...);
+
+  std::ofstream ostream;
+  std::string output_path =
+      grape::GetResultFilename(out_prefix, fragment->fid());
+
+  ostream.open(output_path);
+  worker->Output(ostream);
+  ostream.close();
+
+  worker->Finalize();
+}
+
+// a POD message with padding after src_fid, it takes the packed path of
+// ParallelProcess
+struct OuterVertexMsg {
+  uint64_t gid;
+  int64_t oid;
+  uint32_t src_fid;
+};
+
+// syncs every outer vertex of each label to its owner, once with an empty
+// message and once with an OuterVertexMsg, and checks that ParallelProcess
+// delivers each of them to the right vertex exactly once.
+void TestParallelProcess(std::shared_ptr<FragmentType> fragment,
+                         const grape::CommSpec& comm_spec) {
+  using vertex_t = typename FragmentType::vertex_t;
+  static_assert(!gs::is_packed_message<grape::EmptyType>::value,
+                "an empty message isn't packed");
+  static_assert(gs::is_packed_message<OuterVertexMsg>::value,
+                "a POD message is packed");
+
+  auto& frag = *fragment;
+  int thread_num =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  gs::ParallelPropertyMessageManager messages;
+  messages.Init(comm_spec.comm());
+  messages.InitChannels(1);
+  messages.Start();
+
+  uint64_t sent = 0;
+  std::atomic<uint64_t> empty_received(0), pod_received(0);
+  auto sync_all = [&](bool empty) {
+    messages.StartARound();
+    for (int label = 0; label < frag.vertex_label_num(); ++label) {
+      for (auto u : frag.OuterVertices(label)) {
+        if (empty) {
+          messages.SyncStateOnOuterVertex<FragmentType>(frag, u);
+          ++sent;
+        } else {
+          OuterVertexMsg msg;
+          memset(&msg, 0, sizeof(msg));
+          msg.gid = frag.GetOuterVertexGid(u);
+          msg.oid = frag.GetId(u);
+          msg.src_fid = frag.fid();
+          messages.SyncStateOnOuterVertex<FragmentType, OuterVertexMsg>(frag,
+                                                                        u, msg);
+        }
+      }
+    }
+    messages.FinishARound();
+    messages.ToTerminate();
+  };
+
+  sync_all(true);
+  messages.StartARound();
+  messages.ParallelProcess<FragmentType, grape::EmptyType>(
+      thread_num, frag, [&](int tid, vertex_t v, grape::EmptyType) {
+        CHECK(frag.IsInnerVertex(v));
+        ++empty_received;
+      });
+  messages.FinishARound();
+  messages.ToTerminate();
+
+  sync_all(false);
+  messages.StartARound();
+  messages.ParallelProcess<FragmentType, OuterVertexMsg>(
+      thread_num, frag, [&](int tid, vertex_t v, const OuterVertexMsg& msg) {
+        CHECK(frag.IsInnerVertex(v));
+        CHECK_EQ(msg.gid, frag.GetInnerVertexGid(v));
+        CHECK_EQ(msg.oid, frag.GetId(v));
+        CHECK_NE(msg.src_fid, frag.fid());
+        ++pod_received;
+      });
+  messages.FinishARound();
+  messages.ToTerminate();
+  messages.Finalize();
+
+  uint64_t counts[3] = {sent, empty_received.load(), pod_received.load()};
+  MPI_Allreduce(MPI_IN_PLACE, counts, 3, MPI_UINT64_T, MPI_SUM,
+                comm_spec.comm());
+  CHECK_EQ(counts[0], counts[1]);
+  CHECK_EQ(counts[0], counts[2]);
+  if (comm_spec.worker_id() == grape::kCoordinatorRank) {
+    LOG(INFO) << "Passed ParallelProcess of " << counts[0]
+              << " empty and POD messages";
+  }
+}
+
 using ProjectedFragmentType =
     gs::ArrowProjectedFragment<int64_t, uint64_t, double, int64_t>;
 
@@ -465,6 +687,23 @@ void Run(vineyard::Client& client, const grape::CommSpec& comm_spec,
   } else if (app_name == "sampling_path") {
     RunSamplingPath(fragment, comm_spec, "./outputs_sampling_path/",
                     path_pattern);
+  } else if (app_name == "routing") {
+    RunRouting<gs::benchmarks::PropertyWCC<FragmentType>>(fragment, comm_spec,
+                                                          "wcc");
+    RunRouting<gs::benchmarks::PropertySSSP<FragmentType>>(
+        fragment, comm_spec, "sssp", 4);
+  } else if (app_name == "combine") {
+    RunCombine(fragment, comm_spec);
+  } else if (app_name == "push_pull") {
+    RunPushPull(fragment, comm_spec);
+  } else if (app_name == "parallel_process") {
+    TestParallelProcess(fragment, comm_spec);
+  } else if (app_name == "async") {
+    // the asynchronous wcc must converge to the labels of the synchronous one
+    RunPropertyApp<gs::benchmarks::PropertyWCC<FragmentType>>(
+        fragment, comm_spec, "./outputs_async_sync_wcc/");
+    RunPropertyApp<gs::benchmarks::AsyncPropertyWCC<FragmentType>>(
+        fragment, comm_spec, "./outputs_async_async_wcc/");
   } else {
     if (!run_projected) {
       RunWCC(fragment, comm_spec, "./outputs_wcc/");
@@ -0,0 +1,277 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "core/fragment/dynamic_fragment.h"
+
+using space_t = gs::dynamic_fragment_impl::NbrMapSpace<folly::dynamic>;
+using vid_t = vineyard::property_graph_types::VID_TYPE;
+
+// the neighbors of a slot with the "w" of their data, which must be sorted
+std::map<vid_t, int64_t> nbrsOf(const space_t& space, size_t loc) {
+  std::map<vid_t, int64_t> nbrs;
+  vid_t last = 0;
+  bool first = true;
+  for (auto& nbr : space[loc]) {
+    vid_t vid = nbr.neighbor().GetValue();
+    CHECK(first || last < vid) << "unsorted slot " << loc;
+    first = false;
+    last = vid;
+    nbrs[vid] = nbr.data().getDefault("w", -1).asInt();
+  }
+  return nbrs;
+}
+
+folly::dynamic weight(int64_t w) { return folly::dynamic::object("w", w); }
+
+// the deltas of a batch are merged into the sorted neighbors, and the data
+// of the existing ones are merged
+void TestDeltaMerge() {
+  space_t space;
+  size_t loc = space.allocate();
+  bool created;
+  for (vid_t vid : {5, 3, 9, 1, 7}) {
+    space.emplace(loc, vid, weight(vid), created);
+    CHECK(created);
+  }
+  // found in the delta before the merge
+  space.emplace(loc, 3, folly::dynamic::object("x", 1), created);
+  CHECK(!created);
+  space.Compact();
+  CHECK(space[loc].compacted());
+  CHECK(nbrsOf(space, loc) ==
+        (std::map<vid_t, int64_t>{{1, 1}, {3, 3}, {5, 5}, {7, 7}, {9, 9}}));
+  CHECK_EQ(space[loc].find(3)->data()["x"].asInt(), 1);
+  CHECK_EQ(space[loc].find(3)->data()["w"].asInt(), 3);
+
+  // a larger one is appended to the sorted part, a smaller one to the delta
+  space.emplace(loc, 11, weight(11), created);
+  CHECK(created && space[loc].compacted());
+  space.emplace(loc, 0, weight(0), created);
+  CHECK(created && !space[loc].compacted());
+  space.Compact();
+  CHECK_EQ(nbrsOf(space, loc).size(), 7u);
+
+  // a batch over many slots by several threads, with each neighbor twice
+  constexpr size_t kSlotNum = 64, kNbrNum = 256;
+  std::vector<size_t> locs;
+  for (size_t i = 0; i < kSlotNum; ++i) {
+    locs.push_back(space.allocate());
+  }
+  std::vector<folly::dynamic> data;
+  data.reserve(2 * kSlotNum * kNbrNum);
+  std::vector<space_t::BatchNbr> batch;
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < kNbrNum; ++i) {
+      for (size_t j = 0; j < kSlotNum; ++j) {
+        // descending, so all of them go to the deltas
+        vid_t vid = static_cast<vid_t>(kNbrNum - i);
+        data.push_back(weight(round * 1000 + static_cast<int64_t>(vid)));
+        batch.push_back(space_t::BatchNbr{locs[j], vid, &data.back()});
+      }
+    }
+  }
+  std::vector<uint8_t> created_flags;
+  space.BatchEmplace(batch, created_flags);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    CHECK_EQ(created_flags[i], i < batch.size() / 2 ? 1 : 0);
+  }
+  for (auto l : locs) {
+    auto nbrs = nbrsOf(space, l);
+    CHECK_EQ(nbrs.size(), kNbrNum);
+    for (auto& pair : nbrs) {
+      // the later data is merged into the former one
+      CHECK_EQ(pair.second, 1000 + static_cast<int64_t>(pair.first));
+    }
+  }
+  LOG(INFO) << "Passed the test of the delta merge";
+}
+
+// a removed neighbor is added back with the new data only
+void TestEraseReAdd() {
+  space_t space;
+  size_t loc = space.allocate();
+  bool created;
+  for (vid_t vid = 0; vid < 10; ++vid) {
+    space.emplace(loc, vid, weight(vid), created);
+  }
+  space.Compact();
+  CHECK_EQ(space.remove_edge(loc, 5), 1u);
+  CHECK_EQ(space.remove_edge(loc, 5), 0u);
+  CHECK(space[loc].find(5) == space[loc].end());
+  CHECK_EQ(nbrsOf(space, loc).size(), 9u);
+
+  space.emplace(loc, 5, folly::dynamic::object("w", 50), created);
+  CHECK(created);
+  space.Compact();
+  auto nbrs = nbrsOf(space, loc);
+  CHECK_EQ(nbrs.size(), 10u);
+  CHECK_EQ(nbrs[5], 50);
+
+  // removed and added back by the batches
+  std::vector<folly::dynamic> data{weight(20), weight(40)};
+  std::vector<space_t::BatchNbr> batch{{loc, 2, &data[0]}, {loc, 4, &data[1]},
+                                       {loc, 42, &data[1]}};
+  std::vector<uint8_t> flags;
+  space.BatchRemove(batch, flags);
+  CHECK(flags == (std::vector<uint8_t>{1, 1, 0}));
+  CHECK_EQ(nbrsOf(space, loc).size(), 8u);
+  space.BatchEmplace(batch, flags);
+  CHECK(flags == (std::vector<uint8_t>{1, 1, 1}));
+  nbrs = nbrsOf(space, loc);
+  CHECK_EQ(nbrs.size(), 11u);
+  CHECK_EQ(nbrs[2], 20);
+  CHECK_EQ(nbrs[4], 40);
+  CHECK_EQ(nbrs[42], 40);
+  LOG(INFO) << "Passed the test of the erase and re-add";
+}
+
+// the copies share the slots until either side writes them
+void TestCopyOnWrite() {
+  space_t origin;
+  bool created;
+  for (size_t i = 0; i < 3; ++i) {
+    size_t loc = origin.allocate();
+    for (vid_t vid = 0; vid < 4; ++vid) {
+      origin.emplace(loc, vid, weight(vid), created);
+    }
+  }
+  origin.Compact();
+  const space_t& c_origin = origin;
+
+  space_t copy;
+  copy.copy(origin);
+  const space_t& c_copy = copy;
+  for (size_t loc = 0; loc < 3; ++loc) {
+    CHECK_EQ(&c_copy[loc], &c_origin[loc]);
+  }
+
+  copy.emplace(0, 10, weight(10), created);
+  copy.Compact();
+  CHECK_NE(&c_copy[0], &c_origin[0]);
+  CHECK_EQ(nbrsOf(copy, 0).size(), 5u);
+  CHECK_EQ(nbrsOf(origin, 0).size(), 4u);
+
+  // the source duplicates its slots on the write as well
+  CHECK_EQ(origin.remove_edge(1, 2), 1u);
+  CHECK_NE(&c_copy[1], &c_origin[1]);
+  CHECK_EQ(nbrsOf(copy, 1).size(), 4u);
+  CHECK_EQ(nbrsOf(origin, 1).size(), 3u);
+
+  copy.set_data(2, 3, weight(30));
+  CHECK_EQ(nbrsOf(copy, 2)[3], 30);
+  CHECK_EQ(nbrsOf(origin, 2)[3], 3);
+
+  // a written slot is owned, and not duplicated again
+  auto* owned = &c_copy[0];
+  copy.emplace(0, 11, weight(11), created);
+  copy.Compact();
+  CHECK_EQ(&c_copy[0], owned);
+
+  // both halves of a double copy share each slot, which is written by two
+  // threads of a batch, as the number of the slots is a prime
+  constexpr size_t kSlotNum = 61, kNbrNum = 256;
+  space_t wide;
+  for (size_t i = 0; i < kSlotNum; ++i) {
+    size_t loc = wide.allocate();
+    wide.emplace(loc, 0, weight(0), created);
+  }
+  space_t doubled;
+  doubled.double_copy(wide);
+  CHECK_EQ(doubled.size(), 2 * kSlotNum);
+  folly::dynamic w = weight(1);
+  std::vector<space_t::BatchNbr> batch;
+  for (vid_t vid = 1; vid <= kNbrNum; ++vid) {
+    for (size_t loc = 0; loc < 2 * kSlotNum; ++loc) {
+      // the upper half gets the odd ones only
+      if (loc < kSlotNum || vid % 2 == 1) {
+        batch.push_back(space_t::BatchNbr{loc, vid, &w});
+      }
+    }
+  }
+  std::vector<uint8_t> flags;
+  doubled.BatchEmplace(batch, flags);
+  for (size_t loc = 0; loc < kSlotNum; ++loc) {
+    CHECK_EQ(nbrsOf(wide, loc).size(), 1u);
+    CHECK_EQ(nbrsOf(doubled, loc).size(), kNbrNum + 1);
+    CHECK_EQ(nbrsOf(doubled, loc + kSlotNum).size(), kNbrNum / 2 + 1);
+  }
+  LOG(INFO) << "Passed the test of the copy on write";
+}
+
+// a copy is read by a thread while the source is written, as a snapshot of
+// the fragment is read during a mutation
+void TestReadDuringWrite() {
+  constexpr size_t kSlotNum = 64;
+  constexpr vid_t kNbrNum = 128;
+  space_t origin;
+  bool created;
+  for (size_t i = 0; i < kSlotNum; ++i) {
+    size_t loc = origin.allocate();
+    for (vid_t vid = 0; vid < kNbrNum; ++vid) {
+      origin.emplace(loc, vid, weight(vid), created);
+    }
+  }
+  origin.Compact();
+  space_t snapshot;
+  snapshot.copy(origin);
+
+  std::thread reader([&snapshot]() {
+    for (int round = 0; round < 16; ++round) {
+      for (size_t loc = 0; loc < kSlotNum; ++loc) {
+        auto nbrs = nbrsOf(snapshot, loc);
+        CHECK_EQ(nbrs.size(), kNbrNum);
+        for (auto& pair : nbrs) {
+          CHECK_EQ(pair.second, static_cast<int64_t>(pair.first));
+        }
+      }
+    }
+  });
+  for (size_t loc = 0; loc < kSlotNum; ++loc) {
+    origin.remove_edge(loc, loc % kNbrNum);
+    origin.set_data(loc, (loc + 1) % kNbrNum, weight(-1));
+    origin.emplace(loc, kNbrNum + loc, weight(0), created);
+  }
+  origin.Compact();
+  reader.join();
+
+  for (size_t loc = 0; loc < kSlotNum; ++loc) {
+    auto nbrs = nbrsOf(origin, loc);
+    CHECK_EQ(nbrs.size(), kNbrNum);
+    CHECK(nbrs.find(loc % kNbrNum) == nbrs.end());
+    CHECK_EQ(nbrs[(loc + 1) % kNbrNum], -1);
+    CHECK_EQ(nbrsOf(snapshot, loc).size(), kNbrNum);
+  }
+  LOG(INFO) << "Passed the test of the read during the write";
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging("test_dynamic_fragment");
+  google::InstallFailureSignalHandler();
+
+  TestDeltaMerge();
+  TestEraseReAdd();
+  TestCopyOnWrite();
+  TestReadDuringWrite();
+
+  google::ShutdownGoogleLogging();
+  return 0;
+}
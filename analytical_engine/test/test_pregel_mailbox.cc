@@ -0,0 +1,186 @@
+/** Copyright 2020 Alibaba Group Holding Limited.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * 	http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "glog/logging.h"
+
+#include "grape/graph/vertex.h"
+#include "grape/utils/vertex_array.h"
+
+#include "core/app/pregel/pregel_mailbox.h"
+
+// the vertex types of a fragment, which are all PregelMailbox takes from it
+struct MailboxFragment {
+  using vid_t = uint32_t;
+  using vertex_t = grape::Vertex<vid_t>;
+  template <typename T>
+  using vertex_array_t = grape::VertexArray<T, vid_t>;
+};
+
+using vertex_t = MailboxFragment::vertex_t;
+using mailbox_t = gs::PregelMailbox<MailboxFragment, int>;
+
+constexpr uint32_t kVertexNum = 1000;
+constexpr int kThreadNum = 4;
+
+// the messages to v in a round, from thread tid, of which some vertices get
+// none and some get several ones from each thread
+std::vector<int> expectedMessages(int round, int tid, uint32_t v) {
+  std::vector<int> msgs;
+  if ((v + round) % 3 == 0) {
+    return msgs;
+  }
+  for (uint32_t i = 0; i <= (v + tid) % 3; ++i) {
+    msgs.push_back(static_cast<int>(round * 1000000 + v * 100 + tid * 10 + i));
+  }
+  return msgs;
+}
+
+// appends the messages of a round by kThreadNum threads at once
+void appendRound(mailbox_t& mailbox, int round) {
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < kThreadNum; ++tid) {
+    threads.emplace_back([&mailbox, round, tid]() {
+      for (uint32_t v = 0; v < kVertexNum; ++v) {
+        for (int msg : expectedMessages(round, tid, v)) {
+          mailbox.Append(tid, vertex_t(v), msg);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// checks the built messages of each vertex, and the receivers of each bucket
+void checkRound(mailbox_t& mailbox, int round) {
+  std::vector<uint8_t> received(kVertexNum, 0);
+  for (int bucket = 0; bucket < mailbox.BucketNum(); ++bucket) {
+    for (auto& v : mailbox.Receivers(bucket)) {
+      CHECK_EQ(mailbox.Bucket(v), bucket);
+      CHECK_EQ(received[v.GetValue()], 0) << "twice: " << v.GetValue();
+      received[v.GetValue()] = 1;
+    }
+  }
+  for (uint32_t v = 0; v < kVertexNum; ++v) {
+    std::vector<int> expected;
+    for (int tid = 0; tid < kThreadNum; ++tid) {
+      auto msgs = expectedMessages(round, tid, v);
+      expected.insert(expected.end(), msgs.begin(), msgs.end());
+    }
+    auto got = mailbox.Get(vertex_t(v));
+    std::vector<int> actual(got.begin(), got.end());
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    CHECK(actual == expected) << "round " << round << ", vertex " << v;
+    CHECK_EQ(mailbox.Size(vertex_t(v)), expected.size());
+    CHECK_EQ(mailbox.Empty(vertex_t(v)), expected.empty());
+    CHECK_EQ(received[v], expected.empty() ? 0 : 1);
+  }
+}
+
+// builds the buckets on a thread each
+template <typename MAILBOX_T>
+void buildConcurrently(MAILBOX_T& mailbox) {
+  mailbox.Build([](int bucket_num, const std::function<void(int)>& func) {
+    std::vector<std::thread> threads;
+    for (int bucket = 0; bucket < bucket_num; ++bucket) {
+      threads.emplace_back(func, bucket);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  });
+}
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging("test_pregel_mailbox");
+  google::InstallFailureSignalHandler();
+
+  mailbox_t mailbox;
+  mailbox.Init(grape::VertexRange<uint32_t>(0, kVertexNum), kThreadNum);
+  CHECK_EQ(mailbox.BucketNum(), kThreadNum);
+
+  // the messages of a round replace the ones of the last round, which are
+  // readable until then
+  appendRound(mailbox, 0);
+  CHECK(mailbox.HasPending());
+  mailbox.Build();
+  CHECK(!mailbox.HasPending());
+  checkRound(mailbox, 0);
+
+  appendRound(mailbox, 1);
+  checkRound(mailbox, 0);
+  buildConcurrently(mailbox);
+  CHECK(!mailbox.HasPending());
+  checkRound(mailbox, 1);
+
+  // an empty round leaves no receivers
+  mailbox.Build();
+  for (int bucket = 0; bucket < mailbox.BucketNum(); ++bucket) {
+    CHECK(mailbox.Receivers(bucket).empty());
+  }
+  for (uint32_t v = 0; v < kVertexNum; ++v) {
+    CHECK(mailbox.Empty(vertex_t(v)));
+  }
+
+  // a single bucket after the threads change
+  mailbox.SetThreadNum(1);
+  for (uint32_t v = 0; v < kVertexNum; v += 7) {
+    mailbox.Append(0, vertex_t(v), static_cast<int>(v));
+  }
+  mailbox.Build();
+  CHECK_EQ(mailbox.Receivers(0).size(), (kVertexNum + 6) / 7);
+  for (uint32_t v = 0; v < kVertexNum; ++v) {
+    auto got = mailbox.Get(vertex_t(v));
+    if (v % 7 == 0) {
+      CHECK_EQ(mailbox.Size(vertex_t(v)), 1u);
+      CHECK_EQ(*got.begin(), static_cast<int>(v));
+    } else {
+      CHECK(mailbox.Empty(vertex_t(v)));
+    }
+  }
+
+  // the bool messages are read through a plain array as well
+  gs::PregelMailbox<MailboxFragment, bool> flags;
+  flags.Init(grape::VertexRange<uint32_t>(0, kVertexNum), kThreadNum);
+  for (int round = 0; round < 2; ++round) {
+    for (uint32_t v = 0; v < kVertexNum; v += 3) {
+      flags.Append(v % kThreadNum, vertex_t(v), (v + round) % 2 == 0);
+      flags.Append((v + 1) % kThreadNum, vertex_t(v), round == 0);
+    }
+    buildConcurrently(flags);
+    for (uint32_t v = 0; v < kVertexNum; ++v) {
+      auto got = flags.Get(vertex_t(v));
+      std::vector<bool> actual(got.begin(), got.end());
+      std::sort(actual.begin(), actual.end());
+      std::vector<bool> expected;
+      if (v % 3 == 0) {
+        expected = {(v + round) % 2 == 0, round == 0};
+        std::sort(expected.begin(), expected.end());
+      }
+      CHECK(actual == expected) << "round " << round << ", vertex " << v;
+    }
+  }
+
+  LOG(INFO) << "Passed the tests of the pregel mailbox";
+  google::ShutdownGoogleLogging();
+  return 0;
+}
@@ -185,6 +185,8 @@ class KubernetesClusterLauncher(Launcher):
         vineyard_cpu=None,
         vineyard_mem=None,
         vineyard_shared_mem=None,
+        query_cache_bytes=0,
+        memory_budget_bytes=0,
         mars_worker_cpu=None,
         mars_worker_mem=None,
         mars_scheduler_cpu=None,
@@ -239,6 +241,11 @@ class KubernetesClusterLauncher(Launcher):
         self._vineyard_mem = vineyard_mem
         self._vineyard_shared_mem = vineyard_shared_mem
 
+        # capacity of the query cache of analytical engine
+        self._query_cache_bytes = query_cache_bytes
+        # bytes of the objects of a worker of analytical engine to evict beyond
+        self._memory_budget_bytes = memory_budget_bytes
+
         # etcd pod info
         self._etcd_image = etcd_image
         self._etcd_num_pods = max(1, etcd_num_pods)
@@ -979,6 +986,8 @@ class KubernetesClusterLauncher(Launcher):
             mpi_env["GLOG_v"] = str(self._glog_level)
 
         cmd.extend(["--vineyard_socket", "/tmp/vineyard_workspace/vineyard.sock"])
+        cmd.extend(["--query_cache_bytes", str(self._query_cache_bytes)])
+        cmd.extend(["--memory_budget_bytes", str(self._memory_budget_bytes)])
         logger.debug("Analytical engine launching command: {}".format(" ".join(cmd)))
 
         env = os.environ.copy()
@@ -56,6 +56,7 @@ from gscoordinator.launcher import LocalLauncher
 from gscoordinator.object_manager import GraphMeta
 from gscoordinator.object_manager import LibMeta
 from gscoordinator.object_manager import ObjectManager
+from gscoordinator.utils import BUILTIN_WORKSPACE
 from gscoordinator.utils import compile_app
 from gscoordinator.utils import compile_graph_frame
 from gscoordinator.utils import create_single_op_dag
@@ -63,6 +64,7 @@ from gscoordinator.utils import dump_string
 from gscoordinator.utils import get_app_sha256
 from gscoordinator.utils import get_graph_sha256
 from gscoordinator.utils import get_lib_path
+from gscoordinator.utils import library_lock
 from gscoordinator.utils import str2bool
 from gscoordinator.utils import to_maxgraph_schema
 from gscoordinator.version import __version__
@@ -135,7 +137,7 @@ class CoordinatorServiceServicer(
         self._analytical_engine_config = None
         self._analytical_engine_endpoint = None
 
-        self._builtin_workspace = os.path.join(WORKSPACE, "builtin")
+        self._builtin_workspace = BUILTIN_WORKSPACE
         # udf app workspace should be bound to a specific session when client connect.
         self._udf_app_workspace = None
 
@@ -248,6 +250,67 @@ class CoordinatorServiceServicer(
                 message_pb2.HeartBeatResponse, error_codes_pb2.OK
             )
 
+    # ops whose results may be large, which are streamed from the engine
+    _streaming_ops = (
+        types_pb2.CONTEXT_TO_NUMPY,
+        types_pb2.CONTEXT_TO_DATAFRAME,
+        types_pb2.CONTEXT_TO_FILES,
+        types_pb2.CONTEXT_TO_ARROW,
+        types_pb2.GRAPH_TO_NUMPY,
+        types_pb2.GRAPH_TO_DATAFRAME,
+    )
+
+    def _run_step_streaming(self, request):
+        """Run the step by the streaming RPC of the engine, the chunks of the
+        result are joined once, and the last response carries the status.
+        """
+        chunks = []
+        response = None
+        for response in self._analytical_engine_stub.RunStepStreaming(request):
+            chunks.append(response.result)
+        response.result = b"".join(chunks)
+        return response
+
+    # ops which may run long, which are submitted to the engine and polled,
+    # so their progress is logged
+    _polling_ops = (types_pb2.RUN_APP,)
+
+    # the seconds to wait for a submitted step in a poll
+    _poll_interval = 10
+
+    def _run_step_polling(self, request):
+        """Run the step by submitting it to the engine, and poll it until it is
+        done, logging the workers finished and the time elapsed.
+        """
+        submitted = self._analytical_engine_stub.SubmitStep(request)
+        if submitted.status.code != error_codes_pb2.OK:
+            return self._make_response(
+                message_pb2.RunStepResponse,
+                submitted.status.code,
+                submitted.status.error_msg,
+                request.dag_def.op[0],
+            )
+        poll_request = message_pb2.PollStepRequest(
+            job_id=submitted.job_id, timeout_ms=self._poll_interval * 1000
+        )
+        while True:
+            polled = self._analytical_engine_stub.PollStep(poll_request)
+            if polled.status.code != error_codes_pb2.OK:
+                return self._make_response(
+                    message_pb2.RunStepResponse,
+                    polled.status.code,
+                    polled.status.error_msg,
+                    request.dag_def.op[0],
+                )
+            if polled.done:
+                return polled.response
+            logger.info(
+                "Step %s is running for %.1f seconds on %d workers",
+                submitted.job_id,
+                polled.elapsed_seconds,
+                polled.worker_num,
+            )
+
     def RunStep(self, request, context):  # noqa: C901
         # only one op in one step is allowed.
         if len(request.dag_def.op) != 1:
@@ -312,7 +375,12 @@ class CoordinatorServiceServicer(
                 )
 
         try:
-            response = self._analytical_engine_stub.RunStep(request)
+            if op.op in self._streaming_ops:
+                response = self._run_step_streaming(request)
+            elif op.op in self._polling_ops:
+                response = self._run_step_polling(request)
+            else:
+                response = self._analytical_engine_stub.RunStep(request)
         except grpc.RpcError as e:
             logger.error("self._launcher.poll() = %s", self._launcher.poll())
             if self._launcher.poll() is not None:
@@ -333,6 +401,7 @@ class CoordinatorServiceServicer(
                 types_pb2.PROJECT_GRAPH,
                 types_pb2.ADD_LABELS,
                 types_pb2.ADD_COLUMN,
+                types_pb2.REBALANCE_GRAPH,
             ):
                 schema_path = os.path.join("/tmp", response.graph_def.key + ".json")
                 self._object_manager.put(
@@ -370,10 +439,13 @@ class CoordinatorServiceServicer(
         if types_pb2.GAR in op.attr:
             space = self._udf_app_workspace
         app_lib_path = get_lib_path(os.path.join(space, app_sig), app_sig)
-        if not os.path.isfile(app_lib_path):
-            compiled_path = self._compile_lib_and_distribute(compile_app, app_sig, op)
-            if app_lib_path != compiled_path:
-                raise RuntimeError("Computed path not equal to compiled path.")
+        with library_lock(space, app_sig):
+            if not os.path.isfile(app_lib_path):
+                compiled_path = self._compile_lib_and_distribute(
+                    compile_app, app_sig, op
+                )
+                if app_lib_path != compiled_path:
+                    raise RuntimeError("Computed path not equal to compiled path.")
 
         op.attr[types_pb2.APP_LIBRARY_PATH].CopyFrom(
             attr_value_pb2.AttrValue(s=app_lib_path.encode("utf-8"))
@@ -384,12 +456,13 @@ class CoordinatorServiceServicer(
         graph_sig = get_graph_sha256(op.attr)
         space = self._builtin_workspace
         graph_lib_path = get_lib_path(os.path.join(space, graph_sig), graph_sig)
-        if not os.path.isfile(graph_lib_path):
-            compiled_path = self._compile_lib_and_distribute(
-                compile_graph_frame, graph_sig, op
-            )
-            if graph_lib_path != compiled_path:
-                raise RuntimeError("Computed path not equal to compiled path.")
+        with library_lock(space, graph_sig):
+            if not os.path.isfile(graph_lib_path):
+                compiled_path = self._compile_lib_and_distribute(
+                    compile_graph_frame, graph_sig, op
+                )
+                if graph_lib_path != compiled_path:
+                    raise RuntimeError("Computed path not equal to compiled path.")
         if graph_sig not in self._object_manager:
             # register graph
             op_def = op_def_pb2.OpDef(op=types_pb2.REGISTER_GRAPH_TYPE)
@@ -851,6 +924,19 @@ def parse_sys_args():
         default="8Gi",
         help="Plasma memory in vineyard, suffix with ['Mi', 'Gi', 'Ti'].",
     )
+    parser.add_argument(
+        "--query_cache_bytes",
+        type=int,
+        default=0,
+        help="Capacity in bytes of the query cache of analytical engine, 0 to disable.",
+    )
+    parser.add_argument(
+        "--memory_budget_bytes",
+        type=int,
+        default=0,
+        help="Bytes of the objects held by a worker of analytical engine, beyond "
+        "which the unused projected graphs and contexts are evicted, 0 for no budget.",
+    )
     parser.add_argument(
         "--k8s_engine_cpu",
         type=float,
@@ -1001,6 +1087,8 @@ def launch_graphscope():
             vineyard_cpu=args.k8s_vineyard_cpu,
             vineyard_mem=args.k8s_vineyard_mem,
             vineyard_shared_mem=args.vineyard_shared_mem,
+            query_cache_bytes=args.query_cache_bytes,
+            memory_budget_bytes=args.memory_budget_bytes,
             mars_worker_cpu=args.k8s_mars_worker_cpu,
             mars_worker_mem=args.k8s_mars_worker_mem,
             mars_scheduler_cpu=args.k8s_mars_scheduler_cpu,
@@ -1023,6 +1111,8 @@ def launch_graphscope():
             hosts=args.hosts,
             vineyard_socket=args.vineyard_socket,
             shared_mem=args.vineyard_shared_mem,
+            query_cache_bytes=args.query_cache_bytes,
+            memory_budget_bytes=args.memory_budget_bytes,
             log_level=args.log_level,
             instance_id=args.instance_id,
             timeout_seconds=args.timeout_seconds,
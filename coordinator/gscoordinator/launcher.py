@@ -94,6 +94,8 @@ class LocalLauncher(Launcher):
         log_level,
         instance_id,
         timeout_seconds,
+        query_cache_bytes=0,
+        memory_budget_bytes=0,
     ):
         super().__init__()
         self._num_workers = num_workers
@@ -103,6 +105,8 @@ class LocalLauncher(Launcher):
         self._glog_level = parse_as_glog_level(log_level)
         self._instance_id = instance_id
         self._timeout_seconds = timeout_seconds
+        self._query_cache_bytes = query_cache_bytes
+        self._memory_budget_bytes = memory_budget_bytes
 
         if "GRAPHSCOPE_PREFIX" not in os.environ:
             # only launch GAE
@@ -347,6 +351,8 @@ class LocalLauncher(Launcher):
 
         if self._vineyard_socket:
             cmd.extend(["--vineyard_socket", self._vineyard_socket])
+        cmd.extend(["--query_cache_bytes", str(self._query_cache_bytes)])
+        cmd.extend(["--memory_budget_bytes", str(self._memory_budget_bytes)])
 
         env = os.environ.copy()
         env.update(mpi_env)
@@ -17,8 +17,10 @@
 #
 
 
+import contextlib
 import copy
 import datetime
+import fcntl
 import glob
 import hashlib
 import json
@@ -44,6 +46,7 @@ from graphscope.proto import op_def_pb2
 from graphscope.proto import types_pb2
 
 from gscoordinator.io_utils import PipeWatcher
+from gscoordinator.version import __version__
 
 logger = logging.getLogger("graphscope")
 
@@ -57,6 +60,11 @@ except ModuleNotFoundError:
 GRAPHSCOPE_HOME = os.path.join(COORDINATOR_HOME, "..")
 
 WORKSPACE = "/tmp/gs"
+# the compiled libraries of the builtin apps and graph types, which may be
+# shared by the engines, e.g., by a volume mounted to the pods
+BUILTIN_WORKSPACE = os.environ.get(
+    "GRAPHSCOPE_LIB_CACHE", os.path.join(WORKSPACE, "builtin")
+)
 DEFAULT_GS_CONFIG_FILE = ".gs_conf.yaml"
 ANALYTICAL_ENGINE_HOME = os.path.join(GRAPHSCOPE_HOME, "analytical_engine")
 ANALYTICAL_ENGINE_PATH = os.path.join(ANALYTICAL_ENGINE_HOME, "build", "grape_engine")
@@ -99,6 +107,20 @@ def get_lib_path(app_dir, app_name):
     return lib_path
 
 
+@contextlib.contextmanager
+def library_lock(workspace, library_name):
+    """Lock a library of the workspace across the processes, so the ones sharing
+    the workspace compile it once, and never load it while it is being compiled.
+    """
+    os.makedirs(workspace, exist_ok=True)
+    with open(os.path.join(workspace, library_name + ".lock"), "w") as f:
+        fcntl.flock(f, fcntl.LOCK_EX)
+        try:
+            yield
+        finally:
+            fcntl.flock(f, fcntl.LOCK_UN)
+
+
 def get_app_sha256(attr):
     (
         app_type,
@@ -107,16 +129,19 @@ def get_app_sha256(attr):
         vd_type,
         md_type,
         pregel_combine,
+        pregel_compute_batch,
+        pie_kernels,
+        cuda,
     ) = _codegen_app_info(attr, DEFAULT_GS_CONFIG_FILE)
     graph_header, graph_type = _codegen_graph_info(attr)
     logger.info("Codegened graph type: %s, Graph header: %s", graph_type, graph_header)
     if app_type == "cpp_pie":
         return hashlib.sha256(
-            f"{app_type}.{app_class}.{graph_type}".encode("utf-8")
+            f"{__version__}.{app_type}.{app_class}.{graph_type}".encode("utf-8")
         ).hexdigest()
     else:
         s = hashlib.sha256()
-        s.update(f"{app_type}.{app_class}.{graph_type}".encode("utf-8"))
+        s.update(f"{__version__}.{app_type}.{app_class}.{graph_type}".encode("utf-8"))
         if types_pb2.GAR in attr:
             s.update(attr[types_pb2.GAR].s)
         return s.hexdigest()
@@ -124,7 +149,7 @@ def get_app_sha256(attr):
 
 def get_graph_sha256(attr):
     _, graph_class = _codegen_graph_info(attr)
-    return hashlib.sha256(graph_class.encode("utf-8")).hexdigest()
+    return hashlib.sha256(f"{__version__}.{graph_class}".encode("utf-8")).hexdigest()
 
 
 def compile_app(workspace: str, library_name, attr, engine_config: dict):
@@ -152,6 +177,9 @@ def compile_app(workspace: str, library_name, attr, engine_config: dict):
         vd_type,
         md_type,
         pregel_combine,
+        pregel_compute_batch,
+        pie_kernels,
+        cuda,
     ) = _codegen_app_info(attr, DEFAULT_GS_CONFIG_FILE)
     logger.info(
         "Codegened application type: %s, app header: %s, app_class: %s, vd_type: %s, md_type: %s, pregel_combine: %s",
@@ -174,15 +202,23 @@ def compile_app(workspace: str, library_name, attr, engine_config: dict):
         ".",
         "-DNETWORKX=" + engine_config["networkx"],
     ]
+    if cuda:
+        cmake_commands += ["-DENABLE_CUDA=True"]
     if app_type != "cpp_pie":
         if app_type == "cython_pregel":
             pxd_name = "pregel"
             cmake_commands += ["-DCYTHON_PREGEL_APP=True"]
             if pregel_combine:
                 cmake_commands += ["-DENABLE_PREGEL_COMBINE=True"]
+            if pregel_compute_batch:
+                cmake_commands += ["-DENABLE_PREGEL_COMPUTE_BATCH=True"]
         else:
             pxd_name = "pie"
             cmake_commands += ["-DCYTHON_PIE_APP=True"]
+            if "PEvalKernel" in pie_kernels:
+                cmake_commands += ["-DENABLE_PIE_PEVAL_KERNEL=True"]
+            if "IncEvalKernel" in pie_kernels:
+                cmake_commands += ["-DENABLE_PIE_INCEVAL_KERNEL=True"]
 
         # Copy pxd file and generate cc file from pyx
         shutil.copyfile(
@@ -281,6 +317,7 @@ def compile_graph_frame(workspace: str, library_name, attr: dict, engine_config:
         cmake_commands += ["-DPROPERTY_GRAPH_FRAME=True"]
     elif (
         graph_type == types_pb2.ARROW_PROJECTED
+        or graph_type == types_pb2.ARROW_FLATTENED
         or graph_type == types_pb2.DYNAMIC_PROJECTED
     ):
         cmake_commands += ["-DPROJECT_FRAME=True"]
@@ -378,6 +415,9 @@ def _codegen_app_info(attr, meta_file: str):
                     None,
                     None,
                     None,
+                    None,
+                    [],
+                    app.get("cuda", False),
                 )
             if app_type in ("cython_pregel", "cython_pie"):
                 # cython app doesn't have c-header file
@@ -388,6 +428,9 @@ def _codegen_app_info(attr, meta_file: str):
                     app["vd_type"],
                     app["md_type"],
                     app["pregel_combine"],
+                    app.get("pregel_compute_batch", False),
+                    app.get("pie_kernels", []),
+                    False,
                 )
 
     raise KeyError("Algorithm does not exist in the gar resource.")
@@ -411,6 +454,10 @@ GRAPH_HEADER_MAP = {
         "gs::ArrowProjectedFragment",
         "core/fragment/arrow_projected_fragment.h",
     ),
+    types_pb2.ARROW_FLATTENED: (
+        "gs::ArrowFlattenedFragment",
+        "core/fragment/arrow_flattened_fragment.h",
+    ),
     types_pb2.DYNAMIC_PROPERTY: (
         "gs::DynamicFragment",
         "core/fragment/dynamic_fragment.h",
@@ -431,6 +478,7 @@ def _codegen_graph_info(attr):
         )
     elif graph_class in (
         "gs::ArrowProjectedFragment",
+        "gs::ArrowFlattenedFragment",
         "grape::ImmutableEdgecutFragment",
     ):
         # in a format of gs::ArrowProjectedFragment<int64_t, uint32_t, double, double>
@@ -15,8 +15,28 @@
  */
 #include "global_store_ffi.h"
 #include "htap_ds_impl.h"
+#include "htap_trace.h"
 
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// The handles shared in the process by get_shared_graph_handle, keyed by the
+// object id and the channel num, with the number of the users of each.
+struct SharedGraphHandle {
+  GraphHandle handle;
+  int ref_count;
+};
+
+std::mutex shared_handles_mutex;
+std::map<std::pair<ObjectId, PartitionId>, SharedGraphHandle> shared_handles;
+
+}  // namespace
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,14 +49,68 @@ GraphHandle get_graph_handle(ObjectId object_id, PartitionId channel_num) {
   return ret;
 }
 
+GraphHandle get_graph_handle_with_indices(ObjectId object_id,
+                                         PartitionId channel_num,
+                                         LabelId* labels,
+                                         PropertyId* property_ids,
+                                         int index_count) {
+  GraphHandle ret = get_graph_handle(object_id, channel_num);
+  htap_impl::build_property_indices((htap_impl::GraphHandleImpl*)ret, labels,
+                                    property_ids, index_count);
+  return ret;
+}
+
 void free_graph_handle(GraphHandle handle) {
   htap_impl::free_graph_handle((htap_impl::GraphHandleImpl*)handle);
   free(handle);
 }
 
+int set_cold_properties(GraphHandle graph, LabelId* labels,
+                        PropertyId* property_ids, int count, const char* dir) {
+  return htap_impl::map_cold_columns((htap_impl::GraphHandleImpl*)graph,
+                                     labels, property_ids, count, dir);
+}
+
+PropertyId add_virtual_vertex_property(GraphHandle graph, LabelId label,
+                                       const char* name, ObjectId tensor_id) {
+  return htap_impl::add_virtual_columns((htap_impl::GraphHandleImpl*)graph,
+                                        label, name, tensor_id);
+}
+
+GraphHandle get_shared_graph_handle(ObjectId object_id,
+                                    PartitionId channel_num) {
+  std::lock_guard<std::mutex> lock(shared_handles_mutex);
+  auto key = std::make_pair(object_id, channel_num);
+  auto iter = shared_handles.find(key);
+  if (iter != shared_handles.end()) {
+    ++iter->second.ref_count;
+    return iter->second.handle;
+  }
+  GraphHandle ret = get_graph_handle(object_id, channel_num);
+  shared_handles.emplace(key, SharedGraphHandle{ret, 1});
+  return ret;
+}
+
+void release_graph_handle(GraphHandle handle) {
+  std::lock_guard<std::mutex> lock(shared_handles_mutex);
+  for (auto iter = shared_handles.begin(); iter != shared_handles.end();
+       ++iter) {
+    if (iter->second.handle == handle) {
+      if (--iter->second.ref_count == 0) {
+        shared_handles.erase(iter);
+        free_graph_handle(handle);
+      }
+      return;
+    }
+  }
+  LOG(ERROR) << "Release a graph handle not shared: " << handle;
+}
+
 GetVertexIterator get_vertices(GraphHandle graph, PartitionId partition_id,
                                LabelId* labels, VertexId* ids, int count) {
-  GetVertexIterator ret = malloc(sizeof(htap_impl::GetVertexIteratorImpl));
+  HTAP_TRACE_SCOPE("get_vertices");
+  GetVertexIterator ret =
+      htap_impl::IteratorPool<htap_impl::GetVertexIteratorImpl>::Allocate();
   htap_impl::GraphHandleImpl* casted_graph =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
 
@@ -47,8 +121,8 @@ GetVertexIterator get_vertices(GraphHandle graph, PartitionId partition_id,
 }
 
 void free_get_vertex_iterator(GetVertexIterator iter) {
-  htap_impl::free_get_vertex_iterator((htap_impl::GetVertexIteratorImpl*)iter);
-  free(iter);
+  htap_impl::IteratorPool<htap_impl::GetVertexIteratorImpl>::Release(
+      (htap_impl::GetVertexIteratorImpl*)iter);
 }
 
 int get_vertices_next(GetVertexIterator iter, Vertex* v_out) {
@@ -60,6 +134,7 @@ GetAllVerticesIterator get_all_vertices(GraphHandle graph,
                                         PartitionId partition_id,
                                         LabelId* labels, int labels_count,
                                         int64_t limit) {
+  HTAP_TRACE_SCOPE("get_all_vertices");
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__ << ": partition_id = " << partition_id
             << ", labels_count = " << labels_count;
@@ -68,7 +143,8 @@ GetAllVerticesIterator get_all_vertices(GraphHandle graph,
   }
 #endif
   GetAllVerticesIterator ret =
-      malloc(sizeof(htap_impl::GetAllVerticesIteratorImpl));
+      htap_impl::IteratorPool<
+          htap_impl::GetAllVerticesIteratorImpl>::Allocate();
   htap_impl::GraphHandleImpl* casted_graph =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
 
@@ -82,9 +158,8 @@ GetAllVerticesIterator get_all_vertices(GraphHandle graph,
 }
 
 void free_get_all_vertices_iterator(GetAllVerticesIterator iter) {
-  htap_impl::free_get_all_vertices_iterator(
+  htap_impl::IteratorPool<htap_impl::GetAllVerticesIteratorImpl>::Release(
       (htap_impl::GetAllVerticesIteratorImpl*)iter);
-  free(iter);
 }
 
 int get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out) {
@@ -92,6 +167,71 @@ int get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out) {
       (htap_impl::GetAllVerticesIteratorImpl*)iter, v_out);
 }
 
+GetVertexIterator scan_vertices(GraphHandle graph, PartitionId partition_id,
+                                LabelId* labels, int labels_count,
+                                struct Predicate* predicates,
+                                int predicate_count, int64_t limit) {
+  HTAP_TRACE_SCOPE("scan_vertices");
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ": partition_id = " << partition_id
+            << ", labels_count = " << labels_count
+            << ", predicate_count = " << predicate_count;
+#endif
+  htap_impl::GraphHandleImpl* handle =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  PartitionId fid = partition_id / handle->channel_num;
+  PartitionId channel_id = partition_id % handle->channel_num;
+
+  std::vector<LabelId> scan_labels;
+  if (labels_count == 0 || labels == NULL) {
+    for (LabelId label = 0; label < handle->vertex_label_num; ++label) {
+      scan_labels.push_back(label);
+    }
+  } else {
+    for (int i = 0; i < labels_count; ++i) {
+      if (labels[i] >= 0 && labels[i] < handle->vertex_label_num) {
+        scan_labels.push_back(labels[i]);
+      }
+    }
+  }
+
+  std::vector<htap_impl::VID_TYPE> ids;
+  std::vector<Predicate> transformed(predicates, predicates + predicate_count);
+  for (LabelId label : scan_labels) {
+    // the vertices of a label without some property of the predicates are
+    // skipped as a whole
+    bool has_properties = true;
+    for (int k = 0; k < predicate_count; ++k) {
+      transformed[k].id = handle->schema->VertexEntries()[label]
+                              .reverse_mapping[predicates[k].id];
+      if (transformed[k].id == -1) {
+        has_properties = false;
+        break;
+      }
+    }
+    if (has_properties) {
+      htap_impl::scan_vertices(&(handle->fragments[fid]), channel_id,
+                               handle->vertex_chunk_sizes[fid][label], label,
+                               transformed.data(), predicate_count, limit, ids);
+    }
+  }
+
+  GetVertexIterator ret =
+      htap_impl::IteratorPool<htap_impl::GetVertexIteratorImpl>::Allocate();
+  htap_impl::set_vertices(ids, (htap_impl::GetVertexIteratorImpl*)ret);
+  return ret;
+}
+
+int64_t get_vertex_count(GraphHandle graph, PartitionId partition_id,
+                         LabelId* labels, int labels_count) {
+  htap_impl::GraphHandleImpl* handle =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  PartitionId fid = partition_id / handle->channel_num;
+  return htap_impl::get_vertex_count(
+      &(handle->fragments[fid]), partition_id % handle->channel_num,
+      handle->vertex_chunk_sizes[fid], labels, labels_count);
+}
+
 VertexId get_vertex_id(GraphHandle graph, Vertex v) { return (VertexId)v; }
 
 OuterId get_outer_id(GraphHandle graph, Vertex v) {
@@ -113,6 +253,7 @@ LabelId get_vertex_label(GraphHandle graph, Vertex v) {
 
 int get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
                         Property* p_out) {
+  HTAP_TRACE_SCOPE("get_vertex_property");
   htap_impl::GraphHandleImpl* handle =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
   int partition_id = handle->vid_parser.GetFid((htap_impl::VID_TYPE)v);
@@ -133,7 +274,8 @@ int get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
 }
 
 PropertiesIterator get_vertex_properties(GraphHandle graph, Vertex v) {
-  PropertiesIterator ret = malloc(sizeof(htap_impl::PropertiesIteratorImpl));
+  PropertiesIterator ret =
+      htap_impl::IteratorPool<htap_impl::PropertiesIteratorImpl>::Allocate();
   htap_impl::GraphHandleImpl* handle =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
   ((htap_impl::PropertiesIteratorImpl*)ret)->handle = handle;
@@ -143,9 +285,45 @@ PropertiesIterator get_vertex_properties(GraphHandle graph, Vertex v) {
   return ret;
 }
 
+int get_vertices_property(GraphHandle graph, Vertex* vertices, int count,
+                          PropertyId id, enum PropertyType type, void* out,
+                          uint8_t* validity) {
+  HTAP_TRACE_SCOPE("get_vertices_property");
+  htap_impl::GraphHandleImpl* handle =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  memset(validity, 0, (count + 7) / 8);
+  int valid_count = 0;
+  // the vertices of the same partition and label are read from the column
+  // together
+  int begin = 0;
+  while (begin < count) {
+    auto vid = (htap_impl::VID_TYPE)vertices[begin];
+    int partition_id = handle->vid_parser.GetFid(vid);
+    LabelId label_id = handle->vid_parser.GetLabelId(vid);
+    int end = begin + 1;
+    while (end < count &&
+           handle->vid_parser.GetFid((htap_impl::VID_TYPE)vertices[end]) ==
+               static_cast<htap_impl::FRAG_ID_TYPE>(partition_id) &&
+           handle->vid_parser.GetLabelId(
+               (htap_impl::VID_TYPE)vertices[end]) == label_id) {
+      ++end;
+    }
+    PropertyId transformed_id =
+        handle->schema->VertexEntries()[label_id].reverse_mapping[id];
+    if (transformed_id != -1) {
+      valid_count += htap_impl::get_vertices_property(
+          &(handle->fragments[partition_id]), label_id, vertices, begin, end,
+          transformed_id, type, out, validity);
+    }
+    begin = end;
+  }
+  return valid_count;
+}
+
 OutEdgeIterator get_out_edges(GraphHandle graph, PartitionId partition_id,
                               VertexId src_id, LabelId* labels,
                               int labels_count, int64_t limit) {
+  HTAP_TRACE_SCOPE("get_out_edges");
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
   LOG(INFO) << "label count " << labels_count;
@@ -156,7 +334,8 @@ OutEdgeIterator get_out_edges(GraphHandle graph, PartitionId partition_id,
 
   htap_impl::GraphHandleImpl* casted_graph =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
-  OutEdgeIterator ret = malloc(sizeof(htap_impl::EdgeIteratorImpl));
+  OutEdgeIterator ret =
+      htap_impl::IteratorPool<htap_impl::EdgeIteratorImpl>::Allocate();
   std::vector<LabelId> transformed_labels(labels_count);
   for (int i = 0; i < labels_count; ++i) {
     transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
@@ -171,12 +350,24 @@ OutEdgeIterator get_out_edges(GraphHandle graph, PartitionId partition_id,
   return ret;
 }
 
+void build_edge_index(GraphHandle graph) {
+  htap_impl::build_edge_index((htap_impl::GraphHandleImpl*)graph);
+}
+
+int get_edge_by_id(GraphHandle graph, EdgeId internal_id, struct Edge* e_out) {
+  HTAP_TRACE_SCOPE("get_edge_by_id");
+  return htap_impl::get_edge_by_id((htap_impl::GraphHandleImpl*)graph,
+                                   (htap_impl::EID_TYPE)internal_id, e_out)
+             ? 0
+             : -1;
+}
+
 void free_out_edge_iterator(OutEdgeIterator iter) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  htap_impl::free_edge_iterator((htap_impl::EdgeIteratorImpl*)iter);
-  free(iter);
+  htap_impl::IteratorPool<htap_impl::EdgeIteratorImpl>::Release(
+      (htap_impl::EdgeIteratorImpl*)iter);
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
@@ -189,15 +380,149 @@ int out_edge_next(OutEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::out_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out,
+                        int capacity) {
+  HTAP_TRACE_SCOPE("out_edge_next_batch");
+  int count = htap_impl::out_edge_next_batch(
+      (htap_impl::EdgeIteratorImpl*)iter, e_out, capacity);
+  HTAP_TRACE_BYTES(count * sizeof(struct Edge));
+  return count;
+}
+
+int out_edge_next_columns(OutEdgeIterator iter, VertexId* dst_ids,
+                          EdgeId* edge_ids, int capacity) {
+  HTAP_TRACE_SCOPE("out_edge_next_columns");
+  int count = htap_impl::out_edge_next_columns(
+      (htap_impl::EdgeIteratorImpl*)iter, dst_ids, edge_ids, capacity);
+  HTAP_TRACE_BYTES(count * (sizeof(VertexId) + sizeof(EdgeId)));
+  return count;
+}
+
+struct EdgeList* get_out_edges_multi(GraphHandle graph,
+                                     PartitionId partition_id,
+                                     VertexId* src_ids, int src_ids_count,
+                                     LabelId* labels, int labels_count,
+                                     int64_t limit) {
+  HTAP_TRACE_SCOPE("get_out_edges_multi");
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  struct EdgeList* ret =
+      static_cast<struct EdgeList*>(malloc(sizeof(struct EdgeList)));
+  std::vector<LabelId> transformed_labels(labels_count);
+  for (int i = 0; i < labels_count; ++i) {
+    transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
+  }
+  htap_impl::get_edges_multi(
+      &(casted_graph->fragments[partition_id / casted_graph->channel_num]),
+      &(casted_graph->eid_parser), src_ids, src_ids_count,
+      transformed_labels.data(), labels_count, limit, true, ret);
+  HTAP_TRACE_BYTES(ret->offsets[ret->count] *
+                   (sizeof(VertexId) + sizeof(EdgeId)));
+  return ret;
+}
+
+struct EdgeList* get_in_edges_multi(GraphHandle graph, PartitionId partition_id,
+                                    VertexId* dst_ids, int dst_ids_count,
+                                    LabelId* labels, int labels_count,
+                                    int64_t limit) {
+  HTAP_TRACE_SCOPE("get_in_edges_multi");
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  struct EdgeList* ret =
+      static_cast<struct EdgeList*>(malloc(sizeof(struct EdgeList)));
+  std::vector<LabelId> transformed_labels(labels_count);
+  for (int i = 0; i < labels_count; ++i) {
+    transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
+  }
+  htap_impl::get_edges_multi(
+      &(casted_graph->fragments[partition_id / casted_graph->channel_num]),
+      &(casted_graph->eid_parser), dst_ids, dst_ids_count,
+      transformed_labels.data(), labels_count, limit, false, ret);
+  HTAP_TRACE_BYTES(ret->offsets[ret->count] *
+                   (sizeof(VertexId) + sizeof(EdgeId)));
+  return ret;
+}
+
+void free_edge_list(struct EdgeList* edges) {
+  htap_impl::free_edge_list(edges);
+  free(edges);
+}
+
+static void get_degrees(GraphHandle graph, PartitionId partition_id,
+                        VertexId* ids, int count, LabelId* labels,
+                        int labels_count, bool outgoing,
+                        int64_t* degrees_out) {
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  std::vector<LabelId> transformed_labels(labels_count);
+  for (int i = 0; i < labels_count; ++i) {
+    transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
+  }
+  htap_impl::get_degrees(
+      &(casted_graph->fragments[partition_id / casted_graph->channel_num]),
+      ids, count, transformed_labels.data(), labels_count, outgoing,
+      degrees_out);
+}
+
+int64_t get_out_degree(GraphHandle graph, PartitionId partition_id,
+                       VertexId src_id, LabelId* labels, int labels_count) {
+  int64_t degree = 0;
+  get_degrees(graph, partition_id, &src_id, 1, labels, labels_count, true,
+              &degree);
+  return degree;
+}
+
+int64_t get_in_degree(GraphHandle graph, PartitionId partition_id,
+                      VertexId dst_id, LabelId* labels, int labels_count) {
+  int64_t degree = 0;
+  get_degrees(graph, partition_id, &dst_id, 1, labels, labels_count, false,
+              &degree);
+  return degree;
+}
+
+void get_out_degrees(GraphHandle graph, PartitionId partition_id,
+                     VertexId* src_ids, int count, LabelId* labels,
+                     int labels_count, int64_t* degrees_out) {
+  HTAP_TRACE_SCOPE("get_out_degrees");
+  get_degrees(graph, partition_id, src_ids, count, labels, labels_count, true,
+              degrees_out);
+}
+
+void get_in_degrees(GraphHandle graph, PartitionId partition_id,
+                    VertexId* dst_ids, int count, LabelId* labels,
+                    int labels_count, int64_t* degrees_out) {
+  HTAP_TRACE_SCOPE("get_in_degrees");
+  get_degrees(graph, partition_id, dst_ids, count, labels, labels_count, false,
+              degrees_out);
+}
+
+int64_t get_edge_count(GraphHandle graph, PartitionId partition_id,
+                       LabelId* labels, int labels_count) {
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  PartitionId fid = partition_id / casted_graph->channel_num;
+  std::vector<LabelId> transformed_labels(labels_count);
+  for (int i = 0; i < labels_count; ++i) {
+    transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
+  }
+  return htap_impl::get_edge_count(
+      &(casted_graph->fragments[fid]),
+      partition_id % casted_graph->channel_num,
+      casted_graph->vertex_chunk_sizes[fid], transformed_labels.data(),
+      labels_count);
+}
+
 InEdgeIterator get_in_edges(GraphHandle graph, PartitionId partition_id,
                             VertexId dst_id, LabelId* labels, int labels_count,
                             int64_t limit) {
+  HTAP_TRACE_SCOPE("get_in_edges");
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
   htap_impl::GraphHandleImpl* casted_graph =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
-  InEdgeIterator ret = malloc(sizeof(htap_impl::EdgeIteratorImpl));
+  InEdgeIterator ret =
+      htap_impl::IteratorPool<htap_impl::EdgeIteratorImpl>::Allocate();
   PartitionId dst_partition_id = get_partition_id(graph, dst_id);
   if (dst_partition_id != partition_id) {
     htap_impl::empty_edge_iterator((htap_impl::EdgeIteratorImpl*)ret);
@@ -221,8 +546,8 @@ void free_in_edge_iterator(InEdgeIterator iter) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  htap_impl::free_edge_iterator((htap_impl::EdgeIteratorImpl*)iter);
-  free(iter);
+  htap_impl::IteratorPool<htap_impl::EdgeIteratorImpl>::Release(
+      (htap_impl::EdgeIteratorImpl*)iter);
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
@@ -235,15 +560,80 @@ int in_edge_next(InEdgeIterator iter, struct Edge* e_out) {
   return htap_impl::in_edge_next((htap_impl::EdgeIteratorImpl*)iter, e_out);
 }
 
+int in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int capacity) {
+  HTAP_TRACE_SCOPE("in_edge_next_batch");
+  int count = htap_impl::in_edge_next_batch(
+      (htap_impl::EdgeIteratorImpl*)iter, e_out, capacity);
+  HTAP_TRACE_BYTES(count * sizeof(struct Edge));
+  return count;
+}
+
+int in_edge_next_columns(InEdgeIterator iter, VertexId* src_ids,
+                         EdgeId* edge_ids, int capacity) {
+  HTAP_TRACE_SCOPE("in_edge_next_columns");
+  int count = htap_impl::in_edge_next_columns(
+      (htap_impl::EdgeIteratorImpl*)iter, src_ids, edge_ids, capacity);
+  HTAP_TRACE_BYTES(count * (sizeof(VertexId) + sizeof(EdgeId)));
+  return count;
+}
+
+MorselScan create_morsel_scan(GraphHandle graph, PartitionId partition_id,
+                              LabelId* labels, int labels_count,
+                              int64_t morsel_size) {
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  htap_impl::MorselScanImpl* scan = new htap_impl::MorselScanImpl();
+  htap_impl::init_morsel_scan(
+      &(casted_graph->fragments[partition_id / casted_graph->channel_num]),
+      labels, labels_count, morsel_size, scan);
+  return scan;
+}
+
+void free_morsel_scan(MorselScan scan) {
+  delete static_cast<htap_impl::MorselScanImpl*>(scan);
+}
+
+GetAllVerticesIterator get_morsel_vertices(GraphHandle graph,
+                                           MorselScan scan) {
+  HTAP_TRACE_SCOPE("get_morsel_vertices");
+  GetAllVerticesIterator ret =
+      htap_impl::IteratorPool<
+          htap_impl::GetAllVerticesIteratorImpl>::Allocate();
+  htap_impl::get_morsel_vertices(
+      static_cast<htap_impl::MorselScanImpl*>(scan),
+      (htap_impl::GetAllVerticesIteratorImpl*)ret);
+  return ret;
+}
+
+GetAllEdgesIterator get_morsel_edges(GraphHandle graph, MorselScan scan,
+                                     LabelId* labels, int labels_count) {
+  HTAP_TRACE_SCOPE("get_morsel_edges");
+  htap_impl::GraphHandleImpl* casted_graph =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  GetAllEdgesIterator ret =
+      htap_impl::IteratorPool<htap_impl::GetAllEdgesIteratorImpl>::Allocate();
+  std::vector<LabelId> transformed_labels(labels_count);
+  for (int i = 0; i < labels_count; ++i) {
+    transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
+  }
+  htap_impl::get_morsel_edges(static_cast<htap_impl::MorselScanImpl*>(scan),
+                              &(casted_graph->eid_parser),
+                              transformed_labels.data(), labels_count,
+                              (htap_impl::GetAllEdgesIteratorImpl*)ret);
+  return ret;
+}
+
 GetAllEdgesIterator get_all_edges(GraphHandle graph, PartitionId partition_id,
                                   LabelId* labels, int labels_count,
                                   int64_t limit) {
+  HTAP_TRACE_SCOPE("get_all_edges");
 #ifndef NDEBUG
   LOG(INFO) << "enter get all edges";
 #endif
   htap_impl::GraphHandleImpl* casted_graph =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
-  GetAllEdgesIterator ret = malloc(sizeof(htap_impl::GetAllEdgesIteratorImpl));
+  GetAllEdgesIterator ret =
+      htap_impl::IteratorPool<htap_impl::GetAllEdgesIteratorImpl>::Allocate();
   std::vector<LabelId> transformed_labels(labels_count);
   for (int i = 0; i < labels_count; ++i) {
     transformed_labels[i] = labels[i] - casted_graph->vertex_label_num;
@@ -264,9 +654,8 @@ void free_get_all_edges_iterator(GetAllEdgesIterator iter) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  htap_impl::free_get_all_edges_iterator(
+  htap_impl::IteratorPool<htap_impl::GetAllEdgesIteratorImpl>::Release(
       (htap_impl::GetAllEdgesIteratorImpl*)iter);
-  free(iter);
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
@@ -280,6 +669,15 @@ int get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out) {
       (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out);
 }
 
+int get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                             int capacity) {
+  HTAP_TRACE_SCOPE("get_all_edges_next_batch");
+  int count = htap_impl::get_all_edges_next_batch(
+      (htap_impl::GetAllEdgesIteratorImpl*)iter, e_out, capacity);
+  HTAP_TRACE_BYTES(count * sizeof(struct Edge));
+  return count;
+}
+
 VertexId get_edge_src_id(GraphHandle graph, struct Edge* e) { return e->src; }
 
 VertexId get_edge_dst_id(GraphHandle graph, struct Edge* e) { return e->dst; }
@@ -343,6 +741,7 @@ LabelId get_edge_label(GraphHandle graph, struct Edge* e) {
 
 int get_edge_property(GraphHandle graph, struct Edge* e, PropertyId id,
                       Property* p_out) {
+  HTAP_TRACE_SCOPE("get_edge_property");
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
@@ -378,7 +777,8 @@ PropertiesIterator get_edge_properties(GraphHandle graph, struct Edge* e) {
   int64_t offset;
   parse_edge_id(graph, (htap_impl::EID_TYPE)e->offset, &partition_id, &label,
                 &offset);
-  PropertiesIterator ret = malloc(sizeof(htap_impl::PropertiesIteratorImpl));
+  PropertiesIterator ret =
+      htap_impl::IteratorPool<htap_impl::PropertiesIteratorImpl>::Allocate();
   htap_impl::GraphHandleImpl* handle =
       static_cast<htap_impl::GraphHandleImpl*>(graph);
   ((htap_impl::PropertiesIteratorImpl*)ret)->handle = handle;
@@ -391,6 +791,52 @@ PropertiesIterator get_edge_properties(GraphHandle graph, struct Edge* e) {
   return ret;
 }
 
+int get_edges_property(GraphHandle graph, struct Edge* edges, int count,
+                       PropertyId id, enum PropertyType type, void* out,
+                       uint8_t* validity) {
+  HTAP_TRACE_SCOPE("get_edges_property");
+  htap_impl::GraphHandleImpl* handle =
+      static_cast<htap_impl::GraphHandleImpl*>(graph);
+  memset(validity, 0, (count + 7) / 8);
+  int valid_count = 0;
+  std::vector<int64_t> offsets;
+  std::vector<int> positions;
+  // the edges of the same partition and label are read from the column
+  // together
+  int begin = 0;
+  while (begin < count) {
+    htap_impl::FRAG_ID_TYPE partition_id, cur_partition_id;
+    LabelId label, cur_label;
+    int64_t offset;
+    parse_edge_id(graph, (htap_impl::EID_TYPE)edges[begin].offset,
+                  &partition_id, &label, &offset);
+    offsets.clear();
+    positions.clear();
+    offsets.push_back(offset);
+    positions.push_back(begin);
+    int end = begin + 1;
+    for (; end < count; ++end) {
+      parse_edge_id(graph, (htap_impl::EID_TYPE)edges[end].offset,
+                    &cur_partition_id, &cur_label, &offset);
+      if (cur_partition_id != partition_id || cur_label != label) {
+        break;
+      }
+      offsets.push_back(offset);
+      positions.push_back(end);
+    }
+    PropertyId transformed_id =
+        handle->schema->EdgeEntries()[label].reverse_mapping[id];
+    if (transformed_id != -1) {
+      valid_count += htap_impl::get_edges_property(
+          &(handle->fragments[partition_id]), label, offsets.data(),
+          positions.data(), static_cast<int>(offsets.size()), transformed_id,
+          type, out, validity);
+    }
+    begin = end;
+  }
+  return valid_count;
+}
+
 int properties_next(PropertiesIterator iter, Property* p_out) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
@@ -416,8 +862,8 @@ void free_properties_iterator(PropertiesIterator iter) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  htap_impl::free_properties_iterator((htap_impl::PropertiesIteratorImpl*)iter);
-  free(iter);
+  htap_impl::IteratorPool<htap_impl::PropertiesIteratorImpl>::Release(
+      (htap_impl::PropertiesIteratorImpl*)iter);
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
@@ -529,17 +975,10 @@ int get_vertex_id_from_primary_key(GraphHandle graph, LabelId label_id,
   LOG(INFO) << "query on primary key: label_id = " << label_id
             << ", key = " << key;
 #endif
-  if (label_id < 0) {
-     return -1;
-  }
-  auto handle = ((htap_impl::GraphHandleImpl*)graph);
-  htap_impl::OID_TYPE oid = std::stoll(key);
-  htap_impl::VID_TYPE gid;
-  if (handle->vertex_map->GetGid(label_id, oid, gid)) {
-    *internal_id = gid;
-    *partition_id = get_partition_id(graph, gid);
-#ifndef NDEBUG
-    LOG(INFO) << "vertex found: gid = " << gid
+  if (get_vertex_ids_from_primary_keys(graph, label_id, &key, 1, internal_id,
+                                       partition_id) == 1) {
+#ifndef NDEBUG
+    LOG(INFO) << "vertex found: gid = " << (*internal_id)
               << ", partition_id = " << (*partition_id);
 #endif
     return 0;
@@ -551,6 +990,58 @@ int get_vertex_id_from_primary_key(GraphHandle graph, LabelId label_id,
   }
 }
 
+// the partitions of the found vertices, or -1 for the keys not found
+static int set_found_vertices(GraphHandle graph, int count,
+                              const htap_impl::VID_TYPE* gids,
+                              const uint8_t* found, VertexId* internal_ids,
+                              PartitionId* partition_ids) {
+  int found_count = 0;
+  for (int i = 0; i < count; ++i) {
+    if (found[i]) {
+      internal_ids[i] = gids[i];
+      partition_ids[i] = get_partition_id(graph, gids[i]);
+      ++found_count;
+    } else {
+      partition_ids[i] = -1;
+    }
+  }
+  return found_count;
+}
+
+int get_vertex_ids_from_primary_keys(GraphHandle graph, LabelId label_id,
+                                     const char** keys, int count,
+                                     VertexId* internal_ids,
+                                     PartitionId* partition_ids) {
+  HTAP_TRACE_SCOPE("get_vertex_ids_from_primary_keys");
+  auto handle = static_cast<htap_impl::GraphHandleImpl*>(graph);
+  std::vector<htap_impl::VID_TYPE> gids(count);
+  std::vector<uint8_t> found(count);
+  htap_impl::get_vertices_by_oids(handle, label_id, keys, count, gids.data(),
+                                  found.data());
+  return set_found_vertices(graph, count, gids.data(), found.data(),
+                            internal_ids, partition_ids);
+}
+
+int get_vertex_ids_from_property(GraphHandle graph, LabelId label_id,
+                                 PropertyId property_id, const char** keys,
+                                 int count, VertexId* internal_ids,
+                                 PartitionId* partition_ids) {
+  HTAP_TRACE_SCOPE("get_vertex_ids_from_property");
+  auto handle = static_cast<htap_impl::GraphHandleImpl*>(graph);
+  for (int i = 0; i < handle->property_index_num; ++i) {
+    const htap_impl::PropertyIndexImpl* index = &handle->property_indices[i];
+    if (index->label == label_id && index->id == property_id) {
+      std::vector<htap_impl::VID_TYPE> gids(count);
+      std::vector<uint8_t> found(count);
+      htap_impl::get_vertices_by_index(index, keys, count, gids.data(),
+                                       found.data());
+      return set_found_vertices(graph, count, gids.data(), found.data(),
+                                internal_ids, partition_ids);
+    }
+  }
+  return -1;
+}
+
 void get_process_partition_list(GraphHandle graph, PartitionId** partition_ids,
                                 int* partition_id_size) {
 #ifndef NDEBUG
@@ -581,6 +1072,17 @@ void get_process_partition_list(GraphHandle graph, PartitionId** partition_ids,
 
 void free_partition_list(PartitionId* partition_ids) { free(partition_ids); }
 
+char* get_trace_stats() {
+  std::string stats = htap_impl::dump_trace_counters();
+  char* ret = static_cast<char*>(malloc(stats.size() + 1));
+  memcpy(ret, stats.c_str(), stats.size() + 1);
+  return ret;
+}
+
+void reset_trace_stats() { htap_impl::reset_trace_counters(); }
+
+void free_trace_stats(char* stats) { free(stats); }
+
 #ifdef __cplusplus
 }
 #endif
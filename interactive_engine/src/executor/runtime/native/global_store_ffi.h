@@ -34,6 +34,7 @@ typedef void* InEdgeIterator;
 typedef void* GetVertexIterator;
 typedef void* GetAllVerticesIterator;
 typedef void* GetAllEdgesIterator;
+typedef void* MorselScan;
 typedef void* PropertiesIterator;
 typedef void* Schema;
 
@@ -65,6 +66,37 @@ enum PropertyType {
   STRING_LIST = 14,
 };
 
+// 多个点的邻边，以CSR形式存储
+// 第i个点的邻边为[offsets[i], offsets[i + 1])，对应的邻点id和边id分别在nbr_ids和edge_ids中
+struct EdgeList {
+  int64_t* offsets;
+  VertexId* nbr_ids;
+  EdgeId* edge_ids;
+  int count;
+};
+
+// 谓词的比较方式，BETWEEN表示values[0] <= x <= values[1]，WITHIN表示x属于values中的某个值
+enum CompareOp {
+  EQ = 0,
+  NE = 1,
+  LT = 2,
+  LE = 3,
+  GT = 4,
+  GE = 5,
+  BETWEEN = 6,
+  WITHIN = 7,
+};
+
+// 属性上的谓词，values是类型为type的常量数组，value_count为其长度
+// EQ到GE只使用values[0]，type只支持BOOL到DOUBLE的定长类型
+struct Predicate {
+  PropertyId id;
+  enum CompareOp op;
+  enum PropertyType type;
+  const void* values;
+  int value_count;
+};
+
 struct Property {
   int id;
   enum PropertyType type;
@@ -77,9 +109,38 @@ struct Property {
 // 获取图存储的句柄
 GraphHandle get_graph_handle(ObjectId object_id, PartitionId channel_num);
 
+// 获取图存储的句柄，同时为一些唯一属性建立hash索引，第i个索引建立在labels[i]的点的property_ids[i]属性上
+// 索引由多个线程并行建立，只支持整数和字符串类型的属性，只包含本地partition的点
+// 重复的属性值只保留第一个点
+GraphHandle get_graph_handle_with_indices(ObjectId object_id,
+                                         PartitionId channel_num,
+                                         LabelId* labels,
+                                         PropertyId* property_ids,
+                                         int index_count);
+
 // 释放图存储的句柄，清理内存空间等
 void free_graph_handle(GraphHandle handle);
 
+// 将不常用的点属性列放到dir目录下的文件中，通过mmap读取，第i列为labels[i]的点的property_ids[i]属性
+// 本地partition的列在第一次调用时写入文件，同一台机器上的其他进程直接mmap已有的文件
+// 通过属性接口读取这些属性的方式不变，返回值是mmap的列的个数
+int set_cold_properties(GraphHandle graph, LabelId* labels,
+                        PropertyId* property_ids, int count, const char* dir);
+
+// 将全局tensor（如分析引擎的context结果）作为label的点的虚拟属性name，不需要重新seal图
+// tensor每个partition一块，按该partition中label的内部点的顺序排列，再次添加同名属性会替换其值
+// 返回属性的id，tensor与label不匹配时返回-1，会修改schema，不能与查询并发调用
+PropertyId add_virtual_vertex_property(GraphHandle graph, LabelId label,
+                                       const char* name, ObjectId tensor_id);
+
+// 获取进程内共享的图存储的句柄，同一个object_id和channel_num只会构造一次
+// 句柄带引用计数，必须通过release_graph_handle释放，不能调用free_graph_handle
+GraphHandle get_shared_graph_handle(ObjectId object_id,
+                                    PartitionId channel_num);
+
+// 释放get_shared_graph_handle获取的句柄，最后一个使用者释放时清理内存空间
+void release_graph_handle(GraphHandle handle);
+
 // ----------------- vertex api -------------------- //
 
 // 查询某个partition内的点数据
@@ -114,6 +175,20 @@ void free_get_all_vertices_iterator(GetAllVerticesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Vertex
 int get_all_vertices_next(GetAllVerticesIterator iter, Vertex* v_out);
 
+// 查询某个partition内部的所有相关label的点，只返回满足所有谓词的点，谓词在存储内按列求值
+// predicates是谓词列表，predicate_count表示其长度，其余参数的含义同get_all_vertices
+// 没有谓词中的属性、属性为null或类型不符的点不满足谓词
+// 返回值是一个迭代器，用get_vertices_next取出元素，用free_get_vertex_iterator释放
+GetVertexIterator scan_vertices(GraphHandle graph, PartitionId partition_id,
+                                LabelId* labels, int labels_count,
+                                struct Predicate* predicates,
+                                int predicate_count, int64_t limit);
+
+// 查询某个partition内部的所有相关label的点数，即get_all_vertices返回的点数（不考虑limit）
+// 注意：如果label_count为0或者labels为null，则查询所有label
+int64_t get_vertex_count(GraphHandle graph, PartitionId partition_id,
+                         LabelId* labels, int labels_count);
+
 // 获取点id
 VertexId get_vertex_id(GraphHandle graph, Vertex v);
 
@@ -131,6 +206,16 @@ int get_vertex_property(GraphHandle graph, Vertex v, PropertyId id,
 // 获取点的属性列表，返回一个迭代器
 PropertiesIterator get_vertex_properties(GraphHandle graph, Vertex v);
 
+// 批量获取多个点的同一个属性，按列读取
+// vertices是点列表，count为其长度，type是属性的类型，只支持BOOL到DOUBLE的定长类型
+// out是长度为count的数组，元素类型依次为bool、int8_t、int16_t、int32_t、int64_t、float、double
+// validity是长度为(count + 7) / 8的位图，第i位为1表示out[i]有效
+// 点不存在、没有该属性、属性为null或类型不符时对应的位为0
+// 返回值是有效的属性个数
+int get_vertices_property(GraphHandle graph, Vertex* vertices, int count,
+                          PropertyId id, enum PropertyType type, void* out,
+                          uint8_t* validity);
+
 // ----------------- edge api -------------------- //
 
 // 查询某个partition内的点的出边
@@ -142,12 +227,38 @@ OutEdgeIterator get_out_edges(GraphHandle graph, PartitionId partition_id,
                               VertexId src_id, LabelId* labels,
                               int labels_count, int64_t limit);
 
+// 为本地partition的边建立从边id到起点和终点的索引，多个线程并行建立，只需调用一次
+void build_edge_index(GraphHandle graph);
+
+// 通过build_edge_index建立的索引，由边的内部id（即Edge中的offset）取出这条边
+// 如果没有建立索引或者这条边不在本地partition，返回-1，否则返回0
+int get_edge_by_id(GraphHandle graph, EdgeId internal_id, struct Edge* e_out);
+
 // 释放迭代器
 void free_out_edge_iterator(OutEdgeIterator iter);
 
 // 从迭代器取出下一个元素，返回值是一个Edge
 int out_edge_next(OutEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多capacity个元素，写入e_out数组
+// 返回值是取出的边数，返回0表示迭代结束
+int out_edge_next_batch(OutEdgeIterator iter, struct Edge* e_out, int capacity);
+
+// 从迭代器批量取出至多capacity个元素，终点id和边id分别写入dst_ids和edge_ids数组
+// 返回值是取出的边数，返回0表示迭代结束
+int out_edge_next_columns(OutEdgeIterator iter, VertexId* dst_ids,
+                          EdgeId* edge_ids, int capacity);
+
+// 批量查询某个partition内的多个点的出边，返回值是CSR形式的EdgeList
+// src_ids是待查询的点id列表，src_ids_count表示其长度
+// labels和labels_count的含义同get_out_edges，limit表示每个点返回的最大结果数
+// 不在该partition内的点没有出边
+struct EdgeList* get_out_edges_multi(GraphHandle graph,
+                                     PartitionId partition_id,
+                                     VertexId* src_ids, int src_ids_count,
+                                     LabelId* labels, int labels_count,
+                                     int64_t limit);
+
 // 查询某个partition内的点的入边
 // src_ids是待查询的点id列表
 // labels是label列表，表示查询这些点的这些label的出边
@@ -164,6 +275,69 @@ void free_in_edge_iterator(InEdgeIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int in_edge_next(InEdgeIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多capacity个元素，写入e_out数组
+// 返回值是取出的边数，返回0表示迭代结束
+int in_edge_next_batch(InEdgeIterator iter, struct Edge* e_out, int capacity);
+
+// 从迭代器批量取出至多capacity个元素，起点id和边id分别写入src_ids和edge_ids数组
+// 返回值是取出的边数，返回0表示迭代结束
+int in_edge_next_columns(InEdgeIterator iter, VertexId* src_ids,
+                         EdgeId* edge_ids, int capacity);
+
+// 批量查询某个partition内的多个点的入边，返回值是CSR形式的EdgeList
+// 参数的含义同get_out_edges_multi
+struct EdgeList* get_in_edges_multi(GraphHandle graph, PartitionId partition_id,
+                                    VertexId* dst_ids, int dst_ids_count,
+                                    LabelId* labels, int labels_count,
+                                    int64_t limit);
+
+// 释放get_out_edges_multi和get_in_edges_multi返回的EdgeList
+void free_edge_list(struct EdgeList* edges);
+
+// 查询某个partition内的点的出度，只读取邻接表的大小而不遍历边
+// labels和labels_count的含义同get_out_edges，不在该partition内的点出度为0
+int64_t get_out_degree(GraphHandle graph, PartitionId partition_id,
+                       VertexId src_id, LabelId* labels, int labels_count);
+
+// 查询某个partition内的点的入度，参数的含义同get_out_degree
+int64_t get_in_degree(GraphHandle graph, PartitionId partition_id,
+                      VertexId dst_id, LabelId* labels, int labels_count);
+
+// 批量查询某个partition内的多个点的出度，写入长度为count的degrees_out数组
+void get_out_degrees(GraphHandle graph, PartitionId partition_id,
+                     VertexId* src_ids, int count, LabelId* labels,
+                     int labels_count, int64_t* degrees_out);
+
+// 批量查询某个partition内的多个点的入度，参数的含义同get_out_degrees
+void get_in_degrees(GraphHandle graph, PartitionId partition_id,
+                    VertexId* dst_ids, int count, LabelId* labels,
+                    int labels_count, int64_t* degrees_out);
+
+// 查询某个partition内某些label的边数，即get_all_edges返回的边数（不考虑limit）
+// 注意：如果label_count为0或者labels为null，则查询所有label
+int64_t get_edge_count(GraphHandle graph, PartitionId partition_id,
+                       LabelId* labels, int labels_count);
+
+// 创建某个fragment内某些label的点的共享扫描，partition_id可以是该fragment的任意一个partition
+// 点被切分为至多morsel_size个点的morsel，morsel_size不大于0时使用默认值
+// 多个线程各自从扫描获取迭代器，迭代器通过原子游标动态领取morsel，取完一个再领取下一个，
+// 因此不会因为label的大小不均而使某些线程负载过重
+// 注意：如果label_count为0或者labels为null，则扫描所有label
+MorselScan create_morsel_scan(GraphHandle graph, PartitionId partition_id,
+                              LabelId* labels, int labels_count,
+                              int64_t morsel_size);
+
+// 释放共享扫描，需要在它的所有迭代器释放之后调用
+void free_morsel_scan(MorselScan scan);
+
+// 获取共享扫描的点迭代器，用get_all_vertices_next取出元素，用free_get_all_vertices_iterator释放
+GetAllVerticesIterator get_morsel_vertices(GraphHandle graph, MorselScan scan);
+
+// 获取共享扫描的点的出边迭代器，labels是边的label列表，含义同get_all_edges
+// 用get_all_edges_next或get_all_edges_next_batch取出元素，用free_get_all_edges_iterator释放
+GetAllEdgesIterator get_morsel_edges(GraphHandle graph, MorselScan scan,
+                                     LabelId* labels, int labels_count);
+
 // 查询某个partition内某些label的边数据
 // labels是待查询的label列表
 // labels_count表示label列表的长度
@@ -180,6 +354,11 @@ void free_get_all_edges_iterator(GetAllEdgesIterator iter);
 // 从迭代器取出下一个元素，返回值是一个Edge
 int get_all_edges_next(GetAllEdgesIterator iter, struct Edge* e_out);
 
+// 从迭代器批量取出至多capacity个元素，写入e_out数组
+// 返回值是取出的边数，返回0表示迭代结束
+int get_all_edges_next_batch(GetAllEdgesIterator iter, struct Edge* e_out,
+                             int capacity);
+
 // 从edge对象获取起点id
 VertexId get_edge_src_id(GraphHandle graph, struct Edge* e);
 
@@ -205,6 +384,11 @@ int get_edge_property(GraphHandle graph, struct Edge*, PropertyId id,
 // 获取边的属性列表，返回一个迭代器
 PropertiesIterator get_edge_properties(GraphHandle graph, struct Edge*);
 
+// 批量获取多条边的同一个属性，按列读取，参数和返回值的含义同get_vertices_property
+int get_edges_property(GraphHandle graph, struct Edge* edges, int count,
+                       PropertyId id, enum PropertyType type, void* out,
+                       uint8_t* validity);
+
 // 从属性列表迭代器中取出一个属性，如果没有新的元素，则将Property对象内部的data置为nullptr
 int properties_next(PropertiesIterator iter, struct Property* p_out);
 
@@ -262,6 +446,21 @@ int get_vertex_id_from_primary_key(GraphHandle graph, LabelId label_id,
                                    const char* key, VertexId* internal_id,
                                    PartitionId* partition_id);
 
+// 批量查询primary key，keys是长度为count的\0结束的字符串列表
+// 结果存在长度为count的internal_ids和partition_ids中，不存在的key对应的partition_id为-1
+// 返回值是存在的key的个数
+int get_vertex_ids_from_primary_keys(GraphHandle graph, LabelId label_id,
+                                     const char** keys, int count,
+                                     VertexId* internal_ids,
+                                     PartitionId* partition_ids);
+
+// 通过get_graph_handle_with_indices建立的索引，批量查询唯一属性的值对应的点
+// 参数和返回值的含义同get_vertex_ids_from_primary_keys，如果该属性上没有索引，返回-1
+int get_vertex_ids_from_property(GraphHandle graph, LabelId label_id,
+                                 PropertyId property_id, const char** keys,
+                                 int count, VertexId* internal_ids,
+                                 PartitionId* partition_ids);
+
 // 返回本地的partition列表。
 //
 // 因为maxgraph已经有GraphHandler，因此不需要传worker_global_index。
@@ -276,6 +475,18 @@ void get_process_partition_list(GraphHandle graph, PartitionId** partition_ids,
 // 释放partition_ids对应的内存
 void free_partition_list(PartitionId* partition_ids);
 
+// ------------------ trace api ------------- //
+
+// 返回各个FFI函数的调用次数、采样的延迟直方图和返回的字节数，格式为JSON数组
+// 只有以-DHTAP_TRACE编译时才会统计，否则返回空数组，结果需要调用free_trace_stats释放
+char* get_trace_stats();
+
+// 清零所有的统计
+void reset_trace_stats();
+
+// 释放get_trace_stats返回的字符串
+void free_trace_stats(char* stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
  */
 #include "graph_builder_ffi.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <map>
@@ -204,6 +205,26 @@ void add_edges(GraphBuilder builder, size_t edge_size, EdgeId *edgeids,
                              properties);
 }
 
+void add_vertices_columnar(GraphBuilder builder, LabelId labelid,
+                           size_t vertex_size, VertexId *ids,
+                           size_t column_size, PropertyColumn *columns) {
+  auto stream =
+      static_cast<std::shared_ptr<vineyard::PropertyGraphOutStream> *>(builder);
+  return (*stream)->AddVerticesColumnar(labelid, vertex_size, ids,
+                                        column_size, columns);
+}
+
+void add_edges_columnar(GraphBuilder builder, LabelId label,
+                        LabelId src_label, LabelId dst_label,
+                        size_t edge_size, VertexId *src_ids,
+                        VertexId *dst_ids, size_t column_size,
+                        PropertyColumn *columns) {
+  auto stream =
+      static_cast<std::shared_ptr<vineyard::PropertyGraphOutStream> *>(builder);
+  return (*stream)->AddEdgesColumnar(label, src_label, dst_label, edge_size,
+                                     src_ids, dst_ids, column_size, columns);
+}
+
 void build(GraphBuilder builder) {
   auto stream =
       static_cast<std::shared_ptr<vineyard::PropertyGraphOutStream> *>(builder);
@@ -313,6 +334,32 @@ void free_string(char *s) {
   free(s);
 }
 
+int get_property_types(Schema schema, int *label_num, int *property_num,
+                       PropertyType **types) {
+  auto ptr = static_cast<vineyard::MGPropertyGraphSchema *>(schema);
+  if (!ptr->indexed()) {
+    ptr->BuildIndex();
+  }
+  auto const &property_types = ptr->PropertyTypes();
+  *label_num = static_cast<int>(ptr->label_num());
+  *property_num = static_cast<int>(ptr->property_num());
+  size_t type_num = std::max<size_t>(property_types.size(), 1);
+  *types =
+      static_cast<PropertyType *>(malloc(sizeof(PropertyType) * type_num));
+  for (size_t i = 0; i < property_types.size(); ++i) {
+    (*types)[i] = property_types[i]->Equals(arrow::null())
+                      ? INVALID
+                      : vineyard::detail::PropertyTypeFromDataType(
+                            property_types[i]);
+  }
+#ifndef NDEBUG
+  LOG(INFO) << "get property types: " << *label_num << " x " << *property_num;
+#endif
+  return 0;
+}
+
+void free_property_types(PropertyType *types) { free(types); }
+
 Schema create_schema_builder() { return new vineyard::MGPropertyGraphSchema(); }
 
 VertexTypeBuilder build_vertex_type(Schema schema, LabelId label,
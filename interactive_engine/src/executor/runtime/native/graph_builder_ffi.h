@@ -116,6 +116,43 @@ void add_edges(GraphBuilder builder, size_t edge_size, EdgeId* edgeids,
                LabelId* src_labels, LabelId* dst_labels, size_t* property_sizes,
                Property* properties);
 
+/**
+ * 按列给出的一个属性，用于add_vertices_columnar和add_edges_columnar。
+ *
+ * type: 属性的类型，需要与schema中的类型一致
+ * values: BOOL到DOUBLE时为定长数组，元素类型依次为uint8_t、int8_t、int16_t、
+ *         int32_t、int64_t、float、double；STRING时为int64_t的offsets数组，
+ *         第i个值为data[offsets[i], offsets[i + 1])
+ * data: STRING的字符数据，其它类型为null
+ * valid_bytes: 每个值一个字节，0表示null；为null时所有值都有效
+ */
+struct PropertyColumn {
+  PropertyId id;
+  PropertyType type;
+  const void* values;
+  const char* data;
+  const uint8_t* valid_bytes;
+};
+
+/**
+ * 按列批量写入同一个label的点，每个属性一列，property id到列的映射每个batch只查找一次。
+ *
+ * vertex_size: 点数，也是每一列的长度
+ * columns: 该label所有属性的列，column_size为其个数
+ */
+void add_vertices_columnar(GraphBuilder builder, LabelId labelid,
+                           size_t vertex_size, VertexId* ids,
+                           size_t column_size, struct PropertyColumn* columns);
+
+/**
+ * 按列批量写入同一个(label, src_label, dst_label)的边，参数含义与add_vertices_columnar一致。
+ */
+void add_edges_columnar(GraphBuilder builder, LabelId label,
+                        LabelId src_label, LabelId dst_label,
+                        size_t edge_size, VertexId* src_ids,
+                        VertexId* dst_ids, size_t column_size,
+                        struct PropertyColumn* columns);
+
 /**
  * 结束local GraphBuilder的build，点、边写完之后分别调用
  */
@@ -158,6 +195,15 @@ int get_label_name(Schema schema, LabelId label, const char** out);
 // 释放从上述接口中获取的字符串
 void free_string(char* s);
 
+// 一次性导出所有label的所有属性的类型，(*types)[label * (*property_num) + id]
+// 为label的id属性的类型，不存在的属性为INVALID，用于避免在执行中逐个查询
+// 返回0表示成功，结果需要调用free_property_types释放
+int get_property_types(Schema schema, int* label_num, int* property_num,
+                       PropertyType** types);
+
+// 释放get_property_types获取的类型表
+void free_property_types(PropertyType* types);
+
 /********************** 创建Schema相关API **********************/
 // 创建Schema builder
 Schema create_schema_builder();
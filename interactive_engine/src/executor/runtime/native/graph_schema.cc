@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "graph_schema.h"
 
+#include <algorithm>
 #include <cctype>
 #include <fstream>
 #include <set>
@@ -97,6 +98,10 @@ PropertyType PropertyTypeFromString(const std::string& type) {
 
 MGPropertyGraphSchema::PropertyId MGPropertyGraphSchema::GetPropertyId(
     const std::string& name) {
+  if (indexed_) {
+    auto iter = property_ids_.find(name);
+    return iter == property_ids_.end() ? -1 : iter->second;
+  }
   PropertyId id;
   for (auto const& entry : vertex_entries_) {
     id = entry.GetPropertyId(name);
@@ -115,6 +120,13 @@ MGPropertyGraphSchema::PropertyId MGPropertyGraphSchema::GetPropertyId(
 
 PropertyType MGPropertyGraphSchema::GetPropertyType(LabelId label_id,
                                                   PropertyId prop_id) {
+  if (indexed_) {
+    if (label_id < 0 || static_cast<size_t>(label_id) >= label_num_ ||
+        prop_id < 0 || static_cast<size_t>(prop_id) >= property_num_) {
+      return arrow::null();
+    }
+    return property_types_[label_id * property_num_ + prop_id];
+  }
   PropertyType type;
   for (auto const& entry : vertex_entries_) {
     if (entry.id == label_id) {
@@ -136,6 +148,13 @@ PropertyType MGPropertyGraphSchema::GetPropertyType(LabelId label_id,
 }
 
 std::string MGPropertyGraphSchema::GetPropertyName(PropertyId prop_id) {
+  if (indexed_) {
+    if (prop_id < 0 ||
+        static_cast<size_t>(prop_id) >= property_names_.size()) {
+      return "";
+    }
+    return property_names_[prop_id];
+  }
   std::string name;
   for (auto const& entry : vertex_entries_) {
     name = entry.GetPropertyName(prop_id);
@@ -154,6 +173,10 @@ std::string MGPropertyGraphSchema::GetPropertyName(PropertyId prop_id) {
 
 MGPropertyGraphSchema::LabelId MGPropertyGraphSchema::GetLabelId(
     const std::string& name) {
+  if (indexed_) {
+    auto iter = label_ids_.find(name);
+    return iter == label_ids_.end() ? -1 : iter->second;
+  }
   for (auto const& entry : vertex_entries_) {
     if (entry.label == name) {
       return entry.id;
@@ -168,6 +191,12 @@ MGPropertyGraphSchema::LabelId MGPropertyGraphSchema::GetLabelId(
 }
 
 std::string MGPropertyGraphSchema::GetLabelName(LabelId label_id) {
+  if (indexed_) {
+    if (label_id < 0 || static_cast<size_t>(label_id) >= label_names_.size()) {
+      return "";
+    }
+    return label_names_[label_id];
+  }
   for (auto const& entry : vertex_entries_) {
     if (entry.id == label_id) {
       return entry.label;
@@ -183,6 +212,7 @@ std::string MGPropertyGraphSchema::GetLabelName(LabelId label_id) {
 
 MGPropertyGraphSchema::Entry* MGPropertyGraphSchema::CreateEntry(
     const std::string& type, LabelId label_id, const std::string& name) {
+  indexed_ = false;
   if (type == "VERTEX") {
     vertex_entries_.emplace_back(
         Entry{.id = label_id, .label = name, .type = type});
@@ -194,6 +224,98 @@ MGPropertyGraphSchema::Entry* MGPropertyGraphSchema::CreateEntry(
   }
 }
 
+MGPropertyGraphSchema::PropertyId MGPropertyGraphSchema::AddVertexProperty(
+    LabelId label_id, const std::string& name, PropertyType type) {
+  Entry* entry = nullptr;
+  for (auto& vertex_entry : vertex_entries_) {
+    if (vertex_entry.id == label_id) {
+      entry = &vertex_entry;
+    }
+  }
+  if (entry == nullptr || entry->GetPropertyId(name) != -1) {
+    return -1;
+  }
+  PropertyId id = GetPropertyId(name);
+  if (id == -1) {
+    // mg's prop id: starts from 1
+    unique_property_names_.push_back(name);
+    id = unique_property_names_.size();
+  }
+  PropertyId column_id = entry->mapping.size();
+  entry->AddProperty(name, type);
+  entry->props_.back().id = id;
+  entry->mapping.push_back(id);
+  // the ids are looked up in the reverse mappings of all the labels
+  for (auto& entries : {&vertex_entries_, &edge_entries_}) {
+    for (auto& other : *entries) {
+      if (other.reverse_mapping.size() <= static_cast<size_t>(id)) {
+        other.reverse_mapping.resize(id + 1, -1);
+        other.valid_properties.resize(id + 1, 1);
+      }
+    }
+  }
+  entry->reverse_mapping[id] = column_id;
+  BuildIndex();
+  return id;
+}
+
+void MGPropertyGraphSchema::SetColumnType(bool is_vertex, LabelId label_id,
+                                          PropertyId column_id,
+                                          PropertyType type) {
+  for (auto& entry : is_vertex ? vertex_entries_ : edge_entries_) {
+    if (entry.id == label_id && column_id >= 0 &&
+        static_cast<size_t>(column_id) < entry.props_.size()) {
+      entry.props_[column_id].type = type;
+    }
+  }
+  BuildIndex();
+}
+
+void MGPropertyGraphSchema::BuildIndex() {
+  label_ids_.clear();
+  property_ids_.clear();
+  label_names_.clear();
+  property_names_.clear();
+  property_types_.clear();
+  label_num_ = 0;
+  property_num_ = 0;
+  // the entries in the order of the scans of the getters
+  std::vector<const Entry*> entries;
+  for (auto const& entry : vertex_entries_) {
+    entries.push_back(&entry);
+  }
+  for (auto const& entry : edge_entries_) {
+    entries.push_back(&entry);
+  }
+  for (auto entry : entries) {
+    label_num_ = std::max(label_num_, static_cast<size_t>(entry->id + 1));
+    for (auto const& prop : entry->props_) {
+      property_num_ = std::max(property_num_, static_cast<size_t>(prop.id + 1));
+    }
+  }
+  label_names_.resize(label_num_);
+  property_names_.resize(property_num_);
+  property_types_.resize(label_num_ * property_num_, arrow::null());
+  // keeps the first of the duplicated names and ids, as the scans do
+  for (auto entry : entries) {
+    label_ids_.emplace(entry->label, entry->id);
+    if (label_names_[entry->id].empty()) {
+      label_names_[entry->id] = entry->label;
+    }
+    for (auto const& prop : entry->props_) {
+      property_ids_.emplace(prop.name, prop.id);
+      if (property_names_[prop.id].empty()) {
+        property_names_[prop.id] = prop.name;
+      }
+      auto& type = property_types_[entry->id * property_num_ + prop.id];
+      if (type->Equals(arrow::null())) {
+        type = prop.type;
+      }
+    }
+  }
+  indexed_ = true;
+}
+
 void MGPropertyGraphSchema::ToJSON(vineyard::json& root) const {
   root["partitionNum"] = fnum_;
   vineyard::json types = vineyard::json::array();
@@ -211,6 +333,7 @@ void MGPropertyGraphSchema::ToJSON(vineyard::json& root) const {
 }
 
 void MGPropertyGraphSchema::FromJSON(vineyard::json const& root) {
+  indexed_ = false;
   fnum_ = root["partitionNum"].get<size_t>();
   for (auto const& item : root["types"]) {
     Entry entry;
@@ -300,6 +423,7 @@ MGPropertyGraphSchema MGPropertyGraphSchema::TransformToMaxGraph() {
   new_schema.set_unique_property_names(unique_property_names_);
   new_schema.set_fnum(fnum_);
   new_schema.set_schema_type(SchemaType::kMaxGraph);
+  new_schema.BuildIndex();
   return new_schema;
 }
 
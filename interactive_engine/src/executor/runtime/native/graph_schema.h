@@ -62,6 +62,7 @@ class MGPropertyGraphSchema {
                      const std::string& name);
 
   void AddEntry(const Entry& entry) {
+    indexed_ = false;
     if (entry.type == "VERTEX") {
       vertex_entries_.push_back(entry);
     } else {
@@ -92,6 +93,36 @@ class MGPropertyGraphSchema {
 
   void set_schema_type(SchemaType type) { schema_type_ = type; }
 
+  // Adds the property of the name to the vertex label of a transformed
+  // schema, of which the id is the one of the name in the other labels, or a
+  // new one, and the column is after the columns of the label. Returns the id,
+  // or -1 if the label is missing or has the name already.
+  PropertyId AddVertexProperty(LabelId label_id, const std::string& name,
+                               PropertyType type);
+
+  // Sets the type of the column of the vertex or the edge label, e.g., to the
+  // type of the values of an encoded column, and builds the index again.
+  void SetColumnType(bool is_vertex, LabelId label_id, PropertyId column_id,
+                     PropertyType type);
+
+  // Builds the tables from the names to the ids, from the ids to the names,
+  // and from the label and property ids to the types, so the getters above
+  // are lookups rather than scans of the entries. The tables are dropped
+  // once an entry is added.
+  void BuildIndex();
+
+  bool indexed() const { return indexed_; }
+
+  size_t label_num() const { return label_num_; }
+
+  size_t property_num() const { return property_num_; }
+
+  // The type of the property j of the label i at i * property_num() + j, or
+  // null if the label has no such property, after BuildIndex.
+  const std::vector<PropertyType>& PropertyTypes() const {
+    return property_types_;
+  }
+
  private:
   SchemaType schema_type_ = SchemaType::kAnalytical;
   size_t fnum_;
@@ -105,6 +136,15 @@ class MGPropertyGraphSchema {
   // vector<int> for each label, stores mappings from original id to transformed
   // id.
   std::vector<std::string> unique_property_names_;
+
+  bool indexed_ = false;
+  size_t label_num_ = 0;
+  size_t property_num_ = 0;
+  std::unordered_map<std::string, LabelId> label_ids_;
+  std::unordered_map<std::string, PropertyId> property_ids_;
+  std::vector<std::string> label_names_;
+  std::vector<std::string> property_names_;
+  std::vector<PropertyType> property_types_;
 };
 
 }  // namespace vineyard
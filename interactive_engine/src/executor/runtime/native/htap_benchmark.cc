@@ -0,0 +1,282 @@
+/**
+ * Copyright 2020 Alibaba Group Holding Limited.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "global_store_ffi.h"
+
+// Measures the traversal primitives of global_store_ffi.h on a fragment group
+// loaded by vineyard_htap_loader, i.e., the vertices per second of
+// get_all_vertices_next, the edges per second of out_edge_next and
+// in_edge_next, and of their batched variants, and the latencies of the
+// property fetches, each by 1, 2, 4, ... threads up to the number of the local
+// partitions, the threads taking the partitions in turn, to isolate the
+// regressions of the store from the ones of the engine.
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int kEdgeBatchSize = 1024;
+
+double seconds_since(clock_type::time_point start) {
+  return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+struct Result {
+  std::string name;
+  int thread_num;
+  int64_t items;
+  double seconds;
+};
+
+std::vector<Result> results;
+
+// runs func(pid) for each of the partitions by thread_num threads, and
+// records the items returned per second
+void run(const std::string& name, const std::vector<PartitionId>& partitions,
+         int thread_num, const std::function<int64_t(PartitionId)>& func) {
+  std::atomic<int64_t> items(0);
+  std::vector<std::thread> threads;
+  auto start = clock_type::now();
+  for (int tid = 0; tid < thread_num; ++tid) {
+    threads.emplace_back([&, tid]() {
+      int64_t local_items = 0;
+      for (size_t i = tid; i < partitions.size(); i += thread_num) {
+        local_items += func(partitions[i]);
+      }
+      items += local_items;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds = seconds_since(start);
+  results.push_back(Result{name, thread_num, items.load(), seconds});
+  printf("%-24s threads %3d: %12ld items in %8.3fs, %14.1f per second\n",
+         name.c_str(), thread_num, static_cast<long>(items.load()), seconds,
+         seconds > 0 ? items.load() / seconds : 0.0);
+}
+
+int64_t scan_vertices(GraphHandle handle, PartitionId pid) {
+  GetAllVerticesIterator iter =
+      get_all_vertices(handle, pid, NULL, 0, INT64_MAX);
+  int64_t count = 0;
+  Vertex v;
+  while (get_all_vertices_next(iter, &v) == 0) {
+    ++count;
+  }
+  free_get_all_vertices_iterator(iter);
+  return count;
+}
+
+int64_t traverse_edges(GraphHandle handle, PartitionId pid,
+                       const std::vector<VertexId>& ids, bool out,
+                       bool batch) {
+  int64_t count = 0;
+  struct Edge e;
+  std::vector<struct Edge> edges(batch ? kEdgeBatchSize : 0);
+  for (VertexId id : ids) {
+    if (out) {
+      OutEdgeIterator iter = get_out_edges(handle, pid, id, NULL, 0, INT64_MAX);
+      if (batch) {
+        int got;
+        while ((got = out_edge_next_batch(iter, edges.data(),
+                                          kEdgeBatchSize)) > 0) {
+          count += got;
+        }
+      } else {
+        while (out_edge_next(iter, &e) == 0) {
+          ++count;
+        }
+      }
+      free_out_edge_iterator(iter);
+    } else {
+      InEdgeIterator iter = get_in_edges(handle, pid, id, NULL, 0, INT64_MAX);
+      if (batch) {
+        int got;
+        while ((got = in_edge_next_batch(iter, edges.data(), kEdgeBatchSize)) >
+               0) {
+          count += got;
+        }
+      } else {
+        while (in_edge_next(iter, &e) == 0) {
+          ++count;
+        }
+      }
+      free_in_edge_iterator(iter);
+    }
+  }
+  return count;
+}
+
+// the latency of reading all the properties of each of the sampled vertices,
+// in ns, as the items are the properties read
+void fetch_properties(GraphHandle handle, const std::vector<Vertex>& samples,
+                      int thread_num) {
+  std::vector<std::vector<double>> latencies(thread_num);
+  std::atomic<int64_t> items(0);
+  std::vector<std::thread> threads;
+  auto start = clock_type::now();
+  for (int tid = 0; tid < thread_num; ++tid) {
+    threads.emplace_back([&, tid]() {
+      struct Property property;
+      int64_t local_items = 0;
+      for (size_t i = tid; i < samples.size(); i += thread_num) {
+        auto call_start = clock_type::now();
+        PropertiesIterator iter = get_vertex_properties(handle, samples[i]);
+        while (properties_next(iter, &property) == 0) {
+          free_property(&property);
+          ++local_items;
+        }
+        free_properties_iterator(iter);
+        latencies[tid].push_back(seconds_since(call_start) * 1e9);
+      }
+      items += local_items;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds = seconds_since(start);
+  results.push_back(
+      Result{"vertex_properties", thread_num, items.load(), seconds});
+
+  std::vector<double> all;
+  for (auto& local : latencies) {
+    all.insert(all.end(), local.begin(), local.end());
+  }
+  std::sort(all.begin(), all.end());
+  auto percentile = [&all](double p) {
+    if (all.empty()) {
+      return 0.0;
+    }
+    return all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+  };
+  printf("%-24s threads %3d: %12ld properties of %zu vertices, "
+         "p50 %.0fns, p99 %.0fns, max %.0fns\n",
+         "vertex_properties", thread_num, static_cast<long>(items.load()),
+         samples.size(), percentile(0.5), percentile(0.99),
+         all.empty() ? 0.0 : all.back());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    printf(
+        "usage: ./htap_benchmark <object_id> <channel_num> [max_threads] "
+        "[property_samples]\n");
+    return -1;
+  }
+  ObjectId id = atol(argv[1]);
+  int channel_num = atoi(argv[2]);
+  int max_threads = argc > 3 ? atoi(argv[3]) : 0;
+  size_t sample_num = argc > 4 ? atol(argv[4]) : 100000;
+
+  auto start = clock_type::now();
+  GraphHandle handle = get_graph_handle(id, channel_num);
+  printf("got the graph handle in %.3fs\n", seconds_since(start));
+
+  PartitionId* partition_ids;
+  int partition_id_size;
+  get_process_partition_list(handle, &partition_ids, &partition_id_size);
+  std::vector<PartitionId> partitions(partition_ids,
+                                      partition_ids + partition_id_size);
+  free_partition_list(partition_ids);
+  if (partitions.empty()) {
+    printf("no local partition of the graph %ld\n", static_cast<long>(id));
+    free_graph_handle(handle);
+    return -1;
+  }
+  if (max_threads <= 0 || max_threads > partition_id_size) {
+    max_threads = partition_id_size;
+  }
+
+  // the inner vertices of each partition, the sources of the traversals
+  std::vector<std::vector<VertexId>> ids(partitions.size());
+  std::vector<Vertex> samples;
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    GetAllVerticesIterator iter =
+        get_all_vertices(handle, partitions[i], NULL, 0, INT64_MAX);
+    Vertex v;
+    while (get_all_vertices_next(iter, &v) == 0) {
+      ids[i].push_back(get_vertex_id(handle, v));
+      samples.push_back(v);
+    }
+    free_get_all_vertices_iterator(iter);
+  }
+  std::mt19937_64 rng(0);
+  std::shuffle(samples.begin(), samples.end(), rng);
+  samples.resize(std::min(samples.size(), sample_num));
+  auto ids_of = [&partitions, &ids](PartitionId pid) -> std::vector<VertexId>& {
+    return ids[std::find(partitions.begin(), partitions.end(), pid) -
+               partitions.begin()];
+  };
+
+  for (int thread_num = 1;;
+       thread_num = std::min(thread_num * 2, max_threads)) {
+    reset_trace_stats();
+    run("get_all_vertices_next", partitions, thread_num,
+        [handle](PartitionId pid) { return scan_vertices(handle, pid); });
+    run("out_edge_next", partitions, thread_num, [&](PartitionId pid) {
+      return traverse_edges(handle, pid, ids_of(pid), true, false);
+    });
+    run("out_edge_next_batch", partitions, thread_num, [&](PartitionId pid) {
+      return traverse_edges(handle, pid, ids_of(pid), true, true);
+    });
+    run("in_edge_next", partitions, thread_num, [&](PartitionId pid) {
+      return traverse_edges(handle, pid, ids_of(pid), false, false);
+    });
+    run("in_edge_next_batch", partitions, thread_num, [&](PartitionId pid) {
+      return traverse_edges(handle, pid, ids_of(pid), false, true);
+    });
+    fetch_properties(handle, samples, thread_num);
+    if (thread_num >= max_threads) {
+      break;
+    }
+  }
+
+  // the results as a JSON array, and the counters of the last round of the
+  // calls if built with HTAP_TRACE
+  std::ostringstream os;
+  os << "[";
+  for (size_t i = 0; i < results.size(); ++i) {
+    os << (i == 0 ? "" : ", ") << "{\"name\": \"" << results[i].name
+       << "\", \"threads\": " << results[i].thread_num
+       << ", \"items\": " << results[i].items
+       << ", \"seconds\": " << results[i].seconds << "}";
+  }
+  os << "]";
+  printf("results: %s\n", os.str().c_str());
+  char* stats = get_trace_stats();
+  printf("trace stats: %s\n", stats);
+  free_trace_stats(stats);
+
+  free_graph_handle(handle);
+  return 0;
+}
@@ -15,16 +15,37 @@
  */
 #include "htap_ds_impl.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "vineyard/basic/ds/tensor.h"
 #include "vineyard/client/client.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
 #include "vineyard/graph/fragment/arrow_fragment_group.h"
 
 namespace htap_impl {
 
+enum class OverlayKind { kCold, kVirtual, kEncoded };
+
+static void decode_columns(GraphHandleImpl* handle);
+static void drop_overlay_columns(GraphHandleImpl* handle, OverlayKind kind);
+
 void get_graph_handle(ObjectId id, PartitionId channel_num,
                       GraphHandleImpl* handle) {
 #ifndef NDEBUG
@@ -73,8 +94,14 @@ void get_graph_handle(ObjectId id, PartitionId channel_num,
   }
 
   handle->fragments = new FRAGMENT_TYPE[total_frag_num];
+  handle->cold_column_num = 0;
+  handle->virtual_column_num = 0;
+  handle->encoded_column_num = 0;
+  handle->edge_index = NULL;
   handle->schema = NULL;
   handle->vertex_map = NULL;
+  handle->property_indices = NULL;
+  handle->property_index_num = 0;
 
   for (const auto& pair : fg->Fragments()) {
     FRAG_ID_TYPE fid = pair.first;
@@ -117,6 +144,7 @@ void get_graph_handle(ObjectId id, PartitionId channel_num,
       }
     }
   }
+  decode_columns(handle);
   handle->vertex_chunk_sizes =
       static_cast<VID_TYPE**>(malloc(sizeof(VID_TYPE*) * total_frag_num));
   for (vineyard::fid_t i = 0; i < total_frag_num; ++i) {
@@ -140,6 +168,25 @@ void free_graph_handle(GraphHandleImpl* handle) {
     free(handle->vertex_chunk_sizes[i]);
   }
   free(handle->vertex_chunk_sizes);
+  if (handle->property_indices != NULL) {
+    delete[] handle->property_indices;
+    handle->property_indices = NULL;
+  }
+  if (handle->cold_column_num != 0) {
+    unmap_cold_columns(handle);
+  }
+  if (handle->virtual_column_num != 0) {
+    drop_overlay_columns(handle, OverlayKind::kVirtual);
+    handle->virtual_column_num = 0;
+  }
+  if (handle->encoded_column_num != 0) {
+    drop_overlay_columns(handle, OverlayKind::kEncoded);
+    handle->encoded_column_num = 0;
+  }
+  if (handle->edge_index != NULL) {
+    delete handle->edge_index;
+    handle->edge_index = NULL;
+  }
 
   delete[] handle->fragments;
   if (handle->local_fragments != NULL) {
@@ -154,16 +201,167 @@ void free_graph_handle(GraphHandleImpl* handle) {
 #endif
 }
 
+// The encoding of a column by the loader of the analytical engine, see
+// gs::PropertyEncoder, i.e., the strings as the codes of a sorted dictionary,
+// or the int32 or int64 values as the offsets from a base modulo 2^64, both
+// stored in int8, int16 or int32 from the lowest value of the code type.
+struct ColumnEncoding {
+  // the type of the values
+  std::shared_ptr<arrow::DataType> type;
+  int64_t lowest;
+  uint64_t base;
+  std::vector<std::string> dictionary;
+
+  int64_t integer(int64_t code) const {
+    return static_cast<int64_t>(static_cast<uint64_t>(code) + base);
+  }
+
+  const std::string& string(int64_t code) const {
+    return dictionary[static_cast<size_t>(code - lowest)];
+  }
+};
+
+// A column of a vertex table in place of or in addition to the columns of the
+// table, i.e., mapped from its spilled file, see map_cold_columns, backed by a
+// tensor of vineyard as a virtual property, see add_virtual_columns, or the
+// codes of an encoded column of a vertex or an edge table, see
+// decode_columns.
+struct OverlayColumn {
+  GraphHandleImpl* handle;
+  std::shared_ptr<arrow::Array> array;
+  // the object holding the memory of the array of a virtual column
+  std::shared_ptr<vineyard::Object> source;
+  OverlayKind kind;
+  std::shared_ptr<const ColumnEncoding> encoding;
+};
+
+using overlay_columns_t =
+    std::unordered_map<const arrow::Table*,
+                       std::unordered_map<PropertyId, OverlayColumn>>;
+
+// The overlay columns of all the handles, replaced as a whole on a change, so
+// the reads only load the pointer.
+static std::mutex overlay_columns_mutex;
+static std::shared_ptr<const overlay_columns_t> overlay_columns;
+static std::atomic<bool> has_overlay_columns(false);
+
+// The overlay column of the table, or null if none.
+static const OverlayColumn* find_overlay_column(
+    const std::shared_ptr<const overlay_columns_t>& columns,
+    const arrow::Table* table, PropertyId col_id) {
+  auto iter = columns->find(table);
+  if (iter != columns->end()) {
+    auto col_iter = iter->second.find(col_id);
+    if (col_iter != iter->second.end()) {
+      return &col_iter->second;
+    }
+  }
+  return NULL;
+}
+
+// The array of the column of the table, which is the mapped file if the
+// column is cold, or the tensor if the column is virtual, i.e., after the
+// columns of the table.
+static std::shared_ptr<arrow::Array> column_array(arrow::Table* table,
+                                                  PropertyId col_id) {
+  if (has_overlay_columns.load(std::memory_order_acquire)) {
+    auto columns = std::atomic_load(&overlay_columns);
+    const OverlayColumn* column = find_overlay_column(columns, table, col_id);
+    if (column != NULL) {
+      return column->array;
+    }
+  }
+  if (col_id >= table->num_columns()) {
+    return nullptr;
+  }
+  return table->column(col_id)->chunk(0);
+}
+
+// The type of the column of the table, or null if the column is virtual and
+// absent in the table.
+static std::shared_ptr<arrow::DataType> column_type(arrow::Table* table,
+                                                    PropertyId col_id) {
+  if (col_id < table->num_columns()) {
+    return table->field(col_id)->type();
+  }
+  if (has_overlay_columns.load(std::memory_order_acquire)) {
+    auto columns = std::atomic_load(&overlay_columns);
+    const OverlayColumn* column = find_overlay_column(columns, table, col_id);
+    if (column != NULL) {
+      return column->array->type();
+    }
+  }
+  return arrow::null();
+}
+
+// The encoding of the column of the table, or null if it is not encoded.
+static std::shared_ptr<const ColumnEncoding> column_encoding(
+    arrow::Table* table, PropertyId col_id) {
+  if (has_overlay_columns.load(std::memory_order_acquire)) {
+    auto columns = std::atomic_load(&overlay_columns);
+    const OverlayColumn* column = find_overlay_column(columns, table, col_id);
+    if (column != NULL) {
+      return column->encoding;
+    }
+  }
+  return nullptr;
+}
+
+// The code of the row of an encoded column.
+static int64_t code_at(const std::shared_ptr<arrow::Array>& array,
+                       int64_t row_id) {
+  switch (array->type_id()) {
+  case arrow::Type::INT8:
+    return std::static_pointer_cast<arrow::Int8Array>(array)->Value(row_id);
+  case arrow::Type::INT16:
+    return std::static_pointer_cast<arrow::Int16Array>(array)->Value(row_id);
+  case arrow::Type::INT32:
+    return std::static_pointer_cast<arrow::Int32Array>(array)->Value(row_id);
+  default:
+    return 0;
+  }
+}
+
+// The number of the columns of the table, with the virtual ones.
+static PropertyId column_num(arrow::Table* table) {
+  PropertyId num = table->num_columns();
+  if (has_overlay_columns.load(std::memory_order_acquire)) {
+    auto columns = std::atomic_load(&overlay_columns);
+    auto iter = columns->find(table);
+    if (iter != columns->end()) {
+      for (auto const& column : iter->second) {
+        num = std::max(num, column.first + 1);
+      }
+    }
+  }
+  return num;
+}
+
 static int get_property_from_table(arrow::Table* table, int64_t row_id,
                                    PropertyId col_id, Property* p_out) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  std::shared_ptr<arrow::DataType> dt = table->field(col_id)->type();
-  std::shared_ptr<arrow::Array> array = table->column(col_id)->chunk(0);
+  std::shared_ptr<arrow::DataType> dt = column_type(table, col_id);
+  std::shared_ptr<arrow::Array> array = column_array(table, col_id);
   p_out->id = col_id;
   PodProperties pp;
-  if (dt == arrow::boolean()) {
+  auto encoding = column_encoding(table, col_id);
+  if (encoding != nullptr) {
+    int64_t code = code_at(array, row_id);
+    if (encoding->type == arrow::int32()) {
+      p_out->type = INT;
+      pp.int_value = static_cast<int32_t>(encoding->integer(code));
+    } else if (encoding->type == arrow::int64()) {
+      p_out->type = LONG;
+      pp.long_value = encoding->integer(code);
+    } else {
+      p_out->type = STRING;
+      const std::string& value = encoding->string(code);
+      pp.long_value = value.length();
+      p_out->data = const_cast<void*>(static_cast<const void*>(value.data()));
+    }
+  } else if (dt == arrow::boolean()) {
     p_out->type = BOOL;
     pp.bool_value =
         std::dynamic_pointer_cast<arrow::BooleanArray>(array)->Value(row_id);
@@ -223,7 +421,7 @@ static void get_properties_from_table(std::shared_ptr<arrow::Table> table,
 #endif
   iter->table = table.get();
   iter->row_id = row_id;
-  iter->col_num = table->num_columns();
+  iter->col_num = column_num(table.get());
   iter->col_id = 0;
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
@@ -278,12 +476,152 @@ void get_vertex_properties(FRAGMENT_TYPE* frag, Vertex v,
 #endif
 }
 
+// Reads the values of the rows in the column to out at the positions, and
+// sets the bits of the values not null in validity. Returns the number of the
+// values read.
+template <typename ARRAY_T, typename T>
+static int read_column(const std::shared_ptr<arrow::Array>& array,
+                       const int64_t* rows, const int* positions, int n,
+                       T* out, uint8_t* validity) {
+  auto typed_array = std::static_pointer_cast<ARRAY_T>(array);
+  bool has_null = typed_array->null_count() != 0;
+  int count = 0;
+  for (int k = 0; k < n; ++k) {
+    if (has_null && typed_array->IsNull(rows[k])) {
+      continue;
+    }
+    int pos = positions[k];
+    out[pos] = typed_array->Value(rows[k]);
+    validity[pos >> 3] |= static_cast<uint8_t>(1 << (pos & 7));
+    ++count;
+  }
+  return count;
+}
+
+// Reads the decoded values of the rows in the encoded column like
+// read_column, if the integers are of the type, as the column has no nulls.
+template <typename T>
+static int read_encoded_column(const std::shared_ptr<arrow::Array>& array,
+                               const ColumnEncoding& encoding,
+                               const int64_t* rows, const int* positions,
+                               int n, T* out, uint8_t* validity) {
+  for (int k = 0; k < n; ++k) {
+    int pos = positions[k];
+    out[pos] = static_cast<T>(encoding.integer(code_at(array, rows[k])));
+    validity[pos >> 3] |= static_cast<uint8_t>(1 << (pos & 7));
+  }
+  return n;
+}
+
+// The column is read only if it is of the type, i.e., the type is checked
+// once per column rather than per row.
+static int get_column_values(arrow::Table* table, PropertyId col_id,
+                             PropertyType type, const int64_t* rows,
+                             const int* positions, int n, void* out,
+                             uint8_t* validity) {
+  std::shared_ptr<arrow::DataType> dt = column_type(table, col_id);
+  std::shared_ptr<arrow::Array> array = column_array(table, col_id);
+  auto encoding = column_encoding(table, col_id);
+  if (encoding != nullptr) {
+    if (type == INT && encoding->type == arrow::int32()) {
+      return read_encoded_column(array, *encoding, rows, positions, n,
+                                 static_cast<int32_t*>(out), validity);
+    } else if (type == LONG && encoding->type == arrow::int64()) {
+      return read_encoded_column(array, *encoding, rows, positions, n,
+                                 static_cast<int64_t*>(out), validity);
+    }
+    return 0;
+  }
+  switch (type) {
+  case BOOL:
+    return dt == arrow::boolean()
+               ? read_column<arrow::BooleanArray>(
+                     array, rows, positions, n, static_cast<bool*>(out),
+                     validity)
+               : 0;
+  case CHAR:
+    return dt == arrow::int8()
+               ? read_column<arrow::Int8Array>(array, rows, positions, n,
+                                               static_cast<int8_t*>(out),
+                                               validity)
+               : 0;
+  case SHORT:
+    return dt == arrow::int16()
+               ? read_column<arrow::Int16Array>(array, rows, positions, n,
+                                                static_cast<int16_t*>(out),
+                                                validity)
+               : 0;
+  case INT:
+    return dt == arrow::int32()
+               ? read_column<arrow::Int32Array>(array, rows, positions, n,
+                                                static_cast<int32_t*>(out),
+                                                validity)
+               : 0;
+  case LONG:
+    return dt == arrow::int64()
+               ? read_column<arrow::Int64Array>(array, rows, positions, n,
+                                                static_cast<int64_t*>(out),
+                                                validity)
+               : 0;
+  case FLOAT:
+    return dt == arrow::float32()
+               ? read_column<arrow::FloatArray>(array, rows, positions, n,
+                                                static_cast<float*>(out),
+                                                validity)
+               : 0;
+  case DOUBLE:
+    return dt == arrow::float64()
+               ? read_column<arrow::DoubleArray>(array, rows, positions, n,
+                                                 static_cast<double*>(out),
+                                                 validity)
+               : 0;
+  default:
+    LOG(ERROR) << "invalid type of the columnar property: " << type;
+    return 0;
+  }
+}
+
+int get_vertices_property(FRAGMENT_TYPE* frag, LabelId label,
+                          const Vertex* vertices, int begin, int end,
+                          PropertyId id, PropertyType type, void* out,
+                          uint8_t* validity) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ": id = " << id;
+#endif
+  std::vector<int64_t> rows;
+  std::vector<int> positions;
+  rows.reserve(end - begin);
+  positions.reserve(end - begin);
+  for (int i = begin; i < end; ++i) {
+    VERTEX_TYPE vert;
+    if (frag->InnerVertexGid2Vertex((VID_TYPE)vertices[i], vert)) {
+      rows.push_back(frag->vertex_offset(vert));
+      positions.push_back(i);
+    }
+  }
+  std::shared_ptr<arrow::Table> table = frag->vertex_data_table(label);
+  return get_column_values(table.get(), id, type, rows.data(),
+                           positions.data(), static_cast<int>(rows.size()),
+                           out, validity);
+}
+
+// Makes the array hold n elements at least, keeping it if it is large
+// enough, since the iterators are reused from the IteratorPool.
+template <typename T>
+static void reserve_array(T*& array, int& capacity, int n) {
+  if (capacity < n) {
+    free(array);
+    array = static_cast<T*>(malloc(sizeof(T) * n));
+    capacity = n;
+  }
+}
+
 void get_vertices(FRAGMENT_TYPE* frag, LabelId* label, VertexId* ids, int count,
                   GetVertexIteratorImpl* out) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
 #endif
-  out->ids = static_cast<VID_TYPE*>(malloc(sizeof(VID_TYPE) * count));
+  reserve_array(out->ids, out->ids_capacity, count);
   int cur = 0;
   if (label == NULL) {
     for (int i = 0; i < count; ++i) {
@@ -306,10 +644,6 @@ void get_vertices(FRAGMENT_TYPE* frag, LabelId* label, VertexId* ids, int count,
       }
     }
   }
-  if (cur == 0) {
-    free(out->ids);
-    out->ids = NULL;
-  }
   out->index = 0;
   out->count = cur;
 #ifndef NDEBUG
@@ -361,8 +695,8 @@ void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__ << ", limit = " << limit;
 #endif
+  out->scan = NULL;
   if (limit == 0) {
-    out->ranges = NULL;
     out->range_id = 0;
     out->range_num = 0;
     out->cur_vertex_id = 0;
@@ -375,8 +709,7 @@ void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
   if (labels_count == 0 || labels == NULL) {
     labels_count = frag->vertex_label_num();
 
-    out->ranges = static_cast<VERTEX_RANGE_TYPE*>(
-        malloc(labels_count * sizeof(VERTEX_RANGE_TYPE)));
+    reserve_array(out->ranges, out->ranges_capacity, labels_count);
 
     for (int i = 0; i < labels_count; ++i) {
 #ifndef NDEBUG
@@ -403,8 +736,7 @@ void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
       }
     }
   } else {
-    out->ranges = static_cast<VERTEX_RANGE_TYPE*>(
-        malloc(labels_count * sizeof(VERTEX_RANGE_TYPE)));
+    reserve_array(out->ranges, out->ranges_capacity, labels_count);
 
     for (int i = 0; i < labels_count; ++i) {
       if (labels[i] < 0) {
@@ -437,8 +769,6 @@ void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
 
   out->range_id = 0;
   if (range_index == 0) {
-    free(out->ranges);
-    out->ranges = NULL;
     out->range_num = 0;
     out->cur_vertex_id = 0;
   } else {
@@ -453,13 +783,89 @@ void free_get_all_vertices_iterator(GetAllVerticesIteratorImpl* iter) {
   }
 }
 
+// The morsels are small enough to balance the threads, and large enough to
+// keep them from contending on the cursor.
+static constexpr VID_TYPE kDefaultMorselSize = 4096;
+
+void init_morsel_scan(FRAGMENT_TYPE* frag, LabelId* labels, int labels_count,
+                      int64_t morsel_size, MorselScanImpl* scan) {
+  scan->fragment = frag;
+  scan->morsel_size = morsel_size > 0 ? static_cast<VID_TYPE>(morsel_size)
+                                      : kDefaultMorselSize;
+  scan->cursor = 0;
+  scan->morsel_offsets.push_back(0);
+  auto add_label = [frag, scan](LabelId label) {
+    auto range = frag->InnerVertices(label);
+    VID_TYPE size = range.size();
+    if (size == 0) {
+      return;
+    }
+    VID_TYPE first = frag->Vertex2Gid(range.begin());
+    scan->ranges.emplace_back(first, first + size);
+    scan->morsel_offsets.push_back(
+        scan->morsel_offsets.back() +
+        (size + scan->morsel_size - 1) / scan->morsel_size);
+  };
+  if (labels_count == 0 || labels == NULL) {
+    for (LabelId i = 0; i < frag->vertex_label_num(); ++i) {
+      add_label(i);
+    }
+  } else {
+    for (int i = 0; i < labels_count; ++i) {
+      if (labels[i] >= 0 && labels[i] < frag->vertex_label_num()) {
+        add_label(labels[i]);
+      }
+    }
+  }
+}
+
+bool next_morsel(MorselScanImpl* scan, VERTEX_RANGE_TYPE& morsel) {
+  size_t morsel_id = scan->cursor.fetch_add(1, std::memory_order_relaxed);
+  if (morsel_id >= scan->morsel_offsets.back()) {
+    return false;
+  }
+  size_t range_id = std::upper_bound(scan->morsel_offsets.begin(),
+                                     scan->morsel_offsets.end(), morsel_id) -
+                    scan->morsel_offsets.begin() - 1;
+  const VERTEX_RANGE_TYPE& range = scan->ranges[range_id];
+  morsel.first = range.first +
+                 (morsel_id - scan->morsel_offsets[range_id]) *
+                     scan->morsel_size;
+  morsel.second = std::min(morsel.first + scan->morsel_size, range.second);
+  return true;
+}
+
+// Moves the iterator to the next morsel of the scan, if any.
+static bool next_morsel_vertices(GetAllVerticesIteratorImpl* iter) {
+  VERTEX_RANGE_TYPE morsel;
+  if (iter->scan == NULL || !next_morsel(iter->scan, morsel)) {
+    return false;
+  }
+  iter->ranges[0] = morsel;
+  iter->range_num = 1;
+  iter->range_id = 0;
+  iter->cur_vertex_id = morsel.first;
+  return true;
+}
+
+void get_morsel_vertices(MorselScanImpl* scan,
+                         GetAllVerticesIteratorImpl* out) {
+  reserve_array(out->ranges, out->ranges_capacity, 1);
+  out->scan = scan;
+  out->range_num = 0;
+  out->range_id = 0;
+  out->cur_vertex_id = 0;
+}
+
 int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out) {
   while (iter->range_id != iter->range_num &&
          iter->cur_vertex_id == iter->ranges[iter->range_id].second) {
     ++iter->range_id;
-    iter->cur_vertex_id = iter->ranges[iter->range_id].first;
+    if (iter->range_id != iter->range_num) {
+      iter->cur_vertex_id = iter->ranges[iter->range_id].first;
+    }
   }
-  if (iter->range_id == iter->range_num) {
+  if (iter->range_id == iter->range_num && !next_morsel_vertices(iter)) {
     return -1;
   }
   *v_out = (Vertex)iter->cur_vertex_id;
@@ -470,6 +876,221 @@ int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out) {
   return 0;
 }
 
+// ANDs the predicate on the n values get(i) into the mask, in a loop per
+// comparison without branches on the values.
+template <typename T, typename GET_T>
+static void filter_values(const GET_T& get, int64_t n,
+                          const Predicate& predicate,
+                          std::vector<uint8_t>& mask) {
+  const T* values = static_cast<const T*>(predicate.values);
+  auto apply = [&](const auto& test) {
+    for (int64_t i = 0; i < n; ++i) {
+      mask[i] &= static_cast<uint8_t>(test(get(i)));
+    }
+  };
+  if (predicate.value_count < (predicate.op == BETWEEN ? 2 : 1)) {
+    std::fill(mask.begin(), mask.end(), 0);
+    return;
+  }
+  T x = values[0];
+  switch (predicate.op) {
+  case EQ:
+    apply([x](T v) { return v == x; });
+    break;
+  case NE:
+    apply([x](T v) { return v != x; });
+    break;
+  case LT:
+    apply([x](T v) { return v < x; });
+    break;
+  case LE:
+    apply([x](T v) { return v <= x; });
+    break;
+  case GT:
+    apply([x](T v) { return v > x; });
+    break;
+  case GE:
+    apply([x](T v) { return v >= x; });
+    break;
+  case BETWEEN: {
+    T y = values[1];
+    apply([x, y](T v) { return x <= v && v <= y; });
+    break;
+  }
+  case WITHIN: {
+    std::vector<T> sorted(values, values + predicate.value_count);
+    std::sort(sorted.begin(), sorted.end());
+    apply([&sorted](T v) {
+      return std::binary_search(sorted.begin(), sorted.end(), v);
+    });
+    break;
+  }
+  default:
+    LOG(ERROR) << "invalid compare op of the predicate: " << predicate.op;
+    std::fill(mask.begin(), mask.end(), 0);
+    return;
+  }
+}
+
+// ANDs the predicate on the n rows of the column from row_begin into the
+// mask. The null values never satisfy the predicate.
+template <typename ARRAY_T, typename T>
+static void filter_column(const std::shared_ptr<arrow::Array>& array,
+                          int64_t row_begin, int64_t n,
+                          const Predicate& predicate,
+                          std::vector<uint8_t>& mask) {
+  auto typed_array = std::static_pointer_cast<ARRAY_T>(array);
+  filter_values<T>(
+      [&](int64_t i) -> T { return typed_array->Value(row_begin + i); }, n,
+      predicate, mask);
+  if (typed_array->null_count() != 0) {
+    for (int64_t i = 0; i < n; ++i) {
+      if (typed_array->IsNull(row_begin + i)) {
+        mask[i] = 0;
+      }
+    }
+  }
+}
+
+// ANDs the predicate on the decoded values of the n rows of the encoded
+// column from row_begin into the mask, which has no nulls. The predicate on
+// the integers is of their type, and the strings are not filtered.
+static void filter_encoded_column(const std::shared_ptr<arrow::Array>& array,
+                                  const ColumnEncoding& encoding,
+                                  int64_t row_begin, int64_t n,
+                                  const Predicate& predicate,
+                                  std::vector<uint8_t>& mask) {
+  if (predicate.type == INT && encoding.type == arrow::int32()) {
+    filter_values<int32_t>(
+        [&](int64_t i) {
+          return static_cast<int32_t>(
+              encoding.integer(code_at(array, row_begin + i)));
+        },
+        n, predicate, mask);
+  } else if (predicate.type == LONG && encoding.type == arrow::int64()) {
+    filter_values<int64_t>(
+        [&](int64_t i) {
+          return encoding.integer(code_at(array, row_begin + i));
+        },
+        n, predicate, mask);
+  } else {
+    std::fill(mask.begin(), mask.end(), 0);
+  }
+}
+
+// Like get_column_values, the predicate is evaluated only if the column is of
+// the type, or else no row satisfies it.
+static void filter_table(arrow::Table* table, int64_t row_begin, int64_t n,
+                         const Predicate& predicate,
+                         std::vector<uint8_t>& mask) {
+  std::shared_ptr<arrow::DataType> dt = column_type(table, predicate.id);
+  std::shared_ptr<arrow::Array> array = column_array(table, predicate.id);
+  auto encoding = column_encoding(table, predicate.id);
+  if (encoding != nullptr) {
+    filter_encoded_column(array, *encoding, row_begin, n, predicate, mask);
+    return;
+  }
+  switch (predicate.type) {
+  case BOOL:
+    if (dt == arrow::boolean()) {
+      filter_column<arrow::BooleanArray, bool>(array, row_begin, n, predicate,
+                                               mask);
+      return;
+    }
+    break;
+  case CHAR:
+    if (dt == arrow::int8()) {
+      filter_column<arrow::Int8Array, int8_t>(array, row_begin, n, predicate,
+                                              mask);
+      return;
+    }
+    break;
+  case SHORT:
+    if (dt == arrow::int16()) {
+      filter_column<arrow::Int16Array, int16_t>(array, row_begin, n,
+                                                predicate, mask);
+      return;
+    }
+    break;
+  case INT:
+    if (dt == arrow::int32()) {
+      filter_column<arrow::Int32Array, int32_t>(array, row_begin, n,
+                                                predicate, mask);
+      return;
+    }
+    break;
+  case LONG:
+    if (dt == arrow::int64()) {
+      filter_column<arrow::Int64Array, int64_t>(array, row_begin, n,
+                                                predicate, mask);
+      return;
+    }
+    break;
+  case FLOAT:
+    if (dt == arrow::float32()) {
+      filter_column<arrow::FloatArray, float>(array, row_begin, n, predicate,
+                                              mask);
+      return;
+    }
+    break;
+  case DOUBLE:
+    if (dt == arrow::float64()) {
+      filter_column<arrow::DoubleArray, double>(array, row_begin, n,
+                                                predicate, mask);
+      return;
+    }
+    break;
+  default:
+    LOG(ERROR) << "invalid type of the predicate: " << predicate.type;
+    break;
+  }
+  std::fill(mask.begin(), mask.end(), 0);
+}
+
+void scan_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                   VID_TYPE chunk_size, LabelId label,
+                   const Predicate* predicates, int predicate_count,
+                   size_t limit, std::vector<VID_TYPE>& out) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ": label = " << label
+            << ", predicate_count = " << predicate_count;
+#endif
+  auto range =
+      get_sub_range(frag->InnerVertices(label), chunk_size, channel_id);
+  int64_t n = range.size();
+  if (n == 0 || out.size() >= limit) {
+    return;
+  }
+  // the rows of the inner vertices of a label are their offsets, so the ones
+  // of the sub range are consecutive, as well as the gids
+  int64_t row_begin = frag->vertex_offset(range.begin());
+  VID_TYPE gid_begin = frag->Vertex2Gid(range.begin());
+  std::shared_ptr<arrow::Table> table = frag->vertex_data_table(label);
+  std::vector<uint8_t> mask(n, 1);
+  for (int k = 0; k < predicate_count; ++k) {
+    filter_table(table.get(), row_begin, n, predicates[k], mask);
+  }
+  for (int64_t i = 0; i < n && out.size() < limit; ++i) {
+    if (mask[i]) {
+      out.push_back(gid_begin + i);
+    }
+  }
+#ifndef NDEBUG
+  LOG(INFO) << "finish " << __FUNCTION__ << ": count = " << out.size();
+#endif
+}
+
+void set_vertices(const std::vector<VID_TYPE>& ids,
+                  GetVertexIteratorImpl* out) {
+  int count = static_cast<int>(ids.size());
+  reserve_array(out->ids, out->ids_capacity, count);
+  for (int i = 0; i < count; ++i) {
+    out->ids[i] = ids[i];
+  }
+  out->index = 0;
+  out->count = count;
+}
+
 EdgeId get_edge_id(FRAGMENT_TYPE* frag, LabelId label, int64_t offset) {
 #ifndef NDEBUG
   LOG(INFO) << "enter = " << __FUNCTION__ << ", label = " << label
@@ -504,9 +1125,22 @@ void get_edge_properties(FRAGMENT_TYPE* frag, LabelId label, int64_t offset,
   get_properties_from_table(table, offset, iter);
 }
 
+int get_edges_property(FRAGMENT_TYPE* frag, LabelId label,
+                       const int64_t* offsets, const int* positions, int n,
+                       PropertyId id, PropertyType type, void* out,
+                       uint8_t* validity) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter = " << __FUNCTION__ << ", label = " << label
+            << ", n = " << n;
+#endif
+  std::shared_ptr<arrow::Table> table = frag->edge_data_table(label);
+  return get_column_values(table.get(), id, type, offsets, positions, n, out,
+                           validity);
+}
+
 int properties_next(PropertiesIteratorImpl* iter, Property* p_out) {
   while (iter->col_id < iter->col_num &&
-         iter->table->field(iter->col_id)->type() == arrow::null()) {
+         column_type(iter->table, iter->col_id) == arrow::null()) {
     ++iter->col_id;
   }
   if (iter->col_num == iter->col_id) {
@@ -523,7 +1157,6 @@ void empty_edge_iterator(EdgeIteratorImpl* iter) {
   iter->list_num = 0;
   iter->list_id = 0;
   iter->cur_edge = NULL;
-  iter->lists = NULL;
 }
 
 void get_out_edges(FRAGMENT_TYPE* frag,
@@ -543,8 +1176,7 @@ void get_out_edges(FRAGMENT_TYPE* frag,
     size_t limit_remaining = limit;
     if (labels == NULL || labels_count == 0) {
       labels_count = frag->edge_label_num();
-      iter->lists =
-          static_cast<AdjListUnit*>(malloc(sizeof(AdjListUnit) * labels_count));
+      reserve_array(iter->lists, iter->lists_capacity, labels_count);
       for (int i = 0; i < labels_count; ++i) {
         auto adj_list = frag->GetOutgoingAdjList(
             vert, (typename FRAGMENT_TYPE::label_id_t)i);
@@ -568,8 +1200,7 @@ void get_out_edges(FRAGMENT_TYPE* frag,
         }
       }
     } else {
-      iter->lists =
-          static_cast<AdjListUnit*>(malloc(sizeof(AdjListUnit) * labels_count));
+      reserve_array(iter->lists, iter->lists_capacity, labels_count);
       for (int i = 0; i < labels_count; ++i) {
         if (labels[i] < 0) {
           continue;
@@ -597,8 +1228,6 @@ void get_out_edges(FRAGMENT_TYPE* frag,
       }
     }
     if (list_index == 0) {
-      free(iter->lists);
-      iter->lists = NULL;
       iter->list_num = 0;
       iter->cur_edge = NULL;
     } else {
@@ -606,7 +1235,6 @@ void get_out_edges(FRAGMENT_TYPE* frag,
       iter->cur_edge = iter->lists[0].begin;
     }
   } else {
-    iter->lists = NULL;
     iter->list_num = 0;
     iter->cur_edge = NULL;
   }
@@ -639,6 +1267,209 @@ int out_edge_next(EdgeIteratorImpl* iter, Edge* e_out) {
   return 0;
 }
 
+// The sources are split into the threads by the chunks of at least
+// kMultiSourceChunk.
+static constexpr int64_t kMultiSourceChunk = 1024;
+
+// Calls func(begin, end) on the ranges of [0, count) in parallel.
+template <typename FUNC_T>
+static void parallel_for(int64_t count, const FUNC_T& func) {
+  int64_t thread_num = std::min<int64_t>(
+      std::max<unsigned>(std::thread::hardware_concurrency(), 1),
+      (count + kMultiSourceChunk - 1) / kMultiSourceChunk);
+  if (thread_num <= 1) {
+    func(0, count);
+    return;
+  }
+  int64_t chunk = (count + thread_num - 1) / thread_num;
+  std::vector<std::thread> threads;
+  for (int64_t begin = 0; begin < count; begin += chunk) {
+    threads.emplace_back(func, begin, std::min(count, begin + chunk));
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+// The edge labels to query, i.e., all of them if labels is null or empty.
+static std::vector<LabelId> get_edge_labels(FRAGMENT_TYPE* frag,
+                                            const LabelId* labels,
+                                            int labels_count) {
+  std::vector<LabelId> e_labels;
+  if (labels == NULL || labels_count == 0) {
+    for (int i = 0; i < static_cast<int>(frag->edge_label_num()); ++i) {
+      e_labels.push_back(i);
+    }
+  } else {
+    for (int i = 0; i < labels_count; ++i) {
+      if (labels[i] >= 0) {
+        e_labels.push_back(labels[i]);
+      }
+    }
+  }
+  return e_labels;
+}
+
+void get_edges_multi(FRAGMENT_TYPE* frag,
+                     vineyard::IdParser<EID_TYPE>* eid_parser, VertexId* ids,
+                     int count, LabelId* labels, int labels_count,
+                     int64_t limit, bool outgoing, EdgeList* out) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ", count = " << count;
+#endif
+  std::vector<LabelId> e_labels = get_edge_labels(frag, labels, labels_count);
+  auto adj_list_of = [frag, outgoing](const VERTEX_TYPE& v, LabelId label) {
+    auto e_label = static_cast<typename FRAGMENT_TYPE::label_id_t>(label);
+    return outgoing ? frag->GetOutgoingAdjList(v, e_label)
+                    : frag->GetIncomingAdjList(v, e_label);
+  };
+  // the sources out of the fragment are of no edges
+  std::vector<VERTEX_TYPE> vertices(count);
+  std::vector<uint8_t> found(count, 0);
+  size_t limit_per_source = limit;
+
+  out->count = count;
+  out->offsets = static_cast<int64_t*>(malloc(sizeof(int64_t) * (count + 1)));
+  out->offsets[0] = 0;
+  parallel_for(count, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      size_t degree = 0;
+      if (limit != 0 &&
+          frag->InnerVertexGid2Vertex(static_cast<VID_TYPE>(ids[i]),
+                                      vertices[i])) {
+        found[i] = 1;
+        for (auto label : e_labels) {
+          auto adj_list = adj_list_of(vertices[i], label);
+          degree += adj_list.end_unit() - adj_list.begin_unit();
+          if (degree >= limit_per_source) {
+            degree = limit_per_source;
+            break;
+          }
+        }
+      }
+      out->offsets[i + 1] = degree;
+    }
+  });
+  for (int i = 0; i < count; ++i) {
+    out->offsets[i + 1] += out->offsets[i];
+  }
+
+  int64_t total = out->offsets[count];
+  out->nbr_ids = static_cast<VertexId*>(malloc(sizeof(VertexId) * total));
+  out->edge_ids = static_cast<EdgeId*>(malloc(sizeof(EdgeId) * total));
+  FRAG_ID_TYPE fid = frag->fid();
+  parallel_for(count, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (!found[i]) {
+        continue;
+      }
+      int64_t pos = out->offsets[i], last = out->offsets[i + 1];
+      for (auto label : e_labels) {
+        auto adj_list = adj_list_of(vertices[i], label);
+        for (const NBR_TYPE* ptr = adj_list.begin_unit();
+             ptr != adj_list.end_unit() && pos != last; ++ptr, ++pos) {
+          out->nbr_ids[pos] = frag->Vertex2Gid(VERTEX_TYPE(ptr->vid));
+          out->edge_ids[pos] = eid_parser->GenerateId(fid, label, ptr->eid);
+        }
+        if (pos == last) {
+          break;
+        }
+      }
+    }
+  });
+#ifndef NDEBUG
+  LOG(INFO) << "finish " << __FUNCTION__ << ", total = " << total;
+#endif
+}
+
+void free_edge_list(EdgeList* edges) {
+  free(edges->offsets);
+  free(edges->nbr_ids);
+  free(edges->edge_ids);
+  edges->offsets = NULL;
+  edges->nbr_ids = NULL;
+  edges->edge_ids = NULL;
+  edges->count = 0;
+}
+
+// The degree is the size of the adjacent list, without touching the edges.
+static int64_t get_degree(FRAGMENT_TYPE* frag, const VERTEX_TYPE& v,
+                          const std::vector<LabelId>& e_labels,
+                          bool outgoing) {
+  int64_t degree = 0;
+  for (auto label : e_labels) {
+    auto e_label = static_cast<typename FRAGMENT_TYPE::label_id_t>(label);
+    auto adj_list = outgoing ? frag->GetOutgoingAdjList(v, e_label)
+                             : frag->GetIncomingAdjList(v, e_label);
+    degree += adj_list.end_unit() - adj_list.begin_unit();
+  }
+  return degree;
+}
+
+void get_degrees(FRAGMENT_TYPE* frag, const VertexId* ids, int count,
+                 LabelId* labels, int labels_count, bool outgoing,
+                 int64_t* degrees) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ", count = " << count;
+#endif
+  std::vector<LabelId> e_labels = get_edge_labels(frag, labels, labels_count);
+  parallel_for(count, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      VERTEX_TYPE vert;
+      degrees[i] =
+          frag->InnerVertexGid2Vertex(static_cast<VID_TYPE>(ids[i]), vert)
+              ? get_degree(frag, vert, e_labels, outgoing)
+              : 0;
+    }
+  });
+}
+
+int64_t get_vertex_count(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                         const VID_TYPE* chunk_sizes, LabelId* labels,
+                         int labels_count) {
+  int64_t count = 0;
+  if (labels == NULL || labels_count == 0) {
+    for (LabelId i = 0; i < frag->vertex_label_num(); ++i) {
+      count += get_sub_range(frag->InnerVertices(i), chunk_sizes[i],
+                             channel_id)
+                   .size();
+    }
+  } else {
+    for (int i = 0; i < labels_count; ++i) {
+      if (labels[i] >= 0 && labels[i] < frag->vertex_label_num()) {
+        count += get_sub_range(frag->InnerVertices(labels[i]),
+                               chunk_sizes[labels[i]], channel_id)
+                     .size();
+      }
+    }
+  }
+  return count;
+}
+
+int64_t get_edge_count(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                       const VID_TYPE* chunk_sizes, LabelId* labels,
+                       int labels_count) {
+  std::vector<LabelId> e_labels = get_edge_labels(frag, labels, labels_count);
+  int64_t count = 0;
+  for (LabelId i = 0; i < frag->vertex_label_num(); ++i) {
+    auto range =
+        get_sub_range(frag->InnerVertices(i), chunk_sizes[i], channel_id);
+    if (range.size() == 0) {
+      continue;
+    }
+    // the outgoing adjacent lists of the inner vertices of a label are
+    // consecutive in the CSR, so the edges of a range are between the first
+    // and the last list
+    VERTEX_TYPE last(range.end().GetValue() - 1);
+    for (auto label : e_labels) {
+      auto e_label = static_cast<typename FRAGMENT_TYPE::label_id_t>(label);
+      count += frag->GetOutgoingAdjList(last, e_label).end_unit() -
+               frag->GetOutgoingAdjList(range.begin(), e_label).begin_unit();
+    }
+  }
+  return count;
+}
+
 void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
                   VertexId dst_id, LabelId* labels, int labels_count,
                   int64_t limit, EdgeIteratorImpl* iter) {
@@ -655,8 +1486,7 @@ void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
     size_t limit_remaining = limit;
     if (labels == NULL || labels_count == 0) {
       labels_count = frag->edge_label_num();
-      iter->lists =
-          static_cast<AdjListUnit*>(malloc(sizeof(AdjListUnit) * labels_count));
+      reserve_array(iter->lists, iter->lists_capacity, labels_count);
       for (int i = 0; i < labels_count; ++i) {
         auto adj_list = frag->GetIncomingAdjList(
             vert, (typename FRAGMENT_TYPE::label_id_t)i);
@@ -680,8 +1510,7 @@ void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
         }
       }
     } else {
-      iter->lists =
-          static_cast<AdjListUnit*>(malloc(sizeof(AdjListUnit) * labels_count));
+      reserve_array(iter->lists, iter->lists_capacity, labels_count);
       for (int i = 0; i < labels_count; ++i) {
         if (labels[i] < 0) {
           continue;
@@ -709,8 +1538,6 @@ void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
       }
     }
     if (list_index == 0) {
-      free(iter->lists);
-      iter->lists = NULL;
       iter->list_num = 0;
       iter->cur_edge = NULL;
     } else {
@@ -718,7 +1545,6 @@ void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
       iter->cur_edge = iter->lists[0].begin;
     }
   } else {
-    iter->lists = NULL;
     iter->list_num = 0;
     iter->cur_edge = NULL;
   }
@@ -751,6 +1577,74 @@ int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out) {
   return 0;
 }
 
+// Calls func(i, nbr_gid, eid) on up to capacity edges from the iterator,
+// where i counts from 0, and returns the number of the edges. The edges are
+// taken by the ranges of the adjacent lists, without checking the end of the
+// lists per edge.
+template <typename FUNC_T>
+static int edge_next_batch(EdgeIteratorImpl* iter, int capacity,
+                           const FUNC_T& func) {
+  FRAGMENT_TYPE* frag = iter->fragment;
+  FRAG_ID_TYPE fid = frag->fid();
+  int count = 0;
+  while (count < capacity && iter->list_id != iter->list_num) {
+    const NBR_TYPE* end = iter->lists[iter->list_id].end;
+    LabelId label = iter->lists[iter->list_id].label;
+    int64_t num = std::min<int64_t>(end - iter->cur_edge, capacity - count);
+    for (const NBR_TYPE* ptr = iter->cur_edge; ptr != iter->cur_edge + num;
+         ++ptr) {
+      func(count++, frag->Vertex2Gid(VERTEX_TYPE(ptr->vid)),
+           iter->eid_parser->GenerateId(fid, label, ptr->eid));
+    }
+    iter->cur_edge += num;
+    if (iter->cur_edge == end) {
+      ++iter->list_id;
+      if (iter->list_id != iter->list_num) {
+        iter->cur_edge = iter->lists[iter->list_id].begin;
+      }
+    }
+  }
+  return count;
+}
+
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int capacity) {
+  VertexId src = iter->src;
+  return edge_next_batch(iter, capacity,
+                         [e_out, src](int i, VertexId dst, EdgeId eid) {
+                           e_out[i].src = src;
+                           e_out[i].dst = dst;
+                           e_out[i].offset = eid;
+                         });
+}
+
+int out_edge_next_columns(EdgeIteratorImpl* iter, VertexId* dst_ids,
+                          EdgeId* edge_ids, int capacity) {
+  return edge_next_batch(iter, capacity,
+                         [dst_ids, edge_ids](int i, VertexId dst, EdgeId eid) {
+                           dst_ids[i] = dst;
+                           edge_ids[i] = eid;
+                         });
+}
+
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int capacity) {
+  VertexId dst = iter->src;
+  return edge_next_batch(iter, capacity,
+                         [e_out, dst](int i, VertexId src, EdgeId eid) {
+                           e_out[i].src = src;
+                           e_out[i].dst = dst;
+                           e_out[i].offset = eid;
+                         });
+}
+
+int in_edge_next_columns(EdgeIteratorImpl* iter, VertexId* src_ids,
+                         EdgeId* edge_ids, int capacity) {
+  return edge_next_batch(iter, capacity,
+                         [src_ids, edge_ids](int i, VertexId src, EdgeId eid) {
+                           src_ids[i] = src;
+                           edge_ids[i] = eid;
+                         });
+}
+
 void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
                    const VID_TYPE* chunk_sizes,
                    vineyard::IdParser<EID_TYPE>* eid_parser, LabelId* labels,
@@ -765,13 +1659,14 @@ void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
 #endif
 
   out->fragment = frag;
-  out->e_labels = static_cast<LabelId*>(malloc(sizeof(LabelId) * labels_count));
+  reserve_array(out->e_labels, out->e_labels_capacity, labels_count);
   out->eid_parser = eid_parser;
   memcpy(out->e_labels, labels, sizeof(LabelId) * labels_count);
   out->e_labels_count = labels_count;
 
   out->chunk_sizes = chunk_sizes;
   out->channel_id = channel_id;
+  out->scan = NULL;
 
   out->cur_v_label = 0;
   auto super_range = frag->InnerVertices(out->cur_v_label);
@@ -801,6 +1696,68 @@ void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
 #endif
 }
 
+void get_morsel_edges(MorselScanImpl* scan,
+                      vineyard::IdParser<EID_TYPE>* eid_parser,
+                      LabelId* labels, int labels_count,
+                      GetAllEdgesIteratorImpl* out) {
+  FRAGMENT_TYPE* frag = scan->fragment;
+  out->fragment = frag;
+  reserve_array(out->e_labels, out->e_labels_capacity, labels_count);
+  out->eid_parser = eid_parser;
+  memcpy(out->e_labels, labels, sizeof(LabelId) * labels_count);
+  out->e_labels_count = labels_count;
+  out->chunk_sizes = NULL;
+  out->channel_id = 0;
+  out->scan = scan;
+  out->index = 0;
+  out->limit = -1;
+
+  out->cur_v_label = 0;
+  if (!next_morsel(scan, out->cur_range)) {
+    out->cur_v_label = frag->vertex_label_num();
+    empty_edge_iterator(&out->ei);
+    return;
+  }
+  get_out_edges(frag, eid_parser, out->cur_range.first, out->e_labels,
+                out->e_labels_count, out->limit, &out->ei);
+}
+
+// Moves the iterator to the out edges of the next source vertex, and returns
+// false if there are no more source vertices.
+static bool next_all_edges_source(GetAllEdgesIteratorImpl* iter) {
+  VID_TYPE cur_vid = iter->ei.src + 1;
+  if (cur_vid == iter->cur_range.second && iter->scan != NULL) {
+    if (!next_morsel(iter->scan, iter->cur_range)) {
+      iter->cur_v_label = iter->fragment->vertex_label_num();
+      return false;
+    }
+    cur_vid = iter->cur_range.first;
+  } else if (cur_vid == iter->cur_range.second) {
+    ++iter->cur_v_label;
+    typename FRAGMENT_TYPE::vertex_range_t super_range, range;
+    while (iter->cur_v_label < iter->fragment->vertex_label_num()) {
+      super_range = iter->fragment->InnerVertices(iter->cur_v_label);
+      range = get_sub_range(super_range, iter->chunk_sizes[iter->cur_v_label],
+                            iter->channel_id);
+      if (range.size() == 0) {
+        ++iter->cur_v_label;
+      } else {
+        break;
+      }
+    }
+    if (iter->cur_v_label == iter->fragment->vertex_label_num()) {
+      return false;
+    }
+    iter->cur_range.first = iter->fragment->Vertex2Gid(range.begin());
+    iter->cur_range.second = iter->cur_range.first + range.size();
+    cur_vid = iter->cur_range.first;
+  }
+
+  get_out_edges(iter->fragment, iter->eid_parser, cur_vid, iter->e_labels,
+                iter->e_labels_count, iter->limit - iter->index, &iter->ei);
+  return true;
+}
+
 int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out) {
 #ifndef NDEBUG
   LOG(INFO) << "enter " << __FUNCTION__;
@@ -824,46 +1781,46 @@ int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out) {
       ++iter->index;
       return 0;
     }
-
-    VID_TYPE cur_vid = iter->ei.src + 1;
-    if (cur_vid == iter->cur_range.second) {
-      ++iter->cur_v_label;
-      typename FRAGMENT_TYPE::vertex_range_t super_range, range;
-      while (iter->cur_v_label < iter->fragment->vertex_label_num()) {
-        super_range = iter->fragment->InnerVertices(iter->cur_v_label);
-        range = get_sub_range(super_range, iter->chunk_sizes[iter->cur_v_label],
-                              iter->channel_id);
-        if (range.size() == 0) {
-          ++iter->cur_v_label;
-        } else {
-          break;
-        }
-      }
-      if (iter->cur_v_label == iter->fragment->vertex_label_num()) {
+    if (!next_all_edges_source(iter)) {
 #ifndef NDEBUG
-        LOG(INFO) << "finish " << __FUNCTION__ << " no extra v label";
+      LOG(INFO) << "finish " << __FUNCTION__ << " no extra v label";
 #endif
-        return -1;
-      }
-      iter->cur_range.first = iter->fragment->Vertex2Gid(range.begin());
-      iter->cur_range.second = iter->cur_range.first + range.size();
-      cur_vid = iter->cur_range.first;
+      return -1;
     }
-
-    free_edge_iterator(&iter->ei);
-    get_out_edges(iter->fragment, iter->eid_parser, cur_vid, iter->e_labels,
-                  iter->e_labels_count, iter->limit - iter->index, &iter->ei);
   }
 #ifndef NDEBUG
   LOG(INFO) << "finish " << __FUNCTION__;
 #endif
 }
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int capacity) {
+  int count = 0;
+  while (count < capacity &&
+         iter->cur_v_label <
+             static_cast<int>(iter->fragment->vertex_label_num()) &&
+         iter->index != iter->limit) {
+    int64_t num = capacity - count;
+    if (iter->limit >= 0) {
+      num = std::min(num, iter->limit - iter->index);
+    }
+    int got = out_edge_next_batch(&iter->ei, e_out + count,
+                                  static_cast<int>(num));
+    count += got;
+    iter->index += got;
+    if (got < num && !next_all_edges_source(iter)) {
+      break;
+    }
+  }
+  return count;
+}
+
 void free_edge_iterator(EdgeIteratorImpl* iter) {
   if (iter->lists != NULL) {
     free(iter->lists);
     iter->lists = NULL;
   }
+  iter->lists_capacity = 0;
 }
 
 void free_get_all_edges_iterator(GetAllEdgesIteratorImpl* iter) {
@@ -871,9 +1828,784 @@ void free_get_all_edges_iterator(GetAllEdgesIteratorImpl* iter) {
     free(iter->e_labels);
     iter->e_labels = NULL;
   }
+  iter->e_labels_capacity = 0;
   free_edge_iterator(&iter->ei);
 }
 
+// Keeps the first vertex of the duplicated keys, since the property is
+// expected to be unique.
+template <typename MAP_T, typename KEY_T>
+static void add_index_key(MAP_T& keys, KEY_T&& key, VID_TYPE gid,
+                          size_t& duplicates) {
+  if (!keys.emplace(std::forward<KEY_T>(key), gid).second) {
+    ++duplicates;
+  }
+}
+
+// The rows of the vertex table of a label are the offsets of the inner
+// vertices, so the gids of the rows are consecutive from gid_begin.
+template <typename ARRAY_T>
+static size_t index_integral_column(
+    const std::shared_ptr<arrow::Array>& array, VID_TYPE gid_begin,
+    std::unordered_map<int64_t, VID_TYPE>& keys) {
+  auto typed_array = std::static_pointer_cast<ARRAY_T>(array);
+  size_t duplicates = 0;
+  keys.reserve(typed_array->length());
+  for (int64_t i = 0; i < typed_array->length(); ++i) {
+    if (!typed_array->IsNull(i)) {
+      add_index_key(keys, static_cast<int64_t>(typed_array->Value(i)),
+                    gid_begin + i, duplicates);
+    }
+  }
+  return duplicates;
+}
+
+template <typename ARRAY_T>
+static size_t index_string_column(
+    const std::shared_ptr<arrow::Array>& array, VID_TYPE gid_begin,
+    std::unordered_map<std::string, VID_TYPE>& keys) {
+  auto typed_array = std::static_pointer_cast<ARRAY_T>(array);
+  size_t duplicates = 0;
+  keys.reserve(typed_array->length());
+  for (int64_t i = 0; i < typed_array->length(); ++i) {
+    if (!typed_array->IsNull(i)) {
+      auto view = typed_array->GetView(i);
+      add_index_key(keys, std::string(view.data(), view.size()),
+                    gid_begin + i, duplicates);
+    }
+  }
+  return duplicates;
+}
+
+// The keys are the decoded values of the codes.
+static size_t index_encoded_column(
+    const std::shared_ptr<arrow::Array>& array, const ColumnEncoding& encoding,
+    VID_TYPE gid_begin, PropertyIndexImpl* index, size_t local_id) {
+  bool is_string = encoding.type == arrow::utf8() ||
+                   encoding.type == arrow::large_utf8();
+  size_t duplicates = 0;
+  for (int64_t i = 0; i < array->length(); ++i) {
+    if (array->IsNull(i)) {
+      continue;
+    }
+    int64_t code = code_at(array, i);
+    if (is_string) {
+      add_index_key(index->string_keys[local_id], encoding.string(code),
+                    gid_begin + i, duplicates);
+    } else {
+      add_index_key(index->int_keys[local_id], encoding.integer(code),
+                    gid_begin + i, duplicates);
+    }
+  }
+  return duplicates;
+}
+
+static void build_property_index(FRAGMENT_TYPE* frag, PropertyId col_id,
+                                 PropertyIndexImpl* index, size_t local_id) {
+  auto vertices = frag->InnerVertices(index->label);
+  if (vertices.size() == 0) {
+    return;
+  }
+  VID_TYPE gid_begin = frag->Vertex2Gid(vertices.begin());
+  std::shared_ptr<arrow::Table> table = frag->vertex_data_table(index->label);
+  std::shared_ptr<arrow::DataType> dt = table->field(col_id)->type();
+  std::shared_ptr<arrow::Array> array = table->column(col_id)->chunk(0);
+  auto& int_keys = index->int_keys[local_id];
+  auto& string_keys = index->string_keys[local_id];
+  auto encoding = column_encoding(table.get(), col_id);
+  size_t duplicates = 0;
+  if (encoding != nullptr) {
+    duplicates = index_encoded_column(array, *encoding, gid_begin, index,
+                                      local_id);
+  } else if (dt == arrow::int8()) {
+    duplicates = index_integral_column<arrow::Int8Array>(array, gid_begin,
+                                                         int_keys);
+  } else if (dt == arrow::int16()) {
+    duplicates = index_integral_column<arrow::Int16Array>(array, gid_begin,
+                                                          int_keys);
+  } else if (dt == arrow::int32()) {
+    duplicates = index_integral_column<arrow::Int32Array>(array, gid_begin,
+                                                          int_keys);
+  } else if (dt == arrow::int64()) {
+    duplicates = index_integral_column<arrow::Int64Array>(array, gid_begin,
+                                                          int_keys);
+  } else if (dt == arrow::utf8()) {
+    duplicates = index_string_column<arrow::StringArray>(array, gid_begin,
+                                                         string_keys);
+  } else if (dt == arrow::large_utf8()) {
+    duplicates = index_string_column<arrow::LargeStringArray>(
+        array, gid_begin, string_keys);
+  } else {
+    LOG(ERROR) << "invalid dt of the property index: " << dt->ToString();
+  }
+  if (duplicates != 0) {
+    LOG(WARNING) << "property " << index->id << " of label " << index->label
+                 << " is not unique in fragment " << frag->fid() << ", "
+                 << duplicates << " duplicated values are not indexed";
+  }
+}
+
+void build_property_indices(GraphHandleImpl* handle, const LabelId* labels,
+                            const PropertyId* ids, int count) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ", count = " << count;
+#endif
+  if (count == 0 || handle->local_fnum == 0) {
+    return;
+  }
+  handle->property_indices = new PropertyIndexImpl[count];
+  handle->property_index_num = count;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < count; ++i) {
+    PropertyIndexImpl* index = &handle->property_indices[i];
+    index->label = labels[i];
+    index->id = ids[i];
+    index->string_key = false;
+    index->int_keys.resize(handle->local_fnum);
+    index->string_keys.resize(handle->local_fnum);
+    if (labels[i] < 0 || labels[i] >= handle->vertex_label_num) {
+      LOG(ERROR) << "invalid label of the property index: " << labels[i];
+      continue;
+    }
+    PropertyId col_id =
+        handle->schema->VertexEntries()[labels[i]].reverse_mapping[ids[i]];
+    if (col_id == -1) {
+      LOG(ERROR) << "label " << labels[i] << " has no property " << ids[i];
+      continue;
+    }
+    auto table = handle->fragments[handle->local_fragments[0]]
+                     .vertex_data_table(labels[i]);
+    auto encoding = column_encoding(table.get(), col_id);
+    auto dt = encoding != nullptr ? encoding->type
+                                  : table->field(col_id)->type();
+    index->string_key = dt == arrow::utf8() || dt == arrow::large_utf8();
+    for (FRAG_ID_TYPE j = 0; j < handle->local_fnum; ++j) {
+      FRAGMENT_TYPE* frag = &handle->fragments[handle->local_fragments[j]];
+      threads.emplace_back(build_property_index, frag, col_id, index, j);
+    }
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  LOG(INFO) << "finish building " << count << " property indices";
+}
+
+// Parses the integral key, which has no other character.
+static bool parse_integral_key(const char* key, int64_t& value) {
+  char* end = NULL;
+  errno = 0;
+  value = std::strtoll(key, &end, 10);
+  return end != key && *end == '\0' && errno == 0;
+}
+
+int get_vertices_by_oids(GraphHandleImpl* handle, LabelId label,
+                         const char** keys, int count, VID_TYPE* gids,
+                         uint8_t* found) {
+  if (label < 0 || label >= handle->vertex_label_num) {
+    memset(found, 0, count);
+    return 0;
+  }
+  parallel_for(count, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      int64_t oid;
+      found[i] = parse_integral_key(keys[i], oid) &&
+                 handle->vertex_map->GetGid(label, oid, gids[i]);
+    }
+  });
+  return std::count(found, found + count, 1);
+}
+
+int get_vertices_by_index(const PropertyIndexImpl* index, const char** keys,
+                          int count, VID_TYPE* gids, uint8_t* found) {
+  // looks up the maps of the local fragments in order
+  auto lookup = [&gids](const auto& maps, const auto& key, int64_t i) {
+    for (const auto& keys_of_frag : maps) {
+      auto iter = keys_of_frag.find(key);
+      if (iter != keys_of_frag.end()) {
+        gids[i] = iter->second;
+        return true;
+      }
+    }
+    return false;
+  };
+  parallel_for(count, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      if (index->string_key) {
+        found[i] = lookup(index->string_keys, std::string(keys[i]), i);
+      } else {
+        int64_t key;
+        found[i] = parse_integral_key(keys[i], key) &&
+                   lookup(index->int_keys, key, i);
+      }
+    }
+  });
+  return std::count(found, found + count, 1);
+}
+
+// Fills the endpoints of the edges of the label by the outgoing lists of the
+// inner vertices, and then by the incoming lists for the edges from the outer
+// vertices.
+static void build_edge_index_of_label(FRAGMENT_TYPE* frag, LabelId label,
+                                      std::vector<VID_TYPE>& srcs,
+                                      std::vector<VID_TYPE>& dsts) {
+  auto e_label = static_cast<typename FRAGMENT_TYPE::label_id_t>(label);
+  int64_t edge_num = frag->edge_data_table(label)->num_rows();
+  srcs.resize(edge_num);
+  dsts.resize(edge_num);
+  for (LabelId i = 0; i < frag->vertex_label_num(); ++i) {
+    for (auto v : frag->InnerVertices(i)) {
+      VID_TYPE gid = frag->Vertex2Gid(v);
+      auto adj_list = frag->GetOutgoingAdjList(v, e_label);
+      for (auto e = adj_list.begin_unit(); e != adj_list.end_unit(); ++e) {
+        srcs[e->eid] = gid;
+        dsts[e->eid] = frag->Vertex2Gid(VERTEX_TYPE(e->vid));
+      }
+    }
+  }
+  for (LabelId i = 0; i < frag->vertex_label_num(); ++i) {
+    for (auto v : frag->InnerVertices(i)) {
+      VID_TYPE gid = frag->Vertex2Gid(v);
+      auto adj_list = frag->GetIncomingAdjList(v, e_label);
+      for (auto e = adj_list.begin_unit(); e != adj_list.end_unit(); ++e) {
+        VERTEX_TYPE u(e->vid);
+        if (frag->IsOuterVertex(u)) {
+          srcs[e->eid] = frag->Vertex2Gid(u);
+          dsts[e->eid] = gid;
+        }
+      }
+    }
+  }
+}
+
+void build_edge_index(GraphHandleImpl* handle) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__;
+#endif
+  if (handle->edge_index != NULL) {
+    return;
+  }
+  auto index = new EdgeIndexImpl();
+  index->srcs.resize(handle->local_fnum);
+  index->dsts.resize(handle->local_fnum);
+  std::vector<std::thread> threads;
+  for (FRAG_ID_TYPE i = 0; i < handle->local_fnum; ++i) {
+    FRAGMENT_TYPE* frag = &handle->fragments[handle->local_fragments[i]];
+    index->srcs[i].resize(handle->edge_label_num);
+    index->dsts[i].resize(handle->edge_label_num);
+    for (LabelId j = 0; j < handle->edge_label_num; ++j) {
+      threads.emplace_back(build_edge_index_of_label, frag, j,
+                           std::ref(index->srcs[i][j]),
+                           std::ref(index->dsts[i][j]));
+    }
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+  handle->edge_index = index;
+  LOG(INFO) << "finish building the edge index";
+}
+
+bool get_edge_by_id(GraphHandleImpl* handle, EID_TYPE id, Edge* e_out) {
+  if (handle->edge_index == NULL) {
+    return false;
+  }
+  FRAG_ID_TYPE fid = handle->eid_parser.GetFid(id);
+  LabelId label = handle->eid_parser.GetLabelId(id);
+  int64_t offset = handle->eid_parser.GetOffset(id);
+  auto local = std::find(handle->local_fragments,
+                         handle->local_fragments + handle->local_fnum, fid);
+  if (local == handle->local_fragments + handle->local_fnum || label < 0 ||
+      label >= handle->edge_label_num) {
+    return false;
+  }
+  size_t local_id = local - handle->local_fragments;
+  auto const& srcs = handle->edge_index->srcs[local_id][label];
+  if (offset < 0 || offset >= static_cast<int64_t>(srcs.size())) {
+    return false;
+  }
+  e_out->src = srcs[offset];
+  e_out->dst = handle->edge_index->dsts[local_id][label][offset];
+  e_out->offset = id;
+  return true;
+}
+
+static constexpr int64_t kColdColumnMaxBuffers = 3;
+
+// The spilled file of a column has the header, then each buffer of the array
+// padded to 8 bytes.
+struct ColdColumnHeader {
+  int64_t length;
+  int64_t null_count;
+  int64_t buffer_num;
+  int64_t sizes[kColdColumnMaxBuffers];
+};
+
+static int64_t cold_column_padded(int64_t size) { return (size + 7) / 8 * 8; }
+
+// The whole mapped file, which is unmapped with the last of the buffers
+// sliced from it.
+class MappedFileBuffer : public arrow::Buffer {
+ public:
+  MappedFileBuffer(const uint8_t* data, int64_t size)
+      : arrow::Buffer(data, size) {}
+
+  ~MappedFileBuffer() override {
+    munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+  }
+};
+
+// Writes the buffers of the array to a temporary file, which is renamed to the
+// path at last, so no process maps a partial file.
+static bool spill_column(const std::shared_ptr<arrow::Array>& array,
+                         const std::string& path) {
+  auto data = array->data();
+  ColdColumnHeader header;
+  memset(&header, 0, sizeof(header));
+  header.length = array->length();
+  header.null_count = array->null_count();
+  header.buffer_num = data->buffers.size();
+  if (array->offset() != 0 || !data->child_data.empty() ||
+      header.buffer_num > kColdColumnMaxBuffers) {
+    return false;
+  }
+  for (int64_t i = 0; i < header.buffer_num; ++i) {
+    auto const& buffer = data->buffers[i];
+    header.sizes[i] = buffer == nullptr ? 0 : buffer->size();
+  }
+  std::string tmp_path = path + "." + std::to_string(getpid());
+  FILE* fp = fopen(tmp_path.c_str(), "wb");
+  if (fp == NULL) {
+    return false;
+  }
+  static const char padding[8] = {0};
+  bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+  for (int64_t i = 0; ok && i < header.buffer_num; ++i) {
+    size_t size = header.sizes[i];
+    size_t pad = cold_column_padded(header.sizes[i]) - size;
+    ok = (size == 0 || fwrite(data->buffers[i]->data(), 1, size, fp) == size) &&
+         fwrite(padding, 1, pad, fp) == pad;
+  }
+  ok = fclose(fp) == 0 && ok;
+  ok = ok && rename(tmp_path.c_str(), path.c_str()) == 0;
+  if (!ok) {
+    unlink(tmp_path.c_str());
+  }
+  return ok;
+}
+
+// Maps the spilled file of the array, or returns false if the file is missing
+// or does not match the array.
+static bool map_column(const std::shared_ptr<arrow::Array>& array,
+                       const std::string& path, OverlayColumn& column) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      st.st_size < static_cast<off_t>(sizeof(ColdColumnHeader))) {
+    close(fd);
+    return false;
+  }
+  void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+  auto file = std::make_shared<MappedFileBuffer>(
+      static_cast<const uint8_t*>(addr), st.st_size);
+  auto header = static_cast<const ColdColumnHeader*>(addr);
+  if (header->length != array->length() ||
+      header->buffer_num !=
+          static_cast<int64_t>(array->data()->buffers.size()) ||
+      header->buffer_num > kColdColumnMaxBuffers) {
+    return false;
+  }
+  int64_t expected_size = sizeof(ColdColumnHeader);
+  for (int64_t i = 0; i < header->buffer_num; ++i) {
+    expected_size += cold_column_padded(header->sizes[i]);
+  }
+  if (expected_size != st.st_size) {
+    return false;
+  }
+  std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+  int64_t offset = sizeof(ColdColumnHeader);
+  for (int64_t i = 0; i < header->buffer_num; ++i) {
+    // the validity of the column without nulls is absent
+    if (i == 0 && header->sizes[i] == 0) {
+      buffers.push_back(nullptr);
+    } else {
+      buffers.push_back(arrow::SliceBuffer(file, offset, header->sizes[i]));
+    }
+    offset += cold_column_padded(header->sizes[i]);
+  }
+  column.array = arrow::MakeArray(arrow::ArrayData::Make(
+      array->type(), header->length, buffers, header->null_count));
+  return true;
+}
+
+using overlay_column_item_t =
+    std::pair<const arrow::Table*, std::pair<PropertyId, OverlayColumn>>;
+
+// Publishes the columns by a new copy of the overlay columns, where a column
+// replaces the one of the same table and id if replace, or else is skipped.
+// Returns the number of the columns published.
+static int publish_overlay_columns(
+    const std::vector<overlay_column_item_t>& items, bool replace) {
+  if (items.empty()) {
+    return 0;
+  }
+  int published = 0;
+  std::lock_guard<std::mutex> lock(overlay_columns_mutex);
+  auto columns = overlay_columns == nullptr
+                     ? std::make_shared<overlay_columns_t>()
+                     : std::make_shared<overlay_columns_t>(*overlay_columns);
+  for (auto& item : items) {
+    auto& table_columns = (*columns)[item.first];
+    if (replace) {
+      table_columns[item.second.first] = item.second.second;
+      ++published;
+    } else {
+      published += table_columns.insert(item.second).second;
+    }
+  }
+  std::atomic_store(&overlay_columns,
+                    std::shared_ptr<const overlay_columns_t>(columns));
+  has_overlay_columns.store(true, std::memory_order_release);
+  return published;
+}
+
+// Drops the overlay columns of the kind of the handle.
+static void drop_overlay_columns(GraphHandleImpl* handle, OverlayKind kind) {
+  std::lock_guard<std::mutex> lock(overlay_columns_mutex);
+  if (overlay_columns == nullptr) {
+    return;
+  }
+  auto columns = std::make_shared<overlay_columns_t>();
+  for (auto const& table_columns : *overlay_columns) {
+    for (auto const& column : table_columns.second) {
+      if (column.second.handle != handle ||
+          column.second.kind != kind) {
+        (*columns)[table_columns.first].insert(column);
+      }
+    }
+  }
+  // the files are unmapped, and the tensors released, once the readers
+  // release the arrays
+  std::atomic_store(&overlay_columns,
+                    std::shared_ptr<const overlay_columns_t>(columns));
+}
+
+int map_cold_columns(GraphHandleImpl* handle, const LabelId* labels,
+                     const PropertyId* ids, int count, const std::string& dir) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ", count = " << count;
+#endif
+  std::vector<overlay_column_item_t> mapped;
+  for (int i = 0; i < count; ++i) {
+    if (labels[i] < 0 || labels[i] >= handle->vertex_label_num) {
+      LOG(ERROR) << "invalid label of the cold property: " << labels[i];
+      continue;
+    }
+    PropertyId col_id =
+        handle->schema->VertexEntries()[labels[i]].reverse_mapping[ids[i]];
+    if (col_id == -1) {
+      LOG(ERROR) << "label " << labels[i] << " has no property " << ids[i];
+      continue;
+    }
+    for (FRAG_ID_TYPE j = 0; j < handle->local_fnum; ++j) {
+      FRAGMENT_TYPE* frag = &handle->fragments[handle->local_fragments[j]];
+      std::shared_ptr<arrow::Table> table = frag->vertex_data_table(labels[i]);
+      // the virtual and the encoded columns are not spilled
+      if (col_id >= table->num_columns() ||
+          table->column(col_id)->num_chunks() != 1 ||
+          column_encoding(table.get(), col_id) != nullptr) {
+        continue;
+      }
+      std::shared_ptr<arrow::Array> array = table->column(col_id)->chunk(0);
+      std::string path = dir + "/" + std::to_string(frag->id()) + "_" +
+                         std::to_string(labels[i]) + "_" +
+                         std::to_string(col_id) + ".col";
+      OverlayColumn column;
+      column.handle = handle;
+      column.kind = OverlayKind::kCold;
+      if (!map_column(array, path, column) &&
+          !(spill_column(array, path) && map_column(array, path, column))) {
+        LOG(WARNING) << "failed to map the cold column: " << path;
+        continue;
+      }
+      mapped.emplace_back(table.get(), std::make_pair(col_id, column));
+    }
+  }
+  int inserted = publish_overlay_columns(mapped, false);
+  handle->cold_column_num += inserted;
+  LOG(INFO) << "mapped " << inserted << " cold columns under " << dir;
+  return inserted;
+}
+
+void unmap_cold_columns(GraphHandleImpl* handle) {
+  drop_overlay_columns(handle, OverlayKind::kCold);
+  handle->cold_column_num = 0;
+}
+
+static std::string field_metadata(const std::shared_ptr<arrow::Field>& field,
+                                  const std::string& key) {
+  auto metadata = field->metadata();
+  int index = metadata == nullptr ? -1 : metadata->FindKey(key);
+  return index == -1 ? "" : metadata->value(index);
+}
+
+// The encoding of the field in its metadata, of the keys of
+// gs::PropertyEncoder, or null if the field is not encoded.
+static std::shared_ptr<const ColumnEncoding> parse_column_encoding(
+    const std::shared_ptr<arrow::Field>& field) {
+  std::string encoding = field_metadata(field, "gs.encoding");
+  std::string type = field_metadata(field, "gs.encoding.type");
+  if (encoding.empty()) {
+    return nullptr;
+  }
+  auto result = std::make_shared<ColumnEncoding>();
+  auto code_type = field->type();
+  if (code_type == arrow::int8()) {
+    result->lowest = std::numeric_limits<int8_t>::lowest();
+  } else if (code_type == arrow::int16()) {
+    result->lowest = std::numeric_limits<int16_t>::lowest();
+  } else if (code_type == arrow::int32()) {
+    result->lowest = std::numeric_limits<int32_t>::lowest();
+  } else {
+    return nullptr;
+  }
+  result->base = 0;
+  if (encoding == "frame_of_reference" &&
+      (type == "int32" || type == "int64")) {
+    result->type = type == "int32" ? arrow::int32() : arrow::int64();
+    result->base = std::strtoull(
+        field_metadata(field, "gs.encoding.base").c_str(), NULL, 10);
+    return result;
+  }
+  if (encoding != "dictionary" ||
+      (type != "string" && type != "large_string")) {
+    return nullptr;
+  }
+  result->type = type == "string" ? arrow::utf8() : arrow::large_utf8();
+  // the values each prefixed by its length and ':'
+  std::string packed = field_metadata(field, "gs.encoding.dictionary");
+  size_t pos = 0;
+  while (pos < packed.size()) {
+    size_t colon = packed.find(':', pos);
+    if (colon == std::string::npos) {
+      return nullptr;
+    }
+    size_t length = std::strtoull(packed.c_str() + pos, NULL, 10);
+    if (length > packed.size() - colon - 1) {
+      return nullptr;
+    }
+    result->dictionary.emplace_back(packed, colon + 1, length);
+    pos = colon + 1 + length;
+  }
+  return result;
+}
+
+// Publishes the encodings of the encoded columns of the vertex and the edge
+// tables of the local fragments, so the getters decode the codes, and sets
+// the types of the properties in the schema to the types of the values.
+static void decode_columns(GraphHandleImpl* handle) {
+  std::vector<overlay_column_item_t> items;
+  auto decode_table = [&](const std::shared_ptr<arrow::Table>& table,
+                          bool is_vertex, LabelId label, bool set_type) {
+    for (PropertyId col_id = 0; col_id < table->num_columns(); ++col_id) {
+      auto encoding = parse_column_encoding(table->field(col_id));
+      if (encoding == nullptr || table->column(col_id)->num_chunks() != 1) {
+        continue;
+      }
+      OverlayColumn column;
+      column.handle = handle;
+      column.array = table->column(col_id)->chunk(0);
+      column.kind = OverlayKind::kEncoded;
+      column.encoding = encoding;
+      items.emplace_back(table.get(), std::make_pair(col_id, column));
+      // the encodings are the same in all the fragments
+      if (set_type) {
+        handle->schema->SetColumnType(is_vertex, label, col_id,
+                                      encoding->type);
+      }
+    }
+  };
+  for (FRAG_ID_TYPE i = 0; i < handle->local_fnum; ++i) {
+    FRAGMENT_TYPE* frag = &handle->fragments[handle->local_fragments[i]];
+    for (LabelId label = 0; label < frag->vertex_label_num(); ++label) {
+      decode_table(frag->vertex_data_table(label), true, label, i == 0);
+    }
+    // the edge labels are after the vertex labels in the schema
+    for (LabelId label = 0; label < frag->edge_label_num(); ++label) {
+      decode_table(frag->edge_data_table(label), false,
+                   label + frag->vertex_label_num(), i == 0);
+    }
+  }
+  handle->encoded_column_num += publish_overlay_columns(items, true);
+  if (handle->encoded_column_num != 0) {
+    LOG(INFO) << "decoding " << handle->encoded_column_num
+              << " encoded columns";
+  }
+}
+
+// The array of the elements of the tensor of T, which does not own the
+// memory, or null if the tensor is not of T.
+template <typename T>
+static std::shared_ptr<arrow::Array> tensor_to_array(
+    const std::shared_ptr<vineyard::Object>& chunk,
+    const std::shared_ptr<arrow::DataType>& type) {
+  auto tensor = std::dynamic_pointer_cast<vineyard::Tensor<T>>(chunk);
+  if (tensor == nullptr || tensor->shape().size() != 1) {
+    return nullptr;
+  }
+  int64_t length = tensor->shape()[0];
+  auto buffer = std::make_shared<arrow::Buffer>(
+      reinterpret_cast<const uint8_t*>(tensor->data()), length * sizeof(T));
+  return arrow::MakeArray(
+      arrow::ArrayData::Make(type, length, {nullptr, buffer}, 0));
+}
+
+static std::shared_ptr<arrow::Array> tensor_to_array(
+    const std::shared_ptr<vineyard::Object>& chunk) {
+  auto tensor = std::dynamic_pointer_cast<vineyard::ITensor>(chunk);
+  if (tensor == nullptr) {
+    return nullptr;
+  }
+  switch (tensor->value_type()) {
+  case vineyard::AnyType::Int32:
+    return tensor_to_array<int32_t>(chunk, arrow::int32());
+  case vineyard::AnyType::Int64:
+    return tensor_to_array<int64_t>(chunk, arrow::int64());
+  case vineyard::AnyType::Float:
+    return tensor_to_array<float>(chunk, arrow::float32());
+  case vineyard::AnyType::Double:
+    return tensor_to_array<double>(chunk, arrow::float64());
+  default:
+    return nullptr;
+  }
+}
+
+PropertyId add_virtual_columns(GraphHandleImpl* handle, LabelId label,
+                               const std::string& name, ObjectId tensor_id) {
+#ifndef NDEBUG
+  LOG(INFO) << "enter " << __FUNCTION__ << ", name = " << name;
+#endif
+  if (label < 0 || label >= handle->vertex_label_num ||
+      handle->local_fnum == 0) {
+    LOG(ERROR) << "invalid label of the virtual property: " << label;
+    return -1;
+  }
+  auto global = std::dynamic_pointer_cast<vineyard::GlobalTensor>(
+      handle->client->GetObject(tensor_id));
+  if (global == nullptr) {
+    LOG(ERROR) << "object " << tensor_id << " is not a global tensor";
+    return -1;
+  }
+
+  // a chunk per local fragment, of the values of the inner vertices of the
+  // label in the order of their offsets
+  std::vector<std::pair<FRAGMENT_TYPE*, OverlayColumn>> chunks;
+  for (auto const& chunk : global->LocalPartitions(*handle->client)) {
+    auto tensor = std::dynamic_pointer_cast<vineyard::ITensor>(chunk);
+    if (tensor == nullptr || tensor->partition_index().empty()) {
+      continue;
+    }
+    auto fid = static_cast<FRAG_ID_TYPE>(tensor->partition_index()[0]);
+    if (fid >= handle->fnum ||
+        std::find(handle->local_fragments,
+                  handle->local_fragments + handle->local_fnum,
+                  fid) == handle->local_fragments + handle->local_fnum) {
+      continue;
+    }
+    FRAGMENT_TYPE* frag = &handle->fragments[fid];
+    OverlayColumn column;
+    column.handle = handle;
+    column.array = tensor_to_array(chunk);
+    column.source = chunk;
+    column.kind = OverlayKind::kVirtual;
+    if (column.array == nullptr ||
+        column.array->length() !=
+            static_cast<int64_t>(frag->InnerVertices(label).size())) {
+      LOG(ERROR) << "the chunk of fragment " << fid << " of tensor "
+                 << tensor_id << " does not match label " << label;
+      return -1;
+    }
+    if (!chunks.empty() &&
+        !chunks[0].second.array->type()->Equals(column.array->type())) {
+      LOG(ERROR) << "the chunks of tensor " << tensor_id
+                 << " are of different types";
+      return -1;
+    }
+    chunks.emplace_back(frag, column);
+  }
+  if (chunks.empty()) {
+    LOG(ERROR) << "tensor " << tensor_id << " has no local chunk";
+    return -1;
+  }
+
+  // the property of the name is reused if it is virtual already, so the
+  // results of the next run replace the ones of the last
+  auto& schema = *handle->schema;
+  auto table = chunks[0].first->vertex_data_table(label);
+  PropertyId id = schema.GetPropertyId(name);
+  auto const& entry = schema.VertexEntries()[label];
+  PropertyId col_id =
+      id != -1 && static_cast<size_t>(id) < entry.reverse_mapping.size()
+          ? entry.reverse_mapping[id]
+          : -1;
+  if (col_id != -1 && col_id < table->num_columns()) {
+    LOG(ERROR) << "label " << label << " has the property " << name;
+    return -1;
+  }
+  if (col_id == -1) {
+    id = schema.AddVertexProperty(label, name, chunks[0].second.array->type());
+    if (id == -1) {
+      return -1;
+    }
+    col_id = schema.VertexEntries()[label].reverse_mapping[id];
+  } else if (!schema.GetPropertyType(label, id)->Equals(
+                 chunks[0].second.array->type())) {
+    LOG(ERROR) << "the virtual property " << name << " is of another type";
+    return -1;
+  }
+
+  std::vector<overlay_column_item_t> items;
+  for (auto& chunk : chunks) {
+    auto table = chunk.first->vertex_data_table(label);
+    items.emplace_back(table.get(), std::make_pair(col_id, chunk.second));
+  }
+  handle->virtual_column_num += publish_overlay_columns(items, true);
+  LOG(INFO) << "added the virtual property " << name << " of label " << label
+            << " from tensor " << tensor_id << " as property " << id;
+  return id;
+}
+
+void destroy_iterator(GetVertexIteratorImpl* iter) {
+  free_get_vertex_iterator(iter);
+  free(iter);
+}
+
+void destroy_iterator(GetAllVerticesIteratorImpl* iter) {
+  free_get_all_vertices_iterator(iter);
+  free(iter);
+}
+
+void destroy_iterator(PropertiesIteratorImpl* iter) {
+  free_properties_iterator(iter);
+  free(iter);
+}
+
+void destroy_iterator(EdgeIteratorImpl* iter) {
+  free_edge_iterator(iter);
+  free(iter);
+}
+
+void destroy_iterator(GetAllEdgesIteratorImpl* iter) {
+  free_get_all_edges_iterator(iter);
+  free(iter);
+}
+
 int get_property_as_bool(Property* property, bool* out) {
   if (property->type != BOOL) {
     return -1;
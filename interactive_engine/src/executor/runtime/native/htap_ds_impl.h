@@ -16,7 +16,12 @@
 #ifndef ANALYTICAL_ENGINE_HTAP_HTAP_DS_IMPL_H_
 #define ANALYTICAL_ENGINE_HTAP_HTAP_DS_IMPL_H_
 
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "vineyard/client/client.h"
 #include "vineyard/graph/fragment/arrow_fragment.h"
@@ -36,6 +41,25 @@ using EID_TYPE = typename FRAGMENT_TYPE::eid_t;
 using VERTEX_RANGE_TYPE = std::pair<VID_TYPE, VID_TYPE>;
 using VERTEX_TYPE = typename FRAGMENT_TYPE::vertex_t;
 
+// A hash index on a unique property of the vertices of a label, of which the
+// keys are the values of an integral or a string column. Only the vertices of
+// the local fragments are indexed, by a map per local fragment.
+struct PropertyIndexImpl {
+  LabelId label;
+  PropertyId id;
+  bool string_key;
+  std::vector<std::unordered_map<int64_t, VID_TYPE>> int_keys;
+  std::vector<std::unordered_map<std::string, VID_TYPE>> string_keys;
+};
+
+// The endpoints of the edges of the local fragments by their offsets in the
+// edge tables, so an edge is resolved from its id without a scan. The
+// vectors are by the local fragment, then by the edge label.
+struct EdgeIndexImpl {
+  std::vector<std::vector<std::vector<VID_TYPE>>> srcs;
+  std::vector<std::vector<std::vector<VID_TYPE>>> dsts;
+};
+
 struct GraphHandleImpl {
   vineyard::Client* client;
   FRAGMENT_TYPE* fragments;
@@ -51,6 +75,19 @@ struct GraphHandleImpl {
 
   PartitionId channel_num;
   VID_TYPE** vertex_chunk_sizes;
+
+  PropertyIndexImpl* property_indices;
+  int property_index_num;
+
+  // the number of the columns mapped by map_cold_columns
+  int cold_column_num;
+  // the number of the columns added by add_virtual_columns
+  int virtual_column_num;
+  // the number of the columns encoded by the loader, which are decoded by the
+  // getters, see decode_columns
+  int encoded_column_num;
+
+  EdgeIndexImpl* edge_index;
 };
 
 inline int get_edge_partition_id(EID_TYPE id, GraphHandleImpl* handle) {
@@ -62,8 +99,53 @@ void get_graph_handle(ObjectId id, PartitionId channel_num,
 
 void free_graph_handle(GraphHandleImpl* handle);
 
+// Builds the index on the ids[i]-th column of the labels[i] vertex table for
+// each i, in a thread per index and local fragment.
+void build_property_indices(GraphHandleImpl* handle, const LabelId* labels,
+                            const PropertyId* ids, int count);
+
+// Looks up the gids of the keys, which are the oids of the vertices of the
+// label, setting found[i] if keys[i] exists. Returns the number of the
+// found keys.
+int get_vertices_by_oids(GraphHandleImpl* handle, LabelId label,
+                         const char** keys, int count, VID_TYPE* gids,
+                         uint8_t* found);
+
+// Like get_vertices_by_oids, but the keys are the values of the index.
+int get_vertices_by_index(const PropertyIndexImpl* index, const char** keys,
+                          int count, VID_TYPE* gids, uint8_t* found);
+
+// Builds the edge index of the local fragments, in a thread per local
+// fragment and edge label.
+void build_edge_index(GraphHandleImpl* handle);
+
+// Resolves the edge of the id by the edge index, or returns false if the edge
+// is not in the local fragments.
+bool get_edge_by_id(GraphHandleImpl* handle, EID_TYPE id, Edge* e_out);
+
+// Spills the ids[i]-th column of the labels[i] vertex table of each local
+// fragment to a file under dir, or reuses the file spilled by another process
+// on the node, and maps the file in place of the column for the reads of the
+// property. Returns the number of the columns mapped.
+int map_cold_columns(GraphHandleImpl* handle, const LabelId* labels,
+                     const PropertyId* ids, int count, const std::string& dir);
+
+// Unmaps the cold columns mapped for the handle.
+void unmap_cold_columns(GraphHandleImpl* handle);
+
+// Adds a virtual property of the name to the vertices of the label, of which
+// the values are the local chunks of the global tensor, e.g., the result of an
+// analytical context, a chunk per fragment by the offsets of the inner
+// vertices, read in place without sealing the fragments again. Adding the
+// name again replaces the values. Returns the id of the property, or -1 if
+// the tensor does not match the label. The schema is changed, so it must not
+// run with the queries on the handle.
+PropertyId add_virtual_columns(GraphHandleImpl* handle, LabelId label,
+                               const std::string& name, ObjectId tensor_id);
+
 struct GetVertexIteratorImpl {
   VID_TYPE* ids;
+  int ids_capacity;
   int count;
   int index;
 };
@@ -75,12 +157,35 @@ void free_get_vertex_iterator(GetVertexIteratorImpl* iter);
 
 int get_vertices_next(GetVertexIteratorImpl* iter, Vertex* v_out);
 
+// The vertex ranges of the labels of a fragment split into the morsels of
+// at most morsel_size vertices, which are handed out to the iterators of the
+// threads scanning the fragment by an atomic cursor. Unlike the static sub
+// ranges of the channels, a thread takes the next morsel as soon as it
+// finishes one, so the scan is balanced on the skewed labels.
+struct MorselScanImpl {
+  FRAGMENT_TYPE* fragment;
+  std::vector<VERTEX_RANGE_TYPE> ranges;
+  // the morsels before each range
+  std::vector<size_t> morsel_offsets;
+  VID_TYPE morsel_size;
+  std::atomic<size_t> cursor;
+};
+
+void init_morsel_scan(FRAGMENT_TYPE* frag, LabelId* labels, int labels_count,
+                      int64_t morsel_size, MorselScanImpl* scan);
+
+// Claims the next morsel of the scan, or returns false if there is none.
+bool next_morsel(MorselScanImpl* scan, VERTEX_RANGE_TYPE& morsel);
+
 struct GetAllVerticesIteratorImpl {
   VERTEX_RANGE_TYPE* ranges;
+  int ranges_capacity;
   int range_num;
   int range_id;
 
   VID_TYPE cur_vertex_id;
+  // the scan to claim the next morsel from, if not null
+  MorselScanImpl* scan;
 };
 
 void get_all_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
@@ -92,6 +197,18 @@ void free_get_all_vertices_iterator(GetAllVerticesIteratorImpl* iter);
 
 int get_all_vertices_next(GetAllVerticesIteratorImpl* iter, Vertex* v_out);
 
+void get_morsel_vertices(MorselScanImpl* scan, GetAllVerticesIteratorImpl* out);
+
+// Appends to out the gids of the inner vertices of the label in the sub range
+// of the channel, which satisfy all the predicates, of which the ids are the
+// columns of the vertex table, until out holds limit vertices.
+void scan_vertices(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                   VID_TYPE chunk_size, LabelId label,
+                   const Predicate* predicates, int predicate_count,
+                   size_t limit, std::vector<VID_TYPE>& out);
+
+void set_vertices(const std::vector<VID_TYPE>& ids, GetVertexIteratorImpl* out);
+
 struct PropertiesIteratorImpl {
   GraphHandleImpl* handle;
   arrow::Table* table;
@@ -110,6 +227,11 @@ int get_vertex_property(FRAGMENT_TYPE* frag, Vertex v, PropertyId id,
 void get_vertex_properties(FRAGMENT_TYPE* frag, Vertex v,
                            PropertiesIteratorImpl* iter);
 
+int get_vertices_property(FRAGMENT_TYPE* frag, LabelId label,
+                          const Vertex* vertices, int begin, int end,
+                          PropertyId id, PropertyType type, void* out,
+                          uint8_t* validity);
+
 using NBR_TYPE = typename FRAGMENT_TYPE::nbr_unit_t;
 // using ADJ_LIST_TYPE = std::pair<const NBR_TYPE*, const NBR_TYPE*>;
 struct AdjListUnit {
@@ -125,6 +247,7 @@ struct EdgeIteratorImpl {
 
   int64_t src;
   AdjListUnit* lists;
+  int lists_capacity;
   int list_num;
 
   int list_id;
@@ -140,15 +263,51 @@ void get_out_edges(FRAGMENT_TYPE* frag,
 
 int out_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int out_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int capacity);
+
+int out_edge_next_columns(EdgeIteratorImpl* iter, VertexId* dst_ids,
+                          EdgeId* edge_ids, int capacity);
+
+void get_edges_multi(FRAGMENT_TYPE* frag,
+                     vineyard::IdParser<EID_TYPE>* eid_parser, VertexId* ids,
+                     int count, LabelId* labels, int labels_count,
+                     int64_t limit, bool outgoing, EdgeList* out);
+
+void free_edge_list(EdgeList* edges);
+
+// Writes the degrees of the vertices by the edges of the labels to degrees,
+// where the vertices out of the fragment are of degree 0.
+void get_degrees(FRAGMENT_TYPE* frag, const VertexId* ids, int count,
+                 LabelId* labels, int labels_count, bool outgoing,
+                 int64_t* degrees);
+
+// The number of the inner vertices of the labels in the sub ranges of the
+// channel.
+int64_t get_vertex_count(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                         const VID_TYPE* chunk_sizes, LabelId* labels,
+                         int labels_count);
+
+// The number of the edges of the labels iterated by get_all_edges, i.e., the
+// outgoing edges of the inner vertices in the sub ranges of the channel.
+int64_t get_edge_count(FRAGMENT_TYPE* frag, PartitionId channel_id,
+                       const VID_TYPE* chunk_sizes, LabelId* labels,
+                       int labels_count);
+
 void get_in_edges(FRAGMENT_TYPE* frag, vineyard::IdParser<EID_TYPE>* eid_parser,
                   VertexId dst_id, LabelId* labels, int labels_count,
                   int64_t limit, EdgeIteratorImpl* iter);
 
 int in_edge_next(EdgeIteratorImpl* iter, Edge* e_out);
 
+int in_edge_next_batch(EdgeIteratorImpl* iter, Edge* e_out, int capacity);
+
+int in_edge_next_columns(EdgeIteratorImpl* iter, VertexId* src_ids,
+                         EdgeId* edge_ids, int capacity);
+
 struct GetAllEdgesIteratorImpl {
   FRAGMENT_TYPE* fragment;
   LabelId* e_labels;
+  int e_labels_capacity;
   vineyard::IdParser<EID_TYPE>* eid_parser;
   int e_labels_count;
 
@@ -162,6 +321,8 @@ struct GetAllEdgesIteratorImpl {
 
   int64_t index;
   int64_t limit;
+
+  MorselScanImpl* scan;
 };
 
 void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
@@ -170,12 +331,77 @@ void get_all_edges(FRAGMENT_TYPE* frag, PartitionId channel_id,
                    int labels_count, int64_t limit,
                    GetAllEdgesIteratorImpl* iter);
 
+// Iterates the out edges of the vertices of the morsels claimed from the
+// scan, without a limit.
+void get_morsel_edges(MorselScanImpl* scan,
+                      vineyard::IdParser<EID_TYPE>* eid_parser,
+                      LabelId* labels, int labels_count,
+                      GetAllEdgesIteratorImpl* out);
+
 int get_all_edges_next(GetAllEdgesIteratorImpl* iter, Edge* e_out);
 
+int get_all_edges_next_batch(GetAllEdgesIteratorImpl* iter, Edge* e_out,
+                             int capacity);
+
 void free_edge_iterator(EdgeIteratorImpl* iter);
 
 void free_get_all_edges_iterator(GetAllEdgesIteratorImpl* iter);
 
+// Frees the iterator allocated by IteratorPool, with the arrays it holds.
+void destroy_iterator(GetVertexIteratorImpl* iter);
+void destroy_iterator(GetAllVerticesIteratorImpl* iter);
+void destroy_iterator(PropertiesIteratorImpl* iter);
+void destroy_iterator(EdgeIteratorImpl* iter);
+void destroy_iterator(GetAllEdgesIteratorImpl* iter);
+
+static constexpr size_t kMaxPooledIterators = 1024;
+
+/**
+ * The iterators released on a thread are kept by the thread, along with the
+ * arrays they hold, and reset for the iterators allocated next on it, so the
+ * query path does not go to the allocator per iterator. The arrays are
+ * enlarged only when a query needs more. An iterator may be released on a
+ * thread other than the one allocating it, and a thread keeps up to
+ * kMaxPooledIterators iterators of each type.
+ */
+template <typename ITER_T>
+class IteratorPool {
+ public:
+  // the iterators out of the allocator are zeroed, i.e., of no arrays
+  static ITER_T* Allocate() {
+    auto& iters = local();
+    if (iters.empty()) {
+      return static_cast<ITER_T*>(calloc(1, sizeof(ITER_T)));
+    }
+    ITER_T* iter = iters.back();
+    iters.pop_back();
+    return iter;
+  }
+
+  static void Release(ITER_T* iter) {
+    auto& iters = local();
+    if (iters.size() < kMaxPooledIterators) {
+      iters.push_back(iter);
+    } else {
+      destroy_iterator(iter);
+    }
+  }
+
+ private:
+  struct Pool : public std::vector<ITER_T*> {
+    ~Pool() {
+      for (ITER_T* iter : *this) {
+        destroy_iterator(iter);
+      }
+    }
+  };
+
+  static Pool& local() {
+    static thread_local Pool pool;
+    return pool;
+  }
+};
+
 EdgeId get_edge_id(FRAGMENT_TYPE* frag, LabelId label, int64_t offset);
 
 int get_edge_property(FRAGMENT_TYPE* frag, LabelId label, int64_t offset,
@@ -184,6 +410,11 @@ int get_edge_property(FRAGMENT_TYPE* frag, LabelId label, int64_t offset,
 void get_edge_properties(FRAGMENT_TYPE* frag, LabelId label, int64_t offset,
                          PropertiesIteratorImpl* iter);
 
+int get_edges_property(FRAGMENT_TYPE* frag, LabelId label,
+                       const int64_t* offsets, const int* positions, int n,
+                       PropertyId id, PropertyType type, void* out,
+                       uint8_t* validity);
+
 int properties_next(PropertiesIteratorImpl* iter, Property* p_out);
 
 void free_properties_iterator(PropertiesIteratorImpl* iter);
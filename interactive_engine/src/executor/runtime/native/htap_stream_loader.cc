@@ -15,9 +15,16 @@
  */
 #include <stdio.h>
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <map>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "arrow/array/concatenate.h"
 #include "boost/lexical_cast.hpp"
 #include "glog/logging.h"
 
@@ -31,8 +38,98 @@
 
 #include "htap_ds_impl.h"
 
-using batch_group_t = std::unordered_map<vineyard::htap_types::LABEL_ID_TYPE,
-                     std::vector<std::shared_ptr<arrow::RecordBatch>>>;
+using batch_list_t = std::vector<std::shared_ptr<arrow::RecordBatch>>;
+
+// The batches of a stream are combined once this many rows are pending in a
+// group, so the chunks of the stream are released as they are consumed
+// rather than held until the fragment is built, and the pending ones are a
+// bounded buffer per group.
+static constexpr int64_t kCombineRows = 1 << 20;
+
+// Concatenates the columns of the batches of the same schema into a batch.
+static std::shared_ptr<arrow::RecordBatch> combine_batches(
+    batch_list_t const &batches) {
+  auto schema = batches[0]->schema();
+  int64_t num_rows = 0;
+  for (auto const &batch : batches) {
+    num_rows += batch->num_rows();
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns(schema->num_fields());
+  for (int col = 0; col < schema->num_fields(); ++col) {
+    arrow::ArrayVector arrays;
+    for (auto const &batch : batches) {
+      arrays.emplace_back(batch->column(col));
+    }
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    CHECK_ARROW_ERROR(arrow::Concatenate(arrays, arrow::default_memory_pool(),
+                                         &columns[col]));
+#else
+    CHECK_ARROW_ERROR_AND_ASSIGN(
+        columns[col], arrow::Concatenate(arrays, arrow::default_memory_pool()));
+#endif
+  }
+  return arrow::RecordBatch::Make(schema, num_rows, columns);
+}
+
+// The batches of a label, and src and dst labels for edges, received from a
+// stream, which are combined per kCombineRows as they arrive.
+struct batch_group_builder_t {
+  batch_list_t combined;
+  batch_list_t pending;
+  int64_t pending_rows = 0;
+
+  void Append(std::shared_ptr<arrow::RecordBatch> batch) {
+    pending_rows += batch->num_rows();
+    pending.emplace_back(std::move(batch));
+    if (pending_rows >= kCombineRows) {
+      Combine();
+    }
+  }
+
+  void Combine() {
+    if (!pending.empty()) {
+      combined.emplace_back(combine_batches(pending));
+      pending.clear();
+      pending_rows = 0;
+    }
+  }
+};
+
+// the batches of each label, grouped by the src and dst labels for edges
+using batch_group_t =
+    std::map<vineyard::htap_types::LABEL_ID_TYPE,
+             std::map<std::pair<LabelId, LabelId>, batch_group_builder_t>>;
+
+// Calls func(i) for each i in [0, count), by the threads taking the next i
+// from an atomic counter.
+template <typename FUNC_T>
+static void parallel_for_each(size_t count, const FUNC_T& func) {
+  size_t thread_num = std::min<size_t>(
+      std::max(std::thread::hardware_concurrency(), 1u), count);
+  std::atomic<size_t> next(0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&]() {
+      for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+        func(i);
+      }
+    });
+  }
+  for (auto& thrd : threads) {
+    thrd.join();
+  }
+}
+
+// Parses the integral value of the key in the metadata of the schema of a
+// batch, without converting the whole metadata into a map.
+static int64_t parse_batch_metadata(std::shared_ptr<arrow::RecordBatch> batch,
+                                    const std::string& key) {
+  auto metadata = batch->schema()->metadata();
+  VINEYARD_ASSERT(metadata != nullptr);
+  int index = metadata->FindKey(key);
+  VINEYARD_ASSERT(index != -1, "no " + key + " in the batch metadata");
+  return boost::lexical_cast<int64_t>(metadata->value(index));
+}
 
 static batch_group_t
     gather_chunks_in_stream(vineyard::Client &client,
@@ -47,16 +144,18 @@ static batch_group_t
   VINEYARD_ASSERT(!available_streams.empty());
   graph_schema = available_streams[0]->graph_schema()->ToJSONString();
 
-  batch_group_t batches;
-
   std::string tag = vertex ? "VERTEX" : "EDGE";
 
+  // each stream is pulled into its own groups without locking, and the
+  // groups are merged after all the streams are drained
+  std::vector<batch_group_t> stream_batches(available_streams.size());
   {
-    std::mutex mtx;
     std::vector<std::thread> pull_stream_threads(available_streams.size());
     for (size_t i = 0; i < available_streams.size(); ++i) {
       pull_stream_threads[i] = std::thread([&, i]() {
         auto stream = available_streams[i];
+        auto& batches = stream_batches[i];
+        size_t batch_num = 0, row_num = 0;
         while (true) {
           std::shared_ptr<arrow::RecordBatch> batch = nullptr;
           vineyard::Status status;
@@ -67,20 +166,30 @@ static batch_group_t
           }
           if (status.IsStreamDrained() || status.IsStreamFailed()) {
             LOG(INFO) << "the ith " << tag << " stream stopped: " << i << ", "
-                      << status.ToString();
+                      << status.ToString() << ", receive " << batch_num
+                      << " batches of " << row_num << " rows";
             break;
           }
           VINEYARD_ASSERT(batch != nullptr);
-          std::lock_guard<std::mutex> mtx_guard(mtx);
-          auto metadata = batch->schema()->metadata();
-          LOG(INFO) << "batch schema = " << batch->schema()->ToString(true);
-          std::unordered_map<std::string, std::string> meta_map;
-          metadata->ToUnorderedMap(&meta_map);
-          auto label_id = boost::lexical_cast<vineyard::htap_types::LABEL_ID_TYPE>(
-              meta_map.at("label_id"));
+          auto label_id = static_cast<vineyard::htap_types::LABEL_ID_TYPE>(
+              parse_batch_metadata(batch, "label_id"));
+          std::pair<LabelId, LabelId> src_dst_key(-1, -1);
+          if (!vertex) {
+            src_dst_key.first = parse_batch_metadata(batch, "src_label_id");
+            src_dst_key.second = parse_batch_metadata(batch, "dst_label_id");
+          }
+#ifndef NDEBUG
           LOG(INFO) << "receive " << tag << " batch for label " << label_id
                     << ", size = " << batch->num_rows();
-          batches[label_id].emplace_back(batch);
+#endif
+          batches[label_id][src_dst_key].Append(batch);
+          ++batch_num;
+          row_num += batch->num_rows();
+        }
+        for (auto& group : batches) {
+          for (auto& sub_group : group.second) {
+            sub_group.second.Combine();
+          }
         }
       });
     }
@@ -89,9 +198,42 @@ static batch_group_t
     }
   }
 
+  batch_group_t batches;
+  for (auto& groups : stream_batches) {
+    for (auto& group : groups) {
+      for (auto& sub_group : group.second) {
+        auto& merged = batches[group.first][sub_group.first].combined;
+        merged.insert(merged.end(), sub_group.second.combined.begin(),
+                      sub_group.second.combined.end());
+      }
+    }
+  }
   return batches;
 }
-  
+
+// Concatenates the batches of the groups into tables in parallel, i.e., a
+// table for each label, and src and dst labels for edges.
+static std::vector<std::vector<std::shared_ptr<arrow::Table>>>
+    build_tables(batch_group_t const &batch_groups) {
+  std::vector<batch_list_t const *> lists;
+  std::vector<std::vector<std::shared_ptr<arrow::Table>>> tables;
+  std::vector<std::pair<size_t, size_t>> slots;
+  for (auto const &group : batch_groups) {
+    tables.emplace_back(group.second.size());
+    size_t sub_index = 0;
+    for (auto const &sub_group : group.second) {
+      lists.push_back(&sub_group.second.combined);
+      slots.emplace_back(tables.size() - 1, sub_index++);
+    }
+  }
+  parallel_for_each(lists.size(), [&](size_t i) {
+    std::shared_ptr<arrow::Table> table;
+    VINEYARD_CHECK_OK(vineyard::RecordBatchesToTable(*lists[i], &table));
+    tables[slots[i].first][slots[i].second] = table;
+  });
+  return tables;
+}
+
 static std::vector<std::shared_ptr<arrow::Table>>
     gather_vertex_chunks_in_stream(vineyard::Client &client,
                             std::shared_ptr<vineyard::GlobalPGStream> gs,
@@ -99,11 +241,8 @@ static std::vector<std::shared_ptr<arrow::Table>>
 
   auto batch_groups = gather_chunks_in_stream(client, gs, graph_schema, true);
   std::vector<std::shared_ptr<arrow::Table>> vtables;
-
-  for (auto const &vertices: batch_groups) {
-      std::shared_ptr<arrow::Table> table;
-      VINEYARD_CHECK_OK(vineyard::RecordBatchesToTable(vertices.second, &table));
-      vtables.emplace_back(table);
+  for (auto const &tables : build_tables(batch_groups)) {
+    vtables.insert(vtables.end(), tables.begin(), tables.end());
   }
   return vtables;
 }
@@ -114,28 +253,7 @@ static std::vector<std::vector<std::shared_ptr<arrow::Table>>>
                             std::string &graph_schema) {
 
   auto batch_groups = gather_chunks_in_stream(client, gs, graph_schema, false);
-  std::vector<std::vector<std::shared_ptr<arrow::Table>>> etables;
-
-  for (auto const &edges: batch_groups) {
-    std::map<std::pair<LabelId, LabelId>,
-             std::vector<std::shared_ptr<arrow::RecordBatch>>> sub_batches;
-    for (auto const &batch: edges.second) {
-      auto meta = batch->schema()->metadata();
-      std::unordered_map<std::string, std::string> meta_map;
-      meta->ToUnorderedMap(&meta_map);
-      auto src_label_id = std::strtol(meta_map.at("src_label_id").c_str(), nullptr, 10);
-      auto dst_label_id = std::strtol(meta_map.at("dst_label_id").c_str(), nullptr, 10);
-      sub_batches[std::make_pair(src_label_id, dst_label_id)].emplace_back(batch);
-    }
-    std::vector<std::shared_ptr<arrow::Table>> tables;
-    for (auto const &kv: sub_batches) {
-      std::shared_ptr<arrow::Table> table;
-      VINEYARD_CHECK_OK(vineyard::RecordBatchesToTable(kv.second, &table));
-      tables.emplace_back(table);
-    }
-    etables.emplace_back(tables);
-  }
-  return etables;
+  return build_tables(batch_groups);
 }
 
 int main(int argc, char** argv) {
@@ -167,9 +285,15 @@ int main(int argc, char** argv) {
       client.GetObject(global_streamobject_id));
   VINEYARD_ASSERT(gs != nullptr);
 
-  std::string graph_schema;
+  // the edges are consumed along with the vertices, rather than after them,
+  // so the producer is never blocked on the edges
+  std::string graph_schema, edge_graph_schema;
+  std::vector<std::vector<std::shared_ptr<arrow::Table>>> etables;
+  std::thread edge_thread([&]() {
+    etables = gather_edge_chunks_in_stream(client, gs, edge_graph_schema);
+  });
   auto vtables = gather_vertex_chunks_in_stream(client, gs, graph_schema);
-  auto etables = gather_edge_chunks_in_stream(client, gs, graph_schema);
+  edge_thread.join();
 
   MPI_Barrier(comm_spec.comm());
 
@@ -0,0 +1,103 @@
+/**
+ * Copyright 2020 Alibaba Group Holding Limited.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "htap_trace.h"
+
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace htap_impl {
+
+static std::mutex& trace_counters_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+static std::vector<TraceCounter*>& trace_counters() {
+  static std::vector<TraceCounter*> counters;
+  return counters;
+}
+
+TraceCounter::TraceCounter(const char* name)
+    : name(name), calls(0), sampled(0), sampled_ns(0), bytes(0) {
+  for (int i = 0; i < kTraceBucketNum; ++i) {
+    buckets[i].store(0);
+  }
+  std::lock_guard<std::mutex> lock(trace_counters_mutex());
+  trace_counters().push_back(this);
+}
+
+TraceScope::~TraceScope() {
+  if (!sampled_) {
+    return;
+  }
+  uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - begin_)
+                    .count();
+  int bucket = 0;
+  while (bucket + 1 < kTraceBucketNum && (ns >> (bucket + 1)) != 0) {
+    ++bucket;
+  }
+  counter_->sampled.fetch_add(1, std::memory_order_relaxed);
+  counter_->sampled_ns.fetch_add(ns, std::memory_order_relaxed);
+  counter_->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string dump_trace_counters() {
+  std::lock_guard<std::mutex> lock(trace_counters_mutex());
+  std::ostringstream os;
+  os << "[";
+  bool first = true;
+  for (auto counter : trace_counters()) {
+    uint64_t calls = counter->calls.load(std::memory_order_relaxed);
+    if (calls == 0) {
+      continue;
+    }
+    uint64_t sampled = counter->sampled.load(std::memory_order_relaxed);
+    uint64_t sampled_ns = counter->sampled_ns.load(std::memory_order_relaxed);
+    if (!first) {
+      os << ",";
+    }
+    first = false;
+    os << "{\"name\":\"" << counter->name << "\",\"calls\":" << calls
+       << ",\"sampled\":" << sampled
+       << ",\"avg_ns\":" << (sampled == 0 ? 0 : sampled_ns / sampled)
+       << ",\"bytes\":" << counter->bytes.load(std::memory_order_relaxed)
+       << ",\"buckets\":[";
+    for (int i = 0; i < kTraceBucketNum; ++i) {
+      os << (i == 0 ? "" : ",")
+         << counter->buckets[i].load(std::memory_order_relaxed);
+    }
+    os << "]}";
+  }
+  os << "]";
+  return os.str();
+}
+
+void reset_trace_counters() {
+  std::lock_guard<std::mutex> lock(trace_counters_mutex());
+  for (auto counter : trace_counters()) {
+    counter->calls.store(0);
+    counter->sampled.store(0);
+    counter->sampled_ns.store(0);
+    counter->bytes.store(0);
+    for (int i = 0; i < kTraceBucketNum; ++i) {
+      counter->buckets[i].store(0);
+    }
+  }
+}
+
+}  // namespace htap_impl
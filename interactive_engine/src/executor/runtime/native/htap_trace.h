@@ -0,0 +1,90 @@
+/**
+ * Copyright 2020 Alibaba Group Holding Limited.
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef ANALYTICAL_ENGINE_HTAP_HTAP_TRACE_H_
+#define ANALYTICAL_ENGINE_HTAP_HTAP_TRACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace htap_impl {
+
+static constexpr int kTraceBucketNum = 40;
+static constexpr uint32_t kTraceSampleRate = 64;
+
+// The counters of the calls of an FFI function, which register themselves
+// on construction. The calls and the bytes returned are counted on every
+// call, while the latency is measured on one of kTraceSampleRate calls of
+// each thread, into the buckets of the powers of two of the nanoseconds.
+struct TraceCounter {
+  explicit TraceCounter(const char* name);
+
+  const char* name;
+  std::atomic<uint64_t> calls;
+  std::atomic<uint64_t> sampled;
+  std::atomic<uint64_t> sampled_ns;
+  std::atomic<uint64_t> bytes;
+  std::atomic<uint64_t> buckets[kTraceBucketNum];
+};
+
+// Counts a call to the counter, and measures it if it is sampled.
+class TraceScope {
+ public:
+  explicit TraceScope(TraceCounter* counter) : counter_(counter) {
+    counter_->calls.fetch_add(1, std::memory_order_relaxed);
+    static thread_local uint32_t tick = 0;
+    sampled_ = (++tick % kTraceSampleRate == 0);
+    if (sampled_) {
+      begin_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceScope();
+
+  void AddBytes(size_t bytes) {
+    counter_->bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+ private:
+  TraceCounter* counter_;
+  bool sampled_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+// Dumps the counters with any call as a JSON array, of which each element
+// has the name, calls, sampled, avg_ns, bytes and the buckets of the
+// histogram, where the i-th bucket counts the sampled calls in
+// [2^i, 2^(i+1)) ns.
+std::string dump_trace_counters();
+
+void reset_trace_counters();
+
+}  // namespace htap_impl
+
+// The tracing is compiled in only with -DHTAP_TRACE, see the HTAP_TRACE
+// option of CMakeLists.txt, or else the macros are empty.
+#ifdef HTAP_TRACE
+#define HTAP_TRACE_SCOPE(name)                                 \
+  static ::htap_impl::TraceCounter __htap_trace_counter(name); \
+  ::htap_impl::TraceScope __htap_trace_scope(&__htap_trace_counter)
+#define HTAP_TRACE_BYTES(bytes) __htap_trace_scope.AddBytes(bytes)
+#else
+#define HTAP_TRACE_SCOPE(name)
+#define HTAP_TRACE_BYTES(bytes)
+#endif
+
+#endif  // ANALYTICAL_ENGINE_HTAP_HTAP_TRACE_H_
@@ -98,24 +98,50 @@ PropertyTableAppender::PropertyTableAppender(
     std::shared_ptr<arrow::DataType> type = field->type();
     if (type == arrow::boolean()) {
       funcs_.push_back(AppendProperty<bool>::append);
+      column_funcs_.push_back(
+          AppendColumn<uint8_t, arrow::BooleanBuilder>::append);
+      column_types_.push_back(BOOL);
     } else if (type == arrow::int8()) {
       funcs_.push_back(AppendProperty<char>::append);
+      column_funcs_.push_back(AppendColumn<int8_t, arrow::Int8Builder>::append);
+      column_types_.push_back(CHAR);
     } else if (type == arrow::int16()) {
       funcs_.push_back(AppendProperty<int16_t>::append);
+      column_funcs_.push_back(
+          AppendColumn<int16_t, arrow::Int16Builder>::append);
+      column_types_.push_back(SHORT);
     } else if (type == arrow::int32()) {
       funcs_.push_back(AppendProperty<int32_t>::append);
+      column_funcs_.push_back(
+          AppendColumn<int32_t, arrow::Int32Builder>::append);
+      column_types_.push_back(INT);
     } else if (type == arrow::int64()) {
       funcs_.push_back(AppendProperty<int64_t>::append);
+      column_funcs_.push_back(
+          AppendColumn<int64_t, arrow::Int64Builder>::append);
+      column_types_.push_back(LONG);
     } else if (type == arrow::float32()) {
       funcs_.push_back(AppendProperty<float>::append);
+      column_funcs_.push_back(AppendColumn<float, arrow::FloatBuilder>::append);
+      column_types_.push_back(FLOAT);
     } else if (type == arrow::float64()) {
       funcs_.push_back(AppendProperty<double>::append);
+      column_funcs_.push_back(
+          AppendColumn<double, arrow::DoubleBuilder>::append);
+      column_types_.push_back(DOUBLE);
     } else if (type == arrow::large_utf8()) {
       funcs_.push_back(AppendProperty<std::string>::append);
+      column_funcs_.push_back(
+          AppendColumn<std::string, arrow::LargeStringBuilder>::append);
+      column_types_.push_back(STRING);
     } else if (type->id() == arrow::Type::TIMESTAMP) {
       funcs_.push_back(AppendProperty<arrow::TimestampType>::append);
+      column_funcs_.push_back(AppendColumn<void, void>::append);
+      column_types_.push_back(INVALID);
     } else if (type == arrow::null()) {
       funcs_.push_back(AppendProperty<void>::append);
+      column_funcs_.push_back(AppendColumn<void, void>::append);
+      column_types_.push_back(INVALID);
     } else {
       LOG(FATAL) << "Datatype [" << type->ToString() << "] not implemented...";
     }
@@ -177,6 +203,45 @@ void PropertyTableAppender::Apply(
   }
 }
 
+void PropertyTableAppender::ApplyColumns(
+    std::unique_ptr<arrow::RecordBatchBuilder>& builder,
+    std::vector<VertexId const*> const& id_columns, size_t size,
+    size_t column_size, PropertyColumn const* columns,
+    std::map<int, int> const& property_id_mapping,
+    std::vector<std::shared_ptr<arrow::RecordBatch>>& batches_out) {
+  VINEYARD_ASSERT(col_num_ == id_columns.size() + column_size);
+  std::vector<int> indices(column_size);
+  for (size_t k = 0; k < column_size; ++k) {
+    indices[k] = property_id_mapping.at(columns[k].id);
+    VINEYARD_ASSERT(column_types_[indices[k]] == columns[k].type,
+                    "mismatched type of property column " +
+                        std::to_string(columns[k].id));
+  }
+  size_t capacity = builder->initial_capacity();
+  size_t offset = 0;
+  while (offset < size) {
+    // fills up the builder at most, to flush the batches as Apply does
+    size_t length = std::min(size - offset,
+                             capacity - builder->GetField(0)->length());
+    for (size_t j = 0; j < id_columns.size(); ++j) {
+      CHECK_ARROW_ERROR(
+          dynamic_cast<typename ConvertToArrowType<VertexId>::BuilderType*>(
+              builder->GetField(j))
+              ->AppendValues(id_columns[j] + offset, length));
+    }
+    for (size_t k = 0; k < column_size; ++k) {
+      column_funcs_[indices[k]](builder->GetField(indices[k]), columns[k],
+                                offset, length);
+    }
+    offset += length;
+    if (static_cast<size_t>(builder->GetField(0)->length()) == capacity) {
+      std::shared_ptr<arrow::RecordBatch> batch_out = nullptr;
+      CHECK_ARROW_ERROR(builder->Flush(&batch_out));
+      batches_out.emplace_back(batch_out);
+    }
+  }
+}
+
 void PropertyTableAppender::Flush(
     std::unique_ptr<arrow::RecordBatchBuilder>& builder,
     std::shared_ptr<arrow::RecordBatch>& batches_out, bool allow_empty) {
@@ -203,17 +268,7 @@ void PropertyGraphOutStream::AddVertex(VertexId id, LabelId labelid,
   std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
   appender->Apply(builder, id, property_size, properties,
                   vertex_property_id_mapping_[labelid], batch_chunk);
-  if (batch_chunk != nullptr && vertex_primary_key_column_[labelid] != -1) {
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-    ARROW_OK_OR_RAISE(
-      batch_chunk->RemoveColumn(vertex_primary_key_column_[labelid], &batch_chunk));
-#else
-    CHECK_ARROW_ERROR_AND_ASSIGN(batch_chunk,
-      batch_chunk->RemoveColumn(vertex_primary_key_column_[labelid]));
-#endif
-  }
-  this->buildTableChunk(batch_chunk, vertex_stream_, vertex_writer_, 1,
-                        vertex_property_id_mapping_[labelid]);
+  this->buildVertexChunk(labelid, batch_chunk);
 }
 
 void PropertyGraphOutStream::AddEdge(EdgeId edge_id, VertexId src_id,
@@ -226,26 +281,7 @@ void PropertyGraphOutStream::AddEdge(EdgeId edge_id, VertexId src_id,
             << ", labelid = " << label
             << ", property_size = " << property_size;
 #endif
-  auto src_dst_key = std::make_pair(src_label, dst_label);
-  if (edge_builders_[label][src_dst_key] == nullptr) {
-    std::shared_ptr<arrow::KeyValueMetadata> metadata;
-    if (edge_schemas_[label]->metadata() != nullptr) {
-      metadata = edge_schemas_[label]->metadata()->Copy();
-    } else {
-      metadata.reset(new arrow::KeyValueMetadata());
-    }
-    metadata->Append("src_label_id", std::to_string(src_label));
-    metadata->Append("src_label", graph_schema_->GetLabelName(src_label));
-    metadata->Append("dst_label_id", std::to_string(dst_label));
-    metadata->Append("dst_label", graph_schema_->GetLabelName(dst_label));
-    auto schema = edge_schemas_[label]->WithMetadata(metadata);
-
-    std::unique_ptr<arrow::RecordBatchBuilder> builder = nullptr;
-    CHECK_ARROW_ERROR(arrow::RecordBatchBuilder::Make(
-        schema, arrow::default_memory_pool(), 10240, &builder));
-    edge_builders_[label][src_dst_key].reset(builder.release());
-  }
-  auto &builder = edge_builders_[label][src_dst_key];
+  auto &builder = edgeBuilder(label, src_label, dst_label);
   auto &appender = edge_appenders_[label];
   VINEYARD_ASSERT(appender != nullptr, "edge label = " + std::to_string(label));
   std::shared_ptr<arrow::RecordBatch> batch_chunk = nullptr;
@@ -283,6 +319,53 @@ void PropertyGraphOutStream::AddEdges(size_t edge_size, EdgeId* edge_ids,
   }
 }
 
+void PropertyGraphOutStream::AddVerticesColumnar(LabelId labelid,
+                                                 size_t vertex_size,
+                                                 VertexId* ids,
+                                                 size_t column_size,
+                                                 PropertyColumn* columns) {
+#ifndef NDEBUG
+  LOG(INFO) << "add vertices columnar: labelid = " << labelid
+            << ", vertex_size = " << vertex_size
+            << ", column_size = " << column_size;
+#endif
+  auto& builder = vertex_builders_[labelid];
+  auto& appender = vertex_appenders_[labelid];
+  VINEYARD_ASSERT(builder != nullptr && appender != nullptr);
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batch_chunks;
+  appender->ApplyColumns(builder, {ids}, vertex_size, column_size, columns,
+                         vertex_property_id_mapping_[labelid], batch_chunks);
+  for (auto const& batch_chunk : batch_chunks) {
+    this->buildVertexChunk(labelid, batch_chunk);
+  }
+}
+
+void PropertyGraphOutStream::AddEdgesColumnar(LabelId label,
+                                              LabelId src_label,
+                                              LabelId dst_label,
+                                              size_t edge_size,
+                                              VertexId* src_ids,
+                                              VertexId* dst_ids,
+                                              size_t column_size,
+                                              PropertyColumn* columns) {
+#ifndef NDEBUG
+  LOG(INFO) << "add edges columnar: labelid = " << label
+            << ", edge_size = " << edge_size
+            << ", column_size = " << column_size;
+#endif
+  auto &builder = edgeBuilder(label, src_label, dst_label);
+  auto &appender = edge_appenders_[label];
+  VINEYARD_ASSERT(appender != nullptr, "edge label = " + std::to_string(label));
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batch_chunks;
+  appender->ApplyColumns(builder, {src_ids, dst_ids}, edge_size, column_size,
+                         columns, edge_property_id_mapping_[label],
+                         batch_chunks);
+  for (auto const& batch_chunk : batch_chunks) {
+    this->buildTableChunk(batch_chunk, edge_stream_, edge_writer_, 2,
+                          edge_property_id_mapping_[label]);
+  }
+}
+
 Status PropertyGraphOutStream::Abort() {
   VINEYARD_CHECK_OK(vertex_writer_->Abort());
   VINEYARD_CHECK_OK(edge_writer_->Abort());
@@ -402,6 +485,45 @@ void PropertyGraphOutStream::initialTables() {
   }
 }
 
+std::unique_ptr<arrow::RecordBatchBuilder>& PropertyGraphOutStream::edgeBuilder(
+    LabelId label, LabelId src_label, LabelId dst_label) {
+  auto src_dst_key = std::make_pair(src_label, dst_label);
+  if (edge_builders_[label][src_dst_key] == nullptr) {
+    std::shared_ptr<arrow::KeyValueMetadata> metadata;
+    if (edge_schemas_[label]->metadata() != nullptr) {
+      metadata = edge_schemas_[label]->metadata()->Copy();
+    } else {
+      metadata.reset(new arrow::KeyValueMetadata());
+    }
+    metadata->Append("src_label_id", std::to_string(src_label));
+    metadata->Append("src_label", graph_schema_->GetLabelName(src_label));
+    metadata->Append("dst_label_id", std::to_string(dst_label));
+    metadata->Append("dst_label", graph_schema_->GetLabelName(dst_label));
+    auto schema = edge_schemas_[label]->WithMetadata(metadata);
+
+    std::unique_ptr<arrow::RecordBatchBuilder> builder = nullptr;
+    CHECK_ARROW_ERROR(arrow::RecordBatchBuilder::Make(
+        schema, arrow::default_memory_pool(), 10240, &builder));
+    edge_builders_[label][src_dst_key].reset(builder.release());
+  }
+  return edge_builders_[label][src_dst_key];
+}
+
+void PropertyGraphOutStream::buildVertexChunk(
+    LabelId labelid, std::shared_ptr<arrow::RecordBatch> batch) {
+  if (batch != nullptr && vertex_primary_key_column_[labelid] != -1) {
+#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
+    ARROW_OK_OR_RAISE(
+      batch->RemoveColumn(vertex_primary_key_column_[labelid], &batch));
+#else
+    CHECK_ARROW_ERROR_AND_ASSIGN(batch,
+      batch->RemoveColumn(vertex_primary_key_column_[labelid]));
+#endif
+  }
+  this->buildTableChunk(batch, vertex_stream_, vertex_writer_, 1,
+                        vertex_property_id_mapping_[labelid]);
+}
+
 void PropertyGraphOutStream::buildTableChunk(
     std::shared_ptr<arrow::RecordBatch> batch,
     std::shared_ptr<vineyard::DataframeStream> &output_stream,
@@ -441,17 +563,7 @@ void PropertyGraphOutStream::FinishAllVertices() {
 #ifndef NDEBUG
     LOG(INFO) << "finish vertices: " << batch;
 #endif
-    if (batch != nullptr && vertex_primary_key_column_[vertices.first] != -1) {
-#if defined(ARROW_VERSION) && ARROW_VERSION < 17000
-      ARROW_OK_OR_RAISE(
-        batch->RemoveColumn(vertex_primary_key_column_[vertices.first], &batch));
-#else
-      CHECK_ARROW_ERROR_AND_ASSIGN(batch,
-        batch->RemoveColumn(vertex_primary_key_column_[vertices.first]));
-#endif
-    }
-    buildTableChunk(batch, vertex_stream_, vertex_writer_, 1,
-                    vertex_property_id_mapping_[vertices.first]);
+    buildVertexChunk(vertices.first, batch);
   }
   VINEYARD_CHECK_OK(vertex_writer_->Finish());
   vertex_finished_ = true;
@@ -153,6 +153,52 @@ void generic_appender(arrow::ArrayBuilder* builder, T const& value) {
 using property_appender_func = void (*)(arrow::ArrayBuilder*,
                                         Property const* prop);
 
+// append the values [offset, offset + length) of a column in bulk.
+template <typename T, typename BuilderType>
+struct AppendColumn {
+  static void append(arrow::ArrayBuilder* builder, PropertyColumn const& column,
+                     size_t offset, size_t length) {
+    auto values = static_cast<T const*>(column.values) + offset;
+    auto valid_bytes =
+        column.valid_bytes == nullptr ? nullptr : column.valid_bytes + offset;
+    CHECK_ARROW_ERROR(dynamic_cast<BuilderType*>(builder)->AppendValues(
+        values, length, valid_bytes));
+  }
+};
+
+template <>
+struct AppendColumn<std::string, arrow::LargeStringBuilder> {
+  static void append(arrow::ArrayBuilder* builder, PropertyColumn const& column,
+                     size_t offset, size_t length) {
+    auto string_builder = dynamic_cast<arrow::LargeStringBuilder*>(builder);
+    auto offsets = static_cast<int64_t const*>(column.values);
+    CHECK_ARROW_ERROR(string_builder->Reserve(length));
+    CHECK_ARROW_ERROR(string_builder->ReserveData(offsets[offset + length] -
+                                                  offsets[offset]));
+    for (size_t i = offset; i < offset + length; ++i) {
+      if (column.valid_bytes != nullptr && column.valid_bytes[i] == 0) {
+        CHECK_ARROW_ERROR(string_builder->AppendNull());
+      } else {
+        CHECK_ARROW_ERROR(string_builder->Append(
+            reinterpret_cast<uint8_t const*>(column.data + offsets[i]),
+            offsets[i + 1] - offsets[i]));
+      }
+    }
+  }
+};
+
+template <>
+struct AppendColumn<void, void> {
+  static void append(arrow::ArrayBuilder* builder, PropertyColumn const& column,
+                     size_t offset, size_t length) {
+    LOG(FATAL) << "Unimplemented...";
+  }
+};
+
+using column_appender_func = void (*)(arrow::ArrayBuilder*,
+                                      PropertyColumn const& column,
+                                      size_t offset, size_t length);
+
 class PropertyTableAppender {
  public:
   explicit PropertyTableAppender(std::shared_ptr<arrow::Schema> schema);
@@ -171,12 +217,25 @@ class PropertyTableAppender {
              std::map<int, int> const& property_id_mapping,
              std::shared_ptr<arrow::RecordBatch>& batch_out);
 
+  // apply for a batch of vertices or edges of the same label, given by the
+  // id columns (the vertex ids, or the src and dst ids) and the property
+  // columns, in bulk. The mapping of the property ids is resolved once per
+  // batch, and a record batch is flushed per initial capacity of the builder.
+  void ApplyColumns(std::unique_ptr<arrow::RecordBatchBuilder>& builder,
+                    std::vector<VertexId const*> const& id_columns,
+                    size_t size, size_t column_size,
+                    PropertyColumn const* columns,
+                    std::map<int, int> const& property_id_mapping,
+                    std::vector<std::shared_ptr<arrow::RecordBatch>>& batches_out);
+
   void Flush(std::unique_ptr<arrow::RecordBatchBuilder>& builder,
              std::shared_ptr<arrow::RecordBatch>& batches_out,
              const bool allow_empty = false);
 
  private:
   std::vector<property_appender_func> funcs_;
+  std::vector<column_appender_func> column_funcs_;
+  std::vector<::PropertyType> column_types_;
   size_t col_num_;
 };
 
@@ -284,6 +343,13 @@ class PropertyGraphOutStream : public Registered<PropertyGraphOutStream> {
                 LabelId* dst_labels, size_t* property_sizes,
                 Property* properties);
 
+  void AddVerticesColumnar(LabelId labelid, size_t vertex_size, VertexId* ids,
+                           size_t column_size, PropertyColumn* columns);
+
+  void AddEdgesColumnar(LabelId label, LabelId src_label, LabelId dst_label,
+                        size_t edge_size, VertexId* src_ids, VertexId* dst_ids,
+                        size_t column_size, PropertyColumn* columns);
+
   Status Abort();
 
   Status Finish();
@@ -294,6 +360,11 @@ class PropertyGraphOutStream : public Registered<PropertyGraphOutStream> {
 
  private:
   void initialTables();
+  std::unique_ptr<arrow::RecordBatchBuilder>& edgeBuilder(LabelId label,
+                                                          LabelId src_label,
+                                                          LabelId dst_label);
+  void buildVertexChunk(LabelId labelid,
+                        std::shared_ptr<arrow::RecordBatch> batch);
   void buildTableChunk(std::shared_ptr<arrow::RecordBatch> batch,
                        std::shared_ptr<vineyard::DataframeStream> &output_stream,
                        std::unique_ptr<vineyard::DataframeStreamWriter>& stream_writer,
@@ -28,6 +28,7 @@ use byteorder::WriteBytesExt;
 pub type GraphHandle = *const ::libc::c_void;
 pub type GraphId = i64;
 type GetVertexIterator = *const ::libc::c_void;
+type MorselScan = *const ::libc::c_void;
 type GetAllVerticesIterator = *const ::libc::c_void;
 type VertexHandle = i64;
 pub(crate) type PropertyId = i32;
@@ -47,7 +48,7 @@ const STATE_FAILED: i32 = -1;
 
 
 #[repr(C)]
-#[derive(Debug)]
+#[derive(Debug, Clone, Copy)]
 pub struct EdgeHandle {
     src: i64,
     dst: i64,
@@ -64,6 +65,17 @@ impl EdgeHandle {
     }
 }
 
+/// The adjacent edges of multiple vertices in CSR, the edges of the i-th vertex
+/// are in [offsets[i], offsets[i + 1]) of nbr_ids and edge_ids
+#[repr(C)]
+#[derive(Debug)]
+pub struct EdgeList {
+    offsets: *const i64,
+    nbr_ids: *const VertexId,
+    edge_ids: *const EdgeId,
+    count: i32,
+}
+
 #[repr(C)]
 #[derive(Debug)]
 pub enum PropertyType {
@@ -83,6 +95,30 @@ pub enum PropertyType {
     StringList = 14,
 }
 
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub enum CompareOp {
+    Eq = 0,
+    Ne = 1,
+    Lt = 2,
+    Le = 3,
+    Gt = 4,
+    Ge = 5,
+    Between = 6,
+    Within = 7,
+}
+
+/// a predicate on a property evaluated in the native store, where values are
+/// value_count constants of the property type
+#[repr(C)]
+pub struct Predicate {
+    id: PropertyId,
+    op: CompareOp,
+    r#type: PropertyType,
+    values: *const ::libc::c_void,
+    value_count: i32,
+}
+
 #[repr(C)]
 pub struct NativeProperty {
     id: i32,
@@ -101,7 +137,12 @@ pub struct WriteNativeProperty {
 
 extern {
     fn get_graph_handle(graph_id: GraphId, channel_num: FFIPartitionId) -> GraphHandle;
+    fn get_graph_handle_with_indices(graph_id: GraphId, channel_num: FFIPartitionId, labels: *const FFILabelId, property_ids: *const PropertyId, index_count: i32) -> GraphHandle;
     fn free_graph_handle(handle: GraphHandle);
+    fn set_cold_properties(graph: GraphHandle, labels: *const FFILabelId, property_ids: *const PropertyId, count: i32, dir: *const ::libc::c_char) -> i32;
+    fn add_virtual_vertex_property(graph: GraphHandle, label: FFILabelId, name: *const ::libc::c_char, tensor_id: GraphId) -> PropertyId;
+    fn get_shared_graph_handle(graph_id: GraphId, channel_num: FFIPartitionId) -> GraphHandle;
+    fn release_graph_handle(handle: GraphHandle);
 
     fn get_vertices(graph: GraphHandle, partition_id: FFIPartitionId, label: *const FFILabelId, ids: *const VertexId, count: i32) -> GetVertexIterator;
     fn free_get_vertex_iterator(iter: GetVertexIterator);
@@ -110,11 +151,14 @@ extern {
     fn get_all_vertices(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, limit: i64) -> GetAllVerticesIterator;
     fn free_get_all_vertices_iterator(iter: GetAllVerticesIterator);
     fn get_all_vertices_next(iter: GetAllVerticesIterator, v_out: *mut VertexHandle) -> FFIState;
+    fn scan_vertices(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, predicates: *const Predicate, predicate_count: i32, limit: i64) -> GetVertexIterator;
+    fn get_vertex_count(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32) -> i64;
 
     fn get_vertex_id(graph: GraphHandle, v: VertexHandle) -> VertexId;
     fn get_vertex_label(graph: GraphHandle, v: VertexHandle) -> LabelId;
     fn get_vertex_property(graph: GraphHandle, v: VertexHandle, id: PropertyId, p_out: *mut NativeProperty) -> FFIState;
     fn get_vertex_properties(graph: GraphHandle, v: VertexHandle) -> PropertiesIterator;
+    fn get_vertices_property(graph: GraphHandle, vertices: *const VertexHandle, count: i32, id: PropertyId, property_type: PropertyType, out: *mut ::libc::c_void, validity: *mut u8) -> i32;
 
     fn free_properties_iterator(iter: PropertiesIterator);
     fn properties_next(iter: PropertiesIterator, p_out: *mut NativeProperty) -> FFIState;
@@ -122,23 +166,42 @@ extern {
     fn get_out_edges(graph: GraphHandle, partition_id: FFIPartitionId, src_id: VertexId, labels: *const FFILabelId, label_count: i32, limit: i64) -> OutEdgeIterator;
     fn free_out_edge_iterator(iter: OutEdgeIterator);
     fn out_edge_next(iter: OutEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn out_edge_next_batch(iter: OutEdgeIterator, e_out: *mut EdgeHandle, capacity: i32) -> i32;
+
+    fn get_out_edges_multi(graph: GraphHandle, partition_id: FFIPartitionId, src_ids: *const VertexId, src_ids_count: i32, labels: *const FFILabelId, label_count: i32, limit: i64) -> *mut EdgeList;
+    fn get_in_edges_multi(graph: GraphHandle, partition_id: FFIPartitionId, dst_ids: *const VertexId, dst_ids_count: i32, labels: *const FFILabelId, label_count: i32, limit: i64) -> *mut EdgeList;
+    fn free_edge_list(edges: *mut EdgeList);
+    fn get_out_degree(graph: GraphHandle, partition_id: FFIPartitionId, src_id: VertexId, labels: *const FFILabelId, label_count: i32) -> i64;
+    fn get_in_degree(graph: GraphHandle, partition_id: FFIPartitionId, dst_id: VertexId, labels: *const FFILabelId, label_count: i32) -> i64;
+    fn get_out_degrees(graph: GraphHandle, partition_id: FFIPartitionId, src_ids: *const VertexId, count: i32, labels: *const FFILabelId, label_count: i32, degrees_out: *mut i64);
+    fn get_in_degrees(graph: GraphHandle, partition_id: FFIPartitionId, dst_ids: *const VertexId, count: i32, labels: *const FFILabelId, label_count: i32, degrees_out: *mut i64);
+    fn get_edge_count(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32) -> i64;
 
     fn get_in_edges(graph: GraphHandle, partition_id: FFIPartitionId, dst_id: VertexId, labels: *const FFILabelId, label_count: i32, limit: i64) -> InEdgeIterator;
     fn free_in_edge_iterator(iter: InEdgeIterator);
     fn in_edge_next(iter: InEdgeIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn in_edge_next_batch(iter: InEdgeIterator, e_out: *mut EdgeHandle, capacity: i32) -> i32;
 
+    fn create_morsel_scan(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, morsel_size: i64) -> MorselScan;
+    fn free_morsel_scan(scan: MorselScan);
+    fn get_morsel_vertices(graph: GraphHandle, scan: MorselScan) -> GetAllVerticesIterator;
+    fn get_morsel_edges(graph: GraphHandle, scan: MorselScan, labels: *const FFILabelId, label_count: i32) -> GetAllEdgesIterator;
     fn get_all_edges(graph: GraphHandle, partition_id: FFIPartitionId, labels: *const FFILabelId, label_count: i32, limit: i64) -> GetAllEdgesIterator;
     fn free_get_all_edges_iterator(iter: GetAllEdgesIterator);
     fn get_all_edges_next(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle) -> FFIState;
+    fn get_all_edges_next_batch(iter: GetAllEdgesIterator, e_out: *mut EdgeHandle, capacity: i32) -> i32;
 
     fn get_edge_src_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
     fn get_edge_dst_id(graph: GraphHandle, e: *const EdgeHandle) -> VertexId;
     fn get_edge_id(graph: GraphHandle, e: *const EdgeHandle) -> EdgeId;
+    fn build_edge_index(graph: GraphHandle);
+    fn get_edge_by_id(graph: GraphHandle, internal_id: EdgeId, e_out: *mut EdgeHandle) -> FFIState;
     fn get_edge_src_label(graph: GraphHandle, e: *const EdgeHandle) -> LabelId;
     fn get_edge_dst_label(graph: GraphHandle, e: *const EdgeHandle) -> LabelId;
     fn get_edge_label(graph: GraphHandle, e: *const EdgeHandle) -> LabelId;
     fn get_edge_property(graph: GraphHandle, e: *const EdgeHandle, id: PropertyId, p_out: *mut NativeProperty) -> FFIState;
     fn get_edge_properties(graph: GraphHandle, e: *const EdgeHandle) -> PropertiesIterator;
+    fn get_edges_property(graph: GraphHandle, edges: *const EdgeHandle, count: i32, id: PropertyId, property_type: PropertyType, out: *mut ::libc::c_void, validity: *mut u8) -> i32;
 
     fn get_property_as_bool(property: *const NativeProperty, out: *mut bool) -> FFIState;
     fn get_property_as_char(property: *const NativeProperty, out: *mut u8) -> FFIState;
@@ -166,6 +229,8 @@ extern {
     fn free_schema(schema: SchemaHandle);
 
     fn free_string(s: *const ::libc::c_char);
+    fn get_property_types(schema: SchemaHandle, label_num: *mut i32, property_num: *mut i32, types: *mut *mut i32) -> FFIState;
+    fn free_property_types(types: *mut i32);
 
     fn get_partition_id(graph: GraphHandle, vid: VertexId) -> i32;
     fn get_process_partition_list(graph: GraphHandle,
@@ -174,9 +239,15 @@ extern {
     fn free_partition_list(partition_list: *const ::libc::c_int);
 
     fn get_vertex_id_from_primary_key(graph: GraphHandle, label_id: LabelId, key: *const ::libc::c_char, internal_id: &mut VertexId, partition_id: &mut PartitionId) -> FFIState;
+    fn get_vertex_ids_from_primary_keys(graph: GraphHandle, label_id: LabelId, keys: *const *const ::libc::c_char, count: i32, internal_ids: *mut VertexId, partition_ids: *mut PartitionId) -> i32;
+    fn get_vertex_ids_from_property(graph: GraphHandle, label_id: LabelId, property_id: PropertyId, keys: *const *const ::libc::c_char, count: i32, internal_ids: *mut VertexId, partition_ids: *mut PartitionId) -> i32;
 
     fn get_outer_id(graph: GraphHandle, vid: VertexId) -> VertexId;
 
+    fn get_trace_stats() -> *mut ::libc::c_char;
+    fn reset_trace_stats();
+    fn free_trace_stats(stats: *mut ::libc::c_char);
+
     fn test1(test: NativeProperty);
 }
 
@@ -187,7 +258,7 @@ pub struct FFIGraphStore {
 impl FFIGraphStore {
     pub fn new(graph_id: GraphId, worker_num: i32) -> Self {
         info!("create native graph {:?}", graph_id);
-        let graph = unsafe { get_graph_handle(graph_id, worker_num) };
+        let graph = unsafe { get_shared_graph_handle(graph_id, worker_num) };
         info!("create native graph done {:?}", graph_id);
         FFIGraphStore {
             graph,
@@ -197,11 +268,47 @@ impl FFIGraphStore {
     pub fn get_partition_manager(&self) -> VineyardPartitionManager {
         VineyardPartitionManager::new(self.graph)
     }
+
+    /// Maps the properties of the labels, which are rarely read, from the files
+    /// under dir rather than the memory of vineyard. Returns the number of the
+    /// columns mapped.
+    pub fn set_cold_properties(&self, labels: &[FFILabelId], property_ids: &[PropertyId], dir: &str) -> i32 {
+        assert_eq!(labels.len(), property_ids.len());
+        let c_dir = CString::new(dir).unwrap();
+        unsafe {
+            set_cold_properties(self.graph, labels.as_ptr(), property_ids.as_ptr(), labels.len() as i32, c_dir.as_ptr())
+        }
+    }
+
+    /// Adds the global tensor, e.g. the result of an analytical context, as the
+    /// property of the name of the vertices of the label, without sealing the
+    /// graph again. Returns the id of the property, or -1 if the tensor does not
+    /// match the label. It must not run with the queries on the graph.
+    pub fn add_virtual_vertex_property(&self, label: FFILabelId, name: &str, tensor_id: GraphId) -> PropertyId {
+        let c_name = CString::new(name).unwrap();
+        unsafe {
+            add_virtual_vertex_property(self.graph, label, c_name.as_ptr(), tensor_id)
+        }
+    }
+
+    /// The counters of the calls of the native store as a JSON array, which are
+    /// only collected when the native store is built with HTAP_TRACE.
+    pub fn get_trace_stats(reset: bool) -> String {
+        unsafe {
+            let stats = get_trace_stats();
+            let ret = CStr::from_ptr(stats).to_string_lossy().into_owned();
+            free_trace_stats(stats);
+            if reset {
+                reset_trace_stats();
+            }
+            ret
+        }
+    }
 }
 
 impl Drop for FFIGraphStore {
     fn drop(&mut self) {
-        unsafe { free_graph_handle(self.graph); }
+        unsafe { release_graph_handle(self.graph); }
     }
 }
 
@@ -757,9 +864,47 @@ unsafe impl Sync for FFIEdge {}
 
 unsafe impl Send for FFIEdge {}
 
+/// The number of the edges fetched by a call of the batch apis
+const EDGE_BATCH_SIZE: usize = 256;
+
+/// The edges fetched from an edge iterator by the batch apis, so that the ffi
+/// boundary is crossed once per batch rather than once per edge
+struct EdgeBatch {
+    edges: Vec<EdgeHandle>,
+    cursor: usize,
+}
+
+impl EdgeBatch {
+    fn new() -> Self {
+        EdgeBatch {
+            edges: Vec::new(),
+            cursor: 0,
+        }
+    }
+
+    /// Takes the next edge, and refills the batch by `fetch` when it is used up,
+    /// which fills the array of the capacity given and returns the number filled.
+    fn next<F: FnOnce(*mut EdgeHandle, i32) -> i32>(&mut self, fetch: F) -> Option<EdgeHandle> {
+        if self.cursor == self.edges.len() {
+            self.edges.clear();
+            self.edges.reserve(EDGE_BATCH_SIZE);
+            self.cursor = 0;
+            let count = fetch(self.edges.as_mut_ptr(), EDGE_BATCH_SIZE as i32);
+            if count <= 0 {
+                return None;
+            }
+            unsafe { self.edges.set_len(count as usize); }
+        }
+        let edge = self.edges[self.cursor];
+        self.cursor += 1;
+        Some(edge)
+    }
+}
+
 pub struct FFIOutEdgeIter {
     graph: GraphHandle,
     iter: OutEdgeIterator,
+    batch: EdgeBatch,
 }
 
 impl FFIOutEdgeIter {
@@ -767,6 +912,7 @@ impl FFIOutEdgeIter {
         FFIOutEdgeIter {
             graph,
             iter,
+            batch: EdgeBatch::new(),
         }
     }
 }
@@ -775,13 +921,10 @@ impl Iterator for FFIOutEdgeIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { out_edge_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let iter = self.iter;
+        let graph = self.graph;
+        self.batch.next(|e_out, capacity| unsafe { out_edge_next_batch(iter, e_out, capacity) })
+            .map(|edge_handle| FFIEdge::new(graph, edge_handle))
     }
 }
 
@@ -794,6 +937,7 @@ impl Drop for FFIOutEdgeIter {
 pub struct FFIInEdgeIter {
     graph: GraphHandle,
     iter: InEdgeIterator,
+    batch: EdgeBatch,
 }
 
 impl FFIInEdgeIter {
@@ -801,6 +945,7 @@ impl FFIInEdgeIter {
         FFIInEdgeIter {
             graph,
             iter,
+            batch: EdgeBatch::new(),
         }
     }
 }
@@ -809,13 +954,10 @@ impl Iterator for FFIInEdgeIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { in_edge_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let iter = self.iter;
+        let graph = self.graph;
+        self.batch.next(|e_out, capacity| unsafe { in_edge_next_batch(iter, e_out, capacity) })
+            .map(|edge_handle| FFIEdge::new(graph, edge_handle))
     }
 }
 
@@ -828,6 +970,7 @@ impl Drop for FFIInEdgeIter {
 struct FFIAllEdgesIter {
     graph: GraphHandle,
     iter: GetAllEdgesIterator,
+    batch: EdgeBatch,
 }
 
 impl FFIAllEdgesIter {
@@ -835,6 +978,7 @@ impl FFIAllEdgesIter {
         FFIAllEdgesIter {
             graph,
             iter,
+            batch: EdgeBatch::new(),
         }
     }
 }
@@ -843,13 +987,10 @@ impl Iterator for FFIAllEdgesIter {
     type Item = FFIEdge;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let mut edge_handle = EdgeHandle::new();
-        let state = unsafe { get_all_edges_next(self.iter, &mut edge_handle as *mut EdgeHandle) };
-        if state == STATE_SUCCESS {
-            let e = FFIEdge::new(self.graph, edge_handle);
-            return Some(e);
-        }
-        None
+        let iter = self.iter;
+        let graph = self.graph;
+        self.batch.next(|e_out, capacity| unsafe { get_all_edges_next_batch(iter, e_out, capacity) })
+            .map(|edge_handle| FFIEdge::new(graph, edge_handle))
     }
 }
 
@@ -1309,16 +1450,51 @@ impl PropertyType {
 //////////// schema apis //////////////
 struct FFISchema {
     schema: SchemaHandle,
+    // the types of the properties of the labels, exported once from the schema
+    prop_types: Vec<Option<DataType>>,
+    prop_num: usize,
 }
 
 impl FFISchema {
     pub fn new(schema: SchemaHandle) -> Self {
+        let mut label_num = 0;
+        let mut prop_num = 0;
+        let mut types: *mut i32 = std::ptr::null_mut();
+        let mut prop_types = vec![];
+        let state = unsafe { get_property_types(schema, &mut label_num, &mut prop_num, &mut types) };
+        if state == STATE_SUCCESS {
+            let count = (label_num * prop_num) as usize;
+            prop_types = (0..count).map(|i| data_type_from_code(unsafe { *types.add(i) })).collect();
+            unsafe { free_property_types(types); }
+        }
         FFISchema {
             schema,
+            prop_types,
+            prop_num: prop_num as usize,
         }
     }
 }
 
+fn data_type_from_code(code: i32) -> Option<DataType> {
+    match code {
+        1 => Some(DataType::Bool),
+        2 => Some(DataType::Char),
+        3 => Some(DataType::Short),
+        4 => Some(DataType::Int),
+        5 => Some(DataType::Long),
+        6 => Some(DataType::Float),
+        7 => Some(DataType::Double),
+        8 => Some(DataType::String),
+        9 => Some(DataType::Bytes),
+        10 => Some(DataType::ListInt),
+        11 => Some(DataType::ListLong),
+        12 => Some(DataType::ListFloat),
+        13 => Some(DataType::ListDouble),
+        14 => Some(DataType::ListString),
+        _ => None,
+    }
+}
+
 impl Schema for FFISchema {
     fn get_prop_id(&self, name: &str) -> Option<u32> {
         let c_name = CString::new(name).unwrap();
@@ -1331,6 +1507,10 @@ impl Schema for FFISchema {
     }
 
     fn get_prop_type(&self, label: u32, prop_id: u32) -> Option<DataType> {
+        let index = label as usize * self.prop_num + prop_id as usize;
+        if (prop_id as usize) < self.prop_num && index < self.prop_types.len() {
+            return self.prop_types[index];
+        }
         let mut t = PropertyType::Bool;
         let state = unsafe { get_property_type(self.schema, label, prop_id as PropertyId, &mut t) };
         if state == STATE_SUCCESS {
@@ -30,6 +30,16 @@ type VertexTypeBuilder = *const ::libc::c_void;
 type EdgeTypeBuilder = *const ::libc::c_void;
 type InstanceId = u64;
 
+/// a property given by a column of values, c.f. add_vertices_columnar
+#[repr(C)]
+pub struct PropertyColumn {
+    id: PropertyId,
+    r#type: PropertyType,
+    values: *const ::libc::c_void,
+    data: *const ::libc::c_char,
+    valid_bytes: *const u8,
+}
+
 extern {
     fn create_graph_builder(graph_name: *const ::libc::c_char, schema: SchemaHandle, index: i32) -> GraphBuilder;
     fn get_builder_id(graph_builder: GraphBuilder, graph_id: *mut GraphId, instance_id: *mut InstanceId);
@@ -55,6 +65,14 @@ extern {
                  labels: *const LabelId, src_labels: *const LabelId, dst_labels: *const LabelId,
                  property_sizes: *const usize, properties: *const WriteNativeProperty);
 
+    fn add_vertices_columnar(graph_builder: GraphBuilder, label_id: LabelId,
+                             vertex_size: usize, ids: *const VertexId,
+                             column_size: usize, columns: *const PropertyColumn);
+
+    fn add_edges_columnar(graph_builder: GraphBuilder, label: LabelId, src_label: LabelId, dst_label: LabelId,
+                          edge_size: usize, src_ids: *const VertexId, dst_ids: *const VertexId,
+                          column_size: usize, columns: *const PropertyColumn);
+
     fn build_vertice(builder: GraphBuilder);
     fn build_edges(builder: GraphBuilder);
     fn destroy(builder: GraphBuilder);
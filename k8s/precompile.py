@@ -14,13 +14,16 @@ import yaml
 
 
 def compute_sig(s):
-    return hashlib.sha256(s.encode("utf-8")).hexdigest()
+    # keep in line with the signatures in gscoordinator.utils
+    return hashlib.sha256(f"{__version__}.{s}".encode("utf-8")).hexdigest()
 
 
 NETWORKX = os.environ.get("NETWORKX", "ON")
 try:
     import gscoordinator
 
+    from gscoordinator.version import __version__
+
     COORDINATOR_HOME = Path(gscoordinator.__file__).parent.parent.absolute()
 except ModuleNotFoundError:
     print("Could not found coordinator")
@@ -31,7 +34,7 @@ BUILTIN_APP_RESOURCE_PATH = (
 )
 CMAKELISTS_TEMPLATE = TEMPLATE_DIR / "CMakeLists.template"
 ANALYTICAL_ENGINE_HOME = "/usr/local/bin"
-WORKSPACE = Path("/tmp/gs/builtin")
+WORKSPACE = Path(os.environ.get("GRAPHSCOPE_LIB_CACHE", "/tmp/gs/builtin"))
 
 
 def cmake_and_make(cmake_commands):
@@ -17,20 +17,38 @@
 #
 
 
+from graphscope.analytical.app.bcc import bcc
+from graphscope.analytical.app.betweenness_centrality import betweenness_centrality
 from graphscope.analytical.app.bfs import bfs
+from graphscope.analytical.app.bfs import bfs_cuda
 from graphscope.analytical.app.bfs import property_bfs
 from graphscope.analytical.app.cdlp import cdlp
+from graphscope.analytical.app.closeness_centrality import closeness_centrality
 from graphscope.analytical.app.clustering import clustering
 from graphscope.analytical.app.degree_centrality import degree_centrality
 from graphscope.analytical.app.eigenvector_centrality import eigenvector_centrality
+from graphscope.analytical.app.fused_analytics import fused_analytics
 from graphscope.analytical.app.hits import hits
+from graphscope.analytical.app.hyper_anf import hyper_anf
 from graphscope.analytical.app.k_core import k_core
 from graphscope.analytical.app.k_shell import k_shell
 from graphscope.analytical.app.katz_centrality import katz_centrality
+from graphscope.analytical.app.khop_sampling import khop_sampling
+from graphscope.analytical.app.link_similarity import link_similarity
+from graphscope.analytical.app.louvain import level_louvain
 from graphscope.analytical.app.louvain import louvain
 from graphscope.analytical.app.lpa import lpa
 from graphscope.analytical.app.pagerank import pagerank
+from graphscope.analytical.app.pagerank import pagerank_cuda
+from graphscope.analytical.app.ppr import batched_ppr
+from graphscope.analytical.app.random_walk import random_walk
+from graphscope.analytical.app.scc import scc
 from graphscope.analytical.app.sssp import property_sssp
 from graphscope.analytical.app.sssp import sssp
+from graphscope.analytical.app.sssp import sssp_cuda
+from graphscope.analytical.app.sssp import sssp_delta_stepping
 from graphscope.analytical.app.triangles import triangles
 from graphscope.analytical.app.wcc import wcc
+from graphscope.analytical.app.wcc import wcc_afforest
+from graphscope.analytical.app.wcc import wcc_cuda
+from graphscope.analytical.app.wcc import wcc_rma
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["bcc"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def bcc(graph, src=0):
+    """Evaluate biconnected components in the connected component of the src,
+    with the edges of the `graph` taken as undirected.
+
+    Each vertex other than the src is assigned with the internal ID of the
+    head of the component of the edge to it in the depth-first search tree,
+    i.e., the component is the vertices of the ID and the parent of the head.
+    The src and the vertices not connected to it are assigned with the max
+    value of the internal ID.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        src (int, optional): Source vertex of the search. Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the component ID.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.bcc(pg, 6)  # use 6 as source vertex
+        s.close()
+
+    """
+    return AppAssets(algo="bcc")(graph, src)
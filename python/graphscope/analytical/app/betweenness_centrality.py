@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["betweenness_centrality"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property", "dynamic_projected")
+def betweenness_centrality(graph, normalized=True, k=0):
+    """Compute the betweenness centrality by Brandes.
+
+    See more details for betweenness centrality here:
+    https://networkx.org/documentation/stable/reference/algorithms/generated/networkx.algorithms.centrality.betweenness_centrality.html
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        normalized (bool, optional): Whether to normalize result values by the pairs of the other vertices. Defaults to True.
+        k (int, optional): Number of the sampled sources to estimate the betweenness, 0 for all the vertices. Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the computed betweenness centrality.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.betweenness_centrality(pg, k=100)
+        s.close()
+
+    """
+    normalized = bool(normalized)
+    k = int(k)
+    return AppAssets(algo="betweenness_centrality")(graph, normalized, k)
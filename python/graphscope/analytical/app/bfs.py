@@ -21,7 +21,7 @@ from graphscope.framework.app import AppAssets
 from graphscope.framework.app import not_compatible_for
 from graphscope.framework.app import project_to_simple
 
-__all__ = ["bfs", "property_bfs"]
+__all__ = ["bfs", "bfs_cuda", "property_bfs"]
 
 
 @project_to_simple
@@ -51,7 +51,9 @@ def bfs(graph, src=0):
     return AppAssets(algo="bfs")(graph, src)
 
 
-@not_compatible_for("dynamic_property", "arrow_projected", "dynamic_projected")
+@not_compatible_for(
+    "dynamic_property", "arrow_projected", "arrow_flattened", "dynamic_projected"
+)
 def property_bfs(graph, src=0):
     """Breath first search from the src on property graph.
 
@@ -74,3 +76,20 @@ def property_bfs(graph, src=0):
 
     """
     return AppAssets(algo="property_bfs")(graph, src)
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def bfs_cuda(graph, src=0):
+    """Breadth first search from the src on the GPUs of the engines, see `bfs`.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        src (int, optional): Source vertex of breadth first search. Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: a context with each vertex with a distance from the source.
+    """
+    return AppAssets(algo="bfs_cuda")(graph, src)
@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["closeness_centrality"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property", "dynamic_projected")
+def closeness_centrality(graph, wf_improved=True, k=0):
+    """Compute the closeness centrality by the distances from the vertices
+    reaching each vertex.
+
+    See more details for closeness centrality here:
+    https://networkx.org/documentation/stable/reference/algorithms/generated/networkx.algorithms.centrality.closeness_centrality.html
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        wf_improved (bool, optional): Whether to scale result values by the fraction of the vertices reaching a vertex. Defaults to True.
+        k (int, optional): Number of the sampled sources to estimate the closeness, 0 for all the vertices. Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the computed closeness centrality.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.closeness_centrality(pg)
+        s.close()
+
+    """
+    wf_improved = bool(wf_improved)
+    k = int(k)
+    return AppAssets(algo="closeness_centrality")(graph, wf_improved, k)
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["fused_analytics"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def fused_analytics(graph, delta=0.85, max_round=10, centrality_type="both"):
+    """Compute the degree centrality, the PageRank and the WCC of `graph` in a
+    single run, which scans the edges of a vertex once per round for both the
+    PageRank and the WCC, and exchanges their states in the same messages.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        delta (float, optional): Dumping factor of the PageRank. Defaults to 0.85.
+        max_round (int, optional): Maximum number of rounds of the PageRank.
+            Defaults to 10.
+        centrality_type (str, optional): Available options are in/out/both.
+            Defaults to "both".
+
+    Returns:
+        :class:`VertexPropertyContext`: A context with the columns
+        "degree_centrality", "pagerank" and "wcc", the same as the ones of
+        degree_centrality, pagerank and wcc.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.fused_analytics(pg, delta=0.85, max_round=10)
+        s.close()
+
+    """
+    delta = float(delta)
+    max_round = int(max_round)
+    centrality_type = str(centrality_type)
+    return AppAssets(algo="fused_analytics")(graph, delta, max_round, centrality_type)
@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["hyper_anf"]
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def hyper_anf(graph, max_hops=10, precision=8):
+    """Estimate the number of vertices reachable from each vertex within
+    `max_hops` hops by HyperANF, i.e., a HyperLogLog counter per vertex merged
+    from its out neighbors in each hop.
+
+    The sum of the counters in each hop is the approximate neighborhood
+    function of the graph, from which the effective diameter, i.e., the hops
+    within which 90% of the reachable pairs are, is interpolated and logged.
+    It stops early if no counter changes in a hop.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        max_hops (int, optional): The hops to count within. Defaults to 10.
+        precision (int, optional): The counter of a vertex has 2^precision
+            registers, in [4, 16], with the relative standard error about
+            1.04 / sqrt(2^precision). Defaults to 8.
+
+    Returns:
+        :class:`VertexDataContext`: A context with the estimated reach of each vertex,
+        itself included.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.hyper_anf(pg, max_hops=6, precision=10)
+        s.close()
+
+    """
+    max_hops = int(max_hops)
+    precision = int(precision)
+    return AppAssets(algo="hyper_anf")(graph, max_hops, precision)
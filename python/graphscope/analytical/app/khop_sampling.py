@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["khop_sampling"]
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def khop_sampling(graph, seeds, fanouts, weighted=False, random_seed=0):
+    """Sample the k-hop neighborhoods of the seeds on `graph`, for the
+    mini-batches of the GNNs.
+
+    For each vertex of the hop h, `fanouts[h]` out neighbors are sampled with
+    replacement as the vertices of the hop h + 1, from the seeds as the hop 0,
+    uniformly or by the edge weights. The requests to sample the vertices of
+    the other fragments are batched per fragment in each hop.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        seeds (list): The ids of the seeds.
+        fanouts (list): The neighbors sampled per vertex in each hop, e.g., [25, 10].
+        weighted (bool, optional): Whether to sample by the edge weights. Defaults to False.
+        random_seed (int, optional): The seed of the random numbers. Defaults to 0.
+
+    Returns:
+        :class:`TensorContext`: A context with the rows of (seed, hop, src, dst)
+        of the sampled edges, grouped by the hops.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": ["weight"]})
+        r = gs.khop_sampling(pg, seeds=[1, 6, 10], fanouts=[10, 5], weighted=True)
+        s.close()
+
+    """
+    seeds = ",".join(str(seed) for seed in seeds)
+    fanouts = ",".join(str(int(fanout)) for fanout in fanouts)
+    weighted = bool(weighted)
+    random_seed = int(random_seed)
+    return AppAssets(algo="khop_sampling")(
+        graph, seeds, fanouts, weighted, random_seed
+    )
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["link_similarity"]
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def link_similarity(graph, max_exact_degree=1024, num_hashes=128):
+    """Compute the link prediction scores of the edges of an undirected `graph`,
+    i.e., the common neighbors, the Jaccard similarity and the Adamic-Adar index
+    of the ends of each edge.
+
+    The scores of an edge are exact by the intersection of the sorted neighbors
+    of its ends if either end is of the degree at most `max_exact_degree`, or
+    else estimated by the MinHash sketches of the neighbors of the ends.
+
+    Args:
+        graph (:class:`Graph`): A projected simple undirected graph.
+        max_exact_degree (int, optional): The degree up to which the scores are
+            exact. Defaults to 1024.
+        num_hashes (int, optional): The hashes of a sketch, with the standard
+            error of the estimated Jaccard about 1 / sqrt(num_hashes).
+            Defaults to 128.
+
+    Returns:
+        :class:`TensorContext`: A context with a row of (src, dst, common
+        neighbors, jaccard, adamic_adar, exact) per edge, once per undirected
+        edge, where exact is 1 if the scores are exact, or 0 if estimated.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g(directed=False)
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.link_similarity(pg, max_exact_degree=512)
+        s.close()
+
+    """
+    max_exact_degree = int(max_exact_degree)
+    num_hashes = int(num_hashes)
+    return AppAssets(algo="link_similarity")(graph, max_exact_degree, num_hashes)
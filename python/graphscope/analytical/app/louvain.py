@@ -23,6 +23,7 @@ from graphscope.framework.errors import InvalidArgumentError
 
 __all__ = [
     "louvain",
+    "level_louvain",
 ]
 
 
@@ -66,3 +67,44 @@ def louvain(graph, min_progress=1000, progress_tries=1):
     if graph.is_directed():
         raise InvalidArgumentError("Louvain not support directed graph.")
     return AppAssets(algo="louvain")(graph, min_progress, progress_tries)
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def level_louvain(graph, tolerance=1e-7, max_sweeps=20, max_levels=0):
+    """Compute best partition on the `graph` by louvain, level by level.
+
+    Unlike :func:`louvain`, each level coarsens the graph into a smaller graph of
+    the communities, which is distributed over the fragments, so the later levels
+    only run on the communities.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        tolerance (float, optional): The least gain of modularity by a sweep of the
+            local moves to go on with the level. Defaults to 1e-7.
+        max_sweeps (int, optional): Maximum number of the sweeps in a level.
+            Defaults to 20.
+        max_levels (int, optional): Maximum number of the levels, 0 for no limit.
+            Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with id of community it belongs to.
+
+    References:
+        [1] Blondel, V.D. et al. Fast unfolding of communities in large networks. J. Stat. Mech 10008, 1-12(2008).
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        s = gs.session()
+        g = s.load_from('The parameters for loading a graph...')
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": ["weight"]})
+        r = gs.level_louvain(pg)
+        s.close()
+
+    """
+    if graph.is_directed():
+        raise InvalidArgumentError("Louvain not support directed graph.")
+    return AppAssets(algo="level_louvain")(graph, tolerance, max_sweeps, max_levels)
@@ -23,7 +23,9 @@ from graphscope.framework.app import not_compatible_for
 __all__ = ["lpa"]
 
 
-@not_compatible_for("dynamic_property", "arrow_projected", "dynamic_projected")
+@not_compatible_for(
+    "dynamic_property", "arrow_projected", "arrow_flattened", "dynamic_projected"
+)
 def lpa(graph, max_round=10):
     """Evaluate (multi-) label propagation on a property graph.
 
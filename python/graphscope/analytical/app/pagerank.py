@@ -20,19 +20,23 @@
 from graphscope.framework.app import AppAssets
 from graphscope.framework.app import not_compatible_for
 from graphscope.framework.app import project_to_simple
+from graphscope.framework.errors import InvalidArgumentError
 
-__all__ = ["pagerank"]
+__all__ = ["pagerank", "pagerank_cuda"]
 
 
 @project_to_simple
 @not_compatible_for("arrow_property", "dynamic_property")
-def pagerank(graph, delta=0.85, max_round=10):
+def pagerank(graph, delta=0.85, max_round=10, dtype="double"):
     """Evalute PageRank on a graph.
 
     Args:
         graph (Graph): A projected simple graph.
         delta (float, optional): Dumping factor. Defaults to 0.85.
         max_round (int, optional): Maximum number of rounds. Defaults to 10.
+        dtype (str, optional): The type the ranks are kept in, "double", or
+            "float" to halve the memory of the ranks, of which the values are
+            of the precision of float. Defaults to "double".
 
     Returns:
         :class:`VertexDataContext`: A context with each vertex assigned with the pagerank value.
@@ -51,4 +55,31 @@ def pagerank(graph, delta=0.85, max_round=10):
     """
     delta = float(delta)
     max_round = int(max_round)
+    if dtype == "float":
+        return AppAssets(algo="pagerank_float")(graph, delta, max_round)
+    if dtype != "double":
+        raise InvalidArgumentError("dtype must be 'double' or 'float'.")
     return AppAssets(algo="pagerank")(graph, delta, max_round)
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def pagerank_cuda(graph, delta=0.85, max_round=10):
+    """Evaluate PageRank on the GPUs of the engines, which push the ranks along
+    the outgoing edges in the device memory, and exchange the sums on the
+    boundary vertices between the fragments. The engines are built with CUDA,
+    and each host has a GPU at least.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        delta (float, optional): Dumping factor. Defaults to 0.85.
+        max_round (int, optional): Maximum number of rounds. Defaults to 10.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the pagerank value.
+    """
+    delta = float(delta)
+    max_round = int(max_round)
+    return AppAssets(algo="pagerank_cuda")(graph, delta, max_round)
@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["batched_ppr"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property", "dynamic_projected")
+def batched_ppr(graph, seeds, walk_num=1000, alpha=0.15, threshold=0.0):
+    """Compute the approximate personalized pageranks of many seeds on `graph`.
+
+    The walks from each seed stop at each step with the probability `alpha`,
+    and the score of a vertex to a seed is the fraction of the walks of the
+    seed stopped at it.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        seeds (list): The ids of the seeds.
+        walk_num (int, optional): The number of the walks per seed. Defaults to 1000.
+        alpha (float, optional): The probability of the teleport. Defaults to 0.15.
+        threshold (float, optional): The least score to output. Defaults to 0.0.
+
+    Returns:
+        :class:`TensorContext`: A context with the rows of (seed, vertex, score).
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.batched_ppr(pg, seeds=[1, 6, 10], walk_num=10000)
+        s.close()
+
+    """
+    seeds = ",".join(str(seed) for seed in seeds)
+    walk_num = int(walk_num)
+    alpha = float(alpha)
+    threshold = float(threshold)
+    return AppAssets(algo="batched_ppr")(graph, seeds, walk_num, alpha, threshold)
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+
+
+from graphscope.framework.app import AppAssets
+from graphscope.framework.app import not_compatible_for
+from graphscope.framework.app import project_to_simple
+
+__all__ = ["random_walk"]
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property", "dynamic_projected")
+def random_walk(graph, walk_length=10, walk_num=1, weighted=False, p=1.0, q=1.0):
+    """Generate the random walks from each vertex of `graph`.
+
+    The walks move along the outgoing edges uniformly, or by the edge weights,
+    and are biased by the return parameter `p` and the in-out parameter `q`
+    as node2vec, see more here: https://arxiv.org/abs/1607.00653
+    A walk stays at a vertex without out neighbors.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        walk_length (int, optional): The number of the vertices of a walk. Defaults to 10.
+        walk_num (int, optional): The number of the walks from each vertex. Defaults to 1.
+        weighted (bool, optional): Whether to move by the edge weights. Defaults to False.
+        p (float, optional): The return parameter. Defaults to 1.0.
+        q (float, optional): The in-out parameter. Defaults to 1.0.
+
+    Returns:
+        :class:`TensorContext`: A context with a row of the vertices per walk.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": ["weight"]})
+        r = gs.random_walk(pg, walk_length=20, walk_num=10, p=0.5, q=2.0)
+        s.close()
+
+    """
+    walk_length = int(walk_length)
+    walk_num = int(walk_num)
+    weighted = bool(weighted)
+    p = float(p)
+    q = float(q)
+    return AppAssets(algo="random_walk")(graph, walk_length, walk_num, weighted, p, q)
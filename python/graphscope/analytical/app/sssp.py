@@ -19,9 +19,12 @@
 from graphscope.framework.app import AppAssets
 from graphscope.framework.app import not_compatible_for
 from graphscope.framework.app import project_to_simple
+from graphscope.framework.errors import InvalidArgumentError
 
 __all__ = [
     "sssp",
+    "sssp_delta_stepping",
+    "sssp_cuda",
     "property_sssp",
 ]
 
@@ -53,7 +56,39 @@ def sssp(graph, src=0):
     return AppAssets(algo="sssp")(graph, src)
 
 
-@not_compatible_for("dynamic_property", "arrow_projected", "dynamic_projected")
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def sssp_delta_stepping(graph, src=0, delta=0.0, dtype="double"):
+    """Compute single source shortest path on the `graph` by delta-stepping,
+    which relaxes the vertices by the buckets of the distances of width
+    `delta`, and wastes fewer relaxations than `sssp` on the weighted graphs
+    of large diameters, e.g., the road networks.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        src (int, optional): The source vertex. Defaults to 0.
+        delta (float, optional): The width of the buckets, a non-positive one
+            is chosen as the largest edge weight over the average degree.
+            Defaults to 0.0.
+        dtype (str, optional): The type the distances are kept in, "double",
+            or "float" to halve the memory of the distances, of which the
+            values are of the precision of float. Defaults to "double".
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the shortest distance from the src.
+    """
+    if dtype == "float":
+        return AppAssets(algo="sssp_delta_stepping_float")(
+            graph, src, float(delta)
+        )
+    if dtype != "double":
+        raise InvalidArgumentError("dtype must be 'double' or 'float'.")
+    return AppAssets(algo="sssp_delta_stepping")(graph, src, float(delta))
+
+
+@not_compatible_for(
+    "dynamic_property", "arrow_projected", "arrow_flattened", "dynamic_projected"
+)
 def property_sssp(graph, src=0):
     """Compute single source shortest path on graph G.
 
@@ -65,3 +100,21 @@ def property_sssp(graph, src=0):
         A context with each vertex assigned with the shortest distance from the src.
     """
     return AppAssets(algo="property_sssp")(graph, src)
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def sssp_cuda(graph, src=0):
+    """Compute single source shortest path on the GPUs of the engines, by
+    relaxing the edges in the device memory. The edge weights are non-negative.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+        src (int, optional): The source vertex. Defaults to 0.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the shortest distance from the src.
+    """
+    return AppAssets(algo="sssp_cuda")(graph, src)
@@ -21,7 +21,7 @@ from graphscope.framework.app import AppAssets
 from graphscope.framework.app import not_compatible_for
 from graphscope.framework.app import project_to_simple
 
-__all__ = ["wcc"]
+__all__ = ["wcc", "wcc_afforest", "wcc_cuda", "wcc_rma"]
 
 
 @project_to_simple
@@ -48,3 +48,65 @@ def wcc(graph):
 
     """
     return AppAssets(algo="wcc")(graph)
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def wcc_afforest(graph):
+    """Evaluate weakly connected components on the `graph` by the Afforest
+    algorithm, which links the edges of each fragment locally first, and then
+    exchanges the labels between the fragments in a few rounds.
+
+    Each vertex is assigned with the least internal ID in its component.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the component ID.
+
+    Examples:
+
+    .. code:: python
+
+        import graphscope as gs
+        sess = gs.session()
+        g = sess.g()
+        pg = g.project(vertices={"vlabel": []}, edges={"elabel": []})
+        r = gs.wcc_afforest(pg)
+        s.close()
+
+    """
+    return AppAssets(algo="wcc_afforest")(graph)
+
+
+@project_to_simple
+@not_compatible_for(
+    "arrow_property", "dynamic_property", "arrow_flattened", "dynamic_projected"
+)
+def wcc_cuda(graph):
+    """Evaluate weakly connected components on the GPUs of the engines, see `wcc`.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the component ID.
+    """
+    return AppAssets(algo="wcc_cuda")(graph)
+
+
+@project_to_simple
+@not_compatible_for("arrow_property", "dynamic_property")
+def wcc_rma(graph):
+    """Evaluate weakly connected components on the `graph`, see `wcc`, of which
+    the components of the boundary vertices are synced by the one-sided MPI
+    accumulates into the memory of the owners, instead of the messages.
+
+    Args:
+        graph (:class:`Graph`): A projected simple graph.
+
+    Returns:
+        :class:`VertexDataContext`: A context with each vertex assigned with the component ID.
+    """
+    return AppAssets(algo="wcc_rma")(graph)
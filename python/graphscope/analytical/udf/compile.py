@@ -1097,6 +1097,25 @@ class GRAPECompiler(ast.NodeVisitor):
                         use_ref=True,
                     ),
                 ]
+            elif function_name in (
+                ExpectFuncDef.PEVAL_KERNEL.value,
+                ExpectFuncDef.INCEVAL_KERNEL.value,
+            ):
+                args = node.args.args
+                assert len(args) == 5, "The number of parameters does not match"
+                args = [
+                    self.make_ref_arg("Fragment", args[0].arg, self.loc(args[0])),
+                    self.make_template_arg(
+                        "Context",
+                        [self._vd_type, self._md_type],
+                        args[1].arg,
+                        self.loc(args[1]),
+                        use_ref=True,
+                    ),
+                    self.make_ref_arg("VertexRange", args[2].arg, self.loc(args[2])),
+                    self.make_value_arg("int", args[3].arg, self.loc(args[3])),
+                    self.make_value_arg("int", args[4].arg, self.loc(args[4])),
+                ]
             else:
                 raise RuntimeError(
                     "Not recognized method named {}".format(function_name)
@@ -1147,6 +1166,25 @@ class GRAPECompiler(ast.NodeVisitor):
                         use_ref=True,
                     ),
                 ]
+            elif function_name == ExpectFuncDef.COMPUTE_BATCH.value:
+                args = node.args.args
+                assert len(args) == 2, "The number of parameters does not match"
+                args = [
+                    self.make_template_arg(
+                        "VertexBatch",
+                        [self._vd_type, self._md_type],
+                        args[0].arg,
+                        self.loc(args[0]),
+                        use_ref=True,
+                    ),
+                    self.make_template_arg(
+                        "Context",
+                        [self._vd_type, self._md_type],
+                        args[1].arg,
+                        self.loc(args[1]),
+                        use_ref=True,
+                    ),
+                ]
             elif function_name == ExpectFuncDef.COMBINE.value:
                 args = node.args.args
                 assert len(args) == 1, "The number of parameters does not match"
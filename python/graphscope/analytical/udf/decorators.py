@@ -32,7 +32,9 @@ __all__ = ["pie", "pregel"]
 
 PREGEL_NECESSARY_DEFS = ["Init", "Compute"]
 PREGEL_COMBINE_DEF = "Combine"
+PREGEL_COMPUTE_BATCH_DEF = "ComputeBatch"
 PIE_NECESSARY_DEFS = ["Init", "PEval", "IncEval"]
+PIE_KERNEL_DEFS = ["PEvalKernel", "IncEvalKernel"]
 _BASE_MEMBERS = [k for k, _ in inspect.getmembers(AppAssets)]
 
 
@@ -69,6 +71,14 @@ def pie(vd_type, md_type):
       >>>     @staticmethod
       >>>     def IncEval(frag, context):
       >>>         pass
+
+    The optional `PEvalKernel` and `IncEvalKernel` run after `PEval` and
+    `IncEval` on the ranges of the inner vertices of each label in parallel,
+    and set the values by `context.set_node_value_in_thread(tid, v, value)`::
+
+      >>>     @staticmethod
+      >>>     def IncEvalKernel(frag, context, vertices, label, tid):
+      >>>         pass
     """
 
     def _pie_wrapper(vd_type, md_type, algo):
@@ -85,6 +95,7 @@ def pie(vd_type, md_type):
             }
         )
         _check_and_reorder(PIE_NECESSARY_DEFS, algo, defs)
+        pie_kernels = [d for d in PIE_KERNEL_DEFS if d in defs.keys()]
 
         pyx_header = LinesWrapper()
         pyx_header.putline("from pie cimport AdjList")
@@ -104,7 +115,15 @@ def pie(vd_type, md_type):
         pyx_header.putline("from libcpp cimport bool")
         pyx_header.putline("from libcpp.string cimport string")
 
-        pyx_codegen(algo, defs, ProgramModel.PIE, pyx_header, vd_type, md_type)
+        pyx_codegen(
+            algo,
+            defs,
+            ProgramModel.PIE,
+            pyx_header,
+            vd_type,
+            md_type,
+            pie_kernels=pie_kernels,
+        )
         # pyx_codegen(algo, defs, pyx_wrapper, vd_type, md_type)
         return algo
 
@@ -146,6 +165,12 @@ def pregel(vd_type, md_type):
       >>>     @staticmethod
       >>>     def Combine(messages):
       >>>         pass
+
+    An optional :code:`ComputeBatch(batch, context)` computes a batch of
+    vertices in one call, where :code:`batch.vertex(i)`,
+    :code:`batch.value(i)` and :code:`batch.messages(i)` are the vertex, its
+    value and its messages. It is used instead of :code:`Compute` when
+    defined, to amortize the cost of calling into the program per vertex.
     """
 
     def _pregel_wrapper(vd_type, md_type, algo):
@@ -166,12 +191,16 @@ def pregel(vd_type, md_type):
         enable_combine = False
         if PREGEL_COMBINE_DEF in defs.keys():
             enable_combine = True
+        enable_compute_batch = False
+        if PREGEL_COMPUTE_BATCH_DEF in defs.keys():
+            enable_compute_batch = True
 
         pyx_header = LinesWrapper()
         pyx_header.putline("from pregel cimport Context")
         pyx_header.putline("from pregel cimport MessageIterator")
         pyx_header.putline("from pregel cimport PregelAggregatorType")
         pyx_header.putline("from pregel cimport Vertex")
+        pyx_header.putline("from pregel cimport VertexBatch")
         pyx_header.putline("from pregel cimport to_string")
         pyx_header.putline("")
         pyx_header.putline("from libc.stdint cimport int32_t")
@@ -189,6 +218,7 @@ def pregel(vd_type, md_type):
             vd_type,
             md_type,
             enable_combine,
+            enable_compute_batch,
         )
         return algo
 
@@ -36,9 +36,12 @@ class ExpectFuncDef(Enum):
 
     INIT = "Init"
     COMPUTE = "Compute"
+    COMPUTE_BATCH = "ComputeBatch"
     COMBINE = "Combine"
     PEVAL = "PEval"
     INCEVAL = "IncEval"
+    PEVAL_KERNEL = "PEvalKernel"
+    INCEVAL_KERNEL = "IncEvalKernel"
 
 
 class LinesWrapper(object):
@@ -26,7 +26,15 @@ from graphscope.framework.app import load_app
 
 
 def wrap_init(
-    algo, program_model, pyx_header, pyx_body, vd_type, md_type, pregel_combine
+    algo,
+    program_model,
+    pyx_header,
+    pyx_body,
+    vd_type,
+    md_type,
+    pregel_combine,
+    pregel_compute_batch=False,
+    pie_kernels=None,
 ):
     """Wrapper :code:`__init__` function in algo."""
     algo_name = getattr(algo, "__name__")
@@ -43,6 +51,8 @@ def wrap_init(
                 "vd_type": vd_type,
                 "md_type": md_type,
                 "pregel_combine": pregel_combine,
+                "pregel_compute_batch": pregel_compute_batch,
+                "pie_kernels": pie_kernels or [],
             }
         ]
     }
@@ -71,6 +81,8 @@ def pyx_codegen(
     vd_type=None,
     md_type=None,
     pregel_combine=False,
+    pregel_compute_batch=False,
+    pie_kernels=None,
 ):
     """Transfer python to cython code with :code:`grape.GRAPECompiler`.
 
@@ -82,6 +94,8 @@ def pyx_codegen(
       vd_type (str): vertex data type.
       md_type (str): message type.
       pregel_combine (bool): combinator in pregel model.
+      pregel_compute_batch (bool): batched compute in pregel model.
+      pie_kernels (list): names of the parallel kernels in PIE model.
 
     """
     class_name = getattr(algo, "__name__")
@@ -97,5 +111,13 @@ def pyx_codegen(
     # append code body
     # pyx_wrapper['pyx_code_body'].extend(pyx_code_body)
     wrap_init(
-        algo, program_model, pyx_header, pyx_body, vd_type, md_type, pregel_combine
+        algo,
+        program_model,
+        pyx_header,
+        pyx_body,
+        vd_type,
+        md_type,
+        pregel_combine,
+        pregel_compute_batch,
+        pie_kernels,
     )
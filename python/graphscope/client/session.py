@@ -48,6 +48,7 @@ from graphscope.client.utils import set_defaults
 from graphscope.config import GSConfig as gs_config
 from graphscope.deploy.hosts.cluster import HostsClusterLauncher
 from graphscope.deploy.kubernetes.cluster import KubernetesClusterLauncher
+from graphscope.framework import dag_utils
 from graphscope.framework.errors import ConnectionError
 from graphscope.framework.errors import FatalError
 from graphscope.framework.errors import GRPCError
@@ -173,6 +174,8 @@ class Session(object):
         timeout_seconds=gs_config.timeout_seconds,
         dangling_timeout_seconds=gs_config.dangling_timeout_seconds,
         with_mars=gs_config.with_mars,
+        query_cache_bytes=gs_config.query_cache_bytes,
+        memory_budget_bytes=gs_config.memory_budget_bytes,
         **kw
     ):
         """Construct a new GraphScope session.
@@ -227,6 +230,14 @@ class Session(object):
 
             vineyard_shared_mem (str, optional): Init size of vineyard shared memory. Defaults to '4Gi'.
 
+            query_cache_bytes (int, optional): Capacity in bytes of the query cache of analytical engine.
+                A repeated query on an unmodified graph is answered by the cached context.
+                Defaults to 0, which disables the cache.
+
+            memory_budget_bytes (int, optional): Bytes of the objects held by a worker of analytical engine,
+                beyond which the least recently used projected graphs and contexts not in use are evicted,
+                see `evicted_objects`. Defaults to 0, which means no budget.
+
             k8s_engine_cpu (float, optional): Minimum number of CPU cores request for engine container. Defaults to 0.5.
 
             k8s_engine_mem (str, optional): Minimum number of memory request for engine container. Defaults to '4Gi'.
@@ -392,6 +403,8 @@ class Session(object):
             "k8s_waiting_for_delete",
             "timeout_seconds",
             "dangling_timeout_seconds",
+            "query_cache_bytes",
+            "memory_budget_bytes",
         )
         saved_locals = locals()
         for param in self._accessable_params:
@@ -469,6 +482,8 @@ class Session(object):
 
         self._grpc_client = None
         self._session_id = None  # unique identifier across sessions
+        # the keys of the objects evicted by the engine to keep the memory budget
+        self._evicted_objects = []
         # engine config:
         #
         #   {
@@ -727,6 +742,14 @@ class Session(object):
         # attach an output to op, indicating the op is already run.
         op.set_output(response.metrics)
 
+        if response.evicted_objects:
+            logger.warning(
+                "The objects %s are evicted to keep the memory budget, and must "
+                "be created again to be used",
+                list(response.evicted_objects),
+            )
+            self._evicted_objects.extend(response.evicted_objects)
+
         # if loads a arrow property graph, will return {'object_id': xxxx}
         if op.output_types == types_pb2.GRAPH:
             return response.graph_def
@@ -804,6 +827,8 @@ class Session(object):
                 dangling_timeout_seconds=self._config_params[
                     "dangling_timeout_seconds"
                 ],
+                query_cache_bytes=self._config_params["query_cache_bytes"],
+                memory_budget_bytes=self._config_params["memory_budget_bytes"],
             )
         elif (
             self._cluster_type == types_pb2.HOSTS
@@ -819,6 +844,8 @@ class Session(object):
                 vineyard_socket=self._config_params["vineyard_socket"],
                 timeout_seconds=self._config_params["timeout_seconds"],
                 vineyard_shared_mem=self._config_params["vineyard_shared_mem"],
+                query_cache_bytes=self._config_params["query_cache_bytes"],
+                memory_budget_bytes=self._config_params["memory_budget_bytes"],
             )
         else:
             raise RuntimeError("Session initialize failed.")
@@ -861,8 +888,49 @@ class Session(object):
         """Get configuration of the session."""
         return self._config_params
 
-    def g(self, incoming_data=None, oid_type="int64", directed=True, generate_eid=True):
-        return Graph(self, incoming_data, oid_type, directed, generate_eid)
+    @property
+    def evicted_objects(self):
+        """The keys of the graphs and the contexts evicted by the analytical engine
+        to keep the memory budget, in the order they are evicted. An evicted
+        object must be created again to be used.
+        """
+        return list(self._evicted_objects)
+
+    def memory_usage(self):
+        """Get the bytes held by the objects of each worker of the analytical
+        engine.
+
+        Returns:
+            list: A dict per worker, with `worker_id`, `total_bytes`, `budget_bytes`
+            and `objects`, the `id`, `type` and `bytes` of each object. A fragment
+            shared by several objects is counted once in `total_bytes`.
+        """
+        op = dag_utils.report_memory(self._session_id)
+        ret = self.run(op)
+        usage = []
+        for line in ret.split("\n"):
+            if not line:
+                continue
+            worker = json.loads(line)
+            for key in ("worker_id", "total_bytes", "budget_bytes"):
+                worker[key] = int(worker[key])
+            # an empty array of boost::property_tree is written as ""
+            objects = worker.get("objects") or []
+            for obj in objects:
+                obj["bytes"] = int(obj["bytes"])
+            worker["objects"] = objects
+            usage.append(worker)
+        return sorted(usage, key=lambda worker: worker["worker_id"])
+
+    def g(
+        self,
+        incoming_data=None,
+        oid_type="int64",
+        directed=True,
+        generate_eid=True,
+        vid_type="uint64",
+    ):
+        return Graph(self, incoming_data, oid_type, directed, generate_eid, vid_type)
 
     def load_from(self, *args, **kwargs):
         """Load a graph within the session.
@@ -1171,6 +1239,8 @@ def set_option(**kwargs):
         - engine_params
         - initializing_interactive_engine
         - timeout_seconds
+        - query_cache_bytes
+        - memory_budget_bytes
 
     Args:
         kwargs: dict
@@ -1224,6 +1294,8 @@ def get_option(key):
         - engine_params
         - initializing_interactive_engine
         - timeout_seconds
+        - query_cache_bytes
+        - memory_budget_bytes
 
     Args:
         key: str
@@ -1311,5 +1383,13 @@ class _DefaultSessionStack(object):
 _default_session_stack = _DefaultSessionStack()  # pylint: disable=protected-access
 
 
-def g(incoming_data=None, oid_type="int64", directed=True, generate_eid=True):
-    return get_default_session().g(incoming_data, oid_type, directed, generate_eid)
+def g(
+    incoming_data=None,
+    oid_type="int64",
+    directed=True,
+    generate_eid=True,
+    vid_type="uint64",
+):
+    return get_default_session().g(
+        incoming_data, oid_type, directed, generate_eid, vid_type
+    )
@@ -107,6 +107,14 @@ class GSConfig(object):
 
     timeout_seconds = 600
 
+    # the capacity in bytes of the contexts of the queries on the immutable
+    # graphs cached by the analytical engine, 0 to disable the cache
+    query_cache_bytes = 0
+
+    # the bytes of the objects held by a worker of the analytical engine, beyond
+    # which the unused projected graphs and contexts are evicted, 0 for no budget
+    memory_budget_bytes = 0
+
     # kill GraphScope instance after seconds of client disconnect
     # disable dangling check by setting -1.
     dangling_timeout_seconds = 600
@@ -67,6 +67,8 @@ class HostsClusterLauncher(Launcher):
         vineyard_socket=None,
         timeout_seconds=None,
         vineyard_shared_mem=None,
+        query_cache_bytes=0,
+        memory_budget_bytes=0,
     ):
         self._hosts = hosts
         self._port = port
@@ -74,6 +76,8 @@ class HostsClusterLauncher(Launcher):
         self._vineyard_socket = vineyard_socket
         self._timeout_seconds = timeout_seconds
         self._vineyard_shared_mem = vineyard_shared_mem
+        self._query_cache_bytes = query_cache_bytes
+        self._memory_budget_bytes = memory_budget_bytes
 
         self._instance_id = random_string(6)
         self._proc = None
@@ -110,6 +114,10 @@ class HostsClusterLauncher(Launcher):
             self.type(),
             "--instance_id",
             self._instance_id,
+            "--query_cache_bytes",
+            str(self._query_cache_bytes),
+            "--memory_budget_bytes",
+            str(self._memory_budget_bytes),
         ]
 
         if self._vineyard_shared_mem is not None:
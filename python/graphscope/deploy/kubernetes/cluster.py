@@ -124,6 +124,13 @@ class KubernetesClusterLauncher(Launcher):
         vineyard_shared_mem: str
             Initial size of vineyard shared memory.
 
+        query_cache_bytes: int
+            Capacity in bytes of the query cache of analytical engine.
+
+        memory_budget_bytes: int
+            Bytes of the objects held by a worker of analytical engine, beyond
+            which the unused projected graphs and contexts are evicted.
+
         engine_cpu: float
             Minimum number of CPU cores request for engine container.
 
@@ -199,6 +206,8 @@ class KubernetesClusterLauncher(Launcher):
         vineyard_cpu=None,
         vineyard_mem=None,
         vineyard_shared_mem=None,
+        query_cache_bytes=0,
+        memory_budget_bytes=0,
         engine_cpu=None,
         engine_mem=None,
         coordinator_cpu=None,
@@ -255,6 +264,8 @@ class KubernetesClusterLauncher(Launcher):
         self._vineyard_cpu = vineyard_cpu
         self._vineyard_mem = vineyard_mem
         self._vineyard_shared_mem = vineyard_shared_mem
+        self._query_cache_bytes = query_cache_bytes
+        self._memory_budget_bytes = memory_budget_bytes
         self._engine_cpu = engine_cpu
         self._engine_mem = engine_mem
 
@@ -575,6 +586,10 @@ class KubernetesClusterLauncher(Launcher):
             self._vineyard_mem,
             "--vineyard_shared_mem",
             self._vineyard_shared_mem,
+            "--query_cache_bytes",
+            str(self._query_cache_bytes),
+            "--memory_budget_bytes",
+            str(self._memory_budget_bytes),
             "--k8s_engine_cpu",
             str(self._engine_cpu),
             "--k8s_engine_mem",
@@ -53,7 +53,8 @@ def not_compatible_for(*graph_types):
 
     Args:
         graph_types: list of string
-            Entries must be one of 'arrow_property', 'dynamic_property', 'arrow_projected', 'dynamic_projected'
+            Entries must be one of 'arrow_property', 'dynamic_property',
+            'arrow_projected', 'arrow_flattened', 'dynamic_projected'
 
     Returns:
         The decorated function.
@@ -82,6 +83,7 @@ def not_compatible_for(*graph_types):
             "arrow_property": graph.graph_type == types_pb2.ARROW_PROPERTY,
             "dynamic_property": graph.graph_type == types_pb2.DYNAMIC_PROPERTY,
             "arrow_projected": graph.graph_type == types_pb2.ARROW_PROJECTED,
+            "arrow_flattened": graph.graph_type == types_pb2.ARROW_FLATTENED,
             "dynamic_projected": graph.graph_type == types_pb2.DYNAMIC_PROJECTED,
         }
         match = False
@@ -90,7 +92,8 @@ def not_compatible_for(*graph_types):
                 match = match or terms[t]
         except KeyError:
             raise InvalidArgumentError(
-                "Use one or more of arrow_property,dynamic_property,arrow_projected,dynamic_projected",
+                "Use one or more of arrow_property,dynamic_property,arrow_projected,"
+                "arrow_flattened,dynamic_projected",
             )
         if match:
             raise InvalidArgumentError(
@@ -362,6 +365,7 @@ class App(object):
         results = create_context(
             context_type, self._session_id, context_key, self._graph
         )
+        results._cache_hit = ret.get("cache_hit") == "true"
         return results
 
     def _check_unmodified(self):
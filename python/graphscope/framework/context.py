@@ -25,6 +25,7 @@ from graphscope.framework import dag_utils
 from graphscope.framework import utils
 from graphscope.framework.errors import InvalidArgumentError
 from graphscope.framework.errors import check_argument
+from graphscope.framework.utils import decode_arrow_table
 from graphscope.framework.utils import decode_dataframe
 from graphscope.framework.utils import decode_numpy
 
@@ -65,6 +66,8 @@ class BaseContext(object):
         self._graph = graph
         self._session_id = session_id
         self._saved_signature = self.signature
+        # whether the context is reused from the query cache of the engine
+        self._cache_hit = False
 
     def __repr__(self):
         return f"graphscope.{self.__class__.__name__} from graph {str(self._graph)}"
@@ -155,6 +158,97 @@ class BaseContext(object):
         raw_values = op.eval()
         return decode_dataframe(raw_values)
 
+    def top_k(self, k, selector, order_by="r", vertex_range=None):
+        """Return the vertices with the k largest results as a pandas DataFrame,
+        in descending order of the results. Each worker only sends its own
+        top k vertices, instead of gathering all of the results.
+        Only supported by vertex data contexts.
+
+        Args:
+            k (int): Number of vertices to retrieve.
+            selector (dict): Similar to `to_dataframe`.
+            order_by (str): Selector of the results, e.g., `r` or `r:label_name`
+                for labeled contexts, whose label must be the one of `selector`.
+            vertex_range (dict, optional): Similar to `to_dataframe`.
+
+        Returns:
+            pandas.DataFrame
+        """
+        check_argument(isinstance(k, int) and k > 0, "k must be a positive int")
+        check_argument(
+            isinstance(selector, Mapping), "selector of top_k must be a dict"
+        )
+        order_column = "__order_by__"
+        selector = dict(selector, **{order_column: order_by})
+        limit = json.dumps({"top_k": k})
+        df = self._to_limited_dataframe(selector, vertex_range, limit)
+        df = df.sort_values(order_column, ascending=False, kind="stable").head(k)
+        return df.drop(columns=[order_column]).reset_index(drop=True)
+
+    def sample(self, k, selector, vertex_range=None, seed=None):
+        """Return a uniform sample of about k vertices as a pandas DataFrame.
+        Each worker samples in proportion to its number of vertices, so the
+        results are not gathered.
+        Only supported by vertex data contexts.
+
+        Args:
+            k (int): Number of vertices to sample.
+            selector (dict): Similar to `to_dataframe`.
+            vertex_range (dict, optional): Similar to `to_dataframe`.
+            seed (int, optional): Seed of the sampling, for reproducible samples.
+
+        Returns:
+            pandas.DataFrame
+        """
+        check_argument(isinstance(k, int) and k > 0, "k must be a positive int")
+        check_argument(
+            isinstance(selector, Mapping), "selector of sample must be a dict"
+        )
+        limit = {"sample": k}
+        if seed is not None:
+            limit["seed"] = seed
+        df = self._to_limited_dataframe(selector, vertex_range, json.dumps(limit))
+        if len(df) > k:
+            # the samples of the workers are rounded up
+            df = df.sample(n=k, random_state=seed).sort_index()
+        return df.reset_index(drop=True)
+
+    def _to_limited_dataframe(self, selector, vertex_range, limit):
+        self._check_unmodified()
+        selector = {
+            key: self._transform_selector(value) for key, value in selector.items()
+        }
+        selector = json.dumps(selector)
+        vertex_range = utils.transform_vertex_range(vertex_range)
+        op = dag_utils.context_to_dataframe(self, selector, vertex_range, limit)
+        raw_values = op.eval()
+        return decode_dataframe(raw_values)
+
+    def to_arrow(self, selector):
+        """Return results as a pyarrow.Table, which is transferred as Arrow IPC
+        streams instead of being decoded element by element, and can be
+        converted to pandas by `to_pandas()`.
+
+        Args:
+            selector (dict): Key is used as column name, and the value
+                describes how to select values of context. Selectors of a
+                labeled context must be of the same label.
+
+        Returns:
+            pyarrow.Table
+        """
+        self._check_unmodified()
+        check_argument(
+            isinstance(selector, Mapping), "selector of to_arrow must be a dict"
+        )
+        selector = {
+            key: self._transform_selector(value) for key, value in selector.items()
+        }
+        selector = json.dumps(selector)
+        op = dag_utils.context_to_arrow(self, selector)
+        raw_values = op.eval()
+        return decode_arrow_table(raw_values)
+
     def to_vineyard_tensor(self, selector=None, vertex_range=None, axis=0):
         """Return results as a vineyard tensor.
         Only object id is returned.
@@ -205,6 +299,32 @@ class BaseContext(object):
         object_id = json.loads(ret)["object_id"]
         return object_id
 
+    def to_arrow_files(self, prefix, selector):
+        """Write results to Arrow IPC files without gathering them to a worker.
+        Each worker writes its own partition to a file named by `prefix`, so
+        `prefix` should be on a storage shared by the workers and the client.
+        The files can be read lazily by `pyarrow.ipc.open_file`.
+
+        Args:
+            prefix (str): Prefix of the output files.
+            selector (dict): Key is used as column name, and the value
+                describes how to select values of context.
+
+        Returns:
+            list of str: The paths of the written files.
+        """
+        self._check_unmodified()
+        check_argument(
+            isinstance(selector, Mapping), "selector of to_arrow_files must be a dict"
+        )
+        selector = {
+            key: self._transform_selector(value) for key, value in selector.items()
+        }
+        selector = json.dumps(selector)
+        op = dag_utils.context_to_files(self, prefix, selector)
+        ret = op.eval()
+        return [path for path in ret.split("\n") if path]
+
     def output(self, fd, selector, vertex_range=None, **kwargs):
         """Dump results to `fd`.
         Support dumps data to local (respect to pod) files, hdfs or oss.
@@ -271,6 +391,17 @@ class BaseContext(object):
         df = self.to_dataframe(selector, vertex_range)
         df.to_csv(fd, header=True, index=False)
 
+    def unload(self):
+        """Unload context. Both on engine side and python side. Set the key to None.
+        The other handles of the same cached context are kept readable.
+        """
+        if self._key:
+            op = dag_utils.unload_context(self)
+            op.eval()
+            self._key = None
+            self._graph = None
+            self._session_id = None
+
 
 class TensorContext(BaseContext):
     """Tensor context holds a tensor.
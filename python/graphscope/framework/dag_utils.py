@@ -89,6 +89,10 @@ def create_graph(session_id, graph_type, **kwargs):
         config[types_pb2.E_FILE] = utils.s_to_attr(kwargs["efile"])
         config[types_pb2.V_FILE] = utils.s_to_attr(kwargs["vfile"])
         config[types_pb2.DIRECTED] = utils.b_to_attr(kwargs["directed"])
+        if kwargs.get("memory_strategy"):
+            config[types_pb2.MEMORY_STRATEGY] = utils.s_to_attr(
+                kwargs["memory_strategy"]
+            )
     else:
         raise RuntimeError("Not supported graph type {}".format(graph_type))
 
@@ -259,6 +263,58 @@ def modify_vertices(graph, modify_type, vertices):
     return op
 
 
+def modify_edges_by_batch(graph, modify_type, batch):
+    """Create modify edges operation for nx graph with a columnar batch.
+
+    Args:
+        graph (:class:`nx.Graph`): A nx graph.
+        modify_type (`type_pb2.(NX_ADD_EDGES | NX_DEL_EDGES | NX_UPDATE_EDGES)`): The modify type
+        batch (bytes): An arrow IPC stream, whose first two columns are the source and
+            destination of edges, and the rest columns are the edge properties.
+
+    Returns:
+        An op to modify edges on the graph.
+    """
+    check_argument(graph.graph_type == types_pb2.DYNAMIC_PROPERTY)
+    config = {}
+    config[types_pb2.GRAPH_NAME] = utils.s_to_attr(graph.key)
+    config[types_pb2.MODIFY_TYPE] = utils.modify_type_to_attr(modify_type)
+    config[types_pb2.ARROW_BATCH] = utils.bytes_to_attr(batch)
+    op = Operation(
+        graph.session_id,
+        types_pb2.MODIFY_EDGES,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
+def modify_vertices_by_batch(graph, modify_type, batch):
+    """Create modify vertices operation for nx graph with a columnar batch.
+
+    Args:
+        graph (:class:`nx.Graph`): A nx graph.
+        modify_type (`type_pb2.(NX_ADD_NODES | NX_DEL_NODES | NX_UPDATE_NODES)`): The modify type
+        batch (bytes): An arrow IPC stream, whose first column is the node id, and the
+            rest columns are the node properties.
+
+    Returns:
+        An op to modify vertices on the graph.
+    """
+    check_argument(graph.graph_type == types_pb2.DYNAMIC_PROPERTY)
+    config = {}
+    config[types_pb2.GRAPH_NAME] = utils.s_to_attr(graph.key)
+    config[types_pb2.MODIFY_TYPE] = utils.modify_type_to_attr(modify_type)
+    config[types_pb2.ARROW_BATCH] = utils.bytes_to_attr(batch)
+    op = Operation(
+        graph.session_id,
+        types_pb2.MODIFY_VERTICES,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
 def run_app(graph, app, *args, **kwargs):
     """Run `app` on the `graph`.
 
@@ -294,7 +350,15 @@ def run_app(graph, app, *args, **kwargs):
 
 
 def report_graph(
-    graph, report_type, node=None, edge=None, fid=None, lid=None, key=None
+    graph,
+    report_type,
+    node=None,
+    edge=None,
+    fid=None,
+    lid=None,
+    key=None,
+    batch_size=None,
+    binary=False,
 ):
     """Create report operation for nx graph.
 
@@ -322,12 +386,24 @@ def report_graph(
                       DEG_BY_LOC,
                       IN_DEG_BY_LOC,
                       OUT_DEG_BY_LOC,
-                      NODES_BY_LOC)
-        node (str): node id, used as node id with 'NODE' report types. (optional)
-        edge (str): an edge with 'EDGE' report types. (optional)
+                      NODES_BY_LOC,
+                      HAS_NODES,
+                      HAS_EDGES,
+                      NODES_DATA,
+                      DEG_BY_NODES,
+                      IN_DEG_BY_NODES,
+                      OUT_DEG_BY_NODES)
+        node (str): node id, used as node id with 'NODE' report types, or a json
+            array of nodes with the batched types. (optional)
+        edge (str): an edge with 'EDGE' report types, or a json array of edges
+            with HAS_EDGES. (optional)
         fid (int): fragment id, with 'LOC' report types. (optional)
         lid (int): local id of node in grape_engine, with 'LOC; report types. (optional)
         key (str): edge key for MultiGraph or MultiDiGraph, with 'EDGE' report types. (optional)
+        batch_size (int): the number of nodes of a batch with 'LOC' report types,
+            100 by default. (optional)
+        binary (bool): report the batch of 'LOC' report types in the binary layout
+            rather than json. (optional)
 
     Returns:
         An op to do reporting job.
@@ -346,11 +422,26 @@ def report_graph(
         config[types_pb2.LID] = utils.i_to_attr(lid)
 
     config[types_pb2.EDGE_KEY] = utils.s_to_attr(str(key) if key is not None else "")
+    if batch_size is not None:
+        config[types_pb2.BATCH_SIZE] = utils.i_to_attr(batch_size)
+    if binary:
+        config[types_pb2.BATCH_BINARY] = utils.b_to_attr(True)
+    # the batched reports except NODES_DATA are packed binary
+    if binary or report_type in (
+        types_pb2.HAS_NODES,
+        types_pb2.HAS_EDGES,
+        types_pb2.DEG_BY_NODES,
+        types_pb2.IN_DEG_BY_NODES,
+        types_pb2.OUT_DEG_BY_NODES,
+    ):
+        output_types = types_pb2.TENSOR
+    else:
+        output_types = types_pb2.RESULTS
     op = Operation(
         graph.session_id,
         types_pb2.REPORT_GRAPH,
         config=config,
-        output_types=types_pb2.RESULTS,
+        output_types=output_types,
     )
     return op
 
@@ -390,6 +481,13 @@ def project_arrow_property_graph_to_simple(
     e_data_type,
     oid_type=None,
     vid_type=None,
+    vertex_order=None,
+    materialize_edge_data=False,
+    compress_adjacency=False,
+    edge_filter=None,
+    out_of_core_dir=None,
+    sort_adjacency=False,
+    edge_window=None,
 ):
     """Project arrow property graph to a simple graph.
 
@@ -400,6 +498,22 @@ def project_arrow_property_graph_to_simple(
         v_prop_id (int): Property id of vertex used to project.
         e_label_id (int): Label id of edge used to project.
         e_prop_id (int): Property id of edge used to project.
+        vertex_order (str, optional): The order to traverse the inner vertices
+            in, 'degree', 'bfs' or 'rcm'. Defaults to the order of loading.
+        materialize_edge_data (bool, optional): Whether to copy the numeric edge
+            data along the neighbors, so the weighted apps read them sequentially.
+        compress_adjacency (bool, optional): Whether to keep a copy of the
+            neighbors compressed by delta and varint encoding, for the graphs
+            without edge data.
+        edge_filter (str, optional): Keep the edges passing the filter only, in
+            the form of '<prop_id> <op> <value>', e.g., '0 > 2.5'.
+        out_of_core_dir (str, optional): A local directory of the engines, e.g.,
+            on the SSD, to map the adjacency lists of the projected graph from.
+        sort_adjacency (bool, optional): Whether to sort the neighbors of each
+            vertex, for the binary searches of the edges and the intersections.
+        edge_window (str, optional): Keep the edges of which the time is in the
+            window only, in the form of '<prop_id> <begin> <end>', e.g.,
+            '1 1609459200 1610064000'.
 
     Returns:
         An op to project `graph`, results in a simple ARROW_PROJECTED graph.
@@ -417,6 +531,68 @@ def project_arrow_property_graph_to_simple(
         types_pb2.V_DATA_TYPE: utils.s_to_attr(utils.data_type_to_cpp(v_data_type)),
         types_pb2.E_DATA_TYPE: utils.s_to_attr(utils.data_type_to_cpp(e_data_type)),
     }
+    if vertex_order is not None:
+        check_argument(vertex_order in ("none", "degree", "bfs", "rcm"))
+        config[types_pb2.VERTEX_ORDER] = utils.s_to_attr(vertex_order)
+    if materialize_edge_data:
+        config[types_pb2.MATERIALIZE_EDGE_DATA] = utils.b_to_attr(True)
+    if compress_adjacency:
+        config[types_pb2.COMPRESS_ADJACENCY] = utils.b_to_attr(True)
+    if edge_filter is not None:
+        config[types_pb2.EDGE_FILTER] = utils.s_to_attr(edge_filter)
+    if out_of_core_dir:
+        config[types_pb2.OUT_OF_CORE_DIR] = utils.s_to_attr(out_of_core_dir)
+    if sort_adjacency:
+        config[types_pb2.SORT_ADJACENCY] = utils.b_to_attr(True)
+    if edge_window is not None:
+        config[types_pb2.EDGE_WINDOW] = utils.s_to_attr(edge_window)
+    op = Operation(
+        graph.session_id,
+        types_pb2.PROJECT_TO_SIMPLE,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
+def flatten_arrow_property_graph(
+    graph,
+    v_label_ids,
+    v_prop_ids,
+    e_label_ids,
+    e_prop_ids,
+    v_data_type,
+    e_data_type,
+    oid_type=None,
+    vid_type=None,
+):
+    """Flatten the labels of an arrow property graph to a simple graph.
+
+    Args:
+        graph (:class:`Graph`): Source graph, which type should be ARROW_PROPERTY
+        v_label_ids (list[int]): Label ids of the vertices to flatten.
+        v_prop_ids (list[int]): Property id of each vertex label, -1 for none.
+        e_label_ids (list[int]): Label ids of the edges to flatten.
+        e_prop_ids (list[int]): Property id of each edge label, -1 for none.
+
+    Returns:
+        An op to flatten `graph`, results in a simple ARROW_FLATTENED graph.
+    """
+    check_argument(graph.graph_type == types_pb2.ARROW_PROPERTY)
+    check_argument(len(v_label_ids) == len(v_prop_ids) and v_label_ids)
+    check_argument(len(e_label_ids) == len(e_prop_ids))
+    config = {
+        types_pb2.GRAPH_NAME: utils.s_to_attr(graph.key),
+        types_pb2.GRAPH_TYPE: utils.graph_type_to_attr(types_pb2.ARROW_FLATTENED),
+        types_pb2.V_LABEL_IDS: utils.list_i_to_attr(v_label_ids),
+        types_pb2.V_PROP_IDS: utils.list_i_to_attr(v_prop_ids),
+        types_pb2.E_LABEL_IDS: utils.list_i_to_attr(e_label_ids),
+        types_pb2.E_PROP_IDS: utils.list_i_to_attr(e_prop_ids),
+        types_pb2.OID_TYPE: utils.s_to_attr(oid_type),
+        types_pb2.VID_TYPE: utils.s_to_attr(vid_type),
+        types_pb2.V_DATA_TYPE: utils.s_to_attr(utils.data_type_to_cpp(v_data_type)),
+        types_pb2.E_DATA_TYPE: utils.s_to_attr(utils.data_type_to_cpp(e_data_type)),
+    }
     op = Operation(
         graph.session_id,
         types_pb2.PROJECT_TO_SIMPLE,
@@ -603,6 +779,56 @@ def clear_edges(graph):
     return op
 
 
+def serialize_graph(graph, path):
+    """Create serialize graph operation for nx graph or arrow property graph.
+
+    Args:
+        graph (:class:`nx.Graph` or :class:`Graph`): A nx graph or a
+            property graph.
+        path (str): The directory to write the snapshot, each worker writes
+            its fragment to a separate file.
+
+    Returns:
+        An op to write a snapshot of the graph.
+    """
+    check_argument(
+        graph.graph_type in (types_pb2.DYNAMIC_PROPERTY, types_pb2.ARROW_PROPERTY)
+    )
+    config = {
+        types_pb2.GRAPH_NAME: utils.s_to_attr(graph.key),
+        types_pb2.SNAPSHOT_PATH: utils.s_to_attr(path),
+    }
+    op = Operation(
+        graph.session_id,
+        types_pb2.SERIALIZE_GRAPH,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
+def deserialize_graph(session_id, path):
+    """Create deserialize graph operation for nx graph.
+
+    Args:
+        session_id (str): Session id.
+        path (str): The directory of the snapshot written by `serialize_graph`.
+
+    Returns:
+        An op to restore a nx graph from the snapshot.
+    """
+    config = {
+        types_pb2.SNAPSHOT_PATH: utils.s_to_attr(path),
+    }
+    op = Operation(
+        session_id,
+        types_pb2.DESERIALIZE_GRAPH,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
 def create_subgraph(graph, nodes=None, edges=None):
     """Create subgraph operation for nx graph.
 
@@ -648,6 +874,25 @@ def unload_app(app):
     return op
 
 
+def unload_context(results):
+    """Unload the handle of a context.
+
+    Args:
+        results (:class:`Context`): The context to unload.
+
+    Returns:
+        An op to unload the `results`.
+    """
+    config = {types_pb2.CTX_NAME: utils.s_to_attr(results.key)}
+    op = Operation(
+        results._session_id,
+        types_pb2.UNLOAD_CONTEXT,
+        config=config,
+        output_types=types_pb2.RESULTS,
+    )
+    return op
+
+
 def unload_graph(graph):
     """Unload a graph.
 
@@ -699,13 +944,15 @@ def context_to_numpy(results, selector=None, vertex_range=None, axis=0):
     return op
 
 
-def context_to_dataframe(results, selector=None, vertex_range=None):
+def context_to_dataframe(results, selector=None, vertex_range=None, limit=None):
     """Retrieve results as a pandas DataFrame.
 
     Args:
         results (:class:`Context`): Results return by `run_app` operation, store the query results.
         selector (str): Select the type of data to retrieve.
         vertex_range (str): Specify a range to retrieve.
+        limit (str): Restrict the vertices retrieved by each worker, in json,
+            e.g., '{"top_k": 10}' or '{"sample": 10, "seed": 0}'.
 
     Returns:
         An op to retrieve query results and convert to pandas DataFrame.
@@ -717,6 +964,8 @@ def context_to_dataframe(results, selector=None, vertex_range=None):
         config[types_pb2.SELECTOR] = utils.s_to_attr(selector)
     if vertex_range is not None:
         config[types_pb2.VERTEX_RANGE] = utils.s_to_attr(vertex_range)
+    if limit is not None:
+        config[types_pb2.VERTEX_LIMIT] = utils.s_to_attr(limit)
     op = Operation(
         results._session_id,
         types_pb2.CONTEXT_TO_DATAFRAME,
@@ -780,6 +1029,54 @@ def to_vineyard_dataframe(results, selector=None, vertex_range=None):
     return op
 
 
+def context_to_files(results, prefix, selector):
+    """Write results to Arrow IPC files, each worker writes its own partition.
+
+    Args:
+        results (:class:`Context`): Results return by `run_app` operation, store the query results.
+        prefix (str): Prefix of the output files, on a storage reachable by all workers.
+        selector (str): Select the type of data to retrieve.
+
+    Returns:
+        An op to write the query results, which returns the paths of the files.
+    """
+    config = {
+        types_pb2.CTX_NAME: utils.s_to_attr(results.key),
+        types_pb2.OUTPUT_PREFIX: utils.s_to_attr(prefix),
+        types_pb2.SELECTOR: utils.s_to_attr(selector),
+    }
+    op = Operation(
+        results._session_id,
+        types_pb2.CONTEXT_TO_FILES,
+        config=config,
+        output_types=types_pb2.RESULTS,
+    )
+    return op
+
+
+def context_to_arrow(results, selector):
+    """Retrieve results as the Arrow IPC streams of the workers.
+
+    Args:
+        results (:class:`Context`): Results return by `run_app` operation, store the query results.
+        selector (str): Select the type of data to retrieve.
+
+    Returns:
+        An op to retrieve query results as Arrow IPC streams.
+    """
+    config = {
+        types_pb2.CTX_NAME: utils.s_to_attr(results.key),
+        types_pb2.SELECTOR: utils.s_to_attr(selector),
+    }
+    op = Operation(
+        results._session_id,
+        types_pb2.CONTEXT_TO_ARROW,
+        config=config,
+        output_types=types_pb2.DATAFRAME,
+    )
+    return op
+
+
 def add_column(graph, results, selector):
     """Add a column to `graph`, produce a new graph.
 
@@ -807,6 +1104,32 @@ def add_column(graph, results, selector):
     return op
 
 
+def rebalance_graph(graph, strategy="degree_aware"):
+    """Rebuild the fragments of an arrow property graph, with the vertices
+    placed by their degrees.
+
+    Args:
+        graph (:class:`Graph`): Source ArrowProperty graph.
+        strategy (str): 'edge_balanced' or 'degree_aware'.
+
+    Returns:
+        An op to create a new graph with the same data.
+    """
+    check_argument(graph.graph_type == types_pb2.ARROW_PROPERTY)
+    check_argument(strategy in ("edge_balanced", "degree_aware"))
+    config = {
+        types_pb2.GRAPH_NAME: utils.s_to_attr(graph.key),
+        types_pb2.PARTITION_STRATEGY: utils.s_to_attr(strategy),
+    }
+    op = Operation(
+        graph.session_id,
+        types_pb2.REBALANCE_GRAPH,
+        config=config,
+        output_types=types_pb2.GRAPH,
+    )
+    return op
+
+
 def graph_to_numpy(graph, selector=None, vertex_range=None):
     """Retrieve graph raw data as a numpy ndarray.
 
@@ -859,3 +1182,49 @@ def graph_to_dataframe(graph, selector=None, vertex_range=None):
         output_types=types_pb2.DATAFRAME,
     )
     return op
+
+
+def graph_to_vineyard_dataframe(graph, selector=None, vertex_range=None):
+    """Write graph raw data to a vineyard dataframe, of which each worker
+    holds the chunk of its fragment.
+
+    Args:
+        graph (:class:`Graph`): Source graph.
+        selector (str): Select the type of data to retrieve.
+        vertex_range (str): Specify a range to retrieve.
+
+    Returns:
+        An op to convert a graph's data to a vineyard dataframe.
+    """
+    config = {
+        types_pb2.GRAPH_NAME: utils.s_to_attr(graph.key),
+    }
+    if selector is not None:
+        config[types_pb2.SELECTOR] = utils.s_to_attr(selector)
+    if vertex_range is not None:
+        config[types_pb2.VERTEX_RANGE] = utils.s_to_attr(vertex_range)
+    op = Operation(
+        graph.session_id,
+        types_pb2.GRAPH_TO_VINEYARD_DATAFRAME,
+        config=config,
+        output_types=types_pb2.VINEYARD_DATAFRAME,
+    )
+    return op
+
+
+def report_memory(session_id):
+    """Report the bytes held by the objects of each worker, i.e., the graphs,
+    the apps and the contexts.
+
+    Args:
+        session_id (str): The session the objects belong to.
+
+    Returns:
+        An op to report the memory, which returns one line of json per worker.
+    """
+    op = Operation(
+        session_id,
+        types_pb2.REPORT_MEMORY,
+        output_types=types_pb2.RESULTS,
+    )
+    return op
@@ -74,6 +74,7 @@ class Graph(object):
         oid_type="int64",
         directed=True,
         generate_eid=True,
+        vid_type="uint64",
     ):
         """Construct a :class:`Graph` object.
 
@@ -86,6 +87,12 @@ class Graph(object):
                     - :class:`nx.Graph`
                     - :class:`Graph`
                     - :class:`vineyard.Object`, :class:`vineyard.ObjectId` or :class:`vineyard.ObjectName`
+            vid_type (str, optional): The type of the internal ids of the vertices
+                loaded, "uint64" or "uint32". The latter halves the memory of the
+                ids in the topology, and fits the graphs of up to about 2^32 vertices
+                divided by the number of fragments and vertex labels. The graphs of
+                uint32 ids can not be converted to or from a networkx graph.
+                Defaults to "uint64".
         """
 
         self._key = None
@@ -109,6 +116,10 @@ class Graph(object):
         if oid_type not in ("int64_t", "std::string"):
             raise ValueError("oid_type can only be int64_t or string.")
         self._oid_type = oid_type
+        vid_type = utils.normalize_data_type_str(vid_type)
+        if vid_type not in ("uint64_t", "uint32_t"):
+            raise ValueError("vid_type can only be uint64 or uint32.")
+        self._vid_type = vid_type
         self._directed = directed
         self._generate_eid = generate_eid
 
@@ -128,7 +139,8 @@ class Graph(object):
             if isinstance(incoming_data, Operation):
                 self._pending_op = incoming_data
                 if self._pending_op.type == types_pb2.PROJECT_TO_SIMPLE:
-                    self._graph_type = types_pb2.ARROW_PROJECTED
+                    op_def = self._pending_op.as_op_def()
+                    self._graph_type = op_def.attr[types_pb2.GRAPH_TYPE].graph_type
             elif isinstance(incoming_data, nx.Graph):
                 self._pending_op = self._from_nx_graph(incoming_data)
             elif isinstance(incoming_data, Graph):
@@ -175,6 +187,7 @@ class Graph(object):
         self._key = graph_def.key
         self._vineyard_id = graph_def.vineyard_id
         self._oid_type = graph_def.schema_def.oid_type
+        self._vid_type = graph_def.schema_def.vid_type
         self._directed = graph_def.directed
         self._generate_eid = graph_def.generate_eid
 
@@ -266,6 +279,8 @@ class Graph(object):
             template = f"vineyard::ArrowFragment<{oid_type},{vid_type}>"
         elif self._graph_type == types_pb2.ARROW_PROJECTED:
             template = f"gs::ArrowProjectedFragment<{oid_type},{vid_type},{vdata_type},{edata_type}>"
+        elif self._graph_type == types_pb2.ARROW_FLATTENED:
+            template = f"gs::ArrowFlattenedFragment<{oid_type},{vid_type},{vdata_type},{edata_type}>"
         elif self._graph_type == types_pb2.DYNAMIC_PROJECTED:
             template = f"gs::DynamicProjectedFragment<{vdata_type},{edata_type}>"
         else:
@@ -364,7 +379,50 @@ class Graph(object):
         self._session = None
         self._pending_op = None
 
-    def _project_to_simple(self):
+    def _project_to_simple(
+        self,
+        vertex_order=None,
+        materialize_edge_data=False,
+        compress_adjacency=False,
+        edge_filter=None,
+        out_of_core_dir=None,
+        sort_adjacency=False,
+        edge_window=None,
+    ):
+        """Project the graph to a simple graph of a vertex label and an edge label.
+
+        Args:
+            vertex_order (str, optional): 'degree', 'bfs' or 'rcm', the order to
+                traverse the inner vertices in by the apps, e.g., pagerank, to
+                improve the cache locality. Defaults to the order of loading.
+            materialize_edge_data (bool, optional): Copy the numeric edge data in
+                the order of the neighbors, for the apps reading the edge data,
+                e.g., sssp, at the cost of the memory. Defaults to False.
+            compress_adjacency (bool, optional): Encode the neighbors by delta and
+                varint, for the unweighted apps on the graphs without edge data.
+                Defaults to False.
+            edge_filter (tuple, optional): (property, op, value) to keep the edges
+                of which the numeric property passes the comparison only, e.g.,
+                ('weight', '>', 0.5). op is one of <, <=, >, >=, == and !=.
+                The property tables are not copied. Defaults to None.
+            out_of_core_dir (str, optional): A local directory of the engines, e.g.,
+                on the SSD, to move the adjacency lists of the projected graph to,
+                for the graphs exceeding the memory, as the lists are mapped from
+                it and loaded on demand. They are laid out in vertex_order, e.g.,
+                'degree', in which the apps scan them. Defaults to None.
+            sort_adjacency (bool, optional): Sort the neighbors of each vertex, in
+                parallel, for the apps checking the edges or intersecting the
+                neighbors, e.g., triangles, by the binary searches instead of the
+                scans or hashing. Defaults to False.
+            edge_window (tuple, optional): (property, begin, end) to keep the
+                edges of which the integral, date or timestamp property is in
+                [begin, end) only, e.g., ('timestamp', t - 7 * 86400, t), in the
+                order of the times. The neighbors are sorted by the property
+                once and shared by the windows of it, so another window only
+                searches the lists of the vertices. Not supported with
+                edge_filter, compress_adjacency or sort_adjacency, and by the
+                apps splitting the edges by the fragments. Defaults to None.
+        """
         self._ensure_loaded()
         check_argument(self.graph_type == types_pb2.ARROW_PROPERTY)
         check_argument(
@@ -399,6 +457,20 @@ class Graph(object):
         oid_type = self._schema.oid_type
         vid_type = self._schema.vid_type
 
+        edge_filter_str = None
+        if edge_filter is not None:
+            prop, cmp_op, value = edge_filter
+            check_argument(cmp_op in ("<", "<=", ">", ">=", "==", "!="))
+            prop_id = self.schema.get_edge_property_id(e_label, prop)
+            edge_filter_str = f"{prop_id} {cmp_op} {float(value)!r}"
+
+        edge_window_str = None
+        if edge_window is not None:
+            prop, begin, end = edge_window
+            check_argument(int(begin) <= int(end))
+            prop_id = self.schema.get_edge_property_id(e_label, prop)
+            edge_window_str = f"{prop_id} {int(begin)} {int(end)}"
+
         op = dag_utils.project_arrow_property_graph_to_simple(
             self,
             v_label_id,
@@ -409,6 +481,69 @@ class Graph(object):
             edata_type,
             oid_type,
             vid_type,
+            vertex_order,
+            materialize_edge_data,
+            compress_adjacency,
+            edge_filter_str,
+            out_of_core_dir,
+            sort_adjacency,
+            edge_window_str,
+        )
+        graph = Graph(self._session, op)
+        graph._base_graph = self
+        return graph
+
+    def _project_to_flattened(self):
+        """Flatten all the labels of the graph to a simple graph, in which the
+        vertices of the labels share a vid space, for the apps of the simple
+        graphs, e.g., pagerank, over the whole heterogeneous graph.
+
+        Each label has at most one property, and the properties of the vertex
+        labels, and the ones of the edge labels, are of the same type.
+        """
+        self._ensure_loaded()
+        check_argument(self.graph_type == types_pb2.ARROW_PROPERTY)
+
+        def single_prop(props, kind, label):
+            check_argument(
+                len(props) <= 1,
+                f"Cannot flatten, {kind} label {label} has more than one property.",
+            )
+            return (props[0].id, props[0].type) if props else (-1, None)
+
+        v_label_ids, v_prop_ids, v_types = [], [], set()
+        for v_label in self.schema.vertex_labels:
+            prop_id, prop_type = single_prop(
+                self.schema.get_vertex_properties(v_label), "vertex", v_label
+            )
+            v_label_ids.append(self.schema.get_vertex_label_id(v_label))
+            v_prop_ids.append(prop_id)
+            v_types.add(prop_type)
+        e_label_ids, e_prop_ids, e_types = [], [], set()
+        for e_label in self.schema.edge_labels:
+            prop_id, prop_type = single_prop(
+                self.schema.get_edge_properties(e_label), "edge", e_label
+            )
+            e_label_ids.append(self.schema.get_edge_label_id(e_label))
+            e_prop_ids.append(prop_id)
+            e_types.add(prop_type)
+        check_argument(
+            len(v_types) == 1, "Cannot flatten, vertex properties differ in type."
+        )
+        check_argument(
+            len(e_types) <= 1, "Cannot flatten, edge properties differ in type."
+        )
+
+        op = dag_utils.flatten_arrow_property_graph(
+            self,
+            v_label_ids,
+            v_prop_ids,
+            e_label_ids,
+            e_prop_ids,
+            v_types.pop(),
+            e_types.pop() if e_types else None,
+            self._schema.oid_type,
+            self._schema.vid_type,
         )
         graph = Graph(self._session, op)
         graph._base_graph = self
@@ -442,6 +577,28 @@ class Graph(object):
         graph._ensure_loaded()
         return graph
 
+    def rebalance(self, strategy="degree_aware"):
+        """Rebuild the fragments with the vertices placed by their degrees,
+        e.g., when the edges are skewed across the workers after appends. The
+        vertices are migrated along with their edges and properties, without
+        reading the sources again.
+
+        Args:
+            strategy (str, optional): 'degree_aware' places the vertices from
+                the heaviest one to the least loaded fragment, 'edge_balanced'
+                cuts them into contiguous ranges. Defaults to 'degree_aware'.
+
+        Returns:
+            :class:`Graph`: A new `Graph` with the same schema and data.
+        """
+        self._ensure_loaded()
+        check_argument(self.graph_type == types_pb2.ARROW_PROPERTY)
+        op = dag_utils.rebalance_graph(self, strategy)
+        graph = Graph(self._session, op)
+        graph._base_graph = self
+        graph._ensure_loaded()
+        return graph
+
     def to_numpy(self, selector, vertex_range=None):
         """Select some elements of the graph and output to numpy.
 
@@ -488,6 +645,37 @@ class Graph(object):
         ret = op.eval()
         return utils.decode_dataframe(ret)
 
+    def to_vineyard_dataframe(self, selector, vertex_range=None):
+        """Select some elements of the graph and output as a vineyard dataframe,
+        without gathering them to a worker. Each worker writes the columns
+        of its fragment as a chunk, so the chunks can be fetched from the
+        vineyardd of the workers in parallel. Only object id is returned.
+
+        Args:
+            selector (dict): Select some portions of graph.
+            vertex_range (dict, optional): Slice vertices. Defaults to None.
+
+        Returns:
+            str: object id of the vineyard dataframe
+        """
+        check_argument(self.graph_type == types_pb2.ARROW_PROPERTY)
+        self._ensure_loaded()
+        self._check_unmodified()
+        check_argument(
+            isinstance(selector, Mapping),
+            "selector of to_vineyard_dataframe must be a dict",
+        )
+        selector = {
+            key: utils.transform_labeled_vertex_property_data_selector(self, value)
+            for key, value in selector.items()
+        }
+        selector = json.dumps(selector)
+        vertex_range = utils.transform_vertex_range(vertex_range)
+
+        op = dag_utils.graph_to_vineyard_dataframe(self, selector, vertex_range)
+        ret = op.eval()
+        return json.loads(ret)["object_id"]
+
     def is_directed(self):
         self._ensure_loaded()
         return self._directed
@@ -669,6 +857,63 @@ class Graph(object):
         )
         return cls(sess, vineyard.ObjectID(graph_id))
 
+    def save_snapshot(self, path):
+        """Write a binary snapshot of the graph to a directory.
+
+        Each worker writes its fragment, along with the vertex map, to
+        `path/arrow_frag_{fid}.dat`, which can be restored by
+        `Graph.load_snapshot` in a session with the same number of workers,
+        and with the same `oid_type` and `vid_type` as this graph, without
+        parsing, shuffling or indexing the data again.
+
+        Args:
+            path (str): A local directory, or a uri of an object storage,
+                e.g., s3, hdfs, which is visible to the workers.
+        """
+        check_argument(self.graph_type == types_pb2.ARROW_PROPERTY)
+        self._ensure_loaded()
+        op = dag_utils.serialize_graph(self, path)
+        op.eval()
+
+    @classmethod
+    def load_snapshot(cls, path, sess, oid_type="int64", vid_type="uint64"):
+        """Construct a `Graph` from the snapshot written by `Graph.save_snapshot`.
+
+        Args:
+            path (str): The directory of the snapshot.
+            sess (`graphscope.Session`): The target session, which must have
+                as many workers as the one that wrote the snapshot.
+            oid_type (str, optional): The type of the ids of the vertices of
+                the saved graph, `int64` or `string`. Defaults to `int64`.
+            vid_type (str, optional): The type of the internal ids of the
+                vertices of the saved graph, `uint64` or `uint32`.
+                Defaults to `uint64`.
+
+        Raises:
+            AnalyticalEngineInternalError: If the types are not the ones of the
+                saved graph, or the number of the workers differs.
+
+        Returns:
+            `Graph`: A new graph object with the same schema and data.
+        """
+        oid_type = utils.normalize_data_type_str(oid_type)
+        if oid_type not in ("int64_t", "std::string"):
+            raise ValueError("oid_type can only be int64_t or string.")
+        vid_type = utils.normalize_data_type_str(vid_type)
+        if vid_type not in ("uint64_t", "uint32_t"):
+            raise ValueError("vid_type can only be uint64 or uint32.")
+        config = {}
+        config[types_pb2.SNAPSHOT_PATH] = utils.s_to_attr(path)
+        # the engine checks the types against the ones in the snapshot
+        config[types_pb2.OID_TYPE] = utils.s_to_attr(oid_type)
+        config[types_pb2.VID_TYPE] = utils.s_to_attr(vid_type)
+        op = dag_utils.create_graph(
+            sess.session_id, types_pb2.ARROW_PROPERTY, attrs=config
+        )
+        graph = cls(sess, op)
+        graph._ensure_loaded()
+        return graph
+
     def _construct_op(self, vertices, edges, is_from_existed_graph):
         config = graph_utils.assemble_op_config(
             vertices.values(),
@@ -676,6 +921,7 @@ class Graph(object):
             self._oid_type,
             self._directed,
             self._generate_eid,
+            vid_type=self._vid_type,
         )
         if is_from_existed_graph:
             op = dag_utils.add_labels_to_graph(self, attrs=config)
@@ -716,12 +962,18 @@ class Graph(object):
                     self._oid_type,
                     self._directed,
                     self._generate_eid,
+                    self._vid_type,
                 )
 
         op = self._construct_op(vertices, edges, is_from_existed_graph)
 
         graph = Graph(
-            self._session, op, self._oid_type, self._directed, self._generate_eid
+            self._session,
+            op,
+            self._oid_type,
+            self._directed,
+            self._generate_eid,
+            self._vid_type,
         )
         graph._unsealed_vertices = vertices
         graph._unsealed_edges = edges
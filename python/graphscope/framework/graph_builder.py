@@ -69,6 +69,10 @@ def load_from(
     directed=True,
     oid_type="int64_t",
     generate_eid=True,
+    read_concurrency=1,
+    partition_strategy=None,
+    vid_type="uint64_t",
+    compress_properties=False,
 ) -> Graph:
     """Load a Arrow property graph using a list of vertex/edge specifications.
 
@@ -166,6 +170,25 @@ def load_from(
         generate_eid (bool, optional): Whether to generate a unique edge id for each edge. Generated eid will be placed
             in third column. This feature is for cooperating with interactive engine.
             If you only need to work with analytical engine, set it to False. Defaults to False.
+        read_concurrency (int, optional): The number of threads reading the slice of
+            each file on every worker, which are merged into one table. Defaults to 1.
+        partition_strategy (str, optional): How the vertices are placed to the
+            fragments, one of "hash", "segment", "edge_balanced" and "degree_aware".
+            The last two weight the vertices by their degrees, so the fragments hold
+            about the same number of edges on skewed graphs, and need the vertex
+            files. Defaults to None, i.e., the strategy the engine is built with.
+        vid_type (str, optional): Internal ID type of the vertices, "uint64_t" or
+            "uint32_t". The latter halves the memory of the ids in the topology, for
+            the graphs of up to about 2^32 vertices divided by the number of
+            fragments and vertex labels. Defaults to "uint64_t".
+        compress_properties (bool, optional): Whether the vertex property columns
+            are encoded before sealed, i.e., the strings of few distinct values by
+            dictionaries, and the integers by the offsets from their minimums in
+            narrower integers. The encoded properties are decoded by the
+            interactive engine, the conversion to networkx graphs and the
+            vertex data selectors of the contexts, while projecting them for
+            the analytical apps raises an error. The edge properties are not
+            encoded. Defaults to False.
     """
 
     # Don't import the :code:`nx` in top-level statments to improve the
@@ -180,9 +203,22 @@ def load_from(
     oid_type = utils.normalize_data_type_str(oid_type)
     if oid_type not in ("int64_t", "std::string"):
         raise ValueError("oid_type can only be int64_t or string.")
+    vid_type = utils.normalize_data_type_str(vid_type)
+    if vid_type not in ("uint64_t", "uint32_t"):
+        raise ValueError("vid_type can only be uint64_t or uint32_t.")
     v_labels = normalize_parameter_vertices(vertices)
     e_labels = normalize_parameter_edges(edges)
-    config = assemble_op_config(v_labels, e_labels, oid_type, directed, generate_eid)
+    config = assemble_op_config(
+        v_labels,
+        e_labels,
+        oid_type,
+        directed,
+        generate_eid,
+        read_concurrency,
+        partition_strategy,
+        vid_type,
+        compress_properties,
+    )
     op = dag_utils.create_graph(sess.session_id, types_pb2.ARROW_PROPERTY, attrs=config)
     graph = sess.g(op)
     return graph
@@ -296,6 +296,10 @@ def assemble_op_config(
     oid_type: str,
     directed: bool,
     generate_eid: bool,
+    read_concurrency: int = 1,
+    partition_strategy: str = None,
+    vid_type: str = "uint64_t",
+    compress_properties: bool = False,
 ) -> Dict:
     attr = attr_value_pb2.AttrValue()
 
@@ -310,8 +314,13 @@ def assemble_op_config(
     config[types_pb2.DIRECTED] = utils.b_to_attr(directed)
     config[types_pb2.OID_TYPE] = utils.s_to_attr(oid_type)
     config[types_pb2.GENERATE_EID] = utils.b_to_attr(generate_eid)
-    # vid_type is fixed
-    config[types_pb2.VID_TYPE] = utils.s_to_attr("uint64_t")
+    if read_concurrency > 1:
+        config[types_pb2.READ_CONCURRENCY] = utils.i_to_attr(read_concurrency)
+    if partition_strategy is not None:
+        config[types_pb2.PARTITION_STRATEGY] = utils.s_to_attr(partition_strategy)
+    if compress_properties:
+        config[types_pb2.COMPRESS_PROPERTIES] = utils.b_to_attr(True)
+    config[types_pb2.VID_TYPE] = utils.s_to_attr(vid_type)
     config[types_pb2.IS_FROM_VINEYARD_ID] = utils.b_to_attr(False)
     return config
 
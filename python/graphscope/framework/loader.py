@@ -108,6 +108,9 @@ class Loader(object):
                     * s3 file: specified by URL :code:`s3://...`
                     * numpy ndarray, in CSR format
                     * pandas dataframe
+                    * vineyard object, e.g., a :code:`vineyard.ObjectID` of a global
+                      dataframe whose chunks are already distributed across the
+                      cluster, the local chunks are read by each worker without copying
 
                 Ordinary data sources can be loaded using vineyard stream as well, a :code:`vineyard://`
                 prefix can be used in the URL then the local file, oss object or HDFS file will be loaded
@@ -192,11 +195,19 @@ class Loader(object):
         # If protocol is not set, use 'file' as default
         if not self.protocol:
             self.protocol = "file"
-        if self.protocol in ("hdfs", "hive", "oss", "s3", "vineyard"):
+        # Parquet and ORC files are read by the engine with Arrow's filesystems,
+        # to only decode the selected columns.
+        by_vineyard = self.protocol in ("hdfs", "hive", "oss", "s3", "vineyard")
+        if by_vineyard and not self.is_columnar(source):
             self.process_vineyard(source)
         else:
             self.source = source
 
+    @staticmethod
+    def is_columnar(source: str) -> bool:
+        path = urlparse(source).path.lower()
+        return path.endswith((".parquet", ".parq", ".orc"))
+
     def process_numpy(self, source: Sequence[np.ndarray]):
         self.protocol = "numpy"
         self.row_num = source[0].shape[0]
@@ -328,7 +339,9 @@ class Loader(object):
         # Let graphscope handle local files cause it's implemented in c++ and
         # doesn't add an additional stream layer.
         # Maybe handled by vineyard in the near future
-        if self.protocol == "file":
+        if self.protocol == "file" or (
+            isinstance(self.source, str) and self.is_columnar(self.source)
+        ):
             source = "{}#{}".format(self.source, self.options)
             attr.func.attr[types_pb2.VALUES].CopyFrom(
                 utils.bytes_to_attr(source.encode("utf-8"))
@@ -113,6 +113,8 @@ def graph_type_to_cpp_class(graph_type):
         return "vineyard::ArrowFragment"
     if graph_type == types_pb2.ARROW_PROJECTED:
         return "gs::ArrowProjectedFragment"
+    if graph_type == types_pb2.ARROW_FLATTENED:
+        return "gs::ArrowFlattenedFragment"
     return "null"
 
 
@@ -225,6 +227,21 @@ def decode_dataframe(value):
     return pd.DataFrame(arrays)
 
 
+def decode_arrow_table(value):
+    """Decode the Arrow IPC streams of the workers as a pyarrow.Table."""
+    import pyarrow as pa
+
+    if not value:
+        raise RuntimeError("Value to decode should not be empty")
+    archive = OutArchive(value)
+    stream_num = archive.get_size()
+    tables = []
+    for _ in range(stream_num):
+        buffer = pa.py_buffer(archive.get_sized_block())
+        tables.append(pa.ipc.open_stream(buffer).read_all())
+    return pa.concat_tables(tables)
+
+
 def unify_type(t):
     # If type is None, we deduce type from source file.
     if t is None:
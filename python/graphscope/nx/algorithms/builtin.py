@@ -359,14 +359,27 @@ def has_path(G, source, target):
 
 @patch_docstring(nxa.shortest_path)
 def shortest_path(G, source=None, target=None, weight=None):
-    # FIXME: target and method not support.
+    # FIXME: method not support.
     if weight is None:
         weight = "weight"
         default = False
     else:
         default = True
     pg = G._project_to_simple(e_prop=weight)
-    return AppAssets(algo="sssp_path")(pg, source, weight=default)
+    if target is None:
+        return AppAssets(algo="sssp_path")(pg, source, weight=default)
+    # the predecessors are rebuilt from the distances, and the path is
+    # extracted from the exported (predecessor, node) pairs
+    ctx = AppAssets(algo="sssp_path")(pg, source, weight=default, rebuild=True)
+    parents = {node: parent for parent, node in ctx.to_numpy("r")}
+    path = [target]
+    while path[-1] != source:
+        if path[-1] not in parents:
+            raise nx.NetworkXNoPath(
+                "Target {} cannot be reachable from Source {}".format(target, source)
+            )
+        path.append(parents[path[-1]])
+    return path[::-1]
 
 
 @project_to_simple
@@ -660,14 +673,18 @@ def triangles(G, nodes=None):
 
 @project_to_simple
 @patch_docstring(nxa.transitivity)
-def transitivity(G):
+def transitivity(G, epsilon=None, delta=0.05):
     # FIXME: nodes not support.
+    if epsilon is not None:
+        # estimated by sampling the wedges, within epsilon with probability
+        # 1 - delta
+        return AppAssets(algo="approx_clustering")(G, "transitivity", epsilon, delta)
     return AppAssets(algo="transitivity")(G)
 
 
 @project_to_simple
 @patch_docstring(nxa.average_clustering)
-def average_clustering(G, nodes=None, count_zeros=True):
+def average_clustering(G, nodes=None, count_zeros=True, epsilon=None, delta=0.05):
     """Compute the average clustering coefficient for the graph G.
 
     The clustering coefficient for the graph is the average,
@@ -682,6 +699,13 @@ def average_clustering(G, nodes=None, count_zeros=True):
     ----------
     G : graph
 
+    epsilon : float, optional
+       If given, the coefficient is estimated by sampling the wedges, within
+       the additive error epsilon of the exact one.
+
+    delta : float, optional
+       The probability the estimate is off by more than epsilon.
+
     Returns
     -------
     avg : float
@@ -711,12 +735,15 @@ def average_clustering(G, nodes=None, count_zeros=True):
        https://arxiv.org/abs/0802.2512
     """
     # FIXME: nodes, weight, count_zeros not support.
+    if epsilon is not None:
+        ctx = AppAssets(algo="approx_clustering")(G, "avg_clustering", epsilon, delta)
+        return ctx.to_numpy("r")[0]
     ctx = AppAssets(algo="avg_clustering")(G)
     return ctx.to_numpy("r")[0]
 
 
 @project_to_simple
-def weakly_connected_components(G):
+def weakly_connected_components(G, hub_threshold=0):
     """Generate weakly connected components of G.
 
     Parameters
@@ -724,10 +751,16 @@ def weakly_connected_components(G):
     G : networkx graph
         A directed graph
 
+    hub_threshold : int, optional
+        The least edges of the vertices to send their components once to each
+        fragment holding their neighbors, which fan them out locally, rather
+        than to each of their neighbors on the other fragments. It cuts the
+        messages on the power-law graphs. 0 disables it. Defaults to 0.
+
     Returns
     -------
     comp :class:`VertexDataContext`: A context with each vertex assigned with a boolean:
         1 if the vertex satisfies k-core, otherwise 0.
 
     """
-    return AppAssets(algo="wcc_projected")(G)
+    return AppAssets(algo="wcc_projected")(G, hub_threshold)
@@ -17,12 +17,17 @@
 #
 
 import collections
+import itertools
+from collections.abc import ItemsView
 from collections.abc import MutableMapping
 
 from graphscope.proto import types_pb2
 
 __all__ = ["NodeDict", "AdjDict"]
 
+# the number of nodes of which the attributes are fetched at once
+NODES_DATA_BATCH_SIZE = 10000
+
 
 class NodeDict(MutableMapping):
     __slots__ = "_graph"
@@ -63,6 +68,27 @@ class NodeDict(MutableMapping):
             for node in batch:
                 yield tuple(node["id"]) if isinstance(node["id"], list) else node["id"]
 
+    def items(self):
+        return NodeItemsView(self)
+
+
+class NodeItemsView(ItemsView):
+    """Iterates the (node, attributes) pairs by fetching the attributes of a
+    batch of nodes at once, instead of one report for each node.
+    """
+
+    __slots__ = ()
+
+    def __iter__(self):
+        graph = self._mapping._graph
+        it = iter(self._mapping)
+        while True:
+            batch = list(itertools.islice(it, NODES_DATA_BATCH_SIZE))
+            if not batch:
+                return
+            for n, data in zip(batch, graph._get_nodes_data(batch)):
+                yield (n, NodeAttrDict(graph, n, data or {}))
+
 
 class NodeAttrDict(MutableMapping):
     __slots__ = ("_graph", "_node", "mapping")
@@ -70,7 +96,7 @@ class NodeAttrDict(MutableMapping):
     def __init__(self, graph, node, data=None):
         self._graph = graph
         self._node = node
-        if data:
+        if data is not None:
             self.mapping = data
         else:
             self.mapping = graph.get_node_data(node)
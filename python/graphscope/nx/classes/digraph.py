@@ -24,10 +24,7 @@ from copy import deepcopy
 from networkx import freeze
 from networkx.classes.coreviews import AdjacencyView
 from networkx.classes.digraph import DiGraph as RefDiGraph
-from networkx.classes.reportviews import DiDegreeView
-from networkx.classes.reportviews import InDegreeView
 from networkx.classes.reportviews import InEdgeView
-from networkx.classes.reportviews import OutDegreeView
 from networkx.classes.reportviews import OutEdgeView
 
 from graphscope.client.session import get_default_session
@@ -36,6 +33,9 @@ from graphscope.framework.dag_utils import copy_graph
 from graphscope.framework.graph_schema import GraphSchema
 from graphscope.nx import NetworkXError
 from graphscope.nx.classes.graph import Graph
+from graphscope.nx.classes.reportviews import DiDegreeView
+from graphscope.nx.classes.reportviews import InDegreeView
+from graphscope.nx.classes.reportviews import OutDegreeView
 from graphscope.nx.convert import from_gs_graph
 from graphscope.nx.convert import to_nx_graph
 from graphscope.nx.utils.compat import patch_docstring
@@ -215,6 +215,7 @@ class DiGraph(Graph):
         create_empty_in_engine = attr.pop(
             "create_empty_in_engine", True
         )  # a hidden parameter
+        memory_strategy = attr.pop("memory_strategy", None)
 
         if self._is_gs_graph(incoming_graph_data):
             self._session_id = incoming_graph_data.session_id
@@ -228,7 +229,9 @@ class DiGraph(Graph):
             self._session_id = sess.session_id
 
         if not self._is_gs_graph(incoming_graph_data) and create_empty_in_engine:
-            graph_def = empty_graph_in_engine(self, self.is_directed())
+            graph_def = empty_graph_in_engine(
+                self, self.is_directed(), memory_strategy
+            )
             self._key = graph_def.key
 
         # attempt to load graph with data
@@ -113,6 +113,26 @@ def edge_subgraph(G, edges):
     return G.edge_subgraph(edges)
 
 
+def degree_histogram(G):
+    """Returns a list of the frequency of each degree value.
+
+    The histogram is counted by the engine, and cached until the graph is
+    modified.
+
+    Parameters
+    ----------
+    G : Networkx graph
+       A graph
+
+    Returns
+    -------
+    hist : list
+       A list of frequencies of degrees.
+       The degree values are the index in the list.
+    """
+    return G.degree_histogram()
+
+
 def number_of_selfloops(G):
     """Returns the number of selfloop edges.
 
@@ -22,11 +22,11 @@
 import copy
 import json
 
+import numpy as np
 from networkx import freeze
 from networkx.classes.coreviews import AdjacencyView
 from networkx.classes.graph import Graph as RefGraph
 from networkx.classes.graphviews import generic_graph_view
-from networkx.classes.reportviews import DegreeView
 from networkx.classes.reportviews import EdgeView
 from networkx.classes.reportviews import NodeView
 
@@ -40,11 +40,14 @@ from graphscope.framework.graph_schema import GraphSchema
 from graphscope.nx import NetworkXError
 from graphscope.nx.classes.dicts import AdjDict
 from graphscope.nx.classes.dicts import NodeDict
+from graphscope.nx.classes.reportviews import DegreeView
 from graphscope.nx.convert import from_gs_graph
 from graphscope.nx.convert import to_nx_graph
 from graphscope.nx.utils.compat import patch_docstring
 from graphscope.nx.utils.other import empty_graph_in_engine
+from graphscope.nx.utils.other import parse_binary_batch
 from graphscope.nx.utils.other import parse_ret_as_dict
+from graphscope.nx.utils.other import to_arrow_batch
 from graphscope.proto import types_pb2
 
 
@@ -225,6 +228,11 @@ class Graph(object):
         attr : keyword arguments, optional (default= no attributes)
             Attributes to add to graph as key=value pairs.
 
+        memory_strategy : str, optional (default: None)
+            The allocation of the graph in the engine, a comma separated list
+            of the options, of which "huge_pages" backs the large arrays of
+            the graph with the transparent huge pages.
+
 
         Examples
         --------
@@ -262,6 +270,7 @@ class Graph(object):
         create_empty_in_engine = attr.pop(
             "create_empty_in_engine", True
         )  # a hidden parameter
+        memory_strategy = attr.pop("memory_strategy", None)
 
         if self._is_gs_graph(incoming_graph_data):
             self._session_id = incoming_graph_data.session_id
@@ -275,7 +284,9 @@ class Graph(object):
             self._session_id = sess.session_id
 
         if not self._is_gs_graph(incoming_graph_data) and create_empty_in_engine:
-            graph_def = empty_graph_in_engine(self, self.is_directed())
+            graph_def = empty_graph_in_engine(
+                self, self.is_directed(), memory_strategy
+            )
             self._key = graph_def.key
 
         # attempt to load graph with data
@@ -563,8 +574,8 @@ class Graph(object):
             except (TypeError, ValueError):
                 node = [n, data]
             if self._schema.add_nx_vertex_properties(data):
-                nodes.append(json.dumps(node))
-        self._op = dag_utils.modify_vertices(self, types_pb2.NX_ADD_NODES, nodes)
+                nodes.append(node)
+        self._op = self._modify_vertices_op(types_pb2.NX_ADD_NODES, nodes)
         return self._op.eval()
 
     def remove_node(self, n):
@@ -850,16 +861,36 @@ class Graph(object):
                 )
             # FIXME: support dynamic data type in same property
             self._schema.add_nx_edge_properties(data)
-            edge = [u, v, data]
-            edges.append(json.dumps(edge))
+            edges.append([u, v, data])
             if len(edges) > 10000:  # make sure messages size not larger than rpc max
-                op = dag_utils.modify_edges(self, types_pb2.NX_ADD_EDGES, edges)
+                op = self._modify_edges_op(types_pb2.NX_ADD_EDGES, edges)
                 op.eval()
                 edges.clear()
         if len(edges) > 0:
-            op = dag_utils.modify_edges(self, types_pb2.NX_ADD_EDGES, edges)
+            op = self._modify_edges_op(types_pb2.NX_ADD_EDGES, edges)
             op.eval()
 
+    def _modify_edges_op(self, modify_type, edges):
+        """Create the op to modify the edges, as [u, v, data] lists, which are
+        sent as a columnar arrow batch when they can be typed, that saves the
+        json parsing in the engine, or as json lines otherwise.
+        """
+        batch = to_arrow_batch(edges, id_num=2)
+        if batch is not None:
+            return dag_utils.modify_edges_by_batch(self, modify_type, batch)
+        edges = [json.dumps(e) for e in edges]
+        return dag_utils.modify_edges(self, modify_type, edges)
+
+    def _modify_vertices_op(self, modify_type, nodes):
+        """Create the op to modify the nodes, as [n, data] lists, see
+        _modify_edges_op.
+        """
+        batch = to_arrow_batch(nodes, id_num=1)
+        if batch is not None:
+            return dag_utils.modify_vertices_by_batch(self, modify_type, batch)
+        nodes = [json.dumps(n) for n in nodes]
+        return dag_utils.modify_vertices(self, modify_type, nodes)
+
     def add_weighted_edges_from(self, ebunch_to_add, weight="weight", **attr):
         """Add weighted edges in `ebunch_to_add` with specified weight attr
 
@@ -1118,6 +1149,10 @@ class Graph(object):
         op = dag_utils.report_graph(self, types_pb2.SELFLOOPS_NUM)
         return int(op.eval())
 
+    def degree_histogram(self):
+        op = dag_utils.report_graph(self, types_pb2.DEGREE_HISTOGRAM)
+        return json.loads(op.eval())
+
     def has_edge(self, u, v):
         """Returns True if the edge (u, v) is in the graph.
 
@@ -1423,6 +1458,18 @@ class Graph(object):
             bunch = iter(self.nodes)
         elif nbunch in self:  # if nbunch is a single node
             bunch = iter([nbunch])
+        elif isinstance(nbunch, (list, tuple)):  # checks the nodes at once
+            for n in nbunch:
+                try:
+                    hash(n)
+                except TypeError as e:
+                    msg = "Node {} in sequence nbunch is not a valid node."
+                    raise NetworkXError(msg) from e
+            try:
+                found = self._has_nodes(list(nbunch))
+            except TypeError:
+                found = [n in self for n in nbunch]
+            bunch = iter([n for n, f in zip(nbunch, found) if f])
         else:  # if nbunch is a sequence of nodes
 
             def bunch_iter(nlist, adj):
@@ -1512,6 +1559,79 @@ class Graph(object):
         g._session_id = self._session_id
         return g
 
+    def save_snapshot(self, path):
+        """Write a binary snapshot of the graph to a directory.
+
+        Each worker writes its fragment, along with the vertex map, to
+        `path/dynamic_frag_{fid}.dat`, which can be restored by
+        `load_snapshot` in a session with the same number of workers. The
+        graph attributes, i.e., `G.graph`, are kept in the client and not
+        written.
+
+        Parameters
+        ----------
+        path : str
+            A local directory of the workers.
+
+        Examples
+        --------
+        >>> G = nx.path_graph(4)  # or DiGraph
+        >>> G.save_snapshot("/tmp/path_graph")
+        >>> H = nx.Graph.load_snapshot("/tmp/path_graph")
+        """
+        if self._is_view():
+            raise NetworkXError("Cannot save the snapshot of a graph view.")
+        op = dag_utils.serialize_graph(self, path)
+        op.eval()
+
+    @classmethod
+    def load_snapshot(cls, path, session=None):
+        """Construct a graph from the snapshot written by `save_snapshot`.
+
+        Parameters
+        ----------
+        path : str
+            The directory of the snapshot.
+        session : `graphscope.Session`, optional (default=None)
+            The session to restore the graph in, which must have as many
+            workers as the one that wrote the snapshot. The default session
+            is used if None.
+
+        Returns
+        -------
+        G : Graph
+            A new graph with the nodes, edges and their attributes of the
+            snapshot.
+
+        Raises
+        ------
+        AnalyticalEngineInternalError
+            If the snapshot is not found, or is written by another number
+            of workers.
+        NetworkXError
+            If the snapshot is of a directed graph but the class is not, or
+            vice versa.
+        """
+        sess = session if session is not None else get_default_session()
+        if sess is None:
+            raise ValueError(
+                "Cannot find a default session. "
+                "Please register a session using graphscope.session(...).as_default()"
+            )
+        g = cls(create_empty_in_engine=False)
+        g._session_id = sess.session_id
+        graph_def = dag_utils.deserialize_graph(sess.session_id, path).eval()
+        if graph_def.directed != g.is_directed():
+            raise NetworkXError(
+                "The snapshot is of a %s graph, use %s.load_snapshot instead."
+                % (
+                    "directed" if graph_def.directed else "undirected",
+                    "DiGraph" if graph_def.directed else "Graph",
+                )
+            )
+        g._key = graph_def.key
+        return g
+
     def to_undirected(self, as_view=False):
         """Returns an undirected copy of the graph.
 
@@ -1718,8 +1838,7 @@ class Graph(object):
     def _is_view(self):
         return hasattr(self, "_graph")
 
-    @parse_ret_as_dict
-    def _batch_get_node(self, location):
+    def _batch_get_node(self, location, batch_size=None):
         """Get node by location in batch.
 
         In grape engine, it will start fetch from location, and return a batch of nodes.
@@ -1728,6 +1847,8 @@ class Graph(object):
         ----------
         location: tuple
             location of start node, a tuple with fragment id and local id.
+        batch_size: int
+            the number of nodes of the batch, 100 by default.
 
         Returns
         -------
@@ -1744,9 +1865,14 @@ class Graph(object):
         {'status': True, 'next': [1, 0], 'batch': [1, 2, 3]}
         """
         op = dag_utils.report_graph(
-            self, types_pb2.NODES_BY_LOC, fid=location[0], lid=location[1]
+            self,
+            types_pb2.NODES_BY_LOC,
+            fid=location[0],
+            lid=location[1],
+            batch_size=batch_size,
+            binary=True,
         )
-        return op.eval()
+        return parse_binary_batch(op.eval(), types_pb2.NODES_BY_LOC)
 
     @parse_ret_as_dict
     def _get_nbrs(self, n, report_type=types_pb2.SUCCS_BY_NODE):
@@ -1782,7 +1908,9 @@ class Graph(object):
         op = dag_utils.report_graph(self, report_type, node=json.dumps([n]))
         return op.eval()
 
-    def _batch_get_nbrs(self, location, report_type=types_pb2.SUCCS_BY_LOC):
+    def _batch_get_nbrs(
+        self, location, report_type=types_pb2.SUCCS_BY_LOC, batch_size=None
+    ):
         """Get neighbors of nodes by location in batch.
 
         In grape engine, it will start fetch from location, and return a batch of nodes' neighbors.
@@ -1791,6 +1919,8 @@ class Graph(object):
         ----------
         location: tuple
             location of start node, a tuple with fragment id and local id.
+        batch_size: int
+            the number of nodes of the batch, 100 by default.
         report_type:
             the report type of report graph operation,
                 types_pb2.SUCCS_BY_LOC: get the successors,
@@ -1813,8 +1943,15 @@ class Graph(object):
         {'status': True, 'next': [1, 0],
         'batch': [{'node': 0, 'nbrs': {'1': {}, '2': {}}}], [{'node': 1 .....}]}
         """
-        op = dag_utils.report_graph(self, report_type, fid=location[0], lid=location[1])
-        return op.eval()
+        op = dag_utils.report_graph(
+            self,
+            report_type,
+            fid=location[0],
+            lid=location[1],
+            batch_size=batch_size,
+            binary=True,
+        )
+        return parse_binary_batch(op.eval(), report_type)
 
     def _get_degree(self, n, weight=None, report_type=types_pb2.OUT_DEG_BY_NODE):
         """Get degree of node.
@@ -1842,7 +1979,11 @@ class Graph(object):
         return degree if weight is not None else int(degree)
 
     def _batch_get_degree(
-        self, location, weight=None, report_type=types_pb2.OUT_DEG_BY_LOC
+        self,
+        location,
+        weight=None,
+        report_type=types_pb2.OUT_DEG_BY_LOC,
+        batch_size=None,
     ):
         """Get degree of nodes by location in batch.
 
@@ -1852,6 +1993,8 @@ class Graph(object):
         ----------
         location: tuple
             location of start node, a tuple with fragment id and local id.
+        batch_size: int
+            the number of nodes of the batch, 100 by default.
         report_type:
             the report type of report graph operation,
                 types_pb2.OUT_DEG_BY_LOC: get the out degree,
@@ -1879,9 +2022,92 @@ class Graph(object):
         ]}
         """
         op = dag_utils.report_graph(
-            self, report_type, fid=location[0], lid=location[1], key=weight
+            self,
+            report_type,
+            fid=location[0],
+            lid=location[1],
+            key=weight,
+            batch_size=batch_size,
+            binary=True,
         )
-        return op.eval()
+        return parse_binary_batch(op.eval(), report_type)
+
+    def _has_nodes(self, nodes):
+        """Check whether the nodes are in the graph with a single report.
+
+        Parameters
+        ----------
+        nodes: list of nodes
+
+        Returns
+        -------
+            list of bool, in the order of nodes.
+        """
+        if not nodes:
+            return []
+        op = dag_utils.report_graph(self, types_pb2.HAS_NODES, node=json.dumps(nodes))
+        return np.frombuffer(op.eval(), dtype=np.uint8).astype(bool).tolist()
+
+    def _has_edges(self, edges):
+        """Check whether the edges are in the graph with a single report.
+
+        Parameters
+        ----------
+        edges: list of (u, v) tuples
+
+        Returns
+        -------
+            list of bool, in the order of edges.
+        """
+        if not edges:
+            return []
+        op = dag_utils.report_graph(
+            self, types_pb2.HAS_EDGES, edge=json.dumps([list(e) for e in edges])
+        )
+        return np.frombuffer(op.eval(), dtype=np.uint8).astype(bool).tolist()
+
+    def _get_nodes_data(self, nodes):
+        """Get the attribute dicts of the nodes with a single report.
+
+        Parameters
+        ----------
+        nodes: list of nodes
+
+        Returns
+        -------
+            list of dict, None for the nodes not in the graph.
+        """
+        if not nodes:
+            return []
+        op = dag_utils.report_graph(self, types_pb2.NODES_DATA, node=json.dumps(nodes))
+        return json.loads(op.eval())
+
+    def _get_degrees(self, nodes, weight=None, report_type=types_pb2.OUT_DEG_BY_NODES):
+        """Get the degrees of the nodes with a single report.
+
+        Parameters
+        ----------
+        nodes: list of nodes
+        weight: the edge attribute to get degree. if is None, default 1
+        report_type:
+            the report type of report graph operation,
+            types_pb2.OUT_DEG_BY_NODES: get the out degrees of nodes,
+            types_pb2.IN_DEG_BY_NODES: get the in degrees of nodes,
+            types_pb2.DEG_BY_NODES: get the degrees of nodes,
+
+        Returns
+        -------
+            list of float or int, 0 for the nodes not in the graph.
+        """
+        if not nodes:
+            return []
+        op = dag_utils.report_graph(
+            self, report_type, node=json.dumps(nodes), key=weight
+        )
+        degrees = np.frombuffer(op.eval(), dtype=np.float64)
+        if weight is None:
+            degrees = degrees.astype(np.int64)
+        return degrees.tolist()
 
     def _project_to_simple(self, v_prop=None, e_prop=None):
         """Project nx graph to a simple graph to run builtin alogorithms.
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import itertools
+
+from networkx.classes import reportviews
+
+from graphscope.proto import types_pb2
+
+__all__ = ["DegreeView", "DiDegreeView", "InDegreeView", "OutDegreeView"]
+
+# the number of nodes of which the degrees are reported at once
+REPORT_BATCH_SIZE = 10000
+
+
+def batches(nodes, batch_size=REPORT_BATCH_SIZE):
+    """Splits the iterable of nodes to the lists of at most batch_size nodes."""
+    it = iter(nodes)
+    while True:
+        batch = list(itertools.islice(it, batch_size))
+        if not batch:
+            return
+        yield batch
+
+
+class _BatchedDegreeMixin(object):
+    """Iterates the (node, degree) pairs by reporting the degrees of a batch of
+    nodes at once, instead of fetching the neighbors of each node as the views
+    of networkx do. The views of the graph views, e.g., the reversed ones, are
+    left to networkx, as the engine reports the degrees of the underlying graph.
+    """
+
+    _report_type = types_pb2.DEG_BY_NODES
+
+    def __iter__(self):
+        if self._graph._is_view():
+            yield from super().__iter__()
+            return
+        for batch in batches(self._nodes):
+            degrees = self._graph._get_degrees(
+                batch, weight=self._weight, report_type=self._report_type
+            )
+            yield from zip(batch, self._adjust(batch, degrees))
+
+    def _adjust(self, nodes, degrees):
+        return degrees
+
+
+class DiDegreeView(_BatchedDegreeMixin, reportviews.DiDegreeView):
+    __doc__ = reportviews.DiDegreeView.__doc__
+
+
+class InDegreeView(_BatchedDegreeMixin, reportviews.InDegreeView):
+    __doc__ = reportviews.InDegreeView.__doc__
+    _report_type = types_pb2.IN_DEG_BY_NODES
+
+
+class OutDegreeView(_BatchedDegreeMixin, reportviews.OutDegreeView):
+    __doc__ = reportviews.OutDegreeView.__doc__
+    _report_type = types_pb2.OUT_DEG_BY_NODES
+
+
+class DegreeView(_BatchedDegreeMixin, reportviews.DegreeView):
+    __doc__ = reportviews.DegreeView.__doc__
+    # the neighbors of an undirected graph are the out edges in the engine
+    _report_type = types_pb2.OUT_DEG_BY_NODES
+
+    def _adjust(self, nodes, degrees):
+        # a self loop is stored once but counted twice, as networkx does
+        loops = self._graph._has_edges([(n, n) for n in nodes])
+        for n, degree, loop in zip(nodes, degrees, loops):
+            if loop:
+                if self._weight is None:
+                    degree += 1
+                else:
+                    data = self._graph.get_edge_data(n, n)
+                    degree += data.get(self._weight, 1)
+            yield degree
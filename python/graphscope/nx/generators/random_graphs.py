@@ -1020,10 +1020,13 @@ def powerlaw_cluster_graph(n, m, p, seed=None):
         count = 1
         while count < m:  # add m-1 more new links
             if seed.random() < p:  # clustering step: add triangle
+                # check the links to the neighbors with a single report
+                nbrs = list(G.neighbors(target))
+                linked = G._has_edges([(source, nbr) for nbr in nbrs])
                 neighborhood = [
                     nbr
-                    for nbr in G.neighbors(target)
-                    if not G.has_edge(source, nbr) and not nbr == source
+                    for nbr, has_edge in zip(nbrs, linked)
+                    if not has_edge and not nbr == source
                 ]
                 if neighborhood:  # if there is a neighbor without a link
                     nbr = seed.choice(neighborhood)
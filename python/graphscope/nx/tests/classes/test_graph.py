@@ -15,6 +15,7 @@
 # information.
 #
 
+import networkx
 import pytest
 from networkx.classes.tests.test_graph import TestEdgeSubgraph as _TestEdgeSubgraph
 from networkx.classes.tests.test_graph import TestGraph as _TestGraph
@@ -160,6 +161,75 @@ class TestGraph(_TestGraph):
         G.remove_edge(2, 2)
         assert G.number_of_selfloops() == 0
 
+    def test_batch_modification(self, monkeypatch):
+        nodes = [(i, {"name": f"node{i}", "weight": i * 0.5}) for i in range(20)]
+        nodes.append((20, {"name": "node20", "flag": True}))
+        edges = [(i, (i * 7) % 25, {"weight": i}) for i in range(30)]
+        edges.append((3, 4, {"color": "red"}))
+
+        def build():
+            G = self.Graph()
+            G.add_nodes_from(nodes)
+            G.add_edges_from(edges)
+            G.add_weighted_edges_from([(5, 6, 1.5), (6, 7, 2.5)], weight="w")
+            G.remove_edges_from([(0, 0), (1, 7)])
+            return G
+
+        G = build()
+        # the columnar batches are not used by the json lines
+        monkeypatch.setattr(
+            "graphscope.nx.classes.graph.to_arrow_batch", lambda *_, **__: None
+        )
+        H = build()
+        assert sorted(G.nodes(data=True)) == sorted(H.nodes(data=True))
+        assert sorted(G.edges(data=True)) == sorted(H.edges(data=True))
+        self.graphs_equal(G, H)
+
+    def test_batch_modification_fallback(self):
+        G = self.Graph()
+        # mixed ids, tuple ids and mixed properties are sent as json lines
+        G.add_nodes_from([1, "a", (2, 3)])
+        G.add_edges_from([(1, "a", {"w": 1}), ("a", (2, 3)), (4, 5, {"w": 0.5})])
+        assert sorted(G.nodes, key=str) == sorted([1, "a", (2, 3), 4, 5], key=str)
+        assert G[1]["a"] == {"w": 1}
+        assert G.has_edge("a", (2, 3))
+        assert G[4][5] == {"w": 0.5}
+
+    def test_mixed_node_types(self):
+        # the int nodes are looked up in the typed index of the engine, and the
+        # others, e.g., the float equal to an int, in the dynamic vertex map
+        nodes = [1, 2, 3.0, 4.5, "a", "5"]
+        edges = [(1, "a"), (2, 3.0), (3.0, 4.5), ("a", "5"), (4.5, 1)]
+        probes = nodes + [3, 1.0, 2.0, "1", 5, 6, "b"]
+        G = self.Graph()
+        G.add_nodes_from(nodes)
+        G.add_edges_from(edges)
+        expected = networkx.DiGraph() if G.is_directed() else networkx.Graph()
+        expected.add_nodes_from(nodes)
+        expected.add_edges_from(edges)
+
+        def check(H, E):
+            for n in probes:
+                assert H.has_node(n) == E.has_node(n)
+                if E.has_node(n):
+                    assert set(H[n]) == set(E[n])
+                else:
+                    with pytest.raises(KeyError):
+                        H[n]
+
+        check(G, expected)
+        # the copies share the vertex map with the graph until modified
+        H = G.copy()
+        D = G.to_directed()
+        directed = expected.to_directed()
+        check(H, expected)
+        check(D, directed)
+        H.add_edge(3, 6)
+        check(G, expected)
+        check(D.copy(), directed)
+        expected.add_edge(3, 6)
+        check(H, expected)
+
 
 @pytest.mark.usefixtures("graphscope_session")
 class TestEdgeSubgraph(_TestEdgeSubgraph):
@@ -40,6 +40,7 @@ from networkx.classes.tests.test_reportviews import \
 from networkx.classes.tests.test_reportviews import TestOutEdgeView as _TestOutEdgeView
 
 from graphscope import nx
+from graphscope.nx.classes import reportviews
 
 # fmt:on
 
@@ -178,7 +179,7 @@ class TestInEdgeView(_TestInEdgeView):
 
 class TestDegreeView(_TestDegreeView):
     GRAPH = nx.Graph
-    dview = networkx.reportviews.DegreeView
+    dview = reportviews.DegreeView
 
     def test_pickle(self):
         print(type(self.G))
@@ -187,7 +188,7 @@ class TestDegreeView(_TestDegreeView):
 
 class TestDiDegreeView(TestDegreeView):
     GRAPH = nx.DiGraph
-    dview = networkx.reportviews.DiDegreeView
+    dview = reportviews.DiDegreeView
 
     def test_repr(self):
         dv = self.G.degree()
@@ -197,7 +198,7 @@ class TestDiDegreeView(TestDegreeView):
 
 class TestOutDegreeView(_TestOutDegreeView):
     GRAPH = nx.DiGraph
-    dview = networkx.reportviews.OutDegreeView
+    dview = reportviews.OutDegreeView
 
     def test_pickle(self):
         pass
@@ -205,7 +206,60 @@ class TestOutDegreeView(_TestOutDegreeView):
 
 class TestInDegreeView(_TestInDegreeView):
     GRAPH = nx.DiGraph
-    dview = networkx.reportviews.InDegreeView
+    dview = reportviews.InDegreeView
 
     def test_pickle(self):
         pass
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestBatchedReports:
+    def setup_method(self):
+        edges = [(0, 1, 2), (1, 2, 3), (1, 3, 1.5), (3, 3, 4), (4, 0, 2.5)]
+        self.G, self.DG = nx.Graph(), nx.DiGraph()
+        self.nxG, self.nxDG = networkx.Graph(), networkx.DiGraph()
+        for G in [self.G, self.DG, self.nxG, self.nxDG]:
+            G.add_weighted_edges_from(edges)
+            G.add_node(5, foo="bar")
+            G.add_node(6)
+        for G in [self.DG, self.nxDG]:
+            G.add_weighted_edges_from([(5, 0, 1)])
+
+    def test_degree(self):
+        nbunch = [0, 1, 3, 5, 7]
+        for G, nxG in [(self.G, self.nxG), (self.DG, self.nxDG)]:
+            assert dict(G.degree) == dict(nxG.degree)
+            assert dict(G.degree(nbunch)) == dict(nxG.degree(nbunch))
+            assert dict(G.degree(weight="weight")) == dict(
+                nxG.degree(weight="weight")
+            )
+            assert dict(G.degree(nbunch, weight="weight")) == dict(
+                nxG.degree(nbunch, weight="weight")
+            )
+            assert G.degree(3) == nxG.degree(3)
+            assert G.degree(3, weight="weight") == nxG.degree(3, weight="weight")
+
+    def test_in_out_degree(self):
+        nbunch = [0, 3, 5]
+        for name in ["in_degree", "out_degree"]:
+            dv, nxdv = getattr(self.DG, name), getattr(self.nxDG, name)
+            assert dict(dv) == dict(nxdv)
+            assert dict(dv(nbunch)) == dict(nxdv(nbunch))
+            assert dict(dv(nbunch, weight="weight")) == dict(
+                nxdv(nbunch, weight="weight")
+            )
+
+    def test_nodes_data(self):
+        for G, nxG in [(self.G, self.nxG), (self.DG, self.nxDG)]:
+            assert sorted(G.nodes(data=True)) == sorted(nxG.nodes(data=True))
+            assert sorted(G.nodes.data("foo")) == sorted(nxG.nodes.data("foo"))
+            assert sorted(G.nodes.data("foo", default=0)) == sorted(
+                nxG.nodes.data("foo", default=0)
+            )
+            assert dict(G.nodes.items()) == dict(nxG.nodes.items())
+
+    def test_has_edges(self):
+        edges = [(0, 1), (1, 0), (3, 3), (0, 3), (5, 0), (7, 0)]
+        for G, nxG in [(self.G, self.nxG), (self.DG, self.nxDG)]:
+            assert G._has_edges(edges) == [nxG.has_edge(u, v) for u, v in edges]
+        assert self.G._has_edges([]) == []
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# Copyright 2020 Alibaba Group Holding Limited. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+import os
+import shutil
+import tempfile
+
+import pytest
+
+import graphscope
+import graphscope.nx as nx
+from graphscope.framework.errors import AnalyticalEngineInternalError
+
+
+def graphs_equal(G, H):
+    assert sorted(G.nodes(data=True), key=str) == sorted(H.nodes(data=True), key=str)
+    assert sorted(G.edges(data=True), key=str) == sorted(H.edges(data=True), key=str)
+    assert G.number_of_nodes() == H.number_of_nodes()
+    assert G.number_of_edges() == H.number_of_edges()
+    assert G.number_of_selfloops() == H.number_of_selfloops()
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestSnapshot(object):
+    NXGraph = nx.Graph
+
+    def setup_method(self):
+        self.path = tempfile.mkdtemp(prefix="nx_snapshot_")
+
+    def teardown_method(self):
+        shutil.rmtree(self.path, ignore_errors=True)
+
+    def mutated_graph(self):
+        G = self.NXGraph()
+        G.add_nodes_from([(i, {"name": f"node{i}"}) for i in range(10)])
+        G.add_edges_from([(i, (i * 3) % 10, {"weight": i * 0.5}) for i in range(10)])
+        G.add_node("a", score=1)
+        G.add_edge("a", (1, 2), label="mixed")
+        G.add_edge(4, 4, weight=1.0)
+        G.remove_node(7)
+        G.remove_edge(1, 3)
+        G.nodes[2]["name"] = "renamed"
+        G[5][5]["weight"] = 3.0
+        return G
+
+    def test_round_trip(self):
+        G = self.mutated_graph()
+        G.save_snapshot(self.path)
+        H = self.NXGraph.load_snapshot(self.path)
+        assert H.is_directed() == G.is_directed()
+        assert H.key != G.key
+        graphs_equal(G, H)
+        assert H.has_node((1, 2)) and H.nodes["a"] == {"score": 1}
+
+        # the restored graph is mutable and independent of the original one
+        H.add_edge(8, 9, weight=2.0)
+        H.remove_node(0)
+        assert not G.has_edge(8, 9) and G.has_node(0)
+        G.save_snapshot(self.path)
+        graphs_equal(G, self.NXGraph.load_snapshot(self.path))
+
+    def test_wrong_directed(self):
+        G = self.mutated_graph()
+        G.save_snapshot(self.path)
+        other = nx.Graph if G.is_directed() else nx.DiGraph
+        with pytest.raises(nx.NetworkXError, match="load_snapshot instead"):
+            other.load_snapshot(self.path)
+
+    def test_missing_snapshot(self):
+        with pytest.raises(AnalyticalEngineInternalError, match="Snapshot not found"):
+            self.NXGraph.load_snapshot(os.path.join(self.path, "missing"))
+
+    def test_different_fnum(self, graphscope_session):
+        G = self.mutated_graph()
+        G.save_snapshot(self.path)
+        num_workers = graphscope_session.info["num_workers"]
+        sess = graphscope.session(cluster_type="hosts", num_workers=num_workers + 1)
+        try:
+            with pytest.raises(AnalyticalEngineInternalError, match="(?i)snapshot"):
+                self.NXGraph.load_snapshot(self.path, session=sess)
+        finally:
+            sess.close()
+        # the session that wrote the snapshot still restores it
+        graphs_equal(G, self.NXGraph.load_snapshot(self.path))
+
+
+@pytest.mark.usefixtures("graphscope_session")
+class TestDiGraphSnapshot(TestSnapshot):
+    NXGraph = nx.DiGraph
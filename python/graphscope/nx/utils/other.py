@@ -17,12 +17,16 @@
 #
 
 import json
+import struct
+
+import numpy as np
 
 from graphscope.client.session import get_session_by_id
 from graphscope.framework import dag_utils
+from graphscope.proto import types_pb2
 
 
-def empty_graph_in_engine(graph, directed):
+def empty_graph_in_engine(graph, directed, memory_strategy=None):
     """create empty graph in grape_engine with the graph metadata.
 
     Parameters:
@@ -30,6 +34,7 @@ def empty_graph_in_engine(graph, directed):
     graph: the graph instance in python.
     graph_type: the graph type of graph (IMMUTABLE, ARROW, DYNAMIC).
     nx_graph_type: the networkx graph type of graph (Graph, DiGraph, MultiGraph, MultiDiGraph).
+    memory_strategy: the allocation of the graph in the engine, e.g., "huge_pages".
 
     """
     sess = get_session_by_id(graph.session_id)
@@ -39,6 +44,7 @@ def empty_graph_in_engine(graph, directed):
         directed=directed,
         efile="",
         vfile="",
+        memory_strategy=memory_strategy,
     )
     graph_def = sess.run(op)
     return graph_def
@@ -56,3 +62,130 @@ def parse_ret_as_dict(func):
         return ret
 
     return wrapper
+
+
+def _unpack_ids(buf, offset, size):
+    kind = buf[offset]
+    offset += 1
+    if kind == 0:
+        ids = np.frombuffer(buf, dtype=np.int64, count=size, offset=offset)
+        return ids.tolist(), offset + 8 * size
+    ids, offset = _unpack_string(buf, offset)
+    return json.loads(ids), offset
+
+
+def _unpack_string(buf, offset):
+    (length,) = struct.unpack_from("<Q", buf, offset)
+    offset += 8
+    return buf[offset : offset + length], offset + length
+
+
+def parse_binary_batch(buf, report_type):
+    """Parse the binary batch of the nodes, degrees or neighbors reported by
+    location, to the dict of the json batch, see the packs of
+    DynamicGraphReporter in the engine for the layout.
+    """
+    status, next_fid, next_lid, size = struct.unpack_from("<Bqqq", buf, 0)
+    offset = struct.calcsize("<Bqqq")
+    ret = {"status": bool(status), "next": [next_fid, next_lid]}
+    if not status:
+        return ret
+    ids, offset = _unpack_ids(buf, offset, size)
+    if report_type == types_pb2.NODES_BY_LOC:
+        data, offset = _unpack_string(buf, offset)
+        ret["batch"] = [{"id": i, "data": d} for i, d in zip(ids, json.loads(data))]
+    elif report_type in (
+        types_pb2.DEG_BY_LOC,
+        types_pb2.IN_DEG_BY_LOC,
+        types_pb2.OUT_DEG_BY_LOC,
+    ):
+        degrees = np.frombuffer(buf, dtype=np.float64, count=size, offset=offset)
+        ret["batch"] = [{"node": i, "deg": d} for i, d in zip(ids, degrees.tolist())]
+    else:
+        offsets = np.frombuffer(buf, dtype=np.int64, count=size + 1, offset=offset)
+        offsets = offsets.tolist()
+        offset += 8 * (size + 1)
+        nbr_ids, offset = _unpack_ids(buf, offset, offsets[-1])
+        data, offset = _unpack_string(buf, offset)
+        data = json.loads(data)
+        ret["batch"] = []
+        for k, i in enumerate(ids):
+            nbrs = {}
+            for j in range(offsets[k], offsets[k + 1]):
+                nbr = nbr_ids[j]
+                nbrs[tuple(nbr) if isinstance(nbr, list) else nbr] = data[j]
+            ret["batch"].append({"node": i, "nbrs": nbrs})
+    return ret
+
+
+def _arrow_type(values):
+    """Returns the arrow type of the values, or None when the values are not all
+    bool, int64, float or str, as the columns of the batch are typed.
+    """
+    import pyarrow as pa
+
+    types = set(type(v) for v in values)
+    if len(types) != 1:
+        return None
+    t = types.pop()
+    if t is bool:
+        return pa.bool_()
+    if t is int:
+        if all(-(2**63) <= v < 2**63 for v in values):
+            return pa.int64()
+        return None
+    if t is float:
+        return pa.float64()
+    if t is str:
+        return pa.string()
+    return None
+
+
+def to_arrow_batch(rows, id_num):
+    """Serialize the rows as the arrow IPC stream of the columnar modifications,
+    see DynamicBatchParser in the engine.
+
+    Parameters:
+    -----------
+    rows: list of [id, ..., data] lists, with id_num ids, e.g., [u, v, data]
+        of edges and [n, data] of nodes.
+    id_num: the number of the id columns.
+
+    Returns:
+    --------
+    The bytes of the stream, or None if the rows can't be typed as columns,
+    e.g., the ids are tuples or of mixed types, or a property has values of
+    different types or None, in which case the json lines should be used.
+    """
+    import pyarrow as pa
+
+    if not rows:
+        return None
+    columns = []
+    names = ["src", "dst"] if id_num == 2 else ["id"]
+    for i in range(id_num):
+        ids = [row[i] for row in rows]
+        id_type = _arrow_type(ids)
+        if id_type is None or id_type not in (pa.int64(), pa.string()):
+            return None
+        columns.append(pa.array(ids, type=id_type))
+    keys = {}
+    for row in rows:
+        keys.update(dict.fromkeys(row[id_num]))
+    for key in keys:
+        if not isinstance(key, str):
+            return None
+        values = [row[id_num].get(key) for row in rows]
+        present = [row[id_num][key] for row in rows if key in row[id_num]]
+        if any(v is None for v in present):
+            return None
+        prop_type = _arrow_type(present)
+        if prop_type is None:
+            return None
+        columns.append(pa.array(values, type=prop_type))
+        names.append(key)
+    table = pa.Table.from_arrays(columns, names=names)
+    sink = pa.BufferOutputStream()
+    with pa.ipc.new_stream(sink, table.schema) as writer:
+        writer.write_table(table)
+    return sink.getvalue().to_pybytes()
@@ -358,6 +358,18 @@ def bfs_result():
     yield ret
 
 
+@pytest.fixture(scope="module")
+def p2p_edges():
+    ret = np.loadtxt(
+        "{}/p2p-31_property_e_0".format(property_dir),
+        delimiter=",",
+        skiprows=1,
+        usecols=(0, 1),
+        dtype=int,
+    )
+    yield ret
+
+
 @pytest.fixture(scope="module")
 def cdlp_result():
     ret = np.loadtxt("{}/ldbc/p2p-31-CDLP".format(property_dir), dtype=int)
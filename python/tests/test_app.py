@@ -16,10 +16,12 @@
 # limitations under the License.
 #
 
+import collections
 import os
 
 import networkx as nx
 import numpy as np
+import pandas as pd
 import pytest
 
 import graphscope
@@ -29,9 +31,12 @@ from graphscope import clustering
 from graphscope import degree_centrality
 from graphscope import eigenvector_centrality
 from graphscope import hits
+from graphscope import hyper_anf
 from graphscope import k_core
 from graphscope import k_shell
 from graphscope import katz_centrality
+from graphscope import khop_sampling
+from graphscope import link_similarity
 from graphscope import louvain
 from graphscope import lpa
 from graphscope import pagerank
@@ -39,6 +44,8 @@ from graphscope import property_sssp
 from graphscope import sssp
 from graphscope import triangles
 from graphscope import wcc
+from graphscope import wcc_afforest
+from graphscope import wcc_rma
 from graphscope.framework.app import AppAssets
 from graphscope.framework.errors import InvalidArgumentError
 
@@ -342,6 +349,85 @@ def test_app_on_undirected_graph(
     ctx10 = louvain(p2p_project_undirected_graph, min_progress=50, progress_tries=2)
 
 
+@pytest.mark.parametrize("app", [wcc_afforest, wcc_rma])
+def test_wcc_variants(p2p_project_undirected_graph, wcc_result, app):
+    ctx = app(p2p_project_undirected_graph)
+    df = ctx.to_dataframe({"node": "v.id", "r": "r"})
+    # the components are labeled by the gids, so compare them up to the
+    # labels, i.e., label each component by its least id
+    df["r"] = df.groupby("r")["node"].transform("min")
+    r = df.sort_values(by=["node"]).to_numpy(dtype=int)
+    expected = pd.DataFrame(wcc_result, columns=["node", "r"])
+    expected["r"] = expected.groupby("r")["node"].transform("min")
+    assert np.all(r == expected.sort_values(by=["node"]).to_numpy(dtype=int))
+
+
+def test_khop_sampling(p2p_project_directed_graph, p2p_edges):
+    seeds, fanouts = [1, 6, 10], [5, 3]
+    ctx = khop_sampling(
+        p2p_project_directed_graph, seeds=seeds, fanouts=fanouts, random_seed=7
+    )
+    r = ctx.to_numpy(None, axis=0).astype(int)
+    assert r.ndim == 2 and r.shape[1] == 4
+    out_degrees = collections.Counter(p2p_edges[:, 0].tolist())
+    for seed in seeds:
+        rows = r[r[:, 0] == seed]
+        hop0 = rows[rows[:, 1] == 0]
+        assert np.all(hop0[:, 2] == seed)
+        assert len(hop0) == (fanouts[0] if out_degrees[seed] else 0)
+        # the vertices of the hop 1 are the ones sampled in the hop 0
+        hop1 = rows[rows[:, 1] == 1]
+        assert set(hop1[:, 2].tolist()) <= set(hop0[:, 3].tolist())
+        assert len(hop1) == sum(fanouts[1] for v in hop0[:, 3] if out_degrees[v])
+    edges = set(map(tuple, p2p_edges.tolist()))
+    assert all((src, dst) in edges for src, dst in r[:, 2:].tolist())
+
+
+def test_hyper_anf(p2p_project_directed_graph, p2p_edges):
+    ctx = hyper_anf(p2p_project_directed_graph, max_hops=3, precision=12)
+    df = ctx.to_dataframe({"node": "v.id", "r": "r"}).set_index("node")
+    assert np.all(df["r"] >= 1.0)
+    g = nx.DiGraph()
+    g.add_nodes_from(df.index.tolist())
+    g.add_edges_from(p2p_edges.tolist())
+    # the relative standard error of 2^12 registers is about 1.6%
+    for v in [1, 6, 10, 100, 1000]:
+        reach = len(nx.single_source_shortest_path_length(g, v, cutoff=3))
+        assert abs(df.loc[v, "r"] - reach) <= 0.1 * reach
+
+
+def test_link_similarity(p2p_project_undirected_graph, p2p_edges):
+    g = nx.Graph()
+    g.add_edges_from(p2p_edges.tolist())
+    g.remove_edges_from(list(nx.selfloop_edges(g)))
+
+    ctx = link_similarity(p2p_project_undirected_graph, max_exact_degree=1 << 30)
+    r = ctx.to_numpy(None, axis=0)
+    assert r.shape == (g.number_of_edges(), 6)
+    assert np.all(r[:, 5] == 1)
+    # a row per undirected edge
+    pairs = set(frozenset(pair) for pair in r[:, :2].astype(int).tolist())
+    assert len(pairs) == g.number_of_edges()
+    for src, dst, common, jaccard, adamic_adar, _ in r[:1000].tolist():
+        u, v = int(src), int(dst)
+        assert common == len(list(nx.common_neighbors(g, u, v)))
+        assert np.isclose(jaccard, next(nx.jaccard_coefficient(g, [(u, v)]))[2])
+        assert np.isclose(adamic_adar, next(nx.adamic_adar_index(g, [(u, v)]))[2])
+
+    # the scores of the ends of the degrees over 2 are estimated
+    ctx = link_similarity(
+        p2p_project_undirected_graph, max_exact_degree=2, num_hashes=256
+    )
+    r = ctx.to_numpy(None, axis=0)
+    estimated = r[r[:, 5] == 0]
+    assert len(estimated) > 0
+    errors = [
+        abs(jaccard - next(nx.jaccard_coefficient(g, [(int(src), int(dst))]))[2])
+        for src, dst, _, jaccard, _, _ in estimated[:1000].tolist()
+    ]
+    assert np.mean(errors) < 0.05
+
+
 def test_run_app_on_string_oid_graph(p2p_project_directed_graph_string):
     ctx = sssp(p2p_project_directed_graph_string, src="6")
     r1 = ctx.to_dataframe({"node": "v.id", "r": "r"})
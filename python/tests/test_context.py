@@ -18,7 +18,9 @@
 
 import os
 
+import numpy as np
 import pandas as pd
+import pyarrow as pa
 import pytest
 import vineyard
 import vineyard.io
@@ -71,6 +73,62 @@ def test_simple_context_to_vineyard_dataframe(
     assert out is not None
 
 
+def test_simple_context_to_arrow(simple_context):
+    df = simple_context.to_dataframe({"id": "v.id", "data": "v.data", "result": "r"})
+    out = simple_context.to_arrow({"id": "v.id", "data": "v.data", "result": "r"})
+    assert isinstance(out, pa.Table)
+    assert out.column_names == ["id", "data", "result"]
+    pd.testing.assert_frame_equal(
+        out.to_pandas().sort_values(by=["id"]).reset_index(drop=True),
+        df.sort_values(by=["id"]).reset_index(drop=True),
+        check_dtype=False,
+    )
+
+
+def test_simple_context_top_k(simple_context):
+    df = simple_context.to_dataframe({"id": "v.id", "result": "r"})
+    out = simple_context.top_k(10, {"id": "v.id", "result": "r"})
+    assert out.shape == (10, 2)
+    assert out["result"].is_monotonic_decreasing
+    expected = df.sort_values(by=["result"], ascending=False).head(10)
+    assert np.allclose(out["result"].to_numpy(), expected["result"].to_numpy())
+    # the order_by column is not returned
+    out = simple_context.top_k(5, {"id": "v.id"}, order_by="r")
+    assert out.columns.tolist() == ["id"]
+
+
+def test_simple_context_sample(simple_context):
+    df = simple_context.to_dataframe({"id": "v.id", "result": "r"})
+    out = simple_context.sample(100, {"id": "v.id", "result": "r"}, seed=7)
+    assert out.shape == (100, 2)
+    assert out["id"].is_unique
+    merged = out.merge(df, on="id", suffixes=("", "_all"))
+    assert len(merged) == 100
+    assert np.allclose(merged["result"], merged["result_all"])
+    again = simple_context.sample(100, {"id": "v.id", "result": "r"}, seed=7)
+    pd.testing.assert_frame_equal(out, again)
+    out = simple_context.sample(1000000, {"id": "v.id"})
+    assert out.shape == (40521, 1)
+
+
+def test_simple_context_to_arrow_files(simple_context):
+    df = simple_context.to_dataframe({"id": "v.id", "result": "r"})
+    paths = simple_context.to_arrow_files(
+        "/tmp/test_simple_context_to_arrow_files", {"id": "v.id", "result": "r"}
+    )
+    assert paths
+    tables = [pa.ipc.open_file(path).read_all() for path in paths]
+    out = pa.concat_tables(tables).to_pandas()
+    assert out.shape == (40521, 2)
+    pd.testing.assert_frame_equal(
+        out.sort_values(by=["id"]).reset_index(drop=True),
+        df.sort_values(by=["id"]).reset_index(drop=True),
+        check_dtype=False,
+    )
+    for path in paths:
+        os.remove(path)
+
+
 def test_property_context_to_numpy(property_context):
     out = property_context.to_numpy("v:v0.weight")
     assert out.shape == (40521,)
@@ -85,6 +143,13 @@ def test_property_context_to_dataframe(property_context):
     assert out.shape == (40786, 2)
 
 
+def test_property_context_to_arrow(property_context):
+    out = property_context.to_arrow({"id": "v:v0.id", "result": "r:v0.dist_0"})
+    assert out.num_rows == 40521
+    out = property_context.to_arrow({"id": "v:v1.id", "result": "r:v1.dist_1"})
+    assert out.num_rows == 40786
+
+
 def test_property_context_output(property_context):
     property_context.output_to_client(
         fd="/tmp/r0", selector={"id": "v:v0.id", "result": "r:v0.dist_0"}
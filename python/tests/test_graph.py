@@ -18,12 +18,15 @@
 
 import logging
 import os
+import tempfile
 
 import numpy as np
+import pandas as pd
 import pytest
 import vineyard
 
 import graphscope
+import graphscope.nx as nx
 from graphscope import property_sssp
 from graphscope import sssp
 from graphscope.dataset.ldbc import load_ldbc
@@ -57,6 +60,111 @@ def test_load_graph_copy(graphscope_session, arrow_property_graph):
     assert g3.loaded()
 
 
+def test_save_and_load_snapshot(graphscope_session, p2p_property_graph, sssp_result):
+    g = p2p_property_graph
+    with tempfile.TemporaryDirectory() as path:
+        g.save_snapshot(path)
+        g2 = Graph.load_snapshot(path, graphscope_session)
+        assert g.key != g2.key
+        assert str(g.schema) == str(g2.schema)
+        assert np.all(
+            np.sort(g.to_numpy("v:person.id")) == np.sort(g2.to_numpy("v:person.id"))
+        )
+        pg = g2.project(vertices={"person": ["weight"]}, edges={"knows": ["dist"]})
+        ctx = sssp(pg, src=6)
+        r = (
+            ctx.to_dataframe({"node": "v.id", "r": "r"})
+            .sort_values(by=["node"])
+            .to_numpy(dtype=float)
+        )
+        r[r == 1.7976931348623157e308] = float("inf")  # replace limit::max with inf
+        assert np.allclose(r, sssp_result["directed"])
+        g2.unload()
+
+        # the types are checked against the ones of the snapshot
+        with pytest.raises(AnalyticalEngineInternalError, match="oid type"):
+            Graph.load_snapshot(path, graphscope_session, oid_type="string")
+        with pytest.raises(AnalyticalEngineInternalError, match="vid type"):
+            Graph.load_snapshot(path, graphscope_session, vid_type="uint32")
+
+
+def test_save_and_load_snapshot_of_other_types(graphscope_session):
+    property_dir = os.path.join(prefix, "property")
+    for oid_type, vid_type in [("string", "uint64"), ("int64", "uint32")]:
+        g = (
+            graphscope_session.g(oid_type=oid_type, vid_type=vid_type)
+            .add_vertices(f"{property_dir}/p2p-31_property_v_0", "person")
+            .add_edges(f"{property_dir}/p2p-31_property_e_0", "knows")
+        )
+        with tempfile.TemporaryDirectory() as path:
+            g.save_snapshot(path)
+            with pytest.raises(AnalyticalEngineInternalError):
+                Graph.load_snapshot(path, graphscope_session)
+            g2 = Graph.load_snapshot(
+                path, graphscope_session, oid_type=oid_type, vid_type=vid_type
+            )
+            assert str(g.schema) == str(g2.schema)
+            assert sorted(g.to_numpy("v:person.id")) == sorted(
+                g2.to_numpy("v:person.id")
+            )
+            g2.unload()
+        g.unload()
+
+
+def test_load_with_compress_properties(graphscope_session, arrow_modern_graph):
+    data_dir = os.path.join(prefix, "modern_graph")
+
+    def loader(name):
+        return Loader(os.path.join(data_dir, name), delimiter="|")
+
+    g = graphscope_session.load_from(
+        edges={
+            "knows": (
+                loader("knows.csv"),
+                ["weight"],
+                ("src_id", "person"),
+                ("dst_id", "person"),
+            ),
+            "created": (
+                loader("created.csv"),
+                ["weight"],
+                ("src_id", "person"),
+                ("dst_id", "software"),
+            ),
+        },
+        vertices={
+            "person": (loader("person.csv"), ["name", ("age", "int")], "id"),
+            "software": (loader("software.csv"), ["name", "lang"], "id"),
+        },
+        compress_properties=True,
+    )
+    # the vertex data selectors read the decoded values
+    for label, props in [("person", ["name", "age"]), ("software", ["name", "lang"])]:
+        selector = {prop: f"v:{label}.{prop}" for prop in ["id"] + props}
+        expected = arrow_modern_graph.to_dataframe(selector).sort_values(by=["id"])
+        out = g.to_dataframe(selector).sort_values(by=["id"])
+        pd.testing.assert_frame_equal(
+            out.reset_index(drop=True),
+            expected.reset_index(drop=True),
+            check_dtype=False,
+        )
+
+    # and so does the conversion to networkx graphs
+    nx_g = nx.DiGraph(g)
+    expected = nx.DiGraph(arrow_modern_graph)
+    assert nx_g.number_of_nodes() == expected.number_of_nodes()
+    assert nx_g.number_of_edges() == expected.number_of_edges()
+    for node, data in expected.nodes(data=True):
+        assert nx_g.nodes[node] == data
+    for src, dst, data in expected.edges(data=True):
+        assert nx_g.edges[src, dst] == data
+
+    # while the projections would read the codes
+    with pytest.raises(AnalyticalEngineInternalError, match="compress_properties"):
+        sssp(g.project(vertices={"person": ["age"]}, edges={"knows": ["weight"]}), 1)
+    g.unload()
+
+
 def test_project_to_simple_with_name(p2p_property_graph, sssp_result):
     pg = p2p_property_graph.project(
         vertices={"person": ["weight"]}, edges={"knows": ["dist"]}
@@ -25,9 +25,13 @@ import tempfile
 import time
 
 import pytest
+import vineyard
 
 import graphscope
+import graphscope.nx as nx
 from graphscope.client.session import DEFAULT_CONFIG_FILE
+from graphscope.client.session import default_session
+from graphscope.framework.app import AppAssets
 
 COORDINATOR_HOME = os.path.join(os.path.dirname(__file__), "../", "../coordinator")
 new_data_dir = os.path.expandvars("${GS_TEST_DIR}/new_property/v2_e2")
@@ -260,3 +264,90 @@ def test_border_cases():
             }
         )
         g._ensure_loaded()
+
+
+def test_memory_usage():
+    s = graphscope.session(cluster_type="hosts", num_workers=2)
+    g = load_graph(s)
+    ctx = graphscope.property_sssp(g, src=4)
+
+    usage = s.memory_usage()
+    assert [worker["worker_id"] for worker in usage] == [0, 1]
+    for worker in usage:
+        ids = [obj["id"] for obj in worker["objects"]]
+        assert g.key in ids
+        assert ctx.key in ids
+        assert worker["total_bytes"] > 0
+        # a fragment shared by several objects is counted once
+        assert worker["total_bytes"] <= sum(obj["bytes"] for obj in worker["objects"])
+        # the budget is unlimited by default
+        assert worker["budget_bytes"] == 0
+    assert s.evicted_objects == []
+    s.close()
+
+
+def test_evict_projected_graph():
+    # the budget is exceeded by any of the graphs
+    s = graphscope.session(cluster_type="hosts", num_workers=2, memory_budget_bytes=1)
+    assert s._config_params["memory_budget_bytes"] == 1
+    client = vineyard.connect(s.engine_config["vineyard_socket"])
+    g = load_graph(s)
+    pg = g.project(vertices={"v0": []}, edges={"e0": ["weight"]})
+    sg = pg._project_to_simple(materialize_edge_data=True)
+    sg._ensure_loaded()
+    # the projection put last is kept
+    assert sg.key not in s.evicted_objects
+    projected_bytes = client.status.memory_usage
+
+    # the unused projection is evicted once another object is put, and its
+    # vineyard objects are deleted with it, except those of the graph it is
+    # projected from
+    ctx = graphscope.property_sssp(g, src=4)
+    assert sg.key in s.evicted_objects
+    assert client.status.memory_usage < projected_bytes
+    assert ctx.to_dataframe({"id": "v:v0.id", "result": "r:v0.dist_0"}).shape[0] > 0
+    s.close()
+
+
+def test_query_cache():
+    s = graphscope.session(cluster_type="hosts", query_cache_bytes=1 << 30)
+    assert s._config_params["query_cache_bytes"] == 1 << 30
+    g = load_graph(s)
+    selector = {"id": "v:v0.id", "result": "r:v0.dist_0"}
+
+    ctx1 = graphscope.property_sssp(g, src=4)
+    assert not ctx1._cache_hit
+    ctx2 = graphscope.property_sssp(g, src=4)
+    assert ctx2._cache_hit
+    assert ctx2.key != ctx1.key
+    # another query on the same graph misses
+    ctx3 = graphscope.property_sssp(g, src=6)
+    assert not ctx3._cache_hit
+    expected = ctx1.to_dataframe(selector)
+
+    # the other handle of the cached context is still readable
+    ctx1.unload()
+    assert ctx1.key is None
+    assert ctx2.to_dataframe(selector).equals(expected)
+    ctx4 = graphscope.property_sssp(g, src=4)
+    assert ctx4._cache_hit
+    # the cached context is dropped with its last handle
+    ctx2.unload()
+    ctx4.unload()
+    ctx5 = graphscope.property_sssp(g, src=4)
+    assert not ctx5._cache_hit
+    assert ctx5.to_dataframe(selector).equals(expected)
+
+    # the modified graphs are never answered by the cache
+    with default_session(s):
+        dg = nx.Graph()
+    dg.add_edges_from([(1, 2), (2, 3)], weight=3)
+    sssp = AppAssets(algo="sssp_projected")
+    ctx = sssp(dg.project_to_simple(e_prop="weight"), 1)
+    assert not ctx._cache_hit
+    dg.add_edge(1, 3, weight=1)
+    ctx = sssp(dg.project_to_simple(e_prop="weight"), 1)
+    assert not ctx._cache_hit
+    r = ctx.to_dataframe({"node": "v.id", "result": "r"}).set_index("node")
+    assert r.loc[3, "result"] == 1
+    s.close()